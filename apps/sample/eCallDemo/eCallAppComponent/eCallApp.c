@@ -48,6 +48,29 @@
 //--------------------------------------------------------------------------------------------------
 #define TEST_GNSS_SERVICE_USED  true
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Horizontal movement (in meters) after which the position of the MSD is updated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define POSITION_UPDATE_MAGNITUDE   5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position fix.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isValid;       ///< True if a fix has been received
+    int32_t  latitude;      ///< Latitude in degrees [resolution 1e-6]
+    int32_t  longitude;     ///< Longitude in degrees [resolution 1e-6]
+    int32_t  hAccuracy;     ///< Horizontal accuracy in meters
+    uint32_t direction;     ///< Direction in degrees (0xFFFFFFFF if unknown)
+    uint32_t dirAccuracy;   ///< Direction accuracy in degrees
+}
+Fix_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
 //--------------------------------------------------------------------------------------------------
@@ -60,6 +83,23 @@
 //--------------------------------------------------------------------------------------------------
 static le_ecall_CallRef_t ECallRef;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last position fix received from the positioning service.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static Fix_t LastFix;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum horizontal (in meters) and direction (in degrees) accuracies to trust the position.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t  HMinAccuracy = DEFAULT_H_ACCURACY;
+static uint32_t DirMinAccuracy = DEFAULT_DIR_ACCURACY;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Load the eCall app settings
@@ -274,6 +314,86 @@ static void ECallStateHandler
 
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the position of the MSD from a position fix.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetMsdPosition
+(
+    const Fix_t* fixPtr     ///< [IN] Position fix
+)
+{
+    bool    isPosTrusted = false;
+    int32_t latitude = 0x7FFFFFFF;
+    int32_t longitude = 0x7FFFFFFF;
+    int32_t direction = 0xFF;
+
+    if (fixPtr->isValid)
+    {
+        latitude = fixPtr->latitude;
+        longitude = fixPtr->longitude;
+
+        // The MSD direction is in 2-degrees unit.
+        if (fixPtr->direction < 360)
+        {
+            direction = fixPtr->direction / 2;
+        }
+
+        if ((fixPtr->hAccuracy < HMinAccuracy) && (fixPtr->dirAccuracy < DirMinAccuracy))
+        {
+            isPosTrusted = true;
+        }
+    }
+
+    LE_ERROR_IF((le_ecall_SetMsdPosition(ECallRef,
+                                         isPosTrusted,
+                                         latitude,
+                                         longitude,
+                                         direction) != LE_OK),
+                "Unable to set the position!");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for position updates: the MSD of the eCall session in hot standby is kept up to
+ * date with the latest position.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void PositionHandler
+(
+    le_pos_SampleRef_t positionSampleRef,
+    void*              contextPtr
+)
+{
+    Fix_t fix;
+
+    if (le_pos_sample_Get2DLocation(positionSampleRef,
+                                    &fix.latitude,
+                                    &fix.longitude,
+                                    &fix.hAccuracy) == LE_OK)
+    {
+        if (le_pos_sample_GetDirection(positionSampleRef,
+                                       &fix.direction,
+                                       &fix.dirAccuracy) != LE_OK)
+        {
+            fix.direction = 0xFFFFFFFF;
+            fix.dirAccuracy = 0xFFFFFFFF;
+        }
+        fix.isValid = true;
+        LastFix = fix;
+
+        if (ECallRef)
+        {
+            SetMsdPosition(&LastFix);
+        }
+    }
+
+    le_pos_sample_Release(positionSampleRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start a test eCall Session
@@ -283,50 +403,39 @@ static void ECallStateHandler
 //--------------------------------------------------------------------------------------------------
 static void StartSession
 (
-    uint32_t paxCount,      ///< [IN] number of passengers
-    int32_t  hMinAccuracy,  ///< [IN] minimum horizontal accuracy to trust the position (in meters)
-    uint32_t dirMinAccuracy ///< [IN] minimum direction accuracy to trust the position (in degrees)
+    uint32_t paxCount       ///< [IN] number of passengers
 )
 {
-    bool                              isPosTrusted = false;
-    int32_t                           latitude = 0x7FFFFFFF;
-    int32_t                           longitude = 0x7FFFFFFF;
-    int32_t                           hAccuracy = 0;
-    uint32_t                          direction = 0xFFFFFFFF;
-    uint32_t                          dirAccuracy = 0;
-
     LE_DEBUG("StartSession called");
 
     ECallRef=le_ecall_Create();
     LE_FATAL_IF((!ECallRef), "Unable to create an eCall object, exit the app!");
     LE_DEBUG("Create eCallRef.%p",  ECallRef);
 
-    // Get the position data
-    if (TEST_GNSS_SERVICE_USED)
+    // Get the position data, if it hasn't been received yet
+    if ((TEST_GNSS_SERVICE_USED) && (!LastFix.isValid))
     {
-        if ((le_pos_Get2DLocation(&latitude, &longitude, &hAccuracy) == LE_OK) &&
-                        (le_pos_GetDirection(&direction, &dirAccuracy) == LE_OK))
+        if ((le_pos_Get2DLocation(&LastFix.latitude,
+                                  &LastFix.longitude,
+                                  &LastFix.hAccuracy) == LE_OK) &&
+            (le_pos_GetDirection(&LastFix.direction, &LastFix.dirAccuracy) == LE_OK))
         {
-            if ((hAccuracy < hMinAccuracy) && (dirAccuracy < dirMinAccuracy))
-            {
-                isPosTrusted = true;
-                LE_INFO("Position can be trusted.");
-            }
+            LastFix.isValid = true;
         }
     }
 
-    if (isPosTrusted == false)
+    if (   (LastFix.isValid)
+        && (LastFix.hAccuracy < HMinAccuracy)
+        && (LastFix.dirAccuracy < DirMinAccuracy))
+    {
+        LE_INFO("Position can be trusted.");
+    }
+    else
     {
         LE_WARN("Position can't be trusted!");
     }
 
-
-    LE_ERROR_IF((le_ecall_SetMsdPosition(ECallRef,
-                                         isPosTrusted,
-                                         latitude,
-                                         longitude,
-                                         direction) != LE_OK),
-                "Unable to set the position!");
+    SetMsdPosition(&LastFix);
 
     // for demo purposes N-1 is hardcoded
     LE_ERROR_IF((le_ecall_SetMsdPositionN1(ECallRef,
@@ -390,25 +499,21 @@ void ecallApp_StartSession
     uint32_t  paxCount ///< [IN] number of passengers
 )
 {
-    int32_t  hMinAccuracy = 0;
-    uint32_t dirMinAccuracy = 0;
-
     if (ECallRef)
     {
-        LE_WARN("End and Delete previous eCall session.");
+        // The eCall object is kept for the hot standby.
+        LE_INFO("End previous eCall session.");
         le_ecall_End(ECallRef);
-        le_ecall_Delete(ECallRef);
-        ECallRef = NULL;
     }
 
-    LoadECallSettings(&hMinAccuracy, &dirMinAccuracy);
+    LoadECallSettings(&HMinAccuracy, &DirMinAccuracy);
 
     LE_DEBUG("Start eCall session with %d passengers, hMinAccuracy.%d, dirMinAccuracy.%d",
                 paxCount,
-                hMinAccuracy,
-                dirMinAccuracy);
+                HMinAccuracy,
+                DirMinAccuracy);
 
-    StartSession(paxCount, hMinAccuracy, dirMinAccuracy);
+    StartSession(paxCount);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -455,5 +560,20 @@ COMPONENT_INIT
     LE_ERROR_IF((LE_OK != le_ecall_SetPropulsionType(LE_ECALL_PROPULSION_TYPE_ELECTRIC)),
                 " Unable to set VIN!");
 
+    // Keep an eCall session in hot standby, with the MSD position updated at each new fix, so that
+    // a triggered eCall only has to dial.
+    ECallRef = le_ecall_Create();
+    LE_WARN_IF((LE_OK != le_ecall_SetHotStandby(ECallRef, true)),
+               " Unable to put the eCall session in hot standby!");
+
+    if (TEST_GNSS_SERVICE_USED)
+    {
+        LE_ERROR_IF((NULL == le_pos_AddMovementHandler(POSITION_UPDATE_MAGNITUDE,
+                                                       0,
+                                                       PositionHandler,
+                                                       NULL)),
+                    " Unable to add a position handler!");
+    }
+
     LE_INFO("eCallDemo app is started.");
 }
@@ -20,7 +20,6 @@ typedef struct
     const char* commandNamePtr;
     const char* intermediateRspPtr[5];
     const char* finalRspPtr;
-    int         readIndex;
 }
 AtCommandDesc_t;
 
@@ -52,14 +51,12 @@ static AtCommandDesc_t AtCommandList[] = {
     {
         .commandNamePtr = AtPlusCgdcontPara,
         .intermediateRspPtr = { NULL },
-        .finalRspPtr = OkRsp,
-        .readIndex = 0
+        .finalRspPtr = OkRsp
     },
     {
         .commandNamePtr = AtPlusCpinRead,
         .intermediateRspPtr = { "+CPIN: READY", NULL },
-        .finalRspPtr = OkRsp,
-        .readIndex = 0
+        .finalRspPtr = OkRsp
     },
     {
         .commandNamePtr = AtPlusCgdcontRead,
@@ -67,8 +64,7 @@ static AtCommandDesc_t AtCommandList[] = {
                                 "+CGDCONT: 2,\"IP\",\"bouygues\"",
                                 "+CGDCONT: 3,\"IP\",\"sfr\"",
                                 NULL },
-        .finalRspPtr = OkRsp,
-        .readIndex = 0
+        .finalRspPtr = OkRsp
     },
     {
         .commandNamePtr = AtPlusCgdcontTest,
@@ -77,20 +73,17 @@ static AtCommandDesc_t AtCommandList[] = {
                                 "+CGDCONT: (1-16),\"IPV6\",,,(0-2),(0-4)",
                                 "+CGDCONT: (1-16),\"IPV4V6\",,,(0-2),(0-4)",
                                 NULL },
-        .finalRspPtr = OkRsp,
-        .readIndex = 0
+        .finalRspPtr = OkRsp
     },
     {
         .commandNamePtr = AtQ1,
         .intermediateRspPtr = { "Q1", NULL },
-        .finalRspPtr = OkRsp,
-        .readIndex = 0
+        .finalRspPtr = OkRsp
     },
     {
         .commandNamePtr = AtPlusBad,
         .intermediateRspPtr = { NULL },
-        .finalRspPtr = ErrorRsp,
-        .readIndex = 0
+        .finalRspPtr = ErrorRsp
     },
 };
 
@@ -103,8 +96,12 @@ static AtCommandDesc_t AtCommandList[] = {
 static AtCommandDesc_t* CurrentCmdPtr = NULL;
 static le_sem_Ref_t     BridgeSemaphore;
 static const le_atClient_DeviceRef_t  AtClientDeviceRef = (le_atClient_DeviceRef_t) 0x12345678;
+static const le_atClient_CmdRef_t     AtClientCmdRef = (le_atClient_CmdRef_t) 0x87654321;
 static le_atClient_UnsolicitedResponseHandlerFunc_t UnsolHandler = NULL;
 static void* UnsolHandlerContextPtr = NULL;
+static le_atClient_ResponseHandlerFunc_t RspHandler = NULL;
+static void* RspHandlerContextPtr = NULL;
+static le_thread_Ref_t RspHandlerThreadRef = NULL;
 static int FdAtClient = -1;
 
 //--------------------------------------------------------------------------------------------------
@@ -178,51 +175,43 @@ le_atClient_DeviceRef_t le_atClient_Start
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to automatically set and send an AT Command.
- *
- * @return
- *      - LE_FAULT when function failed
- *      - LE_TIMEOUT when a timeout occur
- *      - LE_OK when function succeed
- *
- * @note This command creates a command reference when called
- *
- * @note In case of an Error the command reference will be deleted and though
- *       not usable. Make sure to test the return code and not use the reference
- *       in other functions.
- *
- * @note If the AT command is invalid, a fatal error occurs,
- *       the function won't return.
+ * This function must be called to create a new AT command.
  *
+ * @return pointer to the new AT Command reference
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetCommandAndSend
+le_atClient_CmdRef_t le_atClient_Create
 (
-    le_atClient_CmdRef_t* cmdRefPtr,
-        ///< [OUT] Command reference
+    void
+)
+{
+    CurrentCmdPtr = NULL;
+    RspHandler = NULL;
 
-    le_atClient_DeviceRef_t devRef,
-        ///< [IN] Device reference
+    return AtClientCmdRef;
+}
 
-    const char* commandPtr,
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the AT command string to be sent.
+ *
+ * @return
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetCommand
+(
+    le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
 
-    const char* interRespPtr,
-        ///< [IN] Expected Intermediate Response
-
-    const char* finalRespPtr,
-        ///< [IN] Expected Final Response
-
-    uint32_t timeout
-        ///< [IN] Timeout
+    const char* commandPtr
+        ///< [IN] Set Command
 )
 {
-    LE_ASSERT(devRef == AtClientDeviceRef);
+    LE_ASSERT(cmdRef == AtClientCmdRef);
 
     int i = 0;
 
-    CurrentCmdPtr = NULL;
-
     while ( i < NUM_ARRAY_MEMBERS(AtCommandList) )
     {
         if (strncmp(commandPtr,
@@ -230,142 +219,204 @@ le_result_t le_atClient_SetCommandAndSend
             strlen(AtCommandList[i].commandNamePtr)) == 0)
         {
             CurrentCmdPtr = &AtCommandList[i];
-            *cmdRefPtr = (le_atClient_CmdRef_t) CurrentCmdPtr;
-            return LE_OK;
+            break;
         }
         i++;
     }
 
-    return LE_FAULT;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is used to get the first intermediate response.
+ * This function must be called to set the device where the AT command will be sent.
  *
  * @return
- *      - LE_FAULT when function failed
  *      - LE_OK when function succeed
- *
- * @note If the AT Command reference is invalid, a fatal error occurs,
- *       the function won't return.
-*/
+ */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetFirstIntermediateResponse
+le_result_t le_atClient_SetDevice
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
 
-    char* intermediateRspPtr,
-        ///< [OUT] Get Next Line
+    le_atClient_DeviceRef_t devRef
+        ///< [IN] Device where the AT command has to be sent
+)
+{
+    LE_ASSERT(cmdRef == AtClientCmdRef);
+    LE_ASSERT(devRef == AtClientDeviceRef);
+
+    return LE_OK;
+}
 
-    size_t intermediateRspNumElements
-        ///< [IN]
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the timeout of the AT command execution.
+ *
+ * @return
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetTimeout
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    uint32_t timer
+        ///< [IN] The timeout value in milliseconds.
 )
 {
-    LE_ASSERT(cmdRef == (le_atClient_CmdRef_t) CurrentCmdPtr);
-    LE_ASSERT(CurrentCmdPtr != NULL);
-    LE_ASSERT(CurrentCmdPtr->readIndex == 0);
+    LE_ASSERT(cmdRef == AtClientCmdRef);
 
-    if (CurrentCmdPtr->intermediateRspPtr[0] != NULL)
-    {
-        snprintf(intermediateRspPtr,
-                 intermediateRspNumElements,
-                 "%s",
-                 CurrentCmdPtr->intermediateRspPtr[0]);
+    return LE_OK;
+}
 
-        CurrentCmdPtr->readIndex++;
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the waiting intermediate responses.
+ *
+ * @return
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetIntermediateResponse
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
 
-        return LE_OK;
-    }
+    const char* intermediatePtr
+        ///< [IN] Set Intermediate
+)
+{
+    LE_ASSERT(cmdRef == AtClientCmdRef);
 
-    return LE_FAULT;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is used to get the next intermediate response.
+ * This function must be called to set the final response(s) of the AT command execution.
  *
  * @return
- *      - LE_NOT_FOUND when there are no further results.
  *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetFinalResponse
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    const char* responsePtr
+        ///< [IN] Set Response
+)
+{
+    LE_ASSERT(cmdRef == AtClientCmdRef);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event provides the responses of an AT command as soon as they are received.
  *
- * @note If the AT Command reference is invalid, a fatal error occurs,
- *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetNextIntermediateResponse
+le_atClient_ResponseHandlerRef_t le_atClient_AddResponseHandler
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
 
-    char* intermediateRspPtr,
-        ///< [OUT] Get Next Line
+    le_atClient_ResponseHandlerFunc_t handlerPtr,
+        ///< [IN]
 
-    size_t intermediateRspNumElements
+    void* contextPtr
         ///< [IN]
 )
 {
-    LE_ASSERT(cmdRef == (le_atClient_CmdRef_t) CurrentCmdPtr);
-    LE_ASSERT(CurrentCmdPtr != NULL);
-    LE_ASSERT(CurrentCmdPtr->readIndex != 0);
+    LE_ASSERT(cmdRef == AtClientCmdRef);
+    LE_ASSERT(RspHandler == NULL);
 
-    if (CurrentCmdPtr->intermediateRspPtr[CurrentCmdPtr->readIndex] != NULL)
-    {
-        snprintf(intermediateRspPtr,
-                 intermediateRspNumElements,
-                 "%s",
-                 CurrentCmdPtr->intermediateRspPtr[CurrentCmdPtr->readIndex]);
+    RspHandler = handlerPtr;
+    RspHandlerContextPtr = contextPtr;
+    RspHandlerThreadRef = le_thread_GetCurrent();
 
-        CurrentCmdPtr->readIndex++;
+    return (le_atClient_ResponseHandlerRef_t) cmdRef;
+}
 
-        return LE_OK;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_atClient_Response'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_RemoveResponseHandler
+(
+    le_atClient_ResponseHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    LE_ASSERT(handlerRef == (le_atClient_ResponseHandlerRef_t) AtClientCmdRef);
 
+    RspHandler = NULL;
+}
 
-    return LE_NOT_FOUND;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a response to the response handler, in the thread that added it (as the IPC does).
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportResponse
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    if (RspHandler != NULL)
+    {
+        RspHandler((const char*) param1Ptr, (param2Ptr != NULL), RspHandlerContextPtr);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is used to get the final response
+ * This function must be called to send an AT Command and wait for response.
  *
  * @return
  *      - LE_FAULT when function failed
  *      - LE_OK when function succeed
- *
- * @note If the AT Command reference is invalid, a fatal error occurs,
- *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetFinalResponse
+le_result_t le_atClient_Send
 (
-    le_atClient_CmdRef_t cmdRef,
+    le_atClient_CmdRef_t cmdRef
         ///< [IN] AT Command
-
-    char* finalRspPtr,
-        ///< [OUT] Get Final Line
-
-    size_t finalRspNumElements
-        ///< [IN]
 )
 {
-    LE_ASSERT(cmdRef == (le_atClient_CmdRef_t) CurrentCmdPtr);
-    LE_ASSERT(CurrentCmdPtr != NULL);
+    LE_ASSERT(cmdRef == AtClientCmdRef);
+    LE_ASSERT(RspHandler != NULL);
 
-    if (CurrentCmdPtr->finalRspPtr)
+    if (CurrentCmdPtr == NULL)
     {
-        snprintf(finalRspPtr,
-                 finalRspNumElements,
-                 "%s",
-                 CurrentCmdPtr->finalRspPtr);
+        return LE_FAULT;
+    }
 
-        CurrentCmdPtr->readIndex = 0;
+    int i;
 
-        return LE_OK;
+    for (i = 0; CurrentCmdPtr->intermediateRspPtr[i] != NULL; i++)
+    {
+        le_event_QueueFunctionToThread(RspHandlerThreadRef,
+                                       ReportResponse,
+                                       (void*) CurrentCmdPtr->intermediateRspPtr[i],
+                                       NULL);
     }
 
-    return LE_FAULT;
+    le_event_QueueFunctionToThread(RspHandlerThreadRef,
+                                   ReportResponse,
+                                   (void*) CurrentCmdPtr->finalRspPtr,
+                                   (void*) CurrentCmdPtr);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 
 #define DSIZE           1024     // default buffer size
 #define SERVER_TIMEOUT  10000    // server timeout in milliseconds
+#define BENCHMARK_CMDS  1000     // number of commands sent for the parser benchmark
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -262,6 +263,27 @@ static void* AtHost
     // Test bridge feature
     LE_ASSERT_OK(Testle_atServer_Bridge(socketFd, epollFd, sharedDataPtr));
 
+    // Parser benchmark: commands with parameters, sent one at a time
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    int i;
+
+    for (i = 0; i < BENCHMARK_CMDS; i++)
+    {
+        LE_ASSERT_OK(SendCommandsAndTest(socketFd, epollFd, "AT+ABCD=1,\"abc\",3",
+                    "\r\n+ABCD TYPE: PARA\r\n"
+                    "+ABCD PARAM 0: 1\r\n"
+                    "+ABCD PARAM 1: abc\r\n"
+                    "+ABCD PARAM 2: 3\r\n"
+                    "\r\nOK\r\n"));
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    uint64_t elapsedUs = (uint64_t)elapsed.sec * 1000000 + elapsed.usec;
+
+    LE_INFO("Parser benchmark: %d commands in %" PRIu64 " us (%" PRIu64 " commands/s)",
+            BENCHMARK_CMDS, elapsedUs,
+            (elapsedUs != 0) ? ((uint64_t)BENCHMARK_CMDS * 1000000 / elapsedUs) : 0);
+
     LE_ASSERT_OK(SendCommandsAndTest(socketFd, epollFd, "AT+DEL="
                 "\"AT\",\"ATI\",\"AT+CBC\",\"AT+ABCD\",\"ATA\",\"AT&F\","
                 "\"ATS\",\"ATV\",\"AT&C\",\"AT&D\",\"ATE\",\"AT+DATA\"",
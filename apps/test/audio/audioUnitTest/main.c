@@ -588,6 +588,9 @@ void Testle_audio_Connector
  * - le_audio_PlaySamples
  * - le_audio_AddMediaHandler
  * - le_audio_Stop
+ * - le_audio_SetSamplePcmPeriodSize
+ * - le_audio_GetSamplePcmPeriodSize
+ * - le_audio_GetSamplesStatistics
  *
  * Exit if failed
  *
@@ -600,6 +603,7 @@ void Testle_audio_PlaySamples
 {
     int i;
     le_audio_StreamRef_t playbackStreamRef = NULL;
+    uint32_t periodSize = 0, underrunCount = 0, overrunCount = 0, latency = 0;
 
     LE_ASSERT(pipe(Pipefd) == 0);
 
@@ -610,6 +614,14 @@ void Testle_audio_PlaySamples
     playbackStreamRef = le_audio_OpenPlayer();
     LE_ASSERT(playbackStreamRef != NULL);
 
+    // Check the period size, and keep the driver default one
+    LE_ASSERT(le_audio_GetSamplePcmPeriodSize(playbackStreamRef, &periodSize) == LE_OK);
+    LE_ASSERT(periodSize == 0);
+    LE_ASSERT(le_audio_SetSamplePcmPeriodSize(playbackStreamRef, 160) == LE_OK);
+    LE_ASSERT(le_audio_GetSamplePcmPeriodSize(playbackStreamRef, &periodSize) == LE_OK);
+    LE_ASSERT(periodSize == 160);
+    LE_ASSERT(le_audio_SetSamplePcmPeriodSize(playbackStreamRef, 0) == LE_OK);
+
     // Set the test case
     TestCase = TEST_PLAY_SAMPLES;
 
@@ -630,6 +642,11 @@ void Testle_audio_PlaySamples
     // check data
     LE_ASSERT(memcmp(Buffer, sentPcmPtr, BUFFER_LEN) == 0);
 
+    // Nothing is captured on a playback stream
+    LE_ASSERT(le_audio_GetSamplesStatistics(playbackStreamRef, &underrunCount, &overrunCount,
+                                            &latency) == LE_OK);
+    LE_ASSERT(overrunCount == 0);
+
     // Release buffer in pa_pcm_simu
     pa_pcmSimu_ReleaseData();
 
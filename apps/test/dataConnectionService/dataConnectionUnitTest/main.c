@@ -6,6 +6,7 @@
  * - le_data_GetFirstUsedTechnology
  * - le_data_GetNextUsedTechnology
  * - le_data_GetTechnology
+ * - le_data_GetTimeToConnect
  * - le_data_AddConnectionStateHandler
  * - le_data_Request
  * - le_data_Release
@@ -473,6 +474,12 @@ static void Testle_data_Service
 
     LE_INFO("Clients started");
 
+    uint32_t timeToConnect;
+    LE_ASSERT_OK(le_data_GetTimeToConnect(LE_DATA_CELLULAR, &timeToConnect));
+    LE_INFO("Cellular connected in %u ms", timeToConnect);
+    LE_ASSERT(LE_NOT_FOUND == le_data_GetTimeToConnect(LE_DATA_WIFI, &timeToConnect));
+    LE_ASSERT(LE_BAD_PARAMETER == le_data_GetTimeToConnect(LE_DATA_MAX, &timeToConnect));
+
     LE_ASSERT(LE_BUSY == le_data_SetCellularProfileIndex(LE_MDC_DEFAULT_PROFILE));
     LE_ASSERT(LE_BAD_PARAMETER == le_data_AddRoute("216.58.206.45.228"));
     LE_ASSERT(LE_BAD_PARAMETER == le_data_DelRoute("216.58.206.45.228"));
@@ -506,6 +513,9 @@ static void Testle_data_Service
     // Wait for the handlers call
     SynchronizeTest();
 
+    LE_ASSERT_OK(le_data_GetTimeToConnect(LE_DATA_WIFI, &timeToConnect));
+    LE_INFO("Wifi connected in %u ms", timeToConnect);
+
     // Disconnection request
     ExpectedConnectionStatus = false;
     // Each application releases the data connection: the API has therefore to be called
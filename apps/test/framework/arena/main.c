@@ -0,0 +1,128 @@
+/**
+ * Test for the arena API.
+ *
+ * Allocates objects of many sizes from an arena, checks that they are aligned and don't overlap,
+ * then checks that resetting the arena releases its chunks so they are reused.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+/// Number of objects allocated from the arena.
+#define NUM_OBJS            2000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Objects allocated from the arena.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* ObjPtrs[NUM_OBJS];
+static size_t ObjSizes[NUM_OBJS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates objects of many sizes, some of them too big for a chunk, and fills them in.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocObjs
+(
+    le_arena_Ref_t arena
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_OBJS; i++)
+    {
+        // Mostly small objects, with a big one every now and then.
+        ObjSizes[i] = (i % 50 == 49) ? (size_t)(1000 + i * 20) : (size_t)(i % 37);
+        ObjPtrs[i] = le_arena_Alloc(arena, ObjSizes[i]);
+
+        LE_TEST(ObjPtrs[i] != NULL);
+        LE_TEST(((uintptr_t)ObjPtrs[i] & 7) == 0);
+
+        memset(ObjPtrs[i], i, ObjSizes[i]);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the objects still hold what was written into them.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckObjs
+(
+    void
+)
+{
+    int i;
+    size_t j;
+
+    for (i = 0; i < NUM_OBJS; i++)
+    {
+        for (j = 0; j < ObjSizes[i]; j++)
+        {
+            if (ObjPtrs[i][j] != (uint8_t)i)
+            {
+                LE_ERROR("Object %d overwritten at byte %zu.", i, j);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN ARENA TEST ========");
+
+    le_mem_PoolRef_t chunkPool = _le_mem_FindPool("framework", "ArenaChunks");
+    le_mem_PoolStats_t stats;
+
+    LE_ASSERT(chunkPool != NULL);
+
+    le_arena_Ref_t arena = le_arena_Create();
+
+    AllocObjs(arena);
+    LE_TEST(CheckObjs());
+
+    char* strPtr = le_arena_StrDup(arena, "request-scoped string");
+    LE_TEST(strcmp(strPtr, "request-scoped string") == 0);
+    LE_TEST(CheckObjs());
+
+    // Objects can be as big as LE_ARENA_MAX_OBJ_BYTES.
+    uint8_t* bigPtr = le_arena_Alloc(arena, LE_ARENA_MAX_OBJ_BYTES);
+    memset(bigPtr, 0xA5, LE_ARENA_MAX_OBJ_BYTES);
+    LE_TEST(CheckObjs());
+
+    // Resetting the arena releases its chunks, and allocating the same objects again reuses them.
+    le_mem_GetStats(chunkPool, &stats);
+    size_t numChunks = le_mem_GetObjectCount(chunkPool);
+    LE_TEST(stats.numBlocksInUse > 0);
+
+    le_arena_Reset(arena);
+
+    le_mem_GetStats(chunkPool, &stats);
+    LE_TEST(stats.numBlocksInUse == 0);
+
+    AllocObjs(arena);
+    LE_TEST(CheckObjs());
+    LE_TEST(le_mem_GetObjectCount(chunkPool) == numChunks);
+
+    le_arena_Delete(arena);
+
+    le_mem_GetStats(chunkPool, &stats);
+    LE_TEST(stats.numBlocksInUse == 0);
+
+    LE_INFO("======== ARENA TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,109 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file bench.h
+ *
+ * Definitions shared by the liblegato microbenchmarks.
+ *
+ * Every result is printed to stdout as a single line containing one JSON object, so the output
+ * of a run can be fed straight into a script.  For example:
+ *
+ * @verbatim
+{"benchmark":"mem.allocRelease","threads":4,"cacheSize":16,"objectSize":64,"ops":4000000,"ns":81234567,"nsPerOp":20.31,"opsPerSec":49240181}
+@endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef BENCH_H_INCLUDE_GUARD
+#define BENCH_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if the benchmarks should run with fewer iterations (--quick).
+ */
+//--------------------------------------------------------------------------------------------------
+extern bool bench_Quick;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of iterations to run, scaled down if running in quick mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t bench_Iterations
+(
+    size_t iterations   ///< [IN] Number of iterations in a full run.
+)
+{
+    return (bench_Quick ? ((iterations + 9) / 10) : iterations);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the monotonic clock.
+ *
+ * @return The current time in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t bench_NowNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    LE_FATAL_IF(clock_gettime(CLOCK_MONOTONIC, &ts) != 0, "clock_gettime() failed (%m).");
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the result of one benchmark run.
+ *
+ * The parameters are inserted into the JSON object as they are, so they must be a
+ * comma-separated list of "key":value pairs (or an empty string).
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_Report
+(
+    const char* name,       ///< [IN] Name of the benchmark.
+    uint64_t    ops,        ///< [IN] Number of operations timed.
+    uint64_t    elapsedNs,  ///< [IN] Time taken by all the operations, in nanoseconds.
+    const char* paramFormat,///< [IN] printf-style format of the benchmark's parameters.
+    ...
+)
+__attribute__ ((format (printf, 4, 5)));
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a record saying that a benchmark could not be run.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_ReportSkipped
+(
+    const char* name,       ///< [IN] Name of the benchmark.
+    const char* reason      ///< [IN] Why it was skipped.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a benchmark group.  Each of these is implemented in its own file.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunMem(void);
+void bench_RunHashmap(void);
+void bench_RunTimer(void);
+void bench_RunEvent(void);
+void bench_RunIpc(void);
+void bench_RunCrc(void);
+void bench_RunHex(void);
+
+
+#endif // BENCH_H_INCLUDE_GUARD
@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * CRC benchmarks.
+ *
+ * Measures le_crc_Crc32() throughput on buffers of several sizes, from a single log record to a
+ * chunk of a firmware image.  Each operation is one call over the whole buffer, so the results are
+ * best read as bytes per second (reported as "mbPerSec").
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Largest buffer size.
+#define MAX_BUFFER_SIZE     (1024 * 1024)
+
+/// Number of bytes to process for each buffer size.
+#define BYTES_PER_RUN       (256 * 1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer the CRCs are computed over.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Buffer[MAX_BUFFER_SIZE];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the CRC benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunCrc
+(
+    void
+)
+{
+    static const size_t bufferSizes[] = { 64, 1024, 64 * 1024, MAX_BUFFER_SIZE };
+    size_t i;
+
+    for (i = 0; i < sizeof(Buffer); i++)
+    {
+        Buffer[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(bufferSizes); i++)
+    {
+        size_t size = bufferSizes[i];
+        size_t numCalls = bench_Iterations(BYTES_PER_RUN / size);
+        uint32_t crc = LE_CRC_START_CRC32;
+        size_t j;
+
+        uint64_t startNs = bench_NowNs();
+        for (j = 0; j < numCalls; j++)
+        {
+            crc = le_crc_Crc32(Buffer, size, crc);
+        }
+        uint64_t elapsedNs = bench_NowNs() - startNs;
+
+        // Use the result, so the calls can't be optimized away.
+        LE_DEBUG("CRC: 0x%08" PRIX32, crc);
+
+        bench_Report("crc.crc32", numCalls, elapsedNs, "\"bytes\":%zu,\"mbPerSec\":%.1f",
+                     size,
+                     (elapsedNs == 0) ? 0.0 : ((double)size * numCalls * 1e3 / elapsedNs));
+    }
+}
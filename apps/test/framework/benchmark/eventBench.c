@@ -0,0 +1,242 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event loop benchmarks.
+ *
+ * Measures the latency of le_event_Report(), i.e., the time from reporting an event to its
+ * handler being called:
+ *
+ *  - within one thread, by having the handler report the next event;
+ *  - between two threads, by having two threads bounce an event back and forth.
+ *
+ * Each benchmark runs in threads of its own so the main thread's event loop isn't involved.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Number of events reported within one thread.
+#define NUM_LOCAL_EVENTS    1000000
+
+/// Number of round trips between two threads.
+#define NUM_ROUND_TRIPS     100000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report payload.  Carries a sequence number.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;
+}
+Report_t;
+
+
+static le_event_Id_t LocalEventId;  ///< Event reported within one thread.
+static le_event_Id_t PingEventId;   ///< Event handled by the "ping" thread.
+static le_event_Id_t PongEventId;   ///< Event handled by the "pong" thread.
+
+static le_sem_Ref_t ReadySem;       ///< Posted by the pong thread when it's ready.
+
+static uint32_t NumEvents;          ///< Number of events (or round trips) to run.
+static uint64_t StartNs;            ///< Time at which the first event was reported.
+
+
+// ==================================
+//  SAME THREAD
+// ==================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler that reports the next event until enough have been handled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LocalHandler
+(
+    void* reportPtr
+)
+{
+    Report_t report = *(Report_t*)reportPtr;
+
+    if (++report.count < NumEvents)
+    {
+        le_event_Report(LocalEventId, &report, sizeof(report));
+    }
+    else
+    {
+        uint64_t elapsedNs = bench_NowNs() - StartNs;
+
+        bench_Report("event.reportLocal", NumEvents, elapsedNs, "\"threads\":1");
+
+        le_thread_Exit(NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that reports events to itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LocalThread
+(
+    void* contextPtr
+)
+{
+    Report_t report = { .count = 0 };
+
+    le_event_AddHandler("benchLocal", LocalEventId, LocalHandler);
+
+    StartNs = bench_NowNs();
+    le_event_Report(LocalEventId, &report, sizeof(report));
+
+    le_event_RunLoop();
+}
+
+
+// ==================================
+//  BETWEEN THREADS
+// ==================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler in the ping thread.  Starts a new round trip until enough have been done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PingHandler
+(
+    void* reportPtr
+)
+{
+    Report_t report = *(Report_t*)reportPtr;
+
+    if (++report.count < NumEvents)
+    {
+        le_event_Report(PongEventId, &report, sizeof(report));
+    }
+    else
+    {
+        uint64_t elapsedNs = bench_NowNs() - StartNs;
+
+        bench_Report("event.reportRoundTrip", NumEvents, elapsedNs, "\"threads\":2");
+
+        // Tell the pong thread to exit too.
+        report.count = UINT32_MAX;
+        le_event_Report(PongEventId, &report, sizeof(report));
+
+        le_thread_Exit(NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler in the pong thread.  Sends the event straight back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PongHandler
+(
+    void* reportPtr
+)
+{
+    if (((Report_t*)reportPtr)->count == UINT32_MAX)
+    {
+        le_thread_Exit(NULL);
+    }
+
+    le_event_Report(PingEventId, reportPtr, sizeof(Report_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that starts the round trips.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PingThread
+(
+    void* contextPtr
+)
+{
+    Report_t report = { .count = 0 };
+
+    le_event_AddHandler("benchPing", PingEventId, PingHandler);
+
+    le_sem_Wait(ReadySem);
+
+    StartNs = bench_NowNs();
+    le_event_Report(PongEventId, &report, sizeof(report));
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that answers the ping thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PongThread
+(
+    void* contextPtr
+)
+{
+    le_event_AddHandler("benchPong", PongEventId, PongHandler);
+
+    le_sem_Post(ReadySem);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a joinable thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t StartThread
+(
+    const char*             name,
+    le_thread_MainFunc_t    mainFunc
+)
+{
+    le_thread_Ref_t threadRef = le_thread_Create(name, mainFunc, NULL);
+
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    return threadRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the event loop benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunEvent
+(
+    void
+)
+{
+    LocalEventId = le_event_CreateId("benchLocal", sizeof(Report_t));
+    PingEventId = le_event_CreateId("benchPing", sizeof(Report_t));
+    PongEventId = le_event_CreateId("benchPong", sizeof(Report_t));
+    ReadySem = le_sem_Create("benchReady", 0);
+
+    NumEvents = bench_Iterations(NUM_LOCAL_EVENTS);
+    le_thread_Join(StartThread("eventLocal", LocalThread), NULL);
+
+    NumEvents = bench_Iterations(NUM_ROUND_TRIPS);
+    le_thread_Ref_t pingRef = StartThread("eventPing", PingThread);
+    le_thread_Ref_t pongRef = StartThread("eventPong", PongThread);
+    le_thread_Join(pingRef, NULL);
+    le_thread_Join(pongRef, NULL);
+
+    le_sem_Delete(ReadySem);
+}
@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hashmap benchmarks.
+ *
+ * Measures le_hashmap_Put() and le_hashmap_Get() (hits and misses) on both chained and compact
+ * maps, filled to several load factors.  The maps are sized so that they have TABLE_SIZE buckets
+ * and never need to grow during a run, so the load factor is simply the number of entries divided
+ * by TABLE_SIZE.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Number of buckets (or slots) in the maps.
+#define TABLE_SIZE          8192
+
+/// Capacity passed when creating the maps, which gives them TABLE_SIZE buckets.
+#define MAP_CAPACITY        (TABLE_SIZE / 2)
+
+/// Largest number of entries put in a map (a load factor of 0.875).
+#define MAX_ENTRIES         (TABLE_SIZE * 7 / 8)
+
+/// Number of lookups timed for each load factor.
+#define NUM_LOOKUPS         2000000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keys put in the maps, and keys that are never put in them.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Keys[MAX_ENTRIES];
+static uint32_t MissingKeys[MAX_ENTRIES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill, then time lookups in, a map at a given load factor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunLoadFactor
+(
+    le_hashmap_Ref_t mapRef,    ///< [IN] Map to use (will be emptied first).
+    const char*      type,      ///< [IN] Type of map, for the report.
+    size_t           numEntries ///< [IN] Number of entries to fill the map with.
+)
+{
+    size_t numLookups = bench_Iterations(NUM_LOOKUPS);
+    double loadFactor = (double)numEntries / TABLE_SIZE;
+    size_t found = 0;
+    size_t i;
+
+    le_hashmap_RemoveAll(mapRef);
+
+    uint64_t startNs = bench_NowNs();
+    for (i = 0; i < numEntries; i++)
+    {
+        le_hashmap_Put(mapRef, &Keys[i], &Keys[i]);
+    }
+    uint64_t elapsedNs = bench_NowNs() - startNs;
+
+    LE_FATAL_IF(le_hashmap_Size(mapRef) != numEntries, "Map has wrong number of entries.");
+
+    bench_Report("hashmap.put", numEntries, elapsedNs,
+                 "\"type\":\"%s\",\"entries\":%zu,\"loadFactor\":%.3f",
+                 type, numEntries, loadFactor);
+
+    startNs = bench_NowNs();
+    for (i = 0; i < numLookups; i++)
+    {
+        if (le_hashmap_Get(mapRef, &Keys[i % numEntries]) != NULL)
+        {
+            found++;
+        }
+    }
+    elapsedNs = bench_NowNs() - startNs;
+
+    LE_FATAL_IF(found != numLookups, "Only found %zu of %zu keys.", found, numLookups);
+
+    bench_Report("hashmap.getHit", numLookups, elapsedNs,
+                 "\"type\":\"%s\",\"entries\":%zu,\"loadFactor\":%.3f",
+                 type, numEntries, loadFactor);
+
+    found = 0;
+    startNs = bench_NowNs();
+    for (i = 0; i < numLookups; i++)
+    {
+        if (le_hashmap_Get(mapRef, &MissingKeys[i % MAX_ENTRIES]) != NULL)
+        {
+            found++;
+        }
+    }
+    elapsedNs = bench_NowNs() - startNs;
+
+    LE_FATAL_IF(found != 0, "Found %zu keys that were never added.", found);
+
+    bench_Report("hashmap.getMiss", numLookups, elapsedNs,
+                 "\"type\":\"%s\",\"entries\":%zu,\"loadFactor\":%.3f",
+                 type, numEntries, loadFactor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the hashmap benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunHashmap
+(
+    void
+)
+{
+    // Load factors (in eighths) to test.  Chained maps grow beyond 0.75, so stop there for them.
+    static const size_t loadEighths[] = { 1, 2, 4, 6, 7 };
+    size_t i;
+
+    // Spread the keys out, and make sure the missing keys can't clash with them (even vs odd).
+    for (i = 0; i < MAX_ENTRIES; i++)
+    {
+        Keys[i] = (uint32_t)(i * 2654435761u) << 1;
+        MissingKeys[i] = Keys[i] | 1u;
+    }
+
+    le_hashmap_Ref_t chainedRef = le_hashmap_Create("benchChained",
+                                                    MAP_CAPACITY,
+                                                    le_hashmap_HashUInt32,
+                                                    le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t compactRef = le_hashmap_CreateCompact("benchCompact",
+                                                           MAP_CAPACITY,
+                                                           le_hashmap_HashUInt32,
+                                                           le_hashmap_EqualsUInt32);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(loadEighths); i++)
+    {
+        size_t numEntries = TABLE_SIZE * loadEighths[i] / 8;
+
+        if (loadEighths[i] <= 6)
+        {
+            RunLoadFactor(chainedRef, "chained", numEntries);
+        }
+        RunLoadFactor(compactRef, "compact", numEntries);
+    }
+
+    le_hashmap_RemoveAll(chainedRef);
+    le_hashmap_RemoveAll(compactRef);
+}
@@ -0,0 +1,187 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hex conversion benchmarks.
+ *
+ * Measures le_hex_BinaryToString() and le_hex_StringToBinary() on buffers from 1 KB to 64 KB,
+ * next to a plain one-nibble-at-a-time implementation of the same conversions, so the gain of
+ * the library's table-driven and word-at-a-time code can be read directly from the results
+ * ("impl" is "le_hex" or "nibble").
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Largest binary buffer size.
+#define MAX_BINARY_SIZE     (64 * 1024)
+
+/// Number of binary bytes to convert for each buffer size.
+#define BYTES_PER_RUN       (64 * 1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffers converted back and forth.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Binary[MAX_BINARY_SIZE];
+static char String[(2 * MAX_BINARY_SIZE) + 1];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference encoder: one nibble at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NibbleBinaryToString
+(
+    const uint8_t* binaryPtr,   ///< [IN] Binary array to convert.
+    uint32_t binarySize,        ///< [IN] Size of the binary array.
+    char* stringPtr,            ///< [OUT] Hex string.
+    uint32_t stringSize         ///< [IN] Size of the string buffer.
+)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    uint32_t i;
+
+    if (stringSize < (2 * binarySize) + 1)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < binarySize; i++)
+    {
+        stringPtr[2 * i] = digits[binaryPtr[i] >> 4];
+        stringPtr[(2 * i) + 1] = digits[binaryPtr[i] & 0x0F];
+    }
+    stringPtr[2 * i] = '\0';
+
+    return 2 * i;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference decoder: one nibble at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NibbleStringToBinary
+(
+    const char* stringPtr,      ///< [IN] Hex string to convert.
+    uint32_t stringLength,      ///< [IN] Length of the string.
+    uint8_t* binaryPtr,         ///< [OUT] Binary result.
+    uint32_t binarySize         ///< [IN] Size of the binary buffer.
+)
+{
+    uint32_t i;
+
+    if (((stringLength % 2) != 0) || ((stringLength / 2) > binarySize))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < stringLength; i++)
+    {
+        char c = stringPtr[i];
+        uint8_t nibble;
+
+        if ((c >= '0') && (c <= '9'))
+        {
+            nibble = c - '0';
+        }
+        else if ((c >= 'A') && (c <= 'F'))
+        {
+            nibble = c - 'A' + 10;
+        }
+        else if ((c >= 'a') && (c <= 'f'))
+        {
+            nibble = c - 'a' + 10;
+        }
+        else
+        {
+            return -1;
+        }
+
+        if ((i % 2) == 0)
+        {
+            binaryPtr[i / 2] = nibble << 4;
+        }
+        else
+        {
+            binaryPtr[i / 2] |= nibble;
+        }
+    }
+
+    return stringLength / 2;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time the conversions of one implementation for one buffer size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunSize
+(
+    const char* impl,   ///< [IN] Name of the implementation, for the report.
+    int32_t (*encodeFunc)(const uint8_t*, uint32_t, char*, uint32_t), ///< [IN] Encoder.
+    int32_t (*decodeFunc)(const char*, uint32_t, uint8_t*, uint32_t), ///< [IN] Decoder.
+    size_t size         ///< [IN] Binary buffer size.
+)
+{
+    size_t numCalls = bench_Iterations(BYTES_PER_RUN / size);
+    size_t i;
+
+    uint64_t startNs = bench_NowNs();
+    for (i = 0; i < numCalls; i++)
+    {
+        LE_FATAL_IF(encodeFunc(Binary, size, String, sizeof(String)) != (int32_t)(2 * size),
+                    "Encoding failed.");
+    }
+    uint64_t elapsedNs = bench_NowNs() - startNs;
+
+    bench_Report("hex.encode", numCalls, elapsedNs,
+                 "\"impl\":\"%s\",\"bytes\":%zu,\"mbPerSec\":%.1f", impl, size,
+                 (elapsedNs == 0) ? 0.0 : ((double)size * numCalls * 1e3 / elapsedNs));
+
+    startNs = bench_NowNs();
+    for (i = 0; i < numCalls; i++)
+    {
+        LE_FATAL_IF(decodeFunc(String, 2 * size, Binary, sizeof(Binary)) != (int32_t)size,
+                    "Decoding failed.");
+    }
+    elapsedNs = bench_NowNs() - startNs;
+
+    bench_Report("hex.decode", numCalls, elapsedNs,
+                 "\"impl\":\"%s\",\"bytes\":%zu,\"mbPerSec\":%.1f", impl, size,
+                 (elapsedNs == 0) ? 0.0 : ((double)size * numCalls * 1e3 / elapsedNs));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the hex conversion benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunHex
+(
+    void
+)
+{
+    static const size_t sizes[] = { 1024, 4 * 1024, 16 * 1024, MAX_BINARY_SIZE };
+    size_t i;
+
+    for (i = 0; i < sizeof(Binary); i++)
+    {
+        Binary[i] = (uint8_t)(i * 131 + 17);
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(sizes); i++)
+    {
+        RunSize("nibble", NibbleBinaryToString, NibbleStringToBinary, sizes[i]);
+        RunSize("le_hex", le_hex_BinaryToString, le_hex_StringToBinary, sizes[i]);
+    }
+}
@@ -0,0 +1,347 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC benchmarks.
+ *
+ * A server thread and a client thread in this process talk to each other through the Low-Level
+ * Messaging API (the same way two processes would), and the client measures, for several payload
+ * sizes:
+ *
+ *  - the round-trip latency of synchronous requests (le_msg_RequestSyncResponse());
+ *  - the throughput of asynchronous requests (le_msg_RequestResponse()), keeping a fixed number
+ *    of them in flight at once.
+ *
+ * Each response is the same size as its request.  The client's "fwBenchmarkIpc" interface must be
+ * bound to the "fwBenchmarkIpc" service offered by the same user (see testFwBenchmark-Setup);
+ * otherwise the benchmarks are reported as skipped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Name of both the service and the client interface.
+#define INTERFACE_NAME      "fwBenchmarkIpc"
+
+#define PROTOCOL_ID_STR     "fwBenchmarkIpc"
+
+/// Largest payload sent.  This is the protocol's maximum message size.
+#define MAX_PAYLOAD_SIZE    16384
+
+/// Number of synchronous round trips timed for each payload size.
+#define NUM_ROUND_TRIPS     20000
+
+/// Number of asynchronous requests timed for each payload size.
+#define NUM_ASYNC_REQUESTS  50000
+
+/// Number of asynchronous requests kept in flight at once.
+#define WINDOW_SIZE         16
+
+/// How long to keep retrying to open the session while the service is being advertised.
+#define OPEN_RETRY_MS       10
+#define OPEN_MAX_RETRIES    200
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload sizes to test, in the order they are run.
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t PayloadSizes[] = { 16, 256, 4096, MAX_PAYLOAD_SIZE };
+
+
+static le_thread_Ref_t ServerThreadRef;     ///< Thread running the server.
+static le_msg_ServiceRef_t ServiceRef;      ///< Service offered by the server.
+static le_sem_Ref_t ServerReadySem;         ///< Posted when the server is advertising.
+
+static le_msg_SessionRef_t SessionRef;      ///< Client's session with the server.
+static size_t SizeIndex;                    ///< Index of the payload size being tested.
+static size_t NumIssued;                    ///< Number of async requests sent so far.
+static size_t NumCompleted;                 ///< Number of async responses received so far.
+static size_t NumRequests;                  ///< Number of async requests to send.
+static uint64_t StartNs;                    ///< Start time of the current async run.
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send every request straight back as its own response.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] Received request.
+    void*               contextPtr  ///< [IN] Not used.
+)
+{
+    le_msg_Respond(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the server.  Queued to the server thread by the client when it has finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerStop
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_msg_DeleteService(ServiceRef);
+
+    le_thread_Exit(NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server thread's main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServerThread
+(
+    void* contextPtr
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, MAX_PAYLOAD_SIZE);
+
+    ServiceRef = le_msg_CreateService(protocolRef, INTERFACE_NAME);
+    le_msg_SetServiceRecvHandler(ServiceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(ServiceRef);
+
+    le_sem_Post(ServerReadySem);
+
+    le_event_RunLoop();
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a request of a given size.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t CreateRequest
+(
+    size_t payloadSize
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+
+    le_msg_SetPayloadSize(msgRef, payloadSize);
+
+    return msgRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time synchronous round trips with a given payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunRoundTrips
+(
+    size_t payloadSize
+)
+{
+    size_t iterations = bench_Iterations(NUM_ROUND_TRIPS);
+    size_t i;
+
+    uint64_t startNs = bench_NowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        le_msg_MessageRef_t respRef = le_msg_RequestSyncResponse(CreateRequest(payloadSize));
+
+        LE_FATAL_IF(respRef == NULL, "Request failed.");
+        LE_FATAL_IF(le_msg_GetPayloadSize(respRef) != payloadSize, "Wrong response size.");
+
+        le_msg_ReleaseMsg(respRef);
+    }
+    uint64_t elapsedNs = bench_NowNs() - startNs;
+
+    bench_Report("ipc.roundTrip", iterations, elapsedNs, "\"payloadSize\":%zu", payloadSize);
+}
+
+
+static void ResponseHandler(le_msg_MessageRef_t msgRef, void* contextPtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the next asynchronous request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendAsyncRequest
+(
+    void
+)
+{
+    NumIssued++;
+
+    le_msg_RequestResponse(CreateRequest(PayloadSizes[SizeIndex]), ResponseHandler, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start timing asynchronous requests with the current payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartAsyncRun
+(
+    void
+)
+{
+    NumIssued = 0;
+    NumCompleted = 0;
+    NumRequests = bench_Iterations(NUM_ASYNC_REQUESTS);
+
+    StartNs = bench_NowNs();
+
+    while ((NumIssued < WINDOW_SIZE) && (NumIssued < NumRequests))
+    {
+        SendAsyncRequest();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the server and the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClientStop
+(
+    void
+)
+{
+    if (SessionRef != NULL)
+    {
+        le_msg_DeleteSession(SessionRef);
+        SessionRef = NULL;
+    }
+
+    le_event_QueueFunctionToThread(ServerThreadRef, ServerStop, NULL, NULL);
+
+    le_thread_Exit(NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive an asynchronous response, and keep the window full until the run is finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResponseHandler
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] Response (NULL if the request failed).
+    void*               contextPtr  ///< [IN] Not used.
+)
+{
+    LE_FATAL_IF(msgRef == NULL, "Request failed.");
+    le_msg_ReleaseMsg(msgRef);
+
+    NumCompleted++;
+
+    if (NumIssued < NumRequests)
+    {
+        SendAsyncRequest();
+    }
+    else if (NumCompleted == NumRequests)
+    {
+        uint64_t elapsedNs = bench_NowNs() - StartNs;
+
+        bench_Report("ipc.throughput", NumRequests, elapsedNs,
+                     "\"payloadSize\":%zu,\"window\":%d", PayloadSizes[SizeIndex], WINDOW_SIZE);
+
+        if (++SizeIndex < NUM_ARRAY_MEMBERS(PayloadSizes))
+        {
+            StartAsyncRun();
+        }
+        else
+        {
+            ClientStop();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client thread's main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ClientThread
+(
+    void* contextPtr
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, MAX_PAYLOAD_SIZE);
+    le_result_t result;
+    int retries = 0;
+
+    SessionRef = le_msg_CreateSession(protocolRef, INTERFACE_NAME);
+
+    // The server may not have finished advertising the service yet.
+    while (   (((result = le_msg_TryOpenSessionSync(SessionRef)) == LE_UNAVAILABLE)
+               || (result == LE_NOT_FOUND))
+           && (retries++ < OPEN_MAX_RETRIES) )
+    {
+        usleep(OPEN_RETRY_MS * 1000);
+    }
+
+    if (result != LE_OK)
+    {
+        bench_ReportSkipped("ipc", LE_RESULT_TXT(result));
+        ClientStop();
+    }
+
+    for (SizeIndex = 0; SizeIndex < NUM_ARRAY_MEMBERS(PayloadSizes); SizeIndex++)
+    {
+        RunRoundTrips(PayloadSizes[SizeIndex]);
+    }
+
+    SizeIndex = 0;
+    StartAsyncRun();
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the IPC benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunIpc
+(
+    void
+)
+{
+    ServerReadySem = le_sem_Create("benchServerReady", 0);
+
+    ServerThreadRef = le_thread_Create("ipcServer", ServerThread, NULL);
+    le_thread_SetJoinable(ServerThreadRef);
+    le_thread_Start(ServerThreadRef);
+
+    le_sem_Wait(ServerReadySem);
+
+    le_thread_Ref_t clientRef = le_thread_Create("ipcClient", ClientThread, NULL);
+    le_thread_SetJoinable(clientRef);
+    le_thread_Start(clientRef);
+
+    le_thread_Join(clientRef, NULL);
+    le_thread_Join(ServerThreadRef, NULL);
+
+    le_sem_Delete(ServerReadySem);
+}
@@ -0,0 +1,126 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Microbenchmarks for the core primitives of the Legato runtime library (liblegato.so).
+ *
+ * Runs each benchmark group in turn, printing one JSON object per result (see bench.h), then
+ * exits.  Options:
+ *
+ *  - @c -q / @c --quick : run roughly a tenth of the iterations (e.g., as a smoke test).
+ *  - @c -b / @c --bench=NAME : only run one group (mem, hashmap, timer, event, ipc, crc or hex).
+ *
+ * The ipc group needs the "fwBenchmarkIpc" interface to be bound to itself (see
+ * testFwBenchmark-Setup), and is reported as skipped otherwise.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+bool bench_Quick = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark groups, in the order they are run.
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    const char* name;
+    void (*runFunc)(void);
+}
+Groups[] =
+{
+    { "mem",        bench_RunMem },
+    { "hashmap",    bench_RunHashmap },
+    { "timer",      bench_RunTimer },
+    { "event",      bench_RunEvent },
+    { "ipc",        bench_RunIpc },
+    { "crc",        bench_RunCrc },
+    { "hex",        bench_RunHex },
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the result of one benchmark run.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_Report
+(
+    const char* name,       ///< [IN] Name of the benchmark.
+    uint64_t    ops,        ///< [IN] Number of operations timed.
+    uint64_t    elapsedNs,  ///< [IN] Time taken by all the operations, in nanoseconds.
+    const char* paramFormat,///< [IN] printf-style format of the benchmark's parameters.
+    ...
+)
+{
+    va_list args;
+
+    printf("{\"benchmark\":\"%s\",", name);
+
+    va_start(args, paramFormat);
+    if (vprintf(paramFormat, args) > 0)
+    {
+        putchar(',');
+    }
+    va_end(args);
+
+    printf("\"ops\":%" PRIu64 ",\"ns\":%" PRIu64 ",\"nsPerOp\":%.2f,\"opsPerSec\":%.0f}\n",
+           ops,
+           elapsedNs,
+           (ops == 0) ? 0.0 : (double)elapsedNs / ops,
+           (elapsedNs == 0) ? 0.0 : (double)ops * 1e9 / elapsedNs);
+
+    fflush(stdout);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a record saying that a benchmark could not be run.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_ReportSkipped
+(
+    const char* name,       ///< [IN] Name of the benchmark.
+    const char* reason      ///< [IN] Why it was skipped.
+)
+{
+    printf("{\"benchmark\":\"%s\",\"skipped\":\"%s\"}\n", name, reason);
+
+    fflush(stdout);
+}
+
+
+COMPONENT_INIT
+{
+    const char* onlyGroup = NULL;
+    size_t i;
+    bool found = false;
+
+    le_arg_SetFlagVar(&bench_Quick, "q", "quick");
+    le_arg_SetStringVar(&onlyGroup, "b", "bench");
+    le_arg_Scan();
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Groups); i++)
+    {
+        if ((onlyGroup == NULL) || (strcmp(onlyGroup, Groups[i].name) == 0))
+        {
+            LE_INFO("Running '%s' benchmarks.", Groups[i].name);
+            Groups[i].runFunc();
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        fprintf(stderr, "Unknown benchmark group '%s'.\n", onlyGroup);
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
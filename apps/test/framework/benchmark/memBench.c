@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool benchmarks.
+ *
+ * Measures the rate of le_mem_ForceAlloc()/le_mem_Release() pairs when several threads hammer the
+ * same pool at once, with and without per-thread caches.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Size of the objects allocated.
+#define OBJECT_SIZE         64
+
+/// Number of objects each thread holds at once.
+#define OBJECTS_PER_ITER    8
+
+/// Number of alloc/release rounds done by each thread.
+#define NUM_ITERATIONS      200000
+
+/// Largest number of threads run at once.
+#define MAX_THREADS         8
+
+/// Size of the per-thread caches, when enabled.
+#define THREAD_CACHE_SIZE   16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool being benchmarked.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t Pool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Posted once by the main thread to let each worker start.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t StartSem;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread: allocates and releases objects NUM_ITERATIONS times.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocReleaseThread
+(
+    void* contextPtr
+)
+{
+    size_t iterations = (size_t)contextPtr;
+    void* objs[OBJECTS_PER_ITER];
+    size_t i;
+    size_t j;
+
+    le_sem_Wait(StartSem);
+
+    for (i = 0; i < iterations; i++)
+    {
+        for (j = 0; j < OBJECTS_PER_ITER; j++)
+        {
+            objs[j] = le_mem_ForceAlloc(Pool);
+        }
+        for (j = 0; j < OBJECTS_PER_ITER; j++)
+        {
+            le_mem_Release(objs[j]);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time a number of threads allocating and releasing from the pool at the same time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunAllocRelease
+(
+    size_t numThreads,  ///< [IN] Number of threads.
+    size_t cacheSize    ///< [IN] Per-thread cache size (0 = no cache).
+)
+{
+    le_thread_Ref_t threads[MAX_THREADS];
+    size_t iterations = bench_Iterations(NUM_ITERATIONS);
+    size_t i;
+
+    char poolName[32];
+    snprintf(poolName, sizeof(poolName), "bench%zu_%zu", numThreads, cacheSize);
+    Pool = le_mem_CreatePool(poolName, OBJECT_SIZE);
+    if (cacheSize > 0)
+    {
+        le_mem_SetThreadCacheSize(Pool, cacheSize);
+    }
+    le_mem_ExpandPool(Pool, numThreads * (OBJECTS_PER_ITER + cacheSize));
+
+    StartSem = le_sem_Create("benchStart", 0);
+
+    for (i = 0; i < numThreads; i++)
+    {
+        char threadName[32];
+        snprintf(threadName, sizeof(threadName), "memBench%zu", i);
+        threads[i] = le_thread_Create(threadName, AllocReleaseThread, (void*)iterations);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+    }
+
+    uint64_t startNs = bench_NowNs();
+
+    for (i = 0; i < numThreads; i++)
+    {
+        le_sem_Post(StartSem);
+    }
+    for (i = 0; i < numThreads; i++)
+    {
+        le_thread_Join(threads[i], NULL);
+    }
+
+    uint64_t elapsedNs = bench_NowNs() - startNs;
+
+    bench_Report("mem.allocRelease",
+                 (uint64_t)numThreads * iterations * OBJECTS_PER_ITER,
+                 elapsedNs,
+                 "\"threads\":%zu,\"cacheSize\":%zu,\"objectSize\":%d",
+                 numThreads,
+                 cacheSize,
+                 OBJECT_SIZE);
+
+    // Pools can't be deleted, so each run leaves its (unused) pool behind.
+    le_sem_Delete(StartSem);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the memory pool benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunMem
+(
+    void
+)
+{
+    size_t numThreads;
+
+    for (numThreads = 1; numThreads <= MAX_THREADS; numThreads *= 2)
+    {
+        RunAllocRelease(numThreads, 0);
+        RunAllocRelease(numThreads, THREAD_CACHE_SIZE);
+    }
+}
@@ -0,0 +1,131 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer benchmarks.
+ *
+ * Measures le_timer_Start()/le_timer_Stop() pairs on one timer while a number of other timers are
+ * running in the same thread.  The timer is started both with the shortest interval (so it
+ * becomes the next one to expire) and with the longest.  None of the timers ever expires.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bench.h"
+
+
+/// Largest number of other timers running at once.
+#define MAX_ACTIVE_TIMERS   1000
+
+/// Number of start/stop pairs timed for each case.
+#define NUM_ITERATIONS      200000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timers running in the background.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t ActiveTimers[MAX_ACTIVE_TIMERS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry handler.  Should never be called.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_FATAL("Timer expired during benchmark.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a timer that won't expire for at least an hour.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t CreateTimer
+(
+    const char* name,       ///< [IN] Name of the timer.
+    time_t      seconds     ///< [IN] Interval, in seconds (added to an hour).
+)
+{
+    le_clk_Time_t interval = { .sec = 3600 + seconds, .usec = 0 };
+
+    le_timer_Ref_t timerRef = le_timer_Create(name);
+    le_timer_SetHandler(timerRef, ExpiryHandler);
+    le_timer_SetInterval(timerRef, interval);
+
+    return timerRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time start/stop pairs on one timer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunStartStop
+(
+    size_t      numActive,  ///< [IN] Number of other timers that are running.
+    bool        isFirst     ///< [IN] true if the timer should expire before all others.
+)
+{
+    size_t iterations = bench_Iterations(NUM_ITERATIONS);
+    size_t i;
+
+    le_timer_Ref_t timerRef = CreateTimer("benchTimer", isFirst ? 0 : 2 * MAX_ACTIVE_TIMERS);
+
+    uint64_t startNs = bench_NowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        le_timer_Start(timerRef);
+        le_timer_Stop(timerRef);
+    }
+    uint64_t elapsedNs = bench_NowNs() - startNs;
+
+    bench_Report("timer.startStop", iterations, elapsedNs,
+                 "\"activeTimers\":%zu,\"position\":\"%s\"",
+                 numActive, isFirst ? "first" : "last");
+
+    le_timer_Delete(timerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the timer benchmarks.
+ */
+//--------------------------------------------------------------------------------------------------
+void bench_RunTimer
+(
+    void
+)
+{
+    size_t numActive = 0;
+    size_t target;
+
+    for (target = 0; target <= MAX_ACTIVE_TIMERS; target = (target == 0) ? 10 : target * 10)
+    {
+        // Start more background timers, each one with a different expiry time.
+        for (; numActive < target; numActive++)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "active%zu", numActive);
+            ActiveTimers[numActive] = CreateTimer(name, 1 + numActive);
+            le_timer_Start(ActiveTimers[numActive]);
+        }
+
+        RunStartStop(numActive, true);
+        RunStartStop(numActive, false);
+    }
+
+    while (numActive > 0)
+    {
+        le_timer_Delete(ActiveTimers[--numActive]);
+    }
+}
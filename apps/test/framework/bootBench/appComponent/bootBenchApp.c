@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------------------------------
+/** @file bootBenchApp.c
+ *
+ * App started, restarted and installed by the boot benchmark.  It does nothing, except faulting
+ * once after it has started if the benchmark asked it to (so that the Supervisor restarts it).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File created by the benchmark to make the app fault once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CRASH_FLAG_FILE     "/tmp/bootBenchApp.crash"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fault.  Queued rather than done in the initializer, so that the start-up trace records that the
+ * initializers have returned first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Crash
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    LE_FATAL("Faulting as asked by the boot benchmark.");
+}
+
+
+COMPONENT_INIT
+{
+    if (unlink(CRASH_FLAG_FILE) == 0)
+    {
+        le_event_QueueFunction(Crash, NULL, NULL);
+    }
+}
@@ -0,0 +1,586 @@
+//--------------------------------------------------------------------------------------------------
+/** @file bootBench.c
+ *
+ * Boot-time and app start-up benchmark.
+ *
+ * Run on the target with:
+ *
+ *     app runProc bootBench bootBench -- [--package=<app update file>] [--iterations=<n>]
+ *                                        [--output=<results file>]
+ *
+ * Timings are taken from the start-up trace that the framework library writes to the runtime
+ * directory (see "inspect startup"), so that they are measured where they happen rather than from
+ * the outside.  The benchmark reports:
+ *
+ * - boot.<daemon>: when each framework daemon finished initializing in the last system start, in
+ *   microseconds since boot and since startSystem was exec'd;
+ * - app.start: from asking the Supervisor to start bootBenchApp until its initializers returned;
+ * - app.restart: from bootBenchApp faulting until its restarted process initialized;
+ * - app.install and app.installToRunning: from running "update" on the app's update package
+ *   (if --package is given) until the update tool returned, and until the app initialized.
+ *
+ * Results are printed as one JSON object per line, to stdout and to the output file if any, so
+ * that they can be collected and compared from one build to the next.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start-up trace file (see startupTrace.h).
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACE_FILE              STRINGIZE(LE_RUNTIME_DIR) "startupTrace"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the app being started, restarted and installed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_NAME                "bootBenchApp"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File that makes bootBenchApp fault once after it has started.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CRASH_FLAG_FILE         "/tmp/bootBenchApp.crash"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update tool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UPDATE_TOOL             "/legato/systems/current/bin/update"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How long to wait for something to happen before giving up, and how often to check.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMEOUT_US              (30 * 1000000ULL)
+#define POLL_INTERVAL_US        10000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Framework daemons whose initialization is reported, in the order they are started.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const Daemons[] =
+{
+    "supervisor",
+    "serviceDirectory",
+    "logCtrlDaemon",
+    "configTree",
+    "updateDaemon",
+    "watchdog",
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latency statistics of a benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int      count;         ///< Number of samples.
+    uint64_t minUs;         ///< Lowest sample.
+    uint64_t maxUs;         ///< Highest sample.
+    uint64_t sumUs;         ///< Sum of the samples.
+}
+Stats_t;
+
+
+static const char* PackagePath = NULL;  ///< App update package, or NULL to skip install timing.
+static const char* OutputPath = NULL;   ///< Results file, or NULL to print the results only.
+static int Iterations = 5;              ///< Number of samples of each app benchmark.
+static FILE* OutputFile = NULL;         ///< Results file.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the clock used by the start-up trace.
+ *
+ * @return The time since boot, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NowUs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    LE_FATAL_IF(clock_gettime(CLOCK_BOOTTIME, &ts) != 0, "clock_gettime() failed (%m).");
+
+    return ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current size of the start-up trace, so that only the entries added after now are
+ * searched.
+ *
+ * @return The size of the trace in bytes, or 0 if there is no trace yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static long TraceSize
+(
+    void
+)
+{
+    struct stat st;
+
+    if (stat(TRACE_FILE, &st) != 0)
+    {
+        return 0;
+    }
+
+    return (long)st.st_size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find an entry in the start-up trace.
+ *
+ * @return
+ *      - LE_OK if the entry was found.
+ *      - LE_NOT_FOUND if it wasn't.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FindEntry
+(
+    long offset,                ///< [IN] Where to start searching.
+    const char* procNamePtr,    ///< [IN] Process name.
+    const char* eventPtr,       ///< [IN] Event name.
+    bool findLast,              ///< [IN] true to find the last matching entry, not the first.
+    uint64_t* timeUsPtr,        ///< [OUT] Time of the entry.
+    long* nextOffsetPtr         ///< [OUT] Offset of the next entry, or NULL.
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+    FILE* filePtr = fopen(TRACE_FILE, "r");
+
+    if (filePtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (fseek(filePtr, offset, SEEK_SET) == 0)
+    {
+        char line[256];
+
+        while (fgets(line, sizeof(line), filePtr) != NULL)
+        {
+            uint64_t timeUs;
+            int pid;
+            char procName[64];
+            char event[16];
+
+            if ((sscanf(line, "%" SCNu64 " %d %63s %15s", &timeUs, &pid, procName, event) == 4)
+                && (strcmp(procName, procNamePtr) == 0)
+                && (strcmp(event, eventPtr) == 0))
+            {
+                *timeUsPtr = timeUs;
+                if (nextOffsetPtr != NULL)
+                {
+                    *nextOffsetPtr = ftell(filePtr);
+                }
+                result = LE_OK;
+
+                if (!findLast)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    fclose(filePtr);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for an entry to be added to the start-up trace.
+ *
+ * @return
+ *      - LE_OK if the entry was found.
+ *      - LE_TIMEOUT if it didn't show up in time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitForEntry
+(
+    long offset,                ///< [IN] Where to start searching.
+    const char* procNamePtr,    ///< [IN] Process name.
+    const char* eventPtr,       ///< [IN] Event name.
+    uint64_t* timeUsPtr,        ///< [OUT] Time of the entry.
+    long* nextOffsetPtr         ///< [OUT] Offset of the next entry, or NULL.
+)
+{
+    uint64_t deadlineUs = NowUs() + TIMEOUT_US;
+
+    while (FindEntry(offset, procNamePtr, eventPtr, false, timeUsPtr, nextOffsetPtr) != LE_OK)
+    {
+        if (NowUs() >= deadlineUs)
+        {
+            LE_ERROR("No '%s %s' entry in the start-up trace.", procNamePtr, eventPtr);
+            return LE_TIMEOUT;
+        }
+
+        usleep(POLL_INTERVAL_US);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the benchmarked app to reach a state.
+ *
+ * @return
+ *      - LE_OK if it did.
+ *      - LE_TIMEOUT if it didn't in time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitForAppState
+(
+    le_appInfo_State_t state    ///< [IN] State to wait for.
+)
+{
+    uint64_t deadlineUs = NowUs() + TIMEOUT_US;
+
+    while (le_appInfo_GetState(APP_NAME) != state)
+    {
+        if (NowUs() >= deadlineUs)
+        {
+            LE_ERROR("App '%s' didn't reach state %d.", APP_NAME, state);
+            return LE_TIMEOUT;
+        }
+
+        usleep(POLL_INTERVAL_US);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the benchmarked app, if it is running, and wait until it has stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopApp
+(
+    void
+)
+{
+    if (le_appInfo_GetState(APP_NAME) == LE_APPINFO_RUNNING)
+    {
+        le_appCtrl_Stop(APP_NAME);
+    }
+
+    LE_FATAL_IF(WaitForAppState(LE_APPINFO_STOPPED) != LE_OK, "Couldn't stop '%s'.", APP_NAME);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a line of results to stdout and to the output file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Output
+(
+    const char* formatPtr,      ///< [IN] printf-style format of the line, without the new line.
+    ...
+)
+{
+    char line[256];
+    va_list args;
+
+    va_start(args, formatPtr);
+    vsnprintf(line, sizeof(line), formatPtr, args);
+    va_end(args);
+
+    printf("%s\n", line);
+
+    if (OutputFile != NULL)
+    {
+        fprintf(OutputFile, "%s\n", line);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a sample to latency statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddSample
+(
+    Stats_t* statsPtr,          ///< [IN] Statistics.
+    uint64_t us                 ///< [IN] Sample.
+)
+{
+    if ((statsPtr->count == 0) || (us < statsPtr->minUs))
+    {
+        statsPtr->minUs = us;
+    }
+    if (us > statsPtr->maxUs)
+    {
+        statsPtr->maxUs = us;
+    }
+    statsPtr->sumUs += us;
+    statsPtr->count++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report latency statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportStats
+(
+    const char* namePtr,        ///< [IN] Benchmark name.
+    const Stats_t* statsPtr     ///< [IN] Statistics.
+)
+{
+    if (statsPtr->count == 0)
+    {
+        LE_ERROR("No samples for '%s'.", namePtr);
+        return;
+    }
+
+    Output("{\"benchmark\":\"%s\",\"iterations\":%d,\"minUs\":%" PRIu64 ",\"meanUs\":%" PRIu64
+           ",\"maxUs\":%" PRIu64 "}",
+           namePtr, statsPtr->count, statsPtr->minUs, statsPtr->sumUs / statsPtr->count,
+           statsPtr->maxUs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report when each framework daemon finished initializing in the last system start.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchBoot
+(
+    void
+)
+{
+    uint64_t startUs;
+    long offset;
+    size_t i;
+
+    if (FindEntry(0, "startSystem", "exec", true, &startUs, &offset) != LE_OK)
+    {
+        LE_ERROR("The start-up trace has no record of the system start.");
+        return;
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Daemons); i++)
+    {
+        uint64_t timeUs;
+
+        // Daemons that have no initializers to run only record when they entered their loop.
+        if ((FindEntry(offset, Daemons[i], "init", false, &timeUs, NULL) != LE_OK) &&
+            (FindEntry(offset, Daemons[i], "loop", false, &timeUs, NULL) != LE_OK))
+        {
+            LE_WARN("No start-up of '%s' in the trace.", Daemons[i]);
+            continue;
+        }
+
+        Output("{\"benchmark\":\"boot.%s\",\"usSinceBoot\":%" PRIu64 ",\"usSinceStart\":%" PRIu64
+               "}",
+               Daemons[i], timeUs, timeUs - startUs);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time how long the app takes to start, from the Supervisor being asked to start it until its
+ * initializers have returned.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchStart
+(
+    void
+)
+{
+    Stats_t stats = { 0 };
+    int i;
+
+    for (i = 0; i < Iterations; i++)
+    {
+        uint64_t initUs;
+
+        StopApp();
+
+        long offset = TraceSize();
+        uint64_t startUs = NowUs();
+
+        LE_FATAL_IF(le_appCtrl_Start(APP_NAME) != LE_OK, "Couldn't start '%s'.", APP_NAME);
+
+        if (WaitForEntry(offset, APP_NAME, "init", &initUs, NULL) == LE_OK)
+        {
+            AddSample(&stats, initUs - startUs);
+        }
+    }
+
+    StopApp();
+
+    ReportStats("app.start", &stats);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time how long the Supervisor takes to restart the app after a fault, from the faulting process
+ * having initialized until the new one has.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchRestart
+(
+    void
+)
+{
+    Stats_t stats = { 0 };
+    int i;
+
+    for (i = 0; i < Iterations; i++)
+    {
+        uint64_t firstInitUs;
+        uint64_t secondInitUs;
+
+        StopApp();
+
+        int fd = open(CRASH_FLAG_FILE, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        LE_FATAL_IF(fd < 0, "Couldn't create '%s' (%m).", CRASH_FLAG_FILE);
+        close(fd);
+
+        long offset = TraceSize();
+
+        LE_FATAL_IF(le_appCtrl_Start(APP_NAME) != LE_OK, "Couldn't start '%s'.", APP_NAME);
+
+        if ((WaitForEntry(offset, APP_NAME, "init", &firstInitUs, &offset) == LE_OK) &&
+            (WaitForEntry(offset, APP_NAME, "init", &secondInitUs, NULL) == LE_OK))
+        {
+            AddSample(&stats, secondInitUs - firstInitUs);
+        }
+    }
+
+    StopApp();
+    unlink(CRASH_FLAG_FILE);
+
+    ReportStats("app.restart", &stats);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time how long it takes to install the app and have it running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchInstall
+(
+    void
+)
+{
+    Stats_t installStats = { 0 };
+    Stats_t runningStats = { 0 };
+    char command[PATH_MAX + sizeof(UPDATE_TOOL) + 1];
+    int i;
+
+    LE_FATAL_IF(snprintf(command, sizeof(command), "%s %s", UPDATE_TOOL, PackagePath)
+                >= (int)sizeof(command),
+                "Package path '%s' is too long.", PackagePath);
+
+    for (i = 0; i < Iterations; i++)
+    {
+        uint64_t initUs;
+
+        StopApp();
+        LE_FATAL_IF(system("/legato/systems/current/bin/app remove " APP_NAME) != 0,
+                    "Couldn't remove '%s'.", APP_NAME);
+
+        long offset = TraceSize();
+        uint64_t startUs = NowUs();
+
+        LE_FATAL_IF(system(command) != 0, "Couldn't install '%s'.", PackagePath);
+
+        AddSample(&installStats, NowUs() - startUs);
+
+        // Installing only starts apps that start automatically once the system is marked good.
+        if (FindEntry(offset, APP_NAME, "init", false, &initUs, NULL) != LE_OK)
+        {
+            if (le_appInfo_GetState(APP_NAME) != LE_APPINFO_RUNNING)
+            {
+                LE_FATAL_IF(le_appCtrl_Start(APP_NAME) != LE_OK,
+                            "Couldn't start '%s'.", APP_NAME);
+            }
+
+            if (WaitForEntry(offset, APP_NAME, "init", &initUs, NULL) != LE_OK)
+            {
+                continue;
+            }
+        }
+
+        AddSample(&runningStats, initUs - startUs);
+    }
+
+    StopApp();
+
+    ReportStats("app.install", &installStats);
+    ReportStats("app.installToRunning", &runningStats);
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetStringVar(&PackagePath, NULL, "package");
+    le_arg_SetStringVar(&OutputPath, NULL, "output");
+    le_arg_SetIntVar(&Iterations, "n", "iterations");
+    le_arg_Scan();
+
+    LE_FATAL_IF(Iterations < 1, "Number of iterations must be at least 1.");
+
+    if (OutputPath != NULL)
+    {
+        OutputFile = fopen(OutputPath, "w");
+        LE_FATAL_IF(OutputFile == NULL, "Couldn't open '%s' (%m).", OutputPath);
+    }
+
+    BenchBoot();
+    BenchStart();
+    BenchRestart();
+
+    if (PackagePath != NULL)
+    {
+        BenchInstall();
+    }
+
+    if (OutputFile != NULL)
+    {
+        fclose(OutputFile);
+    }
+
+    exit(EXIT_SUCCESS);
+}
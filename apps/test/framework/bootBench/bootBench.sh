@@ -0,0 +1,79 @@
+#!/bin/bash
+
+# Boot-time and app start-up benchmark.
+#
+# Usage: bootBench.sh <target address> [<target type>] [--reboot]
+#
+# With --reboot, the target is rebooted first so that the boot timings are those of a cold boot.
+# The results are printed as JSON lines and left in bootBench.<target type>.json.
+
+LoadTestLib
+
+targetAddr=$1
+targetType=${2:-ar7}
+reboot=$3
+
+OnFail() {
+    echo "Boot Benchmark Failed!"
+}
+
+if [ "$LEGATO_ROOT" == "" ]
+then
+    if [ "$WORKSPACE" == "" ]
+    then
+        echo "Neither LEGATO_ROOT nor WORKSPACE are defined." >&2
+        exit 1
+    else
+        LEGATO_ROOT="$WORKSPACE"
+    fi
+fi
+
+echo "******** Boot Benchmark Starting ***********"
+
+if [ "$reboot" == "--reboot" ]
+then
+    echo "Rebooting the target."
+    ssh root@$targetAddr "/sbin/reboot"
+    sleep 10
+
+    for i in $(seq 1 60)
+    do
+        if ssh -o ConnectTimeout=2 root@$targetAddr "$BIN_PATH/legato status" > /dev/null 2>&1
+        then
+            break
+        fi
+        sleep 2
+    done
+fi
+
+echo "Make sure Legato is running."
+ssh root@$targetAddr "$BIN_PATH/legato start"
+CheckRet
+
+appDir="$LEGATO_ROOT/build/$targetType/tests/apps"
+cd "$appDir"
+CheckRet
+
+echo "Install the benchmark and the app it starts."
+InstallApp bootBench
+InstallApp bootBenchApp
+
+scp "bootBenchApp.$targetType.update" "root@$targetAddr:/tmp/bootBenchApp.update"
+CheckRet
+
+echo "Run the benchmark."
+ssh root@$targetAddr "$BIN_PATH/app runProc bootBench bootBench -- \
+                          --package=/tmp/bootBenchApp.update --output=/tmp/bootBench.json"
+CheckRet
+
+scp "root@$targetAddr:/tmp/bootBench.json" "bootBench.$targetType.json"
+CheckRet
+
+cat "bootBench.$targetType.json"
+
+echo "Clean up."
+ssh root@$targetAddr "rm -f /tmp/bootBenchApp.update /tmp/bootBench.json; \
+                      $BIN_PATH/app remove bootBenchApp; $BIN_PATH/app remove bootBench"
+
+echo "Boot Benchmark Passed!"
+exit 0
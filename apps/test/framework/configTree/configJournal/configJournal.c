@@ -0,0 +1,434 @@
+/**
+ * Test for the journals the configTree keeps of the changes committed to its trees.
+ *
+ * Writes batches of entries to a journal in a temporary directory and replays them, then cuts the
+ * journal off in the middle of its last entry, as if the power went while it was being written,
+ * and checks that only the complete entries are replayed, that the partial one is cut off the
+ * file, and that batches appended afterwards replay after the complete entries.  Also checks that
+ * a corrupt entry stops the replay, and that a journal for another revision of the tree, or with a
+ * partial header, is thrown away.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "treeJournal.h"
+
+
+/// Revision of the snapshot the test journal applies to.
+#define BASE_REVISION       7
+
+/// Maximum number of entries the test replays from a journal.
+#define MAX_ENTRIES         16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Entries replayed from a journal.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t            numEntries;                   ///< Number of entries replayed.
+    jrnl_Op_t         ops[MAX_ENTRIES];             ///< Operations of the entries.
+    le_cfg_nodeType_t types[MAX_ENTRIES];           ///< Node types of the entries.
+    char              paths[MAX_ENTRIES][64];       ///< Paths of the entries.
+    char              newNames[MAX_ENTRIES][32];    ///< New names, "" if not renamed.
+    char              values[MAX_ENTRIES][32];      ///< Values, "" if left alone.
+}
+Replayed_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the temporary directory, and of the journal in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static char DirPath[] = "/tmp/configJournalTestXXXXXX";
+static char JournalPath[PATH_MAX];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Collects replayed entries into a Replayed_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CollectEntry
+(
+    const jrnl_Entry_t* entryPtr,
+    void* contextPtr
+)
+{
+    Replayed_t* replayedPtr = contextPtr;
+    size_t i = replayedPtr->numEntries;
+
+    LE_ASSERT(i < MAX_ENTRIES);
+
+    replayedPtr->ops[i] = entryPtr->op;
+    replayedPtr->types[i] = entryPtr->type;
+    LE_ASSERT(le_utf8_Copy(replayedPtr->paths[i], entryPtr->pathPtr,
+                           sizeof(replayedPtr->paths[i]), NULL) == LE_OK);
+    LE_ASSERT(le_utf8_Copy(replayedPtr->newNames[i],
+                           (entryPtr->newNamePtr != NULL) ? entryPtr->newNamePtr : "",
+                           sizeof(replayedPtr->newNames[i]), NULL) == LE_OK);
+    LE_ASSERT(le_utf8_Copy(replayedPtr->values[i],
+                           (entryPtr->valuePtr != NULL) ? entryPtr->valuePtr : "",
+                           sizeof(replayedPtr->values[i]), NULL) == LE_OK);
+
+    replayedPtr->numEntries++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replays the test journal.
+ *
+ * @return The result of jrnl_Replay().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Replay
+(
+    int baseRevision,
+    Replayed_t* replayedPtr,
+    size_t* journalSizePtr
+)
+{
+    memset(replayedPtr, 0, sizeof(*replayedPtr));
+
+    return jrnl_Replay(JournalPath, baseRevision, CollectEntry, replayedPtr, journalSizePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the test journal file.
+ *
+ * @return The size in bytes, or -1 if there is no journal.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t JournalFileSize
+(
+    void
+)
+{
+    struct stat s;
+
+    if (stat(JournalPath, &s) == -1)
+    {
+        LE_ASSERT(errno == ENOENT);
+        return -1;
+    }
+
+    return s.st_size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends a batch of one string node per value to the test journal, as a commit would.
+ *
+ * @return The size of the journal afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t WriteSetBatch
+(
+    size_t journalSize,
+    const char* const* valuesPtr,
+    size_t numValues
+)
+{
+    size_t i;
+
+    for (i = 0; i < numValues; i++)
+    {
+        char path[64];
+        LE_ASSERT(snprintf(path, sizeof(path), "/test/node%s", valuesPtr[i]) < sizeof(path));
+
+        jrnl_Entry_t entry =
+            {
+                .op = JRNL_SET_NODE,
+                .pathPtr = path,
+                .newNamePtr = NULL,
+                .type = LE_CFG_TYPE_STRING,
+                .valuePtr = valuesPtr[i]
+            };
+
+        jrnl_AddEntry(&entry);
+    }
+
+    jrnl_BatchRef_t batchRef = jrnl_TakePending();
+    size_t newSize = jrnl_GetSizeAfter(journalSize, batchRef);
+
+    LE_ASSERT(jrnl_WriteBatch(JournalPath, BASE_REVISION, batchRef, journalSize) == LE_OK);
+    jrnl_DeleteBatch(batchRef);
+
+    LE_ASSERT(JournalFileSize() == (off_t)newSize);
+
+    return newSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the first replayed entries are string nodes set to the given values, in order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckSetEntries
+(
+    const Replayed_t* replayedPtr,
+    const char* const* valuesPtr,
+    size_t numValues
+)
+{
+    size_t i;
+
+    LE_TEST(replayedPtr->numEntries >= numValues);
+
+    for (i = 0; (i < numValues) && (i < replayedPtr->numEntries); i++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "/test/node%s", valuesPtr[i]);
+
+        LE_TEST(   (replayedPtr->ops[i] == JRNL_SET_NODE)
+                && (replayedPtr->types[i] == LE_CFG_TYPE_STRING)
+                && (strcmp(replayedPtr->paths[i], path) == 0)
+                && (strcmp(replayedPtr->newNames[i], "") == 0)
+                && (strcmp(replayedPtr->values[i], valuesPtr[i]) == 0));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes entries of each kind and replays them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestReplay
+(
+    void
+)
+{
+    static const char* const Values[] = { "a", "b" };
+    Replayed_t replayed;
+    size_t journalSize = 0;
+
+    // Nothing to replay yet.
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_NOT_FOUND);
+    LE_TEST(journalSize == 0);
+
+    journalSize = WriteSetBatch(0, Values, NUM_ARRAY_MEMBERS(Values));
+
+    jrnl_Entry_t renameEntry =
+        {
+            .op = JRNL_SET_NODE,
+            .pathPtr = "/test/stem",
+            .newNamePtr = "renamed",
+            .type = LE_CFG_TYPE_STEM,
+            .valuePtr = NULL
+        };
+    jrnl_Entry_t deleteEntry =
+        {
+            .op = JRNL_DELETE_NODE,
+            .pathPtr = "/test/gone",
+            .newNamePtr = NULL,
+            .type = LE_CFG_TYPE_EMPTY,
+            .valuePtr = NULL
+        };
+
+    jrnl_AddEntry(&renameEntry);
+    jrnl_AddEntry(&deleteEntry);
+    LE_TEST(jrnl_GetPendingSize() > 0);
+
+    jrnl_BatchRef_t batchRef = jrnl_TakePending();
+    LE_TEST(jrnl_GetPendingSize() == 0);
+
+    size_t newSize = jrnl_GetSizeAfter(journalSize, batchRef);
+    LE_TEST(jrnl_WriteBatch(JournalPath, BASE_REVISION, batchRef, journalSize) == LE_OK);
+    jrnl_DeleteBatch(batchRef);
+    LE_TEST(JournalFileSize() == (off_t)newSize);
+
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(journalSize == newSize);
+    LE_TEST(replayed.numEntries == 4);
+    CheckSetEntries(&replayed, Values, 2);
+    LE_TEST(   (replayed.ops[2] == JRNL_SET_NODE)
+            && (replayed.types[2] == LE_CFG_TYPE_STEM)
+            && (strcmp(replayed.paths[2], "/test/stem") == 0)
+            && (strcmp(replayed.newNames[2], "renamed") == 0)
+            && (strcmp(replayed.values[2], "") == 0));
+    LE_TEST(   (replayed.ops[3] == JRNL_DELETE_NODE)
+            && (strcmp(replayed.paths[3], "/test/gone") == 0));
+
+    // Entries that were never written are thrown away.
+    jrnl_AddEntry(&deleteEntry);
+    jrnl_DiscardPending();
+    LE_TEST(jrnl_GetPendingSize() == 0);
+
+    jrnl_Delete(JournalPath);
+    LE_TEST(JournalFileSize() == -1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cuts a journal off in the middle of its last entry, and replays it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTruncated
+(
+    void
+)
+{
+    static const char* const FirstValues[] = { "1", "2" };
+    static const char* const LastValues[] = { "3" };
+    static const char* const AllValues[] = { "1", "2", "4", "5" };
+    static const char* const NewValues[] = { "4", "5" };
+    Replayed_t replayed;
+    size_t journalSize;
+
+    size_t completeSize = WriteSetBatch(0, FirstValues, NUM_ARRAY_MEMBERS(FirstValues));
+    size_t fullSize = WriteSetBatch(completeSize, LastValues, NUM_ARRAY_MEMBERS(LastValues));
+
+    // Every cut inside the last entry, down to its header, leaves only the first batch.
+    size_t cutSize;
+
+    for (cutSize = fullSize - 1; cutSize > completeSize; cutSize--)
+    {
+        LE_ASSERT(truncate(JournalPath, cutSize) == 0);
+
+        LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+        LE_TEST(replayed.numEntries == NUM_ARRAY_MEMBERS(FirstValues));
+        CheckSetEntries(&replayed, FirstValues, NUM_ARRAY_MEMBERS(FirstValues));
+        LE_TEST(journalSize == completeSize);
+
+        // The partial entry is cut off the file.
+        LE_TEST(JournalFileSize() == (off_t)completeSize);
+
+        // Put it back for the next cut.
+        LE_ASSERT(WriteSetBatch(completeSize, LastValues, NUM_ARRAY_MEMBERS(LastValues))
+                  == fullSize);
+    }
+
+    // Replaying a cut journal a second time gives the same entries.
+    LE_ASSERT(truncate(JournalPath, fullSize - 1) == 0);
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(replayed.numEntries == NUM_ARRAY_MEMBERS(FirstValues));
+    CheckSetEntries(&replayed, FirstValues, NUM_ARRAY_MEMBERS(FirstValues));
+    LE_TEST(journalSize == completeSize);
+
+    // The next commit is appended right after the complete entries.
+    LE_TEST(WriteSetBatch(journalSize, NewValues, NUM_ARRAY_MEMBERS(NewValues)) > completeSize);
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(replayed.numEntries == NUM_ARRAY_MEMBERS(AllValues));
+    CheckSetEntries(&replayed, AllValues, NUM_ARRAY_MEMBERS(AllValues));
+    LE_TEST(journalSize == (size_t)JournalFileSize());
+
+    jrnl_Delete(JournalPath);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Corrupts an entry in the middle of a journal, and replays it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCorrupt
+(
+    void
+)
+{
+    static const char* const FirstValues[] = { "x" };
+    static const char* const OtherValues[] = { "y", "z" };
+    Replayed_t replayed;
+    size_t journalSize;
+
+    size_t firstSize = WriteSetBatch(0, FirstValues, NUM_ARRAY_MEMBERS(FirstValues));
+    size_t secondSize = WriteSetBatch(firstSize, OtherValues, 1);
+    WriteSetBatch(secondSize, OtherValues + 1, 1);
+
+    // Flip the last byte of the second entry, (the end of its value.)
+    int fd = open(JournalPath, O_RDWR);
+    LE_ASSERT(fd >= 0);
+
+    uint8_t byte;
+    LE_ASSERT(pread(fd, &byte, 1, secondSize - 1) == 1);
+    byte ^= 0xff;
+    LE_ASSERT(pwrite(fd, &byte, 1, secondSize - 1) == 1);
+    LE_ASSERT(close(fd) == 0);
+
+    // Nothing from the bad entry on is replayed, even though the entry after it is intact.
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(replayed.numEntries == NUM_ARRAY_MEMBERS(FirstValues));
+    CheckSetEntries(&replayed, FirstValues, NUM_ARRAY_MEMBERS(FirstValues));
+    LE_TEST(journalSize == firstSize);
+    LE_TEST(JournalFileSize() == (off_t)firstSize);
+
+    jrnl_Delete(JournalPath);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replays journals that can't be used, which are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestStale
+(
+    void
+)
+{
+    static const char* const Values[] = { "s" };
+    Replayed_t replayed;
+    size_t journalSize;
+
+    // The tree was saved again after the journal was written.
+    WriteSetBatch(0, Values, NUM_ARRAY_MEMBERS(Values));
+
+    LE_TEST(Replay(BASE_REVISION + 1, &replayed, &journalSize) == LE_NOT_FOUND);
+    LE_TEST(replayed.numEntries == 0);
+    LE_TEST(journalSize == 0);
+    LE_TEST(JournalFileSize() == -1);
+
+    // The power went while the journal's header was being written.
+    WriteSetBatch(0, Values, NUM_ARRAY_MEMBERS(Values));
+    LE_ASSERT(truncate(JournalPath, 4) == 0);
+
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_NOT_FOUND);
+    LE_TEST(replayed.numEntries == 0);
+    LE_TEST(JournalFileSize() == -1);
+
+    // A new journal can be started in its place.
+    LE_TEST(WriteSetBatch(0, Values, NUM_ARRAY_MEMBERS(Values)) > 0);
+    LE_TEST(Replay(BASE_REVISION, &replayed, &journalSize) == LE_OK);
+    LE_TEST(replayed.numEntries == NUM_ARRAY_MEMBERS(Values));
+    CheckSetEntries(&replayed, Values, NUM_ARRAY_MEMBERS(Values));
+
+    jrnl_Delete(JournalPath);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN CONFIG TREE JOURNAL TEST ========");
+
+    LE_ASSERT(mkdtemp(DirPath) != NULL);
+    LE_ASSERT(snprintf(JournalPath, sizeof(JournalPath), "%s/test.journal", DirPath)
+              < sizeof(JournalPath));
+
+    jrnl_Init();
+
+    TestReplay();
+    TestTruncated();
+    TestCorrupt();
+    TestStale();
+
+    LE_ASSERT(le_dir_RemoveRecursive(DirPath) == LE_OK);
+
+    LE_INFO("======== CONFIG TREE JOURNAL TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,243 @@
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Checks that read transactions see a consistent snapshot of a tree while other transactions are
+ *  committed to it.
+ *
+ *  - A read transaction started before a commit keeps seeing the values, the nodes and the
+ *    children the tree had before the commit, (even a node deleted by the commit,) until it's
+ *    ended.  A read transaction started after the commit sees the new tree.
+ *  - While a writer thread commits a stream of changes, each of which sets a pair of nodes to the
+ *    same value, the main thread's read transactions must always see both nodes of the same pair.
+ *
+ *  Commits used to wait for the tree's read transactions to end, so if they block again this test
+ *  hangs, (and is killed by the test script.)
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+
+#define TEST_ROOT "/configTest/snapshotRead"
+
+/// Number of commits made by the writer thread.
+#define NUM_COMMITS 200
+
+
+
+/// Set once the writer thread is done.
+static le_sem_Ref_t WriterDoneSemRef;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Checks the value and the children that a read transaction sees.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRead
+(
+    le_cfg_IteratorRef_t iterRef,   ///< [IN] Iterator of the read transaction, on TEST_ROOT.
+    const char* valuePtr,           ///< [IN] Expected value of the "value" node.
+    bool hasGone,                   ///< [IN] Whether the "gone" node should exist.
+    bool hasAdded                   ///< [IN] Whether the "added" node should exist.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char buffer[LE_CFG_STR_LEN_BYTES];
+
+    LE_ASSERT(le_cfg_GetString(iterRef, "value", buffer, sizeof(buffer), "") == LE_OK);
+    LE_FATAL_IF(strcmp(buffer, valuePtr) != 0, "Read '%s', expected '%s'.", buffer, valuePtr);
+
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "gone") == hasGone);
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "added") == hasAdded);
+
+    if (hasGone)
+    {
+        LE_ASSERT(le_cfg_GetInt(iterRef, "gone", 0) == 1);
+    }
+
+    // Walking the children must give the same answer.
+    size_t numChildren = 0;
+    bool foundGone = false;
+    bool foundAdded = false;
+
+    if (le_cfg_GoToFirstChild(iterRef) == LE_OK)
+    {
+        do
+        {
+            LE_ASSERT(le_cfg_GetNodeName(iterRef, "", buffer, sizeof(buffer)) == LE_OK);
+
+            foundGone |= (strcmp(buffer, "gone") == 0);
+            foundAdded |= (strcmp(buffer, "added") == 0);
+            numChildren++;
+        }
+        while (le_cfg_GoToNextSibling(iterRef) == LE_OK);
+
+        LE_ASSERT(le_cfg_GoToParent(iterRef) == LE_OK);
+    }
+
+    LE_ASSERT(foundGone == hasGone);
+    LE_ASSERT(foundAdded == hasAdded);
+    LE_ASSERT(numChildren == (size_t)(1 + hasGone + hasAdded));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Commits while read transactions are open, and checks what each of them sees.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSnapshots
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_INFO("---- Reading while committing. ----------------------------------------------------");
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+    le_cfg_QuickSetString(TEST_ROOT "/value", "before");
+    le_cfg_QuickSetInt(TEST_ROOT "/gone", 1);
+
+    le_cfg_IteratorRef_t firstReadRef = le_cfg_CreateReadTxn(TEST_ROOT);
+    CheckRead(firstReadRef, "before", true, false);
+
+    // This doesn't return until the commit is done.
+    le_cfg_IteratorRef_t writeRef = le_cfg_CreateWriteTxn(TEST_ROOT);
+    le_cfg_SetString(writeRef, "value", "after");
+    le_cfg_DeleteNode(writeRef, "gone");
+    le_cfg_SetString(writeRef, "added", "new");
+    le_cfg_CommitTxn(writeRef);
+
+    CheckRead(firstReadRef, "before", true, false);
+
+    le_cfg_IteratorRef_t secondReadRef = le_cfg_CreateReadTxn(TEST_ROOT);
+    CheckRead(secondReadRef, "after", false, true);
+
+    // Quick writes are commits too.
+    le_cfg_QuickSetString(TEST_ROOT "/value", "third");
+
+    CheckRead(firstReadRef, "before", true, false);
+    CheckRead(secondReadRef, "after", false, true);
+
+    le_cfg_CancelTxn(firstReadRef);
+    CheckRead(secondReadRef, "after", false, true);
+    le_cfg_CancelTxn(secondReadRef);
+
+    le_cfg_IteratorRef_t lastReadRef = le_cfg_CreateReadTxn(TEST_ROOT);
+    CheckRead(lastReadRef, "third", false, true);
+    le_cfg_CancelTxn(lastReadRef);
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Commits a stream of changes to TEST_ROOT, each setting both nodes of the pair to the same value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThreadMain
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_ConnectService();
+
+    int i;
+
+    for (i = 1; i <= NUM_COMMITS; i++)
+    {
+        le_cfg_IteratorRef_t writeRef = le_cfg_CreateWriteTxn(TEST_ROOT);
+        le_cfg_SetInt(writeRef, "first", i);
+        le_cfg_SetInt(writeRef, "second", i);
+        le_cfg_CommitTxn(writeRef);
+    }
+
+    le_cfg_DisconnectService();
+    le_sem_Post(WriterDoneSemRef);
+
+    return NULL;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Reads the pair of nodes over and over while the writer thread is committing.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestConcurrentCommits
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_INFO("---- Reading during concurrent commits. -------------------------------------------");
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+    le_cfg_QuickSetInt(TEST_ROOT "/first", 0);
+    le_cfg_QuickSetInt(TEST_ROOT "/second", 0);
+
+    WriterDoneSemRef = le_sem_Create("WriterDone", 0);
+
+    le_thread_Ref_t writerRef = le_thread_Create("Writer", WriterThreadMain, NULL);
+    le_thread_SetJoinable(writerRef);
+    le_thread_Start(writerRef);
+
+    int lastValue = 0;
+    size_t numReads = 0;
+    bool isDone = false;
+
+    while (!isDone)
+    {
+        // Check after the writer is done once more, to see its last commit.
+        isDone = (le_sem_TryWait(WriterDoneSemRef) == LE_OK);
+
+        le_cfg_IteratorRef_t readRef = le_cfg_CreateReadTxn(TEST_ROOT);
+
+        int first = le_cfg_GetInt(readRef, "first", -1);
+
+        // Give the writer a chance to commit in the middle of the transaction.
+        sched_yield();
+
+        int second = le_cfg_GetInt(readRef, "second", -1);
+
+        le_cfg_CancelTxn(readRef);
+
+        LE_FATAL_IF(first != second, "Read a torn pair, %d and %d.", first, second);
+        LE_FATAL_IF(first < lastValue, "Read %d after %d.", first, lastValue);
+
+        lastValue = first;
+        numReads++;
+    }
+
+    LE_ASSERT(lastValue == NUM_COMMITS);
+    LE_ASSERT(le_thread_Join(writerRef, NULL) == LE_OK);
+
+    LE_INFO("Made %zu read transactions during %d commits.", numReads, NUM_COMMITS);
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    TestSnapshots();
+    TestConcurrentCommits();
+
+    LE_INFO("---- Snapshot read tests passed. --------------------------------------------------");
+    exit(EXIT_SUCCESS);
+}
@@ -201,6 +201,191 @@ static void QuickFunctionTest()
 
 
 
+// Write a list of null terminated strings to a new pipe, and return the pipe's read end.
+static int MakeStream
+(
+    const char* const* stringsPtr,
+    size_t count
+)
+{
+    int fds[2];
+    size_t i;
+
+    LE_ASSERT(pipe(fds) == 0);
+
+    for (i = 0; i < count; i++)
+    {
+        size_t size = strlen(stringsPtr[i]) + 1;
+        LE_ASSERT(write(fds[1], stringsPtr[i], size) == (ssize_t)size);
+    }
+
+    close(fds[1]);
+
+    return fds[0];
+}
+
+
+
+// Read a stream to its end, then close it.
+static size_t ReadStream
+(
+    int fd,
+    char* bufferPtr,
+    size_t bufferSize
+)
+{
+    size_t size = 0;
+    ssize_t bytesRead;
+
+    do
+    {
+        bytesRead = read(fd, bufferPtr + size, bufferSize - size);
+
+        if (bytesRead > 0)
+        {
+            size += bytesRead;
+        }
+    }
+    while ((bytesRead > 0) || ((bytesRead == -1) && (errno == EINTR)));
+
+    close(fd);
+
+    return size;
+}
+
+
+
+static void BulkTest()
+{
+    static const char* setRecords[] =
+        {
+            "a/str",  "string", "hello",
+            "a/int",  "int",    "-42",
+            "b/flag", "bool",   "true",
+            "b/pi",   "float",  "3.5",
+            "c",      "empty",  ""
+        };
+
+    static const char* badRecords[] =
+        {
+            "a/str", "string", "goodbye",
+            "a/int", "int",    "notANumber"
+        };
+
+    static const char* getPaths[] = { "a/str", "missing" };
+
+    static const char expectedList[] = "a/str\0string\0hello\0missing\0doesntExist\0";
+
+    static char streamBuffer[4096];
+
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    char valuePath[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result;
+    int fds[2];
+    size_t size;
+
+    LE_INFO("---- Bulk Test ---------------------------------------------------------------------");
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/bulk", TestRootDir);
+    snprintf(valuePath, LE_CFG_STR_LEN_BYTES, "%s/a/int", pathBuffer);
+
+    // Write a list of values in one go.
+    result = le_cfg_QuickSetList(pathBuffer,
+                                 MakeStream(setRecords, NUM_ARRAY_MEMBERS(setRecords)));
+    LE_FATAL_IF(result != LE_OK,
+                "Test: %s - Bulk set failed, result == %s.",
+                TestRootDir,
+                LE_RESULT_TXT(result));
+    LE_FATAL_IF(le_cfg_QuickGetInt(valuePath, 0) != -42,
+                "Test: %s - Bulk set value not written.",
+                TestRootDir);
+
+    // A bad record means nothing gets written.
+    result = le_cfg_QuickSetList(pathBuffer,
+                                 MakeStream(badRecords, NUM_ARRAY_MEMBERS(badRecords)));
+    LE_FATAL_IF(result != LE_FORMAT_ERROR,
+                "Test: %s - Bad bulk set not rejected, result == %s.",
+                TestRootDir,
+                LE_RESULT_TXT(result));
+    LE_FATAL_IF(le_cfg_QuickGetInt(valuePath, 0) != -42,
+                "Test: %s - Bad bulk set changed the tree.",
+                TestRootDir);
+
+    // Read the whole subtree back.  The stream is only written once the call returns.
+    LE_ASSERT(pipe(fds) == 0);
+
+    result = le_cfg_QuickGetSubtree(pathBuffer, fds[1]);
+    LE_FATAL_IF(result != LE_OK,
+                "Test: %s - Bulk get failed, result == %s.",
+                TestRootDir,
+                LE_RESULT_TXT(result));
+
+    size = ReadStream(fds[0], streamBuffer, sizeof(streamBuffer));
+
+    LE_FATAL_IF(   (memmem(streamBuffer, size, "a/int\0int\0-42\0", 14) == NULL)
+                || (memmem(streamBuffer, size, "b/flag\0bool\0true\0", 17) == NULL)
+                || (memmem(streamBuffer, size, "c\0empty\0\0", 9) == NULL),
+                "Test: %s - Bulk get is missing records.",
+                TestRootDir);
+
+    // Read a list of values back, including one that doesn't exist.
+    LE_ASSERT(pipe(fds) == 0);
+
+    result = le_cfg_QuickGetList(pathBuffer,
+                                 MakeStream(getPaths, NUM_ARRAY_MEMBERS(getPaths)),
+                                 fds[1]);
+    LE_FATAL_IF(result != LE_OK,
+                "Test: %s - Bulk list get failed, result == %s.",
+                TestRootDir,
+                LE_RESULT_TXT(result));
+
+    size = ReadStream(fds[0], streamBuffer, sizeof(streamBuffer));
+
+    LE_FATAL_IF(   (size != sizeof(expectedList))
+                || (memcmp(streamBuffer, expectedList, size) != 0),
+                "Test: %s - Bulk list get returned the wrong records.",
+                TestRootDir);
+}
+
+
+
+
+static void StatsTest()
+{
+    static char reportBuffer[16384];
+
+    le_result_t result;
+    int fds[2];
+    size_t size;
+
+    LE_INFO("---- Stats Test --------------------------------------------------------------------");
+
+    // The trees written by the earlier tests have to show up in the report, along with their
+    // commits.
+    LE_ASSERT(pipe(fds) == 0);
+
+    result = le_cfgAdmin_DumpStats(fds[1], true);
+    LE_FATAL_IF(result != LE_OK,
+                "Test: %s - Stats dump failed, result == %s.",
+                TestRootDir,
+                LE_RESULT_TXT(result));
+
+    size = ReadStream(fds[0], reportBuffer, sizeof(reportBuffer) - 1);
+    reportBuffer[size] = '\0';
+
+    LE_INFO("Stats: %s", reportBuffer);
+
+    LE_FATAL_IF(   (strstr(reportBuffer, "{\"trees\":[") != reportBuffer)
+                || (strstr(reportBuffer, "\"name\":\"foo\"") == NULL)
+                || (strstr(reportBuffer, "\"commitLatency\":[") == NULL)
+                || (strstr(reportBuffer, "\"clients\":[") == NULL),
+                "Test: %s - Stats report is missing entries.",
+                TestRootDir);
+}
+
+
+
+
 static void TestValue
 (
     le_cfg_IteratorRef_t iterRef,
@@ -510,6 +695,102 @@ static void TestImportExport()
 
 
 
+static void TestStreamImportExport()
+{
+    LE_INFO("---- Stream Import Export Test -----------------------------------------------------");
+
+    static const char jsonData[] =
+        "{\"name\":\"ignored\",\"type\":\"stem\",\"children\":["
+            "{\"name\":\"quote\",\"type\":\"string\",\"value\":\"say \\\"hi\\\"\"},"
+            "{\"name\":\"nested\",\"type\":\"stem\",\"children\":["
+                "{\"name\":\"count\",\"type\":\"int\",\"value\":7},"
+                "{\"name\":\"on\",\"type\":\"bool\",\"value\":true}]}]}";
+
+    static char streamBuffer[4096];
+
+    char srcPath[LE_CFG_STR_LEN_BYTES] = "";
+    char destPath[LE_CFG_STR_LEN_BYTES] = "";
+    char valuePath[LE_CFG_STR_LEN_BYTES] = "";
+    char strBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_cfg_IteratorRef_t iterRef;
+    int fds[2];
+    size_t size;
+
+    snprintf(srcPath, LE_CFG_STR_LEN_BYTES, "/%s/importExport", TestRootDir);
+
+    // Export the sub-tree written by TestImportExport() as JSON.
+    LE_ASSERT(pipe(fds) == 0);
+
+    iterRef = le_cfg_CreateReadTxn(srcPath);
+    LE_TEST(le_cfgAdmin_ExportTreeStream(iterRef, fds[1], "", LE_CFGADMIN_FORMAT_JSON) == LE_OK);
+    le_cfg_CancelTxn(iterRef);
+
+    size = ReadStream(fds[0], streamBuffer, sizeof(streamBuffer) - 1);
+    streamBuffer[size] = '\0';
+
+    LE_TEST(strstr(streamBuffer, "{\"name\":\"importExport\",\"type\":\"stem\"") == streamBuffer);
+    LE_TEST(strstr(streamBuffer, "{\"name\":\"anIntVal\",\"type\":\"int\",\"value\":1024}")
+            != NULL);
+
+    // Copy it elsewhere through a snapshot.  The stream has to be complete before it's imported.
+    LE_ASSERT(pipe(fds) == 0);
+
+    iterRef = le_cfg_CreateReadTxn(srcPath);
+    LE_TEST(le_cfgAdmin_ExportTreeStream(iterRef, fds[1], "", LE_CFGADMIN_FORMAT_SNAPSHOT)
+            == LE_OK);
+    le_cfg_CancelTxn(iterRef);
+
+    size = ReadStream(fds[0], streamBuffer, sizeof(streamBuffer));
+
+    LE_ASSERT(pipe(fds) == 0);
+    LE_ASSERT(write(fds[1], streamBuffer, size) == (ssize_t)size);
+    close(fds[1]);
+
+    snprintf(destPath, LE_CFG_STR_LEN_BYTES, "/%s/streamCopy", TestRootDir);
+
+    iterRef = le_cfg_CreateWriteTxn(destPath);
+    LE_TEST(le_cfgAdmin_ImportTreeStream(iterRef, fds[0], "", LE_CFGADMIN_FORMAT_SNAPSHOT)
+            == LE_OK);
+    le_cfg_CommitTxn(iterRef);
+
+    snprintf(valuePath, LE_CFG_STR_LEN_BYTES, "%s/nestedValues/anIntVal", destPath);
+    LE_TEST(le_cfg_QuickGetInt(valuePath, 0) == 1024);
+
+    // Anything else in the stream's place is rejected.
+    LE_ASSERT(pipe(fds) == 0);
+    LE_ASSERT(write(fds[1], jsonData, sizeof(jsonData) - 1) == sizeof(jsonData) - 1);
+    close(fds[1]);
+
+    iterRef = le_cfg_CreateWriteTxn(destPath);
+    LE_TEST(le_cfgAdmin_ImportTreeStream(iterRef, fds[0], "", LE_CFGADMIN_FORMAT_SNAPSHOT)
+            == LE_FORMAT_ERROR);
+    le_cfg_CancelTxn(iterRef);
+
+    // Import some JSON, with escaped strings.
+    LE_ASSERT(pipe(fds) == 0);
+    LE_ASSERT(write(fds[1], jsonData, sizeof(jsonData) - 1) == sizeof(jsonData) - 1);
+    close(fds[1]);
+
+    snprintf(destPath, LE_CFG_STR_LEN_BYTES, "/%s/streamJson", TestRootDir);
+
+    iterRef = le_cfg_CreateWriteTxn(destPath);
+    LE_TEST(le_cfgAdmin_ImportTreeStream(iterRef, fds[0], "", LE_CFGADMIN_FORMAT_JSON) == LE_OK);
+    le_cfg_CommitTxn(iterRef);
+
+    snprintf(valuePath, LE_CFG_STR_LEN_BYTES, "%s/quote", destPath);
+    le_cfg_QuickGetString(valuePath, strBuffer, sizeof(strBuffer), "");
+    LE_TEST(strcmp(strBuffer, "say \"hi\"") == 0);
+
+    snprintf(valuePath, LE_CFG_STR_LEN_BYTES, "%s/nested/count", destPath);
+    LE_TEST(le_cfg_QuickGetInt(valuePath, 0) == 7);
+
+    snprintf(valuePath, LE_CFG_STR_LEN_BYTES, "%s/nested/on", destPath);
+    LE_TEST(le_cfg_QuickGetBool(valuePath, false) == true);
+}
+
+
+
+
 static void MultiTreeTest()
 {
     char strBuffer[LE_CFG_STR_LEN_BYTES] = "";
@@ -696,6 +977,7 @@ static void ListTreeTest()
 
 le_cfg_ChangeHandlerRef_t handlerRef = NULL;
 le_cfg_ChangeHandlerRef_t rootHandlerRef = NULL;
+le_cfg_ChangeSummaryHandlerRef_t summaryHandlerRef = NULL;
 
 static void ConfigCallbackFunction
 (
@@ -719,6 +1001,21 @@ static void RootConfigCallbackFunction
 }
 
 
+static void SummaryCallbackFunction
+(
+    const char* changedPath,
+    void* contextPtr
+)
+{
+    static char expectedPath[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(expectedPath, LE_CFG_STR_LEN_BYTES, "%s/callbacks/valueA", TestRootDir);
+
+    LE_INFO("------- Summary Callback Called: %s ------------------------", changedPath);
+    LE_TEST(strcmp(changedPath, expectedPath) == 0);
+    le_cfg_RemoveChangeSummaryHandler(summaryHandlerRef);
+}
+
+
 
 
 static void CallbackTest()
@@ -729,6 +1026,7 @@ static void CallbackTest()
     LE_INFO("------- Callback Test --------------------------------------");
 
     handlerRef = le_cfg_AddChangeHandler(pathBuffer, ConfigCallbackFunction, NULL);
+    summaryHandlerRef = le_cfg_AddChangeSummaryHandler(pathBuffer, SummaryCallbackFunction, NULL);
     rootHandlerRef = le_cfg_AddChangeHandler("/", RootConfigCallbackFunction, NULL);
 
     le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
@@ -849,10 +1147,13 @@ COMPONENT_INIT
     DeleteTest();
     StringSizeTest();
     TestImportExport();
+    TestStreamImportExport();
     MultiTreeTest();
     ExistAndEmptyTest();
     ListTreeTest();
     CallbackTest();
+    BulkTest();
+    StatsTest();
 
     // overwrite a large string with a small string and vice-versa
     TestStringOverwrite();
@@ -7,13 +7,25 @@
 static bool TestAPassed = false;
 static bool TestBPassed = false;
 static bool TestCPassed = false;
+static bool TestDPassed = false;
 
 static le_event_Id_t EventIdA;
 static le_event_Id_t EventIdB;
 static le_event_Id_t EventIdC;
+static le_event_Id_t EventIdD;
 
 static char EventContextA[] = "Context A";
 
+// Number of threads queueing functions to the main thread at the same time, and the number of
+// functions each of them queues.
+#define NUM_PRODUCER_THREADS 4
+#define NUM_QUEUED_PER_THREAD 10000
+
+static le_thread_Ref_t MainThread;
+static size_t NextExpectedSeq[NUM_PRODUCER_THREADS];
+static size_t NumQueuedReceived = 0;
+static bool ReportTestsDone = false;
+
 typedef struct
 {
     char str[10];
@@ -24,6 +36,11 @@ Report_t;
 static Report_t ReportA = { "Report A", &TestAPassed };
 static Report_t ReportB = { "Report B", &TestBPassed };
 static Report_t ReportC = { "Report C", &TestCPassed };
+static Report_t ReportD = { "Report D", &TestDPassed };
+
+// Object reported by reference for Event D, and the number of handlers that have seen it.
+static Report_t* ReportDPtr;
+static int NumHandlerDRuns = 0;
 
 
 static void EventHandlerA
@@ -62,6 +79,23 @@ static void EventHandlerB
 }
 
 
+static void EventHandlerD
+(
+    void* reportPtr // Shared, released by the Event Loop.
+)
+{
+    Report_t* objPtr = reportPtr;
+
+    LE_ASSERT(objPtr == ReportDPtr);
+    LE_ASSERT(strcmp(ReportD.str, objPtr->str) == 0);
+
+    // The Event Loop still holds a reference for this handler.
+    LE_ASSERT(!TestDPassed);
+
+    NumHandlerDRuns++;
+}
+
+
 static void Destructor
 (
     void* objPtr
@@ -72,7 +106,8 @@ static void Destructor
     LE_INFO("Destructor running.");
 
     LE_ASSERT(   (strcmp(ReportB.str, reportPtr->str) == 0)
-              || (strcmp(ReportC.str, reportPtr->str) == 0) );
+              || (strcmp(ReportC.str, reportPtr->str) == 0)
+              || (strcmp(ReportD.str, reportPtr->str) == 0) );
 
     LE_INFO("Destructing reference counted %s.", reportPtr->str);
 
@@ -82,6 +117,54 @@ static void Destructor
 }
 
 
+static void CheckComplete
+(
+    void
+)
+{
+    if (ReportTestsDone && (NumQueuedReceived == NUM_PRODUCER_THREADS * NUM_QUEUED_PER_THREAD))
+    {
+        LE_INFO("======== EVENT LOOP TEST COMPLETE (PASSED) ========");
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+static void QueuedFromThread
+(
+    void* param1Ptr,    // Producer thread index.
+    void* param2Ptr     // Sequence number within that producer thread.
+)
+{
+    size_t producer = (size_t)param1Ptr;
+    size_t seq = (size_t)param2Ptr;
+
+    // Functions queued by the same thread must be called in the order they were queued.
+    LE_ASSERT(producer < NUM_PRODUCER_THREADS);
+    LE_ASSERT(seq == NextExpectedSeq[producer]);
+    NextExpectedSeq[producer]++;
+
+    NumQueuedReceived++;
+    CheckComplete();
+}
+
+
+static void* ProducerThreadMain
+(
+    void* contextPtr    // Producer thread index.
+)
+{
+    size_t seq;
+
+    for (seq = 0; seq < NUM_QUEUED_PER_THREAD; seq++)
+    {
+        le_event_QueueFunctionToThread(MainThread, QueuedFromThread, contextPtr, (void*)seq);
+    }
+
+    return NULL;
+}
+
+
 static void CheckTestResults
 (
     void* param1Ptr,
@@ -94,9 +177,11 @@ static void CheckTestResults
     LE_ASSERT(TestAPassed);
     LE_ASSERT(TestBPassed);
     LE_ASSERT(TestCPassed);
+    LE_ASSERT(TestDPassed);
+    LE_ASSERT(NumHandlerDRuns == 2);
 
-    LE_INFO("======== EVENT LOOP TEST COMPLETE (PASSED) ========");
-    exit(EXIT_SUCCESS);
+    ReportTestsDone = true;
+    CheckComplete();
 }
 
 
@@ -111,16 +196,19 @@ COMPONENT_INIT
     EventIdA = le_event_CreateId("Event A", sizeof(ReportA));
     EventIdB = le_event_CreateIdWithRefCounting("Event B");
     EventIdC = le_event_CreateIdWithRefCounting("Event C");
+    EventIdD = le_event_CreateId("Event D", sizeof(ReportD));
 
     le_event_SetContextPtr(le_event_AddHandler("Handler A", EventIdA, EventHandlerA), &EventContextA);
     le_event_AddHandler("Handler B", EventIdB, EventHandlerB);
     // Intentionally no handler for ref-counting Event C.
+    le_event_AddHandler("Handler D1", EventIdD, EventHandlerD);
+    le_event_AddHandler("Handler D2", EventIdD, EventHandlerD);
 
     le_event_Report(EventIdA, &ReportA, sizeof(ReportA));
 
     le_mem_PoolRef_t memPool = le_mem_CreatePool("Report", sizeof(Report_t));
     le_mem_SetDestructor(memPool, Destructor);
-    le_mem_ExpandPool(memPool, 2);
+    le_mem_ExpandPool(memPool, 3);
 
     reportPtr = le_mem_ForceAlloc(memPool);
     memcpy(reportPtr, &ReportB, sizeof(*reportPtr));
@@ -130,5 +218,21 @@ COMPONENT_INIT
     memcpy(reportPtr, &ReportC, sizeof(*reportPtr));
     le_event_ReportWithRefCounting(EventIdC, reportPtr);
 
+    // Both handlers get the same object, and the Event Loop releases it after the last one.
+    ReportDPtr = le_mem_ForceAlloc(memPool);
+    memcpy(ReportDPtr, &ReportD, sizeof(*ReportDPtr));
+    le_event_ReportByRef(EventIdD, ReportDPtr);
+
     le_event_QueueFunction(CheckTestResults, &ReportA, &ReportB);
+
+    // Have several threads queue functions to this thread at once.
+    size_t i;
+
+    MainThread = le_thread_GetCurrent();
+
+    for (i = 0; i < NUM_PRODUCER_THREADS; i++)
+    {
+        le_thread_Ref_t producerThread = le_thread_Create("Producer", ProducerThreadMain, (void*)i);
+        le_thread_Start(producerThread);
+    }
 }
@@ -33,10 +33,103 @@
 #define LONG_DATA_LENGTH    5000
 
 
+//--------------------------------------------------------------------------------------------------
+// Static declarations
+//--------------------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Data written and read back by the asynchronous test
+ */
+// -------------------------------------------------------------------------------------------------
+static const uint8_t AsyncData[] = "Hello asynchronous world!";
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Buffer the asynchronous test reads into
+ */
+// -------------------------------------------------------------------------------------------------
+static uint8_t AsyncReadBuf[SHORT_DATA_LENGTH];
+
+
 //--------------------------------------------------------------------------------------------------
 // Test functions
 //--------------------------------------------------------------------------------------------------
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Handler of the asynchronous read: checks the data and ends the test.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AsyncReadHandler
+(
+    le_fs_FileRef_t fileRef,
+    le_result_t result,
+    size_t numBytes,
+    void* contextPtr
+)
+{
+    printf("Asynchronous read done: %d, %d bytes: '%s'\n", result, (int)numBytes, AsyncReadBuf);
+    LE_ASSERT_OK(result);
+    LE_ASSERT(sizeof(AsyncData) == numBytes);
+    LE_ASSERT(0 == memcmp(AsyncData, AsyncReadBuf, sizeof(AsyncData)));
+    LE_ASSERT(contextPtr == AsyncReadBuf);
+
+    LE_ASSERT_OK(le_fs_Close(fileRef));
+
+    printf("Successful FS test\n");
+    exit(EXIT_SUCCESS);
+}
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Handler of the asynchronous write: reads the data back.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AsyncWriteHandler
+(
+    le_fs_FileRef_t fileRef,
+    le_result_t result,
+    size_t numBytes,
+    void* contextPtr
+)
+{
+    printf("Asynchronous write done: %d, %d bytes\n", result, (int)numBytes);
+    LE_ASSERT_OK(result);
+    LE_ASSERT(sizeof(AsyncData) == numBytes);
+
+    LE_ASSERT_OK(le_fs_ReadAsync(fileRef, 0, AsyncReadBuf, sizeof(AsyncReadBuf),
+                                 AsyncReadHandler, AsyncReadBuf));
+}
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Start the asynchronous test: writes at the current position, then reads back from offset 0.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TestAsync
+(
+    void
+)
+{
+    le_fs_FileRef_t fileRef = NULL;
+    const char filePath[PATH_LENGTH] = "/foo/bar/async.txt";
+
+    printf("Test asynchronous read and write with file '%s'\n", filePath);
+    LE_ASSERT_OK(le_fs_Open(filePath, LE_FS_CREAT | LE_FS_RDWR | LE_FS_TRUNC, &fileRef));
+
+    // Error cases
+    LE_ASSERT(LE_BAD_PARAMETER == le_fs_WriteAsync(fileRef, 0, NULL, 1, AsyncWriteHandler, NULL));
+    LE_ASSERT(LE_BAD_PARAMETER == le_fs_WriteAsync(fileRef, 0, AsyncData, 1, NULL, NULL));
+    LE_ASSERT(LE_BAD_PARAMETER == le_fs_WriteAsync(fileRef, -2, AsyncData, 1, AsyncWriteHandler,
+                                                   NULL));
+    LE_ASSERT(LE_BAD_PARAMETER == le_fs_ReadAsync((le_fs_FileRef_t)-1, 0, AsyncReadBuf, 1,
+                                                  AsyncReadHandler, NULL));
+
+    LE_ASSERT_OK(le_fs_WriteAsync(fileRef, LE_FS_CURRENT_POSITION, AsyncData, sizeof(AsyncData),
+                                  AsyncWriteHandler, NULL));
+}
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Test main function.
@@ -336,7 +429,7 @@ facilisis erat, a imperdiet risus eleifend nec.";
     LE_ASSERT(LE_BAD_PARAMETER == le_fs_Delete(wrongFilePath));
     LE_ASSERT(LE_BAD_PARAMETER == le_fs_Move(loremFilePath, loremFilePath));
 
-    printf("Successful FS test\n");
-    exit(EXIT_SUCCESS);
+    // The asynchronous test ends the test from its handlers, once the Event Loop runs.
+    TestAsync();
 }
 
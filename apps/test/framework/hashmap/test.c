@@ -21,6 +21,9 @@ size_t le_hashmap_HashCustom(const void* keyPtr);
 bool le_hashmap_EqualsCustom(const void* firstPtr, const void* secondPtr);
 bool itHandler(const void* keyPtr, const void* valuePtr, void* contextPtr);
 void TestIterRemove(le_hashmap_Ref_t map);
+void TestResize(le_hashmap_Ref_t map);
+void TestCompactIter(void);
+void TestSeededMap(le_hashmap_Ref_t map);
 
 typedef struct Key Key_t;
 struct Key {
@@ -66,6 +69,37 @@ COMPONENT_INIT
     TestLongIntHashMap(map6);
     TestNewIter();
     TestIterRemove(map1);
+    TestResize(le_hashmap_Create("GrowMap", 3, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32));
+    TestSeededMap(le_hashmap_Create("SeedMap", 50, &le_hashmap_HashString,
+                                    &le_hashmap_EqualsString));
+
+    LE_INFO("***  Repeating tests on compact hash maps. ***");
+    le_hashmap_Ref_t cmap1 = le_hashmap_CreateCompact("CMap1", 200, &le_hashmap_HashUInt32,
+                                                      &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t cmap2 = le_hashmap_CreateCompact("CMap2", 200, &le_hashmap_HashString,
+                                                      &le_hashmap_EqualsString);
+    le_hashmap_Ref_t cmap3 = le_hashmap_CreateCompact("CMap3", 200, &le_hashmap_HashCustom,
+                                                      &le_hashmap_EqualsCustom);
+    le_hashmap_Ref_t cmap4 = le_hashmap_CreateCompact("CMap4", 1, &le_hashmap_HashUInt32,
+                                                      &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t cmap5 = le_hashmap_CreateCompact("CMap5", 100, &le_hashmap_HashVoidPointer,
+                                                      &le_hashmap_EqualsVoidPointer);
+    le_hashmap_Ref_t cmap6 = le_hashmap_CreateCompact("CMap6", 200, &le_hashmap_HashUInt64,
+                                                      &le_hashmap_EqualsUInt64);
+    LE_TEST(cmap1 && cmap2 && cmap3 && cmap4 && cmap5 && cmap6);
+
+    TestIntHashMap(cmap1);
+    TestStringHashMap(cmap2);
+    TestCustomHashMap(cmap3);
+    TestTinyMap(cmap4);
+    TestPointerMap(cmap5);
+    TestLongIntHashMap(cmap6);
+    TestIterRemove(cmap1);
+    TestResize(le_hashmap_CreateCompact("CGrowMap", 3, &le_hashmap_HashUInt32,
+                                        &le_hashmap_EqualsUInt32));
+    TestCompactIter();
+    TestSeededMap(le_hashmap_CreateCompact("CSeedMap", 50, &le_hashmap_HashString,
+                                           &le_hashmap_EqualsString));
 
     LE_INFO("==== Hashmap Tests PASSED ====\n");
 
@@ -135,7 +169,10 @@ void TestIntHashMap(le_hashmap_Ref_t map)
         le_hashmap_GetValue(mapIt);
     }
     LE_INFO("Iterator count = %d", itercnt);
-    LE_TEST(itercnt == -1);
+    // Going back after running off the end starts again from the last bucket, so all but the
+    // last entry of that bucket are visited twice.  Once the map has grown to hold these
+    // entries, its last bucket only holds a single one.
+    LE_TEST(itercnt == 0);
 
     // Cleanup the map again to allow it to be reused
     le_hashmap_RemoveAll(map);
@@ -187,6 +224,11 @@ void TestHashFns(void)
     LE_INFO("String equality function test");
     LE_TEST(le_hashmap_EqualsString(skey1, skey3) && !le_hashmap_EqualsString(skey1, skey2));
 
+    LE_INFO("Long int equality function test");
+    uint64_t lkey1 = 0x100000001ULL;
+    uint64_t lkey2 = 0x200000001ULL;
+    LE_TEST(le_hashmap_EqualsUInt64(&lkey1, &lkey1) && !le_hashmap_EqualsUInt64(&lkey1, &lkey2));
+
     free(skey3);
 }
 
@@ -526,3 +568,205 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     mapIt = le_hashmap_GetIterator(map);
     LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
 }
+
+void TestResize(le_hashmap_Ref_t map)
+{
+    static uint32_t iKeys[5000];
+    static uint32_t iVals[5000];
+    int itercnt = 0;
+    int j;
+
+    LE_INFO("*** Running hashmap resize tests ***");
+
+    le_hashmap_EnableShrink(map);
+
+    // Grow the map well past its initial capacity, checking that entries remain reachable while
+    // buckets are being migrated.
+    for (j=0; j<5000; j++) {
+        iKeys[j] = j * 3;
+        iVals[j] = j * 6;
+        LE_ASSERT(le_hashmap_Put(map, &iKeys[j], &iVals[j]) == NULL);
+        LE_ASSERT(le_hashmap_Get(map, &iKeys[j / 2]) == &iVals[j / 2]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 5000);
+
+    for (j=0; j<5000; j++) {
+        LE_ASSERT(le_hashmap_ContainsKey(map, &iKeys[j]));
+        LE_ASSERT(le_hashmap_GetStoredKey(map, &iKeys[j]) == &iKeys[j]);
+    }
+
+    // With automatic growth, most entries should have a bucket to themselves.
+    LE_INFO("Collision count = %zu", le_hashmap_CountCollisions(map));
+    LE_TEST(le_hashmap_CountCollisions(map) < 2500);
+
+    // Adding enough entries to need a resize while iterating must not disturb the iteration.
+    static uint32_t extraKeys[2000];
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        const uint32_t* keyPtr = le_hashmap_GetKey(mapIt);
+        if (*keyPtr % 3 == 0)
+        {
+            LE_ASSERT(*((uint32_t*)le_hashmap_GetValue(mapIt)) == (*keyPtr * 2));
+            if (itercnt < 2000)
+            {
+                extraKeys[itercnt] = (itercnt * 3) + 1;
+                le_hashmap_Put(map, &extraKeys[itercnt], &iVals[0]);
+            }
+            itercnt++;
+        }
+    }
+    LE_TEST(itercnt == 5000);
+
+    for (j=0; j<2000; j++) {
+        LE_ASSERT(le_hashmap_Remove(map, &extraKeys[j]) == &iVals[0]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 5000);
+
+    // Shrink the map back down.
+    for (j=0; j<4990; j++) {
+        LE_ASSERT(le_hashmap_Remove(map, &iKeys[j]) == &iVals[j]);
+        LE_ASSERT(le_hashmap_Get(map, &iKeys[4995]) == &iVals[4995]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 10);
+
+    for (j=4990; j<5000; j++) {
+        LE_ASSERT(le_hashmap_Get(map, &iKeys[j]) == &iVals[j]);
+    }
+
+    itercnt = 0;
+    mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == 10);
+}
+
+void TestCompactIter(void)
+{
+    static uint32_t iKeys[100];
+    static uint32_t extraKeys[100];
+    int itercnt = 0;
+    int j;
+
+    LE_INFO("*** Running compact hashmap iteration tests ***");
+
+    le_hashmap_Ref_t map = le_hashmap_CreateCompact("CIterMap", 300, &le_hashmap_HashUInt32,
+                                                    &le_hashmap_EqualsUInt32);
+    for (j=0; j<100; j++) {
+        iKeys[j] = j;
+        le_hashmap_Put(map, &iKeys[j], &iKeys[j]);
+    }
+
+    // Remove the current entry and the one after it, and add new entries, on every step.  Every
+    // remaining original entry must still be visited exactly once.
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        const uint32_t* keyPtr = le_hashmap_GetKey(mapIt);
+        if (*keyPtr >= 100)
+        {
+            continue;
+        }
+
+        uint32_t key = *keyPtr;
+        LE_ASSERT(le_hashmap_GetValue(mapIt) == keyPtr);
+        LE_ASSERT(keyPtr == &iKeys[key]);
+        itercnt++;
+
+        if (key % 4 == 0)
+        {
+            uint32_t nextKey = key + 1;
+            LE_ASSERT(le_hashmap_Remove(map, keyPtr) == keyPtr);
+            LE_ASSERT(le_hashmap_GetKey(mapIt) == NULL);
+            if ((nextKey < 100) && (iKeys[nextKey] == nextKey))
+            {
+                LE_ASSERT(le_hashmap_Remove(map, &nextKey) == &iKeys[nextKey]);
+                iKeys[nextKey] = 1000;
+                itercnt++;
+            }
+        }
+        iKeys[key] = 1000;
+
+        extraKeys[itercnt % 100] = 100 + (itercnt % 100);
+        le_hashmap_Put(map, &extraKeys[itercnt % 100], &extraKeys[itercnt % 100]);
+    }
+    LE_TEST(itercnt == 100);
+
+    // The map is rebuilt by the next update, and must still find everything.
+    size_t size = le_hashmap_Size(map);
+    LE_ASSERT(le_hashmap_Put(map, &extraKeys[0], &extraKeys[0]) == &extraKeys[0]);
+    LE_TEST(le_hashmap_Size(map) == size);
+    for (j=0; j<100; j++) {
+        if (extraKeys[j] != 0)
+        {
+            LE_ASSERT(le_hashmap_Get(map, &extraKeys[j]) == &extraKeys[j]);
+        }
+    }
+
+    // Iterating backwards from the end visits every entry as well.
+    itercnt = 0;
+    mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+    }
+    while (le_hashmap_PrevNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == (int)le_hashmap_Size(map));
+
+    // Adding entries during an iteration still grows the map at the normal load factor, which
+    // ends the iteration.  A map created for 8 entries has 16 slots, so it grows when the 15th
+    // entry is added, before it runs out of free slots.
+    static uint32_t growKeys[15];
+    map = le_hashmap_CreateCompact("CIterGrowMap", 8, &le_hashmap_HashUInt32,
+                                   &le_hashmap_EqualsUInt32);
+    for (j=0; j<8; j++) {
+        growKeys[j] = j;
+        le_hashmap_Put(map, &growKeys[j], &growKeys[j]);
+    }
+    mapIt = le_hashmap_GetIterator(map);
+    LE_ASSERT(le_hashmap_NextNode(mapIt) == LE_OK);
+    for (j=8; j<15; j++) {
+        growKeys[j] = j;
+        le_hashmap_Put(map, &growKeys[j], &growKeys[j]);
+    }
+    LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
+    LE_TEST(le_hashmap_Size(map) == 15);
+    for (j=0; j<15; j++) {
+        LE_ASSERT(le_hashmap_Get(map, &growKeys[j]) == &growKeys[j]);
+    }
+}
+
+void TestSeededMap(le_hashmap_Ref_t map)
+{
+    LE_INFO("*** Running seeded map test ***");
+
+    static char keys[200][16];
+    int i;
+
+    // Keys of every length up to and past a whole number of words.
+    le_hashmap_SetRandomSeed(map);
+    for (i = 0; i < 200; i++)
+    {
+        snprintf(keys[i], sizeof(keys[i]), "%.*s%d", i % 9, "seedkey__", i);
+        le_hashmap_Put(map, keys[i], keys[i]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 200);
+
+    for (i = 0; i < 200; i++)
+    {
+        char key[16];
+        snprintf(key, sizeof(key), "%.*s%d", i % 9, "seedkey__", i);
+        LE_ASSERT(le_hashmap_Get(map, key) == keys[i]);
+    }
+    LE_TEST(le_hashmap_Get(map, "seedkey__") == NULL);
+
+    // The seed can be changed again once the map is empty.
+    le_hashmap_RemoveAll(map);
+    le_hashmap_SetSeed(map, 12345);
+    le_hashmap_Put(map, keys[0], keys[0]);
+    LE_TEST(le_hashmap_Get(map, "0") == keys[0]);
+}
@@ -0,0 +1,149 @@
+/**
+ * Test for the heap API.
+ *
+ * Adds nodes of random values to a heap, removes and changes some of them, then checks that they
+ * come out of the heap in order.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+/// Number of nodes.
+#define NUM_NODES           1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int value;
+    le_heap_Link_t link;
+}
+Node_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The nodes.
+ */
+//--------------------------------------------------------------------------------------------------
+static Node_t Nodes[NUM_NODES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares the values of the nodes of two links.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool NodeLessThan
+(
+    const le_heap_Link_t* aPtr,
+    const le_heap_Link_t* bPtr
+)
+{
+    return CONTAINER_OF(aPtr, Node_t, link)->value < CONTAINER_OF(bPtr, Node_t, link)->value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pops all the links of a heap, checking that they come out in order.
+ *
+ * @return
+ *      The number of links popped, or -1 if they were out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PopAll
+(
+    le_heap_Heap_t* heapPtr
+)
+{
+    le_heap_Link_t* linkPtr;
+    int lastValue = INT_MIN;
+    int count = 0;
+
+    while ((linkPtr = le_heap_Pop(heapPtr)) != NULL)
+    {
+        int value = CONTAINER_OF(linkPtr, Node_t, link)->value;
+
+        if (value < lastValue)
+        {
+            LE_ERROR("Value %d popped after %d.", value, lastValue);
+            return -1;
+        }
+
+        lastValue = value;
+        count++;
+    }
+
+    return count;
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN HEAP TEST ========");
+
+    le_heap_Heap_t heap = LE_HEAP_INIT(NodeLessThan);
+    int i;
+
+    LE_TEST(le_heap_IsEmpty(&heap));
+    LE_TEST(le_heap_Peek(&heap) == NULL);
+    LE_TEST(le_heap_Pop(&heap) == NULL);
+
+    srand(1);
+    for (i = 0; i < NUM_NODES; i++)
+    {
+        Nodes[i].value = rand() % (NUM_NODES / 4);
+        Nodes[i].link = LE_HEAP_LINK_INIT;
+        le_heap_Insert(&heap, &Nodes[i].link);
+    }
+
+    LE_TEST(le_heap_NumLinks(&heap) == NUM_NODES);
+    LE_TEST(le_heap_GetChangeCount(&heap) == NUM_NODES);
+
+    // The top link has the lowest value.
+    int minValue = INT_MAX;
+    for (i = 0; i < NUM_NODES; i++)
+    {
+        minValue = (Nodes[i].value < minValue) ? Nodes[i].value : minValue;
+    }
+    LE_TEST(CONTAINER_OF(le_heap_Peek(&heap), Node_t, link)->value == minValue);
+
+    // Remove every third node, and change the value of every fifth one.
+    bool allInHeap = true;
+    for (i = 0; i < NUM_NODES; i++)
+    {
+        allInHeap = allInHeap && le_heap_IsInHeap(&heap, &Nodes[i].link);
+
+        if (i % 3 == 0)
+        {
+            le_heap_Remove(&heap, &Nodes[i].link);
+        }
+        else if (i % 5 == 0)
+        {
+            Nodes[i].value = rand() % NUM_NODES - NUM_NODES / 2;
+            le_heap_Update(&heap, &Nodes[i].link);
+        }
+    }
+    LE_TEST(allInHeap);
+    LE_TEST(!le_heap_IsInHeap(&heap, &Nodes[0].link));
+    LE_TEST(le_heap_IsInHeap(&heap, &Nodes[1].link));
+    LE_TEST(le_heap_NumLinks(&heap) == NUM_NODES - (NUM_NODES + 2) / 3);
+
+    size_t changeCount = le_heap_GetChangeCount(&heap);
+    LE_TEST(PopAll(&heap) == NUM_NODES - (NUM_NODES + 2) / 3);
+    LE_TEST(le_heap_IsEmpty(&heap));
+    LE_TEST(le_heap_GetChangeCount(&heap) == changeCount + NUM_NODES - (NUM_NODES + 2) / 3);
+
+    LE_INFO("======== HEAP TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
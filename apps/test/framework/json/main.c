@@ -0,0 +1,377 @@
+/**
+ * Test for the JSON parser.
+ *
+ * Parses the same document from memory, from a regular file and from a pipe, checking the events
+ * reported and that whatever follows the document is left in the file descriptor.  Also builds a
+ * document tree from it and writes a document using a JSON writer.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+/// Document used by the test, followed by some data that isn't part of it.
+static const char Document[] =
+    "{\n"
+    "  \"name\": \"update\",\n"
+    "  \"size\": 1234,\n"
+    "  \"list\": [ true, false, null, \"ab\" ],\n"
+    "  \"nested\": { \"x\": -1.5 }\n"
+    "}";
+static const char Trailer[] = "PAYLOAD";
+
+/// Events expected for the Document.
+static const le_json_Event_t ExpectedEvents[] =
+{
+    LE_JSON_OBJECT_START,
+    LE_JSON_OBJECT_MEMBER, LE_JSON_STRING,
+    LE_JSON_OBJECT_MEMBER, LE_JSON_NUMBER,
+    LE_JSON_OBJECT_MEMBER, LE_JSON_ARRAY_START,
+        LE_JSON_TRUE, LE_JSON_FALSE, LE_JSON_NULL, LE_JSON_STRING,
+    LE_JSON_ARRAY_END,
+    LE_JSON_OBJECT_MEMBER, LE_JSON_OBJECT_START,
+        LE_JSON_OBJECT_MEMBER, LE_JSON_NUMBER,
+    LE_JSON_OBJECT_END,
+    LE_JSON_OBJECT_END,
+    LE_JSON_DOC_END
+};
+
+/// Number of events received so far.
+static size_t NumEvents;
+
+/// true if any event didn't match the one expected.
+static bool IsMismatch;
+
+/// Number of errors reported.
+static size_t NumErrors;
+
+/// Value of the first number in the document.
+static double Size;
+
+/// File descriptor being parsed, or -1 if parsing a buffer.
+static int DocFd = -1;
+
+/// true once the regular file has been parsed and the pipe is being parsed.
+static bool IsPipe;
+
+
+static void StartFdTest(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the results before parsing the document again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetResults
+(
+    void
+)
+{
+    NumEvents = 0;
+    IsMismatch = false;
+    NumErrors = 0;
+    Size = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the whole document was parsed without error.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckResults
+(
+    void
+)
+{
+    LE_TEST(!IsMismatch);
+    LE_TEST(NumEvents == NUM_ARRAY_MEMBERS(ExpectedEvents));
+    LE_TEST(NumErrors == 0);
+    LE_TEST(Size == 1234);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check what is left in the file descriptor after the document, and move on to the next test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishFdTest
+(
+    void
+)
+{
+    char rest[sizeof(Trailer) + 1];
+    ssize_t len = read(DocFd, rest, sizeof(rest));
+
+    CheckResults();
+    LE_TEST(le_json_GetBytesRead(le_json_GetSession()) == strlen(Document));
+    LE_TEST((len == (ssize_t)strlen(Trailer)) && (memcmp(rest, Trailer, len) == 0));
+
+    le_json_Cleanup(le_json_GetSession());
+    LE_ASSERT(close(DocFd) == 0);
+    DocFd = -1;
+
+    if (!IsPipe)
+    {
+        IsPipe = true;
+        StartFdTest();
+    }
+    else
+    {
+        LE_INFO("======== JSON TEST COMPLETE ========");
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for all the parsing sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EventHandler
+(
+    le_json_Event_t event
+)
+{
+    if ((NumEvents >= NUM_ARRAY_MEMBERS(ExpectedEvents)) || (ExpectedEvents[NumEvents] != event))
+    {
+        LE_ERROR("Unexpected event %s at %zu.", le_json_GetEventName(event), NumEvents);
+        IsMismatch = true;
+    }
+    NumEvents++;
+
+    if ((event == LE_JSON_NUMBER) && (Size == 0))
+    {
+        Size = le_json_GetNumber();
+    }
+    else if ((event == LE_JSON_DOC_END) && (DocFd != -1))
+    {
+        FinishFdTest();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler for all the parsing sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    LE_INFO("Error %d: %s", error, msg);
+    NumErrors++;
+
+    if (DocFd != -1)
+    {
+        LE_TEST(false);
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the document from memory, whole and truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBuffer
+(
+    void
+)
+{
+    char buffer[sizeof(Document) + sizeof(Trailer)];
+
+    snprintf(buffer, sizeof(buffer), "%s%s", Document, Trailer);
+
+    ResetResults();
+    LE_TEST(le_json_ParseBuffer(buffer, strlen(buffer), EventHandler, ErrorHandler, NULL) == LE_OK);
+    CheckResults();
+
+    ResetResults();
+    LE_TEST(le_json_ParseBuffer(Document, strlen(Document) - 1, EventHandler, ErrorHandler, NULL)
+            == LE_FAULT);
+    LE_TEST(NumErrors == 1);
+    LE_TEST(NumEvents == NUM_ARRAY_MEMBERS(ExpectedEvents) - 2);
+
+    ResetResults();
+    LE_TEST(le_json_ParseBuffer("{ \"x\": tru }", 12, EventHandler, ErrorHandler, NULL)
+            == LE_FAULT);
+    LE_TEST(NumErrors == 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a document tree from the document and look things up in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestDoc
+(
+    void
+)
+{
+    char buffer[sizeof(Document)];
+    le_json_NodeRef_t nodeRef;
+
+    memcpy(buffer, Document, sizeof(buffer));
+
+    le_json_DocRef_t docRef = le_json_CreateDoc(buffer, strlen(buffer));
+    LE_TEST(docRef != NULL);
+
+    le_json_NodeRef_t rootRef = le_json_GetDocRoot(docRef);
+    LE_TEST(le_json_GetNodeType(rootRef) == LE_JSON_CONTEXT_OBJECT);
+    LE_TEST(le_json_GetNodeCount(rootRef) == 4);
+    LE_TEST(le_json_GetNodeName(rootRef) == NULL);
+
+    nodeRef = le_json_FindNodeMember(rootRef, "name");
+    LE_TEST((nodeRef != NULL) && (strcmp(le_json_GetNodeString(nodeRef), "update") == 0));
+    LE_TEST(nodeRef == le_json_GetNodeChild(rootRef, 0));
+
+    nodeRef = le_json_FindNodeMember(rootRef, "size");
+    LE_TEST((nodeRef != NULL) && (le_json_GetNodeNumber(nodeRef) == 1234));
+    LE_TEST(le_json_GetNodeString(nodeRef) == NULL);
+
+    LE_TEST(le_json_FindNodeMember(rootRef, "missing") == NULL);
+    LE_TEST(le_json_GetNodeChild(rootRef, 4) == NULL);
+
+    nodeRef = le_json_FindNodeMember(rootRef, "list");
+    LE_TEST((nodeRef != NULL) && (le_json_GetNodeType(nodeRef) == LE_JSON_CONTEXT_ARRAY));
+    LE_TEST(le_json_GetNodeCount(nodeRef) == 4);
+    LE_TEST(le_json_GetNodeType(le_json_GetNodeChild(nodeRef, 0)) == LE_JSON_CONTEXT_TRUE);
+    LE_TEST(le_json_GetNodeType(le_json_GetNodeChild(nodeRef, 2)) == LE_JSON_CONTEXT_NULL);
+    LE_TEST(strcmp(le_json_GetNodeString(le_json_GetNodeChild(nodeRef, 3)), "ab") == 0);
+    LE_TEST(le_json_FindNodeMember(nodeRef, "ab") == NULL);
+
+    nodeRef = le_json_FindNodeMember(le_json_FindNodeMember(rootRef, "nested"), "x");
+    LE_TEST((nodeRef != NULL) && (le_json_GetNodeNumber(nodeRef) == -1.5));
+    LE_TEST(strcmp(le_json_GetNodeName(nodeRef), "x") == 0);
+
+    le_json_DeleteDoc(docRef);
+
+    memcpy(buffer, Document, sizeof(buffer));
+    LE_TEST(le_json_CreateDoc(buffer, strlen(buffer) - 1) == NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a document, including a copy of part of a document tree, and read it back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWriter
+(
+    void
+)
+{
+    static const char expected[] =
+        "{\"list\":[true,false,null,\"ab\"],\"esc\\\"\":\"a\\\\b\\n\\u0001\","
+        "\"numbers\":[0.1,-1.5,1e+300,null],\"empty\":{}}";
+    char buffer[sizeof(Document)];
+    char output[256];
+    int fds[2];
+
+    memcpy(buffer, Document, sizeof(buffer));
+    le_json_DocRef_t docRef = le_json_CreateDoc(buffer, strlen(buffer));
+    LE_ASSERT(docRef != NULL);
+
+    LE_ASSERT(pipe(fds) == 0);
+
+    le_json_WriterRef_t writerRef = le_json_CreateWriter(fds[1]);
+    le_json_WriteObjectStart(writerRef);
+    le_json_WriteMemberName(writerRef, "list");
+    le_json_WriteNode(writerRef, le_json_FindNodeMember(le_json_GetDocRoot(docRef), "list"));
+    le_json_WriteMemberName(writerRef, "esc\"");
+    le_json_WriteString(writerRef, "a\\b\n\x01");
+    le_json_WriteMemberName(writerRef, "numbers");
+    le_json_WriteArrayStart(writerRef);
+    le_json_WriteNumber(writerRef, 0.1);
+    le_json_WriteNumber(writerRef, -1.5);
+    le_json_WriteNumber(writerRef, 1e300);
+    le_json_WriteNumber(writerRef, NAN);
+    le_json_WriteArrayEnd(writerRef);
+    le_json_WriteMemberName(writerRef, "empty");
+    le_json_WriteObjectStart(writerRef);
+    le_json_WriteObjectEnd(writerRef);
+    le_json_WriteObjectEnd(writerRef);
+    LE_TEST(le_json_DeleteWriter(writerRef) == LE_OK);
+
+    LE_ASSERT(close(fds[1]) == 0);
+    ssize_t len = read(fds[0], output, sizeof(output) - 1);
+    LE_ASSERT(len >= 0);
+    output[len] = '\0';
+    LE_ASSERT(close(fds[0]) == 0);
+
+    LE_INFO("Wrote: %s", output);
+    LE_TEST(strcmp(output, expected) == 0);
+
+    // What was written can be read back.
+    le_json_DocRef_t outputDocRef = le_json_CreateDoc(output, len);
+    LE_TEST(outputDocRef != NULL);
+    if (outputDocRef != NULL)
+    {
+        LE_TEST(le_json_GetNodeCount(le_json_GetDocRoot(outputDocRef)) == 4);
+        LE_TEST(le_json_FindNodeMember(le_json_GetDocRoot(outputDocRef), "esc\\\"") != NULL);
+        le_json_DeleteDoc(outputDocRef);
+    }
+
+    le_json_DeleteDoc(docRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start parsing the document, followed by the trailer, from a regular file or a pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartFdTest
+(
+    void
+)
+{
+    char buffer[sizeof(Document) + sizeof(Trailer)];
+    int len = snprintf(buffer, sizeof(buffer), "%s%s", Document, Trailer);
+
+    if (IsPipe)
+    {
+        int fds[2];
+
+        LE_ASSERT(pipe2(fds, O_NONBLOCK) == 0);
+        LE_ASSERT(write(fds[1], buffer, len) == len);
+        LE_ASSERT(close(fds[1]) == 0);
+        DocFd = fds[0];
+    }
+    else
+    {
+        char path[] = "/tmp/jsonTestXXXXXX";
+
+        DocFd = mkstemp(path);
+        LE_ASSERT(DocFd != -1);
+        LE_ASSERT(unlink(path) == 0);
+        LE_ASSERT(write(DocFd, buffer, len) == len);
+        LE_ASSERT(lseek(DocFd, 0, SEEK_SET) == 0);
+    }
+
+    ResetResults();
+    le_json_Parse(DocFd, EventHandler, ErrorHandler, NULL);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN JSON TEST ========");
+
+    TestBuffer();
+    TestDoc();
+    TestWriter();
+    StartFdTest();
+}
@@ -0,0 +1,259 @@
+/**
+ * Test for binary (deferred-format) logging.
+ *
+ * Runs itself twice as a child process, once with normal logging and once with LE_LOG_BINARY=1,
+ * and checks that both runs log exactly the same messages (ignoring timestamps and process IDs),
+ * in the same order within each thread.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+/// Number of messages logged in a burst.  Enough to fill a ring buffer several times.
+#define NUM_BURST_MSGS      2000
+
+/// Largest number of lines of output captured from each child.
+#define MAX_LINES           (NUM_BURST_MSGS + 100)
+
+/// Longest line captured.
+#define MAX_LINE_BYTES      512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log messages from a second thread, which then terminates.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* OtherThread
+(
+    void* contextPtr
+)
+{
+    int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        LE_INFO("Other thread message %d of %d.", i, 10);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the test messages.  Runs in the child processes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogMessages
+(
+    void
+)
+{
+    char longStr[400];
+    const char* volatile nullStr = NULL;
+    int i;
+
+    memset(longStr, 'x', sizeof(longStr) - 1);
+    longStr[sizeof(longStr) - 1] = '\0';
+
+    le_log_SetFilterLevel(LE_LOG_DEBUG);
+
+    LE_DEBUG("Integers: %d %i %u %x %X %o %hhd %hd %ld %lld %llu %zu %zd %jd %td",
+             -1, 2, 3u, 0xabcu, 0xABCu, 8u, (signed char)-5, (short)-6, -7L, -8LL, 9ULL,
+             (size_t)10, (ssize_t)-11, (intmax_t)12, (ptrdiff_t)-13);
+    LE_INFO("Floats: %f %.2f %e %g %10.3Lf", 1.5, 2.25, 3e10, 0.0001, (long double)4.125);
+    LE_INFO("Chars and strings: '%c' '%s' '%.3s' '%10s' '%-10s|' '%s'",
+            'A', "hello", "truncated", "right", "left", nullStr);
+    LE_INFO("Widths: '%*d' '%-*d' '%.*s' '%*.*f'", 6, 42, 6, 42, 2, "abcdef", 8, 3, 3.14159);
+    LE_INFO("Pointer %p, percent 100%%, flags '%+d' '%05d' '%#x'",
+            (void*)0x1234, 5, 42, 255u);
+    LE_INFO("Long string: %s", longStr);
+    LE_INFO("No arguments at all.");
+
+    errno = ENOENT;
+    LE_INFO("errno message: %m (%d)", ENOENT);
+
+    // A warning is written straight away, and must come after the messages before it.
+    LE_WARN("Warning after %d messages.", 9);
+
+    le_log_TraceRef_t traceRef = le_log_GetTraceRef("binaryTest");
+    le_log_EnableTrace(traceRef);
+    LE_TRACE(traceRef, "Trace message %s.", "enabled");
+
+    for (i = 0; i < NUM_BURST_MSGS; i++)
+    {
+        LE_INFO("Burst message %d: %s", i, (i % 7 == 0) ? longStr + 100 : "short");
+    }
+
+    le_thread_Ref_t threadRef = le_thread_Create("other", OtherThread, NULL);
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+    le_thread_Join(threadRef, NULL);
+
+    LE_ERROR("Error at the end.");
+    LE_INFO("Last message.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output captured from a child.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t numLines;
+    char lines[MAX_LINES][MAX_LINE_BYTES];
+}
+Output_t;
+
+static Output_t TextOutput;
+static Output_t BinaryOutput;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the parts of a log line that differ between runs (the timestamp and the process ID).
+ */
+//--------------------------------------------------------------------------------------------------
+static void StripLine
+(
+    char* linePtr
+)
+{
+    char* startPtr = strstr(linePtr, " : ");
+    if (startPtr != NULL)
+    {
+        memmove(linePtr, startPtr + 3, strlen(startPtr + 3) + 1);
+    }
+
+    char* pidPtr = strchr(linePtr, '[');
+    char* pidEndPtr = (pidPtr != NULL) ? strchr(pidPtr, ']') : NULL;
+    if (pidEndPtr != NULL)
+    {
+        memmove(pidPtr, pidEndPtr + 1, strlen(pidEndPtr + 1) + 1);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a child and capture what it logs.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunChild
+(
+    bool isBinary,
+    Output_t* outputPtr
+)
+{
+    char exePath[PATH_MAX];
+    char command[PATH_MAX + 64];
+    char line[MAX_LINE_BYTES];
+
+    ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    LE_ASSERT(len > 0);
+    exePath[len] = '\0';
+
+    snprintf(command, sizeof(command), "LE_LOG_BINARY=%d '%s' child 2>&1",
+             isBinary ? 1 : 0, exePath);
+
+    FILE* filePtr = popen(command, "r");
+    LE_ASSERT(filePtr != NULL);
+
+    outputPtr->numLines = 0;
+    while (fgets(line, sizeof(line), filePtr) != NULL)
+    {
+        LE_ASSERT(outputPtr->numLines < MAX_LINES);
+
+        StripLine(line);
+        strcpy(outputPtr->lines[outputPtr->numLines++], line);
+    }
+
+    LE_TEST(pclose(filePtr) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the lines logged by one thread are the same in both outputs.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompareThread
+(
+    const char* threadTag   ///< [IN] e.g., "T=main |"
+)
+{
+    size_t textIndex = 0;
+    size_t binaryIndex = 0;
+    size_t numCompared = 0;
+
+    for (;;)
+    {
+        while ((textIndex < TextOutput.numLines)
+               && (strstr(TextOutput.lines[textIndex], threadTag) == NULL))
+        {
+            textIndex++;
+        }
+        while ((binaryIndex < BinaryOutput.numLines)
+               && (strstr(BinaryOutput.lines[binaryIndex], threadTag) == NULL))
+        {
+            binaryIndex++;
+        }
+
+        if ((textIndex == TextOutput.numLines) || (binaryIndex == BinaryOutput.numLines))
+        {
+            break;
+        }
+
+        if (strcmp(TextOutput.lines[textIndex], BinaryOutput.lines[binaryIndex]) != 0)
+        {
+            LE_ERROR("Mismatch:\n  text:   %s  binary: %s",
+                     TextOutput.lines[textIndex], BinaryOutput.lines[binaryIndex]);
+            LE_TEST(false);
+            return;
+        }
+
+        textIndex++;
+        binaryIndex++;
+        numCompared++;
+    }
+
+    // Both outputs must have run out at the same time.
+    LE_TEST((textIndex == TextOutput.numLines) && (binaryIndex == BinaryOutput.numLines));
+
+    LE_INFO("Compared %zu lines for '%s'.", numCompared, threadTag);
+    LE_TEST(numCompared > 0);
+}
+
+
+COMPONENT_INIT
+{
+    const char* modePtr = le_arg_GetArg(0);
+
+    if ((modePtr != NULL) && (strcmp(modePtr, "child") == 0))
+    {
+        LogMessages();
+        exit(EXIT_SUCCESS);
+    }
+
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN BINARY LOGGING TEST ========");
+
+    RunChild(false, &TextOutput);
+    RunChild(true, &BinaryOutput);
+
+    LE_TEST(TextOutput.numLines == BinaryOutput.numLines);
+    LE_TEST(TextOutput.numLines > NUM_BURST_MSGS);
+
+    CompareThread("T=main |");
+    CompareThread("T=other |");
+
+    LE_INFO("======== BINARY LOGGING TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
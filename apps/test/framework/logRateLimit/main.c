@@ -0,0 +1,215 @@
+/**
+ * Test for per-call-site log rate limiting.
+ *
+ * Checks the parsing of rate limit strings, then runs itself as a child process with
+ * LE_LOG_RATE_LIMIT set and checks which of the messages it logs get through, and that the
+ * dropped ones are reported.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+
+
+/// Rate limit given to the child: bursts of RATE_COUNT messages, then RATE_COUNT a second.
+#define RATE_COUNT          5
+#define RATE_LIMIT_STR      "5/1"
+
+/// Number of messages logged in each flood.
+#define NUM_FLOOD_MSGS      100
+
+/// Number of critical messages logged in a flood.  These must never be dropped.
+#define NUM_CRIT_MSGS       20
+
+/// Longest line captured.
+#define MAX_LINE_BYTES      512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the test messages.  Runs in the child process.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogMessages
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_FLOOD_MSGS; i++)
+    {
+        LE_WARN("Flood message %d.", i);
+    }
+
+    for (i = 0; i < NUM_CRIT_MSGS; i++)
+    {
+        LE_CRIT("Critical message %d.", i);
+    }
+
+    // Once the flooding call site has been quiet for the whole period, the next message logged
+    // by anyone makes the drops get reported.
+    usleep(1200 * 1000);
+    LE_INFO("After the flood.");
+
+    // Anything not yet reported when the process exits is reported then.
+    for (i = 0; i < NUM_FLOOD_MSGS; i++)
+    {
+        LE_INFO("Second flood message %d.", i);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the translation of rate limit strings.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestStrings
+(
+    void
+)
+{
+    static const char* badStrs[] = { "", "5", "5/", "/5", "0/1", "5/0", "-5/1", "5/-1", " 5/1",
+                                     "5/1x", "5:1", "on", "99999999999/1" };
+    log_RateLimit_t rateLimit;
+    char buffer[LOG_RATE_LIMIT_STR_BYTES];
+    size_t i;
+
+    LE_TEST(log_StrToRateLimit("10/60", &rateLimit) == LE_OK);
+    LE_TEST((rateLimit.count == 10) && (rateLimit.period == 60));
+    log_RateLimitToStr(&rateLimit, buffer, sizeof(buffer));
+    LE_TEST(strcmp(buffer, "10/60") == 0);
+
+    LE_TEST(log_StrToRateLimit("007/1", &rateLimit) == LE_OK);
+    log_RateLimitToStr(&rateLimit, buffer, sizeof(buffer));
+    LE_TEST(strcmp(buffer, "7/1") == 0);
+
+    LE_TEST(log_StrToRateLimit("off", &rateLimit) == LE_OK);
+    LE_TEST(rateLimit.count == 0);
+    log_RateLimitToStr(&rateLimit, buffer, sizeof(buffer));
+    LE_TEST(strcmp(buffer, "off") == 0);
+
+    rateLimit.count = UINT32_MAX;
+    rateLimit.period = UINT32_MAX;
+    log_RateLimitToStr(&rateLimit, buffer, sizeof(buffer));
+    LE_TEST(strcmp(buffer, "4294967295/4294967295") == 0);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(badStrs); i++)
+    {
+        LE_TEST(log_StrToRateLimit(badStrs[i], &rateLimit) == LE_FAULT);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the child and check what it logged.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestChild
+(
+    void
+)
+{
+    char exePath[PATH_MAX];
+    char command[PATH_MAX + 64];
+    char line[MAX_LINE_BYTES];
+    int numFlood = 0;
+    int numCrit = 0;
+    int numSecondFlood = 0;
+    int afterLine = -1;
+    int lineNum = 0;
+    int firstReportLine = -1;
+    bool hasFirstReport = false;
+    bool hasSecondReport = false;
+
+    ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    LE_ASSERT(len > 0);
+    exePath[len] = '\0';
+
+    snprintf(command, sizeof(command), "LE_LOG_RATE_LIMIT=%s '%s' child 2>&1",
+             RATE_LIMIT_STR, exePath);
+
+    FILE* filePtr = popen(command, "r");
+    LE_ASSERT(filePtr != NULL);
+
+    while (fgets(line, sizeof(line), filePtr) != NULL)
+    {
+        lineNum++;
+
+        if (strstr(line, "Second flood message") != NULL)
+        {
+            numSecondFlood++;
+        }
+        else if (strstr(line, "Flood message") != NULL)
+        {
+            numFlood++;
+        }
+        else if (strstr(line, "Critical message") != NULL)
+        {
+            numCrit++;
+        }
+        else if (strstr(line, "After the flood.") != NULL)
+        {
+            afterLine = lineNum;
+        }
+        else if (strstr(line, "last message repeated") != NULL)
+        {
+            char expected[64];
+
+            snprintf(expected, sizeof(expected), "last message repeated %d times",
+                     NUM_FLOOD_MSGS - RATE_COUNT);
+
+            if ((strstr(line, "-WRN- |") != NULL) && (strstr(line, expected) != NULL))
+            {
+                hasFirstReport = true;
+                firstReportLine = lineNum;
+            }
+            else if ((strstr(line, " INFO |") != NULL) && (strstr(line, expected) != NULL))
+            {
+                hasSecondReport = true;
+            }
+            else
+            {
+                LE_ERROR("Unexpected report: %s", line);
+                LE_TEST(false);
+            }
+        }
+    }
+
+    LE_TEST(pclose(filePtr) == 0);
+
+    LE_TEST(numFlood == RATE_COUNT);
+    LE_TEST(numCrit == NUM_CRIT_MSGS);
+    LE_TEST(numSecondFlood == RATE_COUNT);
+    LE_TEST(hasFirstReport);
+    LE_TEST(hasSecondReport);
+
+    // The first flood's report comes out just before the message that triggered it.
+    LE_TEST((afterLine != -1) && (firstReportLine == afterLine - 1));
+}
+
+
+COMPONENT_INIT
+{
+    const char* modePtr = le_arg_GetArg(0);
+
+    if ((modePtr != NULL) && (strcmp(modePtr, "child") == 0))
+    {
+        LogMessages();
+        exit(EXIT_SUCCESS);
+    }
+
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN LOG RATE LIMIT TEST ========");
+
+    TestStrings();
+    TestChild();
+
+    LE_INFO("======== LOG RATE LIMIT TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
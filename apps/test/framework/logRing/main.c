@@ -0,0 +1,389 @@
+/**
+ * Test for the shared-memory log rings that the Log Control Daemon shares with its clients.
+ *
+ * Plays both the Log Control Daemon's part (creating and reading the ring) and the client's part
+ * (mapping and writing into it), including a client that crashes and one that writes while the
+ * ring is being read.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+#include "logRing.h"
+
+#include <sys/wait.h>
+
+
+/// Size of the rings used by the test.
+#define RING_SIZE           4096
+
+/// Number of messages written by the concurrent writer thread.
+#define NUM_THREAD_MSGS     200000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Messages read out of a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t         numMsgs;                 ///< Number of messages read.
+    le_log_Level_t levels[400];             ///< Levels of the first messages.
+    char           msgs[400][80];           ///< Beginnings of the first messages.
+    char           lastMsg[LOG_MAX_LINE_SIZE]; ///< Last message read.
+    size_t         lastLen;                 ///< Length of the last message read.
+}
+ReadMsgs_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Collects messages read out of a ring into a ReadMsgs_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CollectMsg
+(
+    le_log_Level_t level,
+    const char* msgPtr,
+    void* contextPtr
+)
+{
+    ReadMsgs_t* readPtr = contextPtr;
+
+    if (readPtr->numMsgs < NUM_ARRAY_MEMBERS(readPtr->msgs))
+    {
+        readPtr->levels[readPtr->numMsgs] = level;
+        le_utf8_Copy(readPtr->msgs[readPtr->numMsgs], msgPtr, sizeof(readPtr->msgs[0]), NULL);
+    }
+
+    le_utf8_Copy(readPtr->lastMsg, msgPtr, sizeof(readPtr->lastMsg), NULL);
+    readPtr->lastLen = strlen(msgPtr);
+    readPtr->numMsgs++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a ring, and maps it again the way a client would.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateRing
+(
+    logRing_Ref_t* readerRefPtr,
+    logRing_Ref_t* writerRefPtr
+)
+{
+    int fd = -1;
+
+    *readerRefPtr = logRing_Create(RING_SIZE, getpid(), &fd);
+    LE_ASSERT(*readerRefPtr != NULL);
+    LE_ASSERT(fd >= 0);
+
+    // The client must not be able to resize the ring.
+    LE_TEST(ftruncate(fd, RING_SIZE / 2) != 0);
+    LE_TEST(ftruncate(fd, RING_SIZE * 2) != 0);
+
+    *writerRefPtr = logRing_Map(fd);
+    LE_ASSERT(*writerRefPtr != NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes and reads back a few messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBasic
+(
+    void
+)
+{
+    logRing_Ref_t readerRef;
+    logRing_Ref_t writerRef;
+    ReadMsgs_t readMsgs = { 0 };
+    uint64_t pos = 0;
+
+    CreateRing(&readerRef, &writerRef);
+
+    // An empty ring has nothing to read.
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) == 0);
+    LE_TEST(readMsgs.numMsgs == 0);
+
+    logRing_Write(writerRef, LE_LOG_INFO, "first");
+    logRing_Write(writerRef, (le_log_Level_t)-1, "trace");
+    logRing_Write(writerRef, LE_LOG_EMERG, "");
+    logRing_Write(writerRef, LE_LOG_DEBUG, "last");
+
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) == 0);
+    LE_TEST(readMsgs.numMsgs == 4);
+    LE_TEST((readMsgs.levels[0] == LE_LOG_INFO) && (strcmp(readMsgs.msgs[0], "first") == 0));
+    LE_TEST((readMsgs.levels[1] == (le_log_Level_t)-1) && (strcmp(readMsgs.msgs[1], "trace") == 0));
+    LE_TEST((readMsgs.levels[2] == LE_LOG_EMERG) && (strcmp(readMsgs.msgs[2], "") == 0));
+    LE_TEST((readMsgs.levels[3] == LE_LOG_DEBUG) && (strcmp(readMsgs.msgs[3], "last") == 0));
+
+    // Nothing new to read.
+    readMsgs.numMsgs = 0;
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) == 0);
+    LE_TEST(readMsgs.numMsgs == 0);
+
+    // Long messages are truncated.
+    char longMsg[LOG_MAX_LINE_SIZE * 2];
+    memset(longMsg, 'x', sizeof(longMsg) - 1);
+    longMsg[sizeof(longMsg) - 1] = '\0';
+
+    logRing_Write(writerRef, LE_LOG_WARN, longMsg);
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) == 0);
+    LE_TEST(readMsgs.numMsgs == 1);
+    LE_TEST(readMsgs.lastLen == LOG_MAX_LINE_SIZE - 1);
+
+    logRing_Delete(writerRef);
+    logRing_Delete(readerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes more than fits in the ring, and checks that the oldest messages are the ones lost.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestOverwrite
+(
+    void
+)
+{
+    logRing_Ref_t readerRef;
+    logRing_Ref_t writerRef;
+    ReadMsgs_t readMsgs = { 0 };
+    uint64_t pos = 0;
+    char msg[64];
+    int i;
+
+    CreateRing(&readerRef, &writerRef);
+
+    for (i = 0; i < 300; i++)
+    {
+        snprintf(msg, sizeof(msg), "message number %d is this one", i);
+        logRing_Write(writerRef, LE_LOG_INFO, msg);
+    }
+
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) > 0);
+    LE_TEST(readMsgs.numMsgs > 10);
+    LE_TEST(readMsgs.numMsgs < 300);
+    LE_TEST(strcmp(readMsgs.lastMsg, "message number 299 is this one") == 0);
+
+    // What was read must be the newest messages, complete and in order.
+    size_t first = 300 - readMsgs.numMsgs;
+    bool isOk = true;
+    for (i = 0; i < readMsgs.numMsgs; i++)
+    {
+        snprintf(msg, sizeof(msg), "message number %zu is this one", first + i);
+        if (strcmp(readMsgs.msgs[i], msg) != 0)
+        {
+            LE_ERROR("Got '%s', expected '%s'.", readMsgs.msgs[i], msg);
+            isOk = false;
+        }
+    }
+    LE_TEST(isOk);
+
+    // Reading from the start again gets the same messages (this is how the ring is dumped).
+    ReadMsgs_t dumpMsgs = { 0 };
+    pos = 0;
+    logRing_Read(readerRef, &pos, CollectMsg, &dumpMsgs);
+    LE_TEST(dumpMsgs.numMsgs == readMsgs.numMsgs);
+    LE_TEST(strcmp(dumpMsgs.msgs[0], readMsgs.msgs[0]) == 0);
+
+    logRing_Delete(writerRef);
+    logRing_Delete(readerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that the messages written by a process that crashes can still be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCrash
+(
+    void
+)
+{
+    logRing_Ref_t readerRef;
+    int fd = -1;
+
+    readerRef = logRing_Create(RING_SIZE, getpid(), &fd);
+    LE_ASSERT(readerRef != NULL);
+
+    pid_t pid = fork();
+    LE_ASSERT(pid >= 0);
+
+    if (pid == 0)
+    {
+        logRing_Ref_t writerRef = logRing_Map(fd);
+        if (writerRef == NULL)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        logRing_Write(writerRef, LE_LOG_INFO, "about to crash");
+        logRing_Write(writerRef, LE_LOG_CRIT, "crashing now");
+
+        // Die without cleaning anything up (and without leaving a core file behind).
+        kill(getpid(), SIGKILL);
+    }
+
+    close(fd);
+
+    int status;
+    LE_ASSERT(waitpid(pid, &status, 0) == pid);
+    LE_TEST(WIFSIGNALED(status) && (WTERMSIG(status) == SIGKILL));
+
+    ReadMsgs_t readMsgs = { 0 };
+    uint64_t pos = 0;
+    LE_TEST(logRing_Read(readerRef, &pos, CollectMsg, &readMsgs) == 0);
+    LE_TEST(readMsgs.numMsgs == 2);
+    LE_TEST(strcmp(readMsgs.msgs[0], "about to crash") == 0);
+    LE_TEST((readMsgs.levels[1] == LE_LOG_CRIT) && (strcmp(readMsgs.lastMsg, "crashing now") == 0));
+
+    logRing_Delete(readerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes numbered messages, with a number of characters that depends on the message number.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr
+)
+{
+    logRing_Ref_t writerRef = contextPtr;
+    char msg[200];
+    int i;
+
+    for (i = 0; i < NUM_THREAD_MSGS; i++)
+    {
+        int n = snprintf(msg, sizeof(msg), "%d:", i);
+        memset(msg + n, 'a' + (i % 26), i % 100);
+        msg[n + (i % 100)] = '\0';
+
+        logRing_Write(writerRef, LE_LOG_INFO, msg);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the check of the messages read while the writer thread runs.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int    nextNum;     ///< Lowest message number that can be read next.
+    size_t numMsgs;     ///< Number of messages read.
+    size_t numBad;      ///< Number of messages that were not what they should be.
+}
+ConcurrentCheck_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks a message written by the writer thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckThreadMsg
+(
+    le_log_Level_t level,
+    const char* msgPtr,
+    void* contextPtr
+)
+{
+    ConcurrentCheck_t* checkPtr = contextPtr;
+    char* endPtr;
+    long num = strtol(msgPtr, &endPtr, 10);
+    size_t i;
+
+    checkPtr->numMsgs++;
+
+    bool isOk = (level == LE_LOG_INFO) && (*endPtr == ':') && (num >= checkPtr->nextNum)
+                && (strlen(endPtr + 1) == num % 100);
+
+    for (i = 0; isOk && (endPtr[1 + i] != '\0'); i++)
+    {
+        isOk = (endPtr[1 + i] == 'a' + (num % 26));
+    }
+
+    if (!isOk)
+    {
+        LE_ERROR("Bad message '%s' (expected number %d or later).", msgPtr, checkPtr->nextNum);
+        checkPtr->numBad++;
+    }
+    else
+    {
+        checkPtr->nextNum = num + 1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the ring while another thread writes into it.  Messages may be lost, but everything that
+ * is read must be a complete message, and in order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestConcurrent
+(
+    void
+)
+{
+    logRing_Ref_t readerRef;
+    logRing_Ref_t writerRef;
+    ConcurrentCheck_t check = { 0 };
+    uint64_t pos = 0;
+    pthread_t thread;
+
+    CreateRing(&readerRef, &writerRef);
+
+    LE_ASSERT(pthread_create(&thread, NULL, WriterThread, writerRef) == 0);
+
+    while (check.nextNum < NUM_THREAD_MSGS)
+    {
+        logRing_Read(readerRef, &pos, CheckThreadMsg, &check);
+
+        if (check.numBad > 0)
+        {
+            break;
+        }
+    }
+
+    pthread_join(thread, NULL);
+
+    LE_INFO("Read %zu of %d messages.", check.numMsgs, NUM_THREAD_MSGS);
+    LE_TEST(check.numBad == 0);
+    LE_TEST(check.numMsgs > 0);
+
+    logRing_Delete(writerRef);
+    logRing_Delete(readerRef);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN LOG RING TEST ========");
+
+    TestBasic();
+    TestOverwrite();
+    TestCrash();
+    TestConcurrent();
+
+    LE_INFO("======== LOG RING TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
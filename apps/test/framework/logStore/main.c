@@ -0,0 +1,230 @@
+/**
+ * Test for the compressed log store that the Log Control Daemon keeps on flash.
+ *
+ * Writes messages into a store in a temporary directory and reads them back, with and without
+ * time and level filters, then fills the store until its oldest segments are reused, and checks
+ * that a corrupt block is skipped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "logStore.h"
+
+
+/// Number of messages written to make the store reuse its oldest segments.
+#define NUM_FILL_MSGS       300000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Messages read out of the store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t         numMsgs;                 ///< Number of messages read.
+    le_log_Level_t levels[16];              ///< Levels of the first messages.
+    char           msgs[16][80];            ///< First messages.
+    uint64_t       firstMs;                 ///< Time of the first message read.
+    uint64_t       lastMs;                  ///< Time of the last message read.
+    bool           isOrdered;               ///< false if a message was older than the one before.
+    char           lastMsg[80];             ///< Last message read.
+}
+ReadMsgs_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the temporary store directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static char DirPath[] = "/tmp/logStoreTestXXXXXX";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Collects messages read out of the store into a ReadMsgs_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CollectMsg
+(
+    uint64_t timeMs,
+    le_log_Level_t level,
+    const char* msgPtr,
+    void* contextPtr
+)
+{
+    ReadMsgs_t* readPtr = contextPtr;
+
+    if (readPtr->numMsgs < NUM_ARRAY_MEMBERS(readPtr->msgs))
+    {
+        readPtr->levels[readPtr->numMsgs] = level;
+        le_utf8_Copy(readPtr->msgs[readPtr->numMsgs], msgPtr, sizeof(readPtr->msgs[0]), NULL);
+    }
+
+    if (readPtr->numMsgs == 0)
+    {
+        readPtr->firstMs = timeMs;
+        readPtr->isOrdered = true;
+    }
+    else if (timeMs < readPtr->lastMs)
+    {
+        readPtr->isOrdered = false;
+    }
+
+    le_utf8_Copy(readPtr->lastMsg, msgPtr, sizeof(readPtr->lastMsg), NULL);
+    readPtr->lastMs = timeMs;
+    readPtr->numMsgs++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes and reads back a few messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBasic
+(
+    void
+)
+{
+    ReadMsgs_t readMsgs = { 0 };
+
+    // There's no store until one is opened.
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs)
+            == LE_NOT_FOUND);
+
+    LE_ASSERT(logStore_Open(DirPath) == LE_OK);
+
+    logStore_Write(LE_LOG_INFO, "first");
+    logStore_Write((le_log_Level_t)-1, "trace");
+    logStore_Write(LE_LOG_EMERG, "");
+    logStore_Write(LE_LOG_DEBUG, "last");
+
+    // Nothing is readable until it's flushed.
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs) == LE_OK);
+    LE_TEST(readMsgs.numMsgs == 0);
+
+    logStore_Flush();
+
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs) == LE_OK);
+    LE_TEST(readMsgs.numMsgs == 4);
+    LE_TEST((readMsgs.levels[0] == LE_LOG_INFO) && (strcmp(readMsgs.msgs[0], "first") == 0));
+    LE_TEST((readMsgs.levels[1] == (le_log_Level_t)-1)
+            && (strcmp(readMsgs.msgs[1], "trace") == 0));
+    LE_TEST((readMsgs.levels[2] == LE_LOG_EMERG) && (strcmp(readMsgs.msgs[2], "") == 0));
+    LE_TEST((readMsgs.levels[3] == LE_LOG_DEBUG) && (strcmp(readMsgs.msgs[3], "last") == 0));
+
+    // Level filter.
+    memset(&readMsgs, 0, sizeof(readMsgs));
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX,
+                          LOG_STORE_LEVEL_BIT(LE_LOG_EMERG) | LOG_STORE_LEVEL_BIT(-1),
+                          CollectMsg, &readMsgs) == LE_OK);
+    LE_TEST(readMsgs.numMsgs == 2);
+    LE_TEST(strcmp(readMsgs.msgs[0], "trace") == 0);
+    LE_TEST(readMsgs.levels[1] == LE_LOG_EMERG);
+
+    // Time filter.
+    uint64_t lastMs = readMsgs.lastMs;
+    memset(&readMsgs, 0, sizeof(readMsgs));
+    LE_TEST(logStore_Read(DirPath, lastMs + 1, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs)
+            == LE_OK);
+    LE_TEST(readMsgs.numMsgs == 0);
+    LE_TEST(logStore_Read(DirPath, 0, lastMs, UINT32_MAX, CollectMsg, &readMsgs) == LE_OK);
+    LE_TEST(readMsgs.numMsgs == 4);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes enough messages for the oldest segments to be reused.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFill
+(
+    void
+)
+{
+    ReadMsgs_t readMsgs = { 0 };
+    char msg[100];
+    int i;
+
+    for (i = 0; i < NUM_FILL_MSGS; i++)
+    {
+        snprintf(msg, sizeof(msg), "proc[%d]/comp T=main | file.c Func() %d: message %d",
+                 i % 7, i % 500, i);
+        logStore_Write(i % 6, msg);
+    }
+    logStore_Flush();
+
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs) == LE_OK);
+
+    // The first messages are gone, the last ones are all there, in order.
+    LE_TEST(readMsgs.numMsgs > 0);
+    LE_TEST(readMsgs.numMsgs < NUM_FILL_MSGS);
+    LE_TEST(strncmp(readMsgs.msgs[0], "proc[", 5) == 0);
+    LE_TEST(readMsgs.isOrdered);
+    snprintf(msg, sizeof(msg), "proc[%d]/comp T=main | file.c Func() %d: message %d",
+             (NUM_FILL_MSGS - 1) % 7, (NUM_FILL_MSGS - 1) % 500, NUM_FILL_MSGS - 1);
+    LE_TEST(strcmp(readMsgs.lastMsg, msg) == 0);
+
+    int firstNum = atoi(strrchr(readMsgs.msgs[0], ' ') + 1);
+    LE_TEST(readMsgs.numMsgs == (size_t)(NUM_FILL_MSGS - firstNum));
+
+    LE_INFO("Store kept %zu messages of %d.", readMsgs.numMsgs, NUM_FILL_MSGS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Corrupts the data of every segment, and checks that reading the store skips the bad blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCorrupt
+(
+    void
+)
+{
+    ReadMsgs_t readMsgs = { 0 };
+    char path[LIMIT_MAX_PATH_BYTES];
+    char garbage[4096];
+    int i;
+
+    memset(garbage, 0xF0, sizeof(garbage));
+
+    for (i = 0; i < LOG_STORE_SEGMENT_COUNT; i++)
+    {
+        snprintf(path, sizeof(path), "%s/segment%d", DirPath, i);
+
+        int fd = open(path, O_WRONLY);
+        LE_ASSERT(fd >= 0);
+        LE_ASSERT(pwrite(fd, garbage, sizeof(garbage), LOG_STORE_SEGMENT_BYTES / 2)
+                  == sizeof(garbage));
+        close(fd);
+    }
+
+    LE_TEST(logStore_Read(DirPath, 0, UINT64_MAX, UINT32_MAX, CollectMsg, &readMsgs) == LE_OK);
+    LE_TEST(readMsgs.numMsgs > 0);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN LOG STORE TEST ========");
+
+    LE_ASSERT(mkdtemp(DirPath) != NULL);
+
+    TestBasic();
+    TestFill();
+    TestCorrupt();
+
+    LE_ASSERT(le_dir_RemoveRecursive(DirPath) == LE_OK);
+
+    LE_INFO("======== LOG STORE TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
@@ -31,6 +31,12 @@ colourObj_t;
 #define FORCE_SIZE          3
 #define NUM_EXPAND_SUB_POOL 2
 #define NUM_ALLOC_SUPER_POOL    1
+#define CACHED_POOL_SIZE        64
+#define THREAD_CACHE_SIZE       8
+#define NUM_CACHE_THREADS       4
+#define NUM_CACHE_ITERATIONS    10000
+#define NUM_CACHE_OBJS_PER_ITER 6
+#define REGION_POOL_SIZE        100
 
 static unsigned int NumRelease = 0;
 static unsigned int ReleaseId;
@@ -46,6 +52,32 @@ static void IdDestructor(void* objPtr)
 }
 
 
+static le_mem_PoolRef_t CachedPool;
+
+static void* CachedPoolThread(void* contextPtr)
+{
+    idObj_t* objsPtr[NUM_CACHE_OBJS_PER_ITER];
+    unsigned int i, j;
+
+    for (i = 0; i < NUM_CACHE_ITERATIONS; i++)
+    {
+        for (j = 0; j < NUM_CACHE_OBJS_PER_ITER; j++)
+        {
+            objsPtr[j] = le_mem_ForceAlloc(CachedPool);
+            objsPtr[j]->id = j;
+        }
+
+        for (j = 0; j < NUM_CACHE_OBJS_PER_ITER; j++)
+        {
+            LE_ASSERT(objsPtr[j]->id == j);
+            le_mem_Release(objsPtr[j]);
+        }
+    }
+
+    return NULL;
+}
+
+
 COMPONENT_INIT
 {
     le_mem_PoolRef_t idPool, colourPool;
@@ -525,6 +557,180 @@ COMPONENT_INIT
     }
     printf("Successfully searched for pools by name.\n");
 #endif
+
+    //
+    // Allocate and release from a pool with thread caches from several threads.
+    //
+    {
+        le_thread_Ref_t threads[NUM_CACHE_THREADS];
+        le_mem_PoolStats_t stats;
+
+        CachedPool = le_mem_CreatePool("Cached Pool", sizeof(idObj_t));
+        le_mem_SetThreadCacheSize(CachedPool, THREAD_CACHE_SIZE);
+        le_mem_ExpandPool(CachedPool, CACHED_POOL_SIZE);
+
+        for (i = 0; i < NUM_CACHE_THREADS; i++)
+        {
+            threads[i] = le_thread_Create("cacheTest", CachedPoolThread, NULL);
+            le_thread_SetJoinable(threads[i]);
+            le_thread_Start(threads[i]);
+        }
+
+        for (i = 0; i < NUM_CACHE_THREADS; i++)
+        {
+            LE_ASSERT(le_thread_Join(threads[i], NULL) == LE_OK);
+        }
+
+        le_mem_GetStats(CachedPool, &stats);
+
+        if ( (stats.numBlocksInUse != 0) ||
+             (stats.numAllocs != NUM_CACHE_THREADS * NUM_CACHE_ITERATIONS * NUM_CACHE_OBJS_PER_ITER) ||
+             (stats.numFree != le_mem_GetObjectCount(CachedPool)) ||
+             (stats.maxNumBlocksUsed > NUM_CACHE_THREADS * NUM_CACHE_OBJS_PER_ITER) )
+        {
+            printf("Thread cache stats are incorrect: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        // All cached blocks should have gone back to the pool when the threads exited.
+        for (i = 0; i < CACHED_POOL_SIZE; i++)
+        {
+            if (le_mem_TryAlloc(CachedPool) == NULL)
+            {
+                printf("Thread cache blocks not returned to pool: %d", __LINE__);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    printf("Thread caches work correctly.\n");
+
+    //
+    // Allocate objects of various sizes from size-class allocators.
+    //
+    {
+        static const size_t sizes[] = { 0, 1, 16, 17, 24, 25, 32, 33, 100, 1000, 65536, 65537 };
+        static const size_t classSizes[] = { 16, 16, 16, 24, 24, 32, 32, 48, 128, 1024, 65536,
+                                             98304 };
+        le_mem_SizeClassAllocatorRef_t bufAllocator =
+            le_mem_CreateSizeClassAllocator("Buffers", LE_MEM_SIZE_CLASS_MAX_BYTES);
+        le_mem_SizeClassAllocatorRef_t strAllocator =
+            le_mem_CreateSizeClassAllocator("Strings", 100);
+        uint8_t* bufsPtr[NUM_ARRAY_MEMBERS(sizes)];
+        le_mem_PoolStats_t stats;
+        char name[32];
+
+        for (i = 0; i < NUM_ARRAY_MEMBERS(sizes); i++)
+        {
+            bufsPtr[i] = le_mem_SizeClassAlloc(bufAllocator, sizes[i]);
+            memset(bufsPtr[i], i, sizes[i]);
+
+            // Each object comes from the sub-pool of the smallest size class that holds it.
+            snprintf(name, sizeof(name), "Buffers.%zu", classSizes[i]);
+            le_mem_PoolRef_t subPool = le_mem_FindPool(name);
+            if ( (subPool == NULL) || (le_mem_GetObjectSize(subPool) != classSizes[i]) )
+            {
+                printf("Wrong size class for %zu bytes: %d", sizes[i], __LINE__);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // Both allocators share the super-pool of a size class, but not their sub-pools.  The
+        // super-pools are created by liblegato, so they belong to the framework component.
+        char* strPtr = le_mem_SizeClassAlloc(strAllocator, 20);
+        le_mem_GetStats(le_mem_FindPool("Buffers.24"), &stats);
+        if ( (le_mem_FindPool("Strings.24") == NULL) ||
+             (stats.numBlocksInUse != 2) ||
+             (le_mem_GetObjectCount(_le_mem_FindPool("framework", "SizeClass24")) != 3) )
+        {
+            printf("Error in size-class pools: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+        le_mem_Release(strPtr);
+
+        for (i = 0; i < NUM_ARRAY_MEMBERS(sizes); i++)
+        {
+            size_t j;
+
+            for (j = 0; j < sizes[i]; j++)
+            {
+                if (bufsPtr[i][j] != (uint8_t)i)
+                {
+                    printf("Size-class object overwritten: %d", __LINE__);
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            le_mem_Release(bufsPtr[i]);
+        }
+
+        // Released objects are reused.
+        le_mem_GetStats(le_mem_FindPool("Buffers.16"), &stats);
+        if ( (stats.numBlocksInUse != 0) || (stats.numFree != 3) )
+        {
+            printf("Error in size-class pools: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+        bufsPtr[0] = le_mem_SizeClassAlloc(bufAllocator, 10);
+        if (le_mem_GetObjectCount(le_mem_FindPool("Buffers.16")) != 3)
+        {
+            printf("Error in size-class pools: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+        le_mem_Release(bufsPtr[0]);
+    }
+
+    printf("Size-class allocators work correctly.\n");
+
+    //
+    // Allocate from a pool with a reserved region.
+    //
+    {
+        idObj_t* regionObjsPtr[REGION_POOL_SIZE + 1];
+        le_mem_PoolRef_t regionPool = le_mem_CreatePool("Region Pool", sizeof(idObj_t));
+        size_t blockSize = le_mem_GetObjectFullSize(regionPool);
+
+        le_mem_ReserveRegion(regionPool, REGION_POOL_SIZE,
+                             LE_MEM_REGION_PREFAULT | LE_MEM_REGION_HUGEPAGES);
+        le_mem_ExpandPool(regionPool, REGION_POOL_SIZE);
+
+        // The objects are handed out in address order, one block apart.
+        for (i = 0; i < REGION_POOL_SIZE; i++)
+        {
+            regionObjsPtr[i] = le_mem_AssertAlloc(regionPool);
+            regionObjsPtr[i]->id = i;
+
+            if ( (i > 0) &&
+                 ((uint8_t*)regionObjsPtr[i] - (uint8_t*)regionObjsPtr[i - 1] != blockSize) )
+            {
+                printf("Region objects are not contiguous: %d", __LINE__);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // The region is rounded up to a whole huge page, so the pool can still grow inside it.
+        regionObjsPtr[REGION_POOL_SIZE] = le_mem_ForceAlloc(regionPool);
+        if ( ((uint8_t*)regionObjsPtr[REGION_POOL_SIZE]
+              - (uint8_t*)regionObjsPtr[REGION_POOL_SIZE - 1]) != blockSize )
+        {
+            printf("Region pool expansion is not contiguous: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        for (i = 0; i < REGION_POOL_SIZE; i++)
+        {
+            if (regionObjsPtr[i]->id != i)
+            {
+                printf("Region object overwritten: %d", __LINE__);
+                exit(EXIT_FAILURE);
+            }
+            le_mem_Release(regionObjsPtr[i]);
+        }
+        le_mem_Release(regionObjsPtr[REGION_POOL_SIZE]);
+    }
+
+    printf("Reserved regions work correctly.\n");
+
     printf("*** Unit Test for le_mem module passed. ***\n");
     printf("\n");
     exit(EXIT_SUCCESS);
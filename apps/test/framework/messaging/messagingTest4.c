@@ -0,0 +1,214 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 4:
+ *  - Serve up a named service and then act as its own client (see Test 1).
+ *  - Client sends a request with a large shared buffer attached.  Server checks the contents of
+ *    the buffer and responds with a shared buffer of its own, which the client then checks.
+ *  - Also tests that a message without a shared buffer reports none.
+ *  - Client sends only the used part of its request payload.  Server checks the received size
+ *    and that the part that wasn't sent reads as zeros.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+#include <sys/mman.h>
+
+
+#define SERVICE_INSTANCE_NAME "messagingTest4"
+
+#define PROTOCOL_ID_STR "SharedBufferProtocol"
+
+/// Size of the buffer sent in the request.  Much larger than any message payload.
+#define REQUEST_BUFFER_SIZE     (1024 * 1024)
+
+/// Size of the buffer sent in the response.
+#define RESPONSE_BUFFER_SIZE    (64 * 1024 + 3)
+
+
+typedef struct
+{
+    uint32_t seed;      ///< Value used to generate the expected contents of the shared buffer.
+    uint8_t  unused[252];   ///< Not sent in requests.
+}
+Message_t;
+
+
+// Fill a buffer with a pattern that depends on a seed value.
+static void FillBuffer
+(
+    uint8_t* bufPtr,
+    size_t   size,
+    uint32_t seed
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        bufPtr[i] = (uint8_t)(seed + i * 7 + (i >> 8));
+    }
+}
+
+
+// Check that a buffer contains the pattern generated by FillBuffer().
+static bool CheckBuffer
+(
+    const uint8_t* bufPtr,
+    size_t         size,
+    uint32_t       seed
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (bufPtr[i] != (uint8_t)(seed + i * 7 + (i >> 8)))
+        {
+            LE_ERROR("Mismatch at offset %zu.", i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    size_t size = 0;
+
+    LE_TEST(le_msg_NeedsResponse(msgRef));
+
+    // Only the seed was sent, and the rest of the payload must have been cleared.
+    LE_TEST(le_msg_GetPayloadSize(msgRef) == offsetof(Message_t, unused));
+    size_t i;
+    for (i = 0; (i < sizeof(msgPtr->unused)) && (msgPtr->unused[i] == 0); i++)
+    {
+    }
+    LE_TEST(i == sizeof(msgPtr->unused));
+
+    const uint8_t* bufPtr = le_msg_GetSharedBuffer(msgRef, &size);
+    LE_TEST(bufPtr != NULL);
+    LE_TEST(size == REQUEST_BUFFER_SIZE);
+    LE_TEST(CheckBuffer(bufPtr, size, msgPtr->seed));
+
+    // Fetching the buffer again should give the same mapping, and the fd has been consumed.
+    size_t sizeAgain = 0;
+    LE_TEST(le_msg_GetSharedBuffer(msgRef, &sizeAgain) == bufPtr);
+    LE_TEST(sizeAgain == size);
+    LE_TEST(le_msg_GetFd(msgRef) == -1);
+
+    // The received buffer must not be writable by the receiver.
+    LE_TEST(mprotect((void*)bufPtr, size, PROT_READ | PROT_WRITE) != 0);
+
+    // Reply with a buffer of our own, reusing the request message.  The whole payload is sent back,
+    // even though the request only used part of it.
+    msgPtr->seed = ~msgPtr->seed;
+    uint8_t* respBufPtr = le_msg_CreateSharedBuffer(msgRef, RESPONSE_BUFFER_SIZE);
+    LE_TEST(respBufPtr != NULL);
+    FillBuffer(respBufPtr, RESPONSE_BUFFER_SIZE, msgPtr->seed);
+
+    le_msg_Respond(msgRef);
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_ASSERT(msgRef != NULL);
+
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    size_t size = 0;
+
+    const uint8_t* bufPtr = le_msg_GetSharedBuffer(msgRef, &size);
+    LE_TEST(bufPtr != NULL);
+    LE_TEST(size == RESPONSE_BUFFER_SIZE);
+    LE_TEST(CheckBuffer(bufPtr, size, msgPtr->seed));
+    LE_TEST(le_msg_GetPayloadSize(msgRef) == sizeof(Message_t));
+
+    le_msg_ReleaseMsg(msgRef);
+
+    LE_TEST_SUMMARY
+}
+
+
+static void SessionOpenHandlerFunc
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed into le_msg_OpenSession().
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+    LE_TEST(le_msg_GetPayloadSize(msgRef) == sizeof(Message_t));
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    size_t size = 0;
+
+    // A fresh message has no shared buffer.
+    LE_TEST(le_msg_GetSharedBuffer(msgRef, &size) == NULL);
+
+    msgPtr->seed = 0x5A;
+    memset(msgPtr->unused, 0xFF, sizeof(msgPtr->unused));
+    le_msg_SetPayloadSize(msgRef, offsetof(Message_t, unused));
+    uint8_t* bufPtr = le_msg_CreateSharedBuffer(msgRef, REQUEST_BUFFER_SIZE);
+    LE_TEST(bufPtr != NULL);
+    FillBuffer(bufPtr, REQUEST_BUFFER_SIZE, msgPtr->seed);
+
+    le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, NULL);
+}
+
+
+static void ClientStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_OpenSession(sessionRef, SessionOpenHandlerFunc, NULL);
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    LE_INFO("======= Test 4: Shared buffers ========");
+
+    system("testFwMessaging-Setup");
+
+    ServerStart();
+
+    ClientStart();
+}
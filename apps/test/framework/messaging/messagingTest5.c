@@ -0,0 +1,170 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 5:
+ *  - Serve up a named service and then act as its own client (see Test 1).
+ *  - Client starts a (nested) batch and makes a number of asynchronous requests.  Checks that
+ *    none of them reaches the server until the outermost batch ends, and that the responses then
+ *    all arrive, in order.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+#define SERVICE_INSTANCE_NAME "messagingTest5"
+
+#define PROTOCOL_ID_STR "BatchProtocol"
+
+/// Number of requests made in the batch.
+#define NUM_REQUESTS 20
+
+
+typedef struct
+{
+    uint32_t index;     ///< Index of the request in the batch.
+}
+Message_t;
+
+
+static le_msg_SessionRef_t SessionRef;
+
+static int ServerRequestCount = 0;  // Number of requests received by the server.
+static int ClientResponseCount = 0; // Number of responses received by the client.
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    LE_TEST(le_msg_NeedsResponse(msgRef));
+    LE_TEST(msgPtr->index == ServerRequestCount);
+
+    ServerRequestCount++;
+
+    le_msg_Respond(msgRef);
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_ASSERT(msgRef != NULL);
+
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    LE_TEST(msgPtr->index == (uint32_t)(size_t)contextPtr);
+    LE_TEST(msgPtr->index == ClientResponseCount);
+
+    le_msg_ReleaseMsg(msgRef);
+
+    ClientResponseCount++;
+
+    if (ClientResponseCount == NUM_REQUESTS)
+    {
+        LE_TEST(ServerRequestCount == NUM_REQUESTS);
+
+        LE_TEST_SUMMARY
+    }
+}
+
+
+// Called after the event loop has had a chance to run with the batch still held.
+static void BatchTimerExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    // Nothing must have been sent yet.
+    LE_TEST(ServerRequestCount == 0);
+    LE_TEST(ClientResponseCount == 0);
+
+    // Ending the inner batch doesn't send anything, but ending the outer one does.
+    le_msg_EndBatch(SessionRef);
+    le_msg_EndBatch(SessionRef);
+
+    le_timer_Delete(timerRef);
+}
+
+
+static void SessionOpenHandlerFunc
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed into le_msg_OpenSession().
+)
+{
+    size_t i;
+
+    le_msg_StartBatch(sessionRef);
+    le_msg_StartBatch(sessionRef);
+
+    for (i = 0; i < NUM_REQUESTS; i++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+        Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+        msgPtr->index = i;
+
+        le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, (void*)i);
+    }
+
+    // Give the server a chance to receive something, to make sure it doesn't.
+    le_timer_Ref_t timerRef = le_timer_Create("batchTimer");
+    le_timer_SetMsInterval(timerRef, 100);
+    le_timer_SetHandler(timerRef, BatchTimerExpiryHandler);
+    le_timer_Start(timerRef);
+}
+
+
+static void ClientStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    SessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_OpenSession(SessionRef, SessionOpenHandlerFunc, NULL);
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    LE_INFO("======= Test 5: Batched requests ========");
+
+    system("testFwMessaging-Setup");
+
+    ServerStart();
+
+    ClientStart();
+}
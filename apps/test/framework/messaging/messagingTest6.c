@@ -0,0 +1,259 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 6:
+ *  - Serve up a service and bind a client interface to it in-process (see msg_AddLocalBinding()),
+ *    without any binding in the Service Directory.
+ *  - A client thread opens a session, which can only succeed if it is opened locally, and
+ *    round-trips a synchronous and an asynchronous request over it.
+ *  - The client closes the session, and the server's close handler must be called.
+ *  - The client reopens the session and asks the server to close it.  The client's close handler
+ *    must be called (and the server's again).
+ *
+ * Needs a running Service Directory, to advertise the service, but no bindings.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "messaging.h"
+
+
+#define CLIENT_INTERFACE_NAME "messagingTest6"
+#define SERVER_INTERFACE_NAME "messagingTest6Local"
+
+#define PROTOCOL_ID_STR "LocalProtocol"
+
+/// Value that asks the server to close the session, instead of echoing.
+#define CLOSE_REQUEST 0
+
+
+typedef struct
+{
+    uint32_t value;     ///< Request value, or the request value plus one in the response.
+}
+Message_t;
+
+
+static le_thread_Ref_t MainThreadRef;
+static le_thread_Ref_t ClientThreadRef;
+static le_msg_ProtocolRef_t ProtocolRef;
+static le_msg_SessionRef_t SessionRef;
+
+static int ServerOpenCount = 0;     // Number of times the server's open handler was called.
+static int ServerCloseCount = 0;    // Number of times the server's close handler was called.
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    // The server runs in the main thread, not the client's.
+    LE_TEST(le_thread_GetCurrent() == MainThreadRef);
+
+    // The client is this process.
+    pid_t pid;
+    uid_t uid;
+    LE_TEST(le_msg_GetClientUserCreds(le_msg_GetSession(msgRef), &uid, &pid) == LE_OK);
+    LE_TEST(pid == getpid());
+
+    // The open handler is called before anything is received on the session.
+    if (msgPtr->value == CLOSE_REQUEST)
+    {
+        LE_TEST(ServerOpenCount == 2);
+        LE_TEST(!le_msg_NeedsResponse(msgRef));
+
+        le_msg_SessionRef_t sessionRef = le_msg_GetSession(msgRef);
+        le_msg_ReleaseMsg(msgRef);
+        le_msg_CloseSession(sessionRef);
+    }
+    else
+    {
+        LE_TEST(ServerOpenCount == 1);
+        LE_TEST(le_msg_NeedsResponse(msgRef));
+
+        msgPtr->value++;
+        le_msg_Respond(msgRef);
+    }
+}
+
+
+static void ServerOpenHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed to le_msg_AddServiceOpenHandler().
+)
+{
+    ServerOpenCount++;
+}
+
+
+static void ServerCloseHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that closed.
+    void*               contextPtr  // contextPtr passed to le_msg_AddServiceCloseHandler().
+)
+{
+    ServerCloseCount++;
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(ProtocolRef, SERVER_INTERFACE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AddServiceOpenHandler(serviceRef, ServerOpenHandler, NULL);
+    le_msg_AddServiceCloseHandler(serviceRef, ServerCloseHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+// Called in the client thread after the server has seen the client close the session.
+static void ClientReopen
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    LE_TEST(ServerCloseCount == 1);
+
+    LE_TEST(le_msg_TryOpenSessionSync(SessionRef) == LE_OK);
+
+    // Ask the server to close the session from its end.
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    msgPtr->value = CLOSE_REQUEST;
+    le_msg_Send(msgRef);
+}
+
+
+// Called in the main (server) thread after the session has been closed from either end.
+static void CheckServerClosed
+(
+    void* param1Ptr,    // Number of times the session has been closed.
+    void* param2Ptr
+)
+{
+    int closeCount = (int)(size_t)param1Ptr;
+
+    // Anything the close queued to this thread is ahead of this, so it must have been handled by
+    // now.  The server is notified of the close even when it closed the session itself.
+    LE_TEST(ServerCloseCount == closeCount);
+
+    if (closeCount == 1)
+    {
+        le_event_QueueFunctionToThread(ClientThreadRef, ClientReopen, NULL, NULL);
+    }
+    else
+    {
+        LE_TEST(ServerOpenCount == 2);
+
+        LE_TEST_SUMMARY
+    }
+}
+
+
+static void ClientCloseHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that closed.
+    void*               contextPtr  // contextPtr passed to le_msg_SetSessionCloseHandler().
+)
+{
+    LE_TEST(sessionRef == SessionRef);
+    LE_TEST(le_thread_GetCurrent() == ClientThreadRef);
+
+    le_event_QueueFunctionToThread(MainThreadRef, CheckServerClosed, (void*)2, NULL);
+}
+
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_ASSERT(msgRef != NULL);
+
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_TEST(msgPtr->value == (uint32_t)(size_t)contextPtr + 1);
+    le_msg_ReleaseMsg(msgRef);
+
+    LE_TEST(ServerCloseCount == 0);
+
+    // Close the session from the client end.  The session can be reopened afterwards.
+    le_msg_CloseSession(SessionRef);
+
+    le_event_QueueFunctionToThread(MainThreadRef, CheckServerClosed, (void*)1, NULL);
+}
+
+
+static void* ClientThreadMain
+(
+    void* contextPtr
+)
+{
+    SessionRef = le_msg_CreateSession(ProtocolRef, CLIENT_INTERFACE_NAME);
+    le_msg_SetSessionCloseHandler(SessionRef, ClientCloseHandler, NULL);
+
+    // There is no binding for the client interface in the Service Directory, so this can only
+    // succeed (or fail, rather than wait) if the session is opened in-process.
+    LE_TEST(le_msg_TryOpenSessionSync(SessionRef) == LE_OK);
+
+    // Synchronous round trip.
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    msgPtr->value = 1;
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+    LE_TEST(msgRef != NULL);
+    if (msgRef != NULL)
+    {
+        msgPtr = le_msg_GetPayloadPtr(msgRef);
+        LE_TEST(msgPtr->value == 2);
+        le_msg_ReleaseMsg(msgRef);
+    }
+
+    // Asynchronous round trip.  The rest of the test is driven from the response handler.
+    msgRef = le_msg_CreateMsg(SessionRef);
+    msgPtr = le_msg_GetPayloadPtr(msgRef);
+    msgPtr->value = 10;
+    le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, (void*)(size_t)10);
+
+    le_event_RunLoop();
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    LE_INFO("======= Test 6: In-process sessions ========");
+
+    LE_TEST_INIT;
+
+    msg_AddLocalBinding(CLIENT_INTERFACE_NAME, SERVER_INTERFACE_NAME);
+
+    ProtocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+
+    MainThreadRef = le_thread_GetCurrent();
+
+    ServerStart();
+
+    ClientThreadRef = le_thread_Create("Client", ClientThreadMain, NULL);
+    le_thread_Start(ClientThreadRef);
+}
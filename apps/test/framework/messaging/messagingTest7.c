@@ -0,0 +1,334 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 7:
+ *  - Serve up a named service with worker threads (see le_msg_SetServiceWorkerThreads()), and
+ *    open a session to it from each of two client threads.
+ *  - Checks that each session is handled by a worker thread of its own, and that all of its
+ *    handlers (open, receive and close) are called in that thread.
+ *  - Each client makes a number of asynchronous requests, which must reach the server, and be
+ *    answered, in order.
+ *  - The first client's next request blocks its worker until the second client's next request has
+ *    been handled, which can only happen if the two sessions are handled in parallel.
+ *  - Each client's last request is answered from the server's main thread, which is passed on to
+ *    the worker handling the session.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+#define SERVICE_INSTANCE_NAME "messagingTest7"
+
+#define PROTOCOL_ID_STR "WorkerProtocol"
+
+/// Number of clients, and of worker threads, so that each client gets a worker of its own.
+#define NUM_CLIENTS 2
+
+/// Number of echo requests made by each client.
+#define NUM_REQUESTS 10
+
+/// How long the blocked worker waits to be unblocked before giving up.
+static const le_clk_Time_t BlockTimeout = { .sec = 5, .usec = 0 };
+
+
+/// Operations requested of the server.
+typedef enum
+{
+    OP_ECHO,            ///< Respond straight away.
+    OP_BLOCK,           ///< Wait for an OP_UNBLOCK (other session) to be handled, then respond.
+    OP_UNBLOCK,         ///< Let an OP_BLOCK continue, then respond.
+    OP_RESPOND_LATER,   ///< Have the main thread respond.
+}
+Operation_t;
+
+
+typedef struct
+{
+    Operation_t op;     ///< Requested operation.
+    uint32_t    index;  ///< Index of the request in its session.
+}
+Message_t;
+
+
+/// Server-side state of a session.
+typedef struct
+{
+    le_thread_Ref_t threadRef;  ///< Thread that the session's open handler was called in.
+    uint32_t        nextIndex;  ///< Index of the next request expected in the session.
+}
+ServerSession_t;
+
+
+/// Client-side state of a session.
+typedef struct
+{
+    int                 clientIndex;    ///< Which client this is.
+    le_thread_Ref_t     threadRef;      ///< Client thread.
+    le_msg_SessionRef_t sessionRef;     ///< Client's session.
+    uint32_t            responseCount;  ///< Number of responses received so far.
+}
+Client_t;
+
+
+static le_thread_Ref_t MainThreadRef;
+static le_msg_ProtocolRef_t ProtocolRef;
+
+static ServerSession_t ServerSessions[NUM_CLIENTS];
+static int ServerOpenCount = 0;     // Number of sessions opened on the server side.
+static int ServerCloseCount = 0;    // Number of sessions closed on the server side.
+static le_mutex_Ref_t ServerMutexRef;
+
+static Client_t Clients[NUM_CLIENTS];
+
+static le_sem_Ref_t BlockedSemRef;      // Posted when the first client's worker is blocked.
+static le_sem_Ref_t UnblockSemRef;      // Posted to unblock it.
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerOpenHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed to le_msg_AddServiceOpenHandler().
+)
+{
+    le_thread_Ref_t threadRef = le_thread_GetCurrent();
+    int i;
+
+    LE_TEST(threadRef != MainThreadRef);
+
+    le_mutex_Lock(ServerMutexRef);
+
+    LE_ASSERT(ServerOpenCount < NUM_CLIENTS);
+
+    // Each session must have been dispatched to a different worker.
+    for (i = 0; i < ServerOpenCount; i++)
+    {
+        LE_TEST(ServerSessions[i].threadRef != threadRef);
+    }
+
+    ServerSessions[ServerOpenCount].threadRef = threadRef;
+    ServerSessions[ServerOpenCount].nextIndex = 0;
+    le_msg_SetSessionContextPtr(sessionRef, &ServerSessions[ServerOpenCount]);
+    ServerOpenCount++;
+
+    le_mutex_Unlock(ServerMutexRef);
+}
+
+
+static void ServerCloseHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that closed.
+    void*               contextPtr  // contextPtr passed to le_msg_AddServiceCloseHandler().
+)
+{
+    ServerSession_t* sessionPtr = le_msg_GetSessionContextPtr(sessionRef);
+
+    LE_TEST(sessionPtr->threadRef == le_thread_GetCurrent());
+    LE_TEST(sessionPtr->nextIndex == NUM_REQUESTS + 2);
+
+    le_mutex_Lock(ServerMutexRef);
+    ServerCloseCount++;
+    bool isDone = (ServerCloseCount == NUM_CLIENTS);
+    le_mutex_Unlock(ServerMutexRef);
+
+    if (isDone)
+    {
+        LE_TEST_SUMMARY
+    }
+}
+
+
+// Responds to a request in the main thread, rather than in the worker that received it.
+static void RespondInMainThread
+(
+    void* param1Ptr,    // Reference to the request message.
+    void* param2Ptr
+)
+{
+    le_msg_MessageRef_t msgRef = param1Ptr;
+
+    LE_TEST(le_thread_GetCurrent() == MainThreadRef);
+
+    le_msg_Respond(msgRef);
+}
+
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    ServerSession_t* sessionPtr = le_msg_GetSessionContextPtr(le_msg_GetSession(msgRef));
+
+    LE_TEST(le_msg_NeedsResponse(msgRef));
+
+    // Requests are received in order, in the thread that the session was opened in.
+    LE_TEST(sessionPtr->threadRef == le_thread_GetCurrent());
+    LE_TEST(msgPtr->index == sessionPtr->nextIndex);
+    sessionPtr->nextIndex++;
+
+    switch (msgPtr->op)
+    {
+        case OP_ECHO:
+            le_msg_Respond(msgRef);
+            break;
+
+        case OP_BLOCK:
+            le_sem_Post(BlockedSemRef);
+            LE_TEST(le_sem_WaitWithTimeOut(UnblockSemRef, BlockTimeout) == LE_OK);
+            le_msg_Respond(msgRef);
+            break;
+
+        case OP_UNBLOCK:
+            le_sem_Post(UnblockSemRef);
+            le_msg_Respond(msgRef);
+            break;
+
+        case OP_RESPOND_LATER:
+            le_event_QueueFunctionToThread(MainThreadRef, RespondInMainThread, msgRef, NULL);
+            break;
+
+        default:
+            LE_FATAL("Unexpected operation %d.", msgPtr->op);
+    }
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(ProtocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AddServiceOpenHandler(serviceRef, ServerOpenHandler, NULL);
+    le_msg_AddServiceCloseHandler(serviceRef, ServerCloseHandler, NULL);
+    le_msg_SetServiceWorkerThreads(serviceRef, NUM_CLIENTS);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+static void SendRequest(Client_t* clientPtr, Operation_t op, uint32_t index);
+
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    Client_t* clientPtr = contextPtr;
+
+    LE_ASSERT(msgRef != NULL);
+    LE_TEST(le_thread_GetCurrent() == clientPtr->threadRef);
+
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_TEST(msgPtr->index == clientPtr->responseCount);
+    le_msg_ReleaseMsg(msgRef);
+
+    clientPtr->responseCount++;
+
+    if (clientPtr->responseCount == NUM_REQUESTS)
+    {
+        // All the echoes are back.  The first client blocks its worker, and the second unblocks
+        // it, once it is blocked.
+        if (clientPtr->clientIndex == 0)
+        {
+            SendRequest(clientPtr, OP_BLOCK, NUM_REQUESTS);
+        }
+        else
+        {
+            le_sem_Wait(BlockedSemRef);
+            SendRequest(clientPtr, OP_UNBLOCK, NUM_REQUESTS);
+        }
+    }
+    else if (clientPtr->responseCount == NUM_REQUESTS + 1)
+    {
+        SendRequest(clientPtr, OP_RESPOND_LATER, NUM_REQUESTS + 1);
+    }
+    else if (clientPtr->responseCount == NUM_REQUESTS + 2)
+    {
+        le_msg_CloseSession(clientPtr->sessionRef);
+    }
+}
+
+
+static void SendRequest
+(
+    Client_t*   clientPtr,
+    Operation_t op,
+    uint32_t    index
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(clientPtr->sessionRef);
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->op = op;
+    msgPtr->index = index;
+
+    le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, clientPtr);
+}
+
+
+static void* ClientThreadMain
+(
+    void* contextPtr
+)
+{
+    Client_t* clientPtr = contextPtr;
+    uint32_t i;
+
+    clientPtr->sessionRef = le_msg_CreateSession(ProtocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_OpenSessionSync(clientPtr->sessionRef);
+
+    for (i = 0; i < NUM_REQUESTS; i++)
+    {
+        SendRequest(clientPtr, OP_ECHO, i);
+    }
+
+    le_event_RunLoop();
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    int i;
+
+    LE_INFO("======= Test 7: Service worker threads ========");
+
+    system("testFwMessaging-Setup");
+
+    MainThreadRef = le_thread_GetCurrent();
+    ProtocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    ServerMutexRef = le_mutex_CreateNonRecursive("ServerMutex");
+    BlockedSemRef = le_sem_Create("Blocked", 0);
+    UnblockSemRef = le_sem_Create("Unblock", 0);
+
+    ServerStart();
+
+    for (i = 0; i < NUM_CLIENTS; i++)
+    {
+        char name[16];
+
+        snprintf(name, sizeof(name), "Client%d", i);
+
+        Clients[i].clientIndex = i;
+        Clients[i].responseCount = 0;
+        Clients[i].threadRef = le_thread_Create(name, ClientThreadMain, &Clients[i]);
+        le_thread_Start(Clients[i].threadRef);
+    }
+}
@@ -0,0 +1,345 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 8:
+ *  - Serve up a service and act as its own client, over an in-process session (see Test 6).
+ *  - Inside a batch, make a number of normal requests followed by a number of high priority ones
+ *    (see le_msg_SetHighPriority()).  When the batch ends, the high priority requests must be sent
+ *    ahead of the normal ones, and each lane must keep its order.
+ *  - Make the same requests without a batch.  The high priority ones must be received ahead of
+ *    the normal ones still waiting to be processed, again keeping the order in each lane.
+ *  - Make a number of normal requests while keeping a high priority request outstanding at all
+ *    times.  The normal requests must all be answered before the stream of high priority
+ *    requests ends (i.e., they must not be starved).
+ *  - Do it all again over a socket session to the same service, through a binding in the Service
+ *    Directory, to check that the priority is sent with the messages.
+ *
+ * Needs a running Service Directory, and the messagingTest8Socket binding.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "messaging.h"
+
+
+#define CLIENT_INTERFACE_NAME "messagingTest8"
+#define SOCKET_CLIENT_INTERFACE_NAME "messagingTest8Socket"
+#define SERVER_INTERFACE_NAME "messagingTest8Local"
+
+#define PROTOCOL_ID_STR "PriorityProtocol"
+
+/// Number of normal requests made in each phase.
+#define NUM_NORMAL 8
+
+/// Number of high priority requests made in each of the first two phases.
+#define NUM_HIGH 4
+
+/// Number of high priority requests made, one after the other, in the last phase.
+#define NUM_STREAM_HIGH 32
+
+
+typedef struct
+{
+    bool        isHigh;     ///< true = sent as a high priority request.
+    uint32_t    index;      ///< Index of the request in its lane.
+}
+Message_t;
+
+
+/// Phases of the test.
+typedef enum
+{
+    PHASE_BATCHED,      ///< Requests made inside a batch.
+    PHASE_UNBATCHED,    ///< Requests made one after the other, without a batch.
+    PHASE_STREAM,       ///< Normal requests made alongside a stream of high priority ones.
+}
+Phase_t;
+
+
+static le_msg_SessionRef_t SessionRef;
+
+/// true once the test runs over the socket session.
+static bool IsOverSocket = false;
+
+static Phase_t Phase = PHASE_BATCHED;
+
+/// Requests in the order the server received them, in the current phase.
+static Message_t Received[NUM_NORMAL + NUM_STREAM_HIGH];
+static size_t ReceivedCount = 0;
+
+/// Responses in the order the client received them, in the current phase.
+static Message_t Responses[NUM_NORMAL + NUM_STREAM_HIGH];
+static size_t ResponseCount = 0;
+
+static size_t NormalResponseCount = 0;  // Normal responses received in the current phase.
+static size_t HighResponseCount = 0;    // High priority responses received in the current phase.
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    LE_TEST(le_msg_NeedsResponse(msgRef));
+    LE_ASSERT(ReceivedCount < NUM_ARRAY_MEMBERS(Received));
+
+    Received[ReceivedCount++] = *msgPtr;
+
+    le_msg_Respond(msgRef);
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(protocolRef, SERVER_INTERFACE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+// Checks that a list of requests holds all the high priority ones, in order, followed by all the
+// normal ones, in order.
+static void CheckOrder
+(
+    const Message_t*    listPtr,
+    size_t              count
+)
+{
+    size_t i;
+
+    LE_TEST(count == NUM_HIGH + NUM_NORMAL);
+
+    for (i = 0; i < count; i++)
+    {
+        if (i < NUM_HIGH)
+        {
+            LE_TEST(listPtr[i].isHigh && (listPtr[i].index == i));
+        }
+        else
+        {
+            LE_TEST(!listPtr[i].isHigh && (listPtr[i].index == i - NUM_HIGH));
+        }
+    }
+}
+
+
+static void ClientResponseRecvHandler(le_msg_MessageRef_t msgRef, void* contextPtr);
+static void SocketClientStart(void);
+
+
+static void SendRequest
+(
+    bool        isHigh,
+    uint32_t    index
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->isHigh = isHigh;
+    msgPtr->index = index;
+
+    if (isHigh)
+    {
+        le_msg_SetHighPriority(msgRef);
+    }
+
+    le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, NULL);
+}
+
+
+// Makes the normal requests and then the high priority ones.
+static void SendRequests
+(
+    size_t numHigh
+)
+{
+    uint32_t i;
+
+    ReceivedCount = 0;
+    ResponseCount = 0;
+    NormalResponseCount = 0;
+    HighResponseCount = 0;
+
+    for (i = 0; i < NUM_NORMAL; i++)
+    {
+        SendRequest(false, i);
+    }
+
+    for (i = 0; i < numHigh; i++)
+    {
+        SendRequest(true, i);
+    }
+}
+
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_ASSERT(msgRef != NULL);
+    LE_ASSERT(ResponseCount < NUM_ARRAY_MEMBERS(Responses));
+
+    Message_t* msgPtr = &Responses[ResponseCount++];
+    *msgPtr = *(Message_t*)le_msg_GetPayloadPtr(msgRef);
+    le_msg_ReleaseMsg(msgRef);
+
+    // Each lane is answered in order.
+    if (msgPtr->isHigh)
+    {
+        LE_TEST(msgPtr->index == HighResponseCount);
+        HighResponseCount++;
+    }
+    else
+    {
+        LE_TEST(msgPtr->index == NormalResponseCount);
+        NormalResponseCount++;
+    }
+
+    switch (Phase)
+    {
+        case PHASE_BATCHED:
+            if (ResponseCount == NUM_NORMAL + NUM_HIGH)
+            {
+                CheckOrder(Received, ReceivedCount);
+                CheckOrder(Responses, ResponseCount);
+
+                Phase = PHASE_UNBATCHED;
+                SendRequests(NUM_HIGH);
+            }
+            break;
+
+        case PHASE_UNBATCHED:
+            if (ResponseCount == NUM_NORMAL + NUM_HIGH)
+            {
+                CheckOrder(Received, ReceivedCount);
+                CheckOrder(Responses, ResponseCount);
+
+                // Start off the stream with a single high priority request.
+                Phase = PHASE_STREAM;
+                SendRequests(1);
+            }
+            break;
+
+        case PHASE_STREAM:
+            if (!msgPtr->isHigh)
+            {
+                // No normal request can be left behind by the stream.
+                LE_TEST(HighResponseCount < NUM_STREAM_HIGH);
+            }
+            else if (HighResponseCount < NUM_STREAM_HIGH)
+            {
+                // Keep a high priority request outstanding.
+                SendRequest(true, HighResponseCount);
+            }
+            else
+            {
+                LE_TEST(NormalResponseCount == NUM_NORMAL);
+                LE_TEST(ReceivedCount == NUM_NORMAL + NUM_STREAM_HIGH);
+
+                if (IsOverSocket)
+                {
+                    LE_TEST_SUMMARY
+                }
+                else
+                {
+                    SocketClientStart();
+                }
+            }
+            break;
+    }
+}
+
+
+// Runs the phases of the test on the open session.
+static void StartPhases
+(
+    void
+)
+{
+    Phase = PHASE_BATCHED;
+
+    // Nothing is sent until the batch ends, and then the high priority requests go first.
+    le_msg_StartBatch(SessionRef);
+    SendRequests(NUM_HIGH);
+    le_msg_EndBatch(SessionRef);
+}
+
+
+static void SocketSessionOpenHandler
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed into le_msg_OpenSession().
+)
+{
+    LE_INFO("Session opened over a socket; running the test again.");
+
+    StartPhases();
+}
+
+
+static void SocketClientStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+
+    le_msg_CloseSession(SessionRef);
+    le_msg_DeleteSession(SessionRef);
+
+    // This interface is bound to the service in the Service Directory, not in-process.  It can't
+    // be opened synchronously, since the server runs in this thread.
+    IsOverSocket = true;
+    SessionRef = le_msg_CreateSession(protocolRef, SOCKET_CLIENT_INTERFACE_NAME);
+    le_msg_OpenSession(SessionRef, SocketSessionOpenHandler, NULL);
+}
+
+
+static void ClientStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    SessionRef = le_msg_CreateSession(protocolRef, CLIENT_INTERFACE_NAME);
+
+    // There is no binding for the client interface in the Service Directory, so this can only
+    // succeed if the session is opened in-process.
+    LE_TEST(le_msg_TryOpenSessionSync(SessionRef) == LE_OK);
+
+    StartPhases();
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    LE_INFO("======= Test 8: High priority messages ========");
+
+    msg_AddLocalBinding(CLIENT_INTERFACE_NAME, SERVER_INTERFACE_NAME);
+
+    ServerStart();
+
+    ClientStart();
+}
@@ -0,0 +1,496 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automated unit test for the Low-Level Messaging APIs.
+ *
+ * Test 9: Batched socket sends and receives (sendmmsg() and recvmmsg()).
+ *  - On a pair of connected sockets, checks that unixSocket_SendMsgs() and
+ *    unixSocket_ReceiveMsgs() handle:
+ *     - batches that are only partly filled, or that don't hold everything waiting;
+ *     - the socket filling up part of the way through a batch (EAGAIN), with nothing lost or
+ *       repeated when the rest is sent later;
+ *     - file descriptors sent on some of the messages of a batch;
+ *     - messages too big for their receive buffer, and the connection closing.
+ *  - Serves up a named service and acts as its own client (see Test 5), sending batched requests
+ *    that are too big, all together, for the socket's buffer, some of them carrying a file
+ *    descriptor.  Checks that they all reach the server, in order, with their file descriptors.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "unixSocket.h"
+#include "fileDescriptor.h"
+
+
+#define SERVICE_INSTANCE_NAME "messagingTest9"
+
+#define PROTOCOL_ID_STR "SocketBatchProtocol"
+
+/// Size of the data sent in each message on the socket pair.
+#define DATA_SIZE 1024
+
+/// Number of requests made to the service, inside one batch.
+#define NUM_REQUESTS 100
+
+/// Every this many requests carries a file descriptor.
+#define FD_INTERVAL 3
+
+
+typedef struct
+{
+    uint32_t    index;              ///< Index of the request in the batch.
+    uint8_t     filler[16 * 1024];  ///< Makes the batch too big for the socket's buffer.
+}
+Message_t;
+
+
+/// The file that the requests' file descriptors are opened on.
+static struct stat FdStat;
+
+static int ServerRequestCount = 0;  // Number of requests received by the server.
+static int ClientResponseCount = 0; // Number of responses received by the client.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a number of data messages, starting at a given index, with a file descriptor (a duplicate
+ * of fd) on those whose index is a multiple of FD_INTERVAL if fd is not -1.
+ *
+ * @return the result of unixSocket_SendMsgs().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendIndexed
+(
+    int         socketFd,
+    uint32_t    firstIndex,
+    size_t      numMsgs,
+    int         fd,
+    size_t*     numSentPtr
+)
+{
+    static uint32_t data[UNIX_SOCKET_MAX_BATCH_MSGS][DATA_SIZE / sizeof(uint32_t)];
+    unixSocket_Msg_t msgs[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        uint32_t index = firstIndex + i;
+
+        data[i][0] = index;
+        msgs[i].dataPtr = data[i];
+        msgs[i].dataSize = sizeof(data[i]);
+        msgs[i].fd = ((fd >= 0) && ((index % FD_INTERVAL) == 0)) ? fd : -1;
+    }
+
+    return unixSocket_SendMsgs(socketFd, msgs, numMsgs, numSentPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives up to numMsgs messages, and checks they are the next ones expected.
+ *
+ * @return the result of unixSocket_ReceiveMsgs().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReceiveIndexed
+(
+    int         socketFd,
+    uint32_t*   nextIndexPtr,   ///< [IN+OUT] Index of the next message expected.
+    size_t      numMsgs,
+    bool        expectFds,      ///< Messages whose index is a multiple of FD_INTERVAL have an fd.
+    size_t*     numReceivedPtr
+)
+{
+    static uint32_t data[UNIX_SOCKET_MAX_BATCH_MSGS][DATA_SIZE / sizeof(uint32_t)];
+    unixSocket_Msg_t msgs[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        msgs[i].dataPtr = data[i];
+        msgs[i].dataSize = sizeof(data[i]);
+    }
+
+    le_result_t result = unixSocket_ReceiveMsgs(socketFd, msgs, numMsgs, numReceivedPtr);
+
+    for (i = 0; (result == LE_OK) && (i < *numReceivedPtr); i++)
+    {
+        LE_TEST(msgs[i].dataSize == DATA_SIZE);
+        LE_TEST(!msgs[i].isTruncated);
+        LE_TEST(data[i][0] == *nextIndexPtr);
+
+        if (expectFds && ((*nextIndexPtr % FD_INTERVAL) == 0))
+        {
+            struct stat fdStat;
+
+            LE_TEST(msgs[i].fd >= 0);
+            LE_TEST((fstat(msgs[i].fd, &fdStat) == 0) && (fdStat.st_ino == FdStat.st_ino));
+        }
+        else
+        {
+            LE_TEST(msgs[i].fd == -1);
+        }
+
+        if (msgs[i].fd >= 0)
+        {
+            fd_Close(msgs[i].fd);
+        }
+
+        (*nextIndexPtr)++;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batches that are only partly filled, or that don't hold everything waiting to be received.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestPartialBatches
+(
+    int sendFd,
+    int recvFd
+)
+{
+    uint32_t nextIndex = 0;
+    size_t numSent;
+    size_t numReceived;
+
+    LE_INFO("Partial batches");
+
+    // Nothing waiting.
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, 4, false, &numReceived) == LE_WOULD_BLOCK);
+    LE_TEST(numReceived == 0);
+
+    // Fewer waiting than there are buffers.
+    LE_TEST(SendIndexed(sendFd, 0, 3, -1, &numSent) == LE_OK);
+    LE_TEST(numSent == 3);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, UNIX_SOCKET_MAX_BATCH_MSGS, false, &numReceived)
+            == LE_OK);
+    LE_TEST(numReceived == 3);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, 4, false, &numReceived) == LE_WOULD_BLOCK);
+
+    // More waiting than there are buffers: the rest are left for the next call.
+    LE_TEST(SendIndexed(sendFd, 3, UNIX_SOCKET_MAX_BATCH_MSGS, -1, &numSent) == LE_OK);
+    LE_TEST(numSent == UNIX_SOCKET_MAX_BATCH_MSGS);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, 5, false, &numReceived) == LE_OK);
+    LE_TEST(numReceived == 5);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, 1, false, &numReceived) == LE_OK);
+    LE_TEST(numReceived == 1);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, UNIX_SOCKET_MAX_BATCH_MSGS, false, &numReceived)
+            == LE_OK);
+    LE_TEST(numReceived == UNIX_SOCKET_MAX_BATCH_MSGS - 6);
+    LE_TEST(nextIndex == 3 + UNIX_SOCKET_MAX_BATCH_MSGS);
+    LE_TEST(ReceiveIndexed(recvFd, &nextIndex, 4, false, &numReceived) == LE_WOULD_BLOCK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The socket fills up part of the way through a batch.  What was sent must be received, in order,
+ * and the rest must be sent once there is room again, with nothing lost or repeated.  File
+ * descriptors go with the right messages throughout.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFullSocket
+(
+    int sendFd,
+    int recvFd,
+    int fd          ///< File descriptor to send with some of the messages.
+)
+{
+    uint32_t nextSendIndex = 0;
+    uint32_t nextRecvIndex = 0;
+    size_t numSent;
+    size_t numReceived;
+    le_result_t result;
+    bool isPartial = false;
+
+    LE_INFO("Socket filling up part of the way through a batch");
+
+    // Keep sending full batches until the socket is full.
+    do
+    {
+        result = SendIndexed(sendFd, nextSendIndex, UNIX_SOCKET_MAX_BATCH_MSGS, fd, &numSent);
+
+        LE_TEST((result == LE_OK) || (result == LE_NO_MEMORY));
+        LE_TEST((result == LE_OK) ? (numSent > 0) : (numSent == 0));
+
+        if ((result == LE_OK) && (numSent < UNIX_SOCKET_MAX_BATCH_MSGS))
+        {
+            isPartial = true;
+        }
+
+        nextSendIndex += numSent;
+    }
+    while (result == LE_OK);
+
+    LE_INFO("Socket full after %u messages", nextSendIndex);
+
+    // The socket's buffer holds a whole number of batches only by chance, which the small buffer
+    // size makes unlikely.
+    LE_TEST(isPartial);
+    LE_TEST(nextSendIndex > 0);
+
+    // Make some room, and send the rest of the last batch.
+    do
+    {
+        LE_TEST(ReceiveIndexed(recvFd, &nextRecvIndex, 4, true, &numReceived) == LE_OK);
+    }
+    while (nextRecvIndex < UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    LE_TEST(SendIndexed(sendFd, nextSendIndex, 4, fd, &numSent) == LE_OK);
+    LE_TEST(numSent > 0);
+    nextSendIndex += numSent;
+
+    // Everything sent must come out, once each, in order.
+    while ((result = ReceiveIndexed(recvFd,
+                                    &nextRecvIndex,
+                                    UNIX_SOCKET_MAX_BATCH_MSGS,
+                                    true,
+                                    &numReceived)) == LE_OK)
+    {
+    }
+
+    LE_TEST(result == LE_WOULD_BLOCK);
+    LE_TEST(nextRecvIndex == nextSendIndex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Messages too big for their receive buffers, and the connection closing.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTruncationAndClose
+(
+    int sendFd,
+    int recvFd
+)
+{
+    size_t numSent;
+    size_t numReceived;
+    uint32_t smallBuffers[2][2];
+    unixSocket_Msg_t msgs[2];
+    size_t i;
+
+    LE_INFO("Truncation and close");
+
+    LE_TEST(SendIndexed(sendFd, 0, 2, -1, &numSent) == LE_OK);
+    LE_TEST(numSent == 2);
+
+    for (i = 0; i < 2; i++)
+    {
+        msgs[i].dataPtr = smallBuffers[i];
+        msgs[i].dataSize = sizeof(smallBuffers[i]);
+    }
+
+    LE_TEST(unixSocket_ReceiveMsgs(recvFd, msgs, 2, &numReceived) == LE_OK);
+    LE_TEST(numReceived == 2);
+
+    for (i = 0; i < numReceived; i++)
+    {
+        LE_TEST(msgs[i].isTruncated);
+        LE_TEST(smallBuffers[i][0] == i);
+    }
+
+    fd_Close(sendFd);
+
+    for (i = 0; i < 2; i++)
+    {
+        msgs[i].dataPtr = smallBuffers[i];
+        msgs[i].dataSize = sizeof(smallBuffers[i]);
+    }
+
+    LE_TEST(unixSocket_ReceiveMsgs(recvFd, msgs, 2, &numReceived) == LE_CLOSED);
+    LE_TEST(numReceived == 0);
+
+    fd_Close(recvFd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests the socket batch functions on a pair of connected sockets.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSocketPair
+(
+    void
+)
+{
+    int sendFd;
+    int recvFd;
+    int fd;
+    int sendBufSize = 32 * 1024;
+
+    LE_ASSERT(unixSocket_CreateSeqPacketPair(&sendFd, &recvFd) == LE_OK);
+    fd_SetNonBlocking(sendFd);
+
+    // A small send buffer, so that it fills up part of the way through a batch.
+    LE_ASSERT(setsockopt(sendFd, SOL_SOCKET, SO_SNDBUF, &sendBufSize, sizeof(sendBufSize)) == 0);
+
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT(fd >= 0);
+
+    TestPartialBatches(sendFd, recvFd);
+    TestFullSocket(sendFd, recvFd, fd);
+    TestTruncationAndClose(sendFd, recvFd);
+
+    fd_Close(fd);
+}
+
+
+// ==================================
+//  SERVER
+// ==================================
+
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to the received message.
+    void*               contextPtr  // contextPtr passed to le_msg_SetServiceRecvHandler().
+)
+{
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    int fd = le_msg_GetFd(msgRef);
+
+    LE_TEST(le_msg_NeedsResponse(msgRef));
+    LE_TEST(msgPtr->index == ServerRequestCount);
+
+    if ((msgPtr->index % FD_INTERVAL) == 0)
+    {
+        struct stat fdStat;
+
+        LE_TEST(fd >= 0);
+        LE_TEST((fstat(fd, &fdStat) == 0) && (fdStat.st_ino == FdStat.st_ino));
+    }
+    else
+    {
+        LE_TEST(fd == -1);
+    }
+
+    if (fd >= 0)
+    {
+        fd_Close(fd);
+    }
+
+    ServerRequestCount++;
+
+    le_msg_Respond(msgRef);
+}
+
+
+static void ServerStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_ServiceRef_t serviceRef = le_msg_CreateService(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
+
+
+// ==================================
+//  CLIENT
+// ==================================
+
+static void ClientResponseRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     // Reference to response message (NULL if transaction failed).
+    void*               contextPtr  // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_ASSERT(msgRef != NULL);
+
+    Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    LE_TEST(msgPtr->index == (uint32_t)(size_t)contextPtr);
+    LE_TEST(msgPtr->index == ClientResponseCount);
+
+    le_msg_ReleaseMsg(msgRef);
+
+    ClientResponseCount++;
+
+    if (ClientResponseCount == NUM_REQUESTS)
+    {
+        LE_TEST(ServerRequestCount == NUM_REQUESTS);
+
+        LE_TEST_SUMMARY
+    }
+}
+
+
+static void SessionOpenHandlerFunc
+(
+    le_msg_SessionRef_t sessionRef, // Reference to the session that opened.
+    void*               contextPtr  // contextPtr passed into le_msg_OpenSession().
+)
+{
+    int fd;
+    size_t i;
+
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT(fd >= 0);
+
+    // Nothing is sent until the batch ends, and then there is too much for the socket to take all
+    // at once, so it has to be sent as the server makes room.
+    le_msg_StartBatch(sessionRef);
+
+    for (i = 0; i < NUM_REQUESTS; i++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+        Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+        msgPtr->index = i;
+
+        if ((i % FD_INTERVAL) == 0)
+        {
+            // The message takes ownership of the fd.
+            le_msg_SetFd(msgRef, dup(fd));
+        }
+
+        le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, (void*)i);
+    }
+
+    le_msg_EndBatch(sessionRef);
+
+    fd_Close(fd);
+}
+
+
+static void ClientStart
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Message_t));
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_OpenSession(sessionRef, SessionOpenHandlerFunc, NULL);
+}
+
+
+// Component initialization function.
+COMPONENT_INIT
+{
+    LE_INFO("======= Test 9: Batched socket sends and receives ========");
+
+    LE_ASSERT(stat("/dev/null", &FdStat) == 0);
+
+    TestSocketPair();
+
+    system("testFwMessaging-Setup");
+
+    ServerStart();
+
+    ClientStart();
+}
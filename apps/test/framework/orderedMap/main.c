@@ -0,0 +1,185 @@
+/**
+ * Test for the ordered map API.
+ *
+ * Adds nodes of random keys (with duplicates) to a map, removes some of them, then checks that
+ * the map can be searched and walked in order in both directions.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+/// Number of nodes.
+#define NUM_NODES           1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the map.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int key;
+    le_omap_Link_t link;
+}
+Node_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The nodes.
+ */
+//--------------------------------------------------------------------------------------------------
+static Node_t Nodes[NUM_NODES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares a key to the key of a link's node.
+ */
+//--------------------------------------------------------------------------------------------------
+static int NodeCompare
+(
+    const void* keyPtr,
+    const le_omap_Link_t* linkPtr
+)
+{
+    int key = *(const int*)keyPtr;
+    int nodeKey = CONTAINER_OF(linkPtr, Node_t, link)->key;
+
+    return (key > nodeKey) - (key < nodeKey);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Walks a map in both directions, checking the order of its links.
+ *
+ * @return
+ *      The number of links, or -1 if they were out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Walk
+(
+    const le_omap_Map_t* mapPtr
+)
+{
+    const le_omap_Link_t* linkPtr;
+    int lastKey = INT_MIN;
+    int count = 0;
+
+    for (linkPtr = le_omap_Peek(mapPtr);
+         linkPtr != NULL;
+         linkPtr = le_omap_PeekNext(mapPtr, linkPtr))
+    {
+        int key = CONTAINER_OF(linkPtr, Node_t, link)->key;
+
+        if (key < lastKey)
+        {
+            LE_ERROR("Key %d after %d.", key, lastKey);
+            return -1;
+        }
+        lastKey = key;
+        count++;
+    }
+
+    for (linkPtr = le_omap_PeekTail(mapPtr);
+         linkPtr != NULL;
+         linkPtr = le_omap_PeekPrev(mapPtr, linkPtr))
+    {
+        int key = CONTAINER_OF(linkPtr, Node_t, link)->key;
+
+        if (key > lastKey)
+        {
+            LE_ERROR("Key %d before %d.", key, lastKey);
+            return -1;
+        }
+        lastKey = key;
+        count--;
+    }
+
+    return (count == 0) ? (int)le_omap_NumLinks(mapPtr) : -1;
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======== BEGIN ORDERED MAP TEST ========");
+
+    le_omap_Map_t map = LE_OMAP_INIT(NodeCompare);
+    int i;
+
+    LE_TEST(le_omap_IsEmpty(&map));
+    LE_TEST(le_omap_Peek(&map) == NULL);
+    LE_TEST(le_omap_Pop(&map) == NULL);
+
+    srand(1);
+    for (i = 0; i < NUM_NODES; i++)
+    {
+        // Even keys only, so that odd keys can be looked up and not found.
+        Nodes[i].key = 2 * (rand() % (NUM_NODES / 4));
+        Nodes[i].link = LE_OMAP_LINK_INIT;
+        le_omap_Insert(&map, &Nodes[i].link, &Nodes[i].key);
+    }
+
+    LE_TEST(le_omap_NumLinks(&map) == NUM_NODES);
+    LE_TEST(le_omap_GetChangeCount(&map) == NUM_NODES);
+    LE_TEST(Walk(&map) == NUM_NODES);
+
+    // Links of equal keys are kept in the order they were added.
+    int key = Nodes[0].key;
+    le_omap_Link_t* linkPtr = le_omap_Find(&map, &key);
+    LE_TEST(linkPtr == &Nodes[0].link);
+    LE_TEST((le_omap_PeekPrev(&map, linkPtr) == NULL) ||
+            (CONTAINER_OF(le_omap_PeekPrev(&map, linkPtr), Node_t, link)->key < key));
+
+    key = 1;
+    LE_TEST(le_omap_Find(&map, &key) == NULL);
+    linkPtr = le_omap_FindGreaterOrEqual(&map, &key);
+    LE_TEST((linkPtr != NULL) && (CONTAINER_OF(linkPtr, Node_t, link)->key >= 2));
+
+    key = NUM_NODES;
+    LE_TEST(le_omap_FindGreaterOrEqual(&map, &key) == NULL);
+
+    // Remove every third node.
+    for (i = 0; i < NUM_NODES; i += 3)
+    {
+        le_omap_Remove(&map, &Nodes[i].link);
+    }
+    LE_TEST(!le_omap_IsInMap(&map, &Nodes[0].link));
+    LE_TEST(le_omap_IsInMap(&map, &Nodes[1].link));
+    LE_TEST(Walk(&map) == NUM_NODES - (NUM_NODES + 2) / 3);
+
+    // Each remaining node can be found from its key.
+    bool allFound = true;
+    for (i = 1; i < NUM_NODES; i++)
+    {
+        if (i % 3 != 0)
+        {
+            linkPtr = le_omap_Find(&map, &Nodes[i].key);
+            allFound = allFound && (linkPtr != NULL) &&
+                       (CONTAINER_OF(linkPtr, Node_t, link)->key == Nodes[i].key);
+        }
+    }
+    LE_TEST(allFound);
+
+    // Popping empties the map from its lowest key.
+    int lastKey = INT_MIN;
+    bool inOrder = true;
+    while ((linkPtr = le_omap_Pop(&map)) != NULL)
+    {
+        inOrder = inOrder && (CONTAINER_OF(linkPtr, Node_t, link)->key >= lastKey);
+        lastKey = CONTAINER_OF(linkPtr, Node_t, link)->key;
+    }
+    LE_TEST(inOrder);
+    LE_TEST(le_omap_IsEmpty(&map));
+    LE_TEST(le_omap_NumLinks(&map) == 0);
+
+    LE_INFO("======== ORDERED MAP TEST COMPLETE ========");
+
+    LE_TEST_EXIT;
+}
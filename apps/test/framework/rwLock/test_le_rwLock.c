@@ -0,0 +1,294 @@
+/**
+ * Unit tests of the reader-writer lock and spin lock APIs.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include "CUnit/Console.h"
+#include "CUnit/Basic.h"
+
+#define NB_READERS      8
+#define NB_WRITERS      3
+#define NB_SPINNERS     4
+#define NB_LOOPS        10000
+
+static le_rwlock_Ref_t GLockRef;
+static le_sem_Ref_t GSemRef;
+
+// Data protected by GLockRef: the writers always keep both values equal.
+static volatile long GValueA;
+static volatile long GValueB;
+static volatile bool GTornRead;
+
+// Data protected by GSpinLock.
+static le_spinlock_t GSpinLock = LE_SPINLOCK_INIT;
+static long GSpinCount;
+
+/* The suite initialization function.
+ * Returns zero on success, non-zero otherwise.
+ */
+int init_suite(void)
+{
+    return 0;
+}
+
+/* The suite cleanup function.
+ * Returns zero on success, non-zero otherwise.
+ */
+int clean_suite(void)
+{
+    return 0;
+}
+
+void testCreateDestroy(void)
+{
+    le_rwlock_Ref_t lockRef = le_rwlock_Create("RWLOCK-1");
+    CU_ASSERT_PTR_NOT_EQUAL(lockRef, NULL);
+
+    le_rwlock_Delete(lockRef);
+    CU_PASS("Destruct rwlock\n");
+}
+
+void testReaders(void)
+{
+    le_rwlock_Ref_t lockRef = le_rwlock_Create("RWLOCK-1");
+
+    // Any number of readers at the same time, but no writer.
+    le_rwlock_ReadLock(lockRef);
+    CU_ASSERT_EQUAL(le_rwlock_TryReadLock(lockRef), LE_OK);
+    CU_ASSERT_EQUAL(le_rwlock_TryWriteLock(lockRef), LE_WOULD_BLOCK);
+    le_rwlock_ReadUnlock(lockRef);
+    CU_ASSERT_EQUAL(le_rwlock_TryWriteLock(lockRef), LE_WOULD_BLOCK);
+    le_rwlock_ReadUnlock(lockRef);
+
+    CU_ASSERT_EQUAL(le_rwlock_TryWriteLock(lockRef), LE_OK);
+    le_rwlock_WriteUnlock(lockRef);
+
+    le_rwlock_Delete(lockRef);
+}
+
+void testWriter(void)
+{
+    le_rwlock_Ref_t lockRef = le_rwlock_Create("RWLOCK-1");
+
+    // A single writer, and no reader.
+    le_rwlock_WriteLock(lockRef);
+    CU_ASSERT_EQUAL(le_rwlock_TryReadLock(lockRef), LE_WOULD_BLOCK);
+    CU_ASSERT_EQUAL(le_rwlock_TryWriteLock(lockRef), LE_WOULD_BLOCK);
+    le_rwlock_WriteUnlock(lockRef);
+
+    CU_ASSERT_EQUAL(le_rwlock_TryReadLock(lockRef), LE_OK);
+    le_rwlock_ReadUnlock(lockRef);
+
+    le_rwlock_Delete(lockRef);
+}
+
+static void* WaitingWriter(void* contextPtr)
+{
+    le_sem_Post(GSemRef);
+    le_rwlock_WriteLock(GLockRef);
+    GValueA = 1;
+    le_rwlock_WriteUnlock(GLockRef);
+
+    return NULL;
+}
+
+void testWriterPreference(void)
+{
+    GLockRef = le_rwlock_Create("RWLOCK-PREF");
+    GSemRef = le_sem_Create("SEM-PREF", 0);
+    GValueA = 0;
+
+    le_rwlock_ReadLock(GLockRef);
+
+    le_thread_Ref_t threadRef = le_thread_Create("Writer", WaitingWriter, NULL);
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    // Once the writer waits, new readers must wait too.
+    le_sem_Wait(GSemRef);
+    int i;
+    for (i = 0; (i < 1000) && (le_rwlock_TryReadLock(GLockRef) == LE_OK); i++)
+    {
+        le_rwlock_ReadUnlock(GLockRef);
+        usleep(1000);
+    }
+    CU_ASSERT_EQUAL(le_rwlock_TryReadLock(GLockRef), LE_WOULD_BLOCK);
+    CU_ASSERT_EQUAL(GValueA, 0);
+
+    // The writer gets the lock as soon as the last reader is gone.
+    le_rwlock_ReadUnlock(GLockRef);
+    le_thread_Join(threadRef, NULL);
+    CU_ASSERT_EQUAL(GValueA, 1);
+
+    CU_ASSERT_EQUAL(le_rwlock_TryReadLock(GLockRef), LE_OK);
+    le_rwlock_ReadUnlock(GLockRef);
+
+    le_sem_Delete(GSemRef);
+    le_rwlock_Delete(GLockRef);
+}
+
+static void* Reader(void* contextPtr)
+{
+    int i;
+    for (i = 0; i < NB_LOOPS; i++)
+    {
+        le_rwlock_ReadLock(GLockRef);
+        if (GValueA != GValueB)
+        {
+            GTornRead = true;
+        }
+        le_rwlock_ReadUnlock(GLockRef);
+    }
+
+    return NULL;
+}
+
+static void* Writer(void* contextPtr)
+{
+    int i;
+    for (i = 0; i < NB_LOOPS; i++)
+    {
+        le_rwlock_WriteLock(GLockRef);
+        GValueA++;
+        sched_yield();
+        GValueB++;
+        le_rwlock_WriteUnlock(GLockRef);
+    }
+
+    return NULL;
+}
+
+static void* Spinner(void* contextPtr)
+{
+    int i;
+    for (i = 0; i < NB_LOOPS; i++)
+    {
+        le_spinlock_Lock(&GSpinLock);
+        GSpinCount++;
+        le_spinlock_Unlock(&GSpinLock);
+    }
+
+    return NULL;
+}
+
+static void RunThreads(const char* namePrefix, int count, le_thread_MainFunc_t mainFunc,
+                       le_thread_Ref_t* threadRefs)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        char threadName[20];
+        snprintf(threadName, sizeof(threadName), "%s_%d", namePrefix, i);
+        threadRefs[i] = le_thread_Create(threadName, mainFunc, NULL);
+        le_thread_SetJoinable(threadRefs[i]);
+        le_thread_Start(threadRefs[i]);
+    }
+}
+
+void testScenarioReadersWriters(void)
+{
+    le_thread_Ref_t threadRefs[NB_READERS + NB_WRITERS];
+    int i;
+
+    GLockRef = le_rwlock_Create("RWLOCK-SCENARIO");
+    GValueA = 0;
+    GValueB = 0;
+    GTornRead = false;
+
+    RunThreads("Reader", NB_READERS, Reader, threadRefs);
+    RunThreads("Writer", NB_WRITERS, Writer, threadRefs + NB_READERS);
+
+    for (i = 0; i < NB_READERS + NB_WRITERS; i++)
+    {
+        le_thread_Join(threadRefs[i], NULL);
+    }
+
+    CU_ASSERT_FALSE(GTornRead);
+    CU_ASSERT_EQUAL(GValueA, NB_WRITERS * NB_LOOPS);
+    CU_ASSERT_EQUAL(GValueB, NB_WRITERS * NB_LOOPS);
+
+    le_rwlock_Delete(GLockRef);
+}
+
+void testSpinLock(void)
+{
+    le_spinlock_t lock;
+
+    le_spinlock_Init(&lock);
+    CU_ASSERT_EQUAL(le_spinlock_TryLock(&lock), LE_OK);
+    CU_ASSERT_EQUAL(le_spinlock_TryLock(&lock), LE_WOULD_BLOCK);
+    le_spinlock_Unlock(&lock);
+
+    le_spinlock_Lock(&lock);
+    CU_ASSERT_EQUAL(le_spinlock_TryLock(&lock), LE_WOULD_BLOCK);
+    le_spinlock_Unlock(&lock);
+}
+
+void testScenarioSpinners(void)
+{
+    le_thread_Ref_t threadRefs[NB_SPINNERS];
+    int i;
+
+    GSpinCount = 0;
+
+    RunThreads("Spinner", NB_SPINNERS, Spinner, threadRefs);
+
+    for (i = 0; i < NB_SPINNERS; i++)
+    {
+        le_thread_Join(threadRefs[i], NULL);
+    }
+
+    CU_ASSERT_EQUAL(GSpinCount, NB_SPINNERS * NB_LOOPS);
+}
+
+COMPONENT_INIT
+{
+    CU_TestInfo test_array1[] = {
+    { "create-destroy"          , testCreateDestroy },
+    { "readers"                 , testReaders },
+    { "writer"                  , testWriter },
+    { "writer preference"       , testWriterPreference },
+    { "spin lock"               , testSpinLock },
+    CU_TEST_INFO_NULL,
+    };
+
+    CU_TestInfo test_array2[] = {
+    { "scenario 1: readers and writers" , testScenarioReadersWriters },
+    { "scenario 2: spinners"            , testScenarioSpinners },
+    CU_TEST_INFO_NULL,
+    };
+
+    CU_SuiteInfo suites[] = {
+    { "Suite test always ok"                , init_suite, clean_suite, test_array1 },
+    { "Suite test with scenario"            , init_suite, clean_suite, test_array2 },
+    CU_SUITE_INFO_NULL,
+    };
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        exit(CU_get_error());
+
+    if ( CUE_SUCCESS != CU_register_suites(suites))
+    {
+        CU_cleanup_registry();
+        exit(CU_get_error());
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+
+    // Output summary of failures, if there were any
+    if ( CU_get_number_of_failures() > 0 )
+    {
+        fprintf(stdout,"\n [START]List of Failure :\n");
+        CU_basic_show_failures(CU_get_failure_list());
+        fprintf(stdout,"\n [STOP]List of Failure\n");
+    }
+
+    CU_cleanup_registry();
+    exit(CU_get_error());
+}
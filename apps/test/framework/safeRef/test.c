@@ -64,6 +64,59 @@ COMPONENT_INIT
     LE_ASSERT(le_ref_Lookup(mapRef1, &mapRef1) == NULL);
     LE_INFO("Looking up a pointer value failed, as expected");
 
+    LE_INFO("Testing indexed reference map.");
+
+    le_ref_MapRef_t mapRef2 = le_ref_CreateIndexedMap("Map 2", 2);
+
+    // Grow past the expected number of references.
+    void* safeRefs[10];
+    int i;
+    for (i = 0; i < 10; i++)
+    {
+        safeRefs[i] = le_ref_CreateRef(mapRef2, (void*)(0x2000 + i));
+        LE_ASSERT(safeRefs[i] != NULL);
+    }
+    for (i = 0; i < 10; i++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRefs[i]) == (void*)(0x2000 + i));
+    }
+
+    // Stale references must stay invalid, even once their slot is reused.
+    le_ref_DeleteRef(mapRef2, safeRefs[3]);
+    LE_ASSERT(le_ref_Lookup(mapRef2, safeRefs[3]) == NULL);
+    for (i = 0; i < 100; i++)
+    {
+        void* safeRef = le_ref_CreateRef(mapRef2, (void*)0x3000);
+        LE_ASSERT(safeRef != safeRefs[3]);
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRefs[3]) == NULL);
+        le_ref_DeleteRef(mapRef2, safeRef);
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRef) == NULL);
+    }
+    LE_INFO("Deleting stale reference (expect ERROR)");
+    le_ref_DeleteRef(mapRef2, safeRefs[3]);
+    LE_ASSERT(le_ref_Lookup(mapRef2, safeRefs[4]) == (void*)0x2004);
+
+    LE_ASSERT(le_ref_Lookup(mapRef2, NULL) == NULL);
+    LE_ASSERT(le_ref_Lookup(mapRef2, &mapRef2) == NULL);
+    LE_ASSERT(le_ref_Lookup(mapRef2, safeRef1) == NULL);
+
+    // Iterate, deleting on the way.
+    int count = 0;
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(mapRef2);
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        void* safeRef = (void*)le_ref_GetSafeRef(iterRef);
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRef) == le_ref_GetValue(iterRef));
+        le_ref_DeleteRef(mapRef2, safeRef);
+        count++;
+    }
+    LE_ASSERT(count == 9);
+    for (i = 0; i < 10; i++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRefs[i]) == NULL);
+    }
+    LE_INFO("  Successfully iterated over indexed map.");
+
 
     LE_INFO("======== SAFE REFERENCES TEST COMPLETE (PASSED) ========");
     exit(EXIT_SUCCESS);
@@ -100,6 +100,38 @@ void testPostOK(void)
     CU_PASS("Destruct semaphore\n");
 }
 
+void testPostMany(void)
+{
+    le_sem_Ref_t semPtr=NULL;
+
+    semPtr     = le_sem_Create( "SEMAPHORE-1", 0);
+    CU_ASSERT_PTR_NOT_EQUAL(semPtr, NULL);
+
+    le_sem_PostMany(semPtr, 5);
+    CU_ASSERT_EQUAL(le_sem_GetValue(semPtr),5);
+    le_sem_PostMany(semPtr, 1);
+    CU_ASSERT_EQUAL(le_sem_GetValue(semPtr),6);
+
+    le_sem_Delete(semPtr);
+    CU_PASS("Destruct semaphore\n");
+}
+
+void testTimedWait(void)
+{
+    le_sem_Ref_t semPtr=NULL;
+    le_clk_Time_t timeToWait = { .sec = 0, .usec = 10000 };
+
+    semPtr     = le_sem_Create( "SEMAPHORE-1", 1);
+    CU_ASSERT_PTR_NOT_EQUAL(semPtr, NULL);
+
+    CU_ASSERT_EQUAL(le_sem_WaitWithTimeOut(semPtr, timeToWait), LE_OK);
+    CU_ASSERT_EQUAL(le_sem_WaitWithTimeOut(semPtr, timeToWait), LE_TIMEOUT);
+    CU_ASSERT_EQUAL(le_sem_GetValue(semPtr),0);
+
+    le_sem_Delete(semPtr);
+    CU_PASS("Destruct semaphore\n");
+}
+
 void testGetValue(void)
 {
     le_sem_Ref_t semPtr=NULL;
@@ -294,11 +326,60 @@ void launch_thread()
 //             le_thread_Join(thread[i], NULL);
 // }
 
+#define NB_WAITERS 5
+le_sem_Ref_t GWakeSemPtr=NULL;
+le_sem_Ref_t GReadySemPtr=NULL;
+void * fonction_waiter ()
+{
+    le_sem_Post(GReadySemPtr);
+    le_sem_Wait(GWakeSemPtr);
+
+    return NULL;
+}
+
+void launch_waiters()
+{
+        int i;
+        le_thread_Ref_t thread[NB_WAITERS];
+
+        GWakeSemPtr  = le_sem_Create( "WakeSem", 0);
+        GReadySemPtr = le_sem_Create( "ReadySem", 0);
+
+        for (i = 0; i < NB_WAITERS; i ++) {
+            char threadName[20];
+            snprintf(threadName,20,"Waiter_%d",i);
+            thread[i] = le_thread_Create(threadName, fonction_waiter, NULL);
+            le_thread_SetJoinable(thread[i]);
+            le_thread_Start(thread[i]);
+        }
+        for (i = 0; i < NB_WAITERS; i ++) {
+            le_sem_Wait(GReadySemPtr);
+        }
+
+        // Give the waiters time to block, then wake them all up at once.
+        usleep(10000);
+        le_sem_PostMany(GWakeSemPtr, NB_WAITERS);
+
+        for (i = 0; i < NB_WAITERS; i ++) {
+            le_thread_Join(thread[i], NULL);
+        }
+        CU_ASSERT_EQUAL(le_sem_GetValue(GWakeSemPtr),0);
+
+        le_sem_Delete(GReadySemPtr);
+        le_sem_Delete(GWakeSemPtr);
+        CU_PASS("WakeSemaphore destroy");
+}
+
 void testScenario1(void)
 {
     launch_thread(); // thread shared
 }
 
+void testScenario3(void)
+{
+    launch_waiters(); // batched wake-up
+}
+
 // void testScenario2(void)
 // {
 //     launch_Process(); // process shared
@@ -312,6 +393,8 @@ COMPONENT_INIT
     { "trywait"                 , testTryWait },
     { "post"                    , testPostOK },
     { "value"                   , testGetValue },
+    { "postmany"                , testPostMany },
+    { "timedwait"               , testTimedWait },
     CU_TEST_INFO_NULL,
     };
 
@@ -328,6 +411,7 @@ COMPONENT_INIT
 
     CU_TestInfo test_array3[] = {
     { "scenario 1: wait thread"         , testScenario1 },
+    { "scenario 3: post many"           , testScenario3 },
 //     { "scenario 2: wait process"        , testScenario2 },
     CU_TEST_INFO_NULL,
     };
@@ -0,0 +1,195 @@
+/**
+ * Unit tests of the thread pool API.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include "CUnit/Console.h"
+#include "CUnit/Basic.h"
+
+#define NB_THREADS      4
+#define NB_TASKS        10000
+#define NB_INDEXES      100000
+#define NB_NESTED       16
+
+static le_threadPool_Ref_t GPoolRef;
+static le_sem_Ref_t GSemRef;
+
+static long GTaskCount;
+static long GSum;
+static uint8_t GHits[NB_INDEXES];
+
+/* The suite initialization function.
+ * Returns zero on success, non-zero otherwise.
+ */
+int init_suite(void)
+{
+    GPoolRef = le_threadPool_Create("TestPool", NB_THREADS);
+    return 0;
+}
+
+/* The suite cleanup function.
+ * Returns zero on success, non-zero otherwise.
+ */
+int clean_suite(void)
+{
+    le_threadPool_Delete(GPoolRef);
+    return 0;
+}
+
+void testCreateDestroy(void)
+{
+    le_threadPool_Ref_t poolRef = le_threadPool_Create("POOL-1", 0);
+    CU_ASSERT_PTR_NOT_EQUAL(poolRef, NULL);
+    CU_ASSERT(le_threadPool_GetThreadCount(poolRef) >= 1);
+
+    le_threadPool_Delete(poolRef);
+
+    poolRef = le_threadPool_Create("POOL-2", 3);
+    CU_ASSERT_EQUAL(le_threadPool_GetThreadCount(poolRef), 3);
+    le_threadPool_Delete(poolRef);
+}
+
+void testAffinity(void)
+{
+    CU_ASSERT_EQUAL(le_threadPool_SetCpuAffinity(GPoolRef, 0x1), LE_OK);
+    CU_ASSERT_EQUAL(le_threadPool_SetCpuAffinity(GPoolRef, 0), LE_BAD_PARAMETER);
+    CU_ASSERT_EQUAL(le_threadPool_SetCpuAffinity(GPoolRef, UINT64_MAX), LE_OK);
+}
+
+static void CountTask(void* contextPtr)
+{
+    if (__atomic_add_fetch(&GTaskCount, 1, __ATOMIC_ACQ_REL) == NB_TASKS)
+    {
+        le_sem_Post(GSemRef);
+    }
+}
+
+void testSubmit(void)
+{
+    int i;
+
+    GSemRef = le_sem_Create("SEM-SUBMIT", 0);
+    GTaskCount = 0;
+
+    for (i = 0; i < NB_TASKS; i++)
+    {
+        le_threadPool_Submit(GPoolRef, CountTask, NULL, NULL);
+    }
+
+    le_sem_Wait(GSemRef);
+    CU_ASSERT_EQUAL(GTaskCount, NB_TASKS);
+
+    le_sem_Delete(GSemRef);
+}
+
+static void MarkIndex(size_t index, void* contextPtr)
+{
+    GHits[index]++;
+}
+
+void testParallelFor(void)
+{
+    int i;
+
+    memset(GHits, 0, sizeof(GHits));
+
+    le_threadPool_ParallelFor(GPoolRef, 0, MarkIndex, NULL);
+    le_threadPool_ParallelFor(GPoolRef, 1, MarkIndex, NULL);
+    le_threadPool_ParallelFor(GPoolRef, NB_INDEXES, MarkIndex, NULL);
+
+    // Each index must have been visited exactly once per loop.
+    CU_ASSERT_EQUAL(GHits[0], 2);
+    for (i = 1; i < NB_INDEXES; i++)
+    {
+        if (GHits[i] != 1)
+        {
+            CU_FAIL("Index not visited exactly once");
+            break;
+        }
+    }
+}
+
+static void AddIndex(size_t index, void* contextPtr)
+{
+    __atomic_add_fetch(&GSum, index, __ATOMIC_RELAXED);
+}
+
+static void NestedLoopTask(void* contextPtr)
+{
+    le_threadPool_ParallelFor(GPoolRef, 1000, AddIndex, NULL);
+
+    if (__atomic_add_fetch(&GTaskCount, 1, __ATOMIC_ACQ_REL) == NB_NESTED)
+    {
+        le_sem_Post(GSemRef);
+    }
+}
+
+void testNestedParallelFor(void)
+{
+    int i;
+
+    GSemRef = le_sem_Create("SEM-NESTED", 0);
+    GTaskCount = 0;
+    GSum = 0;
+
+    // Loops run from the workers themselves must not deadlock, even with all workers busy.
+    for (i = 0; i < NB_NESTED; i++)
+    {
+        le_threadPool_Submit(GPoolRef, NestedLoopTask, NULL, NULL);
+    }
+
+    le_sem_Wait(GSemRef);
+    CU_ASSERT_EQUAL(GSum, NB_NESTED * (999 * 1000 / 2));
+
+    le_sem_Delete(GSemRef);
+}
+
+COMPONENT_INIT
+{
+    CU_TestInfo test_array1[] = {
+    { "create-destroy"          , testCreateDestroy },
+    { "affinity"                , testAffinity },
+    CU_TEST_INFO_NULL,
+    };
+
+    CU_TestInfo test_array2[] = {
+    { "scenario 1: submit"              , testSubmit },
+    { "scenario 2: parallel for"        , testParallelFor },
+    { "scenario 3: nested parallel for" , testNestedParallelFor },
+    CU_TEST_INFO_NULL,
+    };
+
+    CU_SuiteInfo suites[] = {
+    { "Suite test always ok"                , init_suite, clean_suite, test_array1 },
+    { "Suite test with scenario"            , init_suite, clean_suite, test_array2 },
+    CU_SUITE_INFO_NULL,
+    };
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        exit(CU_get_error());
+
+    if ( CUE_SUCCESS != CU_register_suites(suites))
+    {
+        CU_cleanup_registry();
+        exit(CU_get_error());
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+
+    // Output summary of failures, if there were any
+    if ( CU_get_number_of_failures() > 0 )
+    {
+        fprintf(stdout,"\n [START]List of Failure :\n");
+        CU_basic_show_failures(CU_get_failure_list());
+        fprintf(stdout,"\n [STOP]List of Failure\n");
+    }
+
+    CU_cleanup_registry();
+    exit(CU_get_error());
+}
@@ -15,6 +15,7 @@
 #include "forkJoinMutex.h"
 #include "externalThreadApi.h"
 #include "priority.h"
+#include "reuse.h"
 
 const char TestNameStr[] = "Thread Test";
 
@@ -39,6 +40,7 @@ static void FinishTest
     fjm_CheckResults();
     eta_CheckResults();
     prio_CheckResults();
+    reuse_CheckResults();
 
     LE_INFO("======== MULTI-THREADING TESTS PASSED ========");
     exit(EXIT_SUCCESS);
@@ -66,5 +68,7 @@ COMPONENT_INIT
 
     prio_Start(objPtr);
 
+    reuse_Start(objPtr);
+
     le_mem_Release(objPtr);
 }
@@ -0,0 +1,212 @@
+// -------------------------------------------------------------------------------------------------
+// Implementation of the reusable thread test.
+//
+// A "driver" thread starts reusable worker threads one after the other, each one after the
+// previous one has finished.  Each worker checks its name, starts and stops a timer and queues a
+// function to itself, to exercise the event loop and timers handed over from parked threads, then
+// records the pthread that ran it.
+//
+// At the end, all the workers must have run, and fewer pthreads than workers must have been used.
+//
+// Copyright (C) Sierra Wireless Inc.
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "reuse.h"
+
+
+/// Number of workers started by the driver thread.
+#define NUM_WORKERS 8
+
+/// Semaphore posted by each worker before it returns.
+static le_sem_Ref_t WorkerDoneSem;
+
+/// Number of workers that have run.
+static int NumWorkersRun = 0;
+
+/// Pthreads that ran the workers.
+static pthread_t WorkerPthreads[NUM_WORKERS];
+
+/// Thread that started the test, which joins with the driver thread.
+static le_thread_Ref_t MainThread;
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Function queued by a worker to itself.  It is never called, as the workers don't run their
+ * event loop, and its queued report is discarded when the worker finishes.
+ */
+// -------------------------------------------------------------------------------------------------
+static void QueuedFunction
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_FATAL("Queued function of worker thread '%s' was called.", le_thread_GetMyName());
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Worker thread main function.
+ *
+ * @return NULL.
+ */
+// -------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* indexPtr  ///< Index of the worker.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int index = (int)(size_t)indexPtr;
+    char expectedName[32];
+
+    snprintf(expectedName, sizeof(expectedName), "reuse%d", index);
+    LE_ASSERT(strcmp(le_thread_GetMyName(), expectedName) == 0);
+
+    le_timer_Ref_t timer = le_timer_Create("reuseTimer");
+    LE_ASSERT(LE_OK == le_timer_SetMsInterval(timer, 60000));
+    LE_ASSERT(LE_OK == le_timer_Start(timer));
+    LE_ASSERT(le_timer_IsRunning(timer));
+    LE_ASSERT(LE_OK == le_timer_Stop(timer));
+    le_timer_Delete(timer);
+
+    le_event_QueueFunction(QueuedFunction, NULL, NULL);
+
+    WorkerPthreads[index] = pthread_self();
+    NumWorkersRun++;
+
+    le_sem_Post(WorkerDoneSem);
+
+    return NULL;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Function queued by the driver thread to the thread that started the test when it's done.  Joins
+ * with the driver thread before signalling the completion of the test, so that the results aren't
+ * checked while the driver thread still exists.
+ */
+// -------------------------------------------------------------------------------------------------
+static void JoinDriver
+(
+    void* driverPtr,        ///< Driver thread.
+    void* completionObjPtr  ///< Pointer to the object whose reference count is used to signal
+                            ///  the completion of the test.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    void* unused;
+
+    LE_ASSERT(LE_OK == le_thread_Join(driverPtr, &unused));
+
+    le_mem_Release(completionObjPtr);
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Driver thread main function.
+ *
+ * @return NULL.
+ */
+// -------------------------------------------------------------------------------------------------
+static void* DriverMain
+(
+    void* completionObjPtr  ///< Pointer to the object whose reference count is used to signal
+                            ///  the completion of the test.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int i;
+
+    for (i = 0; i < NUM_WORKERS; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "reuse%d", i);
+
+        le_thread_Ref_t worker = le_thread_Create(name, WorkerMain, (void*)(size_t)i);
+        le_thread_SetReusable(worker);
+        le_thread_Start(worker);
+
+        le_sem_Wait(WorkerDoneSem);
+
+        // Give the worker time to park itself before the next one is started.
+        usleep(10000);
+    }
+
+    le_event_QueueFunctionToThread(MainThread, JoinDriver, le_thread_GetCurrent(),
+                                   completionObjPtr);
+
+    return NULL;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Starts the test.
+ *
+ * Increments the use count on a given memory pool object, then releases it when the test is
+ * complete.
+ */
+// -------------------------------------------------------------------------------------------------
+void reuse_Start
+(
+    void* completionObjPtr  ///< [in] Pointer to the object whose reference count is used to signal
+                            ///       the completion of the test.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    WorkerDoneSem = le_sem_Create("reuseDone", 0);
+
+    le_mem_AddRef(completionObjPtr);
+
+    MainThread = le_thread_GetCurrent();
+
+    le_thread_Ref_t driver = le_thread_Create("reuseDriver", DriverMain, completionObjPtr);
+    le_thread_SetJoinable(driver);
+    le_thread_Start(driver);
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Checks the completion status of the test.
+ */
+// -------------------------------------------------------------------------------------------------
+void reuse_CheckResults
+(
+    void
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(NumWorkersRun == NUM_WORKERS);
+
+    int numPthreads = 0;
+    int i;
+    int j;
+
+    for (i = 0; i < NUM_WORKERS; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            if (pthread_equal(WorkerPthreads[i], WorkerPthreads[j]))
+            {
+                break;
+            }
+        }
+
+        if (j == i)
+        {
+            numPthreads++;
+        }
+    }
+
+    LE_INFO("%d reusable workers ran on %d pthreads.", NUM_WORKERS, numPthreads);
+    LE_ASSERT(numPthreads < NUM_WORKERS);
+}
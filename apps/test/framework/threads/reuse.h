@@ -0,0 +1,34 @@
+// -------------------------------------------------------------------------------------------------
+// Header file for reusable thread tests.  These functions are called by the main module (main.c).
+//
+// Copyright (C) Sierra Wireless Inc.
+// -------------------------------------------------------------------------------------------------
+
+#ifndef LE_REUSE_TEST_H_INCLUSION_GUARD
+#define LE_REUSE_TEST_H_INCLUSION_GUARD
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Starts the test.
+ *
+ * Increments the reference count on a given memory pool object, then releases it when the test is
+ * complete.
+ */
+// -------------------------------------------------------------------------------------------------
+void reuse_Start
+(
+    void* objPtr    ///< [in] Pointer to the object whose reference count is used to signal
+                    ///       the completion of the test.
+);
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Checks the completion status of the test.
+ */
+// -------------------------------------------------------------------------------------------------
+void reuse_CheckResults
+(
+    void
+);
+
+#endif // LE_REUSE_TEST_H_INCLUSION_GUARD
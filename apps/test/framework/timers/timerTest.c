@@ -63,6 +63,30 @@ TimerTestData TimerTestDataArray[] =
 static le_clk_Time_t StartTime;
 
 
+// Number of timers started together by the expiry order test.
+#define NUM_ORDER_TIMERS 100
+
+// Interval of the timer that expired most recently in the expiry order test, and the number of
+// timers that have expired and are expected to expire.
+static uint32_t LastOrderInterval = 0;
+static int OrderExpiryCount = 0;
+static int OrderExpectedCount = 0;
+static bool OrderTestPassed = true;
+
+
+// Number of tolerant timers started together by the tolerance test, the interval of the first one
+// and the gap between the intervals, and the tolerance to give them, in milliseconds.  The
+// tolerance is longer than the spread of the intervals, so they should all expire together.
+#define NUM_TOLERANT_TIMERS 10
+#define TOLERANT_BASE_INTERVAL 200
+#define TOLERANT_INTERVAL_GAP 10
+#define TOLERANT_TOLERANCE 100
+
+static le_clk_Time_t TolerantStartTime;
+static int TolerantExpiryCount = 0;
+static bool TolerantTestPassed = true;
+
+
 void LongTimerExpiryHandler
 (
     le_timer_Ref_t timerRef    ///< This timer has expired
@@ -218,6 +242,128 @@ void TimerExpiryHandler
 }
 
 
+void OrderTimerExpiryHandler
+(
+    le_timer_Ref_t timerRef    ///< This timer has expired
+)
+{
+    uint32_t interval = (uint32_t)(uintptr_t)le_timer_GetContextPtr(timerRef);
+
+    // The timers were all started at about the same time, with intervals at least a millisecond
+    // apart, so they must expire in order of their intervals.
+    if (interval < LastOrderInterval)
+    {
+        LE_ERROR("TEST FAILED: %u ms timer expired after %u ms timer", interval, LastOrderInterval);
+        OrderTestPassed = false;
+    }
+    if ((interval % 7) == 0)
+    {
+        LE_ERROR("TEST FAILED: stopped %u ms timer expired", interval);
+        OrderTestPassed = false;
+    }
+    LastOrderInterval = interval;
+    OrderExpiryCount++;
+
+    le_timer_Delete(timerRef);
+
+    if (OrderExpiryCount == OrderExpectedCount)
+    {
+        LE_INFO("\n ======================================");
+        LE_INFO("Timer expiry order test: %s", OrderTestPassed ? "TEST PASSED" : "TEST FAILED");
+    }
+}
+
+
+void TolerantTimerExpiryHandler
+(
+    le_timer_Ref_t timerRef    ///< This timer has expired
+)
+{
+    uint32_t interval = (uint32_t)(uintptr_t)le_timer_GetContextPtr(timerRef);
+    uint32_t lastInterval = TOLERANT_BASE_INTERVAL +
+                            (NUM_TOLERANT_TIMERS - 1) * TOLERANT_INTERVAL_GAP;
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), TolerantStartTime);
+    uint32_t diffMs = diffTime.sec * 1000 + diffTime.usec / ONE_MSEC;
+
+    // No timer may expire early, or later than its tolerance allows, and they should all have been
+    // held back until the last one was due.
+    if ( (diffMs < lastInterval) ||
+         (diffMs > interval + TOLERANT_TOLERANCE + TimerTolerance.usec / ONE_MSEC) )
+    {
+        LE_ERROR("TEST FAILED: %u ms timer expired after %u ms", interval, diffMs);
+        TolerantTestPassed = false;
+    }
+    TolerantExpiryCount++;
+
+    le_timer_Delete(timerRef);
+
+    if (TolerantExpiryCount == NUM_TOLERANT_TIMERS)
+    {
+        LE_INFO("\n ======================================");
+        LE_INFO("Timer tolerance test: %s", TolerantTestPassed ? "TEST PASSED" : "TEST FAILED");
+    }
+}
+
+
+void timerToleranceTest(void)
+{
+    int i;
+
+    TolerantStartTime = le_clk_GetRelativeTime();
+
+    for (i=0; i<NUM_TOLERANT_TIMERS; i++)
+    {
+        uint32_t interval = TOLERANT_BASE_INTERVAL + i * TOLERANT_INTERVAL_GAP;
+        le_timer_Ref_t timer = le_timer_Create("tolerant timer");
+
+        le_timer_SetMsInterval(timer, interval);
+        LE_ASSERT(le_timer_SetMsTolerance(timer, TOLERANT_TOLERANCE) == LE_OK);
+        le_timer_SetContextPtr(timer, (void*)(uintptr_t)interval);
+        le_timer_SetHandler(timer, TolerantTimerExpiryHandler);
+        le_timer_Start(timer);
+
+        // The tolerance can't be changed while the timer is running.
+        LE_ASSERT(le_timer_SetTolerance(timer, TimerTolerance) == LE_BUSY);
+    }
+}
+
+
+void timerOrderTest(void)
+{
+    le_timer_Ref_t timers[NUM_ORDER_TIMERS];
+    int i;
+
+    // Start many timers in a scrambled order of interval, then stop and restart some of them.
+    for (i=0; i<NUM_ORDER_TIMERS; i++)
+    {
+        uint32_t interval = 100 + ((i * 37) % NUM_ORDER_TIMERS);
+
+        timers[i] = le_timer_Create("order timer");
+        le_timer_SetMsInterval(timers[i], interval);
+        le_timer_SetContextPtr(timers[i], (void*)(uintptr_t)interval);
+        le_timer_SetHandler(timers[i], OrderTimerExpiryHandler);
+        le_timer_Start(timers[i]);
+    }
+
+    for (i=0; i<NUM_ORDER_TIMERS; i++)
+    {
+        uint32_t interval = (uint32_t)(uintptr_t)le_timer_GetContextPtr(timers[i]);
+
+        if ((interval % 7) == 0)
+        {
+            le_timer_Stop(timers[i]);
+            le_timer_Delete(timers[i]);
+            continue;
+        }
+        else if ((interval % 5) == 0)
+        {
+            le_timer_Restart(timers[i]);
+        }
+        OrderExpectedCount++;
+    }
+}
+
+
 void timerEventLoopTest(void)
 {
     le_timer_Ref_t newTimer;
@@ -245,6 +391,8 @@ COMPONENT_INIT
     LE_INFO("\n");
     LE_INFO("====  Unit test for le_timer module. ====");
 
+    timerOrderTest();
+    timerToleranceTest();
     timerEventLoopTest();
 
     LE_INFO("==== Timer Tests Started ====\n");
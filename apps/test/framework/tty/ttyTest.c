@@ -253,6 +253,77 @@ static void TestTtySetRaw
     TestTtyClose(fd);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test read batching, low latency mode and readable bytes
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTtyLatency
+(
+    void
+)
+{
+    int fd = TestTtyOpen();
+    le_result_t result;
+
+    LE_ASSERT(LE_OK == le_tty_SetRaw(fd, 0, 0));
+    LE_ASSERT(LE_OK == le_tty_SetReadBatching(fd, 64, 1));
+    LE_ASSERT(LE_OK == le_tty_SetReadBatching(fd, 0, 0));
+
+    result = le_tty_SetLowLatency(fd, true);
+    LE_ASSERT((LE_OK == result) || (LE_UNSUPPORTED == result));
+    result = le_tty_SetLowLatency(fd, false);
+    LE_ASSERT((LE_OK == result) || (LE_UNSUPPORTED == result));
+
+    LE_ASSERT(le_tty_GetReadableBytes(fd) >= 0);
+
+    TestTtyClose(fd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the line reader, on a pipe
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTtyLineReader
+(
+    void
+)
+{
+    int pipeFds[2];
+    char buffer[8];
+    le_tty_LineReader_t reader;
+    char* linePtr;
+
+    LE_ASSERT(0 == pipe2(pipeFds, O_NONBLOCK));
+
+    le_tty_InitLineReader(&reader, pipeFds[0], buffer, sizeof(buffer));
+    LE_ASSERT(LE_WOULD_BLOCK == le_tty_ReadLine(&reader, &linePtr));
+
+    LE_ASSERT(7 == write(pipeFds[1], "ab\r\n\ncd", 7));
+    LE_ASSERT(LE_OK == le_tty_ReadLine(&reader, &linePtr));
+    LE_ASSERT(0 == strcmp(linePtr, "ab"));
+    LE_ASSERT(LE_OK == le_tty_ReadLine(&reader, &linePtr));
+    LE_ASSERT(0 == strcmp(linePtr, ""));
+    LE_ASSERT(LE_WOULD_BLOCK == le_tty_ReadLine(&reader, &linePtr));
+
+    // A line too long for the buffer is returned in pieces.
+    LE_ASSERT(7 == write(pipeFds[1], "efghij\n", 7));
+    LE_ASSERT(LE_OVERFLOW == le_tty_ReadLine(&reader, &linePtr));
+    LE_ASSERT(0 == strcmp(linePtr, "cdefghi"));
+    LE_ASSERT(LE_OK == le_tty_ReadLine(&reader, &linePtr));
+    LE_ASSERT(0 == strcmp(linePtr, "j"));
+
+    // Data without a line ending is returned before the end of file.
+    LE_ASSERT(2 == write(pipeFds[1], "xy", 2));
+    fd_Close(pipeFds[1]);
+    LE_ASSERT(LE_OK == le_tty_ReadLine(&reader, &linePtr));
+    LE_ASSERT(0 == strcmp(linePtr, "xy"));
+    LE_ASSERT(LE_CLOSED == le_tty_ReadLine(&reader, &linePtr));
+
+    fd_Close(pipeFds[0]);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * App init.
@@ -300,6 +371,8 @@ COMPONENT_INIT
     TestTtySetFlowControl();
     TestTtySetCanonical();
     TestTtySetRaw();
+    TestTtyLatency();
+    TestTtyLineReader();
 
     // restore configuration
     fd = TestTtyOpen();
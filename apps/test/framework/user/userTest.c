@@ -9,6 +9,8 @@
 #define APP_USER_NAME   "appAthens"
 #define APP_NAME        "Athens"
 #define GROUP_NAME      "testGroup"
+#define BATCH_USER_1    "batchUser1"
+#define BATCH_USER_2    "batchUser2"
 
 uid_t Uid, AppUid;
 gid_t Gid, AppGid;
@@ -113,6 +115,35 @@ static void TestGroupDelete(void)
 }
 
 
+static void TestUserBatch(void)
+{
+    uid_t uid1, uid2, uid;
+    gid_t gid1, gid2, gid;
+
+    // Cancelled batches create nothing.
+    LE_ASSERT(user_BeginBatch() == LE_OK);
+    LE_ASSERT(user_AddToBatch(BATCH_USER_1, &uid1, &gid1) == LE_OK);
+    user_CancelBatch();
+    LE_ASSERT(user_GetIDs(BATCH_USER_1, NULL, NULL) == LE_NOT_FOUND);
+
+    // Users of the same batch get distinct IDs, and are visible once it's committed.
+    LE_ASSERT(user_BeginBatch() == LE_OK);
+    LE_ASSERT(user_AddToBatch(BATCH_USER_1, &uid1, &gid1) == LE_OK);
+    LE_ASSERT(user_AddToBatch(BATCH_USER_2, &uid2, &gid2) == LE_OK);
+    LE_ASSERT(user_AddToBatch(BATCH_USER_1, &uid, &gid) == LE_DUPLICATE);
+    LE_ASSERT( (uid == uid1) && (gid == gid1) );
+    LE_ASSERT( (uid1 != uid2) && (gid1 != gid2) );
+    LE_ASSERT(user_CommitBatch() == LE_OK);
+
+    LE_ASSERT(user_GetIDs(BATCH_USER_2, &uid, &gid) == LE_OK);
+    LE_ASSERT( (uid == uid2) && (gid == gid2) );
+
+    LE_ASSERT(user_Delete(BATCH_USER_1) == LE_OK);
+    LE_ASSERT(user_Delete(BATCH_USER_2) == LE_OK);
+    LE_ASSERT(user_GetIDs(BATCH_USER_1, NULL, NULL) == LE_NOT_FOUND);
+}
+
+
 COMPONENT_INIT
 {
     LE_INFO("======== Starting Users Test ========");
@@ -129,6 +160,8 @@ COMPONENT_INIT
     TestGroupCreation();
     TestGroupDelete();
 
+    TestUserBatch();
+
     LE_INFO("======== Users Test Completed Successfully ========");
     exit(EXIT_SUCCESS);
 }
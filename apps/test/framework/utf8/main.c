@@ -632,6 +632,44 @@ COMPONENT_INIT
 
     printf("Copy Up To Substring correct.\n");
 
+    // Copy and validate.
+    if ( (le_utf8_CopyValidated(destBuffer, multiByteStr2, sizeof(destBuffer), &numBytesCopied)
+          != LE_OK) ||
+         (numBytesCopied != strlen(multiByteStr2)) ||
+         (strcmp(destBuffer, multiByteStr2) != 0) )
+    {
+        printf("Copy validated incorrect: %d\n", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy and validate a long ASCII string that doesn't fit.
+    const char longAsciiStr[] = "This ASCII string is longer than the destination buffer.";
+    char smallBuffer[20];
+    if ( (le_utf8_CopyValidated(smallBuffer, longAsciiStr, sizeof(smallBuffer), &numBytesCopied)
+          != LE_OVERFLOW) ||
+         (numBytesCopied != sizeof(smallBuffer) - 1) ||
+         (strncmp(smallBuffer, longAsciiStr, sizeof(smallBuffer) - 1) != 0) ||
+         (smallBuffer[sizeof(smallBuffer) - 1] != '\0') )
+    {
+        printf("Copy validated incorrect: %d\n", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy and validate a truncated multi-byte character after a long run of ASCII.
+    const char badStr[] = "Long enough ASCII run \xE2\x82";
+    if ( (le_utf8_CopyValidated(destBuffer, badStr, sizeof(destBuffer), &numBytesCopied)
+          != LE_FORMAT_ERROR) ||
+         (numBytesCopied != 0) ||
+         (destBuffer[0] != '\0') ||
+         le_utf8_IsFormatCorrect(badStr) ||
+         (le_utf8_NumChars(badStr) != LE_FORMAT_ERROR) )
+    {
+        printf("Copy validated incorrect: %d\n", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Copy validated correct.\n");
+
     TestIntParsing();
 
     printf("Int parsing correct.\n");
@@ -85,7 +85,9 @@ static void Testle_fwupdate_Download
     // Test valid file descriptor and error on PA: API needs to return LE_FAULT
     // Set returned error code for PA function: LE_FAULT
     pa_fwupdateSimu_SetReturnCode (LE_FAULT);
-    fd = 1;
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
@@ -96,6 +98,9 @@ static void Testle_fwupdate_Download
     pa_fwupdateSimu_SetReturnCode (LE_OK);
     // Set the synchronization state to false
     pa_fwupdateSimu_SetSyncState (false);
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
@@ -106,6 +111,9 @@ static void Testle_fwupdate_Download
     pa_fwupdateSimu_SetReturnCode (LE_TIMEOUT);
     // Set the synchronization state to true
     pa_fwupdateSimu_SetSyncState (true);
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
@@ -116,6 +124,9 @@ static void Testle_fwupdate_Download
     pa_fwupdateSimu_SetReturnCode (LE_UNAVAILABLE);
     // Set the synchronization state to false
     pa_fwupdateSimu_SetSyncState (true);
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
@@ -126,6 +137,9 @@ static void Testle_fwupdate_Download
     pa_fwupdateSimu_SetReturnCode (LE_CLOSED);
     // Set the synchronization state to true
     pa_fwupdateSimu_SetSyncState (true);
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
@@ -136,11 +150,25 @@ static void Testle_fwupdate_Download
     pa_fwupdateSimu_SetReturnCode (LE_OK);
     // Set the synchronization state to true
     pa_fwupdateSimu_SetSyncState (true);
+    // The image is consumed by the download: open a new one
+    fd = open("/dev/null", O_RDONLY);
+    LE_ASSERT (fd >= 0);
     // Call the function to be tested
     result = le_fwupdate_Download (fd);
     // Check required values
     LE_ASSERT (result == LE_OK);
 
+    // The statistics of the download are available: nothing was received from the empty image
+    size_t startPosition;
+    uint64_t receivedBytes;
+    uint32_t durationMs;
+    uint32_t throughput;
+    result = le_fwupdate_GetDownloadStatistics (&startPosition, &receivedBytes, &durationMs,
+                                                &throughput);
+    LE_ASSERT (result == LE_OK);
+    LE_ASSERT (receivedBytes == 0);
+    LE_ASSERT (throughput == 0);
+
     LE_INFO ("======== Test: le_fwupdate_Download PASSED ========");
 }
 
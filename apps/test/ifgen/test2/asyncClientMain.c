@@ -0,0 +1,131 @@
+/*
+ * Client side of the async client test.  The requests are made using the Async functions
+ * generated by ifgen --async-client, inside a batch, and are checked when the responses arrive.
+ */
+
+#include "legato.h"
+#include "asyncClient_interface.h"
+#include "le_print.h"
+
+#define NUM_REQUESTS 3
+
+// Values passed to allParameters, one for each request in the batch.
+static const common_EnumExample_t Values[NUM_REQUESTS] = { COMMON_ONE, COMMON_TWO, COMMON_ONE };
+
+// Number of responses received so far.
+static int NumResponses = 0;
+
+// Input to BufferTest, far larger than a message.
+static uint8_t BufferIn[ASYNCCLIENT_BUFFER_SIZE];
+
+
+static void HandleTriggerTestA
+(
+    void* contextPtr
+)
+{
+    LE_DEBUG("TriggerTestA response");
+
+    // This was sent after all the other requests, so its response must come last.
+    LE_ASSERT(NumResponses == NUM_REQUESTS + 1);
+    LE_ASSERT(contextPtr == &NumResponses);
+
+    LE_INFO("Async client test passed");
+    exit(EXIT_SUCCESS);
+}
+
+
+static void HandleAllParameters
+(
+    uint32_t b,
+    const uint32_t* outputPtr,
+    size_t outputSize,
+    const char* response,
+    const char* more,
+    void* contextPtr
+)
+{
+    int index = (int)(intptr_t)contextPtr;
+    int i;
+
+    LE_PRINT_VALUE("%d", index);
+    LE_PRINT_VALUE("%u", b);
+    LE_PRINT_ARRAY("%u", outputSize, outputPtr);
+
+    // The responses must arrive in the order the requests were made.
+    LE_ASSERT(index == NumResponses);
+    NumResponses++;
+
+    // All outputs are requested at their maximum sizes.
+    LE_ASSERT(b == Values[index]);
+    LE_ASSERT(outputSize == ASYNCCLIENT_TEN);
+    for (i = 0; i < outputSize; i++)
+    {
+        LE_ASSERT(outputPtr[i] == i * Values[index]);
+    }
+    LE_ASSERT(strcmp(response, "response string") == 0);
+    LE_ASSERT(strcmp(more, "more info") == 0);
+}
+
+
+static void HandleBufferTest
+(
+    const uint8_t* dataOutPtr,
+    size_t dataOutSize,
+    void* contextPtr
+)
+{
+    size_t i;
+
+    LE_PRINT_VALUE("%zu", dataOutSize);
+
+    // This was sent after the allParameters requests.
+    LE_ASSERT(NumResponses == NUM_REQUESTS);
+    LE_ASSERT(contextPtr == BufferIn);
+    NumResponses++;
+
+    // The output is only mapped until this handler returns, so it's checked here.
+    LE_ASSERT(dataOutSize == sizeof(BufferIn));
+    for (i = 0; i < dataOutSize; i++)
+    {
+        LE_ASSERT(dataOutPtr[i] == (uint8_t)~BufferIn[i]);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    uint32_t data[] = { 1, 2, 3 };
+    int i;
+
+    for (i = 0; i < sizeof(BufferIn); i++)
+    {
+        BufferIn[i] = (uint8_t)i;
+    }
+
+    asyncClient_ConnectService();
+
+    // Nothing is sent until the outer batch ends.
+    asyncClient_StartBatch();
+    for (i = 0; i < NUM_REQUESTS; i++)
+    {
+        if (i == 1)
+        {
+            asyncClient_StartBatch();
+        }
+        asyncClient_allParametersAsync(Values[i],
+                                       data,
+                                       NUM_ARRAY_MEMBERS(data),
+                                       "async label",
+                                       HandleAllParameters,
+                                       (void*)(intptr_t)i);
+    }
+    asyncClient_EndBatch();
+    asyncClient_BufferTestAsync(BufferIn, sizeof(BufferIn), HandleBufferTest, BufferIn);
+    asyncClient_TriggerTestAAsync(HandleTriggerTestA, &NumResponses);
+    asyncClient_EndBatch();
+
+    LE_ASSERT(NumResponses == 0);
+
+    // The rest of the test is done by the response handlers.
+}
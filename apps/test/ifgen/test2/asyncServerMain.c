@@ -107,6 +107,39 @@ void async_FileTest
     async_FileTestRespond(_cmdRef, dataOut);
 }
 
+// Test shared memory buffers as input and output parameters
+void async_BufferTest
+(
+    async_ServerCmdRef_t _cmdRef,
+    const uint8_t* dataInPtr,
+    size_t dataInSize,
+    size_t dataOutSize
+)
+{
+    size_t i;
+
+    LE_PRINT_VALUE("%zu", dataInSize);
+    LE_ASSERT(dataInSize <= dataOutSize);
+
+    // The input stays mapped until the response is sent, so it can be checked and answered here.
+    for (i = 0; i < dataInSize; i++)
+    {
+        LE_ASSERT(dataInPtr[i] == (uint8_t)i);
+    }
+
+    uint8_t* dataOutPtr = malloc(dataInSize + 1);
+    LE_ASSERT(dataOutPtr != NULL);
+
+    for (i = 0; i < dataInSize; i++)
+    {
+        dataOutPtr[i] = ~dataInPtr[i];
+    }
+
+    // The response copies the output into a shared buffer of its own.
+    async_BufferTestRespond(_cmdRef, dataOutPtr, dataInSize);
+    free(dataOutPtr);
+}
+
 
 // Storage for the handler ref
 static async_TestAHandlerFunc_t HandlerRef = NULL;
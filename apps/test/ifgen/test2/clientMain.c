@@ -262,6 +262,31 @@ void test1(void)
     // Read and print out whatever is read from the server fd
     writeFdToLog(fdFromServer);
     close(fdToServer);
+
+    // Test shared memory buffers, at far more than fits in a message
+    static uint8_t dataIn[EXAMPLE_BUFFER_SIZE];
+    static uint8_t dataOut[EXAMPLE_BUFFER_SIZE];
+    size_t dataOutSize = sizeof(dataOut);
+    size_t i;
+
+    for (i = 0; i < sizeof(dataIn); i++)
+    {
+        dataIn[i] = (uint8_t)i;
+    }
+
+    example_BufferTest(dataIn, sizeof(dataIn), dataOut, &dataOutSize);
+    LE_PRINT_VALUE("%zu", dataOutSize);
+
+    LE_ASSERT(dataOutSize == sizeof(dataIn));
+    for (i = 0; i < dataOutSize; i++)
+    {
+        LE_ASSERT(dataOut[i] == (uint8_t)~dataIn[i]);
+    }
+
+    // An empty input is passed without a shared buffer
+    dataOutSize = sizeof(dataOut);
+    example_BufferTest(dataIn, 0, dataOut, &dataOutSize);
+    LE_ASSERT(dataOutSize == 0);
 }
 
 
@@ -65,6 +65,22 @@ void example_FileTest
 {
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty stub since this is already tested by other code
+ */
+//--------------------------------------------------------------------------------------------------
+void example_BufferTest
+(
+    const uint8_t* dataInPtr,
+    size_t dataInSize,
+    uint8_t* dataOutPtr,
+    size_t* dataOutSizePtr
+)
+{
+    *dataOutSizePtr = 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test handler related functions
@@ -113,6 +113,38 @@ void example_FileTest
 }
 
 
+// Test shared memory buffers as input and output parameters
+void example_BufferTest
+(
+    const uint8_t* dataInPtr,
+    size_t dataInSize,
+    uint8_t* dataOutPtr,
+    size_t* dataOutSizePtr
+)
+{
+    size_t i;
+
+    LE_PRINT_VALUE("%zu", dataInSize);
+    LE_PRINT_VALUE("%zu", *dataOutSizePtr);
+
+    // The client fills the input with a known pattern; return the complement of it.
+    for (i = 0; i < dataInSize; i++)
+    {
+        LE_ASSERT(dataInPtr[i] == (uint8_t)i);
+    }
+
+    if (*dataOutSizePtr > dataInSize)
+    {
+        *dataOutSizePtr = dataInSize;
+    }
+
+    for (i = 0; i < *dataOutSizePtr; i++)
+    {
+        dataOutPtr[i] = ~dataInPtr[i];
+    }
+}
+
+
 // Storage for the handler ref
 static example_TestAHandlerFunc_t HandlerRef = NULL;
 static void* ContextPtr = NULL;
@@ -0,0 +1,944 @@
+/**
+ * IPC stress and throughput test client.
+ *
+ * Starts a number of client processes, each opening a number of sessions with the stress server
+ * (one per thread).  Each session then runs, in turn:
+ *
+ *  - for each payload size, a mix of synchronous (Echo) and asynchronous (EchoAsync) calls, with
+ *    a fixed maximum number of asynchronous calls in flight;
+ *  - an event fan-out phase, where it subscribes to Tick events and asks the server to Broadcast
+ *    a number of them to every subscriber, of every client process;
+ *  - a file descriptor passing phase (PassFile), sending a file descriptor to the server and
+ *    getting one back;
+ *  - a session opening phase, where it repeatedly disconnects from and reconnects to the server,
+ *    which measures how fast the Service Directory sets up sessions.
+ *
+ * The first process only starts the others (from /proc/self/exe, with the --worker option), then
+ * gathers their results through pipes.  Latencies are counted in histograms with 8 buckets per
+ * power of two, so the percentiles reported are the upper bounds of their buckets (at most 12.5%
+ * above the actual values).
+ *
+ * Options:
+ *
+ *  - @c --clients=N : number of client processes (default 1).
+ *  - @c --sessions=N : number of sessions per client process (default 4).
+ *  - @c --calls=N : number of calls per session and payload size (default 10000).
+ *  - @c --async=PERCENT : percentage of the calls that are asynchronous (default 50).
+ *  - @c --window=N : maximum number of asynchronous calls in flight per session (default 8).
+ *  - @c --payloads=SIZE,SIZE... : payload sizes, in bytes (default 16,256,4096).
+ *  - @c --events=N : number of events broadcast by each session (default 1000).
+ *  - @c --fds=N : number of file descriptors passed by each session (default 1000).
+ *  - @c --opens=N : number of sessions opened by each session's thread (default 100).
+ *  - @c -q / @c --quick : run a tenth of the calls, events, file descriptors and sessions.
+ *
+ * Every result is printed to stdout as a single line containing one JSON object.  For example:
+ *
+ * @verbatim
+{"benchmark":"ipc.sync","clients":1,"sessions":4,"payload":256,"ops":20000,"ns":1234567890,"opsPerSec":16200,"meanUs":245.10,"p50Us":229.38,"p90Us":327.68,"p99Us":557.06,"maxUs":1203.42}
+@endverbatim
+ *
+ * Throughput (opsPerSec) is the total number of operations of all the sessions, divided by the
+ * time from the first session starting the phase to the last one finishing it.  For events, the
+ * operations counted are the deliveries of ticks to subscribers.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include <poll.h>
+#include <sys/wait.h>
+
+
+/// Maximum numbers of client processes, of sessions per process and of payload sizes.
+#define MAX_CLIENTS         64
+#define MAX_SESSIONS        256
+#define MAX_PAYLOADS        8
+
+/// Maximum number of asynchronous calls in flight per session.
+#define MAX_WINDOW          64
+
+/// Latency histograms have 2^SUB_BUCKET_BITS buckets per power of two.
+#define SUB_BUCKET_BITS     3
+#define NUM_SUB_BUCKETS     (1 << SUB_BUCKET_BITS)
+#define NUM_BUCKETS         ((64 - SUB_BUCKET_BITS + 1) * NUM_SUB_BUCKETS)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of one kind of operation.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t count;                 ///< Number of operations.
+    uint64_t totalNs;               ///< Sum of their latencies.
+    uint64_t maxNs;                 ///< Highest latency.
+    uint64_t startNs;               ///< When the first session started the phase (0 if none did).
+    uint64_t endNs;                 ///< When the last session finished the phase.
+    uint64_t buckets[NUM_BUCKETS];  ///< Latency histogram.
+}
+Stats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Results of a session, of a client process, or of all of them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Stats_t sync[MAX_PAYLOADS];     ///< Synchronous calls, per payload size.
+    Stats_t async[MAX_PAYLOADS];    ///< Asynchronous calls, per payload size.
+    Stats_t event;                  ///< Tick deliveries.
+    Stats_t fd;                     ///< File descriptor passing calls.
+    Stats_t open;                   ///< Session openings.
+}
+Results_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a session, run by its own thread.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    seed;                       ///< Seed of the pseudo-random sync/async choices.
+    uint32_t    originId;                   ///< Identifies the session's broadcasts.
+    size_t      payloadSize;                ///< Payload size of the calls being run.
+    uint32_t    numInFlight;                ///< Number of asynchronous calls in flight.
+    uint64_t    asyncStartNs[MAX_WINDOW];   ///< Start times of the calls in flight, by sequence.
+    Stats_t*    asyncStatsPtr;              ///< Statistics of the calls in flight.
+    uint32_t    numOwnTicks;                ///< Ticks of the session's broadcast received so far.
+    Results_t   results;                    ///< Results of the session.
+}
+Session_t;
+
+
+static int NumClients = 1;
+static int NumSessions = 4;
+static int NumCalls = 10000;
+static int AsyncPercent = 50;
+static int Window = 8;
+static const char* PayloadsStr = "16,256,4096";
+static int NumEvents = 1000;
+static int NumFds = 1000;
+static int NumOpens = 100;
+static bool IsQuick = false;
+static bool IsWorker = false;
+
+static size_t PayloadSizes[MAX_PAYLOADS];   ///< Payload sizes parsed from PayloadsStr.
+static size_t NumPayloads;                  ///< Number of payload sizes.
+
+static pthread_barrier_t EventBarrier;      ///< Lines up the sessions of a process for events.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the monotonic clock, which all the processes share.
+ *
+ * @return The current time in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NowNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    LE_FATAL_IF(clock_gettime(CLOCK_MONOTONIC, &ts) != 0, "clock_gettime() failed (%m).");
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next number of a session's pseudo-random sequence.
+ *
+ * @return A number from 0 to 99.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextPercent
+(
+    Session_t* sessionPtr
+)
+{
+    sessionPtr->seed = sessionPtr->seed * 1103515245 + 12345;
+
+    return (sessionPtr->seed >> 16) % 100;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the histogram bucket of a latency.
+ *
+ * @return Index of the bucket.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t BucketIndex
+(
+    uint64_t ns
+)
+{
+    if (ns < NUM_SUB_BUCKETS)
+    {
+        return ns;
+    }
+
+    int msb = 63 - __builtin_clzll(ns);
+
+    return (msb - SUB_BUCKET_BITS + 1) * NUM_SUB_BUCKETS
+           + ((ns >> (msb - SUB_BUCKET_BITS)) & (NUM_SUB_BUCKETS - 1));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the lowest latency counted in a histogram bucket.
+ *
+ * @return The latency, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t BucketLowNs
+(
+    size_t index
+)
+{
+    if (index < NUM_SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    int msb = index / NUM_SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+
+    return (uint64_t)(NUM_SUB_BUCKETS + index % NUM_SUB_BUCKETS) << (msb - SUB_BUCKET_BITS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count an operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Record
+(
+    Stats_t* statsPtr,
+    uint64_t ns             ///< Latency of the operation.
+)
+{
+    statsPtr->count++;
+    statsPtr->totalNs += ns;
+    if (ns > statsPtr->maxNs)
+    {
+        statsPtr->maxNs = ns;
+    }
+    statsPtr->buckets[BucketIndex(ns)]++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add statistics to others.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MergeStats
+(
+    Stats_t* destPtr,
+    const Stats_t* srcPtr
+)
+{
+    size_t i;
+
+    if (srcPtr->startNs == 0)
+    {
+        return;
+    }
+
+    if ((destPtr->startNs == 0) || (srcPtr->startNs < destPtr->startNs))
+    {
+        destPtr->startNs = srcPtr->startNs;
+    }
+    if (srcPtr->endNs > destPtr->endNs)
+    {
+        destPtr->endNs = srcPtr->endNs;
+    }
+    if (srcPtr->maxNs > destPtr->maxNs)
+    {
+        destPtr->maxNs = srcPtr->maxNs;
+    }
+    destPtr->count += srcPtr->count;
+    destPtr->totalNs += srcPtr->totalNs;
+
+    for (i = 0; i < NUM_BUCKETS; i++)
+    {
+        destPtr->buckets[i] += srcPtr->buckets[i];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add results to others.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MergeResults
+(
+    Results_t* destPtr,
+    const Results_t* srcPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < MAX_PAYLOADS; i++)
+    {
+        MergeStats(&destPtr->sync[i], &srcPtr->sync[i]);
+        MergeStats(&destPtr->async[i], &srcPtr->async[i]);
+    }
+    MergeStats(&destPtr->event, &srcPtr->event);
+    MergeStats(&destPtr->fd, &srcPtr->fd);
+    MergeStats(&destPtr->open, &srcPtr->open);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a latency percentile.
+ *
+ * @return The upper bound of the percentile's bucket, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double PercentileUs
+(
+    const Stats_t* statsPtr,
+    double fraction         ///< Percentile, from 0 to 1.
+)
+{
+    uint64_t target = (uint64_t)(statsPtr->count * fraction);
+    uint64_t seen = 0;
+    size_t i;
+
+    for (i = 0; i < NUM_BUCKETS - 1; i++)
+    {
+        seen += statsPtr->buckets[i];
+
+        if (seen > target)
+        {
+            break;
+        }
+    }
+
+    uint64_t ns = (i < NUM_BUCKETS - 1) ? (BucketLowNs(i + 1) - 1) : statsPtr->maxNs;
+
+    return (ns > statsPtr->maxNs ? statsPtr->maxNs : ns) / 1000.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the result of one phase, unless no operation was run in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Report
+(
+    const char* name,           ///< Name of the benchmark.
+    size_t payloadSize,         ///< Payload size, or 0 if not applicable.
+    const Stats_t* statsPtr
+)
+{
+    if (statsPtr->count == 0)
+    {
+        return;
+    }
+
+    uint64_t elapsedNs = statsPtr->endNs - statsPtr->startNs;
+
+    printf("{\"benchmark\":\"%s\",\"clients\":%d,\"sessions\":%d,", name, NumClients, NumSessions);
+    if (payloadSize != 0)
+    {
+        printf("\"payload\":%zu,", payloadSize);
+    }
+    printf("\"ops\":%" PRIu64 ",\"ns\":%" PRIu64 ",\"opsPerSec\":%.0f,"
+           "\"meanUs\":%.2f,\"p50Us\":%.2f,\"p90Us\":%.2f,\"p99Us\":%.2f,\"maxUs\":%.2f}\n",
+           statsPtr->count,
+           elapsedNs,
+           (elapsedNs == 0) ? 0.0 : (double)statsPtr->count * 1e9 / elapsedNs,
+           (double)statsPtr->totalNs / statsPtr->count / 1000.0,
+           PercentileUs(statsPtr, 0.5),
+           PercentileUs(statsPtr, 0.9),
+           PercentileUs(statsPtr, 0.99),
+           statsPtr->maxNs / 1000.0);
+
+    fflush(stdout);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for something to happen on the calling thread's event loop, then handle everything that's
+ * pending on it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServiceEvents
+(
+    void
+)
+{
+    struct pollfd pollFd = { .fd = le_event_GetFd(), .events = POLLIN };
+
+    if ((poll(&pollFd, 1, -1) < 0) && (errno != EINTR))
+    {
+        LE_FATAL("poll() failed (%m).");
+    }
+
+    while (le_event_ServiceLoop() == LE_OK)
+    {
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the response to an asynchronous call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EchoDoneHandler
+(
+    uint32_t Seq,
+    const uint8_t* DataPtr,
+    size_t DataSize,
+    void* contextPtr
+)
+{
+    Session_t* sessionPtr = contextPtr;
+
+    LE_ASSERT(DataSize == sessionPtr->payloadSize);
+
+    // Responses come back in order, and no more than Window calls are in flight, so their start
+    // times can't be overwritten before they're used.
+    Record(sessionPtr->asyncStatsPtr, NowNs() - sessionPtr->asyncStartNs[Seq % Window]);
+    sessionPtr->numInFlight--;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a tick.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TickHandler
+(
+    uint32_t OriginId,
+    uint32_t Seq,
+    uint64_t SentNs,
+    void* contextPtr
+)
+{
+    Session_t* sessionPtr = contextPtr;
+
+    Record(&sessionPtr->results.event, NowNs() - SentNs);
+
+    if (OriginId == sessionPtr->originId)
+    {
+        sessionPtr->numOwnTicks++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the synchronous and asynchronous calls, for each payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunCalls
+(
+    Session_t* sessionPtr
+)
+{
+    static const uint8_t inData[IPCSTRESS_MAX_PAYLOAD_BYTES] = { 0x5a };
+    uint8_t outData[IPCSTRESS_MAX_PAYLOAD_BYTES];
+    uint32_t seq = 0;
+    size_t p;
+    int i;
+
+    for (p = 0; p < NumPayloads; p++)
+    {
+        Stats_t* syncStatsPtr = &sessionPtr->results.sync[p];
+
+        sessionPtr->payloadSize = PayloadSizes[p];
+        sessionPtr->asyncStatsPtr = &sessionPtr->results.async[p];
+
+        uint64_t startNs = NowNs();
+
+        for (i = 0; i < NumCalls; i++)
+        {
+            if (NextPercent(sessionPtr) < (uint32_t)AsyncPercent)
+            {
+                while (sessionPtr->numInFlight >= (uint32_t)Window)
+                {
+                    ServiceEvents();
+                }
+
+                sessionPtr->asyncStartNs[seq % Window] = NowNs();
+                sessionPtr->numInFlight++;
+                ipcStress_EchoAsync(seq, inData, sessionPtr->payloadSize,
+                                    EchoDoneHandler, sessionPtr);
+                seq++;
+            }
+            else
+            {
+                size_t outSize = sizeof(outData);
+                uint64_t callStartNs = NowNs();
+
+                ipcStress_Echo(inData, sessionPtr->payloadSize, outData, &outSize);
+                Record(syncStatsPtr, NowNs() - callStartNs);
+
+                LE_ASSERT(outSize == sessionPtr->payloadSize);
+            }
+        }
+
+        while (sessionPtr->numInFlight > 0)
+        {
+            ServiceEvents();
+        }
+
+        uint64_t endNs = NowNs();
+
+        syncStatsPtr->startNs = startNs;
+        syncStatsPtr->endNs = endNs;
+        sessionPtr->asyncStatsPtr->startNs = startNs;
+        sessionPtr->asyncStatsPtr->endNs = endNs;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribe to ticks, broadcast some and wait for them to come back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunEvents
+(
+    Session_t* sessionPtr
+)
+{
+    Stats_t* statsPtr = &sessionPtr->results.event;
+
+    ipcStress_TickHandlerRef_t handlerRef = ipcStress_AddTickHandler(TickHandler, sessionPtr);
+
+    // Make sure all the sessions of this process get each other's ticks.
+    pthread_barrier_wait(&EventBarrier);
+
+    statsPtr->startNs = NowNs();
+
+    ipcStress_Broadcast(sessionPtr->originId, NumEvents);
+
+    while (sessionPtr->numOwnTicks < (uint32_t)NumEvents)
+    {
+        ServiceEvents();
+    }
+
+    pthread_barrier_wait(&EventBarrier);
+
+    // Count the ticks that arrived while waiting for the other sessions.
+    while (le_event_ServiceLoop() == LE_OK)
+    {
+    }
+
+    statsPtr->endNs = NowNs();
+
+    ipcStress_RemoveTickHandler(handlerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass file descriptors to the server and back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunFds
+(
+    Session_t* sessionPtr
+)
+{
+    Stats_t* statsPtr = &sessionPtr->results.fd;
+    int i;
+
+    int fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    LE_FATAL_IF(fd < 0, "Failed to open /dev/null (%m).");
+
+    statsPtr->startNs = NowNs();
+
+    for (i = 0; i < NumFds; i++)
+    {
+        // The file descriptor sent is closed once it has been sent, so send a copy.
+        int inFd = dup(fd);
+        int outFd = -1;
+
+        LE_FATAL_IF(inFd < 0, "Failed to duplicate file descriptor (%m).");
+
+        uint64_t callStartNs = NowNs();
+
+        ipcStress_PassFile(inFd, &outFd);
+        Record(statsPtr, NowNs() - callStartNs);
+
+        LE_ASSERT(outFd >= 0);
+        close(outFd);
+    }
+
+    statsPtr->endNs = NowNs();
+
+    close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the session, then open and close new ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunOpens
+(
+    Session_t* sessionPtr
+)
+{
+    Stats_t* statsPtr = &sessionPtr->results.open;
+    int i;
+
+    ipcStress_DisconnectService();
+
+    statsPtr->startNs = NowNs();
+
+    for (i = 0; i < NumOpens; i++)
+    {
+        uint64_t openStartNs = NowNs();
+
+        ipcStress_ConnectService();
+        Record(statsPtr, NowNs() - openStartNs);
+
+        ipcStress_DisconnectService();
+    }
+
+    statsPtr->endNs = NowNs();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a session's thread.
+ *
+ * @return NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SessionMain
+(
+    void* contextPtr        ///< The session.
+)
+{
+    Session_t* sessionPtr = contextPtr;
+
+    ipcStress_ConnectService();
+
+    RunCalls(sessionPtr);
+
+    if (NumEvents > 0)
+    {
+        RunEvents(sessionPtr);
+    }
+
+    RunFds(sessionPtr);
+    RunOpens(sessionPtr);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer to a file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteAll
+(
+    int fd,
+    const void* bufPtr,
+    size_t size
+)
+{
+    const uint8_t* posPtr = bufPtr;
+
+    while (size > 0)
+    {
+        ssize_t count = write(fd, posPtr, size);
+
+        if (count < 0)
+        {
+            LE_FATAL_IF(errno != EINTR, "Failed to write results (%m).");
+            continue;
+        }
+
+        posPtr += count;
+        size -= count;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a whole buffer from a file descriptor.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT if the end of the file was reached first, or reading failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadAll
+(
+    int fd,
+    void* bufPtr,
+    size_t size
+)
+{
+    uint8_t* posPtr = bufPtr;
+
+    while (size > 0)
+    {
+        ssize_t count = read(fd, posPtr, size);
+
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LE_ERROR("Failed to read results (%m).");
+            return LE_FAULT;
+        }
+        if (count == 0)
+        {
+            return LE_FAULT;
+        }
+
+        posPtr += count;
+        size -= count;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the sessions of a client process, and write their results to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunWorker
+(
+    void
+)
+{
+    Session_t* sessions = calloc(NumSessions, sizeof(Session_t));
+    le_thread_Ref_t threads[MAX_SESSIONS];
+    Results_t* resultsPtr = calloc(1, sizeof(Results_t));
+    int i;
+
+    LE_ASSERT((sessions != NULL) && (resultsPtr != NULL));
+    LE_ASSERT(pthread_barrier_init(&EventBarrier, NULL, NumSessions) == 0);
+
+    for (i = 0; i < NumSessions; i++)
+    {
+        char name[32];
+
+        sessions[i].seed = ((uint32_t)getpid() << 8) | i;
+        sessions[i].originId = sessions[i].seed;
+
+        snprintf(name, sizeof(name), "session%d", i);
+        threads[i] = le_thread_Create(name, SessionMain, &sessions[i]);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+    }
+
+    for (i = 0; i < NumSessions; i++)
+    {
+        LE_ASSERT(le_thread_Join(threads[i], NULL) == LE_OK);
+        MergeResults(resultsPtr, &sessions[i].results);
+    }
+
+    WriteAll(STDOUT_FILENO, resultsPtr, sizeof(*resultsPtr));
+
+    free(resultsPtr);
+    free(sessions);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the client processes, then gather and print their results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunClients
+(
+    void
+)
+{
+    size_t numArgs = le_arg_NumArgs();
+    char* argv[numArgs + 3];
+    int fds[MAX_CLIENTS];
+    pid_t pids[MAX_CLIENTS];
+    Results_t* totalPtr = calloc(1, sizeof(Results_t));
+    Results_t* resultsPtr = calloc(1, sizeof(Results_t));
+    bool isOk = true;
+    size_t i;
+    int c;
+
+    LE_ASSERT((totalPtr != NULL) && (resultsPtr != NULL));
+
+    // The client processes get the same options, plus --worker.
+    argv[0] = (char*)le_arg_GetProgramName();
+    for (i = 0; i < numArgs; i++)
+    {
+        argv[i + 1] = (char*)le_arg_GetArg(i);
+    }
+    argv[numArgs + 1] = "--worker";
+    argv[numArgs + 2] = NULL;
+
+    for (c = 0; c < NumClients; c++)
+    {
+        int pipeFds[2];
+
+        LE_FATAL_IF(pipe2(pipeFds, O_CLOEXEC) != 0, "Failed to create pipe (%m).");
+
+        pids[c] = fork();
+        LE_FATAL_IF(pids[c] < 0, "Failed to fork (%m).");
+
+        if (pids[c] == 0)
+        {
+            if (dup2(pipeFds[1], STDOUT_FILENO) < 0)
+            {
+                _exit(EXIT_FAILURE);
+            }
+            execv("/proc/self/exe", argv);
+            _exit(EXIT_FAILURE);
+        }
+
+        close(pipeFds[1]);
+        fds[c] = pipeFds[0];
+    }
+
+    for (c = 0; c < NumClients; c++)
+    {
+        int status;
+
+        if (ReadAll(fds[c], resultsPtr, sizeof(*resultsPtr)) == LE_OK)
+        {
+            MergeResults(totalPtr, resultsPtr);
+        }
+        else
+        {
+            LE_ERROR("Client process %d didn't report its results.", c);
+            isOk = false;
+        }
+        close(fds[c]);
+
+        LE_FATAL_IF(waitpid(pids[c], &status, 0) != pids[c], "waitpid() failed (%m).");
+        if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+        {
+            LE_ERROR("Client process %d failed (status 0x%x).", c, status);
+            isOk = false;
+        }
+    }
+
+    for (i = 0; i < NumPayloads; i++)
+    {
+        Report("ipc.sync", PayloadSizes[i], &totalPtr->sync[i]);
+        Report("ipc.async", PayloadSizes[i], &totalPtr->async[i]);
+    }
+    Report("ipc.event", 0, &totalPtr->event);
+    Report("ipc.fd", 0, &totalPtr->fd);
+    Report("ipc.sessionOpen", 0, &totalPtr->open);
+
+    free(resultsPtr);
+    free(totalPtr);
+
+    exit(isOk ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the list of payload sizes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParsePayloads
+(
+    void
+)
+{
+    const char* posPtr = PayloadsStr;
+
+    while (*posPtr != '\0')
+    {
+        char* endPtr;
+        unsigned long size = strtoul(posPtr, &endPtr, 10);
+
+        LE_FATAL_IF((endPtr == posPtr) || ((*endPtr != ',') && (*endPtr != '\0')),
+                    "Invalid payload sizes '%s'.", PayloadsStr);
+        LE_FATAL_IF((size == 0) || (size > IPCSTRESS_MAX_PAYLOAD_BYTES),
+                    "Payload sizes must be from 1 to %d bytes.", IPCSTRESS_MAX_PAYLOAD_BYTES);
+        LE_FATAL_IF(NumPayloads >= MAX_PAYLOADS, "No more than %d payload sizes.", MAX_PAYLOADS);
+
+        PayloadSizes[NumPayloads++] = size;
+
+        posPtr = (*endPtr == ',') ? endPtr + 1 : endPtr;
+    }
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetIntVar(&NumClients, NULL, "clients");
+    le_arg_SetIntVar(&NumSessions, NULL, "sessions");
+    le_arg_SetIntVar(&NumCalls, NULL, "calls");
+    le_arg_SetIntVar(&AsyncPercent, NULL, "async");
+    le_arg_SetIntVar(&Window, NULL, "window");
+    le_arg_SetStringVar(&PayloadsStr, NULL, "payloads");
+    le_arg_SetIntVar(&NumEvents, NULL, "events");
+    le_arg_SetIntVar(&NumFds, NULL, "fds");
+    le_arg_SetIntVar(&NumOpens, NULL, "opens");
+    le_arg_SetFlagVar(&IsQuick, "q", "quick");
+    le_arg_SetFlagVar(&IsWorker, NULL, "worker");
+    le_arg_Scan();
+
+    LE_FATAL_IF((NumClients < 1) || (NumClients > MAX_CLIENTS),
+                "Number of clients must be from 1 to %d.", MAX_CLIENTS);
+    LE_FATAL_IF((NumSessions < 1) || (NumSessions > MAX_SESSIONS),
+                "Number of sessions must be from 1 to %d.", MAX_SESSIONS);
+    LE_FATAL_IF((Window < 1) || (Window > MAX_WINDOW),
+                "Window must be from 1 to %d.", MAX_WINDOW);
+    LE_FATAL_IF((AsyncPercent < 0) || (AsyncPercent > 100),
+                "Percentage of asynchronous calls must be from 0 to 100.");
+    LE_FATAL_IF((NumCalls < 0) || (NumEvents < 0) || (NumFds < 0) || (NumOpens < 0),
+                "Numbers of calls, events, file descriptors and sessions can't be negative.");
+
+    ParsePayloads();
+
+    if (IsQuick)
+    {
+        NumCalls = (NumCalls + 9) / 10;
+        NumEvents = (NumEvents + 9) / 10;
+        NumFds = (NumFds + 9) / 10;
+        NumOpens = (NumOpens + 9) / 10;
+    }
+
+    if (IsWorker)
+    {
+        RunWorker();
+        exit(EXIT_SUCCESS);
+    }
+
+    RunClients();
+}
@@ -0,0 +1,204 @@
+/**
+ * Implement the IPC stress test API in C.
+ *
+ * Every call is answered as cheaply as possible, so that what the clients measure is the cost of
+ * the IPC itself.  Tick handlers are kept on a list, and each Broadcast() reports its ticks to all
+ * of them, whichever client they belong to.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include <string.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tick handler registered by a client.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t               link;           ///< Link in the subscriber list.
+    ipcStress_TickHandlerFunc_t handlerPtr;     ///< Client's handler.
+    void*                       contextPtr;     ///< Client's context.
+    le_msg_SessionRef_t         sessionRef;     ///< Client's session.
+    ipcStress_TickHandlerRef_t  ref;            ///< Reference given to the client.
+}
+Subscriber_t;
+
+
+static le_mem_PoolRef_t SubscriberPool;                 ///< Pool of subscribers.
+static le_ref_MapRef_t SubscriberRefMap;                ///< References to the subscribers.
+static le_dls_List_t SubscriberList = LE_DLS_LIST_INIT; ///< List of subscribers.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the monotonic clock, which all the processes share.
+ *
+ * @return The current time in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NowNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    LE_FATAL_IF(clock_gettime(CLOCK_MONOTONIC, &ts) != 0, "clock_gettime() failed (%m).");
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a subscriber and free it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteSubscriber
+(
+    Subscriber_t* subscriberPtr
+)
+{
+    le_dls_Remove(&SubscriberList, &subscriberPtr->link);
+    le_ref_DeleteRef(SubscriberRefMap, subscriberPtr->ref);
+    le_mem_Release(subscriberPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the subscribers of a client whose session has closed (e.g., because it was killed).
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SubscriberList);
+
+    while (linkPtr != NULL)
+    {
+        Subscriber_t* subscriberPtr = CONTAINER_OF(linkPtr, Subscriber_t, link);
+
+        linkPtr = le_dls_PeekNext(&SubscriberList, linkPtr);
+
+        if (subscriberPtr->sessionRef == sessionRef)
+        {
+            DeleteSubscriber(subscriberPtr);
+        }
+    }
+}
+
+
+void ipcStress_Echo
+(
+    const uint8_t* InDataPtr,
+    size_t InDataSize,
+    uint8_t* OutDataPtr,
+    size_t* OutDataSizePtr
+)
+{
+    if (InDataSize > *OutDataSizePtr)
+    {
+        InDataSize = *OutDataSizePtr;
+    }
+
+    memcpy(OutDataPtr, InDataPtr, InDataSize);
+    *OutDataSizePtr = InDataSize;
+}
+
+void ipcStress_EchoAsync
+(
+    uint32_t Seq,
+    const uint8_t* DataPtr,
+    size_t DataSize,
+    ipcStress_EchoDoneHandlerFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    handlerPtr(Seq, DataPtr, DataSize, contextPtr);
+}
+
+ipcStress_TickHandlerRef_t ipcStress_AddTickHandler
+(
+    ipcStress_TickHandlerFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    Subscriber_t* subscriberPtr = le_mem_ForceAlloc(SubscriberPool);
+
+    subscriberPtr->link = LE_DLS_LINK_INIT;
+    subscriberPtr->handlerPtr = handlerPtr;
+    subscriberPtr->contextPtr = contextPtr;
+    subscriberPtr->sessionRef = ipcStress_GetClientSessionRef();
+    subscriberPtr->ref = le_ref_CreateRef(SubscriberRefMap, subscriberPtr);
+
+    le_dls_Queue(&SubscriberList, &subscriberPtr->link);
+
+    return subscriberPtr->ref;
+}
+
+void ipcStress_RemoveTickHandler
+(
+    ipcStress_TickHandlerRef_t handlerRef
+)
+{
+    Subscriber_t* subscriberPtr = le_ref_Lookup(SubscriberRefMap, handlerRef);
+
+    if (subscriberPtr == NULL)
+    {
+        LE_ERROR("Invalid tick handler reference %p.", handlerRef);
+        return;
+    }
+
+    DeleteSubscriber(subscriberPtr);
+}
+
+void ipcStress_Broadcast
+(
+    uint32_t OriginId,
+    uint32_t Count
+)
+{
+    uint32_t seq;
+
+    for (seq = 0; seq < Count; seq++)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&SubscriberList);
+
+        while (linkPtr != NULL)
+        {
+            Subscriber_t* subscriberPtr = CONTAINER_OF(linkPtr, Subscriber_t, link);
+
+            subscriberPtr->handlerPtr(OriginId, seq, NowNs(), subscriberPtr->contextPtr);
+
+            linkPtr = le_dls_PeekNext(&SubscriberList, linkPtr);
+        }
+    }
+}
+
+void ipcStress_PassFile
+(
+    int InFd,
+    int* OutFdPtr
+)
+{
+    // Hand the received file descriptor straight back; it is closed once it has been sent.
+    *OutFdPtr = InFd;
+}
+
+COMPONENT_INIT
+{
+    SubscriberPool = le_mem_CreatePool("TickSubscribers", sizeof(Subscriber_t));
+    SubscriberRefMap = le_ref_CreateMap("TickSubscribers", 64);
+
+    le_msg_AddServiceCloseHandler(ipcStress_GetServiceRef(), SessionCloseHandler, NULL);
+}
@@ -10,6 +10,7 @@
 #include "interfaces.h"
 #include "le_cfg_simu.h"
 #include "le_ecall_local.h"
+#include "asn1Msd.h"
 #include "le_mcc_local.h"
 #include "pa_mcc_simu.h"
 #include "log.h"
@@ -861,7 +862,12 @@ static void Testle_ecall_StartTest
 
     LE_ASSERT(le_ecall_SetMsdPassengersCount(testECallRef, 3) == LE_OK);
 
+    // Pre-stage the session, the position is still updated in hot standby.
+    LE_ASSERT(le_ecall_SetHotStandby(testECallRef, true) == LE_OK);
+    LE_ASSERT(le_ecall_SetMsdPosition(testECallRef, true, +48898070, +2218090, 0) == LE_OK);
+
     LE_ASSERT(le_ecall_StartTest(testECallRef) == LE_OK);
+    LE_ASSERT(le_ecall_SetHotStandby(testECallRef, false) == LE_OK);
 
     LE_ASSERT(le_ecall_StartManual(testECallRef) == LE_BUSY);
     LE_ASSERT(le_ecall_StartAutomatic(testECallRef) == LE_BUSY);
@@ -904,6 +910,93 @@ static void* UnitTestInit
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: Encode an MSD with and without its pre-encoded static part, and measure the encoding
+ * latency.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_ecall_EncodeMsd
+(
+    void
+)
+{
+    const int numEncodes = 10000;
+    msd_t msd;
+    msd_StaticPart_t staticPart;
+    uint8_t fullMsd[LE_ECALL_MSD_MAX_LEN];
+    uint8_t fastMsd[LE_ECALL_MSD_MAX_LEN];
+    int32_t fullLen;
+    le_clk_Time_t startTime;
+    le_clk_Time_t fullTime;
+    le_clk_Time_t fastTime;
+    int i;
+
+    LE_INFO("Start Testle_ecall_EncodeMsd");
+
+    memset(&msd, 0, sizeof(msd));
+    msd.version = 2;
+    memcpy(&msd.msdMsg.msdStruct.vehIdentificationNumber, "WM9VDSVDSYA123456",
+           sizeof(msd.msdMsg.msdStruct.vehIdentificationNumber));
+    msd.msdMsg.msdStruct.control.vehType = MSD_VEHICLE_PASSENGER_M1;
+    msd.msdMsg.msdStruct.control.automaticActivation = true;
+    msd.msdMsg.msdStruct.vehPropulsionStorageType.gasolineTankPresent = true;
+    msd.msdMsg.msdStruct.vehPropulsionStorageType.otherStorage = true;
+    msd.msdMsg.msdStruct.timestamp = 1370346024;
+    msd.msdMsg.msdStruct.vehLocation.latitude = 48898064;
+    msd.msdMsg.msdStruct.vehLocation.longitude = 2218092;
+    msd.msdMsg.msdStruct.recentVehLocationN1Pres = true;
+    msd.msdMsg.msdStruct.recentVehLocationN1.latitudeDelta = 511;
+    msd.msdMsg.msdStruct.recentVehLocationN1.longitudeDelta = -512;
+    msd.msdMsg.msdStruct.numberOfPassengersPres = true;
+    msd.msdMsg.msdStruct.numberOfPassengers = 3;
+
+    LE_ASSERT(msd_EncodeStaticPart(&msd, &staticPart) == LE_OK);
+
+    // The pre-encoded static part gives the same MSD as a full encoding.
+    LE_ASSERT((fullLen = msd_EncodeMsdMessage(&msd, fullMsd)) > 0);
+    LE_ASSERT(msd_EncodeMsdMessageWithStaticPart(&msd, &staticPart, fastMsd) == fullLen);
+    LE_ASSERT(memcmp(fullMsd, fastMsd, fullLen) == 0);
+    LE_ASSERT(fullMsd[1] == fullLen - 2);
+
+    // An outdated static part isn't used.
+    msd.msdMsg.msdStruct.vehIdentificationNumber.isovisSeqPlant[6] = '7';
+    LE_ASSERT((fullLen = msd_EncodeMsdMessage(&msd, fullMsd)) > 0);
+    LE_ASSERT(msd_EncodeMsdMessageWithStaticPart(&msd, &staticPart, fastMsd) == fullLen);
+    LE_ASSERT(memcmp(fullMsd, fastMsd, fullLen) == 0);
+    LE_ASSERT(msd_EncodeStaticPart(&msd, &staticPart) == LE_OK);
+
+    // Invalid settings are still rejected.
+    msd.msdMsg.msdStruct.vehIdentificationNumber.isowmi[0] = 'I';
+    LE_ASSERT(msd_EncodeMsdMessageWithStaticPart(&msd, &staticPart, fastMsd) == LE_FAULT);
+    msd.msdMsg.msdStruct.vehIdentificationNumber.isowmi[0] = 'W';
+    msd.msdMsg.msdStruct.vehDirection = 180;
+    LE_ASSERT(msd_EncodeMsdMessageWithStaticPart(&msd, &staticPart, fastMsd) == LE_FAULT);
+    msd.msdMsg.msdStruct.vehDirection = 45;
+
+    // Encoding latency.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < numEncodes; i++)
+    {
+        msd.msdMsg.msdStruct.timestamp++;
+        LE_ASSERT(msd_EncodeMsdMessage(&msd, fullMsd) > 0);
+    }
+    fullTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < numEncodes; i++)
+    {
+        msd.msdMsg.msdStruct.timestamp++;
+        LE_ASSERT(msd_EncodeMsdMessageWithStaticPart(&msd, &staticPart, fastMsd) > 0);
+    }
+    fastTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    LE_INFO("MSD encoding: %.3f us (full), %.3f us (with pre-encoded static part)",
+            (fullTime.sec * 1000000.0 + fullTime.usec) / numEncodes,
+            (fastTime.sec * 1000000.0 + fastTime.usec) / numEncodes);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -931,6 +1024,8 @@ COMPONENT_INIT
     Testle_ecall_EraGlonassSettings();
     LE_INFO("======== LoadMsd Test  ========");
     Testle_ecall_LoadMsd();
+    LE_INFO("======== EncodeMsd Test  ========");
+    Testle_ecall_EncodeMsd();
     LE_INFO("======== StartManual Test  ========");
     Testle_ecall_StartManual();
     LE_INFO("======== StartTest Test  ========");
@@ -10,6 +10,7 @@
 #include "pa_simu.h"
 #include "pa_info_simu.h"
 #include "sysResets.h"
+#include "le_info_local.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -125,6 +126,8 @@ COMPONENT_INIT
     LE_INFO("le_info_GetBootloaderVersion get => %s", BootLoaderVersion);
     LE_ASSERT(le_info_GetBootloaderVersion(BootLoaderVersion, 2) == LE_OVERFLOW);
     LE_ASSERT_OK(le_info_GetBootloaderVersion(BootLoaderVersion, sizeof(BootLoaderVersion)));
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_NOT_FOUND);
     LE_ASSERT(le_info_GetBootloaderVersion
                              (BootLoaderVersion, sizeof(BootLoaderVersion)) == LE_NOT_FOUND);
@@ -137,6 +140,8 @@ COMPONENT_INIT
     LE_INFO("le_info_GetFirmwareVersion get => %s", FirmwareVersion);
     LE_ASSERT(le_info_GetFirmwareVersion(FirmwareVersion, 2) == LE_OVERFLOW);
     LE_ASSERT_OK(le_info_GetFirmwareVersion(FirmwareVersion,sizeof(FirmwareVersion)));
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_NOT_FOUND);
     LE_ASSERT(le_info_GetFirmwareVersion(FirmwareVersion, sizeof(FirmwareVersion)) == LE_NOT_FOUND);
     pa_infoSimu_ResetErrorCase();
@@ -152,6 +157,8 @@ COMPONENT_INIT
     LE_INFO("le_info_GetMeid get => %s", Meid);
     LE_ASSERT(le_info_GetMeid(Meid, 1) == LE_OVERFLOW);
     // set error case LE_FAULT
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetMeid(Meid, sizeof(Meid)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -160,6 +167,8 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetEsn(Esn, sizeof(Esn)));
     LE_INFO("le_info_GetEsn get => %s", Esn);
     LE_ASSERT(le_info_GetEsn(Esn, 1) == LE_OVERFLOW);
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetEsn(Esn, sizeof(Esn)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -196,6 +205,8 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetManufacturerName(MfrName, sizeof(MfrName)));
     LE_INFO("le_info_GetManufacturerName get => %s", MfrName);
     LE_ASSERT(le_info_GetManufacturerName(MfrName, 1) == LE_OVERFLOW);
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetManufacturerName(MfrName, sizeof(MfrName)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -213,6 +224,8 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetSku(Sku, sizeof(Sku)));
     LE_INFO("le_info_GetSku get => %s", Sku);
     LE_ASSERT(le_info_GetSku(Sku, 1) == LE_OVERFLOW);
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetSku(Sku, sizeof(Sku)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -221,6 +234,8 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)));
     LE_INFO("le_info_GetPlatformSerialNumber get => %s", Psn);
     LE_ASSERT(le_info_GetPlatformSerialNumber(Psn, 1) == LE_OVERFLOW);
+    // The identifier is cached, drop it to read it from the PA again.
+    le_info_InvalidateCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -251,6 +266,51 @@ COMPONENT_INIT
     LE_ASSERT(LE_INFO_RESET_UPDATE == ResetInformation);
     LE_ASSERT(0 == memcmp(ResetStr,PA_SPECIFIC_REASON_SWAP, strlen(PA_SPECIFIC_REASON_SWAP)));
 
+    LE_INFO("======== CacheTest ========");
+    static char newImei[LE_INFO_IMEI_MAX_BYTES] = "271828182845904";
+    static char oldImei[LE_INFO_IMEI_MAX_BYTES] = "314159265300979";
+    char imei[LE_INFO_IMEI_MAX_BYTES];
+    pa_infoSimu_SetImei(oldImei);
+    le_info_InvalidateCache();
+    LE_ASSERT_OK(le_info_GetImei(imei, sizeof(imei)));
+    LE_ASSERT(0 == strcmp(imei, oldImei));
+    // The cached IMEI is returned until the cache is dropped.
+    pa_infoSimu_SetImei(newImei);
+    LE_ASSERT_OK(le_info_GetImei(imei, sizeof(imei)));
+    LE_ASSERT(0 == strcmp(imei, oldImei));
+    le_info_InvalidateCache();
+    LE_ASSERT_OK(le_info_GetImei(imei, sizeof(imei)));
+    LE_ASSERT(0 == strcmp(imei, newImei));
+
+    LE_INFO("======== GetDeviceInfoTest ========");
+    char imeiSv[LE_INFO_IMEISV_MAX_BYTES];
+    char firmwareVersion[LE_INFO_MAX_VERS_BYTES];
+    char bootloaderVersion[LE_INFO_MAX_VERS_BYTES];
+    char model[LE_INFO_MAX_MODEL_BYTES];
+    char mfrName[LE_INFO_MAX_MFR_NAME_BYTES];
+    char sku[LE_INFO_MAX_SKU_BYTES];
+    char psn[LE_INFO_MAX_PSN_BYTES];
+    LE_ASSERT_OK(le_info_GetDeviceInfo(imei, sizeof(imei), imeiSv, sizeof(imeiSv),
+                                       firmwareVersion, sizeof(firmwareVersion),
+                                       bootloaderVersion, sizeof(bootloaderVersion),
+                                       model, sizeof(model), mfrName, sizeof(mfrName),
+                                       sku, sizeof(sku), psn, sizeof(psn)));
+    LE_ASSERT(0 == strcmp(imei, newImei));
+    LE_ASSERT(le_info_GetDeviceInfo(imei, sizeof(imei), imeiSv, sizeof(imeiSv),
+                                    firmwareVersion, sizeof(firmwareVersion),
+                                    bootloaderVersion, sizeof(bootloaderVersion),
+                                    model, 1, mfrName, sizeof(mfrName),
+                                    sku, sizeof(sku), psn, sizeof(psn)) == LE_OVERFLOW);
+    le_info_InvalidateCache();
+    pa_infoSimu_SetErrorCase(LE_FAULT);
+    LE_ASSERT(le_info_GetDeviceInfo(imei, sizeof(imei), imeiSv, sizeof(imeiSv),
+                                    firmwareVersion, sizeof(firmwareVersion),
+                                    bootloaderVersion, sizeof(bootloaderVersion),
+                                    model, sizeof(model), mfrName, sizeof(mfrName),
+                                    sku, sizeof(sku), psn, sizeof(psn)) == LE_FAULT);
+    LE_ASSERT('\0' == psn[0]);
+    pa_infoSimu_ResetErrorCase();
+
     LE_INFO("======== INFO API UnitTests OK ========");
     exit(0);
 }
@@ -71,6 +71,13 @@ static char mncHomeStr[LE_MRC_MCC_BYTES] = {0};
 //--------------------------------------------------------------------------------------------------
 static le_mrc_SignalStrengthChangeHandlerRef_t SignalHdlrRef = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal Metrics handler reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mrc_SignalMetricsHandlerRef_t SignalMetricsHdlrRef = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function for RAT change Notifications.
@@ -1192,6 +1199,40 @@ static void Testle_mrc_GetNeighboringCellsInfo()
 
         le_mrc_DeleteNeighborCellsInfo(ngbrRef);
     }
+
+    // The same information, at once.
+    uint32_t cidTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    uint32_t lacTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t rxLevelTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    le_mrc_Rat_t ratTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t ecioTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t intraRsrqTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t intraRsrpTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t interRsrqTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    int32_t interRsrpTable[LE_MRC_MAX_NEIGHBOR_CELLS];
+    size_t cidNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t lacNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t rxLevelNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t ratNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t ecioNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t intraRsrqNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t intraRsrpNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t interRsrqNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+    size_t interRsrpNb = LE_MRC_MAX_NEIGHBOR_CELLS;
+
+    res = le_mrc_GetNeighborCellsTable(0, cidTable, &cidNb, lacTable, &lacNb,
+                                       rxLevelTable, &rxLevelNb, ratTable, &ratNb,
+                                       ecioTable, &ecioNb, intraRsrqTable, &intraRsrqNb,
+                                       intraRsrpTable, &intraRsrpNb, interRsrqTable, &interRsrqNb,
+                                       interRsrpTable, &interRsrpNb);
+    LE_ASSERT(res == LE_OK);
+    LE_ASSERT((cidNb > 0) && (cidNb == lacNb) && (cidNb == ratNb) && (cidNb == interRsrpNb));
+
+    for (i = 0; i < cidNb; i++)
+    {
+        LE_INFO("Cell #%d, cid.%d, lac.%d, rxLevel.%ddBm, RAT.%d",
+                i, cidTable[i], lacTable[i], rxLevelTable[i], ratTable[i]);
+    }
 }
 //! [Neighbor Cells]
 
@@ -1487,6 +1528,89 @@ static void Testle_mrc_SetSignalStrengthIndDelta
     LE_ASSERT_OK(le_thread_Join(SignalStrengthChangeThreadRef,NULL));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for Signal Metrics Notifications.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSignalMetricsHandler
+(
+    le_mrc_Rat_t rat,
+    int32_t      ss,
+    uint32_t     er,
+    int32_t      ecio,
+    int32_t      rscp,
+    int32_t      rsrq,
+    int32_t      rsrp,
+    int32_t      sinr,
+    void*        contextPtr
+)
+{
+    LE_INFO("New Signal Metrics: RAT.%d, ss.%ddBm, er.%u, ecio.%d, rscp.%d, rsrq.%d, rsrp.%d, "
+            "sinr.%d", rat, ss, er, ecio, rscp, rsrq, rsrp, sinr);
+    LE_ASSERT(LE_MRC_RAT_UNKNOWN != rat);
+    le_sem_Post(ThreadSemaphore);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread for test Signal Metrics subscription.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* MySignalMetricsThread
+(
+    void* context   ///< Context
+)
+{
+    le_mrc_ConnectService();
+
+    // Every second, whatever the signal strength change.
+    SignalMetricsHdlrRef = le_mrc_AddSignalMetricsHandler(1000, 0, TestSignalMetricsHandler, NULL);
+    LE_ASSERT(SignalMetricsHdlrRef);
+
+    le_sem_Post(ThreadSemaphore);
+
+    le_event_RunLoop();
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: Signal Metrics subscription.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void Testle_mrc_SignalMetricsHdlr
+(
+    void
+)
+{
+    le_clk_Time_t time1 = {10, 0};
+    le_thread_Ref_t threadRef;
+
+    // Init the semaphore for asynchronous callback
+    ThreadSemaphore = le_sem_Create("HandlerSignalMetrics", 0);
+
+    threadRef = le_thread_Create("ThreadSignalMetrics", MySignalMetricsThread, NULL);
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    // Wait for complete asynchronous registration
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, time1));
+
+    // Wait for two reports
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, time1));
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, time1));
+
+    le_mrc_RemoveSignalMetricsHandler(SignalMetricsHdlrRef);
+
+    LE_ASSERT_OK(le_thread_Cancel(threadRef));
+    LE_ASSERT_OK(le_thread_Join(threadRef, NULL));
+    le_sem_Delete(ThreadSemaphore);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test: Signal Strength change handling.
@@ -1906,6 +2030,10 @@ COMPONENT_INIT
     Testle_mrc_SetSignalStrengthIndDelta();
     LE_INFO("======== Set Signal Strength delta Test PASSED ========");
 
+    LE_INFO("======== Signal Metrics subscription Test ========");
+    Testle_mrc_SignalMetricsHdlr();
+    LE_INFO("======== Signal Metrics subscription Test PASSED ========");
+
     LE_INFO("======== RatPreferences Test ========");
     Testle_mrc_RatPreferences();
     LE_INFO("======== RatPreferences Test PASSED ========");
@@ -319,6 +319,25 @@ static void PositionHandlerFunction
         LE_INFO("Position unknown [%d,%d,%d]", latitude, longitude, hAccuracy);
     }
 
+    // Get the main position data in one call, which must match the separate getters
+    {
+        le_gnss_FixState_t fixState;
+        int32_t fixLatitude;
+        int32_t fixLongitude;
+        int32_t fixHAccuracy;
+        uint64_t fixEpochTime;
+
+        result = le_gnss_GetPositionFix(positionSampleRef, &fixState, &fixLatitude, &fixLongitude,
+                                        &fixHAccuracy, NULL, NULL, NULL, NULL, NULL,
+                                        &fixEpochTime, NULL, NULL);
+        LE_ASSERT((LE_OK == result)||(LE_OUT_OF_RANGE == result));
+        LE_ASSERT(fixState == state);
+        LE_ASSERT(fixLatitude == latitude);
+        LE_ASSERT(fixLongitude == longitude);
+        LE_ASSERT(fixHAccuracy == hAccuracy);
+        LE_ASSERT(fixEpochTime == EpochTime);
+    }
+
     // Get altitude
     result = le_gnss_GetAltitude( positionSampleRef, &altitude, &vAccuracy);
     LE_ASSERT((LE_OK == result)||(LE_OUT_OF_RANGE == result));
@@ -524,6 +543,9 @@ static void TestLeGnssPositionHandler
     le_gnss_SampleRef_t positionSampleRef;
     uint64_t epochTime;
     uint32_t ttff = 0;
+    uint32_t averageTtff;
+    uint32_t fixCount;
+    bool     assisted;
     uint8_t  minElevation;
 
     LE_INFO("Start Test Testle_gnss_PositionHandlerTest");
@@ -576,6 +598,15 @@ static void TestLeGnssPositionHandler
         LE_INFO("TTFF cold restart not available");
     }
 
+    // TTFF of the starts, measured by the positioning service
+    result = le_gnss_GetTtffStats(&ttff, &assisted, &fixCount, &averageTtff);
+    LE_ASSERT((LE_OK == result)||(LE_BUSY == result));
+    if(result == LE_OK)
+    {
+        LE_INFO("TTFF last start = %d msec (%s), average = %d msec over %d starts",
+                ttff, assisted ? "assisted" : "unassisted", averageTtff, fixCount);
+    }
+
     le_gnss_RemovePositionHandler(PositionHandlerRef);
 
     LE_INFO("Wait 5 seconds");
@@ -1038,6 +1069,12 @@ static void TestLeGnssNmeaSentences
         LE_ASSERT_OK(le_gnss_GetNmeaSentences(&nmeaMask));
         LE_ASSERT(nmeaMask == nmeaSentencesList[i]);
     }
+
+    // Test 3: NMEA flow statistics
+    uint32_t writtenCount, droppedCount, bufferedCount;
+    LE_ASSERT_OK(le_gnss_GetNmeaStats(&writtenCount, &droppedCount, &bufferedCount));
+    LE_INFO("NMEA sentences: %u written, %u dropped, %u buffered",
+            writtenCount, droppedCount, bufferedCount);
 }
 
 //--------------------------------------------------------------------------------------------------
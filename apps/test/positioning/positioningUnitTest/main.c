@@ -536,6 +536,185 @@ static void Test_le_pos_GetFixState
     LE_ASSERT((state == LE_POS_STATE_FIX_ESTIMATED) && (result == LE_OK));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Movement handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MovementHandler
+(
+    le_pos_SampleRef_t positionSampleRef,
+    void* contextPtr
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tested API: le_pos_AddMovementHandler(), le_pos_RemoveMovementHandler()
+ *
+ * Verify that the GNSS acquisition rate follows the fastest movement handler.  Queued to run after
+ * the positioning component is initialized.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_MovementHandlerRates
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_pos_MovementHandlerRef_t slowHandlerRef;
+    le_pos_MovementHandlerRef_t fastHandlerRef;
+    uint32_t rate;
+
+    LE_ASSERT(NULL != le_posCtrl_Request());
+
+    // 100 meters take 8 seconds at the supposed average speed
+    slowHandlerRef = le_pos_AddMovementHandler(100, 0, MovementHandler, NULL);
+    LE_ASSERT(NULL != slowHandlerRef);
+    LE_ASSERT_OK(le_gnss_GetAcquisitionRate(&rate));
+    LE_ASSERT(8000 == rate);
+
+    // 10 meters take less than a second
+    fastHandlerRef = le_pos_AddMovementHandler(10, 10, MovementHandler, NULL);
+    LE_ASSERT(NULL != fastHandlerRef);
+    LE_ASSERT_OK(le_gnss_GetAcquisitionRate(&rate));
+    LE_ASSERT(1000 == rate);
+
+    // The GNSS device slows down when the fast handler is removed
+    le_pos_RemoveMovementHandler(fastHandlerRef);
+    LE_ASSERT_OK(le_gnss_GetAcquisitionRate(&rate));
+    LE_ASSERT(8000 == rate);
+
+    le_pos_RemoveMovementHandler(slowHandlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last geofence transitions reported, and their number.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_TRANSITIONS 4
+static le_pos_FenceRef_t FenceTransitionRefs[MAX_TRANSITIONS];
+static le_pos_FenceTransition_t FenceTransitions[MAX_TRANSITIONS];
+static int NumOfTransitions;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Geofence handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void GeofenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceTransition_t transition,
+    void* contextPtr
+)
+{
+    LE_ASSERT(NumOfTransitions < MAX_TRANSITIONS);
+
+    FenceTransitionRefs[NumOfTransitions] = fenceRef;
+    FenceTransitions[NumOfTransitions] = transition;
+    NumOfTransitions++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a simulated position fix to the positioning service.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportFix
+(
+    int32_t latitude,
+    int32_t longitude,
+    int32_t accuracy
+)
+{
+    gnssSimuLocation_t gnssLocation;
+
+    gnssLocation.latitude = latitude;
+    gnssLocation.longitude = longitude;
+    gnssLocation.accuracy = accuracy;
+    gnssLocation.result = LE_OK;
+    le_gnssSimu_SetLocation(gnssLocation);
+
+    NumOfTransitions = 0;
+    le_gnssSimu_ReportPosition();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tested API: le_pos_CreateFence(), le_pos_DeleteFence(), le_pos_AddGeofenceHandler(),
+ * le_pos_RemoveGeofenceHandler()
+ *
+ * Verify that the fences around the fixes are entered and exited, wherever they are in the index.
+ * Queued to run after the positioning component is initialized.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_Geofence
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_pos_GeofenceHandlerRef_t handlerRef;
+    le_pos_FenceRef_t smallFenceRef;
+    le_pos_FenceRef_t farFenceRef;
+    le_pos_FenceRef_t wideFenceRef;
+
+    handlerRef = le_pos_AddGeofenceHandler(GeofenceHandler, NULL);
+    LE_ASSERT(NULL != handlerRef);
+
+    // A 100 m fence, a fence in another cell, and a fence too big for the grid
+    smallFenceRef = le_pos_CreateFence(48820000, 2260000, 100, 0);
+    LE_ASSERT(NULL != smallFenceRef);
+    farFenceRef = le_pos_CreateFence(45000000, 5000000, 1000, 0);
+    LE_ASSERT(NULL != farFenceRef);
+    wideFenceRef = le_pos_CreateFence(48000000, 2000000, 500000, 0);
+    LE_ASSERT(NULL != wideFenceRef);
+
+    // The small and wide fences are entered
+    ReportFix(48820000, 2260000, 1000);
+    LE_ASSERT(2 == NumOfTransitions);
+    LE_ASSERT((smallFenceRef == FenceTransitionRefs[0]) &&
+              (LE_POS_FENCE_ENTER == FenceTransitions[0]));
+    LE_ASSERT((wideFenceRef == FenceTransitionRefs[1]) &&
+              (LE_POS_FENCE_ENTER == FenceTransitions[1]));
+
+    // Nothing changes for the next fix
+    ReportFix(48820100, 2260000, 1000);
+    LE_ASSERT(0 == NumOfTransitions);
+
+    // 105 m away from the center is within the accuracy of the fix
+    ReportFix(48820943, 2260000, 1000);
+    LE_ASSERT(0 == NumOfTransitions);
+
+    // 150 m away from the center, the small fence is exited
+    ReportFix(48821348, 2260000, 1000);
+    LE_ASSERT(1 == NumOfTransitions);
+    LE_ASSERT((smallFenceRef == FenceTransitionRefs[0]) &&
+              (LE_POS_FENCE_EXIT == FenceTransitions[0]));
+
+    // No transitions are reported for deleted fences
+    le_pos_DeleteFence(wideFenceRef);
+    ReportFix(45000000, 5000000, 1000);
+    LE_ASSERT(1 == NumOfTransitions);
+    LE_ASSERT((farFenceRef == FenceTransitionRefs[0]) &&
+              (LE_POS_FENCE_ENTER == FenceTransitions[0]));
+
+    le_pos_DeleteFence(farFenceRef);
+    le_pos_DeleteFence(smallFenceRef);
+    le_pos_RemoveGeofenceHandler(handlerRef);
+
+    exit(0);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -560,5 +739,6 @@ COMPONENT_INIT
     Test_le_pos_GetTime();
     Test_le_pos_GetFixState();
 
-    exit(0);
+    le_event_QueueFunction(Test_le_pos_MovementHandlerRates, NULL, NULL);
+    le_event_QueueFunction(Test_le_pos_Geofence, NULL, NULL);
 }
@@ -84,6 +84,22 @@ static gnssSimuPositionState_t GnssSimuPositionSate;
 //--------------------------------------------------------------------------------------------------
 static le_gnss_SampleRef_t Sample;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionHandlerFunc_t PositionHandlerPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Acquisition rate in milliseconds
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AcquisitionRate = 1000;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * le_gnssSimu_SetLocation: update simulated location data
@@ -210,6 +226,23 @@ void le_gnssSimu_SetPositionState
     GnssSimuPositionSate = state;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_gnssSimu_ReportPosition: report a position sample to the position handler, if any
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssSimu_ReportPosition
+(
+    void
+)
+{
+    if (PositionHandlerPtr != NULL)
+    {
+        PositionHandlerPtr((le_gnss_SampleRef_t)&GnssLocation, NULL);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the GNSS
@@ -242,7 +275,9 @@ le_gnss_PositionHandlerRef_t le_gnss_AddPositionHandler
     void*                        contextPtr           ///< [IN] The context pointer
 )
 {
-    return NULL;
+    PositionHandlerPtr = handlerPtr;
+
+    return (le_gnss_PositionHandlerRef_t)&PositionHandlerPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -257,6 +292,7 @@ void le_gnss_RemovePositionHandler
     le_gnss_PositionHandlerRef_t    handlerRef ///< [IN] The handler reference.
 )
 {
+    PositionHandlerPtr = NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1336,6 +1372,8 @@ le_result_t le_gnss_SetAcquisitionRate
     uint32_t  rate      ///< Acquisition rate in milliseconds.
 )
 {
+    AcquisitionRate = rate;
+
     return LE_OK;
 }
 
@@ -1354,7 +1392,7 @@ le_result_t le_gnss_GetAcquisitionRate
     uint32_t* ratePtr      ///< Acquisition rate in milliseconds.
 )
 {
-    *ratePtr = 1000;
+    *ratePtr = AcquisitionRate;
 
     return LE_OK;
 }
@@ -134,6 +134,7 @@ void le_gnssSimu_SetVSpeed(gnssSimuVSpeed_t gnssVSpeed);
 void le_gnssSimu_SetTime(gnssSimuTime_t gnssTime);
 void le_gnssSimu_SetSampleRef(le_gnss_SampleRef_t sample);
 void le_gnssSimu_SetPositionState(gnssSimuPositionState_t state);
+void le_gnssSimu_ReportPosition(void);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -272,4 +272,16 @@ void le_cfg_CancelTxn
     le_cfg_IteratorRef_t iteratorRef
         ///< [IN] Iterator object to close.
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the reception of a new SMS message.
+ *
+ * The message is in the message boxes when this returns.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_smsTest_SimulateRxMessage
+(
+    void
+);
 #endif /* interfaces.h */
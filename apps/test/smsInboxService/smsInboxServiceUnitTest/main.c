@@ -27,6 +27,43 @@
 #define MAX_SIMU_PATH_LEN       20
 #define MAX_CMD_ARG             5
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log of the le_smsInbox1 message box, and size of its records ("%c%08x\n").
+ */
+//--------------------------------------------------------------------------------------------------
+#define MBOX1_LOG_PATH          "/tmp/smsInbox/cfg/le_smsInbox1.log"
+#define LOG_RECORD_BYTES        10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the message boxes (not configured by the test), and maximum number of records of a
+ * message box log before it is compacted.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MBOX_SIZE               10
+#define LOG_MAX_RECORDS         ((2 * MBOX_SIZE) + 32)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Argument asking the test to only check the message box it reloads (see ReloadMbox()).
+ */
+//--------------------------------------------------------------------------------------------------
+#define RELOAD_ARG              "reload"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Content of a message box, oldest message first.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;                     ///< Number of messages
+    uint32_t msgIds[MBOX_SIZE];         ///< Message identifiers
+    bool     isUnread[MBOX_SIZE];       ///< Read status of the messages
+}
+Mbox_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Session Reference
@@ -430,6 +467,359 @@ static void Testle_smsInbox_GetSenderTel
 
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the content of the message box by browsing it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetMbox
+(
+    Mbox_t* mboxPtr
+)
+{
+    uint32_t msgId = le_smsInbox1_GetFirst(MyMbx1Ref);
+
+    memset(mboxPtr, 0, sizeof(Mbox_t));
+
+    while (msgId != 0)
+    {
+        LE_ASSERT(mboxPtr->count < MBOX_SIZE);
+        mboxPtr->msgIds[mboxPtr->count] = msgId;
+        mboxPtr->isUnread[mboxPtr->count] = le_smsInbox1_IsUnread(msgId);
+        mboxPtr->count++;
+
+        msgId = le_smsInbox1_GetNext(MyMbx1Ref);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the content of the message box by replaying its log, the way it is reloaded.
+ *
+ * Return:
+ * - Number of records in the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReplayMboxLog
+(
+    Mbox_t* mboxPtr
+)
+{
+    char record[LOG_RECORD_BYTES];
+    uint32_t recordCount = 0;
+    size_t readCount;
+    FILE* filePtr = fopen(MBOX1_LOG_PATH, "r");
+
+    LE_ASSERT(filePtr != NULL);
+    memset(mboxPtr, 0, sizeof(Mbox_t));
+
+    while ((readCount = fread(record, 1, sizeof(record), filePtr)) > 0)
+    {
+        char hexId[9] = {0};
+        char* endPtr;
+        uint32_t i;
+
+        // Records are never partly written
+        LE_ASSERT(readCount == LOG_RECORD_BYTES);
+        LE_ASSERT(record[LOG_RECORD_BYTES - 1] == '\n');
+        memcpy(hexId, &record[1], 8);
+        uint32_t msgId = strtoul(hexId, &endPtr, 16);
+        LE_ASSERT(*endPtr == '\0');
+
+        recordCount++;
+
+        for (i = 0; (i < mboxPtr->count) && (mboxPtr->msgIds[i] != msgId); i++)
+        {
+        }
+
+        switch (record[0])
+        {
+            case '+':
+                if (i == mboxPtr->count)
+                {
+                    LE_ASSERT(mboxPtr->count < MBOX_SIZE);
+                    mboxPtr->msgIds[i] = msgId;
+                    mboxPtr->isUnread[i] = true;
+                    mboxPtr->count++;
+                }
+                break;
+
+            case '-':
+                if (i < mboxPtr->count)
+                {
+                    mboxPtr->count--;
+                    memmove(&mboxPtr->msgIds[i], &mboxPtr->msgIds[i + 1],
+                            (mboxPtr->count - i) * sizeof(mboxPtr->msgIds[0]));
+                    memmove(&mboxPtr->isUnread[i], &mboxPtr->isUnread[i + 1],
+                            (mboxPtr->count - i) * sizeof(mboxPtr->isUnread[0]));
+                }
+                break;
+
+            case 'r':
+            case 'u':
+                if (i < mboxPtr->count)
+                {
+                    mboxPtr->isUnread[i] = (record[0] == 'u');
+                }
+                break;
+
+            default:
+                LE_FATAL("Invalid record '%c' in %s", record[0], MBOX1_LOG_PATH);
+        }
+    }
+
+    fclose(filePtr);
+
+    return recordCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the log holds the content of the message box.
+ *
+ * Return:
+ * - Number of records in the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CheckMboxLog
+(
+    Mbox_t* mboxPtr     ///< [OUT] Content of the message box
+)
+{
+    Mbox_t loggedMbox;
+    uint32_t recordCount = ReplayMboxLog(&loggedMbox);
+
+    GetMbox(mboxPtr);
+
+    LE_ASSERT(loggedMbox.count == mboxPtr->count);
+    LE_ASSERT(memcmp(loggedMbox.msgIds, mboxPtr->msgIds,
+                     mboxPtr->count * sizeof(mboxPtr->msgIds[0])) == 0);
+    LE_ASSERT(memcmp(loggedMbox.isUnread, mboxPtr->isUnread,
+                     mboxPtr->count * sizeof(mboxPtr->isUnread[0])) == 0);
+
+    return recordCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the last record of the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLastRecord
+(
+    char operation,
+    uint32_t msgId
+)
+{
+    char expected[LOG_RECORD_BYTES + 1];
+    char record[LOG_RECORD_BYTES + 1] = {0};
+    struct stat st;
+    int fd = open(MBOX1_LOG_PATH, O_RDONLY);
+
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(fstat(fd, &st) == 0);
+    LE_ASSERT(st.st_size >= LOG_RECORD_BYTES);
+    LE_ASSERT(pread(fd, record, LOG_RECORD_BYTES, st.st_size - LOG_RECORD_BYTES)
+              == LOG_RECORD_BYTES);
+    close(fd);
+
+    snprintf(expected, sizeof(expected), "%c%08x\n", operation, (unsigned int) msgId);
+    LE_ASSERT(strcmp(record, expected) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Toggle the read status of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ToggleRead
+(
+    uint32_t msgId
+)
+{
+    if (le_smsInbox1_IsUnread(msgId))
+    {
+        le_smsInbox1_MarkRead(msgId);
+    }
+    else
+    {
+        le_smsInbox1_MarkUnread(msgId);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reload the message box in a new instance of the test, and check that it has the given content.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReloadMbox
+(
+    const Mbox_t* mboxPtr
+)
+{
+    char args[MBOX_SIZE][10];
+    char* argv[MBOX_SIZE + 3];
+    char exePath[MAX_FILE_PATH_LEN] = {0};
+    uint32_t i;
+    int status;
+
+    LE_ASSERT(readlink("/proc/self/exe", exePath, sizeof(exePath) - 1) > 0);
+
+    argv[0] = exePath;
+    argv[1] = RELOAD_ARG;
+
+    for (i = 0; i < mboxPtr->count; i++)
+    {
+        snprintf(args[i], sizeof(args[i]), "%08x%c", (unsigned int) mboxPtr->msgIds[i],
+                 mboxPtr->isUnread[i] ? 'u' : 'r');
+        argv[i + 2] = args[i];
+    }
+
+    argv[i + 2] = NULL;
+
+    pid_t pid = fork();
+    LE_ASSERT(pid >= 0);
+
+    if (pid == 0)
+    {
+        execv(exePath, argv);
+        LE_FATAL("Unable to run %s: %m", exePath);
+    }
+
+    LE_ASSERT(waitpid(pid, &status, 0) == pid);
+    LE_ASSERT(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the reloaded message box against the content given on the command line (see ReloadMbox()).
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckReloadedMbox
+(
+    void
+)
+{
+    Mbox_t mbox;
+    uint32_t i;
+
+    MyMbx1Ref = le_smsInbox1_Open();
+    LE_ASSERT(MyMbx1Ref != NULL);
+
+    GetMbox(&mbox);
+    LE_ASSERT(mbox.count == le_arg_NumArgs() - 1);
+
+    for (i = 0; i < mbox.count; i++)
+    {
+        const char* argPtr = le_arg_GetArg(i + 1);
+        char* endPtr;
+
+        LE_ASSERT(argPtr != NULL);
+        LE_ASSERT(mbox.msgIds[i] == strtoul(argPtr, &endPtr, 16));
+        LE_ASSERT(mbox.isUnread[i] == (*endPtr == 'u'));
+    }
+
+    le_smsInbox1_Close(MyMbx1Ref);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: Message box log.
+ *
+ * Checks that each change of the message box appends one record to its log, that the oldest
+ * messages are dropped once the message box is full, that the log is compacted once it grows too
+ * big, and that the message box is reloaded from its log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_smsInbox_Log
+(
+    void
+)
+{
+    Mbox_t mbox;
+    uint32_t rxMsgIds[MBOX_SIZE + 2];
+    uint32_t recordCount;
+    uint32_t newRecordCount;
+    uint32_t msgId;
+    uint32_t i;
+
+    recordCount = CheckMboxLog(&mbox);
+    LE_ASSERT(mbox.count > 0);
+
+    // A status change appends a record, setting the same status again doesn't
+    msgId = mbox.msgIds[0];
+    bool isUnread = mbox.isUnread[0];
+    ToggleRead(msgId);
+    LE_ASSERT(CheckMboxLog(&mbox) == recordCount + 1);
+    CheckLastRecord(isUnread ? 'r' : 'u', msgId);
+    LE_ASSERT(mbox.isUnread[0] == !isUnread);
+
+    if (isUnread)
+    {
+        le_smsInbox1_MarkRead(msgId);
+    }
+    else
+    {
+        le_smsInbox1_MarkUnread(msgId);
+    }
+    LE_ASSERT(CheckMboxLog(&mbox) == recordCount + 1);
+
+    // A new message appends a record, and so does its deletion
+    le_smsTest_SimulateRxMessage();
+    LE_ASSERT(CheckMboxLog(&mbox) == recordCount + 2);
+    msgId = mbox.msgIds[mbox.count - 1];
+    LE_ASSERT(mbox.isUnread[mbox.count - 1]);
+    CheckLastRecord('+', msgId);
+
+    le_smsInbox1_DeleteMsg(msgId);
+    LE_ASSERT(CheckMboxLog(&mbox) == recordCount + 3);
+    CheckLastRecord('-', msgId);
+
+    // Wrap around: once the message box is full, the oldest messages are dropped
+    for (i = 0; i < NUM_ARRAY_MEMBERS(rxMsgIds); i++)
+    {
+        le_smsTest_SimulateRxMessage();
+        GetMbox(&mbox);
+        rxMsgIds[i] = mbox.msgIds[mbox.count - 1];
+    }
+
+    recordCount = CheckMboxLog(&mbox);
+    LE_ASSERT(mbox.count == MBOX_SIZE);
+    for (i = 0; i < MBOX_SIZE; i++)
+    {
+        LE_ASSERT(mbox.msgIds[i] == rxMsgIds[i + 2]);
+        LE_ASSERT(mbox.isUnread[i]);
+    }
+
+    ReloadMbox(&mbox);
+
+    // The log is rewritten with the content of the message box only once it grows too big
+    le_smsInbox1_MarkRead(mbox.msgIds[1]);
+    recordCount = CheckMboxLog(&mbox);
+
+    for (i = 0; i < LOG_MAX_RECORDS; i++)
+    {
+        ToggleRead(mbox.msgIds[0]);
+        newRecordCount = CheckMboxLog(&mbox);
+
+        if (newRecordCount <= recordCount)
+        {
+            break;
+        }
+
+        recordCount = newRecordCount;
+    }
+
+    LE_ASSERT(i < LOG_MAX_RECORDS);
+    LE_ASSERT(newRecordCount == MBOX_SIZE + (mbox.isUnread[0] ? 1 : 2));
+
+    // Changes are appended to the compacted log
+    ToggleRead(mbox.msgIds[0]);
+    LE_ASSERT(CheckMboxLog(&mbox) == newRecordCount + 1);
+
+    ReloadMbox(&mbox);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Simulate smsInbox config files
@@ -474,10 +864,20 @@ static void Simulate_smsInbox_msgFileInit
 COMPONENT_INIT
 {
     LE_INFO("======== START UnitTest of SMS INBOX API ========");
-    const char* argString = "";
+    const char* argString = le_arg_GetArg(0);
+
+    if ((NULL != argString) && (strcmp(argString, RELOAD_ARG) == 0))
+    {
+        LE_INFO("======== smsInbox reload test ========");
+        CheckReloadedMbox();
+        exit(EXIT_SUCCESS);
+    }
 
     if (le_arg_NumArgs() >= MAX_CMD_ARG)
     {
+        // Start from empty message boxes, whatever the previous runs left behind
+        system("rm -f" SIMU_CONF_PATH "*" SIMU_MSG_PATH "*");
+
         argString = le_arg_GetArg(0);
         if (NULL == argString)
         {
@@ -565,6 +965,9 @@ COMPONENT_INIT
     LE_INFO("======== smsInbox delete test ========");
     Testle_smsInbox_DeleteMsg();
 
+    LE_INFO("======== smsInbox log test ========");
+    Testle_smsInbox_Log();
+
     LE_INFO("======== smsInbox Close test ========");
     Testle_smsInbox_Close();
 
@@ -134,7 +134,8 @@ int32_t le_cfg_GetInt
     int32_t defaultValue
 )
 {
-    return 0;
+    // Message boxes get their default size
+    return defaultValue;
 }
 
 
@@ -30,6 +30,15 @@ static le_msg_SessionRef_t _ClientSessionRef = NULL;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t SmsInboxRxEventId = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for New SMS message notification, and its context.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sms_RxMessageHandlerFunc_t RxHandlerPtr = NULL;
+static void* RxContextPtr = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the server service reference
@@ -508,9 +517,29 @@ le_sms_RxMessageHandlerRef_t le_sms_AddRxMessageHandler
 
     le_event_SetContextPtr(handlerRef, contextPtr);
 
+    RxHandlerPtr = handlerPtr;
+    RxContextPtr = contextPtr;
+
     return (le_sms_RxMessageHandlerRef_t)(handlerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the reception of a new SMS message.
+ *
+ * The handler is called directly, so the message is in the message boxes when this returns.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_smsTest_SimulateRxMessage
+(
+    void
+)
+{
+    LE_ASSERT(RxHandlerPtr != NULL);
+
+    RxHandlerPtr((le_sms_MsgRef_t) 0x10000001, RxContextPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieves the identification number (IMSI) of the SIM card. (max 15 digits)
@@ -29,6 +29,7 @@
 
 #include "tinycbor/cbor.h"
 #include "zlib.h"
+#include "tsSpool.h"
 
 #endif
 
@@ -60,10 +61,113 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
+ * Maximum number of bytes for the single notification sent when a batch of updates is committed.
+ * If the changed fields don't fit, they are notified one at a time.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CBOR_BUFFER_NUMBYTES 1024
+#define BATCH_NOTIFY_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum number of seconds between observe notifications for a field of an app's asset, when the
+ * server hasn't given a pmin attribute for it.  Changes made in between are coalesced, and only the
+ * latest value is sent.  Fields of the lwm2m objects are notified as they change by default.
+ *
+ * Can be changed by adding -DDEFAULT_NOTIFY_PMIN_SEC=<n> to the component's cflags.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef DEFAULT_NOTIFY_PMIN_SEC
+#define DEFAULT_NOTIFY_PMIN_SEC 1
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the attributes of a LWM2M Write-Attributes request.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFY_ATTR_NUMBYTES 128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of compressed time series data kept for a single field.  The data is
+ * held in chunks allocated as it grows, so a field only uses as much of this as it needs.
+ *
+ * Can be changed by adding -DTIME_SERIES_BUDGET_NUMBYTES=<n> to the component's cflags.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef TIME_SERIES_BUDGET_NUMBYTES
+#define TIME_SERIES_BUDGET_NUMBYTES 8192
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in each chunk of compressed time series data.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_CHUNK_NUMBYTES 512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of chunks of compressed time series data kept for a single field.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_MAX_CHUNKS \
+    ((TIME_SERIES_BUDGET_NUMBYTES + TIME_SERIES_CHUNK_NUMBYTES - 1) / TIME_SERIES_CHUNK_NUMBYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for a single CBOR encoded time series entry (time stamp and value) or
+ * for the CBOR encoded time series header.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_ENTRY_NUMBYTES (STRING_VALUE_NUMBYTES + CBOR_RESERVED_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * zlib window size (log2) and memory level used to compress time series data.  These are smaller
+ * than zlib's defaults, keeping the compressor's state for each field to about 16 KB; the samples
+ * are small and repetitive, so this costs little compression.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_ZLIB_WINDOW_BITS 11
+#define TIME_SERIES_ZLIB_MEM_LEVEL 4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of spooled time series sent to the server at a time once the session is back, and delay
+ * between those bursts, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_DRAIN_BURST 4
+#define TIME_SERIES_DRAIN_INTERVAL_MS 1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR "break" byte, which ends the indefinite length sample array.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_BREAK_BYTE 0xff
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SenML CBOR labels (RFC 8428, section 6), used as map keys in the SenML records.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_LABEL_BASE_NAME   -2
+#define SENML_LABEL_NAME        0
+#define SENML_LABEL_VALUE       2
+#define SENML_LABEL_STRING      3
+#define SENML_LABEL_BOOL        4
 
 
 //--------------------------------------------------------------------------------------------------
@@ -117,6 +221,47 @@ typedef enum
 AccessBitMask_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key for AssetMap.  Stored in the asset data block it maps to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* appNamePtr;             ///< Name of the app containing the asset
+    int assetId;                        ///< Id of the asset within the app
+}
+AssetKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key for InstanceMap and FieldMap: an instance or field id within the asset data block or
+ * instance that contains it.  Stored in the instance or field it maps to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void* ownerPtr;               ///< Asset data block or instance containing the item
+    int id;                             ///< Instance or field id
+}
+ItemKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key for FieldMapByName: a field name within the instance that contains it.  Stored in the field
+ * it maps to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void* ownerPtr;               ///< Instance containing the field
+    const char* namePtr;                ///< Field name
+}
+ItemNameKey_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data associated with an asset with a particular id
@@ -134,10 +279,38 @@ typedef struct assetData_AssetData
     bool isObjectObserve;               ///< Is Observe enabled on this object?
     uint8_t tokenLength;                ///< Token length of the lwm2m observe request.
     uint8_t token[8];                   ///< Token or request ID of the lwm2m observe request.
+    AssetKey_t key;                     ///< Key for AssetMap
+    char nameId[100];                   ///< "appName/assetId", for the asset list
+    bool isModelCompiled;               ///< Has the model been read from the configDB?
+    le_dls_List_t fieldModelList;       ///< Models of the fields of an instance, read once from
+                                        ///  the configDB and copied into each new instance
 }
 AssetData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Model of a field of an asset, as read from the configDB
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int fieldId;                        ///< Id of the field
+    char name[100];                     ///< Name of the field
+    DataTypes_t type;                   ///< Type of the field
+    AccessBitMask_t access;             ///< Access to the field
+    union                               ///< Default value of the field, zero if none
+    {
+        int intValue;
+        double floatValue;
+        bool boolValue;
+        char strValue[100];
+    };
+    le_dls_Link_t link;                 ///< For adding to the field model list
+}
+FieldModel_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data contained in a single asset instance
@@ -149,36 +322,53 @@ typedef struct le_avdata_AssetInstance
     AssetData_t* assetDataPtr;   ///< Back reference to asset data containing this instance
     le_dls_List_t fieldList;     ///< List of fields for this instance
     le_dls_Link_t link;          ///< For adding to the asset instance list
+    ItemKey_t key;               ///< Key for InstanceMap
+    int batchDepth;              ///< Nesting depth of client update batches; notifications for
+                                 ///  changed fields are held back while this is non-zero.
 }
 InstanceData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A chunk of compressed time series data
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;                         ///< For adding to the time series chunk list.
+    uint8_t data[TIME_SERIES_CHUNK_NUMBYTES];   ///< Compressed data.
+}
+TimeSeriesChunk_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data contained in time series
+ *
+ * Each entry is CBOR encoded and handed straight to zlib, which writes the compressed stream into
+ * a list of chunks that grows as needed, up to TIME_SERIES_BUDGET_NUMBYTES.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
+    uint32_t numElements;           ///< Number of elements in cbor encoded stream.
 
 #ifdef LEGATO_FEATURE_TIMESERIES
+    le_sls_List_t chunkList;        ///< Chunks of compressed data, oldest first.
+    size_t numChunks;               ///< Number of chunks in chunkList.
+    size_t unflushedSize;           ///< CBOR bytes given to zlib since its output was flushed.
+    z_stream zStream;               ///< zlib compressor state.
+
     double timeStampFactor;         ///< Factor of time stamp.
-    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
+    int64_t prevTimeStamp;          ///< Scaled time stamp of last data capture, for delta encoding.
 
     double factor;                  ///< Factor of data.
     union
     {
-        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
+        int64_t prevScaledValue;    ///< Scaled value of last data capture - used for delta encoding.
         double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
     };
-
-    uint32_t numElements;           ///< Number of elements in cbor encoded stream.
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
 #endif
 }
 TimeSeriesData_t;
@@ -197,6 +387,15 @@ typedef struct
     DataTypes_t type;
     AccessBitMask_t access;
     bool isObserve;
+    bool isNotifyPending;        ///< Changed during a batch; to be notified when it's committed
+    bool isNotifyDeferred;       ///< Changed within pmin of the last notify; notifyTimerRef is
+                                 ///  running until it can be notified
+    int notifyPmin;              ///< Minimum seconds between notifies, or -1 for the default
+    int notifyPmax;              ///< Maximum seconds between notifies, or 0 for no limit
+    double notifyStep;           ///< Minimum change in a numeric value to notify, or 0 for any
+    double lastNotifyValue;      ///< Numeric value last notified, for notifyStep
+    le_clk_Time_t lastNotifyTime;    ///< When the value was last notified (relative time)
+    le_timer_Ref_t notifyTimerRef;   ///< Timer for pmin and pmax; created when first needed
     pa_avc_LWM2MOperationDataRef_t readCallBackOpRef;
     uint8_t tokenLength;
     uint8_t token[8];
@@ -211,6 +410,8 @@ typedef struct
     TimeSeriesData_t* timeSeriesPtr;
 
     le_dls_Link_t link;          ///< For adding to the field list
+    ItemKey_t key;               ///< Key for FieldMap
+    ItemNameKey_t nameKey;       ///< Key for FieldMapByName
 }
 FieldData_t;
 
@@ -290,10 +491,19 @@ static le_mem_PoolRef_t AssetDataPoolRef = NULL;
 static le_mem_PoolRef_t ActionHandlerDataPoolRef = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field model memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FieldModelPoolRef = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This pool is used for the string representation of a LWM2M address, which is used as a key in a
- * hashmap, e.g. (appName, assetId) to be used with AssetMap. Initialized in assetData_Init().
+ * hashmap, e.g. (appName, assetName) to be used with AssetMapByName. Initialized in
+ * assetData_Init().
  */
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t AddressStringPoolRef = NULL;
@@ -323,6 +533,18 @@ static le_hashmap_Ref_t AssetMap = NULL;
 static le_hashmap_Ref_t AssetMapByName = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (assetData, instanceId) to an instance, (instance, fieldId) to a field, and
+ * (instance, fieldName) to a field, so that lookups don't have to walk the instance and field
+ * lists.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t InstanceMap = NULL;
+static le_hashmap_Ref_t FieldMap = NULL;
+static le_hashmap_Ref_t FieldMapByName = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Used to delay reporting REG_UPDATE, so that we don't generate too much message traffic.
@@ -341,10 +563,30 @@ static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CBOR buffer memory pool.  Initialized in assetData_Init().
+ * Time series chunk memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TimeSeriesChunkPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the buffer the compressed time series data is gathered into when it's pushed to the
+ * server.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TimeSeriesPayloadPoolRef = NULL;
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to send the time series spooled while the session was down.  Initialized in
+ * assetData_Init().
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t CborBufferPoolRef = NULL;
+static le_timer_Ref_t TimeSeriesDrainTimerRef = NULL;
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
@@ -385,6 +627,39 @@ static assetData_SessionTypes_t CurrentAvSessionStatus = ASSET_DATA_SESSION_UNAV
 //--------------------------------------------------------------------------------------------------
 static bool IsRegUpdatePending = false;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload size statistics of the observe notifications sent in a content type.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t contentType;       ///< Content type of the notifications
+    uint32_t numNotifies;       ///< Number of notifications sent
+    uint64_t numBytes;          ///< Total payload size of the notifications sent
+}
+NotifyStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload size statistics of the observe notifications, for each content type used.
+ */
+//--------------------------------------------------------------------------------------------------
+static NotifyStats_t NotifyStats[] =
+{
+    { .contentType = TLV_ENCODING },
+    { .contentType = SENML_CBOR_ENCODING },
+    { .contentType = SIERRA_CBOR_ENCODING },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Content type used for the observe notifications of asset instances. The time series are always
+ * notified in their own format.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t NotifyContentType = TLV_ENCODING;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Declare this function here, until the QMI functions are moved out of this file.
@@ -400,6 +675,31 @@ static le_result_t WriteNotifyObjectToTLV
     size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
 );
 
+static le_result_t WriteNotifyPendingToTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Instance that has changed resources
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+);
+
+static void NotifyTimerHandler
+(
+    le_timer_Ref_t timerRef                     ///< [IN] Timer that expired
+);
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+static le_result_t WriteInstanceToSenmlCbor
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for the fields
+                                                ///<      with a notification pending
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the SenML records
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+);
+#endif
+
 //--------------------------------------------------------------------------------------------------
 // Local functions
 //--------------------------------------------------------------------------------------------------
@@ -558,6 +858,14 @@ static void InitDefaultFieldData
 )
 {
     fieldDataPtr->isObserve = false;
+    fieldDataPtr->isNotifyPending = false;
+    fieldDataPtr->isNotifyDeferred = false;
+    fieldDataPtr->notifyPmin = -1;
+    fieldDataPtr->notifyPmax = 0;
+    fieldDataPtr->notifyStep = 0;
+    fieldDataPtr->lastNotifyValue = 0;
+    fieldDataPtr->lastNotifyTime = (le_clk_Time_t){ .sec=0, .usec=0 };
+    fieldDataPtr->notifyTimerRef = NULL;
     fieldDataPtr->readCallBackOpRef = NULL;
 
     fieldDataPtr->timeSeriesPtr = NULL;
@@ -589,91 +897,90 @@ static void InitDefaultFieldData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read field model from configDB, and fill in field data block
- *
- * @return:
- *      - LE_OK on success
- *      - LE_FAULT on error
+ * Read field model from configDB, and fill in field model block
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateFieldFromModel
+static void CompileFieldModel
 (
     le_cfg_IteratorRef_t assetCfg,
-    FieldData_t* fieldDataPtr
+    FieldModel_t* fieldModelPtr
 )
 {
     char strBuf[100];     // Generic buffer for reading string data
     le_cfg_nodeType_t nodeType;
 
     le_cfg_GetString(assetCfg, "name", strBuf, sizeof(strBuf), "");
-    le_utf8_Copy(fieldDataPtr->name, strBuf, sizeof(fieldDataPtr->name), NULL);
+    le_utf8_Copy(fieldModelPtr->name, strBuf, sizeof(fieldModelPtr->name), NULL);
 
     // The "type" is optional; internally "none" is mapped to DATA_TYPE_NONE
     le_cfg_GetString(assetCfg, "type", strBuf, sizeof(strBuf), "none");
-    ConvertDataTypeStr(strBuf, &fieldDataPtr->type);
+    ConvertDataTypeStr(strBuf, &fieldModelPtr->type);
 
     le_cfg_GetString(assetCfg, "access", strBuf, sizeof(strBuf), "");
-    ConvertAccessModeStr(strBuf, &fieldDataPtr->access);
+    ConvertAccessModeStr(strBuf, &fieldModelPtr->access);
 
     // The 'default' is optional, and only supported for certain field types.
     nodeType=le_cfg_GetNodeType(assetCfg, "default");
 
     // Init with hard-coded defaults, which could get overwritten below.
-    InitDefaultFieldData(fieldDataPtr);
+    memset(fieldModelPtr->strValue, 0, sizeof(fieldModelPtr->strValue));
 
     if ( nodeType==LE_CFG_TYPE_EMPTY || nodeType==LE_CFG_TYPE_DOESNT_EXIST )
     {
-        LE_DEBUG("No default for name=%s", fieldDataPtr->name);
+        LE_DEBUG("No default for name=%s", fieldModelPtr->name);
     }
-    else switch ( fieldDataPtr->type )
+    else switch ( fieldModelPtr->type )
     {
         case DATA_TYPE_INT:
-            fieldDataPtr->intValue = le_cfg_GetInt(assetCfg, "default", 0);
+            fieldModelPtr->intValue = le_cfg_GetInt(assetCfg, "default", 0);
             break;
 
         case DATA_TYPE_BOOL:
-            fieldDataPtr->boolValue = le_cfg_GetBool(assetCfg, "default", 0);
+            fieldModelPtr->boolValue = le_cfg_GetBool(assetCfg, "default", 0);
             break;
 
         case DATA_TYPE_STRING:
-            le_cfg_GetString(assetCfg, "default", strBuf, sizeof(strBuf), "");
-            le_utf8_Copy(fieldDataPtr->strValuePtr, strBuf, STRING_VALUE_NUMBYTES, NULL);
+            le_cfg_GetString(assetCfg, "default", fieldModelPtr->strValue,
+                             sizeof(fieldModelPtr->strValue), "");
             break;
 
         case DATA_TYPE_FLOAT:
-            fieldDataPtr->floatValue = le_cfg_GetFloat(assetCfg, "default", 0.0);
+            fieldModelPtr->floatValue = le_cfg_GetFloat(assetCfg, "default", 0.0);
 
             break;
 
         case DATA_TYPE_NONE:
             LE_DEBUG("Default value not supported for data type '%s'",
-                     GetDataTypeStr(fieldDataPtr->type));
+                     GetDataTypeStr(fieldModelPtr->type));
             break;
 
     }
-
-    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read asset model from configDB, and fill in asset data instance
+ * Read asset model from configDB, and keep its field models in the asset data block
+ *
+ * The configDB is the only source of asset models: the build tools don't parse the "assets:"
+ * section of a .cdef, so there is no model to compile into a binary form at build time.  The
+ * model is therefore compiled here, once per asset, and each new instance is filled from it.
+ * Every field of an instance is still created with the instance, since the TLV, observe and
+ * instance list code walk the whole field list of an instance.
  *
  * @return:
  *      - LE_OK on success
  *      - LE_FAULT on error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateInstanceFromModel
+static le_result_t CompileModel
 (
     le_cfg_IteratorRef_t assetCfg,      ///< [IN]
-    InstanceData_t* assetInstPtr        ///< [IN]
+    AssetData_t* assetDataPtr           ///< [IN]
 )
 {
     char strBuf[LIMIT_MAX_PATH_BYTES];     // Generic buffer for reading string data
-    FieldData_t* fieldDataPtr;
-    le_result_t result;
+    FieldModel_t* fieldModelPtr;
 
     // Goto to the 'fields' node; it must exist.
     le_cfg_GoToNode(assetCfg, "fields");
@@ -691,33 +998,84 @@ static le_result_t CreateInstanceFromModel
         return LE_FAULT;
     }
 
+    do
+    {
+        fieldModelPtr = le_mem_ForceAlloc(FieldModelPoolRef);
+
+        le_cfg_GetNodeName(assetCfg, "", strBuf, sizeof(strBuf));
+        fieldModelPtr->fieldId = atoi(strBuf);
+
+        CompileFieldModel(assetCfg, fieldModelPtr);
+
+        le_dls_Queue(&assetDataPtr->fieldModelList, &fieldModelPtr->link);
+
+    } while ( le_cfg_GoToNextSibling(assetCfg) == LE_OK );
+
+    assetDataPtr->isModelCompiled = true;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill in asset data instance from the field models kept in its asset data block
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateInstanceFromModel
+(
+    AssetData_t* assetDataPtr,          ///< [IN]
+    InstanceData_t* assetInstPtr        ///< [IN]
+)
+{
+    FieldData_t* fieldDataPtr;
+    FieldModel_t* fieldModelPtr;
+    le_dls_Link_t* linkPtr;
+
     // Init the field list for this instance; it will get populated below
     assetInstPtr->fieldList = LE_DLS_LIST_INIT;
 
-    do
+    linkPtr = le_dls_Peek(&assetDataPtr->fieldModelList);
+
+    while ( linkPtr != NULL )
     {
-        // Allocate field data; will be released if errors are found
+        fieldModelPtr = CONTAINER_OF(linkPtr, FieldModel_t, link);
         fieldDataPtr = le_mem_ForceAlloc(FieldDataPoolRef);
 
-        le_cfg_GetNodeName(assetCfg, "", strBuf, sizeof(strBuf));
-        fieldDataPtr->fieldId = atoi(strBuf);
+        fieldDataPtr->fieldId = fieldModelPtr->fieldId;
+        memcpy(fieldDataPtr->name, fieldModelPtr->name, sizeof(fieldDataPtr->name));
+        fieldDataPtr->type = fieldModelPtr->type;
+        fieldDataPtr->access = fieldModelPtr->access;
 
-        // Populate the field from the model definition
-        result = CreateFieldFromModel(assetCfg, fieldDataPtr);
+        InitDefaultFieldData(fieldDataPtr);
 
-        // todo: will have to release all fields allocated so far ...
-        if ( result != LE_OK )
+        switch ( fieldDataPtr->type )
         {
-            LE_ERROR("Error in field read");
-            return LE_FAULT;
+            case DATA_TYPE_INT:
+                fieldDataPtr->intValue = fieldModelPtr->intValue;
+                break;
+
+            case DATA_TYPE_BOOL:
+                fieldDataPtr->boolValue = fieldModelPtr->boolValue;
+                break;
+
+            case DATA_TYPE_STRING:
+                le_utf8_Copy(fieldDataPtr->strValuePtr, fieldModelPtr->strValue,
+                             STRING_VALUE_NUMBYTES, NULL);
+                break;
+
+            case DATA_TYPE_FLOAT:
+                fieldDataPtr->floatValue = fieldModelPtr->floatValue;
+                break;
+
+            case DATA_TYPE_NONE:
+                break;
         }
 
-        // Field read okay; add it to the list.
         le_dls_Queue(&assetInstPtr->fieldList, &fieldDataPtr->link);
 
-    } while ( le_cfg_GoToNextSibling(assetCfg) == LE_OK );
-
-    return LE_OK;
+        linkPtr = le_dls_PeekNext(&assetDataPtr->fieldModelList, linkPtr);
+    }
 }
 
 
@@ -830,24 +1188,165 @@ static void CreateInstanceForObjectNine
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a new asset data block to the AssetMap
- *
- * @return:
- *      - LE_OK on success
- *      - LE_FAULT on error
+ * Hash function for AssetMap keys
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddAssetData
+static size_t HashAssetKey
 (
-    const char* appNamePtr,         ///< [IN]
-    int assetId,                    ///< [IN]
-    const char* assetNamePtr,       ///< [IN]
-    AssetData_t** assetDataPtrPtr   ///< [OUT] Pointer to newly created asset data block
+    const void* keyPtr
 )
 {
-    AssetData_t* assetDataPtr;
-    char* appNameAssetIdPtr;
-    char* appNameAssetNamePtr;
+    const AssetKey_t* assetKeyPtr = keyPtr;
+
+    return le_hashmap_HashString(assetKeyPtr->appNamePtr) * 31 + (size_t)assetKeyPtr->assetId;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for AssetMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsAssetKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const AssetKey_t* firstPtr = firstKeyPtr;
+    const AssetKey_t* secondPtr = secondKeyPtr;
+
+    return ( firstPtr->assetId == secondPtr->assetId ) &&
+           ( strcmp(firstPtr->appNamePtr, secondPtr->appNamePtr) == 0 );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for InstanceMap and FieldMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashItemKey
+(
+    const void* keyPtr
+)
+{
+    const ItemKey_t* itemKeyPtr = keyPtr;
+
+    return le_hashmap_HashVoidPointer(itemKeyPtr->ownerPtr) * 31 + (size_t)itemKeyPtr->id;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for InstanceMap and FieldMap keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsItemKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const ItemKey_t* firstPtr = firstKeyPtr;
+    const ItemKey_t* secondPtr = secondKeyPtr;
+
+    return ( firstPtr->ownerPtr == secondPtr->ownerPtr ) && ( firstPtr->id == secondPtr->id );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for FieldMapByName keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashItemNameKey
+(
+    const void* keyPtr
+)
+{
+    const ItemNameKey_t* itemKeyPtr = keyPtr;
+
+    return le_hashmap_HashVoidPointer(itemKeyPtr->ownerPtr) * 31 +
+           le_hashmap_HashString(itemKeyPtr->namePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for FieldMapByName keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsItemNameKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const ItemNameKey_t* firstPtr = firstKeyPtr;
+    const ItemNameKey_t* secondPtr = secondKeyPtr;
+
+    return ( firstPtr->ownerPtr == secondPtr->ownerPtr ) &&
+           ( strcmp(firstPtr->namePtr, secondPtr->namePtr) == 0 );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an instance, and all its fields, to InstanceMap, FieldMap and FieldMapByName.  The instance
+ * must already have its instanceId and assetDataPtr set.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddInstanceToMaps
+(
+    InstanceData_t* assetInstPtr    ///< [IN]
+)
+{
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* linkPtr;
+
+    assetInstPtr->key.ownerPtr = assetInstPtr->assetDataPtr;
+    assetInstPtr->key.id = assetInstPtr->instanceId;
+    le_hashmap_Put(InstanceMap, &assetInstPtr->key, assetInstPtr);
+
+    linkPtr = le_dls_Peek(&assetInstPtr->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        fieldDataPtr->key.ownerPtr = assetInstPtr;
+        fieldDataPtr->key.id = fieldDataPtr->fieldId;
+        le_hashmap_Put(FieldMap, &fieldDataPtr->key, fieldDataPtr);
+
+        fieldDataPtr->nameKey.ownerPtr = assetInstPtr;
+        fieldDataPtr->nameKey.namePtr = fieldDataPtr->name;
+        le_hashmap_Put(FieldMapByName, &fieldDataPtr->nameKey, fieldDataPtr);
+
+        linkPtr = le_dls_PeekNext(&assetInstPtr->fieldList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new asset data block to the AssetMap
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddAssetData
+(
+    const char* appNamePtr,         ///< [IN]
+    int assetId,                    ///< [IN]
+    const char* assetNamePtr,       ///< [IN]
+    AssetData_t** assetDataPtrPtr   ///< [OUT] Pointer to newly created asset data block
+)
+{
+    AssetData_t* assetDataPtr;
+    char* appNameAssetNamePtr;
 
     assetDataPtr = le_mem_ForceAlloc(AssetDataPoolRef);
     assetDataPtr->assetId = assetId;
@@ -856,25 +1355,31 @@ static le_result_t AddAssetData
     assetDataPtr->fieldActionList = LE_DLS_LIST_INIT;
     assetDataPtr->assetActionList = LE_DLS_LIST_INIT;
     assetDataPtr->isObjectObserve = false;
+    assetDataPtr->isModelCompiled = false;
+    assetDataPtr->fieldModelList = LE_DLS_LIST_INIT;
     le_utf8_Copy(assetDataPtr->assetName, assetNamePtr, sizeof(assetDataPtr->assetName), NULL);
     le_utf8_Copy(assetDataPtr->appName, appNamePtr, sizeof(assetDataPtr->appName), NULL);
 
     // Put (appName, assetId) key in AssetMap, pointing to the assetData block
     // Put (appName, assetName) key in AssetMapByName, pointing to the same assetData block
-    appNameAssetIdPtr = le_mem_ForceAlloc(AddressStringPoolRef);
+    assetDataPtr->key.appNamePtr = assetDataPtr->appName;
+    assetDataPtr->key.assetId = assetId;
     appNameAssetNamePtr = le_mem_ForceAlloc(AddressStringPoolRef);
 
-    if ( ( FormatString(appNameAssetIdPtr, 100, "%s/%i", appNamePtr, assetId) != LE_OK ) ||
+    if ( ( FormatString(assetDataPtr->nameId,
+                        sizeof(assetDataPtr->nameId),
+                        "%s/%i",
+                        appNamePtr,
+                        assetId) != LE_OK ) ||
          ( FormatString(appNameAssetNamePtr, 100, "%s/%s", appNamePtr, assetNamePtr) != LE_OK ) )
     {
         le_mem_Release(assetDataPtr);
-        le_mem_Release(appNameAssetIdPtr);
         le_mem_Release(appNameAssetNamePtr);
         return LE_FAULT;
     }
 
     // todo: 'Put' returns a value, but not sure what it's for.
-    le_hashmap_Put(AssetMap, appNameAssetIdPtr, assetDataPtr);
+    le_hashmap_Put(AssetMap, &assetDataPtr->key, assetDataPtr);
     le_hashmap_Put(AssetMapByName, appNameAssetNamePtr, assetDataPtr);
 
     // Return the pointer to the newly allocated block
@@ -900,12 +1405,7 @@ static le_result_t GetAssetData
     AssetData_t** assetDataPtrPtr   ///< [OUT] Pointer to found asset data block
 )
 {
-    char key[100];
-
-    if ( FormatString(key, sizeof(key), "%s/%i", appNamePtr, assetId) != LE_OK )
-    {
-        return LE_FAULT;
-    }
+    AssetKey_t key = { .appNamePtr = appNamePtr, .assetId = assetId };
 
     *assetDataPtrPtr = le_hashmap_Get(AssetMap, &key);
 
@@ -1010,11 +1510,20 @@ static le_result_t CreateAssetDataFromModel
         // Get the asset name from config
         le_cfg_GetString(assetCfg, "name", assetName, sizeof(assetName), "");
 
+        // Create and store new AssetData block
+        result = AddAssetData(appNamePtr, assetId, assetName, assetDataPtrPtr);
+
+        // Read the field models in the same transaction.  On error, this is retried and reported
+        // when the first instance is created.
+        if ( result == LE_OK )
+        {
+            CompileModel(assetCfg, *assetDataPtrPtr);
+        }
+
         // Regardless of success/failure, stop the transaction
         le_cfg_CancelTxn(assetCfg);
 
-        // Create and store new AssetData block
-        if ( AddAssetData(appNamePtr, assetId, assetName, assetDataPtrPtr) != LE_OK )
+        if ( result != LE_OK )
         {
             return LE_FAULT;
         }
@@ -1121,28 +1630,16 @@ static le_result_t GetInstanceFromAssetData
     InstanceData_t** instanceDataPtrPtr   ///< [OUT]
 )
 {
-    InstanceData_t* assetInstancePtr;
-    le_dls_Link_t* linkPtr;
-
-    // Get the start of the instance list
-    linkPtr = le_dls_Peek(&assetDataPtr->instanceList);
+    ItemKey_t key = { .ownerPtr = assetDataPtr, .id = instanceId };
+    InstanceData_t* assetInstancePtr = le_hashmap_Get(InstanceMap, &key);
 
-    // Loop through the asset instances
-    while ( linkPtr != NULL )
+    if ( assetInstancePtr == NULL )
     {
-        assetInstancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
-        //LE_PRINT_VALUE("%i", assetInstancePtr->instanceId);
-
-        if ( assetInstancePtr->instanceId == instanceId )
-        {
-            *instanceDataPtrPtr = assetInstancePtr;
-            return LE_OK;
-        }
-
-        linkPtr = le_dls_PeekNext(&assetDataPtr->instanceList, linkPtr);
+        return LE_NOT_FOUND;
     }
 
-    return LE_NOT_FOUND;
+    *instanceDataPtrPtr = assetInstancePtr;
+    return LE_OK;
 }
 
 
@@ -1162,28 +1659,16 @@ static le_result_t GetFieldFromInstance
     FieldData_t** fieldDataPtrPtr   ///< [OUT]
 )
 {
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
-
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
+    ItemKey_t key = { .ownerPtr = instanceDataPtr, .id = fieldId };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldMap, &key);
 
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr == NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
-
-        if ( fieldDataPtr->fieldId == fieldId )
-        {
-            *fieldDataPtrPtr = fieldDataPtr;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, fieldLinkPtr);
+        return LE_NOT_FOUND;
     }
 
-    return LE_NOT_FOUND;
+    *fieldDataPtrPtr = fieldDataPtr;
+    return LE_OK;
 }
 
 
@@ -1286,6 +1771,167 @@ static le_result_t GetField
 
 
 
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free a time series' compressor state and chunks, and the time series itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseTimeSeries
+(
+    TimeSeriesData_t* timeSeriesPtr             ///< [IN] Time series to free
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    deflateEnd(&timeSeriesPtr->zStream);
+
+    while ((linkPtr = le_sls_Pop(&timeSeriesPtr->chunkList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, TimeSeriesChunk_t, link));
+    }
+
+    le_mem_Release(timeSeriesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give some CBOR encoded data to the time series' compressor, adding chunks to hold its output as
+ * needed.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the output would exceed TIME_SERIES_BUDGET_NUMBYTES
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t TimeSeriesDeflate
+(
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series to add the data to
+    const uint8_t* dataPtr,                     ///< [IN] CBOR encoded data
+    size_t numBytes,                            ///< [IN] Number of bytes of data
+    int flush                                   ///< [IN] zlib flush mode
+)
+{
+    z_stream* zStreamPtr = &timeSeriesPtr->zStream;
+    TimeSeriesChunk_t* chunkPtr;
+    int zResult;
+
+    zStreamPtr->next_in = (Bytef *)dataPtr;
+    zStreamPtr->avail_in = (uInt)numBytes;
+
+    do
+    {
+        // Start a new chunk when the last one is full.
+        if (zStreamPtr->avail_out == 0)
+        {
+            if (timeSeriesPtr->numChunks >= TIME_SERIES_MAX_CHUNKS)
+            {
+                LE_ERROR("Time series data exceeds %d bytes.", TIME_SERIES_BUDGET_NUMBYTES);
+                return LE_NO_MEMORY;
+            }
+
+            chunkPtr = le_mem_ForceAlloc(TimeSeriesChunkPoolRef);
+            chunkPtr->link = LE_SLS_LINK_INIT;
+            le_sls_Queue(&timeSeriesPtr->chunkList, &chunkPtr->link);
+            timeSeriesPtr->numChunks++;
+
+            zStreamPtr->next_out = chunkPtr->data;
+            zStreamPtr->avail_out = sizeof(chunkPtr->data);
+        }
+
+        zResult = deflate(zStreamPtr, flush);
+        if ((zResult != Z_OK) && (zResult != Z_STREAM_END) && (zResult != Z_BUF_ERROR))
+        {
+            LE_ERROR("Time series compression error %d.", zResult);
+            return LE_FAULT;
+        }
+    }
+    while (   (zResult != Z_STREAM_END)
+           && ((zStreamPtr->avail_in > 0) || (zStreamPtr->avail_out == 0)));
+
+    if (flush == Z_NO_FLUSH)
+    {
+        timeSeriesPtr->unflushedSize += numBytes;
+    }
+    else
+    {
+        timeSeriesPtr->unflushedSize = 0;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the compressed time series is sure to stay within TIME_SERIES_BUDGET_NUMBYTES if a
+ * given number of CBOR encoded bytes are added to it and the stream is then finished.
+ *
+ * zlib holds on to data it has been given until it can compress it well, so the worst case is
+ * assumed for everything given to it since its output was last flushed.  If that doesn't fit, the
+ * output is flushed and the check made again.  That only happens as the budget is used up.
+ *
+ * @return true if there is room.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TimeSeriesHasRoom
+(
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series to check
+    size_t numBytes                             ///< [IN] Number of CBOR encoded bytes to be added
+)
+{
+    const size_t budget = TIME_SERIES_MAX_CHUNKS * TIME_SERIES_CHUNK_NUMBYTES;
+
+    if (  timeSeriesPtr->zStream.total_out
+        + deflateBound(&timeSeriesPtr->zStream,
+                       timeSeriesPtr->unflushedSize + numBytes + CBOR_RESERVED_BYTES)
+        <= budget)
+    {
+        return true;
+    }
+
+    if (timeSeriesPtr->unflushedSize == 0)
+    {
+        return false;
+    }
+
+    if (TimeSeriesDeflate(timeSeriesPtr, NULL, 0, Z_SYNC_FLUSH) != LE_OK)
+    {
+        return false;
+    }
+
+    return (  timeSeriesPtr->zStream.total_out
+            + deflateBound(&timeSeriesPtr->zStream, numBytes + CBOR_RESERVED_BYTES)
+            <= budget);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum number of bytes a CBOR encoded entry (time stamp and value) of a given field can
+ * take.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TimeSeriesMaxEntrySize
+(
+    FieldData_t* fieldDataPtr                   ///< [IN] Field that has time series enabled
+)
+{
+    // An integer, double or boolean takes at most 9 bytes, and so does a string's length.
+    if (fieldDataPtr->type == DATA_TYPE_STRING)
+    {
+        return 9 + 9 + STRING_VALUE_NUMBYTES;
+    }
+
+    return 9 + 9;
+}
+
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Allocate resources and start accumulating time series data on the specified field.
@@ -1309,9 +1955,14 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
+    TimeSeriesData_t* timeSeriesPtr;
+    uint8_t headerBuf[TIME_SERIES_ENTRY_NUMBYTES];
+    size_t headerSize;
     char headerId[64];
     CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
+    CborEncoder sampleRef;
     CborEncoder headerArray;
     CborEncoder factorArray;
 
@@ -1335,34 +1986,18 @@ static le_result_t StartTimeSeries
                  instanceRef->instanceId,
                  fieldId);
 
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
+    // Initialize CBOR stream.  The header is encoded here, then compressed along with the entries.
+    cbor_encoder_init(&streamRef, headerBuf, sizeof(headerBuf), 0);
 
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
-
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
     RETURN_IF_CBOR_ERROR(err);
 
     // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
+    err = cbor_encode_text_stringz(&mapRef, "h");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
+    err = cbor_encoder_create_array(&mapRef, &headerArray, 1);
     RETURN_IF_CBOR_ERROR(err);
 
     err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
@@ -1370,18 +2005,15 @@ static le_result_t StartTimeSeries
 
     // Close the heade map i.e done with entering in to header array.
     // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
+    cbor_encoder_close_container(&mapRef, &headerArray);
 
     // Create a map for factor.
     // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
+    err = cbor_encode_text_stringz(&mapRef, "f");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
+    err = cbor_encoder_create_array(&mapRef, &factorArray, 2);
     RETURN_IF_CBOR_ERROR(err);
 
     // Add factor for time stamp.
@@ -1393,22 +2025,53 @@ static le_result_t StartTimeSeries
     RETURN_IF_CBOR_ERROR(err);
 
     // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
+    cbor_encoder_close_container(&mapRef, &factorArray);
 
     // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
+    // It is closed by PushTimeSeries(), and the map and the stream don't need closing.
+    err = cbor_encode_text_stringz(&mapRef, "s");
     RETURN_IF_CBOR_ERROR(err);
 
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
+    err = cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->factor = factor;
-    fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
+    headerSize = cbor_encoder_get_buffer_size(&sampleRef, headerBuf);
 
-    return result;
+    timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
+
+    memset(timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
+
+    timeSeriesPtr->chunkList = LE_SLS_LIST_INIT;
+    timeSeriesPtr->factor = factor;
+    timeSeriesPtr->timeStampFactor = timeStampFactor;
+
+    // Start the compressor; its output is put in chunks as it's produced.
+    timeSeriesPtr->zStream.zalloc = Z_NULL;
+    timeSeriesPtr->zStream.zfree = Z_NULL;
+    timeSeriesPtr->zStream.opaque = Z_NULL;
+
+    if (deflateInit2(&timeSeriesPtr->zStream,
+                     Z_BEST_COMPRESSION,
+                     Z_DEFLATED,
+                     TIME_SERIES_ZLIB_WINDOW_BITS,
+                     TIME_SERIES_ZLIB_MEM_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        LE_ERROR("Failed to initialize time series compression.");
+        le_mem_Release(timeSeriesPtr);
+        return LE_FAULT;
+    }
+
+    result = TimeSeriesDeflate(timeSeriesPtr, headerBuf, headerSize, Z_NO_FLUSH);
+    if (result != LE_OK)
+    {
+        ReleaseTimeSeries(timeSeriesPtr);
+        return LE_FAULT;
+    }
+
+    fieldDataPtr->timeSeriesPtr = timeSeriesPtr;
+
+    return LE_OK;
 
 #else
     LE_ERROR("Time series not supported.");
@@ -1450,8 +2113,7 @@ static le_result_t StopTimeSeries
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+    ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
 
     fieldDataPtr->timeSeriesPtr = NULL;
 
@@ -1466,7 +2128,208 @@ static le_result_t StopTimeSeries
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Compress the accumulated CBOR encoded time series data and send it to server.
+ * Add a notification sent to the server to the payload size statistics of its content type.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordNotifyPayload
+(
+    uint16_t contentType,                   ///< [IN] Content type of the notification
+    size_t numBytes                         ///< [IN] Payload size of the notification
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(NotifyStats); i++)
+    {
+        if ( NotifyStats[i].contentType == contentType )
+        {
+            NotifyStats[i].numNotifies++;
+            NotifyStats[i].numBytes += numBytes;
+
+            LE_DEBUG("Notify of %zu bytes in content type %u; %"PRIu32" notifies, average %"PRIu64
+                     " bytes", numBytes, contentType, NotifyStats[i].numNotifies,
+                     NotifyStats[i].numBytes / NotifyStats[i].numNotifies);
+            return;
+        }
+    }
+}
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a finished time series to the server, as a notification of the field's observe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyTimeSeries
+(
+    char* appNamePtr,                           ///< [IN] App containing the asset
+    int assetId,                                ///< [IN] Asset id within the app
+    FieldData_t* fieldDataPtr,                  ///< [IN] Observed field
+    uint8_t* payloadPtr,                  ///< [IN] Compressed time series
+    size_t numBytes                             ///< [IN] Size of the compressed time series
+)
+{
+    pa_avc_LWM2MOperationDataRef_t opRef;
+
+    // Send the delta encoded + CBOR encoded + Zipped data to the server.
+    opRef = pa_avc_CreateOpData(appNamePtr,
+                                assetId,
+                                -1,
+                                -1,
+                                PA_AVC_OPTYPE_NOTIFY,
+                                SIERRA_CBOR_ENCODING,
+                                fieldDataPtr->token,
+                                fieldDataPtr->tokenLength);
+
+    pa_avc_NotifyChange(opRef, payloadPtr, numBytes);
+    RecordNotifyPayload(SIERRA_CBOR_ENCODING, numBytes);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a finished time series to the spool, to be sent once the session is available.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if it couldn't be spooled
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SpoolTimeSeries
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance of the field
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field of the time series
+    const uint8_t* payloadPtr,                  ///< [IN] Compressed time series
+    size_t numBytes                             ///< [IN] Size of the compressed time series
+)
+{
+    tsSpool_Key_t key;
+
+    if (le_utf8_Copy(key.appName, instanceRef->assetDataPtr->appName, sizeof(key.appName), NULL)
+        != LE_OK)
+    {
+        LE_ERROR("App name '%s' too long to spool time series.",
+                 instanceRef->assetDataPtr->appName);
+        return LE_FAULT;
+    }
+    key.assetId = instanceRef->assetDataPtr->assetId;
+    key.instanceId = instanceRef->instanceId;
+    key.fieldId = fieldDataPtr->fieldId;
+
+    if (tsSpool_Append(&key, payloadPtr, numBytes) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Spooled %zu bytes of time series for /%s/%d/%d/%d.", numBytes, key.appName,
+             key.assetId, key.instanceId, key.fieldId);
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start sending the spooled time series, if the session is available and there are any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTimeSeriesDrain
+(
+    void
+)
+{
+    if (   (CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE)
+        && !tsSpool_IsEmpty()
+        && !le_timer_IsRunning(TimeSeriesDrainTimerRef))
+    {
+        le_timer_Start(TimeSeriesDrainTimerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a burst of spooled time series to the server, oldest first.  A time series stays in the
+ * spool until its field is observed again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeSeriesDrainTimerHandler
+(
+    le_timer_Ref_t timerRef                     ///< [IN] This timer has expired
+)
+{
+    tsSpool_Key_t key;
+    size_t numBytes;
+    uint8_t* payloadPtr;
+    le_result_t result;
+    assetData_InstanceDataRef_t instanceRef;
+    FieldData_t* fieldDataPtr;
+    int numSent = 0;
+
+    if (CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE)
+    {
+        return;
+    }
+
+    payloadPtr = le_mem_ForceAlloc(TimeSeriesPayloadPoolRef);
+
+    while (numSent < TIME_SERIES_DRAIN_BURST)
+    {
+        numBytes = TIME_SERIES_MAX_CHUNKS * TIME_SERIES_CHUNK_NUMBYTES;
+
+        result = tsSpool_Peek(&key, payloadPtr, &numBytes);
+        if (result == LE_NOT_FOUND)
+        {
+            break;
+        }
+
+        if (result != LE_OK)
+        {
+            // Spooled by a build with a larger time series budget.
+            LE_WARN("Dropping spooled time series of %zu bytes; too large.", numBytes);
+            tsSpool_Consume();
+            continue;
+        }
+
+        if (   (assetData_GetInstanceRefById(key.appName, key.assetId, key.instanceId,
+                                             &instanceRef) != LE_OK)
+            || (GetFieldFromInstance(instanceRef, key.fieldId, &fieldDataPtr) != LE_OK))
+        {
+            LE_WARN("Dropping spooled time series for /%s/%d/%d/%d; no such field.",
+                    key.appName, key.assetId, key.instanceId, key.fieldId);
+            tsSpool_Consume();
+            continue;
+        }
+
+        if (!fieldDataPtr->isObserve)
+        {
+            LE_DEBUG("Spooled time series wait for observe on /%s/%d/%d/%d.",
+                     key.appName, key.assetId, key.instanceId, key.fieldId);
+            break;
+        }
+
+        NotifyTimeSeries(key.appName, key.assetId, fieldDataPtr, payloadPtr, numBytes);
+        tsSpool_Consume();
+        numSent++;
+    }
+
+    le_mem_Release(payloadPtr);
+
+    // Leave the rest for the next burst, so the notifications don't flood the modem.
+    if (numSent == TIME_SERIES_DRAIN_BURST)
+    {
+        StartTimeSeriesDrain();
+    }
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish compressing the accumulated CBOR encoded time series data and send it to server.
+ *
+ * While the session is unavailable, or earlier time series are still spooled, the time series is
+ * spooled instead, and sent once the session is available.
  *
  * @return:
  *      - LE_OK on success
@@ -1488,12 +2351,13 @@ static le_result_t PushTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
-    pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
+    TimeSeriesData_t* timeSeriesPtr;
+    const uint8_t breakByte = CBOR_BREAK_BYTE;
+    uint8_t* compressedBufPtr;
+    size_t compressBufLength;
+    size_t copySize;
+    le_sls_Link_t* linkPtr;
+    bool isSpooled = false;
 
     double dataFactor;
     double timeStampFactor;
@@ -1504,7 +2368,9 @@ static le_result_t PushTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
+
+    if (timeSeriesPtr == NULL)
     {
         // Time series not enabled on this field.
         LE_ERROR("Time series not enabled on this field.");
@@ -1519,58 +2385,68 @@ static le_result_t PushTimeSeries
     }
 
     // Remember the factors used.
-    dataFactor = fieldDataPtr->timeSeriesPtr->factor;
-    timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
+    dataFactor = timeSeriesPtr->factor;
+    timeStampFactor = timeSeriesPtr->timeStampFactor;
+
+    // Close the sample array and finish the compressed stream.  TimeSeriesAddEntry() has made sure
+    // there is room for this.
+    result = TimeSeriesDeflate(timeSeriesPtr, &breakByte, sizeof(breakByte), Z_FINISH);
+    if (result != LE_OK)
+    {
+        return LE_FAULT;
+    }
 
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
+    compressBufLength = timeSeriesPtr->zStream.total_out;
 
-    RETURN_IF_CBOR_ERROR(err);
+    //LE_DEBUG("Compressed size is: %zu", compressBufLength);
 
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
-    RETURN_IF_CBOR_ERROR(err);
+    // Gather the chunks into one buffer.
+    compressedBufPtr = le_mem_ForceAlloc(TimeSeriesPayloadPoolRef);
 
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
+    copySize = 0;
+    linkPtr = le_sls_Peek(&timeSeriesPtr->chunkList);
 
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
+    while ((linkPtr != NULL) && (copySize < compressBufLength))
+    {
+        size_t chunkSize = compressBufLength - copySize;
 
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
+        if (chunkSize > TIME_SERIES_CHUNK_NUMBYTES)
+        {
+            chunkSize = TIME_SERIES_CHUNK_NUMBYTES;
+        }
 
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
+        memcpy(compressedBufPtr + copySize,
+               CONTAINER_OF(linkPtr, TimeSeriesChunk_t, link)->data,
+               chunkSize);
+        copySize += chunkSize;
 
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
+        linkPtr = le_sls_PeekNext(&timeSeriesPtr->chunkList, linkPtr);
+    }
 
-    compressBufLength = defstream.total_out;
+    //LE_DUMP(compressedBufPtr, compressBufLength);
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+    // Earlier time series still in the spool go first, so the server gets them in order.
+    if ((CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE) || !tsSpool_IsEmpty())
+    {
+        isSpooled = (SpoolTimeSeries(instanceRef, fieldDataPtr, compressedBufPtr,
+                                     compressBufLength) == LE_OK);
+    }
 
-    // Send the delta encoded + CBOR encoded + Zipped data to the server.
-    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                instanceRef->assetDataPtr->assetId,
-                                -1,
-                                -1,
-                                PA_AVC_OPTYPE_NOTIFY,
-                                SIERRA_CBOR_ENCODING,
-                                fieldDataPtr->token,
-                                fieldDataPtr->tokenLength);
+    if (isSpooled)
+    {
+        StartTimeSeriesDrain();
+    }
+    else if (CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE)
+    {
+        NotifyTimeSeries(instanceRef->assetDataPtr->appName, instanceRef->assetDataPtr->assetId,
+                         fieldDataPtr, compressedBufPtr, compressBufLength);
+    }
+    else
+    {
+        LE_ERROR("Session unavailable; dropping time series of field %d.", fieldId);
+    }
 
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+    le_mem_Release(compressedBufPtr);
 
     // Stop time series.
     result = StopTimeSeries(instanceRef, fieldId);
@@ -1646,6 +2522,10 @@ le_result_t GetTimeSeriesStatus
 /**
  * Add the sampled data in to the CBOR sample array.
  *
+ * The time stamp and the value are scaled by their factors, then the difference from the previous
+ * entry's scaled values is encoded (CBOR encodes small integers in fewer bytes).  Scaling before
+ * taking the difference means rounding errors don't add up from one entry to the next.
+ *
  * @return:
  *      - LE_OK on success
  *      - LE_FAULT on any other error
@@ -1662,27 +2542,17 @@ static le_result_t TimeSeriesAddEntry
 
 #ifdef LEGATO_FEATURE_TIMESERIES
 
+    TimeSeriesData_t* timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
+    uint8_t entryBuf[TIME_SERIES_ENTRY_NUMBYTES];
+    size_t entrySize;
+    CborEncoder entryRef;
     CborError err;
-    uint64_t timeStamp;
-    int intDelta;
+    le_result_t result;
+    int64_t timeStamp;
+    int64_t scaledValue = 0;
     double floatDelta;
-    size_t currentSize;
     struct timeval tv;
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_OVERFLOW;
-    }
-
     // Get current system time if utc milli seconds is not provided.
     // The time stamp is expected in UTC milli seconds by the server.
     if (utcMilliSec == 0)
@@ -1691,77 +2561,77 @@ static le_result_t TimeSeriesAddEntry
         utcMilliSec = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
     }
 
+    // The entry is encoded on its own, as part of the sample array started by StartTimeSeries().
+    cbor_encoder_init(&entryRef, entryBuf, sizeof(entryBuf), 0);
+
     // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+    timeStamp = (int64_t)(utcMilliSec * timeSeriesPtr->timeStampFactor);
+
+    if (timeSeriesPtr->numElements == 0)
     {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        err = cbor_encode_int(&entryRef, timeStamp);
     }
     else
     {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        err = cbor_encode_int(&entryRef, timeStamp - timeSeriesPtr->prevTimeStamp);
     }
-
-    // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
-
     // Add the data to sample array.
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+            scaledValue = (int64_t)(fieldDataPtr->intValue * timeSeriesPtr->factor);
+
+            if (timeSeriesPtr->numElements == 0)
             {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
+                err = cbor_encode_int(&entryRef, scaledValue);
             }
             else
             {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
+                err = cbor_encode_int(&entryRef, scaledValue - timeSeriesPtr->prevScaledValue);
             }
-
-            //LE_DEBUG("intDelta = %d", intDelta);
-
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
             break;
 
         case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
+            err = cbor_encode_boolean(&entryRef, fieldDataPtr->boolValue);
             break;
 
         case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
+            err = cbor_encode_text_string(&entryRef,
                                           fieldDataPtr->strValuePtr,
                                           strlen(fieldDataPtr->strValuePtr));
             break;
 
         case DATA_TYPE_FLOAT:
             // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
+            if ((uint64_t)timeSeriesPtr->factor == 1)
             {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
+                if (timeSeriesPtr->numElements == 0)
+                {
+                    floatDelta = fieldDataPtr->floatValue;
+                }
+                else
+                {
+                    floatDelta = fieldDataPtr->floatValue - timeSeriesPtr->prevFloatValue;
+                }
+
+                err = cbor_encode_double(&entryRef, floatDelta);
             }
             else
             {
                 LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
+                scaledValue = (int64_t)(fieldDataPtr->floatValue * timeSeriesPtr->factor);
+
+                if (timeSeriesPtr->numElements == 0)
+                {
+                    err = cbor_encode_int(&entryRef, scaledValue);
+                }
+                else
+                {
+                    err = cbor_encode_int(&entryRef, scaledValue - timeSeriesPtr->prevScaledValue);
+                }
             }
-
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
             break;
 
         case DATA_TYPE_NONE:
@@ -1771,19 +2641,42 @@ static le_result_t TimeSeriesAddEntry
 
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->numElements++;
+    entrySize = cbor_encoder_get_buffer_size(&entryRef, entryBuf);
+
+    // Make sure the entry, and the bytes needed to close the stream, fit in the budget.
+    if (!TimeSeriesHasRoom(timeSeriesPtr, entrySize))
+    {
+        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
+        LE_DEBUG("compressedSize = %lu.", timeSeriesPtr->zStream.total_out);
+
+        return LE_OVERFLOW;
+    }
+
+    result = TimeSeriesDeflate(timeSeriesPtr, entryBuf, entrySize, Z_NO_FLUSH);
+    if (result != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    timeSeriesPtr->prevTimeStamp = timeStamp;
 
+    if (fieldDataPtr->type == DATA_TYPE_FLOAT && (uint64_t)timeSeriesPtr->factor == 1)
+    {
+        timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
+    }
+    else
+    {
+        timeSeriesPtr->prevScaledValue = scaledValue;
+    }
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
+    timeSeriesPtr->numElements++;
 
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
+    // The stream has to be flushed if there's no room for another entry.
+    if (!TimeSeriesHasRoom(timeSeriesPtr, TimeSeriesMaxEntrySize(fieldDataPtr)))
     {
         LE_WARN("Time series buffer full; flush and restart time series on field %d.",
                  fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
+        LE_DEBUG("compressedSize = %lu.", timeSeriesPtr->zStream.total_out);
 
         return LE_NO_MEMORY;
     }
@@ -1797,6 +2690,40 @@ static le_result_t TimeSeriesAddEntry
 
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the sampled data to the time series of a field.
+ *
+ * While the session is unavailable, a full time series of an observed field is spooled and
+ * restarted, rather than left for the app to push, so recording carries on without bound (see
+ * PushTimeSeries()).
+ *
+ * @return:
+ *      - As TimeSeriesAddEntry()
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t TimeSeriesRecordEntry
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance of the field
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field of the time series
+    uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
+)
+{
+    le_result_t result = TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+
+    if (   ((result == LE_NO_MEMORY) || (result == LE_OVERFLOW))
+        && (CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE)
+        && fieldDataPtr->isObserve
+        && (PushTimeSeries(instanceRef, fieldDataPtr->fieldId, true) == LE_OK))
+    {
+        // The entry that didn't fit goes into the restarted time series.
+        result = (result == LE_OVERFLOW) ? TimeSeriesAddEntry(fieldDataPtr, utcMilliSec) : LE_OK;
+    }
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check if a registered handler exists for a field read action.
@@ -2020,8 +2947,8 @@ static void PrintAssetMap
 
     while ( le_hashmap_NextNode(iterRef) == LE_OK )
     {
-        nameIdPtr = le_hashmap_GetKey(iterRef);
         assetDataPtr = le_hashmap_GetValue(iterRef);
+        nameIdPtr = assetDataPtr->nameId;
 
         // Print out asset data block, and all its instances.
         PRINT_VALUE(0, "%s", nameIdPtr);
@@ -2045,75 +2972,508 @@ static void PrintAssetMap
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the integer value for the specified field
- *
- * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_FAULT on any other error
+ * Get the minimum number of seconds between notifications for a field: the pmin attribute given
+ * by the server, or the default if there isn't one.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetInt
+static int GetNotifyPmin
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to read
-    int* valuePtr,                              ///< [OUT] The value read
-    bool isClient                               ///< [IN] Is it client or server access
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr               ///< [IN] Field to check
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+    if ( fieldDataPtr->notifyPmin >= 0 )
     {
-        return result;
+        return fieldDataPtr->notifyPmin;
     }
 
-    //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
-    //LE_PRINT_VALUE("%s", fieldDataPtr->name);
-
-    if ( fieldDataPtr->type != DATA_TYPE_INT )
+    if ( strcmp(instanceRef->assetDataPtr->appName, "lwm2m") == 0 )
     {
-        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
+        return 0;
     }
 
-    // Call any registered handlers to be notified of read
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
-
-    // Get the value and return it
-    *valuePtr = fieldDataPtr->intValue;
-    return LE_OK;
+    return DEFAULT_NOTIFY_PMIN_SEC;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the float value for the specified field
+ * Get the value of a numeric field as a double, for comparing with the step attribute.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_FAULT on any other error
+ *      - true if the field is numeric
+ *      - false otherwise
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetFloat
+static bool GetNumericValue
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to read
-    double* valuePtr,                           ///< [OUT] The value read
-    bool isClient                               ///< [IN] Is it client or server access
+    FieldData_t* fieldDataPtr,              ///< [IN] Field to read
+    double* valuePtr                        ///< [OUT] Field value
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+    switch ( fieldDataPtr->type )
     {
-        return result;
-    }
+        case DATA_TYPE_INT:
+            *valuePtr = fieldDataPtr->intValue;
+            return true;
+
+        case DATA_TYPE_FLOAT:
+            *valuePtr = fieldDataPtr->floatValue;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * (Re)start the notify timer of a field, creating it if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartNotifyTimer
+(
+    FieldData_t* fieldDataPtr,              ///< [IN] Field to notify when the timer expires
+    le_clk_Time_t interval                  ///< [IN] Time until the timer expires
+)
+{
+    if ( fieldDataPtr->notifyTimerRef == NULL )
+    {
+        fieldDataPtr->notifyTimerRef = le_timer_Create("Notify timer");
+        le_timer_SetHandler(fieldDataPtr->notifyTimerRef, NotifyTimerHandler);
+        le_timer_SetContextPtr(fieldDataPtr->notifyTimerRef, fieldDataPtr);
+    }
+
+    le_timer_SetInterval(fieldDataPtr->notifyTimerRef, interval);
+    le_timer_Restart(fieldDataPtr->notifyTimerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take note that the server has just been sent the value of a field, and schedule the next
+ * notification if the field has a pmax attribute.  Per LWM2M, pmax is ignored if it's less than
+ * pmin.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordNotify
+(
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr               ///< [IN] Field that was notified
+)
+{
+    fieldDataPtr->lastNotifyTime = le_clk_GetRelativeTime();
+    fieldDataPtr->isNotifyDeferred = false;
+    GetNumericValue(fieldDataPtr, &fieldDataPtr->lastNotifyValue);
+
+    if ( (fieldDataPtr->notifyPmax > 0) &&
+         (fieldDataPtr->notifyPmax >= GetNotifyPmin(instanceRef, fieldDataPtr)) )
+    {
+        StartNotifyTimer(fieldDataPtr, (le_clk_Time_t){ .sec=fieldDataPtr->notifyPmax, .usec=0 });
+    }
+    else if ( fieldDataPtr->notifyTimerRef != NULL )
+    {
+        le_timer_Stop(fieldDataPtr->notifyTimerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the step and pmin attributes of a field to a change of its value.  If the value hasn't
+ * changed by at least step since it was last notified, it isn't notified.  If it was last notified
+ * less than pmin ago, the notify timer is started to notify it once pmin has passed, so however
+ * often the value changes, the latest value is sent at most once every pmin seconds.
+ *
+ * @return:
+ *      - true if the change should be notified now
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ThrottleNotify
+(
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr               ///< [IN] Field that changed
+)
+{
+    double value;
+    double delta;
+    int pmin;
+
+    if ( (fieldDataPtr->notifyStep > 0) && GetNumericValue(fieldDataPtr, &value) )
+    {
+        delta = value - fieldDataPtr->lastNotifyValue;
+
+        if ( (delta < fieldDataPtr->notifyStep) && (-delta < fieldDataPtr->notifyStep) )
+        {
+            LE_DEBUG("Change of resource %d is less than step", fieldDataPtr->fieldId);
+            return false;
+        }
+    }
+
+    // Already waiting for pmin to pass; the latest value will be sent then.
+    if ( fieldDataPtr->isNotifyDeferred )
+    {
+        return false;
+    }
+
+    pmin = GetNotifyPmin(instanceRef, fieldDataPtr);
+
+    if ( pmin > 0 )
+    {
+        le_clk_Time_t now = le_clk_GetRelativeTime();
+        le_clk_Time_t dueTime = le_clk_Add(fieldDataPtr->lastNotifyTime,
+                                           (le_clk_Time_t){ .sec=pmin, .usec=0 });
+
+        if ( le_clk_GreaterThan(dueTime, now) )
+        {
+            LE_DEBUG("Deferring notify of resource %d for pmin", fieldDataPtr->fieldId);
+            fieldDataPtr->isNotifyDeferred = true;
+            StartNotifyTimer(fieldDataPtr, le_clk_Sub(dueTime, now));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send an observe notification for a single changed field.  The server sends notify on entire
+ * object, so we need to send the TLV of entire object but include only the resource that changed.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendFieldNotify
+(
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr               ///< [IN] Field that changed
+)
+{
+    le_result_t result;
+    uint8_t valueData[256+1];
+    size_t bytesWritten;
+    pa_avc_LWM2MOperationDataRef_t opRef;
+    assetData_AssetDataRef_t assetRef;
+
+    result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
+                                       instanceRef->assetDataPtr->assetId,
+                                       &assetRef);
+
+    if ( result == LE_OK)
+    {
+#ifdef LEGATO_FEATURE_TIMESERIES
+        if ( NotifyContentType == SENML_CBOR_ENCODING )
+        {
+            result = WriteInstanceToSenmlCbor(instanceRef,
+                                              fieldDataPtr->fieldId,
+                                              valueData,
+                                              sizeof(valueData),
+                                              &bytesWritten);
+        }
+        else
+#endif
+        {
+            result = WriteNotifyObjectToTLV(assetRef,
+                                            instanceRef->instanceId,
+                                            fieldDataPtr->fieldId,
+                                            valueData,
+                                            sizeof(valueData),
+                                            &bytesWritten);
+        }
+        if ( result != LE_OK )
+        {
+            LE_ERROR("Failed to send lwm2m notification.");
+            return LE_FAULT;
+        }
+
+        opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                    instanceRef->assetDataPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    NotifyContentType,
+                                    fieldDataPtr->token,
+                                    fieldDataPtr->tokenLength);
+
+        pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+        RecordNotifyPayload(NotifyContentType, bytesWritten);
+        RecordNotify(instanceRef, fieldDataPtr);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the notify timer of a field expires: either pmin has passed since a change was
+ * deferred, or pmax has passed since the value was last notified.  Either way, the current value
+ * is notified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyTimerHandler
+(
+    le_timer_Ref_t timerRef                 ///< [IN] Timer that expired
+)
+{
+    FieldData_t* fieldDataPtr = le_timer_GetContextPtr(timerRef);
+    InstanceData_t* instanceRef = (InstanceData_t*)fieldDataPtr->key.ownerPtr;
+
+    if ( !fieldDataPtr->isObserve )
+    {
+        fieldDataPtr->isNotifyDeferred = false;
+        return;
+    }
+
+    // Leave it to the batch in progress; it will be notified when the batch is committed.
+    if ( instanceRef->batchDepth > 0 )
+    {
+        fieldDataPtr->isNotifyDeferred = false;
+        fieldDataPtr->isNotifyPending = true;
+        return;
+    }
+
+    SendFieldNotify(instanceRef, fieldDataPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the server that an observed field has been changed by the client.  If a batch of updates
+ * is in progress on the instance, the notification is held back until the batch is committed.
+ * Otherwise it's subject to the field's step and pmin attributes (see ThrottleNotify()).
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t NotifyFieldChange
+(
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr               ///< [IN] Field that changed
+)
+{
+    if ( instanceRef->batchDepth > 0 )
+    {
+        fieldDataPtr->isNotifyPending = true;
+        return LE_OK;
+    }
+
+    if ( !ThrottleNotify(instanceRef, fieldDataPtr) )
+    {
+        return LE_OK;
+    }
+
+    return SendFieldNotify(instanceRef, fieldDataPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the notifications held back during a batch of updates: a single notification with all the
+ * changed fields, or one per field if they don't all fit in one.  Fields whose change doesn't pass
+ * their step and pmin attributes are left out, as for a single change (see ThrottleNotify()).
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t NotifyPendingFields
+(
+    InstanceData_t* instanceRef             ///< [IN] Asset instance that was updated
+)
+{
+    le_result_t result;
+    uint8_t valueData[BATCH_NOTIFY_NUMBYTES];
+    size_t bytesWritten;
+    pa_avc_LWM2MOperationDataRef_t opRef;
+    FieldData_t* fieldDataPtr;
+    FieldData_t* firstFieldDataPtr = NULL;
+    le_dls_Link_t* linkPtr;
+    bool isSentTogether = false;
+
+    // Find the first field with a notification still to be sent now; its observe token is used
+    // for the notification, as all the fields of an instance are observed by the same request.
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isNotifyPending &&
+             !(fieldDataPtr->isObserve && ThrottleNotify(instanceRef, fieldDataPtr)) )
+        {
+            fieldDataPtr->isNotifyPending = false;
+        }
+
+        if ( fieldDataPtr->isNotifyPending && (firstFieldDataPtr == NULL) )
+        {
+            firstFieldDataPtr = fieldDataPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    if ( firstFieldDataPtr == NULL )
+    {
+        return LE_OK;
+    }
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+    if ( NotifyContentType == SENML_CBOR_ENCODING )
+    {
+        result = WriteInstanceToSenmlCbor(instanceRef,
+                                          -1,
+                                          valueData,
+                                          sizeof(valueData),
+                                          &bytesWritten);
+    }
+    else
+#endif
+    {
+        result = WriteNotifyPendingToTLV(instanceRef, valueData, sizeof(valueData), &bytesWritten);
+    }
+
+    if ( result == LE_OK )
+    {
+        opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                    instanceRef->assetDataPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    NotifyContentType,
+                                    firstFieldDataPtr->token,
+                                    firstFieldDataPtr->tokenLength);
+
+        pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+        RecordNotifyPayload(NotifyContentType, bytesWritten);
+        isSentTogether = true;
+    }
+    else if ( result == LE_OVERFLOW )
+    {
+        LE_DEBUG("Batch too large for one notification; notifying each field separately.");
+        result = LE_OK;
+
+        linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+        while ( linkPtr != NULL )
+        {
+            fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+            if ( fieldDataPtr->isNotifyPending && fieldDataPtr->isObserve &&
+                 (SendFieldNotify(instanceRef, fieldDataPtr) != LE_OK) )
+            {
+                result = LE_FAULT;
+            }
+
+            linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+        }
+    }
+    else
+    {
+        LE_ERROR("Failed to send lwm2m notification.");
+        result = LE_FAULT;
+    }
+
+    // Whatever happened, the notifications are no longer pending.
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( isSentTogether && fieldDataPtr->isNotifyPending )
+        {
+            RecordNotify(instanceRef, fieldDataPtr);
+        }
+
+        fieldDataPtr->isNotifyPending = false;
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the integer value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInt
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to read
+    int* valuePtr,                              ///< [OUT] The value read
+    bool isClient                               ///< [IN] Is it client or server access
+)
+{
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
+
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
+    //LE_PRINT_VALUE("%s", fieldDataPtr->name);
+
+    if ( fieldDataPtr->type != DATA_TYPE_INT )
+    {
+        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
+        return LE_FAULT;
+    }
+
+    // Call any registered handlers to be notified of read
+    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+
+    // Get the value and return it
+    *valuePtr = fieldDataPtr->intValue;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the float value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFloat
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to read
+    double* valuePtr,                           ///< [OUT] The value read
+    bool isClient                               ///< [IN] Is it client or server access
+)
+{
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
+
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
 
     if ( fieldDataPtr->type != DATA_TYPE_FLOAT )
     {
@@ -2157,7 +3517,6 @@ static le_result_t SetInt
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     int prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
 
@@ -2200,43 +3559,15 @@ static le_result_t SetInt
     // not enabled send the observe notification right away.
     if (fieldDataPtr->timeSeriesPtr != NULL)
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        return TimeSeriesRecordEntry(instanceRef, fieldDataPtr, utcMilliSec);
     }
 
     // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
+        if ( NotifyFieldChange(instanceRef, fieldDataPtr) != LE_OK )
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            return LE_FAULT;
         }
     }
 
@@ -2272,7 +3603,6 @@ static le_result_t SetFloat
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     float prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2314,43 +3644,15 @@ static le_result_t SetFloat
     // not enabled send the observe notification right away.
     if (fieldDataPtr->timeSeriesPtr != NULL)
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        return TimeSeriesRecordEntry(instanceRef, fieldDataPtr, utcMilliSec);
     }
 
     // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
+        if ( NotifyFieldChange(instanceRef, fieldDataPtr) != LE_OK )
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            return LE_FAULT;
         }
     }
 
@@ -2427,7 +3729,6 @@ static le_result_t SetBool
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     bool prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2469,43 +3770,15 @@ static le_result_t SetBool
     // not enabled send the observe notification right away.
     if (fieldDataPtr->timeSeriesPtr != NULL)
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        return TimeSeriesRecordEntry(instanceRef, fieldDataPtr, utcMilliSec);
     }
 
     // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
+        if ( NotifyFieldChange(instanceRef, fieldDataPtr) != LE_OK )
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            return LE_FAULT;
         }
     }
 
@@ -2585,7 +3858,6 @@ static le_result_t SetString
     uint8_t valueData[256+1];  // +1 for null byte, if storing a string
     size_t bytesWritten;
     char prevStr[STRING_VALUE_NUMBYTES];
-    pa_avc_LWM2MOperationDataRef_t opRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2627,43 +3899,15 @@ static le_result_t SetString
     // not enabled send the observe notification right away.
     if (fieldDataPtr->timeSeriesPtr != NULL)
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        return TimeSeriesRecordEntry(instanceRef, fieldDataPtr, utcMilliSec);
     }
 
     // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && strcmp(prevStr, strPtr) != 0 && isClient == true)
     {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
+        if ( NotifyFieldChange(instanceRef, fieldDataPtr) != LE_OK )
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
+            return LE_FAULT;
         }
     }
 
@@ -2716,8 +3960,8 @@ static le_result_t GetAssetList
 
     while ( le_hashmap_NextNode(iterRef) == LE_OK )
     {
-        nameIdPtr = le_hashmap_GetKey(iterRef);
         assetDataPtr = le_hashmap_GetValue(iterRef);
+        nameIdPtr = assetDataPtr->nameId;
 
         // Server expects app names to have "le_" prefix.  The app name is the first part of
         // nameIdPtr, up to the first '/', unless it is "lwm2m" or "legato", which are not apps.
@@ -2871,6 +4115,10 @@ void assetData_SessionStatus
     {
         le_timer_Restart(RegUpdateTimerRef);
     }
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+    StartTimeSeriesDrain();
+#endif
 }
 
 
@@ -2923,7 +4171,60 @@ void assetData_RegistrationUpdate
 }
 
 
-
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the content type used for the observe notifications of asset instances.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_UNSUPPORTED if the content type is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyContentType
+(
+    uint16_t contentType                    ///< [IN] TLV_ENCODING or SENML_CBOR_ENCODING
+)
+{
+    switch ( contentType )
+    {
+        case TLV_ENCODING:
+            break;
+
+        case SENML_CBOR_ENCODING:
+#ifndef LEGATO_FEATURE_TIMESERIES
+            // The CBOR encoder is only built along with the time series.
+            return LE_UNSUPPORTED;
+#endif
+            break;
+
+        default:
+            return LE_UNSUPPORTED;
+    }
+
+    NotifyContentType = contentType;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedules a registration update. The update is only sent once no other update has been
+ * scheduled for the RegUpdate timer interval, so that the changes of several apps are reported
+ * to the server together.
+ */
+//--------------------------------------------------------------------------------------------------
+void assetData_ScheduleRegistrationUpdate
+(
+    void
+)
+{
+    // Start or restart the timer; will only report to the modem when the timer expires.
+    le_timer_Restart(RegUpdateTimerRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a registration update if observe is not enabled. A registration update would also be sent
@@ -3016,29 +4317,32 @@ le_result_t assetData_CreateInstanceById
     }
     else
     {
-        le_cfg_IteratorRef_t assetCfg;
-
-        // Open a config read transaction for the asset model
-        if ( OpenModelFromConfig(appNamePtr, assetId, &assetCfg) != LE_OK )
+        // The model is only read from the configDB for the first instance of the asset
+        if ( !assetDataPtr->isModelCompiled )
         {
-            return LE_FAULT;
-        }
+            le_cfg_IteratorRef_t assetCfg;
 
-        // Allocate instance data; will be released if errors are found
-        assetInstPtr = le_mem_ForceAlloc(InstanceDataPoolRef);
+            // Open a config read transaction for the asset model
+            if ( OpenModelFromConfig(appNamePtr, assetId, &assetCfg) != LE_OK )
+            {
+                return LE_FAULT;
+            }
 
-        // Populate most of the instance from the model definition
-        result = CreateInstanceFromModel(assetCfg, assetInstPtr);
+            result = CompileModel(assetCfg, assetDataPtr);
 
-        // Regardless of success/failure, stop the transaction
-        le_cfg_CancelTxn(assetCfg);
+            // Regardless of success/failure, stop the transaction
+            le_cfg_CancelTxn(assetCfg);
 
-        if ( result != LE_OK )
-        {
-            // todo: Need to release all allocated fields as well as asset instance
-            LE_ERROR("Error in reading model");
-            return LE_FAULT;
+            if ( result != LE_OK )
+            {
+                LE_ERROR("Error in reading model");
+                return LE_FAULT;
+            }
         }
+
+        // Populate most of the instance from the model definition
+        assetInstPtr = le_mem_ForceAlloc(InstanceDataPoolRef);
+        CreateInstanceFromModel(assetDataPtr, assetInstPtr);
     }
 
     // Everything is okay, so finish initializing the instance data, and store it
@@ -3062,9 +4366,11 @@ le_result_t assetData_CreateInstanceById
 
     // Add back reference from instance data to the asset containing the instance
     assetInstPtr->assetDataPtr = assetDataPtr;
+    assetInstPtr->batchDepth = 0;
 
 
     le_dls_Queue(&assetDataPtr->instanceList, &assetInstPtr->link);
+    AddInstanceToMaps(assetInstPtr);
 
     // todo: For now, for testing, print it out; add trace support later.
     if ( 0 )
@@ -3080,8 +4386,7 @@ le_result_t assetData_CreateInstanceById
 
     LE_DEBUG("Schedule a registration update after asset creation.");
 
-    // Start or restart the timer; will only report to the modem when the timer expires.
-    le_timer_Restart(RegUpdateTimerRef);
+    assetData_ScheduleRegistrationUpdate();
 
     return LE_OK;
 }
@@ -3175,6 +4480,9 @@ void assetData_DeleteInstance
     {
         fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
 
+        le_hashmap_Remove(FieldMap, &fieldDataPtr->key);
+        le_hashmap_Remove(FieldMapByName, &fieldDataPtr->nameKey);
+
         // Some field types have allocated data, so release that first
         switch ( fieldDataPtr->type )
         {
@@ -3187,12 +4495,18 @@ void assetData_DeleteInstance
                 break;
         }
 
+#ifdef LEGATO_FEATURE_TIMESERIES
         // Release Time Series resources.
         if (fieldDataPtr->timeSeriesPtr != NULL)
         {
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+            ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
+        }
+#endif
+
+        if (fieldDataPtr->notifyTimerRef != NULL)
+        {
+            le_timer_Delete(fieldDataPtr->notifyTimerRef);
         }
 
         // Release the field.
@@ -3204,6 +4518,7 @@ void assetData_DeleteInstance
 
     // Remove the instance from the asset instance list
     le_dls_Remove(&instanceRef->assetDataPtr->instanceList, &instanceRef->link);
+    le_hashmap_Remove(InstanceMap, &instanceRef->key);
 
     // Lastly, release the instance data.
     le_mem_Release(instanceRef);
@@ -3266,30 +4581,32 @@ void assetData_DeleteInstanceAndAsset
         }
 
 
+        /*
+         * Release all items in fieldModelList, so that the model is read again from the configDB
+         * if the asset is created again, e.g. after its app was updated
+         */
+
+        linkPtr = le_dls_Pop(&assetDataPtr->fieldModelList);
+
+        while ( linkPtr != NULL )
+        {
+            le_mem_Release(CONTAINER_OF(linkPtr, FieldModel_t, link));
+
+            linkPtr = le_dls_Pop(&assetDataPtr->fieldModelList);
+        }
+
+
         /*
          * Remove the asset data from the AssetMaps
          */
 
-        char appNameAssetId[100];
-        char* appNameAssetIdKeyPtr;
         char appNameAssetName[100];
         char* appNameAssetNameKeyPtr;
 
-        if ( FormatString(appNameAssetId,
-                          sizeof(appNameAssetId),
-                          "%s/%i",
-                          assetDataPtr->appName,
-                          assetDataPtr->assetId) == LE_OK )
-        {
-            // The key stored in the hashmap also has to be released, so get it first, before
-            // removing the data from the hashmap.
-            appNameAssetIdKeyPtr = le_hashmap_GetStoredKey(AssetMap, appNameAssetId);
-            le_hashmap_Remove(AssetMap, appNameAssetId);
-            le_mem_Release(appNameAssetIdKeyPtr);
-        }
+        le_hashmap_Remove(AssetMap, &assetDataPtr->key);
 
         if ( FormatString(appNameAssetName,
-                          sizeof(appNameAssetId),
+                          sizeof(appNameAssetName),
                           "%s/%s",
                           assetDataPtr->appName,
                           assetDataPtr->assetName) == LE_OK )
@@ -3550,43 +4867,16 @@ le_result_t assetData_GetFieldIdFromName
     int* fieldIdPtr                             ///< [OUT] The field id
 )
 {
-    /*
-     * NOTE:
-     *   The main use for this function is to get the fieldId that is then passed to the various
-     *   assetData_client_Get* functions.  This is not particularly efficient as it requires
-     *   iterating twice through the field list.  One alternative would be to add a new set of
-     *   assetData_client_Get* functions that take a field name instead of field id.
-     *
-     *   For now, assume that the performance is good enough, but if it becomes an issue then
-     *   this second set of functions may need to be added.  Of course, there might also be some
-     *   other alternative solution that has not yet been considered.
-     */
-
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
-
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceRef->fieldList);
-
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->appName);
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->assetName);
+    ItemNameKey_t key = { .ownerPtr = instanceRef, .namePtr = fieldNamePtr };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldMapByName, &key);
 
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr == NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%s", fieldDataPtr->name);
-
-        if ( strcmp(fieldDataPtr->name, fieldNamePtr) == 0 )
-        {
-            *fieldIdPtr = fieldDataPtr->fieldId;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceRef->fieldList, fieldLinkPtr);
+        return LE_FAULT;
     }
 
-    return LE_FAULT;
+    *fieldIdPtr = fieldDataPtr->fieldId;
+    return LE_OK;
 }
 
 
@@ -4000,6 +5290,53 @@ le_result_t assetData_client_IsObserve
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of updates to the fields of an asset instance.  Observe notifications for fields
+ * set during the batch are held back until the batch is committed.  Batches may be nested.
+ */
+//--------------------------------------------------------------------------------------------------
+void assetData_client_BeginBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+)
+{
+    instanceRef->batchDepth++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit a batch of updates started with assetData_client_BeginBatch().  When the outermost batch
+ * is committed, the server is sent one notification with all the observed fields that were set.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_CLOSED if no batch was in progress
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_CommitBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+)
+{
+    if ( instanceRef->batchDepth == 0 )
+    {
+        return LE_CLOSED;
+    }
+
+    instanceRef->batchDepth--;
+
+    if ( instanceRef->batchDepth > 0 )
+    {
+        return LE_OK;
+    }
+
+    return NotifyPendingFields(instanceRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a handler to be notified on field actions, such as write or execute
@@ -4527,16 +5864,19 @@ le_result_t assetData_Init
     AssetDataPoolRef = le_mem_CreatePool("Asset data pool", sizeof(AssetData_t));
     ActionHandlerDataPoolRef = le_mem_CreatePool("Action handler data pool",
                                                  sizeof(ActionHandlerData_t));
+    FieldModelPoolRef = le_mem_CreatePool("Field model pool", sizeof(FieldModel_t));
 
     // Memory pool for time series data.
     TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
-    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+    TimeSeriesChunkPoolRef = le_mem_CreatePool("TimeSeries chunk pool", sizeof(TimeSeriesChunk_t));
+    TimeSeriesPayloadPoolRef = le_mem_CreatePool("TimeSeries payload pool",
+                                                 TIME_SERIES_MAX_CHUNKS * TIME_SERIES_CHUNK_NUMBYTES);
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
 
     // Create AssetMap that maps (appName, assetId) to an AssetData block.
-    AssetMap = le_hashmap_Create("Asset Map", 31, le_hashmap_HashString, le_hashmap_EqualsString);
+    AssetMap = le_hashmap_Create("Asset Map", 31, HashAssetKey, EqualsAssetKey);
 
     // Create AssetMapByName that maps (appName, assetName) to an AssetData block.
     AssetMapByName = le_hashmap_Create("AssetNameIdMap",
@@ -4544,6 +5884,15 @@ le_result_t assetData_Init
                                        le_hashmap_HashString,
                                        le_hashmap_EqualsString);
 
+    // Create the instance and field indexes.  Assets can have hundreds of fields, so these are
+    // compact maps, which store their (small) keys inline.
+    InstanceMap = le_hashmap_CreateCompact("Asset Instance Map", 31, HashItemKey, EqualsItemKey);
+    FieldMap = le_hashmap_CreateCompact("Asset Field Map", 127, HashItemKey, EqualsItemKey);
+    FieldMapByName = le_hashmap_CreateCompact("Asset Field Name Map",
+                                              127,
+                                              HashItemNameKey,
+                                              EqualsItemNameKey);
+
 
     // Use a timer to delay reporting instance creation events to the modem for 15 seconds after
     // the last creation event. This allows us to aggregate multiple registration updates together.
@@ -4555,6 +5904,15 @@ le_result_t assetData_Init
     le_timer_SetInterval(RegUpdateTimerRef, timerInterval);
     le_timer_SetHandler(RegUpdateTimerRef, RegUpdateTimerHandler);
 
+#ifdef LEGATO_FEATURE_TIMESERIES
+    // Time series spooled before a restart are sent once the session is available.
+    tsSpool_Init(TIME_SERIES_MAX_CHUNKS * TIME_SERIES_CHUNK_NUMBYTES);
+
+    TimeSeriesDrainTimerRef = le_timer_Create("TimeSeries drain timer");
+    le_timer_SetMsInterval(TimeSeriesDrainTimerRef, TIME_SERIES_DRAIN_INTERVAL_MS);
+    le_timer_SetHandler(TimeSeriesDrainTimerRef, TimeSeriesDrainTimerHandler);
+#endif
+
     // Pre-load the /lwm2m/9 object into the AssetMap; don't actually need to use the assetRef here.
     assetData_AssetDataRef_t lwm2mAssetRef;
 
@@ -5004,115 +6362,343 @@ static le_result_t WriteInstanceToTLV
         result = LE_OVERFLOW;
     }
 
-    return result;
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write TLV with all instances of the LWM2M Object to the given buffer.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_WriteObjectToTLV
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for all fields
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the header
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    le_result_t result;
+    size_t numBytesWritten;
+    le_dls_Link_t* linkPtr;
+    InstanceData_t* instancePtr;
+
+    // total bytes written will be (bufPtr-startBufPtr)
+    uint8_t* startBufPtr = bufPtr;
+
+    // buffer size will be (endBufPtr-bufPtr);
+    uint8_t* endBufPtr = bufPtr+bufNumBytes;
+
+    // Get the start of the instance list
+    linkPtr = le_dls_Peek(&assetRef->instanceList);
+
+    // Loop through the asset instances
+    while ( linkPtr != NULL )
+    {
+        instancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
+
+        result = WriteInstanceToTLV(instancePtr,
+                                    fieldId,
+                                    bufPtr,
+                                    endBufPtr-bufPtr,
+                                    &numBytesWritten);
+        if ( result != LE_OK )
+            return result;
+
+        bufPtr += numBytesWritten;
+
+        linkPtr = le_dls_PeekNext(&assetRef->instanceList, linkPtr);
+    }
+
+    *numBytesWrittenPtr = bufPtr-startBufPtr;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write TLV for an object but include only the instance/resource which changed. This type of
+ *  response is needed as the server sends notify on entire object, but we need to notify changes
+ *  at resource level.
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyObjectToTLV
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int instanceId,                             ///< [IN] Instance that has a changed resource
+    int fieldId,                                ///< [IN] The resource which changed
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    le_result_t result = LE_OK;
+    InstanceData_t* instancePtr;
+
+    LE_DEBUG("instanceId = %d", instanceId);
+    LE_DEBUG("fieldId = %d", fieldId);
+
+    result = GetInstanceFromAssetData(assetRef, instanceId, &instancePtr);
+
+    if (result != LE_OK)
+    {
+        LE_ERROR("Error reading instance reference result = %d.", result);
+        return LE_FAULT;
+    }
+
+    result = WriteInstanceToTLV(instancePtr,
+                                fieldId,
+                                bufPtr,
+                                bufNumBytes,
+                                numBytesWrittenPtr);
+    if (result != LE_OK)
+    {
+        LE_ERROR("Error while setting asset instance result = %d.", result);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write TLV for an object but include only the instance and the resources which have a
+ *  notification pending, i.e. the observed resources changed during a batch of updates.
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyPendingToTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the object instance
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    le_result_t result;
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    size_t totalNumBytesWritten = 0;
+    size_t numBytesWritten;
+
+    // Leave enough space for the maximum instance header size of 6 bytes.
+    if ( bufNumBytes <= 6 )
+    {
+        return LE_OVERFLOW;
+    }
+
+    // Need to write the field TLVs first, to know how many bytes will be in the instance TLV, so
+    // write them after the space reserved for the header and move them down afterwards.
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isNotifyPending && fieldDataPtr->isObserve )
+        {
+            result = WriteFieldTLV(instanceRef,
+                                   fieldDataPtr,
+                                   bufPtr + 6 + totalNumBytesWritten,
+                                   bufNumBytes - 6 - totalNumBytesWritten,
+                                   &numBytesWritten);
+            if ( result != LE_OK )
+            {
+                *numBytesWrittenPtr = 0;
+                return result;
+            }
+
+            totalNumBytesWritten += numBytesWritten;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    WriteTLVHeader(TLV_TYPE_OBJ_INST,
+                   instanceRef->instanceId,
+                   totalNumBytesWritten,
+                   bufPtr,
+                   6,
+                   &numBytesWritten);
+
+    memmove(bufPtr + numBytesWritten, bufPtr + 6, totalNumBytesWritten);
+    *numBytesWrittenPtr = numBytesWritten + totalNumBytesWritten;
+
+    return LE_OK;
 }
 
 
+#ifdef LEGATO_FEATURE_TIMESERIES
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Write TLV with all instances of the LWM2M Object to the given buffer.
+ * Write a SenML record for a field, as a CBOR map, to the given SenML pack.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_OVERFLOW if the TLV data could not fit in the buffer
- *      - LE_FAULT on any other error
+ *      - CborNoError on success
+ *      - CborErrorOutOfMemory if the record could not fit in the buffer
+ *      - Any other CBOR error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t assetData_WriteObjectToTLV
+static CborError WriteFieldSenmlRecord
 (
-    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
-    int fieldId,                                ///< [IN] Field to write, or -1 for all fields
-    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the header
-    size_t bufNumBytes,                         ///< [IN] Size of buffer
-    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+    CborEncoder* packPtr,                   ///< [IN] SenML pack (CBOR array) to add the record to
+    FieldData_t* fieldDataPtr,              ///< [IN] The field to write
+    const char* baseNamePtr                 ///< [IN] Base name to put in the record, or NULL
 )
 {
-    le_result_t result;
-    size_t numBytesWritten;
-    le_dls_Link_t* linkPtr;
-    InstanceData_t* instancePtr;
+    CborEncoder recordRef;
+    CborError err;
+    char name[12];
 
-    // total bytes written will be (bufPtr-startBufPtr)
-    uint8_t* startBufPtr = bufPtr;
+    err = cbor_encoder_create_map(packPtr, &recordRef, (baseNamePtr != NULL) ? 3 : 2);
 
-    // buffer size will be (endBufPtr-bufPtr);
-    uint8_t* endBufPtr = bufPtr+bufNumBytes;
+    if ( baseNamePtr != NULL )
+    {
+        err |= cbor_encode_int(&recordRef, SENML_LABEL_BASE_NAME);
+        err |= cbor_encode_text_stringz(&recordRef, baseNamePtr);
+    }
 
-    // Get the start of the instance list
-    linkPtr = le_dls_Peek(&assetRef->instanceList);
+    snprintf(name, sizeof(name), "%d", fieldDataPtr->fieldId);
+    err |= cbor_encode_int(&recordRef, SENML_LABEL_NAME);
+    err |= cbor_encode_text_stringz(&recordRef, name);
 
-    // Loop through the asset instances
-    while ( linkPtr != NULL )
+    switch ( fieldDataPtr->type )
     {
-        instancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
+        case DATA_TYPE_INT:
+            err |= cbor_encode_int(&recordRef, SENML_LABEL_VALUE);
+            err |= cbor_encode_int(&recordRef, fieldDataPtr->intValue);
+            break;
 
-        result = WriteInstanceToTLV(instancePtr,
-                                    fieldId,
-                                    bufPtr,
-                                    endBufPtr-bufPtr,
-                                    &numBytesWritten);
-        if ( result != LE_OK )
-            return result;
+        case DATA_TYPE_BOOL:
+            err |= cbor_encode_int(&recordRef, SENML_LABEL_BOOL);
+            err |= cbor_encode_boolean(&recordRef, fieldDataPtr->boolValue);
+            break;
 
-        bufPtr += numBytesWritten;
+        case DATA_TYPE_STRING:
+            err |= cbor_encode_int(&recordRef, SENML_LABEL_STRING);
+            err |= cbor_encode_text_stringz(&recordRef, fieldDataPtr->strValuePtr);
+            break;
 
-        linkPtr = le_dls_PeekNext(&assetRef->instanceList, linkPtr);
+        case DATA_TYPE_FLOAT:
+            err |= cbor_encode_int(&recordRef, SENML_LABEL_VALUE);
+            err |= cbor_encode_double(&recordRef, fieldDataPtr->floatValue);
+            break;
+
+        case DATA_TYPE_NONE:
+            LE_ERROR("No data to read");
+            return CborErrorUnknownType;
     }
 
-    *numBytesWrittenPtr = bufPtr-startBufPtr;
-    return LE_OK;
+    err |= cbor_encoder_close_container(packPtr, &recordRef);
+
+    return err;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Write TLV for an object but include only the instance/resource which changed. This type of
- *  response is needed as the server sends notify on entire object, but we need to notify changes
- *  at resource level.
+ *  Write a SenML CBOR pack for an object instance, to be sent in an observe notification instead
+ *  of the TLV.  Either a single field is included, or all the fields which have a notification
+ *  pending.  The base name of the first record holds the path of the instance, so the name of
+ *  each record is just the resource id.
+ *
+ *  Unlike TLV, the value sizes are not padded and the records can be written in one pass.
  *
  *  @return:
  *      - LE_OK on success
- *      - LE_FAULT on error
+ *      - LE_OVERFLOW if the SenML pack could not fit in the buffer
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteNotifyObjectToTLV
+static le_result_t WriteInstanceToSenmlCbor
 (
-    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
-    int instanceId,                             ///< [IN] Instance that has a changed resource
-    int fieldId,                                ///< [IN] The resource which changed
-    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for the fields
+                                                ///<      with a notification pending
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the SenML records
     size_t bufNumBytes,                         ///< [IN] Size of buffer
     size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
 )
 {
-    le_result_t result = LE_OK;
-    InstanceData_t* instancePtr;
-
-    LE_DEBUG("instanceId = %d", instanceId);
-    LE_DEBUG("fieldId = %d", fieldId);
+    CborEncoder streamRef;
+    CborEncoder packRef;
+    CborError err;
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    char baseName[LIMIT_MAX_PATH_BYTES];
+    const char* baseNamePtr = baseName;
 
-    result = GetInstanceFromAssetData(assetRef, instanceId, &instancePtr);
+    *numBytesWrittenPtr = 0;
 
-    if (result != LE_OK)
+    if ( FormatString(baseName,
+                      sizeof(baseName),
+                      "/%s/%i/%i/",
+                      instanceRef->assetDataPtr->appName,
+                      instanceRef->assetDataPtr->assetId,
+                      instanceRef->instanceId) != LE_OK )
     {
-        LE_ERROR("Error reading instance reference result = %d.", result);
         return LE_FAULT;
     }
 
-    result = WriteInstanceToTLV(instancePtr,
-                                fieldId,
-                                bufPtr,
-                                bufNumBytes,
-                                numBytesWrittenPtr);
-    if (result != LE_OK)
+    cbor_encoder_init(&streamRef, bufPtr, bufNumBytes, 0);
+    err = cbor_encoder_create_array(&streamRef, &packRef, CborIndefiniteLength);
+
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( (linkPtr != NULL) && (err == CborNoError) )
     {
-        LE_ERROR("Error while setting asset instance result = %d.", result);
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( (fieldId == -1) ? (fieldDataPtr->isNotifyPending && fieldDataPtr->isObserve)
+                             : (fieldDataPtr->fieldId == fieldId) )
+        {
+            err = WriteFieldSenmlRecord(&packRef, fieldDataPtr, baseNamePtr);
+            baseNamePtr = NULL;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    if ( err == CborNoError )
+    {
+        err = cbor_encoder_close_container(&streamRef, &packRef);
+    }
+
+    if ( err == CborErrorOutOfMemory )
+    {
+        LE_WARN("Overflow: oiid=%i, rid=%i", instanceRef->instanceId, fieldId);
+        return LE_OVERFLOW;
+    }
+    else if ( err != CborNoError )
+    {
+        LE_ERROR("CBOR encoding error %s", cbor_error_string(err));
         return LE_FAULT;
     }
 
+    *numBytesWrittenPtr = cbor_encoder_get_buffer_size(&streamRef, bufPtr);
+
     return LE_OK;
 }
 
+#endif // LEGATO_FEATURE_TIMESERIES
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -5386,12 +6972,31 @@ le_result_t assetData_SetObserve
                 fieldDataPtr->tokenLength = tokenLength;
                 memcpy(fieldDataPtr->token, tokenPtr, tokenLength);
             }
+
+            if (isObserve)
+            {
+                // The response to the observe request carries the current value.
+                RecordNotify(instanceRef, fieldDataPtr);
+            }
+            else if (fieldDataPtr->notifyTimerRef != NULL)
+            {
+                le_timer_Stop(fieldDataPtr->notifyTimerRef);
+                fieldDataPtr->isNotifyDeferred = false;
+            }
             result = LE_OK;
         }
 
         linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
     }
 
+#ifdef LEGATO_FEATURE_TIMESERIES
+    // Time series spooled for these fields can be sent now.
+    if (isObserve)
+    {
+        StartTimeSeriesDrain();
+    }
+#endif
+
     return result;
 }
 
@@ -5454,8 +7059,8 @@ void assetData_CancelAllObserve
 
     while ( le_hashmap_NextNode(iterRef) == LE_OK )
     {
-        nameIdPtr = le_hashmap_GetKey(iterRef);
         assetDataPtr = (AssetData_t*) le_hashmap_GetValue(iterRef);
+        nameIdPtr = assetDataPtr->nameId;
 
         // Turn off observe on this object.
         assetDataPtr->isObjectObserve = false;
@@ -5533,3 +7138,247 @@ le_result_t assetData_SetObserveAllInstances
     return LE_OK;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification attributes given by a LWM2M Write-Attributes request.  An attribute given without
+ * a value is reset to its default.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool hasPmin;                   ///< Is pmin given?
+    int pmin;                       ///< Minimum period, or -1 for the default
+    bool hasPmax;                   ///< Is pmax given?
+    int pmax;                       ///< Maximum period, or 0 for none
+    bool hasStep;                   ///< Is st given?
+    double step;                    ///< Step, or 0 for none
+}
+NotifyAttributes_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the notification attributes of a Write-Attributes request, in URI query form, e.g.
+ * "pmin=10&pmax=60&st=0.5".
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_UNSUPPORTED if an attribute other than pmin, pmax or st is given
+ *      - LE_BAD_PARAMETER if the attributes can't be parsed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseNotifyAttributes
+(
+    const uint8_t* attrPtr,                 ///< [IN] Attributes; not null terminated
+    size_t attrLength,                      ///< [IN] Length of the attributes
+    NotifyAttributes_t* attrsPtr            ///< [OUT] Parsed attributes
+)
+{
+    char attrStr[NOTIFY_ATTR_NUMBYTES];
+    char* savePtr;
+    char* namePtr;
+    char* valuePtr;
+    char* endPtr;
+
+    memset(attrsPtr, 0, sizeof(*attrsPtr));
+    attrsPtr->pmin = -1;
+
+    if ( attrLength >= sizeof(attrStr) )
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    memcpy(attrStr, attrPtr, attrLength);
+    attrStr[attrLength] = '\0';
+
+    for ( namePtr = strtok_r(attrStr, "&", &savePtr);
+          namePtr != NULL;
+          namePtr = strtok_r(NULL, "&", &savePtr) )
+    {
+        valuePtr = strchr(namePtr, '=');
+        if ( valuePtr != NULL )
+        {
+            *valuePtr++ = '\0';
+        }
+
+        if ( (strcmp(namePtr, "pmin") == 0) || (strcmp(namePtr, "pmax") == 0) )
+        {
+            bool isPmin = (strcmp(namePtr, "pmin") == 0);
+            long period = isPmin ? -1 : 0;
+
+            if ( valuePtr != NULL )
+            {
+                period = strtol(valuePtr, &endPtr, 10);
+                if ( (*valuePtr == '\0') || (*endPtr != '\0') || (period < 0) || (period > INT_MAX) )
+                {
+                    return LE_BAD_PARAMETER;
+                }
+            }
+
+            if ( isPmin )
+            {
+                attrsPtr->hasPmin = true;
+                attrsPtr->pmin = period;
+            }
+            else
+            {
+                attrsPtr->hasPmax = true;
+                attrsPtr->pmax = period;
+            }
+        }
+        else if ( strcmp(namePtr, "st") == 0 )
+        {
+            attrsPtr->hasStep = true;
+
+            if ( valuePtr != NULL )
+            {
+                attrsPtr->step = strtod(valuePtr, &endPtr);
+                if ( (*valuePtr == '\0') || (*endPtr != '\0') || !(attrsPtr->step >= 0) )
+                {
+                    return LE_BAD_PARAMETER;
+                }
+            }
+        }
+        else
+        {
+            LE_ERROR("Unsupported notification attribute '%s'", namePtr);
+            return LE_UNSUPPORTED;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply notification attributes to a field.  If the field is being observed, the pmax timer is
+ * rescheduled from now.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyNotifyAttributes
+(
+    InstanceData_t* instanceRef,            ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr,              ///< [IN] Field to update
+    const NotifyAttributes_t* attrsPtr      ///< [IN] Attributes to apply
+)
+{
+    LE_DEBUG("Setting notification attributes on resource %d", fieldDataPtr->fieldId);
+
+    if ( attrsPtr->hasPmin )
+    {
+        fieldDataPtr->notifyPmin = attrsPtr->pmin;
+    }
+
+    if ( attrsPtr->hasPmax )
+    {
+        fieldDataPtr->notifyPmax = attrsPtr->pmax;
+    }
+
+    if ( attrsPtr->hasStep )
+    {
+        fieldDataPtr->notifyStep = attrsPtr->step;
+    }
+
+    // A deferred change will still be sent once the old pmin has passed.
+    if ( fieldDataPtr->isObserve && !fieldDataPtr->isNotifyDeferred )
+    {
+        if ( (fieldDataPtr->notifyPmax > 0) &&
+             (fieldDataPtr->notifyPmax >= GetNotifyPmin(instanceRef, fieldDataPtr)) )
+        {
+            StartNotifyTimer(fieldDataPtr,
+                             (le_clk_Time_t){ .sec=fieldDataPtr->notifyPmax, .usec=0 });
+        }
+        else if ( fieldDataPtr->notifyTimerRef != NULL )
+        {
+            le_timer_Stop(fieldDataPtr->notifyTimerRef);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the notification attributes (pmin, pmax and st) given by a LWM2M Write-Attributes request
+ * on an object, object instance or resource.  The attributes are applied to each resource
+ * concerned that can be observed.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the instance or field is not found
+ *      - LE_UNSUPPORTED if an unsupported attribute is given
+ *      - LE_BAD_PARAMETER if the attributes can't be parsed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributes
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int instanceId,                             ///< [IN] Instance to use, or -1 for all instances
+    int fieldId,                                ///< [IN] Field to use, or -1 for all fields
+    const uint8_t* attrPtr,                     ///< [IN] Attributes, in URI query form
+    size_t attrLength                           ///< [IN] Length of the attributes
+)
+{
+    le_result_t result;
+    NotifyAttributes_t attrs;
+    InstanceData_t* instancePtr;
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* linkPtr;
+    le_dls_Link_t* fieldLinkPtr;
+
+    result = ParseNotifyAttributes(attrPtr, attrLength, &attrs);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    if ( instanceId != -1 )
+    {
+        result = GetInstanceFromAssetData(assetRef, instanceId, &instancePtr);
+        if ( result != LE_OK )
+        {
+            return result;
+        }
+
+        if ( fieldId != -1 )
+        {
+            result = GetFieldFromInstance(instancePtr, fieldId, &fieldDataPtr);
+            if ( result == LE_OK )
+            {
+                ApplyNotifyAttributes(instancePtr, fieldDataPtr, &attrs);
+            }
+            return result;
+        }
+    }
+
+    // Loop through the instances concerned, and the observable fields of each.
+    linkPtr = le_dls_Peek(&assetRef->instanceList);
+
+    while ( linkPtr != NULL )
+    {
+        instancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
+
+        if ( (instanceId == -1) || (instancePtr->instanceId == instanceId) )
+        {
+            fieldLinkPtr = le_dls_Peek(&instancePtr->fieldList);
+
+            while ( fieldLinkPtr != NULL )
+            {
+                fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
+
+                if ( fieldDataPtr->access & ACCESS_WRITE )
+                {
+                    ApplyNotifyAttributes(instancePtr, fieldDataPtr, &attrs);
+                }
+
+                fieldLinkPtr = le_dls_PeekNext(&instancePtr->fieldList, fieldLinkPtr);
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&assetRef->instanceList, linkPtr);
+    }
+
+    return LE_OK;
+}
+
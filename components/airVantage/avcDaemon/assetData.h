@@ -989,6 +989,29 @@ le_result_t assetData_SetObserveAllInstances
     uint8_t tokenLength                         ///< [IN] Token Length
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the notification attributes (pmin, pmax and st) given by a LWM2M Write-Attributes request
+ * on an object, object instance or resource.  The attributes are applied to each resource
+ * concerned that can be observed.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the instance or field is not found
+ *      - LE_UNSUPPORTED if an unsupported attribute is given
+ *      - LE_BAD_PARAMETER if the attributes can't be parsed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributes
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int instanceId,                             ///< [IN] Instance to use, or -1 for all instances
+    int fieldId,                                ///< [IN] Field to use, or -1 for all fields
+    const uint8_t* attrPtr,                     ///< [IN] Attributes, in URI query form
+    size_t attrLength                           ///< [IN] Length of the attributes
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Is Observe flag set for object9 state and result fields.
@@ -1111,6 +1134,35 @@ le_result_t assetData_client_IsObserve
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of updates to the fields of an asset instance.  Observe notifications for fields
+ * set during the batch are held back until the batch is committed.  Batches may be nested.
+ */
+//--------------------------------------------------------------------------------------------------
+void assetData_client_BeginBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit a batch of updates started with assetData_client_BeginBatch().  When the outermost batch
+ * is committed, the server is sent one notification with all the observed fields that were set.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_CLOSED if no batch was in progress
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_CommitBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a registration update to the server.
@@ -1122,6 +1174,32 @@ LE_SHARED void assetData_RegistrationUpdate
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the content type used for the observe notifications of asset instances.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_UNSUPPORTED if the content type is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t assetData_SetNotifyContentType
+(
+    uint16_t contentType                    ///< [IN] TLV_ENCODING or SENML_CBOR_ENCODING
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedules a registration update, batched with the other updates scheduled shortly after.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void assetData_ScheduleRegistrationUpdate
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a registration update if observe is not enabled. A registration update would also be sent
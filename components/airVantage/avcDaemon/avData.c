@@ -98,6 +98,26 @@ static le_mem_PoolRef_t InstanceRefDataPoolRef = NULL;
 static le_timer_Ref_t SessionReleaseTimerRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Current AV session state, as last reported by avcServer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_avdata_SessionState_t CurrentSessionState = LE_AVDATA_SESSION_STOPPED;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Has a session been requested from avcServer, without being reported as started or stopped yet?
+ *
+ * Apps requesting a session while it is being opened, or while it is open, share it: only the
+ * first request is passed to avcServer, so that the modem doesn't set up a new connection with
+ * the server (and a new DTLS handshake) for each app.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSessionStartPending = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Safe Reference Map for instance references. Initialized in avData_Init().
@@ -164,6 +184,7 @@ static void SessionReleaseTimerHandler
 {
     LE_INFO("SessionRelease timer expired; close session");
 
+    IsSessionStartPending = false;
     avcServer_ReleaseSession();
 }
 
@@ -206,8 +227,9 @@ static void ClientCloseSessionHandler
         }
     }
 
-    // Send registration update after the asset is removed.
-    assetData_RegistrationUpdate(ASSET_DATA_SESSION_STATUS_CHECK);
+    // Schedule a registration update after the asset is removed. It is batched with the updates
+    // of the other apps, e.g. when the client app is restarted and creates its assets again.
+    assetData_ScheduleRegistrationUpdate();
 
     // Search for the session request reference(s) used by the closed client, and clean up any data.
     iterRef = le_ref_GetIterator(AvSessionRequestRefMap);
@@ -851,6 +873,9 @@ void avData_ReportSessionState
 {
     LE_DEBUG("Reporting session state %d", sessionState);
 
+    CurrentSessionState = sessionState;
+    IsSessionStartPending = false;
+
     // Send the event to interested applications
     le_event_Report(SessionStateEvent, &sessionState, sizeof(sessionState));
 }
@@ -939,13 +964,29 @@ le_avdata_RequestSessionObjRef_t le_avdata_RequestSession
 
     le_timer_Stop(SessionReleaseTimerRef);
 
-    // Ask the avc server to pass the request to control app or to initiate a session.
-    result = avcServer_RequestSession();
-
-    // If the fresh request fails, return NULL.
-    if (result != LE_OK)
+    if (CurrentSessionState == LE_AVDATA_SESSION_STARTED)
     {
-        return NULL;
+        // Share the open session, and tell the requesting app that it is available.
+        LE_DEBUG("Session already open, sharing it.");
+        avData_ReportSessionState(LE_AVDATA_SESSION_STARTED);
+    }
+    else if (IsSessionStartPending)
+    {
+        // The requesting app will be notified when the session is opened.
+        LE_DEBUG("Session already requested, sharing it.");
+    }
+    else
+    {
+        // Ask the avc server to pass the request to control app or to initiate a session.
+        result = avcServer_RequestSession();
+
+        // If the fresh request fails, return NULL.
+        if (result != LE_OK)
+        {
+            return NULL;
+        }
+
+        IsSessionStartPending = true;
     }
 
     // Need to return a unique reference that will be used by release. Use the client session ref
@@ -988,7 +1029,7 @@ void le_avdata_ReleaseSession
 
     if (le_ref_NextNode(iterRef) == LE_NOT_FOUND)
     {
-        // Close the session if there is no new open request for 2 seconds.
+        // Close the session if there is no new open request before the release delay.
         le_timer_Restart(SessionReleaseTimerRef);
     }
 }
@@ -1036,6 +1077,51 @@ le_result_t le_avdata_IsObserve
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of updates to the fields of an asset instance.
+ *
+ * @note client will be terminated if instRef isn't valid
+ */
+//--------------------------------------------------------------------------------------------------
+void le_avdata_BeginBatch
+(
+    le_avdata_AssetInstanceRef_t instRef
+        ///< [IN]
+)
+{
+    // Map safeRef to desired data
+    instRef = GetInstRefFromSafeRef(instRef, __func__);
+
+    assetData_client_BeginBatch(instRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit a batch of updates to the fields of an asset instance.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_CLOSED if no batch was in progress
+ *      - LE_FAULT on any other error
+ *
+ * @note client will be terminated if instRef isn't valid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_avdata_CommitBatch
+(
+    le_avdata_AssetInstanceRef_t instRef
+        ///< [IN]
+)
+{
+    // Map safeRef to desired data
+    instRef = GetInstRefFromSafeRef(instRef, __func__);
+
+    return assetData_client_CommitBatch(instRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Allocate resources and start accumulating time series data on the specified field.
@@ -1474,8 +1560,21 @@ void avData_Init
     // Add a handler for client session closes
     le_msg_AddServiceCloseHandler(le_avdata_GetServiceRef(), ClientCloseSessionHandler, NULL);
 
-    // Use a timer to delay releasing the session for 2 seconds.
-    le_clk_Time_t timerInterval = { .sec=2, .usec=0 };
+    // Use a timer to delay releasing the session, so that an app requesting a session again
+    // shortly after reuses the open one. The delay is read from the config tree
+    // @ /apps/avcService/sessionReleaseDelay, in seconds, and defaults to 2 seconds.
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(AVC_SERVICE_CFG);
+    int releaseDelay = le_cfg_GetInt(iterRef, "sessionReleaseDelay", 2);
+    le_cfg_CancelTxn(iterRef);
+
+    if (releaseDelay < 0)
+    {
+        LE_WARN("Invalid session release delay %d, using 0", releaseDelay);
+        releaseDelay = 0;
+    }
+    LE_DEBUG("Session release delay: %d s", releaseDelay);
+
+    le_clk_Time_t timerInterval = { .sec=releaseDelay, .usec=0 };
 
     SessionReleaseTimerRef = le_timer_Create("Session Release timer");
     le_timer_SetInterval(SessionReleaseTimerRef, timerInterval);
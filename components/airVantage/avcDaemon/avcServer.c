@@ -22,8 +22,6 @@
 // Definitions
 //--------------------------------------------------------------------------------------------------
 
-#define AVC_SERVICE_CFG "/apps/avcService"
-
 //--------------------------------------------------------------------------------------------------
 /**
  * This ref is returned when a status handler is added/registered.  It is used when the handler is
@@ -1940,6 +1938,23 @@ COMPONENT_INIT
 
     pa_avc_SetModemActivityTimeout(timeout);
 
+    // Read the content format of the observe notifications from config tree
+    // @ /apps/avcService/notifyContentFormat: "tlv" (default) or "senml-cbor"
+    char contentFormat[16] = "";
+    iterRef = le_cfg_CreateReadTxn(AVC_SERVICE_CFG);
+    le_cfg_GetString(iterRef, "notifyContentFormat", contentFormat, sizeof(contentFormat), "tlv");
+    le_cfg_CancelTxn(iterRef);
+
+    if ( (strcmp(contentFormat, "senml-cbor") == 0)
+         && (assetData_SetNotifyContentType(SENML_CBOR_ENCODING) != LE_OK) )
+    {
+        LE_WARN("SenML CBOR notifications not supported, using TLV.");
+    }
+    else if ( (strcmp(contentFormat, "senml-cbor") != 0) && (strcmp(contentFormat, "tlv") != 0) )
+    {
+        LE_WARN("Unknown notification content format '%s', using TLV.", contentFormat);
+    }
+
     // Check to see if le_avc is bound, which means there is an installed control app.
     IsControlAppInstalled = IsAvcBound();
     LE_INFO("Is control app installed? %i", IsControlAppInstalled);
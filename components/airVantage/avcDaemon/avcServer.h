@@ -19,6 +19,13 @@
 // Definitions.
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree node holding the avcService settings.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AVC_SERVICE_CFG "/apps/avcService"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prototype for handler used with avcServer_QueryInstall() to return install response.
@@ -363,6 +363,44 @@ static void OperationHandler
         return;
     }
 
+    // Write attributes can be on an object, an object instance or a resource. The payload holds
+    // the notification attributes (pmin, pmax and st) in URI query form.
+    if ( opType == PA_AVC_OPTYPE_WRITE_ATTR )
+    {
+        LE_DEBUG("PA_AVC_OPTYPE_WRITE_ATTR %s/%d/%d/%d",
+                 newPrefixPtr, objId, objInstId, resourceId);
+
+        assetData_AssetDataRef_t assetRef;
+
+        result = assetData_GetAssetRefById(newPrefixPtr, objId, &assetRef);
+
+        if ( result == LE_OK )
+        {
+            result = assetData_SetNotifyAttributes(assetRef,
+                                                   objInstId,
+                                                   resourceId,
+                                                   payloadPtr,
+                                                   payloadLength);
+        }
+
+        if ( result == LE_NOT_FOUND )
+            opErr = PA_AVC_OPERR_RESOURCE_UNSUPPORTED;
+        else if ( (result == LE_UNSUPPORTED) || (result == LE_BAD_PARAMETER) )
+            opErr = PA_AVC_OPERR_OP_UNSUPPORTED;
+        else if ( result != LE_OK )
+            opErr = PA_AVC_OPERR_INTERNAL;
+
+        if ( opErr != PA_AVC_OPERR_NO_ERROR )
+        {
+            LE_ERROR("Failed to write attributes.");
+            pa_avc_OperationReportError(opRef, opErr);
+            return;
+        }
+
+        pa_avc_OperationReportSuccess(opRef, NULL, 0);
+        return;
+    }
+
     // These operations all need a valid instanceRef.  Ensure that the specified instance exists,
     // and get the instanceRef; this check is common across several of the opTypes.
     if ( (opType == PA_AVC_OPTYPE_READ) ||
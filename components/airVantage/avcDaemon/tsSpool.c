@@ -0,0 +1,778 @@
+/**
+ * @file tsSpool.c
+ *
+ * Flash-backed spool of compressed time series (see tsSpool.h).
+ *
+ * Each segment file starts with a SegmentHeader_t, followed by the records, each a RecordHeader_t
+ * and the payload.  The sequence numbers of the segments give their order.  A record is only
+ * counted once all of it is in the file and its CRC matches, so a record torn by a crash is
+ * dropped, along with anything after it in its segment.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "tsSpool.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic numbers and version of the segment files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_MAGIC               0x50535354  // "TSSP"
+#define RECORD_MAGIC                0x52535354  // "TSSR"
+#define SEGMENT_VERSION             1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                 ///< SEGMENT_MAGIC.
+    uint32_t version;               ///< SEGMENT_VERSION.
+    uint64_t seq;                   ///< Sequence number of the segment.
+}
+SegmentHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t      magic;            ///< RECORD_MAGIC.
+    uint32_t      numBytes;         ///< Size of the payload following the header.
+    uint32_t      crc;              ///< CRC32 of the key and the payload.
+    tsSpool_Key_t key;              ///< Field the time series belongs to.
+}
+RecordHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment file, as known in memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t seq;                   ///< Sequence number (0 if the file doesn't exist).
+    size_t   size;                  ///< Number of bytes in the file.
+}
+Segment_t;
+
+
+static bool IsOpen = false;                             ///< Is the spool open?
+static Segment_t Segments[TS_SPOOL_SEGMENT_COUNT];      ///< Segment files.
+static size_t SegmentBytes;                             ///< Maximum size of a segment file.
+static int WriteIndex = -1;                             ///< Segment appended to (-1 if none).
+static uint64_t NextSeq = 1;                            ///< Sequence number of the next segment.
+static int ReadIndex = -1;                              ///< Segment being read (-1 if none).
+static size_t ReadOffset;                               ///< Offset of the next record to read.
+static size_t MaxPayloadBytes;                          ///< Largest payload accepted.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records not written to the flash yet.  The ones before BatchStart have already been read.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* BatchPtr;
+static size_t BatchBytes;
+static size_t BatchStart;
+static size_t BatchEnd;
+static le_timer_Ref_t FlushTimerRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the record last read by tsSpool_Peek() (0 if none), and whether it was read from the
+ * records not written to the flash yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PeekBytes = 0;
+static bool IsPeekFromBatch;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    int index,              ///< [IN] Segment index.
+    char* pathPtr,          ///< [OUT] Path.
+    size_t pathSize         ///< [IN] Size of the path buffer.
+)
+{
+    snprintf(pathPtr, pathSize, "%s/segment%d", TS_SPOOL_DIR, index);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the CRC of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RecordCrc
+(
+    const RecordHeader_t* headerPtr,    ///< [IN] Record header.
+    const uint8_t* payloadPtr           ///< [IN] Payload.
+)
+{
+    uint32_t crc = le_crc_Crc32((uint8_t*)&headerPtr->key, sizeof(headerPtr->key),
+                                LE_CRC_START_CRC32);
+
+    return le_crc_Crc32((uint8_t*)payloadPtr, headerPtr->numBytes, crc);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a record from a segment file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the buffer is too small for the payload
+ *      - LE_FORMAT_ERROR if there is no valid record at that offset
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecord
+(
+    int fd,                         ///< [IN] Segment file.
+    size_t offset,                  ///< [IN] Offset of the record.
+    size_t endOffset,               ///< [IN] End of the data in the file.
+    RecordHeader_t* headerPtr,      ///< [OUT] Record header.
+    uint8_t* payloadPtr,            ///< [OUT] Buffer for the payload.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    if (   (offset + sizeof(*headerPtr) > endOffset)
+        || (pread(fd, headerPtr, sizeof(*headerPtr), offset) != (ssize_t)sizeof(*headerPtr))
+        || (headerPtr->magic != RECORD_MAGIC)
+        || (headerPtr->numBytes > endOffset - offset - sizeof(*headerPtr)))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    if (headerPtr->numBytes > bufSize)
+    {
+        return LE_OVERFLOW;
+    }
+
+    if (   (pread(fd, payloadPtr, headerPtr->numBytes, offset + sizeof(*headerPtr))
+                != (ssize_t)headerPtr->numBytes)
+        || (RecordCrc(headerPtr, payloadPtr) != headerPtr->crc))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the header of a segment file.  Files that aren't segments are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadSegment
+(
+    int index               ///< [IN] Segment index.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    SegmentHeader_t header;
+    struct stat st;
+
+    GetSegmentPath(index, path, sizeof(path));
+
+    Segments[index].seq = 0;
+    Segments[index].size = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    if (   (read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header))
+        && (header.magic == SEGMENT_MAGIC)
+        && (header.version == SEGMENT_VERSION)
+        && (header.seq != 0)
+        && (fstat(fd, &st) == 0))
+    {
+        Segments[index].seq = header.seq;
+        Segments[index].size = st.st_size;
+    }
+    close(fd);
+
+    if (Segments[index].seq == 0)
+    {
+        LE_WARN("Deleting invalid time series spool segment '%s'.", path);
+        unlink(path);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cut a segment file after its last valid record, so new records aren't appended after a record
+ * torn by a crash.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TrimSegment
+(
+    int index               ///< [IN] Segment index.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    RecordHeader_t header;
+    size_t offset = sizeof(SegmentHeader_t);
+
+    GetSegmentPath(index, path, sizeof(path));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    // The batch buffer is empty at this point, and large enough for any payload.
+    while (ReadRecord(fd, offset, Segments[index].size, &header, BatchPtr, BatchBytes) == LE_OK)
+    {
+        offset += sizeof(header) + header.numBytes;
+    }
+    close(fd);
+
+    if (offset < Segments[index].size)
+    {
+        LE_WARN("Dropping %zu bytes of torn records from '%s'.",
+                Segments[index].size - offset, path);
+
+        if (truncate(path, offset) == 0)
+        {
+            Segments[index].size = offset;
+        }
+        else
+        {
+            // Don't append to it: records written after the torn one would never be read.
+            LE_ERROR("Failed to truncate '%s' (%m).", path);
+            WriteIndex = -1;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteSegment
+(
+    int index               ///< [IN] Segment index.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    GetSegmentPath(index, path, sizeof(path));
+    unlink(path);
+
+    Segments[index].seq = 0;
+    Segments[index].size = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest segment file.
+ *
+ * @return The segment index, or -1 if there are none.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetOldestSegment
+(
+    void
+)
+{
+    int oldestIndex = -1;
+    int i;
+
+    for (i = 0; i < TS_SPOOL_SEGMENT_COUNT; i++)
+    {
+        if (   (Segments[i].seq != 0)
+            && ((oldestIndex == -1) || (Segments[i].seq < Segments[oldestIndex].seq)))
+        {
+            oldestIndex = i;
+        }
+    }
+
+    return oldestIndex;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move on to the next segment file, emptying it.  If it still holds records, they are lost.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenNextSegment
+(
+    void
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    SegmentHeader_t header = { .magic = SEGMENT_MAGIC, .version = SEGMENT_VERSION };
+
+    WriteIndex = (WriteIndex + 1) % TS_SPOOL_SEGMENT_COUNT;
+
+    if (Segments[WriteIndex].seq != 0)
+    {
+        size_t unreadBytes = Segments[WriteIndex].size - sizeof(SegmentHeader_t);
+
+        if (ReadIndex == WriteIndex)
+        {
+            unreadBytes = Segments[WriteIndex].size - ReadOffset;
+            ReadIndex = -1;
+            PeekBytes = 0;
+        }
+
+        LE_WARN("Time series spool full; dropping %zu bytes of the oldest time series.",
+                unreadBytes);
+    }
+
+    Segments[WriteIndex].seq = 0;
+    Segments[WriteIndex].size = 0;
+
+    GetSegmentPath(WriteIndex, path, sizeof(path));
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to open time series spool segment '%s' (%m).", path);
+        return LE_FAULT;
+    }
+
+    header.seq = NextSeq;
+    if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+    {
+        LE_ERROR("Failed to write time series spool segment '%s' (%m).", path);
+        close(fd);
+        unlink(path);
+        return LE_FAULT;
+    }
+    close(fd);
+
+    Segments[WriteIndex].seq = NextSeq++;
+    Segments[WriteIndex].size = sizeof(header);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush timer handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer.
+)
+{
+    tsSpool_Flush();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the spool, creating its directory if needed.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the spool directory can't be created (nothing is spooled then)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Init
+(
+    size_t maxPayloadBytes      ///< [IN] Largest payload that will be appended.
+)
+{
+    int i;
+
+    MaxPayloadBytes = maxPayloadBytes;
+
+    // A batch must hold the largest record, and a segment the largest batch.
+    BatchBytes = sizeof(RecordHeader_t) + maxPayloadBytes;
+    if (BatchBytes < TS_SPOOL_BATCH_BYTES)
+    {
+        BatchBytes = TS_SPOOL_BATCH_BYTES;
+    }
+    SegmentBytes = sizeof(SegmentHeader_t) + BatchBytes;
+    if (SegmentBytes < TS_SPOOL_SEGMENT_BYTES)
+    {
+        SegmentBytes = TS_SPOOL_SEGMENT_BYTES;
+    }
+
+    le_mem_PoolRef_t batchPoolRef = le_mem_CreatePool("TimeSeries spool batch", BatchBytes);
+    BatchPtr = le_mem_ForceAlloc(batchPoolRef);
+    BatchStart = 0;
+    BatchEnd = 0;
+
+    FlushTimerRef = le_timer_Create("TimeSeries spool flush");
+    le_timer_SetMsInterval(FlushTimerRef, TS_SPOOL_FLUSH_DELAY_S * 1000);
+    le_timer_SetHandler(FlushTimerRef, FlushTimerHandler);
+
+    if (le_dir_MakePath(TS_SPOOL_DIR, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Failed to create '%s'; time series won't be spooled.", TS_SPOOL_DIR);
+        return LE_FAULT;
+    }
+
+    // New records go after the most recent segment.
+    for (i = 0; i < TS_SPOOL_SEGMENT_COUNT; i++)
+    {
+        LoadSegment(i);
+
+        if (Segments[i].seq >= NextSeq)
+        {
+            NextSeq = Segments[i].seq + 1;
+            WriteIndex = i;
+        }
+    }
+
+    if (WriteIndex != -1)
+    {
+        TrimSegment(WriteIndex);
+    }
+
+    IsOpen = true;
+
+    if (!tsSpool_IsEmpty())
+    {
+        LE_INFO("Time series spooled in '%s' will be sent once the session is up.", TS_SPOOL_DIR);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a time series payload to the spool.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the payload is larger than given to tsSpool_Init()
+ *      - LE_FAULT if the spool isn't open
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Append
+(
+    const tsSpool_Key_t* keyPtr,    ///< [IN] Field the time series belongs to.
+    const uint8_t* payloadPtr,      ///< [IN] Payload.
+    size_t numBytes                 ///< [IN] Payload size.
+)
+{
+    RecordHeader_t header;
+
+    if (!IsOpen)
+    {
+        return LE_FAULT;
+    }
+
+    if (numBytes > MaxPayloadBytes)
+    {
+        return LE_OVERFLOW;
+    }
+
+    if (BatchEnd + sizeof(header) + numBytes > BatchBytes)
+    {
+        tsSpool_Flush();
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = RECORD_MAGIC;
+    header.numBytes = numBytes;
+    header.key = *keyPtr;
+    header.crc = RecordCrc(&header, payloadPtr);
+
+    memcpy(BatchPtr + BatchEnd, &header, sizeof(header));
+    memcpy(BatchPtr + BatchEnd + sizeof(header), payloadPtr, numBytes);
+    BatchEnd += sizeof(header) + numBytes;
+
+    if (!le_timer_IsRunning(FlushTimerRef))
+    {
+        le_timer_Start(FlushTimerRef);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the records collected in memory to the flash.
+ */
+//--------------------------------------------------------------------------------------------------
+void tsSpool_Flush
+(
+    void
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    size_t numBytes = BatchEnd - BatchStart;
+    size_t written = 0;
+
+    le_timer_Stop(FlushTimerRef);
+
+    if (numBytes == 0)
+    {
+        return;
+    }
+
+    // The records move to the flash, so a record read from memory must be read again.
+    if (IsPeekFromBatch)
+    {
+        PeekBytes = 0;
+    }
+
+    if (   (WriteIndex == -1)
+        || (Segments[WriteIndex].seq == 0)
+        || (Segments[WriteIndex].size + numBytes > SegmentBytes))
+    {
+        if (OpenNextSegment() != LE_OK)
+        {
+            LE_ERROR("Dropping %zu bytes of time series.", numBytes);
+            BatchStart = 0;
+            BatchEnd = 0;
+            return;
+        }
+    }
+
+    GetSegmentPath(WriteIndex, path, sizeof(path));
+
+    int fd = open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd != -1)
+    {
+        while (written < numBytes)
+        {
+            ssize_t count = write(fd, BatchPtr + BatchStart + written, numBytes - written);
+
+            if (count > 0)
+            {
+                written += count;
+            }
+            else if ((count == -1) && (errno == EINTR))
+            {
+                continue;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if ((written < numBytes) || (fdatasync(fd) != 0))
+        {
+            // Take the partly written records out, so later records can be read after them.
+            LE_ERROR("Failed to write time series spool segment '%s' (%m).", path);
+            if (ftruncate(fd, Segments[WriteIndex].size) != 0)
+            {
+                WriteIndex = -1;
+            }
+            written = 0;
+        }
+        close(fd);
+    }
+    else
+    {
+        LE_ERROR("Failed to open time series spool segment '%s' (%m).", path);
+    }
+
+    if (written == 0)
+    {
+        LE_ERROR("Dropping %zu bytes of time series.", numBytes);
+    }
+    else
+    {
+        Segments[WriteIndex].size += written;
+    }
+
+    BatchStart = 0;
+    BatchEnd = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the oldest record of the spool, without removing it.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the spool is empty
+ *      - LE_OVERFLOW if the buffer is too small for the payload (the size of the payload is given,
+ *        and tsSpool_Consume() removes the record)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Peek
+(
+    tsSpool_Key_t* keyPtr,      ///< [OUT] Field the time series belongs to.
+    uint8_t* payloadPtr,        ///< [OUT] Buffer for the payload.
+    size_t* numBytesPtr         ///< [IN/OUT] Size of the buffer, then of the payload.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    RecordHeader_t header;
+    le_result_t result;
+
+    PeekBytes = 0;
+
+    if (!IsOpen)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    // The records on the flash come first, oldest segment first.
+    while (true)
+    {
+        if (ReadIndex == -1)
+        {
+            ReadIndex = GetOldestSegment();
+            if (ReadIndex == -1)
+            {
+                break;
+            }
+            ReadOffset = sizeof(SegmentHeader_t);
+        }
+
+        if (ReadOffset >= Segments[ReadIndex].size)
+        {
+            // All read: new records go to a new segment, and this one is deleted, not rewritten.
+            DeleteSegment(ReadIndex);
+            ReadIndex = -1;
+            continue;
+        }
+
+        GetSegmentPath(ReadIndex, path, sizeof(path));
+
+        result = LE_FORMAT_ERROR;
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd != -1)
+        {
+            result = ReadRecord(fd, ReadOffset, Segments[ReadIndex].size,
+                                &header, payloadPtr, *numBytesPtr);
+            close(fd);
+        }
+
+        if ((result != LE_OK) && (result != LE_OVERFLOW))
+        {
+            LE_WARN("Corrupted time series spool segment '%s'; skipping %zu bytes.",
+                    path, Segments[ReadIndex].size - ReadOffset);
+            ReadOffset = Segments[ReadIndex].size;
+            continue;
+        }
+
+        *keyPtr = header.key;
+        *numBytesPtr = header.numBytes;
+        PeekBytes = sizeof(header) + header.numBytes;
+        IsPeekFromBatch = false;
+        return result;
+    }
+
+    // Then the records not written to the flash yet.
+    if (BatchStart < BatchEnd)
+    {
+        memcpy(&header, BatchPtr + BatchStart, sizeof(header));
+
+        result = LE_OVERFLOW;
+        if (header.numBytes <= *numBytesPtr)
+        {
+            memcpy(payloadPtr, BatchPtr + BatchStart + sizeof(header), header.numBytes);
+            result = LE_OK;
+        }
+
+        *keyPtr = header.key;
+        *numBytesPtr = header.numBytes;
+        PeekBytes = sizeof(header) + header.numBytes;
+        IsPeekFromBatch = true;
+        return result;
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest record of the spool, as read by tsSpool_Peek().
+ */
+//--------------------------------------------------------------------------------------------------
+void tsSpool_Consume
+(
+    void
+)
+{
+    if (PeekBytes == 0)
+    {
+        return;
+    }
+
+    if (IsPeekFromBatch)
+    {
+        BatchStart += PeekBytes;
+
+        if (BatchStart == BatchEnd)
+        {
+            // Everything was read before it had to be written.
+            BatchStart = 0;
+            BatchEnd = 0;
+            le_timer_Stop(FlushTimerRef);
+        }
+    }
+    else
+    {
+        ReadOffset += PeekBytes;
+    }
+
+    PeekBytes = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the spool is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool tsSpool_IsEmpty
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < TS_SPOOL_SEGMENT_COUNT; i++)
+    {
+        if (Segments[i].seq != 0)
+        {
+            size_t readOffset = (i == ReadIndex) ? ReadOffset : sizeof(SegmentHeader_t);
+
+            if (Segments[i].size > readOffset)
+            {
+                return false;
+            }
+        }
+    }
+
+    return (BatchStart == BatchEnd);
+}
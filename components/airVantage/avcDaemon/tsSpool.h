@@ -0,0 +1,156 @@
+/**
+ * @file tsSpool.h
+ *
+ * Flash-backed spool of compressed time series, kept while the AirVantage session is down.
+ *
+ * Each record of the spool is a finished time series payload (the compressed CBOR stream that
+ * would have been notified to the server) along with the field it belongs to.  Records are
+ * appended to a fixed set of TS_SPOOL_SEGMENT_COUNT segment files in TS_SPOOL_DIR, each at most
+ * TS_SPOOL_SEGMENT_BYTES long, so the spool never takes up more flash than that.  When the last
+ * segment is full, the oldest one is reused and the records it still holds are lost.
+ *
+ * Records are collected in memory and appended to the current segment in batches of up to
+ * TS_SPOOL_BATCH_BYTES, at most every TS_SPOOL_FLUSH_DELAY_S seconds, so each write to the flash is
+ * a large one.  Records read back before their batch is written never reach the flash at all.
+ * Segments are deleted, never rewritten, once all of their records have been read.  How far a
+ * segment has been read isn't saved, so the records of a segment that was being read when the
+ * daemon stopped are read again once it restarts.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_TSSPOOL_INCLUDE_GUARD
+#define LEGATO_TSSPOOL_INCLUDE_GUARD
+
+#include "legato.h"
+#include "limit.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory holding the spool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TS_SPOOL_DIR                    "/data/avcTimeSeries"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of segment files in the spool, and size of each segment file, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TS_SPOOL_SEGMENT_COUNT          8
+#define TS_SPOOL_SEGMENT_BYTES          (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of records collected in memory before they are written to the flash, and
+ * longest time they are kept in memory, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TS_SPOOL_BATCH_BYTES            (16 * 1024)
+#define TS_SPOOL_FLUSH_DELAY_S          60
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field a spooled time series belongs to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char    appName[LIMIT_MAX_APP_NAME_BYTES];  ///< App containing the asset.
+    int32_t assetId;                            ///< Asset id within the app.
+    int32_t instanceId;                         ///< Instance of the asset.
+    int32_t fieldId;                            ///< Field of the instance.
+}
+tsSpool_Key_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the spool, creating its directory if needed.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the spool directory can't be created (nothing is spooled then)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Init
+(
+    size_t maxPayloadBytes      ///< [IN] Largest payload that will be appended.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a time series payload to the spool.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the payload is larger than given to tsSpool_Init()
+ *      - LE_FAULT if the spool isn't open
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Append
+(
+    const tsSpool_Key_t* keyPtr,    ///< [IN] Field the time series belongs to.
+    const uint8_t* payloadPtr,      ///< [IN] Payload.
+    size_t numBytes                 ///< [IN] Payload size.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the records collected in memory to the flash.
+ */
+//--------------------------------------------------------------------------------------------------
+void tsSpool_Flush
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the oldest record of the spool, without removing it.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the spool is empty
+ *      - LE_OVERFLOW if the buffer is too small for the payload (the size of the payload is given,
+ *        and tsSpool_Consume() removes the record)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t tsSpool_Peek
+(
+    tsSpool_Key_t* keyPtr,      ///< [OUT] Field the time series belongs to.
+    uint8_t* payloadPtr,        ///< [OUT] Buffer for the payload.
+    size_t* numBytesPtr         ///< [IN/OUT] Size of the buffer, then of the payload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest record of the spool, as read by tsSpool_Peek().
+ */
+//--------------------------------------------------------------------------------------------------
+void tsSpool_Consume
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the spool is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool tsSpool_IsEmpty
+(
+    void
+);
+
+
+#endif // LEGATO_TSSPOOL_INCLUDE_GUARD
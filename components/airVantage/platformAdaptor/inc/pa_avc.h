@@ -66,6 +66,14 @@
 #define TLV_ENCODING    1542
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Content type: SenML CBOR (RFC 8428), which can be used for notify messages instead of TLV.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_CBOR_ENCODING    112
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The possible actions to take after receiving a pending download or install notification.
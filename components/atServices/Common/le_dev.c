@@ -10,6 +10,7 @@
 #include "le_dev.h"
 #include <pwd.h>
 #include <grp.h>
+#include <sys/ioctl.h>
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -276,6 +277,28 @@ ssize_t le_dev_Read
     return count;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the number of bytes waiting to be read on device (or port)
+ *
+ * @return byte number available, or -1 if it can't be known
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_dev_GetReadableBytes
+(
+    Device_t*   devicePtr     ///< device pointer
+)
+{
+    int available;
+
+    if (ioctl(devicePtr->fd, FIONREAD, &available) == -1)
+    {
+        return -1;
+    }
+
+    return available;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to write on device (or port)
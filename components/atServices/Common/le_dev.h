@@ -35,6 +35,18 @@ ssize_t le_dev_Read
     ssize_t     size          ///< size of buffer
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the number of bytes waiting to be read on device (or port)
+ *
+ * @return byte number available, or -1 if it can't be known
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_dev_GetReadableBytes
+(
+    Device_t*   devicePtr     ///< device pointer
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to write on device (or port)
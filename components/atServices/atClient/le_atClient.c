@@ -105,6 +105,21 @@
 //--------------------------------------------------------------------------------------------------
 #define UNSOLICITED_POOL_SIZE 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited pattern trie node pool size
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNSOL_NODE_POOL_SIZE  64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Max number of commands that can be outstanding at once on a device (see
+ * le_atClient_SetPipelineDepth())
+ */
+//--------------------------------------------------------------------------------------------------
+#define PIPELINE_MAX_DEPTH    CMD_POOL_SIZE
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rx Buffer length
@@ -194,6 +209,7 @@ ClientState_t;
 typedef struct
 {
     char            line[LE_ATDEFS_RESPONSE_MAX_BYTES]; ///< string value
+    size_t          lineLen;                            ///< length of line
     le_dls_Link_t   link;                               ///< link for list
 }
 RspString_t;
@@ -241,7 +257,7 @@ RxParser_t;
  *
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Unsolicited
 {
     le_atClient_UnsolicitedResponseHandlerFunc_t handlerPtr;    ///< Unsolicited handler
     void*         contextPtr;                                   ///< User context
@@ -250,6 +266,8 @@ typedef struct
     uint32_t      lineCount;                                    ///< Unsolicited lines number
     uint32_t      lineCounter;                                  ///< Received line counter
     bool          inProgress;                                   ///< Reception in progress
+    bool          isMatched;                                    ///< Current line matches pattern
+    struct Unsolicited* nextSamePatternPtr;                     ///< Next one in the same trie node
     le_atClient_UnsolicitedResponseHandlerRef_t ref;            ///< Unsolicited reference
     DeviceContextPtr_t interfacePtr;                            ///< device context
     le_dls_Link_t link;                                         ///< link in Unsolicited List
@@ -257,7 +275,39 @@ typedef struct
 }
 Unsolicited_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the prefix trie of a device's unsolicited patterns.
+ *
+ * The children of a node are chained through siblingPtr.  The subscriptions whose pattern ends at
+ * a node are chained through their nextSamePatternPtr.  The root node is the empty pattern.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct UnsolNode
+{
+    char              c;            ///< character leading to this node from its parent
+    struct UnsolNode* childPtr;     ///< first child
+    struct UnsolNode* siblingPtr;   ///< next child of the same parent
+    Unsolicited_t*    unsolPtr;     ///< first subscription whose pattern ends here
+}
+UnsolNode_t;
+
+
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command queue statistics of a device
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t cmdCount;          ///< Number of commands completed (or timed out)
+    uint64_t totalQueueMs;      ///< Total time the commands waited before being sent
+    uint32_t maxQueueMs;        ///< Longest time a command waited before being sent
+    uint64_t totalResponseMs;   ///< Total time between sending the commands and their end
+}
+QueueStats_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -273,7 +323,12 @@ typedef struct DeviceContext
     RxParser_t      rxParser;           ///< Rx buffer parser context
     le_timer_Ref_t  timerRef;           ///< command timer
     le_dls_List_t   atCommandList;      ///< List of command waiting for execution
+    uint32_t        sentCount;          ///< Number of commands at the head of atCommandList that
+                                        ///< have been sent
+    uint32_t        pipelineDepth;      ///< Max number of commands sent at once (0 = 1)
+    QueueStats_t    queueStats;         ///< Command queue statistics
     le_dls_List_t   unsolicitedList;    ///< unsolicited command list
+    UnsolNode_t*    unsolTriePtr;       ///< prefix trie of unsolicitedList patterns
     le_sem_Ref_t    waitingSemaphore;   ///< semaphore used for synchronization
     le_atClient_DeviceRef_t ref;        ///< reference of the device context
     le_msg_SessionRef_t sessionRef;     ///< client session reference
@@ -306,6 +361,12 @@ typedef struct AtCmd
     le_result_t            result;                              ///< result operation
     le_dls_Link_t          link;                                ///< link in AT commands list
     le_msg_SessionRef_t    sessionRef;                          ///< client session reference
+    bool                   isIndependent;                       ///< can be pipelined
+    le_clk_Time_t          queuedTime;                          ///< when it was queued
+    le_clk_Time_t          sentTime;                            ///< when it was sent
+    le_atClient_ResponseHandlerFunc_t rspHandlerPtr;            ///< handler the responses are
+                                                                ///< streamed to, or NULL
+    void*                  rspContextPtr;                       ///< context of rspHandlerPtr
 }
 AtCmd_t;
 
@@ -338,6 +399,13 @@ static le_mem_PoolRef_t  RspStringPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  UnsolicitedPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for unsolicited pattern trie nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  UnsolNodePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map for AT commands
@@ -371,23 +439,159 @@ static void UpdateTransitionManager(ClientStatePtr_t  parserStatePtr,
 
 static void SendLine(RxParserPtr_t charParserPtr);
 static void SendData(RxParserPtr_t charParserPtr);
+static void StartTimer(AtCmd_t* cmdPtr);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function releases an unsolicited pattern trie node and all of its descendants.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseUnsolTrie
+(
+    UnsolNode_t* nodePtr
+)
+{
+    while (nodePtr != NULL)
+    {
+        UnsolNode_t* siblingPtr = nodePtr->siblingPtr;
+
+        ReleaseUnsolTrie(nodePtr->childPtr);
+        le_mem_Release(nodePtr);
+
+        nodePtr = siblingPtr;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function allocates an empty unsolicited pattern trie node.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* NewUnsolNode
+(
+    char c
+)
+{
+    UnsolNode_t* nodePtr = le_mem_ForceAlloc(UnsolNodePool);
+
+    memset(nodePtr, 0, sizeof(UnsolNode_t));
+    nodePtr->c = c;
+
+    return nodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function finds the child of a trie node for a given character.
+ *
+ * @return the child node, or NULL if there is none
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* FindUnsolChild
+(
+    UnsolNode_t* nodePtr,
+    char c
+)
+{
+    UnsolNode_t* childPtr = nodePtr->childPtr;
+
+    while ((childPtr != NULL) && (childPtr->c != c))
+    {
+        childPtr = childPtr->siblingPtr;
+    }
+
+    return childPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function rebuilds the prefix trie of a device's unsolicited patterns.  It must be called
+ * each time a subscription is added to or removed from the device's unsolicited list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RebuildUnsolTrie
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    ReleaseUnsolTrie(interfacePtr->unsolTriePtr);
+    interfacePtr->unsolTriePtr = NULL;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->unsolicitedList);
+
+    while (linkPtr != NULL)
+    {
+        Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
+        const char* charPtr;
+
+        if (interfacePtr->unsolTriePtr == NULL)
+        {
+            interfacePtr->unsolTriePtr = NewUnsolNode('\0');
+        }
+
+        UnsolNode_t* nodePtr = interfacePtr->unsolTriePtr;
+
+        for (charPtr = unsolPtr->unsolRsp; *charPtr != '\0'; charPtr++)
+        {
+            UnsolNode_t* childPtr = FindUnsolChild(nodePtr, *charPtr);
+
+            if (childPtr == NULL)
+            {
+                childPtr = NewUnsolNode(*charPtr);
+                childPtr->siblingPtr = nodePtr->childPtr;
+                nodePtr->childPtr = childPtr;
+            }
+
+            nodePtr = childPtr;
+        }
+
+        unsolPtr->nextSamePatternPtr = nodePtr->unsolPtr;
+        nodePtr->unsolPtr = unsolPtr;
+
+        linkPtr = le_dls_PeekNext(&interfacePtr->unsolicitedList, linkPtr);
+    }
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to check if the received data matches with a subscribed unsolicited
  * response.
  *
+ * The line is matched against all the subscribed patterns in a single walk down the device's
+ * pattern trie, then the matching subscriptions and those waiting for more lines are served in
+ * subscription order.
+ *
  */
 //--------------------------------------------------------------------------------------------------
 static void CheckUnsolicited
 (
     char* unsolRspPtr,
     size_t stringSize,
-    le_dls_List_t *unsolListPtr
+    DeviceContext_t* interfacePtr
 )
 {
     LE_DEBUG("Start checking unsolicited");
 
+    le_dls_List_t* unsolListPtr = &interfacePtr->unsolicitedList;
+    UnsolNode_t* nodePtr = interfacePtr->unsolTriePtr;
+    size_t i = 0;
+
+    // Flag every subscription whose pattern is a prefix of the line.
+    while (nodePtr != NULL)
+    {
+        Unsolicited_t* matchPtr;
+
+        for (matchPtr = nodePtr->unsolPtr; matchPtr != NULL; matchPtr = matchPtr->nextSamePatternPtr)
+        {
+            matchPtr->isMatched = true;
+        }
+
+        nodePtr = (i < stringSize) ? FindUnsolChild(nodePtr, unsolRspPtr[i++]) : NULL;
+    }
+
     le_dls_Link_t* linkPtr = le_dls_Peek(unsolListPtr);
 
     /* Browse all the queue while the string is not found */
@@ -397,10 +601,10 @@ static void CheckUnsolicited
                                                Unsolicited_t,
                                                 link);
 
-        if ((strncmp(unsolPtr->unsolRsp,unsolRspPtr,strlen(unsolPtr->unsolRsp)) == 0) ||
-            (unsolPtr->inProgress))
+        if ((unsolPtr->isMatched) || (unsolPtr->inProgress))
         {
             LE_DEBUG("unsol found");
+            unsolPtr->isMatched = false;
             uint32_t len =
                 (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
                 stringSize :
@@ -441,136 +645,138 @@ static void CheckUnsolicited
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to get the next event to send to the Rx parser
+ * This function must be called to read and send event to the Rx parser
  *
- * @return
- *      - true if a new event is detected and RX parser has to be processed
- *      - false otherwise
+ * The buffer is scanned with memchr() for the next line feed or prompt, rather than a character
+ * at a time.  A run of other characters is reported to the parser as a single PARSER_CHAR event,
+ * which is all the parser states need to see of it.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static bool GetNextEvent
+static void ParseRxBuffer
 (
-    RxParserPtr_t  charParserPtr,
-    RxEvent_t     *evPtr
+    RxParserPtr_t rxParserPtr
 )
 {
-    int32_t idx = charParserPtr->rxData.idx++;
-    if (idx < charParserPtr->rxData.endBuffer)
+    RxData_t* rxDataPtr = &rxParserPtr->rxData;
+
+    while (rxDataPtr->idx < rxDataPtr->endBuffer)
     {
-        if (charParserPtr->rxData.buffer[idx] == '\r')
+        uint8_t* startPtr = &rxDataPtr->buffer[rxDataPtr->idx];
+        size_t   size = rxDataPtr->endBuffer - rxDataPtr->idx;
+        uint8_t* lfPtr = memchr(startPtr, '\n', size);
+        uint8_t* promptPtr = memchr(startPtr, '>', (lfPtr != NULL) ? (size_t)(lfPtr - startPtr) : size);
+        uint8_t* specialPtr = (promptPtr != NULL) ? promptPtr : lfPtr;
+
+        if (specialPtr == NULL)
         {
-            idx = charParserPtr->rxData.idx++;
-            if (idx < charParserPtr->rxData.endBuffer)
-            {
-                if ( charParserPtr->rxData.buffer[idx] == '\n')
-                {
-                    *evPtr = PARSER_CRLF;
-                    return true;
-                }
-                else
-                {
-                    return false;
-                }
-            }
-            else
-            {
-                charParserPtr->rxData.idx--;
-                return false;
-            }
+            rxDataPtr->idx = rxDataPtr->endBuffer;
+            (rxParserPtr->curState)(rxParserPtr,PARSER_CHAR);
+            break;
         }
-        else if (charParserPtr->rxData.buffer[idx] == '\n')
+
+        if (specialPtr > startPtr)
         {
-            if ( idx-1 > 0 )
-            {
-                if (charParserPtr->rxData.buffer[idx-1] == '\r')
-                {
-                    *evPtr = PARSER_CRLF;
-                    return true;
-                }
-                else
-                {
-                    return false;
-                }
-            }
-            else
-            {
-                return false;
-            }
+            (rxParserPtr->curState)(rxParserPtr,PARSER_CHAR);
         }
-        else if (charParserPtr->rxData.buffer[idx] == '>')
+
+        rxDataPtr->idx = specialPtr - rxDataPtr->buffer + 1;
+
+        if (specialPtr == promptPtr)
         {
-            *evPtr = PARSER_PROMPT;
-            return true;
+            (rxParserPtr->curState)(rxParserPtr,PARSER_PROMPT);
         }
-        else
+        else if ((specialPtr > rxDataPtr->buffer) && (specialPtr[-1] == '\r'))
         {
-            *evPtr = PARSER_CHAR;
-            return true;
+            (rxParserPtr->curState)(rxParserPtr,PARSER_CRLF);
         }
     }
-    else
-    {
-        return false;
-    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to read and send event to the Rx parser
+ * This function must be called to delete characters that were already read.
+ *
+ * When every line received has been processed, the parser just goes back to the start of the
+ * buffer.  A partial line is left where it is until the space after it is needed (see
+ * MakeRxBufferRoom()), so it is moved at most once however many reads it takes to complete.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void ParseRxBuffer
+static void ResetRxBuffer
 (
     RxParserPtr_t rxParserPtr
 )
 {
-    RxEvent_t event;
+    RxData_t* rxDataPtr = &rxParserPtr->rxData;
 
-    for (;rxParserPtr->rxData.idx < rxParserPtr->rxData.endBuffer;)
+    if (rxParserPtr->curState == ProcessingState)
     {
-        if (GetNextEvent(rxParserPtr, &event))
+        if (rxDataPtr->idxLastCrLf == rxDataPtr->endBuffer)
         {
-            (rxParserPtr->curState)(rxParserPtr,event);
+            // Keep the CRLF that ended the last line in front of the next one.
+            rxDataPtr->buffer[0] = '\r';
+            rxDataPtr->buffer[1] = '\n';
+            rxDataPtr->idxLastCrLf = 2;
+            rxDataPtr->endBuffer = 2;
+            rxDataPtr->idx = 2;
         }
     }
+    else
+    {
+        // Nothing before the first CRLF is ever used, except a CR that may start it.
+        size_t keep = ((rxDataPtr->endBuffer > 0) &&
+                       (rxDataPtr->buffer[rxDataPtr->endBuffer - 1] == '\r')) ? 1 : 0;
+
+        rxDataPtr->buffer[0] = '\r';
+        rxDataPtr->endBuffer = keep;
+        rxDataPtr->idx = keep;
+    }
+
+    LE_DEBUG("new idx %d, startLine %d", rxDataPtr->idx, rxDataPtr->idxLastCrLf);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to delete characters that were already read.
+ * This function makes room at the end of the Rx buffer for the bytes waiting on the device, by
+ * moving the partial line being received (and the CRLF in front of it) to the start of the buffer.
+ * If the partial line alone fills the buffer, it is dropped.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void ResetRxBuffer
+static void MakeRxBufferRoom
 (
-    RxParserPtr_t rxParserPtr
+    RxParserPtr_t rxParserPtr,
+    ssize_t       available
 )
 {
-    if (rxParserPtr->curState == ProcessingState)
+    RxData_t* rxDataPtr = &rxParserPtr->rxData;
+    size_t    freeSize = PARSER_BUFFER_MAX_BYTES - rxDataPtr->endBuffer;
+
+    if ((freeSize > 0) && ((available < 0) || ((size_t)available <= freeSize)))
+    {
+        return;
+    }
+
+    if ((rxParserPtr->curState == ProcessingState) && (rxDataPtr->idxLastCrLf > 2))
     {
-        size_t idx,sizeToCopy;
-        sizeToCopy = rxParserPtr->rxData.endBuffer-rxParserPtr->rxData.idxLastCrLf+2;
+        size_t offset = rxDataPtr->idxLastCrLf - 2;
+        size_t sizeToMove = rxDataPtr->endBuffer - offset;
 
-        LE_DEBUG("%d sizeToCopy %zd from %d",
-                            rxParserPtr->rxData.idx,sizeToCopy,rxParserPtr->rxData.idxLastCrLf-2);
+        LE_DEBUG("%zu sizeToMove from %zu", sizeToMove, offset);
 
-        for (idx = 0; idx < sizeToCopy; idx++) {
-            rxParserPtr->rxData.buffer[idx] =
-                                rxParserPtr->rxData.buffer[idx+rxParserPtr->rxData.idxLastCrLf-2];
-        }
+        memmove(rxDataPtr->buffer, rxDataPtr->buffer + offset, sizeToMove);
 
-        rxParserPtr->rxData.idxLastCrLf = 2;
-        rxParserPtr->rxData.endBuffer = sizeToCopy;
-        rxParserPtr->rxData.idx = rxParserPtr->rxData.endBuffer;
-        LE_DEBUG("new idx %d, startLine %d",
-                 rxParserPtr->rxData.idx,
-                 rxParserPtr->rxData.idxLastCrLf);
+        rxDataPtr->idxLastCrLf = 2;
+        rxDataPtr->endBuffer = sizeToMove;
+        rxDataPtr->idx = sizeToMove;
     }
-    else
+    else if (rxDataPtr->endBuffer >= PARSER_BUFFER_MAX_BYTES)
     {
-        LE_DEBUG("Nothing should be copied in RxData\n");
+        LE_WARN("Rx Buffer Overflow (FillIndex = %d)!!!", rxDataPtr->idx);
+
+        rxDataPtr->endBuffer = rxDataPtr->idxLastCrLf;
+        rxDataPtr->idx = rxDataPtr->idxLastCrLf;
     }
 }
 
@@ -618,11 +824,14 @@ static void RxNewData
 
     LE_DEBUG("Start read");
 
+    /* Make room for everything waiting on the uart, so it is read in one go */
+    MakeRxBufferRoom(&interfacePtr->rxParser, le_dev_GetReadableBytes(&interfacePtr->device));
+
     /* Read RX data on uart */
     size = le_dev_Read(&interfacePtr->device,
                          (uint8_t *)(&interfacePtr->rxParser.rxData.buffer) +
-                         interfacePtr->rxParser.rxData.idx,
-                         (PARSER_BUFFER_MAX_BYTES - interfacePtr->rxParser.rxData.idx));
+                         interfacePtr->rxParser.rxData.endBuffer,
+                         (PARSER_BUFFER_MAX_BYTES - interfacePtr->rxParser.rxData.endBuffer));
 
     /* Start the parsing only if we have read some bytes */
     if (size > 0)
@@ -634,11 +843,6 @@ static void RxNewData
         ResetRxBuffer(&interfacePtr->rxParser);
     }
 
-    if (interfacePtr->rxParser.rxData.endBuffer > PARSER_BUFFER_MAX_BYTES)
-    {
-        LE_WARN("Rx Buffer Overflow (FillIndex = %d)!!!", interfacePtr->rxParser.rxData.idx);
-    }
-
     LE_DEBUG("read finished");
 }
 
@@ -664,6 +868,9 @@ static void DestroyDeviceThread
         le_mem_Release(unsolPtr);
     }
 
+    ReleaseUnsolTrie(interfacePtr->unsolTriePtr);
+    interfacePtr->unsolTriePtr = NULL;
+
     while ((linkPtr=le_dls_Pop(&interfacePtr->atCommandList)) != NULL)
     {
         AtCmd_t* atCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
@@ -773,6 +980,150 @@ static void StopTimer
     le_timer_Stop(cmdPtr->interfacePtr->timerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the number of milliseconds elapsed since a given time.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetElapsedMs
+(
+    le_clk_Time_t since
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), since);
+
+    return (uint32_t)(elapsed.sec * 1000 + elapsed.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function writes an AT command on its device.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteCommand
+(
+    AtCmd_t* cmdPtr
+)
+{
+    DeviceContext_t* interfacePtr = cmdPtr->interfacePtr;
+    QueueStats_t*    statsPtr = &interfacePtr->queueStats;
+
+    uint32_t len = strlen(cmdPtr->cmd)+2;
+    char atCommand[len];
+    memset(atCommand, 0, len);
+    snprintf(atCommand, len, "%s\r", cmdPtr->cmd);
+
+    le_dev_Write(&(interfacePtr->device),
+                   (uint8_t*) atCommand,
+                   len-1);
+
+    cmdPtr->sentTime = le_clk_GetRelativeTime();
+    interfacePtr->sentCount++;
+
+    uint32_t queueMs = GetElapsedMs(cmdPtr->queuedTime);
+    statsPtr->totalQueueMs += queueMs;
+    if (queueMs > statsPtr->maxQueueMs)
+    {
+        statsPtr->maxQueueMs = queueMs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sends the commands queued after those already sent, for as long as the device's
+ * pipeline depth allows it and all the sent commands, and the next one, are independent.
+ * Commands that send text on the prompt are never pipelined, as the prompt can't be correlated.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendPipelinedCommands
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    le_dls_List_t* listPtr = &interfacePtr->atCommandList;
+    le_dls_Link_t* linkPtr = le_dls_Peek(listPtr);
+    uint32_t       depth = (interfacePtr->pipelineDepth > 0) ? interfacePtr->pipelineDepth : 1;
+    uint32_t       i;
+
+    // All the commands already sent must be independent.
+    for (i = 0; (i < interfacePtr->sentCount) && (linkPtr != NULL); i++)
+    {
+        AtCmd_t* cmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        if ((!cmdPtr->isIndependent) || (cmdPtr->textSize > 0))
+        {
+            return;
+        }
+
+        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+    }
+
+    while ((linkPtr != NULL) && (interfacePtr->sentCount < depth))
+    {
+        AtCmd_t* cmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        if ((!cmdPtr->isIndependent) || (cmdPtr->textSize > 0))
+        {
+            return;
+        }
+
+        LE_DEBUG("Pipelining %s (%u outstanding)", cmdPtr->cmd, interfacePtr->sentCount);
+        WriteCommand(cmdPtr);
+
+        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function ends the command at the head of the queue (when its final response is received
+ * or its timeout is reached), and moves on to the next one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndCommand
+(
+    AtCmd_t* cmdPtr
+)
+{
+    DeviceContext_t* interfacePtr = cmdPtr->interfacePtr;
+    ClientStatePtr_t clientStatePtr = &interfacePtr->clientState;
+
+    le_dls_Pop(&interfacePtr->atCommandList);
+    interfacePtr->sentCount--;
+
+    interfacePtr->queueStats.cmdCount++;
+    interfacePtr->queueStats.totalResponseMs += GetElapsedMs(cmdPtr->sentTime);
+
+    le_sem_Post(cmdPtr->endSem);
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->atCommandList);
+
+    if ((interfacePtr->sentCount > 0) && (linkPtr != NULL))
+    {
+        // The next command has already been sent: its responses come next.
+        AtCmd_t* nextCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        if (nextCmdPtr->timeout > 0)
+        {
+            StartTimer(nextCmdPtr);
+        }
+
+        SendPipelinedCommands(interfacePtr);
+        return;
+    }
+
+    interfacePtr->sentCount = 0;
+
+    UpdateTransitionManager(clientStatePtr,EVENT_SENDCMD,WaitingState);
+
+    // Send the next command
+    (clientStatePtr->curState)(clientStatePtr,EVENT_SENDCMD);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Timer handler (called when the AT command timeout is reached)
@@ -788,14 +1139,8 @@ static void TimerHandler
 
     LE_ERROR("Timeout when sending %s, timeout = %d",  atCmdPtr->cmd, atCmdPtr->timeout);
     atCmdPtr->result = LE_TIMEOUT;
-    le_dls_Pop(&atCmdPtr->interfacePtr->atCommandList);
-    le_sem_Post(atCmdPtr->endSem);
-    ClientStatePtr_t clientStatePtr = &atCmdPtr->interfacePtr->clientState;
-
-    UpdateTransitionManager(clientStatePtr,EVENT_SENDCMD,WaitingState);
 
-    // Send the next command
-    (clientStatePtr->curState)(clientStatePtr,EVENT_SENDCMD);
+    EndCommand(atCmdPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -824,21 +1169,17 @@ static void StartTimer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is used to check if the line match any of final string of the command
+ * This function is used to check if the line starts with any of the expected responses
  *
  */
 //--------------------------------------------------------------------------------------------------
-static bool CheckResponse
+static bool MatchResponse
 (
-    char*          receivedRspPtr,
+    const char*    receivedRspPtr,
     size_t         lineSize,
-    le_dls_List_t* responseListPtr,
-    le_dls_List_t* resultListPtr
+    le_dls_List_t* responseListPtr
 )
 {
-    bool result = false;
-    LE_DEBUG("Start checking response");
-
     if (lineSize == 0)
     {
         return false;
@@ -852,36 +1193,87 @@ static bool CheckResponse
                                                  RspString_t,
                                                  link);
 
-        if ((strlen(currStringPtr->line) == 0) ||
-           ((lineSize >= strlen(currStringPtr->line)) &&
-           (strncmp(currStringPtr->line,receivedRspPtr,strlen(currStringPtr->line)) == 0)))
+        if ((currStringPtr->lineLen == 0) ||
+           ((lineSize >= currStringPtr->lineLen) &&
+           (memcmp(currStringPtr->line,receivedRspPtr,currStringPtr->lineLen) == 0)))
         {
             LE_DEBUG("rsp matched, size = %d", (int) lineSize);
+            return true;
+        }
 
-            RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
-            memset(newStringPtr,0,sizeof(RspString_t));
+        linkPtr = le_dls_PeekNext(responseListPtr, linkPtr);
+    }
 
-            if(lineSize>LE_ATDEFS_RESPONSE_MAX_BYTES)
-            {
-                LE_ERROR("string too long");
-                return false;
-            }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to check if a received line matches one of the expected responses, and
+ * to add it to the result list if it does.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckResponse
+(
+    char*          receivedRspPtr,
+    size_t         lineSize,
+    le_dls_List_t* responseListPtr,
+    le_dls_List_t* resultListPtr
+)
+{
+    LE_DEBUG("Start checking response");
 
-            strncpy(newStringPtr->line,receivedRspPtr,lineSize);
+    if (!MatchResponse(receivedRspPtr, lineSize, responseListPtr))
+    {
+        return false;
+    }
 
-            newStringPtr->link = LE_DLS_LINK_INIT;
+    if(lineSize>LE_ATDEFS_RESPONSE_MAX_BYTES)
+    {
+        LE_ERROR("string too long");
+        return false;
+    }
 
-            le_dls_Queue(resultListPtr,&(newStringPtr->link));
+    RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
+    memset(newStringPtr,0,sizeof(RspString_t));
 
-            return true;
-        }
+    strncpy(newStringPtr->line,receivedRspPtr,lineSize);
+    newStringPtr->lineLen = lineSize;
 
-        linkPtr = le_dls_PeekNext(responseListPtr, linkPtr);
+    newStringPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(resultListPtr,&(newStringPtr->link));
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to pass a received line straight to the response handler of the command,
+ * from the Rx buffer (the line is followed by its <CR><LF>, so it can be terminated in place).
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportResponse
+(
+    AtCmd_t* cmdPtr,
+    char*    receivedRspPtr,
+    size_t   lineSize,
+    bool     isFinal
+)
+{
+    if (lineSize > LE_ATDEFS_RESPONSE_MAX_LEN)
+    {
+        LE_WARN("Response truncated to %d bytes", LE_ATDEFS_RESPONSE_MAX_LEN);
+        lineSize = LE_ATDEFS_RESPONSE_MAX_LEN;
     }
 
-    return false;
-    LE_DEBUG("Stop checking response");
-    return result;
+    char savedChar = receivedRspPtr[lineSize];
+
+    receivedRspPtr[lineSize] = '\0';
+    cmdPtr->rspHandlerPtr(receivedRspPtr, isFinal, cmdPtr->rspContextPtr);
+    receivedRspPtr[lineSize] = savedChar;
 }
 
 
@@ -937,27 +1329,45 @@ static void SendingState
                              //~strlen(smRef->curContext.atLine));
             int32_t newCRLF = parserPtr->idx-2;
             size_t lineSize = newCRLF - parserPtr->idxLastCrLf;
+            char* linePtr = (char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]);
 
-            if (CheckResponse((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]), lineSize,
+            if (CheckResponse(linePtr, lineSize,
                                     &(cmdPtr->expectResponseList), &(cmdPtr->responseList)))
             {
                 LE_DEBUG("Final command found");
 
-                le_dls_Pop(&interfacePtr->atCommandList);
-
                 cmdPtr->result = LE_OK;
                 StopTimer(cmdPtr);
-                le_sem_Post(cmdPtr->endSem);
 
-                UpdateTransitionManager(clientStatePtr,input,WaitingState);
-                // Send the next command
-                (clientStatePtr->curState)(clientStatePtr,EVENT_SENDCMD);
+                if (cmdPtr->rspHandlerPtr != NULL)
+                {
+                    ReportResponse(cmdPtr, linePtr, lineSize, true);
+                }
+
+                EndCommand(cmdPtr);
                 return;
             }
 
-            CheckResponse((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]), lineSize,
+            if (cmdPtr->rspHandlerPtr != NULL)
+            {
+                // Streamed intermediate responses are passed on as they are, without storing them.
+                if (MatchResponse(linePtr, lineSize, &(cmdPtr->ExpectintermediateResponseList)))
+                {
+                    ReportResponse(cmdPtr, linePtr, lineSize, false);
+                }
+            }
+            else
+            {
+                CheckResponse(linePtr, lineSize,
                                     &(cmdPtr->ExpectintermediateResponseList),
                                     &(cmdPtr->responseList));
+            }
+            break;
+        }
+        case EVENT_SENDCMD:
+        {
+            // A command has been queued while others are outstanding.
+            SendPipelinedCommands(interfacePtr);
             break;
         }
         default:
@@ -1005,17 +1415,13 @@ static void WaitingState
                 StartTimer(cmdPtr);
             }
 
-            uint32_t len = strlen(cmdPtr->cmd)+2;
-            char atCommand[len];
-            memset(atCommand, 0, len);
-            snprintf(atCommand, len, "%s\r", cmdPtr->cmd);
-
-            le_dev_Write(&(interfacePtr->device),
-                           (uint8_t*) atCommand,
-                           len-1);
+            interfacePtr->sentCount = 0;
+            WriteCommand(cmdPtr);
 
             UpdateTransitionManager(clientStatePtr,input,SendingState);
 
+            SendPipelinedCommands(interfacePtr);
+
             break;
         }
         case EVENT_PROCESSLINE:
@@ -1027,7 +1433,7 @@ static void WaitingState
 
             CheckUnsolicited((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]),
                               lineSize,
-                              &interfacePtr->unsolicitedList);
+                              interfacePtr);
             break;
         }
         default:
@@ -1216,7 +1622,10 @@ static void AtCmdPoolDestructor
     ReleaseRspStringList(&(oldPtr->expectResponseList));
     ReleaseRspStringList(&(oldPtr->ExpectintermediateResponseList));
 
-    le_ref_DeleteRef(CmdRefMap, oldPtr->ref);
+    if (oldPtr->ref != NULL)
+    {
+        le_ref_DeleteRef(CmdRefMap, oldPtr->ref);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1267,6 +1676,7 @@ static void UnsolicitedPoolDestructor
     if ( le_dls_IsInList(listPtr, linkPtr) )
     {
         le_dls_Remove(listPtr, linkPtr);
+        RebuildUnsolTrie(unsolicitedPtr->interfacePtr);
     }
 }
 
@@ -1322,6 +1732,45 @@ static void RemoveUnsolicited
     le_mem_Release(unsolicitedPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function removes the response handler of a command.  It runs in the device thread, so that
+ * the handler isn't removed while a response is being reported to it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveResponseHandler
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    AtCmd_t* cmdPtr = param1Ptr;
+
+    cmdPtr->rspHandlerPtr = NULL;
+    cmdPtr->rspContextPtr = NULL;
+
+    le_mem_Release(cmdPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds an unsolicited response subscription.  It runs in the device thread, so that
+ * the pattern trie isn't rebuilt while a line is being checked against it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddUnsolicited
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    Unsolicited_t* unsolicitedPtr = param1Ptr;
+    DeviceContext_t* interfacePtr = unsolicitedPtr->interfacePtr;
+
+    le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
+    RebuildUnsolTrie(interfacePtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to create a new AT command.
@@ -1353,6 +1802,39 @@ le_atClient_CmdRef_t le_atClient_Create
     return cmdPtr->ref;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to mark an AT command as independent of the commands sent before
+ * and after it on the same device, so that it can be pipelined with them (see
+ * le_atClient_SetPipelineDepth()).
+ *
+ * @return
+ *      - LE_OK when function succeed
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetIndependent
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    bool isIndependent
+        ///< [IN] true if the command can be pipelined
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    cmdPtr->isIndependent = isIndependent;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the device where the AT command will be sent.
@@ -1419,6 +1901,11 @@ le_result_t le_atClient_Delete
         return LE_BAD_PARAMETER;
     }
 
+    // The command may be kept a little longer by the device thread (see RemoveResponseHandler()),
+    // but it can't be used any more.
+    le_ref_DeleteRef(CmdRefMap, cmdRef);
+    cmdPtr->ref = NULL;
+
     le_mem_Release(cmdPtr);
 
     return LE_OK;
@@ -1504,6 +1991,7 @@ le_result_t le_atClient_SetIntermediateResponse
             }
 
             strncpy(newStringPtr->line,interPtr,LE_ATDEFS_RESPONSE_MAX_BYTES);
+            newStringPtr->lineLen = strlen(newStringPtr->line);
 
             newStringPtr->link = LE_DLS_LINK_INIT;
 
@@ -1572,6 +2060,7 @@ le_result_t le_atClient_SetFinalResponse
             }
 
             strncpy(newStringPtr->line,respPtr,LE_ATDEFS_RESPONSE_MAX_BYTES);
+            newStringPtr->lineLen = strlen(newStringPtr->line);
 
             newStringPtr->link = LE_DLS_LINK_INIT;
 
@@ -1702,6 +2191,7 @@ le_result_t le_atClient_Send
     }
 
     cmdPtr->endSem = le_sem_Create("ResultSignal",0);
+    cmdPtr->queuedTime = le_clk_GetRelativeTime();
     le_dls_Queue(&cmdPtr->interfacePtr->atCommandList, &cmdPtr->link);
 
     ReleaseRspStringList(&cmdPtr->responseList);
@@ -1970,6 +2460,169 @@ le_result_t le_atClient_SetCommandAndSend
     return res;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the max number of independent AT commands that can be
+ * outstanding at once on a device.  1 (the default) disables pipelining.
+ *
+ * @return
+ *      - LE_FAULT when the device or the depth is invalid
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_SetPipelineDepth
+(
+    le_atClient_DeviceRef_t devRef,
+        ///< [IN] Device
+
+    uint32_t depth
+        ///< [IN] Max number of outstanding commands
+)
+{
+    DeviceContext_t* interfacePtr = le_ref_Lookup(DevicesRefMap, devRef);
+
+    if (interfacePtr == NULL)
+    {
+        LE_ERROR("Invalid device");
+        return LE_FAULT;
+    }
+
+    if ((depth == 0) || (depth > PIPELINE_MAX_DEPTH))
+    {
+        LE_ERROR("Invalid pipeline depth %u (1 to %d)", depth, PIPELINE_MAX_DEPTH);
+        return LE_FAULT;
+    }
+
+    interfacePtr->pipelineDepth = depth;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the command queue statistics of a device: how many commands have ended
+ * (with their final response or a timeout), how long they waited in the queue before being sent,
+ * and how long they took to end once sent.
+ *
+ * @return
+ *      - LE_FAULT when the device is invalid
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atClient_GetQueueStats
+(
+    le_atClient_DeviceRef_t devRef,
+        ///< [IN] Device
+
+    uint32_t* cmdCountPtr,
+        ///< [OUT] Number of commands ended
+
+    uint32_t* avgQueueMsPtr,
+        ///< [OUT] Average time waiting to be sent, in milliseconds
+
+    uint32_t* maxQueueMsPtr,
+        ///< [OUT] Longest time waiting to be sent, in milliseconds
+
+    uint32_t* avgResponseMsPtr
+        ///< [OUT] Average time between being sent and ending, in milliseconds
+)
+{
+    DeviceContext_t* interfacePtr = le_ref_Lookup(DevicesRefMap, devRef);
+
+    if (interfacePtr == NULL)
+    {
+        LE_ERROR("Invalid device");
+        return LE_FAULT;
+    }
+
+    QueueStats_t stats = interfacePtr->queueStats;
+
+    *cmdCountPtr = stats.cmdCount;
+    *maxQueueMsPtr = stats.maxQueueMs;
+    *avgQueueMsPtr = (stats.cmdCount > 0) ? (uint32_t)(stats.totalQueueMs / stats.cmdCount) : 0;
+    *avgResponseMsPtr =
+        (stats.cmdCount > 0) ? (uint32_t)(stats.totalResponseMs / stats.cmdCount) : 0;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event provides the responses of an AT command as soon as they are received.
+ *
+ * A command has at most one response handler, so the command reference is also used as the
+ * handler reference.
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_atClient_ResponseHandlerRef_t le_atClient_AddResponseHandler
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    le_atClient_ResponseHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        return NULL;
+    }
+
+    if (cmdPtr->rspHandlerPtr != NULL)
+    {
+        LE_ERROR("Command %p already has a response handler", cmdRef);
+        return NULL;
+    }
+
+    cmdPtr->rspHandlerPtr = handlerPtr;
+    cmdPtr->rspContextPtr = contextPtr;
+
+    return (le_atClient_ResponseHandlerRef_t)cmdRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_atClient_Response'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_RemoveResponseHandler
+(
+    le_atClient_ResponseHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, handlerRef);
+
+    // The handler is gone with the command if the command has been deleted.
+    if (cmdPtr == NULL)
+    {
+        return;
+    }
+
+    if (cmdPtr->interfacePtr == NULL)
+    {
+        // No device, so the handler can't be called.
+        cmdPtr->rspHandlerPtr = NULL;
+        cmdPtr->rspContextPtr = NULL;
+        return;
+    }
+
+    // The command is kept until the handler is removed, even if it is deleted in the meantime.
+    le_mem_AddRef(cmdPtr);
+
+    le_event_QueueFunctionToThread(cmdPtr->interfacePtr->threadRef,
+                                   RemoveResponseHandler,
+                                   (void*) cmdPtr,
+                                   (void*) NULL);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This event provides information on a subscribed unsolicited response when this unsolicited
@@ -2015,7 +2668,10 @@ le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHa
     unsolicitedPtr->link = LE_DLS_LINK_INIT;
     unsolicitedPtr->sessionRef = le_atClient_GetClientSessionRef();
 
-    le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
+    le_event_QueueFunctionToThread(interfacePtr->threadRef,
+                                   AddUnsolicited,
+                                   (void*) unsolicitedPtr,
+                                   (void*) NULL);
 
     return unsolicitedPtr->ref;
 }
@@ -2219,6 +2875,10 @@ COMPONENT_INIT
     le_mem_SetDestructor(UnsolicitedPool,UnsolicitedPoolDestructor);
     UnsolRefMap = le_ref_CreateMap("UnsolRefMap", UNSOLICITED_POOL_SIZE);
 
+    // Unsolicited pattern trie node pool allocation
+    UnsolNodePool = le_mem_CreatePool("AtUnsolNodePool",sizeof(UnsolNode_t));
+    le_mem_ExpandPool(UnsolNodePool,UNSOL_NODE_POOL_SIZE);
+
     // Add a handler to the close session service
     le_msg_AddServiceCloseHandler(
         le_atClient_GetServiceRef(), CloseSessionEventHandler, NULL);
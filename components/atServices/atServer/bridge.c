@@ -90,6 +90,7 @@ typedef struct
     ModemCmdRef_t                    modemCmdRef;                   /// modem AT command reference
     le_atServer_CmdRef_t             atServerCmdRef;                ///< AT server command reference
     le_atClient_CmdRef_t             atClientCmdRef;                ///< AT client command reference
+    le_atClient_ResponseHandlerRef_t rspHandlerRef;                 ///< AT client response handler
     char                             cmd[LE_ATDEFS_COMMAND_MAX_BYTES];  ///< cmd to be sent to AT
                                                                     ///< client
 }
@@ -174,6 +175,34 @@ const char ErrorString[] = "ERROR";
 //--------------------------------------------------------------------------------------------------
 char AtClientFinalResponse[LE_ATDEFS_RESPONSE_MAX_BYTES];
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the AT client command of a modem AT command, once it is over
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteAtClientCmd
+(
+    ModemCmdDesc_t* modemCmdDescPtr
+)
+{
+    // Removing the handler first drops the responses still on their way, if any.
+    if (modemCmdDescPtr->rspHandlerRef)
+    {
+        le_atClient_RemoveResponseHandler(modemCmdDescPtr->rspHandlerRef);
+        modemCmdDescPtr->rspHandlerRef = NULL;
+    }
+
+    if (modemCmdDescPtr->atClientCmdRef)
+    {
+        if (LE_OK != le_atClient_Delete(modemCmdDescPtr->atClientCmdRef))
+        {
+            LE_ERROR("Error in deleting atClient reference");
+        }
+        modemCmdDescPtr->atClientCmdRef = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is the destructor for ModemCmdDesc_t struct
@@ -211,13 +240,7 @@ static void ModemCmdPoolDestructor
     LE_DEBUG("atClientCmdRef %p", modemCmdDescPtr->atClientCmdRef);
 
     // Clean AT client contexts
-    if (modemCmdDescPtr->atClientCmdRef)
-    {
-        if (LE_OK != le_atClient_Delete(modemCmdDescPtr->atClientCmdRef))
-        {
-            LE_ERROR("Error in le_atServer_Delete");
-        }
-    }
+    DeleteAtClientCmd(modemCmdDescPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -319,19 +342,22 @@ static void TreatCommandError
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Treat response of the AT command (coming from modem)
+ * Treat a response of the AT command (coming from modem), as soon as the AT client has received it
+ * ("cut-through" bridging: a long response is sent to the host line by line while the modem is
+ * still answering, rather than once the command is over).
  * This function is called in the main thread (mandatory as this function calls le_atServer_xxx
  * functions).
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void TreatResponse
+static void ResponseHandler
 (
-    void* param1Ptr,
-    void* param2Ptr
+    const char* rspPtr,
+    bool isFinal,
+    void* contextPtr
 )
 {
-    ModemCmdDesc_t* modemCmdDescPtr = param1Ptr;
+    ModemCmdDesc_t* modemCmdDescPtr = contextPtr;
 
     if(NULL == modemCmdDescPtr)
     {
@@ -340,90 +366,110 @@ static void TreatResponse
     }
 
     le_atServer_CmdRef_t atServerCmdRef = modemCmdDescPtr->atServerCmdRef;
-    le_atClient_CmdRef_t atClientCmdRef = modemCmdDescPtr->atClientCmdRef;
-    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES];
 
-    // Get all intermediate responses from the AT client, and send back to the host through the AT
-    // server.
-    if (LE_OK == le_atClient_GetFirstIntermediateResponse(atClientCmdRef,
-                                                          rsp,
-                                                          LE_ATDEFS_RESPONSE_MAX_BYTES))
+    // Send the intermediate response back to the host through the AT server.
+    if (!isFinal)
     {
-        do
+        if (LE_OK != le_atServer_SendIntermediateResponse(atServerCmdRef, rspPtr))
         {
-            if (LE_OK != le_atServer_SendIntermediateResponse(atServerCmdRef, rsp))
-            {
-                LE_ERROR("Failed to send intermediate response");
-                TreatCommandError(modemCmdDescPtr, NULL);
-                return;
-            }
-            memset(rsp, 0, LE_ATDEFS_RESPONSE_MAX_BYTES);
+            LE_ERROR("Failed to send intermediate response");
         }
-        while (LE_OK == le_atClient_GetNextIntermediateResponse(atClientCmdRef,
-                                                                rsp,
-                                                                LE_ATDEFS_RESPONSE_MAX_BYTES));
+        return;
     }
 
-    // Get the final response from the AT client, and send back to the host through the AT
-    // server.
-    if (LE_OK == le_atClient_GetFinalResponse(atClientCmdRef,
-                                              rsp,
-                                              LE_ATDEFS_RESPONSE_MAX_BYTES))
-    {
-        int i;
-        le_atServer_FinalRsp_t finalRsp = LE_ATSERVER_ERROR;
+    // The command is over: send the final response back to the host through the AT server.
+    int i;
+    le_atServer_FinalRsp_t finalRsp = LE_ATSERVER_ERROR;
 
-        // check if the response code is an error
-        for (i=0; i < NUM_ARRAY_MEMBERS(SuccessRspCode); i++)
+    // check if the response code is an error
+    for (i=0; i < NUM_ARRAY_MEMBERS(SuccessRspCode); i++)
+    {
+        if (0 == strncmp(SuccessRspCode[i], rspPtr, strlen(rspPtr)))
         {
-            if (0 == strncmp(SuccessRspCode[i], rsp, strlen(rsp)))
-            {
-                finalRsp = LE_ATSERVER_OK;
-                break;
-            }
+            finalRsp = LE_ATSERVER_OK;
+            break;
         }
+    }
 
-        LE_DEBUG("finalRsp = %s", (finalRsp == LE_ATSERVER_OK) ? "ok": "error");
+    LE_DEBUG("finalRsp = %s", (finalRsp == LE_ATSERVER_OK) ? "ok": "error");
 
-        if (LE_OK != le_atServer_SendFinalResponse(atServerCmdRef,
-                                                   finalRsp,
-                                                   true,
-                                                   rsp))
-        {
-            LE_ERROR("Failed to send final response");
-            TreatCommandError(modemCmdDescPtr, NULL);
-            return;
-        }
+    if (LE_OK != le_atServer_SendFinalResponse(atServerCmdRef,
+                                               finalRsp,
+                                               true,
+                                               rspPtr))
+    {
+        LE_ERROR("Failed to send final response");
+        TreatCommandError(modemCmdDescPtr, NULL);
+        return;
+    }
 
-        if (LE_OK != le_atClient_Delete(modemCmdDescPtr->atClientCmdRef))
-        {
-            LE_ERROR("Error in deleting atClient reference");
-        }
-        else
-        {
-            modemCmdDescPtr->atClientCmdRef = 0;
-        }
+    // "ERROR" final response could mean that the AT command doesn't exist => delete it in this
+    // case
+    if (0 == strncmp(rspPtr, ErrorString, sizeof(ErrorString)))
+    {
+        LE_DEBUG("Remove AT command");
+        le_mem_Release(modemCmdDescPtr);
+        return;
+    }
 
-        // "ERROR" final response could mean that the AT command doesn't exist => delete it in this
-        // case
-        if (0 == strncmp(rsp, ErrorString, sizeof(ErrorString)))
-        {
-            LE_DEBUG("Remove AT command");
-            le_mem_Release(modemCmdDescPtr);
-        }
+    DeleteAtClientCmd(modemCmdDescPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepare the AT client command of a modem AT command, with its responses streamed to
+ * ResponseHandler() in the main thread.
+ * This function is called in the main thread, so that the responses are reported to it.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The function failed to prepare the command.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareAtCommand
+(
+    ModemCmdDesc_t* modemCmdDescPtr,
+    BridgeCtx_t* bridgePtr
+)
+{
+    // Clean the AT client command left by a previous failure, if any.
+    DeleteAtClientCmd(modemCmdDescPtr);
+
+    modemCmdDescPtr->atClientCmdRef = le_atClient_Create();
+
+    if ((LE_OK != le_atClient_SetCommand(modemCmdDescPtr->atClientCmdRef,
+                                         modemCmdDescPtr->cmd)) ||
+        (LE_OK != le_atClient_SetDevice(modemCmdDescPtr->atClientCmdRef,
+                                        bridgePtr->atClientRef)) ||
+        (LE_OK != le_atClient_SetTimeout(modemCmdDescPtr->atClientCmdRef,
+                                         AT_CLIENT_TIMEOUT)) ||
+        (LE_OK != le_atClient_SetIntermediateResponse(modemCmdDescPtr->atClientCmdRef, "")) ||
+        (LE_OK != le_atClient_SetFinalResponse(modemCmdDescPtr->atClientCmdRef,
+                                               AtClientFinalResponse)))
+    {
+        LE_ERROR("Error in setting AT command");
+        return LE_FAULT;
     }
-    else
+
+    modemCmdDescPtr->rspHandlerRef = le_atClient_AddResponseHandler(
+                                                                modemCmdDescPtr->atClientCmdRef,
+                                                                ResponseHandler,
+                                                                modemCmdDescPtr);
+
+    if (NULL == modemCmdDescPtr->rspHandlerRef)
     {
-        LE_ERROR("Failed to get final response");
-        TreatCommandError(modemCmdDescPtr, NULL);
+        LE_ERROR("Error in adding response handler");
+        return LE_FAULT;
     }
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Send the AT command to the modem through the AT client
- * This function is called in a separate thread: le_atClient_SetCommandAndSend is synchronous, and
- * can be locked many seconds (>30s for some of them).
+ * This function is called in a separate thread: le_atClient_Send is synchronous, and can be locked
+ * many seconds (>30s for some of them).
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -444,13 +490,9 @@ static void SendAtCommand
 
     LE_DEBUG("AT command to be sent to the modem: %s", modemCmdDescPtr->cmd);
 
-    // Send AT command to  the modem
-    if (LE_OK != le_atClient_SetCommandAndSend(&modemCmdDescPtr->atClientCmdRef,
-                                               bridgePtr->atClientRef,
-                                               modemCmdDescPtr->cmd,
-                                               "",
-                                               AtClientFinalResponse,
-                                               AT_CLIENT_TIMEOUT))
+    // Send AT command to  the modem.  On success, its responses have been given to
+    // ResponseHandler() as they came.
+    if (LE_OK != le_atClient_Send(modemCmdDescPtr->atClientCmdRef))
     {
         LE_ERROR("Error in sending AT command");
         // Treat the error in the main thread
@@ -458,14 +500,7 @@ static void SendAtCommand
                                        TreatCommandError,
                                        modemCmdDescPtr,
                                        NULL);
-        return;
     }
-
-    // Treat the send of responses in the main thread
-    le_event_QueueFunctionToThread(bridgePtr->mainThreadRef,
-                                   TreatResponse,
-                                   modemCmdDescPtr,
-                                   NULL);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -596,6 +631,12 @@ static void AtCmdHandler
         break;
     }
 
+    if (LE_OK != PrepareAtCommand(modemCmdDescPtr, bridgePtr))
+    {
+        TreatCommandError(modemCmdDescPtr, NULL);
+        return;
+    }
+
     // Treat the AT commands in the Bridge thread in order to not lock the main thread
     le_event_QueueFunctionToThread(bridgePtr->threadRef,
                                    SendAtCommand,
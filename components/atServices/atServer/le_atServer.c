@@ -34,10 +34,18 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Command parameters pool size
+ * Max number of parameters of a command
  */
 //--------------------------------------------------------------------------------------------------
-#define PARAM_POOL_SIZE       20
+#define PARAM_MAX_COUNT       64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer holding the parameters of a command.  The parameters are never longer than
+ * the command line they are parsed from, plus a null character each.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_BUFFER_BYTES    (LE_ATDEFS_COMMAND_MAX_BYTES + PARAM_MAX_COUNT)
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -154,13 +162,6 @@ static le_mem_PoolRef_t    DevicesPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  AtCommandsPool;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Pool for parameter string
- */
-//--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t  ParamStringPool;
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Pool for response
@@ -197,19 +198,6 @@ static le_hashmap_Ref_t   CmdHashMap;
 //--------------------------------------------------------------------------------------------------
 static bool ExtendedErrorCodes = false;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * structure used to describe a parameter.
- *
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    char            param[LE_ATDEFS_PARAMETER_MAX_BYTES];   ///< string value
-    le_dls_Link_t   link;                                   ///< link for list
-}
-ParamString_t;
-
 //--------------------------------------------------------------------------------------------------
 /**
  * AT command response structure.
@@ -285,7 +273,11 @@ typedef struct
     char                    cmdName[LE_ATDEFS_COMMAND_MAX_BYTES];   ///< Command to send
     le_atServer_AvailableDevice_t availableDevice;                  ///< device to send unsol rsp
     le_atServer_Type_t      type;                                   ///< cmd type
-    le_dls_List_t           paramList;                              ///< parameters list
+    char                    paramBuffer[PARAM_BUFFER_BYTES];        ///< parameter strings
+    uint16_t                paramOffset[PARAM_MAX_COUNT];           ///< offset of each parameter
+                                                                    ///< in paramBuffer
+    uint32_t                paramCount;                             ///< number of parameters
+    uint32_t                paramBufferUsed;                        ///< bytes used in paramBuffer
     bool                    processing;                             ///< is command processing
     le_atServer_DeviceRef_t deviceRef;                              ///< device refrence
     bool                    bridgeCmd;                              ///< is command created by the
@@ -492,22 +484,12 @@ static void AtCmdPoolDestructor
 )
 {
     ATCmdSubscribed_t* cmdPtr = commandPtr;
-    le_dls_Link_t* linkPtr;
 
     LE_DEBUG("AT command pool destructor");
 
     // cleanup the hashmap
     le_hashmap_Remove(CmdHashMap, cmdPtr->cmdName);
 
-    // cleanup ParamList dls pool
-    while((linkPtr = le_dls_Pop(&cmdPtr->paramList)) != NULL)
-    {
-        ParamString_t *paramPtr = CONTAINER_OF(linkPtr,
-                                    ParamString_t,
-                                    link);
-        le_mem_Release(paramPtr);
-    }
-
     le_ref_DeleteRef(SubscribedCmdRefMap, cmdPtr->cmdRef);
 }
 
@@ -615,19 +597,12 @@ static void SendFinalRsp
 static void SendIntermediateRsp
 (
     DeviceContext_t* devPtr,
-    RspString_t* rspStringPtr
+    const char* rspPtr
 )
 {
-    if (rspStringPtr == NULL)
-    {
-        LE_ERROR("Bad rspStringPtr");
-        return;
-    }
-
     if (devPtr == NULL)
     {
         LE_ERROR("Bad devPtr");
-        le_mem_Release(rspStringPtr);
         return;
     }
 
@@ -638,12 +613,10 @@ static void SendIntermediateRsp
         (devPtr->cmdParser.currentCmdPtr && !((devPtr->cmdParser.currentCmdPtr)->processing)))
     {
         LE_ERROR("Command not processing anymore");
-        le_mem_Release(rspStringPtr);
         return;
     }
 
-    SendRspString(devPtr, RSP_TYPE_RESPONSE, rspStringPtr->resp);
-    le_mem_Release(rspStringPtr);
+    SendRspString(devPtr, RSP_TYPE_RESPONSE, rspPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -852,6 +825,64 @@ static le_result_t ParseContinue
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the buffer where the next parameter of a command is to be written.
+ *
+ * @return
+ *      - Pointer to a zeroed buffer, big enough for the rest of the command line
+ *      - NULL if the command already has the max number of parameters
+ */
+//--------------------------------------------------------------------------------------------------
+static char* StartParam
+(
+    ATCmdSubscribed_t* cmdPtr
+)
+{
+    if (cmdPtr->paramCount >= PARAM_MAX_COUNT)
+    {
+        LE_ERROR("Too many parameters");
+        return NULL;
+    }
+
+    char* paramPtr = cmdPtr->paramBuffer + cmdPtr->paramBufferUsed;
+
+    memset(paramPtr, 0, PARAM_BUFFER_BYTES - cmdPtr->paramBufferUsed);
+
+    return paramPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the parameter written in the buffer returned by StartParam() to the parameters of a command.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndParam
+(
+    ATCmdSubscribed_t* cmdPtr,
+    uint32_t           len
+)
+{
+    cmdPtr->paramOffset[cmdPtr->paramCount++] = cmdPtr->paramBufferUsed;
+    cmdPtr->paramBufferUsed += len + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the parameters of a command.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearParams
+(
+    ATCmdSubscribed_t* cmdPtr
+)
+{
+    cmdPtr->paramCount = 0;
+    cmdPtr->paramBufferUsed = 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * AT parser transition (Get a parameter from basic format commands)
@@ -863,11 +894,15 @@ static le_result_t ParseBasicCmdParam
     CmdParser_t* cmdParserPtr
 )
 {
-    ParamString_t* paramPtr = le_mem_ForceAlloc(ParamStringPool);
-    memset(paramPtr,0,sizeof(ParamString_t));
+    char* paramPtr = StartParam(cmdParserPtr->currentCmdPtr);
     uint32_t index = 0;
     bool tokenQuote = false;
 
+    if (paramPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
     while ( cmdParserPtr->currentCharPtr <= cmdParserPtr->lastCharPtr )
     {
         if ( IS_QUOTE(*cmdParserPtr->currentCharPtr) )
@@ -884,14 +919,14 @@ static le_result_t ParseBasicCmdParam
             // If "bridge command", keep the quote
             if ((cmdParserPtr->currentCmdPtr)->bridgeCmd)
             {
-                paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                paramPtr[index++] = *cmdParserPtr->currentCharPtr;
             }
         }
         else
         {
             if ((tokenQuote) || ( IS_NUMBER(*cmdParserPtr->currentCharPtr) ))
             {
-                paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                paramPtr[index++] = *cmdParserPtr->currentCharPtr;
             }
             else if (*cmdParserPtr->currentCharPtr == AT_TOKEN_EQUAL)
             {
@@ -908,7 +943,7 @@ static le_result_t ParseBasicCmdParam
     }
 
     cmdParserPtr->currentCmdPtr->type = LE_ATSERVER_TYPE_PARA;
-    le_dls_Queue(&(cmdParserPtr->currentCmdPtr->paramList),&(paramPtr->link));
+    EndParam(cmdParserPtr->currentCmdPtr, index);
 
     return LE_OK;
 }
@@ -930,11 +965,15 @@ static le_result_t ParseBasicDCmdParam
 
     int i;
     int index = 0;
-    ParamString_t* paramPtr = le_mem_ForceAlloc(ParamStringPool);
+    char* paramPtr = StartParam(cmdParserPtr->currentCmdPtr);
     bool dialingFromPhonebook = false;
-    memset(paramPtr,0,sizeof(ParamString_t));
     bool tokenQuote = false;
 
+    if (paramPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
     LE_DEBUG("%s", cmdParserPtr->currentCharPtr);
 
     if ( *cmdParserPtr->currentCharPtr == '>' )
@@ -957,24 +996,24 @@ static le_result_t ParseBasicDCmdParam
                     tokenQuote = true;
                 }
 
-                paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                paramPtr[index++] = *cmdParserPtr->currentCharPtr;
             }
             else
             {
                 if (tokenQuote)
                 {
-                    paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                    paramPtr[index++] = *cmdParserPtr->currentCharPtr;
                 }
                 else
                 {
                     if ( (*cmdParserPtr->currentCharPtr == 'i') ||
                          ( *cmdParserPtr->currentCharPtr == 'g') )
                     {
-                        paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                        paramPtr[index++] = *cmdParserPtr->currentCharPtr;
                     }
                     else
                     {
-                        paramPtr->param[index++] = toupper(*cmdParserPtr->currentCharPtr);
+                        paramPtr[index++] = toupper(*cmdParserPtr->currentCharPtr);
                     }
                 }
             }
@@ -995,7 +1034,7 @@ static le_result_t ParseBasicDCmdParam
                 {
                     if (*testCharPtr == *charTabPtr[i])
                     {
-                        paramPtr->param[index++] = *testCharPtr;
+                        paramPtr[index++] = *testCharPtr;
                         charFound = true;
                         break;
                     }
@@ -1030,13 +1069,12 @@ static le_result_t ParseBasicDCmdParam
     if (index == 0)
     {
         LE_ERROR("empty phone number");
-        le_mem_Release(paramPtr);
         return LE_FAULT;
     }
 
 end:
     cmdParserPtr->currentCmdPtr->type = LE_ATSERVER_TYPE_PARA;
-    le_dls_Queue(&(cmdParserPtr->currentCmdPtr->paramList),&(paramPtr->link));
+    EndParam(cmdParserPtr->currentCmdPtr, index);
 
     return LE_OK;
 }
@@ -1212,13 +1250,17 @@ static le_result_t ParseParam
     CmdParser_t* cmdParserPtr
 )
 {
-    ParamString_t* paramPtr = le_mem_ForceAlloc(ParamStringPool);
-    memset(paramPtr,0,sizeof(ParamString_t));
+    char* paramPtr = StartParam(cmdParserPtr->currentCmdPtr);
     uint32_t index = 0;
     bool tokenQuote = false;
     bool loop = true;
 
-    if (le_dls_NumLinks(&(cmdParserPtr->currentCmdPtr->paramList)) != 0)
+    if (paramPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    if (cmdParserPtr->currentCmdPtr->paramCount != 0)
     {
         // bypass comma (not done for the first param)
         cmdParserPtr->currentCharPtr++;
@@ -1248,7 +1290,7 @@ static le_result_t ParseParam
             // If "bridge command", keep the quote
             if ((cmdParserPtr->currentCmdPtr)->bridgeCmd)
             {
-                paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                paramPtr[index++] = *cmdParserPtr->currentCharPtr;
             }
         }
         else
@@ -1261,11 +1303,10 @@ static le_result_t ParseParam
 
             if ((tokenQuote) || ( IS_PARAM_CHAR(*cmdParserPtr->currentCharPtr) ))
             {
-                paramPtr->param[index++] = *cmdParserPtr->currentCharPtr;
+                paramPtr[index++] = *cmdParserPtr->currentCharPtr;
             }
             else
             {
-                le_mem_Release(paramPtr);
                 return LE_FAULT;
             }
         }
@@ -1286,7 +1327,7 @@ static le_result_t ParseParam
         }
     }
 
-    le_dls_Queue(&(cmdParserPtr->currentCmdPtr->paramList),&(paramPtr->link));
+    EndParam(cmdParserPtr->currentCmdPtr, index);
 
     return LE_OK;
 }
@@ -1496,6 +1537,7 @@ static void ParseAtCmd
                 if (cmdParserPtr->currentCmdPtr)
                 {
                     cmdParserPtr->currentCmdPtr->processing = false;
+                    ClearParams(cmdParserPtr->currentCmdPtr);
                 }
             }
 
@@ -1511,7 +1553,7 @@ static void ParseAtCmd
         {
             (cmdPtr->handlerFunc)( cmdPtr->cmdRef,
                                    cmdPtr->type,
-                                   le_dls_NumLinks(&(cmdPtr->paramList)),
+                                   cmdPtr->paramCount,
                                    cmdPtr->handlerContextPtr );
         }
         else
@@ -2140,7 +2182,6 @@ le_atServer_CmdRef_t le_atServer_Create
     le_hashmap_Put(CmdHashMap, cmdPtr->cmdName, cmdPtr);
 
     cmdPtr->availableDevice = LE_ATSERVER_ALL_DEVICES;
-    cmdPtr->paramList = LE_DLS_LIST_INIT;
     cmdPtr->sessionRef = le_atServer_GetClientSessionRef();
 
     // Check for specific DIAL command
@@ -2287,34 +2328,15 @@ le_result_t le_atServer_GetParameter
         return LE_FAULT;
     }
 
-    uint32_t numParam = le_dls_NumLinks(&cmdPtr->paramList);
-    uint32_t i;
-    le_dls_Link_t* linkPtr;
-
-    if (index >= numParam)
+    if (index >= cmdPtr->paramCount)
     {
         return LE_BAD_PARAMETER;
     }
 
-    linkPtr = le_dls_Peek(&cmdPtr->paramList);
-
-    for(i=0;i<index;i++)
-    {
-        linkPtr = le_dls_PeekNext(&cmdPtr->paramList, linkPtr);
-    }
-
-    if (linkPtr)
-    {
-        ParamString_t* paramPtr;
-
-        paramPtr = CONTAINER_OF(linkPtr, ParamString_t, link);
+    snprintf(parameter, parameterNumElements, "%s",
+             cmdPtr->paramBuffer + cmdPtr->paramOffset[index]);
 
-        snprintf(parameter, parameterNumElements, "%s", paramPtr->param);
-
-        return LE_OK;
-    }
-
-    return LE_FAULT;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2432,10 +2454,8 @@ le_result_t le_atServer_SendIntermediateResponse
         return LE_FAULT;
     }
 
-    RspString_t* rspStringPtr = le_mem_ForceAlloc(RspStringPool);
-    strncpy(rspStringPtr->resp, intermediateRspPtr, LE_ATDEFS_RESPONSE_MAX_BYTES);
-
-    SendIntermediateRsp(devPtr, rspStringPtr);
+    // Written straight to the device: bridged modem responses are sent one by one as they come.
+    SendIntermediateRsp(devPtr, intermediateRspPtr);
 
     return LE_OK;
 }
@@ -2492,12 +2512,7 @@ le_result_t le_atServer_SendFinalResponse
 
 
     // clean AT command context, not in use now
-    le_dls_Link_t* linkPtr;
-    while ((linkPtr=le_dls_Pop(&cmdPtr->paramList)) != NULL)
-    {
-        ParamString_t *paraPtr = CONTAINER_OF(linkPtr, ParamString_t, link);
-        le_mem_Release(paraPtr);
-    }
+    ClearParams(cmdPtr);
 
     cmdPtr->deviceRef = NULL;
     cmdPtr->processing = false;
@@ -2824,8 +2839,6 @@ COMPONENT_INIT
                                    );
 
     // Parameters pool allocation
-    ParamStringPool = le_mem_CreatePool("ParamStringPool",sizeof(ParamString_t));
-    le_mem_ExpandPool(ParamStringPool,PARAM_POOL_SIZE);
 
     // Parameters pool allocation
     RspStringPool = le_mem_CreatePool("RspStringPool",sizeof(RspString_t));
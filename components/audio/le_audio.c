@@ -3208,6 +3208,119 @@ le_result_t le_audio_GetSamplePcmSamplingResolution
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the period size (in frames) used to stream PCM samples with le_audio_PlaySamples() and
+ * le_audio_GetSamples(). A non-zero value enables the low-latency streaming; 0 restores the
+ * driver default.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_SetSamplePcmPeriodSize
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t periodSize
+        ///< [IN]
+        ///< Period size in frames.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    streamPtr->samplePcmConfig.periodSize = periodSize;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the period size (in frames) used to stream PCM samples.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_GetSamplePcmPeriodSize
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t* periodSizePtr
+        ///< [OUT]
+        ///< Period size in frames.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    *periodSizePtr = streamPtr->samplePcmConfig.periodSize;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of the last PCM samples streaming (le_audio_PlaySamples() or
+ * le_audio_GetSamples()) of a stream.
+ *
+ * The latency is the time the last period waited in the pipe, plus the period duration.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_GetSamplesStatistics
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t* underrunCountPtr,
+        ///< [OUT]
+        ///< Periods played as silence for lack of samples.
+
+    uint32_t* overrunCountPtr,
+        ///< [OUT]
+        ///< Captured periods dropped for lack of room.
+
+    uint32_t* latencyPtr
+        ///< [OUT]
+        ///< Last measured latency in milliseconds.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    *underrunCountPtr = streamPtr->samplesStats.underrunCount;
+    *overrunCountPtr = streamPtr->samplesStats.overrunCount;
+    *latencyPtr = streamPtr->samplesStats.latency;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to play a DTMF on a specific audio stream.
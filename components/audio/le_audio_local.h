@@ -18,9 +18,23 @@ typedef struct
     uint16_t channelsCount;         ///< Number of channels
     uint16_t bitsPerSample;         ///< Sampling resolution
     uint32_t byteRate;              ///< byterate of the played/recorded file
+    uint32_t periodSize;            ///< Period size in frames, 0 for the driver default
 }
 le_audio_SamplePcmConfig_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the audio samples streamed through le_audio_PlaySamples()/le_audio_GetSamples().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t underrunCount;         ///< Periods played as silence because no sample was available
+    uint32_t overrunCount;          ///< Captured periods dropped because the client was too late
+    uint32_t latency;               ///< Last measured latency in milliseconds
+}
+le_audio_SamplesStats_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configuration of AMR samples.
@@ -88,6 +102,7 @@ typedef struct {
     bool                        pause;              ///< pause in capture
     le_audio_MediaEvent_t       mediaEvent;         ///< media event to be sent
     int                         framesFuncTimeout;  ///< Timeout for getFramesFunc callback
+    bool                        lowLatency;         ///< Pipe sized to the period
 }
 le_audio_PcmContext_t;
 
@@ -147,6 +162,7 @@ typedef le_result_t (*CloseMediaFunc_t)
 //--------------------------------------------------------------------------------------------------
 typedef struct le_audio_Opaque* le_audio_Codec_t;
 typedef struct le_audio_Opaque* pa_audio_Params_t;
+typedef struct le_audio_MediaQueue* le_audio_MediaQueuePtr_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -172,6 +188,8 @@ typedef struct le_audio_MediaThreadContext
     CloseMediaFunc_t                 closeFunc;          ///< Close function for play/capture
                                                          ///< in WAV/AMR format
     le_audio_Codec_t                 codecParams;        ///< Codec parameters
+    le_audio_MediaQueuePtr_t         queuePtr;           ///< Frames passed from the read stage
+                                                         ///< to the write stage
 }
 le_audio_MediaThreadContext_t;
 
@@ -195,6 +213,7 @@ typedef struct le_audio_Stream {
     le_event_Id_t    streamEventId;                    ///< Event ID to report stream events
     le_audio_StreamRef_t streamRef;                    ///< Stream reference
     le_audio_SamplePcmConfig_t  samplePcmConfig;       ///< Sample PCM configuration
+    le_audio_SamplesStats_t     samplesStats;          ///< Samples streaming statistics
     le_dls_List_t    sessionRefList;                   ///< Clients sessionRef list
     le_audio_SampleAmrConfig_t  sampleAmrConfig;       ///< Sample AMR configuration
     le_audio_Format_t   encodingFormat;                ///< Audio encoding format
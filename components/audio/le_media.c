@@ -15,7 +15,9 @@
 #include "pa_audio.h"
 #include "pa_amr.h"
 #include "pa_pcm.h"
+#include "le_mixer_local.h"
 #include <math.h>
+#include <sys/ioctl.h>
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -39,6 +41,29 @@
 #define PI 3.14159265358979323846264338327
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sine table used to synthesize the tones with a phase accumulator: the upper bits of the 32-bit
+ * phase index the table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TONE_TABLE_BITS     10
+#define TONE_TABLE_SIZE     (1 << TONE_TABLE_BITS)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duration of the DTMF samples generated at once, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DTMF_PERIOD_MS      20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples of the second tone generated at once before being mixed into the first one.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TONE_BLOCK_SAMPLES  64
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Symbols used to populate wave header file.
@@ -57,6 +82,22 @@
 //--------------------------------------------------------------------------------------------------
 #define NO_MORE_SAMPLES_INFINITE_TIMEOUT -1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of periods the pipe can hold when the low-latency streaming is enabled
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOW_LATENCY_PIPE_PERIODS    2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of frames the read stage of a media thread can get ahead of its write stage, and largest
+ * frame passed between them.  Media threads with larger frames read and write them in turn.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MEDIA_QUEUE_DEPTH           8
+#define MEDIA_FRAME_MAX_BYTES       4096
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
@@ -97,6 +138,8 @@ typedef struct
     char     dtmf[LE_AUDIO_DTMF_MAX_BYTES];    ///< The DTMFs to play.
     uint32_t currentDtmf;        ///< Index of the play dtmf
     uint32_t currentSampleCount; ///< Current sample count for the current DTMF
+    uint32_t phase[2];           ///< Phase accumulators of the low and high tones
+    uint32_t phaseStep[2];       ///< Phase increments per sample of the low and high tones
 }
 DtmfParams_t;
 
@@ -128,6 +171,48 @@ typedef enum
 }
 ControlOperation_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timing of a stage of a media thread.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;              ///< Number of frames processed
+    uint64_t totalUs;            ///< Time spent processing them, in microseconds
+    uint32_t maxUs;              ///< Longest time spent on a frame, in microseconds
+}
+MediaStageStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue of frames between the read stage of a media thread (file reading or decoding for
+ * playback, pipe reading for capture) and its write stage (pipe writing for playback, encoding or
+ * file writing for capture), which runs in a thread of its own.  It is a ring of pooled frames:
+ * the read stage fills them in order and the write stage empties them in the same order.
+ *
+ * POSIX semaphores count the free and filled frames, as waiting on them is a cancellation point:
+ * le_media_Stop() can still cancel the media threads wherever they wait.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_audio_MediaQueue
+{
+    le_thread_Ref_t     writeThreadRef;                 ///< Thread of the write stage
+    sem_t               freeSem;                        ///< Number of free frames
+    sem_t               filledSem;                      ///< Number of filled frames
+    uint8_t*            framePtr[MEDIA_QUEUE_DEPTH];    ///< Frames of the ring
+    uint32_t            frameLen[MEDIA_QUEUE_DEPTH];    ///< Lengths of the frames, 0 at the end
+    uint32_t            head;                           ///< Next frame filled by the read stage
+    uint32_t            tail;                           ///< Next frame emptied by the write stage
+    volatile bool       writeFailed;                    ///< The write stage failed
+    uint32_t            maxFilled;                      ///< Largest number of filled frames
+    MediaStageStats_t   readStats;                      ///< Timing of the read stage
+    MediaStageStats_t   writeStats;                     ///< Timing of the write stage
+}
+MediaQueue_t;
+
 //--------------------------------------------------------------------------------------------------
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
@@ -160,6 +245,20 @@ static le_mem_PoolRef_t MediaThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t PcmThreadContextPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the queues between the stages of the media threads
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MediaQueuePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the frames passed between the stages of the media threads
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MediaFramePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Wake Lock for audio streams
@@ -168,6 +267,14 @@ static le_mem_PoolRef_t PcmThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_pm_WakeupSourceRef_t MediaWakeLock;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * One period of a DTMF tone, at the DTMF amplitude
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int16_t ToneTable[TONE_TABLE_SIZE];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reads a specified number of bytes from the provided file descriptor into the provided buffer.
@@ -383,36 +490,69 @@ static inline uint32_t Digit2HighFreq
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Add two 16-bit values.
+ *  Fill the sine table used to synthesize the tones.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static inline int16_t SaturateAdd16
+static void InitToneTable
 (
-    int32_t a,
-    int32_t b
+    void
 )
 {
-    int32_t tot=a+b;
+    int i;
 
-    if (tot > 32767)
+    for (i = 0; i < TONE_TABLE_SIZE; i++)
     {
-        return 32767;
+        ToneTable[i] = (int16_t)(SAMPLE_SCALE * DTMF_AMPLITUDE / 100.0f *
+                                 sin(2 * PI * i / TONE_TABLE_SIZE));
     }
-    else if (tot < -32768)
-    {
-        return -32768;
-    }
-    else
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Return the phase increment per sample of a tone.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t ToneStep
+(
+    uint32_t freq,
+    uint32_t sampleRate
+)
+{
+    return (uint32_t)(((uint64_t)freq << 32) / sampleRate);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Synthesize samples of a tone, from the phase accumulator which is updated.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SynthesizeTone
+(
+    int16_t*  dataPtr,
+    uint32_t  count,
+    uint32_t* phasePtr,
+    uint32_t  phaseStep
+)
+{
+    uint32_t phase = *phasePtr;
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
     {
-        return (tot & 0xFFFF);
+        dataPtr[i] = ToneTable[phase >> (32 - TONE_TABLE_BITS)];
+        phase += phaseStep;
     }
+
+    *phasePtr = phase;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Play Tone function. This function split into samples of 1s. To play a DTMF or a PAUSE for a
- *  duration greater than 1s, several calls are mandatory to get the whole duration sample.
+ *  Play Tone function. This function split into samples of DTMF_PERIOD_MS. To play a DTMF or a
+ *  PAUSE for a longer duration, several calls are mandatory to get the whole duration sample.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -423,42 +563,34 @@ static le_result_t PlayTone
     uint32_t*                      bufferLenPtr  ///< [OUT] Length of the buffer
 )
 {
-    double   d1, d2;
-    uint32_t i;
-
     DtmfParams_t*  dtmfParamsPtr = (DtmfParams_t*) mediaCtxPtr->codecParams;
     // Max samples on the whole duration
     uint32_t samplesCount;
-    // Sample count until the next second
-    uint32_t sampleOneSecond = dtmfParamsPtr->sampleRate + dtmfParamsPtr->currentSampleCount;
-    uint32_t freq1;
-    uint32_t freq2;
-    int32_t  amp1;
-    int32_t  amp2;
+    // Max samples of one call
+    uint32_t periodLength = mediaCtxPtr->bufferSize / sizeof(int16_t);
     int16_t* dataPtr = (int16_t*) bufferOutPtr;
-    // Length of the current sample: max 1 second, i.e, sampleRate
+    // Length of the current sample: max one period
     uint32_t sampleLength;
 
-    if ( (dtmfParamsPtr->sampleRate * sizeof(int16_t)) > mediaCtxPtr->bufferSize )
+    if (0 == periodLength)
     {
-        LE_ERROR("%s buffer too small, sampleRate %d, bufferSize %d",
-                 dtmfParamsPtr->playPause ? "Pause" : "DTMF",
-                 dtmfParamsPtr->sampleRate, mediaCtxPtr->bufferSize);
+        LE_ERROR("%s buffer too small, bufferSize %d",
+                 dtmfParamsPtr->playPause ? "Pause" : "DTMF", mediaCtxPtr->bufferSize);
         return LE_FAULT;
     }
 
     if (dtmfParamsPtr->playPause)
     {
         samplesCount = dtmfParamsPtr->sampleRate*dtmfParamsPtr->pause / 1000;
-        // If the remaining duration is greater than sampleRate, produce only 1s sample, else
+        // If the remaining duration is greater than a period, produce only one period, else
         // produce the remaining duration
         sampleLength =
-            ((samplesCount - dtmfParamsPtr->currentSampleCount) > dtmfParamsPtr->sampleRate)
-                ? dtmfParamsPtr->sampleRate
+            ((samplesCount - dtmfParamsPtr->currentSampleCount) > periodLength)
+                ? periodLength
                 : (samplesCount - dtmfParamsPtr->currentSampleCount);
 
-        LE_DEBUG("Play PAUSE sampleOneSecond %u, currentSampleCount %u, sampleLength %u",
-                 sampleOneSecond, dtmfParamsPtr->currentSampleCount, sampleLength);
+        LE_DEBUG("Play PAUSE currentSampleCount %u, sampleLength %u",
+                 dtmfParamsPtr->currentSampleCount, sampleLength);
 
         memset( dataPtr, 0, sampleLength * sizeof(int16_t) );
 
@@ -470,6 +602,9 @@ static le_result_t PlayTone
     }
     else
     {
+        char     dtmf;
+        uint32_t i;
+
         if (dtmfParamsPtr->currentDtmf == strlen(dtmfParamsPtr->dtmf))
         {
             LE_DEBUG("All DTMF played");
@@ -477,41 +612,49 @@ static le_result_t PlayTone
             return LE_UNDERFLOW;
         }
 
+        dtmf = dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf];
         samplesCount = dtmfParamsPtr->sampleRate*dtmfParamsPtr->duration / 1000;
-        // If the remaining duration is greater than sampleRate, produce only 1s sample, else
+        // If the remaining duration is greater than a period, produce only one period, else
         // produce the remaining duration
         sampleLength =
-            ((samplesCount - dtmfParamsPtr->currentSampleCount) > dtmfParamsPtr->sampleRate)
-                ? dtmfParamsPtr->sampleRate
+            ((samplesCount - dtmfParamsPtr->currentSampleCount) > periodLength)
+                ? periodLength
                 : (samplesCount - dtmfParamsPtr->currentSampleCount);
-        LE_DEBUG("Play DtMF '%c' sampleOneSecond %u, currentSampleCount %u, sampleLength %u",
-                 dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf],
-                 sampleOneSecond, dtmfParamsPtr->currentSampleCount, sampleLength);
-
-        freq1 = Digit2LowFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
-        freq2 = Digit2HighFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
-        amp1 = DTMF_AMPLITUDE;
-        amp2 = DTMF_AMPLITUDE;
-
-        d1 = 1.0f * freq1 / dtmfParamsPtr->sampleRate;
-        d2 = 1.0f * freq2 / dtmfParamsPtr->sampleRate;
-
-        for (i = dtmfParamsPtr->currentSampleCount;
-             // Play max sampleRate (1s) of DTMF and continue at next call
-             (i < sampleOneSecond) && (i < samplesCount);
-             i++)
+        LE_DEBUG("Play DtMF '%c' currentSampleCount %u, sampleLength %u",
+                 dtmf, dtmfParamsPtr->currentSampleCount, sampleLength);
+
+        if (0 == dtmfParamsPtr->currentSampleCount)
+        {
+            // New DTMF: start both tones at phase 0
+            dtmfParamsPtr->phase[0] = 0;
+            dtmfParamsPtr->phase[1] = 0;
+            dtmfParamsPtr->phaseStep[0] = ToneStep(Digit2LowFreq(dtmf),
+                                                   dtmfParamsPtr->sampleRate);
+            dtmfParamsPtr->phaseStep[1] = ToneStep(Digit2HighFreq(dtmf),
+                                                   dtmfParamsPtr->sampleRate);
+        }
+
+        // Low tone directly in the output buffer, then the high tone mixed block by block
+        SynthesizeTone(dataPtr, sampleLength,
+                       &dtmfParamsPtr->phase[0], dtmfParamsPtr->phaseStep[0]);
+
+        for (i = 0; i < sampleLength; i += TONE_BLOCK_SAMPLES)
         {
-            int16_t s1, s2;
+            int16_t  block[TONE_BLOCK_SAMPLES];
+            uint32_t count = ((sampleLength - i) > TONE_BLOCK_SAMPLES)
+                                 ? TONE_BLOCK_SAMPLES
+                                 : (sampleLength - i);
 
-            s1 = (int16_t)(SAMPLE_SCALE * amp1 / 100.0f * sin(2 * PI * d1 * i));
-            s2 = (int16_t)(SAMPLE_SCALE * amp2 / 100.0f * sin(2 * PI * d2 * i));
-            *(dataPtr++) = SaturateAdd16(s1, s2);
+            SynthesizeTone(block, count, &dtmfParamsPtr->phase[1], dtmfParamsPtr->phaseStep[1]);
+            le_mixer_MixSamples16(dataPtr + i, block, count);
         }
 
         // Save the current sample count. If the whole DTMF is played, reset to 0
-        dtmfParamsPtr->currentSampleCount = (i == samplesCount ? 0 : i);
-        if (0 == dtmfParamsPtr->currentSampleCount)
+        dtmfParamsPtr->currentSampleCount += sampleLength;
+        if (dtmfParamsPtr->currentSampleCount >= samplesCount)
         {
+            dtmfParamsPtr->currentSampleCount = 0;
+
             // Update the index of DTMF if the current sample count is reset to 0
             dtmfParamsPtr->currentDtmf++;
         }
@@ -799,13 +942,187 @@ static le_result_t InitPlayDtmf
 {
     DtmfParams_t*  dtmfParamsPtr = (DtmfParams_t*) mediaCtxPtr->codecParams;
 
-    // Buffer size to sample of 1s x 16-bits
-    mediaCtxPtr->bufferSize = dtmfParamsPtr->sampleRate * sizeof(int16_t);
+    // Buffer size to sample of DTMF_PERIOD_MS x 16-bits
+    mediaCtxPtr->bufferSize = (dtmfParamsPtr->sampleRate * DTMF_PERIOD_MS / 1000) *
+                              sizeof(int16_t);
 
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account the time spent by a stage of a media thread on a frame.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateStageStats
+(
+    MediaStageStats_t*  statsPtr,   ///< [IN] Timing of the stage
+    le_clk_Time_t       startTime   ///< [IN] Relative time the frame processing started
+)
+{
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    uint32_t durationUs = duration.sec * 1000000 + duration.usec;
+
+    statsPtr->count++;
+    statsPtr->totalUs += durationUs;
+
+    if (durationUs > statsPtr->maxUs)
+    {
+        statsPtr->maxUs = durationUs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait on a semaphore of a media queue.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitMediaQueue
+(
+    sem_t* semPtr
+)
+{
+    while ((sem_wait(semPtr) == -1) && (EINTR == errno))
+    {
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the queue between the read and write stages of a media thread.
+ *
+ * @return The queue, or NULL if the frames are too large to be pooled.
+ */
+//--------------------------------------------------------------------------------------------------
+static MediaQueue_t* CreateMediaQueue
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr  ///< [IN] Media thread context
+)
+{
+    MediaQueue_t* queuePtr;
+    int i;
+
+    if (mediaCtxPtr->bufferSize > MEDIA_FRAME_MAX_BYTES)
+    {
+        LE_WARN("Frames of %d bytes are read and written in turn", mediaCtxPtr->bufferSize);
+        return NULL;
+    }
+
+    queuePtr = le_mem_ForceAlloc(MediaQueuePool);
+    memset(queuePtr, 0, sizeof(MediaQueue_t));
+
+    sem_init(&queuePtr->freeSem, 0, MEDIA_QUEUE_DEPTH);
+    sem_init(&queuePtr->filledSem, 0, 0);
+
+    for (i = 0; i < MEDIA_QUEUE_DEPTH; i++)
+    {
+        queuePtr->framePtr[i] = le_mem_ForceAlloc(MediaFramePool);
+    }
+
+    return queuePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the write stage of a media thread if it is still running, log the timing of the stages and
+ * delete their queue.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteMediaQueue
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr  ///< [IN] Media thread context
+)
+{
+    MediaQueue_t* queuePtr = mediaCtxPtr->queuePtr;
+    int i;
+
+    if (queuePtr->writeThreadRef)
+    {
+        le_thread_Cancel(queuePtr->writeThreadRef);
+        le_thread_Join(queuePtr->writeThreadRef, NULL);
+        queuePtr->writeThreadRef = NULL;
+    }
+
+    LE_INFO("Read stage: %u frames, %" PRIu64 " us, max %u us; write stage: %u frames, %" PRIu64
+            " us, max %u us; up to %u frames queued",
+            queuePtr->readStats.count, queuePtr->readStats.totalUs, queuePtr->readStats.maxUs,
+            queuePtr->writeStats.count, queuePtr->writeStats.totalUs, queuePtr->writeStats.maxUs,
+            queuePtr->maxFilled);
+
+    for (i = 0; i < MEDIA_QUEUE_DEPTH; i++)
+    {
+        le_mem_Release(queuePtr->framePtr[i]);
+    }
+
+    sem_destroy(&queuePtr->freeSem);
+    sem_destroy(&queuePtr->filledSem);
+
+    le_mem_Release(queuePtr);
+    mediaCtxPtr->queuePtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write stage of a media thread: write or encode the frames queued by the read stage, until the
+ * end of the stream.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* MediaWriteThread
+(
+    void* contextPtr
+)
+{
+    le_audio_MediaThreadContext_t * mediaCtxPtr = (le_audio_MediaThreadContext_t *) contextPtr;
+    MediaQueue_t* queuePtr = mediaCtxPtr->queuePtr;
+    bool semPost = false;
+
+    while (1)
+    {
+        uint32_t len;
+        uint8_t* framePtr;
+
+        WaitMediaQueue(&queuePtr->filledSem);
+
+        len = queuePtr->frameLen[queuePtr->tail];
+        framePtr = queuePtr->framePtr[queuePtr->tail];
+        queuePtr->tail = (queuePtr->tail + 1) % MEDIA_QUEUE_DEPTH;
+
+        if (0 == len)
+        {
+            break;
+        }
+
+        // After a failure, the frames are dropped until the read stage stops
+        if (!queuePtr->writeFailed)
+        {
+            le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+            if (mediaCtxPtr->writeFunc(mediaCtxPtr, framePtr, len) != LE_OK)
+            {
+                queuePtr->writeFailed = true;
+            }
+            else if (mediaCtxPtr->threadSemaphore && !semPost)
+            {
+                le_sem_Post(mediaCtxPtr->threadSemaphore);
+                semPost = true;
+            }
+
+            UpdateStageStats(&queuePtr->writeStats, startTime);
+        }
+
+        sem_post(&queuePtr->freeSem);
+    }
+
+    LE_DEBUG("MediaWriteThread end");
+
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Media threads destructor.
@@ -829,6 +1146,12 @@ static void DestroyMediaThread
 
     if (mediaCtxPtr)
     {
+        // The write stage may still use the codec
+        if (mediaCtxPtr->queuePtr)
+        {
+            DeleteMediaQueue(mediaCtxPtr);
+        }
+
         mediaCtxPtr->closeFunc(mediaCtxPtr);
 
         close(mediaCtxPtr->fd_pipe_input);
@@ -848,27 +1171,74 @@ static void DestroyMediaThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Media thread.
+ * Read stage of a media thread: read or decode the frames and queue them to the write stage, until
+ * the end of the stream.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void* MediaThread
+static void ReadMediaFrames
 (
-    void* contextPtr
+    le_audio_MediaThreadContext_t* mediaCtxPtr  ///< [IN] Media thread context
 )
 {
-    le_audio_MediaThreadContext_t * mediaCtxPtr = (le_audio_MediaThreadContext_t *) contextPtr;
-    uint8_t outBuffer[mediaCtxPtr->bufferSize];
-    uint32_t readLen = 0;
-    bool semPost = false;
-
-    LE_DEBUG("MediaThread");
+    MediaQueue_t* queuePtr = mediaCtxPtr->queuePtr;
+    uint32_t readLen;
+    int filled;
 
-    if (!mediaCtxPtr->readFunc || !mediaCtxPtr->closeFunc || !mediaCtxPtr->writeFunc)
+    do
     {
-        LE_ERROR("functions not set !!!");
-        return NULL;
+        uint8_t* framePtr;
+
+        WaitMediaQueue(&queuePtr->freeSem);
+
+        framePtr = queuePtr->framePtr[queuePtr->head];
+        readLen = 0;
+
+        // An empty frame ends the stream, once no more frames are read or the write stage failed
+        if (!queuePtr->writeFailed)
+        {
+            le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+            memset(framePtr, 0, mediaCtxPtr->bufferSize);
+
+            if (mediaCtxPtr->readFunc(mediaCtxPtr, framePtr, &readLen) != LE_OK)
+            {
+                readLen = 0;
+            }
+
+            UpdateStageStats(&queuePtr->readStats, startTime);
+        }
+
+        queuePtr->frameLen[queuePtr->head] = readLen;
+        queuePtr->head = (queuePtr->head + 1) % MEDIA_QUEUE_DEPTH;
+        sem_post(&queuePtr->filledSem);
+
+        if ((sem_getvalue(&queuePtr->filledSem, &filled) == 0) &&
+            ((uint32_t)filled > queuePtr->maxFilled))
+        {
+            queuePtr->maxFilled = filled;
+        }
     }
+    while (readLen);
+
+    le_thread_Join(queuePtr->writeThreadRef, NULL);
+    queuePtr->writeThreadRef = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read and write the frames of a media thread in turn, until the end of the stream.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadWriteMediaFrames
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr  ///< [IN] Media thread context
+)
+{
+    uint8_t outBuffer[mediaCtxPtr->bufferSize];
+    uint32_t readLen = 0;
+    bool semPost = false;
 
     while (1)
     {
@@ -899,6 +1269,38 @@ static void* MediaThread
             break;
         }
     }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Media thread.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* MediaThread
+(
+    void* contextPtr
+)
+{
+    le_audio_MediaThreadContext_t * mediaCtxPtr = (le_audio_MediaThreadContext_t *) contextPtr;
+
+    LE_DEBUG("MediaThread");
+
+    if (!mediaCtxPtr->readFunc || !mediaCtxPtr->closeFunc || !mediaCtxPtr->writeFunc)
+    {
+        LE_ERROR("functions not set !!!");
+        return NULL;
+    }
+
+    // A slow codec or file system delays the other stage by a whole queue of frames at most
+    if (mediaCtxPtr->queuePtr)
+    {
+        ReadMediaFrames(mediaCtxPtr);
+    }
+    else
+    {
+        ReadWriteMediaFrames(mediaCtxPtr);
+    }
 
     LE_DEBUG("MediaThread end");
 
@@ -946,6 +1348,8 @@ static le_result_t InitMediaThread
         return LE_FAULT;
     }
 
+    mediaCtxPtr->queuePtr = CreateMediaQueue(mediaCtxPtr);
+
     char name[STRING_LEN];
 
     snprintf(name, sizeof(name), "MediaThread-%p", streamPtr->streamRef);
@@ -972,6 +1376,24 @@ static le_result_t InitMediaThread
         le_thread_SetPriority(streamPtr->mediaThreadRef, LE_THREAD_PRIORITY_RT_3);
     }
 
+    if (mediaCtxPtr->queuePtr)
+    {
+        le_thread_Ref_t writeThreadRef;
+
+        snprintf(name, sizeof(name), "MediaWrite-%p", streamPtr->streamRef);
+
+        writeThreadRef = le_thread_Create(name, MediaWriteThread, mediaCtxPtr);
+
+        if ( LE_AUDIO_IF_DSP_FRONTEND_FILE_PLAY == streamPtr->audioInterface )
+        {
+            le_thread_SetPriority(writeThreadRef, LE_THREAD_PRIORITY_RT_3);
+        }
+
+        le_thread_SetJoinable(writeThreadRef);
+        mediaCtxPtr->queuePtr->writeThreadRef = writeThreadRef;
+        le_thread_Start(writeThreadRef);
+    }
+
     le_thread_SetJoinable(streamPtr->mediaThreadRef);
 
     le_thread_AddChildDestructor(streamPtr->mediaThreadRef,
@@ -1407,6 +1829,94 @@ static void PlayTreatEvent
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepare the streaming of the samples: reset the statistics and, if a period size is set for a
+ * client pipe, shrink the pipe to a few periods so that the samples don't wait in it.
+ *
+ * The bounded pipe stands in for a shared-memory ring with the client: le_audio_PlaySamples() and
+ * le_audio_GetSamples() only pass a file descriptor over IPC, so a ring mapped by both sides would
+ * need its own client-side API to fill and drain it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitSamplesStreaming
+(
+    le_audio_Stream_t*      streamPtr,
+    le_audio_PcmContext_t*  pcmContextPtr
+)
+{
+    le_audio_SamplePcmConfig_t* configPtr = &pcmContextPtr->pcmConfig;
+    int periodBytes;
+    int mask;
+
+    memset(&streamPtr->samplesStats, 0, sizeof(le_audio_SamplesStats_t));
+
+    // Files and DTMFs are streamed by the media thread through an internal pipe
+    if (streamPtr->mediaThreadContextPtr)
+    {
+        configPtr->periodSize = 0;
+    }
+
+    if (0 == configPtr->periodSize)
+    {
+        return;
+    }
+
+    periodBytes = configPtr->periodSize * configPtr->channelsCount * configPtr->bitsPerSample / 8;
+
+    // The kernel rounds the pipe size up to a page
+    if (fcntl(pcmContextPtr->fd, F_SETPIPE_SZ, LOW_LATENCY_PIPE_PERIODS * periodBytes) == -1)
+    {
+        LE_WARN("Cannot resize the pipe, errno.%d (%s)", errno, strerror(errno));
+    }
+
+    // Captured periods are dropped rather than delaying the next ones
+    if (LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE == pcmContextPtr->interface)
+    {
+        if (((mask = fcntl(pcmContextPtr->fd, F_GETFL, 0)) == -1) ||
+            (fcntl(pcmContextPtr->fd, F_SETFL, mask | O_NONBLOCK) == -1))
+        {
+            LE_ERROR("fcntl error, errno.%d (%s)", errno, strerror(errno));
+            return;
+        }
+    }
+
+    pcmContextPtr->lowLatency = true;
+
+    LE_DEBUG("Low-latency streaming with periods of %d bytes", periodBytes);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the latency of a period: the time the samples still in the pipe need to be played (or
+ * read), plus the period duration.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSamplesLatency
+(
+    le_audio_Stream_t*      streamPtr,
+    le_audio_PcmContext_t*  pcmContextPtr,
+    uint32_t                periodBytes
+)
+{
+    int queuedBytes = 0;
+
+    if (0 == pcmContextPtr->pcmConfig.byteRate)
+    {
+        return;
+    }
+
+    if (ioctl(pcmContextPtr->fd, FIONREAD, &queuedBytes) == -1)
+    {
+        queuedBytes = 0;
+    }
+
+    streamPtr->samplesStats.latency = ((uint64_t)(queuedBytes + periodBytes) * 1000) /
+                                      pcmContextPtr->pcmConfig.byteRate;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get Playback frames
@@ -1460,6 +1970,11 @@ static le_result_t GetPlaybackFrames
                     // send silence frames to avoid xrun
                     memset(bufferPtr, 0, size);
                     size = 0;
+                    streamPtr->samplesStats.underrunCount++;
+                }
+                else
+                {
+                    UpdateSamplesLatency(streamPtr, pcmContextPtr, amount);
                 }
                 *bufsizePtr = amount;
                 return LE_OK;
@@ -1512,6 +2027,8 @@ static le_result_t GetPlaybackFrames
         }
     }
 
+    UpdateSamplesLatency(streamPtr, pcmContextPtr, amount);
+
     return LE_OK;
 }
 
@@ -1533,11 +2050,35 @@ static le_result_t SetCaptureFrames
 
     if ( !pcmContextPtr->pause )
     {
-        if (WriteFd(pcmContextPtr->fd, bufferPtr, *bufsizePtr) < 0)
+        if (pcmContextPtr->lowLatency)
+        {
+            ssize_t len;
+
+            do
+            {
+                len = write(pcmContextPtr->fd, bufferPtr, *bufsizePtr);
+            }
+            while ((len < 0) && (EINTR == errno));
+
+            if ((len < 0) && (EAGAIN != errno) && (EWOULDBLOCK != errno))
+            {
+                LE_ERROR("Cannot write on pipe");
+                return LE_FAULT;
+            }
+
+            // The client is late: the rest of the period is dropped
+            if (len < (ssize_t)*bufsizePtr)
+            {
+                streamPtr->samplesStats.overrunCount++;
+            }
+        }
+        else if (WriteFd(pcmContextPtr->fd, bufferPtr, *bufsizePtr) < 0)
         {
             LE_ERROR("Cannot write on pipe");
             return LE_FAULT;
         }
+
+        UpdateSamplesLatency(streamPtr, pcmContextPtr, *bufsizePtr);
     }
 
     return LE_OK;
@@ -1896,40 +2437,23 @@ le_result_t le_media_PlaySamples
 
     streamPtr->pcmContextPtr = pcmContextPtr;
 
+    InitSamplesStreaming(streamPtr, pcmContextPtr);
+
     LE_DEBUG("nbChannel.%d, rate.%d, bitsPerSample.%d, byteRate.%d",
              pcmContextPtr->pcmConfig.channelsCount, pcmContextPtr->pcmConfig.sampleRate,
              pcmContextPtr->pcmConfig.bitsPerSample, pcmContextPtr->pcmConfig.byteRate);
 
-    pcm_Handle_t pcmHandle = NULL;
-
     LE_DEBUG("streamPtr->deviceIdentifier %d",streamPtr->deviceIdentifier);
 
-    char deviceString[STRING_LEN];
-    snprintf(deviceString,sizeof(deviceString),"hw:0,%d", streamPtr->hwDeviceId);
-    LE_DEBUG("Hardware interface: %s", deviceString);
-
     // Request a wakeup source for media streams
     le_pm_StayAwake(MediaWakeLock);
 
-    if ((pa_pcm_InitPlayback(&pcmHandle, deviceString, &(pcmContextPtr->pcmConfig)) != LE_OK)
-                            || (pcmHandle == NULL))
-    {
-        LE_ERROR("PCM cannot be open");
-        le_media_Stop(streamPtr);
-        return LE_FAULT;
-    }
-
-    pcmContextPtr->pcmHandle = pcmHandle;
     pcmContextPtr->framesFuncTimeout = 0;
 
-    pa_pcm_SetCallbackHandlers( pcmHandle,
-                                GetPlaybackFrames,
-                                PlayCaptResult,
-                                streamPtr );
-
-    if (pa_pcm_Play(pcmHandle) != LE_OK)
+    // The samples are mixed with the ones of the other streams played on the same device
+    if (le_mixer_AddSource(streamPtr, GetPlaybackFrames, PlayCaptResult) != LE_OK)
     {
-        LE_ERROR("Error in pa_pcm_Write");
+        LE_ERROR("PCM cannot be played");
         le_media_Stop(streamPtr);
         return LE_FAULT;
     }
@@ -2112,8 +2636,15 @@ le_result_t le_media_Stop
         {
             if (streamPtr->pcmContextPtr)
             {
-                LE_DEBUG("Close pa_pcm");
-                pa_pcm_Close(streamPtr->pcmContextPtr->pcmHandle);
+                if (LE_AUDIO_IF_DSP_FRONTEND_FILE_PLAY == streamPtr->audioInterface)
+                {
+                    le_mixer_RemoveSource(streamPtr);
+                }
+                else
+                {
+                    LE_DEBUG("Close pa_pcm");
+                    pa_pcm_Close(streamPtr->pcmContextPtr->pcmHandle);
+                }
                 le_mem_Release(streamPtr->pcmContextPtr);
                 streamPtr->pcmContextPtr = NULL;
             }
@@ -2189,6 +2720,8 @@ le_result_t le_media_Capture
     pcmContextPtr->pause = false;
     streamPtr->pcmContextPtr = pcmContextPtr;
 
+    InitSamplesStreaming(streamPtr, pcmContextPtr);
+
     char deviceString[STRING_LEN];
     snprintf(deviceString,sizeof(deviceString),"hw:0,%d", streamPtr->hwDeviceId);
     LE_DEBUG("Hardware interface: %s", deviceString);
@@ -2276,6 +2809,15 @@ void le_media_Init
     PcmThreadContextPool = le_mem_CreatePool("PcmThreadContextPool",
                                                                sizeof(le_audio_PcmContext_t));
 
+    // Allocate the pools of the queues between the stages of the media threads.
+    MediaQueuePool = le_mem_CreatePool("MediaQueuePool", sizeof(MediaQueue_t));
+    MediaFramePool = le_mem_CreatePool("MediaFramePool", MEDIA_FRAME_MAX_BYTES);
+
     // Create a Wakeup source for Media
     MediaWakeLock = le_pm_NewWakeupSource( LE_PM_REF_COUNT, "MediaStream" );
+
+    // Compute the DTMF tone once for all
+    InitToneTable();
+
+    le_mixer_Init();
 }
@@ -0,0 +1,824 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_mixer.c
+ *
+ * This file contains the source code of the mixer of the player streams played on a same hardware
+ * device.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_audio_local.h"
+#include "pa_pcm.h"
+#include "le_mixer_local.h"
+#include <math.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Legato object string length.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STRING_LEN          30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of frames of the PCM playback mixed at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_FRAMES        256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of channels of a converted stream.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CHANNELS        2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest ratio between the sample rate of a converted stream and the one of the PCM playback.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RATE_RATIO      6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of frames of a stream needed to mix a chunk.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STAGE_FRAMES        (CHUNK_FRAMES * MAX_RATE_RATIO + 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Step of the sample rate conversion, in 16.16 fixed point, when the rates are the same.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RATE_STEP_ONE       (1 << 16)
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream played by a mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;                       ///< Link in the source list of the mixer
+    le_audio_Stream_t*  streamPtr;                  ///< Stream object
+    GetSetFramesFunc_t  framesFunc;                 ///< Function getting the samples
+    ResultFunc_t        resultFunc;                 ///< Function called when the stream ends
+    bool                ended;                      ///< No more samples are mixed
+    bool                passThrough;                ///< Same configuration as the PCM playback
+    uint16_t            channelsCount;              ///< Number of channels of the stream
+    uint32_t            step;                       ///< Frames of the stream per frame of the PCM
+                                                    ///  playback, in 16.16 fixed point
+    uint32_t            pos;                        ///< Position of the next frame to mix in
+                                                    ///  stageBuf, in 16.16 fixed point
+    uint32_t            stageFrames;                ///< Number of frames in stageBuf
+    uint32_t            pendingBytes;               ///< Number of bytes in pending
+    uint8_t             pending[MAX_CHANNELS * sizeof(int16_t)]; ///< Start of an incomplete frame
+    int16_t             stageBuf[STAGE_FRAMES * MAX_CHANNELS];   ///< Frames of the stream, with
+                                                                 ///  the channels of the PCM
+                                                                 ///  playback
+}
+Source_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixer of a hardware device.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t               link;               ///< Link in the mixer list
+    int8_t                      hwDeviceId;         ///< Hardware Device identifier
+    pcm_Handle_t                pcmHandle;          ///< PCM playback handle
+    le_audio_SamplePcmConfig_t  pcmConfig;          ///< PCM playback configuration
+    bool                        closed;             ///< The PCM playback has ended
+    le_mutex_Ref_t              mutex;              ///< Protects the source list
+    le_dls_List_t               sourceList;         ///< Streams played on the device
+    int16_t                     rawBuf[STAGE_FRAMES * MAX_CHANNELS];    ///< Samples of a stream
+                                                                        ///  as read
+    int16_t                     chunkBuf[CHUNK_FRAMES * MAX_CHANNELS];  ///< Converted chunk of
+                                                                        ///  a stream
+}
+Mixer_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the mixers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MixerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the streams played by the mixers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SourcePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixers of the hardware devices being played. Only used from the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t MixerList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add two 16-bit values.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int16_t SaturateAdd16
+(
+    int32_t a,
+    int32_t b
+)
+{
+    int32_t tot=a+b;
+
+    if (tot > 32767)
+    {
+        return 32767;
+    }
+    else if (tot < -32768)
+    {
+        return -32768;
+    }
+    else
+    {
+        return (tot & 0xFFFF);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Convert frames between mono and stereo. A stereo frame is converted to the mean of its two
+ *  channels.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConvertChannels16
+(
+    int16_t*       dataPtr,
+    uint16_t       channelsCount,
+    const int16_t* srcPtr,
+    uint16_t       srcChannelsCount,
+    uint32_t       frames
+)
+{
+    uint32_t i = 0;
+
+    if (channelsCount == srcChannelsCount)
+    {
+        memcpy(dataPtr, srcPtr, frames * channelsCount * sizeof(int16_t));
+    }
+    else if (1 == srcChannelsCount)
+    {
+#if defined(__ARM_NEON)
+        for (; (i + 8) <= frames; i += 8)
+        {
+            int16x8x2_t stereo;
+
+            stereo.val[0] = vld1q_s16(srcPtr + i);
+            stereo.val[1] = stereo.val[0];
+            vst2q_s16(dataPtr + 2 * i, stereo);
+        }
+#endif
+
+        for (; i < frames; i++)
+        {
+            dataPtr[2 * i] = srcPtr[i];
+            dataPtr[2 * i + 1] = srcPtr[i];
+        }
+    }
+    else
+    {
+#if defined(__ARM_NEON)
+        for (; (i + 8) <= frames; i += 8)
+        {
+            int16x8x2_t stereo = vld2q_s16(srcPtr + 2 * i);
+
+            vst1q_s16(dataPtr + i, vhaddq_s16(stereo.val[0], stereo.val[1]));
+        }
+#endif
+
+        for (; i < frames; i++)
+        {
+            dataPtr[i] = (srcPtr[2 * i] + srcPtr[2 * i + 1]) >> 1;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Convert the sample rate of frames by linear interpolation. The position of the first frame and
+ *  the step between frames are in 16.16 fixed point.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Resample16
+(
+    int16_t*       dataPtr,
+    uint16_t       channelsCount,
+    const int16_t* srcPtr,
+    uint32_t       pos,
+    uint32_t       step,
+    uint32_t       frames
+)
+{
+    uint32_t i;
+    uint16_t c;
+
+    for (i = 0; i < frames; i++)
+    {
+        const int16_t* framePtr = srcPtr + (pos >> 16) * channelsCount;
+        // 15-bit fraction, so that the product can't overflow
+        int32_t frac = (pos & 0xFFFF) >> 1;
+
+        for (c = 0; c < channelsCount; c++)
+        {
+            int32_t a = framePtr[c];
+            int32_t b = framePtr[c + channelsCount];
+
+            *dataPtr++ = a + (((b - a) * frac) >> 15);
+        }
+
+        pos += step;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply a gain to 16-bit samples. The gain is in Q15 fixed point.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyGain16
+(
+    int16_t*  dataPtr,
+    uint32_t  count,
+    int16_t   gain
+)
+{
+    uint32_t i = 0;
+
+#if defined(__ARM_NEON)
+    for (; (i + 8) <= count; i += 8)
+    {
+        vst1q_s16(dataPtr + i, vqrdmulhq_n_s16(vld1q_s16(dataPtr + i), gain));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        dataPtr[i] = (int16_t)((dataPtr[i] * gain + (1 << 14)) >> 15);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for the mixer of a hardware device.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static Mixer_t* GetMixer
+(
+    int8_t hwDeviceId
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&MixerList);
+
+    while (linkPtr)
+    {
+        Mixer_t* mixerPtr = CONTAINER_OF(linkPtr, Mixer_t, link);
+
+        if (mixerPtr->hwDeviceId == hwDeviceId)
+        {
+            return mixerPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&MixerList, linkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for the source of a stream, and the mixer it is played by.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static Source_t* GetSource
+(
+    le_audio_Stream_t*  streamPtr,
+    Mixer_t**           mixerPtrPtr
+)
+{
+    le_dls_Link_t* mixerLinkPtr = le_dls_Peek(&MixerList);
+
+    while (mixerLinkPtr)
+    {
+        Mixer_t* mixerPtr = CONTAINER_OF(mixerLinkPtr, Mixer_t, link);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&mixerPtr->sourceList);
+
+        while (linkPtr)
+        {
+            Source_t* sourcePtr = CONTAINER_OF(linkPtr, Source_t, link);
+
+            if (sourcePtr->streamPtr == streamPtr)
+            {
+                *mixerPtrPtr = mixerPtr;
+                return sourcePtr;
+            }
+
+            linkPtr = le_dls_PeekNext(&mixerPtr->sourceList, linkPtr);
+        }
+
+        mixerLinkPtr = le_dls_PeekNext(&MixerList, mixerLinkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up the conversion of a stream to the configuration of the PCM playback.
+ *
+ * @return LE_OK            The stream can be mixed.
+ * @return LE_FORMAT_ERROR  The stream can't be converted.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t InitSource
+(
+    Mixer_t*                    mixerPtr,
+    Source_t*                   sourcePtr,
+    le_audio_SamplePcmConfig_t* configPtr
+)
+{
+    le_audio_SamplePcmConfig_t* pcmConfigPtr = &mixerPtr->pcmConfig;
+
+    sourcePtr->channelsCount = configPtr->channelsCount;
+    sourcePtr->passThrough = (configPtr->sampleRate == pcmConfigPtr->sampleRate) &&
+                             (configPtr->channelsCount == pcmConfigPtr->channelsCount) &&
+                             (configPtr->bitsPerSample == pcmConfigPtr->bitsPerSample);
+
+    // The first stream is always passed through, the next ones are mixed as 16-bit samples
+    if (le_dls_IsEmpty(&mixerPtr->sourceList))
+    {
+        sourcePtr->step = RATE_STEP_ONE;
+        return LE_OK;
+    }
+
+    if ((16 != configPtr->bitsPerSample) || (16 != pcmConfigPtr->bitsPerSample) ||
+        (0 == configPtr->channelsCount) || (configPtr->channelsCount > MAX_CHANNELS) ||
+        (0 == pcmConfigPtr->channelsCount) || (pcmConfigPtr->channelsCount > MAX_CHANNELS) ||
+        (0 == configPtr->sampleRate) ||
+        (configPtr->sampleRate > MAX_RATE_RATIO * pcmConfigPtr->sampleRate))
+    {
+        LE_ERROR("Cannot mix %d Hz %d channel(s) %d-bit samples into %d Hz %d channel(s) %d-bit",
+                 configPtr->sampleRate, configPtr->channelsCount, configPtr->bitsPerSample,
+                 pcmConfigPtr->sampleRate, pcmConfigPtr->channelsCount,
+                 pcmConfigPtr->bitsPerSample);
+        return LE_FORMAT_ERROR;
+    }
+
+    sourcePtr->step = ((uint64_t)configPtr->sampleRate << 16) / pcmConfigPtr->sampleRate;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read frames of a stream, converted to the channels of the PCM playback. The missing frames are
+ * replaced by silence.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadSource
+(
+    Mixer_t*    mixerPtr,
+    Source_t*   sourcePtr,
+    int16_t*    dataPtr,
+    uint32_t    frames
+)
+{
+    uint16_t channelsCount = mixerPtr->pcmConfig.channelsCount;
+    uint32_t frameBytes = sourcePtr->channelsCount * sizeof(int16_t);
+    uint8_t* rawPtr = (uint8_t*)mixerPtr->rawBuf;
+    uint32_t len = frames * frameBytes - sourcePtr->pendingBytes;
+    uint32_t count;
+    le_result_t res;
+
+    memcpy(rawPtr, sourcePtr->pending, sourcePtr->pendingBytes);
+
+    // A late stream must not make the other ones late too
+    sourcePtr->streamPtr->pcmContextPtr->framesFuncTimeout = 0;
+
+    res = sourcePtr->framesFunc(rawPtr + sourcePtr->pendingBytes, &len, sourcePtr->streamPtr);
+    if (LE_OK != res)
+    {
+        return res;
+    }
+
+    len += sourcePtr->pendingBytes;
+    count = len / frameBytes;
+    sourcePtr->pendingBytes = len % frameBytes;
+    memcpy(sourcePtr->pending, rawPtr + count * frameBytes, sourcePtr->pendingBytes);
+
+    ConvertChannels16(dataPtr, channelsCount, mixerPtr->rawBuf, sourcePtr->channelsCount, count);
+    memset(dataPtr + count * channelsCount, 0,
+           (frames - count) * channelsCount * sizeof(int16_t));
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a chunk of a stream, converted to the configuration of the PCM playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PullSource
+(
+    Mixer_t*    mixerPtr,
+    Source_t*   sourcePtr,
+    uint32_t    frames
+)
+{
+    uint16_t channelsCount = mixerPtr->pcmConfig.channelsCount;
+    uint32_t lastPos;
+    uint32_t nextPos;
+    uint32_t needed;
+    le_result_t res;
+
+    if (RATE_STEP_ONE == sourcePtr->step)
+    {
+        return ReadSource(mixerPtr, sourcePtr, mixerPtr->chunkBuf, frames);
+    }
+
+    // Frames of the stream interpolated for the last frame of the chunk, and for the first frame
+    // of the next chunk
+    lastPos = sourcePtr->pos + (frames - 1) * sourcePtr->step;
+    nextPos = sourcePtr->pos + frames * sourcePtr->step;
+    needed = (lastPos >> 16) + 2;
+    if (needed < (nextPos >> 16) + 1)
+    {
+        needed = (nextPos >> 16) + 1;
+    }
+
+    if (needed > sourcePtr->stageFrames)
+    {
+        res = ReadSource(mixerPtr, sourcePtr,
+                         sourcePtr->stageBuf + sourcePtr->stageFrames * channelsCount,
+                         needed - sourcePtr->stageFrames);
+        if (LE_OK != res)
+        {
+            return res;
+        }
+
+        sourcePtr->stageFrames = needed;
+    }
+
+    Resample16(mixerPtr->chunkBuf, channelsCount, sourcePtr->stageBuf, sourcePtr->pos,
+               sourcePtr->step, frames);
+
+    sourcePtr->stageFrames -= nextPos >> 16;
+    memmove(sourcePtr->stageBuf, sourcePtr->stageBuf + (nextPos >> 16) * channelsCount,
+            sourcePtr->stageFrames * channelsCount * sizeof(int16_t));
+    sourcePtr->pos = nextPos & 0xFFFF;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frames of the PCM playback: pass the samples of a stream playing alone through, or mix
+ * all the streams.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MixFrames
+(
+    uint8_t* bufferPtr,
+    uint32_t* bufsizePtr,
+    void* contextPtr
+)
+{
+    Mixer_t* mixerPtr = contextPtr;
+    uint16_t channelsCount = mixerPtr->pcmConfig.channelsCount;
+    int16_t* dataPtr = (int16_t*)bufferPtr;
+    Source_t* soloPtr = NULL;
+    uint32_t sourceCount = 0;
+    int16_t gain = INT16_MAX;
+    le_dls_Link_t* linkPtr;
+    uint32_t frames;
+    uint32_t done;
+    uint32_t count;
+    le_result_t res;
+
+    le_mutex_Lock(mixerPtr->mutex);
+
+    for (linkPtr = le_dls_Peek(&mixerPtr->sourceList);
+         linkPtr;
+         linkPtr = le_dls_PeekNext(&mixerPtr->sourceList, linkPtr))
+    {
+        Source_t* sourcePtr = CONTAINER_OF(linkPtr, Source_t, link);
+
+        if (!sourcePtr->ended)
+        {
+            soloPtr = sourcePtr;
+            sourceCount++;
+        }
+    }
+
+    // A stream playing alone in the configuration of the PCM playback drives it directly
+    if ((1 == sourceCount) && (soloPtr->passThrough))
+    {
+        res = soloPtr->framesFunc(bufferPtr, bufsizePtr, soloPtr->streamPtr);
+        le_mutex_Unlock(mixerPtr->mutex);
+        return res;
+    }
+
+    memset(bufferPtr, 0, *bufsizePtr);
+    frames = *bufsizePtr / (channelsCount * sizeof(int16_t));
+
+    if (sourceCount > 1)
+    {
+        gain = (int16_t)(INT16_MAX / sqrtf(sourceCount));
+    }
+
+    for (done = 0; done < frames; done += count)
+    {
+        count = ((frames - done) < CHUNK_FRAMES) ? (frames - done) : CHUNK_FRAMES;
+
+        for (linkPtr = le_dls_Peek(&mixerPtr->sourceList);
+             linkPtr;
+             linkPtr = le_dls_PeekNext(&mixerPtr->sourceList, linkPtr))
+        {
+            Source_t* sourcePtr = CONTAINER_OF(linkPtr, Source_t, link);
+
+            if (sourcePtr->ended)
+            {
+                continue;
+            }
+
+            res = PullSource(mixerPtr, sourcePtr, count);
+            if (LE_OK != res)
+            {
+                LE_DEBUG("Stream %p ended, res %d", sourcePtr->streamPtr, res);
+                sourcePtr->ended = true;
+                sourcePtr->resultFunc((LE_CLOSED == res) ? LE_OK : res, sourcePtr->streamPtr);
+                continue;
+            }
+
+            if (sourceCount > 1)
+            {
+                ApplyGain16(mixerPtr->chunkBuf, count * channelsCount, gain);
+            }
+
+            le_mixer_MixSamples16(dataPtr + done * channelsCount, mixerPtr->chunkBuf,
+                                  count * channelsCount);
+        }
+    }
+
+    le_mutex_Unlock(mixerPtr->mutex);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of the PCM playback: report it to the streams still played.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MixResult
+(
+    le_result_t res,
+    void* contextPtr
+)
+{
+    Mixer_t* mixerPtr = contextPtr;
+    le_dls_Link_t* linkPtr;
+
+    le_mutex_Lock(mixerPtr->mutex);
+
+    mixerPtr->closed = true;
+
+    for (linkPtr = le_dls_Peek(&mixerPtr->sourceList);
+         linkPtr;
+         linkPtr = le_dls_PeekNext(&mixerPtr->sourceList, linkPtr))
+    {
+        Source_t* sourcePtr = CONTAINER_OF(linkPtr, Source_t, link);
+
+        if (!sourcePtr->ended)
+        {
+            sourcePtr->ended = true;
+            sourcePtr->resultFunc(res, sourcePtr->streamPtr);
+        }
+    }
+
+    le_mutex_Unlock(mixerPtr->mutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Mix 16-bit samples into a buffer, with saturation.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_MixSamples16
+(
+    int16_t*       dataPtr,     ///< [IN/OUT] Samples mixed into
+    const int16_t* srcPtr,      ///< [IN] Samples to mix
+    uint32_t       count        ///< [IN] Number of samples
+)
+{
+    uint32_t i = 0;
+
+#if defined(__ARM_NEON)
+    for (; (i + 8) <= count; i += 8)
+    {
+        vst1q_s16(dataPtr + i, vqaddq_s16(vld1q_s16(dataPtr + i), vld1q_s16(srcPtr + i)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        dataPtr[i] = SaturateAdd16(dataPtr[i], srcPtr[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a player stream to the mixer of its hardware device, opening and starting the PCM playback
+ * if it is the first one.  The PCM context of the stream must be set, and its handle is set to
+ * the one of the PCM playback.
+ *
+ * The frames function of the stream is called by the mixer to get the samples of the stream, and
+ * the result function when the stream ends.
+ *
+ * @return LE_OK            The stream is played.
+ * @return LE_FORMAT_ERROR  The configuration of the stream can't be converted to the one of the
+ *                          PCM playback already running on the device.
+ * @return LE_BUSY          The PCM playback of the device is ending.
+ * @return LE_FAULT         The PCM playback can't be started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_AddSource
+(
+    le_audio_Stream_t*  streamPtr,      ///< [IN] Stream object
+    GetSetFramesFunc_t  framesFunc,     ///< [IN] Function getting the samples of the stream
+    ResultFunc_t        resultFunc      ///< [IN] Function called when the stream ends
+)
+{
+    le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
+    Mixer_t* mixerPtr = GetMixer(streamPtr->hwDeviceId);
+    bool newMixer = false;
+    Source_t* sourcePtr;
+
+    if (NULL == mixerPtr)
+    {
+        pcm_Handle_t pcmHandle = NULL;
+        char deviceString[STRING_LEN];
+
+        snprintf(deviceString, sizeof(deviceString), "hw:0,%d", streamPtr->hwDeviceId);
+        LE_DEBUG("Hardware interface: %s", deviceString);
+
+        if ((pa_pcm_InitPlayback(&pcmHandle, deviceString, &pcmContextPtr->pcmConfig) != LE_OK)
+            || (pcmHandle == NULL))
+        {
+            LE_ERROR("PCM cannot be open");
+            return LE_FAULT;
+        }
+
+        mixerPtr = le_mem_ForceAlloc(MixerPool);
+        memset(mixerPtr, 0, sizeof(Mixer_t));
+        mixerPtr->link = LE_DLS_LINK_INIT;
+        mixerPtr->hwDeviceId = streamPtr->hwDeviceId;
+        mixerPtr->pcmHandle = pcmHandle;
+        mixerPtr->mutex = le_mutex_CreateNonRecursive("MixerMutex");
+        mixerPtr->sourceList = LE_DLS_LIST_INIT;
+        memcpy(&mixerPtr->pcmConfig, &pcmContextPtr->pcmConfig,
+               sizeof(le_audio_SamplePcmConfig_t));
+        le_dls_Queue(&MixerList, &mixerPtr->link);
+        newMixer = true;
+    }
+    else if (mixerPtr->closed)
+    {
+        LE_ERROR("PCM playback of hw:0,%d is ending", streamPtr->hwDeviceId);
+        return LE_BUSY;
+    }
+
+    sourcePtr = le_mem_ForceAlloc(SourcePool);
+    memset(sourcePtr, 0, sizeof(Source_t));
+    sourcePtr->link = LE_DLS_LINK_INIT;
+    sourcePtr->streamPtr = streamPtr;
+    sourcePtr->framesFunc = framesFunc;
+    sourcePtr->resultFunc = resultFunc;
+
+    if (InitSource(mixerPtr, sourcePtr, &pcmContextPtr->pcmConfig) != LE_OK)
+    {
+        le_mem_Release(sourcePtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    pcmContextPtr->pcmHandle = mixerPtr->pcmHandle;
+
+    le_mutex_Lock(mixerPtr->mutex);
+    le_dls_Queue(&mixerPtr->sourceList, &sourcePtr->link);
+    le_mutex_Unlock(mixerPtr->mutex);
+
+    LE_DEBUG("Stream %p mixed into hw:0,%d, passThrough %d step 0x%x", streamPtr,
+             mixerPtr->hwDeviceId, sourcePtr->passThrough, sourcePtr->step);
+
+    if (newMixer)
+    {
+        pa_pcm_SetCallbackHandlers(mixerPtr->pcmHandle, MixFrames, MixResult, mixerPtr);
+
+        if (pa_pcm_Play(mixerPtr->pcmHandle) != LE_OK)
+        {
+            LE_ERROR("Error in pa_pcm_Play");
+            le_mixer_RemoveSource(streamPtr);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a player stream from its mixer, closing the PCM playback if it was the last one.  Nothing
+ * is done if the stream isn't played.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_RemoveSource
+(
+    le_audio_Stream_t*  streamPtr       ///< [IN] Stream object
+)
+{
+    Mixer_t* mixerPtr = NULL;
+    Source_t* sourcePtr = GetSource(streamPtr, &mixerPtr);
+    bool lastSource;
+
+    if (NULL == sourcePtr)
+    {
+        return;
+    }
+
+    le_mutex_Lock(mixerPtr->mutex);
+    le_dls_Remove(&mixerPtr->sourceList, &sourcePtr->link);
+    lastSource = le_dls_IsEmpty(&mixerPtr->sourceList);
+    le_mutex_Unlock(mixerPtr->mutex);
+
+    le_mem_Release(sourcePtr);
+
+    if (lastSource)
+    {
+        LE_DEBUG("Close pa_pcm of hw:0,%d", mixerPtr->hwDeviceId);
+        pa_pcm_Close(mixerPtr->pcmHandle);
+        le_dls_Remove(&MixerList, &mixerPtr->link);
+        le_mutex_Delete(mixerPtr->mutex);
+        le_mem_Release(mixerPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Init
+(
+    void
+)
+{
+    MixerPool = le_mem_CreatePool("MixerPool", sizeof(Mixer_t));
+    SourcePool = le_mem_CreatePool("MixerSourcePool", sizeof(Source_t));
+}
@@ -0,0 +1,77 @@
+/** @file le_mixer_local.h
+ *
+ * The mixer owns the PCM playback of a hardware device, and mixes into it the samples of all the
+ * player streams played on that device.
+ *
+ * The first stream played on a device opens the PCM with its own configuration.  Its samples are
+ * passed through to the driver untouched as long as it plays alone.  The streams played next on
+ * the same device are converted, period by period, to the configuration of the PCM: their sample
+ * rate is converted by linear interpolation, mono and stereo are converted to each other, and
+ * each stream is attenuated by the square root of the number of streams before being added with
+ * saturation.  Only 16-bit streams of one or two channels can be converted.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
+#define LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Mix 16-bit samples into a buffer, with saturation.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_MixSamples16
+(
+    int16_t*       dataPtr,     ///< [IN/OUT] Samples mixed into
+    const int16_t* srcPtr,      ///< [IN] Samples to mix
+    uint32_t       count        ///< [IN] Number of samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a player stream to the mixer of its hardware device, opening and starting the PCM playback
+ * if it is the first one.  The PCM context of the stream must be set, and its handle is set to
+ * the one of the PCM playback.
+ *
+ * The frames function of the stream is called by the mixer to get the samples of the stream, and
+ * the result function when the stream ends.
+ *
+ * @return LE_OK            The stream is played.
+ * @return LE_FORMAT_ERROR  The configuration of the stream can't be converted to the one of the
+ *                          PCM playback already running on the device.
+ * @return LE_BUSY          The PCM playback of the device is ending.
+ * @return LE_FAULT         The PCM playback can't be started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mixer_AddSource
+(
+    le_audio_Stream_t*  streamPtr,      ///< [IN] Stream object
+    GetSetFramesFunc_t  framesFunc,     ///< [IN] Function getting the samples of the stream
+    ResultFunc_t        resultFunc      ///< [IN] Function called when the stream ends
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a player stream from its mixer, closing the PCM playback if it was the last one.  Nothing
+ * is done if the stream isn't played.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_RemoveSource
+(
+    le_audio_Stream_t*  streamPtr       ///< [IN] Stream object
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the mixer.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mixer_Init
+(
+    void
+);
+
+
+#endif // LEGATO_LEMIXERLOCAL_INCLUDE_GUARD
@@ -110,6 +110,7 @@ LE_SHARED uint32_t pa_pcm_GetPeriodSize
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize sound driver for PCM capture.
+ * A non-zero periodSize of the configuration is the period size (in frames) to use.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -124,6 +125,7 @@ LE_SHARED le_result_t pa_pcm_InitCapture
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize sound driver for PCM playback.
+ * A non-zero periodSize of the configuration is the period size (in frames) to use.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,569 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgCache.c
+ *
+ * Read-through cache of config tree values.  Cached values are kept in a hash map keyed by their
+ * path, and each one is also listed under the watched path it was found under, so that when the
+ * config tree reports a change under a watched path only that watch's values need to be checked.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "cfgCache.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A path that's being watched for changes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[LE_CFG_STR_LEN_BYTES];                ///< The watched path, as given by the caller.
+    size_t treeNameLen;                             ///< Length of the "tree:" at the start of the
+                                                    ///<   path, 0 if there isn't one.
+    le_cfg_ChangeSummaryHandlerRef_t handlerRef;    ///< The change handler for the path.
+    le_dls_List_t entryList;                        ///< Values cached under this path.
+    le_dls_Link_t link;                             ///< Link in the WatchList.
+}
+Watch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A cached value.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[LE_CFG_STR_LEN_BYTES];                ///< Path to the node, the key in the EntryMap.
+    le_cfg_nodeType_t type;                         ///< The node's type.
+    char text[LE_CFG_STR_LEN_BYTES];                ///< The node's value, as a string.
+
+    union
+    {
+        int32_t asInt;
+        double asFloat;
+        bool asBool;
+    }
+    value;                                          ///< The node's value, for int, float and bool
+                                                    ///<   nodes.
+
+    le_dls_Link_t link;                             ///< Link in the entry list of the watch.
+}
+Entry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools for the watches and the cached values.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t WatchPool;
+static le_mem_PoolRef_t EntryPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The watched paths.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t WatchList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The cached values, keyed by path.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t EntryMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a path is at or under another one.
+ *
+ * @return
+ *      true if it is, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsAtOrUnder
+(
+    const char* pathPtr,                    ///< [IN] The path to check.
+    const char* basePathPtr                 ///< [IN] The path it could be under.
+)
+{
+    size_t baseLen = strlen(basePathPtr);
+
+    // The root of a tree ends in a separator of its own.
+    while ((baseLen > 0) && (basePathPtr[baseLen - 1] == '/'))
+    {
+        baseLen--;
+    }
+
+    return    (strncmp(pathPtr, basePathPtr, baseLen) == 0)
+           && ((pathPtr[baseLen] == '\0') || (pathPtr[baseLen] == '/'));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a path can be cached.  Only absolute paths in their simplest form are cached, so that
+ * each node has just the one entry, and a change can be matched to the entries it affects by just
+ * comparing paths.
+ *
+ * @return
+ *      The length of the "tree:" at the start of the path, (0 if there isn't one,) or -1 if the
+ *      path can't be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t CheckPath
+(
+    const char* pathPtr                     ///< [IN] The path to check.
+)
+{
+    const char* colonPtr = strchr(pathPtr, ':');
+    size_t treeNameLen = (colonPtr != NULL) ? (size_t)(colonPtr - pathPtr) + 1 : 0;
+    const char* nodePathPtr = pathPtr + treeNameLen;
+
+    if (   (nodePathPtr[0] != '/')
+        || (strlen(pathPtr) >= LE_CFG_STR_LEN_BYTES))
+    {
+        return -1;
+    }
+
+    // Check each of the path's node names.
+    const char* namePtr = nodePathPtr + 1;
+
+    while (*namePtr != '\0')
+    {
+        size_t nameLen = strcspn(namePtr, "/");
+
+        if (   (nameLen == 0)
+            || ((nameLen == 1) && (namePtr[0] == '.'))
+            || ((nameLen == 2) && (namePtr[0] == '.') && (namePtr[1] == '.'))
+            || ((namePtr[nameLen] == '/') && (namePtr[nameLen + 1] == '\0')))
+        {
+            return -1;
+        }
+
+        namePtr += nameLen;
+
+        if (*namePtr == '/')
+        {
+            namePtr++;
+        }
+    }
+
+    return treeNameLen;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop a cached value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteEntry
+(
+    Watch_t* watchPtr,                      ///< [IN] The watch the value is listed under.
+    Entry_t* entryPtr                       ///< [IN] The value to drop.
+)
+{
+    le_dls_Remove(&watchPtr->entryList, &entryPtr->link);
+    le_hashmap_Remove(EntryMap, entryPtr->path);
+    le_mem_Release(entryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called by the config tree when changes have been committed under a watched path.  Drops the
+ * values cached at or under the part of the tree that changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChangeSummaryHandler
+(
+    const char* changedPathPtr,             ///< [IN] Path to the part of the tree that changed,
+                                            ///<      without the tree name.
+    void* contextPtr                        ///< [IN] The watch.
+)
+{
+    Watch_t* watchPtr = contextPtr;
+    char changedPath[LE_CFG_STR_LEN_BYTES] = "";
+
+    // The cached paths include the tree name if the watched path did.
+    memcpy(changedPath, watchPtr->path, watchPtr->treeNameLen);
+    changedPath[watchPtr->treeNameLen] = '\0';
+
+    if (le_utf8_Append(changedPath, changedPathPtr, sizeof(changedPath), NULL) != LE_OK)
+    {
+        // This can't be narrowed down, so drop everything the watch has.
+        changedPath[watchPtr->treeNameLen] = '\0';
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&watchPtr->entryList);
+
+    while (linkPtr != NULL)
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+        linkPtr = le_dls_PeekNext(&watchPtr->entryList, linkPtr);
+
+        if (   (changedPath[watchPtr->treeNameLen] == '\0')
+            || IsAtOrUnder(entryPtr->path, changedPath))
+        {
+            DeleteEntry(watchPtr, entryPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the watch that a path is under.
+ *
+ * @return
+ *      The watch, or NULL if the path isn't being watched.
+ */
+//--------------------------------------------------------------------------------------------------
+static Watch_t* FindWatch
+(
+    const char* pathPtr                     ///< [IN] The path, in its simplest form.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&WatchList);
+
+    while (linkPtr != NULL)
+    {
+        Watch_t* watchPtr = CONTAINER_OF(linkPtr, Watch_t, link);
+
+        if (IsAtOrUnder(pathPtr, watchPtr->path))
+        {
+            return watchPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&WatchList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a node's type and value from the config tree, all within one read transaction so that they
+ * match each other.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FetchEntry
+(
+    Entry_t* entryPtr                       ///< [IN/OUT] The entry, with its path filled in.
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(entryPtr->path);
+
+    entryPtr->type = le_cfg_GetNodeType(iterRef, "");
+    entryPtr->text[0] = '\0';
+    memset(&entryPtr->value, 0, sizeof(entryPtr->value));
+
+    switch (entryPtr->type)
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+        case LE_CFG_TYPE_BOOL:
+            le_cfg_GetString(iterRef, "", entryPtr->text, sizeof(entryPtr->text), "");
+            break;
+
+        default:
+            break;
+    }
+
+    switch (entryPtr->type)
+    {
+        case LE_CFG_TYPE_INT:   entryPtr->value.asInt = le_cfg_GetInt(iterRef, "", 0);         break;
+        case LE_CFG_TYPE_FLOAT: entryPtr->value.asFloat = le_cfg_GetFloat(iterRef, "", 0.0);   break;
+        case LE_CFG_TYPE_BOOL:  entryPtr->value.asBool = le_cfg_GetBool(iterRef, "", false);   break;
+        default:                                                                               break;
+    }
+
+    le_cfg_CancelTxn(iterRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the cached value for a path, fetching it from the config tree first if it isn't cached yet.
+ *
+ * @return
+ *      The cached value, or NULL if the path isn't one that's cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* GetEntry
+(
+    const char* pathPtr                     ///< [IN] Path to the value.
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, pathPtr);
+
+    if (entryPtr != NULL)
+    {
+        return entryPtr;
+    }
+
+    if (CheckPath(pathPtr) < 0)
+    {
+        return NULL;
+    }
+
+    Watch_t* watchPtr = FindWatch(pathPtr);
+
+    if (watchPtr == NULL)
+    {
+        return NULL;
+    }
+
+    entryPtr = le_mem_ForceAlloc(EntryPool);
+    LE_ASSERT(le_utf8_Copy(entryPtr->path, pathPtr, sizeof(entryPtr->path), NULL) == LE_OK);
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    FetchEntry(entryPtr);
+
+    le_hashmap_Put(EntryMap, entryPtr->path, entryPtr);
+    le_dls_Queue(&watchPtr->entryList, &entryPtr->link);
+
+    return entryPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start caching the values at and under a path.  Watching the same path twice has no effect.
+ *
+ * @return
+ *      LE_OK if the path is being watched.
+ *      LE_BAD_PARAMETER if the path is not absolute, or is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t cfgCache_Watch
+(
+    const char* pathPtr         ///< [IN] Absolute path to the node to watch, optionally starting
+                                ///<      with a tree name, (as in "system:/apps".)
+)
+{
+    ssize_t treeNameLen = CheckPath(pathPtr);
+
+    if (treeNameLen < 0)
+    {
+        LE_ERROR("Can't cache values under '%s', it isn't a simple absolute path.", pathPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&WatchList);
+
+    while (linkPtr != NULL)
+    {
+        Watch_t* watchPtr = CONTAINER_OF(linkPtr, Watch_t, link);
+
+        if (strcmp(watchPtr->path, pathPtr) == 0)
+        {
+            return LE_OK;
+        }
+
+        linkPtr = le_dls_PeekNext(&WatchList, linkPtr);
+    }
+
+    Watch_t* watchPtr = le_mem_ForceAlloc(WatchPool);
+
+    LE_ASSERT(le_utf8_Copy(watchPtr->path, pathPtr, sizeof(watchPtr->path), NULL) == LE_OK);
+    watchPtr->treeNameLen = treeNameLen;
+    watchPtr->entryList = LE_DLS_LIST_INIT;
+    watchPtr->link = LE_DLS_LINK_INIT;
+
+    // Values already cached under a path that's now watched on its own stay with their old watch,
+    // the config tree reports their changes to both.
+    watchPtr->handlerRef = le_cfg_AddChangeSummaryHandler(pathPtr, ChangeSummaryHandler, watchPtr);
+
+    le_dls_Queue(&WatchList, &watchPtr->link);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop every cached value, so they'll all be fetched from the config tree again.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void cfgCache_Flush
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&WatchList);
+
+    while (linkPtr != NULL)
+    {
+        Watch_t* watchPtr = CONTAINER_OF(linkPtr, Watch_t, link);
+        le_dls_Link_t* entryLinkPtr;
+
+        while ((entryLinkPtr = le_dls_Peek(&watchPtr->entryList)) != NULL)
+        {
+            DeleteEntry(watchPtr, CONTAINER_OF(entryLinkPtr, Entry_t, link));
+        }
+
+        linkPtr = le_dls_PeekNext(&WatchList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a string value, as with le_cfg_QuickGetString().
+ *
+ * @return
+ *      LE_OK if the value was read.
+ *      LE_OVERFLOW if the value was truncated to fit the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t cfgCache_GetString
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    char* bufferPtr,            ///< [OUT] Buffer for the value.
+    size_t bufferSize,          ///< [IN] Size of the buffer.
+    const char* defaultPtr      ///< [IN] Value to give back if the node is empty or doesn't exist.
+)
+{
+    Entry_t* entryPtr = GetEntry(pathPtr);
+
+    if (entryPtr == NULL)
+    {
+        return le_cfg_QuickGetString(pathPtr, bufferPtr, bufferSize, defaultPtr);
+    }
+
+    switch (entryPtr->type)
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+        case LE_CFG_TYPE_BOOL:
+            return le_utf8_Copy(bufferPtr, entryPtr->text, bufferSize, NULL);
+
+        default:
+            return le_utf8_Copy(bufferPtr, defaultPtr, bufferSize, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer value, as with le_cfg_QuickGetInt().
+ *
+ * @return
+ *      The value, or the default if the node isn't an int or a float node.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED int32_t cfgCache_GetInt
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    int32_t defaultValue        ///< [IN] Value to give back if the node has no integer value.
+)
+{
+    Entry_t* entryPtr = GetEntry(pathPtr);
+
+    if (entryPtr == NULL)
+    {
+        return le_cfg_QuickGetInt(pathPtr, defaultValue);
+    }
+
+    switch (entryPtr->type)
+    {
+        case LE_CFG_TYPE_INT:
+            return entryPtr->value.asInt;
+
+        case LE_CFG_TYPE_FLOAT:
+            // Rounded the same way the config tree does it.
+            return (int32_t)(entryPtr->value.asFloat >= 0.0 ? entryPtr->value.asFloat + 0.5
+                                                             : entryPtr->value.asFloat - 0.5);
+
+        default:
+            return defaultValue;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a floating point value, as with le_cfg_QuickGetFloat().
+ *
+ * @return
+ *      The value, or the default if the node isn't an int or a float node.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED double cfgCache_GetFloat
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    double defaultValue         ///< [IN] Value to give back if the node has no numeric value.
+)
+{
+    Entry_t* entryPtr = GetEntry(pathPtr);
+
+    if (entryPtr == NULL)
+    {
+        return le_cfg_QuickGetFloat(pathPtr, defaultValue);
+    }
+
+    switch (entryPtr->type)
+    {
+        case LE_CFG_TYPE_INT:   return entryPtr->value.asInt;
+        case LE_CFG_TYPE_FLOAT: return entryPtr->value.asFloat;
+        default:                return defaultValue;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a boolean value, as with le_cfg_QuickGetBool().
+ *
+ * @return
+ *      The value, or the default if the node isn't a bool node.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool cfgCache_GetBool
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    bool defaultValue           ///< [IN] Value to give back if the node has no boolean value.
+)
+{
+    Entry_t* entryPtr = GetEntry(pathPtr);
+
+    if (entryPtr == NULL)
+    {
+        return le_cfg_QuickGetBool(pathPtr, defaultValue);
+    }
+
+    if (entryPtr->type == LE_CFG_TYPE_BOOL)
+    {
+        return entryPtr->value.asBool;
+    }
+
+    return defaultValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config cache's initialization function.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    WatchPool = le_mem_CreatePool("CfgCacheWatch", sizeof(Watch_t));
+    EntryPool = le_mem_CreatePool("CfgCacheEntry", sizeof(Entry_t));
+    EntryMap = le_hashmap_Create("CfgCacheEntries",
+                                 31,
+                                 le_hashmap_HashString,
+                                 le_hashmap_EqualsString);
+}
@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgCache.h
+ *
+ * A read-through cache of config tree values, for processes that read the same settings over and
+ * over again.  Each le_cfg read is a round trip to the config tree, while a cached read is a hash
+ * lookup in the reading process.
+ *
+ * Only values under paths that have been given to cfgCache_Watch() are cached; reads of any other
+ * path go straight to the config tree.  The first read of a value fetches it from the tree, and
+ * later reads are answered from the cache, until a change is committed to the value or to one of
+ * its parents.  The config tree reports each commit to the cache with a change summary, and the
+ * cached values under the changed part of the tree are dropped, to be fetched again by the next
+ * read.  Nodes that don't exist are cached as well, so reads that fall back to a default value are
+ * just as cheap.
+ *
+ * Change notifications reach the cache some time after the commit that caused them, (more so if
+ * the config tree has a notification delay configured,) so a read made in between can return the
+ * value from before the commit.  Callers that need to see their own writes right away, or that
+ * need several values to be consistent with each other, should use a read transaction instead.
+ *
+ * The cache belongs to the thread that calls cfgCache_Watch(), since that's the thread its change
+ * notifications are delivered to.  It must only be used from that thread.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_CFG_CACHE_INCLUDE_GUARD
+#define LEGATO_CFG_CACHE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start caching the values at and under a path.  Watching the same path twice has no effect.
+ *
+ * @return
+ *      LE_OK if the path is being watched.
+ *      LE_BAD_PARAMETER if the path is not absolute, or is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgCache_Watch
+(
+    const char* pathPtr         ///< [IN] Absolute path to the node to watch, optionally starting
+                                ///<      with a tree name, (as in "system:/apps".)
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop every cached value, so they'll all be fetched from the config tree again.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgCache_Flush
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a string value, as with le_cfg_QuickGetString().
+ *
+ * @return
+ *      LE_OK if the value was read.
+ *      LE_OVERFLOW if the value was truncated to fit the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgCache_GetString
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    char* bufferPtr,            ///< [OUT] Buffer for the value.
+    size_t bufferSize,          ///< [IN] Size of the buffer.
+    const char* defaultPtr      ///< [IN] Value to give back if the node is empty or doesn't exist.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer value, as with le_cfg_QuickGetInt().
+ *
+ * @return
+ *      The value, or the default if the node isn't an int or a float node.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t cfgCache_GetInt
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    int32_t defaultValue        ///< [IN] Value to give back if the node has no integer value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a floating point value, as with le_cfg_QuickGetFloat().
+ *
+ * @return
+ *      The value, or the default if the node isn't an int or a float node.
+ */
+//--------------------------------------------------------------------------------------------------
+double cfgCache_GetFloat
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    double defaultValue         ///< [IN] Value to give back if the node has no numeric value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a boolean value, as with le_cfg_QuickGetBool().
+ *
+ * @return
+ *      The value, or the default if the node isn't a bool node.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgCache_GetBool
+(
+    const char* pathPtr,        ///< [IN] Path to the value.
+    bool defaultValue           ///< [IN] Value to give back if the node has no boolean value.
+);
+
+
+#endif  // LEGATO_CFG_CACHE_INCLUDE_GUARD
@@ -22,4 +22,17 @@
 #define CFG_NODE_RATE               "acquisitionRate"
 #define CFG_POSITIONING_RATE_PATH   CFG_POSITIONING_PATH"/"CFG_NODE_RATE
 
+#define CFG_NODE_NMEA_BUFFER_SIZE   "nmeaBufferSize"
+
+#define CFG_NODE_ASSIST             "assist"
+#define CFG_POSITIONING_ASSIST_PATH CFG_POSITIONING_PATH"/"CFG_NODE_ASSIST
+
+#define CFG_NODE_LAST_FIX           "lastFix"
+#define CFG_NODE_LATITUDE           "latitude"
+#define CFG_NODE_LONGITUDE          "longitude"
+#define CFG_NODE_H_ACCURACY         "hAccuracy"
+#define CFG_NODE_FIX_TIME           "time"
+
+#define CFG_NODE_XTRA_FILE          "xtraFile"
+
 #endif // LEGATO_POSCFGENTRIES_INCLUDE_GUARD
@@ -12,6 +12,11 @@
  * with the first technology to use. If this one is or becomes unavailable, the second one is used.
  * If the last technology of the list is also unavailable, the first one is used again.
  *
+ * When racing is enabled in the config tree, all the technologies of the list are started at
+ * once instead, and the first one to connect is used while the others are stopped. When the
+ * connection is lost, the other technologies are raced again. If none of them connects, the
+ * technologies are used one after the other as above.
+ *
  * The connection establishment upon reception of a REQUEST command depends on the technology
  * to use:
  * - With the 'Mobile' technology, the DCS first sends a REQUEST command to the Cellular Network
@@ -56,6 +61,8 @@
 #define CFG_NODE_PASSPHRASE         "passphrase"
 #define CFG_PATH_CELLULAR           "cellular"
 #define CFG_NODE_PROFILEINDEX       "profileIndex"
+#define CFG_PATH_CONNECTION         "connection"
+#define CFG_NODE_RACETECHNOLOGIES   "raceTechnologies"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -173,6 +180,34 @@ typedef struct
 }
 TechRecord_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Race state of a technology
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    TECH_RACE_NONE,     ///< Not racing
+    TECH_RACE_STARTING, ///< Started in a race, not connected yet
+    TECH_RACE_ABORTED   ///< Lost a race: its late events are ignored until it is started again
+}
+TechRaceState_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection establishment state of a technology
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    TechRaceState_t raceState;      ///< Race state
+    bool            isStarting;     ///< The technology is started and not connected yet
+    le_clk_Time_t   startTime;      ///< When the technology was started
+    bool            hasConnected;   ///< The technology has connected at least once
+    uint32_t        timeToConnect;  ///< Time to connect of the last connection, in ms
+}
+TechState_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations
 //--------------------------------------------------------------------------------------------------
@@ -183,6 +218,7 @@ TechRecord_t;
  */
 //--------------------------------------------------------------------------------------------------
 static void ConnectionStatusHandler(le_data_Technology_t technology, bool connected);
+static void RaceStatusHandler(le_data_Technology_t technology, bool connected);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -354,6 +390,22 @@ static le_data_Technology_t CurrentTech = LE_DATA_MAX;
 //--------------------------------------------------------------------------------------------------
 static bool DefaultRouteStatus = true;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Technologies racing activation status, read at start-up in config tree.
+ * - true:  the technologies of the list are started at once, the first one to connect is used
+ * - false: the technologies of the list are started one after the other
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RaceTechnologies = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Technologies connection establishment states
+ */
+//--------------------------------------------------------------------------------------------------
+static TechState_t TechState[DCS_TECH_NUMBER];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the list of technologies to use with the default values
@@ -580,6 +632,60 @@ static le_data_Technology_t GetNextTech
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a technology is started or used by DCS, alone or in a race
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsTechInUse
+(
+    le_data_Technology_t technology     ///< [IN] Technology
+)
+{
+    return ((technology == CurrentTech) || (TECH_RACE_STARTING == TechState[technology].raceState));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the start of the connection establishment with a technology
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkTechStarting
+(
+    le_data_Technology_t technology,    ///< [IN] Technology
+    TechRaceState_t      raceState      ///< [IN] Race state of the technology
+)
+{
+    TechState[technology].raceState = raceState;
+    TechState[technology].isStarting = true;
+    TechState[technology].startTime = le_clk_GetRelativeTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the connection of a technology, and its time to connect if it was being started
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkTechConnected
+(
+    le_data_Technology_t technology     ///< [IN] Technology
+)
+{
+    if (TechState[technology].isStarting)
+    {
+        char techStr[DCS_TECH_BYTES] = {0};
+        le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(),
+                                           TechState[technology].startTime);
+
+        TechState[technology].isStarting = false;
+        TechState[technology].hasConnected = true;
+        TechState[technology].timeToConnect = elapsed.sec * 1000 + elapsed.usec / 1000;
+
+        GetTechnologyString(technology, techStr, sizeof(techStr));
+        LE_INFO("'%s' connected in %u ms", techStr, TechState[technology].timeToConnect);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * IP Handling to be done once the wifi link is established
@@ -630,8 +736,21 @@ static void WifiClientEventHandler
     void* contextPtr                ///< [IN] Associated context pointer
 )
 {
+    bool connected;
+
     LE_DEBUG("Wifi event received");
 
+    // The wifi connection lost a race, its events are not relevant until it is disconnected
+    if (TECH_RACE_ABORTED == TechState[LE_DATA_WIFI].raceState)
+    {
+        LE_DEBUG("Ignoring wifi event %d", event);
+        if (LE_WIFICLIENT_EVENT_DISCONNECTED == event)
+        {
+            TechState[LE_DATA_WIFI].raceState = TECH_RACE_NONE;
+        }
+        return;
+    }
+
     switch (event)
     {
         case LE_WIFICLIENT_EVENT_CONNECTED:
@@ -639,20 +758,26 @@ static void WifiClientEventHandler
 
             // Request an IP address through DHCP if DCS initiated the connection
             // and update connection status
-            if ((LE_DATA_WIFI == CurrentTech) && (RequestCount > 0))
+            if ((IsTechInUse(LE_DATA_WIFI)) && (RequestCount > 0))
             {
-                if (LE_OK == AskForIpAddress())
-                {
-                    IsConnected = true;
-                }
-                else
-                {
-                    IsConnected = false;
-                }
+                connected = (LE_OK == AskForIpAddress());
             }
             else
             {
-                IsConnected = true;
+                connected = true;
+            }
+
+            // Is wifi the first technology to connect?
+            if (TECH_RACE_STARTING == TechState[LE_DATA_WIFI].raceState)
+            {
+                RaceStatusHandler(LE_DATA_WIFI, connected);
+                break;
+            }
+
+            IsConnected = connected;
+            if (IsConnected)
+            {
+                MarkTechConnected(LE_DATA_WIFI);
             }
 
             // Send notification to registered applications
@@ -665,6 +790,12 @@ static void WifiClientEventHandler
         case LE_WIFICLIENT_EVENT_DISCONNECTED:
             LE_INFO("Wifi client disconnected");
 
+            if (TECH_RACE_STARTING == TechState[LE_DATA_WIFI].raceState)
+            {
+                RaceStatusHandler(LE_DATA_WIFI, false);
+                break;
+            }
+
             // Update connection status and send notification to registered applications
             IsConnected = false;
             SendConnStateEvent(IsConnected);
@@ -730,8 +861,29 @@ static void DataSessionStateHandler
         return;
     }
 
+    // The cellular connection lost a race, its events are not relevant until it is disconnected
+    if (TECH_RACE_ABORTED == TechState[LE_DATA_CELLULAR].raceState)
+    {
+        if (LE_MDC_DISCONNECTED == connectionStatus)
+        {
+            TechState[LE_DATA_CELLULAR].raceState = TECH_RACE_NONE;
+        }
+        return;
+    }
+
+    // Is cellular the first technology to connect?
+    if (TECH_RACE_STARTING == TechState[LE_DATA_CELLULAR].raceState)
+    {
+        RaceStatusHandler(LE_DATA_CELLULAR, (LE_MDC_CONNECTED == connectionStatus));
+        return;
+    }
+
     // Update connection status and send notification to registered applications
     IsConnected = (connectionStatus == LE_MDC_CONNECTED) ? true : false;
+    if (IsConnected)
+    {
+        MarkTechConnected(LE_DATA_CELLULAR);
+    }
     SendConnStateEvent(IsConnected);
 
     // Handle new connection status for this technology
@@ -813,6 +965,35 @@ static bool GetDefaultRouteStatus
     return defaultRouteStatus;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get technologies racing activation status from config tree
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetRaceTechnologiesStatus
+(
+    void
+)
+{
+    bool raceStatus = false;
+
+    char configPath[LE_CFG_STR_LEN_BYTES];
+    snprintf(configPath, sizeof(configPath), "%s/%s", DCS_CONFIG_TREE_ROOT_DIR,
+             CFG_PATH_CONNECTION);
+
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateReadTxn(configPath);
+
+    // Get technologies racing activation status
+    if (le_cfg_NodeExists(cfg, CFG_NODE_RACETECHNOLOGIES))
+    {
+        raceStatus = le_cfg_GetBool(cfg, CFG_NODE_RACETECHNOLOGIES, false);
+        LE_DEBUG("Technologies racing activation status = %d", raceStatus);
+    }
+    le_cfg_CancelTxn(cfg);
+
+    return raceStatus;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Load the profile of the selected technology
@@ -1778,6 +1959,12 @@ static void TryStartDataSession
         // Impossible to use this technology, try the next one
         ConnectionStatusHandler(LE_DATA_CELLULAR, false);
     }
+    else if (TECH_RACE_STARTING == TechState[LE_DATA_CELLULAR].raceState)
+    {
+        // The route and DNS are only set if cellular wins the race, the other technologies
+        // should not be delayed meanwhile
+        LE_DEBUG("Cellular data session started for the race");
+    }
     else
     {
         // First wait a few seconds for the default DHCP client
@@ -1860,6 +2047,51 @@ static void TryStartWifiSession
     LE_INFO("Connecting to AP");
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the connection establishment with a defined technology
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTechSession
+(
+    le_data_Technology_t technology     ///< [IN] Technology to use for the data session
+)
+{
+    switch (technology)
+    {
+        case LE_DATA_CELLULAR:
+        {
+            // Load MobileProfileRef
+            le_result_t result = LoadSelectedTechProfile(LE_DATA_CELLULAR);
+            if (LE_OK == result)
+            {
+                // Ensure that cellular network service is available.
+                // Data connection will be started when cellular network registration
+                // notification is received.
+                le_cellnet_Request();
+            }
+            else
+            {
+                LE_WARN("Impossible to use cellular profile, error %d (%s)",
+                        result, LE_RESULT_TXT(result));
+
+                // Impossible to use this technology, try the next one
+                ConnectionStatusHandler(LE_DATA_CELLULAR, false);
+            }
+        }
+        break;
+
+        case LE_DATA_WIFI:
+            // Try to establish the wifi connection
+            TryStartWifiSession();
+            break;
+
+        default:
+            LE_ERROR("Unknown technology %d to start", technology);
+            break;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Try to start the default data session with a defined technology
@@ -1882,39 +2114,136 @@ static void TryStartTechSession
 
         // Store the currently used technology
         CurrentTech = technology;
+        MarkTechStarting(technology, TECH_RACE_NONE);
 
-        switch (technology)
+        StartTechSession(technology);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the connection establishment with all the technologies of the list at once, except the
+ * one which just failed. The first one to connect is used as the default data connection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRace
+(
+    le_data_Technology_t failedTech     ///< [IN] Technology to leave out, LE_DATA_MAX for none
+)
+{
+    le_dls_Link_t* linkPtr;
+    int racersCount = 0;
+    int tech;
+
+    // No technology is used until one of them wins the race
+    CurrentTech = LE_DATA_MAX;
+
+    for (linkPtr = le_dls_Peek(&TechList); NULL != linkPtr;
+         linkPtr = le_dls_PeekNext(&TechList, linkPtr))
+    {
+        le_data_Technology_t technology = CONTAINER_OF(linkPtr, TechRecord_t, link)->tech;
+
+        if (technology != failedTech)
         {
-            case LE_DATA_CELLULAR:
+            MarkTechStarting(technology, TECH_RACE_STARTING);
+            racersCount++;
+        }
+    }
+
+    if (0 == racersCount)
+    {
+        // Nothing to race, use the technologies one after the other
+        TryStartTechSession(le_data_GetFirstUsedTechnology());
+        return;
+    }
+
+    LE_INFO("Racing %d technologies for the data connection", racersCount);
+
+    // A technology can fail, or even win, as soon as it is started: check its state again
+    for (tech = 0; tech < DCS_TECH_NUMBER; tech++)
+    {
+        if (TECH_RACE_STARTING == TechState[tech].raceState)
+        {
+            StartTechSession(tech);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the connection establishment with a technology which lost the race
+ */
+//--------------------------------------------------------------------------------------------------
+static void AbortTechSession
+(
+    le_data_Technology_t technology     ///< [IN] Technology to stop
+)
+{
+    TechState[technology].raceState = TECH_RACE_ABORTED;
+    TechState[technology].isStarting = false;
+
+    switch (technology)
+    {
+        case LE_DATA_CELLULAR:
+            if ((NULL != MobileProfileRef) && (LE_OK != le_mdc_StopSession(MobileProfileRef)))
             {
-                // Load MobileProfileRef
-                le_result_t result = LoadSelectedTechProfile(LE_DATA_CELLULAR);
-                if (LE_OK == result)
-                {
-                    // Ensure that cellular network service is available.
-                    // Data connection will be started when cellular network registration
-                    // notification is received.
-                    le_cellnet_Request();
-                }
-                else
-                {
-                    LE_WARN("Impossible to use cellular profile, error %d (%s)",
-                            result, LE_RESULT_TXT(result));
+                LE_DEBUG("No mobile data session to stop");
+            }
+            break;
 
-                    // Impossible to use this technology, try the next one
-                    ConnectionStatusHandler(LE_DATA_CELLULAR, false);
-                }
+        case LE_DATA_WIFI:
+            if (LE_OK != le_wifiClient_Disconnect())
+            {
+                LE_DEBUG("No wifi connection to stop");
             }
             break;
 
-            case LE_DATA_WIFI:
-                // Try to establish the wifi connection
-                TryStartWifiSession();
-                break;
+        default:
+            LE_ERROR("Unknown technology %d to stop", technology);
+            break;
+    }
+}
 
-            default:
-                LE_ERROR("Unknown technology %d to start", technology);
-                break;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if technologies are racing for the data connection
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRaceInProgress
+(
+    void
+)
+{
+    int tech;
+
+    for (tech = 0; tech < DCS_TECH_NUMBER; tech++)
+    {
+        if (TECH_RACE_STARTING == TechState[tech].raceState)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop all the technologies which are still racing for the data connection
+ */
+//--------------------------------------------------------------------------------------------------
+static void AbortRace
+(
+    void
+)
+{
+    int tech;
+
+    for (tech = 0; tech < DCS_TECH_NUMBER; tech++)
+    {
+        if (TECH_RACE_STARTING == TechState[tech].raceState)
+        {
+            AbortTechSession(tech);
         }
     }
 }
@@ -2178,8 +2507,16 @@ static void ProcessCommand
             // The connection notification will be sent when DCS retrieves the data session.
             if (1 == RequestCount)
             {
-                // Get the technology to use from the list and start the data session
-                TryStartTechSession(le_data_GetFirstUsedTechnology());
+                if (RaceTechnologies)
+                {
+                    // Start all the technologies of the list and use the first one to connect
+                    StartRace(LE_DATA_MAX);
+                }
+                else
+                {
+                    // Get the technology to use from the list and start the data session
+                    TryStartTechSession(le_data_GetFirstUsedTechnology());
+                }
             }
         }
         else
@@ -2200,8 +2537,16 @@ static void ProcessCommand
 
         if (0 == RequestCount)
         {
-            // Try and disconnect the current technology
-            TryStopTechSession(CurrentTech);
+            if (IsRaceInProgress())
+            {
+                // No technology is used yet, stop all the racing ones
+                AbortRace();
+            }
+            else
+            {
+                // Try and disconnect the current technology
+                TryStopTechSession(CurrentTech);
+            }
         }
     }
     else
@@ -2234,7 +2579,7 @@ static void CellNetStateHandler
         case LE_CELLNET_REG_HOME:
         case LE_CELLNET_REG_ROAMING:
             // Check if the mobile data session should be started
-            if ((LE_DATA_CELLULAR == CurrentTech) && (RequestCount > 0) && (!IsConnected))
+            if ((IsTechInUse(LE_DATA_CELLULAR)) && (RequestCount > 0) && (!IsConnected))
             {
                 TryStartDataSession();
             }
@@ -2253,17 +2598,89 @@ static void ConnectionStatusHandler
     bool connected                      ///< [IN] Connection status
 )
 {
+    // The technology is racing for the data connection
+    if (TECH_RACE_STARTING == TechState[technology].raceState)
+    {
+        RaceStatusHandler(technology, connected);
+        return;
+    }
+
     // Check if the default data connection is still necessary
     if ((false == connected) && (RequestCount > 0))
     {
+        // Race the technologies again only if the connection was established and then lost
+        bool wasStarting = TechState[technology].isStarting;
+        TechState[technology].isStarting = false;
+
         // Disconnect the current technology which is not available anymore
         TryStopTechSession(CurrentTech);
 
-        // Connect the next technology to use
-        TryStartTechSession(GetNextTech(CurrentTech));
+        if ((RaceTechnologies) && (!wasStarting))
+        {
+            // Connect the first available technology, except the one which was just lost
+            StartRace(technology);
+        }
+        else
+        {
+            // Connect the next technology to use
+            TryStartTechSession(GetNextTech(CurrentTech));
+        }
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the connection status of a technology racing for the data connection
+ */
+//--------------------------------------------------------------------------------------------------
+static void RaceStatusHandler
+(
+    le_data_Technology_t technology,    ///< [IN] Racing technology
+    bool connected                      ///< [IN] Connection status
+)
+{
+    int tech;
+
+    if (!connected)
+    {
+        AbortTechSession(technology);
+
+        if (!IsRaceInProgress())
+        {
+            LE_WARN("No technology won the race, trying them one after the other");
+            TryStartTechSession(le_data_GetFirstUsedTechnology());
+        }
+        return;
+    }
+
+    // The first technology to connect wins the race: stop the other ones
+    for (tech = 0; tech < DCS_TECH_NUMBER; tech++)
+    {
+        if ((technology != (le_data_Technology_t)tech) &&
+            (TECH_RACE_STARTING == TechState[tech].raceState))
+        {
+            AbortTechSession(tech);
+        }
+    }
+    TechState[technology].raceState = TECH_RACE_NONE;
+    CurrentTech = technology;
+
+    // The route and DNS were not set while cellular was racing
+    if ((LE_DATA_CELLULAR == technology) && (LE_OK != SetDefaultRouteAndDns(DefaultRouteStatus)))
+    {
+        // Impossible to use this technology, try the next one
+        IsConnected = false;
+        ConnectionStatusHandler(LE_DATA_CELLULAR, false);
+        return;
+    }
+
+    IsConnected = true;
+    MarkTechConnected(technology);
+
+    // Send notification to registered applications
+    SendConnStateEvent(IsConnected);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer Connection State Handler
@@ -2802,6 +3219,37 @@ le_data_Technology_t le_data_GetTechnology
     return CurrentTech;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time the last connection through a technology took to be established, from its start
+ * to the connection notification.
+ *
+ * @return
+ *      - LE_OK             on success
+ *      - LE_BAD_PARAMETER  if the technology is unknown
+ *      - LE_NOT_FOUND      if no connection was established through this technology yet
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_data_GetTimeToConnect
+(
+    le_data_Technology_t technology,    ///< [IN] Technology
+    uint32_t* timeToConnectPtr          ///< [OUT] Time to connect in milliseconds
+)
+{
+    if ((technology >= DCS_TECH_NUMBER) || (NULL == timeToConnectPtr))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (!TechState[technology].hasConnected)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    *timeToConnectPtr = TechState[technology].timeToConnect;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the cellular profile index used by the data connection service when the cellular technology
@@ -2963,6 +3411,9 @@ COMPONENT_INIT
     // Retrieve default gateway activation status
     DefaultRouteStatus = GetDefaultRouteStatus();
 
+    // Check if the technologies should be raced
+    RaceTechnologies = GetRaceTechnologiesStatus();
+
     // Set a timer to retry the stop data session
     StopDcsTimer = le_timer_Create("StopDcsTimer");
     le_clk_Time_t interval = {0, 5};    // 5 seconds
@@ -0,0 +1,25 @@
+/**
+ * @file dualsys.h
+ *
+ * Dual system functions used by the rest of the firmware update service.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_DUALSYS_INCLUDE_GUARD
+#define LEGATO_DUALSYS_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if an incremental synchronization is in progress.  Operations writing to the flash must
+ * not be started while it is.
+ *
+ * @return true if a synchronization is in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+bool dualsys_IsSyncInProgress
+(
+    void
+);
+
+#endif // LEGATO_DUALSYS_INCLUDE_GUARD
@@ -9,6 +9,259 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_fwupdate.h"
+#include "dualsys.h"
+#include <sys/eventfd.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the chunks read from the client's file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DOWNLOAD_CHUNK_SIZE     (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of chunks that can wait for the flash programming, while the next one is received.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DOWNLOAD_PIPELINE_DEPTH 2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Download pipeline.
+ *
+ * The image is received from the client's file descriptor by a thread, and handed over to the
+ * platform adaptor through a pipe. So the next chunk of the image is received while the platform
+ * adaptor programs the flash with the previous ones, instead of one after the other.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int             clientFd;       ///< File descriptor of the image, given by the client.
+    int             pipeFd[2];      ///< Pipe to the platform adaptor.
+    int             stopFd;         ///< Event file descriptor to stop the reception thread.
+    le_thread_Ref_t threadRef;      ///< Reception thread.
+}
+DownloadPipeline_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the last download.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t          startPosition;  ///< Resume position when the download started.
+    uint64_t        receivedBytes;  ///< Bytes received from the client.
+    le_clk_Time_t   startTime;      ///< Start of the download.
+    le_clk_Time_t   duration;       ///< Duration of the download.
+}
+DownloadStats_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the last download. The received bytes are only updated by the reception thread,
+ * and only read once it has been joined.
+ */
+//--------------------------------------------------------------------------------------------------
+static DownloadStats_t DownloadStats;
+
+//==================================================================================================
+//                                       Private Functions
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a file descriptor to be ready, or for the reception thread to be stopped.
+ *
+ * @return
+ *      - true  if the file descriptor is ready
+ *      - false if the thread is stopped, or the file descriptor is in error
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WaitFd
+(
+    DownloadPipeline_t* pipelinePtr,    ///< [IN] Download pipeline
+    int fd,                             ///< [IN] File descriptor to wait for
+    short events                        ///< [IN] Events to wait for
+)
+{
+    struct pollfd fds[2] =
+    {
+        { .fd = fd, .events = events },
+        { .fd = pipelinePtr->stopFd, .events = POLLIN }
+    };
+    int ret;
+
+    do
+    {
+        ret = poll(fds, 2, -1);
+    }
+    while ((-1 == ret) && (EINTR == errno));
+
+    if ((ret < 0) || (fds[1].revents))
+    {
+        return false;
+    }
+
+    // A hang-up still lets the remaining data be read.
+    return (0 != (fds[0].revents & (events | POLLHUP)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reception thread: read the image from the client's file descriptor, and write it to the pipe.
+ * The end of the image, or an error, is reported to the platform adaptor by closing the pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ReceiveImage
+(
+    void* contextPtr    ///< [IN] Download pipeline
+)
+{
+    DownloadPipeline_t* pipelinePtr = contextPtr;
+    static uint8_t chunk[DOWNLOAD_CHUNK_SIZE];
+    sigset_t sigSet;
+
+    // A write to a pipe closed by the platform adaptor must fail, not kill the process.
+    sigemptyset(&sigSet);
+    sigaddset(&sigSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigSet, NULL);
+
+    while (WaitFd(pipelinePtr, pipelinePtr->clientFd, POLLIN))
+    {
+        ssize_t length = read(pipelinePtr->clientFd, chunk, sizeof(chunk));
+
+        if ((length < 0) && ((EINTR == errno) || (EAGAIN == errno)))
+        {
+            continue;
+        }
+        if (length <= 0)
+        {
+            break;
+        }
+
+        DownloadStats.receivedBytes += length;
+
+        ssize_t offset = 0;
+        while (offset < length)
+        {
+            if (!WaitFd(pipelinePtr, pipelinePtr->pipeFd[1], POLLOUT))
+            {
+                goto end;
+            }
+
+            ssize_t written = write(pipelinePtr->pipeFd[1], chunk + offset, length - offset);
+
+            if (written < 0)
+            {
+                if ((EINTR == errno) || (EAGAIN == errno))
+                {
+                    continue;
+                }
+                LE_ERROR("Unable to hand the image over: %m");
+                goto end;
+            }
+            offset += written;
+        }
+    }
+
+end:
+    close(pipelinePtr->pipeFd[1]);
+    pipelinePtr->pipeFd[1] = -1;
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the download pipeline.
+ *
+ * @return
+ *      - LE_OK    On success
+ *      - LE_FAULT On failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartPipeline
+(
+    DownloadPipeline_t* pipelinePtr,    ///< [IN] Download pipeline
+    int clientFd                        ///< [IN] File descriptor of the image
+)
+{
+    int flags;
+
+    pipelinePtr->clientFd = clientFd;
+
+    if (-1 == pipe2(pipelinePtr->pipeFd, O_CLOEXEC))
+    {
+        LE_ERROR("Unable to create the download pipe: %m");
+        return LE_FAULT;
+    }
+
+    // A blocking write could not be interrupted by StopPipeline(), if the platform adaptor stops
+    // reading the image.
+    flags = fcntl(pipelinePtr->pipeFd[1], F_GETFL);
+    if ((-1 == flags) || (-1 == fcntl(pipelinePtr->pipeFd[1], F_SETFL, flags | O_NONBLOCK)))
+    {
+        LE_ERROR("Unable to set up the download pipe: %m");
+        close(pipelinePtr->pipeFd[0]);
+        close(pipelinePtr->pipeFd[1]);
+        return LE_FAULT;
+    }
+
+    // Room for the chunks waiting for the flash programming. The default size is kept if the
+    // kernel refuses it.
+    if (-1 == fcntl(pipelinePtr->pipeFd[1], F_SETPIPE_SZ,
+                    DOWNLOAD_PIPELINE_DEPTH * DOWNLOAD_CHUNK_SIZE))
+    {
+        LE_WARN("Unable to resize the download pipe: %m");
+    }
+
+    pipelinePtr->stopFd = eventfd(0, EFD_CLOEXEC);
+    if (-1 == pipelinePtr->stopFd)
+    {
+        LE_ERROR("Unable to create the download event: %m");
+        close(pipelinePtr->pipeFd[0]);
+        close(pipelinePtr->pipeFd[1]);
+        return LE_FAULT;
+    }
+
+    pipelinePtr->threadRef = le_thread_Create("FwDownload", ReceiveImage, pipelinePtr);
+    le_thread_SetJoinable(pipelinePtr->threadRef);
+    le_thread_Start(pipelinePtr->threadRef);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the download pipeline, once the platform adaptor is done with the image.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopPipeline
+(
+    DownloadPipeline_t* pipelinePtr     ///< [IN] Download pipeline
+)
+{
+    uint64_t stop = 1;
+
+    if (sizeof(stop) != write(pipelinePtr->stopFd, &stop, sizeof(stop)))
+    {
+        LE_ERROR("Unable to stop the download thread: %m");
+    }
+    le_thread_Join(pipelinePtr->threadRef, NULL);
+
+    close(pipelinePtr->stopFd);
+    close(pipelinePtr->clientFd);
+}
 
 //==================================================================================================
 //                                       Public API Functions
@@ -47,8 +300,77 @@ le_result_t le_fwupdate_Download
         return LE_BAD_PARAMETER;
     }
 
-    // Pass the fd to the PA layer, which will handle the details.
-    return pa_fwupdate_Download(fd);
+    if (dualsys_IsSyncInProgress())
+    {
+        LE_ERROR("A synchronization of the systems is in progress");
+        close(fd);
+        return LE_BUSY;
+    }
+
+    DownloadPipeline_t pipeline;
+    le_result_t result;
+
+    memset(&DownloadStats, 0, sizeof(DownloadStats));
+    if (LE_OK != pa_fwupdate_GetResumePosition(&DownloadStats.startPosition))
+    {
+        DownloadStats.startPosition = 0;
+    }
+    DownloadStats.startTime = le_clk_GetRelativeTime();
+    LE_INFO("Download starting at position %zu", DownloadStats.startPosition);
+
+    if (LE_OK != StartPipeline(&pipeline, fd))
+    {
+        // Pass the fd to the PA layer, which will handle the details.
+        return pa_fwupdate_Download(fd);
+    }
+
+    // The PA layer reads the image from the pipe, and owns its read end as it owned the fd.
+    result = pa_fwupdate_Download(pipeline.pipeFd[0]);
+
+    StopPipeline(&pipeline);
+
+    DownloadStats.duration = le_clk_Sub(le_clk_GetRelativeTime(), DownloadStats.startTime);
+    LE_INFO("Download %s: %"PRIu64" bytes received in %ld.%03ld s",
+            LE_RESULT_TXT(result), DownloadStats.receivedBytes,
+            (long)DownloadStats.duration.sec, (long)(DownloadStats.duration.usec / 1000));
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the statistics of the last download.
+ *
+ * @return
+ *      - LE_OK              On success
+ *      - LE_BAD_PARAMETER   The given parameters are invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fwupdate_GetDownloadStatistics
+(
+    size_t *startPositionPtr,   ///< [OUT] Resume position when the download started
+    uint64_t *receivedBytesPtr, ///< [OUT] Bytes received
+    uint32_t *durationMsPtr,    ///< [OUT] Duration of the download, in milliseconds
+    uint32_t *throughputPtr     ///< [OUT] Average throughput, in bytes per second
+)
+{
+    uint64_t durationMs;
+
+    if ((NULL == startPositionPtr) || (NULL == receivedBytesPtr) || (NULL == durationMsPtr) ||
+        (NULL == throughputPtr))
+    {
+        LE_ERROR("Invalid parameter.");
+        return LE_BAD_PARAMETER;
+    }
+
+    durationMs = (uint64_t)DownloadStats.duration.sec * 1000 + DownloadStats.duration.usec / 1000;
+
+    *startPositionPtr = DownloadStats.startPosition;
+    *receivedBytesPtr = DownloadStats.receivedBytes;
+    *durationMsPtr = (durationMs > UINT32_MAX) ? UINT32_MAX : durationMs;
+    *throughputPtr = durationMs ? (uint32_t)((DownloadStats.receivedBytes * 1000) / durationMs) : 0;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -78,6 +400,12 @@ le_result_t le_fwupdate_InitDownload
     void
 )
 {
+    if (dualsys_IsSyncInProgress())
+    {
+        LE_ERROR("A synchronization of the systems is in progress");
+        return LE_BUSY;
+    }
+
     return pa_fwupdate_InitDownload();
 }
 
@@ -292,6 +620,12 @@ le_result_t le_fwupdate_Install
 {
     le_result_t result;
 
+    if (dualsys_IsSyncInProgress())
+    {
+        LE_ERROR("A synchronization of the systems is in progress");
+        return LE_BUSY;
+    }
+
     /* request system install */
     result = pa_fwupdate_Install(false);
 
@@ -323,6 +657,12 @@ le_result_t le_fwupdate_MarkGood
     void
 )
 {
+    if (dualsys_IsSyncInProgress())
+    {
+        LE_ERROR("A synchronization of the systems is in progress");
+        return LE_BUSY;
+    }
+
     le_result_t result = pa_fwupdate_MarkGood();
     LE_DEBUG ("result %d", result);
     return result;
@@ -351,6 +691,13 @@ le_result_t le_fwupdate_InstallAndMarkGood
 )
 {
     le_result_t result;
+
+    if (dualsys_IsSyncInProgress())
+    {
+        LE_ERROR("A synchronization of the systems is in progress");
+        return LE_BUSY;
+    }
+
     /* request the swap and sync */
     result = pa_fwupdate_Install(true);
     /* the previous function returns only if there has been an error */
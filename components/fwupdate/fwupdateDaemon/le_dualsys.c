@@ -9,6 +9,278 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_fwupdate.h"
+#include "dualsys.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of progress reports of an incremental synchronization (besides the last one, giving its
+ * result).
+ */
+//--------------------------------------------------------------------------------------------------
+#define SYNC_PROGRESS_STEPS     100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Progress of an incremental synchronization, as reported to the SyncProgress handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    checkedBlocks;  ///< Number of blocks compared so far.
+    uint32_t    copiedBlocks;   ///< Number of those blocks that differed, and were copied.
+    uint32_t    totalBlocks;    ///< Number of blocks of all the partitions to synchronize.
+    le_result_t result;         ///< LE_BUSY while in progress, then the result.
+}
+SyncProgress_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID of the progress reports of the incremental synchronizations.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t SyncProgressEventId = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread running the incremental synchronization, or NULL if none is in progress.  Only accessed
+ * by the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t SyncThreadRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main thread of the service, to which the synchronization thread hands back when it is done.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t MainThreadRef = NULL;
+
+
+//==================================================================================================
+//                                       Private Functions
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the event for the progress reports, on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitSync
+(
+    void
+)
+{
+    if (NULL == SyncProgressEventId)
+    {
+        SyncProgressEventId = le_event_CreateId("SyncProgress", sizeof(SyncProgress_t));
+        MainThreadRef = le_thread_GetCurrent();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare a block on the two systems, and copy it from the ACTIVE system to the UPDATE one if it
+ * differs.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_IO_ERROR if the block could not be read or written
+ *      - LE_FAULT on any other failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncBlock
+(
+    uint32_t partitionIndex,    ///< [IN] Index of the partition
+    uint32_t blockIndex,        ///< [IN] Index of the block in the partition
+    bool* isCopiedPtr           ///< [OUT] true if the block differed, and was copied
+)
+{
+    uint8_t activeDigest[PA_FWUPDATE_BLOCK_DIGEST_SIZE];
+    uint8_t updateDigest[PA_FWUPDATE_BLOCK_DIGEST_SIZE];
+    le_result_t result;
+
+    *isCopiedPtr = false;
+
+    result = pa_fwupdate_GetBlockDigest(partitionIndex, blockIndex, false, activeDigest);
+    if (LE_OK != result)
+    {
+        LE_ERROR("Unable to get the digest of active block %"PRIu32" of partition %"PRIu32": %s",
+                 blockIndex, partitionIndex, LE_RESULT_TXT(result));
+        return (LE_IO_ERROR == result) ? LE_IO_ERROR : LE_FAULT;
+    }
+
+    // If the block of the UPDATE system can't be read, it is rewritten anyway.
+    result = pa_fwupdate_GetBlockDigest(partitionIndex, blockIndex, true, updateDigest);
+    if ((LE_OK == result) && (0 == memcmp(activeDigest, updateDigest, sizeof(activeDigest))))
+    {
+        return LE_OK;
+    }
+
+    result = pa_fwupdate_CopyBlock(partitionIndex, blockIndex);
+    if (LE_OK != result)
+    {
+        LE_ERROR("Unable to copy block %"PRIu32" of partition %"PRIu32": %s",
+                 blockIndex, partitionIndex, LE_RESULT_TXT(result));
+        return (LE_IO_ERROR == result) ? LE_IO_ERROR : LE_FAULT;
+    }
+
+    *isCopiedPtr = true;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronize the UPDATE system with the ACTIVE one, block by block, reporting the progress.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_IO_ERROR if a block could not be read or written
+ *      - LE_FAULT on any other failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncSystems
+(
+    SyncProgress_t* progressPtr     ///< [IN/OUT] Progress of the synchronization
+)
+{
+    uint32_t partitionIndex;
+    uint32_t blockCount;
+    uint32_t blockIndex;
+    uint32_t reportedStep = 0;
+    le_result_t result;
+
+    // Count the blocks first, for the progress reports.
+    for (partitionIndex = 0;
+         LE_OK == (result = pa_fwupdate_GetSyncPartition(partitionIndex, &blockCount));
+         partitionIndex++)
+    {
+        progressPtr->totalBlocks += blockCount;
+    }
+    if (LE_OUT_OF_RANGE != result)
+    {
+        return LE_FAULT;
+    }
+
+    if (LE_OK != pa_fwupdate_SetState(PA_FWUPDATE_STATE_SYNC))
+    {
+        return LE_FAULT;
+    }
+
+    for (partitionIndex = 0;
+         LE_OK == pa_fwupdate_GetSyncPartition(partitionIndex, &blockCount);
+         partitionIndex++)
+    {
+        for (blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            bool isCopied;
+
+            result = SyncBlock(partitionIndex, blockIndex, &isCopied);
+            if (LE_OK != result)
+            {
+                // The systems are left in the synchronization state, i.e. not synchronized.
+                return result;
+            }
+
+            progressPtr->checkedBlocks++;
+            if (isCopied)
+            {
+                progressPtr->copiedBlocks++;
+            }
+
+            uint32_t step = (uint32_t)(((uint64_t)progressPtr->checkedBlocks * SYNC_PROGRESS_STEPS)
+                                       / progressPtr->totalBlocks);
+            if (step != reportedStep)
+            {
+                reportedStep = step;
+                le_event_Report(SyncProgressEventId, progressPtr, sizeof(*progressPtr));
+            }
+        }
+    }
+
+    LE_INFO("Systems synchronized: %"PRIu32" of %"PRIu32" blocks copied",
+            progressPtr->copiedBlocks, progressPtr->totalBlocks);
+
+    return (LE_OK == pa_fwupdate_SetState(PA_FWUPDATE_STATE_NORMAL)) ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the main thread when the synchronization thread is done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncDone
+(
+    void* param1Ptr,    ///< [IN] Unused
+    void* param2Ptr     ///< [IN] Unused
+)
+{
+    SyncThreadRef = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronization thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SyncThread
+(
+    void* contextPtr    ///< [IN] Unused
+)
+{
+    SyncProgress_t progress;
+
+    memset(&progress, 0, sizeof(progress));
+    progress.result = LE_BUSY;
+
+    progress.result = SyncSystems(&progress);
+
+    // The main thread forgets this thread before the last report is handled, so that a new
+    // synchronization can be started from the handlers.
+    le_event_QueueFunctionToThread(MainThreadRef, SyncDone, NULL, NULL);
+    le_event_Report(SyncProgressEventId, &progress, sizeof(progress));
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * First layer SyncProgress handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncProgressHandler
+(
+    void* reportPtr,        ///< [IN] Pointer to the event report payload.
+    void* secondLayerFunc   ///< [IN] Address of the second layer handler function.
+)
+{
+    le_dualsys_SyncProgressHandlerFunc_t clientHandlerFunc = secondLayerFunc;
+    SyncProgress_t* progressPtr = reportPtr;
+
+    clientHandlerFunc(progressPtr->checkedBlocks, progressPtr->copiedBlocks,
+                      progressPtr->totalBlocks, progressPtr->result, le_event_GetContextPtr());
+}
+
+
+//==================================================================================================
+//                                       Internal Functions
+//==================================================================================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if an incremental synchronization is in progress.  Operations writing to the flash must
+ * not be started while it is.
+ *
+ * @return true if a synchronization is in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+bool dualsys_IsSyncInProgress
+(
+    void
+)
+{
+    return (NULL != SyncThreadRef);
+}
 
 
 //==================================================================================================
@@ -111,3 +383,86 @@ le_result_t le_dualsys_GetCurrentSystem
     }
     return res;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an incremental synchronization of the UPDATE system with the ACTIVE one: only the blocks
+ * whose digests differ between the two systems are copied.
+ *
+ * The progress and the result are reported to the SyncProgress handlers.
+ *
+ * @return
+ *      - LE_OK            The synchronization is started
+ *      - LE_BUSY          A synchronization is already in progress
+ *      - LE_UNSUPPORTED   The feature is not supported
+ *      - LE_FAULT         On failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_dualsys_StartSync
+(
+    void
+)
+{
+    uint32_t blockCount;
+    le_result_t result;
+
+    if (dualsys_IsSyncInProgress())
+    {
+        return LE_BUSY;
+    }
+
+    result = pa_fwupdate_GetSyncPartition(0, &blockCount);
+    if ((LE_OK != result) && (LE_OUT_OF_RANGE != result))
+    {
+        return (LE_UNSUPPORTED == result) ? LE_UNSUPPORTED : LE_FAULT;
+    }
+
+    InitSync();
+
+    SyncThreadRef = le_thread_Create("DualSysSync", SyncThread, NULL);
+    le_thread_Start(SyncThreadRef);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler for the progress of the incremental synchronizations.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dualsys_SyncProgressHandlerRef_t le_dualsys_AddSyncProgressHandler
+(
+    le_dualsys_SyncProgressHandlerFunc_t handlerPtr,    ///< [IN] Handler pointer
+    void* contextPtr                                    ///< [IN] Associated context pointer
+)
+{
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("Handler pointer is NULL !");
+        return NULL;
+    }
+
+    InitSync();
+
+    le_event_HandlerRef_t handlerRef = le_event_AddLayeredHandler("SyncProgressHandler",
+                                                                  SyncProgressEventId,
+                                                                  SyncProgressHandler,
+                                                                  (void*)handlerPtr);
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_dualsys_SyncProgressHandlerRef_t)handlerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a handler for the progress of the incremental synchronizations.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dualsys_RemoveSyncProgressHandler
+(
+    le_dualsys_SyncProgressHandlerRef_t handlerRef  ///< [IN] Handler reference
+)
+{
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
@@ -436,5 +436,72 @@ LE_SHARED void pa_fwupdate_StopBadImageIndication
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the digests of the blocks compared by an incremental synchronization.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_FWUPDATE_BLOCK_DIGEST_SIZE   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of blocks of a partition to synchronize, for an incremental synchronization of
+ * the UPDATE system with the ACTIVE one.
+ *
+ * The partitions are enumerated by index, from 0, until LE_OUT_OF_RANGE is returned.
+ *
+ * @return
+ *      - LE_OK             on success
+ *      - LE_OUT_OF_RANGE   there is no partition of this index
+ *      - LE_UNSUPPORTED    the feature is not supported
+ *      - LE_FAULT          on failure
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_fwupdate_GetSyncPartition
+(
+    uint32_t partitionIndex,    ///< [IN] Index of the partition
+    uint32_t* blockCountPtr     ///< [OUT] Number of blocks of the partition
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the digest of a block of a partition to synchronize, on the ACTIVE or UPDATE system.
+ * The same block has the same digest on both systems if, and only if, it holds the same data.
+ *
+ * @return
+ *      - LE_OK             on success
+ *      - LE_BAD_PARAMETER  bad parameter
+ *      - LE_UNSUPPORTED    the feature is not supported
+ *      - LE_IO_ERROR       the block could not be read
+ *      - LE_FAULT          on failure
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_fwupdate_GetBlockDigest
+(
+    uint32_t partitionIndex,    ///< [IN] Index of the partition
+    uint32_t blockIndex,        ///< [IN] Index of the block in the partition
+    bool isUpdateSystem,        ///< [IN] true for the UPDATE system, false for the ACTIVE one
+    uint8_t* digestPtr          ///< [OUT] Digest, of PA_FWUPDATE_BLOCK_DIGEST_SIZE bytes
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a block of a partition to synchronize from the ACTIVE system to the UPDATE one.
+ *
+ * @return
+ *      - LE_OK             on success
+ *      - LE_BAD_PARAMETER  bad parameter
+ *      - LE_UNSUPPORTED    the feature is not supported
+ *      - LE_UNAVAILABLE    the flash access is not granted for SW update
+ *      - LE_IO_ERROR       the block could not be read or written
+ *      - LE_FAULT          on failure
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_fwupdate_CopyBlock
+(
+    uint32_t partitionIndex,    ///< [IN] Index of the partition
+    uint32_t blockIndex         ///< [IN] Index of the block in the partition
+);
+
 #endif // LEGATO_PA_FWUPDATE_INCLUDE_GUARD
 
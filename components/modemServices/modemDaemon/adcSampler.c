@@ -0,0 +1,662 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file adcSampler.c
+ *
+ * This file contains the source code of the ADC and temperature sampling API (see the Sampling
+ * section of the @ref c_adc).
+ *
+ * Each sampler has its own repeating timer, and reads all of its sources each time it expires.
+ * The values are then checked against the thresholds of their sources, and appended to the batch
+ * record being built, which is sent once it holds the number of cycles asked for.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_adc.h"
+#include "le_temp_local.h"
+#include "adcSampler.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the header of a batch record, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_HEADER_BYTES         4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the time stamp of a cycle in a batch record, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CYCLE_TIME_BYTES            8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value recorded when a source could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNKNOWN_VALUE               INT32_MIN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of samplers.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLER_DEFAULT_POOL_SIZE   4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampled source.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_adc_SourceType_t type;                               ///< Kind of source.
+    char                name[LE_ADC_SOURCE_NAME_MAX_BYTES]; ///< ADC channel or sensor name.
+    le_temp_SensorRef_t sensorRef;                          ///< Temperature sensor reference.
+    int32_t             lowThreshold;                       ///< Low threshold.
+    int32_t             highThreshold;                      ///< High threshold.
+    le_adc_Zone_t       zone;                               ///< Zone of the last value read.
+}
+Source_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_adc_SamplerRef_t             ref;                ///< Safe reference of the sampler.
+    le_msg_SessionRef_t             sessionRef;         ///< Session of the client.
+    le_timer_Ref_t                  timerRef;           ///< Sampling timer.
+    Source_t                        sources[LE_ADC_MAX_SAMPLED_SOURCES];    ///< Sources.
+    size_t                          numSources;         ///< Number of sources.
+    le_adc_ThresholdHandlerFunc_t   thresholdFunc;      ///< Threshold handler, or NULL.
+    void*                           thresholdCtxPtr;    ///< Threshold handler's context.
+    le_adc_BatchHandlerFunc_t       batchFunc;          ///< Batch handler, or NULL.
+    void*                           batchCtxPtr;        ///< Batch handler's context.
+    uint32_t                        batchCycles;        ///< Number of cycles per record.
+    uint16_t                        numCycles;          ///< Number of cycles in the record.
+    size_t                          recordSize;         ///< Size of the record, in bytes.
+    uint8_t                         record[LE_ADC_MAX_RECORD_BYTES];    ///< Record being built.
+}
+Sampler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for samplers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SamplerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference map of samplers.  The threshold and batch handler references given to the
+ * clients are the safe references of their samplers, since a sampler has at most one of each.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t SamplerRefMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store an unsigned integer in little-endian byte order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutUint
+(
+    uint8_t* bufPtr,                ///< [OUT] Where to store the integer.
+    uint64_t value,                 ///< [IN] Integer.
+    size_t numBytes                 ///< [IN] Size of the integer, in bytes.
+)
+{
+    size_t i;
+
+    for (i = 0; i < numBytes; i++)
+    {
+        bufPtr[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a sampler of the calling client.
+ *
+ * @return The sampler, or NULL if the reference is not one of the client's samplers.
+ */
+//--------------------------------------------------------------------------------------------------
+static Sampler_t* GetClientSampler
+(
+    le_adc_SamplerRef_t samplerRef  ///< [IN] Sampler reference.
+)
+{
+    Sampler_t* samplerPtr = le_ref_Lookup(SamplerRefMap, samplerRef);
+
+    if ((samplerPtr == NULL) || (samplerPtr->sessionRef != le_adc_GetClientSessionRef()))
+    {
+        return NULL;
+    }
+
+    return samplerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the value of a source.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - Anything else if the value could not be read
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadSource
+(
+    Source_t* sourcePtr,            ///< [IN] Source.
+    int32_t* valuePtr               ///< [OUT] Value.
+)
+{
+    if (sourcePtr->type == LE_ADC_SOURCE_TEMP)
+    {
+        return le_temp_GetTemperature(sourcePtr->sensorRef, valuePtr);
+    }
+
+    return pa_adc_ReadValue(sourcePtr->name, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling timer handler.  Reads all the sources of a sampler, then reports the threshold
+ * crossings and adds a cycle to the batch record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerHandler
+(
+    le_timer_Ref_t timerRef         ///< [IN] Sampling timer.
+)
+{
+    Sampler_t* samplerPtr = le_ref_Lookup(SamplerRefMap, le_timer_GetContextPtr(timerRef));
+    int32_t values[LE_ADC_MAX_SAMPLED_SOURCES];
+    size_t i;
+
+    if (samplerPtr == NULL)
+    {
+        LE_ERROR("Sampling timer of a deleted sampler.");
+        return;
+    }
+
+    // Read everything first, so that the values of a cycle are as close in time as possible.
+    for (i = 0; i < samplerPtr->numSources; i++)
+    {
+        if (ReadSource(&samplerPtr->sources[i], &values[i]) != LE_OK)
+        {
+            values[i] = UNKNOWN_VALUE;
+        }
+    }
+
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    for (i = 0; i < samplerPtr->numSources; i++)
+    {
+        Source_t* sourcePtr = &samplerPtr->sources[i];
+
+        if (values[i] == UNKNOWN_VALUE)
+        {
+            continue;
+        }
+
+        le_adc_Zone_t zone = LE_ADC_ZONE_NORMAL;
+
+        if (values[i] < sourcePtr->lowThreshold)
+        {
+            zone = LE_ADC_ZONE_LOW;
+        }
+        else if (values[i] > sourcePtr->highThreshold)
+        {
+            zone = LE_ADC_ZONE_HIGH;
+        }
+
+        if (zone != sourcePtr->zone)
+        {
+            sourcePtr->zone = zone;
+
+            if (samplerPtr->thresholdFunc != NULL)
+            {
+                samplerPtr->thresholdFunc((uint8_t)i, values[i], zone,
+                                          samplerPtr->thresholdCtxPtr);
+            }
+        }
+    }
+
+    if (samplerPtr->batchFunc == NULL)
+    {
+        return;
+    }
+
+    if (samplerPtr->numCycles == 0)
+    {
+        samplerPtr->record[0] = LE_ADC_RECORD_VERSION;
+        samplerPtr->record[1] = (uint8_t)samplerPtr->numSources;
+        samplerPtr->recordSize = RECORD_HEADER_BYTES;
+    }
+
+    uint8_t* cyclePtr = samplerPtr->record + samplerPtr->recordSize;
+
+    PutUint(cyclePtr, (uint64_t)now.sec * 1000 + now.usec / 1000, CYCLE_TIME_BYTES);
+    for (i = 0; i < samplerPtr->numSources; i++)
+    {
+        PutUint(cyclePtr + CYCLE_TIME_BYTES + i * sizeof(int32_t),
+                (uint32_t)values[i],
+                sizeof(int32_t));
+    }
+    samplerPtr->recordSize += CYCLE_TIME_BYTES + samplerPtr->numSources * sizeof(int32_t);
+    samplerPtr->numCycles++;
+
+    if (samplerPtr->numCycles >= samplerPtr->batchCycles)
+    {
+        PutUint(samplerPtr->record + 2, samplerPtr->numCycles, sizeof(uint16_t));
+        samplerPtr->numCycles = 0;
+
+        samplerPtr->batchFunc(samplerPtr->record, samplerPtr->recordSize,
+                              samplerPtr->batchCtxPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteSampler
+(
+    Sampler_t* samplerPtr           ///< [IN] Sampler.
+)
+{
+    size_t i;
+
+    for (i = 0; i < samplerPtr->numSources; i++)
+    {
+        if (samplerPtr->sources[i].sensorRef != NULL)
+        {
+            le_temp_ReleaseSensor(samplerPtr->sources[i].sensorRef);
+        }
+    }
+
+    le_ref_DeleteRef(SamplerRefMap, samplerPtr->ref);
+    le_timer_Delete(samplerPtr->timerRef);
+    le_mem_Release(samplerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the samplers of a client that has disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session reference of the client.
+    void*               contextPtr  ///< [IN] Not used.
+)
+{
+    le_ref_IterRef_t iter = le_ref_GetIterator(SamplerRefMap);
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        Sampler_t* samplerPtr = (Sampler_t*)le_ref_GetValue(iter);
+
+        LE_ASSERT(samplerPtr != NULL);
+
+        if (samplerPtr->sessionRef == sessionRef)
+        {
+            DeleteSampler(samplerPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the ADC sampling.
+ */
+//--------------------------------------------------------------------------------------------------
+void adcSampler_Init
+(
+    void
+)
+{
+    SamplerPool = le_mem_CreatePool("AdcSamplerPool", sizeof(Sampler_t));
+    le_mem_ExpandPool(SamplerPool, SAMPLER_DEFAULT_POOL_SIZE);
+
+    SamplerRefMap = le_ref_CreateMap("AdcSamplerMap", SAMPLER_DEFAULT_POOL_SIZE);
+
+    le_msg_AddServiceCloseHandler(le_adc_GetServiceRef(), CloseSessionEventHandler, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a sampler.
+ *
+ * @return Reference to the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_adc_SamplerRef_t le_adc_CreateSampler
+(
+    uint32_t periodMs               ///< [IN] Sampling period, in milliseconds.
+)
+{
+    if (periodMs < LE_ADC_MIN_SAMPLING_PERIOD_MS)
+    {
+        LE_WARN("Sampling period of %" PRIu32 " ms rounded up to %d ms.",
+                periodMs, LE_ADC_MIN_SAMPLING_PERIOD_MS);
+        periodMs = LE_ADC_MIN_SAMPLING_PERIOD_MS;
+    }
+
+    Sampler_t* samplerPtr = le_mem_ForceAlloc(SamplerPool);
+
+    memset(samplerPtr, 0, sizeof(*samplerPtr));
+    samplerPtr->sessionRef = le_adc_GetClientSessionRef();
+    samplerPtr->ref = le_ref_CreateRef(SamplerRefMap, samplerPtr);
+
+    samplerPtr->timerRef = le_timer_Create("AdcSampler");
+    LE_ASSERT(le_timer_SetMsInterval(samplerPtr->timerRef, periodMs) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(samplerPtr->timerRef, 0) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(samplerPtr->timerRef, SampleTimerHandler) == LE_OK);
+    LE_ASSERT(le_timer_SetContextPtr(samplerPtr->timerRef, samplerPtr->ref) == LE_OK);
+
+    return samplerPtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a source to a sampler.  Sources can't be added once the sampler is started.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_NOT_FOUND     The temperature sensor doesn't exist on this platform.
+ *      - LE_OVERFLOW      The sampler already has LE_ADC_MAX_SAMPLED_SOURCES sources.
+ *      - LE_BUSY          The sampler is started.
+ *      - LE_BAD_PARAMETER The low threshold is above the high threshold.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_adc_AddSource
+(
+    le_adc_SamplerRef_t samplerRef, ///< [IN] Sampler.
+    le_adc_SourceType_t type,       ///< [IN] Kind of source.
+    const char* namePtr,            ///< [IN] Name of the ADC channel or sensor.
+    int32_t lowThreshold,           ///< [IN] Low threshold.
+    int32_t highThreshold           ///< [IN] High threshold.
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler(samplerRef);
+
+    if (samplerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid sampler reference (%p) provided!", samplerRef);
+        return LE_FAULT;
+    }
+
+    if (le_timer_IsRunning(samplerPtr->timerRef))
+    {
+        return LE_BUSY;
+    }
+
+    if (samplerPtr->numSources >= LE_ADC_MAX_SAMPLED_SOURCES)
+    {
+        return LE_OVERFLOW;
+    }
+
+    if (lowThreshold > highThreshold)
+    {
+        LE_ERROR("Low threshold %" PRId32 " is above high threshold %" PRId32,
+                 lowThreshold, highThreshold);
+        return LE_BAD_PARAMETER;
+    }
+
+    Source_t* sourcePtr = &samplerPtr->sources[samplerPtr->numSources];
+
+    if (le_utf8_Copy(sourcePtr->name, namePtr, sizeof(sourcePtr->name), NULL) != LE_OK)
+    {
+        LE_KILL_CLIENT("Source name is too long.");
+        return LE_FAULT;
+    }
+
+    switch (type)
+    {
+        case LE_ADC_SOURCE_ADC:
+            sourcePtr->sensorRef = NULL;
+            break;
+
+        case LE_ADC_SOURCE_TEMP:
+            sourcePtr->sensorRef = le_temp_AcquireSensor(namePtr);
+            if (sourcePtr->sensorRef == NULL)
+            {
+                LE_ERROR("Temperature sensor '%s' not found.", namePtr);
+                return LE_NOT_FOUND;
+            }
+            break;
+
+        default:
+            LE_KILL_CLIENT("Invalid source type %d.", type);
+            return LE_FAULT;
+    }
+
+    sourcePtr->type = type;
+    sourcePtr->lowThreshold = lowThreshold;
+    sourcePtr->highThreshold = highThreshold;
+    sourcePtr->zone = LE_ADC_ZONE_NORMAL;
+    samplerPtr->numSources++;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start sampling.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_BUSY          The sampler is already started.
+ *      - LE_FAULT         The sampler has no source.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_adc_StartSampler
+(
+    le_adc_SamplerRef_t samplerRef  ///< [IN] Sampler.
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler(samplerRef);
+
+    if (samplerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid sampler reference (%p) provided!", samplerRef);
+        return LE_FAULT;
+    }
+
+    if (le_timer_IsRunning(samplerPtr->timerRef))
+    {
+        return LE_BUSY;
+    }
+
+    if (samplerPtr->numSources == 0)
+    {
+        LE_ERROR("Sampler has no source.");
+        return LE_FAULT;
+    }
+
+    // Now that the number of sources is known, make sure the records fit.
+    uint32_t maxCycles = (LE_ADC_MAX_RECORD_BYTES - RECORD_HEADER_BYTES)
+                         / (CYCLE_TIME_BYTES + samplerPtr->numSources * sizeof(int32_t));
+
+    if (samplerPtr->batchCycles > maxCycles)
+    {
+        LE_WARN("Batch of %" PRIu32 " cycles reduced to %" PRIu32 ".",
+                samplerPtr->batchCycles, maxCycles);
+        samplerPtr->batchCycles = maxCycles;
+    }
+
+    samplerPtr->numCycles = 0;
+
+    LE_ASSERT(le_timer_Start(samplerPtr->timerRef) == LE_OK);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop sampling and delete a sampler, along with its handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_DeleteSampler
+(
+    le_adc_SamplerRef_t samplerRef  ///< [IN] Sampler.
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler(samplerRef);
+
+    if (samplerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid sampler reference (%p) provided!", samplerRef);
+        return;
+    }
+
+    DeleteSampler(samplerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_adc_Threshold'
+ *
+ * Threshold crossings of the sources of a sampler.  A sampler has at most one threshold handler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_adc_ThresholdHandlerRef_t le_adc_AddThresholdHandler
+(
+    le_adc_SamplerRef_t samplerRef,
+        ///< [IN] Sampler.
+
+    le_adc_ThresholdHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler(samplerRef);
+
+    if ((samplerPtr == NULL) || (handlerPtr == NULL))
+    {
+        LE_KILL_CLIENT("Invalid sampler reference (%p) or NULL handler!", samplerRef);
+        return NULL;
+    }
+
+    if (samplerPtr->thresholdFunc != NULL)
+    {
+        LE_ERROR("Sampler %p already has a threshold handler.", samplerRef);
+        return NULL;
+    }
+
+    samplerPtr->thresholdFunc = handlerPtr;
+    samplerPtr->thresholdCtxPtr = contextPtr;
+
+    return (le_adc_ThresholdHandlerRef_t)samplerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_adc_Threshold'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_RemoveThresholdHandler
+(
+    le_adc_ThresholdHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler((le_adc_SamplerRef_t)handlerRef);
+
+    if (samplerPtr == NULL)
+    {
+        LE_ERROR("Invalid threshold handler reference %p.", handlerRef);
+        return;
+    }
+
+    samplerPtr->thresholdFunc = NULL;
+    samplerPtr->thresholdCtxPtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_adc_Batch'
+ *
+ * Batch records of the values of a sampler.  A sampler has at most one batch handler, which must
+ * be added before the sampler is started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_adc_BatchHandlerRef_t le_adc_AddBatchHandler
+(
+    le_adc_SamplerRef_t samplerRef,
+        ///< [IN] Sampler.
+
+    uint32_t numCycles,
+        ///< [IN] Number of sampling cycles per record.
+
+    le_adc_BatchHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler(samplerRef);
+
+    if ((samplerPtr == NULL) || (handlerPtr == NULL))
+    {
+        LE_KILL_CLIENT("Invalid sampler reference (%p) or NULL handler!", samplerRef);
+        return NULL;
+    }
+
+    if (samplerPtr->batchFunc != NULL)
+    {
+        LE_ERROR("Sampler %p already has a batch handler.", samplerRef);
+        return NULL;
+    }
+
+    if (le_timer_IsRunning(samplerPtr->timerRef))
+    {
+        LE_ERROR("Sampler %p is started.", samplerRef);
+        return NULL;
+    }
+
+    samplerPtr->batchFunc = handlerPtr;
+    samplerPtr->batchCtxPtr = contextPtr;
+    samplerPtr->batchCycles = (numCycles == 0) ? 1 : numCycles;
+    samplerPtr->numCycles = 0;
+
+    return (le_adc_BatchHandlerRef_t)samplerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_adc_Batch'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_RemoveBatchHandler
+(
+    le_adc_BatchHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    Sampler_t* samplerPtr = GetClientSampler((le_adc_SamplerRef_t)handlerRef);
+
+    if (samplerPtr == NULL)
+    {
+        LE_ERROR("Invalid batch handler reference %p.", handlerRef);
+        return;
+    }
+
+    // The cycles already in the record are dropped.
+    samplerPtr->batchFunc = NULL;
+    samplerPtr->batchCtxPtr = NULL;
+    samplerPtr->numCycles = 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file adcSampler.h
+ *
+ * ADC and temperature sampling, provided through the le_adc API.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_ADC_SAMPLER_INCLUDE_GUARD
+#define LEGATO_ADC_SAMPLER_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the ADC sampling.
+ */
+//--------------------------------------------------------------------------------------------------
+void adcSampler_Init
+(
+    void
+);
+
+#endif // LEGATO_ADC_SAMPLER_INCLUDE_GUARD
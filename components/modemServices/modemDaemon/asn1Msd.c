@@ -92,116 +92,333 @@ static int8_t GetAsciiCode
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function insert an 'up to 8-bit' element in the MSD message
+ * Maximum size of an encoded MSD message (and of the ERA-GLONASS optional data), in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_MAX_BYTES   140
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit writer.
  *
- * @return the updated offset after the element insertion
+ * Bits are shifted into a 64-bit accumulator, most significant bit first, and written out a whole
+ * byte at a time.  Bytes that don't fit in the output buffer are dropped, but still counted in the
+ * offset, so that an overlong message can be detected once it's been encoded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t acc;       ///< Bits that haven't been written out yet (in the low numBits bits).
+    uint32_t numBits;   ///< Number of bits in the accumulator (always less than 8 between calls).
+    uint32_t offset;    ///< Total number of bits put so far.
+    uint8_t* outPtr;    ///< Where the next byte goes.
+    uint8_t* endPtr;    ///< End of the output buffer.
+}
+BitWriter_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field made of a presence flag followed, later in the message, by a value flag.  The offsets are
+ * relative to the structure holding both flags.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t presentOffset;     ///< Offset of the presence flag.
+    uint16_t valueOffset;       ///< Offset of the value flag.
+}
+FlagField_t;
+
+#define FLAG_FIELD(type, present, value)   { offsetof(type, present), offsetof(type, value) }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the vehicle propulsion storage type.  Every flag is its own presence flag: all of the
+ * flags are put first, then a 'true' for each one that is set.  The last one only exists in MSD
+ * version 2.
+ */
+//--------------------------------------------------------------------------------------------------
+static const FlagField_t PropulsionFields[] =
+{
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, gasolineTankPresent, gasolineTankPresent),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, dieselTankPresent, dieselTankPresent),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, compressedNaturalGas, compressedNaturalGas),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, liquidPropaneGas, liquidPropaneGas),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, electricEnergyStorage, electricEnergyStorage),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, hydrogenStorage, hydrogenStorage),
+    FLAG_FIELD(msd_VehiclePropulsionStorageType_t, otherStorage, otherStorage),
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the ERA-GLONASS diagnostic result.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIAG_FIELD(name, value) \
+    FLAG_FIELD(msd_EraGlonassData_t, diagnosticResult.name, diagnosticResult.value)
+
+static const FlagField_t DiagnosticFields[] =
+{
+    DIAG_FIELD(presentMicConnectionFailure, micConnectionFailure),
+    DIAG_FIELD(presentMicFailure, micFailure),
+    DIAG_FIELD(presentRightSpeakerFailure, rightSpeakerFailure),
+    DIAG_FIELD(presentLeftSpeakerFailure, leftSpeakerFailure),
+    DIAG_FIELD(presentSpeakersFailure, speakersFailure),
+    DIAG_FIELD(presentIgnitionLineFailure, ignitionLineFailure),
+    DIAG_FIELD(presentUimFailure, uimFailure),
+    DIAG_FIELD(presentStatusIndicatorFailure, statusIndicatorFailure),
+    DIAG_FIELD(presentBatteryFailure, batteryFailure),
+    DIAG_FIELD(presentBatteryVoltageLow, batteryVoltageLow),
+    DIAG_FIELD(presentCrashSensorFailure, crashSensorFailure),
+    DIAG_FIELD(presentFirmwareImageCorruption, firmwareImageCorruption),
+    DIAG_FIELD(presentCommModuleInterfaceFailure, commModuleInterfaceFailure),
+    DIAG_FIELD(presentGnssReceiverFailure, gnssReceiverFailure),
+    DIAG_FIELD(presentRaimProblem, raimProblem),
+    DIAG_FIELD(presentGnssAntennaFailure, gnssAntennaFailure),
+    DIAG_FIELD(presentCommModuleFailure, commModuleFailure),
+    DIAG_FIELD(presentEventsMemoryOverflow, eventsMemoryOverflow),
+    DIAG_FIELD(presentCrashProfileMemoryOverflow, crashProfileMemoryOverflow),
+    DIAG_FIELD(presentOtherCriticalFailures, otherCriticalFailures),
+    DIAG_FIELD(presentOtherNotCriticalFailures, otherNotCriticalFailures),
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the ERA-GLONASS crash type.
  */
 //--------------------------------------------------------------------------------------------------
-static uint16_t PutBits
+#define CRASH_FIELD(name, value) \
+    FLAG_FIELD(msd_EraGlonassData_t, crashType.name, crashType.value)
+
+static const FlagField_t CrashTypeFields[] =
+{
+    CRASH_FIELD(presentCrashFront, crashFront),
+    CRASH_FIELD(presentCrashLeft, crashLeft),
+    CRASH_FIELD(presentCrashRight, crashRight),
+    CRASH_FIELD(presentCrashRear, crashRear),
+    CRASH_FIELD(presentCrashRollover, crashRollover),
+    CRASH_FIELD(presentCrashSide, crashSide),
+    CRASH_FIELD(presentCrashFrontOrSide, crashFrontOrSide),
+    CRASH_FIELD(presentCrashAnotherType, crashAnotherType),
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing bits to a buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartBits
 (
-    uint16_t msgOffset,   ///< [IN] Element position in the MSD message
-    uint16_t elmtLen,     ///< [IN] Element length in bits
-    uint8_t* elmtPtr,     ///< [IN] Pointer to the element to insert
-    uint8_t* msgPtr       ///< [OUT] updated MSD message with the new element
+    BitWriter_t* writerPtr,     ///< [OUT] Bit writer
+    uint8_t*     bufPtr,        ///< [IN] Output buffer
+    size_t       bufSize        ///< [IN] Size of the output buffer, in bytes
 )
 {
-    register uint8_t elmtPos;
-    register uint8_t msgPos;
-    register uint8_t val;
-    register int8_t shift;
-    uint8_t mask;
-    uint16_t i ;
-    uint8_t bitMask [8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
-
-    msgPos = (msgOffset & 0x07);      /* Modulus 8      */
-    msgPtr += msgOffset >> 3;         /* integral div 8 */
-    elmtPos  = 8 - ((elmtLen & 0x07) ? elmtLen & 0x07 : (elmtLen & 0x07) + 8);
-
-    for (i = 0 ; i < elmtLen ; i++)
-    {
-        val = (*elmtPtr) &  bitMask [elmtPos];
-        mask = bitMask [elmtPos];
-        shift = msgPos - elmtPos;
-        if (shift >= 0)
-        {
-            val >>= shift;
-            mask >>= shift;
-        }
-        else
+    writerPtr->acc = 0;
+    writerPtr->numBits = 0;
+    writerPtr->offset = 0;
+    writerPtr->outPtr = bufPtr;
+    writerPtr->endPtr = bufPtr + bufSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put the low bits of a value, most significant bit first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void PutBits
+(
+    BitWriter_t* writerPtr,     ///< [IN] Bit writer
+    uint32_t     value,         ///< [IN] Value to put
+    uint32_t     len            ///< [IN] Number of bits to put (1 to 32)
+)
+{
+    writerPtr->acc = (writerPtr->acc << len) | (value & (uint32_t)((1ULL << len) - 1));
+    writerPtr->numBits += len;
+    writerPtr->offset += len;
+
+    while (writerPtr->numBits >= 8)
+    {
+        writerPtr->numBits -= 8;
+
+        if (writerPtr->outPtr < writerPtr->endPtr)
         {
-            val <<= (- shift);
-            mask <<= (-shift);
+            *writerPtr->outPtr = (uint8_t)(writerPtr->acc >> writerPtr->numBits);
         }
-        *msgPtr &= ~mask;
-        *msgPtr |= val;
-        elmtPos++;
-        msgPos++;
-        if (elmtPos > 7) /* byte change in elmtPtr */
+        writerPtr->outPtr++;
+    }
+
+    writerPtr->acc &= (1U << writerPtr->numBits) - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put bits copied from a buffer (as written by another bit writer).
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutBitString
+(
+    BitWriter_t*   writerPtr,   ///< [IN] Bit writer
+    const uint8_t* bitsPtr,     ///< [IN] Bits, most significant bit of the first byte first
+    uint32_t       numBits      ///< [IN] Number of bits to put
+)
+{
+    for (; numBits >= 8; numBits -= 8)
+    {
+        PutBits(writerPtr, *bitsPtr++, 8);
+    }
+
+    if (numBits > 0)
+    {
+        PutBits(writerPtr, *bitsPtr >> (8 - numBits), numBits);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put the presence flags of a table of fields, then the value flags of the present ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutFlagFields
+(
+    BitWriter_t*       writerPtr,   ///< [IN] Bit writer
+    const void*        structPtr,   ///< [IN] Structure holding the flags
+    const FlagField_t* fieldsPtr,   ///< [IN] Layout of the fields
+    size_t             numFields    ///< [IN] Number of fields
+)
+{
+    const uint8_t* basePtr = structPtr;
+    size_t i;
+
+    for (i = 0; i < numFields; i++)
+    {
+        PutBits(writerPtr, *(const bool*)(basePtr + fieldsPtr[i].presentOffset), 1);
+    }
+
+    for (i = 0; i < numFields; i++)
+    {
+        if (*(const bool*)(basePtr + fieldsPtr[i].presentOffset))
         {
-            elmtPtr++;
-            elmtPos = 0;
+            PutBits(writerPtr, *(const bool*)(basePtr + fieldsPtr[i].valueOffset), 1);
         }
-        if (msgPos > 7) /* byte change in elmtPtr */
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pad the last byte with zeros and write it out.
+ *
+ * @return the number of bytes taken by the bits put
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FlushBits
+(
+    BitWriter_t* writerPtr      ///< [IN] Bit writer
+)
+{
+    if (writerPtr->numBits > 0)
+    {
+        uint32_t padBits = 8 - writerPtr->numBits;
+
+        PutBits(writerPtr, 0, padBits);
+        writerPtr->offset -= padBits;
+    }
+
+    return (writerPtr->offset + 7) / 8;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function puts the part of the MSD message that only depends on the vehicle: the vehicle
+ * type, the VIN and the propulsion storage type.
+ *
+ * @return LE_OK on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PutStaticPart
+(
+    BitWriter_t* writerPtr,     ///< [IN] Bit writer
+    msd_t*       msdDataPtr     ///< [IN] MSD data
+)
+{
+    const msd_Vin_t* vinPtr = &msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber;
+    const char* vinCharsPtr = (const char*)vinPtr;
+    int i;
+
+    /* vehType : Only enumerated values are supported : no extension*/
+    PutBits(writerPtr, 0, 1); /* extension bit */
+    PutBits(writerPtr, msdDataPtr->msdMsg.msdStruct.control.vehType - 1, 4);
+
+    /* Vehicle identification Number */
+    if (!IsVinValid(*vinPtr))
+    {
+        LE_ERROR("Cannot encode Vehicle Identification Number!");
+        return LE_FAULT;
+    }
+
+    /* Each character is coded within 6 bits according to translation table */
+    for (i = 0; i < sizeof(msd_Vin_t); i++)
+    {
+        int8_t tmp = GetAsciiCode(vinCharsPtr[i]);
+        /* check if character is authorized */
+        if (tmp < 0)
         {
-            msgPtr++;
-            msgPos = 0;
+            LE_ERROR("Unable to get ASCII code for VIN character %d", i);
+            return LE_FAULT;
         }
+        PutBits(writerPtr, tmp, 6);
     }
 
-    return (msgOffset + elmtLen);
+    /* VehiclePropulsionStorageType */
+    /* Extension bit */
+    PutBits(writerPtr, 0, 1);
+
+    PutFlagFields(writerPtr,
+                  &msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType,
+                  PropulsionFields,
+                  NUM_ARRAY_MEMBERS(PropulsionFields) - ((msdDataPtr->version == 2) ? 0 : 1));
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function insert an 'up to 2-byte' element in the MSD message
+ * This function checks whether a pre-encoded static part can be used for an MSD message, i.e.
+ * whether it was encoded from the same MSD version, vehicle type, VIN and propulsion storage type.
  *
- * @return the updated offset after the element insertion
+ * @return true if it can be used, false otherwise.
  */
 //--------------------------------------------------------------------------------------------------
-static uint16_t PutTwoBytes
+static bool IsStaticPartUpToDate
 (
-    uint16_t  msgOffset,   ///< [IN] Element position in the MSD message
-    uint16_t  elmtLen,     ///< [IN] Element length in bits
-    uint16_t* elmtPtr,     ///< [IN] Pointer to the element to insert
-    uint8_t*  msgPtr       ///< [OUT] updated MSD message with the new element
+    const msd_StaticPart_t* staticPartPtr,  ///< [IN] Pre-encoded static part
+    const msd_t*            msdDataPtr      ///< [IN] MSD data
 )
 {
-   uint16_t  msgOffsetCurrent = msgOffset;
-   uint8_t n;
-   uint16_t setBit[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
-                           0x100, 0x200, 0x400, 0x800, 0x1000, 0x2000, 0x4000, 0x8000 };
-
-   for( n = 0; n < elmtLen; n++ )
-   {
-      if( *(elmtPtr) & setBit[elmtLen-1-n] )
-      {
-         msgPtr[ (msgOffsetCurrent>>3) ] |= 0x01<<(7-( msgOffsetCurrent&0x07 ));
-      }
-      else
-      {
-         msgPtr[ (msgOffsetCurrent>>3) ] &=~( 0x01<<(7-( msgOffsetCurrent&0x07 )));
-      }
-      msgOffsetCurrent++;
-   }
-
-   return (msgOffset + elmtLen);
+    const msd_Structure_t* structPtr = &msdDataPtr->msdMsg.msdStruct;
+
+    return (staticPartPtr != NULL) &&
+           staticPartPtr->isValid &&
+           (staticPartPtr->version == msdDataPtr->version) &&
+           (staticPartPtr->vehType == structPtr->control.vehType) &&
+           (memcmp(&staticPartPtr->vin,
+                   &structPtr->vehIdentificationNumber,
+                   sizeof(staticPartPtr->vin)) == 0) &&
+           (memcmp(&staticPartPtr->propulsion,
+                   &structPtr->vehPropulsionStorageType,
+                   sizeof(staticPartPtr->propulsion)) == 0);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * This function encodes the MSD message optional data from the elements of the MSD data structure
- *
- * @return the MSD message optional data length in bits on success
- * @return LE_FAULT on failure
- *
- * @note Only MSD version 1 is supported.
  */
 //--------------------------------------------------------------------------------------------------
-static int32_t msd_EncodeMsdMessageOptionalData
+static void msd_EncodeMsdMessageOptionalData
 (
-    uint16_t    offset,     ///< [IN] offset of encoded MSD message
-    msd_t*      msdDataPtr, ///< [IN] MSD data
-    uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
+    BitWriter_t* writerPtr,     ///< [IN] Bit writer
+    msd_t*       msdDataPtr     ///< [IN] MSD data
 )
 {
     int i;
@@ -230,63 +447,99 @@ static int32_t msd_EncodeMsdMessageOptionalData
         }
     }
     // Put updated OID length value
-    offset = PutBits(offset, 8, &oidLength, outDataPtr);
+    PutBits(writerPtr, oidLength, 8);
 
     /* Put OID value */
     for(i=0; i<length; i++)
     {
+        uint8_t oid = msdDataPtr->msdMsg.optionalData.oid[i];
+
         // OID encoded thru 7 bits: additional Bytes added for OID value(s) greater than 127
-        if ( msdDataPtr->msdMsg.optionalData.oid[i] > 127 )
+        if ( oid > 127 )
         {
-            uint8_t oidFirstByte=0x00;
-            uint8_t oidSecondByte=0x00;
-            // OID b7 -> OID first Byte b0
-            oidFirstByte = (msdDataPtr->msdMsg.optionalData.oid[i] >> 7)& 0x01;
-            // OID first Byte: b7 set to 1
-            oidFirstByte |= 0x80;
+            // OID b7 -> OID first Byte b0, with b7 set to 1
+            PutBits(writerPtr, 0x80 | ((oid >> 7) & 0x01), 8);
             // OID b6-b0 -> OID second Byte b6-b0
-            oidSecondByte = msdDataPtr->msdMsg.optionalData.oid[i] & 0x7F;
-            offset = PutBits(offset, 8, (uint8_t*)&oidFirstByte, outDataPtr);
-            offset = PutBits(offset, 8, (uint8_t*)&oidSecondByte, outDataPtr);
-        } else
+            PutBits(writerPtr, oid & 0x7F, 8);
+        }
+        else
         {
-            offset = PutBits(offset, 8, &msdDataPtr->msdMsg.optionalData.oid[i], outDataPtr);
+            PutBits(writerPtr, oid, 8);
         }
     }
 
     /* Put optional data to MSD message */
     length = msdDataPtr->msdMsg.optionalData.dataLen;
-    offset = PutBits(offset, 8, &length, outDataPtr);
+    PutBits(writerPtr, length, 8);
     for(i=0; i<length; i++)
     {
-        offset = PutBits(offset, 8, &optionalDataPtr[i], outDataPtr);
+        PutBits(writerPtr, optionalDataPtr[i], 8);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function pre-encodes the part of the MSD message that only depends on the vehicle
+ * configuration (vehicle type, VIN and propulsion storage type), so that it doesn't have to be
+ * encoded again every time an MSD is built.
+ *
+ * @return LE_OK on success
+ * @return LE_FAULT on failure (the static part is then marked as not valid)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msd_EncodeStaticPart
+(
+    msd_t*            msdDataPtr,       ///< [IN] MSD data
+    msd_StaticPart_t* staticPartPtr     ///< [OUT] pre-encoded static part
+)
+{
+    BitWriter_t writer;
+
+    staticPartPtr->isValid = false;
+
+    if ((msdDataPtr->version != 1) && (msdDataPtr->version != 2))
+    {
+        LE_ERROR("MSD version %d not supported", msdDataPtr->version);
+        return LE_FAULT;
     }
 
-    return offset;
+    StartBits(&writer, staticPartPtr->data, sizeof(staticPartPtr->data));
+
+    if (PutStaticPart(&writer, msdDataPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    FlushBits(&writer);
+
+    staticPartPtr->numBits = writer.offset;
+    staticPartPtr->version = msdDataPtr->version;
+    staticPartPtr->vehType = msdDataPtr->msdMsg.msdStruct.control.vehType;
+    staticPartPtr->vin = msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber;
+    staticPartPtr->propulsion = msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType;
+    staticPartPtr->isValid = true;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function encodes the MSD message from the elements of the MSD data structure
+ * This function encodes the MSD message from the elements of the MSD data structure, using a
+ * pre-encoded static part if it is still up to date.
  *
  * @return the MSD message length in bytes on success
  * @return LE_FAULT on failure
- *
- * @note Only MSD version 1 is supported.
  */
 //--------------------------------------------------------------------------------------------------
-int32_t msd_EncodeMsdMessage
+int32_t msd_EncodeMsdMessageWithStaticPart
 (
-    msd_t*      msdDataPtr, ///< [IN] MSD data
-    uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
+    msd_t*                  msdDataPtr,     ///< [IN] MSD data
+    const msd_StaticPart_t* staticPartPtr,  ///< [IN] pre-encoded static part (can be NULL)
+    uint8_t*                outDataPtr      ///< [OUT] encoded MSD message
 )
 {
-    uint8_t off = 0;
-    uint16_t offset=0;
-    int i;
-    uint16_t offsetV2=0;
-    uint8_t *outDataV2Ptr;
-
+    msd_Structure_t* structPtr = &msdDataPtr->msdMsg.msdStruct;
+    BitWriter_t writer;
 
     /* MSD Format */
     if ((msdDataPtr->version != 1)&&(msdDataPtr->version != 2))
@@ -294,364 +547,199 @@ int32_t msd_EncodeMsdMessage
         LE_ERROR("MSD version %d not supported", msdDataPtr->version);
         return LE_FAULT;
     }
-    offset = PutBits(offset, 8, &msdDataPtr->version, outDataPtr);
 
-    /* MSD structure size field for MSD V2 coding (left empty and compute at the end) */
-    offsetV2 = offset;
-    outDataV2Ptr = outDataPtr;
+    StartBits(&writer, outDataPtr, MSD_MAX_BYTES);
+
+    PutBits(&writer, msdDataPtr->version, 8);
+
+    /* MSD structure size field for MSD V2 coding (left empty and filled in at the end) */
     if (msdDataPtr->version == 2)
     {
-       /* Length for MSD structure */
-       offset = PutBits(offset, 8, &off, outDataPtr);
+       PutBits(&writer, 0, 8);
     }
 
     /* Extension bit */
-    offset = PutBits(offset, 1, &off, outDataPtr);
+    PutBits(&writer, 0, 1);
 
     /* Optional Data Presence */
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.optionalDataPres, outDataPtr);
+    PutBits(&writer, msdDataPtr->msdMsg.optionalDataPres, 1);
 
     /* ** MSD structure ** */
     /* Extension bit */
-    offset = PutBits(offset, 1, &off, outDataPtr);
+    PutBits(&writer, 0, 1);
 
     /* Optional field presence indication */
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.recentVehLocationN1Pres
-             , outDataPtr);
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.recentVehLocationN2Pres
-             , outDataPtr);
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.numberOfPassengersPres
-             , outDataPtr);
+    PutBits(&writer, structPtr->recentVehLocationN1Pres, 1);
+    PutBits(&writer, structPtr->recentVehLocationN2Pres, 1);
+    PutBits(&writer, structPtr->numberOfPassengersPres, 1);
 
     /* Message Identifier */
-    offset = PutBits(offset, 8, &msdDataPtr->msdMsg.msdStruct.messageIdentifier, outDataPtr);
+    PutBits(&writer, structPtr->messageIdentifier, 8);
 
     /* Control Type */
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.control.automaticActivation
-             , outDataPtr);
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.control.testCall
-             , outDataPtr);
-    offset = PutBits(offset, 1, (uint8_t*)&msdDataPtr->msdMsg.msdStruct.control.positionCanBeTrusted
-             , outDataPtr);
-    /* vehType : Only enumerated values are supported : no extension*/
-    offset = PutBits(offset, 1, &off, outDataPtr); /* extension bit */
-    {
-        uint8_t tmp = msdDataPtr->msdMsg.msdStruct.control.vehType;
-        tmp -= 1;
-
-        offset = PutBits(offset, 4, &tmp , outDataPtr);
-    }
-
-    /* Vehicle identification Number */
-    if (!IsVinValid(msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber))
-    {
-        LE_ERROR("Cannot encode Vehicle Identification Number!");
-        return LE_FAULT;
-    }
-
-    /* Each character is coded within 6 bits according to translation table */
-    /* isowmi */
-    for (i=0;i<3;i++)
-    {
-        uint8_t* ptr = (uint8_t*) msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber.isowmi;
-        int8_t tmp = GetAsciiCode (ptr[i]);
-        /* check if character is authorized */
-        if (tmp <0)
-        {
-            LE_ERROR("Unable to get ASCII code for isowmi");
-            return LE_FAULT;
-        }
-        offset = PutBits(offset, 6, (uint8_t*) &tmp, outDataPtr);
-    }
-
-    /* isovdsvds */
-    for (i=0;i<6;i++)
-    {
-        uint8_t* ptr = (uint8_t*) msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber.isovds;
-        int8_t tmp = GetAsciiCode (ptr[i]);
-        /* check if character is authorized */
-        if (tmp <0)
-        {
-            LE_ERROR("Unable to get ASCII code for isovds");
-            return LE_FAULT;
-        }
-        offset = PutBits(offset, 6, (uint8_t*) &tmp, outDataPtr);
-    }
-
-    /* isovisModelyear */
-    for (i=0;i<1;i++)
-    {
-        uint8_t* ptr =
-            (uint8_t*) msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber.isovisModelyear;
-        int8_t tmp = GetAsciiCode (ptr[i]);
-        /* check if character is authorized */
-        if (tmp <0)
-        {
-            LE_ERROR("Unable to get ASCII code for isovisModelyear");
-            return LE_FAULT;
-        }
-        offset = PutBits(offset, 6, (uint8_t*) &tmp, outDataPtr);
-    }
+    PutBits(&writer, structPtr->control.automaticActivation, 1);
+    PutBits(&writer, structPtr->control.testCall, 1);
+    PutBits(&writer, structPtr->control.positionCanBeTrusted, 1);
 
-    /* isovisSeqPlant */
-    for (i=0;i<7;i++)
+    /* Vehicle type, VIN and propulsion storage type */
+    if (IsStaticPartUpToDate(staticPartPtr, msdDataPtr))
     {
-        uint8_t* ptr =
-            (uint8_t*) msdDataPtr->msdMsg.msdStruct.vehIdentificationNumber.isovisSeqPlant;
-        int8_t tmp = GetAsciiCode (ptr[i]);
-        /* check if character is authorized */
-        if (tmp <0)
-        {
-            LE_ERROR("Unable to get ASCII code for isovisSeqPlant");
-            return LE_FAULT;
-        }
-        offset = PutBits(offset, 6, (uint8_t*) &tmp, outDataPtr);
-    }
-
-    /* VehiclePropulsionStorageType */
-    /* Extension bit */
-    offset = PutBits(offset, 1, &off, outDataPtr);
-
-    offset = PutBits(offset, 1
-             , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.gasolineTankPresent
-             , outDataPtr);
-    offset = PutBits(offset, 1
-             , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.dieselTankPresent
-             , outDataPtr);
-    offset = PutBits(offset, 1
-    , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.compressedNaturalGas
-    , outDataPtr);
-    offset = PutBits(offset, 1
-             , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.liquidPropaneGas
-             , outDataPtr);
-    offset = PutBits(offset, 1
-    , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.electricEnergyStorage
-    , outDataPtr);
-    offset = PutBits(offset, 1
-             , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.hydrogenStorage
-             , outDataPtr);
-    if (msdDataPtr->version == 2)
-    {
-        offset = PutBits(offset, 1
-                 , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.otherStorage
-                 , outDataPtr);
-    }
-
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.gasolineTankPresent )
-    {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.gasolineTankPresent
-        , outDataPtr);
-    }
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.dieselTankPresent )
-    {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.dieselTankPresent
-        , outDataPtr);
-    }
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.compressedNaturalGas )
-    {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.compressedNaturalGas
-        , outDataPtr);
+        PutBitString(&writer, staticPartPtr->data, staticPartPtr->numBits);
     }
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.liquidPropaneGas )
+    else if (PutStaticPart(&writer, msdDataPtr) != LE_OK)
     {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.liquidPropaneGas
-        , outDataPtr);
-    }
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.electricEnergyStorage )
-    {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.electricEnergyStorage
-        , outDataPtr);
-    }
-    if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.hydrogenStorage )
-    {
-        offset = PutBits(offset, 1
-        , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.hydrogenStorage
-        , outDataPtr);
-    }
-    if (msdDataPtr->version == 2)
-    {
-       if ( msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.otherStorage )
-       {
-           offset = PutBits(offset, 1
-           , (uint8_t*)&msdDataPtr->msdMsg.msdStruct.vehPropulsionStorageType.otherStorage
-           , outDataPtr);
-       }
+        return LE_FAULT;
     }
 
-    /* Timestamp ( 32 bits ==> 4 * 8 bits ==> to check order ) */
-    {
-        uint8_t* ptr = (uint8_t*) &msdDataPtr->msdMsg.msdStruct.timestamp;
+    /* Timestamp */
+    PutBits(&writer, structPtr->timestamp, 32);
 
-        for (i=0;i<4;i++)
-        {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
-        }
-    }
-
-    /* vehLocation idem on 32 bits for latitude and longitude */
+    /* vehLocation on 32 bits for latitude and longitude */
     /* latitude */
+    if((structPtr->vehLocation.latitude < -324000000) ||
+       (structPtr->vehLocation.latitude > 324000000))
     {
-        int32_t latitudeTmp = msdDataPtr->msdMsg.msdStruct.vehLocation.latitude;
-        uint8_t* ptr = (uint8_t*) &latitudeTmp;
-        if((latitudeTmp < -324000000) || (latitudeTmp > 324000000))
+        if(structPtr->vehLocation.latitude != 0x7FFFFFFF)
         {
-            if(latitudeTmp != 0x7FFFFFFF)
-            {
-                LE_ERROR("Bad latitude value.%d", latitudeTmp);
-                return LE_FAULT;
-            }
-        }
-        latitudeTmp += 0x80000000;
-        for (i=0;i<4;i++)
-        {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
+            LE_ERROR("Bad latitude value.%d", structPtr->vehLocation.latitude);
+            return LE_FAULT;
         }
     }
+    PutBits(&writer, (uint32_t)structPtr->vehLocation.latitude + 0x80000000, 32);
 
     /* longitude */
+    if((structPtr->vehLocation.longitude < -648000000) ||
+       (structPtr->vehLocation.longitude > 648000000))
     {
-        int32_t longitudeTmp = msdDataPtr->msdMsg.msdStruct.vehLocation.longitude;
-        uint8_t* ptr = (uint8_t*) &longitudeTmp;
-        if((longitudeTmp < -648000000) || (longitudeTmp > 648000000))
-        {
-            if(longitudeTmp != 0x7FFFFFFF)
-            {
-                LE_ERROR("Bad longitude value.%d", longitudeTmp);
-                return LE_FAULT;
-            }
-        }
-        longitudeTmp += 0x80000000;
-        for (i=0;i<4;i++)
+        if(structPtr->vehLocation.longitude != 0x7FFFFFFF)
         {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
+            LE_ERROR("Bad longitude value.%d", structPtr->vehLocation.longitude);
+            return LE_FAULT;
         }
     }
+    PutBits(&writer, (uint32_t)structPtr->vehLocation.longitude + 0x80000000, 32);
 
     /* vehDirection */
-    if(msdDataPtr->msdMsg.msdStruct.vehDirection > 179)
+    if(structPtr->vehDirection > 179)
     {
-        if(msdDataPtr->msdMsg.msdStruct.vehDirection != 0xFF)
+        if(structPtr->vehDirection != 0xFF)
         {
             LE_ERROR("Bad Vehicle direction.%d (> 179 degrees && != 255)",
-                     msdDataPtr->msdMsg.msdStruct.vehDirection);
+                     structPtr->vehDirection);
             return LE_FAULT;
         }
     }
-    offset = PutBits(offset, 8 , &msdDataPtr->msdMsg.msdStruct.vehDirection, outDataPtr);
+    PutBits(&writer, structPtr->vehDirection, 8);
 
     /* Optional field */
     /* recentVehLocationN1 */
-    if (msdDataPtr->msdMsg.msdStruct.recentVehLocationN1Pres)
+    if (structPtr->recentVehLocationN1Pres)
     {
-        int32_t latitudeDeltaTmp, longitudeDeltaTmp;
+        int32_t latitudeDeltaTmp = structPtr->recentVehLocationN1.latitudeDelta;
+        int32_t longitudeDeltaTmp = structPtr->recentVehLocationN1.longitudeDelta;
+
         /* latitudeDelta */
-        latitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN1.latitudeDelta;
         if((latitudeDeltaTmp < ASN1_LATITUDE_DELTA_MIN) ||
            (latitudeDeltaTmp > ASN1_LATITUDE_DELTA_MAX))
         {
             LE_ERROR("Bad latitude delta 1 value.%d", latitudeDeltaTmp);
             return LE_FAULT;
         }
-        latitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&latitudeDeltaTmp, outDataPtr);
+        PutBits(&writer, latitudeDeltaTmp + 512, 10);
 
         /* longitudeDelta */
-        longitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN1.longitudeDelta;
         if((longitudeDeltaTmp < ASN1_LONGITUDE_DELTA_MIN) ||
            (longitudeDeltaTmp > ASN1_LONGITUDE_DELTA_MAX))
         {
             LE_ERROR("Bad longitude delta 1 value.%d", longitudeDeltaTmp);
             return LE_FAULT;
         }
-        longitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&longitudeDeltaTmp, outDataPtr);
+        PutBits(&writer, longitudeDeltaTmp + 512, 10);
     }
 
     /* recentVehLocationN2 */
-    if (msdDataPtr->msdMsg.msdStruct.recentVehLocationN2Pres)
+    if (structPtr->recentVehLocationN2Pres)
     {
-        int32_t latitudeDeltaTmp, longitudeDeltaTmp;
+        int32_t latitudeDeltaTmp = structPtr->recentVehLocationN2.latitudeDelta;
+        int32_t longitudeDeltaTmp = structPtr->recentVehLocationN2.longitudeDelta;
+
         /* latitudeDelta */
-        latitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN2.latitudeDelta;
         if((latitudeDeltaTmp < ASN1_LATITUDE_DELTA_MIN) ||
            (latitudeDeltaTmp > ASN1_LATITUDE_DELTA_MAX))
         {
             LE_ERROR("Bad latitude delta 2 value.%d", latitudeDeltaTmp);
             return LE_FAULT;
         }
-
-        latitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&latitudeDeltaTmp, outDataPtr);
+        PutBits(&writer, latitudeDeltaTmp + 512, 10);
 
         /* longitudeDelta */
-        longitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN2.longitudeDelta;
         if((longitudeDeltaTmp < ASN1_LONGITUDE_DELTA_MIN) ||
            (longitudeDeltaTmp > ASN1_LONGITUDE_DELTA_MAX))
         {
             LE_ERROR("Bad longitude delta 2 value.%d", longitudeDeltaTmp);
             return LE_FAULT;
         }
-        longitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&longitudeDeltaTmp, outDataPtr);
+        PutBits(&writer, longitudeDeltaTmp + 512, 10);
     }
 
     /* numberOfPassengers */
-    if (msdDataPtr->msdMsg.msdStruct.numberOfPassengersPres)
+    if (structPtr->numberOfPassengersPres)
     {
-        offset = PutBits(offset, 8, &msdDataPtr->msdMsg.msdStruct.numberOfPassengers, outDataPtr);
+        PutBits(&writer, structPtr->numberOfPassengers, 8);
     }
 
     /* optionalData */
     if (msdDataPtr->msdMsg.optionalDataPres)
     {
-        offset = msd_EncodeMsdMessageOptionalData(offset, msdDataPtr, outDataPtr);
+        msd_EncodeMsdMessageOptionalData(&writer, msdDataPtr);
     }
 
     /* Check the offset value, if > 1120 (MSD_MAX_SIZE (140) * 8 */
-    if(offset > 1120)
+    if(writer.offset > MSD_MAX_BYTES * 8)
     {
-        LE_ERROR("Bad offset value %d bits", offset);
+        LE_ERROR("Bad offset value %d bits", writer.offset);
         return LE_FAULT;
     }
     else
     {
-        uint16_t msdMsgLen=0;
-        /* Convert MSD message length in bits to length in Bytes */
-        if(offset%8)
-        {
-            /* Modulo 8 bits requires a one Byte extension */
-            msdMsgLen = (offset/8)+1;
-        }
-        else
-        {
-            msdMsgLen = (offset/8);
-        }
+        uint32_t msdMsgLen = FlushBits(&writer);
 
-        LE_DEBUG("MSD length %d Bytes for %d Bits", msdMsgLen, offset);
+        LE_DEBUG("MSD length %d Bytes for %d Bits", msdMsgLen, writer.offset);
 
         if (msdDataPtr->version == 2)
         {
             /* MSD structure size for MSD V2 coding */
-            uint8_t msdV2StructLen = msdMsgLen-2;
-            LE_DEBUG("MSD version 2: offset %d, MSD struct length %d", offsetV2, msdV2StructLen );
-            offset = PutBits(offsetV2, 8, &msdV2StructLen, outDataV2Ptr);
+            outDataPtr[1] = msdMsgLen - 2;
+            LE_DEBUG("MSD version 2: MSD struct length %d", outDataPtr[1]);
         }
 
         return msdMsgLen;
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the MSD message from the elements of the MSD data structure
+ *
+ * @return the MSD message length in bytes on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t msd_EncodeMsdMessage
+(
+    msd_t*      msdDataPtr, ///< [IN] MSD data
+    uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
+)
+{
+    return msd_EncodeMsdMessageWithStaticPart(msdDataPtr, NULL, outDataPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function encodes a data buffer from the elements of the ERA Glonass additional data
  * structure.
  *
- * @return the data buffer length in bits
+ * @return the data buffer length in bytes
  */
 //--------------------------------------------------------------------------------------------------
 int32_t msd_EncodeOptionalDataForEraGlonass
@@ -661,9 +749,8 @@ int32_t msd_EncodeOptionalDataForEraGlonass
                                               ///  calling function must be minimum 140 Bytes)
 )
 {
-    uint8_t off=0;
-    int offset=0;
-    uint16_t msdMsgLen=0;
+    BitWriter_t writer;
+    uint32_t msdMsgLen = 0;
 
     if(outDataPtr)
     {
@@ -677,318 +764,47 @@ int32_t msd_EncodeOptionalDataForEraGlonass
          * ...
          * }
          */
+        StartBits(&writer, outDataPtr, MSD_MAX_BYTES);
 
         /* Extension bit should PROBABLY be here since there is OPTIONAL parameters in the tree*/
-        offset = PutBits(offset, 1, &off, outDataPtr);
+        PutBits(&writer, 0, 1);
 
         /* Optional Data Presence */
         LE_DEBUG("Present: crashSeverity %d; diagno %d, crashInfo %d ",
               eraGlonassDataPtr->presentCrashSeverity,
               eraGlonassDataPtr->presentDiagnosticResult,
               eraGlonassDataPtr->presentCrashInfo);
-        offset = PutBits(offset, 1 ,(uint8_t*)&eraGlonassDataPtr->presentCrashSeverity
-                        , outDataPtr);
-        offset = PutBits(offset, 1 ,(uint8_t*)&eraGlonassDataPtr->presentDiagnosticResult
-                        , outDataPtr);
-        offset = PutBits(offset, 1 ,(uint8_t*)&eraGlonassDataPtr->presentCrashInfo
-                        , outDataPtr);
+        PutBits(&writer, eraGlonassDataPtr->presentCrashSeverity, 1);
+        PutBits(&writer, eraGlonassDataPtr->presentDiagnosticResult, 1);
+        PutBits(&writer, eraGlonassDataPtr->presentCrashInfo, 1);
 
         if( eraGlonassDataPtr->presentCrashSeverity )
         {
             /* crashSeverity : INTEGER (0..2047) OPTIONAL*/
             /* Fits in 11 bits */
-            offset = PutTwoBytes(offset, 11 ,(uint16_t*)&eraGlonassDataPtr->crashSeverity
-                                 , outDataPtr);
+            PutBits(&writer, eraGlonassDataPtr->crashSeverity, 11);
         }
 
         if( eraGlonassDataPtr->presentDiagnosticResult )
         {
-            /* first presence bits*/
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentMicConnectionFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentMicFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentRightSpeakerFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentLeftSpeakerFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentSpeakersFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentIgnitionLineFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentUimFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentStatusIndicatorFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentBatteryFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentBatteryVoltageLow
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentCrashSensorFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-            , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentFirmwareImageCorruption
-            , outDataPtr);
-            offset = PutBits(offset, 1
-            , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentCommModuleInterfaceFailure
-            , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentGnssReceiverFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentRaimProblem
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentGnssAntennaFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentCommModuleFailure
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentEventsMemoryOverflow
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-            , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentCrashProfileMemoryOverflow
-            , outDataPtr);
-            offset = PutBits(offset, 1
-                     , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentOtherCriticalFailures
-                     , outDataPtr);
-            offset = PutBits(offset, 1
-            , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.presentOtherNotCriticalFailures
-            , outDataPtr);
-
-           if( eraGlonassDataPtr->diagnosticResult.presentMicConnectionFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.micConnectionFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentMicFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.micFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentRightSpeakerFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.rightSpeakerFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentLeftSpeakerFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.leftSpeakerFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentSpeakersFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.speakersFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentIgnitionLineFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.ignitionLineFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentUimFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.uimFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentStatusIndicatorFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.statusIndicatorFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentBatteryFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.batteryFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentBatteryVoltageLow)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.batteryVoltageLow
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentCrashSensorFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.crashSensorFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentFirmwareImageCorruption)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.firmwareImageCorruption
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentCommModuleInterfaceFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.commModuleInterfaceFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentGnssReceiverFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.gnssReceiverFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentRaimProblem)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.raimProblem
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentGnssAntennaFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.gnssAntennaFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentCommModuleFailure)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.commModuleFailure
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentEventsMemoryOverflow)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.eventsMemoryOverflow
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentCrashProfileMemoryOverflow)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.crashProfileMemoryOverflow
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentOtherCriticalFailures)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.otherCriticalFailures
-                        , outDataPtr);
-           }
-           if( eraGlonassDataPtr->diagnosticResult.presentOtherNotCriticalFailures)
-           {
-               offset = PutBits(offset, 1
-                        , (uint8_t*)&eraGlonassDataPtr->diagnosticResult.otherNotCriticalFailures
-                        , outDataPtr);
-           }
+            PutFlagFields(&writer,
+                          eraGlonassDataPtr,
+                          DiagnosticFields,
+                          NUM_ARRAY_MEMBERS(DiagnosticFields));
         }
 
-
         if ( eraGlonassDataPtr->presentCrashInfo )
         {
-            /* Presence bits*/
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashFront
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashLeft
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashRight
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashRear
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashRollover
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashSide
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashFrontOrSide
-                             , outDataPtr);
-            offset = PutBits(offset, 1
-                             , (uint8_t*)&eraGlonassDataPtr->crashType.presentCrashAnotherType
-                             , outDataPtr);
-
-           /* Value bits*/
-           if( eraGlonassDataPtr->crashType.presentCrashFront )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashFront
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashLeft )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashLeft
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashRight )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashRight
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashRear )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashRear
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashRollover )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashRollover
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashSide )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashSide
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashFrontOrSide )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashFrontOrSide
-                                , outDataPtr);
-           }
-           if( eraGlonassDataPtr->crashType.presentCrashAnotherType )
-           {
-               offset = PutBits(offset, 1
-                                , (uint8_t*)&eraGlonassDataPtr->crashType.crashAnotherType
-                                , outDataPtr);
-           }
+            PutFlagFields(&writer,
+                          eraGlonassDataPtr,
+                          CrashTypeFields,
+                          NUM_ARRAY_MEMBERS(CrashTypeFields));
         }
 
-        /* Convert MSD message length in bits to length in Bytes */
-        if(offset%8)
-        {
-            /* Modulo 8 bits requires a one Byte extension */
-            msdMsgLen = (offset/8)+1;
-        }
-        else
-        {
-            msdMsgLen = (offset/8);
-        }
-    }
+        msdMsgLen = FlushBits(&writer);
 
-    LE_DEBUG("MSD Optional Data length %d Bytes for %d Bits", msdMsgLen, offset);
+        LE_DEBUG("MSD Optional Data length %d Bytes for %d Bits", msdMsgLen, writer.offset);
+    }
 
    return msdMsgLen; // number of Bytes.
 }
@@ -26,6 +26,14 @@
 #define ASN1_LONGITUDE_DELTA_MAX  511
 #define ASN1_LONGITUDE_DELTA_MIN  -512
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the pre-encoded static part of an MSD message, in bytes: vehicle type (5 bits),
+ * VIN (102 bits) and propulsion storage type (up to 15 bits).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_STATIC_PART_MAX_BYTES  16
+
 //--------------------------------------------------------------------------------------------------
 // Symbols and enums.
 //--------------------------------------------------------------------------------------------------
@@ -303,12 +311,29 @@ typedef struct {
    } crashType;
 } msd_EraGlonassData_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data structure holding the pre-encoded part of the MSD message that only depends on the vehicle
+ * configuration, along with the settings it was encoded from.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct {
+   bool                                isValid;     ///< true if the part has been encoded
+   uint8_t                             version;     ///< MSD version it was encoded for
+   msd_VehicleType_t                   vehType;     ///< Vehicle type it was encoded from
+   msd_Vin_t                           vin;         ///< VIN it was encoded from
+   msd_VehiclePropulsionStorageType_t  propulsion;  ///< Propulsion type it was encoded from
+   uint16_t                            numBits;     ///< Number of encoded bits
+   uint8_t                             data[MSD_STATIC_PART_MAX_BYTES]; ///< Encoded bits
+} msd_StaticPart_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function encodes a data buffer from the elements of the ERA Glonass additional data
  * structure.
  *
- * @return the data buffer length in bits
+ * @return the data buffer length in bytes
  */
 //--------------------------------------------------------------------------------------------------
 int32_t msd_EncodeOptionalDataForEraGlonass
@@ -324,8 +349,6 @@ int32_t msd_EncodeOptionalDataForEraGlonass
  *
  * @return the MSD message length in bytes on success
  * @return LE_FAULT on failure
- *
- * @note Only MSD version 1 is supported.
  */
 //--------------------------------------------------------------------------------------------------
 int32_t msd_EncodeMsdMessage
@@ -334,4 +357,39 @@ int32_t msd_EncodeMsdMessage
     uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function pre-encodes the part of the MSD message that only depends on the vehicle
+ * configuration (vehicle type, VIN and propulsion storage type), so that it doesn't have to be
+ * encoded again every time an MSD is built.
+ *
+ * @return LE_OK on success
+ * @return LE_FAULT on failure (the static part is then marked as not valid)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msd_EncodeStaticPart
+(
+    msd_t*            msdDataPtr,       ///< [IN] MSD data
+    msd_StaticPart_t* staticPartPtr     ///< [OUT] pre-encoded static part
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the MSD message from the elements of the MSD data structure, using a
+ * pre-encoded static part if it is still up to date.
+ *
+ * @note If the static part is NULL, not valid, or was encoded from other settings than the ones in
+ *       the MSD data, the vehicle type, VIN and propulsion storage type are encoded again.
+ *
+ * @return the MSD message length in bytes on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t msd_EncodeMsdMessageWithStaticPart
+(
+    msd_t*                  msdDataPtr,     ///< [IN] MSD data
+    const msd_StaticPart_t* staticPartPtr,  ///< [IN] pre-encoded static part (can be NULL)
+    uint8_t*                outDataPtr      ///< [OUT] encoded MSD message
+);
+
 #endif // LEGATO_ASN1_MSD_INCLUDE_GUARD
@@ -229,6 +229,9 @@ typedef struct
                                                                         /// when requested by the
                                                                         /// PSAP (pull)
     msd_t                   msd;                                        ///< MSD
+    msd_StaticPart_t        msdStaticPart;                              ///< Pre-encoded vehicle
+                                                                        ///  type, VIN and
+                                                                        ///  propulsion type
     uint8_t                 builtMsd[LE_ECALL_MSD_MAX_LEN];             ///< built MSD
     size_t                  builtMsdSize;                               ///< Size of the built MSD
     bool                    isMsdImported;                              ///< True if the MSD is
@@ -245,6 +248,10 @@ typedef struct
                                                                         ///< termination reason
     bool                    ackOrT7Received;                            ///< LL-ACK, HL-ACK,
                                                                         ///< T7 timeout received
+    bool                    isHotStandby;                               ///< True if the session
+                                                                        ///  is pre-staged
+    le_clk_Time_t           triggerTime;                                ///< Relative time the
+                                                                        ///  session was triggered
 }
 ECall_t;
 
@@ -285,6 +292,14 @@ ECallEventData_t;
 //--------------------------------------------------------------------------------------------------
 static void DialDurationTimerHandler(le_timer_Ref_t timerRef);
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Declaration of the MSD encoding function.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EncodeMsd(ECall_t* eCallPtr);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Choosen system standard (PAN-EUROPEAN or ERA-GLONASS).
@@ -392,6 +407,47 @@ static int32_t ConvertDdToDms
     return ((int32_t)((deg*60*60.000 + min*60.000 + sec)*1000));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the time elapsed since the eCall session was triggered, for compliance testing.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogSessionTiming
+(
+    const char* stepPtr,    ///< [IN] Session step
+    int32_t     value       ///< [IN] Value associated to the step
+)
+{
+    if ((ECallObj.triggerTime.sec == 0) && (ECallObj.triggerTime.usec == 0))
+    {
+        return;
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), ECallObj.triggerTime);
+
+    LE_INFO("eCall session timing: %s %d at +%" PRIu64 " us",
+            stepPtr,
+            value,
+            (uint64_t)elapsed.sec * 1000000 + elapsed.usec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the timing of a new eCall session.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartSessionTiming
+(
+    pa_ecall_StartType_t startType  ///< [IN] eCall start type
+)
+{
+    ECallObj.triggerTime = le_clk_GetRelativeTime();
+    LogSessionTiming(ECallObj.isHotStandby ? "triggered from hot standby, type" : "triggered, type",
+                     startType);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Report an eCall State to all eCall references.
@@ -405,6 +461,8 @@ static void ReportState
 {
     ReportState_t reportState;
 
+    LogSessionTiming("state", state);
+
     // Update eCall state for le_ecall_GetState function
     ECallObj.state = state;
     // Report state to application
@@ -739,6 +797,7 @@ static le_result_t DialAttempt
         if(pa_ecall_Start(ECallObj.startType) == LE_OK)
         {
             ECallObj.redial.dialAttemptsCount++;
+            LogSessionTiming("dial attempt", ECallObj.redial.dialAttemptsCount);
             result = LE_OK;
         }
         else
@@ -757,6 +816,7 @@ static le_result_t DialAttempt
             if(pa_ecall_Start(ECallObj.startType) == LE_OK)
             {
                 ECallObj.redial.dialAttemptsCount++;
+                LogSessionTiming("dial attempt", ECallObj.redial.dialAttemptsCount);
                 result = LE_OK;
             }
             else
@@ -1396,7 +1456,23 @@ static le_result_t LoadECallSettings
 
     le_cfg_CancelTxn(eCallCfg);
 
-    return GetPropulsionType();
+    le_result_t result = GetPropulsionType();
+
+    // Pre-encode the part of the MSD that only depends on these settings, so that it doesn't have
+    // to be encoded again when the eCall is triggered.
+    if (eCallPtr->msd.msdMsg.msdStruct.vehIdentificationNumber.isowmi[0] != '\0')
+    {
+        if (msd_EncodeStaticPart(&eCallPtr->msd, &eCallPtr->msdStaticPart) != LE_OK)
+        {
+            LE_WARN("Unable to pre-encode the MSD vehicle settings!");
+        }
+    }
+    else
+    {
+        eCallPtr->msdStaticPart.isValid = false;
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1411,6 +1487,12 @@ static void SettingsUpdate
 {
     LE_INFO("eCall settings have changed!");
     LoadECallSettings(&ECallObj);
+
+    // Keep the pre-staged MSD in line with the new settings.
+    if ((ECallObj.isHotStandby) && (EncodeMsd(&ECallObj) != LE_OK))
+    {
+        LE_WARN("The MSD can't be encoded with the new settings, hot standby is not ready!");
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1493,7 +1575,9 @@ static le_result_t EncodeMsd
         }
 
         // Encode MSD message
-        if ((eCallPtr->builtMsdSize = msd_EncodeMsdMessage(&eCallPtr->msd, eCallPtr->builtMsd))
+        if ((eCallPtr->builtMsdSize = msd_EncodeMsdMessageWithStaticPart(&eCallPtr->msd,
+                                                                         &eCallPtr->msdStaticPart,
+                                                                         eCallPtr->builtMsd))
             == LE_FAULT)
         {
             LE_ERROR("Unable to encode the MSD! Please verify your settings in the config tree.");
@@ -2637,8 +2721,10 @@ le_result_t le_ecall_ExportMsd
     }
 
     if ((!eCallPtr->isMsdImported) &&
-        (eCallPtr->builtMsdSize = msd_EncodeMsdMessage(&eCallPtr->msd,
-                                                        eCallPtr->builtMsd)) == LE_FAULT)
+        (eCallPtr->builtMsdSize = msd_EncodeMsdMessageWithStaticPart(&eCallPtr->msd,
+                                                                      &eCallPtr->msdStaticPart,
+                                                                      eCallPtr->builtMsd))
+         == LE_FAULT)
     {
         LE_ERROR("Unable to encode the MSD!");
         return LE_NOT_FOUND;
@@ -2683,6 +2769,8 @@ le_result_t le_ecall_StartAutomatic
         return LE_BUSY;
     }
 
+    StartSessionTiming(PA_ECALL_START_AUTO);
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -2704,6 +2792,7 @@ le_result_t le_ecall_StartAutomatic
         LE_ERROR("Encode MSD failure (msg ID, timestamp and control flags)");
         return LE_FAULT;
     }
+    LogSessionTiming("MSD encoded, length", eCallPtr->builtMsdSize);
 
     // Initialize redial state machine
     RedialInit();
@@ -2772,6 +2861,8 @@ le_result_t le_ecall_StartManual
         return LE_BUSY;
     }
 
+    StartSessionTiming(PA_ECALL_START_MANUAL);
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -2793,6 +2884,7 @@ le_result_t le_ecall_StartManual
         LE_ERROR("Encode MSD failure (msg ID, timestamp and control flags)");
         return LE_FAULT;
     }
+    LogSessionTiming("MSD encoded, length", eCallPtr->builtMsdSize);
 
     // Initialize redial state machine
     RedialInit();
@@ -2861,6 +2953,8 @@ le_result_t le_ecall_StartTest
         return LE_BUSY;
     }
 
+    StartSessionTiming(PA_ECALL_START_TEST);
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -2882,6 +2976,7 @@ le_result_t le_ecall_StartTest
         LE_ERROR("Encode MSD failure (msg ID, timestamp and control flags)");
         return LE_FAULT;
     }
+    LogSessionTiming("MSD encoded, length", eCallPtr->builtMsdSize);
 
     // Initialize redial state machine
     RedialInit();
@@ -2917,6 +3012,90 @@ le_result_t le_ecall_StartTest
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the hot standby of an eCall session.
+ *
+ * In hot standby, everything that doesn't depend on the trigger is done beforehand: the MSD
+ * transmission mode is configured and checked in the modem, the MSD is encoded and kept encoded
+ * with the latest values set by the le_ecall_SetMsdXxx() functions and the eCall settings, so that
+ * the le_ecall_StartXxx() functions only have to complete the MSD and dial.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER bad eCall reference
+ *      - LE_FAULT the eCall session can't be pre-staged (the hot standby is then disabled)
+ *
+ * @note The process exits, if an invalid eCall reference is given
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_ecall_SetHotStandby
+(
+    le_ecall_CallRef_t    ecallRef,  ///< [IN] eCall reference
+    bool                  enable     ///< [IN] True to enable the hot standby, false to disable it
+)
+{
+    ECall_t*   eCallPtr = le_ref_Lookup(ECallRefMap, ecallRef);
+    char psapNumber[LE_MDMDEFS_PHONE_NUM_MAX_BYTES] = {0};
+    le_ecall_MsdTxMode_t msdTxMode;
+
+    if (eCallPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", ecallRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    eCallPtr->isHotStandby = false;
+
+    if (!enable)
+    {
+        LE_INFO("eCall hot standby disabled");
+        return LE_OK;
+    }
+
+    // Make sure the latest eCall settings are used.
+    if (LoadECallSettings(eCallPtr) != LE_OK)
+    {
+        LE_WARN("Unable to load all the eCall settings!");
+    }
+
+    // Configure the MSD transmission mode used when the eCall is triggered, and check that the
+    // modem really uses it.
+    if (   (pa_ecall_GetMsdTxMode(&msdTxMode) != LE_OK)
+        || (msdTxMode != LE_ECALL_TX_MODE_PUSH))
+    {
+        if (pa_ecall_SetMsdTxMode(LE_ECALL_TX_MODE_PUSH) != LE_OK)
+        {
+            LE_ERROR("Unable to set the Push mode!");
+            return LE_FAULT;
+        }
+    }
+    eCallPtr->isPushed = true;
+
+    // The PSAP number can also be read from the U/SIM, so only warn if none is set.
+    if (   (pa_ecall_GetPsapNumber(psapNumber, sizeof(psapNumber)) != LE_OK)
+        || (psapNumber[0] == '\0'))
+    {
+        LE_WARN("No PSAP number set in the modem!");
+    }
+
+    // Pre-encode the MSD.
+    if (!eCallPtr->msdStaticPart.isValid)
+    {
+        msd_EncodeStaticPart(&eCallPtr->msd, &eCallPtr->msdStaticPart);
+    }
+    if (EncodeMsd(eCallPtr) != LE_OK)
+    {
+        LE_ERROR("Unable to encode the MSD! Please verify your settings in the config tree.");
+        return LE_FAULT;
+    }
+
+    eCallPtr->isHotStandby = true;
+    LE_INFO("eCall hot standby enabled");
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * End the current eCall session
@@ -2957,6 +3136,12 @@ le_result_t le_ecall_End
     // Invalidate MSD
     InvalidateMsd();
 
+    // Get the MSD ready for the next session
+    if ((eCallPtr->isHotStandby) && (EncodeMsd(eCallPtr) != LE_OK))
+    {
+        LE_WARN("Unable to encode the MSD, hot standby is not ready!");
+    }
+
     result = pa_ecall_End();
 
     // Stop redial
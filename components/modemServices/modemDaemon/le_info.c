@@ -11,11 +11,238 @@
 #include "pa_info.h"
 #include "pa_sim.h"
 #include "sysResets.h"
+#include "le_info_local.h"
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a cached identifier, big enough for the longest of them (the versions and model).
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHED_INFO_BYTES       LE_INFO_MAX_VERS_BYTES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifiers that don't change while the modem runs, and are cached after the first successful
+ * read so that they don't cost a modem query every time they're asked for.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    CACHED_IMEI,
+    CACHED_IMEISV,
+    CACHED_FIRMWARE_VERSION,
+    CACHED_BOOTLOADER_VERSION,
+    CACHED_DEVICE_MODEL,
+    CACHED_MEID,
+    CACHED_ESN,
+    CACHED_MFR_NAME,
+    CACHED_SKU,
+    CACHED_PSN,
+    CACHED_INFO_MAX
+}
+CachedInfo_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isValid;                   ///< true once the identifier has been read.
+    char str[CACHED_INFO_BYTES];    ///< Identifier (null-terminated).
+}
+CachedString_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache of the identifiers.
+ */
+//--------------------------------------------------------------------------------------------------
+static CachedString_t Cache[CACHED_INFO_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the IMEI from the platform adaptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadImei
+(
+    char*  strPtr,      ///< [OUT] IMEI string.
+    size_t strSize      ///< [IN] Size of the string buffer.
+)
+{
+    pa_info_Imei_t imei = {0};
+
+    if (pa_info_GetImei(imei) != LE_OK)
+    {
+        LE_ERROR("Failed to get the IMEI");
+        return LE_FAULT;
+    }
+
+    return le_utf8_Copy(strPtr, imei, strSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the IMEISV from the platform adaptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadImeiSv
+(
+    char*  strPtr,      ///< [OUT] IMEISV string.
+    size_t strSize      ///< [IN] Size of the string buffer.
+)
+{
+    pa_info_ImeiSv_t imeiSv = {0};
+
+    if (pa_info_GetImeiSv(imeiSv) != LE_OK)
+    {
+        LE_ERROR("Failed to get the IMEISV");
+        return LE_FAULT;
+    }
+
+    return le_utf8_Copy(strPtr, imeiSv, strSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the device model from the platform adaptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadDeviceModel
+(
+    char*  strPtr,      ///< [OUT] Model string.
+    size_t strSize      ///< [IN] Size of the string buffer.
+)
+{
+    pa_info_DeviceModel_t modelVersion;
+
+    if (pa_info_GetDeviceModel(modelVersion) != LE_OK)
+    {
+        LE_ERROR("Failed to get the device model");
+        return LE_FAULT;
+    }
+
+    return le_utf8_Copy(strPtr, modelVersion, strSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Functions reading the identifiers from the platform adaptor, indexed by CachedInfo_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t (*const ReadFuncs[CACHED_INFO_MAX])(char*, size_t) =
+{
+    [CACHED_IMEI]               = ReadImei,
+    [CACHED_IMEISV]             = ReadImeiSv,
+    [CACHED_FIRMWARE_VERSION]   = pa_info_GetFirmwareVersion,
+    [CACHED_BOOTLOADER_VERSION] = pa_info_GetBootloaderVersion,
+    [CACHED_DEVICE_MODEL]       = ReadDeviceModel,
+    [CACHED_MEID]               = pa_info_GetMeid,
+    [CACHED_ESN]                = pa_info_GetEsn,
+    [CACHED_MFR_NAME]           = pa_info_GetManufacturerName,
+    [CACHED_SKU]                = pa_info_GetSku,
+    [CACHED_PSN]                = pa_info_GetPlatformSerialNumber,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an identifier, from the cache if it has already been read.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_OVERFLOW      The identifier doesn't fit in the buffer.
+ *      - Anything else    The error returned by the platform adaptor (nothing is cached).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetCachedInfo
+(
+    CachedInfo_t info,  ///< [IN] Identifier.
+    char*  strPtr,      ///< [OUT] Identifier string.
+    size_t strSize      ///< [IN] Size of the string buffer.
+)
+{
+    CachedString_t* cachePtr = &Cache[info];
+
+    if (!cachePtr->isValid)
+    {
+        le_result_t result = ReadFuncs[info](cachePtr->str, sizeof(cachePtr->str));
+
+        if (result != LE_OK)
+        {
+            strPtr[0] = '\0';
+            return result;
+        }
+
+        cachePtr->isValid = true;
+    }
+
+    return le_utf8_Copy(strPtr, cachePtr->str, strSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SIM state handler: a new SIM can make the modem switch to another firmware image.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SimStateHandler
+(
+    pa_sim_Event_t* eventPtr    ///< [IN] New SIM state.
+)
+{
+    if ((eventPtr->state == LE_SIM_INSERTED) || (eventPtr->state == LE_SIM_ABSENT))
+    {
+        le_info_InvalidateCache();
+    }
+
+    le_mem_Release(eventPtr);
+}
 
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the cached identifiers, so that they are read again from the modem the next time they
+ * are asked for.  Must be called when they may have changed, e.g. after a firmware update.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_InvalidateCache
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < CACHED_INFO_MAX; i++)
+    {
+        Cache[i].isValid = false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the Info component.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_Init
+(
+    void
+)
+{
+    // Register a handler function for SIM state changes, to keep the cache in sync.
+    if (pa_sim_AddNewStateHandler(SimStateHandler) == NULL)
+    {
+        LE_WARN("failed to register a handler function for SIM state");
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to retrieve the International Mobile Equipment Identity (IMEI).
@@ -34,8 +261,6 @@ le_result_t le_info_GetImei
     size_t           len       ///< [IN] The length of IMEI string.
 )
 {
-    pa_info_Imei_t imei = {0};
-
     if (imeiPtr == NULL)
     {
         LE_KILL_CLIENT("imeiPtr is NULL !");
@@ -47,16 +272,7 @@ le_result_t le_info_GetImei
         return LE_FAULT;
     }
 
-    if(pa_info_GetImei(imei) != LE_OK)
-    {
-        LE_ERROR("Failed to get the IMEI");
-        imeiPtr[0] = '\0';
-        return LE_FAULT;
-    }
-    else
-    {
-        return (le_utf8_Copy(imeiPtr, imei, len, NULL));
-    }
+    return GetCachedInfo(CACHED_IMEI, imeiPtr, len);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -78,8 +294,6 @@ le_result_t le_info_GetImeiSv
     size_t imeiSvNumElements    ///< [IN] The length of IMEISV string.
 )
 {
-    pa_info_ImeiSv_t imeiSv = {0};
-
     if (imeiSvPtr == NULL)
     {
         LE_KILL_CLIENT("imeiSvPtr is NULL !");
@@ -91,16 +305,7 @@ le_result_t le_info_GetImeiSv
         return LE_FAULT;
     }
 
-    if (pa_info_GetImeiSv(imeiSv) != LE_OK)
-    {
-        LE_ERROR("Failed to get the IMEISV");
-        imeiSvPtr[0] = '\0';
-        return LE_FAULT;
-    }
-    else
-    {
-        return (le_utf8_Copy(imeiSvPtr, imeiSv, imeiSvNumElements, NULL));
-    }
+    return GetCachedInfo(CACHED_IMEISV, imeiSvPtr, imeiSvNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -138,7 +343,7 @@ le_result_t le_info_GetFirmwareVersion
         LE_ERROR("parameter error");
         return LE_FAULT;
     }
-    return pa_info_GetFirmwareVersion(versionPtr, versionNumElements);
+    return GetCachedInfo(CACHED_FIRMWARE_VERSION, versionPtr, versionNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -214,7 +419,7 @@ le_result_t le_info_GetBootloaderVersion
         LE_ERROR("parameter error");
         return LE_FAULT;
     }
-    return pa_info_GetBootloaderVersion(versionPtr, versionNumElements);
+    return GetCachedInfo(CACHED_BOOTLOADER_VERSION, versionPtr, versionNumElements);
 }
 
 
@@ -237,8 +442,6 @@ le_result_t le_info_GetDeviceModel
         ///< [IN] The length of Model identity string.
 )
 {
-    pa_info_DeviceModel_t modelVersion;
-
     if(modelPtr == NULL)
     {
         LE_KILL_CLIENT("model pointer is NULL");
@@ -251,16 +454,7 @@ le_result_t le_info_GetDeviceModel
         return LE_FAULT;
     }
 
-    if(pa_info_GetDeviceModel(modelVersion) != LE_OK)
-    {
-        LE_ERROR("Failed to get the device model");
-        modelPtr[0] = '\0';
-        return LE_FAULT;
-    }
-    else
-    {
-        return (le_utf8_Copy(modelPtr, modelVersion, modelNumElements, NULL));
-    }
+    return GetCachedInfo(CACHED_DEVICE_MODEL, modelPtr, modelNumElements);
 }
 
 
@@ -291,7 +485,13 @@ le_result_t le_info_GetMeid
         return LE_FAULT;
     }
 
-    return pa_info_GetMeid(meidStr, meidStrNumElements);
+    if (0 == meidStrNumElements)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    return GetCachedInfo(CACHED_MEID, meidStr, meidStrNumElements);
 }
 
 
@@ -322,7 +522,13 @@ le_result_t le_info_GetEsn
         return LE_FAULT;
     }
 
-    return pa_info_GetEsn(esnStr, esnStrNumElements);
+    if (0 == esnStrNumElements)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    return GetCachedInfo(CACHED_ESN, esnStr, esnStrNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -504,7 +710,13 @@ le_result_t le_info_GetManufacturerName
         return LE_FAULT;
     }
 
-    return pa_info_GetManufacturerName(mfrNameStr, mfrNameStrNumElements);
+    if (0 == mfrNameStrNumElements)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    return GetCachedInfo(CACHED_MFR_NAME, mfrNameStr, mfrNameStrNumElements);
 }
 
 
@@ -628,7 +840,13 @@ le_result_t le_info_GetSku
         return LE_FAULT;
     }
 
-    return pa_info_GetSku(skuIdStr, skuIdStrNumElements);
+    if (0 == skuIdStrNumElements)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    return GetCachedInfo(CACHED_SKU, skuIdStr, skuIdStrNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -657,8 +875,100 @@ le_result_t le_info_GetPlatformSerialNumber
         return LE_FAULT;
     }
 
-    return pa_info_GetPlatformSerialNumber(platformSerialNumberStr,
-                    platformSerialNumberStrNumElements);
+    if (0 == platformSerialNumberStrNumElements)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    return GetCachedInfo(CACHED_PSN, platformSerialNumberStr, platformSerialNumberStrNumElements);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the identifiers and versions of the device that don't change while it runs, in one call.
+ * An identifier that can't be retrieved is returned as an empty string.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_OVERFLOW      At least one of the strings exceeds the maximum length.
+ *      - LE_FAULT         At least one of the identifiers couldn't be retrieved.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_info_GetDeviceInfo
+(
+    char* imeiPtr,                      ///< [OUT] IMEI string.
+    size_t imeiSize,                    ///< [IN]
+    char* imeiSvPtr,                    ///< [OUT] IMEISV string.
+    size_t imeiSvSize,                  ///< [IN]
+    char* firmwareVersionPtr,           ///< [OUT] Firmware version string.
+    size_t firmwareVersionSize,         ///< [IN]
+    char* bootloaderVersionPtr,         ///< [OUT] Bootloader version string.
+    size_t bootloaderVersionSize,       ///< [IN]
+    char* modelPtr,                     ///< [OUT] Device model string.
+    size_t modelSize,                   ///< [IN]
+    char* mfrNamePtr,                   ///< [OUT] Manufacturer name string.
+    size_t mfrNameSize,                 ///< [IN]
+    char* skuIdPtr,                     ///< [OUT] Product SKU ID string.
+    size_t skuIdSize,                   ///< [IN]
+    char* platformSerialNumberPtr,      ///< [OUT] Platform Serial Number string.
+    size_t platformSerialNumberSize     ///< [IN]
+)
+{
+    struct
+    {
+        CachedInfo_t info;
+        char*        strPtr;
+        size_t       strSize;
+    }
+    fields[] =
+    {
+        { CACHED_IMEI,               imeiPtr,                 imeiSize },
+        { CACHED_IMEISV,             imeiSvPtr,               imeiSvSize },
+        { CACHED_FIRMWARE_VERSION,   firmwareVersionPtr,      firmwareVersionSize },
+        { CACHED_BOOTLOADER_VERSION, bootloaderVersionPtr,    bootloaderVersionSize },
+        { CACHED_DEVICE_MODEL,       modelPtr,                modelSize },
+        { CACHED_MFR_NAME,           mfrNamePtr,              mfrNameSize },
+        { CACHED_SKU,                skuIdPtr,                skuIdSize },
+        { CACHED_PSN,                platformSerialNumberPtr, platformSerialNumberSize },
+    };
+    le_result_t result = LE_OK;
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(fields); i++)
+    {
+        if (fields[i].strPtr == NULL)
+        {
+            LE_KILL_CLIENT("String pointer is NULL !");
+            return LE_FAULT;
+        }
+        if (0 == fields[i].strSize)
+        {
+            LE_ERROR("parameter error");
+            return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(fields); i++)
+    {
+        le_result_t fieldResult = GetCachedInfo(fields[i].info,
+                                                fields[i].strPtr,
+                                                fields[i].strSize);
+
+        if (fieldResult == LE_OVERFLOW)
+        {
+            if (result == LE_OK)
+            {
+                result = LE_OVERFLOW;
+            }
+        }
+        else if (fieldResult != LE_OK)
+        {
+            result = LE_FAULT;
+        }
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+/**
+ * @file le_info_local.h
+ *
+ * Local Modem Information Definitions
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_INFO_LOCAL_INCLUDE_GUARD
+#define LEGATO_INFO_LOCAL_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the Info component.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the cached identifiers, so that they are read again from the modem the next time they
+ * are asked for.  Must be called when they may have changed, e.g. after a firmware update.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_InvalidateCache
+(
+    void
+);
+
+
+#endif // LEGATO_INFO_LOCAL_INCLUDE_GUARD
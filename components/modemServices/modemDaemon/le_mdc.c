@@ -12,6 +12,10 @@
 #include "interfaces.h"
 #include "pa_mdc.h"
 
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
 // Include macros for printing out values
 #include "le_print.h"
 
@@ -43,6 +47,20 @@
 //--------------------------------------------------------------------------------------------------
 #define LE_MDC_MAX_PROFILE_INDEX            16
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of bytes counter subscriptions.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COUNTER_DEFAULT_POOL_SIZE           4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer receiving the link messages from the kernel, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NETLINK_BUFFER_BYTES                16384
+
 //--------------------------------------------------------------------------------------------------
 /**
  * MDC command Type.
@@ -73,9 +91,31 @@ typedef struct
     le_mdc_ProfileRef_t profileRef;            ///< Profile Safe Reference
     le_mdc_ConState_t connectionStatus;        ///< Data session connection status
     pa_mdc_ConnectionFailureCode_t conFailure; ///< connection or disconnection failure reason
+    bool isCounted;                            ///< Whether the session traffic is counted
+    unsigned int ifIndex;                      ///< Index of the network interface, or 0 if unknown
+    uint64_t ifRxBytes;                        ///< Bytes received by the interface at last check
+    uint64_t ifTxBytes;                        ///< Bytes sent by the interface at last check
 }
 le_mdc_Profile_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bytes counter subscription.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mdc_BytesCounterHandlerRef_t  ref;              ///< Safe reference of the subscription.
+    le_msg_SessionRef_t              sessionRef;       ///< Session of the client.
+    le_mdc_BytesCounterHandlerFunc_t handlerFunc;      ///< Handler function.
+    void*                            contextPtr;       ///< Handler's context.
+    le_timer_Ref_t                   timerRef;         ///< Timer checking the counters.
+    uint64_t                         thresholdBytes;   ///< Bytes needed to call the handler.
+    uint64_t                         rxBytes;          ///< RxBytes at the handler's last call.
+    uint64_t                         txBytes;          ///< TxBytes at the handler's last call.
+}
+CounterSub_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Request command structure.
@@ -131,6 +171,66 @@ static le_event_Id_t MtPdpEventId;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t CommandEventId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for bytes counter subscriptions.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CounterSubPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe Reference Map for bytes counter subscriptions.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t CounterSubRefMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bytes received and transmitted by the data sessions since the first subscription.  These only
+ * ever grow, whatever happens to the kernel or modem counters they are updated from.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t RxBytes;
+static uint64_t TxBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Modem counters at last check, when the kernel statistics can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ModemRxBytes;
+static uint64_t ModemTxBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Routing netlink socket used to read the statistics of the network interfaces, or -1 if it
+ * could not be opened (the modem counters are used instead).
+ */
+//--------------------------------------------------------------------------------------------------
+static int NetlinkFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the last request sent on the netlink socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NetlinkSeq;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the session close handler of the bytes counter subscriptions has been added.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CounterCloseHandlerAdded;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of connected data sessions whose traffic is counted.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NumCountedSessions;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Trace reference used for controlling tracing in this module.
@@ -182,6 +282,323 @@ static le_mdc_Profile_t* SearchProfileInList
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes received and transmitted by a network interface, from the statistics
+ * kept by the kernel.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetNetdevStats
+(
+    unsigned int ifIndex,   ///< [IN] Index of the network interface.
+    uint64_t* rxBytesPtr,   ///< [OUT] Bytes received.
+    uint64_t* txBytesPtr    ///< [OUT] Bytes transmitted.
+)
+{
+    static uint32_t buffer[NETLINK_BUFFER_BYTES / sizeof(uint32_t)];
+    struct
+    {
+        struct nlmsghdr  hdr;
+        struct ifinfomsg ifi;
+    }
+    request;
+
+    memset(&request, 0, sizeof(request));
+    request.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.hdr.nlmsg_type = RTM_GETLINK;
+    request.hdr.nlmsg_flags = NLM_F_REQUEST;
+    request.hdr.nlmsg_seq = ++NetlinkSeq;
+    request.ifi.ifi_family = AF_UNSPEC;
+    request.ifi.ifi_index = ifIndex;
+
+    if (send(NetlinkFd, &request, request.hdr.nlmsg_len, 0) < 0)
+    {
+        LE_ERROR("Failed to send link request (%m).");
+        return LE_FAULT;
+    }
+
+    // The kernel handles the request before send() returns, so the answer is already queued.
+    // Answers to older requests that timed out are skipped.
+    ssize_t len;
+
+    while ((len = recv(NetlinkFd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+    {
+        struct nlmsghdr* hdrPtr = (struct nlmsghdr*)buffer;
+
+        for (; NLMSG_OK(hdrPtr, (size_t)len); hdrPtr = NLMSG_NEXT(hdrPtr, len))
+        {
+            if (hdrPtr->nlmsg_seq != NetlinkSeq)
+            {
+                continue;
+            }
+
+            if (hdrPtr->nlmsg_type != RTM_NEWLINK)
+            {
+                TRACE("No statistics for interface %u (message type %u).",
+                      ifIndex,
+                      hdrPtr->nlmsg_type);
+                return LE_FAULT;
+            }
+
+            struct ifinfomsg* ifiPtr = NLMSG_DATA(hdrPtr);
+            struct rtattr* attrPtr = IFLA_RTA(ifiPtr);
+            int attrLen = IFLA_PAYLOAD(hdrPtr);
+
+            for (; RTA_OK(attrPtr, attrLen); attrPtr = RTA_NEXT(attrPtr, attrLen))
+            {
+                if (   (attrPtr->rta_type == IFLA_STATS64)
+                    && (RTA_PAYLOAD(attrPtr) >= sizeof(struct rtnl_link_stats64)))
+                {
+                    struct rtnl_link_stats64 stats;
+
+                    memcpy(&stats, RTA_DATA(attrPtr), sizeof(stats));
+                    *rxBytesPtr = stats.rx_bytes;
+                    *txBytesPtr = stats.tx_bytes;
+                    return LE_OK;
+                }
+            }
+
+            LE_ERROR("No 64-bit statistics for interface %u.", ifIndex);
+            return LE_FAULT;
+        }
+    }
+
+    LE_ERROR("No answer to link request for interface %u.", ifIndex);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the last value read from a counter.
+ *
+ * @return Increase of the counter.  A counter going back is taken as having been reset.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t UpdateCounter
+(
+    uint64_t* lastValuePtr, ///< [IN/OUT] Last value read.
+    uint64_t value          ///< [IN] New value.
+)
+{
+    uint64_t delta = (value >= *lastValuePtr) ? (value - *lastValuePtr) : value;
+
+    *lastValuePtr = value;
+
+    return delta;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the traffic since the last check to RxBytes and TxBytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateBytesCounters
+(
+    void
+)
+{
+    uint64_t rxBytes;
+    uint64_t txBytes;
+
+    if (NetlinkFd < 0)
+    {
+        pa_mdc_PktStatistics_t data;
+
+        if (pa_mdc_GetDataFlowStatistics(&data) == LE_OK)
+        {
+            RxBytes += UpdateCounter(&ModemRxBytes, data.receivedBytesCount);
+            TxBytes += UpdateCounter(&ModemTxBytes, data.transmittedBytesCount);
+        }
+        return;
+    }
+
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(DataProfileRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        le_mdc_Profile_t* profilePtr = (le_mdc_Profile_t*) le_ref_GetValue(iterRef);
+
+        if (   profilePtr->isCounted
+            && (profilePtr->ifIndex != 0)
+            && (GetNetdevStats(profilePtr->ifIndex, &rxBytes, &txBytes) == LE_OK))
+        {
+            RxBytes += UpdateCounter(&profilePtr->ifRxBytes, rxBytes);
+            TxBytes += UpdateCounter(&profilePtr->ifTxBytes, txBytes);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call the handler of a bytes counter subscription, if enough bytes went through since its
+ * previous call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportBytesCounter
+(
+    CounterSub_t* subPtr    ///< [IN] Subscription.
+)
+{
+    uint64_t rxDelta = RxBytes - subPtr->rxBytes;
+    uint64_t txDelta = TxBytes - subPtr->txBytes;
+
+    if (((rxDelta + txDelta) == 0) || ((rxDelta + txDelta) < subPtr->thresholdBytes))
+    {
+        return;
+    }
+
+    subPtr->rxBytes = RxBytes;
+    subPtr->txBytes = TxBytes;
+
+    subPtr->handlerFunc(rxDelta, txDelta, subPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer handler checking the counters of a bytes counter subscription.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BytesCounterTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer of the subscription.
+)
+{
+    UpdateBytesCounters();
+    ReportBytesCounter((CounterSub_t*)le_timer_GetContextPtr(timerRef));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the timers of the bytes counter subscriptions if a counted data session is connected, or
+ * stop them otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateBytesCounterTimers
+(
+    void
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(CounterSubRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        CounterSub_t* subPtr = (CounterSub_t*) le_ref_GetValue(iterRef);
+
+        if (NumCountedSessions == 0)
+        {
+            // Report what was counted so far, as nothing will be until the next connection.
+            ReportBytesCounter(subPtr);
+            le_timer_Stop(subPtr->timerRef);
+        }
+        else if (!le_timer_IsRunning(subPtr->timerRef))
+        {
+            le_timer_Start(subPtr->timerRef);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start or stop counting the traffic of a data session when it is connected or disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSessionCounting
+(
+    le_mdc_Profile_t* profilePtr    ///< [IN] Profile of the data session.
+)
+{
+    bool isConnected = (profilePtr->connectionStatus == LE_MDC_CONNECTED);
+
+    if (isConnected == profilePtr->isCounted)
+    {
+        return;
+    }
+
+    if (isConnected)
+    {
+        char ifName[LE_MDC_INTERFACE_NAME_MAX_BYTES] = {0};
+
+        profilePtr->ifIndex = 0;
+
+        if (NetlinkFd >= 0)
+        {
+            if (pa_mdc_GetInterfaceName(profilePtr->profileIndex, ifName, sizeof(ifName)) == LE_OK)
+            {
+                profilePtr->ifIndex = if_nametoindex(ifName);
+            }
+
+            if (   (profilePtr->ifIndex == 0)
+                || (GetNetdevStats(profilePtr->ifIndex,
+                                   &profilePtr->ifRxBytes,
+                                   &profilePtr->ifTxBytes) != LE_OK))
+            {
+                LE_WARN("Traffic of profile %d not counted (interface '%s').",
+                        profilePtr->profileIndex,
+                        ifName);
+                profilePtr->ifIndex = 0;
+            }
+        }
+
+        profilePtr->isCounted = true;
+        NumCountedSessions++;
+    }
+    else
+    {
+        // Pick up the traffic since the last check, while the interface may still be there.
+        UpdateBytesCounters();
+
+        profilePtr->isCounted = false;
+        profilePtr->ifIndex = 0;
+        NumCountedSessions--;
+    }
+
+    UpdateBytesCounterTimers();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a bytes counter subscription.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteBytesCounterSub
+(
+    CounterSub_t* subPtr    ///< [IN] Subscription.
+)
+{
+    le_timer_Delete(subPtr->timerRef);
+    le_ref_DeleteRef(CounterSubRefMap, subPtr->ref);
+    le_mem_Release(subPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function to the close session service, deleting the bytes counter subscriptions of the
+ * client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session of the client.
+    void*               contextPtr  ///< [IN] Not used.
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(CounterSubRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        CounterSub_t* subPtr = (CounterSub_t*) le_ref_GetValue(iterRef);
+
+        if (subPtr->sessionRef == sessionRef)
+        {
+            DeleteBytesCounterSub(subPtr);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer New Session State Change Handler.
@@ -242,6 +659,7 @@ static void NewSessionStateHandler
                 le_event_Report(profilePtr->sessionStateEvent, &profilePtr, sizeof(profilePtr));
                 // Update Connection Status
                 profilePtr->connectionStatus = sessionStatePtr->newState;
+                UpdateSessionCounting(profilePtr);
             }
 
             // Get disconnection reason
@@ -691,6 +1109,17 @@ void le_mdc_Init
     // Subscribe to the session state handler
     pa_mdc_AddSessionStateHandler(NewSessionStateHandler, NULL);
 
+    // Bytes counter subscriptions, and the socket used to read the interface statistics
+    CounterSubPool = le_mem_CreatePool("CounterSubPool", sizeof(CounterSub_t));
+    le_mem_ExpandPool(CounterSubPool, COUNTER_DEFAULT_POOL_SIZE);
+    CounterSubRefMap = le_ref_CreateMap("CounterSubMap", COUNTER_DEFAULT_POOL_SIZE);
+
+    NetlinkFd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (NetlinkFd < 0)
+    {
+        LE_WARN("Failed to open netlink socket (%m), the modem counters will be used.");
+    }
+
     /* MT-PDP management */
     // Create an event Id for MT-PDP notification
     MtPdpEventId = le_event_CreateId("MtPdpNotif", sizeof(le_mdc_Profile_t*));
@@ -1667,6 +2096,96 @@ le_result_t le_mdc_ResetBytesCounter
     return pa_mdc_ResetDataFlowStatistics();
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_mdc_BytesCounter'
+ *
+ * Traffic of the data sessions.  The counters are checked every periodMs milliseconds while a data
+ * session is connected, and the handler is called once at least thresholdBytes went through since
+ * its previous call.
+ *
+ * @note
+ *      The process exits if the period is shorter than LE_MDC_MIN_COUNTER_PERIOD_MS.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mdc_BytesCounterHandlerRef_t le_mdc_AddBytesCounterHandler
+(
+    uint32_t periodMs,
+        ///< [IN] Period at which the counters are checked, in milliseconds.
+
+    uint64_t thresholdBytes,
+        ///< [IN] Bytes (received and transmitted) needed to call the handler.
+
+    le_mdc_BytesCounterHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    if ((periodMs < LE_MDC_MIN_COUNTER_PERIOD_MS) || (handlerPtr == NULL))
+    {
+        LE_KILL_CLIENT("Invalid period (%" PRIu32 " ms) or NULL handler!", periodMs);
+        return NULL;
+    }
+
+    if (!CounterCloseHandlerAdded)
+    {
+        le_msg_AddServiceCloseHandler(le_mdc_GetServiceRef(), CloseSessionEventHandler, NULL);
+        CounterCloseHandlerAdded = true;
+    }
+
+    CounterSub_t* subPtr = le_mem_ForceAlloc(CounterSubPool);
+
+    subPtr->sessionRef = le_mdc_GetClientSessionRef();
+    subPtr->handlerFunc = handlerPtr;
+    subPtr->contextPtr = contextPtr;
+    subPtr->thresholdBytes = thresholdBytes;
+
+    subPtr->timerRef = le_timer_Create("BytesCounter");
+    le_timer_SetMsInterval(subPtr->timerRef, periodMs);
+    le_timer_SetMsTolerance(subPtr->timerRef, periodMs / 4);
+    le_timer_SetRepeat(subPtr->timerRef, 0);
+    le_timer_SetContextPtr(subPtr->timerRef, subPtr);
+    le_timer_SetHandler(subPtr->timerRef, BytesCounterTimerHandler);
+
+    // Only the traffic from now on is reported.
+    UpdateBytesCounters();
+    subPtr->rxBytes = RxBytes;
+    subPtr->txBytes = TxBytes;
+
+    subPtr->ref = le_ref_CreateRef(CounterSubRefMap, subPtr);
+
+    if (NumCountedSessions > 0)
+    {
+        le_timer_Start(subPtr->timerRef);
+    }
+
+    return subPtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_mdc_BytesCounter'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mdc_RemoveBytesCounterHandler
+(
+    le_mdc_BytesCounterHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    CounterSub_t* subPtr = le_ref_Lookup(CounterSubRefMap, handlerRef);
+
+    if ((subPtr == NULL) || (subPtr->sessionRef != le_mdc_GetClientSessionRef()))
+    {
+        LE_ERROR("Invalid bytes counter handler reference %p.", handlerRef);
+        return;
+    }
+
+    DeleteBytesCounterSub(subPtr);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
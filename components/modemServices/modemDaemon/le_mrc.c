@@ -55,6 +55,14 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_NUM_NEIGHBOR_LISTS    5
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum age in milliseconds of the neighboring cells information returned by
+ * le_mrc_GetNeighborCellsInfo(). Within it, clients share the information retrieved last.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NEIGHBOR_CELLS_MAX_AGE_MS 1000
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum number of preferred operator lists we expect to have at one time.
@@ -90,6 +98,13 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_NUM_METRICS 1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of Signal Metrics subscriptions we expect to have at one time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_NUM_METRICS_SUBSCRIPTIONS 5
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex to prevent race condition with asynchronous functions.
@@ -139,15 +154,29 @@ typedef struct
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Neighboring Cells Information list structure.
+ * Neighboring Cells Information snapshot structure.
  *
+ * The neighboring cells information retrieved from the modem, shared (reference counted) by all
+ * the lists created from it. The cells are never modified once retrieved.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
     int32_t             cellsCount;          // number of detected cells
-    le_msg_SessionRef_t sessionRef;          // Message session reference
+    le_clk_Time_t       timestamp;           // when the information was retrieved
     le_dls_List_t       paNgbrCellInfoList;  // list of pa_mrc_CellInfo_t
+} CellSnapshot_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Neighboring Cells Information list structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;          // Message session reference
+    CellSnapshot_t*     snapshotPtr;         // neighboring cells information
     le_dls_List_t       safeRefCellInfoList; // list of CellSafeRef_t
     le_dls_Link_t       *currentLinkPtr;     // link for current CellSafeRef_t reference
 } CellList_t;
@@ -265,6 +294,29 @@ typedef struct
     le_msg_SessionRef_t sessionRef;                  ///< Message session reference.
 } SignalMetrics_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal metrics subscription structure.
+ *
+ * The signal metrics are measured at the requested period, or on the signal strength indications
+ * of the platform adaptor if no period is requested, and reported when the signal strength has
+ * moved by the hysteresis since the last report (or the RAT has changed).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mrc_SignalMetricsHandlerFunc_t handlerFuncPtr;  ///< Handler function.
+    void*                             handlerCtxPtr;   ///< Handler's context.
+    uint32_t                          period;          ///< Measurement period in ms, 0 for
+                                                       ///< signal strength indications.
+    uint32_t                          hysteresis;      ///< Signal strength hysteresis in dBm.
+    bool                              hasReported;     ///< Metrics have been reported.
+    le_mrc_Rat_t                      ratPrevious;     ///< Last reported RAT.
+    int32_t                           ssPrevious;      ///< Last reported signal strength.
+    le_timer_Ref_t                    timerRef;        ///< Measurement timer (period only).
+    le_msg_SessionRef_t               sessionRef;      ///< Message session reference.
+} SignalMetricsSubscription_t;
+
 
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
@@ -276,6 +328,21 @@ typedef struct
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t CellListPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for neighboring cells information snapshots.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CellSnapshotPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last neighboring cells information retrieved from the modem, NULL if it must be retrieved
+ * again.
+ */
+//--------------------------------------------------------------------------------------------------
+static CellSnapshot_t* CellSnapshotPtr;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pool for cell information safe reference.
@@ -405,6 +472,35 @@ static le_mem_PoolRef_t  MetricsSessionPool;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t MetricsRefMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for Signal Metrics subscriptions.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  MetricsSubscriptionPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe Reference Map for Signal Metrics subscriptions (their handler references).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t MetricsSubscriptionRefMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of Signal Metrics subscriptions driven by the signal strength indications.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MetricsIndSubscriptionCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength indication delta (in units of 0.1 dBm) set for the Signal Metrics
+ * subscriptions, 0 if none has been set.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t MetricsIndDelta;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event IDs for Signal Strength notification.
@@ -497,6 +593,87 @@ static void FirstLayerNetRegStateChangeHandler
     le_mem_Release(reportPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor of the neighboring cells information snapshots.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CellSnapshotDestructor
+(
+    void* objPtr
+)
+{
+    CellSnapshot_t* snapshotPtr = (CellSnapshot_t*)objPtr;
+
+    pa_mrc_DeleteNeighborCellsInfo(&(snapshotPtr->paNgbrCellInfoList));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the last neighboring cells information, so that it is retrieved again from the modem.
+ * The lists still using it keep it until they are deleted.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateCellSnapshot
+(
+    void
+)
+{
+    if (NULL != CellSnapshotPtr)
+    {
+        le_mem_Release(CellSnapshotPtr);
+        CellSnapshotPtr = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the neighboring cells information, retrieving it from the modem if the last one is older
+ * than the given age.
+ *
+ * @return The neighboring cells information (to be released by the caller), or NULL if no cells
+ *         information are available.
+ */
+//--------------------------------------------------------------------------------------------------
+static CellSnapshot_t* GetCellSnapshot
+(
+    uint32_t maxAgeMs   ///< [IN] Maximum age of the information in milliseconds.
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    if (NULL != CellSnapshotPtr)
+    {
+        le_clk_Time_t age = le_clk_Sub(now, CellSnapshotPtr->timestamp);
+
+        if (((uint64_t)age.sec * 1000 + age.usec / 1000) >= maxAgeMs)
+        {
+            InvalidateCellSnapshot();
+        }
+    }
+
+    if (NULL == CellSnapshotPtr)
+    {
+        CellSnapshot_t* snapshotPtr = (CellSnapshot_t*)le_mem_ForceAlloc(CellSnapshotPool);
+
+        snapshotPtr->paNgbrCellInfoList = LE_DLS_LIST_INIT;
+        snapshotPtr->timestamp = now;
+        snapshotPtr->cellsCount = pa_mrc_GetNeighborCellsInfo(&(snapshotPtr->paNgbrCellInfoList));
+        if (snapshotPtr->cellsCount <= 0)
+        {
+            le_mem_Release(snapshotPtr);
+            return NULL;
+        }
+
+        CellSnapshotPtr = snapshotPtr;
+    }
+
+    le_mem_AddRef(CellSnapshotPtr);
+    return CellSnapshotPtr;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * New Network Registration State handler function.
@@ -510,6 +687,9 @@ static void NewRegStateHandler
 {
     LE_DEBUG("Handler Function called with regStat %d", *regStatePtr);
 
+    // The neighboring cells have likely changed.
+    InvalidateCellSnapshot();
+
     // Notify all the registered client's handlers
     le_event_ReportWithRefCounting(NewNetRegStateId, regStatePtr);
 }
@@ -594,6 +774,9 @@ static void RatChangeHandler
 {
     LE_DEBUG("Handler Function called with RAT %d", *ratPtr);
 
+    // The neighboring cells have likely changed.
+    InvalidateCellSnapshot();
+
     // Notify all the registered client's handlers
     le_event_ReportWithRefCounting(RatChangeId, ratPtr);
 }
@@ -616,6 +799,130 @@ static void PSChangeHandler
     le_event_ReportWithRefCounting(PSChangeId, serviceStatePtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the signal metrics to a subscription if its hysteresis has been crossed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportSignalMetrics
+(
+    SignalMetricsSubscription_t*  subscriptionPtr,  ///< [IN] The subscription.
+    const pa_mrc_SignalMetrics_t* metricsPtr        ///< [IN] The measured signal metrics.
+)
+{
+    int32_t ecio = INT32_MAX;
+    int32_t rscp = INT32_MAX;
+    int32_t rsrq = INT32_MAX;
+    int32_t rsrp = INT32_MAX;
+    int32_t sinr = INT32_MAX;
+
+    if ((subscriptionPtr->hasReported) &&
+        (subscriptionPtr->ratPrevious == metricsPtr->rat) &&
+        ((uint32_t)abs(metricsPtr->ss - subscriptionPtr->ssPrevious) <
+         subscriptionPtr->hysteresis))
+    {
+        return;
+    }
+
+    switch (metricsPtr->rat)
+    {
+        case LE_MRC_RAT_UMTS:
+            ecio = metricsPtr->umtsMetrics.ecio;
+            break;
+
+        case LE_MRC_RAT_TDSCDMA:
+            ecio = metricsPtr->tdscdmaMetrics.ecio;
+            rscp = metricsPtr->tdscdmaMetrics.rscp;
+            sinr = metricsPtr->tdscdmaMetrics.sinr;
+            break;
+
+        case LE_MRC_RAT_LTE:
+            rsrq = metricsPtr->lteMetrics.rsrq;
+            rsrp = metricsPtr->lteMetrics.rsrp;
+            sinr = metricsPtr->lteMetrics.snr;
+            break;
+
+        case LE_MRC_RAT_CDMA:
+            ecio = metricsPtr->cdmaMetrics.ecio;
+            sinr = metricsPtr->cdmaMetrics.sinr;
+            break;
+
+        default:
+            break;
+    }
+
+    subscriptionPtr->hasReported = true;
+    subscriptionPtr->ratPrevious = metricsPtr->rat;
+    subscriptionPtr->ssPrevious = metricsPtr->ss;
+
+    subscriptionPtr->handlerFuncPtr(metricsPtr->rat, metricsPtr->ss, metricsPtr->er,
+                                    ecio, rscp, rsrq, rsrp, sinr,
+                                    subscriptionPtr->handlerCtxPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measurement timer handler of the periodic Signal Metrics subscriptions.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SignalMetricsTimerHandler
+(
+    le_timer_Ref_t timerRef    ///< [IN] The subscription's timer.
+)
+{
+    SignalMetricsSubscription_t* subscriptionPtr = le_timer_GetContextPtr(timerRef);
+    pa_mrc_SignalMetrics_t metrics;
+
+    if (LE_OK != pa_mrc_MeasureSignalMetrics(&metrics))
+    {
+        LE_DEBUG("Unable to measure the signal metrics");
+        return;
+    }
+
+    ReportSignalMetrics(subscriptionPtr, &metrics);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the signal metrics to the Signal Metrics subscriptions driven by the signal strength
+ * indications. The metrics are measured once for all of them.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportSignalMetricsOnInd
+(
+    void
+)
+{
+    pa_mrc_SignalMetrics_t metrics;
+    le_ref_IterRef_t iterRef;
+
+    if (0 == MetricsIndSubscriptionCount)
+    {
+        return;
+    }
+
+    if (LE_OK != pa_mrc_MeasureSignalMetrics(&metrics))
+    {
+        LE_DEBUG("Unable to measure the signal metrics");
+        return;
+    }
+
+    iterRef = le_ref_GetIterator(MetricsSubscriptionRefMap);
+    while (LE_OK == le_ref_NextNode(iterRef))
+    {
+        SignalMetricsSubscription_t* subscriptionPtr =
+                                (SignalMetricsSubscription_t*)le_ref_GetValue(iterRef);
+
+        if (0 == subscriptionPtr->period)
+        {
+            ReportSignalMetrics(subscriptionPtr, &metrics);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer Signal Strength Change Handler.
@@ -651,6 +958,8 @@ static void SignalStrengthIndHandlerFunc
     LE_INFO("Signal Strength Ind Handler called with RAT.%d and ss.%d",
              ssIndPtr->rat, ssIndPtr->ss);
 
+    ReportSignalMetricsOnInd();
+
     switch(ssIndPtr->rat)
     {
         case LE_MRC_RAT_GSM:
@@ -1248,6 +1557,30 @@ static void CloseSessionEventHandler
         // Get the next value in the reference
         result = le_ref_NextNode(iterRef);
     }
+
+    // Search for all subscriptions of the current client session that has been closed.
+    iterRef = le_ref_GetIterator(MetricsSubscriptionRefMap);
+    result = le_ref_NextNode(iterRef);
+    while (LE_OK == result)
+    {
+        SignalMetricsSubscription_t* subscriptionPtr =
+                                (SignalMetricsSubscription_t*)le_ref_GetValue(iterRef);
+
+        // Check if the session reference saved matchs with the current session reference.
+        if (subscriptionPtr->sessionRef == sessionRef)
+        {
+            le_mrc_SignalMetricsHandlerRef_t safeRef =
+                                (le_mrc_SignalMetricsHandlerRef_t)le_ref_GetSafeRef(iterRef);
+            LE_DEBUG("Call le_mrc_RemoveSignalMetricsHandler 0x%p, Session 0x%p", safeRef,
+                                                                                  sessionRef);
+
+            // Remove the subscription.
+            le_mrc_RemoveSignalMetricsHandler(safeRef);
+        }
+
+        // Get the next value in the reference
+        result = le_ref_NextNode(iterRef);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1282,6 +1615,10 @@ void le_mrc_Init
     // Create the pool for cells information list.
     CellListPool = le_mem_CreatePool("CellListPool", sizeof(CellList_t));
 
+    // Create the pool for cells information snapshots.
+    CellSnapshotPool = le_mem_CreatePool("CellSnapshotPool", sizeof(CellSnapshot_t));
+    le_mem_SetDestructor(CellSnapshotPool, CellSnapshotDestructor);
+
     // Create the pool for Preferred cells information list.
     PrefOpsListPool = le_mem_CreatePool("PrefOpListPool", sizeof(PreferredOperatorsList_t));
 
@@ -1322,6 +1659,12 @@ void le_mrc_Init
     // Create the Safe Reference Map to use for Signal Metrics object Safe References.
     MetricsRefMap = le_ref_CreateMap("MetricsRefMap", MAX_NUM_METRICS);
 
+    // Create the pool and the Safe Reference Map for Signal Metrics subscriptions.
+    MetricsSubscriptionPool = le_mem_CreatePool("MetricsSubscriptionPool",
+                                                sizeof(SignalMetricsSubscription_t));
+    MetricsSubscriptionRefMap = le_ref_CreateMap("MetricsSubscriptionRefMap",
+                                                 MAX_NUM_METRICS_SUBSCRIPTIONS);
+
     // Add a handler to the close session service
     le_msg_ServiceRef_t msgService = le_mrc_GetServiceRef();
     le_msg_AddServiceCloseHandler(msgService, CloseSessionEventHandler, NULL);
@@ -3170,35 +3513,25 @@ le_mrc_NeighborCellsRef_t le_mrc_GetNeighborCellsInfo
     void
 )
 {
-    CellList_t* ngbrCellsInfoListPtr = (CellList_t*)le_mem_ForceAlloc(CellListPool);
+    CellSnapshot_t* snapshotPtr = GetCellSnapshot(NEIGHBOR_CELLS_MAX_AGE_MS);
 
-    if (ngbrCellsInfoListPtr != NULL)
-    {
-        ngbrCellsInfoListPtr->paNgbrCellInfoList = LE_DLS_LIST_INIT;
-        ngbrCellsInfoListPtr->safeRefCellInfoList = LE_DLS_LIST_INIT;
-        ngbrCellsInfoListPtr->currentLinkPtr = NULL;
-        ngbrCellsInfoListPtr->cellsCount = pa_mrc_GetNeighborCellsInfo(
-                                                &(ngbrCellsInfoListPtr->paNgbrCellInfoList));
-        if (ngbrCellsInfoListPtr->cellsCount > 0)
-        {
-            // Save message session reference.
-            ngbrCellsInfoListPtr->sessionRef = le_mrc_GetClientSessionRef();
-
-            // Create and return a Safe Reference for this List object.
-            return le_ref_CreateRef(CellListRefMap, ngbrCellsInfoListPtr);
-        }
-        else
-        {
-            le_mem_Release(ngbrCellsInfoListPtr);
-            LE_WARN("Unable to retrieve the Neighboring Cells information!");
-            return NULL;
-        }
-    }
-    else
+    if (snapshotPtr == NULL)
     {
         LE_WARN("Unable to retrieve the Neighboring Cells information!");
         return NULL;
     }
+
+    CellList_t* ngbrCellsInfoListPtr = (CellList_t*)le_mem_ForceAlloc(CellListPool);
+
+    ngbrCellsInfoListPtr->snapshotPtr = snapshotPtr;
+    ngbrCellsInfoListPtr->safeRefCellInfoList = LE_DLS_LIST_INIT;
+    ngbrCellsInfoListPtr->currentLinkPtr = NULL;
+
+    // Save message session reference.
+    ngbrCellsInfoListPtr->sessionRef = le_mrc_GetClientSessionRef();
+
+    // Create and return a Safe Reference for this List object.
+    return le_ref_CreateRef(CellListRefMap, ngbrCellsInfoListPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -3223,13 +3556,13 @@ void le_mrc_DeleteNeighborCellsInfo
     }
 
     ngbrCellsInfoListPtr->currentLinkPtr = NULL;
-    pa_mrc_DeleteNeighborCellsInfo(&(ngbrCellsInfoListPtr->paNgbrCellInfoList));
 
     // Delete the safe Reference list.
     DeleteCellInfoSafeRefList(&(ngbrCellsInfoListPtr->safeRefCellInfoList));
     // Invalidate the Safe Reference.
     le_ref_DeleteRef(CellListRefMap, ngbrCellsRef);
 
+    le_mem_Release(ngbrCellsInfoListPtr->snapshotPtr);
     le_mem_Release(ngbrCellsInfoListPtr);
 }
 
@@ -3259,7 +3592,7 @@ le_mrc_CellInfoRef_t le_mrc_GetFirstNeighborCellInfo
         return NULL;
     }
 
-    linkPtr = le_dls_Peek(&(ngbrCellsInfoListPtr->paNgbrCellInfoList));
+    linkPtr = le_dls_Peek(&(ngbrCellsInfoListPtr->snapshotPtr->paNgbrCellInfoList));
     if (linkPtr != NULL)
     {
         nodePtr = CONTAINER_OF(linkPtr, pa_mrc_CellInfo_t, link);
@@ -3304,7 +3637,7 @@ le_mrc_CellInfoRef_t le_mrc_GetNextNeighborCellInfo
         return NULL;
     }
 
-    linkPtr = le_dls_PeekNext(&(ngbrCellsInfoListPtr->paNgbrCellInfoList),
+    linkPtr = le_dls_PeekNext(&(ngbrCellsInfoListPtr->snapshotPtr->paNgbrCellInfoList),
         ngbrCellsInfoListPtr->currentLinkPtr);
     if (linkPtr != NULL)
     {
@@ -3523,6 +3856,124 @@ le_result_t le_mrc_GetNeighborCellLteInterFreq
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to get the information of all the neighboring cells at once, in
+ * parallel tables (one entry per cell).
+ *
+ * The information retrieved from the modem by any client less than maxAge milliseconds ago is
+ * returned, instead of retrieving it again. It is always retrieved again after a change of the
+ * network registration state or of the Radio Access Technology.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if no Cells Information are available
+ *
+ * @note If the caller is passing a bad pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mrc_GetNeighborCellsTable
+(
+    uint32_t      maxAge,                       ///< [IN] Maximum age of the information in
+                                                ///< milliseconds (0 to retrieve it from the
+                                                ///< modem)
+    uint32_t*     cellIdPtr,                    ///< [OUT] Cell identifiers
+    size_t*       cellIdNumElementsPtr,         ///< [INOUT]
+    uint32_t*     lacPtr,                       ///< [OUT] Location area codes
+    size_t*       lacNumElementsPtr,            ///< [INOUT]
+    int32_t*      rxLevelPtr,                   ///< [OUT] Signal strengths in dBm
+    size_t*       rxLevelNumElementsPtr,        ///< [INOUT]
+    le_mrc_Rat_t* ratPtr,                       ///< [OUT] Radio Access Technologies
+    size_t*       ratNumElementsPtr,            ///< [INOUT]
+    int32_t*      umtsEcIoPtr,                  ///< [OUT] UMTS Ec/Io in dB with 1 decimal place
+    size_t*       umtsEcIoNumElementsPtr,       ///< [INOUT]
+    int32_t*      lteIntraRsrqPtr,              ///< [OUT] LTE Intrafrequency RSRQ in dB with 1
+                                                ///< decimal place
+    size_t*       lteIntraRsrqNumElementsPtr,   ///< [INOUT]
+    int32_t*      lteIntraRsrpPtr,              ///< [OUT] LTE Intrafrequency RSRP in dBm with 1
+                                                ///< decimal place
+    size_t*       lteIntraRsrpNumElementsPtr,   ///< [INOUT]
+    int32_t*      lteInterRsrqPtr,              ///< [OUT] LTE Interfrequency RSRQ in dB with 1
+                                                ///< decimal place
+    size_t*       lteInterRsrqNumElementsPtr,   ///< [INOUT]
+    int32_t*      lteInterRsrpPtr,              ///< [OUT] LTE Interfrequency RSRP in dBm with 1
+                                                ///< decimal place
+    size_t*       lteInterRsrpNumElementsPtr    ///< [INOUT]
+)
+{
+    size_t* numElementsPtrs[] = { cellIdNumElementsPtr, lacNumElementsPtr,
+                                  rxLevelNumElementsPtr, ratNumElementsPtr,
+                                  umtsEcIoNumElementsPtr,
+                                  lteIntraRsrqNumElementsPtr, lteIntraRsrpNumElementsPtr,
+                                  lteInterRsrqNumElementsPtr, lteInterRsrpNumElementsPtr };
+    size_t maxCount = SIZE_MAX;
+    size_t count = 0;
+    size_t i;
+
+    if ((cellIdPtr == NULL) || (lacPtr == NULL) || (rxLevelPtr == NULL) || (ratPtr == NULL) ||
+        (umtsEcIoPtr == NULL) || (lteIntraRsrqPtr == NULL) || (lteIntraRsrpPtr == NULL) ||
+        (lteInterRsrqPtr == NULL) || (lteInterRsrpPtr == NULL))
+    {
+        LE_KILL_CLIENT("Invalid table pointer provided!");
+        return LE_FAULT;
+    }
+
+    // All the tables are filled with the same number of cells.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(numElementsPtrs); i++)
+    {
+        if (numElementsPtrs[i] == NULL)
+        {
+            LE_KILL_CLIENT("Invalid table size pointer provided!");
+            return LE_FAULT;
+        }
+        if (*numElementsPtrs[i] < maxCount)
+        {
+            maxCount = *numElementsPtrs[i];
+        }
+    }
+
+    CellSnapshot_t* snapshotPtr = GetCellSnapshot(maxAge);
+    if (snapshotPtr == NULL)
+    {
+        LE_WARN("Unable to retrieve the Neighboring Cells information!");
+        return LE_FAULT;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&(snapshotPtr->paNgbrCellInfoList));
+    while ((linkPtr != NULL) && (count < maxCount))
+    {
+        pa_mrc_CellInfo_t* cellInfoPtr = CONTAINER_OF(linkPtr, pa_mrc_CellInfo_t, link);
+
+        cellIdPtr[count] = cellInfoPtr->id;
+        lacPtr[count] = cellInfoPtr->lac;
+        rxLevelPtr[count] = cellInfoPtr->rxLevel;
+        ratPtr[count] = cellInfoPtr->rat;
+        umtsEcIoPtr[count] = cellInfoPtr->umtsEcIo;
+        lteIntraRsrqPtr[count] = cellInfoPtr->lteIntraRsrq;
+        lteIntraRsrpPtr[count] = cellInfoPtr->lteIntraRsrp;
+        lteInterRsrqPtr[count] = cellInfoPtr->lteInterRsrq;
+        lteInterRsrpPtr[count] = cellInfoPtr->lteInterRsrp;
+        count++;
+
+        linkPtr = le_dls_PeekNext(&(snapshotPtr->paNgbrCellInfoList), linkPtr);
+    }
+
+    if (linkPtr != NULL)
+    {
+        LE_WARN("Only %zu of the %d neighboring cells returned", count, snapshotPtr->cellsCount);
+    }
+
+    le_mem_Release(snapshotPtr);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(numElementsPtrs); i++)
+    {
+        *numElementsPtrs[i] = count;
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to measure the signal metrics. It creates and returns a reference
@@ -3993,6 +4444,125 @@ void le_mrc_RemoveSignalStrengthChangeHandler
    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for the signal metrics.
+ *
+ * With a period, the signal metrics are measured at that period; without, they are measured on
+ * the signal strength indications of the modem, which are then set to the hysteresis. In both
+ * cases, they are reported when the signal strength has moved by at least the hysteresis since
+ * the last report, or the Radio Access Technology has changed.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note If the caller is passing a null handler function into this function, it's a fatal error,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mrc_SignalMetricsHandlerRef_t le_mrc_AddSignalMetricsHandler
+(
+    uint32_t                          period,         ///< [IN] Measurement period in ms, 0 to
+                                                      ///<      measure on signal strength
+                                                      ///<      indications
+    uint32_t                          hysteresis,     ///< [IN] Signal strength hysteresis in dBm
+    le_mrc_SignalMetricsHandlerFunc_t handlerFuncPtr, ///< [IN] The handler function
+    void*                             contextPtr      ///< [IN] The handler's context
+)
+{
+    SignalMetricsSubscription_t* subscriptionPtr;
+    le_mrc_SignalMetricsHandlerRef_t handlerRef;
+
+    if (NULL == handlerFuncPtr)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    if (hysteresis > UINT16_MAX / 10)
+    {
+        LE_KILL_CLIENT("Hysteresis %u dBm is too large!", hysteresis);
+        return NULL;
+    }
+
+    subscriptionPtr = le_mem_ForceAlloc(MetricsSubscriptionPool);
+    subscriptionPtr->handlerFuncPtr = handlerFuncPtr;
+    subscriptionPtr->handlerCtxPtr = contextPtr;
+    subscriptionPtr->period = period;
+    subscriptionPtr->hysteresis = hysteresis;
+    subscriptionPtr->hasReported = false;
+    subscriptionPtr->ratPrevious = LE_MRC_RAT_UNKNOWN;
+    subscriptionPtr->ssPrevious = 0;
+    subscriptionPtr->timerRef = NULL;
+    subscriptionPtr->sessionRef = le_mrc_GetClientSessionRef();
+
+    handlerRef = le_ref_CreateRef(MetricsSubscriptionRefMap, subscriptionPtr);
+
+    if (period)
+    {
+        subscriptionPtr->timerRef = le_timer_Create("SignalMetricsTimer");
+        le_timer_SetMsInterval(subscriptionPtr->timerRef, period);
+        le_timer_SetRepeat(subscriptionPtr->timerRef, 0);
+        le_timer_SetContextPtr(subscriptionPtr->timerRef, subscriptionPtr);
+        le_timer_SetHandler(subscriptionPtr->timerRef, SignalMetricsTimerHandler);
+        le_timer_Start(subscriptionPtr->timerRef);
+    }
+    else
+    {
+        uint16_t delta = (hysteresis ? hysteresis * 10 : 1);
+        le_mrc_Rat_t rat;
+
+        MetricsIndSubscriptionCount++;
+
+        // Have the modem indicate the signal strength changes the subscription cares about.
+        if ((0 == MetricsIndDelta) || (delta < MetricsIndDelta))
+        {
+            MetricsIndDelta = delta;
+            for (rat = LE_MRC_RAT_GSM; rat <= LE_MRC_RAT_CDMA; rat++)
+            {
+                if (LE_OK != pa_mrc_SetSignalStrengthIndDelta(rat, delta))
+                {
+                    LE_DEBUG("Unable to set the signal strength indication delta for RAT.%d",
+                             rat);
+                }
+            }
+        }
+    }
+
+    return handlerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove an handler for the signal metrics.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mrc_RemoveSignalMetricsHandler
+(
+    le_mrc_SignalMetricsHandlerRef_t handlerRef ///< [IN] The handler reference.
+)
+{
+    SignalMetricsSubscription_t* subscriptionPtr = le_ref_Lookup(MetricsSubscriptionRefMap,
+                                                                 handlerRef);
+    if (NULL == subscriptionPtr)
+    {
+        LE_ERROR("Invalid reference (%p) provided!", handlerRef);
+        return;
+    }
+
+    le_ref_DeleteRef(MetricsSubscriptionRefMap, handlerRef);
+
+    if (subscriptionPtr->timerRef)
+    {
+        le_timer_Delete(subscriptionPtr->timerRef);
+    }
+    else
+    {
+        MetricsIndSubscriptionCount--;
+    }
+
+    le_mem_Release(subscriptionPtr);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
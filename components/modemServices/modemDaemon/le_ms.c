@@ -19,7 +19,9 @@
 #include "le_temp_local.h"
 #include "le_antenna_local.h"
 #include "le_riPin_local.h"
+#include "le_info_local.h"
 #include "sysResets.h"
+#include "adcSampler.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -40,6 +42,8 @@ COMPONENT_INIT
     le_antenna_Init();
     le_riPin_Init();
     le_ecall_Init();
+    le_info_Init();
+    adcSampler_Init();
     if (LE_OK != sysResets_Init())
     {
         LE_ERROR("Failed to initialize system resets counter");
@@ -57,6 +57,8 @@ typedef struct le_sim_Obj
     char             phoneNumber[LE_MDMDEFS_PHONE_NUM_MAX_BYTES]; /// < The Phone Number.
     bool             isPresent;                  ///< 'isPresent' flag.
     Subscription_t   subscription;               ///< Subscription type
+    le_sim_States_t  state;                      ///< Last known SIM state.
+    bool             isStateValid;               ///< Whether 'state' is up to date.
 }
 Sim_t;
 
@@ -299,6 +301,7 @@ static le_result_t LocalSwap
         return LE_OK;
     }
 
+    SimList[SelectedCard].isStateValid = false;
     return pa_sim_Refresh();
 }
 
@@ -322,11 +325,49 @@ static le_result_t SelectSIMCard
             LE_ERROR("Failed to select sim identifier.%d", simId);
             return LE_NOT_FOUND;
         }
+
+        // State changes are only notified for the selected card.
+        SimList[SelectedCard].isStateValid = false;
         SelectedCard = simId;
     }
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the state of a SIM card, selecting it first.  The state is only read from the modem when
+ * it isn't known yet: it is then kept up to date by the SIM state notifications.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the SIM card could not be selected
+ *      - LE_FAULT if the state could not be read
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetSimState
+(
+    Sim_t*           simPtr,    ///< [IN] The SIM structure.
+    le_sim_States_t* statePtr   ///< [OUT] The SIM state.
+)
+{
+    if (LE_OK != SelectSIMCard(simPtr->simId))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (!simPtr->isStateValid)
+    {
+        if (LE_OK != pa_sim_GetState(&simPtr->state))
+        {
+            return LE_FAULT;
+        }
+        simPtr->isStateValid = true;
+    }
+
+    *statePtr = simPtr->state;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer New SIM state notification Handler.
@@ -459,6 +500,7 @@ static void GetSimCardInformation
             simPtr->isPresent = true;
             simPtr->IMSI[0] = '\0';
             simPtr->EID[0] = '\0';
+            simPtr->phoneNumber[0] = '\0';
             GetICCID(simPtr);
             GetEID(simPtr);
             break;
@@ -496,6 +538,8 @@ static void NewSimStateHandler
         eventPtr->simId, eventPtr);
     simPtr = &SimList[eventPtr->simId];
     GetSimCardInformation(simPtr, eventPtr->state);
+    simPtr->state = eventPtr->state;
+    simPtr->isStateValid = true;
 
     // Discard transitional states
     switch (eventPtr->state)
@@ -513,6 +557,7 @@ static void NewSimStateHandler
     if ( eventPtr->simId != SelectedCard )
     {
         LE_DEBUG("New selected card");
+        SimList[SelectedCard].isStateValid = false;
         SelectedCard = eventPtr->simId;
     }
 
@@ -803,6 +848,7 @@ le_result_t le_sim_Init
         SimList[i].phoneNumber[0] = '\0';
         SimList[i].isPresent = false;
         SimList[i].subscription = UNKNOWN_SUBSCRIPTION;
+        SimList[i].isStateValid = false;
         GetSimCardInformation(&SimList[i], LE_SIM_ABSENT);
     }
 
@@ -923,8 +969,7 @@ le_result_t le_sim_GetICCID
 
     if (0 == simPtr->ICCID[0])
     {
-        if ((LE_OK == SelectSIMCard(simPtr->simId)) &&
-            (LE_OK == pa_sim_GetState(&state)) &&
+        if ((LE_OK == GetSimState(simPtr, &state)) &&
             ((LE_SIM_INSERTED == state) || (LE_SIM_READY == state) || (LE_SIM_BLOCKED == state))
            )
         {
@@ -999,8 +1044,7 @@ le_result_t  le_sim_GetEID
 
     if (0 == simPtr->EID[0])
     {
-        if ((LE_OK == SelectSIMCard(simPtr->simId)) &&
-            (LE_OK == pa_sim_GetState(&state)) &&
+        if ((LE_OK == GetSimState(simPtr, &state)) &&
             ((LE_SIM_INSERTED == state) || (LE_SIM_READY == state) || (LE_SIM_BLOCKED == state))
            )
         {
@@ -1071,8 +1115,7 @@ le_result_t le_sim_GetIMSI
 
     if (0 == simPtr->IMSI[0])
     {
-        if ((LE_OK == SelectSIMCard(simPtr->simId)) &&
-            (LE_OK == pa_sim_GetState(&state)) &&
+        if ((LE_OK == GetSimState(simPtr, &state)) &&
             (LE_SIM_READY == state)
            )
         {
@@ -1131,12 +1174,7 @@ bool le_sim_IsPresent
     }
     simPtr = &SimList[simId];
 
-    if (SelectSIMCard(simId) != LE_OK)
-    {
-        return false;
-    }
-
-    if (pa_sim_GetState(&state) == LE_OK)
+    if (GetSimState(simPtr, &state) == LE_OK)
     {
         if((state != LE_SIM_ABSENT) && (state != LE_SIM_STATE_UNKNOWN))
         {
@@ -1173,12 +1211,13 @@ bool le_sim_IsReady
 {
     le_sim_States_t  state;
 
-    if (SelectSIMCard(simId) != LE_OK)
+    if (simId >= LE_SIM_ID_MAX)
     {
+        LE_ERROR("Invalid simId (%d) provided!", simId);
         return false;
     }
 
-    if (pa_sim_GetState(&state) == LE_OK)
+    if (GetSimState(&SimList[simId], &state) == LE_OK)
     {
         if(state == LE_SIM_READY)
         {
@@ -1249,6 +1288,7 @@ le_result_t le_sim_EnterPIN
 
     // Enter PIN
     le_utf8_Copy(pinloc, pinPtr, sizeof(pinloc), NULL);
+    simPtr->isStateValid = false;
     if(pa_sim_EnterPIN(PA_SIM_PIN,pinloc) != LE_OK)
     {
         LE_ERROR("Failed to enter PIN.%s sim identifier.%d", pinPtr, simId);
@@ -1593,6 +1633,7 @@ le_result_t le_sim_Unblock
     // Unblock card
     le_utf8_Copy(pukloc, pukPtr, sizeof(pukloc), NULL);
     le_utf8_Copy(newpinloc, newpinPtr, sizeof(newpinloc), NULL);
+    simPtr->isStateValid = false;
     if(pa_sim_EnterPUK(PA_SIM_PUK,pukloc, newpinloc) != LE_OK)
     {
         LE_ERROR("Failed to unblock sim identifier.%d", simId);
@@ -1617,12 +1658,13 @@ le_sim_States_t le_sim_GetState
 {
     le_sim_States_t state;
 
-    if (SelectSIMCard(simId) != LE_OK)
+    if (simId >= LE_SIM_ID_MAX)
     {
+        LE_ERROR("Invalid simId (%d) provided!", simId);
         return LE_SIM_STATE_UNKNOWN;
     }
 
-    if (pa_sim_GetState(&state) == LE_OK)
+    if (GetSimState(&SimList[simId], &state) == LE_OK)
     {
         return state;
     }
@@ -1724,7 +1766,7 @@ le_result_t le_sim_GetSubscriberPhoneNumber
     {
         if (SelectSIMCard(simPtr->simId) == LE_OK)
         {
-            if (pa_sim_GetState(&state) == LE_OK)
+            if (GetSimState(simPtr, &state) == LE_OK)
             {
                 LE_DEBUG("Try get the Phone Number of sim identifier.%d in state %d",
                                 simPtr->simId, state);
@@ -2279,6 +2321,7 @@ le_result_t le_sim_Reset
         return LE_FAULT;
     }
 
+    SimList[simId].isStateValid = false;
     if (LE_OK != pa_sim_Reset())
     {
         LE_ERROR("Not able to reset the SIM");
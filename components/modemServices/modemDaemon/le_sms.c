@@ -67,6 +67,14 @@
 //--------------------------------------------------------------------------------------------------
 #define SMS_MAX_SESSION 5
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of protocols (GSM and CDMA) and storage areas (SIM and memory) whose messages are cached.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_CACHE_PROTOCOLS     2
+#define MSG_CACHE_STORAGES      2
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS command Type.
@@ -129,6 +137,8 @@ typedef struct le_sms_Msg
     void*             callBackPtr;                         ///< Callback response.
     void*             ctxPtr;                              ///< Context.
     le_msg_SessionRef_t sessionRef;                        ///< Client session reference.
+    le_clk_Time_t     queuedTime;                          ///< Time the message was queued in
+                                                           ///< the sending thread.
 
     /// SMS Status Report parameters
     uint8_t           messageReference;                             ///< TP Message Reference
@@ -193,6 +203,22 @@ typedef struct
 }
 le_sms_MsgStats_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data structure for the latencies of the messages sent by the sending thread since its queue was
+ * last empty, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;         ///< Number of messages sent.
+    uint64_t queueSum;      ///< Sum of the times spent waiting in the queue.
+    uint32_t queueMax;      ///< Longest time spent waiting in the queue.
+    uint64_t sendSum;       ///< Sum of the times spent sending to the modem.
+    uint32_t sendMax;       ///< Longest time spent sending to the modem.
+}
+SendLatencyStats_t;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -341,6 +367,44 @@ static le_event_Id_t SmsCommandEventId;
 //--------------------------------------------------------------------------------------------------
 static le_sem_Ref_t SmsSem;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the number of sending commands queued in the sending thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t SendQueueMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of sending commands queued in the sending thread, including the one being processed.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SendQueueCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the modem was told that more messages are about to be sent, and whether it supports it.
+ * Only used by the sending thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MoreMsgsToSend = false;
+static bool MoreMsgsToSendSupported = true;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pa_sms_SetMoreMessagesToSend() is optional: platform adaptors (and test simulators) that do not
+ * provide it still link, and behave as if it returned LE_UNSUPPORTED.
+ */
+//--------------------------------------------------------------------------------------------------
+extern __attribute__((weak)) le_result_t pa_sms_SetMoreMessagesToSend(bool moreMessages);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latencies of the messages sent by the sending thread.  Only used by the sending thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static SendLatencyStats_t SendLatencyStats;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure for message statistics.
@@ -363,6 +427,27 @@ static bool StatusReportActivation = false;
 //--------------------------------------------------------------------------------------------------
 static le_dls_List_t  SessionCtxList;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for the decoded copies of the stored messages.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   CachedMsgPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decoded copies of the messages present in the storage areas, indexed by protocol, storage area
+ * and storage index.
+ *
+ * Listing the stored messages only reads from the modem the messages which are not in the cache.
+ * An entry is dropped when the message is deleted, when a new message is indicated at its index,
+ * and for the SIM storage when the SIM state changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sms_Msg_t* MsgCache[MSG_CACHE_PROTOCOLS][MSG_CACHE_STORAGES]
+                             [MAX_NUM_OF_SMS_MSG_IN_STORAGE];
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -964,6 +1049,233 @@ static le_sms_Msg_t* CreateAndPopulateMessage
     return newSmsMsgObjPtr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the message cache entry of a storage location.
+ *
+ * @return The cache entry, or NULL if messages at this location are not cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sms_Msg_t** GetCachedMsgSlot
+(
+    pa_sms_Protocol_t   protocol,       ///< [IN] Protocol of the message.
+    pa_sms_Storage_t    storage,        ///< [IN] Storage used.
+    uint32_t            storageIdx      ///< [IN] Storage index.
+)
+{
+    int protocolIdx;
+    int storageAreaIdx;
+
+    switch (protocol)
+    {
+        case PA_SMS_PROTOCOL_GSM:
+            protocolIdx = 0;
+            break;
+        case PA_SMS_PROTOCOL_CDMA:
+            protocolIdx = 1;
+            break;
+        default:
+            return NULL;
+    }
+
+    switch (storage)
+    {
+        case PA_SMS_STORAGE_SIM:
+            storageAreaIdx = 0;
+            break;
+        case PA_SMS_STORAGE_NV:
+            storageAreaIdx = 1;
+            break;
+        default:
+            return NULL;
+    }
+
+    if (storageIdx >= MAX_NUM_OF_SMS_MSG_IN_STORAGE)
+    {
+        return NULL;
+    }
+
+    return &MsgCache[protocolIdx][storageAreaIdx][storageIdx];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keep a copy of a stored message in the message cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CacheMessage
+(
+    const le_sms_Msg_t* msgPtr          ///< [IN] Message read from the storage.
+)
+{
+    le_sms_Msg_t** slotPtr = GetCachedMsgSlot(msgPtr->protocol, msgPtr->storage,
+                                              msgPtr->storageIdx);
+
+    if (NULL == slotPtr)
+    {
+        return;
+    }
+
+    if (NULL == *slotPtr)
+    {
+        *slotPtr = le_mem_ForceAlloc(CachedMsgPool);
+    }
+
+    memcpy(*slotPtr, msgPtr, sizeof(le_sms_Msg_t));
+
+    // The copy doesn't belong to any client.
+    (*slotPtr)->inAList = false;
+    (*slotPtr)->smsUserCount = 0;
+    (*slotPtr)->delAsked = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the cached copy of the message at a storage location, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UncacheMessage
+(
+    pa_sms_Protocol_t   protocol,       ///< [IN] Protocol of the message.
+    pa_sms_Storage_t    storage,        ///< [IN] Storage used.
+    uint32_t            storageIdx      ///< [IN] Storage index.
+)
+{
+    le_sms_Msg_t** slotPtr = GetCachedMsgSlot(protocol, storage, storageIdx);
+
+    if ((NULL != slotPtr) && (NULL != *slotPtr))
+    {
+        le_mem_Release(*slotPtr);
+        *slotPtr = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the cached copies of all the messages of a storage area.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UncacheStorage
+(
+    pa_sms_Storage_t    storage         ///< [IN] Storage area.
+)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < MAX_NUM_OF_SMS_MSG_IN_STORAGE; idx++)
+    {
+        UncacheMessage(PA_SMS_PROTOCOL_GSM, storage, idx);
+        UncacheMessage(PA_SMS_PROTOCOL_CDMA, storage, idx);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the status of the cached copy of a message, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetCachedMessageStatus
+(
+    const le_sms_Msg_t* msgPtr,         ///< [IN] Stored message.
+    le_sms_Status_t     status          ///< [IN] New status of the message.
+)
+{
+    le_sms_Msg_t** slotPtr = GetCachedMsgSlot(msgPtr->protocol, msgPtr->storage,
+                                              msgPtr->storageIdx);
+
+    if ((NULL != slotPtr) && (NULL != *slotPtr))
+    {
+        (*slotPtr)->pdu.status = status;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new message object for a message present in a storage area. The message is copied from
+ * the message cache if possible, otherwise it is read from the storage area, decoded and cached.
+ *
+ * @return The new message object, or NULL if the message can't be read or is not a received
+ *         message.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sms_Msg_t* CreateStoredMessage
+(
+    uint32_t            storageIdx,     ///< [IN] Storage index.
+    pa_sms_Protocol_t   protocol,       ///< [IN] Protocol to read.
+    le_sms_Status_t     status,         ///< [IN] Status of the message in the storage.
+    pa_sms_Storage_t    storage         ///< [IN] Storage used.
+)
+{
+    le_sms_Msg_t** slotPtr = GetCachedMsgSlot(protocol, storage, storageIdx);
+    le_sms_Msg_t* newSmsMsgObjPtr;
+    pa_sms_Pdu_t messagePdu;
+    pa_sms_Message_t messageConverted;
+    le_result_t res;
+
+    if ((NULL != slotPtr) && (NULL != *slotPtr))
+    {
+        // The status may have been changed outside of this service.
+        (*slotPtr)->pdu.status = status;
+
+        newSmsMsgObjPtr = (le_sms_Msg_t*)le_mem_ForceAlloc(MsgPool);
+        memcpy(newSmsMsgObjPtr, *slotPtr, sizeof(le_sms_Msg_t));
+        return newSmsMsgObjPtr;
+    }
+
+    le_sem_Wait(SmsSem);
+    res = pa_sms_RdPDUMsgFromMem(storageIdx, protocol, storage, &messagePdu);
+    le_sem_Post(SmsSem);
+
+    if (res != LE_OK)
+    {
+        LE_ERROR("pa_sms_RdMsgFromMem failed");
+        return NULL;
+    }
+
+    if (messagePdu.dataLen > LE_SMS_PDU_MAX_BYTES)
+    {
+        LE_ERROR("PDU length out of range (%u) for message %d !",
+                        messagePdu.dataLen,
+                        storageIdx);
+        return NULL;
+    }
+
+    // Try to decode message.
+    if (smsPdu_Decode(messagePdu.protocol,
+                      messagePdu.data,
+                      messagePdu.dataLen,
+                      true,
+                      &messageConverted) == LE_OK)
+    {
+        if (messageConverted.type == PA_SMS_SUBMIT)
+        {
+            LE_WARN("Unexpected message type %d for message %d",
+                            messageConverted.type,
+                            storageIdx);
+            return NULL;
+        }
+
+        newSmsMsgObjPtr = CreateAndPopulateMessage(storageIdx, &messagePdu, &messageConverted);
+    }
+    else
+    {
+        LE_WARN("Could not decode the message (idx.%d)", storageIdx);
+        newSmsMsgObjPtr = CreateMessage(storageIdx, &messagePdu);
+    }
+
+    if (newSmsMsgObjPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Store sms area storage information.
+    newSmsMsgObjPtr->storage = storage;
+
+    CacheMessage(newSmsMsgObjPtr);
+
+    return newSmsMsgObjPtr;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieve messages from memory. A new message object is created for each retrieved message and
@@ -977,12 +1289,12 @@ static int32_t GetMessagesFromMem
 (
     le_sms_List_t      *msgListObjPtr, ///< [OUT]List of received messages.
     pa_sms_Protocol_t   protocol,      ///< [IN] protocol to read.
+    le_sms_Status_t     status,        ///< [IN] status of the messages.
     uint32_t            numOfMsg,      ///< [IN]Number of message to read from memory.
     uint32_t           *arrayPtr,      ///< [IN]Array of message indexes.
     pa_sms_Storage_t    storage        ///< [IN] Storage used.
 )
 {
-    pa_sms_Pdu_t messagePdu;
     uint32_t     i;
     uint32_t     numOfQueuedMsg=0;
 
@@ -998,103 +1310,31 @@ static int32_t GetMessagesFromMem
     // Get Unread messages.
     for (i=0 ; i < numOfMsg ; i++)
     {
-        // Try to read message for protocol mode.
-        le_result_t res;
-
-        le_sem_Wait(SmsSem);
-        res = pa_sms_RdPDUMsgFromMem(arrayPtr[i],protocol, storage, &messagePdu);
-        le_sem_Post(SmsSem);
-
-        if (res != LE_OK)
+        le_sms_Msg_t* newSmsMsgObjPtr = CreateStoredMessage(arrayPtr[i], protocol, status,
+                                                            storage);
+        if (newSmsMsgObjPtr == NULL)
         {
-            LE_ERROR("pa_sms_RdMsgFromMem failed");
+            LE_ERROR("Cannot create a new message object! Jump to next one...");
             continue;
         }
+        newSmsMsgObjPtr->inAList = true;
 
-        if (messagePdu.dataLen > LE_SMS_PDU_MAX_BYTES)
-        {
-            LE_ERROR("PDU length out of range (%u) for message %d !",
-                            messagePdu.dataLen,
-                            arrayPtr[i]);
-            continue;
-        }
+        // Allocate a new node message for the List SMS Message node.
+        le_sms_MsgReference_t* newReferencePtr =
+                        (le_sms_MsgReference_t*)le_mem_ForceAlloc(ReferencePool);
 
-        // Try to decode message.
-        pa_sms_Message_t messageConverted;
+        // Create a Safe Reference for this Message object.
+        newReferencePtr->msgRef = le_ref_CreateRef(MsgRefMap, newSmsMsgObjPtr);
+        (newSmsMsgObjPtr->smsUserCount)++;
 
-        if (smsPdu_Decode(messagePdu.protocol,
-                          messagePdu.data,
-                          messagePdu.dataLen,
-                          true,
-                          &messageConverted) == LE_OK)
-        {
-            if (messageConverted.type != PA_SMS_SUBMIT)
-            {
-                le_sms_Msg_t* newSmsMsgObjPtr = CreateAndPopulateMessage(arrayPtr[i],
-                                &messagePdu,
-                                &messageConverted);
-                if (newSmsMsgObjPtr == NULL)
-                {
-                    LE_ERROR("Cannot create a new message object! Jump to next one...");
-                    continue;
-                }
-                // Store sms area storage information.
-                newSmsMsgObjPtr->storage = storage;
-                newSmsMsgObjPtr->inAList = true;
-
-                // Allocate a new node message for the List SMS Message node.
-                le_sms_MsgReference_t* newReferencePtr =
-                                (le_sms_MsgReference_t*)le_mem_ForceAlloc(ReferencePool);
-
-                // Create a Safe Reference for this Message object.
-                newReferencePtr->msgRef = le_ref_CreateRef(MsgRefMap, newSmsMsgObjPtr);
-                (newSmsMsgObjPtr->smsUserCount)++;
-
-                LE_DEBUG("create reference node[%p], obj[%p], ref[%p], cpt (%d)",
-                    newReferencePtr, newSmsMsgObjPtr,
-                    newReferencePtr->msgRef, newSmsMsgObjPtr->smsUserCount);
-
-                newReferencePtr->listLink = LE_DLS_LINK_INIT;
-                // Insert the message in the List SMS Message node.
-                le_dls_Queue(&(msgListObjPtr->list), &(newReferencePtr->listLink));
-                numOfQueuedMsg++;
-            }
-            else
-            {
-                LE_WARN("Unexpected message type %d for message %d",
-                                messageConverted.type,
-                                arrayPtr[i]);
-            }
-        }
-        else
-        {
-            LE_WARN("Could not decode the message (idx.%d)", arrayPtr[i]);
-            le_sms_Msg_t* newSmsMsgObjPtr = CreateMessage(arrayPtr[i], &messagePdu);
-            if (newSmsMsgObjPtr == NULL)
-            {
-                LE_ERROR("Cannot create a new message object! Jump to next one...");
-                continue;
-            }
-            // Store sms area storage information.
-            newSmsMsgObjPtr->storage = storage;
-            newSmsMsgObjPtr->inAList = true;
-
-            // Allocate a new node message for the List SMS Message node.
-            le_sms_MsgReference_t* newReferencePtr =
-                            (le_sms_MsgReference_t*)le_mem_ForceAlloc(ReferencePool);
-            // Create a Safe Reference for this Message object.
-            newReferencePtr->msgRef = le_ref_CreateRef(MsgRefMap, newSmsMsgObjPtr);
-            (newSmsMsgObjPtr->smsUserCount)++;
-
-            LE_DEBUG("create reference node[%p], obj[%p], ref[%p], cpt (%d)",
-                newReferencePtr, newSmsMsgObjPtr,
-                newReferencePtr->msgRef, newSmsMsgObjPtr->smsUserCount);
-
-            newReferencePtr->listLink = LE_DLS_LINK_INIT;
-            // Insert the message in the List SMS Message node.
-            le_dls_Queue(&(msgListObjPtr->list), &(newReferencePtr->listLink));
-            numOfQueuedMsg++;
-        }
+        LE_DEBUG("create reference node[%p], obj[%p], ref[%p], cpt (%d)",
+            newReferencePtr, newSmsMsgObjPtr,
+            newReferencePtr->msgRef, newSmsMsgObjPtr->smsUserCount);
+
+        newReferencePtr->listLink = LE_DLS_LINK_INIT;
+        // Insert the message in the List SMS Message node.
+        le_dls_Queue(&(msgListObjPtr->list), &(newReferencePtr->listLink));
+        numOfQueuedMsg++;
     }
 
     return numOfQueuedMsg;
@@ -1145,7 +1385,7 @@ static int32_t ListReceivedMessages
     {
         int32_t retValue;
 
-        retValue = GetMessagesFromMem(msgListObjPtr, protocol, numTot, idxArray, storage);
+        retValue = GetMessagesFromMem(msgListObjPtr, protocol, status, numTot, idxArray, storage);
         if(retValue == LE_FAULT)
         {
             LE_WARN("No message retrieve for protocol %d", protocol);
@@ -1652,6 +1892,14 @@ static void NewSmsHandler
 
     le_dls_Link_t* linkPtr = le_dls_Peek(&SessionCtxList);
 
+    // A message previously stored at this index is not there anymore.
+    if (newMessageIndicationPtr->storage != PA_SMS_STORAGE_NONE)
+    {
+        UncacheMessage(newMessageIndicationPtr->protocol,
+                       newMessageIndicationPtr->storage,
+                       newMessageIndicationPtr->msgIndex);
+    }
+
     // For all sessions, check if any handlers are present.
     while (linkPtr)
     {
@@ -1746,6 +1994,9 @@ static void NewSmsHandler
 
     newSmsMsgObjPtr->storage = newMessageIndicationPtr->storage;
 
+    // Keep the decoded message for the next listings of the storage.
+    CacheMessage(newSmsMsgObjPtr);
+
     // Update received message count if necessary
     if (MessageStats.counting)
     {
@@ -2051,6 +2302,127 @@ static void AsynSmsTimerHandler
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of milliseconds elapsed since a relative time.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetElapsedMs
+(
+    le_clk_Time_t startTime     ///< [IN] Relative time to count from.
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (uint32_t)(elapsed.sec * 1000 + elapsed.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a sending command from the queue of the sending thread.
+ *
+ * @return The number of sending commands still queued behind it.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t DequeueSendCommand
+(
+    void
+)
+{
+    uint32_t count;
+
+    le_mutex_Lock(SendQueueMutex);
+    if (SendQueueCount > 0)
+    {
+        SendQueueCount--;
+    }
+    count = SendQueueCount;
+    le_mutex_Unlock(SendQueueMutex);
+
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell the modem whether more messages are about to be sent, if it changed since last time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetMoreMsgsToSend
+(
+    bool moreMsgs       ///< [IN] More messages are about to be sent.
+)
+{
+    if ((!MoreMsgsToSendSupported) || (moreMsgs == MoreMsgsToSend))
+    {
+        return;
+    }
+
+    if (NULL == pa_sms_SetMoreMessagesToSend)
+    {
+        LE_INFO("Modem can't keep the link open between messages");
+        MoreMsgsToSendSupported = false;
+        return;
+    }
+
+    le_sem_Wait(SmsSem);
+    le_result_t res = pa_sms_SetMoreMessagesToSend(moreMsgs);
+    le_sem_Post(SmsSem);
+
+    if (LE_OK == res)
+    {
+        MoreMsgsToSend = moreMsgs;
+    }
+    else if (LE_UNSUPPORTED == res)
+    {
+        LE_INFO("Modem can't keep the link open between messages");
+        MoreMsgsToSendSupported = false;
+    }
+    else
+    {
+        LE_WARN("Failed to set more messages to send to %d", moreMsgs);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the latencies of a message sent by the sending thread, and log the latencies of all the
+ * messages sent since the queue was last empty when it is empty again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordSendLatency
+(
+    le_sms_MsgRef_t messageRef,     ///< [IN] The message sent.
+    uint32_t        queueMs,        ///< [IN] Time spent waiting in the queue.
+    uint32_t        sendMs,         ///< [IN] Time spent sending to the modem.
+    bool            queueEmpty      ///< [IN] No other message is queued.
+)
+{
+    LE_DEBUG("Message (%p) queued for %"PRIu32" ms, sent in %"PRIu32" ms",
+             messageRef, queueMs, sendMs);
+
+    SendLatencyStats.count++;
+    SendLatencyStats.queueSum += queueMs;
+    SendLatencyStats.sendSum += sendMs;
+    if (queueMs > SendLatencyStats.queueMax)
+    {
+        SendLatencyStats.queueMax = queueMs;
+    }
+    if (sendMs > SendLatencyStats.sendMax)
+    {
+        SendLatencyStats.sendMax = sendMs;
+    }
+
+    if (queueEmpty)
+    {
+        LE_INFO("%"PRIu32" message(s) sent: queued for %"PRIu64" ms on average, %"PRIu32" ms max,"
+                " sent in %"PRIu64" ms on average, %"PRIu32" ms max",
+                SendLatencyStats.count,
+                SendLatencyStats.queueSum / SendLatencyStats.count, SendLatencyStats.queueMax,
+                SendLatencyStats.sendSum / SendLatencyStats.count, SendLatencyStats.sendMax);
+        memset(&SendLatencyStats, 0, sizeof(SendLatencyStats));
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function send a message in asynchrone mode.
@@ -2140,6 +2512,11 @@ static le_result_t SendAsyncSMS
                 msgCommand.msgRef = msgRef;
                 msgPtr->callBackPtr = callBack;
                 msgPtr->ctxPtr = context;
+                msgPtr->queuedTime = le_clk_GetRelativeTime();
+
+                le_mutex_Lock(SendQueueMutex);
+                SendQueueCount++;
+                le_mutex_Unlock(SendQueueMutex);
 
                 LE_INFO("Send Send command for message (%p)", msgRef);
                 le_event_Report(SmsCommandEventId, &msgCommand, sizeof(msgCommand));
@@ -2175,6 +2552,10 @@ static void ProcessSmsSendingCommandHandler
     uint32_t command = ((CmdRequest_t*) msgCommand)->command;
     le_sms_MsgRef_t messageRef = ((CmdRequest_t*) msgCommand)->msgRef;
 
+    // Keep the link open after this message if others are queued behind it.
+    bool moreMsgs = (DequeueSendCommand() > 0);
+    SetMoreMsgsToSend(moreMsgs);
+
     le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, messageRef);
 
     if (NULL == msgPtr)
@@ -2218,9 +2599,13 @@ static void ProcessSmsSendingCommandHandler
                 }
                 else
                 {
+                    uint32_t queueMs = GetElapsedMs(msgPtr->queuedTime);
+                    le_clk_Time_t sendTime = le_clk_GetRelativeTime();
+
                     res = pa_sms_SendPduMsg(msgPtr->protocol,
                                     msgPtr->pdu.dataLen, msgPtr->pdu.data,
                                     remainingTime, &msgPtr->pdu.errorCode);
+                    RecordSendLatency(messageRef, queueMs, GetElapsedMs(sendTime), !moreMsgs);
                     if (LE_OK == res)
                     {
                         msgPtr->pdu.status = LE_SMS_SENT;
@@ -2340,6 +2725,24 @@ static void CloseSessionEventHandler
 //                                       Public declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * SIM state handler function: the content of the SIM storage may have changed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SimStateHandler
+(
+    pa_sim_Event_t* eventPtr    ///< [IN] New SIM state.
+)
+{
+    LE_DEBUG("SIM state %d, drop the cached SIM messages", eventPtr->state);
+
+    UncacheStorage(PA_SMS_STORAGE_SIM);
+
+    le_mem_Release(eventPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the SMS operations component.
@@ -2383,6 +2786,9 @@ le_result_t le_sms_Init
     MsgRefPool = le_mem_CreatePool("MsgRefPool", sizeof(MsgRefNode_t));
     le_mem_ExpandPool(MsgRefPool, SMS_MAX_SESSION*MAX_NUM_OF_SMS_MSG);
 
+    // Create a pool for the message cache. It grows with the number of stored messages.
+    CachedMsgPool = le_mem_CreatePool("SmsCachedMsgPool", sizeof(le_sms_Msg_t));
+
     // Create pool for received message handler.
     HandlerPool = le_mem_CreatePool("HandlerPool", sizeof(HandlerCtxNode_t));
     le_mem_ExpandPool(HandlerPool, SMS_MAX_SESSION);
@@ -2408,7 +2814,14 @@ le_result_t le_sms_Init
         LE_WARN("failed to register a handler function for SMS storage");
     }
 
+    // Register a handler function for SIM state changes, to keep the message cache in sync.
+    if (pa_sim_AddNewStateHandler(SimStateHandler) == NULL)
+    {
+        LE_WARN("failed to register a handler function for SIM state");
+    }
+
     SmsSem = le_sem_Create("SmsSem", 1);
+    SendQueueMutex = le_mutex_CreateNonRecursive("SmsSendQueueMutex");
 
     // Init the SMS command Event Id.
     SmsCommandEventId = le_event_CreateId("SmsSendCmd", sizeof(CmdRequest_t));
@@ -4130,6 +4543,9 @@ le_result_t le_sms_DeleteFromStorage
         resp = pa_sms_DelMsgFromMem(msgPtr->storageIdx, msgPtr->protocol, msgPtr->storage);
         le_sem_Post(SmsSem);
 
+        // Whatever the result, read the storage location again on the next listing.
+        UncacheMessage(msgPtr->protocol, msgPtr->storage, msgPtr->storageIdx);
+
         if ((LE_COMM_ERROR == resp) || (LE_TIMEOUT == resp))
         {
             return LE_NO_MEMORY;
@@ -4350,6 +4766,7 @@ void le_sms_MarkRead
                     msgPtr->storage) == LE_OK)
     {
         msgPtr->pdu.status = LE_SMS_RX_READ;
+        SetCachedMessageStatus(msgPtr, LE_SMS_RX_READ);
     }
     le_sem_Post(SmsSem);
 
@@ -4381,6 +4798,7 @@ void le_sms_MarkUnread
                     msgPtr->storage) == LE_OK)
     {
         msgPtr->pdu.status = LE_SMS_RX_UNREAD;
+        SetCachedMessageStatus(msgPtr, LE_SMS_RX_UNREAD);
     }
     le_sem_Post(SmsSem);
 }
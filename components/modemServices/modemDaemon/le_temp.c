@@ -11,6 +11,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_temp.h"
+#include "le_temp_local.h"
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -401,7 +402,6 @@ le_temp_SensorRef_t le_temp_Request
 )
 {
     size_t              length;
-    SensorCtx_t*        currentPtr=NULL;
     le_temp_SensorRef_t sensorRef;
 
     LE_DEBUG("call marker.");
@@ -423,48 +423,87 @@ le_temp_SensorRef_t le_temp_Request
         return NULL;
     }
 
+    sensorRef = le_temp_AcquireSensor(sensorPtr);
+    if (sensorRef == NULL)
+    {
+        return NULL;
+    }
+
+    // Create session reference list which associate to the sensor reference.
+    SessionRefNode_t* sessionRefNodePtr = le_mem_ForceAlloc(SessionRefPool);
+    sessionRefNodePtr->ref = sensorRef;
+    sessionRefNodePtr->sessionRef = le_temp_GetClientSessionRef();
+    sessionRefNodePtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&SessionRefList, &sessionRefNodePtr->link);
+
+    return sensorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a reference to a temperature sensor for use inside the Modem Services, without tying it to
+ * a client session.  The reference must be given back with le_temp_ReleaseSensor().
+ *
+ * @return
+ *      - Reference to the temperature sensor.
+ *      - NULL when the requested sensor is not supported.
+ */
+//--------------------------------------------------------------------------------------------------
+le_temp_SensorRef_t le_temp_AcquireSensor
+(
+    const char*  sensorPtr ///< [IN] Name of the temperature sensor.
+)
+{
+    SensorCtx_t*        currentPtr;
+    le_temp_SensorRef_t sensorRef;
+
     // Check if this sensor already exists
     if ((sensorRef = FindSensorRef(sensorPtr)) != NULL)
     {
         SensorCtx_t* sensorCtxPtr = le_ref_Lookup(SensorRefMap, sensorRef);
         le_mem_AddRef(sensorCtxPtr);
 
-        // Create session reference list which associate to the sensor reference.
-        SessionRefNode_t* sessionRefNodePtr = le_mem_ForceAlloc(SessionRefPool);
-        sessionRefNodePtr->ref = sensorRef;
-        sessionRefNodePtr->sessionRef = le_temp_GetClientSessionRef();
-        sessionRefNodePtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&SessionRefList, &(sessionRefNodePtr->link));
-
         return sensorRef;
     }
-    else
+
+    currentPtr = le_mem_ForceAlloc(SensorPool);
+
+    if (LE_OK == pa_temp_Request(sensorPtr,
+                        (le_temp_Handle_t)currentPtr,
+                        &currentPtr->paHandle))
     {
-        currentPtr = le_mem_ForceAlloc(SensorPool);
+        currentPtr->ref = le_ref_CreateRef(SensorRefMap, currentPtr);
 
-        if (LE_OK == pa_temp_Request(sensorPtr,
-                            (le_temp_Handle_t)currentPtr,
-                            &currentPtr->paHandle))
-        {
-            currentPtr->ref = le_ref_CreateRef(SensorRefMap, currentPtr);
+        LE_DEBUG("Create a new sensor reference (%p)", currentPtr->ref);
+        return currentPtr->ref;
+    }
+    else
+    {
+        le_mem_Release(currentPtr);
+        LE_DEBUG("This sensor (%s) doesn't exist on your platform", sensorPtr);
+        return NULL;
+    }
+}
 
-            // Create session reference list which associate to the sensor reference.
-            SessionRefNode_t* sessionRefNodePtr = le_mem_ForceAlloc(SessionRefPool);
-            sessionRefNodePtr->ref = currentPtr->ref;
-            sessionRefNodePtr->sessionRef = le_temp_GetClientSessionRef();
-            sessionRefNodePtr->link = LE_DLS_LINK_INIT;
-            le_dls_Queue(&SessionRefList, &sessionRefNodePtr->link);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give back a temperature sensor reference obtained with le_temp_AcquireSensor().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_temp_ReleaseSensor
+(
+    le_temp_SensorRef_t sensorRef ///< [IN] Temperature sensor reference.
+)
+{
+    SensorCtx_t* sensorCtxPtr = le_ref_Lookup(SensorRefMap, sensorRef);
 
-            LE_DEBUG("Create a new sensor reference (%p)", currentPtr->ref);
-            return currentPtr->ref;
-        }
-        else
-        {
-            le_mem_Release(currentPtr);
-            LE_DEBUG("This sensor (%s) doesn't exist on your platform", sensorPtr);
-            return NULL;
-        }
+    if (sensorCtxPtr == NULL)
+    {
+        LE_ERROR("Invalid reference (%p) provided!", sensorRef);
+        return;
     }
+
+    le_mem_Release(sensorCtxPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
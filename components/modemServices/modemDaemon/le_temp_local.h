@@ -16,4 +16,29 @@ void le_temp_Init
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a reference to a temperature sensor for use inside the Modem Services, without tying it to
+ * a client session.  The reference must be given back with le_temp_ReleaseSensor().
+ *
+ * @return
+ *      - Reference to the temperature sensor.
+ *      - NULL when the requested sensor is not supported.
+ */
+//--------------------------------------------------------------------------------------------------
+le_temp_SensorRef_t le_temp_AcquireSensor
+(
+    const char*  sensorPtr ///< [IN] Name of the temperature sensor.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give back a temperature sensor reference obtained with le_temp_AcquireSensor().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_temp_ReleaseSensor
+(
+    le_temp_SensorRef_t sensorRef ///< [IN] Temperature sensor reference.
+);
+
 #endif // LEGATO_LETEMP_LOCAL_INCLUDE_GUARD
@@ -559,6 +559,22 @@ static void DumpPdu
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Septets are packed by words of 8 septets into 7 bytes: the 7-bit conversions handle a whole word
+ * at once with a 64-bit integer, and only fall back to septet by septet accesses at the edges.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEPTETS_PER_WORD    8
+#define BYTES_PER_WORD      7
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of septets that a PDU can hold, which bounds the unpacked septet buffers of the
+ * 7-bit conversions.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SEPTETS         ((LE_SMS_PDU_MAX_BYTES * SEPTETS_PER_WORD) / BYTES_PER_WORD)
 
 static inline unsigned int Read7Bits
 (
@@ -575,59 +591,211 @@ static inline unsigned int Read7Bits
     return (a|b) & 0x7F;
 }
 
-static inline void Write7Bits
+static inline unsigned int ReadCdma7Bits
 (
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
+    const uint8_t* bufferPtr,
+    uint32_t       pos
 )
 {
-    val &= 0x7F;
     uint8_t idx = pos/8;
 
+    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack septets, GSM packing (first septet in the least significant bits).
+ */
+//--------------------------------------------------------------------------------------------------
+static void Unpack7Bits
+(
+    const uint8_t *bufferPtr,   ///< [IN] packed septets
+    uint32_t       first,       ///< [IN] index of the first septet to unpack
+    uint32_t       count,       ///< [IN] number of septets to unpack
+    uint8_t       *septetPtr    ///< [OUT] unpacked septets
+)
+{
+    uint32_t i = first;
+    uint32_t end = first + count;
 
-    if (!(pos&7)) {
-        bufferPtr[idx] = val;
+    while ((i < end) && (i % SEPTETS_PER_WORD))
+    {
+        *septetPtr++ = Read7Bits(bufferPtr, i++ * 7);
     }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<1);
+
+    while (end - i >= SEPTETS_PER_WORD)
+    {
+        const uint8_t* wordPtr = &bufferPtr[(i / SEPTETS_PER_WORD) * BYTES_PER_WORD];
+        uint64_t word = (uint64_t)wordPtr[0]         | ((uint64_t)wordPtr[1] << 8)  |
+                        ((uint64_t)wordPtr[2] << 16) | ((uint64_t)wordPtr[3] << 24) |
+                        ((uint64_t)wordPtr[4] << 32) | ((uint64_t)wordPtr[5] << 40) |
+                        ((uint64_t)wordPtr[6] << 48);
+
+        // Independent shifts, so that the septets are extracted in parallel
+        septetPtr[0] = word & 0x7F;
+        septetPtr[1] = (word >> 7) & 0x7F;
+        septetPtr[2] = (word >> 14) & 0x7F;
+        septetPtr[3] = (word >> 21) & 0x7F;
+        septetPtr[4] = (word >> 28) & 0x7F;
+        septetPtr[5] = (word >> 35) & 0x7F;
+        septetPtr[6] = (word >> 42) & 0x7F;
+        septetPtr[7] = (word >> 49) & 0x7F;
+
+        septetPtr += SEPTETS_PER_WORD;
+        i += SEPTETS_PER_WORD;
     }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<(pos&7));
-        bufferPtr[idx+1] = (val>>(8-(pos&7)));
+
+    while (i < end)
+    {
+        *septetPtr++ = Read7Bits(bufferPtr, i++ * 7);
     }
 }
 
-static inline unsigned int ReadCdma7Bits
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack septets from the start of a buffer, GSM packing (first septet in the least significant
+ * bits).
+ */
+//--------------------------------------------------------------------------------------------------
+static void Pack7Bits
 (
-    const uint8_t* bufferPtr,
-    uint32_t       pos
+    const uint8_t *septetPtr,   ///< [IN] septets to pack
+    uint32_t       count,       ///< [IN] number of septets
+    uint8_t       *bufferPtr    ///< [OUT] packed septets
 )
 {
-    uint8_t idx = pos/8;
+    while (count >= SEPTETS_PER_WORD)
+    {
+        uint64_t word = (uint64_t)(septetPtr[0] & 0x7F)         |
+                        ((uint64_t)(septetPtr[1] & 0x7F) << 7)  |
+                        ((uint64_t)(septetPtr[2] & 0x7F) << 14) |
+                        ((uint64_t)(septetPtr[3] & 0x7F) << 21) |
+                        ((uint64_t)(septetPtr[4] & 0x7F) << 28) |
+                        ((uint64_t)(septetPtr[5] & 0x7F) << 35) |
+                        ((uint64_t)(septetPtr[6] & 0x7F) << 42) |
+                        ((uint64_t)(septetPtr[7] & 0x7F) << 49);
 
-    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
+        bufferPtr[0] = word;
+        bufferPtr[1] = word >> 8;
+        bufferPtr[2] = word >> 16;
+        bufferPtr[3] = word >> 24;
+        bufferPtr[4] = word >> 32;
+        bufferPtr[5] = word >> 40;
+        bufferPtr[6] = word >> 48;
+
+        bufferPtr += BYTES_PER_WORD;
+        septetPtr += SEPTETS_PER_WORD;
+        count -= SEPTETS_PER_WORD;
+    }
+
+    if (count > 0)
+    {
+        uint64_t word = 0;
+        uint32_t j;
+
+        for (j = 0; j < count; j++)
+        {
+            word |= (uint64_t)(septetPtr[j] & 0x7F) << (7 * j);
+        }
+        for (j = 0; j < ((count * 7) + 7) / 8; j++)
+        {
+            bufferPtr[j] = word >> (8 * j);
+        }
+    }
 }
 
-static inline void WriteCdma7Bits
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack septets from the start of a buffer, CDMA packing (first septet in the most significant
+ * bits).
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnpackCdma7Bits
 (
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
+    const uint8_t *bufferPtr,   ///< [IN] packed septets
+    uint32_t       count,       ///< [IN] number of septets to unpack
+    uint8_t       *septetPtr    ///< [OUT] unpacked septets
 )
 {
-    val &= 0x7F;
-    uint8_t idx = pos/8;
+    uint32_t i = 0;
+
+    while (count - i >= SEPTETS_PER_WORD)
+    {
+        const uint8_t* wordPtr = &bufferPtr[(i / SEPTETS_PER_WORD) * BYTES_PER_WORD];
+        uint64_t word = ((uint64_t)wordPtr[0] << 48) | ((uint64_t)wordPtr[1] << 40) |
+                        ((uint64_t)wordPtr[2] << 32) | ((uint64_t)wordPtr[3] << 24) |
+                        ((uint64_t)wordPtr[4] << 16) | ((uint64_t)wordPtr[5] << 8)  |
+                        (uint64_t)wordPtr[6];
 
-    if (!(pos&7)) {
-        bufferPtr[idx] = val << 1;
+        septetPtr[0] = (word >> 49) & 0x7F;
+        septetPtr[1] = (word >> 42) & 0x7F;
+        septetPtr[2] = (word >> 35) & 0x7F;
+        septetPtr[3] = (word >> 28) & 0x7F;
+        septetPtr[4] = (word >> 21) & 0x7F;
+        septetPtr[5] = (word >> 14) & 0x7F;
+        septetPtr[6] = (word >> 7) & 0x7F;
+        septetPtr[7] = word & 0x7F;
+
+        septetPtr += SEPTETS_PER_WORD;
+        i += SEPTETS_PER_WORD;
     }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | val;
+
+    while (i < count)
+    {
+        *septetPtr++ = ReadCdma7Bits(bufferPtr, i++ * 7);
     }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val>>((pos&7)-1));
-        bufferPtr[idx+1] = ((val<<(8-((pos&7)-1)))&0xff);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack septets from the start of a buffer, CDMA packing (first septet in the most significant
+ * bits).
+ */
+//--------------------------------------------------------------------------------------------------
+static void PackCdma7Bits
+(
+    const uint8_t *septetPtr,   ///< [IN] septets to pack
+    uint32_t       count,       ///< [IN] number of septets
+    uint8_t       *bufferPtr    ///< [OUT] packed septets
+)
+{
+    while (count >= SEPTETS_PER_WORD)
+    {
+        uint64_t word = ((uint64_t)(septetPtr[0] & 0x7F) << 49) |
+                        ((uint64_t)(septetPtr[1] & 0x7F) << 42) |
+                        ((uint64_t)(septetPtr[2] & 0x7F) << 35) |
+                        ((uint64_t)(septetPtr[3] & 0x7F) << 28) |
+                        ((uint64_t)(septetPtr[4] & 0x7F) << 21) |
+                        ((uint64_t)(septetPtr[5] & 0x7F) << 14) |
+                        ((uint64_t)(septetPtr[6] & 0x7F) << 7)  |
+                        (uint64_t)(septetPtr[7] & 0x7F);
+
+        bufferPtr[0] = word >> 48;
+        bufferPtr[1] = word >> 40;
+        bufferPtr[2] = word >> 32;
+        bufferPtr[3] = word >> 24;
+        bufferPtr[4] = word >> 16;
+        bufferPtr[5] = word >> 8;
+        bufferPtr[6] = word;
+
+        bufferPtr += BYTES_PER_WORD;
+        septetPtr += SEPTETS_PER_WORD;
+        count -= SEPTETS_PER_WORD;
+    }
+
+    if (count > 0)
+    {
+        uint64_t word = 0;
+        uint32_t j;
+
+        for (j = 0; j < count; j++)
+        {
+            word |= (uint64_t)(septetPtr[j] & 0x7F) << (49 - (7 * j));
+        }
+        for (j = 0; j < ((count * 7) + 7) / 8; j++)
+        {
+            bufferPtr[j] = word >> (48 - (8 * j));
+        }
     }
 }
 
@@ -635,7 +803,8 @@ static inline void WriteCdma7Bits
  * Convert an ascii array into a 7bits array
  * length is the number of bytes in the ascii buffer
  *
- * @return the size of the a7bit string (in 7bit chars!), or LE_OVERFLOW if a7bitPtr is too small.
+ * @return the size of the a7bit string (in 7bit chars!), or LE_OVERFLOW if a7bitPtr is too small
+ *         or the message is longer than a PDU.
  */
 static int32_t Convert8BitsTo7Bits
 (
@@ -649,43 +818,39 @@ static int32_t Convert8BitsTo7Bits
 {
     int read;
     int write = 0;
-    int size = 0;
+    int size;
+    uint8_t septets[MAX_SEPTETS];
 
     for (read = pos; read < length+pos; ++read)
     {
         uint8_t byte = Ascii8to7[a8bitPtr[read]];
 
-        /* Escape */
-        if (byte >= 128)
+        // Each character may need an escape
+        if ((write + 2) > MAX_SEPTETS)
         {
-            if (size>a7bitSize)
-            {
-                return LE_OVERFLOW;
-            }
-
-            Write7Bits(a7bitPtr, 0x1B, write*7);
-            write++;
-            byte -= 128;
+            return LE_OVERFLOW;
         }
 
-        if (size>a7bitSize)
+        /* Escape */
+        if (byte >= 128)
         {
-            return LE_OVERFLOW;
+            septets[write++] = 0x1B;
+            byte -= 128;
         }
 
-        Write7Bits(a7bitPtr, byte, write*7);
-        write++;
-
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
+        septets[write++] = byte;
     }
 
+    /* Number of 8 bit chars */
+    size = ((write * 7) + 7) / 8;
+
     if (size>a7bitSize)
     {
         return LE_OVERFLOW;
     }
 
+    Pack7Bits(septets, write, a7bitPtr);
+
     /* Number of written chars */
     *a7bitsNumber = write;
 
@@ -696,7 +861,8 @@ static int32_t Convert8BitsTo7Bits
  * Convert a 7bit array into a ascii array
  * length is the number of 7bit char in the a7bit buffer
  *
- * @return the size of the ascii array, of LE_OVERFLOW if a8bitPtr is too small.
+ * @return the size of the ascii array, of LE_OVERFLOW if a8bitPtr is too small or length is more
+ *         septets than a PDU holds.
  */
 static int32_t Convert7BitsTo8Bits
 (
@@ -710,11 +876,25 @@ static int32_t Convert7BitsTo8Bits
     int r;
     int w;
 
+    if (length <= 0)
+    {
+        return 0;
+    }
+
+    if (length >= MAX_SEPTETS)
+    {
+        return LE_OVERFLOW;
+    }
+
+    // A trailing escape is followed by a null septet
+    uint8_t septets[MAX_SEPTETS];
+    Unpack7Bits(a7bitPtr, pos, length, septets);
+    septets[length] = 0;
+
     w = 0;
-    for (r = pos; r < length+pos; r++)
+    for (r = 0; r < length; r++)
     {
-        uint8_t byte = Read7Bits(a7bitPtr, r*7);
-        byte = Ascii7to8[byte];
+        uint8_t byte = Ascii7to8[septets[r]];
 
         if (byte != 27)
         {
@@ -733,7 +913,7 @@ static int32_t Convert7BitsTo8Bits
             /* If we're escaped then the next byte have a special meaning. */
             r++;
 
-            byte = Read7Bits(a7bitPtr, r*7);
+            byte = septets[r];
             if (w < a8bitSize)
             {
                 switch (byte)
@@ -1846,29 +2026,20 @@ static le_result_t EncodeCdma7BitsData
     uint8_t       *a7bitsNumber ///< [OUT] number of char in 7bitsPtr
 )
 {
-    int read;
-    int write = 0;
-    int size = 0;
-
-    memset(a7bitPtr,0,a7bitSize);
+    /* Number of 8 bit chars */
+    size_t size = ((a8bitPtrSize * 7) + 7) / 8;
 
-    for (read = 0; read < a8bitPtrSize; ++read)
+    if (size>a7bitSize)
     {
-        if (size>a7bitSize)
-        {
-            return LE_OVERFLOW;
-        }
+        return LE_OVERFLOW;
+    }
 
-        WriteCdma7Bits(a7bitPtr, a8bitPtr[read], write*7);
-        write++;
+    memset(a7bitPtr,0,a7bitSize);
 
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
-    }
+    PackCdma7Bits(a8bitPtr, a8bitPtrSize, a7bitPtr);
 
     /* Number of written chars */
-    *a7bitsNumber = write;
+    *a7bitsNumber = a8bitPtrSize;
 
     return LE_OK;
 }
@@ -1890,24 +2061,16 @@ static le_result_t DecodeCdma7bitsData
     uint32_t      *a8bitNumber   ///< [OUT] number of char written
 )
 {
-    int read;
-    int write;
-
     memset(a8bitPtr,0,a8bitSize);
 
-    for (read = 0, write = 0; read < a7bitPtrSize; read++, write++)
+    if (a7bitPtrSize > a8bitSize)
     {
-        if (write < a8bitSize)
-        {
-            a8bitPtr[write] = ReadCdma7Bits(a7bitPtr, read*7);
-        }
-        else
-        {
-            return LE_OVERFLOW;
-        }
+        return LE_OVERFLOW;
     }
 
-    *a8bitNumber = write;
+    UnpackCdma7Bits(a7bitPtr, a7bitPtrSize, a8bitPtr);
+
+    *a8bitNumber = a7bitPtrSize;
 
     return LE_OK;
 }
@@ -133,6 +133,25 @@ int32_t pa_sms_SendPduMsg
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function tells the modem whether more messages are about to be sent, so that it keeps the
+ * relay protocol link open between them instead of closing it after each message (AT+CMMS).
+ *
+ * @return LE_OK            The function succeeded.
+ * @return LE_FAULT         The function failed.
+ * @return LE_UNSUPPORTED   The platform does not support this operation.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_sms_SetMoreMessagesToSend
+(
+    bool moreMessages                    ///< [IN] More messages are about to be sent.
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_UNSUPPORTED;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function gets the message from the preferred message storage.
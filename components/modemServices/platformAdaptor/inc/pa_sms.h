@@ -390,6 +390,23 @@ LE_SHARED int32_t pa_sms_SendPduMsg
     pa_sms_SendingErrCode_t *errorCode   ///< [OUT] The error code.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function tells the modem whether more messages are about to be sent, so that it keeps the
+ * relay protocol link open between them instead of closing it after each message (AT+CMMS).
+ *
+ * Implementing it is optional: the SMS service treats a missing implementation as LE_UNSUPPORTED.
+ *
+ * @return LE_OK            The function succeeded.
+ * @return LE_FAULT         The function failed.
+ * @return LE_UNSUPPORTED   The platform does not support this operation.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_sms_SetMoreMessagesToSend
+(
+    bool moreMessages                    ///< [IN] More messages are about to be sent.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function gets the message from the preferred message storage.
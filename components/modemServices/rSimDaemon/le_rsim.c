@@ -92,9 +92,25 @@ typedef struct
                                                 ///< used when connected to remote server
     uint16_t                    maxMsgSize;     ///< Maximum message size negotiated
                                                 ///< for current SAP session
+    le_clk_Time_t               apduIndTime;    ///< Time the APDU being processed was received
+                                                ///< from the modem
 }
 RsimObject_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * APDU latency statistics, from the APDU indication of the modem to the transmission of the
+ * APDU response to the modem
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t apduCount;     ///< Number of APDU exchanges measured
+    uint64_t totalUs;       ///< Sum of the measured latencies, in microseconds
+    uint64_t maxUs;         ///< Longest measured latency, in microseconds
+}
+ApduLatencyStats_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * RSIM message structure
@@ -102,8 +118,8 @@ RsimObject_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t message[LE_RSIM_MAX_MSG_SIZE];  ///< Message
     size_t  messageSize;                    ///< Message size
+    uint8_t message[LE_RSIM_MAX_MSG_SIZE];  ///< Message, only messageSize bytes are significant
 }
 RsimMessage_t;
 
@@ -139,6 +155,23 @@ static le_timer_Ref_t SapConnectionTimer;
 //--------------------------------------------------------------------------------------------------
 static RsimObject_t RsimObject;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer used to build the SAP messages sent to the remote SIM server.
+ *
+ * Messages are encoded in place in this preallocated buffer and only their significant bytes are
+ * copied into the event report.
+ */
+//--------------------------------------------------------------------------------------------------
+static RsimMessage_t SapTxMessage;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * APDU latency statistics for the current SAP session
+ */
+//--------------------------------------------------------------------------------------------------
+static ApduLatencyStats_t ApduLatencyStats;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event ID for RSIM messages notification
@@ -182,6 +215,68 @@ static void NotifySimStatus
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the SAP message built in SapTxMessage to the remote SIM server
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportSapTxMessage
+(
+    void
+)
+{
+    LE_DUMP(SapTxMessage.message, SapTxMessage.messageSize);
+
+    // Only copy the significant bytes, the remaining ones are cleared by the event report
+    le_event_Report(RsimMsgEventId,
+                    &SapTxMessage,
+                    offsetof(RsimMessage_t, message) + SapTxMessage.messageSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the APDU latency statistics with the APDU exchange which just ended
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateApduLatency
+(
+    void
+)
+{
+    le_clk_Time_t latency = le_clk_Sub(le_clk_GetRelativeTime(), RsimObject.apduIndTime);
+    uint64_t latencyUs = ((uint64_t)latency.sec * 1000000) + latency.usec;
+
+    ApduLatencyStats.apduCount++;
+    ApduLatencyStats.totalUs += latencyUs;
+    if (latencyUs > ApduLatencyStats.maxUs)
+    {
+        ApduLatencyStats.maxUs = latencyUs;
+    }
+
+    LE_DEBUG("APDU latency: %"PRIu64" us", latencyUs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the APDU latency statistics of the SAP session which just ended, and reset them
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogApduLatency
+(
+    void
+)
+{
+    if (0 != ApduLatencyStats.apduCount)
+    {
+        LE_INFO("%"PRIu32" APDU exchanged, latency: average %"PRIu64" us, max %"PRIu64" us",
+                ApduLatencyStats.apduCount,
+                ApduLatencyStats.totalUs / ApduLatencyStats.apduCount,
+                ApduLatencyStats.maxUs);
+    }
+
+    memset(&ApduLatencyStats, 0, sizeof(ApduLatencyStats));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send a SAP TRANSFER_ATR_REQ message and update the SAP session sub-state
@@ -193,25 +288,23 @@ static void SendSapTransferAtrReq
 )
 {
     // Create TRANSFER_ATR_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_TRANSFER_ATR_REQ;    // MsgId (TRANSFER_ATR_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
+    messagePtr[0] = SAP_MSGID_TRANSFER_ATR_REQ;             // MsgId (TRANSFER_ATR_REQ)
+    messagePtr[1] = 0x00;                                   // Parameters number
+    messagePtr[2] = 0x00;                                   // Reserved
+    messagePtr[3] = 0x00;                                   // Reserved
 
     // Set message size
-    RsimMessage.messageSize = 4;
+    SapTxMessage.messageSize = 4;
 
     // Update SAP session sub-state
     RsimObject.sapSubState = sapSubState;
 
     // Send TRANSFER_ATR_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send TRANSFER_ATR_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -225,32 +318,33 @@ static void SendSapTransferApduReq
 )
 {
     // Create TRANSFER_APDU_REQ message to transmit
-    RsimMessage_t RsimMessage;
+    uint8_t* messagePtr = SapTxMessage.message;
     size_t size = 0;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_TRANSFER_APDU_REQ;           // MsgId (TRANSFER_APDU_REQ)
-    RsimMessage.message[1] = 0x01;                                  // Parameters number
-    RsimMessage.message[2] = 0x00;                                  // Reserved
-    RsimMessage.message[3] = 0x00;                                  // Reserved
+    messagePtr[0] = SAP_MSGID_TRANSFER_APDU_REQ;                    // MsgId (TRANSFER_APDU_REQ)
+    messagePtr[1] = 0x01;                                           // Parameters number
+    messagePtr[2] = 0x00;                                           // Reserved
+    messagePtr[3] = 0x00;                                           // Reserved
 
     // Parameter header
-    RsimMessage.message[4] = SAP_PARAMID_COMMAND_APDU;              // Parameter Id (CommandAPDU)
-    RsimMessage.message[5] = 0x00;                                  // Reserved
-    RsimMessage.message[6] = ((apduInd->apduLength & 0xFF00U) >> MSB_SHIFT);// APDU length (MSB)
-    RsimMessage.message[7] = (apduInd->apduLength & 0x00FF);        // APDU length (LSB)
+    messagePtr[4] = SAP_PARAMID_COMMAND_APDU;                       // Parameter Id (CommandAPDU)
+    messagePtr[5] = 0x00;                                           // Reserved
+    messagePtr[6] = ((apduInd->apduLength & 0xFF00U) >> MSB_SHIFT); // APDU length (MSB)
+    messagePtr[7] = (apduInd->apduLength & 0x00FF);                 // APDU length (LSB)
 
     // Current message size
     size = 8;
 
     // Parameter value (APDU)
-    memcpy(&RsimMessage.message[size], apduInd->apduData, apduInd->apduLength);
+    memcpy(&messagePtr[size], apduInd->apduData, apduInd->apduLength);
     size += apduInd->apduLength;
 
-    // Set message size, which should be 4-byte aligned
+    // Set message size, which should be 4-byte aligned. The buffer is reused, so the padding
+    // has to be cleared.
+    memset(&messagePtr[size], 0, 4 - (size % 4));
     size += (4 - (size % 4));
-    RsimMessage.messageSize = size;
+    SapTxMessage.messageSize = size;
 
     // Check message length
     if (size > RsimObject.maxMsgSize)
@@ -271,8 +365,7 @@ static void SendSapTransferApduReq
 
         // Send TRANSFER_APDU_REQ message by notifying it to the remote SIM server
         LE_DEBUG("Send TRANSFER_APDU_REQ message:");
-        LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-        le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+        ReportSapTxMessage();
     }
 }
 
@@ -299,29 +392,28 @@ static le_result_t SendSapConnectReq
     }
 
     // Create CONNECT_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0]  = SAP_MSGID_CONNECT_REQ;                    // MsgId (CONNECT_REQ)
-    RsimMessage.message[1]  = 0x01;                                     // Parameters number
-    RsimMessage.message[2]  = 0x00;                                     // Reserved
-    RsimMessage.message[3]  = 0x00;                                     // Reserved
+    messagePtr[0]  = SAP_MSGID_CONNECT_REQ;                             // MsgId (CONNECT_REQ)
+    messagePtr[1]  = 0x01;                                              // Parameters number
+    messagePtr[2]  = 0x00;                                              // Reserved
+    messagePtr[3]  = 0x00;                                              // Reserved
 
     // Parameter header
-    RsimMessage.message[4]  = SAP_PARAMID_MAX_MSG_SIZE;                 // Parameter Id (MaxMsgSize)
-    RsimMessage.message[5]  = 0x00;                                     // Reserved
-    RsimMessage.message[6]  = 0x00;                                     // Parameter length (MSB)
-    RsimMessage.message[7]  = SAP_LENGTH_MAX_MSG_SIZE;                  // Parameter length (LSB)
+    messagePtr[4]  = SAP_PARAMID_MAX_MSG_SIZE;                          // Parameter Id (MaxMsgSize)
+    messagePtr[5]  = 0x00;                                              // Reserved
+    messagePtr[6]  = 0x00;                                              // Parameter length (MSB)
+    messagePtr[7]  = SAP_LENGTH_MAX_MSG_SIZE;                           // Parameter length (LSB)
 
     // Parameter value (MaxMsgSize)
-    RsimMessage.message[8]  = ((RsimObject.maxMsgSize & 0xFF00U) >> MSB_SHIFT); // MaxMsgSize (MSB)
-    RsimMessage.message[9]  = (RsimObject.maxMsgSize & 0x00FF);                 // MaxMsgSize (LSB)
-    RsimMessage.message[10] = 0x00;                                             // Padding
-    RsimMessage.message[11] = 0x00;                                             // Padding
+    messagePtr[8]  = ((RsimObject.maxMsgSize & 0xFF00U) >> MSB_SHIFT);          // MaxMsgSize (MSB)
+    messagePtr[9]  = (RsimObject.maxMsgSize & 0x00FF);                          // MaxMsgSize (LSB)
+    messagePtr[10] = 0x00;                                                      // Padding
+    messagePtr[11] = 0x00;                                                      // Padding
 
     // Set message size
-    RsimMessage.messageSize = 12;
+    SapTxMessage.messageSize = 12;
 
     // Start timer securing the connection establishment
     if (LE_OK != le_timer_Start(SapConnectionTimer))
@@ -334,8 +426,7 @@ static le_result_t SendSapConnectReq
 
     // Send CONNECT_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send CONNECT_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 
     return LE_OK;
 }
@@ -362,25 +453,23 @@ static le_result_t SendSapPowerSimOffReq
     }
 
     // Create POWER_SIM_OFF_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_POWER_SIM_OFF_REQ;   // MsgId (POWER_SIM_OFF_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
+    messagePtr[0] = SAP_MSGID_POWER_SIM_OFF_REQ;            // MsgId (POWER_SIM_OFF_REQ)
+    messagePtr[1] = 0x00;                                   // Parameters number
+    messagePtr[2] = 0x00;                                   // Reserved
+    messagePtr[3] = 0x00;                                   // Reserved
 
     // Set message size
-    RsimMessage.messageSize = 4;
+    SapTxMessage.messageSize = 4;
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_POWER_OFF;
 
     // Send POWER_SIM_OFF_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send POWER_SIM_OFF_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 
     return LE_OK;
 }
@@ -410,25 +499,23 @@ static le_result_t SendSapPowerSimOnReq
     }
 
     // Create POWER_SIM_ON_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_POWER_SIM_ON_REQ;    // MsgId (POWER_SIM_ON_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
+    messagePtr[0] = SAP_MSGID_POWER_SIM_ON_REQ;             // MsgId (POWER_SIM_ON_REQ)
+    messagePtr[1] = 0x00;                                   // Parameters number
+    messagePtr[2] = 0x00;                                   // Reserved
+    messagePtr[3] = 0x00;                                   // Reserved
 
     // Set message size
-    RsimMessage.messageSize = 4;
+    SapTxMessage.messageSize = 4;
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_POWER_ON;
 
     // Send POWER_SIM_ON_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send POWER_SIM_ON_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 
     return LE_OK;
 }
@@ -459,25 +546,23 @@ static le_result_t SendSapResetSimReq
     }
 
     // Create RESET_SIM_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_RESET_SIM_REQ;   // MsgId (RESET_SIM_REQ)
-    RsimMessage.message[1] = 0x00;                      // Parameters number
-    RsimMessage.message[2] = 0x00;                      // Reserved
-    RsimMessage.message[3] = 0x00;                      // Reserved
+    messagePtr[0] = SAP_MSGID_RESET_SIM_REQ;            // MsgId (RESET_SIM_REQ)
+    messagePtr[1] = 0x00;                               // Parameters number
+    messagePtr[2] = 0x00;                               // Reserved
+    messagePtr[3] = 0x00;                               // Reserved
 
     // Set message size
-    RsimMessage.messageSize = 4;
+    SapTxMessage.messageSize = 4;
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_RESET;
 
     // Send RESET_SIM_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send RESET_SIM_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 
     return LE_OK;
 }
@@ -493,25 +578,23 @@ static void SendSapDisconnectReq
 )
 {
     // Create DISCONNECT_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t* messagePtr = SapTxMessage.message;
 
     // SAP header
-    RsimMessage.message[0] = SAP_MSGID_DISCONNECT_REQ;  // MsgId (DISCONNECT_REQ)
-    RsimMessage.message[1] = 0x00;                      // Parameters number
-    RsimMessage.message[2] = 0x00;                      // Reserved
-    RsimMessage.message[3] = 0x00;                      // Reserved
+    messagePtr[0] = SAP_MSGID_DISCONNECT_REQ;           // MsgId (DISCONNECT_REQ)
+    messagePtr[1] = 0x00;                               // Parameters number
+    messagePtr[2] = 0x00;                               // Reserved
+    messagePtr[3] = 0x00;                               // Reserved
 
     // Set message size
-    RsimMessage.messageSize = 4;
+    SapTxMessage.messageSize = 4;
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_DISCONNECT;
 
     // Send DISCONNECT_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send DISCONNECT_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    ReportSapTxMessage();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1008,6 +1091,7 @@ static le_result_t ProcessSapTransferApduResp
                     LE_ERROR("Error when transmitting APDU response");
                     result = LE_FAULT;
                 }
+                UpdateApduLatency();
             }
             else
             {
@@ -1026,6 +1110,7 @@ static le_result_t ProcessSapTransferApduResp
                 LE_ERROR("Error when transmitting APDU response error");
                 result = LE_FAULT;
             }
+            UpdateApduLatency();
         break;
 
         default:
@@ -1107,6 +1192,7 @@ static le_result_t ProcessSapDisconnectInd
             RsimObject.sapSubState = SAP_SESSION_CONNECTED_IDLE;
             // Reset maximal message size
             RsimObject.maxMsgSize = LE_RSIM_MAX_MSG_SIZE;
+            LogApduLatency();
         break;
 
         default:
@@ -1151,6 +1237,7 @@ static le_result_t ProcessSapDisconnectResp
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_IDLE;
     // Reset maximal message size
     RsimObject.maxMsgSize = LE_RSIM_MAX_MSG_SIZE;
+    LogApduLatency();
 
     return LE_OK;
 }
@@ -1441,20 +1528,19 @@ static le_result_t ProcessSapErrorResp
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Process an incoming SAP message
+ * Process an incoming SAP message, decoding it in place, and notify the result through the
+ * provided callback
  */
 //--------------------------------------------------------------------------------------------------
 static void ProcessSapMessage
 (
-    void* param1Ptr,
-    void* param2Ptr
+    const uint8_t* messagePtr,                  ///< SAP message
+    size_t messageNumElements,                  ///< SAP message size
+    le_rsim_CallbackHandlerFunc_t callback,     ///< Callback for sending result
+    void* contextPtr                            ///< Associated context
 )
 {
     le_result_t result;
-    RsimMessageSending_t* rsimSendingPtr = (RsimMessageSending_t*) param1Ptr;
-    uint8_t* messagePtr = rsimSendingPtr->rsimMessage.message;
-    size_t messageNumElements = rsimSendingPtr->rsimMessage.messageSize;
-    le_rsim_CallbackHandlerFunc_t callback = rsimSendingPtr->callbackPtr;
     uint8_t msgId = messagePtr[0];
 
     LE_DEBUG("Process SAP message length (%d):", (int) messageNumElements);
@@ -1519,12 +1605,31 @@ static void ProcessSapMessage
     if (NULL != callback)
     {
         LE_DEBUG("Callback %p called with result %d for message %d", callback, result, msgId);
-        callback(msgId, result, rsimSendingPtr->context);
+        callback(msgId, result, contextPtr);
     }
     else
     {
         LE_WARN("No callback found for message %d, result %d", msgId, result);
     }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process an incoming SAP message queued to the main thread
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessQueuedSapMessage
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    RsimMessageSending_t* rsimSendingPtr = (RsimMessageSending_t*) param1Ptr;
+
+    ProcessSapMessage(rsimSendingPtr->rsimMessage.message,
+                      rsimSendingPtr->rsimMessage.messageSize,
+                      rsimSendingPtr->callbackPtr,
+                      rsimSendingPtr->context);
 
     // Release allocated memory
     le_mem_Release(rsimSendingPtr);
@@ -1657,6 +1762,8 @@ static void ApduNotificationHandler
     pa_rsim_ApduInd_t* apduInd      ///< APDU information sent by the modem
 )
 {
+    RsimObject.apduIndTime = le_clk_GetRelativeTime();
+
     LE_DEBUG("APDU received:");
     LE_DUMP(apduInd->apduData, apduInd->apduLength);
 
@@ -1874,16 +1981,25 @@ le_result_t le_rsim_SendMessage
         return LE_BAD_PARAMETER;
     }
 
+    // Timers are linked to the thread originating their start or stop:
+    // all the processing should therefore be done in the same thread to correctly
+    // start and stop the timers.
+    // When the message is already received in the main thread, which is the case for IPC calls,
+    // it is processed directly from the received buffer: this avoids a copy and an event loop
+    // round trip for each APDU response.
+    if (le_thread_GetCurrent() == MainThread)
+    {
+        ProcessSapMessage(messagePtr, messageNumElements, callbackPtr, contextPtr);
+        return LE_OK;
+    }
+
     RsimMessageSending_t* rsimSendingPtr = le_mem_ForceAlloc(RsimMessagesPool);
     memcpy(rsimSendingPtr->rsimMessage.message, messagePtr, messageNumElements);
     rsimSendingPtr->rsimMessage.messageSize = messageNumElements;
     rsimSendingPtr->callbackPtr = callbackPtr;
     rsimSendingPtr->context = contextPtr;
 
-    // Timers are linked to the thread originating their start or stop:
-    // all the processing should therefore be done in the same thread to correctly
-    // start and stop the timers
-    le_event_QueueFunctionToThread(MainThread, ProcessSapMessage, rsimSendingPtr, NULL);
+    le_event_QueueFunctionToThread(MainThread, ProcessQueuedSapMessage, rsimSendingPtr, NULL);
 
     return LE_OK;
 }
@@ -321,6 +321,30 @@ le_result_t pa_gnss_InjectUtcTime
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to inject a reference position into the GNSS device, typically the
+ * last known position, to shorten the time to first fix.
+ *
+ * @return
+ *  - LE_OK            The function succeeded.
+ *  - LE_FAULT         The function failed to inject the position.
+ *  - LE_UNSUPPORTED   The GNSS device doesn't support position injection.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnss_InjectPosition
+(
+    int32_t  latitude,     ///< [IN] Latitude in degrees, with 6 decimal places
+    int32_t  longitude,    ///< [IN] Longitude in degrees, with 6 decimal places
+    uint32_t hUncertainty, ///< [IN] Horizontal uncertainty in meters, with 2 decimal places
+    uint64_t timeUtc       ///< [IN] UTC time of the position since Jan. 1, 1970 in milliseconds
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_UNSUPPORTED;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to restart the GNSS device.
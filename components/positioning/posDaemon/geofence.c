@@ -0,0 +1,744 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file geofence.c
+ *
+ * This file contains the source code of the geofencing of the positioning service (see
+ * @ref le_pos_geofencing).
+ *
+ * The fences are indexed on a grid of cells of CELL_SIZE by CELL_SIZE micro-degrees: each fence is
+ * listed in all of the cells its bounding box overlaps, and a hashmap gives the fences of a cell.
+ * For each fix, only the fences of the fix's cell are checked for entry, along with the fences the
+ * device is in (for exit and dwell), and the few fences too big for the grid, which are checked
+ * for every fix.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "geofence.h"
+
+#include <math.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the cells of the grid, in micro-degrees (about 1.1 km of latitude).
+ */
+//--------------------------------------------------------------------------------------------------
+#define CELL_SIZE                   10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of cells a fence can be listed in.  Bigger fences are checked for every fix.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_FENCE_CELLS             64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a degree of latitude, in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+#define METERS_PER_DEGREE           111320.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of fences, handlers and cells.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FENCE_DEFAULT_POOL_SIZE     32
+#define HANDLER_DEFAULT_POOL_SIZE   8
+#define CELL_MAP_SIZE               127
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert micro-degrees to radians.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TO_RADIANS(microDeg)        ((double)(microDeg) / 1000000.0 * M_PI / 180.0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_FenceRef_t   ref;            ///< Safe reference of the fence.
+    le_msg_SessionRef_t sessionRef;     ///< Session of the client owning the fence.
+    int32_t             latitude;       ///< Latitude of the center [resolution 1e-6 degree].
+    int32_t             longitude;      ///< Longitude of the center [resolution 1e-6 degree].
+    uint32_t            radius;         ///< Radius, in meters.
+    uint32_t            dwellTime;      ///< Dwell time, in milliseconds (0 for none).
+    bool                isWide;         ///< Whether the fence is too big for the grid.
+    int32_t             minLatCell;     ///< First row of cells overlapped by the fence.
+    int32_t             maxLatCell;     ///< Last row of cells overlapped by the fence.
+    int32_t             minLonCell;     ///< First column of cells overlapped by the fence.
+    int32_t             maxLonCell;     ///< Last column of cells overlapped by the fence.
+    bool                isInside;       ///< Whether the device is in the fence.
+    bool                isDwellReported;///< Whether FENCE_DWELL was reported since the entry.
+    le_clk_Time_t       entryTime;      ///< When the fence was entered.
+    uint32_t            lastFixId;      ///< Last fix the fence was checked against.
+    le_dls_Link_t       insideLink;     ///< Link in InsideList, when the device is in the fence.
+    le_dls_Link_t       wideLink;       ///< Link in WideList, when the fence is too big.
+}
+Fence_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cell of the grid, holding the fences that overlap it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t      key;          ///< Row and column of the cell.
+    le_dls_List_t entryList;    ///< Fences overlapping the cell.
+}
+Cell_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Entry of a fence in a cell.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Fence_t*      fencePtr;     ///< Fence.
+    le_dls_Link_t link;         ///< Link in the cell's list.
+}
+CellEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence transition handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_GeofenceHandlerRef_t  ref;           ///< Safe reference of the handler.
+    le_msg_SessionRef_t          sessionRef;    ///< Session of the client.
+    le_pos_GeofenceHandlerFunc_t handlerPtr;    ///< Handler function.
+    void*                        contextPtr;    ///< Handler's context.
+}
+Handler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FencePool;
+static le_mem_PoolRef_t CellPool;
+static le_mem_PoolRef_t CellEntryPool;
+static le_mem_PoolRef_t HandlerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference maps of the fences and handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t FenceRefMap;
+static le_ref_MapRef_t HandlerRefMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cells holding fences, by key.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t CellMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fences the device is in.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t InsideList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fences too big for the grid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t WideList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of fences.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FenceCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifier of the last fix, so that a fence is checked only once per fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FixId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the row or column of the cells holding a latitude or longitude.
+ *
+ * @return The row or column.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t GetCellIndex
+(
+    int64_t microDeg    ///< [IN] Latitude or longitude [resolution 1e-6 degree].
+)
+{
+    // Round towards minus infinity, so that the cells around 0 are the same size as the others.
+    return (int32_t)((microDeg >= 0) ? (microDeg / CELL_SIZE)
+                                     : -((-microDeg + CELL_SIZE - 1) / CELL_SIZE));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the key of a cell.
+ *
+ * @return The key.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetCellKey
+(
+    int32_t latCell,    ///< [IN] Row of the cell.
+    int32_t lonCell     ///< [IN] Column of the cell.
+)
+{
+    return ((uint64_t)(uint32_t)latCell << 32) | (uint32_t)lonCell;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the cells overlapped by the bounding box of a fence, or find that it is too big (or too
+ * close to a pole or to the antimeridian) for the grid.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ComputeFenceCells
+(
+    Fence_t* fencePtr   ///< [IN/OUT] Fence.
+)
+{
+    double latExtent = (double)fencePtr->radius * 1000000.0 / METERS_PER_DEGREE;
+    double cosLat = cos(TO_RADIANS(fencePtr->latitude));
+    int64_t minLat = fencePtr->latitude - (int64_t)ceil(latExtent);
+    int64_t maxLat = fencePtr->latitude + (int64_t)ceil(latExtent);
+
+    if ((minLat < -90000000) || (maxLat > 90000000) || (cosLat < 0.01))
+    {
+        fencePtr->isWide = true;
+        return;
+    }
+
+    int64_t lonExtent = (int64_t)ceil(latExtent / cosLat);
+    int64_t minLon = fencePtr->longitude - lonExtent;
+    int64_t maxLon = fencePtr->longitude + lonExtent;
+
+    if ((minLon < -180000000) || (maxLon > 180000000))
+    {
+        fencePtr->isWide = true;
+        return;
+    }
+
+    fencePtr->minLatCell = GetCellIndex(minLat);
+    fencePtr->maxLatCell = GetCellIndex(maxLat);
+    fencePtr->minLonCell = GetCellIndex(minLon);
+    fencePtr->maxLonCell = GetCellIndex(maxLon);
+
+    fencePtr->isWide = ((int64_t)(fencePtr->maxLatCell - fencePtr->minLatCell + 1)
+                        * (fencePtr->maxLonCell - fencePtr->minLonCell + 1)) > MAX_FENCE_CELLS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List a fence in the cells it overlaps, or in WideList if it is too big.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexFence
+(
+    Fence_t* fencePtr   ///< [IN] Fence.
+)
+{
+    int32_t latCell;
+    int32_t lonCell;
+
+    if (fencePtr->isWide)
+    {
+        le_dls_Queue(&WideList, &fencePtr->wideLink);
+        return;
+    }
+
+    for (latCell = fencePtr->minLatCell; latCell <= fencePtr->maxLatCell; latCell++)
+    {
+        for (lonCell = fencePtr->minLonCell; lonCell <= fencePtr->maxLonCell; lonCell++)
+        {
+            uint64_t key = GetCellKey(latCell, lonCell);
+            Cell_t* cellPtr = le_hashmap_Get(CellMap, &key);
+
+            if (cellPtr == NULL)
+            {
+                cellPtr = le_mem_ForceAlloc(CellPool);
+                cellPtr->key = key;
+                cellPtr->entryList = LE_DLS_LIST_INIT;
+                le_hashmap_Put(CellMap, &cellPtr->key, cellPtr);
+            }
+
+            CellEntry_t* entryPtr = le_mem_ForceAlloc(CellEntryPool);
+            entryPtr->fencePtr = fencePtr;
+            entryPtr->link = LE_DLS_LINK_INIT;
+            le_dls_Queue(&cellPtr->entryList, &entryPtr->link);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence from the cells it overlaps, or from WideList.  Cells left empty are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnindexFence
+(
+    Fence_t* fencePtr   ///< [IN] Fence.
+)
+{
+    int32_t latCell;
+    int32_t lonCell;
+
+    if (fencePtr->isWide)
+    {
+        le_dls_Remove(&WideList, &fencePtr->wideLink);
+        return;
+    }
+
+    for (latCell = fencePtr->minLatCell; latCell <= fencePtr->maxLatCell; latCell++)
+    {
+        for (lonCell = fencePtr->minLonCell; lonCell <= fencePtr->maxLonCell; lonCell++)
+        {
+            uint64_t key = GetCellKey(latCell, lonCell);
+            Cell_t* cellPtr = le_hashmap_Get(CellMap, &key);
+
+            LE_ASSERT(cellPtr != NULL);
+
+            le_dls_Link_t* linkPtr = le_dls_Peek(&cellPtr->entryList);
+
+            while (linkPtr != NULL)
+            {
+                CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, link);
+
+                if (entryPtr->fencePtr == fencePtr)
+                {
+                    le_dls_Remove(&cellPtr->entryList, linkPtr);
+                    le_mem_Release(entryPtr);
+                    break;
+                }
+                linkPtr = le_dls_PeekNext(&cellPtr->entryList, linkPtr);
+            }
+
+            if (le_dls_IsEmpty(&cellPtr->entryList))
+            {
+                le_hashmap_Remove(CellMap, &key);
+                le_mem_Release(cellPtr);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the distance between two points.  The flat Earth approximation used is well within
+ * the accuracy of a GNSS fix at the scale of a fence.
+ *
+ * @return The distance, in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ComputeDistance
+(
+    int32_t latitude1,      ///< [IN] Latitude of the first point [resolution 1e-6 degree].
+    int32_t longitude1,     ///< [IN] Longitude of the first point [resolution 1e-6 degree].
+    int32_t latitude2,      ///< [IN] Latitude of the second point [resolution 1e-6 degree].
+    int32_t longitude2      ///< [IN] Longitude of the second point [resolution 1e-6 degree].
+)
+{
+    int64_t dLon = (int64_t)longitude2 - longitude1;
+
+    // Go the short way around the antimeridian.
+    if (dLon > 180000000)
+    {
+        dLon -= 360000000;
+    }
+    else if (dLon < -180000000)
+    {
+        dLon += 360000000;
+    }
+
+    double x = (double)dLon * cos(TO_RADIANS(((int64_t)latitude1 + latitude2) / 2));
+    double y = (double)((int64_t)latitude2 - latitude1);
+
+    return sqrt(x * x + y * y) * METERS_PER_DEGREE / 1000000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the client owning a fence of one of its transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyTransition
+(
+    Fence_t*                 fencePtr,      ///< [IN] Fence.
+    le_pos_FenceTransition_t transition     ///< [IN] Transition.
+)
+{
+    LE_DEBUG("Fence %p: transition %d", fencePtr->ref, transition);
+
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(HandlerRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        Handler_t* handlerPtr = (Handler_t*)le_ref_GetValue(iterRef);
+
+        if (handlerPtr->sessionRef == fencePtr->sessionRef)
+        {
+            handlerPtr->handlerPtr(fencePtr->ref, transition, handlerPtr->contextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a fence against a position fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckFence
+(
+    Fence_t*      fencePtr,     ///< [IN] Fence.
+    int32_t       latitude,     ///< [IN] Latitude of the fix [resolution 1e-6 degree].
+    int32_t       longitude,    ///< [IN] Longitude of the fix [resolution 1e-6 degree].
+    double        accuracy,     ///< [IN] Horizontal accuracy of the fix, in meters.
+    le_clk_Time_t now           ///< [IN] Time of the fix.
+)
+{
+    if (fencePtr->lastFixId == FixId)
+    {
+        return;
+    }
+    fencePtr->lastFixId = FixId;
+
+    double distance = ComputeDistance(fencePtr->latitude, fencePtr->longitude,
+                                      latitude, longitude);
+
+    if (!fencePtr->isInside)
+    {
+        if (distance <= fencePtr->radius)
+        {
+            fencePtr->isInside = true;
+            fencePtr->isDwellReported = false;
+            fencePtr->entryTime = now;
+            le_dls_Queue(&InsideList, &fencePtr->insideLink);
+            NotifyTransition(fencePtr, LE_POS_FENCE_ENTER);
+        }
+    }
+    else if (distance > (fencePtr->radius + accuracy))
+    {
+        fencePtr->isInside = false;
+        le_dls_Remove(&InsideList, &fencePtr->insideLink);
+        NotifyTransition(fencePtr, LE_POS_FENCE_EXIT);
+    }
+    else if ((fencePtr->dwellTime != 0) && !fencePtr->isDwellReported)
+    {
+        le_clk_Time_t elapsed = le_clk_Sub(now, fencePtr->entryTime);
+
+        if (((uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000) >= fencePtr->dwellTime)
+        {
+            fencePtr->isDwellReported = true;
+            NotifyTransition(fencePtr, LE_POS_FENCE_DWELL);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a fence.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteFence
+(
+    Fence_t* fencePtr   ///< [IN] Fence.
+)
+{
+    if (fencePtr->isInside)
+    {
+        le_dls_Remove(&InsideList, &fencePtr->insideLink);
+    }
+
+    UnindexFence(fencePtr);
+    le_ref_DeleteRef(FenceRefMap, fencePtr->ref);
+    le_mem_Release(fencePtr);
+    FenceCount--;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the geofencing.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_Init
+(
+    void
+)
+{
+    FencePool = le_mem_CreatePool("FencePool", sizeof(Fence_t));
+    le_mem_ExpandPool(FencePool, FENCE_DEFAULT_POOL_SIZE);
+
+    CellPool = le_mem_CreatePool("FenceCellPool", sizeof(Cell_t));
+    CellEntryPool = le_mem_CreatePool("FenceCellEntryPool", sizeof(CellEntry_t));
+
+    HandlerPool = le_mem_CreatePool("FenceHandlerPool", sizeof(Handler_t));
+    le_mem_ExpandPool(HandlerPool, HANDLER_DEFAULT_POOL_SIZE);
+
+    FenceRefMap = le_ref_CreateMap("FenceMap", FENCE_DEFAULT_POOL_SIZE);
+    HandlerRefMap = le_ref_CreateMap("FenceHandlerMap", HANDLER_DEFAULT_POOL_SIZE);
+
+    CellMap = le_hashmap_Create("FenceCells",
+                                CELL_MAP_SIZE,
+                                le_hashmap_HashUInt64,
+                                le_hashmap_EqualsUInt64);
+
+    FenceCount = 0;
+    FixId = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a circular fence.
+ *
+ * @return Reference to the fence, or NULL if LE_POS_MAX_FENCES fences already exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t geofence_Create
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session of the client owning the fence.
+    int32_t             latitude,   ///< [IN] Latitude of the center [resolution 1e-6 degree].
+    int32_t             longitude,  ///< [IN] Longitude of the center [resolution 1e-6 degree].
+    uint32_t            radius,     ///< [IN] Radius, in meters.
+    uint32_t            dwellTime   ///< [IN] Dwell time, in milliseconds (0 for none).
+)
+{
+    if (FenceCount >= LE_POS_MAX_FENCES)
+    {
+        LE_ERROR("Too many fences (%d).", LE_POS_MAX_FENCES);
+        return NULL;
+    }
+
+    Fence_t* fencePtr = le_mem_ForceAlloc(FencePool);
+
+    memset(fencePtr, 0, sizeof(*fencePtr));
+    fencePtr->sessionRef = sessionRef;
+    fencePtr->latitude = latitude;
+    fencePtr->longitude = longitude;
+    fencePtr->radius = radius;
+    fencePtr->dwellTime = dwellTime;
+    fencePtr->lastFixId = FixId;
+    fencePtr->insideLink = LE_DLS_LINK_INIT;
+    fencePtr->wideLink = LE_DLS_LINK_INIT;
+
+    ComputeFenceCells(fencePtr);
+    IndexFence(fencePtr);
+
+    fencePtr->ref = le_ref_CreateRef(FenceRefMap, fencePtr);
+    FenceCount++;
+
+    LE_DEBUG("Fence %p created at %d,%d (radius %u m%s)",
+             fencePtr->ref, latitude, longitude, radius, fencePtr->isWide ? ", wide" : "");
+
+    return fencePtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a fence.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the fence doesn't exist or belongs to another client
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t geofence_Delete
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session of the client.
+    le_pos_FenceRef_t   fenceRef    ///< [IN] Fence.
+)
+{
+    Fence_t* fencePtr = le_ref_Lookup(FenceRefMap, fenceRef);
+
+    if ((fencePtr == NULL) || (fencePtr->sessionRef != sessionRef))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    DeleteFence(fencePtr);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a fence transition handler.
+ *
+ * @return Reference to the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_GeofenceHandlerRef_t geofence_AddHandler
+(
+    le_msg_SessionRef_t          sessionRef,    ///< [IN] Session of the client.
+    le_pos_GeofenceHandlerFunc_t handlerPtr,    ///< [IN] Handler function.
+    void*                        contextPtr     ///< [IN] Handler's context.
+)
+{
+    Handler_t* handlerNodePtr = le_mem_ForceAlloc(HandlerPool);
+
+    handlerNodePtr->sessionRef = sessionRef;
+    handlerNodePtr->handlerPtr = handlerPtr;
+    handlerNodePtr->contextPtr = contextPtr;
+    handlerNodePtr->ref = le_ref_CreateRef(HandlerRefMap, handlerNodePtr);
+
+    return handlerNodePtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence transition handler.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the handler doesn't exist or belongs to another client
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t geofence_RemoveHandler
+(
+    le_msg_SessionRef_t         sessionRef, ///< [IN] Session of the client.
+    le_pos_GeofenceHandlerRef_t handlerRef  ///< [IN] Handler.
+)
+{
+    Handler_t* handlerNodePtr = le_ref_Lookup(HandlerRefMap, handlerRef);
+
+    if ((handlerNodePtr == NULL) || (handlerNodePtr->sessionRef != sessionRef))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    le_ref_DeleteRef(HandlerRefMap, handlerRef);
+    le_mem_Release(handlerNodePtr);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the fences and handlers of a client.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_DeleteSession
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Session of the client.
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(FenceRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        Fence_t* fencePtr = (Fence_t*)le_ref_GetValue(iterRef);
+
+        if (fencePtr->sessionRef == sessionRef)
+        {
+            DeleteFence(fencePtr);
+        }
+    }
+
+    iterRef = le_ref_GetIterator(HandlerRefMap);
+
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        Handler_t* handlerNodePtr = (Handler_t*)le_ref_GetValue(iterRef);
+
+        if (handlerNodePtr->sessionRef == sessionRef)
+        {
+            le_ref_DeleteRef(HandlerRefMap, handlerNodePtr->ref);
+            le_mem_Release(handlerNodePtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of fences.
+ *
+ * @return The number of fences, of all clients.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t geofence_GetCount
+(
+    void
+)
+{
+    return FenceCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the fences against a position fix, and notify their owners of their transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_CheckFix
+(
+    int32_t latitude,   ///< [IN] Latitude [resolution 1e-6 degree].
+    int32_t longitude,  ///< [IN] Longitude [resolution 1e-6 degree].
+    int32_t hAccuracy   ///< [IN] Horizontal accuracy [resolution 1e-2 meter], or INT32_MAX.
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    double accuracy = (hAccuracy == INT32_MAX) ? 0.0 : (double)hAccuracy / 100.0;
+    le_dls_Link_t* linkPtr;
+
+    if (FenceCount == 0)
+    {
+        return;
+    }
+
+    FixId++;
+
+    // The fences the device is in, for exit and dwell.  A fence leaves the list when exited, so
+    // get the next one first.
+    linkPtr = le_dls_Peek(&InsideList);
+    while (linkPtr != NULL)
+    {
+        le_dls_Link_t* nextLinkPtr = le_dls_PeekNext(&InsideList, linkPtr);
+
+        CheckFence(CONTAINER_OF(linkPtr, Fence_t, insideLink), latitude, longitude, accuracy, now);
+        linkPtr = nextLinkPtr;
+    }
+
+    // The fences around the fix, for entry.
+    uint64_t key = GetCellKey(GetCellIndex(latitude), GetCellIndex(longitude));
+    Cell_t* cellPtr = le_hashmap_Get(CellMap, &key);
+
+    if (cellPtr != NULL)
+    {
+        linkPtr = le_dls_Peek(&cellPtr->entryList);
+        while (linkPtr != NULL)
+        {
+            CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, link);
+
+            CheckFence(entryPtr->fencePtr, latitude, longitude, accuracy, now);
+            linkPtr = le_dls_PeekNext(&cellPtr->entryList, linkPtr);
+        }
+    }
+
+    // The fences too big for the grid.
+    linkPtr = le_dls_Peek(&WideList);
+    while (linkPtr != NULL)
+    {
+        CheckFence(CONTAINER_OF(linkPtr, Fence_t, wideLink), latitude, longitude, accuracy, now);
+        linkPtr = le_dls_PeekNext(&WideList, linkPtr);
+    }
+}
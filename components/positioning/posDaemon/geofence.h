@@ -0,0 +1,122 @@
+/**
+ * @file geofence.h
+ *
+ * Geofencing, used by the positioning service to check the fences of all its clients against each
+ * position fix (see @ref le_pos_geofencing).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_GEOFENCE_INCLUDE_GUARD
+#define LEGATO_GEOFENCE_INCLUDE_GUARD
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the geofencing.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a circular fence.
+ *
+ * @return Reference to the fence, or NULL if LE_POS_MAX_FENCES fences already exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t geofence_Create
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session of the client owning the fence.
+    int32_t             latitude,   ///< [IN] Latitude of the center [resolution 1e-6 degree].
+    int32_t             longitude,  ///< [IN] Longitude of the center [resolution 1e-6 degree].
+    uint32_t            radius,     ///< [IN] Radius, in meters.
+    uint32_t            dwellTime   ///< [IN] Dwell time, in milliseconds (0 for none).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a fence.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the fence doesn't exist or belongs to another client
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t geofence_Delete
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session of the client.
+    le_pos_FenceRef_t   fenceRef    ///< [IN] Fence.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a fence transition handler.
+ *
+ * @return Reference to the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_GeofenceHandlerRef_t geofence_AddHandler
+(
+    le_msg_SessionRef_t          sessionRef,    ///< [IN] Session of the client.
+    le_pos_GeofenceHandlerFunc_t handlerPtr,    ///< [IN] Handler function.
+    void*                        contextPtr     ///< [IN] Handler's context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence transition handler.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the handler doesn't exist or belongs to another client
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t geofence_RemoveHandler
+(
+    le_msg_SessionRef_t         sessionRef, ///< [IN] Session of the client.
+    le_pos_GeofenceHandlerRef_t handlerRef  ///< [IN] Handler.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the fences and handlers of a client.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_DeleteSession
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Session of the client.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of fences.
+ *
+ * @return The number of fences, of all clients.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t geofence_GetCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the fences against a position fix, and notify their owners of their transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_CheckFix
+(
+    int32_t latitude,   ///< [IN] Latitude [resolution 1e-6 degree].
+    int32_t longitude,  ///< [IN] Longitude [resolution 1e-6 degree].
+    int32_t hAccuracy   ///< [IN] Horizontal accuracy [resolution 1e-2 meter], or INT32_MAX.
+);
+
+
+#endif // LEGATO_GEOFENCE_INCLUDE_GUARD
@@ -0,0 +1,506 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file gnssAssist.c
+ *
+ * This file contains the source code of the GNSS start assistance (see
+ * @ref le_gnss_Assisted_GNSS_Local).
+ *
+ * The last position fix is checkpointed in the config tree when the GNSS device is stopped, when
+ * the service is terminated, and periodically while fixes come in.  It is injected into the GNSS
+ * device at the next start, along with the system time, so that the device doesn't have to search
+ * for satellites as if it knew nothing.  The extended ephemeris file, when one is configured, is
+ * loaded whenever a newer version of it appears or the data loaded is about to expire.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_gnss.h"
+#include "posCfgEntries.h"
+#include "gnssAssist.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay before a new fix is checkpointed, in seconds.  Fixes coming in meanwhile are checkpointed
+ * together, to spare the flash.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHECKPOINT_DELAY_S          600
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum age of the last fix for it to be injected, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LAST_FIX_MAX_AGE_S          (12 * 3600)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Speed the device is assumed to move at since the last fix, in centimeters per second.  The
+ * accuracy of the injected position grows with its age at that speed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ASSUMED_SPEED_CM_PER_S      2500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Uncertainty of the injected system time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_UNCERTAINTY_MS         2000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Earliest plausible system time, in milliseconds since Jan. 1, 1970 (Jan. 1, 2016).  An earlier
+ * time means the system clock hasn't been set yet, so it isn't injected.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_SYSTEM_TIME_MS          1451606400000ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval between checks of the extended ephemeris file, in seconds, and validity left under
+ * which the extended ephemeris data loaded is considered to be expiring.
+ */
+//--------------------------------------------------------------------------------------------------
+#define XTRA_CHECK_INTERVAL_S       3600
+#define XTRA_REFRESH_MARGIN_S       (24 * 3600)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the last fix.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_LAST_FIX_PATH           CFG_POSITIONING_ASSIST_PATH"/"CFG_NODE_LAST_FIX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last fix, whether there is one, and whether it has changed since it was checkpointed.
+ */
+//--------------------------------------------------------------------------------------------------
+static gnssAssist_Fix_t LastFix;
+static bool LastFixValid = false;
+static bool LastFixDirty = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer used to checkpoint the last fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t CheckpointTimer;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the extended ephemeris file (empty if none is configured), and modification time of the
+ * version last loaded (0 if none).
+ */
+//--------------------------------------------------------------------------------------------------
+static char XtraFile[PATH_MAX] = "";
+static time_t XtraFileTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the use of the extended ephemeris data is enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool XtraEnabled = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to first fix measurement: time of the last start, whether a fix is awaited since, and
+ * whether assistance data was injected at that start.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t StartTime;
+static bool WaitingFirstFix = false;
+static bool StartAssisted = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to first fix statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t LastTtff = 0;
+static bool LastAssisted = false;
+static uint32_t FixCount = 0;
+static uint64_t TotalTtff = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the system time.
+ *
+ * @return The system time, in milliseconds since Jan. 1, 1970.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetSystemTimeMs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetAbsoluteTime();
+
+    return ((uint64_t)now.sec * 1000) + ((uint64_t)now.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the last fix checkpointed in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadLastFix
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(CFG_LAST_FIX_PATH);
+
+    if (le_cfg_NodeExists(iterRef, ""))
+    {
+        int32_t latitude = le_cfg_GetInt(iterRef, CFG_NODE_LATITUDE, INT32_MAX);
+        int32_t longitude = le_cfg_GetInt(iterRef, CFG_NODE_LONGITUDE, INT32_MAX);
+        int32_t hAccuracy = le_cfg_GetInt(iterRef, CFG_NODE_H_ACCURACY, -1);
+        double epochTime = le_cfg_GetFloat(iterRef, CFG_NODE_FIX_TIME, 0.0);
+
+        if ((latitude < -90000000) || (latitude > 90000000) ||
+            (longitude < -180000000) || (longitude > 180000000) ||
+            (hAccuracy < 0) || (epochTime <= 0.0))
+        {
+            LE_WARN("Ignoring invalid last fix in the config tree.");
+        }
+        else
+        {
+            LastFix.latitude = latitude;
+            LastFix.longitude = longitude;
+            LastFix.hAccuracy = (uint32_t)hAccuracy;
+            LastFix.epochTime = (uint64_t)epochTime;
+            LastFixValid = true;
+        }
+    }
+
+    le_cfg_CancelTxn(iterRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checkpoint the last fix in the config tree, if it has changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveLastFix
+(
+    void
+)
+{
+    if (!LastFixDirty)
+    {
+        return;
+    }
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(CFG_LAST_FIX_PATH);
+
+    le_cfg_SetInt(iterRef, CFG_NODE_LATITUDE, LastFix.latitude);
+    le_cfg_SetInt(iterRef, CFG_NODE_LONGITUDE, LastFix.longitude);
+    le_cfg_SetInt(iterRef, CFG_NODE_H_ACCURACY,
+                  (LastFix.hAccuracy > INT32_MAX) ? INT32_MAX : (int32_t)LastFix.hAccuracy);
+    // Float nodes hold the time in milliseconds exactly, where int nodes would overflow.
+    le_cfg_SetFloat(iterRef, CFG_NODE_FIX_TIME, (double)LastFix.epochTime);
+
+    le_cfg_CommitTxn(iterRef);
+
+    le_timer_Stop(CheckpointTimer);
+    LastFixDirty = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checkpoint timer handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckpointTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer.
+)
+{
+    SaveLastFix();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the extended ephemeris file if a newer version of it has appeared, or if the data loaded
+ * is about to expire.  The file itself is kept up to date by whoever downloads it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RefreshXtra
+(
+    void
+)
+{
+    uint64_t startTime;
+    uint64_t stopTime;
+    bool isExpiring = true;
+    struct stat fileStat;
+
+    if (LE_OK == pa_gnss_GetExtendedEphemerisValidity(&startTime, &stopTime))
+    {
+        isExpiring = (stopTime < (GetSystemTimeMs() / 1000) + XTRA_REFRESH_MARGIN_S);
+    }
+
+    if (0 != stat(XtraFile, &fileStat))
+    {
+        if (isExpiring)
+        {
+            LE_WARN("Extended ephemeris expiring, but '%s' can't be read (%m).", XtraFile);
+        }
+        return;
+    }
+
+    if (fileStat.st_mtime == XtraFileTime)
+    {
+        if (isExpiring)
+        {
+            LE_WARN("Extended ephemeris expiring, waiting for a newer '%s'.", XtraFile);
+        }
+        return;
+    }
+
+    if ((!isExpiring) && (0 == XtraFileTime))
+    {
+        // The data the device already has is still valid: only load the next version of the file.
+        XtraFileTime = fileStat.st_mtime;
+        return;
+    }
+
+    int fd = open(XtraFile, O_RDONLY);
+
+    if (-1 == fd)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", XtraFile);
+        return;
+    }
+
+    le_result_t result = pa_gnss_LoadExtendedEphemerisFile(fd);
+
+    close(fd);
+
+    if (LE_OK != result)
+    {
+        LE_ERROR("Failed to load '%s' (%s).", XtraFile, LE_RESULT_TXT(result));
+        return;
+    }
+
+    XtraFileTime = fileStat.st_mtime;
+
+    if (LE_OK == pa_gnss_GetExtendedEphemerisValidity(&startTime, &stopTime))
+    {
+        LE_INFO("Loaded '%s', valid from %" PRIu64 " to %" PRIu64 ".",
+                XtraFile, startTime, stopTime);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extended ephemeris check timer handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void XtraTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer.
+)
+{
+    RefreshXtra();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the positioning service is asked to stop.  Checkpoints the last fix, then exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnTerminate
+(
+    int sigNum  ///< [IN] The signal that was received.
+)
+{
+    SaveLastFix();
+
+    LE_INFO("Terminated");
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the start assistance: load the last fix checkpointed in the config tree, and enable
+ * and load the extended ephemeris file if one is configured.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Init
+(
+    void
+)
+{
+    CheckpointTimer = le_timer_Create("GnssCheckpoint");
+    le_timer_SetMsInterval(CheckpointTimer, CHECKPOINT_DELAY_S * 1000);
+    le_timer_SetHandler(CheckpointTimer, CheckpointTimerHandler);
+
+    LoadLastFix();
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(CFG_POSITIONING_ASSIST_PATH);
+    if (LE_OK != le_cfg_GetString(iterRef, CFG_NODE_XTRA_FILE, XtraFile, sizeof(XtraFile), ""))
+    {
+        LE_ERROR("Extended ephemeris file path too long.");
+        XtraFile[0] = '\0';
+    }
+    le_cfg_CancelTxn(iterRef);
+
+    if ('\0' != XtraFile[0])
+    {
+        if (LE_OK == pa_gnss_EnableExtendedEphemerisFile())
+        {
+            XtraEnabled = true;
+            RefreshXtra();
+
+            le_timer_Ref_t xtraTimer = le_timer_Create("GnssXtraCheck");
+            le_timer_SetMsInterval(xtraTimer, XTRA_CHECK_INTERVAL_S * 1000);
+            le_timer_SetRepeat(xtraTimer, 0);
+            le_timer_SetHandler(xtraTimer, XtraTimerHandler);
+            le_timer_Start(xtraTimer);
+        }
+        else
+        {
+            LE_ERROR("Failed to enable the extended ephemeris.");
+        }
+    }
+
+    // The last fix is checkpointed before exiting.
+    le_sig_Block(SIGTERM);
+    le_sig_SetEventHandler(SIGTERM, OnTerminate);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inject the assistance data into the GNSS device before it is started, and start measuring the
+ * time to first fix.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Start
+(
+    void
+)
+{
+    uint64_t now = GetSystemTimeMs();
+
+    StartAssisted = false;
+
+    if ((now < MIN_SYSTEM_TIME_MS) || (LastFixValid && (now < LastFix.epochTime)))
+    {
+        LE_WARN("System time not set, no assistance data injected.");
+    }
+    else
+    {
+        // The device only accepts time along with the extended ephemeris data.
+        if (XtraEnabled && (LE_OK == pa_gnss_InjectUtcTime(now, TIME_UNCERTAINTY_MS)))
+        {
+            StartAssisted = true;
+        }
+
+        uint64_t age = (LastFixValid ? (now - LastFix.epochTime) / 1000 : 0);
+
+        if (LastFixValid && (age <= LAST_FIX_MAX_AGE_S))
+        {
+            uint64_t hUncertainty = LastFix.hAccuracy + (age * ASSUMED_SPEED_CM_PER_S);
+            le_result_t result = pa_gnss_InjectPosition(LastFix.latitude,
+                                                        LastFix.longitude,
+                                                        (uint32_t)hUncertainty,
+                                                        LastFix.epochTime);
+            if (LE_OK == result)
+            {
+                StartAssisted = true;
+            }
+            else if (LE_UNSUPPORTED != result)
+            {
+                LE_ERROR("Failed to inject the last fix (%s).", LE_RESULT_TXT(result));
+            }
+        }
+    }
+
+    StartTime = le_clk_GetRelativeTime();
+    WaitingFirstFix = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checkpoint the last fix when the GNSS device is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Stop
+(
+    void
+)
+{
+    WaitingFirstFix = false;
+    SaveLastFix();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a position fix.  The first fix after a start gives the time to first fix.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_ReportFix
+(
+    const gnssAssist_Fix_t* fixPtr  ///< [IN] Position fix.
+)
+{
+    LastFix = *fixPtr;
+    LastFixValid = true;
+    LastFixDirty = true;
+
+    if (WaitingFirstFix)
+    {
+        le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+
+        WaitingFirstFix = false;
+        LastTtff = (uint32_t)((elapsed.sec * 1000) + (elapsed.usec / 1000));
+        LastAssisted = StartAssisted;
+        FixCount++;
+        TotalTtff += LastTtff;
+
+        LE_INFO("Time to first fix: %" PRIu32 " ms (%s start).",
+                LastTtff, StartAssisted ? "assisted" : "unassisted");
+
+        // Don't lose the first fix if the service is killed before the checkpoint delay.
+        SaveLastFix();
+    }
+    else if (!le_timer_IsRunning(CheckpointTimer))
+    {
+        le_timer_Start(CheckpointTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time to first fix statistics.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if no start has got a fix yet
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gnssAssist_GetTtffStats
+(
+    uint32_t* lastTtffPtr,      ///< [OUT] Time to first fix of the last start, in milliseconds.
+    bool*     lastAssistedPtr,  ///< [OUT] Whether assistance data was injected at the last start.
+    uint32_t* fixCountPtr,      ///< [OUT] Number of starts that got a fix.
+    uint32_t* averageTtffPtr    ///< [OUT] Average time to first fix, in milliseconds.
+)
+{
+    *lastTtffPtr = LastTtff;
+    *lastAssistedPtr = LastAssisted;
+    *fixCountPtr = FixCount;
+    *averageTtffPtr = (FixCount ? (uint32_t)(TotalTtff / FixCount) : 0);
+
+    return (FixCount ? LE_OK : LE_BUSY);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file gnssAssist.h
+ *
+ * GNSS start assistance, used by the GNSS service to shorten the time to first fix (see
+ * @ref le_gnss_Assisted_GNSS_Local).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_GNSSASSIST_INCLUDE_GUARD
+#define LEGATO_GNSSASSIST_INCLUDE_GUARD
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position fix, as checkpointed and injected at start.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t  latitude;      ///< Latitude [resolution 1e-6 degree].
+    int32_t  longitude;     ///< Longitude [resolution 1e-6 degree].
+    uint32_t hAccuracy;     ///< Horizontal accuracy, in meters [resolution 1e-2].
+    uint64_t epochTime;     ///< Time of the fix, in milliseconds since Jan. 1, 1970.
+}
+gnssAssist_Fix_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the start assistance: load the last fix checkpointed in the config tree, and enable
+ * and load the extended ephemeris file if one is configured.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inject the assistance data into the GNSS device before it is started, and start measuring the
+ * time to first fix.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Start
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checkpoint the last fix when the GNSS device is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_Stop
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a position fix.  The first fix after a start gives the time to first fix.
+ */
+//--------------------------------------------------------------------------------------------------
+void gnssAssist_ReportFix
+(
+    const gnssAssist_Fix_t* fixPtr  ///< [IN] Position fix.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time to first fix statistics.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if no start has got a fix yet
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gnssAssist_GetTtffStats
+(
+    uint32_t* lastTtffPtr,      ///< [OUT] Time to first fix of the last start, in milliseconds.
+    bool*     lastAssistedPtr,  ///< [OUT] Whether assistance data was injected at the last start.
+    uint32_t* fixCountPtr,      ///< [OUT] Number of starts that got a fix.
+    uint32_t* averageTtffPtr    ///< [OUT] Average time to first fix, in milliseconds.
+);
+
+
+#endif // LEGATO_GNSSASSIST_INCLUDE_GUARD
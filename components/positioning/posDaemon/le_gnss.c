@@ -12,6 +12,9 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_gnss.h"
+#include "posCfgEntries.h"
+#include "gnssAssist.h"
+#include <sys/uio.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -31,6 +34,24 @@
 //--------------------------------------------------------------------------------------------------
 #define LE_GNSS_NMEA_NODE_PATH                  "/dev/nmea"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default and minimum size of the NMEA output buffer, in bytes.  The size can be changed with the
+ * "nmeaBufferSize" node of the positioning config tree, and is read at start-up.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_BUFFER_DEFAULT_BYTES               4096
+#define NMEA_BUFFER_MIN_BYTES                   256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay before the buffered NMEA sentences are written to the NMEA pipe, in milliseconds.  All the
+ * sentences of an epoch are reported in a burst, well within this delay, so they are written
+ * together.  Also the delay before retrying when the pipe is full.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_FLUSH_DELAY_MS                     50
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SV ID definitions corresponding to SBAS constellation categories
@@ -92,6 +113,29 @@ typedef struct {
 }
 le_gnss_SvMeas_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA output buffer.
+ *
+ * A ring of NUL-terminated sentences waiting to be written to the NMEA pipe.  When there is no
+ * room for a new sentence, the oldest ones are dropped, unless the oldest one has already been
+ * partly written (dropping the rest of it would garble the flow).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char*           bufferPtr;          ///< Ring buffer.
+    size_t          size;               ///< Size of the ring buffer, in bytes.
+    size_t          head;               ///< Index of the first byte not written yet.
+    size_t          used;               ///< Number of bytes not written yet.
+    bool            headPartial;        ///< true if the first sentence has been partly written.
+    uint32_t        bufferedCount;      ///< Number of sentences (or part sentences) buffered.
+    uint32_t        writtenCount;       ///< Number of sentences written to the pipe.
+    uint32_t        droppedCount;       ///< Number of sentences dropped.
+    le_timer_Ref_t  flushTimer;         ///< Timer used to write the buffer to the pipe.
+}
+NmeaBuffer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position Sample structure.
@@ -257,11 +301,12 @@ static le_dls_List_t PositionHandlerList = LE_DLS_LIST_INIT;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Memory Pool for position samples.
+ * Last position sample.  The samples are never modified once filled in, so this one is shared
+ * (with a reference count) by all the position sample references given out since it was received.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_gnss_PositionSample_t   LastPositionSample;
+static le_gnss_PositionSample_t*  LastPositionSamplePtr = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -302,6 +347,13 @@ static le_ref_MapRef_t PositionSampleMap;
 //--------------------------------------------------------------------------------------------------
 static int NmeaPipeFd = -1;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA output buffer
+ */
+//--------------------------------------------------------------------------------------------------
+static NmeaBuffer_t NmeaBuffer;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position Handler destructor.
@@ -480,44 +532,237 @@ static le_result_t CloseNmeaPipe
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write the NMEA sentence to NMEA pipe
+ * Drop the oldest sentence of the NMEA buffer.
+ *
+ * @return
+ *  - true if a sentence has been dropped
+ *  - false if the buffer is empty, or its oldest sentence has been partly written
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteNmeaPipe
+static bool DropOldestNmeaSentence
 (
-    const char*  nmeaStringPtr          ///< [IN] Pointer to the NMEA sentence to write.
+    void
 )
 {
-    le_result_t resultNmeaPipe = LE_OK;
-    ssize_t resultWrite = 0;
-    ssize_t written = 0;
-    ssize_t stringSize = 0;
+    char* startPtr = NmeaBuffer.bufferPtr + NmeaBuffer.head;
+    char* endPtr;
+    size_t length;
 
-    // Open the NMEA FIFO pipe
+    if ((0 == NmeaBuffer.used) || (NmeaBuffer.headPartial))
+    {
+        return false;
+    }
+
+    // The sentence may wrap around the end of the ring.
+    endPtr = memchr(startPtr, '\0', NmeaBuffer.size - NmeaBuffer.head);
+    if (NULL != endPtr)
+    {
+        length = endPtr - startPtr + 1;
+    }
+    else
+    {
+        endPtr = memchr(NmeaBuffer.bufferPtr, '\0', NmeaBuffer.head);
+        LE_ASSERT(NULL != endPtr);
+        length = NmeaBuffer.size - NmeaBuffer.head + (endPtr - NmeaBuffer.bufferPtr) + 1;
+    }
+
+    NmeaBuffer.head = (NmeaBuffer.head + length) % NmeaBuffer.size;
+    NmeaBuffer.used -= length;
+    NmeaBuffer.bufferedCount--;
+    NmeaBuffer.droppedCount++;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the bytes written to the NMEA pipe from the NMEA buffer, and count the sentences they
+ * complete.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConsumeNmeaBuffer
+(
+    size_t  length          ///< [IN] Number of bytes written.
+)
+{
+    while (length > 0)
+    {
+        char* startPtr = NmeaBuffer.bufferPtr + NmeaBuffer.head;
+        size_t chunk = NmeaBuffer.size - NmeaBuffer.head;
+        char* endPtr;
+
+        if (chunk > length)
+        {
+            chunk = length;
+        }
+
+        endPtr = memchr(startPtr, '\0', chunk);
+        if (NULL != endPtr)
+        {
+            // One more complete sentence.
+            chunk = endPtr - startPtr + 1;
+            NmeaBuffer.headPartial = false;
+            NmeaBuffer.bufferedCount--;
+            NmeaBuffer.writtenCount++;
+        }
+        else
+        {
+            NmeaBuffer.headPartial = true;
+        }
+
+        NmeaBuffer.head = (NmeaBuffer.head + chunk) % NmeaBuffer.size;
+        NmeaBuffer.used -= chunk;
+        length -= chunk;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the NMEA buffer to the NMEA pipe, with a single write.
+ *
+ * What can't be written because the pipe is full stays in the buffer, and is written later.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushNmeaBuffer
+(
+    le_timer_Ref_t timerRef     ///< [IN] Flush timer.
+)
+{
+    le_result_t resultNmeaPipe;
+    struct iovec iov[2];
+    int iovCount = 1;
+    ssize_t resultWrite;
+
+    if (0 == NmeaBuffer.used)
+    {
+        return;
+    }
+
+    // Open the NMEA FIFO pipe.  If nobody reads it, keep the sentences until the buffer is full.
     resultNmeaPipe = OpenNmeaPipe();
+    if ((LE_OK != resultNmeaPipe) && (LE_DUPLICATE != resultNmeaPipe))
+    {
+        return;
+    }
+
+    // The buffered bytes may wrap around the end of the ring.
+    iov[0].iov_base = NmeaBuffer.bufferPtr + NmeaBuffer.head;
+    iov[0].iov_len = NmeaBuffer.used;
+    if (NmeaBuffer.head + NmeaBuffer.used > NmeaBuffer.size)
+    {
+        iov[0].iov_len = NmeaBuffer.size - NmeaBuffer.head;
+        iov[1].iov_base = NmeaBuffer.bufferPtr;
+        iov[1].iov_len = NmeaBuffer.used - iov[0].iov_len;
+        iovCount = 2;
+    }
+
+    do
+    {
+        resultWrite = writev(NmeaPipeFd, iov, iovCount);
+    }
+    while ((resultWrite < 0) && (EINTR == errno));
 
-    if((resultNmeaPipe == LE_OK)||(resultNmeaPipe == LE_DUPLICATE))
+    if (resultWrite < 0)
     {
-        written = 0;
-        stringSize = strlen(nmeaStringPtr)+1;
-        // Write to NMEA pipe
-        while (written < stringSize)
+        if ((EAGAIN != errno) && (EWOULDBLOCK != errno))
         {
-            resultWrite = write(NmeaPipeFd, nmeaStringPtr + written, stringSize - written);
+            LE_ERROR("Could not write to %s (write error, errno.%d (%s))",
+                     LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
+            CloseNmeaPipe();
+            return;
+        }
+        resultWrite = 0;
+    }
 
-            if ((resultWrite < 0) && (errno != EINTR))
-            {
-                LE_ERROR("Could not write to %s (write error, errno.%d (%s))",
-                         LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
-                CloseNmeaPipe();
-                return LE_FAULT;
-            }
+    ConsumeNmeaBuffer(resultWrite);
+
+    // The pipe is full: try again later.
+    if ((NmeaBuffer.used > 0) && (!le_timer_IsRunning(NmeaBuffer.flushTimer)))
+    {
+        le_timer_Start(NmeaBuffer.flushTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an NMEA sentence to the NMEA buffer, dropping the oldest ones if there isn't room for it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BufferNmeaSentence
+(
+    const char*  nmeaStringPtr          ///< [IN] Pointer to the NMEA sentence to write.
+)
+{
+    // The terminating NUL is written to the pipe as well.
+    size_t length = strlen(nmeaStringPtr) + 1;
+    size_t tail;
+    size_t chunk;
 
-            written += resultWrite;
+    while (NmeaBuffer.size - NmeaBuffer.used < length)
+    {
+        if (!DropOldestNmeaSentence())
+        {
+            NmeaBuffer.droppedCount++;
+            return;
         }
     }
 
-    return LE_OK;
+    tail = (NmeaBuffer.head + NmeaBuffer.used) % NmeaBuffer.size;
+    chunk = NmeaBuffer.size - tail;
+    if (chunk > length)
+    {
+        chunk = length;
+    }
+
+    memcpy(NmeaBuffer.bufferPtr + tail, nmeaStringPtr, chunk);
+    memcpy(NmeaBuffer.bufferPtr, nmeaStringPtr + chunk, length - chunk);
+
+    NmeaBuffer.used += length;
+    NmeaBuffer.bufferedCount++;
+
+    if (!le_timer_IsRunning(NmeaBuffer.flushTimer))
+    {
+        le_timer_Start(NmeaBuffer.flushTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the NMEA output buffer, with the size set in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitNmeaBuffer
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t posCfg = le_cfg_CreateReadTxn(CFG_POSITIONING_PATH);
+    int32_t size = le_cfg_GetInt(posCfg, CFG_NODE_NMEA_BUFFER_SIZE, NMEA_BUFFER_DEFAULT_BYTES);
+    le_cfg_CancelTxn(posCfg);
+
+    if (size < NMEA_BUFFER_MIN_BYTES)
+    {
+        LE_WARN("NMEA buffer size %d too small, using %d bytes", size, NMEA_BUFFER_MIN_BYTES);
+        size = NMEA_BUFFER_MIN_BYTES;
+    }
+
+    le_mem_PoolRef_t poolRef = le_mem_CreatePool("NmeaBufferPool", size);
+    le_mem_ExpandPool(poolRef, 1);
+
+    NmeaBuffer.bufferPtr = le_mem_ForceAlloc(poolRef);
+    NmeaBuffer.size = size;
+    NmeaBuffer.head = 0;
+    NmeaBuffer.used = 0;
+    NmeaBuffer.headPartial = false;
+    NmeaBuffer.bufferedCount = 0;
+    NmeaBuffer.writtenCount = 0;
+    NmeaBuffer.droppedCount = 0;
+
+    NmeaBuffer.flushTimer = le_timer_Create("NmeaFlushTimer");
+    le_timer_SetMsInterval(NmeaBuffer.flushTimer, NMEA_FLUSH_DELAY_MS);
+    le_timer_SetHandler(NmeaBuffer.flushTimer, FlushNmeaBuffer);
+
+    LE_DEBUG("NMEA buffer of %d bytes", size);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -533,8 +778,8 @@ static void PaNmeaHandler
 {
     LE_DEBUG("Handler Function called with PA NMEA %p", nmeaPtr);
 
-    // Write the NMEA sentence to the /dev/nmea device folder
-    WriteNmeaPipe(nmeaPtr);
+    // Queue the NMEA sentence for the /dev/nmea device folder
+    BufferNmeaSentence(nmeaPtr);
 
     le_mem_Release(nmeaPtr);
 }
@@ -676,6 +921,60 @@ static void SigPipeHandler
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace the last position sample with an empty one (no position fix).  The previous sample isn't
+ * modified, as clients may still be referencing it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetLastPositionSample
+(
+    void
+)
+{
+    le_gnss_PositionSample_t* positionSamplePtr =
+                            (le_gnss_PositionSample_t*)le_mem_ForceAlloc(PositionSamplePoolRef);
+
+    memset(positionSamplePtr, 0, sizeof(le_gnss_PositionSample_t));
+    positionSamplePtr->fixState = LE_GNSS_STATE_FIX_NO_POS;
+    positionSamplePtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&PositionSampleList, &(positionSamplePtr->link));
+
+    if (NULL != LastPositionSamplePtr)
+    {
+        le_mem_Release(LastPositionSamplePtr);
+    }
+    LastPositionSamplePtr = positionSamplePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a position sample request object, holding a reference to a given position sample, and
+ * its safe reference.
+ *
+ * @return The request object.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionSampleRequest_t* NewPositionSampleRequest
+(
+    le_gnss_PositionSample_t* positionSamplePtr,    // [IN] The position sample.
+    le_msg_SessionRef_t       sessionRef            // [IN] Client session of the request.
+)
+{
+    le_gnss_PositionSampleRequest_t* positionSampleRequestNodePtr =
+                 (le_gnss_PositionSampleRequest_t*)le_mem_ForceAlloc(PositionSampleRequestPoolRef);
+
+    le_mem_AddRef(positionSamplePtr);
+    positionSampleRequestNodePtr->positionSampleNodePtr = positionSamplePtr;
+    positionSampleRequestNodePtr->sessionRef = sessionRef;
+    positionSampleRequestNodePtr->positionSampleRef = le_ref_CreateRef(PositionSampleMap,
+                                                               positionSampleRequestNodePtr);
+    positionSampleRequestNodePtr->link = LE_DLS_LINK_INIT;
+
+    return positionSampleRequestNodePtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // APIs.
 //--------------------------------------------------------------------------------------------------
@@ -694,8 +993,7 @@ static void PaPositionHandler
 
     le_gnss_PositionHandler_t*  positionHandlerNodePtr;
     le_dls_Link_t*              linkPtr;
-    le_gnss_PositionSampleRequest_t*    positionSampleRequestNodePtr=NULL;
-    uint8_t i;
+    le_gnss_PositionSample_t*   positionSamplePtr;
 
     if (NULL == positionPtr)
     {
@@ -705,74 +1003,60 @@ static void PaPositionHandler
 
     LE_DEBUG("Handler Function called with PA position %p", positionPtr);
 
-    // Get the position sample data from the PA position data report
-    GetPosSampleData(&LastPositionSample, positionPtr);
+    // Get the position sample data from the PA position data report.  The sample is filled in
+    // once and then shared, read-only, by every reference to it.
+    positionSamplePtr = (le_gnss_PositionSample_t*)le_mem_ForceAlloc(PositionSamplePoolRef);
+    GetPosSampleData(positionSamplePtr, positionPtr);
+    le_dls_Queue(&PositionSampleList, &(positionSamplePtr->link));
+
+    // Keep the fix for the next start.
+    if (((LE_GNSS_STATE_FIX_2D == positionSamplePtr->fixState) ||
+         (LE_GNSS_STATE_FIX_3D == positionSamplePtr->fixState)) &&
+        positionSamplePtr->latitudeValid && positionSamplePtr->longitudeValid &&
+        positionSamplePtr->hAccuracyValid && positionSamplePtr->dateValid &&
+        positionSamplePtr->timeValid)
+    {
+        gnssAssist_Fix_t fix;
+
+        fix.latitude = positionSamplePtr->latitude;
+        fix.longitude = positionSamplePtr->longitude;
+        fix.hAccuracy = (uint32_t)positionSamplePtr->hAccuracy;
+        fix.epochTime = positionSamplePtr->epochTime;
+        gnssAssist_ReportFix(&fix);
+    }
+
+    le_mem_Release(positionPtr);
+
+    // It replaces the last position sample.  Samples still referenced by clients stay alive.
+    le_mem_Release(LastPositionSamplePtr);
+    LastPositionSamplePtr = positionSamplePtr;
 
     if(!NumOfPositionHandlers)
     {
         LE_DEBUG("No positioning handlers, exit Handler Function");
-        le_mem_Release(positionPtr);
         return;
     }
 
+    // Call Handler(s), each with its own reference to the shared sample.
     linkPtr = le_dls_Peek(&PositionHandlerList);
-    if (NULL != linkPtr)
+    while (NULL != linkPtr)
     {
-        // Create the position request sample node.
-        positionSampleRequestNodePtr =
-                 (le_gnss_PositionSampleRequest_t*)le_mem_ForceAlloc(PositionSampleRequestPoolRef);
-
-        // Create the position sample node.
-        positionSampleRequestNodePtr->positionSampleNodePtr =
-                 (le_gnss_PositionSample_t*)le_mem_ForceAlloc(PositionSamplePoolRef);
-
-        // Add reference for each subscribe handler.
-        for(i=0 ; i<NumOfPositionHandlers-1 ; i++)
-        {
-            le_mem_AddRef((void *)positionSampleRequestNodePtr);
-            le_mem_AddRef((void *)positionSampleRequestNodePtr->positionSampleNodePtr);
-        }
-
-        // Copy the position sample to the position sample node
-        memcpy(positionSampleRequestNodePtr->positionSampleNodePtr, &LastPositionSample,
-                     sizeof(le_gnss_PositionSample_t));
-
-        // Add the node to the queue of the list by passing in the node's link.
-        le_dls_Queue(&PositionSampleList, &(positionSampleRequestNodePtr->
-                                                positionSampleNodePtr->link));
-
-        // Call Handler(s)
-        do
-        {
-            // Get the node from the list
-            positionHandlerNodePtr =
-                (le_gnss_PositionHandler_t*)CONTAINER_OF(linkPtr, le_gnss_PositionHandler_t, link);
+        // Get the node from the list
+        positionHandlerNodePtr =
+            (le_gnss_PositionHandler_t*)CONTAINER_OF(linkPtr, le_gnss_PositionHandler_t, link);
 
-            LE_DEBUG("Report sample %p to the corresponding handler (handler %p)",
-                     positionSampleRequestNodePtr->positionSampleNodePtr,
-                     positionHandlerNodePtr->handlerFuncPtr);
+        // Move to the next node now, as the handler may remove itself.
+        linkPtr = le_dls_PeekNext(&PositionHandlerList, linkPtr);
 
-            // Create a safe reference and call the client's handler
-            le_gnss_SampleRef_t safePositionSampleRef = le_ref_CreateRef(PositionSampleMap,
-                                                           positionSampleRequestNodePtr);
+        LE_DEBUG("Report sample %p to the corresponding handler (handler %p)",
+                 positionSamplePtr, positionHandlerNodePtr->handlerFuncPtr);
 
-            // Store message session reference which will be useful for close session handler
-            positionSampleRequestNodePtr->sessionRef = positionHandlerNodePtr->sessionRef;
+        le_gnss_PositionSampleRequest_t* positionSampleRequestNodePtr =
+                NewPositionSampleRequest(positionSamplePtr, positionHandlerNodePtr->sessionRef);
 
-            // Store safereference which will be useful for close session handler
-            positionSampleRequestNodePtr->positionSampleRef = safePositionSampleRef;
-
-            if(safePositionSampleRef != NULL)
-            {
-                positionHandlerNodePtr->handlerFuncPtr(safePositionSampleRef,
-                                                   positionHandlerNodePtr->handlerContextPtr);
-            }
-            // Move to the next node.
-            linkPtr = le_dls_PeekNext(&PositionHandlerList, linkPtr);
-        } while (NULL != linkPtr);
+        positionHandlerNodePtr->handlerFuncPtr(positionSampleRequestNodePtr->positionSampleRef,
+                                               positionHandlerNodePtr->handlerContextPtr);
     }
-
-    le_mem_Release(positionPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -932,8 +1216,7 @@ le_result_t gnss_Init
     PaHandlerRef = NULL;
 
     // Initialize last Position sample
-    memset(&LastPositionSample, 0, sizeof(LastPositionSample));
-    LastPositionSample.fixState = LE_GNSS_STATE_FIX_NO_POS;
+    ResetLastPositionSample();
 
     // Subscribe to PA position Data handler
     if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
@@ -949,6 +1232,8 @@ le_result_t gnss_Init
     // That node is a FIFO (named pipe): it will be managed from Legato (User space).
     if ((resultStat == 0) && (S_ISFIFO(nmeaFileStat.st_mode))) // FIFO (named pipe)
     {
+         InitNmeaBuffer();
+
          if ((PaNmeaHandlerRef=pa_gnss_AddNmeaHandler(PaNmeaHandler)) == NULL)
          {
              LE_ERROR("Failed to add PA NMEA handler!");
@@ -960,6 +1245,8 @@ le_result_t gnss_Init
     }
     else if((resultStat == -1)&&(errno == ENOENT)) // No such file or directory
     {
+        InitNmeaBuffer();
+
         if ((PaNmeaHandlerRef=pa_gnss_AddNmeaHandler(PaNmeaHandler)) != NULL)
         {
             // Create NMEA device folder
@@ -976,6 +1263,11 @@ le_result_t gnss_Init
                LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
     }
 
+    if (LE_OK == result)
+    {
+        gnssAssist_Init();
+    }
+
     return result;
 }
 
@@ -2602,6 +2894,114 @@ le_result_t le_gnss_GetMagneticDeviation
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the main data of a position sample in a single call: fix state, location, altitude,
+ * speeds, direction, epoch time, horizontal DOP and number of satellites used.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OUT_OF_RANGE  One of the retrieved parameter is invalid. Invalid parameters are set as by
+ *                     the function that returns them separately (e.g. INT32_MAX for latitude,
+ *                     UINT32_MAX for direction, 0 for epoch time).
+ *  - LE_OK            Function succeeded.
+ *
+ * @note If the caller is passing an invalid Position sample reference into this function,
+ *       it is a fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetPositionFix
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_FixState_t* statePtr,
+        ///< [OUT] Position fix state.
+
+    int32_t* latitudePtr,
+        ///< [OUT] WGS84 Latitude in degrees, positive North [resolution 1e-6].
+
+    int32_t* longitudePtr,
+        ///< [OUT] WGS84 Longitude in degrees, positive East [resolution 1e-6].
+
+    int32_t* hAccuracyPtr,
+        ///< [OUT] Horizontal position's accuracy in meters [resolution 1e-2].
+
+    int32_t* altitudePtr,
+        ///< [OUT] Altitude in meters, above Mean Sea Level [resolution 1e-3].
+
+    int32_t* vAccuracyPtr,
+        ///< [OUT] Vertical position's accuracy in meters [resolution 1e-1].
+
+    uint32_t* hSpeedPtr,
+        ///< [OUT] Horizontal speed in meters/second [resolution 1e-2].
+
+    int32_t* vSpeedPtr,
+        ///< [OUT] Vertical speed in meters/second [resolution 1e-2], positive up.
+
+    uint32_t* directionPtr,
+        ///< [OUT] Direction in degrees [resolution 1e-1].
+        ///< Range: 0 to 359.9, where 0 is True North.
+
+    uint64_t* epochTimePtr,
+        ///< [OUT] Milliseconds since Jan. 1, 1970.
+
+    uint16_t* hdopPtr,
+        ///< [OUT] Horizontal Dilution of Precision [resolution 1e-3].
+
+    uint8_t* satsUsedCountPtr
+        ///< [OUT] Number of satellites used for navigation.
+)
+{
+    le_result_t result = LE_OK;
+    le_gnss_PositionSampleRequest_t* positionSampleRequestNodePtr
+                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+
+    // Check position sample's reference
+    result = ValidatePositionSamplePtr(positionSampleRequestNodePtr);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    const le_gnss_PositionSample_t* samplePtr = positionSampleRequestNodePtr->positionSampleNodePtr;
+
+// Set an output parameter to a sample field, or to its invalid value if the field isn't valid.
+#define GET_FIELD(outPtr, valid, field, invalidValue)   \
+    if (outPtr)                                         \
+    {                                                   \
+        if (samplePtr->valid)                           \
+        {                                               \
+            *(outPtr) = samplePtr->field;               \
+        }                                               \
+        else                                            \
+        {                                               \
+            *(outPtr) = (invalidValue);                 \
+            result = LE_OUT_OF_RANGE;                   \
+        }                                               \
+    }
+
+    if (statePtr)
+    {
+        *statePtr = samplePtr->fixState;
+    }
+    GET_FIELD(latitudePtr, latitudeValid, latitude, INT32_MAX);
+    GET_FIELD(longitudePtr, longitudeValid, longitude, INT32_MAX);
+    GET_FIELD(hAccuracyPtr, hAccuracyValid, hAccuracy, INT32_MAX);
+    GET_FIELD(altitudePtr, altitudeValid, altitude, INT32_MAX);
+    GET_FIELD(vAccuracyPtr, vAccuracyValid, vAccuracy, INT32_MAX);
+    GET_FIELD(hSpeedPtr, hSpeedValid, hSpeed, UINT32_MAX);
+    GET_FIELD(vSpeedPtr, vSpeedValid, vSpeed, INT32_MAX);
+    GET_FIELD(directionPtr, directionValid, direction, UINT32_MAX);
+    GET_FIELD(epochTimePtr, timeValid, epochTime, 0);
+    GET_FIELD(hdopPtr, hdopValid, hdop, UINT16_MAX);
+    GET_FIELD(satsUsedCountPtr, satsUsedCountValid, satsUsedCount, UINT8_MAX);
+
+#undef GET_FIELD
+
+    return result;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2619,30 +3019,11 @@ le_gnss_SampleRef_t le_gnss_GetLastSampleRef
     void
 )
 {
-    le_gnss_PositionSampleRequest_t*   positionSampleRequestNodePtr=NULL;
-
-    // Create the position sample node.
-    positionSampleRequestNodePtr =
-               (le_gnss_PositionSampleRequest_t*)le_mem_ForceAlloc(PositionSampleRequestPoolRef);
-    positionSampleRequestNodePtr->positionSampleNodePtr =
-               (le_gnss_PositionSample_t*)le_mem_ForceAlloc(PositionSamplePoolRef);
-
-    // Copy the position sample to the position sample node
-    memcpy(positionSampleRequestNodePtr->positionSampleNodePtr, &LastPositionSample,
-           sizeof(le_gnss_PositionSample_t));
+    LE_DEBUG("Get sample %p", LastPositionSamplePtr);
 
-    // Add the node to the queue of the list by passing in the node's link.
-    le_dls_Queue(&PositionSampleList, &(positionSampleRequestNodePtr->positionSampleNodePtr->link));
-
-    LE_DEBUG("Get sample %p", positionSampleRequestNodePtr->positionSampleNodePtr);
-
-    positionSampleRequestNodePtr->sessionRef = le_gnss_GetClientSessionRef();
-
-    le_gnss_SampleRef_t reqRef = le_ref_CreateRef(PositionSampleMap, positionSampleRequestNodePtr);
-    positionSampleRequestNodePtr->positionSampleRef = reqRef;
-
-    // Create a safe reference and call the client's handler
-    return reqRef;
+    // Share the last position sample rather than copying it.
+    return NewPositionSampleRequest(LastPositionSamplePtr,
+                                    le_gnss_GetClientSessionRef())->positionSampleRef;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -3020,7 +3401,8 @@ le_result_t le_gnss_Start
     {
         case LE_GNSS_STATE_READY:
         {
-            // Start GNSS
+            // Inject the last fix and the time, then start GNSS
+            gnssAssist_Start();
             result = pa_gnss_Start();
             // Update GNSS device state
             if(result == LE_OK)
@@ -3083,9 +3465,11 @@ le_result_t le_gnss_Stop
             // Update GNSS device state
             if (LE_OK == result)
             {
+                // Checkpoint the last fix
+                gnssAssist_Stop();
+
                 // Initialize last Position sample
-                memset(&LastPositionSample, 0, sizeof(LastPositionSample));
-                LastPositionSample.fixState = LE_GNSS_STATE_FIX_NO_POS;
+                ResetLastPositionSample();
 
                 GnssState = LE_GNSS_STATE_READY;
             }
@@ -3856,6 +4240,70 @@ le_result_t le_gnss_GetNmeaSentences
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the statistics of the NMEA flow written to the "/dev/nmea" pipe.
+ *
+ * @return
+ *  - LE_OK             Success
+ *
+ * @note If the caller is passing an null pointer to this function, it is a fatal error
+ *       and the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetNmeaStats
+(
+    uint32_t* writtenCountPtr,  ///< [OUT] Number of NMEA sentences written to the pipe.
+    uint32_t* droppedCountPtr,  ///< [OUT] Number of NMEA sentences dropped because the pipe
+                                ///<       reader was too slow or absent.
+    uint32_t* bufferedCountPtr  ///< [OUT] Number of NMEA sentences waiting to be written.
+)
+{
+    if ((NULL == writtenCountPtr) || (NULL == droppedCountPtr) || (NULL == bufferedCountPtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer!");
+        return LE_FAULT;
+    }
+
+    *writtenCountPtr = NmeaBuffer.writtenCount;
+    *droppedCountPtr = NmeaBuffer.droppedCount;
+    *bufferedCountPtr = NmeaBuffer.bufferedCount;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the time to first fix statistics of the starts requested with
+ * le_gnss_Start().
+ *
+ * @return
+ *  - LE_OK             Success
+ *  - LE_BUSY           No start has got a position fix yet
+ *
+ * @note If the caller is passing an null pointer to this function, it is a fatal error
+ *       and the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetTtffStats
+(
+    uint32_t* lastTtffPtr,      ///< [OUT] TTFF of the last start, in milliseconds.
+    bool* lastAssistedPtr,      ///< [OUT] true if the last fix or the time was injected at
+                                ///<       the last start.
+    uint32_t* fixCountPtr,      ///< [OUT] Number of starts that got a position fix.
+    uint32_t* averageTtffPtr    ///< [OUT] Average TTFF of those starts, in milliseconds.
+)
+{
+    if ((NULL == lastTtffPtr) || (NULL == lastAssistedPtr) || (NULL == fixCountPtr) ||
+        (NULL == averageTtffPtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer!");
+        return LE_FAULT;
+    }
+
+    return gnssAssist_GetTtffStats(lastTtffPtr, lastAssistedPtr, fixCountPtr, averageTtffPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function returns the state of the GNSS device.
@@ -13,6 +13,7 @@
 #include "interfaces.h"
 #include "le_gnss_local.h"
 #include "posCfgEntries.h"
+#include "geofence.h"
 
 #include <math.h>
 
@@ -115,7 +116,11 @@ typedef struct le_pos_SampleHandler
 {
     le_pos_MovementHandlerFunc_t handlerFuncPtr;      ///< The handler function address.
     void*                        handlerContextPtr;   ///< The handler function context.
-    uint32_t                     acquisitionRate;     ///< The acquisition rate for this handler.
+    uint32_t                     acquisitionRate;     ///< The acquisition rate for this handler,
+                                                      ///  in milliseconds (0 to follow the
+                                                      ///  configured acquisition rate).
+    le_clk_Time_t                lastCheckTime;       ///< When a position sample was last checked
+                                                      ///  for this handler.
     uint32_t                     horizontalMagnitude; ///< The horizontal magnitude in meters for
                                                       ///  this handler.
     uint32_t                     verticalMagnitude;   ///< The vertical magnitude in meters for this
@@ -266,11 +271,19 @@ static le_gnss_PositionHandlerRef_t GnssHandlerRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The acquisition rate in milliseconds.
+ * The configured acquisition rate in milliseconds.
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t AcqRate = 1000; // in milliseconds.
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The acquisition rate in milliseconds the GNSS device is set to: the fastest rate needed by the
+ * movement handlers, or the configured rate if there are none.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GnssAcqRate = 0; // in milliseconds.
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Verify GNSS device availability. TODO
@@ -366,8 +379,11 @@ static void PosSampleHandlerDestructor
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Calculate the GNSS's Acquisistion rate.
+ * Calculate the acquisition rate a movement handler needs: about the time it takes to cover the
+ * smallest of its magnitudes at a given average speed.
  *
+ * @return The rate in milliseconds, or 0 if both magnitudes are 0 (the handler is to be called at
+ *         the configured acquisition rate).
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t CalculateAcquisitionRate
@@ -377,23 +393,78 @@ static uint32_t CalculateAcquisitionRate
     uint32_t verticalMagnitude     // The vertical magnitude in meters.
 )
 {
-    uint32_t  rate;
     uint32_t  metersec = averageSpeed*1000/3600; // convert speed in m/sec
+    uint32_t  magnitude;
+
+    // A magnitude of 0 means that the handler doesn't care about that direction.
+    if (0 == horizontalMagnitude)
+    {
+        magnitude = verticalMagnitude;
+    }
+    else if (0 == verticalMagnitude)
+    {
+        magnitude = horizontalMagnitude;
+    }
+    else
+    {
+        magnitude = (horizontalMagnitude < verticalMagnitude) ? horizontalMagnitude
+                                                              : verticalMagnitude;
+    }
 
-    if ((horizontalMagnitude<metersec) || (verticalMagnitude<metersec))
+    if (0 == magnitude)
     {
-        return 1;
+        return 0;
     }
 
-    rate = 0;
-    while (! (((horizontalMagnitude >= (metersec + metersec*rate)) &&
-               (verticalMagnitude >= (metersec + metersec*rate))) &&
-             ((horizontalMagnitude < (metersec + metersec*(rate+1))) ||
-              (verticalMagnitude < (metersec + metersec*(rate+1))))))
+    if (magnitude < metersec)
     {
-        rate++;
+        return 1000;
     }
-    return rate + 2;
+
+    return (magnitude/metersec + 1) * 1000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the acquisition rate of a movement handler.
+ *
+ * @return The rate in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetHandlerRate
+(
+    const le_pos_SampleHandler_t* posSampleHandlerNodePtr
+)
+{
+    if (0 == posSampleHandlerNodePtr->acquisitionRate)
+    {
+        return AcqRate;
+    }
+
+    return posSampleHandlerNodePtr->acquisitionRate;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a position sample is to be checked for a movement handler, i.e. whether the
+ * handler's acquisition rate has elapsed since the last one was.  The GNSS device may run faster
+ * than the handler needs, for other handlers, so the samples are decimated for each handler.
+ *
+ * @return true if the sample is to be checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHandlerDue
+(
+    const le_pos_SampleHandler_t* posSampleHandlerNodePtr,
+    le_clk_Time_t                 now
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(now, posSampleHandlerNodePtr->lastCheckTime);
+    uint64_t elapsedMs = (uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000;
+
+    // Allow half a GNSS acquisition period of jitter, or the handler would wait a whole
+    // period more each time a sample arrives a little early.
+    return ((elapsedMs + GnssAcqRate/2) >= GetHandlerRate(posSampleHandlerNodePtr));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -468,41 +539,79 @@ static bool IsBeyondMagnitude
 /**
  * Calculate the smallest acquisition rate to use for all the registered handlers.
  *
+ * @return The rate in milliseconds, the configured acquisition rate if there are no handlers.
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t ComputeCommonSmallestRate
 (
-    uint32_t rate
+    void
 )
 {
     le_pos_SampleHandler_t *posSampleHandlerNodePtr;
     le_dls_Link_t          *linkPtr;
+    uint32_t               rate = UINT32_MAX;
 
     linkPtr = le_dls_Peek(&PosSampleHandlerList);
-    if (linkPtr != NULL)
+    while (linkPtr != NULL)
     {
-        do
+        // Get the node from the list
+        posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
+                                                                        le_pos_SampleHandler_t,
+                                                                        link);
+        if (GetHandlerRate(posSampleHandlerNodePtr) < rate)
         {
-            // Get the node from the list
-            posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
-                                                                            le_pos_SampleHandler_t,
-                                                                            link);
-            // Check the node.
-            if (posSampleHandlerNodePtr->acquisitionRate < rate)
-            {
-                // Remove the node.
-                rate = posSampleHandlerNodePtr->acquisitionRate;
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+            rate = GetHandlerRate(posSampleHandlerNodePtr);
+        }
+
+        // Move to the next node.
+        linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
     }
 
-    return rate;
+    return (UINT32_MAX == rate) ? AcqRate : rate;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the GNSS device to the smallest acquisition rate needed by the registered handlers, so that
+ * it slows down (and saves power) when the fastest handler is removed.
+ *
+ * The rate can only be changed while the GNSS device is stopped, so if it's running it is stopped
+ * and started again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateGnssAcquisitionRate
+(
+    void
+)
+{
+    uint32_t rate = ComputeCommonSmallestRate();
+
+    if (rate == GnssAcqRate)
+    {
+        return;
+    }
+
+    LE_DEBUG("GNSS acquisition rate changed from %d to %d ms", GnssAcqRate, rate);
+    GnssAcqRate = rate;
+
+    if (CurrentActivationsCount > 0)
+    {
+        if (le_gnss_Stop() != LE_OK)
+        {
+            LE_WARN("Failed to stop GNSS to change its acquisition rate (%d)", rate);
+            return;
+        }
+
+        if (le_gnss_SetAcquisitionRate(rate) != LE_OK)
+        {
+            LE_WARN("Failed to set GNSS's acquisition rate (%d)", rate);
+        }
+
+        if (le_gnss_Start() != LE_OK)
+        {
+            LE_ERROR("Failed to restart GNSS");
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -631,6 +740,7 @@ static void PosSampleHandlerfunc
     le_pos_SampleHandler_t* posSampleHandlerNodePtr;
     le_dls_Link_t*          linkPtr;
     PosSampleRequest_t*     posSampleRequestPtr=NULL;
+    le_clk_Time_t           now = le_clk_GetRelativeTime();
 
     if (NULL == positionSampleRef)
     {
@@ -638,7 +748,7 @@ static void PosSampleHandlerfunc
         return;
     }
 
-    if (!NumOfHandlers)
+    if (!NumOfHandlers && !geofence_GetCount())
     {
         LE_DEBUG("No positioning Sample handler, exit Handler Function");
         // Release provided Position sample reference
@@ -677,6 +787,12 @@ static void PosSampleHandlerfunc
         LE_DEBUG("Altitude unknown [%d,%d]", altitude, vAccuracy);
     }
 
+    // Geofences are checked against every fix, whatever the rates of the movement handlers.
+    if (locationValid)
+    {
+        geofence_CheckFix(latitude, longitude, hAccuracy);
+    }
+
     // Positioning sample
     linkPtr = le_dls_Peek(&PosSampleHandlerList);
 
@@ -703,6 +819,15 @@ static void PosSampleHandlerfunc
                                                                         le_pos_SampleHandler_t,
                                                                         link);
 
+        // Skip the samples that come faster than this handler's own rate.
+        if (!IsHandlerDue(posSampleHandlerNodePtr, now))
+        {
+            // Move to the next node.
+            linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
+            continue;
+        }
+        posSampleHandlerNodePtr->lastCheckTime = now;
+
         if (LE_FAULT == ComputeMove(posSampleHandlerNodePtr, &posParam, &hflag, &vflag))
         {
             // Release provided Position sample reference
@@ -881,6 +1006,8 @@ static void AcquitisionRateUpdate
     LE_DEBUG("New acquisition rate (%d) for positioning",AcqRate);
 
     le_cfg_CancelTxn(posCfg);
+
+    UpdateGnssAcquisitionRate();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -953,6 +1080,49 @@ static void PosCtrlCloseSessionEventHandler
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribe to the GNSS position fixes, if not done yet.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the GNSS position handler couldn't be added
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartPositionHandler
+(
+    void
+)
+{
+    if (GnssHandlerRef == NULL)
+    {
+        if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
+        {
+            LE_ERROR("Failed to add PA GNSS's handler!");
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsubscribe from the GNSS position fixes once there are neither movement handlers nor fences.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopPositionHandlerIfUnused
+(
+    void
+)
+{
+    if ((GnssHandlerRef != NULL) && (NumOfHandlers == 0) && (geofence_GetCount() == 0))
+    {
+        le_gnss_RemovePositionHandler(GnssHandlerRef);
+        GnssHandlerRef = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
 * handler function to release Positioning service for le_pos APIs
@@ -994,6 +1164,9 @@ static void PosCloseSessionEventHandler
         // Get the next value in the reference mpa
         result = le_ref_NextNode(iterRef);
     }
+
+    geofence_DeleteSession(sessionRef);
+    StopPositionHandlerIfUnused();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1038,6 +1211,8 @@ COMPONENT_INIT
     NumOfHandlers = 0;
     GnssHandlerRef = NULL;
 
+    geofence_Init();
+
     // Create safe reference map for request references. The size of the map should be based on
     // the expected number of simultaneous data requests, so take a reasonable guess.
     ActivationRequestRefMap = le_ref_CreateMap("Positioning Client", POSITIONING_ACTIVATION_MAX);
@@ -1086,10 +1261,11 @@ le_posCtrl_ActivationRef_t le_posCtrl_Request
 
     if (CurrentActivationsCount == 0)
     {
+        GnssAcqRate = ComputeCommonSmallestRate();
 
-        if (le_gnss_SetAcquisitionRate(AcqRate) != LE_OK)
+        if (le_gnss_SetAcquisitionRate(GnssAcqRate) != LE_OK)
         {
-            LE_WARN("Failed to set GNSS's acquisition rate (%d)", AcqRate);
+            LE_WARN("Failed to set GNSS's acquisition rate (%d)", GnssAcqRate);
         }
 
         // Start the GNSS acquisition.
@@ -1170,7 +1346,6 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
     void*                        contextPtr           ///< [IN] The context pointer
 )
 {
-    uint32_t                 rate = 0;
     le_pos_SampleHandler_t*  posSampleHandlerNodePtr=NULL;
 
     LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
@@ -1183,39 +1358,28 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
                                                                         horizontalMagnitude,
                                                                         verticalMagnitude);
 
+    posSampleHandlerNodePtr->lastCheckTime = (le_clk_Time_t){0, 0};
     posSampleHandlerNodePtr->sessionRef = le_pos_GetClientSessionRef();
-    AcqRate = ComputeCommonSmallestRate(posSampleHandlerNodePtr->acquisitionRate);
 
-    LE_DEBUG("Computed Acquisistion rate is %d sec for an average speed of %d km/h",
-             rate,
+    LE_DEBUG("Computed Acquisistion rate is %d ms for an average speed of %d km/h",
+             GetHandlerRate(posSampleHandlerNodePtr),
              SUPPOSED_AVERAGE_SPEED);
 
-    // update configDB with the new rate.
-    {
-        // Add the default acquisition rate,.
-        le_cfg_IteratorRef_t posCfg = le_cfg_CreateWriteTxn(CFG_POSITIONING_PATH);
-        // enter default the value
-        le_cfg_SetInt(posCfg,CFG_NODE_RATE,rate);
-        le_cfg_CommitTxn(posCfg);
-    }
-
     posSampleHandlerNodePtr->horizontalMagnitude = horizontalMagnitude;
     posSampleHandlerNodePtr->verticalMagnitude = verticalMagnitude;
 
     // Start acquisition
-    if (NumOfHandlers == 0)
+    if (LE_OK != StartPositionHandler())
     {
-        if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
-        {
-            LE_ERROR("Failed to add PA GNSS's handler!");
-            le_mem_Release(posSampleHandlerNodePtr);
-            return NULL;
-        }
+        le_mem_Release(posSampleHandlerNodePtr);
+        return NULL;
     }
 
     le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
     NumOfHandlers++;
 
+    UpdateGnssAcquisitionRate();
+
     return (le_pos_MovementHandlerRef_t)posSampleHandlerNodePtr;
 }
 
@@ -1259,10 +1423,103 @@ void le_pos_RemoveMovementHandler
         } while (linkPtr != NULL);
     }
 
-    if (NumOfHandlers == 0)
+    StopPositionHandlerIfUnused();
+
+    UpdateGnssAcquisitionRate();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a circular geofence (see @ref le_pos_geofencing).
+ *
+ * @return
+ *      - Reference to the fence.
+ *      - NULL if LE_POS_MAX_FENCES fences already exist.
+ *
+ * @note The process exits if the center of the fence is not a valid position.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t le_pos_CreateFence
+(
+    int32_t  latitude,      ///< [IN] Latitude of the center [resolution 1e-6 degree].
+    int32_t  longitude,     ///< [IN] Longitude of the center [resolution 1e-6 degree].
+    uint32_t radius,        ///< [IN] Radius, in meters.
+    uint32_t dwellTime      ///< [IN] Dwell time, in milliseconds (0 for none).
+)
+{
+    if ((latitude < -90000000) || (latitude > 90000000) ||
+        (longitude < -180000000) || (longitude > 180000000))
+    {
+        LE_KILL_CLIENT("Invalid fence center (%d,%d)", latitude, longitude);
+        return NULL;
+    }
+
+    le_pos_FenceRef_t fenceRef = geofence_Create(le_pos_GetClientSessionRef(),
+                                                 latitude, longitude, radius, dwellTime);
+
+    if ((fenceRef != NULL) && (LE_OK != StartPositionHandler()))
     {
-        le_gnss_RemovePositionHandler(GnssHandlerRef);
-        GnssHandlerRef = NULL;
+        geofence_Delete(le_pos_GetClientSessionRef(), fenceRef);
+        return NULL;
+    }
+
+    return fenceRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a geofence.
+ *
+ * @note The process exits if an invalid reference is given.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_DeleteFence
+(
+    le_pos_FenceRef_t fenceRef  ///< [IN] Fence.
+)
+{
+    if (LE_OK != geofence_Delete(le_pos_GetClientSessionRef(), fenceRef))
+    {
+        LE_KILL_CLIENT("Invalid fence reference %p", fenceRef);
+        return;
+    }
+
+    StopPositionHandlerIfUnused();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler for the transitions of the geofences created by the client.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_GeofenceHandlerRef_t le_pos_AddGeofenceHandler
+(
+    le_pos_GeofenceHandlerFunc_t handlerPtr,    ///< [IN] The handler function.
+    void*                        contextPtr     ///< [IN] The context pointer.
+)
+{
+    LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
+
+    return geofence_AddHandler(le_pos_GetClientSessionRef(), handlerPtr, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a handler for geofence transitions.
+ *
+ * @note The process exits if an invalid reference is given.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_RemoveGeofenceHandler
+(
+    le_pos_GeofenceHandlerRef_t handlerRef  ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != geofence_RemoveHandler(le_pos_GetClientSessionRef(), handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid geofence handler reference %p", handlerRef);
     }
 }
 
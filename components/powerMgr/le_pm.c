@@ -35,6 +35,22 @@
 //--------------------------------------------------------------------------------------------------
 #define LEGATO_TAG_PREFIX   "legato"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the single kernel wakeup source held while any client wakeup source is taken
+ */
+//--------------------------------------------------------------------------------------------------
+#define LEGATO_KERNEL_WS_NAME   LEGATO_TAG_PREFIX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment variable holding the number of milliseconds to keep the kernel wakeup source after
+ * the last client wakeup source is released (0, the default, releases it at once), and its limit.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RELAX_DELAY_ENV_VAR     "LE_PM_RELAX_DELAY_MS"
+#define MAX_RELAX_DELAY_MS      60000
+
 ///@{
 //--------------------------------------------------------------------------------------------------
 /**
@@ -74,6 +90,10 @@ typedef struct {
     pid_t         pid;      // client pid of wakeup source owner
     void          *wsref;   // back-pointer to safe reference
     bool          isRef;     // true if reference counted, false if not
+    uint32_t      numAcquired;  // number of times taken while released
+    uint64_t      takenAtMs;    // time it was last taken
+    uint64_t      totalHeldMs;  // time held, not counting the current hold
+    uint64_t      maxHeldMs;    // longest hold
 }
 WakeupSource_t;
 #define PM_WAKEUP_SOURCE_COOKIE 0xa1f6337b
@@ -103,8 +123,142 @@ static struct {
     le_hashmap_Ref_t    locks;   // table of wakeup source records
     le_mem_PoolRef_t    cpool;   // memory pool for client records
     le_hashmap_Ref_t    clients; // table of client records
+    uint32_t            numTaken;    // number of wakeup sources taken
+    bool                isKernelWsHeld;  // true if the kernel wakeup source is held
+    le_timer_Ref_t      relaxTimer;  // releases the kernel wakeup source after a delay, or NULL
+}
+PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL, 0, false, NULL};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in milliseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeMs(void)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return (uint64_t)now.sec * 1000 + now.usec / 1000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the kernel wakeup source
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseKernelWakeupSource(void)
+{
+    // write to /sys/power/wake_unlock
+    if (0 > write(PowerManager.wu, LEGATO_KERNEL_WS_NAME, strlen(LEGATO_KERNEL_WS_NAME)))
+        LE_FATAL("Error releasing wakeup source '%s', errno = %d.",
+            LEGATO_KERNEL_WS_NAME, errno);
+
+    PowerManager.isKernelWsHeld = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Relax timer expiry handler: releases the kernel wakeup source if no wakeup source has been
+ * taken since the last one was released
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnRelaxTimerExpiry(le_timer_Ref_t timer)
+{
+    if ((0 == PowerManager.numTaken) && PowerManager.isKernelWsHeld)
+        ReleaseKernelWakeupSource();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a wakeup source as taken, taking the kernel wakeup source for the first one
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void AcquireAggregate(WakeupSource_t *ws)
+{
+    ws->numAcquired++;
+    ws->takenAtMs = GetTimeMs();
+
+    if (PowerManager.numTaken++)
+        return;
+
+    if (PowerManager.relaxTimer)
+        le_timer_Stop(PowerManager.relaxTimer);
+
+    if (PowerManager.isKernelWsHeld)
+        // Still held from the last release
+        return;
+
+    // Write to /sys/power/wake_lock
+    if (0 > write(PowerManager.wl, LEGATO_KERNEL_WS_NAME, strlen(LEGATO_KERNEL_WS_NAME)))
+        LE_FATAL("Error acquiring wakeup source '%s', errno = %d.",
+            LEGATO_KERNEL_WS_NAME, errno);
+
+    PowerManager.isKernelWsHeld = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a wakeup source as released, releasing the kernel wakeup source (maybe after a delay)
+ * for the last one
+ *
+ * @note The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseAggregate(WakeupSource_t *ws)
+{
+    uint64_t heldMs = GetTimeMs() - ws->takenAtMs;
+
+    ws->totalHeldMs += heldMs;
+    if (heldMs > ws->maxHeldMs)
+        ws->maxHeldMs = heldMs;
+
+    if (--PowerManager.numTaken)
+        return;
+
+    if (PowerManager.relaxTimer)
+        le_timer_Start(PowerManager.relaxTimer);
+    else
+        ReleaseKernelWakeupSource();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the statistics of a wakeup source
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogStats(const WakeupSource_t *ws)
+{
+    uint64_t heldMs = ws->totalHeldMs;
+
+    if (ws->taken)
+        heldMs += GetTimeMs() - ws->takenAtMs;
+
+    LE_INFO("Wakeup source '%s': %s, acquired %u times, held %" PRIu64 " ms (longest %" PRIu64
+            " ms).", ws->name, ws->taken ? "held" : "released", ws->numAcquired, heldMs,
+            ws->maxHeldMs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SIGUSR1 handler: logs the statistics of all wakeup sources
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnStatsSignal(int sigNum)
+{
+    le_hashmap_It_Ref_t iter;
+
+    LE_INFO("%u of %zu wakeup sources taken, kernel wakeup source %s.",
+            PowerManager.numTaken, le_hashmap_Size(PowerManager.locks),
+            PowerManager.isKernelWsHeld ? "held" : "released");
+
+    iter = le_hashmap_GetIterator(PowerManager.locks);
+    while (LE_OK == le_hashmap_NextNode(iter))
+        LogStats((const WakeupSource_t*)le_hashmap_GetValue(iter));
 }
-PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL};
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -216,6 +370,7 @@ static void OnClientDisconnect
         // Delete wakeup source record, free memory
         LE_INFO("Deleting wakeup source '%s' on behalf of pid %d.",
                 ws->name, ws->pid);
+        LogStats(ws);
         le_hashmap_Remove(PowerManager.locks, ws->name);
         le_ref_DeleteRef(PowerManager.refs, ws->wsref);
         le_mem_Release(ws);
@@ -283,6 +438,29 @@ COMPONENT_INIT
     if (NULL == PowerManager.clients)
         LE_FATAL("Failed to create client hashmap");
 
+    // Read the delay before releasing the kernel wakeup source, if any
+    const char *delayStr = getenv(RELAX_DELAY_ENV_VAR);
+    if (delayStr) {
+        char *endPtr;
+        unsigned long delayMs = strtoul(delayStr, &endPtr, 10);
+
+        if (*delayStr == '\0' || *endPtr != '\0' || delayMs > MAX_RELAX_DELAY_MS) {
+            LE_WARN("Ignoring invalid %s value '%s' (max %d).",
+                    RELAX_DELAY_ENV_VAR, delayStr, MAX_RELAX_DELAY_MS);
+        }
+        else if (delayMs > 0) {
+            PowerManager.relaxTimer = le_timer_Create("PM Relax Delay");
+            le_timer_SetMsInterval(PowerManager.relaxTimer, delayMs);
+            le_timer_SetHandler(PowerManager.relaxTimer, OnRelaxTimerExpiry);
+            LE_INFO("Kernel wakeup source released %lu ms after the last wakeup source.",
+                    delayMs);
+        }
+    }
+
+    // Log wakeup source statistics on SIGUSR1
+    le_sig_Block(SIGUSR1);
+    le_sig_SetEventHandler(SIGUSR1, OnStatsSignal);
+
     // Register client connect/disconnect handlers
     le_msg_AddServiceOpenHandler(le_pm_GetServiceRef(), OnClientConnect, NULL);
     le_msg_AddServiceCloseHandler(le_pm_GetServiceRef(), OnClientDisconnect, NULL);
@@ -334,6 +512,10 @@ le_pm_WakeupSourceRef_t le_pm_NewWakeupSource(uint32_t opts, const char *tag)
     ws->taken = 0;
     ws->pid = cl->pid;
     ws->isRef = (opts & LE_PM_REF_COUNT ? true : false);
+    ws->numAcquired = 0;
+    ws->takenAtMs = 0;
+    ws->totalHeldMs = 0;
+    ws->maxHeldMs = 0;
 
     ws->wsref = le_ref_CreateRef(PowerManager.refs, ws);
 
@@ -378,10 +560,7 @@ void le_pm_StayAwake(le_pm_WakeupSourceRef_t w)
         return;
     }
 
-    // Write to /sys/power/wake_lock
-    if (0 > write(PowerManager.wl, entry->name, strlen(entry->name)))
-        LE_FATAL("Error acquiring wakeup soruce '%s', errno = %d.",
-            entry->name, errno);
+    AcquireAggregate(entry);
 
     return;
 }
@@ -426,10 +605,7 @@ void le_pm_Relax(le_pm_WakeupSourceRef_t w)
         entry->taken = 0;
     }
 
-    // write to /sys/power/wake_unlock
-    if (0 > write(PowerManager.wu, entry->name, strlen(entry->name)))
-        LE_FATAL("Error releasing wakeup soruce '%s', errno = %d.",
-            entry->name, errno);
+    ReleaseAggregate(entry);
 
     return;
 }
@@ -448,24 +624,7 @@ bool pm_CheckWakeLock
     void
 )
 {
-    WakeupSource_t *wakeSrc;
-    le_hashmap_It_Ref_t iter;
-    bool wakelockHeld = false;
-
-    //Traverse all wakeup sources and check for wakelocks.
-    iter = le_hashmap_GetIterator(PowerManager.locks);
-    while (le_hashmap_NextNode(iter) == LE_OK) {
-        wakeSrc = (WakeupSource_t*)le_hashmap_GetValue(iter);
-
-        if (wakeSrc->taken) {
-            // Wakelock held
-            LE_DEBUG("Wakelock held(Pid: %d, Wake Source Name: %s)",
-                     wakeSrc->pid,
-                     wakeSrc->name);
-            wakelockHeld = true;
-            break;
-        }
-    }
+    LE_DEBUG("%u wakeup sources taken", PowerManager.numTaken);
 
-    return wakelockHeld;
+    return PowerManager.numTaken > 0;
 }
@@ -73,6 +73,16 @@ static char CurrSysPath[LIMIT_MAX_PATH_BYTES] = "";
 static bool IsCurrSysPathValid = false;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index and hash of the current system, cached by GetCurrSysHash() so that retrying to initialize
+ * the systems (e.g. while the secure storage is unavailable) doesn't ask the Update Daemon again.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CurrSysHashIndex = -1;
+static char CurrSysHash[MD5_STR_BYTES] = "";
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * List of system indices in secure storage.
@@ -163,6 +173,185 @@ Entry_t;
 static le_mem_PoolRef_t EntryPool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of items written in a batch before they are flushed to the secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BATCH_ITEMS     64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A client session object.  The client's name is resolved once per session, and the items the
+ * client writes in a batch are kept here until the batch is committed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;                 ///< Client session reference.
+    bool isNameValid;                               ///< true if the name has been resolved.
+    bool isApp;                                     ///< true if the client is an app.
+    char name[LIMIT_MAX_USER_NAME_BYTES];           ///< Client name.
+    bool isInBatch;                                 ///< true if a batch is started.
+    le_sls_List_t batchList;                        ///< Items written in the batch.
+    size_t batchCount;                              ///< Number of items in the batch.
+}
+Client_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An item written in a batch, not yet in the secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];        ///< Path of the item.
+    uint8_t data[LE_SECSTORE_MAX_ITEM_SIZE];        ///< Value of the item.
+    size_t size;                                    ///< Size of the value.
+    le_sls_Link_t link;                             ///< Link in the client's batch list.
+}
+BatchItem_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Space used by a client in the secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];        ///< Path to the client's area.
+    size_t usedSpace;                               ///< Space used, in bytes.
+}
+ClientUsage_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of an item of a client, 0 if it doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];        ///< Path of the item.
+    size_t size;                                    ///< Size of the item, in bytes.
+}
+ItemMeta_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client sessions, by session reference, and the pool of client objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ClientMap = NULL;
+static le_mem_PoolRef_t ClientPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of batch items.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BatchItemPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the space used by the clients and of the size of their items, by path, so that the
+ * client limit is checked without walking the secure storage.  It is filled on demand, updated by
+ * the client writes, and dropped whenever the secure storage is modified some other way.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t UsageIndex = NULL;
+static le_mem_PoolRef_t ClientUsagePool = NULL;
+static le_hashmap_Ref_t ItemIndex = NULL;
+static le_mem_PoolRef_t ItemMetaPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Suffix of the name under which the chunks of a write stream are stored until the stream is
+ * closed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_TMP_SUFFIX   "~stream"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A stream object.  A streamed object is stored as a directory of chunks, named after their index
+ * ("name/0", "name/1", ...), each at most LE_SECSTORE_MAX_ITEM_SIZE bytes, so that neither the
+ * client nor the daemon holds more than one chunk in memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;                 ///< Client session reference.
+    bool isWrite;                                   ///< true for a write stream.
+    bool isGlobal;                                  ///< true in the global domain.
+    bool isChunked;                                 ///< false if reading a single item.
+    char clientName[LIMIT_MAX_USER_NAME_BYTES];     ///< Client name.
+    char clientPath[SECSTOREADMIN_MAX_PATH_BYTES];  ///< Path to the client's area.
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];        ///< Path of the object.
+    char tmpName[SECSTOREADMIN_MAX_PATH_BYTES];     ///< Name of the chunks until closed.
+    char tmpPath[SECSTOREADMIN_MAX_PATH_BYTES];     ///< Path of the chunks until closed.
+    uint32_t chunkIndex;                            ///< Index of the next chunk.
+}
+Stream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe references to the streams, and the pool of stream objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t StreamMap = NULL;
+static le_mem_PoolRef_t StreamPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases an index entry.  This is a le_hashmap_ForEach() callback.
+ *
+ * @return
+ *      true to continue the iteration.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReleaseIndexEntry
+(
+    const void* keyPtr,             ///< [IN] Path of the entry.
+    const void* valuePtr,           ///< [IN] Entry.
+    void* contextPtr                ///< [IN] Not used.
+)
+{
+    le_mem_Release((void*)valuePtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops the index of the space used by the clients.  It is rebuilt on demand from the secure
+ * storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateIndex
+(
+    void
+)
+{
+    le_hashmap_ForEach(UsageIndex, ReleaseIndexEntry, NULL);
+    le_hashmap_RemoveAll(UsageIndex);
+
+    le_hashmap_ForEach(ItemIndex, ReleaseIndexEntry, NULL);
+    le_hashmap_RemoveAll(ItemIndex);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the specified system index is in the list.
@@ -310,6 +499,34 @@ static int FindAncestorSys
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the hash of the current system, asking the Update Daemon only the first time.
+ *
+ * @return
+ *      The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetCurrSysHash
+(
+    int currIndex                   ///< [IN] Index of the current system.
+)
+{
+    if (currIndex != CurrSysHashIndex)
+    {
+        le_result_t result = le_update_GetSystemHash(currIndex, CurrSysHash, sizeof(CurrSysHash));
+
+        LE_FATAL_IF(result != LE_OK,
+                    "Could not get the current system's hash.  %s.",
+                    LE_RESULT_TXT(result));
+
+        CurrSysHashIndex = currIndex;
+    }
+
+    return CurrSysHash;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the current system for secure storage.
@@ -343,12 +560,8 @@ static le_result_t SetCurrSystem
                 "Secure storage path '%s...' is too long.", secSysHashPath);
 
     // Get the current system's hash.
-    char currHash[MD5_STR_BYTES];
-    le_result_t result = le_update_GetSystemHash(currIndex, currHash, sizeof(currHash));
-
-    LE_FATAL_IF(result != LE_OK,
-                "Could not get the current system's hash.  %s.",
-                LE_RESULT_TXT(result));
+    const char* currHash = GetCurrSysHash(currIndex);
+    le_result_t result;
 
     if (IsSystemInList(currIndex, &SecStoreSystems))
     {
@@ -369,7 +582,7 @@ static le_result_t SetCurrSystem
         if (result == LE_OK)
         {
             // Compare the hashes.
-            if (strncmp(currHash, secSysHash, sizeof(currHash)) == 0)
+            if (strncmp(currHash, secSysHash, MD5_STR_BYTES) == 0)
             {
                 return LE_OK;
             }
@@ -511,16 +724,17 @@ static le_result_t InitSystems
     // Get a list of all the systems in secure storage right now.
     le_result_t result = pa_secStore_GetEntries(SYS_PATH, AddSystemToList, &SecStoreSystems);
 
-    if (result != LE_OK)
+    if (result == LE_OK)
     {
-        return result;
+        // Set the current system.
+        result = SetCurrSystem(currIndex);
     }
 
-    // Set the current system.
-    result = SetCurrSystem(currIndex);
-
     if (result != LE_OK)
     {
+        // Don't accumulate the lists over the retries.
+        ClearSystemList(&SecStoreSystems);
+        ClearSystemList(&FrameworkSystems);
         return result;
     }
 
@@ -531,6 +745,9 @@ static le_result_t InitSystems
     ClearSystemList(&SecStoreSystems);
     ClearSystemList(&FrameworkSystems);
 
+    // The clients' areas may have been copied from another system.
+    InvalidateIndex();
+
     IsCurrSysPathValid = true;
 
     return LE_OK;
@@ -590,6 +807,17 @@ static le_result_t GetClientName
     bool* isApp                     ///< [OUT] Set to true if the client is an app.
 )
 {
+    // The client doesn't change during a session.
+    Client_t* clientPtr = le_hashmap_Get(ClientMap, le_secStore_GetClientSessionRef());
+
+    if ((clientPtr != NULL) && (clientPtr->isNameValid))
+    {
+        LE_FATAL_IF(le_utf8_Copy(bufPtr, clientPtr->name, bufSize, NULL) != LE_OK,
+                    "Buffer too small to contain the client name.");
+        *isApp = clientPtr->isApp;
+        return LE_OK;
+    }
+
     // Get the client's credentials.
     pid_t pid;
     uid_t uid;
@@ -606,26 +834,36 @@ static le_result_t GetClientName
     if (result == LE_OK)
     {
         *isApp = true;
-        return LE_OK;
     }
+    else
+    {
+        LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
 
-    LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
+        // The process was not an app.  Get the linux user name for the process.
+        result = user_GetName(uid, bufPtr, bufSize);
 
-    // The process was not an app.  Get the linux user name for the process.
-    result = user_GetName(uid, bufPtr, bufSize);
+        LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the user name.");
+
+        if (result != LE_OK)
+        {
+            // Could not get the user name.
+            LE_CRIT("Could not get user name for pid %d (uid %d).", pid, uid);
+
+            return LE_FAULT;
+        }
 
-    if (result == LE_OK)
-    {
         *isApp = false;
-        return LE_OK;
     }
 
-    LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the user name.");
-
-    // Could not get the user name.
-    LE_CRIT("Could not get user name for pid %d (uid %d).", pid, uid);
+    // Remember the client name for the next requests of the session.
+    if ((clientPtr != NULL) &&
+        (le_utf8_Copy(clientPtr->name, bufPtr, sizeof(clientPtr->name), NULL) == LE_OK))
+    {
+        clientPtr->isApp = *isApp;
+        clientPtr->isNameValid = true;
+    }
 
-    return LE_FAULT;
+    return LE_OK;
 }
 
 
@@ -663,96 +901,497 @@ static void GetClientPath
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks if there is enough space in the client's area of secure storage for the client to write
- * the item.
+ * Gets the object of the current client session, creating it on the client's first request.
  *
  * @return
- *      LE_OK if the item would fit in the client's area of secure storage.
- *      LE_NO_MEMORY if there is not enough memory to store the item.
- *      LE_UNAVAILABLE if the secure storage is currently unavailable.
- *      LE_FAULT if there was an error.
+ *      Pointer to the client object.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CheckClientLimit
+static Client_t* GetClient
 (
-    const char* clientNamePtr,              ///< [IN] Name of the client.
-    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
-    const char* itemNamePtr,                ///< [IN] Name of the item.
-    size_t itemSize                         ///< [IN] Size, in bytes, of the item.
+    bool isGlobal                   ///< [IN] Is this an operation is the global domain?
 )
 {
-    // Get the secure storage limit for the client.
-    appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
-    if (!iter)
-    {
-       LE_ERROR("iter is NULL");
-       return LE_FAULT;
-    }
-    size_t secStoreLimit = appCfg_GetSecStoreLimit(iter);
-    appCfg_DeleteIter(iter);
+    le_msg_SessionRef_t sessionRef = isGlobal ? secStoreGlobal_GetClientSessionRef() :
+                                                le_secStore_GetClientSessionRef();
 
-    // Get the current amount of space used by the client.
-    size_t usedSpace = 0;
-    le_result_t result = pa_secStore_GetSize(clientPathPtr, &usedSpace);
+    Client_t* clientPtr = le_hashmap_Get(ClientMap, sessionRef);
 
-    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    if (clientPtr == NULL)
     {
-        return result;
+        clientPtr = le_mem_ForceAlloc(ClientPool);
+
+        clientPtr->sessionRef = sessionRef;
+        clientPtr->isNameValid = false;
+        clientPtr->isApp = false;
+        clientPtr->name[0] = '\0';
+        clientPtr->isInBatch = false;
+        clientPtr->batchList = LE_SLS_LIST_INIT;
+        clientPtr->batchCount = 0;
+
+        le_hashmap_Put(ClientMap, sessionRef, clientPtr);
     }
 
-    // Get the size of the item in the secure storage if it already exists.
-    char itemPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+    return clientPtr;
+}
 
-    LE_FATAL_IF(le_path_Concat("/", itemPath, sizeof(itemPath), clientPathPtr, itemNamePtr, NULL) != LE_OK,
-                "Client %s's path for item %s is too long.", clientNamePtr, itemNamePtr);
 
-    size_t origItemSize = 0;
-    result = pa_secStore_GetSize(itemPath, &origItemSize);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the index entry of the space used by a client, reading it from the secure storage if it is
+ * not in the index yet.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetClientUsage
+(
+    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
+    ClientUsage_t** usagePtrPtr             ///< [OUT] Index entry.
+)
+{
+    ClientUsage_t* usagePtr = le_hashmap_Get(UsageIndex, clientPathPtr);
 
-    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    if (usagePtr == NULL)
     {
-        return result;
-    }
+        size_t usedSpace = 0;
+        le_result_t result = pa_secStore_GetSize(clientPathPtr, &usedSpace);
 
-    // Calculate if replacing the item would fit within the limit.
-    if (((ssize_t)(secStoreLimit - usedSpace + origItemSize - itemSize)) >= 0)
-    {
-        return LE_OK;
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            return result;
+        }
+
+        usagePtr = le_mem_ForceAlloc(ClientUsagePool);
+        LE_ASSERT(le_utf8_Copy(usagePtr->path, clientPathPtr,
+                               sizeof(usagePtr->path), NULL) == LE_OK);
+        usagePtr->usedSpace = usedSpace;
+
+        le_hashmap_Put(UsageIndex, usagePtr->path, usagePtr);
     }
 
-    return LE_NO_MEMORY;
+    *usagePtrPtr = usagePtr;
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check that item names are valid.
+ * Gets the index entry of the size of a client's item, reading it from the secure storage if it is
+ * not in the index yet.
  *
  * @return
- *      true if the item name is valid.
- *      false otherwise.
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsValidName
+static le_result_t GetItemMeta
 (
-    const char* namePtr             ///< [IN] Name of the secure storage item.
+    const char* itemPathPtr,                ///< [IN] Path of the item.
+    ItemMeta_t** metaPtrPtr                 ///< [OUT] Index entry.
 )
 {
-    if (namePtr == NULL)
+    ItemMeta_t* metaPtr = le_hashmap_Get(ItemIndex, itemPathPtr);
+
+    if (metaPtr == NULL)
     {
-        return false;
+        size_t size = 0;
+        le_result_t result = pa_secStore_GetSize(itemPathPtr, &size);
+
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            return result;
+        }
+
+        metaPtr = le_mem_ForceAlloc(ItemMetaPool);
+        LE_ASSERT(le_utf8_Copy(metaPtr->path, itemPathPtr, sizeof(metaPtr->path), NULL) == LE_OK);
+        metaPtr->size = size;
+
+        le_hashmap_Put(ItemIndex, metaPtr->path, metaPtr);
     }
 
-    int nameLen = strlen(namePtr);
+    *metaPtrPtr = metaPtr;
 
-    if (nameLen == 0)
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates the index after a client's item has been written (or added to a batch).
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateIndex
+(
+    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
+    const char* itemPathPtr,                ///< [IN] Path of the item.
+    size_t itemSize                         ///< [IN] New size, in bytes, of the item.
+)
+{
+    ClientUsage_t* usagePtr = le_hashmap_Get(UsageIndex, clientPathPtr);
+    ItemMeta_t* metaPtr = le_hashmap_Get(ItemIndex, itemPathPtr);
+
+    if ( (usagePtr == NULL) || (metaPtr == NULL) )
     {
-        LE_ERROR("Name cannot be empty.");
-        return false;
+        // Not indexed: the limit was not checked with the index.
+        InvalidateIndex();
+        return;
     }
 
-    if (nameLen > LE_SECSTORE_MAX_NAME_SIZE)
-    {
+    usagePtr->usedSpace = usagePtr->usedSpace - metaPtr->size + itemSize;
+    metaPtr->size = itemSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a batch item, wiping its data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseBatchItem
+(
+    BatchItem_t* itemPtr                    ///< [IN] Batch item.
+)
+{
+    memset(itemPtr, 0, sizeof(*itemPtr));
+    le_mem_Release(itemPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds an item in a client's batch.
+ *
+ * @return
+ *      Pointer to the batch item, or NULL if the item is not in the batch.
+ */
+//--------------------------------------------------------------------------------------------------
+static BatchItem_t* FindBatchItem
+(
+    Client_t* clientPtr,                    ///< [IN] Client.
+    const char* pathPtr                     ///< [IN] Path of the item.
+)
+{
+    le_sls_Link_t* linkPtr = le_sls_Peek(&clientPtr->batchList);
+
+    while (linkPtr != NULL)
+    {
+        BatchItem_t* itemPtr = CONTAINER_OF(linkPtr, BatchItem_t, link);
+
+        if (strncmp(itemPtr->path, pathPtr, sizeof(itemPtr->path)) == 0)
+        {
+            return itemPtr;
+        }
+
+        linkPtr = le_sls_PeekNext(&clientPtr->batchList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the items of a client's batch to the secure storage, and empties the batch.  The writes
+ * stop at the first error, and the remaining items are discarded.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store an item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushBatch
+(
+    Client_t* clientPtr                     ///< [IN] Client.
+)
+{
+    le_result_t result = LE_OK;
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&clientPtr->batchList)) != NULL)
+    {
+        BatchItem_t* itemPtr = CONTAINER_OF(linkPtr, BatchItem_t, link);
+
+        if (result == LE_OK)
+        {
+            result = pa_secStore_Write(itemPtr->path, itemPtr->data, itemPtr->size);
+
+            if (result != LE_OK)
+            {
+                LE_ERROR("Could not write batch item '%s'.  %s.",
+                         itemPtr->path, LE_RESULT_TXT(result));
+            }
+        }
+
+        ReleaseBatchItem(itemPtr);
+    }
+
+    clientPtr->batchCount = 0;
+
+    if (result != LE_OK)
+    {
+        // The index counted the items that have not been written.
+        InvalidateIndex();
+    }
+
+    if (result == LE_BAD_PARAMETER)
+    {
+        return LE_FAULT;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an item to a client's batch.  An item that is already in the batch is replaced, and the
+ * batch is written to the secure storage when it is full.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the batch.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddToBatch
+(
+    Client_t* clientPtr,                    ///< [IN] Client.
+    const char* pathPtr,                    ///< [IN] Path of the item.
+    const uint8_t* bufPtr,                  ///< [IN] Data of the item.
+    size_t bufNumElements                   ///< [IN] Size of the data.
+)
+{
+    if (bufNumElements > LE_SECSTORE_MAX_ITEM_SIZE)
+    {
+        return LE_FAULT;
+    }
+
+    BatchItem_t* itemPtr = FindBatchItem(clientPtr, pathPtr);
+
+    if (itemPtr == NULL)
+    {
+        if (clientPtr->batchCount >= MAX_BATCH_ITEMS)
+        {
+            le_result_t result = FlushBatch(clientPtr);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+
+        itemPtr = le_mem_ForceAlloc(BatchItemPool);
+        LE_ASSERT(le_utf8_Copy(itemPtr->path, pathPtr, sizeof(itemPtr->path), NULL) == LE_OK);
+        itemPtr->link = LE_SLS_LINK_INIT;
+
+        le_sls_Queue(&clientPtr->batchList, &itemPtr->link);
+        clientPtr->batchCount++;
+    }
+
+    memcpy(itemPtr->data, bufPtr, bufNumElements);
+    itemPtr->size = bufNumElements;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a stream.  The chunks of a write stream that has not been closed are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteStream
+(
+    void* streamRef,                        ///< [IN] Stream reference.
+    Stream_t* streamPtr                     ///< [IN] Stream.
+)
+{
+    le_ref_DeleteRef(StreamMap, streamRef);
+
+    if (streamPtr->isWrite)
+    {
+        le_result_t result = pa_secStore_Delete(streamPtr->tmpPath);
+
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            LE_ERROR("Could not delete '%s'.  %s.", streamPtr->tmpPath, LE_RESULT_TXT(result));
+        }
+
+        InvalidateIndex();
+    }
+
+    le_mem_Release(streamPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the streams of a client session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CleanupClientStreams
+(
+    le_msg_SessionRef_t sessionRef          ///< [IN] Client session reference.
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(StreamMap);
+    le_result_t result;
+
+    while ((result = le_ref_NextNode(iterRef)) == LE_OK)
+    {
+        Stream_t* streamPtr = (Stream_t*)le_ref_GetValue(iterRef);
+
+        if (streamPtr->sessionRef == sessionRef)
+        {
+            DeleteStream((void*)le_ref_GetSafeRef(iterRef), streamPtr);
+        }
+    }
+
+    LE_FATAL_IF(result == LE_FAULT, "Error iterating over safe reference.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cleans up a client's session data when the client disconnects.  An uncommitted batch, and the
+ * objects of the write streams that have not been closed, are discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CleanupClient
+(
+    le_msg_SessionRef_t sessionRef,         ///< [IN] Client session reference.
+    void* contextPtr                        ///< [IN] Not used.
+)
+{
+    CleanupClientStreams(sessionRef);
+
+    Client_t* clientPtr = le_hashmap_Remove(ClientMap, sessionRef);
+
+    if (clientPtr == NULL)
+    {
+        return;
+    }
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&clientPtr->batchList)) != NULL)
+    {
+        ReleaseBatchItem(CONTAINER_OF(linkPtr, BatchItem_t, link));
+    }
+
+    if (clientPtr->isInBatch)
+    {
+        LE_WARN("Client disconnected without committing its batch.");
+
+        // The index counted the items that have not been written.
+        InvalidateIndex();
+    }
+
+    le_mem_Release(clientPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if there is enough space in the client's area of secure storage for the client to write
+ * the item.
+ *
+ * @return
+ *      LE_OK if the item would fit in the client's area of secure storage.
+ *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckClientLimit
+(
+    const char* clientNamePtr,              ///< [IN] Name of the client.
+    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
+    const char* itemNamePtr,                ///< [IN] Name of the item.
+    size_t itemSize                         ///< [IN] Size, in bytes, of the item.
+)
+{
+    // Get the secure storage limit for the client.
+    appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
+    if (!iter)
+    {
+       LE_ERROR("iter is NULL");
+       return LE_FAULT;
+    }
+    size_t secStoreLimit = appCfg_GetSecStoreLimit(iter);
+    appCfg_DeleteIter(iter);
+
+    // Get the current amount of space used by the client.
+    ClientUsage_t* usagePtr;
+    le_result_t result = GetClientUsage(clientPathPtr, &usagePtr);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // Get the size of the item in the secure storage if it already exists.
+    char itemPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+
+    LE_FATAL_IF(le_path_Concat("/", itemPath, sizeof(itemPath), clientPathPtr, itemNamePtr, NULL) != LE_OK,
+                "Client %s's path for item %s is too long.", clientNamePtr, itemNamePtr);
+
+    ItemMeta_t* metaPtr;
+    result = GetItemMeta(itemPath, &metaPtr);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // Calculate if replacing the item would fit within the limit.
+    if (((ssize_t)(secStoreLimit - usagePtr->usedSpace + metaPtr->size - itemSize)) >= 0)
+    {
+        return LE_OK;
+    }
+
+    return LE_NO_MEMORY;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that item names are valid.
+ *
+ * @return
+ *      true if the item name is valid.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidName
+(
+    const char* namePtr             ///< [IN] Name of the secure storage item.
+)
+{
+    if (namePtr == NULL)
+    {
+        return false;
+    }
+
+    int nameLen = strlen(namePtr);
+
+    if (nameLen == 0)
+    {
+        LE_ERROR("Name cannot be empty.");
+        return false;
+    }
+
+    if (nameLen > LE_SECSTORE_MAX_NAME_SIZE)
+    {
         LE_ERROR("Name is too long.");
         return false;
     }
@@ -763,385 +1402,1161 @@ static bool IsValidName
         return false;
     }
 
-    return true;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item to secure storage.  If the item already exists then it will be overwritten with
+ * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
+ * buffer size means emptying an existing file or creating a 0-byte file.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Write
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    const char* name,               ///< [IN] Name of the secure storage item.
+    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
+    size_t bufNumElements           ///< [IN] Size of buffer.
+)
+{
+    // Check parameters.
+    if (!IsValidName(name))
+    {
+        LE_KILL_CLIENT("Item name is invalid.");
+        return LE_FAULT;
+    }
+
+    if (bufPtr == NULL)
+    {
+        LE_KILL_CLIENT("Client buffer should not be NULL.");
+        return LE_FAULT;
+    }
+
+    // Make sure systems are initialized.
+    if (!IsCurrSysPathValid)
+    {
+        le_result_t r = InitSystems();
+
+        if (r != LE_OK)
+        {
+            return r;
+        }
+    }
+
+    Client_t* clientPtr = GetClient(isGlobal);
+    char clientPath[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+    le_result_t result;
+
+    if(isGlobal)
+    {
+        // Build global path based on prefix and item name.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
+                    "Global path for item %s is too long.", name);
+    }
+    else
+    {
+        // Get the client's name and see if it is an app.
+        bool isApp;
+        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+
+        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        {
+            LE_KILL_CLIENT("Could not get the client's name.");
+            return LE_FAULT;
+        }
+
+        // Get the path to the client's secure storage area.
+        GetClientPath(clientName, isApp, path, sizeof(path));
+        LE_ASSERT(le_utf8_Copy(clientPath, path, sizeof(clientPath), NULL) == LE_OK);
+
+        // Check the available limit for the client.
+        result = CheckClientLimit(clientName, path, name, bufNumElements);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        // Append item name to client path.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
+                    "Client %s's path for item %s is too long.", clientName, name);
+    }
+
+    if (clientPtr->isInBatch)
+    {
+        // Keep the item until the batch is committed.
+        result = AddToBatch(clientPtr, path, bufPtr, bufNumElements);
+    }
+    else
+    {
+        // Write the item to the secure storage.
+        result = pa_secStore_Write(path, bufPtr, bufNumElements);
+    }
+
+    if ( (result == LE_OK) && (!isGlobal) )
+    {
+        UpdateIndex(clientPath, path, bufNumElements);
+    }
+
+    if (result == LE_BAD_PARAMETER)
+    {
+        return LE_FAULT;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item to secure storage.  If the item already exists then it will be overwritten with
+ * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
+ * buffer size means emptying an existing file or creating a 0-byte file.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Write
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
+    size_t bufNumElements           ///< [IN] Size of buffer.
+)
+{
+    return Write(false, name, bufPtr, bufNumElements);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item to secure storage.  If the item already exists then it will be overwritten with
+ * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
+ * buffer size means emptying an existing file or creating a 0-byte file.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_Write
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
+    size_t bufNumElements           ///< [IN] Size of buffer.
+)
+{
+    return Write(true, name, bufPtr, bufNumElements);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
+ *                  the buffer in this case.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Read
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    const char* name,               ///< [IN] Name of the secure storage item.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+)
+{
+    // Check parameters.
+    if (!IsValidName(name))
+    {
+        LE_KILL_CLIENT("Item name is invalid.");
+        return LE_FAULT;
+    }
+
+    if (bufPtr == NULL)
+    {
+        LE_KILL_CLIENT("Client buffer should not be NULL.");
+        return LE_FAULT;
+    }
+
+    // Make sure systems are initialized.
+    if (!IsCurrSysPathValid)
+    {
+        le_result_t r = InitSystems();
+
+        if (r != LE_OK)
+        {
+            return r;
+        }
+    }
+
+    Client_t* clientPtr = GetClient(isGlobal);
+    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+    le_result_t result;
+
+    if(isGlobal)
+    {
+        // Build global path based on prefix and item name.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
+                    "Global path for item %s is too long.", name);
+    }
+    else
+    {
+        // Get the client's name and see if it is an app.
+        bool isApp;
+        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+
+        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        {
+            LE_KILL_CLIENT("Could not get the client's name.");
+            return LE_FAULT;
+        }
+
+        // Get the path to the client's secure storage area.
+        GetClientPath(clientName, isApp, path, sizeof(path));
+
+        // Append item name to client path.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
+                    "Client %s's path for item %s is too long.", clientName, name);
+    }
+
+    // An item written in the batch is not in the secure storage yet.
+    BatchItem_t* itemPtr = FindBatchItem(clientPtr, path);
+
+    if (itemPtr != NULL)
+    {
+        if (itemPtr->size > *bufNumElementsPtr)
+        {
+            result = LE_OVERFLOW;
+        }
+        else
+        {
+            memcpy(bufPtr, itemPtr->data, itemPtr->size);
+            *bufNumElementsPtr = itemPtr->size;
+            result = LE_OK;
+        }
+    }
+    else
+    {
+        // Read the item from the secure storage.
+        result = pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
+    }
+
+    // If there is an error, make sure that the buffer is empty.
+    if ( (LE_OK != result) && (bufNumElementsPtr > 0) )
+    {
+        bufPtr[0] = 0;
+        *bufNumElementsPtr = 0;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
+ *                  the buffer in this case.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Read
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+)
+{
+    return Read(false, name, bufPtr, bufNumElementsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
+ *                  the buffer in this case.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_Read
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+)
+{
+    return Read(true, name, bufPtr, bufNumElementsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t Delete
+(
+    bool isGlobal,      ///< [IN] Is this an operation is the global domain?
+    const char* name    ///< [IN] Name of the secure storage item.
+)
+{
+    // Check parameters.
+    if (!IsValidName(name))
+    {
+        LE_KILL_CLIENT("Item name is invalid.");
+        return LE_FAULT;
+    }
+
+    // Make sure systems are initialized.
+    if (!IsCurrSysPathValid)
+    {
+        le_result_t r = InitSystems();
+
+        if (r != LE_OK)
+        {
+            return r;
+        }
+    }
+
+    Client_t* clientPtr = GetClient(isGlobal);
+    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+
+    if(isGlobal)
+    {
+        // Build global path based on prefix and item name.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
+                    "Global path for item %s is too long.", name);
+    }
+    else
+    {
+        // Get the client's name and see if it is an app.
+        bool isApp;
+        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+
+        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        {
+            LE_KILL_CLIENT("Could not get the client's name.");
+            return LE_FAULT;
+        }
+
+        // Get the path to the client's secure storage area.
+        GetClientPath(clientName, isApp, path, sizeof(path));
+
+        // Append item name to client path.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
+                    "Client %s's path for item %s is too long.", clientName, name);
+    }
+
+    // Write the batch first, so that the deletion applies to the items written before it.
+    le_result_t result = FlushBatch(clientPtr);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // Delete the item from the secure storage.
+    InvalidateIndex();
+
+    return pa_secStore_Delete(path);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Delete
+(
+    const char* name    ///< [IN] Name of the secure storage item.
+)
+{
+    return Delete(false, name);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_Delete
+(
+    const char* name    ///< [IN] Name of the secure storage item.
+)
+{
+    return Delete(true, name);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of writes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartBatch
+(
+    bool isGlobal                   ///< [IN] Is this an operation is the global domain?
+)
+{
+    GetClient(isGlobal)->isInBatch = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of writes.  The items written until le_secStore_CommitBatch() is called are
+ * kept by the secure storage service, and written to the secure storage together.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_secStore_StartBatch
+(
+    void
+)
+{
+    StartBatch(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of writes.  The items written until secStoreGlobal_CommitBatch() is called are
+ * kept by the secure storage service, and written to the secure storage together.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreGlobal_StartBatch
+(
+    void
+)
+{
+    StartBatch(true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the items of the batch to secure storage, and ends the batch.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store an item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if no batch was started, or there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CommitBatch
+(
+    bool isGlobal                   ///< [IN] Is this an operation is the global domain?
+)
+{
+    Client_t* clientPtr = GetClient(isGlobal);
+
+    if (!clientPtr->isInBatch)
+    {
+        LE_ERROR("No batch was started.");
+        return LE_FAULT;
+    }
+
+    clientPtr->isInBatch = false;
+
+    return FlushBatch(clientPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the items of the batch to secure storage, and ends the batch.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store an item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if no batch was started, or there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_CommitBatch
+(
+    void
+)
+{
+    return CommitBatch(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the items of the batch to secure storage, and ends the batch.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store an item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if no batch was started, or there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_CommitBatch
+(
+    void
+)
+{
+    return CommitBatch(true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a stream on an object of secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenStream
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    bool isWrite,                   ///< [IN] true to open a write stream.
+    const char* name,               ///< [IN] Name of the secure storage object.
+    Stream_t** streamPtrPtr         ///< [OUT] Stream.
+)
+{
+    // Check parameters.
+    if (!IsValidName(name))
+    {
+        LE_KILL_CLIENT("Item name is invalid.");
+        return LE_FAULT;
+    }
+
+    // Make sure systems are initialized.
+    if (!IsCurrSysPathValid)
+    {
+        le_result_t r = InitSystems();
+
+        if (r != LE_OK)
+        {
+            return r;
+        }
+    }
+
+    Client_t* clientPtr = GetClient(isGlobal);
+    Stream_t* streamPtr = le_mem_ForceAlloc(StreamPool);
+
+    memset(streamPtr, 0, sizeof(*streamPtr));
+    streamPtr->sessionRef = clientPtr->sessionRef;
+    streamPtr->isWrite = isWrite;
+    streamPtr->isGlobal = isGlobal;
+    streamPtr->isChunked = true;
+
+    if(isGlobal)
+    {
+        LE_ASSERT(le_utf8_Copy(streamPtr->clientPath, GLOBAL_PATH,
+                               sizeof(streamPtr->clientPath), NULL) == LE_OK);
+    }
+    else
+    {
+        // Get the client's name and see if it is an app.
+        bool isApp;
+
+        if (GetClientName(streamPtr->clientName, sizeof(streamPtr->clientName), &isApp) != LE_OK)
+        {
+            le_mem_Release(streamPtr);
+            LE_KILL_CLIENT("Could not get the client's name.");
+            return LE_FAULT;
+        }
+
+        // Get the path to the client's secure storage area.
+        GetClientPath(streamPtr->clientName, isApp,
+                      streamPtr->clientPath, sizeof(streamPtr->clientPath));
+    }
+
+    if ( (le_path_Concat("/", streamPtr->path, sizeof(streamPtr->path),
+                         streamPtr->clientPath, name, NULL) != LE_OK) ||
+         (snprintf(streamPtr->tmpName, sizeof(streamPtr->tmpName),
+                   "%s%s", name, STREAM_TMP_SUFFIX) >= sizeof(streamPtr->tmpName)) ||
+         (le_path_Concat("/", streamPtr->tmpPath, sizeof(streamPtr->tmpPath),
+                         streamPtr->clientPath, streamPtr->tmpName, NULL) != LE_OK) )
+    {
+        LE_ERROR("Path for item %s is too long.", name);
+        le_mem_Release(streamPtr);
+        return LE_FAULT;
+    }
+
+    *streamPtrPtr = streamPtr;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the stream of a reference.  If the reference is not a stream of the client, this function
+ * kills the client.
+ *
+ * @return
+ *      Pointer to the stream, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static Stream_t* GetStreamPtr
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    void* streamRef                 ///< [IN] Stream reference.
+)
+{
+    Stream_t* streamPtr = le_ref_Lookup(StreamMap, streamRef);
+
+    if ( (streamPtr == NULL) || (streamPtr->isGlobal != isGlobal) ||
+         (streamPtr->sessionRef != GetClient(isGlobal)->sessionRef) )
+    {
+        LE_KILL_CLIENT("Stream reference, <%p> is invalid.", streamRef);
+        return NULL;
+    }
+
+    return streamPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a stream to write an object to secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenWriteStream
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    const char* name,               ///< [IN] Name of the secure storage object.
+    void** streamRefPtr             ///< [OUT] Stream reference.
+)
+{
+    Stream_t* streamPtr;
+    le_result_t result = OpenStream(isGlobal, true, name, &streamPtr);
+
+    *streamRefPtr = NULL;
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // Drop the chunks left by a stream that was not closed.
+    result = pa_secStore_Delete(streamPtr->tmpPath);
+
+    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    {
+        le_mem_Release(streamPtr);
+        return (result == LE_UNAVAILABLE) ? LE_UNAVAILABLE : LE_FAULT;
+    }
+
+    InvalidateIndex();
+
+    *streamRefPtr = le_ref_CreateRef(StreamMap, streamPtr);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a stream to write an object to secure storage.  The object replaces the item or object of
+ * that name when the stream is closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_OpenWriteStream
+(
+    const char* name,                           ///< [IN] Name of the secure storage object.
+    le_secStore_StreamRef_t* streamRefPtr       ///< [OUT] Stream reference.
+)
+{
+    return OpenWriteStream(false, name, (void**)streamRefPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a stream to write an object to secure storage.  The object replaces the item or object of
+ * that name when the stream is closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_OpenWriteStream
+(
+    const char* name,                           ///< [IN] Name of the secure storage object.
+    secStoreGlobal_StreamRef_t* streamRefPtr    ///< [OUT] Stream reference.
+)
+{
+    return OpenWriteStream(true, name, (void**)streamRefPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the next chunk of an object to a write stream.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the chunk.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteStream
+(
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    void* streamRef,                ///< [IN] Stream reference.
+    const uint8_t* bufPtr,          ///< [IN] Chunk.
+    size_t bufNumElements           ///< [IN] Size of the chunk.
+)
+{
+    Stream_t* streamPtr = GetStreamPtr(isGlobal, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    if ( (!streamPtr->isWrite) || (bufPtr == NULL) )
+    {
+        LE_KILL_CLIENT("Stream reference, <%p> is not a write stream.", streamRef);
+        return LE_FAULT;
+    }
+
+    char chunkName[SECSTOREADMIN_MAX_PATH_BYTES];
+    char chunkPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+
+    if ( (snprintf(chunkName, sizeof(chunkName), "%s/%" PRIu32,
+                   streamPtr->tmpName, streamPtr->chunkIndex) >= sizeof(chunkName)) ||
+         (le_path_Concat("/", chunkPath, sizeof(chunkPath),
+                         streamPtr->clientPath, chunkName, NULL) != LE_OK) )
+    {
+        LE_ERROR("Path for chunk of '%s' is too long.", streamPtr->path);
+        return LE_FAULT;
+    }
+
+    le_result_t result;
+
+    if (!isGlobal)
+    {
+        // Check the available limit for the client.
+        result = CheckClientLimit(streamPtr->clientName, streamPtr->clientPath,
+                                  chunkName, bufNumElements);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    result = pa_secStore_Write(chunkPath, bufPtr, bufNumElements);
+
+    if (result == LE_OK)
+    {
+        if (!isGlobal)
+        {
+            UpdateIndex(streamPtr->clientPath, chunkPath, bufNumElements);
+        }
+
+        streamPtr->chunkIndex++;
+    }
+
+    if (result == LE_BAD_PARAMETER)
+    {
+        return LE_FAULT;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the next chunk of an object to a write stream.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the chunk.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_WriteStream
+(
+    le_secStore_StreamRef_t streamRef,      ///< [IN] Stream reference.
+    const uint8_t* bufPtr,                  ///< [IN] Chunk.
+    size_t bufNumElements                   ///< [IN] Size of the chunk.
+)
+{
+    return WriteStream(false, streamRef, bufPtr, bufNumElements);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the next chunk of an object to a write stream.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NO_MEMORY if there is not enough memory to store the chunk.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_WriteStream
+(
+    secStoreGlobal_StreamRef_t streamRef,   ///< [IN] Stream reference.
+    const uint8_t* bufPtr,                  ///< [IN] Chunk.
+    size_t bufNumElements                   ///< [IN] Size of the chunk.
+)
+{
+    return WriteStream(true, streamRef, bufPtr, bufNumElements);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes an item to secure storage.  If the item already exists then it will be overwritten with
- * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
- * buffer size means emptying an existing file or creating a 0-byte file.
+ * Opens a stream to read an object from secure storage.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_NOT_FOUND if the object does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t Write
+static le_result_t OpenReadStream
 (
     bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
-    const char* name,               ///< [IN] Name of the secure storage item.
-    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
-    size_t bufNumElements           ///< [IN] Size of buffer.
+    const char* name,               ///< [IN] Name of the secure storage object.
+    void** streamRefPtr,            ///< [OUT] Stream reference.
+    uint32_t* sizePtr               ///< [OUT] Size of the object, in bytes.
 )
 {
-    // Check parameters.
-    if (!IsValidName(name))
-    {
-        LE_KILL_CLIENT("Item name is invalid.");
-        return LE_FAULT;
-    }
+    Stream_t* streamPtr;
+    le_result_t result = OpenStream(isGlobal, false, name, &streamPtr);
 
-    if (bufPtr == NULL)
-    {
-        LE_KILL_CLIENT("Client buffer should not be NULL.");
-        return LE_FAULT;
-    }
+    *streamRefPtr = NULL;
+    *sizePtr = 0;
 
-    // Make sure systems are initialized.
-    if (!IsCurrSysPathValid)
+    if (result != LE_OK)
     {
-        le_result_t r = InitSystems();
-
-        if (r != LE_OK)
-        {
-            return r;
-        }
+        return result;
     }
 
-    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
-    le_result_t result;
+    size_t size = 0;
+    result = pa_secStore_GetSize(streamPtr->path, &size);
 
-    if(isGlobal)
-    {
-        // Build global path based on prefix and item name.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
-                    "Global path for item %s is too long.", name);
-    }
-    else
+    if (result == LE_OK)
     {
-        // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
-
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
-        {
-            LE_KILL_CLIENT("Could not get the client's name.");
-            return LE_FAULT;
-        }
-
-        // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
-
-        // Check the available limit for the client.
-        result = CheckClientLimit(clientName, path, name, bufNumElements);
+        // An item written with le_secStore_Write() is read as a single chunk.
+        char chunkPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+        size_t chunkSize;
 
-        if (result != LE_OK)
-        {
-            return result;
-        }
+        LE_FATAL_IF(le_path_Concat("/", chunkPath, sizeof(chunkPath),
+                                   streamPtr->path, "0", NULL) != LE_OK,
+                    "Path for chunk of '%s' is too long.", streamPtr->path);
 
-        // Append item name to client path.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+        streamPtr->isChunked = (pa_secStore_GetSize(chunkPath, &chunkSize) == LE_OK);
     }
 
-    // Write the item to the secure storage.
-    result = pa_secStore_Write(path, bufPtr, bufNumElements);
-
-    if (result == LE_BAD_PARAMETER)
+    if (result != LE_OK)
     {
-        return LE_FAULT;
+        le_mem_Release(streamPtr);
+        return (result == LE_BAD_PARAMETER) ? LE_FAULT : result;
     }
 
-    return result;
+    *streamRefPtr = le_ref_CreateRef(StreamMap, streamPtr);
+    *sizePtr = size;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes an item to secure storage.  If the item already exists then it will be overwritten with
- * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
- * buffer size means emptying an existing file or creating a 0-byte file.
+ * Opens a stream to read an object, or an item, from secure storage.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_NOT_FOUND if the object does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_secStore_Write
+le_result_t le_secStore_OpenReadStream
 (
-    const char* name,               ///< [IN] Name of the secure storage item.
-    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
-    size_t bufNumElements           ///< [IN] Size of buffer.
+    const char* name,                           ///< [IN] Name of the secure storage object.
+    le_secStore_StreamRef_t* streamRefPtr,      ///< [OUT] Stream reference.
+    uint32_t* sizePtr                           ///< [OUT] Size of the object, in bytes.
 )
 {
-    return Write(false, name, bufPtr, bufNumElements);
+    return OpenReadStream(false, name, (void**)streamRefPtr, sizePtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes an item to secure storage.  If the item already exists then it will be overwritten with
- * the new value.  If the item does not already exist then it will be created.  Specifying 0 for
- * buffer size means emptying an existing file or creating a 0-byte file.
+ * Opens a stream to read an object, or an item, from secure storage.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_NOT_FOUND if the object does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t secStoreGlobal_Write
+le_result_t secStoreGlobal_OpenReadStream
 (
-    const char* name,               ///< [IN] Name of the secure storage item.
-    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
-    size_t bufNumElements           ///< [IN] Size of buffer.
+    const char* name,                           ///< [IN] Name of the secure storage object.
+    secStoreGlobal_StreamRef_t* streamRefPtr,   ///< [OUT] Stream reference.
+    uint32_t* sizePtr                           ///< [OUT] Size of the object, in bytes.
 )
 {
-    return Write(true, name, bufPtr, bufNumElements);
+    return OpenReadStream(true, name, (void**)streamRefPtr, sizePtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads an item from secure storage.
+ * Reads the next chunk of an object from a read stream.  At the end of the object, no data is
+ * read.
  *
  * @return
  *      LE_OK if successful.
- *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
- *                  the buffer in this case.
- *      LE_NOT_FOUND if the item does not exist.
+ *      LE_OVERFLOW if the buffer is too small to hold the chunk.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t Read
+static le_result_t ReadStream
 (
     bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
-    const char* name,               ///< [IN] Name of the secure storage item.
-    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    void* streamRef,                ///< [IN] Stream reference.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the chunk in.
     size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
 )
 {
-    // Check parameters.
-    if (!IsValidName(name))
+    Stream_t* streamPtr = GetStreamPtr(isGlobal, streamRef);
+
+    if (streamPtr == NULL)
     {
-        LE_KILL_CLIENT("Item name is invalid.");
         return LE_FAULT;
     }
 
-    if (bufPtr == NULL)
+    if ( (streamPtr->isWrite) || (bufPtr == NULL) )
     {
-        LE_KILL_CLIENT("Client buffer should not be NULL.");
+        LE_KILL_CLIENT("Stream reference, <%p> is not a read stream.", streamRef);
         return LE_FAULT;
     }
 
-    // Make sure systems are initialized.
-    if (!IsCurrSysPathValid)
+    char chunkPath[SECSTOREADMIN_MAX_PATH_BYTES];
+    le_result_t result;
+
+    if (streamPtr->isChunked)
     {
-        le_result_t r = InitSystems();
+        LE_FATAL_IF(snprintf(chunkPath, sizeof(chunkPath), "%s/%" PRIu32,
+                             streamPtr->path, streamPtr->chunkIndex) >= sizeof(chunkPath),
+                    "Path for chunk of '%s' is too long.", streamPtr->path);
 
-        if (r != LE_OK)
-        {
-            return r;
-        }
+        result = pa_secStore_Read(chunkPath, bufPtr, bufNumElementsPtr);
     }
-
-    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
-    le_result_t result;
-
-    if(isGlobal)
+    else if (streamPtr->chunkIndex == 0)
     {
-        // Build global path based on prefix and item name.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
-                    "Global path for item %s is too long.", name);
+        result = pa_secStore_Read(streamPtr->path, bufPtr, bufNumElementsPtr);
     }
     else
     {
-        // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
-
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
-        {
-            LE_KILL_CLIENT("Could not get the client's name.");
-            return LE_FAULT;
-        }
-
-        // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
-
-        // Append item name to client path.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+        result = LE_NOT_FOUND;
     }
 
-    // Read the item from the secure storage.
-    result = pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
-
-    // If there is an error, make sure that the buffer is empty.
-    if ( (LE_OK != result) && (bufNumElementsPtr > 0) )
+    if (result == LE_OK)
     {
-        bufPtr[0] = 0;
+        streamPtr->chunkIndex++;
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        // End of the object.
         *bufNumElementsPtr = 0;
+        result = LE_OK;
     }
 
-    return result;
+    return (result == LE_BAD_PARAMETER) ? LE_FAULT : result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads an item from secure storage.
+ * Reads the next chunk of an object from a read stream.  At the end of the object, no data is
+ * read.
  *
  * @return
  *      LE_OK if successful.
- *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
- *                  the buffer in this case.
- *      LE_NOT_FOUND if the item does not exist.
+ *      LE_OVERFLOW if the buffer is too small to hold the chunk.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_secStore_Read
+le_result_t le_secStore_ReadStream
 (
-    const char* name,               ///< [IN] Name of the secure storage item.
-    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
-    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+    le_secStore_StreamRef_t streamRef,      ///< [IN] Stream reference.
+    uint8_t* bufPtr,                        ///< [OUT] Buffer to store the chunk in.
+    size_t* bufNumElementsPtr               ///< [INOUT] Size of buffer.
 )
 {
-    return Read(false, name, bufPtr, bufNumElementsPtr);
+    return ReadStream(false, streamRef, bufPtr, bufNumElementsPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads an item from secure storage.
+ * Reads the next chunk of an object from a read stream.  At the end of the object, no data is
+ * read.
  *
  * @return
  *      LE_OK if successful.
- *      LE_OVERFLOW if the buffer is too small to hold the entire item.  No data will be written to
- *                  the buffer in this case.
- *      LE_NOT_FOUND if the item does not exist.
+ *      LE_OVERFLOW if the buffer is too small to hold the chunk.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t secStoreGlobal_Read
+le_result_t secStoreGlobal_ReadStream
 (
-    const char* name,               ///< [IN] Name of the secure storage item.
-    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
-    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+    secStoreGlobal_StreamRef_t streamRef,   ///< [IN] Stream reference.
+    uint8_t* bufPtr,                        ///< [OUT] Buffer to store the chunk in.
+    size_t* bufNumElementsPtr               ///< [INOUT] Size of buffer.
 )
 {
-    return Read(true, name, bufPtr, bufNumElementsPtr);
+    return ReadStream(true, streamRef, bufPtr, bufNumElementsPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an item from secure storage.
+ * Closes a stream.  The object written to a write stream replaces the item or object of that name.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NOT_FOUND if the item does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t Delete
+static le_result_t CloseStream
 (
-    bool isGlobal,      ///< [IN] Is this an operation is the global domain?
-    const char* name    ///< [IN] Name of the secure storage item.
+    bool isGlobal,                  ///< [IN] Is this an operation is the global domain?
+    void* streamRef                 ///< [IN] Stream reference.
 )
 {
-    // Check parameters.
-    if (!IsValidName(name))
+    Stream_t* streamPtr = GetStreamPtr(isGlobal, streamRef);
+
+    if (streamPtr == NULL)
     {
-        LE_KILL_CLIENT("Item name is invalid.");
         return LE_FAULT;
     }
 
-    // Make sure systems are initialized.
-    if (!IsCurrSysPathValid)
-    {
-        le_result_t r = InitSystems();
+    le_result_t result = LE_OK;
 
-        if (r != LE_OK)
+    if (streamPtr->isWrite)
+    {
+        // An empty object still has a chunk, so that it is read as an object.
+        if (streamPtr->chunkIndex == 0)
         {
-            return r;
+            result = WriteStream(isGlobal, streamRef, (const uint8_t*)"", 0);
         }
-    }
 
-    char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+        if (result == LE_OK)
+        {
+            result = pa_secStore_Delete(streamPtr->path);
 
-    if(isGlobal)
-    {
-        // Build global path based on prefix and item name.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), GLOBAL_PATH, name, NULL) != LE_OK,
-                    "Global path for item %s is too long.", name);
-    }
-    else
-    {
-        // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+            if ( (result == LE_OK) || (result == LE_NOT_FOUND) )
+            {
+                result = pa_secStore_Move(streamPtr->path, streamPtr->tmpPath);
+            }
+        }
 
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        if (result != LE_OK)
         {
-            LE_KILL_CLIENT("Could not get the client's name.");
-            return LE_FAULT;
+            LE_ERROR("Could not store '%s'.  %s.", streamPtr->path, LE_RESULT_TXT(result));
         }
+    }
 
-        // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
+    // The chunks are gone from the temporary path if they have been moved.
+    DeleteStream(streamRef, streamPtr);
 
-        // Append item name to client path.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+    if ( (result != LE_OK) && (result != LE_UNAVAILABLE) )
+    {
+        return LE_FAULT;
     }
 
-    // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an item from secure storage.
+ * Closes a stream.  The object written to a write stream replaces the item or object of that name.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NOT_FOUND if the item does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_secStore_Delete
+le_result_t le_secStore_CloseStream
 (
-    const char* name    ///< [IN] Name of the secure storage item.
+    le_secStore_StreamRef_t streamRef       ///< [IN] Stream reference.
 )
 {
-    return Delete(false, name);
+    return CloseStream(false, streamRef);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an item from secure storage.
+ * Closes a stream.  The object written to a write stream replaces the item or object of that name.
  *
  * @return
  *      LE_OK if successful.
- *      LE_NOT_FOUND if the item does not exist.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t secStoreGlobal_Delete
+le_result_t secStoreGlobal_CloseStream
 (
-    const char* name    ///< [IN] Name of the secure storage item.
+    secStoreGlobal_StreamRef_t streamRef    ///< [IN] Stream reference.
 )
 {
-    return Delete(true, name);
+    return CloseStream(true, streamRef);
 }
 
 
@@ -1539,6 +2954,8 @@ le_result_t secStoreAdmin_Write
     }
 
     // Write the item to the secure storage.
+    InvalidateIndex();
+
     return pa_secStore_Write(path, bufPtr, bufNumElements);
 }
 
@@ -1609,6 +3026,8 @@ le_result_t secStoreAdmin_CopyMetaTo
         ///< Destination path of meta file copy.
 )
 {
+    InvalidateIndex();
+
     return pa_secStore_CopyMetaTo(path);
 }
 
@@ -1643,6 +3062,8 @@ le_result_t secStoreAdmin_Delete
     }
 
     // Delete the item from the secure storage.
+    InvalidateIndex();
+
     return pa_secStore_Delete(path);
 }
 
@@ -1734,8 +3155,25 @@ COMPONENT_INIT
 
     SystemIndexPool = le_mem_CreatePool("SystemIndexPool", sizeof(SystemsIndex_t));
 
+    ClientMap = le_hashmap_Create("SecStoreClients", 31,
+                                  le_hashmap_HashVoidPointer, le_hashmap_EqualsVoidPointer);
+    ClientPool = le_mem_CreatePool("SecStoreClientPool", sizeof(Client_t));
+    BatchItemPool = le_mem_CreatePool("SecStoreBatchItemPool", sizeof(BatchItem_t));
+
+    UsageIndex = le_hashmap_Create("SecStoreUsageIndex", 31,
+                                   le_hashmap_HashString, le_hashmap_EqualsString);
+    ClientUsagePool = le_mem_CreatePool("SecStoreUsagePool", sizeof(ClientUsage_t));
+    ItemIndex = le_hashmap_Create("SecStoreItemIndex", 127,
+                                  le_hashmap_HashString, le_hashmap_EqualsString);
+    ItemMetaPool = le_mem_CreatePool("SecStoreItemMetaPool", sizeof(ItemMeta_t));
+
+    StreamMap = le_ref_CreateMap("SecStoreStreamMap", 8);
+    StreamPool = le_mem_CreatePool("SecStoreStreamPool", sizeof(Stream_t));
+
     // Register a handler that will clean up client specific data when clients disconnect.
     le_msg_AddServiceCloseHandler(secStoreAdmin_GetServiceRef(),
                                   CleanupClientIterators,
                                   NULL);
+    le_msg_AddServiceCloseHandler(le_secStore_GetServiceRef(), CleanupClient, NULL);
+    le_msg_AddServiceCloseHandler(secStoreGlobal_GetServiceRef(), CleanupClient, NULL);
 }
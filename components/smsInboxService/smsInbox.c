@@ -10,10 +10,13 @@
  * text/pdu, sender telephone number, timestamp, read/unread) are recorded with a key to retrieve
  * each value.
  *
- * Each application using the SMS Inbox Server possesses a configuration file in
- * SMSINBOX_PATH/CONF_PATH directory (also encoding using Jansson format): this file is used to
- * store the message identifier contained in the application mailbox. It is updated each time is new
- * SMS is received.
+ * Each application using the SMS Inbox Server possesses a message box log in the
+ * SMSINBOX_PATH/CONF_PATH directory: this append-only file records, with fixed size text records,
+ * the messages added to and removed from the application mailbox and their read status. The
+ * message box is kept in memory, and the log is only replayed when the message box is first used.
+ * When the log grows beyond twice the message box size, it is rewritten with the current content of
+ * the message box only. A message box stored by a previous version in a Jansson configuration file
+ * is imported into the log.
  *
  *  Copyright (C) Sierra Wireless Inc.
  */
@@ -53,6 +56,27 @@
  */
 //--------------------------------------------------------------------------------------------------
 #define FILE_EXTENSION ".json"
+#define LOG_EXTENSION ".log"
+#define TMP_EXTENSION ".tmp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box log records: operation character followed by the message identifier in hexadecimal,
+ * i.e. "%c%08x\n".
+ */
+//--------------------------------------------------------------------------------------------------
+#define MBOX_LOG_RECORD_BYTES   10
+#define MBOX_LOG_ADD            '+'
+#define MBOX_LOG_REMOVE         '-'
+#define MBOX_LOG_READ           'r'
+#define MBOX_LOG_UNREAD         'u'
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum number of records of a message box log before it is compacted.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MBOX_LOG_MIN_RECORDS    32
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -125,10 +149,8 @@ typedef uint32_t MessageId_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    json_t* jsonObjPtr;
-    json_t* jsonArrayPtr;
-    uint32_t currentMessageIndex;
-    uint32_t maxIndex;
+    bool     isBrowsing;                ///< GetFirst has been called
+    uint32_t currentSeq;                ///< Sequence number of the last returned message
 }
 BrowseCtx_t;
 
@@ -160,6 +182,21 @@ typedef struct
 EntryDesc_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * message box entry structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MessageId_t   messageId;            ///< Message identifier
+    uint32_t      seq;                  ///< Order of arrival in the message box
+    bool          isUnread;             ///< Message read status
+    le_dls_Link_t link;                 ///< Link in the message box
+}
+MboxEntry_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * message box object structure.
@@ -171,7 +208,11 @@ typedef struct
     char *    namePtr;                  ///< App name
     uint32_t inboxSize;                 ///< Max messages in the inbox
     uint32_t msgCount;                  ///< Number message
-
+    bool     isLoaded;                  ///< Message box loaded from its log
+    le_dls_List_t entryList;            ///< Messages, oldest first
+    uint32_t nextSeq;                   ///< Sequence number of the next message
+    int      logFd;                     ///< Message box log, opened for appending
+    uint32_t logRecordCount;            ///< Number of records in the log
 }
 MboxCtx_t;
 
@@ -249,6 +290,14 @@ extern const uint8_t le_smsInbox_NbMbx;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t   MboxSessionPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for the message box entries.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   MboxEntryPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for pool for the SMS RX handler.
@@ -506,159 +555,55 @@ static void GetSMSInboxConfigPath
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify Json object
+ * Get the application's message box log path length
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyJsonObj
+static uint32_t GetSMSInboxLogPathLen
 (
-    json_t* jsonObjPtr,         ///<[IN] Json object (root object)
-    json_t* jsonValPtr,         ///<[IN] Json value to be modified
-    char*   key,                ///<[IN] Key to modify
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    char* appNamePtr    ///<[IN] Application name
 )
 {
-    int res = 0;
-
-    if (jsonValPtr == NULL)
-    {
-        return LE_FAULT;
-    }
-
-    switch (modifPtr->type)
-    {
-        case DESC_STRING:
-            // check the type
-            if (json_is_string(jsonValPtr) == false)
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_string_set(jsonValPtr, modifPtr->uVal.str.strPtr);
-            }
-        break;
-        case DESC_INT:
-            // check the type
-            if (json_is_integer(jsonValPtr) == false )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_integer_set(jsonValPtr, modifPtr->uVal.val);
-            }
-        break;
-        case DESC_BOOL:
-            // check the type
-            if ( (json_is_true(jsonValPtr) != true) && (json_is_false(jsonValPtr) != true) )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if (( res == 0 ) &&
-                (AddBooleanKeyInJsonObject(jsonObjPtr, key, modifPtr->uVal.boolVal) != LE_OK))
-            {
-                res = -1;
-            }
-        break;
-        default:
-            res = -1;
-        break;
-    }
-
-    if (res < 0)
-    {
-        LE_ERROR(("Update error %d"), modifPtr->type);
-        return LE_FAULT;
-    }
-    else
-    {
-        return LE_OK;
-    }
+    return strlen(appNamePtr)+strlen(SMSINBOX_PATH)+strlen(CONF_PATH)+strlen(LOG_EXTENSION)
+           +strlen(TMP_EXTENSION)+1;
+}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the application's message box log path
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSMSInboxLogPath
+(
+    char* appNamePtr,   ///<[IN] Application name
+    bool isTemporary,   ///<[IN] Path of the log being compacted
+    char* pathPtr,      ///<[OUT] log file path
+    uint32_t pathLen    ///<[IN] path length
+)
+{
+    snprintf(pathPtr, pathLen, "%s%s%s%s%s", SMSINBOX_PATH, CONF_PATH, appNamePtr, LOG_EXTENSION,
+                                             isTemporary ? TMP_EXTENSION : "");
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify message file
+ * Check if a message file exists
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyMsgEntry
+static bool IsMsgEntryPresent
 (
-    MessageId_t messageId,      ///<[IN] Message identifier to be modified
-    char* keyPtr[],              ///<[IN] Key to modify
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    MessageId_t messageId   ///<[IN] Message identifier
 )
 {
     uint16_t pathLen = GetSMSInboxMessagePathLen();
     char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res;
-    int indexKey = -1;
+    struct stat st;
 
     GetSMSInboxMessagePath(messageId, path, pathLen);
 
-    json_t* jsonRootPtr = json_load_file(path, 0, &error);
-
-    if ( jsonRootPtr == NULL )
-    {
-        LE_ERROR("json decoder error %s", error.text);
-        return LE_FAULT;
-    }
-
-    json_t* jsonValPtr = jsonRootPtr;
-    json_t* jsonSubObjPtr = jsonRootPtr;
-
-    while ( ( json_is_object(jsonValPtr) == true ) && ( nbKey > indexKey ) )
-    {
-        indexKey++;
-        jsonSubObjPtr = jsonValPtr;
-        jsonValPtr = json_object_get(jsonSubObjPtr, keyPtr[indexKey]);
-    }
-
-    if ( !jsonValPtr )
-    {
-        if ((indexKey > -1) && (indexKey < nbKey))
-        {
-            LE_ERROR("Unable to get the object %s", keyPtr[indexKey]);
-        }
-        else
-        {
-            LE_ERROR("indexKey: %d is out of range", indexKey);
-        }
-
-        res = LE_FAULT;
-    }
-    else
-    {
-        res = ModifyJsonObj(jsonSubObjPtr, jsonValPtr, keyPtr[indexKey], modifPtr);
-    }
-
-    if ( res == LE_OK )
-    {
-        if (json_dump_file(jsonRootPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0)
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
-    {
-        LE_ERROR("Something was wrong in ModifyJsonObj");
-    }
-
-    json_decref(jsonRootPtr);
-
-    return res;
+    return (0 == stat(path, &st));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -825,117 +770,492 @@ static le_result_t GetMsgListFromMbox
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove a message from the application's cfg file
+ * Insert a message at the end of the in-memory message box (the log is not updated)
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t DeleteMsgInAppCfg
+static void InsertMboxEntry
 (
-    char *appNamePtr,               ///<[IN] application name
-    MessageId_t deleteMessageId     ///<[IN] message to delete
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    MessageId_t messageId,      ///<[IN] message to insert
+    bool isUnread               ///<[IN] message read status
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
+    MboxEntry_t* entryPtr = le_mem_ForceAlloc(MboxEntryPool);
+
+    entryPtr->messageId = messageId;
+    entryPtr->seq = appsPtr->nextSeq++;
+    entryPtr->isUnread = isUnread;
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&appsPtr->entryList, &entryPtr->link);
+    appsPtr->msgCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from the in-memory message box (the log is not updated)
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveMboxEntry
+(
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    MboxEntry_t* entryPtr       ///<[IN] message to remove
+)
+{
+    le_dls_Remove(&appsPtr->entryList, &entryPtr->link);
+    appsPtr->msgCount--;
+    le_mem_Release(entryPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for a message in the in-memory message box
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static MboxEntry_t* LookupMboxEntry
+(
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    MessageId_t messageId       ///<[IN] message to look for
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&appsPtr->entryList);
+
+    while (linkPtr)
+    {
+        MboxEntry_t* entryPtr = CONTAINER_OF(linkPtr, MboxEntry_t, link);
+
+        if (entryPtr->messageId == messageId)
+        {
+            return entryPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&appsPtr->entryList, linkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the application's message box log for appending
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenMboxLog
+(
+    MboxCtx_t* appsPtr          ///<[IN] application message box
+)
+{
+    uint32_t pathLen = GetSMSInboxLogPathLen(appsPtr->namePtr);
     char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
-    json_t *jsonObjPtr;
-    json_t *jsonArrayPtr;
+    GetSMSInboxLogPath(appsPtr->namePtr, false, path, pathLen);
+
+    appsPtr->logFd = open(path, O_WRONLY | O_APPEND | O_CREAT, S_IRUSR | S_IWUSR);
+
+    if (appsPtr->logFd < 0)
+    {
+        LE_ERROR("Unable to open %s: %m", path);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rewrite the application's message box log with the current content of the message box only.
+ *
+ * The log is written to a temporary file which replaces the previous log once synced, so a reset
+ * during the compaction leaves either the old or the new log.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompactMboxLog
+(
+    MboxCtx_t* appsPtr          ///<[IN] application message box
+)
+{
+    uint32_t pathLen = GetSMSInboxLogPathLen(appsPtr->namePtr);
+    char path[pathLen];
+    char tmpPath[pathLen];
+    GetSMSInboxLogPath(appsPtr->namePtr, false, path, pathLen);
+    GetSMSInboxLogPath(appsPtr->namePtr, true, tmpPath, pathLen);
+    uint32_t recordCount = 0;
+    int res = 0;
+
+    FILE* filePtr = fopen(tmpPath, "w");
 
-    if (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK)
+    if (NULL == filePtr)
     {
+        LE_ERROR("Unable to create %s: %m", tmpPath);
         return LE_FAULT;
     }
 
-    int i;
-    MessageId_t messageId;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&appsPtr->entryList);
 
-    for (i=0; i < json_array_size(jsonArrayPtr); i++)
+    while ((linkPtr) && (res >= 0))
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
+        MboxEntry_t* entryPtr = CONTAINER_OF(linkPtr, MboxEntry_t, link);
 
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
+        res = fprintf(filePtr, "%c%08x\n", MBOX_LOG_ADD, (unsigned int) entryPtr->messageId);
+        recordCount++;
 
-            if (messageId == deleteMessageId)
-            {
-                LE_DEBUG("Remove %d", (int) messageId);
-                json_array_remove(jsonArrayPtr, i);
-            }
-        }
-        else
+        if ((res >= 0) && (!entryPtr->isUnread))
         {
-            LE_ERROR("Json error");
+            res = fprintf(filePtr, "%c%08x\n", MBOX_LOG_READ,
+                          (unsigned int) entryPtr->messageId);
+            recordCount++;
         }
+
+        linkPtr = le_dls_PeekNext(&appsPtr->entryList, linkPtr);
     }
 
-    le_result_t res = LE_OK;
-    if ( json_dump_file(jsonObjPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
+    if ((res < 0) || (fflush(filePtr) != 0) || (fsync(fileno(filePtr)) < 0))
     {
-        res = LE_FAULT;
+        LE_ERROR("Unable to write %s: %m", tmpPath);
+        fclose(filePtr);
+        unlink(tmpPath);
+        return LE_FAULT;
     }
 
-    json_decref(jsonObjPtr);
+    fclose(filePtr);
 
-    return res;
+    if (rename(tmpPath, path) < 0)
+    {
+        LE_ERROR("Unable to rename %s: %m", tmpPath);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    if (appsPtr->logFd >= 0)
+    {
+        close(appsPtr->logFd);
+    }
+
+    OpenMboxLog(appsPtr);
+    appsPtr->logRecordCount = recordCount;
+
+    LE_DEBUG("%s log compacted to %d records", appsPtr->namePtr, (int) recordCount);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if a message belongs to a message box
+ * Append a record to the application's message box log.
+ *
+ * The in-memory message box must already be updated, as it is used when the log is compacted.
  *
  */
 //--------------------------------------------------------------------------------------------------
+static le_result_t AppendMboxRecord
+(
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    char operation,             ///<[IN] MBOX_LOG_ADD, MBOX_LOG_REMOVE, MBOX_LOG_READ, ...
+    MessageId_t messageId       ///<[IN] message identifier
+)
+{
+    char record[MBOX_LOG_RECORD_BYTES + 1];
+    ssize_t count;
 
-le_result_t CheckMessageIdInMbox
+    if (appsPtr->logFd < 0)
+    {
+        LE_ERROR("No log for %s", appsPtr->namePtr);
+        return LE_FAULT;
+    }
+
+    snprintf(record, sizeof(record), "%c%08x\n", operation, (unsigned int) messageId);
+
+    do
+    {
+        count = write(appsPtr->logFd, record, MBOX_LOG_RECORD_BYTES);
+    }
+    while ((count < 0) && (EINTR == errno));
+
+    if (count != MBOX_LOG_RECORD_BYTES)
+    {
+        LE_ERROR("Unable to write the %s log: %m", appsPtr->namePtr);
+        // Rewrite the log so that it doesn't end with a partial record
+        return CompactMboxLog(appsPtr);
+    }
+
+    appsPtr->logRecordCount++;
+
+    if (appsPtr->logRecordCount >= (2 * appsPtr->inboxSize) + MBOX_LOG_MIN_RECORDS)
+    {
+        return CompactMboxLog(appsPtr);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the application's message box log into the in-memory message box
+ *
+ * @return
+ *      - true if the log has to be compacted (invalid records found)
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReplayMboxLog
 (
-    char* mboxName,
-    MessageId_t messageId
+    MboxCtx_t* appsPtr          ///<[IN] application message box
 )
 {
-    json_t *jsonRootObjPtr;
-    json_t *jsonArrayPtr;
-    uint32_t pathLen = GetSMSInboxConfigPathLen(mboxName);
+    uint32_t pathLen = GetSMSInboxLogPathLen(appsPtr->namePtr);
     char path[pathLen];
-    GetSMSInboxConfigPath(mboxName, path, pathLen);
+    GetSMSInboxLogPath(appsPtr->namePtr, false, path, pathLen);
+    char record[MBOX_LOG_RECORD_BYTES + 1];
+    bool isCorrupted = false;
+
+    FILE* filePtr = fopen(path, "r");
 
-    if ( GetMsgListFromMbox(path, &jsonRootObjPtr, &jsonArrayPtr) != LE_OK )
+    if (NULL == filePtr)
     {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return LE_FAULT;
+        // No log yet
+        return false;
+    }
+
+    while (fgets(record, sizeof(record), filePtr))
+    {
+        char* endPtr;
+        MessageId_t messageId = strtoul(&record[1], &endPtr, 16);
+
+        appsPtr->logRecordCount++;
+
+        if ((strlen(record) != MBOX_LOG_RECORD_BYTES) || (endPtr != &record[9]) ||
+            (*endPtr != '\n'))
+        {
+            LE_WARN("Invalid record in %s", path);
+            isCorrupted = true;
+            continue;
+        }
+
+        MboxEntry_t* entryPtr = LookupMboxEntry(appsPtr, messageId);
+
+        switch (record[0])
+        {
+            case MBOX_LOG_ADD:
+                if (NULL == entryPtr)
+                {
+                    InsertMboxEntry(appsPtr, messageId, true);
+                }
+            break;
+            case MBOX_LOG_REMOVE:
+                if (entryPtr)
+                {
+                    RemoveMboxEntry(appsPtr, entryPtr);
+                }
+            break;
+            case MBOX_LOG_READ:
+            case MBOX_LOG_UNREAD:
+                if (entryPtr)
+                {
+                    entryPtr->isUnread = (MBOX_LOG_UNREAD == record[0]);
+                }
+            break;
+            default:
+                LE_WARN("Invalid record in %s", path);
+                isCorrupted = true;
+            break;
+        }
+    }
+
+    fclose(filePtr);
+
+    return isCorrupted;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import a message box stored by a previous version (whole JSON configuration file)
+ *
+ * @return
+ *      - true if a previous message box has been imported
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ImportMboxFromAppCfg
+(
+    MboxCtx_t* appsPtr          ///<[IN] application message box
+)
+{
+    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
+    char path[pathLen];
+    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
+    json_t *jsonObjPtr;
+    json_t *jsonArrayPtr;
+    int i;
+
+    if ((access(path, F_OK) != 0) ||
+        (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK))
+    {
+        return false;
     }
 
-    int i = 0;
+    LE_INFO("Import %s", path);
 
-    while (i < json_array_size(jsonArrayPtr))
+    for (i=0; i < json_array_size(jsonArrayPtr); i++)
     {
         json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-        MessageId_t msgId = 0;
+        MessageId_t messageId = json_integer_value(jsonIntegerPtr);
 
-        if (jsonIntegerPtr)
+        if ((0 == messageId) || (!IsMsgEntryPresent(messageId)) ||
+            (LookupMboxEntry(appsPtr, messageId)))
         {
-            msgId = json_integer_value(jsonIntegerPtr);
+            continue;
         }
-        else
+
+        // The read status used to be stored in the message file
+        EntryDesc_t decode;
+        decode.type = DESC_BOOL;
+        char* key[2] = {JSON_ISUNREAD, appsPtr->namePtr};
+        bool isUnread = true;
+        json_error_t error;
+        uint16_t msgPathLen = GetSMSInboxMessagePathLen();
+        char msgPath[msgPathLen];
+        GetSMSInboxMessagePath(messageId, msgPath, msgPathLen);
+
+        json_t* jsonMsgPtr = json_load_file(msgPath, JSON_REJECT_DUPLICATES, &error);
+        if (jsonMsgPtr)
         {
-            LE_ERROR("json error");
-            json_decref(jsonRootObjPtr);
-            return LE_FAULT;
+            if (ReadJsonObj(jsonMsgPtr, key, 2, &decode) == LE_OK)
+            {
+                isUnread = decode.uVal.boolVal;
+            }
+            json_decref(jsonMsgPtr);
         }
 
-        if (msgId == messageId)
+        InsertMboxEntry(appsPtr, messageId, isUnread);
+    }
+
+    json_decref(jsonObjPtr);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the application's message box in memory, if not done yet
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadMbox
+(
+    MboxCtx_t* appsPtr          ///<[IN] application message box
+)
+{
+    bool isImported;
+    bool needsCompaction;
+
+    if (appsPtr->isLoaded)
+    {
+        return;
+    }
+
+    appsPtr->isLoaded = true;
+    appsPtr->entryList = LE_DLS_LIST_INIT;
+    appsPtr->nextSeq = 1;
+    appsPtr->msgCount = 0;
+    appsPtr->logFd = -1;
+    appsPtr->logRecordCount = 0;
+
+    // A message box stored by a previous version takes precedence over the log
+    isImported = ImportMboxFromAppCfg(appsPtr);
+    needsCompaction = isImported ? true : ReplayMboxLog(appsPtr);
+
+    // Drop the messages which have been deleted behind our back
+    le_dls_Link_t* linkPtr = le_dls_Peek(&appsPtr->entryList);
+    while (linkPtr)
+    {
+        MboxEntry_t* entryPtr = CONTAINER_OF(linkPtr, MboxEntry_t, link);
+        linkPtr = le_dls_PeekNext(&appsPtr->entryList, linkPtr);
+
+        if (!IsMsgEntryPresent(entryPtr->messageId))
         {
-            json_decref(jsonRootObjPtr);
-            return LE_OK;
+            RemoveMboxEntry(appsPtr, entryPtr);
+            needsCompaction = true;
         }
+    }
 
-        i++;
+    OpenMboxLog(appsPtr);
+
+    if ((needsCompaction) && (CompactMboxLog(appsPtr) == LE_OK) && (isImported))
+    {
+        uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
+        char path[pathLen];
+        GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
+        unlink(path);
     }
 
-    LE_ERROR("Bad msg id or mbox name");
-    json_decref(jsonRootObjPtr);
-    return LE_FAULT;
+    LE_DEBUG("%s: %d messages", appsPtr->namePtr, (int) appsPtr->msgCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static MboxEntry_t* CheckMessageIdInMbox
+(
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    MessageId_t messageId       ///<[IN] message identifier
+)
+{
+    LoadMbox(appsPtr);
+
+    return LookupMboxEntry(appsPtr, messageId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from the application's message box
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DeleteMsgInMbox
+(
+    MboxCtx_t* appsPtr,             ///<[IN] application message box
+    MessageId_t deleteMessageId     ///<[IN] message to delete
+)
+{
+    MboxEntry_t* entryPtr = CheckMessageIdInMbox(appsPtr, deleteMessageId);
+
+    if (NULL == entryPtr)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    LE_DEBUG("Remove %d", (int) deleteMessageId);
+    RemoveMboxEntry(appsPtr, entryPtr);
+
+    return AppendMboxRecord(appsPtr, MBOX_LOG_REMOVE, deleteMessageId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the read status of a message in the application's message box
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetMsgUnreadInMbox
+(
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
+    MboxEntry_t* entryPtr,      ///<[IN] message entry
+    bool isUnread               ///<[IN] new read status
+)
+{
+    if (entryPtr->isUnread == isUnread)
+    {
+        return LE_OK;
+    }
+
+    entryPtr->isUnread = isUnread;
+
+    return AppendMboxRecord(appsPtr, isUnread ? MBOX_LOG_UNREAD : MBOX_LOG_READ,
+                            entryPtr->messageId);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -946,7 +1266,7 @@ le_result_t CheckMessageIdInMbox
 //--------------------------------------------------------------------------------------------------
 static le_result_t DecodeMsgEntry
 (
-    char* mboxName,                      ///<[IN] mbox name
+    MboxCtx_t* appsPtr,                  ///<[IN] application message box
     MessageId_t messageId,               ///<[IN] Message identifier to decode
     char* keyPtr[],                      ///<[IN] Key to retrieve
     uint8_t nbKey,                       ///<[IN] Number of elements in keyPtr
@@ -966,7 +1286,7 @@ static le_result_t DecodeMsgEntry
     if ( jsonRootPtr == NULL )
     {
         LE_ERROR("json decoder error %s", error.text);
-        DeleteMsgInAppCfg(mboxName, messageId);
+        DeleteMsgInMbox(appsPtr, messageId);
         return LE_FAULT;
     }
 
@@ -977,37 +1297,9 @@ static le_result_t DecodeMsgEntry
     return res;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if an application requested the deletion of a message
- *
- */
-//--------------------------------------------------------------------------------------------------
-static bool IsDeleted
-(
-    MessageId_t messageId,  ///<[IN] Message identifier
-    char* appNamePtr        ///<[IN] Application name
-)
-{
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[2] = {JSON_ISDELETED, appNamePtr};
-
-    if (DecodeMsgEntry(appNamePtr, messageId, key, 2, &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        // if error, delete the message
-        return true;
-    }
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Perform the deleteion
+ * Perform the deletion
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -1017,111 +1309,57 @@ static void PerformDeletion
 )
 {
     int i;
-    bool deleted = true;
 
     for (i=0; i < MAX_APPS; i++)
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
+        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) &&
+             (CheckMessageIdInMbox(&Apps[i], messageId)) )
         {
-            deleted &= IsDeleted(messageId, Apps[i].namePtr);
+            return;
         }
     }
 
-    // All applications mark this message to be delteted => erase physically the message
-    if (deleted)
-    {
-        uint16_t pathLen = GetSMSInboxMessagePathLen();
-        char path[pathLen];
-        memset(path,0,pathLen);
+    // No message box contains this message anymore => erase physically the message
+    uint16_t pathLen = GetSMSInboxMessagePathLen();
+    char path[pathLen];
+    memset(path,0,pathLen);
 
-        GetSMSInboxMessagePath(messageId, path, pathLen);
+    GetSMSInboxMessagePath(messageId, path, pathLen);
 
-        unlink(path);
-    }
+    unlink(path);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a message in the application's cfg file
+ * Add a message in the application's message box
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddMsgInAppCfg
+static le_result_t AddMsgInMbox
 (
-    MboxCtx_t* appsPtr,         ///<[IN] application config
+    MboxCtx_t* appsPtr,         ///<[IN] application message box
     MessageId_t messageId     ///<[IN] message to add
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
-    char path[pathLen];
-    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
-    json_t* jsonMsgIdPtr = NULL;
-    json_t* jsonPtr;
-    json_t* jsonArrayPtr;
-
-    if ( GetMsgListFromMbox (path, &jsonPtr, &jsonArrayPtr) != LE_OK )
-    {
-        return LE_FAULT;
-    }
+    LoadMbox(appsPtr);
 
-    if ( json_array_size(jsonArrayPtr) == appsPtr->inboxSize )
+    // The message box is full: delete the older entries
+    while ((appsPtr->msgCount > 0) && (appsPtr->msgCount >= appsPtr->inboxSize))
     {
-        // delete older entry
-        jsonMsgIdPtr = json_array_get(jsonArrayPtr, 0);
-        MessageId_t messageId = 0;
+        MboxEntry_t* entryPtr = CONTAINER_OF(le_dls_Peek(&appsPtr->entryList), MboxEntry_t, link);
+        MessageId_t olderMessageId = entryPtr->messageId;
 
-        if (jsonMsgIdPtr)
+        if (DeleteMsgInMbox(appsPtr, olderMessageId) != LE_OK)
         {
-            messageId = json_integer_value(jsonMsgIdPtr);
+            LE_ERROR("Can't remove entry %08x", (int) olderMessageId);
         }
 
-        if (messageId != 0)
-        {
-            json_array_remove(jsonArrayPtr, 0);
-
-            EntryDesc_t modif;
-            modif.type = DESC_BOOL;
-            modif.uVal.boolVal = true;
-            char* key[2]={JSON_ISDELETED, appsPtr->namePtr};
-
-            if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-            {
-                LE_ERROR("Can't modify entry %08x", (int) messageId);
-            }
-
-            PerformDeletion(messageId);
-        }
-        else
-        {
-            json_decref(jsonPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
+        PerformDeletion(olderMessageId);
     }
 
-    if (AddIntegerKeyInJsonObject(jsonArrayPtr, NULL, messageId) != LE_OK)
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
+    InsertMboxEntry(appsPtr, messageId, true);
 
-    if ( json_dump_file(jsonPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    json_decref(jsonPtr);
-
-    // Use for the first initialization
-    if (jsonArrayPtr->refcount > 0)
-    {
-        json_decref(jsonArrayPtr);
-    }
-
-    return LE_OK;
+    return AppendMboxRecord(appsPtr, MBOX_LOG_ADD, messageId);
 }
 
 
@@ -1354,7 +1592,7 @@ static le_result_t CreateMsgEntry
     {
         if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
         {
-            AddMsgInAppCfg(&Apps[i], NextMessageId);
+            AddMsgInMbox(&Apps[i], NextMessageId);
         }
     }
 
@@ -1703,6 +1941,9 @@ COMPONENT_INIT
     MboxSessionPool = le_mem_CreatePool("MboxSessionPool", sizeof(MboxSession_t));
     le_mem_ExpandPool(MboxSessionPool, MAX_APPS);
 
+    // Create a pool for the message box entries
+    MboxEntryPool = le_mem_CreatePool("MboxEntryPool", sizeof(MboxEntry_t));
+
     // Create a pool for the SMS RX handler
     RxMsgReportPool = le_mem_CreatePool("RxMsgReportPool", sizeof(RxMsgReport_t));
     le_mem_ExpandPool(RxMsgReportPool, MAX_APPS);
@@ -1717,6 +1958,7 @@ COMPONENT_INIT
 
     // Retrieve the smsInbox settings from the configuration tree
     LoadInboxSettings();
+    le_mem_ExpandPool(MboxEntryPool, MaxInboxSize * le_smsInbox_NbMbx);
 
     // Initialization of the smsInbox directory
     InitSmsInBoxDirectory();
@@ -1937,27 +2179,17 @@ void SmsInbox_DeleteMsg
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("message not included into the mbox");
-        return;
-    }
-
     MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISDELETED, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
+    le_result_t res = DeleteMsgInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId);
 
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (LE_NOT_FOUND == res)
     {
-        LE_ERROR("ModifyMsgEntry error");
+        LE_ERROR("message not included into the mbox");
+        return;
     }
-
-    if (DeleteMsgInAppCfg(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId)
-                          != LE_OK)
+    else if (LE_OK != res)
     {
-        LE_ERROR("DeleteMsgInAppCfg error");
+        LE_ERROR("DeleteMsgInMbox error");
     }
 
     PerformDeletion(messageId);
@@ -2008,7 +2240,7 @@ le_result_t SmsInbox_GetImsi
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2030,7 +2262,7 @@ le_result_t SmsInbox_GetImsi
     decode.uVal.str.lenStr = imsiNumElements;
     char* key[1] = {JSON_IMSI};
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
+    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr,
                               messageId, key, 1, &decode)) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
@@ -2075,7 +2307,7 @@ le_sms_Format_t SmsInbox_GetFormat
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return 0;
@@ -2086,7 +2318,7 @@ le_sms_Format_t SmsInbox_GetFormat
     decode.type = DESC_INT;
     char* key[1] = {JSON_FORMAT};
 
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
+    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId, key, 1,
                       &decode) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
@@ -2140,7 +2372,7 @@ le_result_t SmsInbox_GetSenderTel
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2155,7 +2387,7 @@ le_result_t SmsInbox_GetSenderTel
     memset(telPtr,0,telNumElements);
     char* key[1] = {JSON_SENDERTEL};
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key,
+    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId, key,
                               1, &decode)) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
@@ -2210,7 +2442,7 @@ le_result_t SmsInbox_GetTimeStamp
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2225,7 +2457,7 @@ le_result_t SmsInbox_GetTimeStamp
     char* key[1] = {JSON_TIMESTAMP};
     le_result_t res;
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
+    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId,
                                key, 1, &decode)) == LE_OK )
     {
         SmsInbox_MarkRead(sessionRef, msgId);
@@ -2267,7 +2499,7 @@ size_t SmsInbox_GetMsgLen
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2280,7 +2512,7 @@ size_t SmsInbox_GetMsgLen
     char* key[1] = {JSON_MSGLEN};
     le_result_t res;
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
+    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr,
                                 messageId,
                                 key,
                                 1,
@@ -2339,7 +2571,7 @@ le_result_t SmsInbox_GetText
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2358,7 +2590,7 @@ le_result_t SmsInbox_GetText
     decode.uVal.str.lenStr = len;
     char* key[1] = {JSON_TEXT};
 
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
+    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId, key, 1,
                          &decode);
 
     if ( res == LE_OK )
@@ -2420,7 +2652,7 @@ le_result_t SmsInbox_GetBinary
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
@@ -2439,7 +2671,7 @@ le_result_t SmsInbox_GetBinary
     decode.uVal.str.lenStr = len;
     char* key[1] = {JSON_BIN};
 
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
+    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId,
                          key, 1, &decode);
 
     if ( res == LE_OK )
@@ -2509,7 +2741,7 @@ le_result_t SmsInbox_GetPdu
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (NULL == CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId))
     {
         LE_ERROR("message not included into the mbox");
         return 0;
@@ -2528,7 +2760,7 @@ le_result_t SmsInbox_GetPdu
     decode.uVal.str.lenStr = len;
     char* key[1] = {JSON_PDU};
 
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
+    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, messageId, key, 1,
                          &decode);
 
     if ( res == LE_OK )
@@ -2583,75 +2815,28 @@ uint32_t SmsInbox_GetFirst
         return 0;
     }
 
-    uint32_t pathLen = GetSMSInboxConfigPathLen(clientRequestPtr->
-                                                mboxSessionPtr->mboxCtxPtr->namePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, path, pathLen);
-    le_result_t res = LE_OK;
-    MessageId_t messageId=0;
-
-    if ( GetMsgListFromMbox(path,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("error in GetMsgListFromMbox");
-        return 0;
-    }
-
-    clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex =
-                      json_array_size(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr);
-
-    LE_DEBUG("maxIndex %d", clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex);
+    MboxCtx_t* appsPtr = clientRequestPtr->mboxSessionPtr->mboxCtxPtr;
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
 
-    if ( clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex > 0 )
-    {
-        json_t * jsonIntegerPtr =
-                 json_array_get(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr, 0);
+    LoadMbox(appsPtr);
 
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
+    le_dls_Link_t* linkPtr = le_dls_Peek(&appsPtr->entryList);
 
-        if (messageId)
-        {
-            clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex = 1;
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (NULL == linkPtr)
     {
-        res = LE_FAULT;
         LE_DEBUG("Empty mbox");
+        memset(browseCtxPtr, 0, sizeof(BrowseCtx_t));
+        return 0;
     }
 
-    if (res == LE_FAULT)
-    {
-        if (clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr)
-        {
-            json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-        }
+    MboxEntry_t* entryPtr = CONTAINER_OF(linkPtr, MboxEntry_t, link);
 
-        memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
+    browseCtxPtr->isBrowsing = true;
+    browseCtxPtr->currentSeq = entryPtr->seq;
 
-        return 0;
-    }
-    else
-    {
-        return messageId;
-    }
+    LE_DEBUG("msgCount %d", (int) appsPtr->msgCount);
 
-    return 0;
+    return entryPtr->messageId;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2679,58 +2864,38 @@ uint32_t SmsInbox_GetNext
         return LE_BAD_PARAMETER;
     }
 
-    while(clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex !=
-          clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex)
+    if (clientRequestPtr->mboxSessionPtr == NULL)
     {
-        LE_DEBUG("currentIndex %d, maxIndex %d", clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.maxIndex);
-
-        json_t * jsonIntegerPtr = json_array_get(clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.jsonArrayPtr,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex);
-
-        if (jsonIntegerPtr)
-        {
-            MessageId_t messageId = json_integer_value(jsonIntegerPtr);
+        LE_ERROR("Bad mbox reference");
+        return 0;
+    }
 
-            if (messageId > 0)
-            {
-                clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex++;
+    MboxCtx_t* appsPtr = clientRequestPtr->mboxSessionPtr->mboxCtxPtr;
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
 
-                // Check if the message exist (it may be deleted since the GetFirst call)
-                uint16_t pathLen = GetSMSInboxMessagePathLen();
-                char path[pathLen];
-                memset(path, 0, pathLen);
-                GetSMSInboxMessagePath(messageId, path, pathLen);
-                int32_t fd = open(path, O_RDWR);
+    if (browseCtxPtr->isBrowsing)
+    {
+        // The last returned message may have been deleted since: look for the first message
+        // which arrived after it
+        le_dls_Link_t* linkPtr = le_dls_Peek(&appsPtr->entryList);
 
-                if (fd >= 0)
-                {
-                    // message is still existing
-                    close(fd);
-                    return messageId;
-                }
+        while (linkPtr)
+        {
+            MboxEntry_t* entryPtr = CONTAINER_OF(linkPtr, MboxEntry_t, link);
 
-                // else continue the parsing
-            }
-            else
+            if (entryPtr->seq > browseCtxPtr->currentSeq)
             {
-                LE_ERROR("json error");
+                browseCtxPtr->currentSeq = entryPtr->seq;
+                return entryPtr->messageId;
             }
-        }
-        else
-        {
-            LE_ERROR("json error");
+
+            linkPtr = le_dls_PeekNext(&appsPtr->entryList, linkPtr);
         }
     }
 
-    // Parsing end => free the memory
+    // Parsing end
     LE_DEBUG("No more messages");
-    json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-    memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
+    memset(browseCtxPtr, 0, sizeof(BrowseCtx_t));
 
     return 0;
 }
@@ -2771,27 +2936,15 @@ bool SmsInbox_IsUnread
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    MboxEntry_t* entryPtr = CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr,
+                                                 msgId);
+    if (NULL == entryPtr)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[] = {JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 2,
-                       &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        LE_ERROR("Error in DecodeMsgEntry");
-        return false;
-    }
+    return entryPtr->isUnread;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2826,21 +2979,17 @@ void SmsInbox_MarkRead
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    MboxEntry_t* entryPtr = CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr,
+                                                 msgId);
+    if (NULL == entryPtr)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = false;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (SetMsgUnreadInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, entryPtr, false) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Error in SetMsgUnreadInMbox");
     }
 }
 
@@ -2876,20 +3025,16 @@ void SmsInbox_MarkUnread
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    MboxEntry_t* entryPtr = CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr,
+                                                 msgId);
+    if (NULL == entryPtr)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (SetMsgUnreadInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, entryPtr, true) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Error in SetMsgUnreadInMbox");
     }
 }
@@ -13,6 +13,22 @@
 #include <linux/types.h>
 #include <linux/spi/spidev.h>
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of segments in a transfer (bits in the full duplex mask).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SEGMENTS 32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * spidev module parameter holding the maximum number of bytes written or read by one message,
+ * and its default value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SPIDEV_BUFSIZ_PATH      "/sys/module/spidev/parameters/bufsiz"
+#define SPIDEV_DEFAULT_BUFSIZ   4096
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configures the SPI bus for use with a specific device.
@@ -331,6 +347,219 @@ le_result_t le_spiLib_ReadHD
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs a sequence of SPI transfers in a single message, with chip select kept asserted from
+ * the first to the last.  Each segment writes writeLengths[i] bytes then reads readLengths[i]
+ * bytes, unless bit i of fullDuplexMask is set, in which case it writes and reads the same number
+ * of bytes at the same time.  The data written by all segments is taken one after the other from
+ * writeData, and the data read is stored one after the other in readData.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER if there are too many segments or a full duplex segment doesn't write as
+ *        many bytes as it reads
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spiLib_Transfer
+(
+    int fd,                         ///< [in] open file descriptor of SPI port
+    const uint8_t* writeData,       ///< [in] data written by all segments
+    uint8_t* readData,              ///< [out] data read by all segments
+    const uint32_t* writeLengths,   ///< [in] number of bytes written by each segment
+    const uint32_t* readLengths,    ///< [in] number of bytes read by each segment
+    size_t numSegments,             ///< [in] number of segments (at most 32)
+    uint32_t fullDuplexMask         ///< [in] bit i set if segment i is full duplex
+)
+{
+    // A half duplex segment takes up to two transfers, one writing and one reading.
+    struct spi_ioc_transfer tr[MAX_SEGMENTS * 2];
+    size_t numTransfers = 0;
+    int transferResult;
+
+    if (numSegments > MAX_SEGMENTS)
+    {
+        LE_ERROR("Too many segments (%zu)", numSegments);
+        return LE_BAD_PARAMETER;
+    }
+
+    memset(tr, 0, sizeof(tr));
+
+    for (size_t i = 0; i < numSegments; i++)
+    {
+        if (fullDuplexMask & (1u << i))
+        {
+            if (writeLengths[i] != readLengths[i])
+            {
+                LE_ERROR("Full duplex segment %zu writes %u bytes but reads %u",
+                         i, writeLengths[i], readLengths[i]);
+                return LE_BAD_PARAMETER;
+            }
+
+            tr[numTransfers].tx_buf = (unsigned long)writeData;
+            tr[numTransfers].rx_buf = (unsigned long)readData;
+            tr[numTransfers].len = writeLengths[i];
+            numTransfers++;
+        }
+        else
+        {
+            if (writeLengths[i] > 0)
+            {
+                tr[numTransfers].tx_buf = (unsigned long)writeData;
+                tr[numTransfers].len = writeLengths[i];
+                numTransfers++;
+            }
+            if (readLengths[i] > 0)
+            {
+                tr[numTransfers].rx_buf = (unsigned long)readData;
+                tr[numTransfers].len = readLengths[i];
+                numTransfers++;
+            }
+        }
+
+        writeData += writeLengths[i];
+        readData += readLengths[i];
+    }
+
+    if (numTransfers == 0)
+    {
+        return LE_OK;
+    }
+
+    LE_DEBUG("Transferring %zu segments in %zu transfers", numSegments, numTransfers);
+
+    transferResult = ioctl(fd, SPI_IOC_MESSAGE(numTransfers), tr);
+    if (transferResult < 1)
+    {
+        LE_ERROR("Transfer failed with error %d : %d (%m)", transferResult, errno);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum number of bytes the spidev driver writes or reads in one message.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetSpidevBufSize
+(
+    void
+)
+{
+    static size_t BufSize = 0;
+
+    if (BufSize == 0)
+    {
+        char value[16];
+        int fd = open(SPIDEV_BUFSIZ_PATH, O_RDONLY);
+        ssize_t len = (fd < 0) ? -1 : read(fd, value, sizeof(value) - 1);
+
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        BufSize = SPIDEV_DEFAULT_BUFSIZ;
+        if (len > 0)
+        {
+            value[len] = '\0';
+            unsigned long bufSize = strtoul(value, NULL, 10);
+            if (bufSize > 0)
+            {
+                BufSize = bufSize;
+            }
+        }
+
+        LE_DEBUG("spidev transfers up to %zu bytes per message", BufSize);
+    }
+
+    return BufSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs SPI Write Half Duplex followed by a Read of any size.  Reads bigger than what the
+ * spidev driver accepts in one message are split into several messages, with chip select kept
+ * asserted between them.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spiLib_WriteReadLarge
+(
+    int fd,                   ///< [in] open file descriptor of SPI port
+    const uint8_t* writeData, ///< [in] tx command/address being sent to slave
+    size_t writeDataLength,   ///< [in] number of bytes in tx message (may be 0)
+    uint8_t* readData,        ///< [out] rx response from slave
+    size_t readDataLength     ///< [in] number of bytes to read
+)
+{
+    size_t bufSize = GetSpidevBufSize();
+    size_t numMsgs = 0;
+
+    if (writeDataLength > bufSize)
+    {
+        LE_ERROR("Can't write %zu bytes in one message (max %zu)", writeDataLength, bufSize);
+        return LE_FAULT;
+    }
+
+    do
+    {
+        struct spi_ioc_transfer tr[2];
+        size_t numTransfers = 0;
+        size_t chunkLength = (readDataLength < bufSize) ? readDataLength : bufSize;
+
+        memset(tr, 0, sizeof(tr));
+
+        // The command is only written at the start.
+        if (writeDataLength > 0)
+        {
+            tr[numTransfers].tx_buf = (unsigned long)writeData;
+            tr[numTransfers].len = writeDataLength;
+            numTransfers++;
+            writeDataLength = 0;
+        }
+        if (chunkLength > 0)
+        {
+            tr[numTransfers].rx_buf = (unsigned long)readData;
+            tr[numTransfers].len = chunkLength;
+            numTransfers++;
+        }
+        if (numTransfers == 0)
+        {
+            break;
+        }
+
+        readData += chunkLength;
+        readDataLength -= chunkLength;
+
+        // Keep chip select asserted after the message if there is more to read.
+        tr[numTransfers - 1].cs_change = (readDataLength > 0);
+
+        int transferResult = ioctl(fd, SPI_IOC_MESSAGE(numTransfers), tr);
+        if (transferResult < 1)
+        {
+            LE_ERROR("Transfer failed with error %d : %d (%m)", transferResult, errno);
+            return LE_FAULT;
+        }
+
+        numMsgs++;
+    }
+    while (readDataLength > 0);
+
+    LE_DEBUG("Read done in %zu messages", numMsgs);
+
+    return LE_OK;
+}
+
+
 COMPONENT_INIT
 {
     LE_DEBUG("spiLibrary initializing");
@@ -100,4 +100,50 @@ LE_SHARED le_result_t le_spiLib_ReadHD
     size_t* readDataLength    ///< [in/out] number of bytes in rx message
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs a sequence of SPI transfers in a single message, with chip select kept asserted from
+ * the first to the last.  Each segment writes writeLengths[i] bytes then reads readLengths[i]
+ * bytes, unless bit i of fullDuplexMask is set, in which case it writes and reads the same number
+ * of bytes at the same time.  The data written by all segments is taken one after the other from
+ * writeData, and the data read is stored one after the other in readData.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER if there are too many segments or a full duplex segment doesn't write as
+ *        many bytes as it reads
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_spiLib_Transfer
+(
+    int fd,                         ///< [in] open file descriptor of SPI port
+    const uint8_t* writeData,       ///< [in] data written by all segments
+    uint8_t* readData,              ///< [out] data read by all segments
+    const uint32_t* writeLengths,   ///< [in] number of bytes written by each segment
+    const uint32_t* readLengths,    ///< [in] number of bytes read by each segment
+    size_t numSegments,             ///< [in] number of segments (at most 32)
+    uint32_t fullDuplexMask         ///< [in] bit i set if segment i is full duplex
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs SPI Write Half Duplex followed by a Read of any size.  Reads bigger than what the
+ * spidev driver accepts in one message are split into several messages, with chip select kept
+ * asserted between them.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_spiLib_WriteReadLarge
+(
+    int fd,                   ///< [in] open file descriptor of SPI port
+    const uint8_t* writeData, ///< [in] tx command/address being sent to slave
+    size_t writeDataLength,   ///< [in] number of bytes in tx message (may be 0)
+    uint8_t* readData,        ///< [out] rx response from slave
+    size_t readDataLength     ///< [in] number of bytes to read
+);
+
 #endif  // LE_SPI_LIBRARY_H
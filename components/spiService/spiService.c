@@ -12,6 +12,8 @@
 #include "interfaces.h"
 #include "le_spiLibrary.h"
 
+#include <sys/mman.h>
+
 #define MAX_EXPECTED_DEVICES (8)
 
 
@@ -332,6 +334,157 @@ le_result_t le_spi_ReadHD
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs a sequence of transfers as a single SPI message.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the lengths don't match the data or each other
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spi_Transfer
+(
+    le_spi_DeviceHandleRef_t handle, ///< [in] Handle for the SPI master to perform the transfer on
+    const uint32_t* writeLengths, ///< [in] Number of bytes written by each segment
+    size_t numWriteLengths,       ///< [in] Number of entries in writeLengths
+    const uint32_t* readLengths,  ///< [in] Number of bytes read by each segment
+    size_t numReadLengths,        ///< [in] Number of entries in readLengths
+    uint32_t fullDuplexMask,      ///< [in] Bit i set if segment i is full duplex
+    const uint8_t* writeData,     ///< [in] Data written by all segments
+    size_t writeDataLength,       ///< [in] Number of bytes in writeData
+    uint8_t* readData,            ///< [out] Data read by all segments
+    size_t* readDataLength        ///< [in/out] Number of bytes in readData
+)
+{
+    Device_t* device = le_ref_Lookup(DeviceHandleRefMap, handle);
+    if (device == NULL)
+    {
+        LE_KILL_CLIENT("Failed to lookup device from handle!");
+        return LE_FAULT;
+    }
+
+    if (!IsDeviceOwnedByCaller(device))
+    {
+        LE_KILL_CLIENT("Cannot assign handle to transfer as it is not owned by the caller");
+        return LE_FAULT;
+    }
+
+    if (numWriteLengths != numReadLengths)
+    {
+        LE_ERROR("%zu write lengths for %zu read lengths", numWriteLengths, numReadLengths);
+        return LE_BAD_PARAMETER;
+    }
+
+    // The segments must account for all of the data, and fit in the read buffer.
+    size_t totalWrite = 0;
+    size_t totalRead = 0;
+    for (size_t i = 0; i < numWriteLengths; i++)
+    {
+        totalWrite += writeLengths[i];
+        totalRead += readLengths[i];
+    }
+    if ((totalWrite != writeDataLength) || (totalRead > *readDataLength))
+    {
+        LE_ERROR("Segments write %zu bytes of %zu and read %zu bytes into %zu",
+                 totalWrite, writeDataLength, totalRead, *readDataLength);
+        return LE_BAD_PARAMETER;
+    }
+    *readDataLength = totalRead;
+
+    return le_spiLib_Transfer(
+        device->fd,
+        writeData,
+        readData,
+        writeLengths,
+        readLengths,
+        numWriteLengths,
+        fullDuplexMask);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SPI Half Duplex Write followed by a Read into a buffer shared with the client.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the buffer can't be mapped or is too small
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spi_ReadToBuffer
+(
+    le_spi_DeviceHandleRef_t handle, ///< [in] Handle for the SPI master to perform the read on
+    const uint8_t* writeData,     ///< [in] Tx command/address being sent to slave
+    size_t writeDataLength,       ///< [in] Number of bytes in tx message
+    int bufferFd,                 ///< [in] Shared memory file to read into (closed here)
+    uint32_t offset,              ///< [in] Offset in the buffer of the first byte read
+    uint32_t length               ///< [in] Number of bytes to read
+)
+{
+    le_result_t result;
+    struct stat bufferStat;
+
+    Device_t* device = le_ref_Lookup(DeviceHandleRefMap, handle);
+    if (device == NULL)
+    {
+        LE_KILL_CLIENT("Failed to lookup device from handle!");
+        close(bufferFd);
+        return LE_FAULT;
+    }
+
+    if (!IsDeviceOwnedByCaller(device))
+    {
+        LE_KILL_CLIENT("Cannot assign handle to read as it is not owned by the caller");
+        close(bufferFd);
+        return LE_FAULT;
+    }
+
+    if ((bufferFd < 0) || (fstat(bufferFd, &bufferStat) != 0) ||
+        ((uint64_t)offset + length > (uint64_t)bufferStat.st_size))
+    {
+        LE_ERROR("Buffer is too small for %u bytes at offset %u", length, offset);
+        if (bufferFd >= 0)
+        {
+            close(bufferFd);
+        }
+        return LE_BAD_PARAMETER;
+    }
+
+    if (length == 0)
+    {
+        close(bufferFd);
+        return le_spiLib_WriteHD(device->fd, writeData, writeDataLength) == LE_OK ?
+            LE_OK : LE_FAULT;
+    }
+
+    // Only map the pages holding the part of the buffer read into.
+    size_t pageOffset = offset % sysconf(_SC_PAGESIZE);
+    size_t mapLength = pageOffset + length;
+    uint8_t* mapPtr = mmap(NULL, mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, bufferFd,
+                           offset - pageOffset);
+    close(bufferFd);
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Can't map the buffer (%m)");
+        return LE_BAD_PARAMETER;
+    }
+
+    result = le_spiLib_WriteReadLarge(
+        device->fd,
+        writeData,
+        writeDataLength,
+        mapPtr + pageOffset,
+        length) == LE_OK ? LE_OK : LE_FAULT;
+
+    munmap(mapPtr, mapLength);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the given handle is owned by the current client.
@@ -0,0 +1,910 @@
+/**
+ * @file gpioChardev.c
+ *
+ * Functions for working with GPIOs through the GPIO character device (GPIO v2 uAPI) in Linux.
+ *
+ * Each pin gets a line request when it is first used by a client, and keeps it until the client
+ * session closes.  Changing the configuration of the pin reconfigures the line request rather than
+ * requesting it again, and the configuration is cached so that reading it back costs nothing.
+ * Edge events are queued by the kernel, with a timestamp and a sequence number, and are read in
+ * batches when the line request's file descriptor becomes readable.
+ *
+ * If the kernel headers don't provide the GPIO v2 uAPI, gpioChardev_Init() always fails and the
+ * sysfs is used instead.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "gpioChardev.h"
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#ifdef GPIO_V2_GET_LINE_IOCTL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The pins are provided by the GPIO chip that is presented in the sysfs at this path.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SYSFS_GPIO_CHIP_PATH    "/sys/class/gpio/gpiochip1"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GPIO character devices have paths like /dev/gpiochip0
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEV_PATH                "/dev"
+#define DEV_GPIO_CHIP_PREFIX    "gpiochip"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the consumer of the line requests, as shown by the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LINE_CONSUMER           "legato"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of edge events the kernel can queue for each pin before it starts losing them, and the
+ * maximum number of events read at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_QUEUE_SIZE        64
+#define EVENT_BATCH_SIZE        16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flags of the line configuration that are set by each function.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIRECTION_FLAGS     (GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_OUTPUT)
+#define DRIVE_FLAGS         (GPIO_V2_LINE_FLAG_OPEN_DRAIN | GPIO_V2_LINE_FLAG_OPEN_SOURCE)
+#define BIAS_FLAGS          (GPIO_V2_LINE_FLAG_BIAS_PULL_UP | GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN \
+                             | GPIO_V2_LINE_FLAG_BIAS_DISABLED)
+#define EDGE_FLAGS          (GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The GPIO chip: its file descriptor, and the number of the pin that is its first line.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ChipFd = -1;
+static int ChipBase = 0;
+static uint32_t ChipLines = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an attribute of the GPIO chip from the sysfs, without its trailing newline.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if it can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadChipAttr
+(
+    const char* attrName,       ///< [IN] Name of the attribute
+    char* bufferPtr,            ///< [OUT] Attribute content
+    size_t bufferSize           ///< [IN] Size of the buffer
+)
+{
+    char path[128];
+    ssize_t length;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/%s", SYSFS_GPIO_CHIP_PATH, attrName);
+
+    do
+    {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    while ((fd < 0) && (errno == EINTR));
+
+    if (fd < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    do
+    {
+        length = read(fd, bufferPtr, bufferSize - 1);
+    }
+    while ((length < 0) && (errno == EINTR));
+
+    close(fd);
+
+    if (length <= 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    bufferPtr[length] = '\0';
+    bufferPtr[strcspn(bufferPtr, "\n")] = '\0';
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the GPIO chip that provides the pins.
+ *
+ * It's the GPIO character device with the same label as the GPIO chip presented in the sysfs.
+ *
+ * @return true if the pins can be driven through the GPIO character device.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gpioChardev_Init
+(
+    void
+)
+{
+    char label[GPIO_MAX_NAME_SIZE];
+    char base[16];
+    struct dirent* entryPtr;
+    DIR* dirPtr;
+
+    if (ChipFd >= 0)
+    {
+        return true;
+    }
+
+    if ((LE_OK != ReadChipAttr("label", label, sizeof(label)))
+        || (LE_OK != ReadChipAttr("base", base, sizeof(base))))
+    {
+        LE_INFO("Unable to identify the GPIO chip in %s", SYSFS_GPIO_CHIP_PATH);
+        return false;
+    }
+
+    dirPtr = opendir(DEV_PATH);
+    if (NULL == dirPtr)
+    {
+        return false;
+    }
+
+    while ((ChipFd < 0) && ((entryPtr = readdir(dirPtr)) != NULL))
+    {
+        char path[PATH_MAX];
+        struct gpiochip_info info;
+        int fd;
+
+        if (strncmp(entryPtr->d_name, DEV_GPIO_CHIP_PREFIX, sizeof(DEV_GPIO_CHIP_PREFIX) - 1) != 0)
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", DEV_PATH, entryPtr->d_name);
+
+        do
+        {
+            fd = open(path, O_RDWR | O_CLOEXEC);
+        }
+        while ((fd < 0) && (errno == EINTR));
+
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        memset(&info, 0, sizeof(info));
+        if ((ioctl(fd, GPIO_GET_CHIPINFO_IOCTL, &info) == 0)
+            && (strncmp(info.label, label, sizeof(info.label)) == 0))
+        {
+            LE_INFO("Using GPIO character device %s (%s, %u lines)", path, label, info.lines);
+            ChipFd = fd;
+            ChipBase = atoi(base);
+            ChipLines = info.lines;
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+
+    closedir(dirPtr);
+
+    return (ChipFd >= 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current configuration of a pin: the flags its line request was configured with, or the
+ * flags reported by the kernel if it hasn't been requested yet.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel can't be queried
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFlags
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    uint64_t* flagsPtr              ///< [OUT] GPIO_V2_LINE_FLAG_* flags
+)
+{
+    struct gpio_v2_line_info info;
+
+    if (gpioRef->lineRequested)
+    {
+        *flagsPtr = gpioRef->lineFlags;
+        return LE_OK;
+    }
+
+    if ((gpioRef->pinNum < ChipBase) || (gpioRef->pinNum - ChipBase >= ChipLines))
+    {
+        LE_ERROR("GPIO %s is not provided by the GPIO chip", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    memset(&info, 0, sizeof(info));
+    info.offset = gpioRef->pinNum - ChipBase;
+
+    if (ioctl(ChipFd, GPIO_V2_GET_LINEINFO_IOCTL, &info) != 0)
+    {
+        LE_ERROR("Unable to get GPIO %s line info. %m", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    *flagsPtr = info.flags & ~GPIO_V2_LINE_FLAG_USED;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill in a line configuration, with the output value if the line is an output.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitLineConfig
+(
+    struct gpio_v2_line_config* configPtr,  ///< [OUT] Line configuration
+    uint64_t flags,                         ///< [IN] GPIO_V2_LINE_FLAG_* flags
+    bool value                              ///< [IN] Output value
+)
+{
+    memset(configPtr, 0, sizeof(*configPtr));
+    configPtr->flags = flags;
+
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT)
+    {
+        configPtr->num_attrs = 1;
+        configPtr->attrs[0].mask = 1;
+        configPtr->attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        configPtr->attrs[0].attr.values = value ? 1 : 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure a pin, requesting its line if it hasn't been requested yet.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Configure
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    uint64_t flags,                 ///< [IN] GPIO_V2_LINE_FLAG_* flags
+    bool value                      ///< [IN] Initial value, if configured as an output
+)
+{
+    // Edges can only be detected on inputs.
+    if (!(flags & GPIO_V2_LINE_FLAG_INPUT))
+    {
+        flags &= ~EDGE_FLAGS;
+    }
+
+    if (gpioRef->lineRequested)
+    {
+        struct gpio_v2_line_config config;
+
+        InitLineConfig(&config, flags, value);
+
+        if (ioctl(gpioRef->lineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) != 0)
+        {
+            LE_ERROR("Unable to configure GPIO %s. %m", gpioRef->gpioName);
+            return LE_IO_ERROR;
+        }
+    }
+    else
+    {
+        struct gpio_v2_line_request request;
+
+        memset(&request, 0, sizeof(request));
+        request.offsets[0] = gpioRef->pinNum - ChipBase;
+        request.num_lines = 1;
+        request.event_buffer_size = EVENT_QUEUE_SIZE;
+        le_utf8_Copy(request.consumer, LINE_CONSUMER, sizeof(request.consumer), NULL);
+        InitLineConfig(&request.config, flags, value);
+
+        if (ioctl(ChipFd, GPIO_V2_GET_LINE_IOCTL, &request) != 0)
+        {
+            LE_ERROR("Unable to request GPIO %s. %m", gpioRef->gpioName);
+            return LE_IO_ERROR;
+        }
+
+        gpioRef->lineFd = request.fd;
+        gpioRef->lineRequested = true;
+        gpioRef->lastEventSeqno = 0;
+    }
+
+    gpioRef->lineFlags = flags;
+
+    LE_DEBUG("GPIO %s configured with flags 0x%" PRIx64, gpioRef->gpioName, flags);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Request the line of a pin, if it hasn't been requested yet, leaving its configuration as it is.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RequestLine
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    struct gpio_v2_line_request request;
+    uint64_t flags;
+
+    if (gpioRef->lineRequested)
+    {
+        return LE_OK;
+    }
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    // A request without direction flags leaves the direction (and output value) unchanged.
+    memset(&request, 0, sizeof(request));
+    request.offsets[0] = gpioRef->pinNum - ChipBase;
+    request.num_lines = 1;
+    request.event_buffer_size = EVENT_QUEUE_SIZE;
+    request.config.flags = flags & GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    le_utf8_Copy(request.consumer, LINE_CONSUMER, sizeof(request.consumer), NULL);
+
+    if (ioctl(ChipFd, GPIO_V2_GET_LINE_IOCTL, &request) != 0)
+    {
+        LE_ERROR("Unable to request GPIO %s. %m", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    gpioRef->lineFd = request.fd;
+    gpioRef->lineRequested = true;
+    gpioRef->lineFlags = flags;
+    gpioRef->lastEventSeqno = 0;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure a pin as an input.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetInput
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity         ///< [IN] Active-high or active-low
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    flags = (flags & (BIAS_FLAGS | EDGE_FLAGS)) | GPIO_V2_LINE_FLAG_INPUT;
+    if (SYSFS_ACTIVE_TYPE_LOW == polarity)
+    {
+        flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+
+    return Configure(gpioRef, flags, false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure a pin as an output.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetOutput
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity,        ///< [IN] Active-high or active-low
+    gpioSysfs_OpenDrainOperation_t drive,   ///< [IN] Push-pull or open drain
+    bool value                              ///< [IN] Initial value (true for active)
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    flags = (flags & BIAS_FLAGS) | GPIO_V2_LINE_FLAG_OUTPUT;
+    if (SYSFS_ACTIVE_TYPE_LOW == polarity)
+    {
+        flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+    if (SYSFS_OPEN_DRAIN_OP == drive)
+    {
+        flags |= GPIO_V2_LINE_FLAG_OPEN_DRAIN;
+    }
+
+    return Configure(gpioRef, flags, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pull-up/pull-down resistors of a pin.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetPullUpDown
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_PullUpDownType_t pud          ///< [IN] The type of pullup, pulldown, off
+)
+{
+    uint64_t flags;
+    bool value = false;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    // Reconfiguring an output must not change its value.
+    if ((flags & GPIO_V2_LINE_FLAG_OUTPUT) && (LE_OK != gpioChardev_GetValue(gpioRef, &value)))
+    {
+        return LE_IO_ERROR;
+    }
+
+    flags &= ~BIAS_FLAGS;
+    switch (pud)
+    {
+        case SYSFS_PULLUPDOWN_TYPE_UP:
+            flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+            break;
+        case SYSFS_PULLUPDOWN_TYPE_DOWN:
+            flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+            break;
+        default:
+            flags |= GPIO_V2_LINE_FLAG_BIAS_DISABLED;
+            break;
+    }
+
+    // Bias can only be set on a line with a direction.
+    if (!(flags & DIRECTION_FLAGS))
+    {
+        flags |= GPIO_V2_LINE_FLAG_INPUT;
+    }
+
+    return Configure(gpioRef, flags, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the polarity of a pin.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetPolarity
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity         ///< [IN] Active-high or active-low
+)
+{
+    uint64_t flags;
+    bool value = false;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    // As with the sysfs, the output value is kept as active or inactive, not as high or low.
+    if ((flags & GPIO_V2_LINE_FLAG_OUTPUT) && (LE_OK != gpioChardev_GetValue(gpioRef, &value)))
+    {
+        return LE_IO_ERROR;
+    }
+
+    flags &= ~GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    if (SYSFS_ACTIVE_TYPE_LOW == polarity)
+    {
+        flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+
+    return Configure(gpioRef, flags, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the edges of an input pin that are queued as events.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetEdgeSense
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_EdgeSensivityMode_t edge      ///< [IN] The mode of GPIO Edge Sensivity.
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    if ((!(flags & GPIO_V2_LINE_FLAG_INPUT)) && (SYSFS_EDGE_SENSE_NONE != edge))
+    {
+        LE_ERROR("Edge detection is only possible on inputs (GPIO %s)", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    flags &= ~EDGE_FLAGS;
+    switch (edge)
+    {
+        case SYSFS_EDGE_SENSE_RISING:
+            flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+            break;
+        case SYSFS_EDGE_SENSE_FALLING:
+            flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+            break;
+        case SYSFS_EDGE_SENSE_BOTH:
+            flags |= EDGE_FLAGS;
+            break;
+        default:
+            break;
+    }
+
+    return Configure(gpioRef, flags, false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a pin is configured as an input.
+ *
+ * @return true = input, false = output.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gpioChardev_IsInput
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return false;
+    }
+
+    return (!(flags & GPIO_V2_LINE_FLAG_OUTPUT));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the polarity of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_ActiveType_t gpioChardev_GetPolarity
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return -1;
+    }
+
+    return (flags & GPIO_V2_LINE_FLAG_ACTIVE_LOW) ? SYSFS_ACTIVE_TYPE_LOW : SYSFS_ACTIVE_TYPE_HIGH;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the pull-up/pull-down resistors of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_PullUpDownType_t gpioChardev_GetPullUpDown
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return -1;
+    }
+
+    if (flags & GPIO_V2_LINE_FLAG_BIAS_PULL_UP)
+    {
+        return SYSFS_PULLUPDOWN_TYPE_UP;
+    }
+    if (flags & GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN)
+    {
+        return SYSFS_PULLUPDOWN_TYPE_DOWN;
+    }
+
+    return SYSFS_PULLUPDOWN_TYPE_OFF;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the edge sensing of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_EdgeSensivityMode_t gpioChardev_GetEdgeSense
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+)
+{
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return -1;
+    }
+
+    switch (flags & EDGE_FLAGS)
+    {
+        case EDGE_FLAGS:
+            return SYSFS_EDGE_SENSE_BOTH;
+        case GPIO_V2_LINE_FLAG_EDGE_RISING:
+            return SYSFS_EDGE_SENSE_RISING;
+        case GPIO_V2_LINE_FLAG_EDGE_FALLING:
+            return SYSFS_EDGE_SENSE_FALLING;
+        default:
+            return SYSFS_EDGE_SENSE_NONE;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the value of a pin (active or inactive, so the polarity is taken into account).
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_GetValue
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    bool* valuePtr                  ///< [OUT] true if active
+)
+{
+    struct gpio_v2_line_values values = { .bits = 0, .mask = 1 };
+
+    if (LE_OK != RequestLine(gpioRef))
+    {
+        return LE_IO_ERROR;
+    }
+
+    if (ioctl(gpioRef->lineFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) != 0)
+    {
+        LE_ERROR("Unable to read GPIO %s. %m", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    *valuePtr = (values.bits & 1);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the value of an output pin (active or inactive).
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetValue
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    bool value                      ///< [IN] true for active
+)
+{
+    struct gpio_v2_line_values values = { .bits = value ? 1 : 0, .mask = 1 };
+    uint64_t flags;
+
+    if (LE_OK != GetFlags(gpioRef, &flags))
+    {
+        return LE_IO_ERROR;
+    }
+
+    // Configuring the pin as an output sets the value at the same time.
+    if ((!gpioRef->lineRequested) || (!(flags & GPIO_V2_LINE_FLAG_OUTPUT)))
+    {
+        return Configure(gpioRef,
+                         (flags & (BIAS_FLAGS | DRIVE_FLAGS | GPIO_V2_LINE_FLAG_ACTIVE_LOW))
+                         | GPIO_V2_LINE_FLAG_OUTPUT,
+                         value);
+    }
+
+    if (ioctl(gpioRef->lineFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) != 0)
+    {
+        LE_ERROR("Unable to write GPIO %s. %m", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the file descriptor to monitor for edge events (POLLIN), requesting the line if needed.
+ *
+ * @return The file descriptor, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+int gpioChardev_GetEventFd
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    if (LE_OK != RequestLine(gpioRef))
+    {
+        return -1;
+    }
+
+    return gpioRef->lineFd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the edge events queued by the kernel for a pin, calling its change callback for each.
+ *
+ * The events are read in batches.  Events lost because the queue overflowed are detected with the
+ * sequence numbers, and reported.
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioChardev_ReadEvents
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    struct gpio_v2_line_event events[EVENT_BATCH_SIZE];
+    ssize_t length;
+    size_t i;
+
+    do
+    {
+        length = read(gpioRef->lineFd, events, sizeof(events));
+    }
+    while ((length < 0) && (errno == EINTR));
+
+    if (length < 0)
+    {
+        LE_ERROR_IF(errno != EAGAIN, "Unable to read events for GPIO %s. %m", gpioRef->gpioName);
+        return;
+    }
+
+    for (i = 0; i < (size_t)length / sizeof(events[0]); i++)
+    {
+        const struct gpio_v2_line_event* eventPtr = &events[i];
+
+        if ((gpioRef->lastEventSeqno != 0) && (eventPtr->line_seqno != gpioRef->lastEventSeqno + 1))
+        {
+            LE_WARN("GPIO %s: %u edge events lost",
+                    gpioRef->gpioName, eventPtr->line_seqno - gpioRef->lastEventSeqno - 1);
+        }
+        gpioRef->lastEventSeqno = eventPtr->line_seqno;
+        gpioRef->lastEventTimestampNs = eventPtr->timestamp_ns;
+
+        LE_DEBUG("GPIO %s %s edge at %" PRIu64 " ns", gpioRef->gpioName,
+                 (eventPtr->id == GPIO_V2_LINE_EVENT_RISING_EDGE) ? "rising" : "falling",
+                 (uint64_t)eventPtr->timestamp_ns);
+
+        // The client may remove its handler from the callback.
+        if (gpioRef->handlerPtr != NULL)
+        {
+            gpioRef->handlerPtr(eventPtr->id == GPIO_V2_LINE_EVENT_RISING_EDGE,
+                                gpioRef->callbackContextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the line request of a pin.
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioChardev_Release
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    int ret;
+
+    if (!gpioRef->lineRequested)
+    {
+        return;
+    }
+
+    do
+    {
+        ret = close(gpioRef->lineFd);
+    }
+    while ((ret != 0) && (errno == EINTR));
+
+    gpioRef->lineRequested = false;
+    gpioRef->lineFd = -1;
+    gpioRef->lineFlags = 0;
+}
+
+#else // GPIO_V2_GET_LINE_IOCTL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The kernel headers don't provide the GPIO v2 uAPI: always use the sysfs.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gpioChardev_Init(void) { return false; }
+le_result_t gpioChardev_SetInput(gpioSysfs_GpioRef_t gpioRef, gpioSysfs_ActiveType_t polarity)
+    { return LE_NOT_IMPLEMENTED; }
+le_result_t gpioChardev_SetOutput(gpioSysfs_GpioRef_t gpioRef, gpioSysfs_ActiveType_t polarity,
+    gpioSysfs_OpenDrainOperation_t drive, bool value) { return LE_NOT_IMPLEMENTED; }
+le_result_t gpioChardev_SetPullUpDown(gpioSysfs_GpioRef_t gpioRef, gpioSysfs_PullUpDownType_t pud)
+    { return LE_NOT_IMPLEMENTED; }
+le_result_t gpioChardev_SetPolarity(gpioSysfs_GpioRef_t gpioRef, gpioSysfs_ActiveType_t polarity)
+    { return LE_NOT_IMPLEMENTED; }
+le_result_t gpioChardev_SetEdgeSense(gpioSysfs_GpioRef_t gpioRef,
+    gpioSysfs_EdgeSensivityMode_t edge) { return LE_NOT_IMPLEMENTED; }
+bool gpioChardev_IsInput(gpioSysfs_GpioRef_t gpioRef) { return false; }
+gpioSysfs_ActiveType_t gpioChardev_GetPolarity(gpioSysfs_GpioRef_t gpioRef) { return -1; }
+gpioSysfs_PullUpDownType_t gpioChardev_GetPullUpDown(gpioSysfs_GpioRef_t gpioRef) { return -1; }
+gpioSysfs_EdgeSensivityMode_t gpioChardev_GetEdgeSense(gpioSysfs_GpioRef_t gpioRef)
+    { return -1; }
+le_result_t gpioChardev_GetValue(gpioSysfs_GpioRef_t gpioRef, bool* valuePtr)
+    { return LE_NOT_IMPLEMENTED; }
+le_result_t gpioChardev_SetValue(gpioSysfs_GpioRef_t gpioRef, bool value)
+    { return LE_NOT_IMPLEMENTED; }
+int gpioChardev_GetEventFd(gpioSysfs_GpioRef_t gpioRef) { return -1; }
+void gpioChardev_ReadEvents(gpioSysfs_GpioRef_t gpioRef) {}
+void gpioChardev_Release(gpioSysfs_GpioRef_t gpioRef) {}
+
+#endif // GPIO_V2_GET_LINE_IOCTL
@@ -0,0 +1,222 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Definitions of the functions for manipulating GPIOs through the GPIO character device
+ * (/dev/gpiochipN, GPIO v2 uAPI) presented by the Linux kernel.
+ *
+ * When the kernel provides it, it is used instead of the sysfs: each pin keeps a line request open
+ * while a client uses it, so reading or writing a pin costs a single ioctl, and edges are queued
+ * (and timestamped) by the kernel instead of being polled from the value file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef GPIOCHARDEV_INTERFACE_H_INCLUDE_GUARD
+#define GPIOCHARDEV_INTERFACE_H_INCLUDE_GUARD
+
+
+#include "legato.h"
+#include "gpioSysfs.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the GPIO chip that provides the pins.
+ *
+ * @return true if the pins can be driven through the GPIO character device.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gpioChardev_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure a pin as an input.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetInput
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity         ///< [IN] Active-high or active-low
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure a pin as an output.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetOutput
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity,        ///< [IN] Active-high or active-low
+    gpioSysfs_OpenDrainOperation_t drive,   ///< [IN] Push-pull or open drain
+    bool value                              ///< [IN] Initial value (true for active)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pull-up/pull-down resistors of a pin.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetPullUpDown
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_PullUpDownType_t pud          ///< [IN] The type of pullup, pulldown, off
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the polarity of a pin.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetPolarity
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_ActiveType_t polarity         ///< [IN] Active-high or active-low
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the edges of an input pin that are queued as events.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR if the kernel refused the configuration
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetEdgeSense
+(
+    gpioSysfs_GpioRef_t gpioRef,            ///< [IN] GPIO object reference
+    gpioSysfs_EdgeSensivityMode_t edge      ///< [IN] The mode of GPIO Edge Sensivity.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a pin is configured as an input.
+ *
+ * @return true = input, false = output.
+ */
+//--------------------------------------------------------------------------------------------------
+bool gpioChardev_IsInput
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the polarity of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_ActiveType_t gpioChardev_GetPolarity
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the pull-up/pull-down resistors of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_PullUpDownType_t gpioChardev_GetPullUpDown
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the edge sensing of a pin.
+ *
+ * @return The current configured value
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_EdgeSensivityMode_t gpioChardev_GetEdgeSense
+(
+    gpioSysfs_GpioRef_t gpioRef             ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the value of a pin (active or inactive, so the polarity is taken into account).
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_GetValue
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    bool* valuePtr                  ///< [OUT] true if active
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the value of an output pin (active or inactive).
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioChardev_SetValue
+(
+    gpioSysfs_GpioRef_t gpioRef,    ///< [IN] GPIO object reference
+    bool value                      ///< [IN] true for active
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the file descriptor to monitor for edge events (POLLIN), requesting the line if needed.
+ *
+ * @return The file descriptor, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+int gpioChardev_GetEventFd
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the edge events queued by the kernel for a pin, calling its change callback for each.
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioChardev_ReadEvents
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the line request of a pin.
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioChardev_Release
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+);
+
+
+#endif // GPIOCHARDEV_INTERFACE_H_INCLUDE_GUARD
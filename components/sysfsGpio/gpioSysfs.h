@@ -270,9 +270,8 @@ le_result_t gpioSysfs_Deactivate
 void* gpioSysfs_SetChangeCallback
 (
     gpioSysfs_GpioRef_t gpioRef,                  ///< [IN] GPIO object reference
-    le_fdMonitor_HandlerFunc_t fdMonFunc,         ///< [IN] The fd monitor function
     gpioSysfs_EdgeSensivityMode_t edge,           ///< [IN] Change(s) that should trigger the callback
-    le_gpioPin2_ChangeCallbackFunc_t handlerPtr,  ///< [IN] The change callback
+    gpioSysfs_ChangeCallbackFunc_t handlerPtr,    ///< [IN] The change callback
     void* contextPtr,                             ///< [IN] A context pointer
     int32_t sampleMs                              ///< [IN] If not interrupt capable, sample this often (ms).
 );
@@ -449,6 +448,11 @@ struct gpioSysfs_Gpio {
     void *callbackContextPtr;                     ///< Client context to be passed back
     le_fdMonitor_Ref_t fdMonitor;                 ///< fdMonitor Object associated to this GPIO
     le_msg_SessionRef_t currentSession;           ///< Current valid IPC session for this pin
+    bool lineRequested;                           ///< Is lineFd a GPIO character device line?
+    int lineFd;                                   ///< The FD of the line request
+    uint64_t lineFlags;                           ///< Flags the line request is configured with
+    uint32_t lastEventSeqno;                      ///< Sequence number of the last edge event
+    uint64_t lastEventTimestampNs;                ///< Time of the last edge event (monotonic)
 };
 
 
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "gpioSysfs.h"
+#include "gpioChardev.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -28,6 +29,42 @@
 #define MAX_PIN_NUMBER 64
 #define MIN_PIN_NUMBER 1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree node that forces the use of the sysfs, even if the GPIO character device is there.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_USE_SYSFS  "gpioService:/useSysfs"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the pins are driven through the GPIO character device rather than the sysfs.  The
+ * choice is made the first time it's needed.
+ *
+ * @return
+ * - true: the GPIO character device is used
+ * - false: the sysfs is used
+ */
+//--------------------------------------------------------------------------------------------------
+static bool UseChardev
+(
+    void
+)
+{
+    static bool isChosen = false;
+    static bool useChardev = false;
+
+    if (!isChosen)
+    {
+        isChosen = true;
+        useChardev = (!le_cfg_QuickGetBool(CFG_USE_SYSFS, false)) && gpioChardev_Init();
+
+        LE_INFO("Using the GPIO %s", useChardev ? "character device" : "sysfs");
+    }
+
+    return useChardev;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check if sysfs gpio path exists.
@@ -269,6 +306,11 @@ static le_result_t WriteOutputValue
         return LE_BAD_PARAMETER;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_SetValue(gpioRef, (SYSFS_VALUE_HIGH == level));
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
     snprintf(attr, sizeof(attr), "%d", level);
     LE_DEBUG("path:%s, attr:%s", path, attr);
@@ -305,6 +347,11 @@ static le_result_t SetEdgeSense
         return LE_BAD_PARAMETER;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_SetEdgeSense(gpioRef, edge);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "edge");
 
     switch(edge)
@@ -382,6 +429,11 @@ le_result_t gpioSysfs_SetPullUpDown
         return LE_BAD_PARAMETER;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_SetPullUpDown(gpioRef, pud);
+    }
+
     // It is not possible to disable the resistors
     if (pud == SYSFS_PULLUPDOWN_TYPE_OFF)
     {
@@ -410,6 +462,11 @@ le_result_t gpioSysfs_SetPushPullOutput
 {
     le_result_t res = LE_OK;
 
+    if ((gpioRef) && (gpioRef->pinNum != 0) && UseChardev())
+    {
+        return gpioChardev_SetOutput(gpioRef, polarity, SYSFS_PUSH_PULL_OP, value);
+    }
+
     res = SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT);
     if (LE_OK != res)
     {
@@ -447,6 +504,11 @@ le_result_t gpioSysfs_SetOpenDrain
     bool value                            ///< [IN] Initial value to drive
 )
 {
+    if ((gpioRef) && (gpioRef->pinNum != 0) && UseChardev())
+    {
+        return gpioChardev_SetOutput(gpioRef, polarity, SYSFS_OPEN_DRAIN_OP, value);
+    }
+
     LE_WARN("Open Drain API not implemented in sysfs GPIO");
     return LE_NOT_IMPLEMENTED;
 }
@@ -481,6 +543,11 @@ le_result_t gpioSysfs_SetInput
 {
     le_result_t res = LE_OK;
 
+    if ((gpioRef) && (gpioRef->pinNum != 0) && UseChardev())
+    {
+        return gpioChardev_SetInput(gpioRef, polarity);
+    }
+
     res = SetDirection(gpioRef, SYSFS_PIN_MODE_INPUT);
 
     if (LE_OK != res)
@@ -529,6 +596,11 @@ le_result_t gpioSysfs_SetPolarity
         return LE_BAD_PARAMETER;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_SetPolarity(gpioRef, level);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "active_low");
     snprintf(attr, sizeof(attr), "%d", level);
     LE_DEBUG("path:%s, attr:%s", path, attr);
@@ -536,6 +608,21 @@ le_result_t gpioSysfs_SetPolarity
     return WriteSysGpioSignalAttr(path, attr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * fd monitor handler for the change callbacks of all the pins.  The pin is the fd monitor's
+ * context.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InputMonitorHandler
+(
+    int fd,             ///< [IN] File descriptor being monitored
+    short events        ///< [IN] Events that occurred
+)
+{
+    gpioSysfs_InputMonitorHandlerFunc(le_fdMonitor_GetContextPtr(), fd, events);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set a change callback on a particular pin
@@ -546,7 +633,6 @@ le_result_t gpioSysfs_SetPolarity
 void* gpioSysfs_SetChangeCallback
 (
     gpioSysfs_GpioRef_t gpioRef,                  ///< [IN] GPIO object reference
-    le_fdMonitor_HandlerFunc_t fdMonFunc,         ///< [IN] The fd monitor function
     gpioSysfs_EdgeSensivityMode_t edge,           ///< [IN] Edge detection mode.
     gpioSysfs_ChangeCallbackFunc_t handlerPtr,    ///< [IN]
     void* contextPtr,                             ///< [IN]
@@ -589,6 +675,24 @@ void* gpioSysfs_SetChangeCallback
     gpioRef->handlerPtr = handlerPtr;
     gpioRef->callbackContextPtr = contextPtr;
 
+    // With the GPIO character device, the edges are queued as events on the line request's fd
+    if (UseChardev())
+    {
+        monFd = gpioChardev_GetEventFd(gpioRef);
+        if (monFd < 0)
+        {
+            LE_ERROR("Unable to get GPIO events fd for monitoring");
+            return NULL;
+        }
+
+        LE_DEBUG("Setting up event monitor for fd %d and pin %s", monFd, gpioRef->gpioName);
+        gpioRef->fdMonitor = le_fdMonitor_Create(gpioRef->gpioName, monFd,
+                                                 InputMonitorHandler, POLLIN);
+        le_fdMonitor_SetContextPtr(gpioRef->fdMonitor, gpioRef);
+
+        return &(gpioRef->gpioName);
+    }
+
     // Start monitoring the fd for the correct GPIO
     snprintf(monFile, sizeof(monFile), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
 
@@ -620,7 +724,9 @@ void* gpioSysfs_SetChangeCallback
     }
 
     LE_DEBUG("Setting up file monitor for fd %d and pin %s", monFd, gpioRef->gpioName);
-    gpioRef->fdMonitor = le_fdMonitor_Create (gpioRef->gpioName, monFd, fdMonFunc, POLLPRI);
+    gpioRef->fdMonitor = le_fdMonitor_Create(gpioRef->gpioName, monFd,
+                                             InputMonitorHandler, POLLPRI);
+    le_fdMonitor_SetContextPtr(gpioRef->fdMonitor, gpioRef);
     gpioRef->monitorFd = monFd;
 
     return &(gpioRef->gpioName);
@@ -649,6 +755,12 @@ void gpioSysfs_RemoveChangeCallback
         gpioRef->fdMonitor = NULL;
     }
 
+    // Nobody reads the edge events anymore: stop queuing them
+    if (UseChardev())
+    {
+        gpioChardev_SetEdgeSense(gpioRef, SYSFS_EDGE_SENSE_NONE);
+    }
+
     // If there is a callback registered then forget it
     gpioRef->callbackContextPtr = NULL;
     gpioRef->handlerPtr = NULL;
@@ -700,6 +812,18 @@ gpioSysfs_Value_t gpioSysfs_ReadValue
         return -1;
     }
 
+    if (UseChardev())
+    {
+        bool value;
+
+        if (LE_OK != gpioChardev_GetValue(gpioRef, &value))
+        {
+            return -1;
+        }
+
+        return value ? SYSFS_VALUE_HIGH : SYSFS_VALUE_LOW;
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -726,10 +850,14 @@ le_result_t gpioSysfs_Activate
     gpioSysfs_GpioRef_t gpioRef
 )
 {
-    if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+    // The GPIO character device configures the pin as an output when writing its value
+    if ((!gpioRef) || (gpioRef->pinNum == 0) || (!UseChardev()))
     {
-        LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
-        return LE_IO_ERROR;
+        if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+        {
+            LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
+            return LE_IO_ERROR;
+        }
     }
 
     if (LE_OK != WriteOutputValue(gpioRef, SYSFS_VALUE_HIGH))
@@ -752,10 +880,14 @@ le_result_t gpioSysfs_Deactivate
     gpioSysfs_GpioRef_t gpioRef
 )
 {
-    if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+    // The GPIO character device configures the pin as an output when writing its value
+    if ((!gpioRef) || (gpioRef->pinNum == 0) || (!UseChardev()))
     {
-        LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
-        return LE_IO_ERROR;
+        if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+        {
+            LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
+            return LE_IO_ERROR;
+        }
     }
 
     if (LE_OK != WriteOutputValue(gpioRef, SYSFS_VALUE_LOW))
@@ -811,6 +943,11 @@ bool gpioSysfs_IsInput
         return false;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_IsInput(gpioRef);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "direction");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -860,6 +997,11 @@ gpioSysfs_PullUpDownType_t gpioSysfs_GetPullUpDown
         return -1;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_GetPullUpDown(gpioRef);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "pull");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -908,6 +1050,11 @@ gpioSysfs_ActiveType_t gpioSysfs_GetPolarity
         return -1;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_GetPolarity(gpioRef);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "active_low");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -956,6 +1103,11 @@ gpioSysfs_EdgeSensivityMode_t gpioSysfs_GetEdgeSense
         return SYSFS_EDGE_SENSE_NONE;
     }
 
+    if (UseChardev())
+    {
+        return gpioChardev_GetEdgeSense(gpioRef);
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "edge");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -1032,6 +1184,12 @@ void gpioSysfs_InputMonitorHandlerFunc
         return;
     }
 
+    if (UseChardev())
+    {
+        gpioChardev_ReadEvents(gpioRef);
+        return;
+    }
+
     // Seek to the start of the file - this is required to prevent
     // repeated triggers - see https://www.kernel.org/doc/Documentation/gpio/sysfs.txt
     LE_DEBUG("Seek to start of file %d", fd);
@@ -1107,7 +1265,7 @@ void gpioSysfs_SessionOpenHandlerFunc
     }
 
     // Export the pin in sysfs to make it available for use
-    if (LE_OK != ExportGpio(gpioRef))
+    if ((!UseChardev()) && (LE_OK != ExportGpio(gpioRef)))
     {
         LE_WARN("Unable to export GPIO %s for use - stopping session", gpioRef->gpioName);
         le_msg_CloseSession(sessionRef);
@@ -1164,15 +1322,21 @@ void gpioSysfs_SessionCloseHandlerFunc
         LE_DEBUG("Stopping fd monitor");
         le_fdMonitor_Delete(gpioRef->fdMonitor);
         gpioRef->fdMonitor = NULL;
-        int ret = 0;
-        do
+        if (gpioRef->monitorFd >= 0)
         {
-            ret = close(gpioRef->monitorFd);
+            int ret = 0;
+            do
+            {
+                ret = close(gpioRef->monitorFd);
+            }
+            while ((ret != 0) && (errno == EINTR));
+            gpioRef->monitorFd = -1;
         }
-        while ((ret != 0) && (errno == EINTR));
-        gpioRef->monitorFd = -1;
     }
 
+    // Release the line request, which also closes the fd monitored with the GPIO character device
+    gpioChardev_Release(gpioRef);
+
     LE_DEBUG("Removing callback references");
     // If there is a callback registered then forget it
     gpioRef->callbackContextPtr = NULL;
@@ -1197,9 +1361,9 @@ bool gpioSysfs_IsPinAvailable
     int pinNum         ///< [IN] GPIO object reference
 )
 {
-    char path[64];
-    char result[33];
-    le_result_t leResult;
+    // The mask is read once, when the services start
+    static bool isMaskRead = false;
+    static uint64_t mask = 0;
 
     if ((pinNum < MIN_PIN_NUMBER) || (pinNum > MAX_PIN_NUMBER))
     {
@@ -1207,45 +1371,24 @@ bool gpioSysfs_IsPinAvailable
         return false;
     }
 
-    snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, "gpiochip1", "mask");
-    leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
-    if (leResult != LE_OK)
+    if (!isMaskRead)
     {
-        return false;
-    }
-
-    LE_DEBUG("Mask read as: %s", result);
+        char path[64];
+        char result[33];
 
-    // The mask is 64 bits long
-    // The format of the string is 0xnnnnnnnnnnnnnnnn. Each "n" represents 4 pins, starting
-    // with pin 1-4 on the far right. So we can calculate where to look based on the pin number
-    // e.g. 1-4 = index 17, 5-8 = index 16 etc.
-    int index = 17 - (pinNum / 4);
-    int bitInMask = (pinNum) % 4;
-
-    // Multiples of 4 have no remainder, and end up at the wrong index with that calculation
-    // Need to move them back one bit, which is one character to the right, and 4 bits left
-    if (bitInMask == 0)
-    {
-        bitInMask = 4;
-        index ++;
-    }
+        snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, "gpiochip1", "mask");
+        if (ReadSysGpioSignalAttr(path, sizeof(result), result) != LE_OK)
+        {
+            return false;
+        }
 
-    // Convert the mask to a number from a hex string
-    LE_DEBUG("Mask calculated for %d as bit %d at index %d", pinNum, bitInMask, index);
+        // The format of the string is 0xnnnnnnnnnnnnnnnn, with pin 1 as the lowest bit.
+        mask = strtoull(result, NULL, 16);
+        isMaskRead = true;
 
-    // Convert the entry in the mask from a hex character to a number
-    int check = 0;
-    if (isdigit(result[index]))
-    {
-        check = result[index] - '0';
-    }
-    else
-    {
-        check = toupper(result[index]) - 'A' + 10;
+        LE_DEBUG("Mask read as: %s", result);
     }
 
-    LE_DEBUG("About to compare %d and %d", check, (1 << (bitInMask -1)));
-    return (check & (1 << (bitInMask -1)));
+    return ((mask >> (pinNum - 1)) & 1);
 }
 
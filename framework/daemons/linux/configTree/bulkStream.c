@@ -0,0 +1,806 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file bulkStream.c
+ *
+ *  Building, parsing and sending of the record streams used by the bulk config API calls.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "treeDb.h"
+#include "treePath.h"
+#include "bulkStream.h"
+
+
+
+
+/// Initial size of a stream buffer.
+#define BUFFER_MIN_SIZE 512
+
+
+
+/// Largest stream that will be read from a client.
+#define STREAM_MAX_SIZE (1024 * 1024)
+
+
+
+/// Number of bytes to read from a stream at a time.
+#define READ_CHUNK_SIZE 4096
+
+
+
+
+// Pool for the stream buffer objects.
+static le_mem_PoolRef_t BufferPool = NULL;
+
+#define CFG_BULK_BUFFER_POOL "configTree.bulkBufferPool"
+
+
+
+
+/// Names of the node types, as they appear in streams.
+static const char* TypeNames[] =
+    {
+        [LE_CFG_TYPE_EMPTY] = "empty",
+        [LE_CFG_TYPE_STRING] = "string",
+        [LE_CFG_TYPE_BOOL] = "bool",
+        [LE_CFG_TYPE_INT] = "int",
+        [LE_CFG_TYPE_FLOAT] = "float",
+        [LE_CFG_TYPE_STEM] = "stem",
+        [LE_CFG_TYPE_DOESNT_EXIST] = "doesntExist"
+    };
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct bs_Buffer
+{
+    uint8_t* dataPtr;                ///< The stream.
+    size_t size;                     ///< Number of bytes used in the buffer.
+    size_t maxSize;                  ///< Number of bytes allocated for the buffer.
+
+    size_t sentSize;                 ///< Number of bytes sent so far, while sending.
+    int descriptor;                  ///< Where the buffer is being sent, -1 if it isn't.
+    le_fdMonitor_Ref_t monitorRef;   ///< Waits for room to send more, NULL if not waiting.
+}
+Buffer_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Make sure there's room for more bytes at the end of a buffer.
+ *
+ *  @return Pointer to the end of the used part of the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* MakeRoom
+(
+    Buffer_t* bufferPtr,  ///< [IN] The buffer.
+    size_t size           ///< [IN] Number of bytes needed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (bufferPtr->size + size > bufferPtr->maxSize)
+    {
+        size_t newMax = bufferPtr->maxSize * 2;
+
+        while (bufferPtr->size + size > newMax)
+        {
+            newMax *= 2;
+        }
+
+        bufferPtr->dataPtr = realloc(bufferPtr->dataPtr, newMax);
+        LE_ASSERT(bufferPtr->dataPtr != NULL);
+        bufferPtr->maxSize = newMax;
+    }
+
+    return bufferPtr->dataPtr + bufferPtr->size;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a string to a buffer, along with its null terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddString
+(
+    Buffer_t* bufferPtr,  ///< [IN] The buffer.
+    const char* strPtr    ///< [IN] The string to add.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t size = strlen(strPtr) + 1;
+
+    memcpy(MakeRoom(bufferPtr, size), strPtr, size);
+    bufferPtr->size += size;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append records for the children of a stem, and everything under them.
+ *
+ *  @return LE_OK if the records were added, LE_OVERFLOW if a path got too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddChildren
+(
+    Buffer_t* bufferPtr,    ///< [IN] The buffer.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The stem.
+    char* pathPtr,          ///< [IN] Buffer holding the path to the stem, LE_CFG_STR_LEN_BYTES
+                            ///<      long.  It's restored before returning.
+    size_t pathLen          ///< [IN] Length of the path to the stem.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while ((childRef != NULL) && (result == LE_OK))
+    {
+        size_t childLen = pathLen;
+
+        if (childLen > 0)
+        {
+            if (childLen + 1 >= LE_CFG_STR_LEN_BYTES)
+            {
+                result = LE_OVERFLOW;
+                break;
+            }
+
+            pathPtr[childLen++] = '/';
+        }
+
+        result = tdb_GetNodeName(childRef, pathPtr + childLen, LE_CFG_STR_LEN_BYTES - childLen);
+
+        if (result == LE_OK)
+        {
+            if (tdb_GetNodeType(childRef) == LE_CFG_TYPE_STEM)
+            {
+                result = AddChildren(bufferPtr, childRef, pathPtr, strlen(pathPtr));
+            }
+            else
+            {
+                bs_AddNode(bufferPtr, pathPtr, childRef);
+            }
+        }
+
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    pathPtr[pathLen] = '\0';
+
+    return result;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look up a type by its name.
+ *
+ *  @return LE_OK if the name is known, LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseType
+(
+    const char* namePtr,        ///< [IN] The type's name.
+    le_cfg_nodeType_t* typePtr  ///< [OUT] The type.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(TypeNames); i++)
+    {
+        if (   (TypeNames[i] != NULL)
+            && (strcmp(TypeNames[i], namePtr) == 0))
+        {
+            *typePtr = (le_cfg_nodeType_t)i;
+            return LE_OK;
+        }
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check a record's value against its type, and convert it if need be.
+ *
+ *  @return LE_OK if the value is good, LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseValue
+(
+    bs_Record_t* recordPtr  ///< [IN/OUT] The record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* valuePtr = recordPtr->valuePtr;
+    char* endPtr = NULL;
+
+    switch (recordPtr->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            return LE_OK;
+
+        case LE_CFG_TYPE_STRING:
+            return (strlen(valuePtr) <= LE_CFG_STR_LEN) ? LE_OK : LE_FORMAT_ERROR;
+
+        case LE_CFG_TYPE_BOOL:
+            if (strcmp(valuePtr, "true") == 0)
+            {
+                recordPtr->value.asBool = true;
+                return LE_OK;
+            }
+
+            if (strcmp(valuePtr, "false") == 0)
+            {
+                recordPtr->value.asBool = false;
+                return LE_OK;
+            }
+
+            return LE_FORMAT_ERROR;
+
+        case LE_CFG_TYPE_INT:
+            {
+                errno = 0;
+                long value = strtol(valuePtr, &endPtr, 10);
+
+                if (   (errno != 0)
+                    || (endPtr == valuePtr)
+                    || (*endPtr != '\0')
+                    || (value < INT32_MIN)
+                    || (value > INT32_MAX))
+                {
+                    return LE_FORMAT_ERROR;
+                }
+
+                recordPtr->value.asInt = (int32_t)value;
+            }
+            return LE_OK;
+
+        case LE_CFG_TYPE_FLOAT:
+            errno = 0;
+            recordPtr->value.asFloat = strtod(valuePtr, &endPtr);
+
+            if (   (errno != 0)
+                || (endPtr == valuePtr)
+                || (*endPtr != '\0'))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            return LE_OK;
+
+        case LE_CFG_TYPE_STEM:
+            // A stem is made by writing its children.
+            return LE_FORMAT_ERROR;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write as much of a buffer as the descriptor will take.
+ *
+ *  @return LE_OK if the whole buffer has been sent.
+ *          LE_WOULD_BLOCK if the descriptor has to make room before more can be sent.
+ *          LE_IO_ERROR if the write failed, (the reader may have gone away.)
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendMore
+(
+    Buffer_t* bufferPtr  ///< [IN] The buffer being sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (bufferPtr->sentSize < bufferPtr->size)
+    {
+        ssize_t written = write(bufferPtr->descriptor,
+                                bufferPtr->dataPtr + bufferPtr->sentSize,
+                                bufferPtr->size - bufferPtr->sentSize);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                return LE_WOULD_BLOCK;
+            }
+
+            LE_DEBUG("Bulk stream dropped after %zu of %zu bytes (%m).",
+                     bufferPtr->sentSize,
+                     bufferPtr->size);
+            return LE_IO_ERROR;
+        }
+
+        bufferPtr->sentSize += written;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Stop sending a buffer, close its descriptor and free it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishSend
+(
+    Buffer_t* bufferPtr  ///< [IN] The buffer being sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (bufferPtr->monitorRef != NULL)
+    {
+        le_fdMonitor_Delete(bufferPtr->monitorRef);
+        bufferPtr->monitorRef = NULL;
+    }
+
+    bs_CloseFd(bufferPtr->descriptor);
+    bufferPtr->descriptor = -1;
+
+    bs_DeleteBuffer(bufferPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Called when a descriptor that a buffer is being sent to has room for more.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnWritable
+(
+    int descriptor,  ///< [IN] The descriptor.
+    short events     ///< [IN] What happened to it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Buffer_t* bufferPtr = le_fdMonitor_GetContextPtr();
+
+    if (events & (POLLERR | POLLHUP))
+    {
+        LE_DEBUG("Reader of bulk stream on fd %d went away.", descriptor);
+        FinishSend(bufferPtr);
+    }
+    else if (SendMore(bufferPtr) != LE_WOULD_BLOCK)
+    {
+        FinishSend(bufferPtr);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the bulk stream subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Bulk Stream subsystem.");
+
+    BufferPool = le_mem_CreatePool(CFG_BULK_BUFFER_POOL, sizeof(Buffer_t));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create a new, empty, stream buffer.
+ *
+ *  @return The new buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+bs_BufferRef_t bs_CreateBuffer
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Buffer_t* bufferPtr = le_mem_ForceAlloc(BufferPool);
+
+    bufferPtr->dataPtr = malloc(BUFFER_MIN_SIZE);
+    LE_ASSERT(bufferPtr->dataPtr != NULL);
+
+    bufferPtr->size = 0;
+    bufferPtr->maxSize = BUFFER_MIN_SIZE;
+    bufferPtr->sentSize = 0;
+    bufferPtr->descriptor = -1;
+    bufferPtr->monitorRef = NULL;
+
+    return bufferPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_DeleteBuffer
+(
+    bs_BufferRef_t bufferRef  ///< [IN] The buffer to free.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(bufferRef->dataPtr);
+    bufferRef->dataPtr = NULL;
+
+    le_mem_Release(bufferRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a record to a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_AddRecord
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    const char* pathPtr,       ///< [IN] Path to the node.
+    le_cfg_nodeType_t type,    ///< [IN] The node's type.
+    const char* valuePtr       ///< [IN] The node's value, NULL for none.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT((size_t)type < NUM_ARRAY_MEMBERS(TypeNames));
+
+    AddString(bufferRef, pathPtr);
+    AddString(bufferRef, TypeNames[type]);
+    AddString(bufferRef, (valuePtr != NULL) ? valuePtr : "");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a record for a node to a stream buffer.  Stems get a record of their own, their children
+ *  are not included.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_AddNode
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    const char* pathPtr,       ///< [IN] Path to record for the node.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node, NULL if it doesn't exist.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+    char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    const char* valuePtr = NULL;
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            LE_ASSERT(tdb_GetValueAsString(nodeRef, valueBuffer, sizeof(valueBuffer), "") == LE_OK);
+            valuePtr = valueBuffer;
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            valuePtr = tdb_GetValueAsBool(nodeRef, false) ? "true" : "false";
+            break;
+
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_STEM:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            break;
+    }
+
+    bs_AddRecord(bufferRef, pathPtr, type, valuePtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append records for every leaf and empty node at or under a node to a stream buffer.  The paths
+ *  of the records are relative to the given node, (so a node that isn't a stem gets one record,
+ *  with an empty path.)
+ *
+ *  @return LE_OK if the records were added.
+ *          LE_OVERFLOW if the path to one of the nodes was too long to record.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_AddSubtree
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node at the top of the subtree.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (tdb_GetNodeType(nodeRef) != LE_CFG_TYPE_STEM)
+    {
+        bs_AddNode(bufferRef, "", nodeRef);
+        return LE_OK;
+    }
+
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    return AddChildren(bufferRef, nodeRef, pathBuffer, 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a whole stream from a file descriptor into a new buffer.  The stream has to be complete
+ *  when this is called, it is read up to its end without waiting on the writer.
+ *
+ *  @return LE_OK if the stream was read.
+ *          LE_FORMAT_ERROR if the stream wasn't complete, or couldn't be read.
+ *          LE_OVERFLOW if the stream was too large.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_ReadStream
+(
+    int descriptor,               ///< [IN] The file to read.
+    bs_BufferRef_t* bufferRefPtr  ///< [OUT] The stream, if LE_OK is returned.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Never wait on the client, if it hasn't finished writing the stream that's its problem.
+    int flags = fcntl(descriptor, F_GETFL);
+
+    if (   (flags == -1)
+        || (fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1))
+    {
+        LE_ERROR("Could not set up bulk stream fd %d for reading (%m).", descriptor);
+        return LE_FORMAT_ERROR;
+    }
+
+    Buffer_t* bufferPtr = bs_CreateBuffer();
+    le_result_t result = LE_OK;
+
+    for (;;)
+    {
+        ssize_t bytesRead = read(descriptor, MakeRoom(bufferPtr, READ_CHUNK_SIZE), READ_CHUNK_SIZE);
+
+        if (bytesRead == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LE_ERROR("Bulk stream incomplete after %zu bytes (%m).", bufferPtr->size);
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        if (bytesRead == 0)
+        {
+            break;
+        }
+
+        bufferPtr->size += bytesRead;
+
+        if (bufferPtr->size > STREAM_MAX_SIZE)
+        {
+            LE_ERROR("Bulk stream is larger than %d bytes.", STREAM_MAX_SIZE);
+            result = LE_OVERFLOW;
+            break;
+        }
+    }
+
+    if (result != LE_OK)
+    {
+        bs_DeleteBuffer(bufferPtr);
+        return result;
+    }
+
+    // Keep a terminator past the end, in case the client didn't terminate the last string.
+    *MakeRoom(bufferPtr, 1) = '\0';
+
+    *bufferRefPtr = bufferPtr;
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the next null terminated string from a stream buffer.
+ *
+ *  @return The string, or NULL if the end of the buffer has been reached.  Strings remain valid
+ *          until the buffer is freed.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* bs_NextString
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to read.
+    size_t* offsetPtr          ///< [IN/OUT] Where to read from, start at 0.  Moved past the string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = *offsetPtr;
+
+    if (offset >= bufferRef->size)
+    {
+        return NULL;
+    }
+
+    const uint8_t* bytePtr = bufferRef->dataPtr + offset;
+    const uint8_t* nullPtr = memchr(bytePtr, '\0', bufferRef->size - offset);
+
+    if (nullPtr == NULL)
+    {
+        // The last string wasn't terminated, it ends at the terminator kept past the end of the
+        // buffer.
+        nullPtr = bufferRef->dataPtr + bufferRef->size;
+    }
+
+    *offsetPtr = (nullPtr - bufferRef->dataPtr) + 1;
+    return (const char*)bytePtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the next record from a stream buffer.
+ *
+ *  @return LE_OK if a record was read.
+ *          LE_NOT_FOUND if the end of the buffer has been reached.
+ *          LE_FORMAT_ERROR if the record is malformed, or its value doesn't match its type.  Stem
+ *          records are also rejected, as a stem can only be written through its children.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_NextRecord
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to read.
+    size_t* offsetPtr,         ///< [IN/OUT] Where to read from, start at 0.  Moved past the record.
+    bs_Record_t* recordPtr     ///< [OUT] The record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* pathPtr = bs_NextString(bufferRef, offsetPtr);
+
+    if (pathPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    const char* typeNamePtr = bs_NextString(bufferRef, offsetPtr);
+    const char* valuePtr = bs_NextString(bufferRef, offsetPtr);
+
+    if (   (typeNamePtr == NULL)
+        || (valuePtr == NULL)
+        || (strlen(pathPtr) > LE_CFG_STR_LEN)
+        || (tp_PathHasTreeSpecifier(pathPtr))
+        || (ParseType(typeNamePtr, &recordPtr->type) != LE_OK))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    recordPtr->pathPtr = pathPtr;
+    recordPtr->valuePtr = valuePtr;
+
+    return ParseValue(recordPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Send the contents of a stream buffer to a file descriptor, then close the descriptor and free
+ *  the buffer.  Pipes and sockets are written in the background, as the reader makes room.  If the
+ *  reader goes away before the whole stream is sent, the rest of the stream is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_Send
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to send, it is taken over.
+    int descriptor             ///< [IN] The file to write to, it is taken over.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bufferRef->descriptor = descriptor;
+    bufferRef->sentSize = 0;
+
+    struct stat fileStat;
+    int flags = fcntl(descriptor, F_GETFL);
+
+    if (   (fstat(descriptor, &fileStat) == -1)
+        || (flags == -1)
+        || (fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1))
+    {
+        LE_ERROR("Could not set up bulk stream fd %d for writing (%m).", descriptor);
+        FinishSend(bufferRef);
+        return;
+    }
+
+    if (   (SendMore(bufferRef) == LE_WOULD_BLOCK)
+        && (S_ISFIFO(fileStat.st_mode) || S_ISSOCK(fileStat.st_mode)))
+    {
+        bufferRef->monitorRef = le_fdMonitor_Create("cfgBulkStream",
+                                                    descriptor,
+                                                    OnWritable,
+                                                    POLLOUT);
+        le_fdMonitor_SetContextPtr(bufferRef->monitorRef, bufferRef);
+        return;
+    }
+
+    FinishSend(bufferRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Close a file descriptor that was handed over by a client, retrying if interrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_CloseFd
+(
+    int descriptor  ///< [IN] The file to close.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int retVal;
+
+    do
+    {
+        retVal = close(descriptor);
+    }
+    while ((retVal == -1) && (errno == EINTR));
+
+    LE_ERROR_IF(retVal == -1, "An error occurred while closing a bulk stream: %m");
+}
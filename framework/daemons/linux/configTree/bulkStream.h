@@ -0,0 +1,239 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file bulkStream.h
+ *
+ *  Record streams used by the bulk get and set calls of the config API.
+ *
+ *  Rather than making one IPC call per value, a client of the bulk calls passes the config tree a
+ *  file descriptor, and the values are sent or received through it as a stream of records.  Each
+ *  record is three null terminated strings: a path relative to the base path of the call, the name
+ *  of the node's type, and the node's value.  The type names are "empty", "string", "bool", "int",
+ *  "float", "stem" and "doesntExist".  Bool values are "true" or "false".
+ *
+ *  Streams are built up or read into a buffer in full before they're acted on, so a bulk get
+ *  always sees a consistent view of the tree, and a bulk set is applied in one commit, or not at
+ *  all.  Buffers are sent in the background, so the config tree never waits on a slow client.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_BULK_STREAM_INCLUDE_GUARD
+#define CFG_BULK_STREAM_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Reference to a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct bs_Buffer* bs_BufferRef_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A record read from a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* pathPtr;     ///< Path to the node, relative to the base path.
+    le_cfg_nodeType_t type;  ///< The node's type.
+    const char* valuePtr;    ///< The node's value, as it appears in the stream.
+
+    union
+    {
+        int32_t asInt;
+        double asFloat;
+        bool asBool;
+    }
+    value;                   ///< The node's value, for int, float and bool records.
+}
+bs_Record_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the bulk stream subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create a new, empty, stream buffer.
+ *
+ *  @return The new buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+bs_BufferRef_t bs_CreateBuffer
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_DeleteBuffer
+(
+    bs_BufferRef_t bufferRef  ///< [IN] The buffer to free.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a record to a stream buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_AddRecord
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    const char* pathPtr,       ///< [IN] Path to the node.
+    le_cfg_nodeType_t type,    ///< [IN] The node's type.
+    const char* valuePtr       ///< [IN] The node's value, NULL for none.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a record for a node to a stream buffer.  Stems get a record of their own, their children
+ *  are not included.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_AddNode
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    const char* pathPtr,       ///< [IN] Path to record for the node.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node, NULL if it doesn't exist.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append records for every leaf and empty node at or under a node to a stream buffer.  The paths
+ *  of the records are relative to the given node, (so a node that isn't a stem gets one record,
+ *  with an empty path.)
+ *
+ *  @return LE_OK if the records were added.
+ *          LE_OVERFLOW if the path to one of the nodes was too long to record.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_AddSubtree
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to append to.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node at the top of the subtree.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a whole stream from a file descriptor into a new buffer.  The stream has to be complete
+ *  when this is called, it is read up to its end without waiting on the writer.
+ *
+ *  @return LE_OK if the stream was read.
+ *          LE_FORMAT_ERROR if the stream wasn't complete, or couldn't be read.
+ *          LE_OVERFLOW if the stream was too large.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_ReadStream
+(
+    int descriptor,               ///< [IN] The file to read.
+    bs_BufferRef_t* bufferRefPtr  ///< [OUT] The stream, if LE_OK is returned.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the next null terminated string from a stream buffer.
+ *
+ *  @return The string, or NULL if the end of the buffer has been reached.  Strings remain valid
+ *          until the buffer is freed.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* bs_NextString
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to read.
+    size_t* offsetPtr          ///< [IN/OUT] Where to read from, start at 0.  Moved past the string.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the next record from a stream buffer.
+ *
+ *  @return LE_OK if a record was read.
+ *          LE_NOT_FOUND if the end of the buffer has been reached.
+ *          LE_FORMAT_ERROR if the record is malformed, or its value doesn't match its type.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bs_NextRecord
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to read.
+    size_t* offsetPtr,         ///< [IN/OUT] Where to read from, start at 0.  Moved past the record.
+    bs_Record_t* recordPtr     ///< [OUT] The record.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Send the contents of a stream buffer to a file descriptor, then close the descriptor and free
+ *  the buffer.  Pipes and sockets are written in the background, as the reader makes room.  If the
+ *  reader goes away before the whole stream is sent, the rest of the stream is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_Send
+(
+    bs_BufferRef_t bufferRef,  ///< [IN] The buffer to send, it is taken over.
+    int descriptor             ///< [IN] The file to write to, it is taken over.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Close a file descriptor that was handed over by a client, retrying if interrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+void bs_CloseFd
+(
+    int descriptor  ///< [IN] The file to close.
+);
+
+
+
+
+#endif
@@ -13,11 +13,16 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "internString.h"
+#include "treeSnapshot.h"
+#include "treeJournal.h"
+#include "treeWriter.h"
 #include "treeDb.h"
 #include "treeUser.h"
+#include "treeStats.h"
 #include "nodeIterator.h"
 #include "treeIterator.h"
+#include "bulkStream.h"
 #include "requestQueue.h"
 #include "internalConfig.h"
 
@@ -82,6 +87,27 @@ static void OnConfigAdminSessionClosed
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called when the config tree is asked to stop.  Waits for the tree files still being written,
+ *  then exits.
+ */
+// -------------------------------------------------------------------------------------------------
+static void OnTerminate
+(
+    int sigNum  ///< [IN] The signal that was received.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tw_FlushAll();
+
+    LE_INFO("Terminated");
+    exit(EXIT_SUCCESS);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Initialize the configTree server interfaces and all of it's subsystems.
@@ -92,7 +118,12 @@ COMPONENT_INIT
     LE_DEBUG("** Config Tree, begin init.");
 
     // Initilize our internal subsystems.
-    dstr_Init();   // Dynamic strings.
+    istr_Init();   // Interned strings.
+    snap_Init();   // Tree snapshots.
+    jrnl_Init();   // Tree journals.
+    tw_Init();     // Tree writer threads.
+    ts_Init();     // Tree stats.
+    bs_Init();     // Bulk streams.
     rq_Init();     // Request queue.
     ni_Init();     // Node iterator.
     ti_Init();     // Tree iterator.
@@ -100,6 +131,14 @@ COMPONENT_INIT
     tdb_Init();    // Tree DB.
     ic_Init();     // Internal config, this depends on other subsystems and so need to go last.
 
+    // Bulk streams are written to pipes handed over by clients.  If a client goes away before
+    // reading its stream, the write should fail, not kill the config tree.
+    le_sig_Block(SIGPIPE);
+
+    // Tree files are written in the background, so make sure they're all written before exiting.
+    le_sig_Block(SIGTERM);
+    le_sig_SetEventHandler(SIGTERM, OnTerminate);
+
     // Register our service handlers on those services so that we can properly free up resources if
     // clients unexpectedly disconnect.
     LE_DEBUG("** Setting up service event handlers.");
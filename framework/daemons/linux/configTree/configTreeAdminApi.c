@@ -16,6 +16,8 @@
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "treeIterator.h"
+#include "bulkStream.h"
+#include "treeStats.h"
 
 
 
@@ -235,6 +237,318 @@ void le_cfgAdmin_ExportTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check if a descriptor refers to a regular file, which can be read, written and mapped without
+ *  ever waiting on the client.
+ *
+ *  @return True if it's a regular file, false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsRegularFile
+(
+    int descriptor  ///< [IN] The descriptor to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    struct stat fileStat;
+
+    return (fstat(descriptor, &fileStat) == 0) && S_ISREG(fileStat.st_mode);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a sub-tree from a file in the given format.
+ *
+ *  @return LE_OK if the sub-tree was read, or an error code as described for ImportTreeStream().
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTree
+(
+    tdb_NodeRef_t nodeRef,             ///< [IN] The node to read the sub-tree into.
+    le_cfgAdmin_TreeFormat_t format,  ///< [IN] The format of the sub-tree.
+    int descriptor                     ///< [IN] The file to read from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    switch (format)
+    {
+        case LE_CFGADMIN_FORMAT_TEXT:
+            return tdb_ReadTreeNode(nodeRef, descriptor) ? LE_OK : LE_FORMAT_ERROR;
+
+        case LE_CFGADMIN_FORMAT_SNAPSHOT:
+            return tdb_ReadTreeSnapshot(nodeRef, descriptor);
+
+        case LE_CFGADMIN_FORMAT_JSON:
+            return tdb_ReadTreeJson(nodeRef, descriptor);
+    }
+
+    return LE_BAD_PARAMETER;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a sub-tree to a file in the given format.
+ *
+ *  @return LE_OK if the sub-tree was written, LE_FAULT if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteTree
+(
+    tdb_NodeRef_t nodeRef,             ///< [IN] The node to write, may be NULL.
+    le_cfgAdmin_TreeFormat_t format,  ///< [IN] The format to write the sub-tree in.
+    int descriptor                     ///< [IN] The file to write to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    switch (format)
+    {
+        case LE_CFGADMIN_FORMAT_TEXT:
+            result = tdb_WriteTreeNode(nodeRef, descriptor);
+            break;
+
+        case LE_CFGADMIN_FORMAT_SNAPSHOT:
+            result = tdb_WriteTreeSnapshot(nodeRef, descriptor);
+            break;
+
+        case LE_CFGADMIN_FORMAT_JSON:
+            result = tdb_WriteTreeJson(nodeRef, descriptor);
+            break;
+
+        default:
+            return LE_BAD_PARAMETER;
+    }
+
+    return (result == LE_OK) ? LE_OK : LE_FAULT;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a sub-tree from a client's stream, and write it over the node at the given nodePath as
+ *  part of the iterator's transaction.  The stream is closed once it has been read.
+ *
+ *  Regular files are read in place.  Anything else, (a pipe for instance,) is first read up to its
+ *  end without waiting on the client, as bulk streams are, into an unlinked temporary file, which
+ *  can then be parsed or mapped like any other.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - The sub-tree was imported.
+ *          - LE_NOT_FOUND     - The node couldn't be created.
+ *          - LE_FAULT         - An I/O error occurred while reading the data.
+ *          - LE_FORMAT_ERROR  - Configuration data being imported appears corrupted.
+ *          - LE_NOT_POSSIBLE  - JSON data conflicts with a value already in the tree.
+ *          - LE_BAD_PARAMETER - No stream, or an unknown format, was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ImportTreeStream
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Write iterator that is being used for the
+                                            ///<      import.
+    int stream,                             ///< [IN] Import the tree data from this stream.
+    const char* nodePathPtr,                ///< [IN] Where in the tree should this import happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+    le_cfgAdmin_TreeFormat_t format         ///< [IN] The format of the tree data.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Importing a tree from stream %d onto node '%s', using iterator, '%p'.",
+             stream, nodePathPtr, externalRef);
+
+    if (stream < 0)
+    {
+        le_cfgAdmin_ImportTreeStreamRespond(commandRef, LE_BAD_PARAMETER);
+        return;
+    }
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (iteratorRef == NULL)
+    {
+        bs_CloseFd(stream);
+        le_cfgAdmin_ImportTreeStreamRespond(commandRef, LE_OK);
+        return;
+    }
+
+    tdb_NodeRef_t nodeRef = ni_TryCreateNode(iteratorRef, nodePathPtr);
+
+    if (nodeRef == NULL)
+    {
+        bs_CloseFd(stream);
+        le_cfgAdmin_ImportTreeStreamRespond(commandRef, LE_NOT_FOUND);
+        return;
+    }
+
+    le_result_t result = LE_OK;
+    FILE* tempFilePtr = NULL;
+    int descriptor = stream;
+
+    if (IsRegularFile(stream) == false)
+    {
+        bs_BufferRef_t bufferRef;
+
+        tempFilePtr = tmpfile();
+        result = bs_ReadStream(stream, &bufferRef);
+
+        if (tempFilePtr == NULL)
+        {
+            LE_ERROR("Could not create a temporary file for the import (%m).");
+
+            if (result == LE_OK)
+            {
+                bs_DeleteBuffer(bufferRef);
+            }
+
+            result = LE_FAULT;
+        }
+        else if (result == LE_OK)
+        {
+            // Writes to a regular file are finished by the time bs_Send() returns.
+            descriptor = fileno(tempFilePtr);
+            bs_Send(bufferRef, dup(descriptor));
+
+            if (lseek(descriptor, 0, SEEK_SET) == -1)
+            {
+                result = LE_FAULT;
+            }
+        }
+        else
+        {
+            result = LE_FORMAT_ERROR;
+        }
+    }
+
+    if (result == LE_OK)
+    {
+        result = ReadTree(nodeRef, format, descriptor);
+    }
+
+    if (tempFilePtr != NULL)
+    {
+        fclose(tempFilePtr);
+    }
+
+    bs_CloseFd(stream);
+    le_cfgAdmin_ImportTreeStreamRespond(commandRef, result);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write the node given by nodePath, and it's children, to a client's stream, then close it.
+ *
+ *  Regular files are written in place.  Anything else is written to an unlinked temporary file
+ *  first, which is then sent in the background, as bulk streams are, so the config tree never
+ *  waits on a slow reader.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - The sub-tree was exported.
+ *          - LE_FAULT         - An I/O error occurred while writing the data.
+ *          - LE_BAD_PARAMETER - No stream, or an unknown format, was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ExportTreeStream
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator that is being used for the export.
+    int stream,                             ///< [IN] Export the tree data to this stream.
+    const char* nodePathPtr,                ///< [IN] Where in the tree should this export happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+    le_cfgAdmin_TreeFormat_t format         ///< [IN] The format to write the tree data in.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Exporting a tree from node '%s' into stream %d, using iterator, '%p'.",
+             nodePathPtr, stream, externalRef);
+
+    if (stream < 0)
+    {
+        le_cfgAdmin_ExportTreeStreamRespond(commandRef, LE_BAD_PARAMETER);
+        return;
+    }
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (iteratorRef == NULL)
+    {
+        bs_CloseFd(stream);
+        le_cfgAdmin_ExportTreeStreamRespond(commandRef, LE_OK);
+        return;
+    }
+
+    tdb_NodeRef_t nodeRef = ni_GetNode(iteratorRef, nodePathPtr);
+    le_result_t result;
+
+    if (IsRegularFile(stream))
+    {
+        result = WriteTree(nodeRef, format, stream);
+        bs_CloseFd(stream);
+    }
+    else
+    {
+        FILE* tempFilePtr = tmpfile();
+        bs_BufferRef_t bufferRef = NULL;
+
+        if (tempFilePtr == NULL)
+        {
+            LE_ERROR("Could not create a temporary file for the export (%m).");
+            result = LE_FAULT;
+        }
+        else
+        {
+            int descriptor = fileno(tempFilePtr);
+
+            result = WriteTree(nodeRef, format, descriptor);
+
+            if (   (result == LE_OK)
+                && (   (lseek(descriptor, 0, SEEK_SET) == -1)
+                    || (bs_ReadStream(descriptor, &bufferRef) != LE_OK)))
+            {
+                result = LE_FAULT;
+            }
+
+            fclose(tempFilePtr);
+        }
+
+        if (result == LE_OK)
+        {
+            bs_Send(bufferRef, stream);
+        }
+        else
+        {
+            bs_CloseFd(stream);
+        }
+    }
+
+    le_cfgAdmin_ExportTreeStreamRespond(commandRef, result);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 //  Tree maintenance.
 // -------------------------------------------------------------------------------------------------
@@ -392,3 +706,67 @@ void le_cfgAdmin_NextTree
 
     le_cfgAdmin_NextTreeRespond(commandRef, result);
 }
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+//  Performance counters.
+// -------------------------------------------------------------------------------------------------
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a report of the config tree's performance counters to the client's stream, then close it.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - The report was written.
+ *          - LE_IO_ERROR      - The report could not be written to the stream.
+ *          - LE_BAD_PARAMETER - No stream was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_DumpStats
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    int stream,                             ///< [IN] Where to write the report.
+    bool asJson                             ///< [IN] Write the report as JSON?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (stream < 0)
+    {
+        le_cfgAdmin_DumpStatsRespond(commandRef, LE_BAD_PARAMETER);
+        return;
+    }
+
+    // The report is only a few lines per tree and per client, so it's written out right away.
+    le_result_t result = ts_WriteReport(stream, asJson);
+
+    bs_CloseFd(stream);
+    le_cfgAdmin_DumpStatsRespond(commandRef, result);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Set all of the config tree's performance counters back to zero.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ResetStats
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef  ///< [IN] Reference used to generate a reply for this
+                                           ///<      request.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ts_Reset();
+    le_cfgAdmin_ResetStatsRespond(commandRef);
+}
@@ -12,12 +12,14 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "internString.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "treePath.h"
 #include "nodeIterator.h"
+#include "bulkStream.h"
 #include "requestQueue.h"
+#include "treeStats.h"
 
 
 
@@ -55,6 +57,8 @@ static void CreateTransaction
     }
     else
     {
+        ts_CountTxn(userRef, treeRef, request == NI_WRITE);
+
         // Try to create the new iterator.  If it can't be created now, it'll be queued for
         // creation later.
         rq_HandleCreateTxnRequest(userRef,
@@ -182,7 +186,8 @@ static size_t MaxStr
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called by the "Quick" functions to get a reference to the tree the user wants.  If the tree
- *  retreival fails for any reason, (as in, permission error,) terminate the client.
+ *  retreival fails for any reason, (as in, permission error,) terminate the client.  Otherwise the
+ *  access is counted as a quick get or set, depending on the permission asked for.
  *
  *  @note If the permission check fails, then terminate client will be called.
  *
@@ -204,6 +209,14 @@ static tdb_TreeRef_t QuickGetTree
         tu_TerminateConfigClient(le_cfg_GetClientSessionRef(),
                                  "The requested configuration tree could not be opened.");
     }
+    else if (permission == TU_TREE_READ)
+    {
+        ts_CountQuickGet(userRef, treeRef);
+    }
+    else
+    {
+        ts_CountQuickSet(userRef, treeRef);
+    }
 
     return treeRef;
 }
@@ -720,6 +733,67 @@ void le_cfg_RemoveChangeHandler
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds a handler that is given a summary of each change, the path to the deepest
+ * node holding all of the changes made.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_ChangeSummaryHandlerRef_t le_cfg_AddChangeSummaryHandler
+(
+    const char* newPathPtr,                        ///< [IN] Path to the object to watch.
+    le_cfg_ChangeSummaryHandlerFunc_t handlerPtr,  ///< [IN] Function to call back.
+    void* contextPtr                               ///< [IN] Context to give the function when
+                                                   ///<      called.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tu_UserRef_t userRef = tu_GetCurrentConfigUserInfo();
+    le_cfg_ChangeSummaryHandlerRef_t handlerRef = NULL;
+
+    if (userRef != NULL)
+    {
+        tdb_TreeRef_t treeRef = tu_GetRequestedTree(userRef, TU_TREE_READ, newPathPtr);
+
+        if (treeRef != NULL)
+        {
+            handlerRef = tdb_AddChangeSummaryHandler(treeRef,
+                                                     le_cfg_GetClientSessionRef(),
+                                                     newPathPtr,
+                                                     handlerPtr,
+                                                     contextPtr);
+        }
+    }
+
+    if (handlerRef == NULL)
+    {
+        tu_TerminateConfigClient(le_cfg_GetClientSessionRef(),
+                                 "Change handler registration failed.");
+    }
+
+    return handlerRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function removes a change summary handler.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_RemoveChangeSummaryHandler
+(
+    le_cfg_ChangeSummaryHandlerRef_t handlerRef  ///< [IN] Previously registered handler to remove.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_RemoveChangeHandler((le_cfg_ChangeHandlerRef_t)handlerRef, le_cfg_GetClientSessionRef());
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 //  Transactional reading/writing, creation/deletion.
 // -------------------------------------------------------------------------------------------------
@@ -1551,3 +1625,237 @@ void le_cfg_QuickSetBool
                               value);
     }
 }
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read every value at or under a node in the configuration tree, and send them to the client's
+ *  stream as a list of records.  The stream is sent after the response, and closed once all the
+ *  records have been written.
+ *
+ *  \b Responds \b With:
+ *
+ *  This function will respond with one of the following values:
+ *
+ *          - LE_OK            - The records are on their way.
+ *          - LE_NOT_FOUND     - The node doesn't exist.
+ *          - LE_OVERFLOW      - A path under the node is too long to be sent.
+ *          - LE_BAD_PARAMETER - No stream was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfg_QuickGetSubtree
+(
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                       ///<      request.
+    const char* pathPtr,               ///< [IN] Path to the node to read.
+    int stream                         ///< [IN] Where to write the records.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Quick get subtree at \"%s\".", pathPtr);
+
+    if (stream < 0)
+    {
+        le_cfg_QuickGetSubtreeRespond(commandRef, LE_BAD_PARAMETER);
+        return;
+    }
+
+    tu_UserRef_t userRef = tu_GetCurrentConfigUserInfo();
+    tdb_TreeRef_t treeRef = QuickGetTree(userRef, TU_TREE_READ, pathPtr);
+
+    if (treeRef != NULL)
+    {
+        rq_HandleQuickGetSubtree(le_cfg_GetClientSessionRef(),
+                                 commandRef,
+                                 userRef,
+                                 treeRef,
+                                 tp_GetPathOnly(pathPtr),
+                                 stream);
+    }
+    else
+    {
+        bs_CloseFd(stream);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a list of values from the configuration tree, and send them to the client's stream as a
+ *  list of records, one per requested path, in the order they were asked for.  The stream is sent
+ *  after the response, and closed once all the records have been written.
+ *
+ *  \b Responds \b With:
+ *
+ *  This function will respond with one of the following values:
+ *
+ *          - LE_OK            - The records are on their way.
+ *          - LE_FORMAT_ERROR  - The list of paths was incomplete or malformed.
+ *          - LE_OVERFLOW      - The list of paths was too large.
+ *          - LE_BAD_PARAMETER - No stream was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfg_QuickGetList
+(
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                       ///<      request.
+    const char* basePathPtr,           ///< [IN] Path the listed paths are relative to.
+    int requestStream,                 ///< [IN] The list of paths to read.
+    int stream                         ///< [IN] Where to write the records.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Quick get list at \"%s\".", basePathPtr);
+
+    le_result_t result = LE_BAD_PARAMETER;
+    bs_BufferRef_t requestRef = NULL;
+
+    if (requestStream >= 0)
+    {
+        result = bs_ReadStream(requestStream, &requestRef);
+        bs_CloseFd(requestStream);
+    }
+
+    if ((result == LE_OK) && (stream < 0))
+    {
+        result = LE_BAD_PARAMETER;
+        bs_DeleteBuffer(requestRef);
+    }
+
+    if (result == LE_OK)
+    {
+        size_t offset = 0;
+        const char* pathPtr;
+
+        while ((pathPtr = bs_NextString(requestRef, &offset)) != NULL)
+        {
+            if (   (strlen(pathPtr) > LE_CFG_STR_LEN)
+                || (tp_PathHasTreeSpecifier(pathPtr)))
+            {
+                result = LE_FORMAT_ERROR;
+                bs_DeleteBuffer(requestRef);
+                break;
+            }
+        }
+    }
+
+    if (result != LE_OK)
+    {
+        le_cfg_QuickGetListRespond(commandRef, result);
+
+        if (stream >= 0)
+        {
+            bs_CloseFd(stream);
+        }
+
+        return;
+    }
+
+    tu_UserRef_t userRef = tu_GetCurrentConfigUserInfo();
+    tdb_TreeRef_t treeRef = QuickGetTree(userRef, TU_TREE_READ, basePathPtr);
+
+    if (treeRef != NULL)
+    {
+        rq_HandleQuickGetList(le_cfg_GetClientSessionRef(),
+                              commandRef,
+                              userRef,
+                              treeRef,
+                              tp_GetPathOnly(basePathPtr),
+                              requestRef,
+                              stream);
+    }
+    else
+    {
+        bs_DeleteBuffer(requestRef);
+        bs_CloseFd(stream);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a list of records, read from the client's stream, to the configuration tree.  All of the
+ *  records are checked before any are written, and they are all written in one commit.
+ *
+ *  \b Responds \b With:
+ *
+ *  This function will respond with one of the following values:
+ *
+ *          - LE_OK            - The records were written.
+ *          - LE_FORMAT_ERROR  - The stream was incomplete, or one of the records was malformed.
+ *                               Nothing was written.
+ *          - LE_OVERFLOW      - The stream was too large.  Nothing was written.
+ *          - LE_BAD_PARAMETER - No stream was given.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfg_QuickSetList
+(
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                       ///<      request.
+    const char* basePathPtr,           ///< [IN] Path the records' paths are relative to.
+    int stream                         ///< [IN] The records to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Quick set list at \"%s\".", basePathPtr);
+
+    le_result_t result = LE_BAD_PARAMETER;
+    bs_BufferRef_t bufferRef = NULL;
+
+    if (stream >= 0)
+    {
+        result = bs_ReadStream(stream, &bufferRef);
+        bs_CloseFd(stream);
+    }
+
+    if (result == LE_OK)
+    {
+        size_t offset = 0;
+        bs_Record_t record;
+
+        // Check every record up front, so a bad one doesn't leave the list half written.
+        do
+        {
+            result = bs_NextRecord(bufferRef, &offset, &record);
+        }
+        while (result == LE_OK);
+
+        if (result == LE_NOT_FOUND)
+        {
+            result = LE_OK;
+        }
+        else
+        {
+            bs_DeleteBuffer(bufferRef);
+        }
+    }
+
+    if (result != LE_OK)
+    {
+        le_cfg_QuickSetListRespond(commandRef, result);
+        return;
+    }
+
+    tu_UserRef_t userRef = tu_GetCurrentConfigUserInfo();
+    tdb_TreeRef_t treeRef = QuickGetTree(userRef, TU_TREE_WRITE, basePathPtr);
+
+    if (treeRef != NULL)
+    {
+        rq_HandleQuickSetList(le_cfg_GetClientSessionRef(),
+                              commandRef,
+                              userRef,
+                              treeRef,
+                              tp_GetPathOnly(basePathPtr),
+                              bufferRef);
+    }
+    else
+    {
+        bs_DeleteBuffer(bufferRef);
+    }
+}
@@ -0,0 +1,342 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file internString.c
+ *
+ *  A table of interned, reference counted strings.  The strings are kept in a hash map keyed by
+ *  their text, and their blocks come from one of a few pools, picked by the length of the text.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "internString.h"
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  An interned string.  The text follows the header in the same block.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct istr_String
+{
+    size_t hash;          ///< Hash of the text.
+    uint32_t refCount;    ///< Number of references held to the string.
+    uint32_t length;      ///< Length of the text in bytes, excluding the terminating NULL.
+    char text[];          ///< The null terminated text.
+}
+String_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The size classes of the string blocks, as the number of bytes of text (including the
+ *  terminating NULL) they can hold.  Strings that are too big for the largest class are allocated
+ *  from the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t ClassTextBytes[] = { 16, 48, LE_CFG_NAME_LEN_BYTES, LE_CFG_STR_LEN_BYTES };
+
+
+
+
+/// Number of size classes.
+#define NUM_CLASSES NUM_ARRAY_MEMBERS(ClassTextBytes)
+
+
+
+
+/// Name of the pool of each size class.
+static const char* ClassPoolNames[NUM_CLASSES] =
+{
+    "internStringPool16",
+    "internStringPool48",
+    "internStringPoolName",
+    "internStringPoolValue"
+};
+
+
+
+
+/// Number of blocks each pool is filled with at start-up.  Most names and values are short.
+static const size_t ClassPoolSizes[NUM_CLASSES] = { 1500, 500, 50, 10 };
+
+
+
+
+/// The pools of the string blocks, in the same order as ClassTextBytes.
+static le_mem_PoolRef_t ClassPools[NUM_CLASSES];
+
+
+
+
+/// Map of the interned strings, keyed by their text.
+static le_hashmap_Ref_t StringMapRef = NULL;
+
+
+
+
+/// Initial capacity of the string map.
+#define STRING_MAP_SIZE 1000
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Work out the size class of a string.
+ *
+ *  @return The index of the class, or NUM_CLASSES if the string has to come from the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetClass
+(
+    size_t length  ///< [IN] Length of the text in bytes, excluding the terminating NULL.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i < NUM_CLASSES; i++)
+    {
+        if (length < ClassTextBytes[i])
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the interned string API and the internal memory resources it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Interned String subsystem.");
+
+    size_t i;
+
+    for (i = 0; i < NUM_CLASSES; i++)
+    {
+        ClassPools[i] = le_mem_CreatePool(ClassPoolNames[i], sizeof(String_t) + ClassTextBytes[i]);
+        le_mem_SetNumObjsToForce(ClassPools[i], 50);    // Grow in chunks of 50 blocks.
+        le_mem_ExpandPool(ClassPools[i], ClassPoolSizes[i]);
+    }
+
+    StringMapRef = le_hashmap_CreateCompact("internStringMap",
+                                            STRING_MAP_SIZE,
+                                            le_hashmap_HashString,
+                                            le_hashmap_EqualsString);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a reference to the interned copy of a C-String, interning it if it isn't already.
+ *
+ *  @return The interned string.  The caller owns a reference to it, and must release it with
+ *          istr_Release() when done with it.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Get
+(
+    const char* textPtr  ///< [IN] The C-String to intern.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(textPtr != NULL);
+
+    istr_Ref_t strRef = le_hashmap_Get(StringMapRef, textPtr);
+
+    if (strRef != NULL)
+    {
+        return istr_AddRef(strRef);
+    }
+
+    size_t length = strlen(textPtr);
+    size_t class = GetClass(length);
+
+    LE_FATAL_IF(length > UINT32_MAX, "String of %zu bytes is too long to intern.", length);
+
+    if (class < NUM_CLASSES)
+    {
+        strRef = le_mem_ForceAlloc(ClassPools[class]);
+    }
+    else
+    {
+        strRef = malloc(sizeof(String_t) + length + 1);
+        LE_ASSERT(strRef != NULL);
+    }
+
+    strRef->hash = le_hashmap_HashString(textPtr);
+    strRef->refCount = 1;
+    strRef->length = length;
+    memcpy(strRef->text, textPtr, length + 1);
+
+    le_hashmap_Put(StringMapRef, strRef->text, strRef);
+
+    return strRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look for the interned copy of a C-String, without adding a reference to it.
+ *
+ *  @return The interned string, or NULL if the string isn't interned (and so can't be the name or
+ *          value of any node).
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Find
+(
+    const char* textPtr  ///< [IN] The C-String to look for.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return le_hashmap_Get(StringMapRef, textPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a reference to an interned string.
+ *
+ *  @return The same string, for convenience.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_AddRef
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+    LE_FATAL_IF(strRef->refCount == UINT32_MAX, "Too many references to interned string.");
+
+    strRef->refCount++;
+
+    return strRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to an interned string.  The string is freed once the last reference to it
+ *  is released.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Release
+(
+    istr_Ref_t strRef  ///< [IN] The string to release.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+    LE_FATAL_IF(strRef->refCount == 0, "Releasing an interned string that has no references.");
+
+    strRef->refCount--;
+
+    if (strRef->refCount > 0)
+    {
+        return;
+    }
+
+    le_hashmap_Remove(StringMapRef, strRef->text);
+
+    if (GetClass(strRef->length) < NUM_CLASSES)
+    {
+        le_mem_Release(strRef);
+    }
+    else
+    {
+        free(strRef);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the text of an interned string.
+ *
+ *  @return A pointer to the null terminated text.  It stays valid as long as the caller holds a
+ *          reference to the string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* istr_GetText
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    return strRef->text;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the length of an interned string, in bytes.
+ *
+ *  @return The length of the string in bytes, excluding the terminating NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetLength
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    return strRef->length;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the hash of an interned string.  This is the same as le_hashmap_HashString() would give for
+ *  its text.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetHash
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    return strRef->hash;
+}
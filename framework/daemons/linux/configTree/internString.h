@@ -0,0 +1,155 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file internString.h
+ *
+ *  A table of interned, reference counted strings, used for the names of the config tree nodes and
+ *  for those of their values that are too long to be kept in the node itself.
+ *
+ *  Each distinct string is only kept once, so the many nodes that share a name (or a value, like
+ *  "true" or "0") share its memory, and two interned strings are equal if and only if their
+ *  references are equal.  The text of a string is kept in one contiguous block along with its
+ *  length and its hash, which are worked out when the string is interned.  Short strings are kept
+ *  in small blocks, so they take little more memory than the pointer that refers to them.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_INTERN_STRING_INCLUDE_GUARD
+#define CFG_INTERN_STRING_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The interned string object pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct istr_String* istr_Ref_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the interned string API and the internal memory resources it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a reference to the interned copy of a C-String, interning it if it isn't already.
+ *
+ *  @return The interned string.  The caller owns a reference to it, and must release it with
+ *          istr_Release() when done with it.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Get
+(
+    const char* textPtr  ///< [IN] The C-String to intern.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look for the interned copy of a C-String, without adding a reference to it.
+ *
+ *  @return The interned string, or NULL if the string isn't interned (and so can't be the name of
+ *          any node).
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Find
+(
+    const char* textPtr  ///< [IN] The C-String to look for.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a reference to an interned string.
+ *
+ *  @return The same string, for convenience.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_AddRef
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to an interned string.  The string is freed once the last reference to it
+ *  is released.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Release
+(
+    istr_Ref_t strRef  ///< [IN] The string to release.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the text of an interned string.
+ *
+ *  @return A pointer to the null terminated text.  It stays valid as long as the caller holds a
+ *          reference to the string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* istr_GetText
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the length of an interned string, in bytes.
+ *
+ *  @return The length of the string in bytes, excluding the terminating NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetLength
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the hash of an interned string.  This is the same as le_hashmap_HashString() would give for
+ *  its text.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetHash
+(
+    istr_Ref_t strRef  ///< [IN] The string to read.
+);
+
+
+
+
+#endif
@@ -109,6 +109,9 @@
 /// Cached value for the transaction timeout.
 static time_t TransactionTimeout = 0;
 
+/// Cached value for the change notification delay, in milliseconds.
+static uint32_t NotificationDelay = 0;
+
 
 /// Path to the configTree's global configuration.
 #define GLOBAL_CONFIG_PATH "/configTree"
@@ -135,6 +138,10 @@ static void OnGlobalConfigChanged
                                                      GLOBAL_CONFIG_PATH);
 
     TransactionTimeout = ni_GetNodeValueInt(iteratorRef, "transactionTimeout", 30);
+
+    int32_t delay = ni_GetNodeValueInt(iteratorRef, "notificationDelay", 0);
+    NotificationDelay = (delay > 0) ? (uint32_t)delay : 0;
+
     ni_Release(iteratorRef);
 }
 
@@ -312,3 +319,23 @@ time_t ic_GetTransactionTimeout
 {
     return TransactionTimeout;
 }
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the current change notification delay from the configtree's internal data.  Changes
+ *  committed within this delay of each other are reported to change handlers together.
+ *
+ *  @return The delay in milliseconds, 0 if changes are reported as soon as they're committed.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t ic_GetNotificationDelay
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return NotificationDelay;
+}
@@ -63,4 +63,20 @@ time_t ic_GetTransactionTimeout
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the current change notification delay from the configtree's internal data.  Changes
+ *  committed within this delay of each other are reported to change handlers together.
+ *
+ *  @return The delay in milliseconds, 0 if changes are reported as soon as they're committed.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t ic_GetNotificationDelay
+(
+    void
+);
+
+
+
+
 #endif
@@ -16,6 +16,7 @@
 #include "treeUser.h"
 #include "internalConfig.h"
 #include "nodeIterator.h"
+#include "treeStats.h"
 
 
 
@@ -378,7 +379,8 @@ ni_IteratorRef_t ni_InternalRefFromExternalRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Commit the changes introduced by an iterator to the config tree.
+ *  Commit the changes introduced by an iterator to the config tree.  The time the commit takes is
+ *  counted in the tree stats.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_Commit
@@ -389,7 +391,13 @@ void ni_Commit
 {
     if (iteratorRef->type == NI_WRITE)
     {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
         tdb_MergeTree(iteratorRef->treeRef);
+
+        ts_CountCommit(iteratorRef->userRef,
+                       iteratorRef->treeRef,
+                       le_clk_Sub(le_clk_GetRelativeTime(), startTime));
     }
 }
 
@@ -575,6 +583,29 @@ tdb_TreeRef_t ni_GetTree
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Move a read iterator from the tree it's on to a version of that tree, (see treeDb.c.)  The
+ *  iterator stays on the same node.  The iterator takes over the caller's reference to the version.
+ */
+//--------------------------------------------------------------------------------------------------
+void ni_MoveToVersion
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator to move.
+    tdb_TreeRef_t versionRef       ///< [IN] The version to move it to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(iteratorRef != NULL);
+    LE_ASSERT(iteratorRef->type == NI_READ);
+
+    iteratorRef->currentNodeRef = tdb_GetVersionNode(versionRef, iteratorRef->currentNodeRef);
+    iteratorRef->treeRef = versionRef;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  This function will find all iterators that have active safe refs.  For each found
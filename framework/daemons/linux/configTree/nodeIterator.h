@@ -236,6 +236,21 @@ tdb_TreeRef_t ni_GetTree
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Move a read iterator from the tree it's on to a version of that tree, (see treeDb.c.)  The
+ *  iterator stays on the same node.  The iterator takes over the caller's reference to the version.
+ */
+//--------------------------------------------------------------------------------------------------
+void ni_MoveToVersion
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator to move.
+    tdb_TreeRef_t versionRef       ///< [IN] The version to move it to.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  This function will find all iterators that have active safe refs.  For each found
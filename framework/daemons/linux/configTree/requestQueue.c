@@ -20,7 +20,9 @@
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
+#include "bulkStream.h"
 #include "requestQueue.h"
+#include "treeStats.h"
 
 
 
@@ -43,7 +45,6 @@ typedef enum
     RQ_INVALID,
 
     RQ_CREATE_WRITE_TXN,
-    RQ_COMMIT_WRITE_TXN,
     RQ_CREATE_READ_TXN,
     RQ_DELETE_TXN,
 
@@ -52,7 +53,8 @@ typedef enum
     RQ_SET_STRING,
     RQ_SET_INT,
     RQ_SET_FLOAT,
-    RQ_SET_BOOL
+    RQ_SET_BOOL,
+    RQ_SET_LIST
 }
 RequestType_t;
 
@@ -76,6 +78,8 @@ typedef struct UpdateRequest
                                                  ///<   in on.
     le_cfg_ServerCmdRef_t commandRef;            ///< Message context for the request.
 
+    le_clk_Time_t queuedTime;                    ///< When the request was put on the tree's queue.
+
     union
     {
         struct
@@ -84,12 +88,6 @@ typedef struct UpdateRequest
         }
         createTxn;                               ///< Create new transaction info.
 
-        struct
-        {
-            ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
-        }
-        commitTxn;
-
         struct
         {
             ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
@@ -110,6 +108,13 @@ typedef struct UpdateRequest
             value;
         }
         writeReq;
+
+        struct
+        {
+            char pathPtr[LE_CFG_STR_LEN_BYTES];  ///< Path the records are relative to.
+            bs_BufferRef_t bufferRef;            ///< The records to write.
+        }
+        setList;
     }
     data;
 
@@ -202,6 +207,14 @@ static void QueueRequest
 // -------------------------------------------------------------------------------------------------
 {
     LE_DEBUG("** Queuing request block <%p>.", requestPtr);
+
+    // Requests deferred on a tree's queue are counted, internal clean up lists aren't.
+    if (listPtr == tdb_GetRequestQueue(requestPtr->treeRef))
+    {
+        requestPtr->queuedTime = le_clk_GetRelativeTime();
+        ts_CountQueued(requestPtr->userRef, requestPtr->treeRef);
+    }
+
     le_sls_Queue(listPtr, &(requestPtr->link));
 }
 
@@ -299,6 +312,13 @@ static void ProcessRequestQueue
     {
         UpdateRequest_t* requestPtr = CONTAINER_OF(linkPtr, UpdateRequest_t, link);
 
+        if (listPtr == tdb_GetRequestQueue(requestPtr->treeRef))
+        {
+            ts_CountDequeued(requestPtr->userRef,
+                             requestPtr->treeRef,
+                             le_clk_Sub(le_clk_GetRelativeTime(), requestPtr->queuedTime));
+        }
+
         // If this request belongs to a session that's been closed,
         if (   (ignoreSessionRef != NULL)
             && (requestPtr->sessionRef == ignoreSessionRef))
@@ -308,6 +328,11 @@ static void ProcessRequestQueue
                      tu_GetUserId(requestPtr->userRef),
                      tu_GetUserName(requestPtr->userRef),
                      tdb_GetTreeName(requestPtr->treeRef));
+
+            if (requestPtr->type == RQ_SET_LIST)
+            {
+                bs_DeleteBuffer(requestPtr->data.setList.bufferRef);
+            }
         }
         else
         {
@@ -329,16 +354,6 @@ static void ProcessRequestQueue
                                               requestPtr->data.createTxn.pathPtr);
                     break;
 
-                case RQ_COMMIT_WRITE_TXN:
-                    LE_DEBUG("Committing deferred write txn for user %u (%s) on tree '%s'.",
-                             tu_GetUserId(requestPtr->userRef),
-                             tu_GetUserName(requestPtr->userRef),
-                             tdb_GetTreeName(requestPtr->treeRef));
-
-                    rq_HandleCommitTxnRequest(requestPtr->commandRef,
-                                              requestPtr->data.commitTxn.iteratorRef);
-                    break;
-
                case RQ_CREATE_READ_TXN:
                     LE_DEBUG("Starting deferred read txn for user %u (%s) on tree '%s'.",
                              tu_GetUserId(requestPtr->userRef),
@@ -445,6 +460,20 @@ static void ProcessRequestQueue
                                           requestPtr->data.writeReq.value.AsBool);
                     break;
 
+                case RQ_SET_LIST:
+                    LE_DEBUG("Processing deferred quick 'set list' for user %u (%s) on tree '%s'.",
+                             tu_GetUserId(requestPtr->userRef),
+                             tu_GetUserName(requestPtr->userRef),
+                             tdb_GetTreeName(requestPtr->treeRef));
+
+                    rq_HandleQuickSetList(requestPtr->sessionRef,
+                                          requestPtr->commandRef,
+                                          requestPtr->userRef,
+                                          requestPtr->treeRef,
+                                          requestPtr->data.setList.pathPtr,
+                                          requestPtr->data.setList.bufferRef);
+                    break;
+
                 case RQ_INVALID:
                     LE_FATAL("Invalid request block used.");
             }
@@ -471,14 +500,9 @@ static bool CanQuickSet
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If there are active readers or writers on the tree then a quick write should be defered.
-    if (   (tdb_HasActiveReaders(treeRef) == false)
-        && (tdb_GetActiveWriteIter(treeRef) == NULL))
-    {
-        return true;
-    }
-
-    return false;
+    // If there is an active writer on the tree then a quick write should be defered.  Readers don't
+    // matter, as they're moved onto a version of the tree when the write is committed.
+    return tdb_GetActiveWriteIter(treeRef) == NULL;
 }
 
 
@@ -631,8 +655,10 @@ void rq_HandleCommitTxnRequest
         le_cfg_CommitTxnRespond(commandRef);
         ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
     }
-    else if (tdb_HasActiveReaders(ni_GetTree(iteratorRef)) == false)
+    else
     {
+        // Any readers on the tree are moved onto a version of it by the commit, so there's no
+        // need to wait for them to finish.
         ni_Close(iteratorRef);
         ni_Commit(iteratorRef);
         ni_Release(iteratorRef);
@@ -640,17 +666,6 @@ void rq_HandleCommitTxnRequest
         le_cfg_CommitTxnRespond(commandRef);
         ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
     }
-    else
-    {
-        UpdateRequest_t* requestPtr = NewRequestBlock(RQ_COMMIT_WRITE_TXN,
-                                                      ni_GetUser(iteratorRef),
-                                                      ni_GetTree(iteratorRef),
-                                                      ni_GetSession(iteratorRef),
-                                                      commandRef);
-
-        requestPtr->data.commitTxn.iteratorRef = iteratorRef;
-        QueueRequest(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), requestPtr);
-    }
 }
 
 
@@ -1133,3 +1148,192 @@ void rq_HandleQuickSetBool
         le_cfg_QuickSetBoolRespond(commandRef);
     }
 }
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Send every value at or under a node to a client's stream, in one go.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickGetSubtree
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* pathPtr,               ///< [IN] The path to the node to access.
+    int streamFd                       ///< [IN] Where to send the values, it is taken over.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = ni_CreateIterator(sessionRef,
+                                                     userRef,
+                                                     treeRef,
+                                                     NI_READ,
+                                                     pathPtr);
+
+    tdb_NodeRef_t nodeRef = ni_GetNode(iteratorRef, NULL);
+    le_result_t result = LE_NOT_FOUND;
+
+    if (nodeRef != NULL)
+    {
+        // The whole subtree is gathered up before anything is sent, so the client sees it as it
+        // was at this moment, no matter how slowly it reads.
+        bs_BufferRef_t bufferRef = bs_CreateBuffer();
+
+        result = bs_AddSubtree(bufferRef, nodeRef);
+
+        if (result == LE_OK)
+        {
+            le_cfg_QuickGetSubtreeRespond(commandRef, result);
+            bs_Send(bufferRef, streamFd);
+        }
+        else
+        {
+            bs_DeleteBuffer(bufferRef);
+        }
+    }
+
+    if (result != LE_OK)
+    {
+        le_cfg_QuickGetSubtreeRespond(commandRef, result);
+        bs_CloseFd(streamFd);
+    }
+
+    ni_Release(iteratorRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Send the values of a list of nodes to a client's stream, in one go.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickGetList
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* basePathPtr,           ///< [IN] The path the listed paths are relative to.
+    bs_BufferRef_t requestRef,         ///< [IN] The list of paths, it is taken over.
+    int streamFd                       ///< [IN] Where to send the values, it is taken over.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = ni_CreateIterator(sessionRef,
+                                                     userRef,
+                                                     treeRef,
+                                                     NI_READ,
+                                                     basePathPtr);
+
+    bs_BufferRef_t bufferRef = bs_CreateBuffer();
+    size_t offset = 0;
+    const char* pathPtr;
+
+    while ((pathPtr = bs_NextString(requestRef, &offset)) != NULL)
+    {
+        bs_AddNode(bufferRef, pathPtr, ni_GetNode(iteratorRef, pathPtr));
+    }
+
+    ni_Release(iteratorRef);
+    bs_DeleteBuffer(requestRef);
+
+    le_cfg_QuickGetListRespond(commandRef, LE_OK);
+    bs_Send(bufferRef, streamFd);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a list of values to the configTree, all in one commit.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickSetList
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* basePathPtr,           ///< [IN] The path the records' paths are relative to.
+    bs_BufferRef_t bufferRef           ///< [IN] The records to write, already checked.  It is taken
+                                       ///<      over.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CanQuickSet(treeRef) == false)
+    {
+        UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_LIST,
+                                                      userRef,
+                                                      treeRef,
+                                                      sessionRef,
+                                                      commandRef);
+
+        LE_ASSERT(le_utf8_Copy(requestPtr->data.setList.pathPtr,
+                               basePathPtr,
+                               sizeof(requestPtr->data.setList.pathPtr),
+                               NULL) == LE_OK);
+
+        requestPtr->data.setList.bufferRef = bufferRef;
+
+        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+    }
+    else
+    {
+        ni_IteratorRef_t iteratorRef = ni_CreateIterator(sessionRef,
+                                                         userRef,
+                                                         treeRef,
+                                                         NI_WRITE,
+                                                         basePathPtr);
+        size_t offset = 0;
+        bs_Record_t record;
+
+        while (bs_NextRecord(bufferRef, &offset, &record) == LE_OK)
+        {
+            switch (record.type)
+            {
+                case LE_CFG_TYPE_EMPTY:
+                    ni_SetEmpty(iteratorRef, record.pathPtr);
+                    break;
+
+                case LE_CFG_TYPE_STRING:
+                    ni_SetNodeValueString(iteratorRef, record.pathPtr, record.valuePtr);
+                    break;
+
+                case LE_CFG_TYPE_BOOL:
+                    ni_SetNodeValueBool(iteratorRef, record.pathPtr, record.value.asBool);
+                    break;
+
+                case LE_CFG_TYPE_INT:
+                    ni_SetNodeValueInt(iteratorRef, record.pathPtr, record.value.asInt);
+                    break;
+
+                case LE_CFG_TYPE_FLOAT:
+                    ni_SetNodeValueFloat(iteratorRef, record.pathPtr, record.value.asFloat);
+                    break;
+
+                case LE_CFG_TYPE_DOESNT_EXIST:
+                    ni_DeleteNode(iteratorRef, record.pathPtr);
+                    break;
+
+                case LE_CFG_TYPE_STEM:
+                    LE_FATAL("Unchecked stem record in bulk set.");
+            }
+        }
+
+        ni_Commit(iteratorRef);
+        ni_Release(iteratorRef);
+        bs_DeleteBuffer(bufferRef);
+
+        le_cfg_QuickSetListRespond(commandRef, LE_OK);
+    }
+}
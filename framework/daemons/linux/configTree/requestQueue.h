@@ -281,4 +281,63 @@ void rq_HandleQuickSetBool
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Send every value at or under a node to a client's stream, in one go.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickGetSubtree
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* pathPtr,               ///< [IN] The path to the node to access.
+    int streamFd                       ///< [IN] Where to send the values, it is taken over.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Send the values of a list of nodes to a client's stream, in one go.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickGetList
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* basePathPtr,           ///< [IN] The path the listed paths are relative to.
+    bs_BufferRef_t requestRef,         ///< [IN] The list of paths, it is taken over.
+    int streamFd                       ///< [IN] Where to send the values, it is taken over.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a list of values to the configTree, all in one commit.
+ */
+// -------------------------------------------------------------------------------------------------
+void rq_HandleQuickSetList
+(
+    le_msg_SessionRef_t sessionRef,    ///< [IN] The session this request occured on.
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] This handle is used to generate the reply for this
+                                       ///<      message.
+    tu_UserRef_t userRef,              ///< [IN] The user that's requesting the action.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree that we're peforming the action on.
+    const char* basePathPtr,           ///< [IN] The path the records' paths are relative to.
+    bs_BufferRef_t bufferRef           ///< [IN] The records to write, already checked.  It is taken
+                                       ///<      over.
+);
+
+
+
+
 #endif
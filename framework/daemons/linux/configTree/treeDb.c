@@ -42,9 +42,9 @@
  *  incremented.  When it ends, the count is decremented.
  *
  *  When client requests are received that cannot be processed immediately, because of the state
- *  of the tree the request is for (e.g., if a write transaction commit request is received while
- *  there are read transactions in progress on the tree), then the request is queued onto the tree's
- *  Request Queue.
+ *  of the tree the request is for (e.g., if a write transaction is requested while another write
+ *  transaction is in progress on the tree), then the request is queued onto the tree's Request
+ *  Queue.
  *
  *  <b>Shadow Trees:</b>
  *
@@ -68,6 +68,18 @@
  *  Shadow Trees don't have handlers, request queues, write iterator references or read iterator
  *  counts.
  *
+ *  <b>Versions:</b>
+ *
+ *  Read transactions don't hold up commits.  Read iterators work on the original tree directly,
+ *  until a commit is about to be merged into it.  Then every read iterator still on the tree is
+ *  moved onto a "version" of the tree, which is a shadow tree that nobody writes to.  The version
+ *  shows the tree as it was before the merge, as every original node the merge is about to change
+ *  is first copied into any version shadowing it.  That is, the version's shadow node for the
+ *  original takes its own copy of the name, value and list of children, and stops looking at the
+ *  original.  The nodes of a version also hold references to the originals they shadow, so nodes
+ *  deleted from the original tree stay around until the readers are done with them.  A version
+ *  goes away once the last read iterator on it has been released.
+ *
  *  <b>Event Handler Registration:</b>
  *
  *  The config tree allows clients to register callbacks to be notified if certian sections of a
@@ -114,12 +126,36 @@
  *  handler can quickly and easily remove a handler as required.
  *
  *  When a merge occurs each modified node path is checked against the registration map.  If there
- *  is a registration object for that node each of the registered handlers is invoked.
+ *  is a registration object for that node it is marked as triggered, and queued on the triggered
+ *  list.  Once the merge is done, the handlers of each triggered registration are invoked, so a
+ *  handler is only called once per commit, no matter how many nodes under it changed.  If a
+ *  notification delay is configured, the handlers aren't invoked until the delay has passed since
+ *  the first commit that triggered them, so a burst of commits only gets one notification.
+ *
+ *  Each triggered registration also keeps a summary of what changed under it: the path to the
+ *  deepest node that holds every change, (which is the registration's own node if it changed
+ *  itself, or if changes were made under more than one of its children.)  This is passed to the
+ *  handlers that asked for it, so they can re-read just that part of the tree.
  *
  *  Handlers are registered in this hash map so that the target node doesn't need to actually exist
  *  in order to have a handler registed for it.  In fact, a handler will be called when a node is
  *  deleted and when it is recreated.
  *
+ *  <b>Tree Files:</b>
+ *
+ *  Trees are saved in the filesystem as binary snapshots, (see treeSnapshot.h.)  When a tree is
+ *  loaded its snapshot is memory mapped and only the root node is created.  The children of a stem
+ *  are created from the snapshot the first time anything looks at them, so parts of a tree that
+ *  are never used are never loaded.  When a tree is saved, stems whose children were never loaded
+ *  are copied straight from the old snapshot into the new one.  Tree files in the older text format
+ *  can still be loaded, and the text format is still used to import and export trees.
+ *
+ *  Committing a write transaction doesn't save the whole tree.  Instead, as the shadow tree is
+ *  merged, an entry is made for each node that was merged, giving its path and its new name, type
+ *  and value.  The entries are then appended to the tree's journal, (see treeJournal.h.)  Once the
+ *  journal has grown as big as the tree's snapshot, the tree is saved as a new snapshot and the
+ *  journal is deleted.  When a tree is loaded, its journal is replayed on top of its snapshot.
+ *
  *  Copyright (C) Sierra Wireless Inc.
  *
  */
@@ -128,11 +164,16 @@
 #include "legato.h"
 #include "limit.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "internString.h"
 #include "treePath.h"
+#include "treeSnapshot.h"
+#include "treeJournal.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
+#include "internalConfig.h"
+#include "treeWriter.h"
+#include "treeStats.h"
 #include "sysPaths.h"
 
 
@@ -148,6 +189,33 @@
 
 
 
+/// Size (in bytes) of the buffer a value is kept in when it's short enough to be stored in the
+/// node itself, including the null terminator.  This is the size of a pointer on 64-bit targets,
+/// so it doesn't make the node any bigger there.
+#define INLINE_VALUE_BYTES 8
+
+
+
+/// Number of children a stem needs before it gets a child index.
+#define CHILD_INDEX_MIN_CHILDREN 16
+
+
+
+/// A tree's journal may always grow to this size, (in bytes,) before the tree is saved as a new
+/// snapshot.  Past this, it may grow as big as the snapshot is.
+#define JOURNAL_MIN_COMPACT_SIZE (16 * 1024)
+
+
+
+/// Names of the members of the objects a tree is exported to and imported from as JSON.  This is
+/// the same layout the config tool has always used for --format=json.
+#define JSON_FIELD_NAME "name"
+#define JSON_FIELD_TYPE "type"
+#define JSON_FIELD_VALUE "value"
+#define JSON_FIELD_CHILDREN "children"
+
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -160,6 +228,9 @@ typedef struct Registration
                                                ///<   also include the tree name.
     bool triggered;                            ///< Has this registration been triggered for
                                                ///<   callback?
+    char changedPath[CFG_MAX_PATH_SIZE];       ///< While triggered, the path to the deepest node
+                                               ///<   holding all of the changes being reported.
+    le_dls_Link_t triggeredLink;               ///< While triggered, link in the TriggeredList.
 
     union
     {
@@ -191,7 +262,10 @@ typedef struct Handler
 
     le_msg_SessionRef_t sessionRef;         ///< Session that this handler was registered on.
 
-    le_cfg_ChangeHandlerFunc_t handlerPtr;  ///< Function to call back.
+    le_cfg_ChangeHandlerFunc_t handlerPtr;  ///< Function to call back, or NULL if the handler
+                                            ///<   wants a summary of the change.
+    le_cfg_ChangeSummaryHandlerFunc_t summaryHandlerPtr;  ///< Function to call back with a summary
+                                                          ///<   of the change, or NULL.
     void* contextPtr;                       ///< Context to give the function when called.
 
     Registration_t* registrationPtr;        ///< The registration object this handler is attached
@@ -224,6 +298,22 @@ CleanUpContext_t;
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Context used while moving the readers of a tree onto a new version of it.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct VersionContext
+{
+    tdb_TreeRef_t treeRef;       ///< The tree about to be changed.
+    tdb_TreeRef_t versionRef;    ///< The version the readers are moved to, created for the first
+                                 ///<   reader found.
+}
+VersionContext_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Flags that can be set on a node to allow the code to keep track of the various changes as
@@ -232,17 +322,59 @@ CleanUpContext_t;
 // -------------------------------------------------------------------------------------------------
 typedef enum
 {
-    NODE_FLAGS_UNSET = 0x0,  ///< No flags have been set.
-    NODE_IS_SHADOW   = 0x1,  ///< The node is a shadow for a node in another tree.
-    NODE_IS_MODIFIED = 0x2,  ///< This node has been modified.
-    NODE_IS_DELETED  = 0x4   ///< This node has been marked as deleted, the actual deletion will
-                             ///<   take place later.
+    NODE_FLAGS_UNSET      = 0x0,   ///< No flags have been set.
+    NODE_IS_SHADOW        = 0x1,   ///< The node is a shadow for a node in another tree.
+    NODE_IS_MODIFIED      = 0x2,   ///< This node has been modified.
+    NODE_IS_DELETED       = 0x4,   ///< This node has been marked as deleted, the actual deletion
+                                   ///<   will take place later.
+    NODE_IS_VERSION       = 0x8,   ///< The node belongs to a version of a tree kept for its
+                                   ///<   readers, and holds a reference to the node it shadows.
+    NODE_HAS_INLINE_VALUE = 0x10   ///< The node's value is kept in info.inlineValue rather than
+                                   ///<   interned.
 }
 NodeFlags_t;
 
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  An entry in a child index.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t nameHash;                 ///< Hash of the child's name.
+    tdb_NodeRef_t nodeRef;           ///< The child node, or NULL if the slot is free.
+}
+ChildIndexSlot_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Index of the children of a stem by name, so they can be found without comparing the name of
+ *  every child.  This is an open addressing hash table, allocated in one block.
+ *
+ *  Only stems in non-shadow trees with more than a few children get an index, and it is only built
+ *  once a search has had to look at that many children.  Renamed children get a new entry; their
+ *  old entries are left in place, as a search checks the name of every child it finds anyway.
+ *  When a child is deleted, or the index gets too full, the index is thrown away and rebuilt by a
+ *  later search.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t numSlots;                 ///< Total number of slots (a power of 2).
+    size_t numUsed;                  ///< Number of slots in use.
+    ChildIndexSlot_t slots[];        ///< The slots.
+}
+ChildIndex_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  The Node object structure.
@@ -258,19 +390,30 @@ typedef struct Node
     tdb_NodeRef_t shadowRef;         ///< If this node is shadowing another then the pointer to
                                      ///<   that shadowed node is here.
 
-    dstr_Ref_t nameRef;              ///< The name of this node.
+    istr_Ref_t nameRef;              ///< The name of this node.
 
     le_dls_Link_t siblingList;       ///< The linked list of node siblings.  All of the nodes
                                      ///<   in this list have the same parent node.
 
     union
     {
-        dstr_Ref_t valueRef;         ///< The value of the node.  This is only valid if the
+        istr_Ref_t valueRef;         ///< The value of the node.  This is only valid if the
                                      ///<   node is not a stem.
 
+        char inlineValue[INLINE_VALUE_BYTES];  ///< The value of the node, if it's short enough to
+                                               ///<   be kept here.  Only valid if the node is
+                                               ///<   flagged NODE_HAS_INLINE_VALUE.
+
         le_dls_List_t children;      ///< The linked list of children belonging to this node.
     }
     info;                            ///< The actual inforation that this node stores.
+
+    ChildIndex_t* childIndexPtr;     ///< Index of the children by name, or NULL if the node is not
+                                     ///<   a stem or it hasn't been indexed.
+
+    snap_Ref_t snapRef;              ///< If the node is a stem whose children haven't been loaded
+                                     ///<   yet, the snapshot they are to be loaded from.
+    uint32_t snapIndex;              ///< The node's record in snapRef.
 }
 Node_t;
 
@@ -307,6 +450,17 @@ typedef struct Tree
 
     le_sls_List_t requestList;            ///< Each tree maintains it's own list of pending
                                           ///<   requests.
+
+    size_t snapshotSize;                  ///< Size of the tree's snapshot file, in bytes.
+    size_t journalSize;                   ///< Size of the tree's journal file, 0 if it has none.
+                                          ///<   Includes the writes that are still queued.
+    bool isSaveFailed;                    ///< Did the last attempt to save the tree as a snapshot
+                                          ///<   fail?
+
+    bool isVersion;                       ///< Is this tree an older version of its original tree,
+                                          ///<   kept for the readers that were on it?
+    le_dls_List_t versionList;            ///< The versions of this tree still in use by readers.
+    le_dls_Link_t versionLink;            ///< Link in the original tree's list of versions.
 }
 Tree_t;
 
@@ -388,6 +542,65 @@ static le_mem_PoolRef_t RegistrationPool = NULL;
 
 
 
+/// Registrations triggered by commits, whose handlers haven't been called yet.
+static le_dls_List_t TriggeredList = LE_DLS_LIST_INIT;
+
+/// Timer used to hold back change notifications, when a notification delay is configured.
+static le_timer_Ref_t NotificationTimer = NULL;
+
+
+
+/// Set if a node merged in the current commit couldn't be journaled, so the tree has to be saved as
+/// a whole.
+static bool JournalIncomplete = false;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The kinds of writes made to a tree's files.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    WRITE_JOURNAL,   ///< Append a batch of entries to the tree's journal.
+    WRITE_SNAPSHOT,  ///< Save the tree as a new snapshot, then delete the old one and the journal.
+    WRITE_DELETE     ///< Delete all of the tree's files.
+}
+WriteOp_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A write queued for one of the tree writer threads.  It holds everything the write needs, so the
+ *  writer thread never has to look at the tree itself.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    WriteOp_t op;                         ///< What to write.
+    char treeName[MAX_TREE_NAME_BYTES];   ///< The tree being written.
+    int revisionId;                       ///< The revision of the snapshot being written, or that
+                                          ///<   the journal applies to.
+    int oldRevisionId;                    ///< The snapshot revision to delete once a new snapshot
+                                          ///<   is written, 0 for none.
+    size_t journalSize;                   ///< Size of the journal before a batch is appended.
+    jrnl_BatchRef_t batchRef;             ///< The journal entries to append.
+    snap_BuilderRef_t builderRef;         ///< The snapshot to write.
+    size_t fileSize;                      ///< Size of the snapshot once it's written.
+}
+WriteJob_t;
+
+
+
+/// Pool of the writes queued for the writer threads.
+static le_mem_PoolRef_t WriteJobPool = NULL;
+
+
+
 
 // -------------------------------------------------------------------------------------------------
 /**
@@ -544,29 +757,16 @@ static void ClearDeletedFlag
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node and fill out it's default information.
- *
- *  @return The newly created node.
+ *  Does the node belong to a version of a tree?
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewNode
+static bool IsVersion
 (
-    void
+    const tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Create a new blank node.
-    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
-
-    newNodeRef->parentRef = NULL;
-    newNodeRef->type = LE_CFG_TYPE_EMPTY;
-    ClearFlags(newNodeRef);
-    newNodeRef->shadowRef = NULL;
-    newNodeRef->nameRef = NULL;
-    newNodeRef->siblingList = LE_DLS_LINK_INIT;
-    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
-
-    return newNodeRef;
+    return (nodeRef->flags & NODE_IS_VERSION) != 0;
 }
 
 
@@ -574,63 +774,56 @@ static tdb_NodeRef_t NewNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  The node destructor function.  This will take care of freeing a node's string values and any
- *  children it may have.  Called automaticly by the memory system when a node is released.
+ *  Turn a newly created shadow node into a node of a version.  The node takes a reference to the
+ *  original it shadows, so that the original outlives any deletion from its own tree.
  */
 // -------------------------------------------------------------------------------------------------
-static void NodeDestructor
+static void MakeVersionNode
 (
-    void* objectPtr  ///< [IN] The generic object to free.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
+    // The original's modified flag says nothing about the shadow, and a version node is only
+    // marked modified once it no longer looks at its original.
+    ClearModifiedFlag(nodeRef);
+    nodeRef->flags |= NODE_IS_VERSION;
 
-    if (nodeRef->nameRef)
-    {
-        dstr_Release(nodeRef->nameRef);
-    }
+    le_mem_AddRef(nodeRef->shadowRef);
+}
 
-    switch (nodeRef->type)
-    {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            // Nothing to do here.
-            break;
 
-        case LE_CFG_TYPE_STRING:
-        case LE_CFG_TYPE_BOOL:
-        case LE_CFG_TYPE_INT:
-        case LE_CFG_TYPE_FLOAT:
-            if (nodeRef->info.valueRef)
-            {
-                dstr_Release(nodeRef->info.valueRef);
-            }
-            break;
 
-        case LE_CFG_TYPE_STEM:
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
-                while (childRef != NULL)
-                {
-                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Is the node's value kept in the node itself, rather than interned?
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsInlineValue
+(
+    const tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    return (nodeRef->flags & NODE_HAS_INLINE_VALUE) != 0;
+}
 
-                    le_mem_Release(childRef);
-                    childRef = nextChildRef;
-                }
-            }
-            break;
-    }
 
-    if (nodeRef->parentRef != NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
-        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
-        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
 
-        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
-    }
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Does the node hold a value of its own?  Only meaningful for nodes that aren't stems.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool HasValue
+(
+    const tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    return IsInlineValue(nodeRef) || (nodeRef->info.valueRef != NULL);
 }
 
 
@@ -638,40 +831,29 @@ static void NodeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
+ *  Get the text of the node's value.
  *
- *  @return A new node that shadows the existing node.
+ *  @return The value, or NULL if the node doesn't hold one.  The text is only valid until the
+ *          value is changed.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewShadowNode
+static const char* GetValueText
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
+    const tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Allocate a new blank node.
-    tdb_NodeRef_t newShadowRef = NewNode();
-
-    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
-    // be creating a shadow node for which no original exists.  Which is the case when creating a
-    // new path that didn't exist in the original tree.
-    if (nodeRef != NULL)
+    if (IsInlineValue(nodeRef))
     {
-        newShadowRef->type = nodeRef->type;
-        newShadowRef->flags = nodeRef->flags;
-        newShadowRef->shadowRef = nodeRef;
+        return nodeRef->info.inlineValue;
+    }
 
-        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
-        // same with this new node.
-        if (   (nodeRef->parentRef != NULL)
-            && (IsDeleted(nodeRef->parentRef)))
-        {
-            SetDeletedFlag(newShadowRef);
-        }
+    if (nodeRef->info.valueRef != NULL)
+    {
+        return istr_GetText(nodeRef->info.valueRef);
     }
 
-    SetShadowFlag(newShadowRef);
-    return newShadowRef;
+    return NULL;
 }
 
 
@@ -679,48 +861,56 @@ static tdb_NodeRef_t NewShadowNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new node and insert it into the given node's children collection.
- *
- *  @return The newly create node, already inserted into the supplied node's child collection.
+ *  Free the node's value, if it holds one, leaving it without a value.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewChildNode
+static void ReleaseValue
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node is currently empty, then turn it into a stem.
-    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
+    if (IsInlineValue(nodeRef))
     {
-        nodeRef->type = LE_CFG_TYPE_STEM;
+        nodeRef->flags &= ~NODE_HAS_INLINE_VALUE;
+    }
+    else if (nodeRef->info.valueRef != NULL)
+    {
+        istr_Release(nodeRef->info.valueRef);
     }
 
-    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+    nodeRef->info.valueRef = NULL;
+}
 
-    // Create a new node.  Then set it's parent to the given node
-    tdb_NodeRef_t newRef = NewNode();
 
-    newRef->parentRef = nodeRef;
-    newRef->type = LE_CFG_TYPE_EMPTY;
 
-    // Get the new node to inheret the parent's shadow and deletion flags.
-    if (IsShadow(nodeRef))
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Replace the node's value.  Short values, (like most bools and ints,) are copied into the node
+ *  itself, longer ones are interned.
+ */
+// -------------------------------------------------------------------------------------------------
+static void SetValueText
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to update.
+    const char* textPtr     ///< [IN] The new value.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ReleaseValue(nodeRef);
+
+    size_t length = strlen(textPtr);
+
+    if (length < INLINE_VALUE_BYTES)
     {
-        SetShadowFlag(newRef);
-        SetDeletedFlag(newRef);
+        memcpy(nodeRef->info.inlineValue, textPtr, length + 1);
+        nodeRef->flags |= NODE_HAS_INLINE_VALUE;
     }
-
-    if (IsDeleted(nodeRef))
+    else
     {
-        SetDeletedFlag(newRef);
+        nodeRef->info.valueRef = istr_Get(textPtr);
     }
-
-    // Now make sure to add the new child node to the end of the parents collection.
-    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
-
-    // Finally return the newly created node to the caller.
-    return newRef;
 }
 
 
@@ -728,59 +918,61 @@ static tdb_NodeRef_t NewChildNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to shadow a node's collection of children.
+ *  Replace the value of one node with the value of another.  An interned value is shared rather
+ *  than copied.
  */
 // -------------------------------------------------------------------------------------------------
-static void ShadowChildren
+static void CopyValue
 (
-    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
+    tdb_NodeRef_t destRef,      ///< [IN] The node to update.
+    const tdb_NodeRef_t srcRef  ///< [IN] The node holding the value.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the parent node isn't a stem then there isn't much else to do here.
-    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
-    {
-        return;
-    }
+    ReleaseValue(destRef);
 
-    // Does this node have any children currently?  If yes, then we don't need to do anything else.
-    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
+    if (IsInlineValue(srcRef))
     {
-        return;
+        destRef->info = srcRef->info;
+        destRef->flags |= NODE_HAS_INLINE_VALUE;
     }
-
-    // Has this node been modified?  If so, then the shadow children may have been cleared from
-    // this collection.
-    if (IsModified(shadowParentRef) == true)
+    else if (srcRef->info.valueRef != NULL)
     {
-        return;
+        destRef->info.valueRef = istr_AddRef(srcRef->info.valueRef);
     }
+}
 
-    // This node has no shadow children.  So what we do now is check the original node... Does it
-    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
-    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
-    // this piecemeal and possibly out of order.
-    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
 
-    if (   (originalRef == NULL)
-        || (originalRef->type != LE_CFG_TYPE_STEM))
-    {
-        return;
-    }
 
-    // Simply iterate through the original collection and add a new shadow child to our own
-    // collection.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
 
-    while (originalChildRef != NULL)
-    {
-        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
-        newShadowRef->parentRef = shadowParentRef;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a new node and fill out it's default information.
+ *
+ *  @return The newly created node.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t NewNode
+(
+    void
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Create a new blank node.
+    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
 
-        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+    newNodeRef->parentRef = NULL;
+    newNodeRef->type = LE_CFG_TYPE_EMPTY;
+    ClearFlags(newNodeRef);
+    newNodeRef->shadowRef = NULL;
+    newNodeRef->nameRef = NULL;
+    newNodeRef->siblingList = LE_DLS_LINK_INIT;
+    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
+    newNodeRef->childIndexPtr = NULL;
+    newNodeRef->snapRef = NULL;
+    newNodeRef->snapIndex = 0;
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
+    return newNodeRef;
 }
 
 
@@ -788,24 +980,26 @@ static void ShadowChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Search up through a node tree until we find the root node.
+ *  Get a node's name.  A shadow node that hasn't been renamed doesn't have a name of its own, so
+ *  the name of the node it shadows is used.
+ *
+ *  @return The node's name, or NULL if it hasn't got one (like the root node of a tree.)
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetRootParentNode
+static istr_Ref_t GetNameRef
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t parentRef = NULL;
-
-    while (nodeRef != NULL)
+    if (   (IsShadow(nodeRef))
+        && (nodeRef->nameRef == NULL)
+        && (nodeRef->shadowRef != NULL))
     {
-        parentRef = nodeRef;
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        return nodeRef->shadowRef->nameRef;
     }
 
-    return parentRef;
+    return nodeRef->nameRef;
 }
 
 
@@ -813,53 +1007,46 @@ static tdb_NodeRef_t GetRootParentNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to look for a named child in a given node's child collection.
- *
- *  @return Reference to the found child node, or NULL if a node was not found.
+ *  Throw away a stem's child index, if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetNamedChild
+static void DropChildIndex
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is this one of the "special" names?
-    if (strcmp(nameRef, ".") == 0)
-    {
-        return nodeRef;
-    }
-
-    if (strcmp(nameRef, "..") == 0)
-    {
-        return nodeRef->parentRef;
-    }
+    free(nodeRef->childIndexPtr);
+    nodeRef->childIndexPtr = NULL;
+}
 
-    // If the current node isn't a stem, then this node can't have any children.
-    if (nodeRef->type != LE_CFG_TYPE_STEM)
-    {
-        return NULL;
-    }
 
-    // Search the child list for a node with the given name.
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
-    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
 
-    while (currentRef != NULL)
-    {
-        tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
 
-        if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
-        {
-            return currentRef;
-        }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add an entry to a child index.  The index must have room for it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddToChildIndex
+(
+    ChildIndex_t* indexPtr,  ///< [IN] The index.
+    size_t nameHash,         ///< [IN] Hash of the child's name.
+    tdb_NodeRef_t childRef   ///< [IN] The child.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t mask = indexPtr->numSlots - 1;
+    size_t slot = nameHash & mask;
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+    while (indexPtr->slots[slot].nodeRef != NULL)
+    {
+        slot = (slot + 1) & mask;
     }
 
-    // Looks like there was no node to return.
-    return NULL;
+    indexPtr->slots[slot].nameHash = nameHash;
+    indexPtr->slots[slot].nodeRef = childRef;
+    indexPtr->numUsed++;
 }
 
 
@@ -867,46 +1054,43 @@ static tdb_NodeRef_t GetNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to create a named child in a nodes child collection.  However, this function will only
- *  create nodes on shadow trees.
- *
- *  @return Reference to newly created child node, or NULL if it can not be created.
+ *  Build a child index for a stem.  It is made big enough that quite a few children can be added
+ *  before it needs to be rebuilt.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t CreateNamedChild
+static void BuildChildIndex
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t childRef = NULL;
+    size_t numChildren = le_dls_NumLinks(&nodeRef->info.children);
+    size_t numSlots = 1;
 
-    if (IsShadow(nodeRef) == true)
+    while (numSlots < numChildren * 4)
     {
-        // If the node isn't a stem, then convert it into an empty one now.
-        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
-        {
-            tdb_SetEmpty(nodeRef);
-            nodeRef->type = LE_CFG_TYPE_STEM;
-            nodeRef->info.children = LE_DLS_LIST_INIT;
-        }
+        numSlots *= 2;
+    }
 
-        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
-        childRef = NewChildNode(nodeRef);
-        SetDeletedFlag(childRef);
+    ChildIndex_t* indexPtr = calloc(1, sizeof(ChildIndex_t) + numSlots * sizeof(ChildIndexSlot_t));
+    LE_ASSERT(indexPtr != NULL);
 
-        // Set the name of the new node, if that fails then the user had given us a bad name for the
-        // new node.  So in that case free the node and return NULL.
-        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+    indexPtr->numSlots = numSlots;
+
+    tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        if (childRef->nameRef != NULL)
         {
-            le_mem_Release(childRef);
-            childRef = NULL;
+            AddToChildIndex(indexPtr, istr_GetHash(childRef->nameRef), childRef);
         }
+
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    return childRef;
+    DropChildIndex(nodeRef);
+    nodeRef->childIndexPtr = indexPtr;
 }
 
 
@@ -914,34 +1098,32 @@ static tdb_NodeRef_t CreateNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a given node exists within a node's child collection.
- *
- *  @return True if the given node exists within the parent node's collection.  False if not.
+ *  Update the child index of a node's parent after the node has been given a new name.
  */
 // -------------------------------------------------------------------------------------------------
-static bool NodeExists
+static void IndexChildName
 (
-    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
-    const char* namePtr       ///< [IN] The name to search for.
+    tdb_NodeRef_t childRef  ///< [IN] The child that has been renamed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
-    char currentName[LE_CFG_NAME_LEN_BYTES] = "";
+    tdb_NodeRef_t parentRef = childRef->parentRef;
 
-    while (currentRef != NULL)
+    if ((parentRef == NULL) || (parentRef->childIndexPtr == NULL))
     {
-        tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
+        return;
+    }
 
-        if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
-        {
-            return true;
-        }
+    ChildIndex_t* indexPtr = parentRef->childIndexPtr;
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+    // Keep the index at most half full, so searches stay short.
+    if ((indexPtr->numUsed + 1) * 2 > indexPtr->numSlots)
+    {
+        DropChildIndex(parentRef);
+        return;
     }
 
-    return false;
+    AddToChildIndex(indexPtr, istr_GetHash(childRef->nameRef), childRef);
 }
 
 
@@ -949,28 +1131,20 @@ static bool NodeExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node type and see if it should have a string value.
- *
- *  @return True if the given node could hold a string value.  False if not.
+ *  Forget about the snapshot a stem's children were to be loaded from, without loading them.
  */
 // -------------------------------------------------------------------------------------------------
-static bool IsStringType
+static void DropSnapshot
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
-
-    if (   (type == LE_CFG_TYPE_STRING)
-        || (type == LE_CFG_TYPE_BOOL)
-        || (type == LE_CFG_TYPE_INT)
-        || (type == LE_CFG_TYPE_FLOAT))
+    if (nodeRef->snapRef != NULL)
     {
-        return true;
+        snap_Release(nodeRef->snapRef);
+        nodeRef->snapRef = NULL;
     }
-
-    return false;
 }
 
 
@@ -978,33 +1152,40 @@ static bool IsStringType
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will copy a string value from an original tree node into a node that has shadowed
- *  it.
+ *  Fill out an empty node from its record in a snapshot.  If the node is a stem, its children are
+ *  left in the snapshot, to be loaded by LoadChildren() when something first looks at them.
  */
 // -------------------------------------------------------------------------------------------------
-static void PropagateValue
+static void LoadSnapshotNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to fill out.
+    snap_Ref_t snapRef,     ///< [IN] The snapshot.
+    uint32_t index          ///< [IN] The node's record in the snapshot.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node doesn't even have a ref to an original node, then there's nothing left to do
-    // here.
-    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
+    le_cfg_nodeType_t type = snap_GetType(snapRef, index);
 
-    if (shadowRef == NULL)
+    switch (type)
     {
-        return;
-    }
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            nodeRef->type = type;
+            SetValueText(nodeRef, snap_GetValue(snapRef, index));
+            break;
 
-    // Ok, figure out the type for this node.  If it has a value, and the original
-    if (   (IsStringType(nodeRef) == true)
-        && (IsStringType(shadowRef) == true)
-        && (nodeRef->info.valueRef == NULL)
-        && (shadowRef->info.valueRef != NULL))
-    {
-        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
-        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+        case LE_CFG_TYPE_STEM:
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+            nodeRef->snapRef = snap_AddRef(snapRef);
+            nodeRef->snapIndex = index;
+            break;
+
+        default:
+            nodeRef->type = LE_CFG_TYPE_EMPTY;
+            break;
     }
 }
 
@@ -1013,194 +1194,194 @@ static void PropagateValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow node with the original it represents.
+ *  If a stem's children haven't been loaded from its snapshot yet, load them now.  Only the
+ *  children themselves are loaded, any grandchildren stay in the snapshot until they're needed.
  */
 // -------------------------------------------------------------------------------------------------
-static void MergeNode
+static void LoadChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
+    snap_Ref_t snapRef = nodeRef->snapRef;
 
-    // If this shadow node for some reason doesn't have a ref check for an original version of it in
-    // the original tree.  This shadow node may have been destroyed and re-created loosing this
-    // link.
-    if (nodeRef->shadowRef == NULL)
+    if (snapRef == NULL)
     {
-        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
+        return;
+    }
 
-        if (shadowedParentRef != NULL)
-        {
-            char name[LE_CFG_NAME_LEN_BYTES] = "";
+    nodeRef->snapRef = NULL;
 
-            tdb_GetNodeName(nodeRef, name, sizeof(name));
-            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
-        }
-    }
+    uint32_t firstIndex;
+    uint32_t count = snap_GetChildren(snapRef, nodeRef->snapIndex, &firstIndex);
 
-    // If this node has been marked as deleted, then simply drop the original node and move on.
-    if (IsDeleted(nodeRef))
+    for (uint32_t i = 0; i < count; i++)
     {
-        if (   (nodeRef->shadowRef != NULL)
-            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
-        {
-            le_mem_Release(nodeRef->shadowRef);
-        }
-        else
+        const char* namePtr = snap_GetName(snapRef, firstIndex + i);
+
+        // The names were checked when the tree was saved, so only a corrupt file can get this.
+        if (namePtr[0] == '\0')
         {
-            // We delete every node but the root node.  Since this is the root node, we just need
-            // to clear it out.
-            tdb_SetEmpty(nodeRef->shadowRef);
+            LE_CRIT("Skipping unnamed node in configuration tree snapshot.");
+            continue;
         }
 
-        return;
+        tdb_NodeRef_t childRef = NewNode();
+
+        childRef->parentRef = nodeRef;
+        childRef->nameRef = istr_Get(namePtr);
+        LoadSnapshotNode(childRef, snapRef, firstIndex + i);
+
+        le_dls_Queue(&nodeRef->info.children, &childRef->siblingList);
     }
 
-    // If the original node doesn't exist, create it now.
-    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+    snap_Release(snapRef);
+}
 
-    if (originalRef == NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef != NULL);
-        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
 
-        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
-    }
 
-    ClearModifiedFlag(originalRef);
 
-    // If the name has been changed, then copy it over now.
-    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Take a node out of its parent's list of children and release it.  The node is unlinked first,
+ *  as a version of the tree may still hold a reference to it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReleaseChildNode
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to release.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t parentRef = nodeRef->parentRef;
+
+    if (parentRef != NULL)
     {
-        if (originalRef->nameRef != NULL)
-        {
-            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
-        }
-        else
-        {
-            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
-        }
+        le_dls_Remove(&parentRef->info.children, &nodeRef->siblingList);
+        DropChildIndex(parentRef);
+
+        nodeRef->parentRef = NULL;
     }
 
-    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
-    // then clear out the original node.  If the types have changed, then clear out the original so
-    // that we can properly populate it again.
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
-
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != originalRef->type))
-    {
-        tdb_SetEmpty(originalRef);
-    }
-
-    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
-    // that it isn't a stem.  If not, then copy over the string value.
-    if (   (nodeType != LE_CFG_TYPE_EMPTY)
-        && (nodeType != LE_CFG_TYPE_STEM))
-    {
-        if (nodeRef->info.valueRef != NULL)
-        {
-            if (originalRef->info.valueRef != NULL)
-            {
-                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
-            }
-            else
-            {
-                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
-            }
-
-            // Propigate over the type as that may have changed, like going from an int value to a
-            // bool value.
-
-            originalRef->type = nodeRef->type;
-        }
-    }
-
-    // Now at this point, if both the original and the shadow node are stems, we'll let the function
-    // InternalMergeTree take care of the children, (if any.)
-
-    // If the original has been cleared out, we can still just rely on InternalMergeTree to
-    // propigate over the new nodes.
-}
+    le_mem_Release(nodeRef);
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
- *  given path, nothing happens.
+ *  The node destructor function.  This will take care of freeing a node's string values and any
+ *  children it may have.  Called automaticly by the memory system when a node is released.
  */
 // -------------------------------------------------------------------------------------------------
-static void TriggerCallbacks
+static void NodeDestructor
 (
-    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
+    void* objectPtr  ///< [IN] The generic object to free.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Read the path out of the buffer.
-    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
-    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
+
+    // Children that are still in a snapshot don't need to be loaded just to be thrown away.
+    DropSnapshot(nodeRef);
+
+    if (nodeRef->nameRef)
     {
-        LE_ERROR("Callback path buffer overflow.");
-        return;
+        istr_Release(nodeRef->nameRef);
     }
 
-    // Try to find a registration object for this path.  If one is found, flag it for calling once
-    // the merge is complete.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
+    // Drop the index first, so it isn't searched while the children are being released.
+    DropChildIndex(nodeRef);
 
-    if (foundRegistrationPtr != NULL)
+    switch (nodeRef->type)
     {
-        foundRegistrationPtr->triggered = true;
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            // Nothing to do here.
+            break;
+
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            ReleaseValue(nodeRef);
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+                while (childRef != NULL)
+                {
+                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+
+                    ReleaseChildNode(childRef);
+                    childRef = nextChildRef;
+                }
+            }
+            break;
+    }
+
+    if (nodeRef->parentRef != NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
+        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
+        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+
+        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+
+        // The parent's index may still refer to this node.
+        DropChildIndex(nodeRef->parentRef);
     }
-}
 
+    // Version nodes keep the nodes they shadow alive.
+    if (IsVersion(nodeRef))
+    {
+        le_mem_Release(nodeRef->shadowRef);
+    }
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Go through all of the registered event callbacks, and fire the call backs for each of the
- *  registrations that has been makred as triggered.
+ *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
  *
- *  Once this is done, the triggered flag is cleared for next time.
+ *  @return A new node that shadows the existing node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireTriggeredCallbacks
+static tdb_NodeRef_t NewShadowNode
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Go through the registration map.
-    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
+    // Allocate a new blank node.
+    tdb_NodeRef_t newShadowRef = NewNode();
 
-    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
+    // be creating a shadow node for which no original exists.  Which is the case when creating a
+    // new path that didn't exist in the original tree.
+    if (nodeRef != NULL)
     {
-        // For each registration, check to see if it was triggered.
-        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
+        newShadowRef->type = nodeRef->type;
+        newShadowRef->flags = nodeRef->flags & ~NODE_HAS_INLINE_VALUE;
+        newShadowRef->shadowRef = nodeRef;
 
-        if (registrationPtr->triggered)
+        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
+        // same with this new node.
+        if (   (nodeRef->parentRef != NULL)
+            && (IsDeleted(nodeRef->parentRef)))
         {
-            // This registration has been triggered, so call all of the handlers attached to it.
-            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
-
-            while (linkPtr != NULL)
-            {
-                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-
-                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
-                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
-            }
-
-            // Now that that's done, clear the triggered flag.
-            registrationPtr->triggered = false;
+            SetDeletedFlag(newShadowRef);
         }
     }
+
+    SetShadowFlag(newShadowRef);
+    return newShadowRef;
 }
 
 
@@ -1208,39 +1389,51 @@ static void FireTriggeredCallbacks
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node to see if it was renamed.
+ *  Create a new node and insert it into the given node's children collection.
  *
- *  @return True if the node was renamed within this transaction.  False if not.
+ *  @return The newly create node, already inserted into the supplied node's child collection.
  */
 // -------------------------------------------------------------------------------------------------
-static bool WasRenamed
+static tdb_NodeRef_t NewChildNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (IsModified(nodeRef) == false)
+    // The new child goes after any existing children, so make sure they're loaded.
+    LoadChildren(nodeRef);
+
+    // If the node is currently empty, then turn it into a stem.
+    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
     {
-        // The node wasn't even modified, so it can not have been renamed.
-        return false;
+        nodeRef->type = LE_CFG_TYPE_STEM;
     }
 
-    if (nodeRef->shadowRef == NULL)
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+
+    // Create a new node.  Then set it's parent to the given node
+    tdb_NodeRef_t newRef = NewNode();
+
+    newRef->parentRef = nodeRef;
+    newRef->type = LE_CFG_TYPE_EMPTY;
+
+    // Get the new node to inheret the parent's shadow and deletion flags.
+    if (IsShadow(nodeRef))
     {
-        // If the node doesn't have a shadow reference, then most likely this is a new node and not
-        // a rename of an existing one.
-        return false;
+        SetShadowFlag(newRef);
+        SetDeletedFlag(newRef);
     }
 
-    if (nodeRef->nameRef == NULL)
+    if (IsDeleted(nodeRef))
     {
-        // The shadow node does not have a local copy of a name, so it can not have been renamed.
-        // It must have been modified for other reasons.
-        return false;
+        SetDeletedFlag(newRef);
     }
 
-    // Looks like the node has a new name.
-    return true;
+    // Now make sure to add the new child node to the end of the parents collection.
+    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
+
+    // Finally return the newly created node to the caller.
+    return newRef;
 }
 
 
@@ -1248,54 +1441,64 @@ static bool WasRenamed
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the original non-shadow node to see if it will need to be cleared during the merge.
- *
- *  @return True if the merge will clear out the original value.  False if not.
+ *  Called to shadow a node's collection of children.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OriginalToBeCleared
+static void ShadowChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+    // If the parent node isn't a stem then there isn't much else to do here.
+    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    // Does this node have any children currently?  If yes, then we don't need to do anything else.
+    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
     {
-        return true;
+        return;
     }
 
-    return false;
-}
+    // Has this node been modified?  If so, then the shadow children may have been cleared from
+    // this collection.
+    if (IsModified(shadowParentRef) == true)
+    {
+        return;
+    }
 
+    // This node has no shadow children.  So what we do now is check the original node... Does it
+    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
+    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
+    // this piecemeal and possibly out of order.
+    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
 
+    if (   (originalRef == NULL)
+        || (originalRef->type != LE_CFG_TYPE_STEM))
+    {
+        return;
+    }
 
+    // Simply iterate through the original collection and add a new shadow child to our own
+    // collection.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Append the name of a node onto the end of a path object.
- */
-// -------------------------------------------------------------------------------------------------
-static void AppendNodeName
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    while (originalChildRef != NULL)
+    {
+        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
+        newShadowRef->parentRef = shadowParentRef;
 
-    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+        if (IsVersion(shadowParentRef))
+        {
+            MakeVersionNode(newShadowRef);
+        }
 
-    LE_WARN_IF(result != LE_OK,
-               "Could not append node '%s' onto the update callback tracking path.  "
-               "Reason: %d, '%s'.",
-               nodeName,
-               result,
-               LE_RESULT_TXT(result));
+        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 }
 
 
@@ -1303,21 +1506,24 @@ static void AppendNodeName
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new config path for the tree name given.
- *
- *  @return A new config path, rooted on the given tree.
+ *  Search up through a node tree until we find the root node.
  */
 // -------------------------------------------------------------------------------------------------
-static le_pathIter_Ref_t CreateBasePath
+static tdb_NodeRef_t GetRootParentNode
 (
-    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
+    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
+    tdb_NodeRef_t parentRef = NULL;
 
-    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
-    return le_pathIter_CreateForUnix(basePath);
+    while (nodeRef != NULL)
+    {
+        parentRef = nodeRef;
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    return parentRef;
 }
 
 
@@ -1325,60 +1531,78 @@ static le_pathIter_Ref_t CreateBasePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Generate a config path to the given node.
+ *  Search a node's child collection for a child with a given name, using the node's child index if
+ *  it has one.  Builds the index if the search had to look at many children.
+ *
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static void GeneratePath
+static tdb_NodeRef_t FindChild
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* namePtr     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (nodeRef == NULL)
-    {
-        return;
-    }
+    // The names of children still in a snapshot haven't been interned yet.
+    LoadChildren(nodeRef);
 
-    GeneratePath(pathRef, nodeRef->parentRef);
-    AppendNodeName(pathRef, nodeRef);
-}
+    // Every node name is interned, so if the name isn't, no child can have it.  Otherwise the
+    // names can be compared by reference.
+    istr_Ref_t nameRef = istr_Find(namePtr);
 
+    if (nameRef == NULL)
+    {
+        return NULL;
+    }
 
+    ChildIndex_t* indexPtr = nodeRef->childIndexPtr;
 
+    if (indexPtr != NULL)
+    {
+        size_t nameHash = istr_GetHash(nameRef);
+        size_t mask = indexPtr->numSlots - 1;
+        size_t slot = nameHash & mask;
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Trigger callbacks for this node and all of it's children.
- */
-// -------------------------------------------------------------------------------------------------
-static void FireAllChildren
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Add this node to the path we're using to find registered callbacks.
-    AppendNodeName(pathRef, nodeRef);
+        while (indexPtr->slots[slot].nodeRef != NULL)
+        {
+            // The entry may be for the child's old name, so check the name it has now.
+            if (   (indexPtr->slots[slot].nameHash == nameHash)
+                && (indexPtr->slots[slot].nodeRef->nameRef == nameRef))
+            {
+                return indexPtr->slots[slot].nodeRef;
+            }
 
-    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
-    // there are no callbacks registered for those nodes, then nothing will happen.
-    if (nodeRef->type == LE_CFG_TYPE_STEM)
-    {
-        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+            slot = (slot + 1) & mask;
+        }
 
-        while (childRef != NULL)
+        return NULL;
+    }
+
+    // Search the child list for a node with the given name.
+    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
+    size_t numSearched = 0;
+
+    while (currentRef != NULL)
+    {
+        if (GetNameRef(currentRef) == nameRef)
         {
-            FireAllChildren(pathRef, childRef);
-            childRef = tdb_GetNextSiblingNode(childRef);
+            break;
         }
+
+        numSearched++;
+        currentRef = tdb_GetNextSiblingNode(currentRef);
     }
 
-    // Like with the children, try to do the same for this node.  Then remove this node from the
-    // tracking path.
-    TriggerCallbacks(pathRef);
-    le_pathIter_Truncate(pathRef);
+    // Shadow nodes aren't indexed, as their names can come from the nodes they shadow.
+    if (   (numSearched >= CHILD_INDEX_MIN_CHILDREN)
+        && (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsShadow(nodeRef) == false))
+    {
+        BuildChildIndex(nodeRef);
+    }
+
+    return currentRef;
 }
 
 
@@ -1386,82 +1610,36 @@ static void FireAllChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check a given shadow node and the original node it's shadowing.  If the original has children
- *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
- *  about to go away.
- *
- *  The algorithm employed by this function is as follows:
- *
- *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
- *         mark all of the children as deleted.  (This is done with the expectation that the
- *         original tree does not have nodes with the deleted flag set.)
- *
- *      2. Go through the shadow collection, and any shadow children that have links to the original
- *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *  Called to look for a named child in a given node's child collection.
  *
- *      3. Travers the original children one more time.  For any node that is still marked as
- *         deleted we queue up an event handler.  As this node has been removed from the colection
- *         and will be removed as part of the final merge.  The delete flag is also cleared at this
- *         step to ensure that there are no external side effects.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireLostChildren
+static tdb_NodeRef_t GetNamedChild
 (
-    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is the original a stem?  If no, then done.
-    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
-
-    if (originalRef->type != LE_CFG_TYPE_STEM)
+    // Is this one of the "special" names?
+    if (strcmp(nameRef, ".") == 0)
     {
-        return;
+        return nodeRef;
     }
 
-    // Mark all originals deleted.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
+    if (strcmp(nameRef, "..") == 0)
     {
-        // Children in the original tree shouldn't currently be marked as deleted.
-        LE_ASSERT(IsDeleted(originalChildRef) == false);
-
-        SetDeletedFlag(originalChildRef);
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        return nodeRef->parentRef;
     }
 
-    // Follow through all of the shadow links and unmark deletions.
-    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    // If the current node isn't a stem, then this node can't have any children.
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
     {
-        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
-
-        while (shadowChildRef != NULL)
-        {
-            if (shadowChildRef->shadowRef != NULL)
-            {
-                ClearDeletedFlag(shadowChildRef->shadowRef);
-            }
-
-            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
-        }
+        return NULL;
     }
 
-    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
-    // in order to leave everything as it was.
-    originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
-    {
-        if (IsDeleted(originalChildRef) == true)
-        {
-            FireAllChildren(pathRef, originalChildRef);
-            ClearDeletedFlag(originalChildRef);
-        }
-
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
+    return FindChild(nodeRef, nameRef);
 }
 
 
@@ -1469,93 +1647,46 @@ static void FireLostChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *  Called to create a named child in a nodes child collection.  However, this function will only
+ *  create nodes on shadow trees.
  *
- *  @return True if the given node or any if it's children have been modified.  False if not.
+ *  @return Reference to newly created child node, or NULL if it can not be created.
  */
 // -------------------------------------------------------------------------------------------------
-static bool InternalMergeTree
+static tdb_NodeRef_t CreateNamedChild
 (
-    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
-    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
-    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
-                                ///<      children, regardless of wether or not this node has been
-                                ///<      directly modified?
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool isModified = IsModified(nodeRef);
-    bool renamed = WasRenamed(nodeRef);
-
-    // If this node was renamed, then all children also need to be triggered as well.
-    forceFire = renamed || forceFire;
+    tdb_NodeRef_t childRef = NULL;
 
-    // If this node has been renamed, marked as deleted or set empty, then all of the children need
-    // notifications fired on the original nodes.
-    if (   (renamed == true)
-        || (IsDeleted(nodeRef) == true)
-        || (OriginalToBeCleared(nodeRef) == true))
+    if (IsShadow(nodeRef) == true)
     {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        if (nodeRef->shadowRef != NULL)
+        // If the node isn't a stem, then convert it into an empty one now.
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
         {
-            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
-            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+            tdb_SetEmpty(nodeRef);
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
         }
 
-        le_pathIter_Delete(originalPathRef);
-    }
-    else if (   (isModified == true)
-             && (nodeRef->type == LE_CFG_TYPE_STEM))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        GeneratePath(originalPathRef, nodeRef->shadowRef);
-        FireLostChildren(originalPathRef, nodeRef);
-
-        le_pathIter_Delete(originalPathRef);
-    }
-
-    AppendNodeName(pathRef, nodeRef);
-
-    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
-    // track of whether any of those children have been modified as well.
-    if (isModified)
-    {
-        MergeNode(nodeRef);
-    }
-
-    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
-        && (IsDeleted(nodeRef) == false))
-    {
-        nodeRef = tdb_GetFirstChildNode(nodeRef);
+        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
+        childRef = NewChildNode(nodeRef);
+        SetDeletedFlag(childRef);
 
-        while (nodeRef != NULL)
+        // Set the name of the new node, if that fails then the user had given us a bad name for the
+        // new node.  So in that case free the node and return NULL.
+        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
         {
-            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
-
-            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
-            nodeRef = nextNodeRef;
+            le_mem_Release(childRef);
+            childRef = NULL;
         }
     }
 
-    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
-    // be registered.
-    if (isModified || forceFire)
-    {
-        TriggerCallbacks(pathRef);
-    }
-
-    // Now remove this node from the tracking path and let our caller know if any modifications have
-    // happened at this level or lower.
-    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
-    {
-        le_pathIter_Truncate(pathRef);
-    }
-
-    return isModified;
+    return childRef;
 }
 
 
@@ -1563,31 +1694,19 @@ static bool InternalMergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new tree object and set it to default values.
+ *  Check to see if a given node exists within a node's child collection.
  *
- *  @return A ref to the newly created tree object.
+ *  @return True if the given node exists within the parent node's collection.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-tdb_TreeRef_t NewTree
+static bool NodeExists
 (
-    const char* treeNameRef,   ///< [IN] The name of the new tree.
-    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
-
-    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
-
-    treeRef->isDeletePending = false;
-    treeRef->originalTreeRef = NULL;
-    treeRef->revisionId = 0;
-    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
-    treeRef->activeReadCount = 0;
-    treeRef->activeWriteIterRef = NULL;
-    treeRef->requestList = LE_SLS_LIST_INIT;
-
-    return treeRef;
+    return (FindChild(parentRef, namePtr) != NULL);
 }
 
 
@@ -1595,25 +1714,28 @@ tdb_TreeRef_t NewTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Destructor called when a tree object is to be freed from memory.
+ *  Check the given node type and see if it should have a string value.
+ *
+ *  @return True if the given node could hold a string value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void TreeDestructor
+static bool IsStringType
 (
-    void* objectPtr  ///< The memory object to destruct.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
-    // Kill the root node.
-    le_mem_Release(treeRef->rootNodeRef);
-    treeRef->rootNodeRef = NULL;
+    if (   (type == LE_CFG_TYPE_STRING)
+        || (type == LE_CFG_TYPE_BOOL)
+        || (type == LE_CFG_TYPE_INT)
+        || (type == LE_CFG_TYPE_FLOAT))
+    {
+        return true;
+    }
 
-    // Sanity check, is the tree actually ready to clean up?
-    LE_ASSERT(treeRef->activeReadCount == 0);
-    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+    return false;
 }
 
 
@@ -1621,40 +1743,33 @@ static void TreeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a path to a tree file with the given revision id.
- *
- *  @return A stringBuffer backed string containing the full path to the tree file.
+ *  This function will copy a string value from an original tree node into a node that has shadowed
+ *  it.
  */
 // -------------------------------------------------------------------------------------------------
-static void GetTreePath
+static void PropagateValue
 (
-    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
-    int revisionId,           ///< [IN] Generate a name based on the tree revision.
-    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
-    size_t pathSize           ///< [IN] Size of the path buffer.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // paper    --> rock       1 -> 2
-    // rock     --> scissors   2 -> 3
-    // scissors --> paper      3 -> 1
-
-    static const char* revNames[] = { "paper", "rock", "scissors" };
-    int printSize;
-
-    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+    // If the node doesn't even have a ref to an original node, then there's nothing left to do
+    // here.
+    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
 
-    printSize = snprintf(pathBuffer,
-                         pathSize,
-                         "%s/%s.%s",
-                         CFG_TREE_PATH,
-                         treeNameRef,
-                         revNames[revisionId - 1]);
+    if (shadowRef == NULL)
+    {
+        return;
+    }
 
-    if (printSize >= pathSize)
+    // Ok, figure out the type for this node.  If it has a value, and the original
+    if (   (IsStringType(nodeRef) == true)
+        && (IsStringType(shadowRef) == true)
+        && (HasValue(nodeRef) == false)
+        && (HasValue(shadowRef) == true))
     {
-       LE_ERROR("Unable to store config tree path in buffer");
-       pathBuffer[0] = '\0';
+        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
+        CopyValue(nodeRef, shadowRef);
     }
 }
 
@@ -1663,57 +1778,49 @@ static void GetTreePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a configTree file at the given revision already exists in the filesystem.
+ *  Get the absolute path to a node within its tree.
  *
- *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
- *
- *  @return True if the named file exists, false otherwise.
+ *  @return LE_OK if the path fit in the buffer, LE_OVERFLOW if not.
  */
 // -------------------------------------------------------------------------------------------------
-static bool TreeFileExists
+static le_result_t GetNodePath
 (
-    const char* treeNameRef,  ///< [IN] Name of the tree to check.
-    int revisionId            ///< [IN] The revision of the tree to check against.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node.
+    char* pathPtr,          ///< [OUT] The path.
+    size_t pathSize         ///< [IN] Size of the path buffer.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+    // Fill the buffer from the end, as the path is found from the node up to the root.
+    size_t start = pathSize - 1;
+    pathPtr[start] = '\0';
 
-    // Make sure this part was successful.
-    if (fullPath[0] == '\0')
+    while (   (nodeRef != NULL)
+           && (nodeRef->parentRef != NULL))
     {
-        return false;
-    }
+        istr_Ref_t nameRef = GetNameRef(nodeRef);
+        size_t nameLen = (nameRef == NULL) ? 0 : istr_GetLength(nameRef);
 
-    // stat() the file to see if it exists and get its size.
-    struct stat s;
-    if (stat(fullPath, &s) == -1)
-    {
-        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
-        return false;
-    }
+        if (nameLen + 1 > start)
+        {
+            return LE_OVERFLOW;
+        }
 
-    // Make sure it's a regular file.
-    if (!S_ISREG(s.st_mode))
-    {
-        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+        start -= nameLen;
+        memcpy(pathPtr + start, istr_GetText(nameRef), nameLen);
+        pathPtr[--start] = '/';
+
+        nodeRef = nodeRef->parentRef;
     }
 
-    // If it's zero size, delete it and report that it doesn't exist.
-    if (s.st_size == 0)
+    if (start == pathSize - 1)
     {
-        if (unlink(fullPath) == -1)
-        {
-            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
-        }
-
-        return false;
+        pathPtr[--start] = '/';
     }
 
-    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
+    memmove(pathPtr, pathPtr + start, pathSize - start);
 
-    return true;
+    return LE_OK;
 }
 
 
@@ -1721,72 +1828,81 @@ static bool TreeFileExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- * Check the filesystem and get the current "valid" version of the file and update the tree object
- * with that version number.
- *
- * If there are two files for a given tree, we use the older one.  The idea being, if there are
- * two versions of the same file in the filesystem then there was a system failure during a save
- * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
- * unless the size of the older file is zero, which can happen if deletion of that file is
- * interrupted.
+ *  Add a journal entry for the change a shadow node is about to make to the original tree.  This
+ *  has to be done before the node is merged, while the original node still has its old name.
  */
 // -------------------------------------------------------------------------------------------------
-static void UpdateRevision
+static void JournalNode
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node being merged.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int newRevision = 0;
+    char path[CFG_MAX_PATH_SIZE] = "";
+    le_result_t result;
+    jrnl_Entry_t entry =
+        {
+            .op = JRNL_SET_NODE,
+            .pathPtr = path,
+            .newNamePtr = NULL,
+            .type = LE_CFG_TYPE_EMPTY,
+            .valuePtr = NULL
+        };
 
-    if (TreeFileExists(treeRef->name, 1))
+    if (IsDeleted(nodeRef))
     {
-        if (TreeFileExists(treeRef->name, 3))
+        // Nothing happens to an original that doesn't exist.
+        if (nodeRef->shadowRef == NULL)
         {
-            newRevision = 3;
-        }
-        else
-        {
-            newRevision = 1;
+            return;
         }
+
+        entry.op = JRNL_DELETE_NODE;
+        result = GetNodePath(nodeRef->shadowRef, path, sizeof(path));
     }
-    else if (TreeFileExists(treeRef->name, 3))
+    else
     {
-        if (TreeFileExists(treeRef->name, 2))
+        if (nodeRef->shadowRef != NULL)
         {
-            newRevision = 2;
+            // Existing nodes are found by their old name, and then renamed.
+            result = GetNodePath(nodeRef->shadowRef, path, sizeof(path));
+
+            if (nodeRef->nameRef != NULL)
+            {
+                entry.newNamePtr = istr_GetText(nodeRef->nameRef);
+            }
         }
         else
         {
-            newRevision = 3;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 2))
-    {
-        newRevision = 2;
-    }
+            // New nodes are created under the parent's original, which has already been merged.
+            istr_Ref_t nameRef = GetNameRef(nodeRef);
 
-    treeRef->revisionId = newRevision;
-}
+            result = GetNodePath(nodeRef->parentRef->shadowRef, path, sizeof(path));
 
+            if (   (result == LE_OK)
+                && (nameRef != NULL)
+                && (le_path_Concat("/", path, sizeof(path), istr_GetText(nameRef), (char*)NULL) != LE_OK))
+            {
+                result = LE_OVERFLOW;
+            }
+        }
 
+        entry.type = tdb_GetNodeType(nodeRef);
 
+        if (IsStringType(nodeRef))
+        {
+            entry.valuePtr = GetValueText(nodeRef);
+        }
+    }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Peek into the input stream one character ahead.
- */
-// -------------------------------------------------------------------------------------------------
-static signed char PeekChar
-(
-    FILE* filePtr  ///< [IN] The file stream to peek into.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    char next = fgetc(filePtr);
-    ungetc(next, filePtr);
+    if (result != LE_OK)
+    {
+        LE_WARN("Path too long to journal, the whole tree will be saved.");
+        JournalIncomplete = true;
+        return;
+    }
 
-    return next;
+    jrnl_AddEntry(&entry);
 }
 
 
@@ -1794,45 +1910,41 @@ static signed char PeekChar
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *  Find the node in a version that shadows a node of the original tree, creating the shadow nodes
+ *  along the way as needed.
  *
- *  @return LE_OK if the whitespace is skiped and there is still more file to read.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  @return The version's node, or NULL if the original node isn't part of the version.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipWhiteSpace
+static tdb_NodeRef_t FindVersionNode
 (
-    FILE* filePtr  ///< [IN] The file stream to seek through.
+    tdb_NodeRef_t versionRootRef,  ///< [IN] Root node of the version.
+    tdb_NodeRef_t originalRef      ///< [IN] The node in the original tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool done = false;
-    bool isEof = false;
+    if (originalRef->parentRef == NULL)
+    {
+        return (versionRootRef->shadowRef == originalRef) ? versionRootRef : NULL;
+    }
 
-    while (done == false)
+    tdb_NodeRef_t parentRef = FindVersionNode(versionRootRef, originalRef->parentRef);
+
+    if (   (parentRef == NULL)
+        || (parentRef->type != LE_CFG_TYPE_STEM))
     {
-        switch (PeekChar(filePtr))
-        {
-            case '\n':
-            case '\r':
-            case '\t':
-            case ' ':
-                // Eat the character.
-                fgetc(filePtr);
-                break;
+        return NULL;
+    }
 
-            case EOF:
-                done = true;
-                isEof = true;
-                break;
+    tdb_NodeRef_t childRef = tdb_GetFirstChildNode(parentRef);
 
-            default:
-                done = true;
-                break;
-        }
+    while (   (childRef != NULL)
+           && (childRef->shadowRef != originalRef))
+    {
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+    return childRef;
 }
 
 
@@ -1840,32 +1952,39 @@ static le_result_t SkipWhiteSpace
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean literal from the input file.
- *
- *  @return LE_OK if the literal could be read.
- *          LE_FORMAT_ERROR if the literal could not be read.
+ *  Make a version's node independent of the original it shadows, by copying over the original's
+ *  name and value, or by shadowing its children.
  */
 // -------------------------------------------------------------------------------------------------
-static bool ReadBoolToken
+static void FreezeVersionNode
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    tdb_NodeRef_t nodeRef  ///< [IN] The version's node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next = fgetc(filePtr);
+    if (IsModified(nodeRef))
+    {
+        return;
+    }
 
-    if (   (next == 't')
-        || (next == 'f'))
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
-        stringPtr[0] = next;
-        stringPtr[1] = 0;
+        ShadowChildren(nodeRef);
+    }
+    else
+    {
+        PropagateValue(nodeRef);
+    }
 
-        return LE_OK;
+    if (   (nodeRef->nameRef == NULL)
+        && (originalRef->nameRef != NULL))
+    {
+        nodeRef->nameRef = istr_AddRef(originalRef->nameRef);
     }
 
-    return LE_FORMAT_ERROR;
+    SetModifiedFlag(nodeRef);
 }
 
 
@@ -1873,67 +1992,31 @@ static bool ReadBoolToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
- *  character is found.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Called before a node of the original tree is changed, so that any version of the tree that can
+ *  see the node keeps seeing it as it is now.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadTextLiteral
+static void PreserveNode
 (
-    FILE* filePtr,        ///< [IN]  The file we're reading from.
-    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
-    signed char terminal  ///< [IN]  The terminal character we're searching for.
+    tdb_TreeRef_t treeRef,     ///< [IN] The original tree.
+    tdb_NodeRef_t originalRef  ///< [IN] The node about to be changed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-    size_t count = 0;
-
-    char* oldPtr = stringPtr;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&treeRef->versionList);
 
-    while ((next = fgetc(filePtr)) != terminal)
+    while (linkPtr != NULL)
     {
-        if (next == EOF)
-        {
-            LE_ERROR("Missing end specifier, ']' in int value.");
-            return LE_FORMAT_ERROR;
-        }
+        tdb_TreeRef_t versionRef = CONTAINER_OF(linkPtr, Tree_t, versionLink);
+        tdb_NodeRef_t nodeRef = FindVersionNode(versionRef->rootNodeRef, originalRef);
 
-        if (next == '\\')
+        if (nodeRef != NULL)
         {
-            next = fgetc(filePtr);
-
-            if (next == EOF)
-            {
-                LE_ERROR("Unexpected EOF after finding \\ character.");
-                return LE_FORMAT_ERROR;
-            }
+            FreezeVersionNode(nodeRef);
         }
 
-        *stringPtr = next;
-
-        ++stringPtr;
-        ++count;
-
-        if (count >= (stringSize - 1))
-        {
-            *stringPtr = 0;
-
-            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
-                     oldPtr,
-                     strlen(oldPtr),
-                     stringSize);
-
-            return LE_FORMAT_ERROR;
-        }
+        linkPtr = le_dls_PeekNext(&treeRef->versionList, linkPtr);
     }
-
-    *stringPtr = 0;
-
-    return LE_OK;
 }
 
 
@@ -1941,25 +2024,119 @@ static le_result_t ReadTextLiteral
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read an integer token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Merge a shadow node with the original it represents.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadIntToken
+static void MergeNode
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    tdb_TreeRef_t treeRef,  ///< [IN] The original tree being merged into.
+    tdb_NodeRef_t nodeRef   ///< [IN] The shadow node to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+    LE_ASSERT(nodeRef != NULL);
 
-    // TODO: Validate the int string.
+    // If this shadow node for some reason doesn't have a ref check for an original version of it in
+    // the original tree.  This shadow node may have been destroyed and re-created loosing this
+    // link.
+    if (nodeRef->shadowRef == NULL)
+    {
+        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
 
-    return result;
+        if (shadowedParentRef != NULL)
+        {
+            char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+            tdb_GetNodeName(nodeRef, name, sizeof(name));
+            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+        }
+    }
+
+    JournalNode(nodeRef);
+
+    // If this node has been marked as deleted, then simply drop the original node and move on.
+    if (IsDeleted(nodeRef))
+    {
+        if (   (nodeRef->shadowRef != NULL)
+            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
+        {
+            PreserveNode(treeRef, tdb_GetNodeParent(nodeRef->shadowRef));
+            ReleaseChildNode(nodeRef->shadowRef);
+        }
+        else if (nodeRef->shadowRef != NULL)
+        {
+            // We delete every node but the root node.  Since this is the root node, we just need
+            // to clear it out.
+            PreserveNode(treeRef, nodeRef->shadowRef);
+            tdb_SetEmpty(nodeRef->shadowRef);
+        }
+
+        return;
+    }
+
+    // If the original node doesn't exist, create it now.
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+
+    if (originalRef == NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef != NULL);
+        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
+
+        PreserveNode(treeRef, nodeRef->parentRef->shadowRef);
+        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
+    }
+    else
+    {
+        PreserveNode(treeRef, originalRef);
+    }
+
+    ClearModifiedFlag(originalRef);
+
+    // If the name has been changed, then copy it over now.
+    if (nodeRef->nameRef != NULL)
+    {
+        if (originalRef->nameRef != NULL)
+        {
+            istr_Release(originalRef->nameRef);
+        }
+
+        originalRef->nameRef = istr_AddRef(nodeRef->nameRef);
+
+        IndexChildName(originalRef);
+    }
+
+    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
+    // then clear out the original node.  If the types have changed, then clear out the original so
+    // that we can properly populate it again.
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != originalRef->type))
+    {
+        tdb_SetEmpty(originalRef);
+    }
+
+    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
+    // that it isn't a stem.  If not, then copy over the string value.
+    if (   (nodeType != LE_CFG_TYPE_EMPTY)
+        && (nodeType != LE_CFG_TYPE_STEM))
+    {
+        if (HasValue(nodeRef))
+        {
+            CopyValue(originalRef, nodeRef);
+
+            // Propigate over the type as that may have changed, like going from an int value to a
+            // bool value.
+
+            originalRef->type = nodeRef->type;
+        }
+    }
+
+    // Now at this point, if both the original and the shadow node are stems, we'll let the function
+    // InternalMergeTree take care of the children, (if any.)
+
+    // If the original has been cleared out, we can still just rely on InternalMergeTree to
+    // propigate over the new nodes.
 }
 
 
@@ -1967,25 +2144,59 @@ static le_result_t ReadIntToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a floating point token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Narrow a changed path summary down to the deepest node it has in common with another changed
+ *  path.  The tree's root node is as far up as a summary can go.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadFloatToken
+static void MergeChangedPath
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    char* changedPathPtr,     ///< [IN/OUT] The summary, CFG_MAX_PATH_SIZE long.  Empty if nothing
+                              ///<          has been recorded yet.
+    const char* otherPathPtr  ///< [IN] The other changed path, in the same tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+    if (changedPathPtr[0] == '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(changedPathPtr, otherPathPtr, CFG_MAX_PATH_SIZE, NULL) == LE_OK);
+        return;
+    }
 
-    // TODO: Validate the float string.
+    // Find where the paths part ways, and the last separator they have in common.
+    size_t i = 0;
+    size_t lastSeparator = 0;
 
-    return result;
+    while (   (changedPathPtr[i] != '\0')
+           && (changedPathPtr[i] == otherPathPtr[i]))
+    {
+        if (changedPathPtr[i] == '/')
+        {
+            lastSeparator = i;
+        }
+
+        i++;
+    }
+
+    // If the summary already holds the other path, it stays as it is.  If the other path holds the
+    // summary, then the summary becomes the other path.
+    if (   (changedPathPtr[i] == '\0')
+        && ((otherPathPtr[i] == '\0') || (otherPathPtr[i] == '/')))
+    {
+        return;
+    }
+
+    if (   (otherPathPtr[i] == '\0')
+        && (changedPathPtr[i] == '/'))
+    {
+        changedPathPtr[i] = '\0';
+        return;
+    }
+
+    // Otherwise the summary becomes the parent the paths share, but never goes past the root.
+    const char* rootPtr = strchr(changedPathPtr, '/');
+    size_t rootLength = (rootPtr != NULL) ? (size_t)(rootPtr - changedPathPtr) + 1 : 0;
+
+    changedPathPtr[(lastSeparator < rootLength) ? rootLength : lastSeparator] = '\0';
 }
 
 
@@ -1993,25 +2204,53 @@ static le_result_t ReadFloatToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a string from the config tree file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
+ *  given path, nothing happens.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadStringToken
+static void TriggerCallbacks
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path to search for callback registrations.
+    const char* changedPathPtr  ///< [IN] Path to the deepest node holding all of the changes made
+                                ///<      at or under this path, or NULL if it's the path itself.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+    // Read the path out of the buffer.
+    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
+    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    {
+        LE_ERROR("Callback path buffer overflow.");
+        return;
+    }
 
-    // TODO: Validate the literal string.
+    // Try to find a registration object for this path.  If one is found, flag it for calling once
+    // the merge is complete.
+    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
 
-    return result;
+    if (foundRegistrationPtr == NULL)
+    {
+        return;
+    }
+
+    if (changedPathPtr == NULL)
+    {
+        changedPathPtr = pathBuffer;
+    }
+
+    // If the registration is already waiting to be called, only its summary needs updating.
+    if (foundRegistrationPtr->triggered)
+    {
+        MergeChangedPath(foundRegistrationPtr->changedPath, changedPathPtr);
+    }
+    else
+    {
+        foundRegistrationPtr->triggered = true;
+        foundRegistrationPtr->changedPath[0] = '\0';
+        MergeChangedPath(foundRegistrationPtr->changedPath, changedPathPtr);
+
+        le_dls_Queue(&TriggeredList, &foundRegistrationPtr->triggeredLink);
+    }
 }
 
 
@@ -2019,69 +2258,66 @@ static le_result_t ReadStringToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a token from the input stream.
+ *  Go through all of the registrations that have been marked as triggered, and fire the call backs
+ *  for each of them.
  *
- *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
- *          before a token could be finished.
+ *  Once this is done, the triggered flag is cleared for next time.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadToken
+static void FireTriggeredCallbacks
 (
-    FILE* filePtr,         ///< [IN]  The file we're reading from.
-    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
-    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    *stringPtr = 0;
+    le_dls_Link_t* triggeredLinkPtr;
 
-    if (SkipWhiteSpace(filePtr) != LE_OK)
+    while ((triggeredLinkPtr = le_dls_Pop(&TriggeredList)) != NULL)
     {
-        return LE_OUT_OF_RANGE;
-    }
+        Registration_t* registrationPtr = CONTAINER_OF(triggeredLinkPtr,
+                                                       Registration_t,
+                                                       triggeredLink);
 
-    signed char next;
+        // This registration has been triggered, so call all of the handlers attached to it.
+        const char* changedPathPtr = tp_GetPathOnly(registrationPtr->changedPath);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
 
-    while ((next = fgetc(filePtr)) != EOF)
-    {
-        switch (next)
+        while (linkPtr != NULL)
         {
-            case '~':
-                *typePtr = TT_EMPTY_VALUE;
-                return LE_OK;
-
-            case '!':
-                *typePtr = TT_BOOL_VALUE;
-                return ReadBoolToken(filePtr, stringPtr, stringSize);
+            Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
 
-            case '[':
-                *typePtr = TT_INT_VALUE;
-                return ReadIntToken(filePtr, stringPtr, stringSize);
+            if (handlerObjectPtr->summaryHandlerPtr != NULL)
+            {
+                handlerObjectPtr->summaryHandlerPtr(changedPathPtr, handlerObjectPtr->contextPtr);
+            }
+            else
+            {
+                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
+            }
 
-            case '(':
-                *typePtr = TT_FLOAT_VALUE;
-                return ReadFloatToken(filePtr, stringPtr, stringSize);
+            linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+        }
 
-            case '\"':
-                *typePtr = TT_STRING_VALUE;
-                return ReadStringToken(filePtr, stringPtr, stringSize);
+        // Now that that's done, clear the triggered flag.
+        registrationPtr->triggered = false;
+    }
+}
 
-            case '{':
-                *typePtr = TT_OPEN_GROUP;
-                return LE_OK;
 
-            case '}':
-                *typePtr = TT_CLOSE_GROUP;
-                return LE_OK;
 
-            default:
-                LE_ERROR("Unexpected character in input stream.");
-                return LE_FORMAT_ERROR;
-        }
-    }
 
-    return LE_OUT_OF_RANGE;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called when the notification delay has passed, to fire the callbacks that were held back.
+ */
+// -------------------------------------------------------------------------------------------------
+static void OnNotificationTimer
+(
+    le_timer_Ref_t timerRef  ///< [IN] The timer that expired.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    FireTriggeredCallbacks();
 }
 
 
@@ -2089,83 +2325,2481 @@ static le_result_t ReadToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write data to the output stream.  This function will record any faults to the system log.
- *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  Called once a merge is complete, to fire the callbacks it triggered.  If a notification delay is
+ *  configured, they're held back until the delay has passed, so that the changes of any other
+ *  commits made in the mean time are reported along with them.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteFile
+static void NotifyChanges
 (
-    FILE* filePtr,        ///< [IN] The file being written to.
-    const void* dataPtr,  ///< [IN] The data being written to the file.
-    size_t dataSize       ///< [IN] The amount of data being written.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+    uint32_t delay = ic_GetNotificationDelay();
 
-    if (ferror(filePtr) != 0)
+    if (delay == 0)
     {
-        LE_EMERG("Failed to write to config tree file.");
-        return LE_IO_ERROR;
+        FireTriggeredCallbacks();
     }
-
-    if (written < dataSize)
+    else if (   (le_dls_IsEmpty(&TriggeredList) == false)
+             && (le_timer_IsRunning(NotificationTimer) == false))
     {
-        LE_EMERG("Data truncated while writing to configuration file.");
-        return LE_IO_ERROR;
+        LE_ASSERT(le_timer_SetMsInterval(NotificationTimer, delay) == LE_OK);
+        LE_ASSERT(le_timer_Start(NotificationTimer) == LE_OK);
     }
-
-    return LE_OK;
 }
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write a string token to the output stream.  This function will write the string and escape all
- *  control characters as it does so.
+ *  Check the given node to see if it was renamed.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @return True if the node was renamed within this transaction.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteStringValue
+static bool WasRenamed
 (
-    FILE* filePtr,         ///< [IN] The file to write to.
-    char startChar,        ///< [IN] The delimiter to use.
-    char endChar,          ///< [IN] The closing delimiter to use.
-    const char* stringPtr  ///< [IN] The actual string to write.
+    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = LE_OK;
-
-    result = WriteFile(filePtr, &startChar, 1);
+    if (IsModified(nodeRef) == false)
+    {
+        // The node wasn't even modified, so it can not have been renamed.
+        return false;
+    }
+
+    if (nodeRef->shadowRef == NULL)
+    {
+        // If the node doesn't have a shadow reference, then most likely this is a new node and not
+        // a rename of an existing one.
+        return false;
+    }
+
+    if (nodeRef->nameRef == NULL)
+    {
+        // The shadow node does not have a local copy of a name, so it can not have been renamed.
+        // It must have been modified for other reasons.
+        return false;
+    }
+
+    // Looks like the node has a new name.
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the original non-shadow node to see if it will need to be cleared during the merge.
+ *
+ *  @return True if the merge will clear out the original value.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OriginalToBeCleared
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append the name of a node onto the end of a path object.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AppendNodeName
+(
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+
+    LE_WARN_IF(result != LE_OK,
+               "Could not append node '%s' onto the update callback tracking path.  "
+               "Reason: %d, '%s'.",
+               nodeName,
+               result,
+               LE_RESULT_TXT(result));
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new config path for the tree name given.
+ *
+ *  @return A new config path, rooted on the given tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_pathIter_Ref_t CreateBasePath
+(
+    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
+
+    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
+    return le_pathIter_CreateForUnix(basePath);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Generate a config path to the given node.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GeneratePath
+(
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (nodeRef == NULL)
+    {
+        return;
+    }
+
+    GeneratePath(pathRef, nodeRef->parentRef);
+    AppendNodeName(pathRef, nodeRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Trigger callbacks for this node and all of it's children.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireAllChildren
+(
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Add this node to the path we're using to find registered callbacks.
+    AppendNodeName(pathRef, nodeRef);
+
+    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
+    // there are no callbacks registered for those nodes, then nothing will happen.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+        while (childRef != NULL)
+        {
+            FireAllChildren(pathRef, childRef);
+            childRef = tdb_GetNextSiblingNode(childRef);
+        }
+    }
+
+    // Like with the children, try to do the same for this node.  Then remove this node from the
+    // tracking path.
+    TriggerCallbacks(pathRef, NULL);
+    le_pathIter_Truncate(pathRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check a given shadow node and the original node it's shadowing.  If the original has children
+ *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
+ *  about to go away.
+ *
+ *  The algorithm employed by this function is as follows:
+ *
+ *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
+ *         mark all of the children as deleted.  (This is done with the expectation that the
+ *         original tree does not have nodes with the deleted flag set.)
+ *
+ *      2. Go through the shadow collection, and any shadow children that have links to the original
+ *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *
+ *      3. Travers the original children one more time.  For any node that is still marked as
+ *         deleted we queue up an event handler.  As this node has been removed from the colection
+ *         and will be removed as part of the final merge.  The delete flag is also cleared at this
+ *         step to ensure that there are no external side effects.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireLostChildren
+(
+    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Is the original a stem?  If no, then done.
+    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
+
+    if (originalRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
+
+    // Mark all originals deleted.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        // Children in the original tree shouldn't currently be marked as deleted.
+        LE_ASSERT(IsDeleted(originalChildRef) == false);
+
+        SetDeletedFlag(originalChildRef);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+
+    // Follow through all of the shadow links and unmark deletions.
+    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
+
+        while (shadowChildRef != NULL)
+        {
+            if (shadowChildRef->shadowRef != NULL)
+            {
+                ClearDeletedFlag(shadowChildRef->shadowRef);
+            }
+
+            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+        }
+    }
+
+    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
+    // in order to leave everything as it was.
+    originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        if (IsDeleted(originalChildRef) == true)
+        {
+            FireAllChildren(pathRef, originalChildRef);
+            ClearDeletedFlag(originalChildRef);
+        }
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *
+ *  @return True if the given node or any if it's children have been modified.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool InternalMergeTree
+(
+    tdb_TreeRef_t treeRef,      ///< [IN] The tree we're merging into.
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
+    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
+    bool forceFire,             ///< [IN] Should update handlers be fired for this node and all it's
+                                ///<      children, regardless of wether or not this node has been
+                                ///<      directly modified?
+    char* changedPathPtr        ///< [OUT] Path to the deepest node holding all of the changes made
+                                ///<       at or under this node, CFG_MAX_PATH_SIZE long.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool isModified = IsModified(nodeRef);
+    bool isSelfModified = isModified;
+    bool renamed = WasRenamed(nodeRef);
+
+    changedPathPtr[0] = '\0';
+
+    // If this node was renamed, then all children also need to be triggered as well.
+    forceFire = renamed || forceFire;
+
+    // If this node has been renamed, marked as deleted or set empty, then all of the children need
+    // notifications fired on the original nodes.
+    if (   (renamed == true)
+        || (IsDeleted(nodeRef) == true)
+        || (OriginalToBeCleared(nodeRef) == true))
+    {
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeRef->name);
+
+        if (nodeRef->shadowRef != NULL)
+        {
+            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
+            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+        }
+
+        le_pathIter_Delete(originalPathRef);
+    }
+    else if (   (isModified == true)
+             && (nodeRef->type == LE_CFG_TYPE_STEM))
+    {
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeRef->name);
+
+        GeneratePath(originalPathRef, nodeRef->shadowRef);
+        FireLostChildren(originalPathRef, nodeRef);
+
+        le_pathIter_Delete(originalPathRef);
+    }
+
+    AppendNodeName(pathRef, nodeRef);
+
+    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
+    // track of whether any of those children have been modified as well.
+    if (isModified)
+    {
+        MergeNode(treeRef, nodeRef);
+    }
+
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
+    {
+        char childChangedPath[CFG_MAX_PATH_SIZE];
+
+        nodeRef = tdb_GetFirstChildNode(nodeRef);
+
+        while (nodeRef != NULL)
+        {
+            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
+
+            if (InternalMergeTree(treeRef, pathRef, nodeRef, forceFire, childChangedPath))
+            {
+                isModified = true;
+                MergeChangedPath(changedPathPtr, childChangedPath);
+            }
+
+            nodeRef = nextNodeRef;
+        }
+    }
+
+    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
+    // be registered.  Unless the changes were all made under one child, they're summarized as a
+    // change to this node.
+    if (isModified || forceFire)
+    {
+        if (   isSelfModified
+            || forceFire
+            || (changedPathPtr[0] == '\0'))
+        {
+            if (le_pathIter_GetPath(pathRef, changedPathPtr, CFG_MAX_PATH_SIZE) != LE_OK)
+            {
+                changedPathPtr[0] = '\0';
+            }
+        }
+
+        TriggerCallbacks(pathRef, (changedPathPtr[0] != '\0') ? changedPathPtr : NULL);
+    }
+
+    // Now remove this node from the tracking path and let our caller know if any modifications have
+    // happened at this level or lower.
+    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
+    {
+        le_pathIter_Truncate(pathRef);
+    }
+
+    return isModified;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new tree object and set it to default values.
+ *
+ *  @return A ref to the newly created tree object.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t NewTree
+(
+    const char* treeNameRef,   ///< [IN] The name of the new tree.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
+
+    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+
+    treeRef->isDeletePending = false;
+    treeRef->originalTreeRef = NULL;
+    treeRef->revisionId = 0;
+    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
+    treeRef->activeReadCount = 0;
+    treeRef->activeWriteIterRef = NULL;
+    treeRef->requestList = LE_SLS_LIST_INIT;
+    treeRef->snapshotSize = 0;
+    treeRef->journalSize = 0;
+    treeRef->isSaveFailed = false;
+    treeRef->isVersion = false;
+    treeRef->versionList = LE_DLS_LIST_INIT;
+    treeRef->versionLink = LE_DLS_LINK_INIT;
+
+    return treeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree object is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+
+    // Kill the root node.
+    le_mem_Release(treeRef->rootNodeRef);
+    treeRef->rootNodeRef = NULL;
+
+    // A version holds a reference to its original tree, so it can be dropped from the original's
+    // list now.
+    if (treeRef->isVersion)
+    {
+        le_dls_Remove(&treeRef->originalTreeRef->versionList, &treeRef->versionLink);
+        le_mem_Release(treeRef->originalTreeRef);
+    }
+
+    // Sanity check, is the tree actually ready to clean up?
+    LE_ASSERT(treeRef->activeReadCount == 0);
+    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
+    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+    LE_ASSERT(le_dls_IsEmpty(&treeRef->versionList) == true);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a tree file with the given revision id.
+ *
+ *  @return A stringBuffer backed string containing the full path to the tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetTreePath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // paper    --> rock       1 -> 2
+    // rock     --> scissors   2 -> 3
+    // scissors --> paper      3 -> 1
+
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    int printSize;
+
+    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+
+    printSize = snprintf(pathBuffer,
+                         pathSize,
+                         "%s/%s.%s",
+                         CFG_TREE_PATH,
+                         treeNameRef,
+                         revNames[revisionId - 1]);
+
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree path in buffer");
+       pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a tree's journal file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetJournalPath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int printSize = snprintf(pathBuffer, pathSize, "%s/%s.journal", CFG_TREE_PATH, treeNameRef);
+
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree journal path in buffer");
+       pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check to see if a configTree file at the given revision already exists in the filesystem.
+ *
+ *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *
+ *  @return True if the named file exists, false otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool TreeFileExists
+(
+    const char* treeNameRef,  ///< [IN] Name of the tree to check.
+    int revisionId            ///< [IN] The revision of the tree to check against.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+
+    // Make sure this part was successful.
+    if (fullPath[0] == '\0')
+    {
+        return false;
+    }
+
+    // stat() the file to see if it exists and get its size.
+    struct stat s;
+    if (stat(fullPath, &s) == -1)
+    {
+        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        return false;
+    }
+
+    // Make sure it's a regular file.
+    if (!S_ISREG(s.st_mode))
+    {
+        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+    }
+
+    // If it's zero size, delete it and report that it doesn't exist.
+    if (s.st_size == 0)
+    {
+        if (unlink(fullPath) == -1)
+        {
+            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
+        }
+
+        return false;
+    }
+
+    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Check the filesystem and get the current "valid" version of the file and update the tree object
+ * with that version number.
+ *
+ * If there are two files for a given tree, we use the older one.  The idea being, if there are
+ * two versions of the same file in the filesystem then there was a system failure during a save
+ * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
+ * unless the size of the older file is zero, which can happen if deletion of that file is
+ * interrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void UpdateRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int newRevision = 0;
+
+    if (TreeFileExists(treeRef->name, 1))
+    {
+        if (TreeFileExists(treeRef->name, 3))
+        {
+            newRevision = 3;
+        }
+        else
+        {
+            newRevision = 1;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 3))
+    {
+        if (TreeFileExists(treeRef->name, 2))
+        {
+            newRevision = 2;
+        }
+        else
+        {
+            newRevision = 3;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 2))
+    {
+        newRevision = 2;
+    }
+
+    treeRef->revisionId = newRevision;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Peek into the input stream one character ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+static signed char PeekChar
+(
+    FILE* filePtr  ///< [IN] The file stream to peek into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char next = fgetc(filePtr);
+    ungetc(next, filePtr);
+
+    return next;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *
+ *  @return LE_OK if the whitespace is skiped and there is still more file to read.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipWhiteSpace
+(
+    FILE* filePtr  ///< [IN] The file stream to seek through.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool done = false;
+    bool isEof = false;
+
+    while (done == false)
+    {
+        switch (PeekChar(filePtr))
+        {
+            case '\n':
+            case '\r':
+            case '\t':
+            case ' ':
+                // Eat the character.
+                fgetc(filePtr);
+                break;
+
+            case EOF:
+                done = true;
+                isEof = true;
+                break;
+
+            default:
+                done = true;
+                break;
+        }
+    }
+
+    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a boolean literal from the input file.
+ *
+ *  @return LE_OK if the literal could be read.
+ *          LE_FORMAT_ERROR if the literal could not be read.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadBoolToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next = fgetc(filePtr);
+
+    if (   (next == 't')
+        || (next == 'f'))
+    {
+        stringPtr[0] = next;
+        stringPtr[1] = 0;
+
+        return LE_OK;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
+ *  character is found.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTextLiteral
+(
+    FILE* filePtr,        ///< [IN]  The file we're reading from.
+    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
+    signed char terminal  ///< [IN]  The terminal character we're searching for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next;
+    size_t count = 0;
+
+    char* oldPtr = stringPtr;
+
+    while ((next = fgetc(filePtr)) != terminal)
+    {
+        if (next == EOF)
+        {
+            LE_ERROR("Missing end specifier, ']' in int value.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (next == '\\')
+        {
+            next = fgetc(filePtr);
+
+            if (next == EOF)
+            {
+                LE_ERROR("Unexpected EOF after finding \\ character.");
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        *stringPtr = next;
+
+        ++stringPtr;
+        ++count;
+
+        if (count >= (stringSize - 1))
+        {
+            *stringPtr = 0;
+
+            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
+                     oldPtr,
+                     strlen(oldPtr),
+                     stringSize);
+
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    *stringPtr = 0;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an integer token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadIntToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+
+    // TODO: Validate the int string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a floating point token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadFloatToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+
+    // TODO: Validate the float string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a string from the config tree file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadStringToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+
+    // TODO: Validate the literal string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a token from the input stream.
+ *
+ *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
+ *          before a token could be finished.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadToken
+(
+    FILE* filePtr,         ///< [IN]  The file we're reading from.
+    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
+    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *stringPtr = 0;
+
+    if (SkipWhiteSpace(filePtr) != LE_OK)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != EOF)
+    {
+        switch (next)
+        {
+            case '~':
+                *typePtr = TT_EMPTY_VALUE;
+                return LE_OK;
+
+            case '!':
+                *typePtr = TT_BOOL_VALUE;
+                return ReadBoolToken(filePtr, stringPtr, stringSize);
+
+            case '[':
+                *typePtr = TT_INT_VALUE;
+                return ReadIntToken(filePtr, stringPtr, stringSize);
+
+            case '(':
+                *typePtr = TT_FLOAT_VALUE;
+                return ReadFloatToken(filePtr, stringPtr, stringSize);
+
+            case '\"':
+                *typePtr = TT_STRING_VALUE;
+                return ReadStringToken(filePtr, stringPtr, stringSize);
+
+            case '{':
+                *typePtr = TT_OPEN_GROUP;
+                return LE_OK;
+
+            case '}':
+                *typePtr = TT_CLOSE_GROUP;
+                return LE_OK;
+
+            default:
+                LE_ERROR("Unexpected character in input stream.");
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OUT_OF_RANGE;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write data to the output stream.  This function will record any faults to the system log.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteFile
+(
+    FILE* filePtr,        ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+
+    if (ferror(filePtr) != 0)
+    {
+        LE_EMERG("Failed to write to config tree file.");
+        return LE_IO_ERROR;
+    }
+
+    if (written < dataSize)
+    {
+        LE_EMERG("Data truncated while writing to configuration file.");
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a string token to the output stream.  This function will write the string and escape all
+ *  control characters as it does so.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteStringValue
+(
+    FILE* filePtr,         ///< [IN] The file to write to.
+    char startChar,        ///< [IN] The delimiter to use.
+    char endChar,          ///< [IN] The closing delimiter to use.
+    const char* stringPtr  ///< [IN] The actual string to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    result = WriteFile(filePtr, &startChar, 1);
+
+    while (   (*stringPtr != 0)
+           && (result == LE_OK))
+    {
+        if (   (*stringPtr == '\"')
+            || (*stringPtr == '\\'))
+        {
+            result = WriteFile(filePtr, "\\", 1);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, stringPtr, 1);
+        }
+
+        stringPtr++;
+    }
+
+    if (result == LE_OK)
+    {
+        char strBuffer[2] = { endChar, ' ' };
+        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called once a node has been read in from an import.  Nodes read into a shadow tree are marked
+ *  as modified so they're merged on commit, and the node is made sure to exist.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FinishReadNode
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node that was read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
+
+    tdb_EnsureExists(nodeRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value from the given file.  If the value is a collection, then read in those nodes
+ *  too.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if parse errors are encountered.
+ *          LE_NOT_FOUND if the end of file is reached.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalReadNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
+    FILE* filePtr,          ///< [IN] The file we're reading the value from.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    TokenType_t tokenType;
+
+    // Try to read this node's value.
+    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    {
+        LE_ERROR("Unexpected EOF or bad token in file.");
+        return LE_FORMAT_ERROR;
+    }
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (tokenType)
+    {
+        case TT_BOOL_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_BOOL;
+            break;
+
+        case TT_INT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_INT;
+            break;
+
+        case TT_FLOAT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_FLOAT;
+            break;
+
+        case TT_STRING_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            break;
+
+        case TT_EMPTY_VALUE:
+            // The node has already been cleared, so there's nothing left to do but make sure that
+            // the node exists.
+            ClearDeletedFlag(nodeRef);
+            break;
+
+        case TT_OPEN_GROUP:
+            while (tokenType != TT_CLOSE_GROUP)
+            {
+                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+                {
+                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+
+                if (tokenType == TT_STRING_VALUE)
+                {
+                    size_t strLen = le_utf8_NumBytes(stringBuffer);
+                    size_t newPathLen = pathLen + 1 + strLen;
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
+                                 stringBuffer,
+                                 strLen,
+                                 (size_t)LE_CFG_STR_LEN);
+
+                        return LE_FORMAT_ERROR;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                            return LE_FORMAT_ERROR;
+                        }
+
+                        LE_DEBUG("New node, %s", stringBuffer);
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        return result;
+                    }
+                }
+                else if (tokenType == TT_CLOSE_GROUP)
+                {
+                    break;
+                }
+                else
+                {
+                    LE_ERROR("Unexpected token in found while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+            }
+            break;
+
+        case TT_CLOSE_GROUP:
+        default:
+            LE_ERROR("Unexpected token found.");
+            return LE_FORMAT_ERROR;
+    }
+
+    FinishReadNode(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a file in the filesystem.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalWriteNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
+    FILE* filePtr           ///< [IN] The file being written to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If there is no node to write, or if the node is marked as having been deleted...  Then write
+    // a blank node.
+    if (   (nodeRef == NULL)
+        || (IsDeleted(nodeRef) == true))
+    {
+        return WriteFile(filePtr, "~ ", 2);
+    }
+
+    // Get the node's value as a string.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = LE_OK;
+
+    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+
+    // Now, depending on the type of node, write out any required format information.
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            result = WriteFile(filePtr, "~ ", 2);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            {
+                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
+                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+            }
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
+            break;
+
+        // Looks like this node is a collection, so write out it's child nodes now.
+        case LE_CFG_TYPE_STEM:
+            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                while (   (childRef != NULL)
+                       && (result == LE_OK))
+                {
+                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
+                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+
+                    if (result == LE_OK)
+                    {
+                        result = InternalWriteNode(childRef, filePtr);
+                    }
+
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                if (result == LE_OK)
+                {
+                    result = WriteFile(filePtr, "} ", 2);
+                }
+            }
+            break;
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a tree node and it's children to a snapshot.  Children that were never loaded from the
+ *  tree's last snapshot are copied straight from it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddSnapshotNode
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The snapshot being built.
+    uint32_t index,                ///< [IN] The node's record in the snapshot.
+    tdb_NodeRef_t nodeRef          ///< [IN] The node being added.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    istr_Ref_t nameRef = GetNameRef(nodeRef);
+    const char* namePtr = (nameRef == NULL) ? NULL : istr_GetText(nameRef);
+
+    if (nodeRef->snapRef != NULL)
+    {
+        snap_CopyNode(builderRef, index, namePtr, nodeRef->snapRef, nodeRef->snapIndex);
+        return;
+    }
+
+    if (IsDeleted(nodeRef))
+    {
+        snap_SetValue(builderRef, index, namePtr, LE_CFG_TYPE_EMPTY, NULL);
+        return;
+    }
+
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        const char* valuePtr = NULL;
+
+        if (IsStringType(nodeRef))
+        {
+            valuePtr = GetValueText(nodeRef);
+        }
+
+        snap_SetValue(builderRef, index, namePtr, nodeRef->type, valuePtr);
+        return;
+    }
+
+    // The children of a stem take consecutive records, so count them first.
+    uint32_t count = 0;
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        count++;
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    uint32_t childIndex = snap_AddChildren(builderRef, index, namePtr, count);
+
+    childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        AddSnapshotNode(builderRef, childIndex, childRef);
+
+        childIndex++;
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Build a snapshot of a tree as it is now, ready to be written to the filesystem.
+ *
+ *  @return The snapshot's builder.
+ */
+// -------------------------------------------------------------------------------------------------
+static snap_BuilderRef_t BuildSnapshot
+(
+    tdb_NodeRef_t rootRef  ///< [IN] The root node of the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    snap_BuilderRef_t builderRef = snap_CreateBuilder();
+
+    AddSnapshotNode(builderRef, SNAP_ROOT_INDEX, rootRef);
+
+    return builderRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a node and it's children to a snapshot being exported.  Unlike AddSnapshotNode(), this
+ *  goes through the accessors, so it works for the nodes of shadow trees and versions too.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddExportNode
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The snapshot being built.
+    uint32_t index,                ///< [IN] The node's record in the snapshot.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the snapshot's root.
+    tdb_NodeRef_t nodeRef          ///< [IN] The node being added, may be NULL.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // The value is added to the snapshot before recursing, so the buffer can be shared.
+    static char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            tdb_GetValueAsString(nodeRef, valueBuffer, sizeof(valueBuffer), "");
+            snap_SetValue(builderRef, index, namePtr, type, valueBuffer);
+            return;
+
+        case LE_CFG_TYPE_STEM:
+            break;
+
+        default:
+            snap_SetValue(builderRef, index, namePtr, LE_CFG_TYPE_EMPTY, NULL);
+            return;
+    }
+
+    uint32_t count = 0;
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        count++;
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    uint32_t childIndex = snap_AddChildren(builderRef, index, namePtr, count);
+
+    childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        char childName[LE_CFG_NAME_LEN_BYTES] = "";
+
+        tdb_GetNodeName(childRef, childName, sizeof(childName));
+        AddExportNode(builderRef, childIndex, childName, childRef);
+
+        childIndex++;
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node, and everything under it, from a snapshot being imported.
+ *
+ *  @return LE_OK if the node was read, LE_FORMAT_ERROR if the snapshot holds bad node names or
+ *          paths that are too long.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ImportSnapshotNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to read into.
+    snap_Ref_t snapRef,     ///< [IN] The snapshot.
+    uint32_t index,         ///< [IN] The node's record in the snapshot.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t type = snap_GetType(snapRef, index);
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+        case LE_CFG_TYPE_STRING:
+            tdb_SetValueAsString(nodeRef, snap_GetValue(snapRef, index));
+            nodeRef->type = type;
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            {
+                uint32_t firstIndex;
+                uint32_t count = snap_GetChildren(snapRef, index, &firstIndex);
+
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const char* namePtr = snap_GetName(snapRef, firstIndex + i);
+                    size_t newPathLen = pathLen + 1 + le_utf8_NumBytes(namePtr);
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.", namePtr);
+                        return LE_FORMAT_ERROR;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, namePtr);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+
+                        if (tdb_SetNodeName(childRef, namePtr) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", namePtr);
+                            return LE_FORMAT_ERROR;
+                        }
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    le_result_t result = ImportSnapshotNode(childRef,
+                                                            snapRef,
+                                                            firstIndex + i,
+                                                            newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        return result;
+                    }
+                }
+            }
+            break;
+
+        default:
+            ClearDeletedFlag(nodeRef);
+            break;
+    }
+
+    FinishReadNode(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a node, and everything under it, as a JSON object.  Stems and empty nodes are written
+ *  with an array of children, other nodes with their value.  A tree's root node has no name, and
+ *  is written with the type "tree".  A node that doesn't exist is written as an empty object.
+ */
+// -------------------------------------------------------------------------------------------------
+static void WriteJsonNode
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    tdb_NodeRef_t nodeRef           ///< [IN] The node being written, may be NULL.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Values and names are copied by the writer before recursing, so the buffer can be shared.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+
+    le_json_WriteObjectStart(writerRef);
+
+    if (type == LE_CFG_TYPE_DOESNT_EXIST)
+    {
+        le_json_WriteObjectEnd(writerRef);
+        return;
+    }
+
+    tdb_GetNodeName(nodeRef, stringBuffer, sizeof(stringBuffer));
+
+    le_json_WriteMemberName(writerRef, JSON_FIELD_NAME);
+    le_json_WriteString(writerRef, stringBuffer);
+    le_json_WriteMemberName(writerRef, JSON_FIELD_TYPE);
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_BOOL:
+            le_json_WriteString(writerRef, "bool");
+            le_json_WriteMemberName(writerRef, JSON_FIELD_VALUE);
+            le_json_WriteBool(writerRef, tdb_GetValueAsBool(nodeRef, false));
+            break;
+
+        case LE_CFG_TYPE_INT:
+            le_json_WriteString(writerRef, "int");
+            le_json_WriteMemberName(writerRef, JSON_FIELD_VALUE);
+            le_json_WriteNumber(writerRef, tdb_GetValueAsInt(nodeRef, 0));
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            le_json_WriteString(writerRef, "float");
+            le_json_WriteMemberName(writerRef, JSON_FIELD_VALUE);
+            le_json_WriteNumber(writerRef, tdb_GetValueAsFloat(nodeRef, 0.0));
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            le_json_WriteString(writerRef, "string");
+            le_json_WriteMemberName(writerRef, JSON_FIELD_VALUE);
+            tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+            le_json_WriteString(writerRef, stringBuffer);
+            break;
+
+        default:
+            {
+                bool isTree = (type == LE_CFG_TYPE_STEM) && (stringBuffer[0] == '\0');
+
+                le_json_WriteString(writerRef, isTree ? "tree" : "stem");
+                le_json_WriteMemberName(writerRef, JSON_FIELD_CHILDREN);
+                le_json_WriteArrayStart(writerRef);
+
+                tdb_NodeRef_t childRef = NULL;
+
+                if (type == LE_CFG_TYPE_STEM)
+                {
+                    childRef = tdb_GetFirstActiveChildNode(nodeRef);
+                }
+
+                while (childRef != NULL)
+                {
+                    WriteJsonNode(writerRef, childRef);
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                le_json_WriteArrayEnd(writerRef);
+            }
+            break;
+    }
+
+    le_json_WriteObjectEnd(writerRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append a unicode code point to a string as UTF-8.
+ *
+ *  @return LE_OK if the code point fit, LE_OVERFLOW if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t AppendUtf8
+(
+    char* destPtr,      ///< [IN] The string.
+    size_t destSize,    ///< [IN] The size of the string's buffer.
+    size_t* lenPtr,     ///< [IN/OUT] The length of the string so far.
+    uint32_t codePoint  ///< [IN] The code point to add.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char bytes[4];
+    size_t count;
+
+    if (codePoint < 0x80)
+    {
+        bytes[0] = (char)codePoint;
+        count = 1;
+    }
+    else if (codePoint < 0x800)
+    {
+        bytes[0] = (char)(0xC0 | (codePoint >> 6));
+        bytes[1] = (char)(0x80 | (codePoint & 0x3F));
+        count = 2;
+    }
+    else if (codePoint < 0x10000)
+    {
+        bytes[0] = (char)(0xE0 | (codePoint >> 12));
+        bytes[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (codePoint & 0x3F));
+        count = 3;
+    }
+    else
+    {
+        bytes[0] = (char)(0xF0 | (codePoint >> 18));
+        bytes[1] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        bytes[2] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        bytes[3] = (char)(0x80 | (codePoint & 0x3F));
+        count = 4;
+    }
+
+    if (*lenPtr + count >= destSize)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(destPtr + *lenPtr, bytes, count);
+    *lenPtr += count;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read the four hex digits of a unicode escape sequence.
+ *
+ *  @return True if there were four hex digits, false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadHex4
+(
+    const char* srcPtr,  ///< [IN] The digits.
+    uint32_t* valuePtr   ///< [OUT] Their value.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *valuePtr = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        char c = srcPtr[i];
+        uint32_t digit;
+
+        if ((c >= '0') && (c <= '9'))
+        {
+            digit = c - '0';
+        }
+        else if ((c >= 'a') && (c <= 'f'))
+        {
+            digit = c - 'a' + 10;
+        }
+        else if ((c >= 'A') && (c <= 'F'))
+        {
+            digit = c - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+
+        *valuePtr = (*valuePtr << 4) | digit;
+    }
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Copy a string out of a JSON document tree, decoding its escape sequences on the way.
+ *
+ *  @return LE_OK if the string was copied.
+ *          LE_OVERFLOW if the string doesn't fit in the buffer.
+ *          LE_FORMAT_ERROR if the string holds a bad escape sequence.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t DecodeJsonString
+(
+    const char* srcPtr,  ///< [IN] The string, as it appears in the document.
+    char* destPtr,       ///< [OUT] The decoded string.
+    size_t destSize      ///< [IN] The size of the buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t len = 0;
+
+    while (*srcPtr != '\0')
+    {
+        uint32_t codePoint = (unsigned char)*srcPtr++;
+
+        if (codePoint == '\\')
+        {
+            char escape = *srcPtr++;
+
+            switch (escape)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    codePoint = escape;
+                    break;
+
+                case 'b':
+                    codePoint = '\b';
+                    break;
+
+                case 'f':
+                    codePoint = '\f';
+                    break;
+
+                case 'n':
+                    codePoint = '\n';
+                    break;
+
+                case 'r':
+                    codePoint = '\r';
+                    break;
+
+                case 't':
+                    codePoint = '\t';
+                    break;
+
+                case 'u':
+                    {
+                        if ((ReadHex4(srcPtr, &codePoint) == false) || (codePoint == 0))
+                        {
+                            return LE_FORMAT_ERROR;
+                        }
+
+                        srcPtr += 4;
+
+                        // Characters outside of the basic plane come as a pair of surrogates.
+                        uint32_t lowSurrogate;
+
+                        if (   (codePoint >= 0xD800)
+                            && (codePoint < 0xDC00)
+                            && (srcPtr[0] == '\\')
+                            && (srcPtr[1] == 'u')
+                            && (ReadHex4(srcPtr + 2, &lowSurrogate))
+                            && (lowSurrogate >= 0xDC00)
+                            && (lowSurrogate < 0xE000))
+                        {
+                            codePoint = 0x10000
+                                      + ((codePoint - 0xD800) << 10)
+                                      + (lowSurrogate - 0xDC00);
+                            srcPtr += 6;
+                        }
+                    }
+                    break;
+
+                default:
+                    return LE_FORMAT_ERROR;
+            }
+
+            if (AppendUtf8(destPtr, destSize, &len, codePoint) != LE_OK)
+            {
+                return LE_OVERFLOW;
+            }
+        }
+        else
+        {
+            if (len + 1 >= destSize)
+            {
+                return LE_OVERFLOW;
+            }
+
+            destPtr[len++] = (char)codePoint;
+        }
+    }
+
+    destPtr[len] = '\0';
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node, and everything under it, from a JSON object.  The children of a stem are merged
+ *  into the node's existing children, but a child that already holds a value can't be replaced.
+ *
+ *  @return LE_OK if the node was read.
+ *          LE_FORMAT_ERROR if the object isn't laid out as expected, or holds a bad name or value.
+ *          LE_NOT_POSSIBLE if a child conflicts with an existing node.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ImportJsonNode
+(
+    tdb_NodeRef_t nodeRef,        ///< [IN] The node to read into.
+    le_json_NodeRef_t objectRef,  ///< [IN] The JSON object to read from.
+    size_t pathLen                ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Each string is used before recursing, so the buffer can be shared.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    const char* typePtr = le_json_GetNodeString(le_json_FindNodeMember(objectRef,
+                                                                       JSON_FIELD_TYPE));
+    le_json_NodeRef_t valueRef = le_json_FindNodeMember(objectRef, JSON_FIELD_VALUE);
+
+    if (typePtr == NULL)
+    {
+        LE_ERROR("JSON node has no type.");
+        return LE_FORMAT_ERROR;
+    }
+
+    le_json_ContextType_t valueType = LE_JSON_CONTEXT_NULL;
+
+    if (valueRef != NULL)
+    {
+        valueType = le_json_GetNodeType(valueRef);
+    }
+
+    if (strcmp(typePtr, "bool") == 0)
+    {
+        if ((valueType != LE_JSON_CONTEXT_TRUE) && (valueType != LE_JSON_CONTEXT_FALSE))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        tdb_SetValueAsBool(nodeRef, valueType == LE_JSON_CONTEXT_TRUE);
+    }
+    else if (strcmp(typePtr, "int") == 0)
+    {
+        if (valueType != LE_JSON_CONTEXT_NUMBER)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        tdb_SetValueAsInt(nodeRef, (int32_t)le_json_GetNodeNumber(valueRef));
+    }
+    else if (strcmp(typePtr, "float") == 0)
+    {
+        if (valueType != LE_JSON_CONTEXT_NUMBER)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        tdb_SetValueAsFloat(nodeRef, le_json_GetNodeNumber(valueRef));
+    }
+    else if (strcmp(typePtr, "string") == 0)
+    {
+        if (   (valueType != LE_JSON_CONTEXT_STRING)
+            || (DecodeJsonString(le_json_GetNodeString(valueRef),
+                                 stringBuffer,
+                                 sizeof(stringBuffer)) != LE_OK))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        tdb_SetValueAsString(nodeRef, stringBuffer);
+    }
+    else if ((strcmp(typePtr, "stem") == 0) || (strcmp(typePtr, "tree") == 0))
+    {
+        le_json_NodeRef_t childrenRef = le_json_FindNodeMember(objectRef, JSON_FIELD_CHILDREN);
+        size_t count = le_json_GetNodeCount(childrenRef);
+
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
+        {
+            tdb_SetEmpty(nodeRef);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            le_json_NodeRef_t childObjectRef = le_json_GetNodeChild(childrenRef, i);
+            const char* namePtr = le_json_GetNodeString(le_json_FindNodeMember(childObjectRef,
+                                                                               JSON_FIELD_NAME));
+
+            if (   (namePtr == NULL)
+                || (DecodeJsonString(namePtr, stringBuffer, LE_CFG_NAME_LEN_BYTES) != LE_OK)
+                || (stringBuffer[0] == '\0')
+                || (strcmp(stringBuffer, ".") == 0)
+                || (strcmp(stringBuffer, "..") == 0))
+            {
+                LE_ERROR("Bad or missing node name in JSON.");
+                return LE_FORMAT_ERROR;
+            }
+
+            size_t newPathLen = pathLen + 1 + le_utf8_NumBytes(stringBuffer);
+
+            if (newPathLen > LE_CFG_STR_LEN)
+            {
+                LE_ERROR("New path length for node '%s' is too long.", stringBuffer);
+                return LE_FORMAT_ERROR;
+            }
+
+            tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+            if (childRef == NULL)
+            {
+                childRef = CreateNamedChild(nodeRef, stringBuffer);
+
+                if (childRef == NULL)
+                {
+                    LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                    return LE_FORMAT_ERROR;
+                }
+            }
+            else
+            {
+                le_cfg_nodeType_t existingType = tdb_GetNodeType(childRef);
+
+                if (   (existingType != LE_CFG_TYPE_DOESNT_EXIST)
+                    && (existingType != LE_CFG_TYPE_STEM)
+                    && (existingType != LE_CFG_TYPE_EMPTY))
+                {
+                    LE_ERROR("Node conflict when importing, at node '%s'.", stringBuffer);
+                    return LE_NOT_POSSIBLE;
+                }
+            }
+
+            tdb_EnsureExists(childRef);
+
+            le_result_t result = ImportJsonNode(childRef, childObjectRef, newPathLen);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+
+        FinishReadNode(nodeRef);
+    }
+    else
+    {
+        LE_ERROR("Unknown JSON node type '%s'.", typePtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Calculate the number of bytes required to store a node path, including seperators and a trailing
+ *  NULL.
+ *
+ *  @return The amount of bytes required to store the whole path string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ComputePathLength
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = 0;
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    while (nodeRef != NULL)
+    {
+        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+
+        // Add this path segment's length to our running total, along with the required path
+        // seperator.
+        pathLen += 1 + le_utf8_NumBytes(nodeName);
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    // Don't forget to include a spot for the trailing NULL.
+    return pathLen + 1;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Bump up the version id of this tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void IncrementRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef->revisionId++;
+
+    if (treeRef->revisionId > 3)
+    {
+        treeRef->revisionId = 1;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the node a journal entry applies to, creating it and any missing parents if asked to.
+ *
+ *  @return The node, or NULL if it couldn't be found or created.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t FindJournalNode
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] The root of the tree.
+    const char* pathPtr,    ///< [IN] Absolute path to the node.
+    bool create             ///< [IN] Create the node if it doesn't exist?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix(pathPtr);
+    tdb_NodeRef_t currentRef = rootRef;
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+    le_result_t result = le_pathIter_GoToStart(pathRef);
+
+    while (   (result != LE_NOT_FOUND)
+           && (currentRef != NULL))
+    {
+        result = le_pathIter_GetCurrentNode(pathRef, name, sizeof(name));
+
+        if (result != LE_OK)
+        {
+            currentRef = NULL;
+            break;
+        }
+
+        tdb_NodeRef_t childRef = GetNamedChild(currentRef, name);
 
-    while (   (*stringPtr != 0)
-           && (result == LE_OK))
+        if (   (childRef == NULL)
+            && (create)
+            && (   (currentRef->type == LE_CFG_TYPE_STEM)
+                || (currentRef->type == LE_CFG_TYPE_EMPTY)))
+        {
+            childRef = NewChildNode(currentRef);
+            childRef->nameRef = istr_Get(name);
+            IndexChildName(childRef);
+        }
+
+        currentRef = childRef;
+        result = le_pathIter_GoToNext(pathRef);
+    }
+
+    le_pathIter_Delete(pathRef);
+
+    return currentRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply an entry from a tree's journal to the tree.  This makes the same change to the node as
+ *  MergeNode() made when the entry was recorded.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ApplyJournalEntry
+(
+    const jrnl_Entry_t* entryPtr,  ///< [IN] The entry.
+    void* contextPtr               ///< [IN] The tree being loaded.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = contextPtr;
+    tdb_NodeRef_t nodeRef = FindJournalNode(treeRef->rootNodeRef,
+                                            entryPtr->pathPtr,
+                                            entryPtr->op == JRNL_SET_NODE);
+
+    if (nodeRef == NULL)
+    {
+        if (entryPtr->op == JRNL_SET_NODE)
+        {
+            LE_ERROR("Can't apply journal entry for '%s:%s'.", treeRef->name, entryPtr->pathPtr);
+        }
+
+        return;
+    }
+
+    switch (entryPtr->op)
+    {
+        case JRNL_DELETE_NODE:
+            if (nodeRef->parentRef != NULL)
+            {
+                le_mem_Release(nodeRef);
+            }
+            else
+            {
+                tdb_SetEmpty(nodeRef);
+            }
+            break;
+
+        case JRNL_SET_NODE:
+            ClearModifiedFlag(nodeRef);
+
+            if (   (entryPtr->newNamePtr != NULL)
+                && (nodeRef->parentRef != NULL))
+            {
+                if (nodeRef->nameRef != NULL)
+                {
+                    istr_Release(nodeRef->nameRef);
+                }
+
+                nodeRef->nameRef = istr_Get(entryPtr->newNamePtr);
+                IndexChildName(nodeRef);
+            }
+
+            if (   (entryPtr->type == LE_CFG_TYPE_EMPTY)
+                || (entryPtr->type != nodeRef->type))
+            {
+                tdb_SetEmpty(nodeRef);
+            }
+
+            if (   (entryPtr->valuePtr != NULL)
+                && (entryPtr->type != LE_CFG_TYPE_EMPTY)
+                && (entryPtr->type != LE_CFG_TYPE_STEM))
+            {
+                SetValueText(nodeRef, entryPtr->valuePtr);
+                nodeRef->type = entryPtr->type;
+            }
+            break;
+
+        default:
+            LE_ERROR("Unknown journal entry, %d, for '%s:%s'.",
+                     entryPtr->op,
+                     treeRef->name,
+                     entryPtr->pathPtr);
+            break;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Replay a tree's journal on top of the tree that has just been loaded.  A tree without a
+ *  revision hasn't been saved, so any journal it has is stale and is deleted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReplayJournal
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that was loaded.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, pathPtr, sizeof(pathPtr));
+
+    if (pathPtr[0] == '\0')
+    {
+        return;
+    }
+
+    if (treeRef->revisionId == 0)
+    {
+        jrnl_Delete(pathPtr);
+        treeRef->journalSize = 0;
+        return;
+    }
+
+    jrnl_Replay(pathPtr, treeRef->revisionId, ApplyJournalEntry, treeRef, &treeRef->journalSize);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the size of an open file.
+ *
+ *  @return The size in bytes, or 0 if it can't be found.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t GetFileSize
+(
+    int descriptor  ///< [IN] The file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    struct stat s;
+
+    if (fstat(descriptor, &s) == -1)
+    {
+        LE_ERROR("Can't stat config tree file (%m).");
+        return 0;
+    }
+
+    return s.st_size;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Attempt to load a configuration tree from a config file.  This function will look for the latest
+ *  valid version of the config file and load that one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void LoadTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the tree was deleted, its files may not all be gone yet.
+    tw_Flush(treeRef->name);
+
+    // If we don't know the revision then hunt it out from the filesystem.
+    if (treeRef->revisionId == 0)
+    {
+        UpdateRevision(treeRef);
+    }
+
+    // If this tree has no root, create it now.
+    if (treeRef->rootNodeRef == NULL)
+    {
+        treeRef->rootNodeRef = NewNode();
+    }
+
+    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
+    if (treeRef->revisionId != 0)
+    {
+        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
+
+        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+
+        int fileRef = -1;
+
+        do
+        {
+            fileRef = open(pathPtr, O_RDONLY);
+        }
+        while ((fileRef == -1) && (errno == EINTR));
+
+        tdb_EnsureExists(treeRef->rootNodeRef);
+
+        if (fileRef == -1)
+        {
+            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+        }
+        else
+        {
+            snap_Ref_t snapRef = NULL;
+            le_result_t result = snap_Open(fileRef, &snapRef);
+
+            if (result == LE_OK)
+            {
+                // Only the root is loaded for now, the rest of the tree is loaded as it's used.
+                LoadSnapshotNode(treeRef->rootNodeRef, snapRef, SNAP_ROOT_INDEX);
+                snap_Release(snapRef);
+            }
+            else if (result == LE_UNSUPPORTED)
+            {
+                // Trees saved by older versions of the framework are in the text format.  They'll
+                // be saved as snapshots the next time they're saved as a whole.
+                if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
+                {
+                    LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
+                    le_mem_Release(treeRef->rootNodeRef);
+                    treeRef->rootNodeRef = NewNode();
+                }
+            }
+            else
+            {
+                LE_ERROR("Could not load configuration tree snapshot: %s.", pathPtr);
+            }
+
+            treeRef->snapshotSize = GetFileSize(fileRef);
+
+            int retVal = -1;
+
+            do
+            {
+                retVal = close(fileRef);
+            }
+            while ((retVal == -1) && (errno == EINTR));
+        }
+    }
+
+    // Bring the tree up to date with the commits made since it was saved.
+    ReplayJournal(treeRef);
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Free a registration object that no longer has any handlers.  If it was waiting for its handlers
+ *  to be called, it's taken off of the triggered list.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteRegistration
+(
+    Registration_t* registrationPtr  ///< [IN] The registration object to free.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (registrationPtr->triggered)
+    {
+        le_dls_Remove(&TriggeredList, &registrationPtr->triggeredLink);
+    }
+
+    le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
+    le_mem_Release(registrationPtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Removes the handler object from the given registration object.  This function will also free the
+ *  memory that the handler object had used.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveHandler
+(
+    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
+    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Kill the ref, and remove the object from the registration list.
+    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
+    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+
+    // Clear out the link data, just to be safe.
+    handlerPtr->link = LE_DLS_LINK_INIT;
+    handlerPtr->sessionRef = NULL;
+    handlerPtr->registrationPtr = NULL;
+    handlerPtr->safeRef = NULL;
+
+    // Finally kill the object.
+    le_mem_Release(handlerPtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function is called by the hash map ForEach function, which is invoked when a session closed
+ *  event occurs.
+ *
+ *  This function takes care of cleaning out orphaned event handlers from the registration objects
+ *  currently stored in the registration hash map.  If a given registration handler is no longer
+ *  required then the object itself is queued for deletion.  It is queued and not deleted in place
+ *  because the hash map does not support deleting objects in the middle of an iteration.
+ *
+ *  @return True.  This function always returns true to indicate that iteration should continue
+ *          until the end of the hash map.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OnHandlerRegistrationCleanup
+(
+    const void* keyPtr,    ///< [IN] The key used by this hash entry.
+    const void* valuePtr,  ///< [IN] The registration object.
+    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Convert our pointers into something useable.
+    Registration_t* registrationPtr = (Registration_t*)valuePtr;
+    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+
+    // Go through this registration object's list of update handlers and check to see if they were
+    // registered on the target session.  If so, free them from the list.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+    while (linkPtr != NULL)
     {
-        if (   (*stringPtr == '\"')
-            || (*stringPtr == '\\'))
-        {
-            result = WriteFile(filePtr, "\\", 1);
-        }
+        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
 
-        if (result == LE_OK)
+        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
         {
-            result = WriteFile(filePtr, stringPtr, 1);
+            RemoveHandler(registrationPtr, handlerObjectPtr);
         }
-
-        stringPtr++;
     }
 
-    if (result == LE_OK)
+    // Now, check to see if there are any handlers left in this object.  If the registration object
+    // is empty, then queue it for deletion.
+    if (le_dls_IsEmpty(&registrationPtr->handlerList))
     {
-        char strBuffer[2] = { endChar, ' ' };
-        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+        registrationPtr->link = LE_SLS_LINK_INIT;
+        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
     }
 
-    return result;
+    // We want to continue iterating through the collection.
+    return true;
 }
 
 
@@ -2173,139 +4807,116 @@ static le_result_t WriteStringValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a node value from the given file.  If the value is a collection, then read in those nodes
- *  too.
- *
- *  @return LE_OK if the read is successful.
- *          LE_FORMAT_ERROR if parse errors are encountered.
- *          LE_NOT_FOUND if the end of file is reached.
+ *  Call this function to delete a tree file from the filesystem.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalReadNode
+static void DeleteTreeFile
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
-    FILE* filePtr,          ///< [IN] The file we're reading the value from.
-    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+    const char* filePathPtr  ///< Path to the tree file in question.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
-
-    TokenType_t tokenType;
+    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
 
-    // Try to read this node's value.
-    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    if (unlink(filePathPtr) != 0)
     {
-        LE_ERROR("Unexpected EOF or bad token in file.");
-        return LE_FORMAT_ERROR;
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
     }
+}
 
-    tdb_SetEmpty(nodeRef);
-
-    switch (tokenType)
-    {
-        case TT_BOOL_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_BOOL;
-            break;
-
-        case TT_INT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_INT;
-            break;
 
-        case TT_FLOAT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_FLOAT;
-            break;
 
-        case TT_STRING_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            break;
 
-        case TT_EMPTY_VALUE:
-            // The node has already been cleared, so there's nothing left to do but make sure that
-            // the node exists.
-            ClearDeletedFlag(nodeRef);
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a new snapshot of a tree.  Once it's safely on the disk, the old snapshot and the journal
+ *  are deleted.  Runs on a tree writer thread.
+ *
+ *  @return LE_OK if the snapshot was written.
+ *          LE_NOT_PERMITTED if the filesystem is read only.
+ *          LE_IO_ERROR if the snapshot could not be written.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteSnapshotFile
+(
+    WriteJob_t* jobPtr  ///< [IN] The write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(jobPtr->treeName, jobPtr->revisionId, filePath, sizeof(filePath));
 
-        case TT_OPEN_GROUP:
-            while (tokenType != TT_CLOSE_GROUP)
-            {
-                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
-                {
-                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
+    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
 
-                if (tokenType == TT_STRING_VALUE)
-                {
-                    size_t strLen = le_utf8_NumBytes(stringBuffer);
-                    size_t newPathLen = pathLen + 1 + strLen;
+    int fileRef = -1;
 
-                    if (newPathLen > LE_CFG_STR_LEN)
-                    {
-                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
-                                 stringBuffer,
-                                 strLen,
-                                 (size_t)LE_CFG_STR_LEN);
+    do
+    {
+        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
 
-                        return LE_FORMAT_ERROR;
-                    }
+    if ((-1 == fileRef) && (EROFS == errno))
+    {
+        // In case we are R/O for the config tree, we discard the update to flash
+        return LE_NOT_PERMITTED;
+    }
 
-                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+    if (fileRef == -1)
+    {
+        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
+        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
+                 "filesystem!!");
+        return LE_IO_ERROR;
+    }
 
-                    if (childRef == NULL)
-                    {
-                        childRef = NewChildNode(nodeRef);
-                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
-                        {
-                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
-                            return LE_FORMAT_ERROR;
-                        }
+    // We have a tree file to write to, so save the new tree to it then close the output file.  The
+    // old snapshot is about to be deleted, so this one has to be on the disk first.
+    le_result_t writeResult = snap_Write(jobPtr->builderRef, fileRef);
 
-                        LE_DEBUG("New node, %s", stringBuffer);
-                    }
+    if (   (writeResult == LE_OK)
+        && (fdatasync(fileRef) == -1))
+    {
+        LE_EMERG("Failed to flush the tree file '%s' (%m).", filePath);
+        writeResult = LE_IO_ERROR;
+    }
 
-                    tdb_EnsureExists(childRef);
+    jobPtr->fileSize = GetFileSize(fileRef);
+    int retVal = -1;
 
-                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+    do
+    {
+        retVal = close(fileRef);
+    }
+    while ((retVal == -1) && (errno == EINTR));
 
-                    if (result != LE_OK)
-                    {
-                        return result;
-                    }
-                }
-                else if (tokenType == TT_CLOSE_GROUP)
-                {
-                    break;
-                }
-                else
-                {
-                    LE_ERROR("Unexpected token in found while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
-            }
-            break;
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
 
-        case TT_CLOSE_GROUP:
-        default:
-            LE_ERROR("Unexpected token found.");
-            return LE_FORMAT_ERROR;
-    }
 
-    if (IsShadow(nodeRef) == false)
+    // Finally remove the old version of the tree file, if there is one.
+    if (writeResult == LE_OK)
     {
-        ClearModifiedFlag(nodeRef);
+        if (   (jobPtr->oldRevisionId != 0)
+            && (TreeFileExists(jobPtr->treeName, jobPtr->oldRevisionId)))
+        {
+            GetTreePath(jobPtr->treeName, jobPtr->oldRevisionId, filePath, sizeof(filePath));
+            DeleteTreeFile(filePath);
+        }
+
+        // The journal can only go once the old snapshot has, or the old snapshot could be loaded
+        // without the changes from the journal.
+        GetJournalPath(jobPtr->treeName, filePath, sizeof(filePath));
+        jrnl_Delete(filePath);
     }
     else
     {
-        SetModifiedFlag(nodeRef);
+        // The write failed, delete the new file we attempted to create.
+        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
+        DeleteTreeFile(filePath);
     }
 
-    tdb_EnsureExists(nodeRef);
-
-    return LE_OK;
+    return writeResult;
 }
 
 
@@ -2313,88 +4924,29 @@ static le_result_t InternalReadNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Serialize a tree node and it's children to a file in the filesystem.
- *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  Delete all of the files of a tree.  Runs on a tree writer thread.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalWriteNode
+static void DeleteTreeFiles
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
-    FILE* filePtr           ///< [IN] The file being written to.
+    const char* treeNamePtr  ///< [IN] The tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If there is no node to write, or if the node is marked as having been deleted...  Then write
-    // a blank node.
-    if (   (nodeRef == NULL)
-        || (IsDeleted(nodeRef) == true))
+    for (int id = 1; id <= 3; id++)
     {
-        return WriteFile(filePtr, "~ ", 2);
-    }
-
-    // Get the node's value as a string.
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
-    le_result_t result = LE_OK;
-
-    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
-
-    // Now, depending on the type of node, write out any required format information.
-    switch (nodeRef->type)
-    {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            result = WriteFile(filePtr, "~ ", 2);
-            break;
-
-        case LE_CFG_TYPE_BOOL:
-            {
-                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
-                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
-            }
-            break;
-
-        case LE_CFG_TYPE_STRING:
-            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-            break;
-
-        case LE_CFG_TYPE_INT:
-            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
-            break;
-
-        case LE_CFG_TYPE_FLOAT:
-            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
-            break;
-
-        // Looks like this node is a collection, so write out it's child nodes now.
-        case LE_CFG_TYPE_STEM:
-            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
-
-                while (   (childRef != NULL)
-                       && (result == LE_OK))
-                {
-                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
-                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-
-                    if (result == LE_OK)
-                    {
-                        result = InternalWriteNode(childRef, filePtr);
-                    }
-
-                    childRef = tdb_GetNextActiveSiblingNode(childRef);
-                }
+        if (TreeFileExists(treeNamePtr, id))
+        {
+            char filePathPtr[LE_CFG_STR_LEN_BYTES] = "";
+            GetTreePath(treeNamePtr, id, filePathPtr, sizeof(filePathPtr));
 
-                if (result == LE_OK)
-                {
-                    result = WriteFile(filePtr, "} ", 2);
-                }
-            }
-            break;
+            DeleteTreeFile(filePathPtr);
+        }
     }
 
-    return result;
+    char journalPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeNamePtr, journalPath, sizeof(journalPath));
+    jrnl_Delete(journalPath);
 }
 
 
@@ -2402,33 +4954,41 @@ static le_result_t InternalWriteNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Calculate the number of bytes required to store a node path, including seperators and a trailing
- *  NULL.
+ *  Do a write queued for a tree's files.  Runs on a tree writer thread.
  *
- *  @return The amount of bytes required to store the whole path string.
+ *  @return The result of the write.
  */
 // -------------------------------------------------------------------------------------------------
-static size_t ComputePathLength
+static le_result_t RunWriteJob
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+    void* contextPtr  ///< [IN] The WriteJob_t.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    size_t pathLen = 0;
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    WriteJob_t* jobPtr = contextPtr;
 
-    while (nodeRef != NULL)
+    switch (jobPtr->op)
     {
-        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+        case WRITE_JOURNAL:
+            {
+                char filePath[LE_CFG_STR_LEN_BYTES] = "";
+                GetJournalPath(jobPtr->treeName, filePath, sizeof(filePath));
 
-        // Add this path segment's length to our running total, along with the required path
-        // seperator.
-        pathLen += 1 + le_utf8_NumBytes(nodeName);
-        nodeRef = tdb_GetNodeParent(nodeRef);
+                return jrnl_WriteBatch(filePath,
+                                       jobPtr->revisionId,
+                                       jobPtr->batchRef,
+                                       jobPtr->journalSize);
+            }
+
+        case WRITE_SNAPSHOT:
+            return WriteSnapshotFile(jobPtr);
+
+        case WRITE_DELETE:
+            DeleteTreeFiles(jobPtr->treeName);
+            return LE_OK;
     }
 
-    // Don't forget to include a spot for the trailing NULL.
-    return pathLen + 1;
+    return LE_OK;
 }
 
 
@@ -2436,121 +4996,68 @@ static size_t ComputePathLength
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Bump up the version id of this tree.
+ *  Queue a write of a tree's files to the tree writer threads.
  */
 // -------------------------------------------------------------------------------------------------
-static void IncrementRevision
+static void QueueWriteJob
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    treeRef->revisionId++;
-
-    if (treeRef->revisionId > 3)
-    {
-        treeRef->revisionId = 1;
-    }
-}
+    WriteJob_t* jobPtr  ///< [IN] The write, it's freed once it's done.
+);
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to load a configuration tree from a config file.  This function will look for the latest
- *  valid version of the config file and load that one.
+ *  Create a new write for a tree's files.
+ *
+ *  @return The write, to be filled in and queued with QueueWriteJob().
  */
 // -------------------------------------------------------------------------------------------------
-static void LoadTree
+static WriteJob_t* NewWriteJob
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+    WriteOp_t op,            ///< [IN] What to write.
+    const char* treeNamePtr  ///< [IN] The tree being written.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If we don't know the revision then hunt it out from the filesystem.
-    if (treeRef->revisionId == 0)
-    {
-        UpdateRevision(treeRef);
-    }
-
-    // If this tree has no root, create it now.
-    if (treeRef->rootNodeRef == NULL)
-    {
-        treeRef->rootNodeRef = NewNode();
-    }
-
-    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
-    if (treeRef->revisionId != 0)
-    {
-        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
-        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
-
-        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
-
-        int fileRef = -1;
-
-        do
-        {
-            fileRef = open(pathPtr, O_RDONLY);
-        }
-        while ((fileRef == -1) && (errno == EINTR));
-
-        tdb_EnsureExists(treeRef->rootNodeRef);
-
-        if (fileRef == -1)
-        {
-            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
-                     pathPtr,
-                     strerror(errno));
-        }
-        else
-        {
-            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
-            {
-                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
-                le_mem_Release(treeRef->rootNodeRef);
-                treeRef->rootNodeRef = NewNode();
-            }
+    WriteJob_t* jobPtr = le_mem_ForceAlloc(WriteJobPool);
 
-            int retVal = -1;
+    memset(jobPtr, 0, sizeof(WriteJob_t));
+    jobPtr->op = op;
+    LE_ASSERT(le_utf8_Copy(jobPtr->treeName, treeNamePtr, sizeof(jobPtr->treeName), NULL) == LE_OK);
 
-            do
-            {
-                retVal = close(fileRef);
-            }
-            while ((retVal == -1) && (errno == EINTR));
-        }
-    }
+    return jobPtr;
 }
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Removes the handler object from the given registration object.  This function will also free the
- *  memory that the handler object had used.
+ *  Queue a save of a tree as a new snapshot.  The snapshot is built now, so later commits don't
+ *  change it, but it's written in the background.
  */
 // -------------------------------------------------------------------------------------------------
-static void RemoveHandler
+static void SaveTree
 (
-    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
-    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to save.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Kill the ref, and remove the object from the registration list.
-    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
-    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+    WriteJob_t* jobPtr = NewWriteJob(WRITE_SNAPSHOT, treeRef->name);
 
-    // Clear out the link data, just to be safe.
-    handlerPtr->link = LE_DLS_LINK_INIT;
-    handlerPtr->sessionRef = NULL;
-    handlerPtr->registrationPtr = NULL;
-    handlerPtr->safeRef = NULL;
+    // Now increment revision of the tree, the new snapshot is written under the new revision.
+    jobPtr->oldRevisionId = treeRef->revisionId;
+    IncrementRevision(treeRef);
+    jobPtr->revisionId = treeRef->revisionId;
+    jobPtr->builderRef = BuildSnapshot(treeRef->rootNodeRef);
 
-    // Finally kill the object.
-    le_mem_Release(handlerPtr);
+    // Commits made from here on go into a new journal, for the new revision.
+    treeRef->journalSize = 0;
+    treeRef->isSaveFailed = false;
+
+    QueueWriteJob(jobPtr);
 }
 
 
@@ -2558,55 +5065,72 @@ static void RemoveHandler
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function is called by the hash map ForEach function, which is invoked when a session closed
- *  event occurs.
- *
- *  This function takes care of cleaning out orphaned event handlers from the registration objects
- *  currently stored in the registration hash map.  If a given registration handler is no longer
- *  required then the object itself is queued for deletion.  It is queued and not deleted in place
- *  because the hash map does not support deleting objects in the middle of an iteration.
- *
- *  @return True.  This function always returns true to indicate that iteration should continue
- *          until the end of the hash map.
+ *  Called on the main thread once a write of a tree's files is done.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OnHandlerRegistrationCleanup
+static void OnWriteJobDone
 (
-    const void* keyPtr,    ///< [IN] The key used by this hash entry.
-    const void* valuePtr,  ///< [IN] The registration object.
-    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+    le_result_t result,  ///< [IN] The result of the write.
+    void* contextPtr     ///< [IN] The WriteJob_t.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Convert our pointers into something useable.
-    Registration_t* registrationPtr = (Registration_t*)valuePtr;
-    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+    WriteJob_t* jobPtr = contextPtr;
 
-    // Go through this registration object's list of update handlers and check to see if they were
-    // registered on the target session.  If so, free them from the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    // The tree may have been deleted, (and even created again,) since the write was queued.
+    tdb_TreeRef_t treeRef = le_hashmap_Get(TreeCollectionRef, jobPtr->treeName);
 
-    while (linkPtr != NULL)
+    switch (jobPtr->op)
     {
-        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+        case WRITE_JOURNAL:
+            if (result == LE_OK)
+            {
+                ts_CountBytesWritten(jobPtr->treeName,
+                                     jrnl_GetSizeAfter(jobPtr->journalSize, jobPtr->batchRef)
+                                     - jobPtr->journalSize);
+            }
 
-        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
-        {
-            RemoveHandler(registrationPtr, handlerObjectPtr);
-        }
-    }
+            jrnl_DeleteBatch(jobPtr->batchRef);
 
-    // Now, check to see if there are any handlers left in this object.  If the registration object
-    // is empty, then queue it for deletion.
-    if (le_dls_IsEmpty(&registrationPtr->handlerList))
-    {
-        registrationPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+            // The journal is gone, so save the whole tree instead.
+            if (   (result == LE_IO_ERROR)
+                && (treeRef != NULL))
+            {
+                LE_WARN("Could not append to the journal of tree '%s', saving the whole tree.",
+                        treeRef->name);
+
+                SaveTree(treeRef);
+            }
+            break;
+
+        case WRITE_SNAPSHOT:
+            snap_DeleteBuilder(jobPtr->builderRef);
+
+            if (result == LE_OK)
+            {
+                ts_CountBytesWritten(jobPtr->treeName, jobPtr->fileSize);
+            }
+
+            if (   (treeRef != NULL)
+                && (treeRef->revisionId == jobPtr->revisionId))
+            {
+                if (result == LE_OK)
+                {
+                    treeRef->snapshotSize = jobPtr->fileSize;
+                }
+                else if (result == LE_IO_ERROR)
+                {
+                    // Save the tree as a whole again with the next commit.
+                    treeRef->isSaveFailed = true;
+                }
+            }
+            break;
+
+        case WRITE_DELETE:
+            break;
     }
 
-    // We want to continue iterating through the collection.
-    return true;
+    le_mem_Release(jobPtr);
 }
 
 
@@ -2614,21 +5138,16 @@ static bool OnHandlerRegistrationCleanup
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this function to delete a tree file from the filesystem.
+ *  Queue a write of a tree's files to the tree writer threads.
  */
 // -------------------------------------------------------------------------------------------------
-static void DeleteTreeFile
+static void QueueWriteJob
 (
-    const char* filePathPtr  ///< Path to the tree file in question.
+    WriteJob_t* jobPtr  ///< [IN] The write, it's freed once it's done.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
-
-    if (unlink(filePathPtr) != 0)
-    {
-        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
-    }
+    tw_Queue(jobPtr->treeName, RunWriteJob, OnWriteJobDone, jobPtr);
 }
 
 
@@ -2792,6 +5311,11 @@ void tdb_Init
     HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
     RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
 
+    WriteJobPool = le_mem_CreatePool("writeJobPool", sizeof(WriteJob_t));
+
+    NotificationTimer = le_timer_Create("Notification Timer");
+    LE_ASSERT(le_timer_SetHandler(NotificationTimer, OnNotificationTimer) == LE_OK);
+
     // Preload the system tree.
     tdb_GetTree("system");
 }
@@ -2855,16 +5379,8 @@ void tdb_DeleteTree
         // kill the tree itself.
         LE_DEBUG("** Deleting configuration tree, '%s'.", treeRef->name);
 
-        for (int id = 1; id <= 3; id++)
-        {
-            if (TreeFileExists(treeRef->name, id))
-            {
-                char filePathPtr[LE_CFG_STR_LEN_BYTES] = "";
-                GetTreePath(treeRef->name, id, filePathPtr, sizeof(filePathPtr));
-
-                DeleteTreeFile(filePathPtr);
-            }
-        }
+        // The files go after any writes still queued for them.
+        QueueWriteJob(NewWriteJob(WRITE_DELETE, treeRef->name));
 
         LE_ASSERT(le_hashmap_Remove(TreeCollectionRef, treeRef->name) == treeRef);
         le_mem_Release(treeRef);
@@ -2924,6 +5440,33 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the node in a version of a tree that stands in for a node of the original tree.
+ *
+ *  @return The version's node, or NULL if the node isn't part of the version.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_NodeRef_t tdb_GetVersionNode
+(
+    tdb_TreeRef_t versionRef,  ///< [IN] The version.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node in the original tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(versionRef->isVersion);
+
+    if (nodeRef == NULL)
+    {
+        return NULL;
+    }
+
+    return FindVersionNode(versionRef->rootNodeRef, nodeRef);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -3126,89 +5669,151 @@ le_sls_List_t* tdb_GetRequestQueue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  Queue the journal entries made while merging a commit to be appended to the tree's journal, if
+ *  the journal isn't too big yet.
+ *
+ *  @return True if the commit has been dealt with, false if the whole tree needs to be saved.
  */
 // -------------------------------------------------------------------------------------------------
-void tdb_MergeTree
+static bool AppendJournal
 (
-    tdb_TreeRef_t shadowTreeRef  ///< [IN] Merge the nodes from this tree into their base tree.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree the commit was merged into.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
-    // iterator to track the merge and allow for update handlers to be called.
-    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
-    le_pathIter_Ref_t pathRef = CreateBasePath(shadowTreeRef->originalTreeRef->name);
+    bool isIncomplete = JournalIncomplete;
+    JournalIncomplete = false;
 
-    InternalMergeTree(shadowTreeRef->originalTreeRef->name, pathRef, nodeRef, false);
-    le_pathIter_Delete(pathRef);
+    // Let the journal grow as big as the snapshot before starting over, so that replaying it never
+    // takes much longer than loading the snapshot.
+    size_t maxSize = (treeRef->snapshotSize > JOURNAL_MIN_COMPACT_SIZE) ? treeRef->snapshotSize
+                                                                         : JOURNAL_MIN_COMPACT_SIZE;
 
-    // Now, go through and call the triggered callbacks.
-    FireTriggeredCallbacks();
+    if (   (isIncomplete)
+        || (treeRef->isSaveFailed)
+        || (treeRef->revisionId == 0)
+        || (treeRef->journalSize + jrnl_GetPendingSize() > maxSize))
+    {
+        jrnl_DiscardPending();
+        return false;
+    }
 
-    // Now increment revision of the tree and open a tree file for writing.
-    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
-    int oldId = originalTreeRef->revisionId;
+    WriteJob_t* jobPtr = NewWriteJob(WRITE_JOURNAL, treeRef->name);
 
-    IncrementRevision(originalTreeRef);
+    jobPtr->revisionId = treeRef->revisionId;
+    jobPtr->journalSize = treeRef->journalSize;
+    jobPtr->batchRef = jrnl_TakePending();
 
-    char filePath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(originalTreeRef->name, originalTreeRef->revisionId, filePath, sizeof(filePath));
+    treeRef->journalSize = jrnl_GetSizeAfter(treeRef->journalSize, jobPtr->batchRef);
 
-    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
+    QueueWriteJob(jobPtr);
 
-    int fileRef = -1;
+    return true;
+}
 
-    do
-    {
-        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
-    }
-    while (   (fileRef == -1)
-           && (errno == EINTR));
 
-    if ((-1 == fileRef) && (EROFS == errno))
-    {
-        // In case we are R/O for the config tree, we discard the update to flash
-        return;
-    }
 
-    if (fileRef == -1)
-    {
-        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
-        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
-                 "filesystem!!");
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new version of a tree, showing the tree as it is now.
+ *
+ *  @return The new version.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_TreeRef_t NewVersion
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The original tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t versionRef = tdb_ShadowTree(treeRef);
+
+    MakeVersionNode(versionRef->rootNodeRef);
+    versionRef->isVersion = true;
+
+    le_mem_AddRef(treeRef);
+    le_dls_Queue(&treeRef->versionList, &versionRef->versionLink);
+
+    return versionRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called for each active iterator before a commit is merged.  Read iterators that are working on
+ *  the tree being changed are moved onto a version of it, so they don't see the change.
+ */
+// -------------------------------------------------------------------------------------------------
+static void MoveReaderToVersion
+(
+    ni_ConstIteratorRef_t iteratorRef,  ///< [IN] The iterator.
+    void* contextPtr                    ///< [IN] The VersionContext_t of the merge.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    VersionContext_t* versionContextPtr = (VersionContext_t*)contextPtr;
+
+    // Writers are always on shadow trees, so only readers can be on the original.
+    if (ni_GetTree(iteratorRef) != versionContextPtr->treeRef)
+    {
         return;
     }
 
-    // We have a tree file to write to, so stream the new tree to it then close the output file.
-    le_result_t writeResult = tdb_WriteTreeNode(originalTreeRef->rootNodeRef, fileRef);
-    int retVal = -1;
-
-    do
+    if (versionContextPtr->versionRef == NULL)
     {
-        retVal = close(fileRef);
+        versionContextPtr->versionRef = NewVersion(versionContextPtr->treeRef);
+    }
+    else
+    {
+        le_mem_AddRef(versionContextPtr->versionRef);
     }
-    while ((retVal == -1) && (errno == EINTR));
 
-    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+    ni_MoveToVersion((ni_IteratorRef_t)iteratorRef, versionContextPtr->versionRef);
+}
 
 
-    // Finally remove the old version of the tree file, if there is one.
-    if (writeResult == LE_OK)
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Merge a shadow tree into the original tree it was created from.  Once the change is merged it
+ *  is added to the tree's journal, or if the journal has grown too big, the updated tree is saved
+ *  to the filesystem.  The files are written in the background, by the tree writer threads.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_MergeTree
+(
+    tdb_TreeRef_t shadowTreeRef  ///< [IN] Merge the nodes from this tree into their base tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
+
+    // Any readers still on the tree get to finish with the tree as it was before this commit.
+    if (originalTreeRef->activeReadCount > 0)
     {
-        if (   (oldId != 0)
-            && (TreeFileExists(originalTreeRef->name, oldId)))
-        {
-            GetTreePath(originalTreeRef->name, oldId, filePath, sizeof(filePath));
-            DeleteTreeFile(filePath);
-        }
+        VersionContext_t versionContext = { originalTreeRef, NULL };
+        ni_ForEachIter(MoveReaderToVersion, &versionContext);
     }
-    else
+
+    // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
+    // iterator to track the merge and allow for update handlers to be called.
+    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
+    le_pathIter_Ref_t pathRef = CreateBasePath(originalTreeRef->name);
+    char changedPath[CFG_MAX_PATH_SIZE];
+
+    InternalMergeTree(originalTreeRef, pathRef, nodeRef, false, changedPath);
+    le_pathIter_Delete(pathRef);
+
+    // Now, go through and call the triggered callbacks.
+    NotifyChanges();
+
+    if (AppendJournal(originalTreeRef) == false)
     {
-        // The write failed, delete the new file we attempted to create.
-        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
-        DeleteTreeFile(filePath);
+        SaveTree(originalTreeRef);
     }
 }
 
@@ -3341,6 +5946,198 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a snapshot, as written by
+ *  tdb_WriteTreeSnapshot().  The snapshot has to be in a file that can be mapped into memory.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if the file isn't a snapshot, or the snapshot is corrupt.
+ *          LE_FAULT if the file couldn't be mapped.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_ReadTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    int descriptor          ///< [IN] The file to read from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(nodeRef != NULL);
+
+    size_t pathLen = ComputePathLength(nodeRef);
+
+    if (pathLen >= LE_CFG_STR_LEN)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    snap_Ref_t snapRef = NULL;
+    le_result_t result = snap_Open(descriptor, &snapRef);
+
+    if (result == LE_UNSUPPORTED)
+    {
+        LE_ERROR("Imported data isn't a config tree snapshot.");
+        return LE_FORMAT_ERROR;
+    }
+    else if (result != LE_OK)
+    {
+        return result;
+    }
+
+    tdb_EnsureExists(nodeRef);
+    result = ImportSnapshotNode(nodeRef, snapRef, SNAP_ROOT_INDEX, pathLen);
+
+    if (result != LE_OK)
+    {
+        tdb_SetEmpty(nodeRef);
+    }
+
+    snap_Release(snapRef);
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and it's children to a file as a snapshot, in the same binary format the trees
+ *  are saved in.  The node becomes the root of the snapshot.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    snap_BuilderRef_t builderRef = snap_CreateBuilder();
+
+    AddExportNode(builderRef, SNAP_ROOT_INDEX, NULL, nodeRef);
+
+    le_result_t result = snap_Write(builderRef, descriptor);
+    snap_DeleteBuilder(builderRef);
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a JSON document, laid out as written by
+ *  tdb_WriteTreeJson().  Stems are merged into the node's existing children.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if the document isn't valid, or isn't laid out as expected.
+ *          LE_NOT_POSSIBLE if the document conflicts with values already in the tree.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_ReadTreeJson
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    int descriptor          ///< [IN] The file to read from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(nodeRef != NULL);
+
+    size_t pathLen = ComputePathLength(nodeRef);
+
+    if (pathLen >= LE_CFG_STR_LEN)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    // The document is parsed in one go, so read all of it in first.
+    size_t bufferSize = 0;
+    size_t maxSize = 4096;
+    char* bufferPtr = malloc(maxSize);
+    ssize_t bytesRead;
+
+    LE_ASSERT(bufferPtr != NULL);
+
+    do
+    {
+        if (bufferSize == maxSize)
+        {
+            maxSize *= 2;
+            bufferPtr = realloc(bufferPtr, maxSize);
+            LE_ASSERT(bufferPtr != NULL);
+        }
+
+        bytesRead = read(descriptor, bufferPtr + bufferSize, maxSize - bufferSize);
+
+        if (bytesRead > 0)
+        {
+            bufferSize += bytesRead;
+        }
+    }
+    while ((bytesRead > 0) || ((bytesRead == -1) && (errno == EINTR)));
+
+    if (bytesRead == -1)
+    {
+        LE_ERROR("Could not read the JSON document, reason: %m");
+        free(bufferPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    le_json_DocRef_t docRef = le_json_CreateDoc(bufferPtr, bufferSize);
+
+    if (docRef == NULL)
+    {
+        free(bufferPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    le_json_NodeRef_t rootRef = le_json_GetDocRoot(docRef);
+    le_result_t result = LE_FORMAT_ERROR;
+
+    if (le_json_GetNodeType(rootRef) == LE_JSON_CONTEXT_OBJECT)
+    {
+        result = ImportJsonNode(nodeRef, rootRef, pathLen);
+    }
+
+    le_json_DeleteDoc(docRef);
+    free(bufferPtr);
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and it's children to a file as a JSON document.  Each node is an object with
+ *  a "name" and a "type", and either a "value", or an array of "children".
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeJson
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_json_WriterRef_t writerRef = le_json_CreateWriter(descriptor);
+
+    WriteJsonNode(writerRef, nodeRef);
+
+    return (le_json_DeleteWriter(writerRef) == LE_OK) ? LE_OK : LE_IO_ERROR;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -3504,19 +6301,12 @@ le_result_t tdb_GetNodeName
     // NULL.  The reason that the name may be NULL is because the client never changed the name of
     // the node.  So, we just get the name from the original node, saving memory.  However, nodes
     // like the root node of a tree also do not have names.
-    dstr_Ref_t nameRef = nodeRef->nameRef;
-
-    if (   (IsShadow(nodeRef))
-        && (nodeRef->nameRef == NULL)
-        && (nodeRef->shadowRef != NULL))
-    {
-        nameRef = nodeRef->shadowRef->nameRef;
-    }
+    istr_Ref_t nameRef = GetNameRef(nodeRef);
 
     // If the node has a name, copy it into the user buffer now.
     if (nameRef != NULL)
     {
-        return dstr_CopyToCstr(stringPtr, maxSize, nameRef, NULL);
+        return le_utf8_Copy(stringPtr, istr_GetText(nameRef), maxSize, NULL);
     }
 
     return LE_OK;
@@ -3574,15 +6364,15 @@ le_result_t tdb_SetNodeName
 
     // Copy over the new name.  Note that we don't care if this node is a shadow node.  Coping over
     // the name is taken care of as part of the merge process.
-    if (nodeRef->nameRef == NULL)
-    {
-        nodeRef->nameRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
+    if (nodeRef->nameRef != NULL)
     {
-        dstr_CopyFromCstr(nodeRef->nameRef, stringPtr);
+        istr_Release(nodeRef->nameRef);
     }
 
+    nodeRef->nameRef = istr_Get(stringPtr);
+
+    IndexChildName(nodeRef);
+
     // If this is a shadow node and this is the change that modified it, then try to get it's
     // children now.  This is done so that later when this node is merged the merge code doesn't end
     // up thinking that the child nodes where removed.
@@ -3639,7 +6429,7 @@ le_cfg_nodeType_t tdb_GetNodeType
 
     // If the node isn't a stem and there is no string value then this node is definitly empty.
     if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-        && (nodeRef->info.valueRef == NULL))
+        && (HasValue(nodeRef) == false))
     {
         if (   (IsShadow(nodeRef))
             && (IsModified(nodeRef) == false))
@@ -3708,25 +6498,25 @@ void tdb_SetEmpty
     // If this is a stem node, then go through and clear out the children.
     if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
+        DropChildIndex(nodeRef);
+        DropSnapshot(nodeRef);
+
         tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
         while (childRef != NULL)
         {
             tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
 
-            // We don't remove the child from the list explicitly, because the destructor will take
-            // care of that for us.
-            le_mem_Release(childRef);
+            ReleaseChildNode(childRef);
             childRef = nextChildRef;
         }
 
         nodeRef->info.children = LE_DLS_LIST_INIT;
     }
-    else if (nodeRef->info.valueRef)
+    else
     {
         // It's a string value, so free it now.
-        dstr_Release(nodeRef->info.valueRef);
-        nodeRef->info.valueRef = NULL;
+        ReleaseValue(nodeRef);
     }
 
     // Mark the node as being emtpy, and that it has been modified.
@@ -3817,6 +6607,8 @@ tdb_NodeRef_t tdb_GetFirstChildNode
 {
     LE_ASSERT(nodeRef != NULL);
 
+    LoadChildren(nodeRef);
+
     // Is this the type of node that has children?
     if (   (   (nodeRef->type != LE_CFG_TYPE_STEM)
             || (le_dls_IsEmpty(&nodeRef->info.children) == true))
@@ -3969,18 +6761,18 @@ le_result_t tdb_GetValueAsString
 
     // Check to see if we have the value locally, or if we need to go back to the original node for
     // the value.
-    if (nodeRef->info.valueRef == NULL)
+    if (HasValue(nodeRef) == false)
     {
         if (IsShadow(nodeRef))
         {
             LE_ASSERT(nodeRef->shadowRef != NULL);
-            return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->shadowRef->info.valueRef, NULL);
+            return le_utf8_Copy(stringPtr, GetValueText(nodeRef->shadowRef), maxSize, NULL);
         }
 
         return LE_OK;
     }
 
-    return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->info.valueRef, NULL);
+    return le_utf8_Copy(stringPtr, GetValueText(nodeRef), maxSize, NULL);
 }
 
 
@@ -4006,20 +6798,13 @@ void tdb_SetValueAsString
         || (nodeRef->type != LE_CFG_TYPE_EMPTY))
     {
         tdb_SetEmpty(nodeRef);
+        nodeRef->flags &= ~NODE_HAS_INLINE_VALUE;
         nodeRef->info.valueRef = NULL;
     }
 
     // Mark this as a string node, and copy over the value.
     nodeRef->type = LE_CFG_TYPE_STRING;
-
-    if (nodeRef->info.valueRef == NULL)
-    {
-        nodeRef->info.valueRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
-    {
-        dstr_CopyFromCstr(nodeRef->info.valueRef, stringPtr);
-    }
+    SetValueText(nodeRef, stringPtr);
 
     // Make sure the system knows this node has been modified so that it can be included for merging
     // into the original tree.  Also, make sure that this node and it's parents are not marked as
@@ -4250,23 +7035,27 @@ void tdb_SetValueAsFloat
 
 
 
-//--------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
 /**
- *  Registers a handler function to be called when a node at or below a given path changes.
+ *  Registers a handler object to be called when a node at or below a given path changes.
  *
- *  @return A new safe ref backed object, or NULL if the creation failed.
+ *  @return The new handler object's safe ref, or NULL if the creation failed.
  */
-//--------------------------------------------------------------------------------------------------
-le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
+// -------------------------------------------------------------------------------------------------
+static void* AddHandler
 (
-    tdb_TreeRef_t treeRef,                  ///< [IN] The tree to register the handler on.
-    le_msg_SessionRef_t sessionRef,         ///< [IN] The session that the request came in on.
-    const char* pathPtr,                    ///< [IN] Path of the node to watch.
-    le_cfg_ChangeHandlerFunc_t handlerPtr,  ///< [IN] Function to call back.
-    void* contextPtr                        ///< [IN] Opaque value to pass to the function when
-                                            ///<      called.
+    tdb_TreeRef_t treeRef,                                ///< [IN] The tree to register the handler
+                                                          ///<      on.
+    le_msg_SessionRef_t sessionRef,                       ///< [IN] The session that the request
+                                                          ///<      came in on.
+    const char* pathPtr,                                  ///< [IN] Path of the node to watch.
+    le_cfg_ChangeHandlerFunc_t handlerPtr,                ///< [IN] Function to call back, or NULL.
+    le_cfg_ChangeSummaryHandlerFunc_t summaryHandlerPtr,  ///< [IN] Function to call back with a
+                                                          ///<      summary, or NULL.
+    void* contextPtr                                      ///< [IN] Opaque value to pass to the
+                                                          ///<      function when called.
 )
-//--------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
 {
     le_pathIter_Ref_t pathIterRef = NULL;
     char newPathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
@@ -4311,6 +7100,8 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
         foundRegistrationPtr = le_mem_ForceAlloc(RegistrationPool);
 
         foundRegistrationPtr->triggered = false;
+        foundRegistrationPtr->changedPath[0] = '\0';
+        foundRegistrationPtr->triggeredLink = LE_DLS_LINK_INIT;
 
         foundRegistrationPtr->handlerList = LE_DLS_LIST_INIT;
         le_utf8_Copy(foundRegistrationPtr->registrationPath,
@@ -4329,6 +7120,7 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
     handlerObjectPtr->link = LE_DLS_LINK_INIT;
     handlerObjectPtr->sessionRef = sessionRef;
     handlerObjectPtr->handlerPtr = handlerPtr;
+    handlerObjectPtr->summaryHandlerPtr = summaryHandlerPtr;
     handlerObjectPtr->contextPtr = contextPtr;
     handlerObjectPtr->registrationPtr = foundRegistrationPtr;
     handlerObjectPtr->safeRef = le_ref_CreateRef(HandlerSafeRefMap, handlerObjectPtr);
@@ -4341,6 +7133,58 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Registers a handler function to be called when a node at or below a given path changes.
+ *
+ *  @return A new safe ref backed object, or NULL if the creation failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
+(
+    tdb_TreeRef_t treeRef,                  ///< [IN] The tree to register the handler on.
+    le_msg_SessionRef_t sessionRef,         ///< [IN] The session that the request came in on.
+    const char* pathPtr,                    ///< [IN] Path of the node to watch.
+    le_cfg_ChangeHandlerFunc_t handlerPtr,  ///< [IN] Function to call back.
+    void* contextPtr                        ///< [IN] Opaque value to pass to the function when
+                                            ///<      called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return AddHandler(treeRef, sessionRef, pathPtr, handlerPtr, NULL, contextPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Registers a handler function to be called when a node at or below a given path changes.  The
+ *  handler is given the path to the deepest node holding all of the changes being reported.
+ *
+ *  Both kinds of handler are removed with tdb_RemoveChangeHandler().
+ *
+ *  @return A new safe ref backed object, or NULL if the creation failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_ChangeSummaryHandlerRef_t tdb_AddChangeSummaryHandler
+(
+    tdb_TreeRef_t treeRef,                         ///< [IN] The tree to register the handler on.
+    le_msg_SessionRef_t sessionRef,                ///< [IN] The session that the request came in
+                                                   ///<      on.
+    const char* pathPtr,                           ///< [IN] Path of the node to watch.
+    le_cfg_ChangeSummaryHandlerFunc_t handlerPtr,  ///< [IN] Function to call back.
+    void* contextPtr                               ///< [IN] Opaque value to pass to the function
+                                                   ///<      when called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return AddHandler(treeRef, sessionRef, pathPtr, NULL, handlerPtr, contextPtr);
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Deregisters a handler function that was registered using tdb_AddChangeHandler().
@@ -4368,8 +7212,7 @@ void tdb_RemoveChangeHandler
         // If there are no more handlers in this registration object, kill the object.
         if (le_dls_IsEmpty(&registrationPtr->handlerList))
         {
-            le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-            le_mem_Release(registrationPtr);
+            DeleteRegistration(registrationPtr);
         }
     }
 }
@@ -4402,7 +7245,6 @@ void tdb_CleanUpHandlers
     {
         Registration_t* registrationPtr = CONTAINER_OF(linkPtr, Registration_t, link);
 
-        le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-        le_mem_Release(registrationPtr);
+        DeleteRegistration(registrationPtr);
     }
 }
@@ -121,6 +121,22 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the node in a version of a tree that stands in for a node of the original tree.
+ *
+ *  @return The version's node, or NULL if the node isn't part of the version.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_NodeRef_t tdb_GetVersionNode
+(
+    tdb_TreeRef_t versionRef,  ///< [IN] The version.
+    tdb_NodeRef_t nodeRef      ///< [IN] The node in the original tree.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -287,6 +303,78 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a snapshot, as written by
+ *  tdb_WriteTreeSnapshot().  The snapshot has to be in a file that can be mapped into memory.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if the file isn't a snapshot, or the snapshot is corrupt.
+ *          LE_FAULT if the file couldn't be mapped.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_ReadTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    int descriptor          ///< [IN] The file to read from.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and it's children to a file as a snapshot, in the same binary format the trees
+ *  are saved in.  The node becomes the root of the snapshot.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a JSON document, laid out as written by
+ *  tdb_WriteTreeJson().  Stems are merged into the node's existing children.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if the document isn't valid, or isn't laid out as expected.
+ *          LE_NOT_POSSIBLE if the document conflicts with values already in the tree.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_ReadTreeJson
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    int descriptor          ///< [IN] The file to read from.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and it's children to a file as a JSON document.  Each node is an object with
+ *  a "name" and a "type", and either a "value", or an array of "children".
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeJson
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -656,6 +744,30 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Registers a handler function to be called when a node at or below a given path changes.  The
+ *  handler is given the path to the deepest node holding all of the changes being reported.
+ *
+ *  Both kinds of handler are removed with tdb_RemoveChangeHandler().
+ *
+ *  @return A new safe ref backed object, or NULL if the creation failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_ChangeSummaryHandlerRef_t tdb_AddChangeSummaryHandler
+(
+    tdb_TreeRef_t treeRef,                         ///< [IN] The tree to register the handler on.
+    le_msg_SessionRef_t sessionRef,                ///< [IN] The session that the request came in
+                                                   ///<      on.
+    const char* pathPtr,                           ///< [IN] Path of the node to watch.
+    le_cfg_ChangeSummaryHandlerFunc_t handlerPtr,  ///< [IN] Function to call back.
+    void* contextPtr                               ///< [IN] Opaque value to pass to the function
+                                                   ///<      when called.
+);
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Deregisters a handler function that was registered using tdb_AddChangeHandler().
@@ -0,0 +1,744 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeJournal.c
+ *
+ *  Writing and replaying of configuration tree journals.
+ *
+ *  A journal file is a header followed by entries.  Each entry is an entry header, (the size and
+ *  CRC32 of its payload,) followed by the payload: the operation, the node type and a set of flags,
+ *  one byte each plus a byte of padding, then the path, the new name and the value, each null
+ *  terminated.  Everything is stored in the native byte order.
+ *
+ *  The entries of the commit being merged are collected in memory.  Once the merge is done they're
+ *  taken as a batch, which is written to the journal in one go by one of the tree writer threads.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "treeJournal.h"
+
+
+
+
+/// Magic number at the start of every journal.
+static const char JournalMagic[8] = { '\x7f', 'c', 'f', 'g', 'j', 'r', 'n', 'l' };
+
+
+
+/// Version of the journal format.
+#define JOURNAL_VERSION 1
+
+
+
+/// Initial size of the pending entry buffer.
+#define PENDING_MIN_SIZE 512
+
+
+
+/// Entry flag, the entry has a new name for its node.
+#define ENTRY_HAS_NEW_NAME 0x1
+
+/// Entry flag, the entry has a value for its node.
+#define ENTRY_HAS_VALUE    0x2
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The header at the start of a journal file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[8];            ///< Always JournalMagic.
+    uint32_t version;         ///< JOURNAL_VERSION.
+    uint32_t baseRevision;    ///< Revision of the snapshot the journal applies to.
+}
+Header_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The header of a journal entry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t size;            ///< Size of the payload following the header.
+    uint32_t crc;             ///< CRC32 of the payload.
+}
+EntryHeader_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The fixed part of an entry's payload.  The strings follow it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t op;               ///< One of jrnl_Op_t.
+    uint8_t type;             ///< The le_cfg_nodeType_t of the node.  These values are part of the
+                              ///<   le_cfg API, and so don't change.
+    uint8_t flags;            ///< ENTRY_HAS_NEW_NAME and ENTRY_HAS_VALUE.
+    uint8_t reserved;         ///< Set to 0.
+}
+EntryInfo_t;
+
+
+
+
+/// Entries waiting to be written to the journal of the tree being merged.  They're kept exactly as
+/// they will be written.
+static uint8_t* PendingPtr = NULL;
+
+/// Number of bytes used in the pending entry buffer.
+static size_t PendingSize = 0;
+
+/// Number of bytes allocated for the pending entry buffer.
+static size_t PendingMaxSize = 0;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A batch of entries taken from the pending entry buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct jrnl_Batch
+{
+    uint8_t* dataPtr;  ///< The entries, exactly as they will be written.
+    size_t size;       ///< Number of bytes of entries.
+}
+Batch_t;
+
+
+
+/// Pool of batches.
+static le_mem_PoolRef_t BatchPool = NULL;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Make room for more bytes in the pending entry buffer.
+ *
+ *  @return Pointer to the start of the new bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* ReservePending
+(
+    size_t size  ///< [IN] Number of bytes needed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (PendingSize + size > PendingMaxSize)
+    {
+        size_t newMax = PendingMaxSize * 2;
+
+        while (PendingSize + size > newMax)
+        {
+            newMax *= 2;
+        }
+
+        PendingPtr = realloc(PendingPtr, newMax);
+        LE_ASSERT(PendingPtr != NULL);
+        PendingMaxSize = newMax;
+    }
+
+    uint8_t* bytePtr = PendingPtr + PendingSize;
+    PendingSize += size;
+
+    return bytePtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a whole buffer to a file.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int descriptor,       ///< [IN] The file to write to.
+    const void* dataPtr,  ///< [IN] The data to write.
+    size_t dataSize       ///< [IN] The size of the data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* bytePtr = dataPtr;
+
+    while (dataSize > 0)
+    {
+        ssize_t written = write(descriptor, bytePtr, dataSize);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LE_EMERG("Failed to write config tree journal (%m).");
+            return LE_IO_ERROR;
+        }
+
+        bytePtr += written;
+        dataSize -= written;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Close a file descriptor, retrying if interrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseFd
+(
+    int descriptor  ///< [IN] The file to close.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int retVal;
+
+    do
+    {
+        retVal = close(descriptor);
+    }
+    while ((retVal == -1) && (errno == EINTR));
+
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree journal: %m");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the next string from an entry's payload.
+ *
+ *  @return The string, or NULL if it runs past the end of the payload.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* NextString
+(
+    const uint8_t** bytePtrPtr,  ///< [IN/OUT] Where the string starts.  Moved past the string.
+    const uint8_t* endPtr        ///< [IN] The end of the payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = *bytePtrPtr;
+    const uint8_t* nullPtr = memchr(bytePtr, '\0', endPtr - bytePtr);
+
+    if (nullPtr == NULL)
+    {
+        return NULL;
+    }
+
+    *bytePtrPtr = nullPtr + 1;
+    return (const char*)bytePtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the journal subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Tree Journal subsystem.");
+
+    BatchPool = le_mem_CreatePool("journalBatchPool", sizeof(Batch_t));
+
+    PendingPtr = malloc(PENDING_MIN_SIZE);
+    LE_ASSERT(PendingPtr != NULL);
+
+    PendingSize = 0;
+    PendingMaxSize = PENDING_MIN_SIZE;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add an entry to the list of entries pending for the commit being merged.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_AddEntry
+(
+    const jrnl_Entry_t* entryPtr  ///< [IN] The entry, it is copied.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* newNamePtr = (entryPtr->newNamePtr != NULL) ? entryPtr->newNamePtr : "";
+    const char* valuePtr = (entryPtr->valuePtr != NULL) ? entryPtr->valuePtr : "";
+
+    size_t pathSize = strlen(entryPtr->pathPtr) + 1;
+    size_t newNameSize = strlen(newNamePtr) + 1;
+    size_t valueSize = strlen(valuePtr) + 1;
+    size_t payloadSize = sizeof(EntryInfo_t) + pathSize + newNameSize + valueSize;
+
+    // Remember where the entry starts, the buffer may move while it's being reserved.
+    size_t entryOffset = PendingSize;
+    uint8_t* bytePtr = ReservePending(sizeof(EntryHeader_t) + payloadSize);
+    uint8_t* payloadPtr = bytePtr + sizeof(EntryHeader_t);
+
+    EntryInfo_t info =
+        {
+            .op = entryPtr->op,
+            .type = entryPtr->type,
+            .flags =   ((entryPtr->newNamePtr != NULL) ? ENTRY_HAS_NEW_NAME : 0)
+                     | ((entryPtr->valuePtr != NULL) ? ENTRY_HAS_VALUE : 0),
+            .reserved = 0
+        };
+
+    memcpy(payloadPtr, &info, sizeof(info));
+    payloadPtr += sizeof(info);
+    memcpy(payloadPtr, entryPtr->pathPtr, pathSize);
+    payloadPtr += pathSize;
+    memcpy(payloadPtr, newNamePtr, newNameSize);
+    payloadPtr += newNameSize;
+    memcpy(payloadPtr, valuePtr, valueSize);
+
+    EntryHeader_t header =
+        {
+            .size = payloadSize,
+            .crc = le_crc_Crc32(PendingPtr + entryOffset + sizeof(EntryHeader_t),
+                                payloadSize,
+                                LE_CRC_START_CRC32)
+        };
+
+    memcpy(PendingPtr + entryOffset, &header, sizeof(header));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the size the pending entries will take up in a journal file.
+ *
+ *  @return The size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t jrnl_GetPendingSize
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return PendingSize;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Throw away the pending entries.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_DiscardPending
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PendingSize = 0;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Take the pending entries as a batch, to be written to a journal later.  The list of pending
+ *  entries is left empty.
+ *
+ *  @return The batch.
+ */
+//--------------------------------------------------------------------------------------------------
+jrnl_BatchRef_t jrnl_TakePending
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    jrnl_BatchRef_t batchRef = le_mem_ForceAlloc(BatchPool);
+
+    // The batch takes the buffer over, and a new one is started for the next commit.
+    batchRef->dataPtr = PendingPtr;
+    batchRef->size = PendingSize;
+
+    PendingPtr = malloc(PENDING_MIN_SIZE);
+    LE_ASSERT(PendingPtr != NULL);
+
+    PendingSize = 0;
+    PendingMaxSize = PENDING_MIN_SIZE;
+
+    return batchRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the size a journal file will have once a batch has been appended to it.
+ *
+ *  @return The size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t jrnl_GetSizeAfter
+(
+    size_t journalSize,       ///< [IN] Size of the journal file, 0 if there isn't one yet.
+    jrnl_BatchRef_t batchRef  ///< [IN] The batch to append.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (batchRef->size == 0)
+    {
+        return journalSize;
+    }
+
+    return ((journalSize == 0) ? sizeof(Header_t) : journalSize) + batchRef->size;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a batch of entries to a journal file, and flush them to the disk.  If the journal is
+ *  empty, the file is started over.  If the entries can't be written the journal is deleted, so the
+ *  batches written after this one can never be replayed without it.
+ *
+ *  This only uses the batch it's given, so it can be called from any thread.
+ *
+ *  @return LE_OK if the entries were written.
+ *          LE_NOT_PERMITTED if the filesystem is read only, the entries are thrown away.
+ *          LE_IO_ERROR if the entries could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t jrnl_WriteBatch
+(
+    const char* pathPtr,       ///< [IN] Path to the journal file.
+    int baseRevision,          ///< [IN] Revision of the snapshot the journal applies to.
+    jrnl_BatchRef_t batchRef,  ///< [IN] The entries to write.
+    size_t journalSize         ///< [IN] Size of the journal file, 0 if there isn't one yet.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (batchRef->size == 0)
+    {
+        return LE_OK;
+    }
+
+    int fd;
+
+    do
+    {
+        fd = open(pathPtr, O_WRONLY | O_APPEND | O_CREAT, S_IRUSR | S_IWUSR);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        if (errno == EROFS)
+        {
+            // In case we are R/O for the config tree, we discard the update to flash.
+            return LE_NOT_PERMITTED;
+        }
+
+        LE_EMERG("Failed to open config tree journal '%s' (%m).", pathPtr);
+        jrnl_Delete(pathPtr);
+
+        return LE_IO_ERROR;
+    }
+
+    le_result_t result = LE_OK;
+
+    // A new journal gets a new header, and loses anything that was left in an old one.
+    if (journalSize == 0)
+    {
+        Header_t header;
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, JournalMagic, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.baseRevision = baseRevision;
+
+        if (ftruncate(fd, 0) == -1)
+        {
+            LE_EMERG("Failed to clear config tree journal '%s' (%m).", pathPtr);
+            result = LE_IO_ERROR;
+        }
+        else
+        {
+            result = WriteAll(fd, &header, sizeof(header));
+        }
+    }
+
+    if (result == LE_OK)
+    {
+        result = WriteAll(fd, batchRef->dataPtr, batchRef->size);
+    }
+
+    if (   (result == LE_OK)
+        && (fdatasync(fd) == -1))
+    {
+        LE_EMERG("Failed to flush config tree journal '%s' (%m).", pathPtr);
+        result = LE_IO_ERROR;
+    }
+
+    CloseFd(fd);
+
+    if (result != LE_OK)
+    {
+        // Without these entries, the ones appended after them would be replayed onto the wrong
+        // tree.  It's better to fall back to the snapshot until the tree is saved again.
+        jrnl_Delete(pathPtr);
+    }
+
+    return result;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free a batch of entries.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_DeleteBatch
+(
+    jrnl_BatchRef_t batchRef  ///< [IN] The batch.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(batchRef->dataPtr);
+    le_mem_Release(batchRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply the entries of a journal file.  A journal for a different revision of the tree is
+ *  deleted.  Any partly written entry at the end of the journal is cut off.
+ *
+ *  @return LE_OK if the journal was replayed, (it may have been empty.)
+ *          LE_NOT_FOUND if there is no journal for the given revision.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t jrnl_Replay
+(
+    const char* pathPtr,         ///< [IN] Path to the journal file.
+    int baseRevision,            ///< [IN] Revision of the snapshot that was loaded.
+    jrnl_ApplyFunc_t applyFunc,  ///< [IN] Called for each entry.
+    void* contextPtr,            ///< [IN] Given to applyFunc.
+    size_t* journalSizePtr       ///< [OUT] Size of the valid part of the journal, 0 if none.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *journalSizePtr = 0;
+
+    int fd;
+
+    do
+    {
+        fd = open(pathPtr, O_RDWR);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Could not open config tree journal '%s' (%m).", pathPtr);
+        }
+
+        return LE_NOT_FOUND;
+    }
+
+    // Journals are kept small by saving the tree once they grow, so read it in one go.
+    struct stat s;
+    uint8_t* bufferPtr = NULL;
+    ssize_t readSize = -1;
+
+    if (fstat(fd, &s) == -1)
+    {
+        LE_ERROR("Can't stat config tree journal '%s' (%m).", pathPtr);
+    }
+    else if ((size_t)s.st_size >= sizeof(Header_t))
+    {
+        bufferPtr = malloc(s.st_size);
+        LE_ASSERT(bufferPtr != NULL);
+
+        do
+        {
+            readSize = pread(fd, bufferPtr, s.st_size, 0);
+        }
+        while ((readSize == -1) && (errno == EINTR));
+    }
+
+    bool isValid = (bufferPtr != NULL) && (readSize == s.st_size);
+
+    if (isValid)
+    {
+        Header_t header;
+        memcpy(&header, bufferPtr, sizeof(header));
+
+        isValid =    (memcmp(header.magic, JournalMagic, sizeof(header.magic)) == 0)
+                  && (header.version == JOURNAL_VERSION)
+                  && (header.baseRevision == (uint32_t)baseRevision);
+    }
+
+    if (!isValid)
+    {
+        // The tree was saved after this journal was written, (or it's not a journal at all.)
+        LE_DEBUG("Discarding stale config tree journal '%s'.", pathPtr);
+
+        free(bufferPtr);
+        CloseFd(fd);
+        jrnl_Delete(pathPtr);
+
+        return LE_NOT_FOUND;
+    }
+
+    size_t offset = sizeof(Header_t);
+    size_t numEntries = 0;
+
+    while (offset < (size_t)s.st_size)
+    {
+        EntryHeader_t entryHeader;
+        size_t remaining = s.st_size - offset;
+
+        if (remaining < sizeof(entryHeader))
+        {
+            break;
+        }
+
+        memcpy(&entryHeader, bufferPtr + offset, sizeof(entryHeader));
+
+        if (   (entryHeader.size < sizeof(EntryInfo_t))
+            || (entryHeader.size > remaining - sizeof(entryHeader)))
+        {
+            break;
+        }
+
+        uint8_t* payloadPtr = bufferPtr + offset + sizeof(entryHeader);
+        const uint8_t* endPtr = payloadPtr + entryHeader.size;
+
+        if (le_crc_Crc32(payloadPtr, entryHeader.size, LE_CRC_START_CRC32) != entryHeader.crc)
+        {
+            break;
+        }
+
+        EntryInfo_t info;
+        memcpy(&info, payloadPtr, sizeof(info));
+
+        // The strings have to be read in order.
+        const uint8_t* stringPtr = payloadPtr + sizeof(info);
+        jrnl_Entry_t entry;
+
+        entry.op = info.op;
+        entry.type = info.type;
+        entry.pathPtr = NextString(&stringPtr, endPtr);
+        entry.newNamePtr = (entry.pathPtr != NULL) ? NextString(&stringPtr, endPtr) : NULL;
+        entry.valuePtr = (entry.newNamePtr != NULL) ? NextString(&stringPtr, endPtr) : NULL;
+
+        if (   (entry.pathPtr == NULL)
+            || (entry.newNamePtr == NULL)
+            || (entry.valuePtr == NULL))
+        {
+            break;
+        }
+
+        if ((info.flags & ENTRY_HAS_NEW_NAME) == 0)
+        {
+            entry.newNamePtr = NULL;
+        }
+
+        if ((info.flags & ENTRY_HAS_VALUE) == 0)
+        {
+            entry.valuePtr = NULL;
+        }
+
+        applyFunc(&entry, contextPtr);
+
+        offset += sizeof(entryHeader) + entryHeader.size;
+        numEntries++;
+    }
+
+    if (offset < (size_t)s.st_size)
+    {
+        LE_WARN("Discarding %zu bytes of incomplete entries from config tree journal '%s'.",
+                (size_t)s.st_size - offset,
+                pathPtr);
+
+        LE_ERROR_IF(ftruncate(fd, offset) == -1,
+                    "Failed to truncate config tree journal '%s' (%m).",
+                    pathPtr);
+    }
+
+    LE_DEBUG("Replayed %zu entries from config tree journal '%s'.", numEntries, pathPtr);
+
+    free(bufferPtr);
+    CloseFd(fd);
+
+    *journalSizePtr = offset;
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Delete a journal file, if it exists.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_Delete
+(
+    const char* pathPtr  ///< [IN] Path to the journal file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   (unlink(pathPtr) != 0)
+        && (errno != ENOENT))
+    {
+        LE_ERROR("Failed to delete config tree journal '%s' (%m).", pathPtr);
+    }
+}
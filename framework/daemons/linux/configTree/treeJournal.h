@@ -0,0 +1,244 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeJournal.h
+ *
+ *  Journals of the changes committed to configuration trees since their last snapshot was saved.
+ *
+ *  Rather than saving a whole tree every time a write transaction is committed, the changes the
+ *  commit made are appended to the tree's journal file as a list of entries, one per merged node.
+ *  When a tree is loaded its snapshot is loaded first, then the entries in the journal are applied
+ *  to it, in order.  Once the journal has grown too big, the tree is saved as a new snapshot and the
+ *  journal is started over.
+ *
+ *  Each journal records the revision of the snapshot it applies to, so a journal that was left
+ *  behind when the tree was saved can be recognized and thrown away.  Every entry has its own
+ *  CRC, so an entry that was only partly written when the power went is ignored, along with
+ *  everything after it.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_TREE_JOURNAL_INCLUDE_GUARD
+#define CFG_TREE_JOURNAL_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The operations a journal entry can record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    JRNL_SET_NODE = 1,     ///< Find or create a node, then rename it and update its type and value.
+    JRNL_DELETE_NODE = 2   ///< Delete a node, (or clear it out, if it's the root.)
+}
+jrnl_Op_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A journal entry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    jrnl_Op_t op;            ///< What the entry does.
+    const char* pathPtr;     ///< Absolute path to the node in its tree, before it's renamed.
+    const char* newNamePtr;  ///< The node's new name, or NULL if it isn't renamed.
+    le_cfg_nodeType_t type;  ///< The node's new type.
+    const char* valuePtr;    ///< The node's new value, or NULL if the value is left alone.
+}
+jrnl_Entry_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A batch of entries, taken from the pending list to be written to a journal.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct jrnl_Batch* jrnl_BatchRef_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Prototype for the functions that apply journal entries to a tree as the journal is replayed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*jrnl_ApplyFunc_t)
+(
+    const jrnl_Entry_t* entryPtr,  ///< [IN] The entry.  Its strings are only valid during the call.
+    void* contextPtr               ///< [IN] The context given to jrnl_Replay().
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the journal subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add an entry to the list of entries pending for the commit being merged.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_AddEntry
+(
+    const jrnl_Entry_t* entryPtr  ///< [IN] The entry, it is copied.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the size the pending entries will take up in a journal file.
+ *
+ *  @return The size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t jrnl_GetPendingSize
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Throw away the pending entries.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_DiscardPending
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Take the pending entries as a batch, to be written to a journal later.  The list of pending
+ *  entries is left empty.
+ *
+ *  @return The batch.
+ */
+//--------------------------------------------------------------------------------------------------
+jrnl_BatchRef_t jrnl_TakePending
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the size a journal file will have once a batch has been appended to it.
+ *
+ *  @return The size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t jrnl_GetSizeAfter
+(
+    size_t journalSize,       ///< [IN] Size of the journal file, 0 if there isn't one yet.
+    jrnl_BatchRef_t batchRef  ///< [IN] The batch to append.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a batch of entries to a journal file, and flush them to the disk.  If the journal is
+ *  empty, the file is started over.  If the entries can't be written the journal is deleted, so the
+ *  batches written after this one can never be replayed without it.
+ *
+ *  This only uses the batch it's given, so it can be called from any thread.
+ *
+ *  @return LE_OK if the entries were written.
+ *          LE_NOT_PERMITTED if the filesystem is read only, the entries are thrown away.
+ *          LE_IO_ERROR if the entries could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t jrnl_WriteBatch
+(
+    const char* pathPtr,       ///< [IN] Path to the journal file.
+    int baseRevision,          ///< [IN] Revision of the snapshot the journal applies to.
+    jrnl_BatchRef_t batchRef,  ///< [IN] The entries to write.
+    size_t journalSize         ///< [IN] Size of the journal file, 0 if there isn't one yet.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free a batch of entries.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_DeleteBatch
+(
+    jrnl_BatchRef_t batchRef  ///< [IN] The batch.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply the entries of a journal file.  A journal for a different revision of the tree is
+ *  deleted.  Any partly written entry at the end of the journal is cut off.
+ *
+ *  @return LE_OK if the journal was replayed, (it may have been empty.)
+ *          LE_NOT_FOUND if there is no journal for the given revision.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t jrnl_Replay
+(
+    const char* pathPtr,         ///< [IN] Path to the journal file.
+    int baseRevision,            ///< [IN] Revision of the snapshot that was loaded.
+    jrnl_ApplyFunc_t applyFunc,  ///< [IN] Called for each entry.
+    void* contextPtr,            ///< [IN] Given to applyFunc.
+    size_t* journalSizePtr       ///< [OUT] Size of the valid part of the journal, 0 if none.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Delete a journal file, if it exists.
+ */
+//--------------------------------------------------------------------------------------------------
+void jrnl_Delete
+(
+    const char* pathPtr  ///< [IN] Path to the journal file.
+);
+
+
+
+
+#endif
@@ -0,0 +1,898 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeSnapshot.c
+ *
+ *  Reading, (by memory mapping,) and writing of binary configuration tree snapshots.
+ *
+ *  The file layout is:
+ *
+ * @verbatim
+
+    +--------+-----------------------------------+----------------------------------+
+    | Header | Node records, (numRecords of them) | Strings, (stringsSize bytes)     |
+    +--------+-----------------------------------+----------------------------------+
+
+@endverbatim
+ *
+ *  Everything is stored in the native byte order, as the files never leave the device that wrote
+ *  them.  The string block always starts with an empty string, which is what offset 0 refers to,
+ *  and ends with a NULL, so any offset into it is a valid C-String.
+ *
+ *  A corrupt snapshot must not be able to crash the daemon, so every record and offset is checked
+ *  as it is read.  The children of a stem must come after the stem itself, which means walking a
+ *  snapshot always ends, whatever the records contain.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "treeSnapshot.h"
+#include <sys/mman.h>
+
+
+
+
+/// Magic number at the start of every snapshot.  Text tree files can never start with this.
+static const char SnapshotMagic[8] = { '\x7f', 'c', 'f', 'g', 's', 'n', 'a', 'p' };
+
+
+
+/// Version of the snapshot format.
+#define SNAPSHOT_VERSION 1
+
+
+
+/// Initial number of records allocated by a builder.
+#define BUILDER_MIN_RECORDS 64
+
+
+
+/// Initial size of the string block of a builder.
+#define BUILDER_MIN_STRINGS 1024
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The types of the node records, as they're stored in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    RT_EMPTY  = 0,  ///< Node without any value.
+    RT_STRING = 1,  ///< UTF-8 text string.
+    RT_BOOL   = 2,  ///< Boolean value, stored as the string "true" or "false".
+    RT_INT    = 3,  ///< Signed integer, stored as a string.
+    RT_FLOAT  = 4,  ///< Floating point number, stored as a string.
+    RT_STEM   = 5   ///< Node with children.
+}
+RecordType_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The header at the start of a snapshot file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[8];            ///< Always SnapshotMagic.
+    uint32_t version;         ///< SNAPSHOT_VERSION.
+    uint32_t numRecords;      ///< Number of node records, at least 1 for the root.
+    uint32_t stringsSize;     ///< Size of the string block in bytes.
+    uint32_t reserved;        ///< Set to 0.
+}
+Header_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A node record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t nameOffset;      ///< Offset of the node's name in the string block.
+    uint32_t type;            ///< One of RecordType_t.
+    uint32_t data;            ///< For stems the record of the first child, otherwise the offset
+                              ///<   of the node's value in the string block.
+    uint32_t numChildren;     ///< For stems, the number of children.  Otherwise 0.
+}
+Record_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A memory mapped snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct snap_Snapshot
+{
+    void* basePtr;             ///< Start of the mapping.
+    size_t size;               ///< Size of the mapping.
+    const Record_t* records;   ///< The node records.
+    uint32_t numRecords;       ///< Number of node records.
+    const char* strings;       ///< The string block.
+    uint32_t stringsSize;      ///< Size of the string block in bytes.
+}
+Snapshot_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A snapshot being built.  The records and strings are grown on the heap as they're added.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct snap_Builder
+{
+    Record_t* records;         ///< The node records.
+    size_t numRecords;         ///< Number of records in use.
+    size_t maxRecords;         ///< Number of records allocated.
+    char* strings;             ///< The string block.
+    size_t stringsSize;        ///< Number of bytes of the string block in use.
+    size_t maxStrings;         ///< Number of bytes allocated for the string block.
+}
+Builder_t;
+
+
+
+
+/// Pool of mapped snapshot objects.
+static le_mem_PoolRef_t SnapshotPool = NULL;
+
+
+
+/// Pool of snapshot builders.
+static le_mem_PoolRef_t BuilderPool = NULL;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Unmap a snapshot when its last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SnapshotDestructor
+(
+    void* objectPtr  ///< [IN] The snapshot being freed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Snapshot_t* snapPtr = objectPtr;
+
+    if (munmap(snapPtr->basePtr, snapPtr->size) != 0)
+    {
+        LE_ERROR("Failed to unmap config tree snapshot (%m).");
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a node record from a snapshot.
+ *
+ *  @return The record, or NULL if there is no such record.
+ */
+//--------------------------------------------------------------------------------------------------
+static const Record_t* GetRecord
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(snapRef != NULL);
+
+    if (index >= snapRef->numRecords)
+    {
+        LE_CRIT("Config tree snapshot record %" PRIu32 " out of range.", index);
+        return NULL;
+    }
+
+    return &snapRef->records[index];
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a string from the string block of a snapshot.
+ *
+ *  @return The string, or the empty string if the offset is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetString
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t offset      ///< [IN] Offset of the string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (offset >= snapRef->stringsSize)
+    {
+        LE_CRIT("Config tree snapshot string offset %" PRIu32 " out of range.", offset);
+        return "";
+    }
+
+    // The block is known to end with a NULL, so this is a valid C-String.
+    return snapRef->strings + offset;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a whole buffer to a file.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int descriptor,       ///< [IN] The file to write to.
+    const void* dataPtr,  ///< [IN] The data to write.
+    size_t dataSize       ///< [IN] The size of the data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* bytePtr = dataPtr;
+
+    while (dataSize > 0)
+    {
+        ssize_t written = write(descriptor, bytePtr, dataSize);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LE_EMERG("Failed to write config tree snapshot (%m).");
+            return LE_IO_ERROR;
+        }
+
+        bytePtr += written;
+        dataSize -= written;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a string to a builder's string block.
+ *
+ *  @return The offset of the string in the block.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AddString
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    const char* textPtr            ///< [IN] The string, NULL is the same as the empty string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((textPtr == NULL) || (textPtr[0] == '\0'))
+    {
+        return 0;
+    }
+
+    size_t size = strlen(textPtr) + 1;
+
+    if (builderRef->stringsSize + size > builderRef->maxStrings)
+    {
+        size_t newMax = builderRef->maxStrings * 2;
+
+        while (builderRef->stringsSize + size > newMax)
+        {
+            newMax *= 2;
+        }
+
+        builderRef->strings = realloc(builderRef->strings, newMax);
+        LE_ASSERT(builderRef->strings != NULL);
+        builderRef->maxStrings = newMax;
+    }
+
+    LE_FATAL_IF(builderRef->stringsSize + size > UINT32_MAX, "Config tree snapshot is too big.");
+
+    uint32_t offset = builderRef->stringsSize;
+
+    memcpy(builderRef->strings + offset, textPtr, size);
+    builderRef->stringsSize += size;
+
+    return offset;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get one of a builder's records.
+ *
+ *  @return The record.
+ */
+//--------------------------------------------------------------------------------------------------
+static Record_t* GetBuilderRecord
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index                 ///< [IN] The record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(index < builderRef->numRecords);
+
+    return &builderRef->records[index];
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the snapshot subsystem and the memory pools it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Tree Snapshot subsystem.");
+
+    SnapshotPool = le_mem_CreatePool("snapshotPool", sizeof(Snapshot_t));
+    le_mem_SetDestructor(SnapshotPool, SnapshotDestructor);
+
+    BuilderPool = le_mem_CreatePool("snapshotBuilderPool", sizeof(Builder_t));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Map a snapshot file into memory.
+ *
+ *  The descriptor may be closed once this returns, the mapping does not depend on it.
+ *
+ *  @return LE_OK if the file was mapped.
+ *          LE_UNSUPPORTED if the file isn't a snapshot, (it may be in the text format.)
+ *          LE_FORMAT_ERROR if the file is a snapshot, but it's truncated or corrupt.
+ *          LE_FAULT if the file couldn't be mapped.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t snap_Open
+(
+    int descriptor,         ///< [IN] The file to map.
+    snap_Ref_t* snapRefPtr  ///< [OUT] The mapped snapshot, if LE_OK is returned.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Check the magic number before mapping anything, most text files are tiny.
+    char magic[sizeof(SnapshotMagic)];
+    ssize_t readSize;
+
+    do
+    {
+        readSize = pread(descriptor, magic, sizeof(magic), 0);
+    }
+    while ((readSize == -1) && (errno == EINTR));
+
+    if (   (readSize != sizeof(magic))
+        || (memcmp(magic, SnapshotMagic, sizeof(magic)) != 0))
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    struct stat s;
+
+    if (fstat(descriptor, &s) == -1)
+    {
+        LE_ERROR("Can't stat config tree snapshot (%m).");
+        return LE_FAULT;
+    }
+
+    if ((size_t)s.st_size < sizeof(Header_t))
+    {
+        LE_ERROR("Config tree snapshot is truncated.");
+        return LE_FORMAT_ERROR;
+    }
+
+    void* basePtr = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    if (basePtr == MAP_FAILED)
+    {
+        LE_ERROR("Can't map config tree snapshot (%m).");
+        return LE_FAULT;
+    }
+
+    // Make sure that the records and the strings fill the file exactly.
+    const Header_t* headerPtr = basePtr;
+    uint64_t expectedSize =   sizeof(Header_t)
+                            + ((uint64_t)headerPtr->numRecords * sizeof(Record_t))
+                            + headerPtr->stringsSize;
+    const char* stringsPtr = (const char*)basePtr
+                             + sizeof(Header_t)
+                             + ((size_t)headerPtr->numRecords * sizeof(Record_t));
+
+    if (   (headerPtr->version != SNAPSHOT_VERSION)
+        || (headerPtr->numRecords == 0)
+        || (headerPtr->stringsSize == 0)
+        || (expectedSize != (uint64_t)s.st_size)
+        || (stringsPtr[0] != '\0')
+        || (stringsPtr[headerPtr->stringsSize - 1] != '\0'))
+    {
+        LE_ERROR("Config tree snapshot is corrupt, (version %" PRIu32 ", %" PRIu32 " records, "
+                 "%" PRIu32 " bytes of strings, file size %lld.)",
+                 headerPtr->version,
+                 headerPtr->numRecords,
+                 headerPtr->stringsSize,
+                 (long long)s.st_size);
+
+        munmap(basePtr, s.st_size);
+        return LE_FORMAT_ERROR;
+    }
+
+    snap_Ref_t snapRef = le_mem_ForceAlloc(SnapshotPool);
+
+    snapRef->basePtr = basePtr;
+    snapRef->size = s.st_size;
+    snapRef->records = (const Record_t*)((const char*)basePtr + sizeof(Header_t));
+    snapRef->numRecords = headerPtr->numRecords;
+    snapRef->strings = stringsPtr;
+    snapRef->stringsSize = headerPtr->stringsSize;
+
+    LE_DEBUG("Mapped config tree snapshot, %" PRIu32 " nodes, %zu bytes.",
+             snapRef->numRecords,
+             snapRef->size);
+
+    *snapRefPtr = snapRef;
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a reference to a snapshot.
+ *
+ *  @return The same snapshot, for convenience.
+ */
+//--------------------------------------------------------------------------------------------------
+snap_Ref_t snap_AddRef
+(
+    snap_Ref_t snapRef  ///< [IN] The snapshot.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mem_AddRef(snapRef);
+    return snapRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_Release
+(
+    snap_Ref_t snapRef  ///< [IN] The snapshot.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mem_Release(snapRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the type of a node in a snapshot.  A stem without any children is reported as empty.
+ *
+ *  @return The node's type.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_nodeType_t snap_GetType
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const Record_t* recordPtr = GetRecord(snapRef, index);
+
+    if (recordPtr == NULL)
+    {
+        return LE_CFG_TYPE_EMPTY;
+    }
+
+    switch (recordPtr->type)
+    {
+        case RT_STRING:
+            return LE_CFG_TYPE_STRING;
+
+        case RT_BOOL:
+            return LE_CFG_TYPE_BOOL;
+
+        case RT_INT:
+            return LE_CFG_TYPE_INT;
+
+        case RT_FLOAT:
+            return LE_CFG_TYPE_FLOAT;
+
+        case RT_STEM:
+            return recordPtr->numChildren > 0 ? LE_CFG_TYPE_STEM : LE_CFG_TYPE_EMPTY;
+
+        case RT_EMPTY:
+            return LE_CFG_TYPE_EMPTY;
+    }
+
+    LE_CRIT("Config tree snapshot record %" PRIu32 " has a bad type, %" PRIu32 ".",
+            index,
+            recordPtr->type);
+
+    return LE_CFG_TYPE_EMPTY;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the name of a node in a snapshot.
+ *
+ *  @return The name, it stays valid as long as the caller holds a reference to the snapshot.  The
+ *          root node's name is the empty string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* snap_GetName
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const Record_t* recordPtr = GetRecord(snapRef, index);
+
+    return recordPtr == NULL ? "" : GetString(snapRef, recordPtr->nameOffset);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the value of a node in a snapshot, as a string.
+ *
+ *  @return The value, it stays valid as long as the caller holds a reference to the snapshot.
+ *          Stems and empty nodes have the empty string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* snap_GetValue
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const Record_t* recordPtr = GetRecord(snapRef, index);
+
+    if (   (recordPtr == NULL)
+        || (recordPtr->type == RT_STEM)
+        || (recordPtr->type == RT_EMPTY))
+    {
+        return "";
+    }
+
+    return GetString(snapRef, recordPtr->data);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the children of a stem node in a snapshot.  Their records are firstIndex to
+ *  firstIndex + count - 1.
+ *
+ *  @return The number of children, (0 if the node isn't a stem.)
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t snap_GetChildren
+(
+    snap_Ref_t snapRef,     ///< [IN] The snapshot.
+    uint32_t index,         ///< [IN] The node's record.
+    uint32_t* firstIdxPtr   ///< [OUT] The record of the first child.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const Record_t* recordPtr = GetRecord(snapRef, index);
+
+    *firstIdxPtr = 0;
+
+    if (   (recordPtr == NULL)
+        || (recordPtr->type != RT_STEM)
+        || (recordPtr->numChildren == 0))
+    {
+        return 0;
+    }
+
+    // Children always come after their parent, and must all be in the file.
+    if (   (recordPtr->data <= index)
+        || (recordPtr->data >= snapRef->numRecords)
+        || (recordPtr->numChildren > snapRef->numRecords - recordPtr->data))
+    {
+        LE_CRIT("Config tree snapshot record %" PRIu32 " has bad children.", index);
+        return 0;
+    }
+
+    *firstIdxPtr = recordPtr->data;
+    return recordPtr->numChildren;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start building a new snapshot.  The new snapshot has an empty root node.
+ *
+ *  @return The new builder.
+ */
+//--------------------------------------------------------------------------------------------------
+snap_BuilderRef_t snap_CreateBuilder
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    snap_BuilderRef_t builderRef = le_mem_ForceAlloc(BuilderPool);
+
+    builderRef->records = calloc(BUILDER_MIN_RECORDS, sizeof(Record_t));
+    LE_ASSERT(builderRef->records != NULL);
+    builderRef->numRecords = 1;
+    builderRef->maxRecords = BUILDER_MIN_RECORDS;
+
+    // Offset 0 is the empty string.
+    builderRef->strings = calloc(BUILDER_MIN_STRINGS, 1);
+    LE_ASSERT(builderRef->strings != NULL);
+    builderRef->stringsSize = 1;
+    builderRef->maxStrings = BUILDER_MIN_STRINGS;
+
+    return builderRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Throw away a builder, and anything it has built.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_DeleteBuilder
+(
+    snap_BuilderRef_t builderRef  ///< [IN] The builder.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(builderRef->records);
+    free(builderRef->strings);
+    le_mem_Release(builderRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Fill in a node record with a value.  Stems are filled in with snap_AddChildren() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_SetValue
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    le_cfg_nodeType_t type,        ///< [IN] The node's type.
+    const char* valuePtr           ///< [IN] The node's value, may be NULL for empty nodes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RecordType_t recordType;
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+            recordType = RT_STRING;
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            recordType = RT_BOOL;
+            break;
+
+        case LE_CFG_TYPE_INT:
+            recordType = RT_INT;
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            recordType = RT_FLOAT;
+            break;
+
+        default:
+            recordType = RT_EMPTY;
+            break;
+    }
+
+    uint32_t nameOffset = AddString(builderRef, namePtr);
+    uint32_t valueOffset = recordType == RT_EMPTY ? 0 : AddString(builderRef, valuePtr);
+
+    Record_t* recordPtr = GetBuilderRecord(builderRef, index);
+
+    recordPtr->nameOffset = nameOffset;
+    recordPtr->type = recordType;
+    recordPtr->data = valueOffset;
+    recordPtr->numChildren = 0;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Turn a node record into a stem and allocate the records for its children.  The children are
+ *  left empty, and have to be filled in by the caller.
+ *
+ *  @return The record of the first child.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t snap_AddChildren
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    uint32_t count                 ///< [IN] The number of children.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(builderRef->numRecords + count > UINT32_MAX, "Config tree snapshot is too big.");
+
+    if (builderRef->numRecords + count > builderRef->maxRecords)
+    {
+        size_t newMax = builderRef->maxRecords * 2;
+
+        while (builderRef->numRecords + count > newMax)
+        {
+            newMax *= 2;
+        }
+
+        builderRef->records = realloc(builderRef->records, newMax * sizeof(Record_t));
+        LE_ASSERT(builderRef->records != NULL);
+        builderRef->maxRecords = newMax;
+    }
+
+    uint32_t firstIndex = builderRef->numRecords;
+
+    memset(&builderRef->records[firstIndex], 0, count * sizeof(Record_t));
+    builderRef->numRecords += count;
+
+    uint32_t nameOffset = AddString(builderRef, namePtr);
+    Record_t* recordPtr = GetBuilderRecord(builderRef, index);
+
+    recordPtr->nameOffset = nameOffset;
+    recordPtr->type = RT_STEM;
+    recordPtr->data = firstIndex;
+    recordPtr->numChildren = count;
+
+    return firstIndex;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Fill in a node record, and everything under it, from a node in another snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_CopyNode
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    snap_Ref_t srcSnapRef,         ///< [IN] The snapshot to copy from.
+    uint32_t srcIndex              ///< [IN] The record to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t type = snap_GetType(srcSnapRef, srcIndex);
+
+    if (type != LE_CFG_TYPE_STEM)
+    {
+        snap_SetValue(builderRef, index, namePtr, type, snap_GetValue(srcSnapRef, srcIndex));
+        return;
+    }
+
+    uint32_t srcFirst;
+    uint32_t count = snap_GetChildren(srcSnapRef, srcIndex, &srcFirst);
+    uint32_t first = snap_AddChildren(builderRef, index, namePtr, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        snap_CopyNode(builderRef,
+                      first + i,
+                      snap_GetName(srcSnapRef, srcFirst + i),
+                      srcSnapRef,
+                      srcFirst + i);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a built snapshot to a file.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t snap_Write
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    int descriptor                 ///< [IN] The file to write to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Header_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.numRecords = builderRef->numRecords;
+    header.stringsSize = builderRef->stringsSize;
+
+    le_result_t result = WriteAll(descriptor, &header, sizeof(header));
+
+    if (result == LE_OK)
+    {
+        result = WriteAll(descriptor,
+                          builderRef->records,
+                          builderRef->numRecords * sizeof(Record_t));
+    }
+
+    if (result == LE_OK)
+    {
+        result = WriteAll(descriptor, builderRef->strings, builderRef->stringsSize);
+    }
+
+    return result;
+}
@@ -0,0 +1,284 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeSnapshot.h
+ *
+ *  Binary snapshots of configuration trees.  This is the format the trees are kept in on the
+ *  filesystem, (the text format is still used for import and export.)
+ *
+ *  A snapshot is a header, followed by an array of fixed size node records, followed by a block of
+ *  null terminated strings that hold the node names and values.  The root node is record 0, and
+ *  the children of a stem are stored in consecutive records, so a stem only needs to record where
+ *  its first child is and how many children it has.
+ *
+ *  Snapshot files are memory mapped, not read.  Nothing is copied out of the mapping until a node
+ *  is actually looked at, which lets the tree DB load a tree one stem at a time, as it's accessed.
+ *
+ *  Snapshots are written through a builder.  The node records are filled in one stem at a time,
+ *  and subtrees that were never loaded from an older snapshot can be copied straight across.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_TREE_SNAPSHOT_INCLUDE_GUARD
+#define CFG_TREE_SNAPSHOT_INCLUDE_GUARD
+
+
+
+/// Index of the root node record in every snapshot.
+#define SNAP_ROOT_INDEX 0
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Reference to a memory mapped snapshot.  These are reference counted, and the file is unmapped
+ *  once the last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct snap_Snapshot* snap_Ref_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Reference to a snapshot builder.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct snap_Builder* snap_BuilderRef_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the snapshot subsystem and the memory pools it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Map a snapshot file into memory.
+ *
+ *  The descriptor may be closed once this returns, the mapping does not depend on it.
+ *
+ *  @return LE_OK if the file was mapped.
+ *          LE_UNSUPPORTED if the file isn't a snapshot, (it may be in the text format.)
+ *          LE_FORMAT_ERROR if the file is a snapshot, but it's truncated or corrupt.
+ *          LE_FAULT if the file couldn't be mapped.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t snap_Open
+(
+    int descriptor,         ///< [IN] The file to map.
+    snap_Ref_t* snapRefPtr  ///< [OUT] The mapped snapshot, if LE_OK is returned.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a reference to a snapshot.
+ *
+ *  @return The same snapshot, for convenience.
+ */
+//--------------------------------------------------------------------------------------------------
+snap_Ref_t snap_AddRef
+(
+    snap_Ref_t snapRef  ///< [IN] The snapshot.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_Release
+(
+    snap_Ref_t snapRef  ///< [IN] The snapshot.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the type of a node in a snapshot.  A stem without any children is reported as empty.
+ *
+ *  @return The node's type.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_nodeType_t snap_GetType
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the name of a node in a snapshot.
+ *
+ *  @return The name, it stays valid as long as the caller holds a reference to the snapshot.  The
+ *          root node's name is the empty string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* snap_GetName
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the value of a node in a snapshot, as a string.
+ *
+ *  @return The value, it stays valid as long as the caller holds a reference to the snapshot.
+ *          Stems and empty nodes have the empty string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* snap_GetValue
+(
+    snap_Ref_t snapRef,  ///< [IN] The snapshot.
+    uint32_t index       ///< [IN] The node's record.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the children of a stem node in a snapshot.  Their records are firstIndex to
+ *  firstIndex + count - 1.
+ *
+ *  @return The number of children, (0 if the node isn't a stem.)
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t snap_GetChildren
+(
+    snap_Ref_t snapRef,     ///< [IN] The snapshot.
+    uint32_t index,         ///< [IN] The node's record.
+    uint32_t* firstIdxPtr   ///< [OUT] The record of the first child.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start building a new snapshot.  The new snapshot has an empty root node.
+ *
+ *  @return The new builder.
+ */
+//--------------------------------------------------------------------------------------------------
+snap_BuilderRef_t snap_CreateBuilder
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Throw away a builder, and anything it has built.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_DeleteBuilder
+(
+    snap_BuilderRef_t builderRef  ///< [IN] The builder.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Fill in a node record with a value.  Stems are filled in with snap_AddChildren() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_SetValue
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    le_cfg_nodeType_t type,        ///< [IN] The node's type.
+    const char* valuePtr           ///< [IN] The node's value, may be NULL for empty nodes.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Turn a node record into a stem and allocate the records for its children.  The children are
+ *  left empty, and have to be filled in by the caller.
+ *
+ *  @return The record of the first child.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t snap_AddChildren
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    uint32_t count                 ///< [IN] The number of children.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Fill in a node record, and everything under it, from a node in another snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void snap_CopyNode
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    uint32_t index,                ///< [IN] The node's record.
+    const char* namePtr,           ///< [IN] The node's name, NULL for the root.
+    snap_Ref_t srcSnapRef,         ///< [IN] The snapshot to copy from.
+    uint32_t srcIndex              ///< [IN] The record to copy.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a built snapshot to a file.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t snap_Write
+(
+    snap_BuilderRef_t builderRef,  ///< [IN] The builder.
+    int descriptor                 ///< [IN] The file to write to.
+);
+
+
+
+
+#endif
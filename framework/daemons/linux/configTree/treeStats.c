@@ -0,0 +1,713 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeStats.c
+ *
+ *  The counters are kept in two maps, one keyed by tree name and one keyed by user name.  An entry
+ *  is made the first time a tree or a user is counted, and is kept for as long as the config tree
+ *  runs, so that the counters of a tree that's been deleted, or of a user that's disconnected, can
+ *  still be reported.  Everything here runs on the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "interfaces.h"
+#include "treePath.h"
+#include "treeDb.h"
+#include "treeUser.h"
+#include "treeStats.h"
+
+
+
+
+/// Upper bounds, in microseconds, of the commit time histogram's buckets.  Commits that take longer
+/// than the last bound go in one more bucket.
+static const uint64_t LatencyBounds[] = { 100, 1000, 10000, 100000, 1000000 };
+
+/// Names of the histogram's buckets, as used in the reports.
+static const char* LatencyNames[] = { "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s" };
+
+/// Number of buckets in the commit time histogram.
+#define LATENCY_BUCKET_COUNT (NUM_ARRAY_MEMBERS(LatencyBounds) + 1)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The counters of a tree, or of a user.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_USER_NAME_BYTES];    ///< The tree or user name, the key in its map.
+
+    uint64_t quickGets;                      ///< Quick reads.
+    uint64_t quickSets;                      ///< Quick writes.
+    uint64_t readTxns;                       ///< Read transactions.
+    uint64_t writeTxns;                      ///< Write transactions.
+
+    uint64_t commits;                        ///< Commits, both of transactions and quick writes.
+    uint64_t commitUs;                       ///< Total time taken by the commits.
+    uint64_t maxCommitUs;                    ///< Time taken by the slowest commit.
+    uint64_t latency[LATENCY_BUCKET_COUNT];  ///< Commit time histogram.
+
+    uint64_t bytesWritten;                   ///< Bytes written to the tree's files, trees only.
+
+    size_t queued;                           ///< Requests on a request queue right now.
+    size_t maxQueued;                        ///< The most requests that have been queued at once.
+    uint64_t deferrals;                      ///< Requests taken off of a request queue.
+    uint64_t deferredUs;                     ///< Total time those requests spent queued.
+}
+Counters_t;
+
+
+
+
+/// Pool for the counters.
+static le_mem_PoolRef_t CountersPool = NULL;
+
+/// The counters of each tree, keyed by tree name.
+static le_hashmap_Ref_t TreeMap = NULL;
+
+/// The counters of each user, keyed by user name.
+static le_hashmap_Ref_t UserMap = NULL;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the counters for a name, making new ones if there aren't any yet.
+ *
+ *  @return The counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static Counters_t* GetCounters
+(
+    le_hashmap_Ref_t mapRef,  ///< [IN] The map to look in.
+    const char* namePtr       ///< [IN] The tree or user name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Counters_t* countersPtr = le_hashmap_Get(mapRef, namePtr);
+
+    if (countersPtr == NULL)
+    {
+        countersPtr = le_mem_ForceAlloc(CountersPool);
+        memset(countersPtr, 0, sizeof(Counters_t));
+
+        if (le_utf8_Copy(countersPtr->name, namePtr, sizeof(countersPtr->name), NULL) != LE_OK)
+        {
+            LE_WARN("Name '%s' truncated in the config tree stats.", namePtr);
+        }
+
+        le_hashmap_Put(mapRef, countersPtr->name, countersPtr);
+    }
+
+    return countersPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the counters of a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static Counters_t* GetTreeCounters
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return GetCounters(TreeMap, tdb_GetTreeName(treeRef));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the counters of a user.
+ */
+//--------------------------------------------------------------------------------------------------
+static Counters_t* GetUserCounters
+(
+    tu_UserRef_t userRef  ///< [IN] The user.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return GetCounters(UserMap, tu_GetUserName(userRef));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Convert a time span to microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ToUs
+(
+    le_clk_Time_t time  ///< [IN] The time span.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (time.sec < 0)
+    {
+        return 0;
+    }
+
+    return ((uint64_t)time.sec * 1000000) + time.usec;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a commit to a set of counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddCommit
+(
+    Counters_t* countersPtr,  ///< [IN] The counters.
+    uint64_t commitUs         ///< [IN] How long the commit took.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t bucket = 0;
+
+    while (   (bucket < NUM_ARRAY_MEMBERS(LatencyBounds))
+           && (commitUs >= LatencyBounds[bucket]))
+    {
+        bucket++;
+    }
+
+    countersPtr->commits++;
+    countersPtr->commitUs += commitUs;
+    countersPtr->latency[bucket]++;
+
+    if (commitUs > countersPtr->maxCommitUs)
+    {
+        countersPtr->maxCommitUs = commitUs;
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a newly queued request to a set of counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddQueued
+(
+    Counters_t* countersPtr  ///< [IN] The counters.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    countersPtr->queued++;
+
+    if (countersPtr->queued > countersPtr->maxQueued)
+    {
+        countersPtr->maxQueued = countersPtr->queued;
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Take a request off of a set of counters' queue count.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddDequeued
+(
+    Counters_t* countersPtr,  ///< [IN] The counters.
+    uint64_t waitUs           ///< [IN] How long the request was queued.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (countersPtr->queued > 0)
+    {
+        countersPtr->queued--;
+    }
+
+    countersPtr->deferrals++;
+    countersPtr->deferredUs += waitUs;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write one table of the text report, with a line for each entry of a map.
+ *
+ *  @return LE_OK if the table was written, LE_IO_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteTextTable
+(
+    int descriptor,           ///< [IN] Where to write the table.
+    le_hashmap_Ref_t mapRef,  ///< [IN] The counters to write.
+    const char* titlePtr      ///< [IN] Title of the name column.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isTree = (mapRef == TreeMap);
+
+    if (dprintf(descriptor,
+                "%-24s %10s %10s %10s %10s %13s %7s %7s %10s %12s\n",
+                titlePtr,
+                "QUICK GETS",
+                "QUICK SETS",
+                "READ TXNS",
+                "WRITE TXNS",
+                isTree ? "BYTES WRITTEN" : "",
+                "QUEUED",
+                "MAX Q",
+                "DEFERRALS",
+                "DEFERRED(ms)") < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(mapRef);
+
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
+    {
+        const Counters_t* countersPtr = le_hashmap_GetValue(iterRef);
+        char bytesStr[24] = "";
+
+        if (isTree)
+        {
+            snprintf(bytesStr, sizeof(bytesStr), "%" PRIu64, countersPtr->bytesWritten);
+        }
+
+        if (dprintf(descriptor,
+                    "%-24s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %13s %7zu %7zu "
+                    "%10" PRIu64 " %8" PRIu64 ".%03" PRIu64 "\n",
+                    countersPtr->name,
+                    countersPtr->quickGets,
+                    countersPtr->quickSets,
+                    countersPtr->readTxns,
+                    countersPtr->writeTxns,
+                    bytesStr,
+                    countersPtr->queued,
+                    countersPtr->maxQueued,
+                    countersPtr->deferrals,
+                    countersPtr->deferredUs / 1000,
+                    countersPtr->deferredUs % 1000) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    // The commit time histogram goes in a second table, as it doesn't fit on the same line.
+    if (dprintf(descriptor, "\n%-24s %10s", titlePtr, "COMMITS") < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+    {
+        if (dprintf(descriptor, " %8s", LatencyNames[i]) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    if (dprintf(descriptor, " %10s %10s\n", "AVG(ms)", "MAX(ms)") < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    iterRef = le_hashmap_GetIterator(mapRef);
+
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
+    {
+        const Counters_t* countersPtr = le_hashmap_GetValue(iterRef);
+        uint64_t avgUs = (countersPtr->commits == 0) ? 0
+                                                     : countersPtr->commitUs / countersPtr->commits;
+
+        if (dprintf(descriptor, "%-24s %10" PRIu64, countersPtr->name, countersPtr->commits) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+
+        for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+        {
+            if (dprintf(descriptor, " %8" PRIu64, countersPtr->latency[i]) < 0)
+            {
+                return LE_IO_ERROR;
+            }
+        }
+
+        if (dprintf(descriptor,
+                    " %6" PRIu64 ".%03" PRIu64 " %6" PRIu64 ".%03" PRIu64 "\n",
+                    avgUs / 1000,
+                    avgUs % 1000,
+                    countersPtr->maxCommitUs / 1000,
+                    countersPtr->maxCommitUs % 1000) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the entries of a map as a JSON array.
+ *
+ *  @return LE_OK if the array was written, LE_IO_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteJsonArray
+(
+    int descriptor,          ///< [IN] Where to write the array.
+    le_hashmap_Ref_t mapRef  ///< [IN] The counters to write.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isFirst = true;
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(mapRef);
+
+    if (dprintf(descriptor, "[") < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
+    {
+        const Counters_t* countersPtr = le_hashmap_GetValue(iterRef);
+
+        if (dprintf(descriptor,
+                    "%s{\"name\":\"%s\",\"quickGets\":%" PRIu64 ",\"quickSets\":%" PRIu64 ","
+                    "\"readTxns\":%" PRIu64 ",\"writeTxns\":%" PRIu64 ",\"commits\":%" PRIu64 ","
+                    "\"commitUs\":%" PRIu64 ",\"maxCommitUs\":%" PRIu64 ",\"commitLatency\":[",
+                    isFirst ? "" : ",",
+                    countersPtr->name,
+                    countersPtr->quickGets,
+                    countersPtr->quickSets,
+                    countersPtr->readTxns,
+                    countersPtr->writeTxns,
+                    countersPtr->commits,
+                    countersPtr->commitUs,
+                    countersPtr->maxCommitUs) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+
+        for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+        {
+            if (dprintf(descriptor,
+                        "%s{\"bucket\":\"%s\",\"count\":%" PRIu64 "}",
+                        (i == 0) ? "" : ",",
+                        LatencyNames[i],
+                        countersPtr->latency[i]) < 0)
+            {
+                return LE_IO_ERROR;
+            }
+        }
+
+        if (dprintf(descriptor, "]") < 0)
+        {
+            return LE_IO_ERROR;
+        }
+
+        // Only the trees' files are written, so only the trees count bytes.
+        if (   (mapRef == TreeMap)
+            && (dprintf(descriptor, ",\"bytesWritten\":%" PRIu64, countersPtr->bytesWritten) < 0))
+        {
+            return LE_IO_ERROR;
+        }
+
+        if (dprintf(descriptor,
+                    ",\"queued\":%zu,\"maxQueued\":%zu,\"deferrals\":%" PRIu64 ","
+                    "\"deferredUs\":%" PRIu64 "}",
+                    countersPtr->queued,
+                    countersPtr->maxQueued,
+                    countersPtr->deferrals,
+                    countersPtr->deferredUs) < 0)
+        {
+            return LE_IO_ERROR;
+        }
+
+        isFirst = false;
+    }
+
+    if (dprintf(descriptor, "]") < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the tree stats subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Tree Stats subsystem.");
+
+    CountersPool = le_mem_CreatePool("treeStatsPool", sizeof(Counters_t));
+    TreeMap = le_hashmap_Create("treeStatsTreeMap",
+                                31,
+                                le_hashmap_HashString,
+                                le_hashmap_EqualsString);
+    UserMap = le_hashmap_Create("treeStatsUserMap",
+                                31,
+                                le_hashmap_HashString,
+                                le_hashmap_EqualsString);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a quick read, (including the bulk reads,) made by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQuickGet
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the read.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that was read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    GetTreeCounters(treeRef)->quickGets++;
+    GetUserCounters(userRef)->quickGets++;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a quick write, (including deletes and bulk writes,) made by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQuickSet
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the write.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that was written.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    GetTreeCounters(treeRef)->quickSets++;
+    GetUserCounters(userRef)->quickSets++;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a transaction requested by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountTxn
+(
+    tu_UserRef_t userRef,   ///< [IN] The user that asked for the transaction.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree the transaction is on.
+    bool isWrite            ///< [IN] True for a write transaction, false for a read transaction.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (isWrite)
+    {
+        GetTreeCounters(treeRef)->writeTxns++;
+        GetUserCounters(userRef)->writeTxns++;
+    }
+    else
+    {
+        GetTreeCounters(treeRef)->readTxns++;
+        GetUserCounters(userRef)->readTxns++;
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a commit, (of a write transaction or of a quick write,) and how long it took to merge it
+ *  into the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountCommit
+(
+    tu_UserRef_t userRef,     ///< [IN] The user that made the commit.
+    tdb_TreeRef_t treeRef,    ///< [IN] The tree that was committed to.
+    le_clk_Time_t commitTime  ///< [IN] How long the commit took.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t commitUs = ToUs(commitTime);
+
+    AddCommit(GetTreeCounters(treeRef), commitUs);
+    AddCommit(GetUserCounters(userRef), commitUs);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count the bytes written to a tree's files.  The tree is given by name, as it may have been
+ *  deleted since the write was queued.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountBytesWritten
+(
+    const char* treeNamePtr,  ///< [IN] The tree that was written.
+    size_t byteCount          ///< [IN] How many bytes were written.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    GetCounters(TreeMap, treeNamePtr)->bytesWritten += byteCount;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a request that had to be put on a tree's request queue.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQueued
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the request.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree whose queue the request is on.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    AddQueued(GetTreeCounters(treeRef));
+    AddQueued(GetUserCounters(userRef));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a request being taken back off of a tree's request queue, and how long it waited there.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountDequeued
+(
+    tu_UserRef_t userRef,   ///< [IN] The user that made the request.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree whose queue the request was on.
+    le_clk_Time_t waitTime  ///< [IN] How long the request was on the queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t waitUs = ToUs(waitTime);
+
+    AddDequeued(GetTreeCounters(treeRef), waitUs);
+    AddDequeued(GetUserCounters(userRef), waitUs);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Set all of the counters back to zero.  The requests that are still queued stay counted.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_Reset
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_hashmap_Ref_t maps[] = { TreeMap, UserMap };
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(maps); i++)
+    {
+        le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(maps[i]);
+
+        while (le_hashmap_NextNode(iterRef) == LE_OK)
+        {
+            Counters_t* countersPtr = le_hashmap_GetValue(iterRef);
+            size_t queued = countersPtr->queued;
+
+            memset(&countersPtr->quickGets,
+                   0,
+                   sizeof(Counters_t) - offsetof(Counters_t, quickGets));
+
+            countersPtr->queued = queued;
+            countersPtr->maxQueued = queued;
+        }
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a report of all of the counters to a file descriptor, either as text tables or as JSON.
+ *
+ *  @return LE_OK if the report was written, LE_IO_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ts_WriteReport
+(
+    int descriptor,  ///< [IN] Where to write the report.
+    bool asJson      ///< [IN] Write the report as JSON rather than as text.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (asJson)
+    {
+        if (   (dprintf(descriptor, "{\"trees\":") < 0)
+            || (WriteJsonArray(descriptor, TreeMap) != LE_OK)
+            || (dprintf(descriptor, ",\"clients\":") < 0)
+            || (WriteJsonArray(descriptor, UserMap) != LE_OK)
+            || (dprintf(descriptor, "}\n") < 0))
+        {
+            return LE_IO_ERROR;
+        }
+
+        return LE_OK;
+    }
+
+    if (   (WriteTextTable(descriptor, TreeMap, "TREE") != LE_OK)
+        || (dprintf(descriptor, "\n") < 0)
+        || (WriteTextTable(descriptor, UserMap, "CLIENT") != LE_OK))
+    {
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
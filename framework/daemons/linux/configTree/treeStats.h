@@ -0,0 +1,171 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeStats.h
+ *
+ *  Performance counters for the config tree.  Every quick read and write, every transaction and
+ *  every commit is counted twice, once against the tree it was made on, and once against the user
+ *  that made it.  Commit times are kept as a histogram, and the requests that had to wait in a
+ *  tree's request queue are counted along with the time they spent waiting.  The trees also count
+ *  the bytes written to their files, and how deep their request queues got.
+ *
+ *  The counters are reported through the config admin API, (see le_cfgAdmin_DumpStats,) so they
+ *  can be read with "config stats" or "inspect config".
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_TREE_STATS_INCLUDE_GUARD
+#define CFG_TREE_STATS_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the tree stats subsystem.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a quick read, (including the bulk reads,) made by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQuickGet
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the read.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that was read.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a quick write, (including deletes and bulk writes,) made by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQuickSet
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the write.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that was written.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a transaction requested by a user on a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountTxn
+(
+    tu_UserRef_t userRef,   ///< [IN] The user that asked for the transaction.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree the transaction is on.
+    bool isWrite            ///< [IN] True for a write transaction, false for a read transaction.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a commit, (of a write transaction or of a quick write,) and how long it took to merge it
+ *  into the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountCommit
+(
+    tu_UserRef_t userRef,     ///< [IN] The user that made the commit.
+    tdb_TreeRef_t treeRef,    ///< [IN] The tree that was committed to.
+    le_clk_Time_t commitTime  ///< [IN] How long the commit took.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count the bytes written to a tree's files.  The tree is given by name, as it may have been
+ *  deleted since the write was queued.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountBytesWritten
+(
+    const char* treeNamePtr,  ///< [IN] The tree that was written.
+    size_t byteCount          ///< [IN] How many bytes were written.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a request that had to be put on a tree's request queue.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountQueued
+(
+    tu_UserRef_t userRef,  ///< [IN] The user that made the request.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree whose queue the request is on.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Count a request being taken back off of a tree's request queue, and how long it waited there.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_CountDequeued
+(
+    tu_UserRef_t userRef,   ///< [IN] The user that made the request.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree whose queue the request was on.
+    le_clk_Time_t waitTime  ///< [IN] How long the request was on the queue.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Set all of the counters back to zero.  The requests that are still queued stay counted.
+ */
+//--------------------------------------------------------------------------------------------------
+void ts_Reset
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a report of all of the counters to a file descriptor, either as text tables or as JSON.
+ *
+ *  @return LE_OK if the report was written, LE_IO_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ts_WriteReport
+(
+    int descriptor,  ///< [IN] Where to write the report.
+    bool asJson      ///< [IN] Write the report as JSON rather than as text.
+);
+
+
+
+
+#endif
@@ -0,0 +1,443 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeWriter.c
+ *
+ *  The writer threads, and the per tree write queues they work from.
+ *
+ *  Every tree that has been written to has a queue.  A queue is on the ready list while it has
+ *  writes waiting and none of its writes are being done, and the writer threads take their work
+ *  from the front of the ready list.  Taking a queue's first write takes the queue off of the ready
+ *  list, and it only goes back on once that write is done, which is what keeps a tree's writes in
+ *  order.  All of this is protected by one mutex; the writes themselves are done outside of it.
+ *
+ *  Writes that are done go on the done list, and the main thread is asked to call their done
+ *  functions.  The queues themselves are only ever created on the main thread, and are never freed.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "interfaces.h"
+#include "treePath.h"
+#include "treeWriter.h"
+
+
+
+
+/// Number of writer threads, so the number of trees that can be written at the same time.
+#define WRITER_THREAD_COUNT 2
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The write queue of a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char treeName[MAX_TREE_NAME_BYTES];  ///< The tree the queue is for, the key in the QueueMap.
+    le_sls_List_t jobList;               ///< Writes waiting to be done.
+    bool isBusy;                         ///< Is one of the queue's writes being done right now?
+    le_sls_Link_t readyLink;             ///< Link in the ReadyList.
+}
+Queue_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A queued write.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    tw_WorkFunc_t workFunc;  ///< Does the write.
+    tw_DoneFunc_t doneFunc;  ///< Called once the write is done.
+    void* contextPtr;        ///< Given to both functions.
+    le_result_t result;      ///< What the work function returned.
+    le_sls_Link_t link;      ///< Link in the job list of the queue, then in the DoneList.
+}
+Job_t;
+
+
+
+
+/// Pools for the queues and the writes.
+static le_mem_PoolRef_t QueuePool = NULL;
+static le_mem_PoolRef_t JobPool = NULL;
+
+/// The queues, keyed by tree name.  Only used on the main thread.
+static le_hashmap_Ref_t QueueMap = NULL;
+
+/// Protects everything below it.
+static le_mutex_Ref_t Mutex = NULL;
+
+/// Queues with writes that are ready to be done.
+static le_sls_List_t ReadyList = LE_SLS_LIST_INIT;
+
+/// Counts the queues on the ReadyList, the writer threads wait on it for work.
+static le_sem_Ref_t ReadySem = NULL;
+
+/// Writes that are done, waiting for their done functions to be called.
+static le_sls_List_t DoneList = LE_SLS_LIST_INIT;
+
+/// Has the main thread already been asked to go through the DoneList?
+static bool IsDoneQueued = false;
+
+/// Is the main thread waiting for a write to be done?
+static bool IsFlushWaiting = false;
+
+/// Posted when a write is done while the main thread is waiting.
+static le_sem_Ref_t FlushSem = NULL;
+
+/// The main thread, where the done functions are called.
+static le_thread_Ref_t MainThread = NULL;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Put a queue on the ready list, if it has writes waiting and isn't busy.  Must be called with the
+ *  mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateReady
+(
+    Queue_t* queuePtr  ///< [IN] The queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   (queuePtr->isBusy == false)
+        && (le_sls_IsEmpty(&queuePtr->jobList) == false))
+    {
+        le_sls_Queue(&ReadyList, &queuePtr->readyLink);
+        le_sem_Post(ReadySem);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check if all of a queue's writes are done.  Must be called with the mutex locked.
+ *
+ *  @return True if the queue is idle, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsIdle
+(
+    Queue_t* queuePtr  ///< [IN] The queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (queuePtr->isBusy == false) && le_sls_IsEmpty(&queuePtr->jobList);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Call the done functions of the writes that are done, on the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallDoneFunctions
+(
+    void* param1Ptr,  ///< [IN] Not used.
+    void* param2Ptr   ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mutex_Lock(Mutex);
+
+    le_sls_List_t doneList = DoneList;
+    DoneList = LE_SLS_LIST_INIT;
+    IsDoneQueued = false;
+
+    le_mutex_Unlock(Mutex);
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&doneList)) != NULL)
+    {
+        Job_t* jobPtr = CONTAINER_OF(linkPtr, Job_t, link);
+
+        jobPtr->doneFunc(jobPtr->result, jobPtr->contextPtr);
+        le_mem_Release(jobPtr);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The main function of the writer threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr  ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (;;)
+    {
+        le_sem_Wait(ReadySem);
+
+        le_mutex_Lock(Mutex);
+
+        Queue_t* queuePtr = CONTAINER_OF(le_sls_Pop(&ReadyList), Queue_t, readyLink);
+        Job_t* jobPtr = CONTAINER_OF(le_sls_Pop(&queuePtr->jobList), Job_t, link);
+
+        queuePtr->isBusy = true;
+
+        le_mutex_Unlock(Mutex);
+
+        jobPtr->result = jobPtr->workFunc(jobPtr->contextPtr);
+
+        le_mutex_Lock(Mutex);
+
+        queuePtr->isBusy = false;
+        UpdateReady(queuePtr);
+
+        le_sls_Queue(&DoneList, &jobPtr->link);
+
+        bool callMain = (IsDoneQueued == false);
+        IsDoneQueued = true;
+
+        if (IsFlushWaiting)
+        {
+            IsFlushWaiting = false;
+            le_sem_Post(FlushSem);
+        }
+
+        le_mutex_Unlock(Mutex);
+
+        if (callMain)
+        {
+            le_event_QueueFunctionToThread(MainThread, CallDoneFunctions, NULL, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Wait for all of a queue's writes to be done, and call their done functions.  The done functions
+ *  may queue more writes, so this goes on until there are none left.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushQueue
+(
+    Queue_t* queuePtr  ///< [IN] The queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (;;)
+    {
+        le_mutex_Lock(Mutex);
+
+        bool isIdle = IsIdle(queuePtr);
+
+        if (isIdle == false)
+        {
+            IsFlushWaiting = true;
+        }
+
+        le_mutex_Unlock(Mutex);
+
+        if (isIdle)
+        {
+            // Make sure the done functions of the last writes have been called.
+            CallDoneFunctions(NULL, NULL);
+
+            le_mutex_Lock(Mutex);
+            isIdle = IsIdle(queuePtr);
+            le_mutex_Unlock(Mutex);
+
+            if (isIdle)
+            {
+                return;
+            }
+        }
+        else
+        {
+            le_sem_Wait(FlushSem);
+        }
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the tree writer subsystem, and start its threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Tree Writer subsystem.");
+
+    QueuePool = le_mem_CreatePool("treeWriteQueuePool", sizeof(Queue_t));
+    JobPool = le_mem_CreatePool("treeWriteJobPool", sizeof(Job_t));
+    QueueMap = le_hashmap_Create("treeWriteQueueMap",
+                                 31,
+                                 le_hashmap_HashString,
+                                 le_hashmap_EqualsString);
+
+    Mutex = le_mutex_CreateNonRecursive("treeWriterMutex");
+    ReadySem = le_sem_Create("treeWriterReadySem", 0);
+    FlushSem = le_sem_Create("treeWriterFlushSem", 0);
+
+    MainThread = le_thread_GetCurrent();
+
+    for (int i = 0; i < WRITER_THREAD_COUNT; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "treeWriter%d", i + 1);
+        le_thread_Start(le_thread_Create(name, WriterThread, NULL));
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Queue a write for a tree.  It is done after all of the writes already queued for the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Queue
+(
+    const char* treeNamePtr,  ///< [IN] The tree the write is for.
+    tw_WorkFunc_t workFunc,   ///< [IN] Does the write, on a writer thread.
+    tw_DoneFunc_t doneFunc,   ///< [IN] Called on the main thread once the write is done.
+    void* contextPtr          ///< [IN] Given to both functions.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Queue_t* queuePtr = le_hashmap_Get(QueueMap, treeNamePtr);
+
+    if (queuePtr == NULL)
+    {
+        queuePtr = le_mem_ForceAlloc(QueuePool);
+
+        LE_ASSERT(le_utf8_Copy(queuePtr->treeName,
+                               treeNamePtr,
+                               sizeof(queuePtr->treeName),
+                               NULL) == LE_OK);
+        queuePtr->jobList = LE_SLS_LIST_INIT;
+        queuePtr->isBusy = false;
+        queuePtr->readyLink = LE_SLS_LINK_INIT;
+
+        le_hashmap_Put(QueueMap, queuePtr->treeName, queuePtr);
+    }
+
+    Job_t* jobPtr = le_mem_ForceAlloc(JobPool);
+
+    jobPtr->workFunc = workFunc;
+    jobPtr->doneFunc = doneFunc;
+    jobPtr->contextPtr = contextPtr;
+    jobPtr->result = LE_OK;
+    jobPtr->link = LE_SLS_LINK_INIT;
+
+    le_mutex_Lock(Mutex);
+
+    bool wasEmpty = le_sls_IsEmpty(&queuePtr->jobList);
+    le_sls_Queue(&queuePtr->jobList, &jobPtr->link);
+
+    if (wasEmpty)
+    {
+        UpdateReady(queuePtr);
+    }
+
+    le_mutex_Unlock(Mutex);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Wait for all of the writes queued for a tree to be done, and call their done functions.  This
+ *  blocks the main thread, so it's only used when the tree's files are about to be read.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Flush
+(
+    const char* treeNamePtr  ///< [IN] The tree to wait for.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Queue_t* queuePtr = le_hashmap_Get(QueueMap, treeNamePtr);
+
+    if (queuePtr != NULL)
+    {
+        FlushQueue(queuePtr);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Wait for all of the writes queued for every tree to be done.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_FlushAll
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // A done function can queue a write for any tree, so whenever a queue has to be waited for the
+    // search starts over.
+    bool isAllIdle;
+
+    do
+    {
+        isAllIdle = true;
+
+        le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(QueueMap);
+
+        while (le_hashmap_NextNode(iterRef) == LE_OK)
+        {
+            Queue_t* queuePtr = le_hashmap_GetValue(iterRef);
+
+            le_mutex_Lock(Mutex);
+            bool isIdle = IsIdle(queuePtr);
+            le_mutex_Unlock(Mutex);
+
+            if (isIdle == false)
+            {
+                FlushQueue(queuePtr);
+                isAllIdle = false;
+                break;
+            }
+        }
+    }
+    while (isAllIdle == false);
+
+    CallDoneFunctions(NULL, NULL);
+}
@@ -0,0 +1,114 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file treeWriter.h
+ *
+ *  Background writing of configuration tree files.
+ *
+ *  Commits are merged into the in-memory trees on the main thread, but the snapshot and journal
+ *  files that make them stick are written by a small pool of writer threads, so that a slow flash
+ *  write holds up neither the other trees, nor the quick reads and writes that don't touch the
+ *  filesystem.
+ *
+ *  Each tree has its own queue of writes, and a tree's writes are done one at a time, in the order
+ *  they were queued.  The writes of different trees are done at the same time, on different
+ *  threads.  The work function of a write runs on a writer thread, and must only use the data it is
+ *  given; once it's done, the write's done function is called back on the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_TREE_WRITER_INCLUDE_GUARD
+#define CFG_TREE_WRITER_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Prototype for the functions that do the work of a write, on a writer thread.
+ *
+ *  @return The result of the write, passed on to the done function.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_result_t (*tw_WorkFunc_t)
+(
+    void* contextPtr  ///< [IN] The context given to tw_Queue().
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Prototype for the functions called back on the main thread once a write has been done.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*tw_DoneFunc_t)
+(
+    le_result_t result,  ///< [IN] What the work function returned.
+    void* contextPtr     ///< [IN] The context given to tw_Queue().
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the tree writer subsystem, and start its threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Queue a write for a tree.  It is done after all of the writes already queued for the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Queue
+(
+    const char* treeNamePtr,  ///< [IN] The tree the write is for.
+    tw_WorkFunc_t workFunc,   ///< [IN] Does the write, on a writer thread.
+    tw_DoneFunc_t doneFunc,   ///< [IN] Called on the main thread once the write is done.
+    void* contextPtr          ///< [IN] Given to both functions.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Wait for all of the writes queued for a tree to be done, and call their done functions.  This
+ *  blocks the main thread, so it's only used when the tree's files are about to be read.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_Flush
+(
+    const char* treeNamePtr  ///< [IN] The tree to wait for.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Wait for all of the writes queued for every tree to be done.
+ */
+//--------------------------------------------------------------------------------------------------
+void tw_FlushAll
+(
+    void
+);
+
+
+
+
+#endif
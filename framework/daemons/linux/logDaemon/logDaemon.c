@@ -67,6 +67,9 @@
 #include "logDaemon.h"
 #include "limit.h"
 #include "fileDescriptor.h"
+#include "logRing.h"
+#include "logStore.h"
+#include <regex.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -97,6 +100,32 @@
 #define MAX_EXPECTED_TRACES 20
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of log ring dumps (see LOG_RING_DUMP_DIR) to keep.  The oldest is deleted when another
+ * one is saved.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MAX_RING_DUMPS 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval at which messages written into the log rings are passed on to syslog, in milliseconds.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define RING_DRAIN_INTERVAL_MS 100
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval at which the messages collected for the log store (see logStore.h) are compressed and
+ * written into it, in milliseconds, if they haven't filled a block first.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_FLUSH_INTERVAL_MS 5000
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hash map of Process Name objects, keyed by process name string.
@@ -127,6 +156,60 @@ static le_hashmap_Ref_t IpcSessionMapRef;
 static le_hashmap_Ref_t ProcessIdMapRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the objects that are kept on the list of another object and looked up by name in that
+ * list (see NameKeyHash()).  The key is kept inside the object itself.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void* ownerPtr;       ///< Ptr to the object whose list the named object is on.
+    const char* namePtr;        ///< Ptr to the name (inside the named object).
+}
+NameKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of Component Name objects, keyed by NameKey_t (Process Name object, component name).
+ *
+ * Value pointer points to a ComponentName_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ComponentNameMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of Trace Name objects, keyed by NameKey_t (Component Name object, keyword).
+ *
+ * Value pointer points to a TraceName_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t TraceNameMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of Log Session objects, keyed by NameKey_t (Running Process object, component name).
+ *
+ * Value pointer points to a LogSession_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t LogSessionMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of Trace objects, keyed by NameKey_t (Log Session object, keyword).
+ *
+ * Value pointer points to a Trace_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t TraceMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Component Name objects are used to store the log level setting associated with a component
@@ -139,8 +222,10 @@ static le_hashmap_Ref_t ProcessIdMapRef;
 typedef struct
 {
     le_dls_Link_t       link;                   ///< Link in the Process Name's component name list.
+    NameKey_t           key;                    ///< Key in the Component Name Map.
     char name[LIMIT_MAX_COMPONENT_NAME_BYTES];  ///< The component name.
     le_log_Level_t      level;                  ///< The log level setting.
+    char rateLimit[LOG_RATE_LIMIT_STR_BYTES];   ///< The rate limit setting ("" = default).
     le_dls_List_t       enabledTracesList;      ///< List of enabled trace keywords.
 }
 ComponentName_t;
@@ -192,6 +277,7 @@ static le_mem_PoolRef_t ProcessNamePoolRef;
 typedef struct
 {
     le_dls_Link_t   link;          ///< Used to link into Component Name's list of enabled keywords.
+    NameKey_t       key;           ///< Key in the Trace Name Map.
     char            name[LIMIT_MAX_LOG_KEYWORD_BYTES];   ///< The keyword.
 }
 TraceName_t;
@@ -223,10 +309,9 @@ typedef struct
     pid_t               pid;            ///< The process ID.
     le_msg_SessionRef_t ipcSessionRef;  ///< Reference to the IPC session connected to this process.
     le_dls_List_t       logSessionList; ///< List of log sessions in this process.
-/* TODO: Implement shared memory.
-    void*               sharedMemAddr;  ///< Address of base of memory region shared with
-                                        ///  this process.
- */
+    logRing_Ref_t       ringRef;        ///< Log ring shared with this process (or NULL).
+    int                 ringFd;         ///< Fd of the log ring, until it is sent to the process.
+    uint64_t            ringPos;        ///< Position up to which the log ring has been read.
 }
 RunningProcess_t;
 
@@ -249,8 +334,10 @@ static le_mem_PoolRef_t RunningProcessPoolRef;
 typedef struct
 {
     le_dls_Link_t       link;               ///< Link in the Running Process's log session list.
+    NameKey_t           key;                ///< Key in the Log Session Map.
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];  ///< The component name.
     le_log_Level_t      level;              ///< This session's log level.
+    char rateLimit[LOG_RATE_LIMIT_STR_BYTES];   ///< This session's rate limit ("" = default).
     le_dls_List_t       traceList;          ///< List of Trace objects for this log session.
 }
 LogSession_t;
@@ -277,6 +364,7 @@ static le_mem_PoolRef_t LogSessionPoolRef;
 typedef struct
 {
     le_dls_Link_t   link;           ///< Used to link into the Running Process's trace flag list.
+    NameKey_t       key;            ///< Key in the Trace Map.
     char            name[LIMIT_MAX_LOG_KEYWORD_BYTES];   ///< The keyword.
     bool            isEnabled;      ///< true = the keyword is enabled.
 }
@@ -327,6 +415,47 @@ FdLog_t;
 static le_mem_PoolRef_t FdLogPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log Stream objects hold the filter of a log control tool session that streams the messages read
+ * out of the log rings (see LOG_CMD_STREAM), and the state of its rate cap.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;           ///< Used to link into the Stream List.
+    le_msg_SessionRef_t ipcSessionRef;  ///< IPC session of the log control tool.
+    char                procName[LIMIT_MAX_PROCESS_NAME_BYTES];     ///< Process name, or "*".
+    pid_t               pid;            ///< PID of the process, or -1 if selected by name.
+    char                componentName[LIMIT_MAX_COMPONENT_NAME_BYTES]; ///< Component, or "*".
+    le_log_Level_t      minLevel;       ///< Least severe level streamed.
+    char                matchStr[LOG_MAX_CMD_PACKET_BYTES]; ///< Text to look for, or "".
+    bool                hasRegex;       ///< true if the lines must also match the regex.
+    regex_t             regex;          ///< Compiled regular expression.
+    uint32_t            rate;           ///< Most lines streamed per second (0 = no cap).
+    le_clk_Time_t       periodStart;    ///< Start of the current one-second period.
+    uint32_t            sentCount;      ///< Number of lines streamed in the current period.
+    size_t              droppedCount;   ///< Number of lines dropped since the last one streamed.
+}
+LogStream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Log Stream objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LogStreamPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of Log Stream objects, one per log control tool session that is streaming.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t StreamList = LE_DLS_LIST_INIT;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum length of log messages.
@@ -335,6 +464,23 @@ static le_mem_PoolRef_t FdLogPoolRef;
 #define MAX_MSG_SIZE            256
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * PIDs of the processes whose log ring dumps are being kept, oldest first starting at
+ * NextRingDumpIndex.  0 = unused slot.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t RingDumpPids[MAX_RING_DUMPS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index in RingDumpPids that the next log ring dump's PID will be stored at.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t NextRingDumpIndex;
+
+
 
 // ========================================
 //  FUNCTIONS
@@ -406,6 +552,45 @@ static bool ProcessIdEquals
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash computation function for name keys.
+ *
+ * @return  The hash value computed from a NameKey_t.
+ **/
+//--------------------------------------------------------------------------------------------------
+static size_t NameKeyHash
+(
+    const void* hashKeyPtr
+)
+{
+    const NameKey_t* keyPtr = hashKeyPtr;
+
+    return le_hashmap_HashString(keyPtr->namePtr) ^ ((size_t)keyPtr->ownerPtr >> 3);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality comparison function for name keys.
+ *
+ * @return  true = the two keys have the same owner and name.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool NameKeyEquals
+(
+    const void* hashKey1Ptr,
+    const void* hashKey2Ptr
+)
+{
+    const NameKey_t* key1Ptr = hashKey1Ptr;
+    const NameKey_t* key2Ptr = hashKey2Ptr;
+
+    return (   (key1Ptr->ownerPtr == key2Ptr->ownerPtr)
+            && (strcmp(key1Ptr->namePtr, key2Ptr->namePtr) == 0) );
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches a pointer to a constant string containing the name of a log level.
@@ -476,9 +661,11 @@ static void DeleteAllComponentNamesForProcessName
         {
             TraceName_t* traceNameObjPtr = CONTAINER_OF(traceNameLinkPtr, TraceName_t, link);
 
+            le_hashmap_Remove(TraceNameMapRef, &traceNameObjPtr->key);
             le_mem_Release(traceNameObjPtr);
         }
 
+        le_hashmap_Remove(ComponentNameMapRef, &compNameObjPtr->key);
         le_mem_Release(compNameObjPtr);
     }
 }
@@ -505,37 +692,23 @@ static void DeleteProcessName
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Search a given Process Name's list of Component Names.
+ * Find a Component Name object in a given Process Name's list of Component Names.
  *
  * @return
  *      A pointer to the Component Name object on success.
  *      NULL if the component name could not be found.
  */
 //--------------------------------------------------------------------------------------------------
-static ComponentName_t* FindComponentName
+static inline ComponentName_t* FindComponentName
 (
     const ProcessName_t* procNameObjPtr,
     const char* componentNameStr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Search for the component in the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&procNameObjPtr->componentNameList);
-
-    while (linkPtr != NULL)
-    {
-        ComponentName_t* compPtr = CONTAINER_OF(linkPtr, ComponentName_t, link);
-
-        if (strcmp(compPtr->name, componentNameStr) == 0)
-        {
-            return compPtr;
-        }
-
-        // Get the next component.
-        linkPtr = le_dls_PeekNext(&procNameObjPtr->componentNameList, linkPtr);
-    }
+    NameKey_t key = { .ownerPtr = procNameObjPtr, .namePtr = componentNameStr };
 
-    return NULL;
+    return le_hashmap_Get(ComponentNameMapRef, &key);
 }
 
 
@@ -562,11 +735,16 @@ static ComponentName_t* CreateComponentName
     }
 
     objPtr->level = -1;
+    objPtr->rateLimit[0] = '\0';
     objPtr->enabledTracesList = LE_DLS_LIST_INIT;
 
     objPtr->link = LE_DLS_LINK_INIT;
     le_dls_Queue(&procNameObjPtr->componentNameList, &objPtr->link);
 
+    objPtr->key.ownerPtr = procNameObjPtr;
+    objPtr->key.namePtr = objPtr->name;
+    le_hashmap_Put(ComponentNameMapRef, &objPtr->key, objPtr);
+
     return objPtr;
 }
 
@@ -597,6 +775,10 @@ static TraceName_t* CreateTraceName
 
     le_dls_Stack(&compNameObjPtr->enabledTracesList, &objPtr->link);
 
+    objPtr->key.ownerPtr = compNameObjPtr;
+    objPtr->key.namePtr = objPtr->name;
+    le_hashmap_Put(TraceNameMapRef, &objPtr->key, objPtr);
+
     return objPtr;
 }
 
@@ -633,37 +815,23 @@ static ProcessName_t* CreateProcessName
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Search a given Component Name's list of enabled traces.
+ * Find a Trace Name object in a given Component Name's list of enabled traces.
  *
  * @return
  *      A pointer to the Trace Name object on success.
  *      NULL if the trace name could not be found.
  */
 //--------------------------------------------------------------------------------------------------
-static TraceName_t* FindTraceName
+static inline TraceName_t* FindTraceName
 (
     const ComponentName_t* compNameObjPtr,
     const char* traceNameStr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Search for the keyword in the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&compNameObjPtr->enabledTracesList);
-
-    while (linkPtr != NULL)
-    {
-        TraceName_t* tracePtr = CONTAINER_OF(linkPtr, TraceName_t, link);
-
-        if (strcmp(tracePtr->name, traceNameStr) == 0)
-        {
-            return tracePtr;
-        }
-
-        // Get the next component.
-        linkPtr = le_dls_PeekNext(&compNameObjPtr->enabledTracesList, linkPtr);
-    }
+    NameKey_t key = { .ownerPtr = compNameObjPtr, .namePtr = traceNameStr };
 
-    return NULL;
+    return le_hashmap_Get(TraceNameMapRef, &key);
 }
 
 
@@ -730,7 +898,12 @@ static RunningProcess_t* CreateRunningProcess
 
     objPtr->pid = pid;
     objPtr->ipcSessionRef = ipcSessionRef;
-//    objPtr->sharedMemAddr = NULL;   // TODO: Implement shared memory.
+
+    // Create the process's log ring.  It's sent to the process in the response to its
+    // registration.  If this fails, the process just keeps on logging straight to syslog.
+    objPtr->ringFd = -1;
+    objPtr->ringPos = 0;
+    objPtr->ringRef = logRing_Create(LOG_RING_SIZE, pid, &objPtr->ringFd);
 
     le_hashmap_Put(ProcessIdMapRef, &objPtr->pid, objPtr);
     le_hashmap_Put(IpcSessionMapRef, &objPtr->ipcSessionRef, objPtr);
@@ -741,37 +914,23 @@ static RunningProcess_t* CreateRunningProcess
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Search a given Running Process's list of log sessions.
+ * Find a Log Session object in a given Running Process's list of log sessions.
  *
  * @return
  *      A pointer to the Log Session object on success.
  *      NULL if the component name could not be found.
  */
 //--------------------------------------------------------------------------------------------------
-static LogSession_t* FindLogSession
+static inline LogSession_t* FindLogSession
 (
     const RunningProcess_t* procPtr,
     const char* componentNameStr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Search for the keyword in the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&procPtr->logSessionList);
-
-    while (linkPtr != NULL)
-    {
-        LogSession_t* sessionPtr = CONTAINER_OF(linkPtr, LogSession_t, link);
-
-        if (strcmp(sessionPtr->componentName, componentNameStr) == 0)
-        {
-            return sessionPtr;
-        }
-
-        // Get the next component.
-        linkPtr = le_dls_PeekNext(&procPtr->logSessionList, linkPtr);
-    }
+    NameKey_t key = { .ownerPtr = procPtr, .namePtr = componentNameStr };
 
-    return NULL;
+    return le_hashmap_Get(LogSessionMapRef, &key);
 }
 
 
@@ -802,48 +961,40 @@ static LogSession_t* CreateLogSession
     }
 
     objPtr->level = -1;     // Indicates unknown state.
+    objPtr->rateLimit[0] = '\0';
     objPtr->traceList = LE_DLS_LIST_INIT;
     // TODO: implement shared memory.
 
     objPtr->link = LE_DLS_LINK_INIT;
     le_dls_Queue(&runningProcPtr->logSessionList, &objPtr->link);
 
+    objPtr->key.ownerPtr = runningProcPtr;
+    objPtr->key.namePtr = objPtr->componentName;
+    le_hashmap_Put(LogSessionMapRef, &objPtr->key, objPtr);
+
     return objPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Search a given Log Session's list of Traces.
+ * Find a Trace object in a given Log Session's list of Traces.
  *
  * @return
  *      A pointer to the Trace object on success.
  *      NULL if the trace keyword could not be found.
  */
 //--------------------------------------------------------------------------------------------------
-static Trace_t* FindTrace
+static inline Trace_t* FindTrace
 (
     const LogSession_t* logSessionPtr,
     const char* keywordStr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Search for the keyword in the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&logSessionPtr->traceList);
-
-    while (linkPtr != NULL)
-    {
-        Trace_t* traceObjPtr = CONTAINER_OF(linkPtr, Trace_t, link);
-
-        if (strcmp(traceObjPtr->name, keywordStr) == 0)
-        {
-            return traceObjPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&logSessionPtr->traceList, linkPtr);
-    }
+    NameKey_t key = { .ownerPtr = logSessionPtr, .namePtr = keywordStr };
 
-    return NULL;
+    return le_hashmap_Get(TraceMapRef, &key);
 }
 
 
@@ -879,6 +1030,10 @@ static Trace_t* CreateTrace
 
     le_dls_Stack(&logSessionPtr->traceList, &objPtr->link);
 
+    objPtr->key.ownerPtr = logSessionPtr;
+    objPtr->key.namePtr = objPtr->name;
+    le_hashmap_Put(TraceMapRef, &objPtr->key, objPtr);
+
     return objPtr;
 }
 
@@ -1099,73 +1254,170 @@ static void SendToLogTool
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sends a client an update to its log session settings.
+ * A batch of commands for a client.  The commands are packed into as few messages as possible,
+ * separated by LOG_CMD_SEPARATOR characters.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    RunningProcess_t*   runningProcObjPtr;  ///< The process that the commands are for.
+    le_msg_MessageRef_t msgRef;             ///< Message being filled in, or NULL if none yet.
+    size_t              length;             ///< Number of bytes of commands in the message.
+}
+CmdBatch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of commands for a client.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void StartCmdBatch
+(
+    CmdBatch_t* batchPtr,
+    RunningProcess_t* runningProcObjPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    batchPtr->runningProcObjPtr = runningProcObjPtr;
+    batchPtr->msgRef = NULL;
+    batchPtr->length = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the commands that have been added to a batch so far.  The batch can then be reused.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SendCmdBatch
+(
+    CmdBatch_t* batchPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (batchPtr->msgRef != NULL)
+    {
+        // Only send the commands and their terminator, not the whole payload buffer.
+        le_msg_SetPayloadSize(batchPtr->msgRef, batchPtr->length + 1);
+        le_msg_Send(batchPtr->msgRef);
+
+        batchPtr->msgRef = NULL;
+        batchPtr->length = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a command for one of a client's log sessions (or for all of them, if the component name is
+ * "*") to a batch.  If the current message is full, it is sent and a new one is started.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AddToCmdBatch
+(
+    CmdBatch_t* batchPtr,
+    char commandChar,
+    const char* componentName,
+    const char* commandDataPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RunningProcess_t* runningProcObjPtr = batchPtr->runningProcObjPtr;
+    char command[LOG_MAX_CMD_PACKET_BYTES];
+
+    size_t byteCount = snprintf(command,
+                                sizeof(command),
+                                "%c%s/%s",
+                                commandChar,
+                                componentName,
+                                commandDataPtr);
+
+    if (byteCount >= sizeof(command))
+    {
+        LE_CRIT("Message too long (%zu bytes) to send to component '%s' in process '%s' (pid %d).",
+                byteCount,
+                componentName,
+                runningProcObjPtr->procNameObjPtr->name,
+                runningProcObjPtr->pid);
+        return;
+    }
+
+    // If the command (with its separator and the terminator) doesn't fit in the rest of the
+    // current message, send that first.
+    if (   (batchPtr->msgRef != NULL)
+        && (batchPtr->length + 1 + byteCount >= le_msg_GetMaxPayloadSize(batchPtr->msgRef)) )
+    {
+        SendCmdBatch(batchPtr);
+    }
+
+    if (batchPtr->msgRef == NULL)
+    {
+        batchPtr->msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
+        le_msg_SetPayloadSize(batchPtr->msgRef, 0);
+    }
+
+    char* payloadPtr = le_msg_GetPayloadPtr(batchPtr->msgRef);
+
+    if (batchPtr->length != 0)
+    {
+        payloadPtr[batchPtr->length++] = LOG_CMD_SEPARATOR;
+    }
+
+    memcpy(payloadPtr + batchPtr->length, command, byteCount + 1);
+    batchPtr->length += byteCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds updates to a client's log session settings to a batch.
  **/
 //--------------------------------------------------------------------------------------------------
 static void UpdateClientSessionSettings
 (
-    RunningProcess_t* runningProcObjPtr,
+    CmdBatch_t* batchPtr,
     LogSession_t* logSessionPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_msg_MessageRef_t msgRef;
-    char* payloadPtr;
-    size_t maxSize;
-    size_t byteCount;
-
     // First send the level update, if it's not -1 (default).
     if (logSessionPtr->level != (le_log_Level_t)-1)
     {
-        msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
-        payloadPtr = le_msg_GetPayloadPtr(msgRef);
-        maxSize = le_msg_GetMaxPayloadSize(msgRef);
-
-        byteCount = snprintf(payloadPtr,
-                             maxSize,
-                             "%c%s/%s",
-                             LOG_CMD_SET_LEVEL,
-                             logSessionPtr->componentName,
-                             GetLevelString(logSessionPtr->level));
+        AddToCmdBatch(batchPtr,
+                      LOG_CMD_SET_LEVEL,
+                      logSessionPtr->componentName,
+                      GetLevelString(logSessionPtr->level));
+    }
 
-        if (byteCount >= maxSize)
-        {
-            LE_CRIT("Message too long (%zu bytes) to send to component '%s' in process '%s' (pid %d).",
-                    byteCount,
-                    logSessionPtr->componentName,
-                    runningProcObjPtr->procNameObjPtr->name,
-                    runningProcObjPtr->pid);
-            le_msg_ReleaseMsg(msgRef);
-        }
-        else
-        {
-            le_msg_Send(msgRef);
-        }
+    // Then the rate limit update, if it has been set.
+    if (logSessionPtr->rateLimit[0] != '\0')
+    {
+        AddToCmdBatch(batchPtr,
+                      LOG_CMD_SET_RATE_LIMIT,
+                      logSessionPtr->componentName,
+                      logSessionPtr->rateLimit);
     }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sends a client an update to one of its trace settings.
+ * Adds an update to one of a client's trace settings to a batch.
  **/
 //--------------------------------------------------------------------------------------------------
 static void UpdateClientTraceSetting
 (
-    RunningProcess_t* runningProcObjPtr,
-    LogSession_t* logSessionPtr,
-    Trace_t* traceObjPtr
+    CmdBatch_t* batchPtr,
+    const char* componentName,      ///< [IN] Component name, or "*" for all the components.
+    const char* keyword,
+    bool isEnabled
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // First send the level update.
-    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
-    char* payloadPtr = le_msg_GetPayloadPtr(msgRef);
-    size_t maxSize = le_msg_GetMaxPayloadSize(msgRef);
-
     char commandChar;
 
-    if (traceObjPtr->isEnabled)
+    if (isEnabled)
     {
         commandChar = LOG_CMD_ENABLE_TRACE;
     }
@@ -1174,26 +1426,7 @@ static void UpdateClientTraceSetting
         commandChar = LOG_CMD_DISABLE_TRACE;
     }
 
-    size_t byteCount = snprintf(payloadPtr,
-                                maxSize,
-                                "%c%s/%s",
-                                commandChar,
-                                logSessionPtr->componentName,
-                                traceObjPtr->name);
-
-    if (byteCount >= maxSize)
-    {
-        LE_CRIT("Message too long (%zu bytes) to send to component '%s' in process '%s' (pid %d).",
-                byteCount,
-                logSessionPtr->componentName,
-                runningProcObjPtr->procNameObjPtr->name,
-                runningProcObjPtr->pid);
-        le_msg_ReleaseMsg(msgRef);
-    }
-    else
-    {
-        le_msg_Send(msgRef);
-    }
+    AddToCmdBatch(batchPtr, commandChar, componentName, keyword);
 }
 
 
@@ -1209,9 +1442,17 @@ static void CopyComponentSettings
     ComponentName_t*    compNameObjPtr
 )
 {
+    CmdBatch_t batch;
+
+    StartCmdBatch(&batch, runningProcObjPtr);
+
     logSessionPtr->level = compNameObjPtr->level;
+    LE_ASSERT(le_utf8_Copy(logSessionPtr->rateLimit,
+                           compNameObjPtr->rateLimit,
+                           sizeof(logSessionPtr->rateLimit),
+                           NULL) == LE_OK);
 
-    UpdateClientSessionSettings(runningProcObjPtr, logSessionPtr);
+    UpdateClientSessionSettings(&batch, logSessionPtr);
 
     // For all enabled traces for the component name.
     le_dls_Link_t* linkPtr = le_dls_Peek(&compNameObjPtr->enabledTracesList);
@@ -1224,10 +1465,12 @@ static void CopyComponentSettings
         traceObjPtr->isEnabled = true;
 
         // Notify the client that the keyword is enabled.
-        UpdateClientTraceSetting(runningProcObjPtr, logSessionPtr, traceObjPtr);
+        UpdateClientTraceSetting(&batch, logSessionPtr->componentName, traceObjPtr->name, true);
 
         linkPtr = le_dls_PeekNext(&compNameObjPtr->enabledTracesList, linkPtr);
     }
+
+    SendCmdBatch(&batch);
 }
 
 
@@ -1444,6 +1687,388 @@ static void RegComponent
 }
 
 
+// Log streams are fed from the log rings, which are only drained on embedded targets.
+#ifdef LEGATO_EMBEDDED
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the component name out of a log line read out of a log ring.  The lines look like
+ * "LEVEL | process[pid]/component T=thread | file function() line | message".
+ *
+ * @return  true if successful, false if the line has no component name that fits in the buffer.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool GetLineComponentName
+(
+    const char* linePtr,    ///< [IN] Log line.
+    char* bufferPtr,        ///< [OUT] Buffer to copy the component name into.
+    size_t bufferSize       ///< [IN] Size of the buffer.
+)
+{
+    const char* startPtr = strstr(linePtr, "]/");
+
+    if (startPtr == NULL)
+    {
+        return false;
+    }
+    startPtr += 2;
+
+    const char* endPtr = strstr(startPtr, " T=");
+
+    if ((endPtr == NULL) || ((size_t)(endPtr - startPtr) >= bufferSize))
+    {
+        return false;
+    }
+
+    memcpy(bufferPtr, startPtr, endPtr - startPtr);
+    bufferPtr[endPtr - startPtr] = '\0';
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a log line read out of a running process's log ring passes a stream's filter.
+ *
+ * @return  true if it does.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool StreamFilterMatches
+(
+    const LogStream_t* streamPtr,   ///< [IN] The stream.
+    const RunningProcess_t* runningProcObjPtr,  ///< [IN] Process the line comes from.
+    const char* componentName,      ///< [IN] Component the line comes from ("" if unknown).
+    le_log_Level_t level,           ///< [IN] Severity level of the line.
+    const char* linePtr             ///< [IN] Log line.
+)
+{
+    // Cheapest checks first.
+    if (level < streamPtr->minLevel)
+    {
+        return false;
+    }
+
+    if (streamPtr->pid != -1)
+    {
+        if (runningProcObjPtr->pid != streamPtr->pid)
+        {
+            return false;
+        }
+    }
+    else if (strcmp(streamPtr->procName, "*") != 0)
+    {
+        if ( (runningProcObjPtr->procNameObjPtr == NULL)
+            || (strcmp(runningProcObjPtr->procNameObjPtr->name, streamPtr->procName) != 0) )
+        {
+            return false;
+        }
+    }
+
+    if ( (strcmp(streamPtr->componentName, "*") != 0)
+        && (strcmp(streamPtr->componentName, componentName) != 0) )
+    {
+        return false;
+    }
+
+    if ((streamPtr->matchStr[0] != '\0') && (strstr(linePtr, streamPtr->matchStr) == NULL))
+    {
+        return false;
+    }
+
+    if (streamPtr->hasRegex && (regexec(&streamPtr->regex, linePtr, 0, NULL, 0) != 0))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a line against a stream's rate cap.
+ *
+ * @return  true if the line can be streamed, false if it must be dropped.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool TakeStreamRate
+(
+    LogStream_t* streamPtr,         ///< [IN] The stream.
+    le_clk_Time_t now               ///< [IN] Current relative time.
+)
+{
+    if (streamPtr->rate == 0)
+    {
+        return true;
+    }
+
+    if (le_clk_Sub(now, streamPtr->periodStart).sec >= 1)
+    {
+        streamPtr->periodStart = now;
+        streamPtr->sentCount = 0;
+    }
+
+    if (streamPtr->sentCount >= streamPtr->rate)
+    {
+        streamPtr->droppedCount++;
+        return false;
+    }
+
+    streamPtr->sentCount++;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a line to a streaming log control tool.  Unlike SendToLogTool(), lines too long for a
+ * message are cut short without a warning, as there can be many of them.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SendToStream
+(
+    LogStream_t* streamPtr,         ///< [IN] The stream.
+    const char* lineStr             ///< [IN] Line to send.
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(streamPtr->ipcSessionRef);
+
+    le_utf8_Copy(le_msg_GetPayloadPtr(msgRef), lineStr, le_msg_GetMaxPayloadSize(msgRef), NULL);
+
+    le_msg_Send(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a log line read out of a running process's log ring to the log control tools streaming
+ * the messages that pass their filters, time-stamped like the messages shown from the log store.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SendToStreams
+(
+    RunningProcess_t* runningProcObjPtr,    ///< [IN] Process the line comes from.
+    le_log_Level_t level,                   ///< [IN] Severity level.
+    const char* linePtr                     ///< [IN] Log line.
+)
+{
+    if (le_dls_IsEmpty(&StreamList))
+    {
+        return;
+    }
+
+    char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES] = "";
+    char streamLine[LOG_MAX_CMD_PACKET_BYTES] = "";
+    le_clk_Time_t now = le_clk_GetRelativeTimeCoarse();
+
+    GetLineComponentName(linePtr, componentName, sizeof(componentName));
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&StreamList);
+
+    while (linkPtr != NULL)
+    {
+        LogStream_t* streamPtr = CONTAINER_OF(linkPtr, LogStream_t, link);
+
+        linkPtr = le_dls_PeekNext(&StreamList, linkPtr);
+
+        if ( !StreamFilterMatches(streamPtr, runningProcObjPtr, componentName, level, linePtr)
+            || !TakeStreamRate(streamPtr, now) )
+        {
+            continue;
+        }
+
+        if (streamPtr->droppedCount > 0)
+        {
+            char notice[64];
+
+            snprintf(notice, sizeof(notice), "--- %zu lines dropped (over %u lines/s) ---",
+                     streamPtr->droppedCount, streamPtr->rate);
+            SendToStream(streamPtr, notice);
+            streamPtr->droppedCount = 0;
+        }
+
+        // Only time-stamp the line once, for the first stream it goes to.
+        if (streamLine[0] == '\0')
+        {
+            le_clk_Time_t absTime = le_clk_GetAbsoluteTime();
+            time_t seconds = absTime.sec;
+            struct tm brokenDownTime;
+            char timeStamp[32] = "";
+
+            if (localtime_r(&seconds, &brokenDownTime) != NULL)
+            {
+                strftime(timeStamp, sizeof(timeStamp), "%b %e %H:%M:%S", &brokenDownTime);
+            }
+
+            snprintf(streamLine, sizeof(streamLine), "%s.%03u %s",
+                     timeStamp, (unsigned int)(absTime.usec / 1000), linePtr);
+        }
+
+        SendToStream(streamPtr, streamLine);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a message read out of a log ring out to the log, and to the streaming log control tools.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void WriteRingMsg
+(
+    le_log_Level_t level,   ///< [IN] Severity level.
+    const char* msgPtr,     ///< [IN] Log line.
+    void* contextPtr        ///< [IN] Running Process object of the ring.
+)
+{
+    log_WriteLine(level, msgPtr);
+    logStore_Write(level, msgPtr);
+    SendToStreams(contextPtr, level, msgPtr);
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Passes on the messages that a running process wrote into its log ring since the last time.
+ *
+ * On a PC, client processes write every message to their standard error as well as into the log
+ * ring, so this does nothing.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DrainRing
+(
+    RunningProcess_t* runningProcObjPtr
+)
+{
+#ifdef LEGATO_EMBEDDED
+    if (runningProcObjPtr->ringRef != NULL)
+    {
+        size_t lost = logRing_Read(runningProcObjPtr->ringRef,
+                                   &runningProcObjPtr->ringPos,
+                                   WriteRingMsg,
+                                   runningProcObjPtr);
+        if (lost > 0)
+        {
+            char msg[MAX_MSG_SIZE];
+
+            snprintf(msg, sizeof(msg), "%zu bytes of log messages were lost.", lost);
+            log_LogGenericMsg(LE_LOG_WARN,
+                              runningProcObjPtr->procNameObjPtr->name,
+                              runningProcObjPtr->pid,
+                              msg);
+        }
+    }
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer expiry handler that passes on the messages written into all the log rings.
+ **/
+//--------------------------------------------------------------------------------------------------
+#ifdef LEGATO_EMBEDDED
+
+static void DrainTimerExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(ProcessIdMapRef);
+    while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+    {
+        DrainRing((RunningProcess_t*)le_hashmap_GetValue(iteratorRef));
+    }
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer expiry handler that writes the messages collected for the log store into it.
+ **/
+//--------------------------------------------------------------------------------------------------
+#ifdef LEGATO_EMBEDDED
+
+static void LogStoreTimerExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    logStore_Flush();
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a message read out of a log ring into a dump file.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void WriteRingMsgToFile
+(
+    le_log_Level_t level,   ///< [IN] Severity level (not used).
+    const char* msgPtr,     ///< [IN] Log line.
+    void* contextPtr        ///< [IN] FILE stream to write to.
+)
+{
+    fprintf(contextPtr, "%s\n", msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves everything that is still in a process's log ring into a file in LOG_RING_DUMP_DIR, so
+ * that its last messages are still around if the Supervisor needs them to capture debug data.
+ * Deletes the oldest dump if there are already MAX_RING_DUMPS of them.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DumpRing
+(
+    RunningProcess_t* runningProcObjPtr
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    if (RingDumpPids[NextRingDumpIndex] != 0)
+    {
+        snprintf(path, sizeof(path), "%s/%d", LOG_RING_DUMP_DIR, RingDumpPids[NextRingDumpIndex]);
+
+        // The Supervisor may have already taken this dump.
+        if ((unlink(path) != 0) && (errno != ENOENT))
+        {
+            LE_WARN("Failed to delete old log ring dump '%s' (%m).", path);
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%d", LOG_RING_DUMP_DIR, runningProcObjPtr->pid);
+
+    FILE* filePtr = fopen(path, "we");
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Failed to create log ring dump '%s' (%m).", path);
+        return;
+    }
+
+    uint64_t pos = 0;
+    logRing_Read(runningProcObjPtr->ringRef, &pos, WriteRingMsgToFile, filePtr);
+
+    if (fclose(filePtr) != 0)
+    {
+        LE_ERROR("Failed to write log ring dump '%s' (%m).", path);
+    }
+
+    RingDumpPids[NextRingDumpIndex] = runningProcObjPtr->pid;
+    NextRingDumpIndex = (NextRingDumpIndex + 1) % MAX_RING_DUMPS;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handle the closing of a client IPC session, which signals the death of a process.
@@ -1478,6 +2103,21 @@ static void ClientIpcSessionClosed
     le_hashmap_Remove(ProcessIdMapRef, &runningProcObjPtr->pid);
     le_hashmap_Remove(IpcSessionMapRef, &ipcSessionRef);
 
+    // Pass on the last messages in the process's log ring, and keep a copy of them, then get rid
+    // of the ring.
+    if (runningProcObjPtr->ringRef != NULL)
+    {
+        DrainRing(runningProcObjPtr);
+        DumpRing(runningProcObjPtr);
+
+        logRing_Delete(runningProcObjPtr->ringRef);
+
+        if (runningProcObjPtr->ringFd != -1)
+        {
+            fd_Close(runningProcObjPtr->ringFd);
+        }
+    }
+
     // Delete all the log sessions for this process.
 
     LE_CRIT_IF(le_dls_IsEmpty(&runningProcObjPtr->logSessionList),
@@ -1492,9 +2132,13 @@ static void ClientIpcSessionClosed
         // Delete all the traces for this log session.
         while ((linkPtr = le_dls_Pop(&logSessionPtr->traceList)) != NULL)
         {
-            le_mem_Release(CONTAINER_OF(linkPtr, Trace_t, link));
+            Trace_t* traceObjPtr = CONTAINER_OF(linkPtr, Trace_t, link);
+
+            le_hashmap_Remove(TraceMapRef, &traceObjPtr->key);
+            le_mem_Release(traceObjPtr);
         }
 
+        le_hashmap_Remove(LogSessionMapRef, &logSessionPtr->key);
         le_mem_Release(logSessionPtr);
     }
 
@@ -1516,6 +2160,60 @@ static void ClientIpcSessionClosed
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores log settings in a Component Name object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SetComponentNameSettings
+(
+    ComponentName_t* compNameObjPtr,
+    le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr                ///< [IN] Rate limit string, or NULL if not being set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (levelPtr != NULL)
+    {
+        compNameObjPtr->level = *levelPtr;
+    }
+    if (rateLimitStr != NULL)
+    {
+        le_utf8_Copy(compNameObjPtr->rateLimit,
+                     rateLimitStr,
+                     sizeof(compNameObjPtr->rateLimit),
+                     NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores log settings in a Log Session object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SetLogSessionSettings
+(
+    LogSession_t* logSessionObjPtr,
+    le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr                ///< [IN] Rate limit string, or NULL if not being set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (levelPtr != NULL)
+    {
+        logSessionObjPtr->level = *levelPtr;
+    }
+    if (rateLimitStr != NULL)
+    {
+        le_utf8_Copy(logSessionObjPtr->rateLimit,
+                     rateLimitStr,
+                     sizeof(logSessionObjPtr->rateLimit),
+                     NULL);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets log settings for a specific running process.
@@ -1525,10 +2223,15 @@ static void SetForRunningProcess
 (
     RunningProcess_t* runningProcObjPtr,
     const char* componentName,
-    le_log_Level_t* levelPtr                ///< [IN] Ptr log level, or NULL if not being set.
+    le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr                ///< [IN] Rate limit string, or NULL if not being set.
 )
 //--------------------------------------------------------------------------------------------------
 {
+    CmdBatch_t batch;
+
+    StartCmdBatch(&batch, runningProcObjPtr);
+
     // If the setting applies to all log sessions in the process,
     if (strcmp(componentName, "*") == 0)
     {
@@ -1538,15 +2241,20 @@ static void SetForRunningProcess
         {
             LogSession_t* logSessionObjPtr = CONTAINER_OF(linkPtr, LogSession_t, link);
 
-            if (levelPtr != NULL)
-            {
-                logSessionObjPtr->level = *levelPtr;
-            }
-
-            UpdateClientSessionSettings(runningProcObjPtr, logSessionObjPtr);
+            SetLogSessionSettings(logSessionObjPtr, levelPtr, rateLimitStr);
 
             linkPtr = le_dls_PeekNext(&runningProcObjPtr->logSessionList, linkPtr);
         }
+
+        // The client applies the same settings to all of its log sessions itself.
+        if (levelPtr != NULL)
+        {
+            AddToCmdBatch(&batch, LOG_CMD_SET_LEVEL, "*", GetLevelString(*levelPtr));
+        }
+        if (rateLimitStr != NULL)
+        {
+            AddToCmdBatch(&batch, LOG_CMD_SET_RATE_LIMIT, "*", rateLimitStr);
+        }
     }
     // If the setting applies to a specific log session within the process,
     else
@@ -1555,14 +2263,13 @@ static void SetForRunningProcess
         LogSession_t* logSessionObjPtr = FindLogSession(runningProcObjPtr, componentName);
         if (logSessionObjPtr != NULL)
         {
-            if (levelPtr != NULL)
-            {
-                logSessionObjPtr->level = *levelPtr;
-            }
+            SetLogSessionSettings(logSessionObjPtr, levelPtr, rateLimitStr);
 
-            UpdateClientSessionSettings(runningProcObjPtr, logSessionObjPtr);
+            UpdateClientSessionSettings(&batch, logSessionObjPtr);
         }
     }
+
+    SendCmdBatch(&batch);
 }
 
 
@@ -1576,6 +2283,7 @@ static void SetByPid
     pid_t pid,
     const char* componentName,
     le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr,               ///< [IN] Rate limit string, or NULL if not being set.
     le_msg_SessionRef_t toolIpcSessionRef   ///< [IN] Reference to log control tool's IPC session.
 )
 //--------------------------------------------------------------------------------------------------
@@ -1591,7 +2299,7 @@ static void SetByPid
     }
     else
     {
-        SetForRunningProcess(runningProcObjPtr, componentName, levelPtr);
+        SetForRunningProcess(runningProcObjPtr, componentName, levelPtr, rateLimitStr);
     }
 }
 
@@ -1605,7 +2313,8 @@ static void SetByPid
 static void SetForAllProcesses
 (
     const char* componentName,
-    le_log_Level_t* levelPtr                ///< [IN] Ptr log level, or NULL if not being set.
+    le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr                ///< [IN] Rate limit string, or NULL if not being set.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -1642,10 +2351,7 @@ static void SetForAllProcesses
             {
                 ComponentName_t* compNameObjPtr = CONTAINER_OF(linkPtr, ComponentName_t, link);
 
-                if (levelPtr != NULL)
-                {
-                    compNameObjPtr->level = *levelPtr;
-                }
+                SetComponentNameSettings(compNameObjPtr, levelPtr, rateLimitStr);
 
                 linkPtr = le_dls_PeekNext(&procNameObjPtr->componentNameList, linkPtr);
             }
@@ -1657,10 +2363,7 @@ static void SetForAllProcesses
             ComponentName_t* compNameObjPtr = FindComponentName(procNameObjPtr, componentName);
             if (compNameObjPtr != NULL)
             {
-                if (levelPtr != NULL)
-                {
-                    compNameObjPtr->level = *levelPtr;
-                }
+                SetComponentNameSettings(compNameObjPtr, levelPtr, rateLimitStr);
             }
         }
 
@@ -1670,7 +2373,7 @@ static void SetForAllProcesses
         {
             RunningProcess_t* runningProcObjPtr = CONTAINER_OF(linkPtr, RunningProcess_t, link);
 
-            SetForRunningProcess(runningProcObjPtr, componentName, levelPtr);
+            SetForRunningProcess(runningProcObjPtr, componentName, levelPtr, rateLimitStr);
 
             linkPtr = le_dls_PeekNext(&procNameObjPtr->runningProcessesList, linkPtr);
         }
@@ -1729,7 +2432,8 @@ static void SetByProcessName
 (
     const char* processName,
     const char* componentName,
-    le_log_Level_t* levelPtr                ///< [IN] Ptr log level, or NULL if not being set.
+    le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr                ///< [IN] Rate limit string, or NULL if not being set.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -1762,10 +2466,7 @@ static void SetByProcessName
         {
             ComponentName_t* compNameObjPtr = CONTAINER_OF(linkPtr, ComponentName_t, link);
 
-            if (levelPtr != NULL)
-            {
-                compNameObjPtr->level = *levelPtr;
-            }
+            SetComponentNameSettings(compNameObjPtr, levelPtr, rateLimitStr);
 
             linkPtr = le_dls_PeekNext(&procNameObjPtr->componentNameList, linkPtr);
         }
@@ -1780,10 +2481,7 @@ static void SetByProcessName
         {
             compNameObjPtr = CreateComponentName(procNameObjPtr, componentName);
         }
-        if (levelPtr != NULL)
-        {
-            compNameObjPtr->level = *levelPtr;
-        }
+        SetComponentNameSettings(compNameObjPtr, levelPtr, rateLimitStr);
     }
 
     // Now update all the actual running processes that share this process name.
@@ -1792,7 +2490,7 @@ static void SetByProcessName
     {
         RunningProcess_t* runningProcObjPtr = CONTAINER_OF(linkPtr, RunningProcess_t, link);
 
-        SetForRunningProcess(runningProcObjPtr, componentName, levelPtr);
+        SetForRunningProcess(runningProcObjPtr, componentName, levelPtr, rateLimitStr);
 
         linkPtr = le_dls_PeekNext(&procNameObjPtr->runningProcessesList, linkPtr);
     }
@@ -1809,6 +2507,7 @@ static void ApplySettings
     const char* processName,
     const char* componentName,
     le_log_Level_t* levelPtr,               ///< [IN] Ptr log level, or NULL if not being set.
+    const char* rateLimitStr,               ///< [IN] Rate limit string, or NULL if not being set.
     le_msg_SessionRef_t toolIpcSessionRef   ///< [IN] Reference to log control tool's IPC session.
 
 )
@@ -1818,18 +2517,18 @@ static void ApplySettings
     pid_t pid = StringToPid(processName);
     if (pid > 0)
     {
-        SetByPid(pid, componentName, levelPtr, toolIpcSessionRef);
+        SetByPid(pid, componentName, levelPtr, rateLimitStr, toolIpcSessionRef);
     }
     // If the process name is "*",
     else if (strcmp(processName, "*") == 0)
     {
         // This setting applies to ALL PROCESSES.
-        SetForAllProcesses(componentName, levelPtr);
+        SetForAllProcesses(componentName, levelPtr, rateLimitStr);
     }
     else
     {
         // This setting applies to processes sharing a specific name.
-        SetByProcessName(processName, componentName, levelPtr);
+        SetByProcessName(processName, componentName, levelPtr, rateLimitStr);
     }
 }
 
@@ -1861,7 +2560,7 @@ static void SetLevel
     }
     else
     {
-        ApplySettings(processName, componentName, &level, toolIpcSessionRef);
+        ApplySettings(processName, componentName, &level, NULL, toolIpcSessionRef);
         snprintf(message,
                  sizeof(message),
                  "Set filtering level for '%s/%s' to '%s'.",
@@ -1873,6 +2572,49 @@ static void SetLevel
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the per-call-site rate limit for a given process/component.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SetRateLimit
+(
+    const char* processName,
+    const char* componentName,
+    const char* rateLimitStr,
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char message[128];
+    log_RateLimit_t rateLimit;
+
+    // Parse the command data payload to get the rate limit, and put it back into the standard
+    // form that is stored and sent to the clients.
+    if (log_StrToRateLimit(rateLimitStr, &rateLimit) != LE_OK)
+    {
+        snprintf(message, sizeof(message), "***ERROR: Invalid rate limit '%s'.", rateLimitStr);
+        LE_WARN("%s", message);
+        SendToLogTool(toolIpcSessionRef, message);
+    }
+    else
+    {
+        char normalizedStr[LOG_RATE_LIMIT_STR_BYTES];
+
+        log_RateLimitToStr(&rateLimit, normalizedStr, sizeof(normalizedStr));
+
+        ApplySettings(processName, componentName, NULL, normalizedStr, toolIpcSessionRef);
+        snprintf(message,
+                 sizeof(message),
+                 "Set rate limit for '%s/%s' to '%s'.",
+                 processName,
+                 componentName,
+                 normalizedStr);
+        SendToLogTool(toolIpcSessionRef, message);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets (enables or disables) a trace for a specific component name.
@@ -1900,6 +2642,7 @@ static void SetTraceForComponentName
         if (!isEnabled)
         {
             le_dls_Remove(&compNameObjPtr->enabledTracesList, &traceNameObjPtr->link);
+            le_hashmap_Remove(TraceNameMapRef, &traceNameObjPtr->key);
             le_mem_Release(traceNameObjPtr);
         }
     }
@@ -1908,12 +2651,11 @@ static void SetTraceForComponentName
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sets (enables or disables) a trace for a specific log session.
+ * Records the setting (enabled or disabled) of a trace for a specific log session.
  **/
 //--------------------------------------------------------------------------------------------------
 static void SetTraceForLogSession
 (
-    RunningProcess_t* runningProcObjPtr,
     LogSession_t* logSessionPtr,
     const char* keyword,
     bool isEnabled
@@ -1928,8 +2670,6 @@ static void SetTraceForLogSession
     }
 
     tracePtr->isEnabled = isEnabled;
-
-    UpdateClientTraceSetting(runningProcObjPtr, logSessionPtr, tracePtr);
 }
 
 
@@ -1947,6 +2687,10 @@ static void SetTraceForRunningProcess
 )
 //--------------------------------------------------------------------------------------------------
 {
+    CmdBatch_t batch;
+
+    StartCmdBatch(&batch, runningProcObjPtr);
+
     // If the setting applies to all log sessions in the process,
     if (strcmp(componentName, "*") == 0)
     {
@@ -1956,10 +2700,13 @@ static void SetTraceForRunningProcess
         {
             LogSession_t* logSessionObjPtr = CONTAINER_OF(linkPtr, LogSession_t, link);
 
-            SetTraceForLogSession(runningProcObjPtr, logSessionObjPtr, keyword, isEnabled);
+            SetTraceForLogSession(logSessionObjPtr, keyword, isEnabled);
 
             linkPtr = le_dls_PeekNext(&runningProcObjPtr->logSessionList, linkPtr);
         }
+
+        // The client applies the same setting to all of its log sessions itself.
+        UpdateClientTraceSetting(&batch, "*", keyword, isEnabled);
     }
     // If the setting applies to a specific log session within the process,
     else
@@ -1968,9 +2715,13 @@ static void SetTraceForRunningProcess
         LogSession_t* logSessionObjPtr = FindLogSession(runningProcObjPtr, componentName);
         if (logSessionObjPtr != NULL)
         {
-            SetTraceForLogSession(runningProcObjPtr, logSessionObjPtr, keyword, isEnabled);
+            SetTraceForLogSession(logSessionObjPtr, keyword, isEnabled);
+
+            UpdateClientTraceSetting(&batch, logSessionObjPtr->componentName, keyword, isEnabled);
         }
     }
+
+    SendCmdBatch(&batch);
 }
 
 
@@ -2238,13 +2989,14 @@ static void SendTraceNameToLogTool
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message to the log tool containing a printable, null-terminated, UTF-8 string containing
- * the name of a component and its associated log level.
+ * the name of a component and its associated log level and rate limit.
  **/
 //--------------------------------------------------------------------------------------------------
 static void SendComponentInfoToLogTool
 (
     const char* componentName,
     le_log_Level_t level,
+    const char* rateLimitStr,
     le_msg_SessionRef_t ipcSessionRef
 )
 //--------------------------------------------------------------------------------------------------
@@ -2255,9 +3007,11 @@ static void SendComponentInfoToLogTool
 
     snprintf(payloadPtr,
              le_msg_GetMaxPayloadSize(msgRef),
-             "      /%s @ %s",
+             "      /%s @ %s%s%s",
              componentName,
-             GetLevelString(level));
+             GetLevelString(level),
+             (rateLimitStr[0] != '\0') ? ", rate limit " : "",
+             rateLimitStr);
 
     le_msg_Send(msgRef);
 }
@@ -2279,6 +3033,7 @@ static void GenerateComponentList
 {
     SendComponentInfoToLogTool(compNameObjPtr->name,
                                compNameObjPtr->level,
+                               compNameObjPtr->rateLimit,
                                ipcSessionRef);
 
     le_dls_Link_t* linkPtr = le_dls_Peek(&compNameObjPtr->enabledTracesList);
@@ -2308,6 +3063,7 @@ static void GenerateLogSessionList
 {
     SendComponentInfoToLogTool(logSessionObjPtr->componentName,
                                logSessionObjPtr->level,
+                               logSessionObjPtr->rateLimit,
                                ipcSessionRef);
 
     le_dls_Link_t* linkPtr = le_dls_Peek(&logSessionObjPtr->traceList);
@@ -2485,15 +3241,28 @@ static void ClientMsgReceiveHandler
         switch (command)
         {
             case LOG_CMD_REG_COMPONENT:
-
+            {
                 RegComponent(processName, componentName, commandDataPtr, ipcSessionRef);
+
+                // If the process hasn't been sent its log ring yet, send it now.  The fd is
+                // closed once it is sent.
+                RunningProcess_t* runningProcObjPtr = FindProcessByIpcSession(ipcSessionRef);
+
+                if ((runningProcObjPtr != NULL) && (runningProcObjPtr->ringFd != -1))
+                {
+                    le_msg_SetFd(msgRef, runningProcObjPtr->ringFd);
+                    runningProcObjPtr->ringFd = -1;
+                }
+
                 le_msg_Respond(msgRef);
 
                 return;
+            }
 
             case LOG_CMD_SET_LEVEL:
             case LOG_CMD_ENABLE_TRACE:
             case LOG_CMD_DISABLE_TRACE:
+            case LOG_CMD_SET_RATE_LIMIT:
             case LOG_CMD_LIST_COMPONENTS:
             case LOG_CMD_FORGET_PROCESS:
 
@@ -2521,6 +3290,235 @@ static void ClientMsgReceiveHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a Log Stream object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DeleteStream
+(
+    LogStream_t* streamPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&StreamList, &streamPtr->link);
+
+    if (streamPtr->hasRegex)
+    {
+        regfree(&streamPtr->regex);
+    }
+
+    le_mem_Release(streamPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies one "KEY=VALUE" setting of a stream filter to a Log Stream object.
+ *
+ * @return  LE_OK if successful, LE_FAULT if the setting is invalid (the error message is then put
+ *          in the error buffer).
+ **/
+//--------------------------------------------------------------------------------------------------
+#ifdef LEGATO_EMBEDDED
+
+static le_result_t ApplyStreamSetting
+(
+    LogStream_t* streamPtr,     ///< [IN] The stream.
+    const char* settingPtr,     ///< [IN] The setting.
+    char* errorPtr,             ///< [OUT] Buffer for the error message.
+    size_t errorSize            ///< [IN] Size of the error buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* valuePtr = strchr(settingPtr, '=');
+
+    if (valuePtr == NULL)
+    {
+        snprintf(errorPtr, errorSize, "***ERROR: Invalid stream filter '%s'.", settingPtr);
+        return LE_FAULT;
+    }
+    size_t keyLen = valuePtr - settingPtr;
+    valuePtr++;
+
+#define IS_KEY(key) ((keyLen == sizeof(key) - 1) && (strncmp(settingPtr, key, keyLen) == 0))
+
+    if (IS_KEY(LOG_STREAM_LEVEL_KEY))
+    {
+        streamPtr->minLevel = log_StrToSeverityLevel(valuePtr);
+
+        if (streamPtr->minLevel == (le_log_Level_t)-1)
+        {
+            snprintf(errorPtr, errorSize, "***ERROR: Invalid log level '%s'.", valuePtr);
+            return LE_FAULT;
+        }
+    }
+    else if (IS_KEY(LOG_STREAM_MATCH_KEY))
+    {
+        LE_ASSERT(le_utf8_Copy(streamPtr->matchStr, valuePtr, sizeof(streamPtr->matchStr), NULL)
+                  == LE_OK);
+    }
+    else if (IS_KEY(LOG_STREAM_REGEX_KEY))
+    {
+        if (streamPtr->hasRegex)
+        {
+            regfree(&streamPtr->regex);
+            streamPtr->hasRegex = false;
+        }
+
+        int result = regcomp(&streamPtr->regex, valuePtr, REG_EXTENDED | REG_NOSUB);
+
+        if (result != 0)
+        {
+            char reason[100];
+
+            regerror(result, &streamPtr->regex, reason, sizeof(reason));
+            snprintf(errorPtr, errorSize, "***ERROR: Invalid regular expression (%s).", reason);
+            return LE_FAULT;
+        }
+        streamPtr->hasRegex = true;
+    }
+    else if (IS_KEY(LOG_STREAM_RATE_KEY))
+    {
+        char* endPtr;
+
+        errno = 0;
+        unsigned long rate = strtoul(valuePtr, &endPtr, 10);
+
+        if ((errno != 0) || (endPtr == valuePtr) || (*endPtr != '\0') || (rate > UINT32_MAX))
+        {
+            snprintf(errorPtr, errorSize, "***ERROR: Invalid stream rate '%s'.", valuePtr);
+            return LE_FAULT;
+        }
+        streamPtr->rate = rate;
+    }
+    else
+    {
+        snprintf(errorPtr, errorSize, "***ERROR: Invalid stream filter '%s'.", settingPtr);
+        return LE_FAULT;
+    }
+
+#undef IS_KEY
+
+    return LE_OK;
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts streaming the messages that pass a filter to a log control tool.
+ *
+ * @return  true if the tool is now streaming, false if an error message was sent to it instead.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool StartStream
+(
+    const char* processName,
+    const char* componentName,
+    const char* filterStr,
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+#ifdef LEGATO_EMBEDDED
+    char message[LOG_MAX_CMD_PACKET_BYTES];
+    char filter[LOG_MAX_CMD_PACKET_BYTES];
+
+    LogStream_t* streamPtr = le_mem_ForceAlloc(LogStreamPoolRef);
+    memset(streamPtr, 0, sizeof(*streamPtr));
+
+    streamPtr->link = LE_DLS_LINK_INIT;
+    streamPtr->ipcSessionRef = toolIpcSessionRef;
+    LE_ASSERT(le_utf8_Copy(streamPtr->procName, processName, sizeof(streamPtr->procName), NULL)
+              == LE_OK);
+    LE_ASSERT(le_utf8_Copy(streamPtr->componentName,
+                           componentName,
+                           sizeof(streamPtr->componentName),
+                           NULL) == LE_OK);
+    streamPtr->pid = StringToPid(processName);
+    if (streamPtr->pid <= 0)
+    {
+        streamPtr->pid = -1;
+    }
+    streamPtr->minLevel = LE_LOG_DEBUG;
+    streamPtr->rate = LOG_STREAM_DEFAULT_RATE;
+    streamPtr->periodStart = le_clk_GetRelativeTimeCoarse();
+
+    // Apply the filter's settings, one line at a time.
+    LE_ASSERT(le_utf8_Copy(filter, filterStr, sizeof(filter), NULL) == LE_OK);
+
+    char* settingPtr = filter;
+
+    while (settingPtr != NULL)
+    {
+        char* nextPtr = strchr(settingPtr, LOG_CMD_SEPARATOR);
+
+        if (nextPtr != NULL)
+        {
+            *nextPtr = '\0';
+            nextPtr++;
+        }
+
+        if ( (settingPtr[0] != '\0')
+            && (ApplyStreamSetting(streamPtr, settingPtr, message, sizeof(message)) != LE_OK) )
+        {
+            LE_WARN("%s", message);
+            SendToLogTool(toolIpcSessionRef, message);
+            DeleteStream(streamPtr);
+            return false;
+        }
+
+        settingPtr = nextPtr;
+    }
+
+    le_dls_Queue(&StreamList, &streamPtr->link);
+
+    LE_DEBUG("Streaming log messages of '%s/%s' to log control tool session %p.",
+             processName,
+             componentName,
+             toolIpcSessionRef);
+
+    return true;
+#else
+    // Processes write their messages to their standard error on a PC, instead of through the log
+    // rings that the streams are fed from.
+    SendToLogTool(toolIpcSessionRef, "***ERROR: Log streaming is only supported on targets.");
+
+    return false;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a log control tool session closing: stops streaming to it, if it was.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ControlToolSessionClosed
+(
+    le_msg_SessionRef_t ipcSessionRef,
+    void* contextPtr    // not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&StreamList);
+
+    while (linkPtr != NULL)
+    {
+        LogStream_t* streamPtr = CONTAINER_OF(linkPtr, LogStream_t, link);
+
+        linkPtr = le_dls_PeekNext(&StreamList, linkPtr);
+
+        if (streamPtr->ipcSessionRef == ipcSessionRef)
+        {
+            DeleteStream(streamPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process a message received from a connected log control tool.
@@ -2540,6 +3538,7 @@ static void ControlToolMsgReceiveHandler
     char processName[LIMIT_MAX_PROCESS_NAME_BYTES];
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
     const char* commandDataPtr;
+    bool keepSessionOpen = false;
 
     // Parse the packet to get the process and component names.
     if (ParseCmdPacket(rxBuffPtr, &command, processName, componentName, &commandDataPtr))
@@ -2565,6 +3564,12 @@ static void ControlToolMsgReceiveHandler
 
                 break;
 
+            case LOG_CMD_SET_RATE_LIMIT:
+
+                SetRateLimit(processName, componentName, commandDataPtr, ipcSessionRef);
+
+                break;
+
             case LOG_CMD_REG_COMPONENT:
 
                 LE_ERROR("Unexpected command '%c' from log control tool.", command);
@@ -2583,6 +3588,16 @@ static void ControlToolMsgReceiveHandler
 
                 break;
 
+            case LOG_CMD_STREAM:
+
+                // The session stays open for the messages streamed, until the tool closes it.
+                keepSessionOpen = StartStream(processName,
+                                              componentName,
+                                              commandDataPtr,
+                                              ipcSessionRef);
+
+                break;
+
             default:
 
                 LE_ERROR("Unknown command byte '%c' received from log control tool.", command);
@@ -2592,7 +3607,10 @@ static void ControlToolMsgReceiveHandler
         }
     }
 
-    le_msg_CloseSession(le_msg_GetSession(msgRef));
+    if (!keepSessionOpen)
+    {
+        le_msg_CloseSession(le_msg_GetSession(msgRef));
+    }
     le_msg_ReleaseMsg(msgRef);
 }
 
@@ -2801,6 +3819,7 @@ COMPONENT_INIT
     LogSessionPoolRef = le_mem_CreatePool("LogSession", sizeof(LogSession_t));
     TracePoolRef = le_mem_CreatePool("Traces", sizeof(Trace_t));
     FdLogPoolRef = le_mem_CreatePool("FdLogs", sizeof(FdLog_t));
+    LogStreamPoolRef = le_mem_CreatePool("LogStreams", sizeof(LogStream_t));
 
     // Tune the pools' initial sizes to reduce warnings in the log at start-up.
     // TODO: Make this configurable.
@@ -2825,6 +3844,47 @@ COMPONENT_INIT
                                           MAX_EXPECTED_PROCESSES,
                                           ProcessIdHash,
                                           ProcessIdEquals);
+    ComponentNameMapRef = le_hashmap_Create("ComponentName",
+                                            MAX_EXPECTED_COMPONENTS,
+                                            NameKeyHash,
+                                            NameKeyEquals);
+    TraceNameMapRef     = le_hashmap_Create("TraceName",
+                                            MAX_EXPECTED_TRACES,
+                                            NameKeyHash,
+                                            NameKeyEquals);
+    LogSessionMapRef    = le_hashmap_Create("LogSession",
+                                            MAX_EXPECTED_COMPONENTS,
+                                            NameKeyHash,
+                                            NameKeyEquals);
+    TraceMapRef         = le_hashmap_Create("Trace",
+                                            MAX_EXPECTED_TRACES,
+                                            NameKeyHash,
+                                            NameKeyEquals);
+
+    // Start with an empty log ring dump directory.
+    // If this fails, the last messages from processes that die just won't be saved.
+    LE_ERROR_IF((le_dir_RemoveRecursive(LOG_RING_DUMP_DIR) != LE_OK)
+                || (le_dir_MakePath(LOG_RING_DUMP_DIR, S_IRWXU) == LE_FAULT),
+                "Failed to set up log ring dump directory '%s'.", LOG_RING_DUMP_DIR);
+
+#ifdef LEGATO_EMBEDDED
+    // Start passing on the messages written into the log rings.
+    le_timer_Ref_t drainTimerRef = le_timer_Create("RingDrain");
+    le_timer_SetMsInterval(drainTimerRef, RING_DRAIN_INTERVAL_MS);
+    le_timer_SetRepeat(drainTimerRef, 0);
+    le_timer_SetHandler(drainTimerRef, DrainTimerExpiryHandler);
+    le_timer_Start(drainTimerRef);
+
+    // Keep a compressed copy of those messages on flash too, if the system has been set up for it.
+    if ((access(LOG_STORE_DIR, F_OK) == 0) && (logStore_Open(LOG_STORE_DIR) == LE_OK))
+    {
+        le_timer_Ref_t storeTimerRef = le_timer_Create("LogStoreFlush");
+        le_timer_SetMsInterval(storeTimerRef, LOG_STORE_FLUSH_INTERVAL_MS);
+        le_timer_SetRepeat(storeTimerRef, 0);
+        le_timer_SetHandler(storeTimerRef, LogStoreTimerExpiryHandler);
+        le_timer_Start(storeTimerRef);
+    }
+#endif
 
     // Get a reference to the Log Control Protocol identification.
     le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID,
@@ -2839,6 +3899,7 @@ COMPONENT_INIT
     // Create and advertise the log control service (the one the control tool uses).
     serviceRef = le_msg_CreateService(protocolRef, LOG_CONTROL_SERVICE_NAME);
     le_msg_SetServiceRecvHandler(serviceRef, ControlToolMsgReceiveHandler, NULL);
+    le_msg_AddServiceCloseHandler(serviceRef, ControlToolSessionClosed, NULL);
     le_msg_AdvertiseService(serviceRef);
 
     // Close the fd that we inherited from the Supervisor.  This will let the Supervisor know that
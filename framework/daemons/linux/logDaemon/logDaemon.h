@@ -23,6 +23,20 @@
  * the Log Control Daemon will use log control commands to update log clients when log
  * control settings are changed by log control tools.
  *
+ * The commands sent to log clients leave out the ProcessName (and its '/').  A ComponentName of
+ * "*" applies a command to all the components in the client process, and several commands for
+ * the same client may be sent in one message, separated by LOG_CMD_SEPARATOR characters, so that
+ * changing a setting costs one message per process rather than one per component.
+ *
+ * The response to the first "Register" message from a process carries a file descriptor for a
+ * log ring (see logRing.h) that the Log Control Daemon has created for that process.  From then
+ * on, the process writes its log messages into the ring, and the Log Control Daemon passes them
+ * on to syslog.  When the process disconnects (e.g., because it died), the Log Control Daemon
+ * saves what is left in the ring into a file in LOG_RING_DUMP_DIR, so that the last messages
+ * logged by a faulty process can be saved along with the rest of its debug data.  The Log Control
+ * Daemon can also keep a compressed copy of the messages on flash, for the log tool's "show"
+ * command to read back (see logStore.h).
+ *
  * @todo Change to use shared memory to control log sessions instead.
  *
  * Log tools connect and send in a log control command.  The Log Control Daemon responds
@@ -31,6 +45,12 @@
  * session with the log control tool when it finishes processing the command.
  * Response strings that contain error messages always start with a "*".
  *
+ * The "stream" command (LOG_CMD_STREAM) is the exception: the Log Control Daemon keeps the IPC
+ * session open and sends the tool every message read out of the log rings that passes the
+ * command's filter, one message per line, until the tool closes the session.  The filtering is
+ * done by the Log Control Daemon so that only the lines wanted are sent over, which matters when
+ * the tool's output goes over a slow link, and the number of lines sent each second is capped.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -73,6 +93,33 @@
 #define LOG_CLIENT_SERVICE_NAME         "LogClient"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the log ring that the Log Control Daemon creates for each client process, in bytes.
+ * This is roughly how much of a process's most recent log is still available after it dies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_RING_SIZE                   (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory that the Log Control Daemon saves the contents of a process's log ring into when the
+ * process disconnects.  Each file is named after the process ID.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_RING_DUMP_DIR               STRINGIZE(LE_RUNTIME_DIR) "logRings"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File that the Supervisor moves a faulty process's log ring dump to, for the saveLogs script to
+ * pick up.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_RING_FAULT_DUMP_FILE        LOG_RING_DUMP_DIR "/fault"
+
+
 // =====================================
 //  COMMANDS
 // =====================================
@@ -86,6 +133,15 @@
 #define LOG_CMD_SET_LEVEL               'l' // CommandData = level string (see below)
 #define LOG_CMD_ENABLE_TRACE            'e' // CommandData = keyword string
 #define LOG_CMD_DISABLE_TRACE           'd' // CommandData = keyword string
+#define LOG_CMD_SET_RATE_LIMIT          'q' // CommandData = rate limit string (see below)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Separates the commands batched into one message sent from the log daemon to a component.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_CMD_SEPARATOR               '\n'
 
 
 //--------------------------------------------------------------------------------------------------
@@ -103,6 +159,7 @@
 //--------------------------------------------------------------------------------------------------
 #define LOG_CMD_LIST_COMPONENTS         'c' // No ProcessName, ComponentName, or CommandData
 #define LOG_CMD_FORGET_PROCESS          'x' // No ComponentName or CommandData
+#define LOG_CMD_STREAM                  'f' // CommandData = stream filter (see below)
 
 
 // =======================================================
@@ -117,6 +174,29 @@
 #define LOG_SET_LEVEL_DEBUG_STR "DEBUG"
 
 
+// ===============================================================
+//  RATE LIMITS (CommandData part of SET_RATE_LIMIT commands)
+// ===============================================================
+
+// Either this, or "COUNT/SECONDS" (e.g., "10/60" for at most 10 messages a minute).
+#define LOG_RATE_LIMIT_OFF_STR  "off"
+
+
+// ===============================================================
+//  STREAM FILTERS (CommandData part of STREAM commands)
+// ===============================================================
+
+// The filter is a list of "KEY=VALUE" settings separated by LOG_CMD_SEPARATOR characters.  The
+// ProcessName and ComponentName of the command select the messages' origin ("*" for all).
+#define LOG_STREAM_LEVEL_KEY    "level" // Least severe level streamed (a level string above).
+#define LOG_STREAM_MATCH_KEY    "match" // Text that the lines streamed must contain.
+#define LOG_STREAM_REGEX_KEY    "regex" // POSIX extended regular expression they must match.
+#define LOG_STREAM_RATE_KEY     "rate"  // Most lines streamed per second (0 = no cap).
+
+// Rate cap used if the filter doesn't have one.
+#define LOG_STREAM_DEFAULT_RATE 50
+
+
 // =========================================================================
 //  LOG OUTPUT LOCATION NAMES (CommandData part of SET_OUTPUT_LOC commands)
 // =========================================================================
@@ -0,0 +1,856 @@
+/** @file logStore.c
+ *
+ * Compressed on-target log store.  See logStore.h for the design.
+ *
+ * The LZ4 block format is implemented here rather than pulled in from liblz4, as only the
+ * simplest (single-probe, greedy) compressor is needed for log text, and the framework doesn't
+ * otherwise depend on it.  Blocks are never bigger than 64 KiB, so every match offset fits the
+ * format's 16 bits.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include "logStore.h"
+
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_MAGIC               0x53474f4c  // "LOGS"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the segment file layout.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_VERSION             1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of blocks in a segment.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BLOCKS                  256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in front of each message's text in a block: the time and the level.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_HEADER_BYTES            9
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * LZ4 block format parameters.  A match is at least LZ4_MIN_MATCH bytes long, the last
+ * LZ4_LAST_LITERALS bytes of a block are always literals, and the last match starts at least
+ * LZ4_MF_LIMIT bytes before the end of the block.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LZ4_MIN_MATCH               4
+#define LZ4_LAST_LITERALS           5
+#define LZ4_MF_LIMIT                12
+#define LZ4_MAX_OFFSET              65535
+#define LZ4_HASH_BITS               12
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest size that LZ4 compression can grow a given number of bytes to.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LZ4_BOUND(size)             ((size) + ((size) / 255) + 16)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry for a block.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t minMs;                 ///< Earliest time of the messages in the block.
+    uint64_t maxMs;                 ///< Latest time of the messages in the block.
+    uint32_t offset;                ///< Offset of the compressed block from the start of the file.
+    uint32_t compressedSize;        ///< Size of the compressed block, in bytes.
+    uint32_t size;                  ///< Size of the block before compression, in bytes.
+    uint32_t levelMask;             ///< LOG_STORE_LEVEL_BIT() of each level in the block.
+}
+BlockEntry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment file header.  Followed by the blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                 ///< SEGMENT_MAGIC.
+    uint32_t version;               ///< SEGMENT_VERSION.
+    uint64_t seq;                   ///< Sequence number of the segment (0 while it's being reset).
+    uint32_t blockCount;            ///< Number of complete blocks in the segment.
+    uint32_t dataEnd;               ///< Offset of the end of the last block.
+    BlockEntry_t blocks[MAX_BLOCKS];    ///< Block index.
+}
+SegmentHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment mapped for reading.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const SegmentHeader_t* headerPtr;   ///< Mapped segment file (NULL if there's no segment).
+    uint64_t seq;                       ///< Sequence number of the segment.
+}
+MappedSegment_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writer state.
+ */
+//--------------------------------------------------------------------------------------------------
+static char DirPath[LIMIT_MAX_PATH_BYTES];  ///< Store directory ("" if the store isn't open).
+static SegmentHeader_t* SegmentPtr;         ///< Segment being written (NULL if none yet).
+static int SegmentIndex = -1;               ///< Index of the segment being written.
+static uint64_t NextSeq = 1;                ///< Sequence number for the next segment.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block being filled in, and its index entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Block[LOG_STORE_BLOCK_BYTES];
+static BlockEntry_t BlockEntry;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer that blocks are compressed into (when writing) or decompressed into (when reading).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t CodecBuffer[LZ4_BOUND(LOG_STORE_BLOCK_BYTES)];
+
+
+// ==============================
+//  LZ4 BLOCK CODEC
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read 4 bytes from a possibly unaligned address.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t Read32
+(
+    const uint8_t* ptr
+)
+{
+    uint32_t value;
+
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the extension bytes of a literal or match length that didn't fit in its token.
+ *
+ * @return Pointer to the byte after the extension.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* WriteLength
+(
+    uint8_t* outPtr,        ///< [IN] Where to write the extension bytes.
+    size_t length           ///< [IN] Length, minus the 15 counted in the token.
+)
+{
+    while (length >= 255)
+    {
+        *outPtr++ = 255;
+        length -= 255;
+    }
+    *outPtr++ = (uint8_t)length;
+
+    return outPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a sequence (literals, then a match if matchLength isn't 0).
+ *
+ * @return Pointer to the byte after the sequence.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* WriteSequence
+(
+    uint8_t* outPtr,            ///< [IN] Where to write the sequence.
+    const uint8_t* literalPtr,  ///< [IN] Literals.
+    size_t literalLength,       ///< [IN] Number of literals.
+    size_t offset,              ///< [IN] Match offset.
+    size_t matchLength          ///< [IN] Match length (0 for the last sequence).
+)
+{
+    uint8_t* tokenPtr = outPtr++;
+
+    *tokenPtr = (literalLength < 15 ? literalLength : 15) << 4;
+    if (literalLength >= 15)
+    {
+        outPtr = WriteLength(outPtr, literalLength - 15);
+    }
+
+    memcpy(outPtr, literalPtr, literalLength);
+    outPtr += literalLength;
+
+    if (matchLength != 0)
+    {
+        *outPtr++ = offset & 0xFF;
+        *outPtr++ = offset >> 8;
+
+        matchLength -= LZ4_MIN_MATCH;
+        *tokenPtr |= (matchLength < 15 ? matchLength : 15);
+        if (matchLength >= 15)
+        {
+            outPtr = WriteLength(outPtr, matchLength - 15);
+        }
+    }
+
+    return outPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress a buffer of at most 64 KiB into the LZ4 block format.
+ *
+ * @return Size of the compressed data, which is at most LZ4_BOUND(size).
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Lz4Compress
+(
+    const uint8_t* srcPtr,  ///< [IN] Data to compress.
+    size_t size,            ///< [IN] Number of bytes to compress.
+    uint8_t* destPtr        ///< [OUT] Compressed data.
+)
+{
+    uint16_t table[1 << LZ4_HASH_BITS];
+    const uint8_t* inPtr = srcPtr;
+    const uint8_t* anchorPtr = srcPtr;
+    uint8_t* outPtr = destPtr;
+
+    LE_ASSERT(size <= LZ4_MAX_OFFSET + 1);
+
+    if (size > LZ4_MF_LIMIT)
+    {
+        const uint8_t* matchLimitPtr = srcPtr + size - LZ4_LAST_LITERALS;
+        const uint8_t* mfLimitPtr = srcPtr + size - LZ4_MF_LIMIT;
+
+        memset(table, 0, sizeof(table));
+
+        while (inPtr <= mfLimitPtr)
+        {
+            uint32_t sequence = Read32(inPtr);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+            const uint8_t* refPtr = srcPtr + table[hash];
+
+            table[hash] = inPtr - srcPtr;
+
+            if ((refPtr >= inPtr) || (Read32(refPtr) != sequence))
+            {
+                // Take bigger steps through data that doesn't compress.
+                inPtr += 1 + ((inPtr - anchorPtr) >> 6);
+                continue;
+            }
+
+            const uint8_t* matchEndPtr = inPtr + LZ4_MIN_MATCH;
+            const uint8_t* refEndPtr = refPtr + LZ4_MIN_MATCH;
+            while ((matchEndPtr < matchLimitPtr) && (*matchEndPtr == *refEndPtr))
+            {
+                matchEndPtr++;
+                refEndPtr++;
+            }
+
+            while ((inPtr > anchorPtr) && (refPtr > srcPtr) && (inPtr[-1] == refPtr[-1]))
+            {
+                inPtr--;
+                refPtr--;
+            }
+
+            outPtr = WriteSequence(outPtr, anchorPtr, inPtr - anchorPtr, inPtr - refPtr,
+                                   matchEndPtr - inPtr);
+            inPtr = matchEndPtr;
+            anchorPtr = inPtr;
+        }
+    }
+
+    outPtr = WriteSequence(outPtr, anchorPtr, srcPtr + size - anchorPtr, 0, 0);
+
+    return outPtr - destPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the extension bytes of a literal or match length.
+ *
+ * @return false if the input ended first.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadLength
+(
+    const uint8_t** inPtrPtr,   ///< [IN,OUT] Input position.
+    const uint8_t* inEndPtr,    ///< [IN] End of the input.
+    size_t* lengthPtr           ///< [IN,OUT] Length to add the extension bytes to.
+)
+{
+    uint8_t byte;
+
+    do
+    {
+        if (*inPtrPtr >= inEndPtr)
+        {
+            return false;
+        }
+        byte = *(*inPtrPtr)++;
+        *lengthPtr += byte;
+    }
+    while (byte == 255);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress a block in the LZ4 block format, checking that it stays within its bounds (it's read
+ * from a file that may be corrupt).
+ *
+ * @return Size of the decompressed data, or -1 if the compressed data is malformed.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t Lz4Decompress
+(
+    const uint8_t* srcPtr,  ///< [IN] Compressed data.
+    size_t size,            ///< [IN] Size of the compressed data.
+    uint8_t* destPtr,       ///< [OUT] Decompressed data.
+    size_t destSize         ///< [IN] Size of the destination buffer.
+)
+{
+    const uint8_t* inPtr = srcPtr;
+    const uint8_t* inEndPtr = srcPtr + size;
+    uint8_t* outPtr = destPtr;
+    uint8_t* outEndPtr = destPtr + destSize;
+
+    while (inPtr < inEndPtr)
+    {
+        uint8_t token = *inPtr++;
+        size_t length = token >> 4;
+
+        if ((length == 15) && !ReadLength(&inPtr, inEndPtr, &length))
+        {
+            return -1;
+        }
+        if ((length > (size_t)(inEndPtr - inPtr)) || (length > (size_t)(outEndPtr - outPtr)))
+        {
+            return -1;
+        }
+        memcpy(outPtr, inPtr, length);
+        inPtr += length;
+        outPtr += length;
+
+        // The last sequence has no match.
+        if (inPtr == inEndPtr)
+        {
+            break;
+        }
+
+        if (inEndPtr - inPtr < 2)
+        {
+            return -1;
+        }
+        size_t offset = inPtr[0] | (inPtr[1] << 8);
+        inPtr += 2;
+        if ((offset == 0) || (offset > (size_t)(outPtr - destPtr)))
+        {
+            return -1;
+        }
+
+        length = token & 15;
+        if ((length == 15) && !ReadLength(&inPtr, inEndPtr, &length))
+        {
+            return -1;
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > (size_t)(outEndPtr - outPtr))
+        {
+            return -1;
+        }
+
+        // Byte by byte, as the match may overlap the bytes it's producing.
+        const uint8_t* matchPtr = outPtr - offset;
+        while (length-- > 0)
+        {
+            *outPtr++ = *matchPtr++;
+        }
+    }
+
+    return outPtr - destPtr;
+}
+
+
+// ==============================
+//  SEGMENTS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    const char* dirPath,    ///< [IN] Store directory.
+    int index,              ///< [IN] Segment index.
+    char* pathPtr,          ///< [OUT] Path.
+    size_t pathSize         ///< [IN] Size of the path buffer.
+)
+{
+    snprintf(pathPtr, pathSize, "%s/segment%d", dirPath, index);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a segment file for reading.
+ *
+ * @return The mapped file, or NULL if it doesn't exist or isn't a segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static const SegmentHeader_t* MapSegment
+(
+    const char* dirPath,    ///< [IN] Store directory.
+    int index               ///< [IN] Segment index.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    struct stat st;
+
+    GetSegmentPath(dirPath, index, path, sizeof(path));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return NULL;
+    }
+
+    void* mapPtr = MAP_FAILED;
+    if ((fstat(fd, &st) == 0) && (st.st_size == LOG_STORE_SEGMENT_BYTES))
+    {
+        mapPtr = mmap(NULL, LOG_STORE_SEGMENT_BYTES, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    fd_Close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    const SegmentHeader_t* headerPtr = mapPtr;
+    if ((headerPtr->magic != SEGMENT_MAGIC) || (headerPtr->version != SEGMENT_VERSION))
+    {
+        munmap(mapPtr, LOG_STORE_SEGMENT_BYTES);
+        return NULL;
+    }
+
+    return headerPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move on to the next segment file, emptying it.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenNextSegment
+(
+    void
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    if (SegmentPtr != NULL)
+    {
+        munmap(SegmentPtr, LOG_STORE_SEGMENT_BYTES);
+        SegmentPtr = NULL;
+    }
+
+    SegmentIndex = (SegmentIndex + 1) % LOG_STORE_SEGMENT_COUNT;
+    GetSegmentPath(DirPath, SegmentIndex, path, sizeof(path));
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP);
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to open log store segment '%s' (%m).", path);
+        return LE_FAULT;
+    }
+
+    void* mapPtr = MAP_FAILED;
+    if (ftruncate(fd, LOG_STORE_SEGMENT_BYTES) == 0)
+    {
+        mapPtr = mmap(NULL, LOG_STORE_SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map log store segment '%s' (%m).", path);
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+    fd_Close(fd);
+
+    // Take the old blocks out of the segment before giving it its new sequence number, so they're
+    // never seen as part of the new segment.
+    SegmentPtr = mapPtr;
+    __atomic_store_n(&SegmentPtr->seq, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&SegmentPtr->blockCount, 0, __ATOMIC_RELEASE);
+    SegmentPtr->magic = SEGMENT_MAGIC;
+    SegmentPtr->version = SEGMENT_VERSION;
+    SegmentPtr->dataEnd = sizeof(SegmentHeader_t);
+    __atomic_store_n(&SegmentPtr->seq, NextSeq++, __ATOMIC_RELEASE);
+
+    return LE_OK;
+}
+
+
+// ==============================
+//  PUBLIC API FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing into the log store in a directory.  New messages go into a new segment, after the
+ * most recent one already in the directory.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT if the directory can't be used (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Open
+(
+    const char* dirPath     ///< [IN] Directory holding the store.
+)
+{
+    if (le_utf8_Copy(DirPath, dirPath, sizeof(DirPath), NULL) != LE_OK)
+    {
+        LE_ERROR("Log store path '%s' is too long.", dirPath);
+        DirPath[0] = '\0';
+        return LE_FAULT;
+    }
+
+    // Carry on after the most recent segment.
+    int index;
+    for (index = 0; index < LOG_STORE_SEGMENT_COUNT; index++)
+    {
+        const SegmentHeader_t* headerPtr = MapSegment(dirPath, index);
+
+        if (headerPtr != NULL)
+        {
+            if (headerPtr->seq >= NextSeq)
+            {
+                NextSeq = headerPtr->seq + 1;
+                SegmentIndex = index;
+            }
+            munmap((void*)headerPtr, LOG_STORE_SEGMENT_BYTES);
+        }
+    }
+
+    if (OpenNextSegment() != LE_OK)
+    {
+        DirPath[0] = '\0';
+        return LE_FAULT;
+    }
+
+    LE_INFO("Storing logs in '%s'.", dirPath);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the log store.  Does nothing if the store isn't open.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Write
+(
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr      ///< [IN] Formatted message.
+)
+{
+    struct timespec now;
+    int i;
+
+    if (DirPath[0] == '\0')
+    {
+        return;
+    }
+
+    size_t length = strnlen(msgPtr, LOG_STORE_BLOCK_BYTES - MSG_HEADER_BYTES - 1);
+
+    if (BlockEntry.size + MSG_HEADER_BYTES + length + 1 > sizeof(Block))
+    {
+        logStore_Flush();
+    }
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t timeMs = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+
+    uint8_t* msgStartPtr = Block + BlockEntry.size;
+    for (i = 0; i < 8; i++)
+    {
+        msgStartPtr[i] = timeMs >> (8 * i);
+    }
+    msgStartPtr[8] = (int8_t)level;
+    memcpy(msgStartPtr + MSG_HEADER_BYTES, msgPtr, length);
+    msgStartPtr[MSG_HEADER_BYTES + length] = '\0';
+
+    // The clock may be set back, so the messages aren't always in time order.
+    if ((BlockEntry.size == 0) || (timeMs < BlockEntry.minMs))
+    {
+        BlockEntry.minMs = timeMs;
+    }
+    if (timeMs > BlockEntry.maxMs)
+    {
+        BlockEntry.maxMs = timeMs;
+    }
+    BlockEntry.levelMask |= LOG_STORE_LEVEL_BIT(level);
+    BlockEntry.size += MSG_HEADER_BYTES + length + 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the messages added since the last block was written into a block of their own, so
+ * that they can be read out of the store.  Does nothing if there are none.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Flush
+(
+    void
+)
+{
+    if (BlockEntry.size == 0)
+    {
+        return;
+    }
+
+    size_t compressedSize = Lz4Compress(Block, BlockEntry.size, CodecBuffer);
+
+    if (   (SegmentPtr == NULL)
+        || (SegmentPtr->blockCount == MAX_BLOCKS)
+        || (SegmentPtr->dataEnd + compressedSize > LOG_STORE_SEGMENT_BYTES))
+    {
+        if (OpenNextSegment() != LE_OK)
+        {
+            // Drop these messages; the next block will try another segment.
+            memset(&BlockEntry, 0, sizeof(BlockEntry));
+            return;
+        }
+    }
+
+    // Write the block and its index entry, and only then count it.
+    uint32_t blockCount = SegmentPtr->blockCount;
+
+    BlockEntry.offset = SegmentPtr->dataEnd;
+    BlockEntry.compressedSize = compressedSize;
+    memcpy((uint8_t*)SegmentPtr + BlockEntry.offset, CodecBuffer, compressedSize);
+    SegmentPtr->blocks[blockCount] = BlockEntry;
+    SegmentPtr->dataEnd += compressedSize;
+    __atomic_store_n(&SegmentPtr->blockCount, blockCount + 1, __ATOMIC_RELEASE);
+
+    memset(&BlockEntry, 0, sizeof(BlockEntry));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two mapped segments by sequence number, for qsort().
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareSegments
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    uint64_t a = ((const MappedSegment_t*)aPtr)->seq;
+    uint64_t b = ((const MappedSegment_t*)bPtr)->seq;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a handler for each message in a block that is in a given time range and has one of a
+ * given set of severity levels.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadBlock
+(
+    const SegmentHeader_t* headerPtr,   ///< [IN] Segment holding the block.
+    const BlockEntry_t* entryPtr,       ///< [IN] Index entry of the block.
+    uint64_t startMs,                   ///< [IN] Earliest time of the messages to read.
+    uint64_t endMs,                     ///< [IN] Latest time of the messages to read.
+    uint32_t levelMask,                 ///< [IN] LOG_STORE_LEVEL_BIT() of each level to read.
+    logStore_MsgHandler_t handler,      ///< [IN] Function to call for each message.
+    void* contextPtr                    ///< [IN] Context pointer to pass to the handler.
+)
+{
+    if (   (entryPtr->offset < sizeof(SegmentHeader_t))
+        || (entryPtr->offset > LOG_STORE_SEGMENT_BYTES)
+        || (entryPtr->compressedSize > LOG_STORE_SEGMENT_BYTES - entryPtr->offset))
+    {
+        LE_WARN("Skipping corrupt log store block.");
+        return;
+    }
+
+    ssize_t size = Lz4Decompress((const uint8_t*)headerPtr + entryPtr->offset,
+                                 entryPtr->compressedSize,
+                                 CodecBuffer,
+                                 sizeof(CodecBuffer));
+    if (size < 0)
+    {
+        LE_WARN("Skipping corrupt log store block.");
+        return;
+    }
+
+    const uint8_t* msgStartPtr = CodecBuffer;
+    const uint8_t* endPtr = CodecBuffer + size;
+
+    while (endPtr - msgStartPtr > MSG_HEADER_BYTES)
+    {
+        const char* msgPtr = (const char*)msgStartPtr + MSG_HEADER_BYTES;
+        size_t length = strnlen(msgPtr, endPtr - (const uint8_t*)msgPtr);
+        if (msgPtr + length == (const char*)endPtr)
+        {
+            // Not null-terminated.
+            break;
+        }
+
+        uint64_t timeMs = 0;
+        int i;
+        for (i = 0; i < 8; i++)
+        {
+            timeMs |= (uint64_t)msgStartPtr[i] << (8 * i);
+        }
+        le_log_Level_t level = (int8_t)msgStartPtr[8];
+
+        if (   (timeMs >= startMs)
+            && (timeMs <= endMs)
+            && ((levelMask & LOG_STORE_LEVEL_BIT(level)) != 0))
+        {
+            handler(timeMs, level, msgPtr, contextPtr);
+        }
+
+        msgStartPtr = (const uint8_t*)msgPtr + length + 1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the messages in a log store, oldest first, that were stored in a given time range and
+ * have one of a given set of severity levels.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if there is no log store in the directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Read
+(
+    const char* dirPath,            ///< [IN] Directory holding the store.
+    uint64_t startMs,               ///< [IN] Earliest time of the messages to read.
+    uint64_t endMs,                 ///< [IN] Latest time of the messages to read.
+    uint32_t levelMask,             ///< [IN] LOG_STORE_LEVEL_BIT() of each level to read.
+    logStore_MsgHandler_t handler,  ///< [IN] Function to call for each message.
+    void* contextPtr                ///< [IN] Context pointer to pass to the handler.
+)
+{
+    MappedSegment_t segments[LOG_STORE_SEGMENT_COUNT];
+    size_t segmentCount = 0;
+    size_t i;
+
+    for (i = 0; i < LOG_STORE_SEGMENT_COUNT; i++)
+    {
+        const SegmentHeader_t* headerPtr = MapSegment(dirPath, i);
+
+        if (headerPtr != NULL)
+        {
+            segments[segmentCount].headerPtr = headerPtr;
+            segments[segmentCount].seq = __atomic_load_n(&headerPtr->seq, __ATOMIC_ACQUIRE);
+            segmentCount++;
+        }
+    }
+
+    if (segmentCount == 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    qsort(segments, segmentCount, sizeof(segments[0]), CompareSegments);
+
+    for (i = 0; i < segmentCount; i++)
+    {
+        const SegmentHeader_t* headerPtr = segments[i].headerPtr;
+        uint32_t blockCount = __atomic_load_n(&headerPtr->blockCount, __ATOMIC_ACQUIRE);
+        uint32_t block;
+
+        // A segment that's being reset has no messages yet.
+        if (segments[i].seq == 0)
+        {
+            blockCount = 0;
+        }
+        if (blockCount > MAX_BLOCKS)
+        {
+            blockCount = MAX_BLOCKS;
+        }
+
+        // Only decompress the blocks whose index entries say they may hold messages we want.
+        for (block = 0; block < blockCount; block++)
+        {
+            const BlockEntry_t* entryPtr = &headerPtr->blocks[block];
+
+            if (   (entryPtr->maxMs >= startMs)
+                && (entryPtr->minMs <= endMs)
+                && ((entryPtr->levelMask & levelMask) != 0))
+            {
+                ReadBlock(headerPtr, entryPtr, startMs, endMs, levelMask, handler, contextPtr);
+            }
+        }
+
+        munmap((void*)headerPtr, LOG_STORE_SEGMENT_BYTES);
+    }
+
+    return LE_OK;
+}
@@ -0,0 +1,147 @@
+/** @file logStore.h
+ *
+ * Compressed on-target log store.  Written by the Log Control Daemon, read by the log tool.
+ *
+ * If the directory LOG_STORE_DIR exists when the Log Control Daemon starts, the daemon keeps a
+ * copy of the messages it passes on from the log rings in a fixed set of LOG_STORE_SEGMENT_COUNT
+ * segment files in that directory, each LOG_STORE_SEGMENT_BYTES long, so the store never takes
+ * up more flash than that.  When the last segment is full, the oldest one is reused.
+ *
+ * Each segment file is memory-mapped by the writer.  It starts with a header holding the
+ * segment's sequence number and an index of the blocks in the segment, followed by the blocks
+ * themselves.  A block is up to LOG_STORE_BLOCK_BYTES of messages, compressed using the LZ4 block
+ * format.  Each message in a block is stored as its time (milliseconds since the Epoch, 64 bits,
+ * little-endian), one byte holding its severity level, and the message text with a null
+ * terminator.  Each index entry holds the earliest and latest times of the messages in its block
+ * and a bit mask of the severity levels found in it (see LOG_STORE_LEVEL_BIT()), so a reader can
+ * skip the blocks that can't hold the messages it wants without decompressing them.
+ *
+ * The writer fills in a block and its index entry before counting it in the segment's header,
+ * so a reader (or a writer restarted after a crash) never sees a block that's only partly there.
+ * Messages are collected in memory until a block is full or logStore_Flush() is called, so the
+ * last few seconds of messages are not in the store yet if the Log Control Daemon dies (they are
+ * in the system log anyway).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LOG_STORE_INCLUDE_GUARD
+#define LOG_STORE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory holding the log store.  The store is only written if this exists.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_DIR                   "/legato/logStore"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of segment files in the store.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_SEGMENT_COUNT         8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of each segment file, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_SEGMENT_BYTES         (256 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of messages in a block, before compression.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_BLOCK_BYTES           (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit for a severity level (-1 for a trace) in a level mask.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_LEVEL_BIT(level)      (1u << ((level) + 1))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the functions that are called for each message read out of the log store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logStore_MsgHandler_t)
+(
+    uint64_t timeMs,        ///< [IN] Time at which the message was stored (ms since the Epoch).
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr,     ///< [IN] Formatted message.
+    void* contextPtr        ///< [IN] Context pointer passed to logStore_Read().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing into the log store in a directory.  New messages go into a new segment, after the
+ * most recent one already in the directory.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT if the directory can't be used (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Open
+(
+    const char* dirPath     ///< [IN] Directory holding the store.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the log store.  Does nothing if the store isn't open.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Write
+(
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr      ///< [IN] Formatted message.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the messages added since the last block was written into a block of their own, so
+ * that they can be read out of the store.  Does nothing if there are none.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Flush
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the messages in a log store, oldest first, that were stored in a given time range and
+ * have one of a given set of severity levels.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if there is no log store in the directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Read
+(
+    const char* dirPath,            ///< [IN] Directory holding the store.
+    uint64_t startMs,               ///< [IN] Earliest time of the messages to read.
+    uint64_t endMs,                 ///< [IN] Latest time of the messages to read.
+    uint32_t levelMask,             ///< [IN] LOG_STORE_LEVEL_BIT() of each level to read.
+    logStore_MsgHandler_t handler,  ///< [IN] Function to call for each message.
+    void* contextPtr                ///< [IN] Context pointer to pass to the handler.
+);
+
+
+#endif // LOG_STORE_INCLUDE_GUARD
@@ -40,11 +40,15 @@ typedef enum
 
     LE_SDTP_MSGID_LIST_JSON,        ///< Same as LE_SDTP_MSGID_LIST, but the output in json format.
 
-    LE_SDTP_MSGID_UNBIND_ALL,       ///< Delete all bindings (This message has no payload).
+    LE_SDTP_MSGID_UNBIND_ALL,       ///< Delete all bindings, then re-create the built-in ones and
+                                    ///  those of the system's binding table (This message has
+                                    ///  no payload).
 
     LE_SDTP_MSGID_BIND,             ///< Create one binding.  The payload is the binding details.
                                     ///  If the Service Directory runs into an error, it will
                                     ///  drop the connection to the sdir tool without responding.
+    LE_SDTP_MSGID_UNBIND,           ///< Delete one binding, if it exists.  The payload is the
+                                    ///  client and client interface name of the binding.
 }
 le_sdtp_MsgType_t;
 
@@ -75,8 +75,10 @@ User List ------> User --+---> Name               |        |        |
  *  - list of services that it offers, and
  *  - list of client connections that are waiting for a binding to be created for them.
  *
- * Binding objects are created for bindings that appear in the configuration data.  The 'sdir' tool
- * is in charge of reading the configuration data and pushing updates to the Service Directory.
+ * Binding objects are created for bindings that appear in the configuration data.  At start-up,
+ * the Service Directory creates the bindings of the current system's binding table (generated by
+ * mksys, see bindingTable.h) in one pass.  The 'sdir' tool is in charge of reading the
+ * configuration data and pushing the differences from that table to the Service Directory.
  * The Service Directory creates and deletes Binding objects in response to messages received from
  * the 'sdir' tool.  Each Binding object has a list of client connections that match that binding
  * but are waiting for the server to advertise the service.
@@ -98,6 +100,20 @@ User List ------> User --+---> Name               |        |        |
  * Each Binding object and Connection object holds a reference count on a User object.  A User
  * object will be deleted when all associated Binding objects and Connection objects are deleted.
  *
+ * So that opening a session doesn't require searching through the lists, the objects are also
+ * indexed by hash maps:
+ *  - the User Map finds a User object from its user ID,
+ *  - the Binding Map finds a Binding object from its client User and client interface name,
+ *  - the Service Map finds a (advertised) Server Connection from its User and service name, and
+ *  - the Service Bindings Map finds, from a server User and service name, a Service Bindings
+ *    object, which holds the list of all the Binding objects that refer to that service.
+ *    It is deleted when the last of those Binding objects is deleted.
+ *
+ * Each Binding object also has a list of the Direct Channels that were created through it (see
+ * @ref serviceDirectoryProtocol_DirectChannels).  A Direct Channel object holds the Service
+ * Directory's copy of the server's end of the channel, so that the channel can be revoked when
+ * the Binding is deleted or the server that the channel goes to disconnects.
+ *
  *
  * @section sd_theoryOfOperation Theory of Operation
  *
@@ -114,10 +130,10 @@ User List ------> User --+---> Name               |        |        |
  * object is not found for that service name on that User, the new one is is added to the list.
  * Otherwise, the new server connection is dropped.
  *
- * When a new Server Connection is added to a Service List, all users' Binding Lists are
- * searched for matching bindings, and if any that match have non-empty Waiting Clients Lists,
- * all those Client Connections are removed from those lists and dispatched to the new Server
- * Connection.
+ * When a new Server Connection is added to a Service List, the bindings that refer to that service
+ * are found through its Service Bindings object, and if any of them have non-empty Waiting Clients
+ * Lists, all those Client Connections are removed from those lists and dispatched to the new
+ * Server Connection.
  *
  * When a Binding is added, it is added to the client's User object's Binding List.  That user's
  * Unbound Clients List will then be checked for matches to the new binding, and if any are found,
@@ -206,6 +222,7 @@ User List ------> User --+---> Name               |        |        |
 #include "fileDescriptor.h"
 #include "limit.h"
 #include "user.h"
+#include "bindingTable.h"
 
 // =======================================
 //  PRIVATE DATA
@@ -220,6 +237,15 @@ User List ------> User --+---> Name               |        |        |
 #define MAX_CONNECT_REQUEST_BACKLOG 100
 
 
+//--------------------------------------------------------------------------------------------------
+/// The number of users, services and bindings expected.  Used to size the pools and hash maps.
+/// @todo Make this configurable.
+//--------------------------------------------------------------------------------------------------
+#define MAX_EXPECTED_USERS      30
+#define MAX_EXPECTED_SERVICES   30
+#define MAX_EXPECTED_BINDINGS   30
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a user.  Objects of this type are allocated from the User Pool and are kept on the
@@ -250,6 +276,45 @@ static le_mem_PoolRef_t UserPoolRef;
 static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/// The User Map, in which all User objects are kept, keyed by user ID.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t UserMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the objects that are looked up by user and interface name (see InterfaceKeyHash()).
+ * The key is kept inside the object itself.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const User_t*   userPtr;            ///< Ptr to the User object.
+    const char*     namePtr;            ///< Ptr to the interface name (inside the object).
+}
+InterfaceKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// The Service Map, keyed by (server User, service name).  Holds advertised Server Connections.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ServiceMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/// The Binding Map, keyed by (client User, client interface name).  Holds all Binding objects.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BindingMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/// The Service Bindings Map, keyed by (server User, service name).  Holds all Service Bindings
+/// objects.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ServiceBindingsMapRef;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -260,6 +325,7 @@ static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 typedef struct
 {
     le_dls_Link_t               link;           ///< Used to link onto user's Service List.
+    InterfaceKey_t              key;            ///< Key in the Service Map.
     int                         fd;             ///< Fd of the connection socket.
     le_fdMonitor_Ref_t          fdMonitorRef;   ///< FD Monitor object monitoring this connection.
     User_t*                     userPtr;        ///< Pointer to the User object for the client uid.
@@ -275,6 +341,28 @@ ServerConnection_t;
 static le_mem_PoolRef_t ServerConnectionPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keeps track of all the bindings that refer to a given service.  Objects of this type are
+ * allocated from the Service Bindings Pool and are kept in the Service Bindings Map.  They exist
+ * for as long as at least one Binding refers to the service, whether it is advertised or not.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    InterfaceKey_t  key;                ///< Key in the Service Bindings Map.
+    char            serviceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];   ///< Service name.
+    le_dls_List_t   bindingList;        ///< List of Bindings that refer to this service.
+}
+ServiceBindings_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Pool from which Service Bindings objects are allocated.
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ServiceBindingsPoolRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a binding from a user's client interface to a service.  Objects of this type are
@@ -284,12 +372,16 @@ static le_mem_PoolRef_t ServerConnectionPoolRef;
 typedef struct
 {
     le_dls_Link_t       link;               ///< Used to link into the User's Binding List.
+    InterfaceKey_t      key;                ///< Key in the Binding Map.
+    le_dls_Link_t       serviceLink;        ///< Used to link into the Service Bindings' list.
+    ServiceBindings_t*  serviceBindingsPtr; ///< Ptr to the Service Bindings whose list I'm in.
     User_t*             clientUserPtr;      ///< Ptr to the client User whose Binding List I'm in.
     User_t*             serverUserPtr;      ///< Ptr to the User who serves the service.
     char                clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Client I/F name
     char                serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Service name
     ServerConnection_t* serverConnectionPtr;///< Ptr to Server Connection (NULL if service unavail.)
     le_dls_List_t       waitingClientsList; ///< List of Client Connections waiting for the service.
+    le_dls_List_t       directChannelList;  ///< List of Direct Channels created through me.
 }
 Binding_t;
 
@@ -300,6 +392,29 @@ Binding_t;
 static le_mem_PoolRef_t BindingPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Represents a Direct Channel between a client and a server.  Objects of this type are allocated
+ * from the Direct Channel Pool and are kept on the Direct Channel List of the Binding through
+ * which they were created.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;               ///< Used to link into the Binding's list.
+    Binding_t*          bindingPtr;         ///< Ptr to the Binding whose list I'm in.
+    int                 fd;                 ///< Our copy of the server's end of the channel.
+    le_fdMonitor_Ref_t  fdMonitorRef;       ///< FD Monitor object watching for the client hang-up.
+}
+DirectChannel_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Pool from which Direct Channel objects are allocated.
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirectChannelPoolRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumeration of the different states that a client connection can be in.
@@ -330,6 +445,7 @@ typedef struct
     pid_t                   pid;            ///< Process ID of client process.
     svcdir_InterfaceDetails_t interface;    ///< Interface details (protocol & interface name)
     Binding_t*              bindingPtr;     ///< Ptr to Binding whose Waiting Clients List we are on
+    int                     directChannelFd;///< Fd of the Direct Channel requested (-1 if none).
 }
 ClientConnection_t;
 
@@ -370,6 +486,47 @@ static le_fdMonitor_Ref_t ServerSocketMonitorRef;
 // =======================================
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash computation function for interface keys.
+ *
+ * @return  The hash value computed from an InterfaceKey_t.
+ **/
+//--------------------------------------------------------------------------------------------------
+static size_t InterfaceKeyHash
+(
+    const void* hashKeyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* keyPtr = hashKeyPtr;
+
+    return le_hashmap_HashString(keyPtr->namePtr) ^ ((size_t)keyPtr->userPtr >> 3);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality comparison function for interface keys.
+ *
+ * @return  true = the two keys have the same user and interface name.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool InterfaceKeyEquals
+(
+    const void* hashKey1Ptr,
+    const void* hashKey2Ptr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* key1Ptr = hashKey1Ptr;
+    const InterfaceKey_t* key2Ptr = hashKey2Ptr;
+
+    return (   (key1Ptr->userPtr == key2Ptr->userPtr)
+            && (strcmp(key1Ptr->namePtr, key2Ptr->namePtr) == 0) );
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a User object for a given Unix user ID.
@@ -399,8 +556,9 @@ static User_t* CreateUser
     userPtr->serviceList = LE_DLS_LIST_INIT;
     userPtr->unboundClientsList = LE_DLS_LIST_INIT;
 
-    // Add it to the User List.
+    // Add it to the User List and the User Map.
     le_dls_Queue(&UserList, &userPtr->link);
+    le_hashmap_Put(UserMapRef, &userPtr->uid, userPtr);
 
     return userPtr;
 }
@@ -408,7 +566,7 @@ static User_t* CreateUser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches the User List for a particular Unix user ID.  If found, increments the reference count
+ * Looks up a particular Unix user ID in the User Map.  If found, increments the reference count
  * on that object.  If not found, creates a new User object.
  *
  * @return Pointer to the User object.
@@ -420,19 +578,12 @@ static User_t* GetUser
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&UserList);
+    User_t* userPtr = le_hashmap_Get(UserMapRef, &uid);
 
-    while (linkPtr != NULL)
+    if (userPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(linkPtr, User_t, link);
-
-        if (userPtr->uid == uid)
-        {
-            le_mem_AddRef(userPtr);
-            return userPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&UserList, linkPtr);
+        le_mem_AddRef(userPtr);
+        return userPtr;
     }
 
     return CreateUser(uid);
@@ -453,14 +604,15 @@ static void UserDestructor
 {
     User_t* userPtr = objPtr;
 
-    // Remove the User object from the User List.
+    // Remove the User object from the User List and the User Map.
     le_dls_Remove(&UserList, &userPtr->link);
+    le_hashmap_Remove(UserMapRef, &userPtr->uid);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a (client) User's Binding List for a particular client-side interface name.
+ * Looks up a (client) User's binding for a particular client-side interface name.
  *
  * @return Pointer to the Binding object or NULL if not found.
  **/
@@ -472,21 +624,29 @@ static Binding_t* FindBinding
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->bindingList);
+    InterfaceKey_t key = { .userPtr = userPtr, .namePtr = interfaceName };
 
-    while (linkPtr != NULL)
-    {
-        Binding_t* bindingPtr = CONTAINER_OF(linkPtr, Binding_t, link);
+    return le_hashmap_Get(BindingMapRef, &key);
+}
 
-        if (strcmp(bindingPtr->clientInterfaceName, interfaceName) == 0)
-        {
-            return bindingPtr;
-        }
 
-        linkPtr = le_dls_PeekNext(&userPtr->bindingList, linkPtr);
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the Service Bindings object for a particular service.
+ *
+ * @return Pointer to the Service Bindings object or NULL if no binding refers to the service.
+ **/
+//--------------------------------------------------------------------------------------------------
+static ServiceBindings_t* FindServiceBindings
+(
+    const User_t* userPtr,      ///< [in] Pointer to the server's User object.
+    const char* serviceName     ///< [in] Service name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    InterfaceKey_t key = { .userPtr = userPtr, .namePtr = serviceName };
 
-    return NULL;
+    return le_hashmap_Get(ServiceBindingsMapRef, &key);
 }
 
 
@@ -568,13 +728,25 @@ static le_result_t ReceiveMessage
 (
     int      fd,        ///< [in] File descriptor to receive the message from.
     void*    msgPtr,    ///< [out] Ptr to where the message will be stored if successful.
-    size_t   msgSize    ///< [in] Size of the message to be received.
+    size_t   msgSize,   ///< [in] Size of the message to be received.
+    int*     fdPtr      ///< [out] Ptr to where a file descriptor received along with the message
+                        ///        will be stored (-1 if none), or NULL if none is expected.
 )
 //--------------------------------------------------------------------------------------------------
 {
     size_t byteCount = msgSize;
 
-    le_result_t result = unixSocket_ReceiveDataMsg(fd, msgPtr, &byteCount);
+    le_result_t result = unixSocket_ReceiveMsg(fd, msgPtr, &byteCount, fdPtr, NULL);
+
+    // Don't leak a file descriptor that came with a bad message.
+    if ((result != LE_OK) || (byteCount != msgSize))
+    {
+        if ((fdPtr != NULL) && (*fdPtr >= 0))
+        {
+            fd_Close(*fdPtr);
+            *fdPtr = -1;
+        }
+    }
 
     if (result == LE_FAULT)
     {
@@ -597,9 +769,9 @@ static le_result_t ReceiveMessage
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a User's Service List for a particular service name.
+ * Looks up a particular service name among the services served up by a User.
  *
- * @return Pointer to the Server Connection object for the matching service.
+ * @return Pointer to the Server Connection object for the matching service, or NULL if not found.
  **/
 //--------------------------------------------------------------------------------------------------
 static ServerConnection_t* FindService
@@ -609,21 +781,9 @@ static ServerConnection_t* FindService
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->serviceList);
-
-    while (linkPtr != NULL)
-    {
-        ServerConnection_t* serverConnectionPtr = CONTAINER_OF(linkPtr, ServerConnection_t, link);
-
-        if (strcmp(serverConnectionPtr->interface.interfaceName, serviceName) == 0)
-        {
-            return serverConnectionPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&userPtr->serviceList, linkPtr);
-    }
+    InterfaceKey_t key = { .userPtr = userPtr, .namePtr = serviceName };
 
-    return NULL;
+    return le_hashmap_Get(ServiceMapRef, &key);
 }
 
 
@@ -673,6 +833,155 @@ static bool IsDuplicateService
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a Direct Channel object, closing our copy of the server's end of the channel.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteDirectChannel
+(
+    DirectChannel_t* channelPtr,
+    bool shouldRevoke   ///< [in] true = shut the channel down, so the server and client drop it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&channelPtr->bindingPtr->directChannelList, &channelPtr->link);
+
+    le_fdMonitor_Delete(channelPtr->fdMonitorRef);
+
+    // NOTE: Closing our copy wouldn't affect the copy held by the server, but shutting down the
+    //       socket does.
+    if (shouldRevoke && (shutdown(channelPtr->fd, SHUT_RDWR) != 0))
+    {
+        LE_ERROR("Failed to shut down Direct Channel. Errno = %d (%m).", errno);
+    }
+
+    fd_Close(channelPtr->fd);
+
+    le_mem_Release(channelPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Revokes all the Direct Channels that were created through a given Binding.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RevokeDirectChannels
+(
+    Binding_t* bindingPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Peek(&bindingPtr->directChannelList)))
+    {
+        DeleteDirectChannel(CONTAINER_OF(linkPtr, DirectChannel_t, link), true /* shouldRevoke */);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File descriptor event handler for our copies of the server ends of Direct Channels.
+ *
+ * We never read from these, so this only gets called when the client closes its end.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DirectChannelSocketHandler
+(
+    int fd,
+    short events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DirectChannel_t* channelPtr = le_fdMonitor_GetContextPtr();
+
+    LE_DEBUG("Client closed Direct Channel <%s>.%s.",
+             channelPtr->bindingPtr->clientUserPtr->name,
+             channelPtr->bindingPtr->clientInterfaceName);
+
+    DeleteDirectChannel(channelPtr, false /* shouldRevoke */);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a file descriptor received from a client is a Unix domain sequenced-packet socket
+ * that could be used as a Direct Channel.
+ *
+ * @return true if it is.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsValidDirectChannel
+(
+    int fd
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int domain;
+    int type;
+    socklen_t domainSize = sizeof(domain);
+    socklen_t typeSize = sizeof(type);
+
+    return (   (getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &domain, &domainSize) == 0)
+            && (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &typeSize) == 0)
+            && (domain == AF_UNIX)
+            && (type == SOCK_SEQPACKET) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the Direct Channel requested by a client connection to a server and creates a Direct
+ * Channel object to keep track of it.
+ *
+ * @return  LE_OK if successful, or the result code of the failed send to the server otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendDirectChannel
+(
+    ClientConnection_t* clientConnectionPtr, ///< [in] Client connection with a channel to send.
+    ServerConnection_t* serverConnectionPtr  ///< [in] Server connection to send the channel to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    svcdir_DirectChannelMsg_t msg = { .magic = SVCDIR_DIRECT_CHANNEL_MAGIC };
+
+    le_result_t result = unixSocket_SendMsg(serverConnectionPtr->fd,
+                                            &msg,
+                                            sizeof(msg),
+                                            clientConnectionPtr->directChannelFd,
+                                            false); // sendCredentials
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    DirectChannel_t* channelPtr = le_mem_ForceAlloc(DirectChannelPoolRef);
+
+    channelPtr->link = LE_DLS_LINK_INIT;
+    channelPtr->bindingPtr = clientConnectionPtr->bindingPtr;
+    channelPtr->fd = clientConnectionPtr->directChannelFd;
+    clientConnectionPtr->directChannelFd = -1;
+
+    char fdMonName[64];  // Buffer for holding the FD Monitor's name string.
+
+    snprintf(fdMonName, sizeof(fdMonName), "Direct:fd%dpid%d",
+             channelPtr->fd, clientConnectionPtr->pid);
+    channelPtr->fdMonitorRef = le_fdMonitor_Create(fdMonName,
+                                                   channelPtr->fd,
+                                                   DirectChannelSocketHandler,
+                                                   POLLRDHUP);
+    le_fdMonitor_SetContextPtr(channelPtr->fdMonitorRef, channelPtr);
+
+    le_dls_Queue(&channelPtr->bindingPtr->directChannelList, &channelPtr->link);
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Dispatch a client connection to a server connection.
@@ -738,12 +1047,24 @@ static le_result_t DispatchToServer
 
     else
     {
+        le_result_t result = LE_OK;
+
+        // If the client asked for a Direct Channel, send it to the server first, so the server
+        // has it by the time the client gets the welcome message.
+        if (clientConnectionPtr->directChannelFd >= 0)
+        {
+            result = SendDirectChannel(clientConnectionPtr, serverConnectionPtr);
+        }
+
         // Send the client connection fd to the server.
-        le_result_t result = unixSocket_SendMsg(serverConnectionPtr->fd,
-                                                NULL,   // dataPtr
-                                                0,      // dataSize
-                                                clientConnectionPtr->fd, // fdToSend
-                                                false); // sendCredentials
+        if (result == LE_OK)
+        {
+            result = unixSocket_SendMsg(serverConnectionPtr->fd,
+                                        NULL,   // dataPtr
+                                        0,      // dataSize
+                                        clientConnectionPtr->fd, // fdToSend
+                                        false); // sendCredentials
+        }
 
         if (result == LE_OK)
         {
@@ -916,9 +1237,31 @@ static void CreateBinding
 
     bindingPtr->serverConnectionPtr = NULL;
     bindingPtr->waitingClientsList = LE_DLS_LIST_INIT;
+    bindingPtr->directChannelList = LE_DLS_LIST_INIT;
 
-    // Add the Binding to the client User's Binding List.
+    // Add the Binding to the client User's Binding List and to the Binding Map.
     le_dls_Queue(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    bindingPtr->key.userPtr = clientUserPtr;
+    bindingPtr->key.namePtr = bindingPtr->clientInterfaceName;
+    le_hashmap_Put(BindingMapRef, &bindingPtr->key, bindingPtr);
+
+    // Add the Binding to the list of Bindings that refer to its service.
+    ServiceBindings_t* serviceBindingsPtr = FindServiceBindings(serverUserPtr, serverInterfaceName);
+    if (serviceBindingsPtr == NULL)
+    {
+        serviceBindingsPtr = le_mem_ForceAlloc(ServiceBindingsPoolRef);
+        le_utf8_Copy(serviceBindingsPtr->serviceName,
+                     serverInterfaceName,
+                     sizeof(serviceBindingsPtr->serviceName),
+                     NULL);
+        serviceBindingsPtr->key.userPtr = serverUserPtr;
+        serviceBindingsPtr->key.namePtr = serviceBindingsPtr->serviceName;
+        serviceBindingsPtr->bindingList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(ServiceBindingsMapRef, &serviceBindingsPtr->key, serviceBindingsPtr);
+    }
+    bindingPtr->serviceLink = LE_DLS_LINK_INIT;
+    bindingPtr->serviceBindingsPtr = serviceBindingsPtr;
+    le_dls_Queue(&serviceBindingsPtr->bindingList, &bindingPtr->serviceLink);
 
     // Look for a server serving the binding's destination service.
     bindingPtr->serverConnectionPtr = FindService(bindingPtr->serverUserPtr, serverInterfaceName);
@@ -974,6 +1317,8 @@ static void CreateHardCodedBindings
     CreateBinding(uid, "le_instStat", uid, "le_instStat");
     CreateBinding(uid, "le_appInfo", uid, "le_appInfo");
     CreateBinding(uid, "le_appProc", uid, "le_appProc");
+    CreateBinding(uid, "le_appStats", uid, "le_appStats");
+    CreateBinding(uid, "le_memPressure", uid, "le_memPressure");
     CreateBinding(uid, "appSmack", uid, "appSmack");
     CreateBinding(uid, "logFd", uid, "logFd");
 
@@ -982,6 +1327,69 @@ static void CreateHardCodedBindings
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the bindings of the current system's binding table, if it has one.
+ *
+ * The bindings are sorted by client user, so the client's user ID is only looked up once per user.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void CreateTableBindings
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bindingTable_Ref_t tableRef = bindingTable_Load(BINDING_TABLE_FILE_PATH);
+
+    if (tableRef == NULL)
+    {
+        return;
+    }
+
+    size_t count = bindingTable_GetCount(tableRef);
+    const char* clientUserPtr = NULL;
+    le_result_t clientResult = LE_FAULT;
+    uid_t clientUid = 0;
+    size_t numCreated = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        bindingTable_Binding_t binding;
+        uid_t serverUid;
+
+        bindingTable_Get(tableRef, i, &binding);
+
+        if ((clientUserPtr == NULL) || (strcmp(clientUserPtr, binding.clientUserPtr) != 0))
+        {
+            clientUserPtr = binding.clientUserPtr;
+            clientResult = user_GetUid(clientUserPtr, &clientUid);
+        }
+
+        // Users of apps that are not installed (yet) have no user ID.  Their bindings are
+        // created by "sdir load" when they are installed.
+        if (clientResult != LE_OK)
+        {
+            LE_DEBUG("Skipping binding of unknown client user '%s'.", clientUserPtr);
+            continue;
+        }
+        if (user_GetUid(binding.serverUserPtr, &serverUid) != LE_OK)
+        {
+            LE_DEBUG("Skipping binding to unknown server user '%s'.", binding.serverUserPtr);
+            continue;
+        }
+
+        CreateBinding(clientUid, binding.clientIfPtr, serverUid, binding.serverIfPtr);
+        numCreated++;
+    }
+
+    bindingTable_Unload(tableRef);
+
+    LE_INFO("Created %zu of the %zu bindings of the binding table.", numCreated, count);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Search for and associate bindings that refer to this service and dispatch any
@@ -994,51 +1402,43 @@ static void ResolveBindingsToServer
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+    ServiceBindings_t* serviceBindingsPtr =
+        FindServiceBindings(connectionPtr->userPtr, connectionPtr->interface.interfaceName);
+    if (serviceBindingsPtr == NULL)
+    {
+        // No binding refers to this service.
+        return;
+    }
 
-    while (userLinkPtr != NULL)
+    // For each of the bindings that are pointing at the new server's service,
+    le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&serviceBindingsPtr->bindingList);
+    while (bindingLinkPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+        Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, serviceLink);
 
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
-        {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+        bindingPtr->serverConnectionPtr = connectionPtr;
 
-            // If the binding is pointing at the new server's service,
-            if (   (connectionPtr->userPtr == bindingPtr->serverUserPtr)
-                && (0 == strcmp(connectionPtr->interface.interfaceName,
-                                bindingPtr->serverInterfaceName))  )
+        // While there's still a client connection on the Waiting Clients List, get
+        // a pointer to the first one, without removing it from the list, then try
+        // to dispatch that client to the server.
+        le_dls_Link_t* clientLinkPtr;
+        while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
+        {
+            ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                   ClientConnection_t,
+                                                                   link);
+            if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
             {
-                bindingPtr->serverConnectionPtr = connectionPtr;
-
-                // While there's still a client connection on the Waiting Clients List, get
-                // a pointer to the first one, without removing it from the list, then try
-                // to dispatch that client to the server.
-                le_dls_Link_t* clientLinkPtr;
-                while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
-                {
-                    ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                                           ClientConnection_t,
-                                                                           link);
-                    if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
-                    {
-                        // Server went down.  Client was left on the Waiting Clients List.
-                        // Server Connection destructor was run and it disconnected itself
-                        // from the Binding object.
-                        return;
-                    }
-                    // NOTE: If the server didn't go down, then the Client Connection has been
-                    // deleted and its destructor removed it from the Waiting Clients List.
-                }
+                // Server went down.  Client was left on the Waiting Clients List.
+                // Server Connection destructor was run and it disconnected itself
+                // from the Binding object.
+                return;
             }
-
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+            // NOTE: If the server didn't go down, then the Client Connection has been
+            // deleted and its destructor removed it from the Waiting Clients List.
         }
 
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+        bindingLinkPtr = le_dls_PeekNext(&serviceBindingsPtr->bindingList, bindingLinkPtr);
     }
 }
 
@@ -1072,8 +1472,11 @@ static void ProcessAdvertisementFromServer
     // connection to the service list.
     else
     {
-        // Add the object to the User's Service List.
+        // Add the object to the User's Service List and to the Service Map.
         le_dls_Queue(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+        connectionPtr->key.userPtr = connectionPtr->userPtr;
+        connectionPtr->key.namePtr = connectionPtr->interface.interfaceName;
+        le_hashmap_Put(ServiceMapRef, &connectionPtr->key, connectionPtr);
 
         LE_DEBUG("Server (uid %u '%s', pid %d) now serving service '%s' (%s).",
                  connectionPtr->userPtr->uid,
@@ -1211,9 +1614,10 @@ static void ClientReadHandler
 
     LE_ASSERT(clientConnectionPtr != NULL);
 
-    // Receive the "Open" request from the client.
+    // Receive the "Open" request from the client, and the Direct Channel, if it asked for one.
     svcdir_OpenRequest_t msg;
-    result = ReceiveMessage(fd, &msg, sizeof(msg));
+    int directChannelFd = -1;
+    result = ReceiveMessage(fd, &msg, sizeof(msg), &directChannelFd);
 
     // If the connection has closed or there is simply nothing left to be received
     // from the socket,
@@ -1235,6 +1639,11 @@ static void ClientReadHandler
                  clientConnectionPtr->interface.interfaceName,
                  clientConnectionPtr->interface.protocolId);
 
+        if (directChannelFd >= 0)
+        {
+            fd_Close(directChannelFd);
+        }
+
         // Drop connection to misbehaving client.
         RejectClient(clientConnectionPtr, LE_FAULT);
     }
@@ -1243,6 +1652,23 @@ static void ClientReadHandler
         memcpy(&(clientConnectionPtr->interface),
                &(msg.interface),
                sizeof(clientConnectionPtr->interface));
+
+        if (directChannelFd >= 0)
+        {
+            if (IsValidDirectChannel(directChannelFd))
+            {
+                clientConnectionPtr->directChannelFd = directChannelFd;
+            }
+            else
+            {
+                LE_ERROR("Client (uid %u '%s', pid %d) sent an invalid Direct Channel.",
+                         clientConnectionPtr->userPtr->uid,
+                         clientConnectionPtr->userPtr->name,
+                         clientConnectionPtr->pid);
+                fd_Close(directChannelFd);
+            }
+        }
+
         ProcessOpenRequestFromClient(clientConnectionPtr, msg.shouldWait);
     }
     // If an error occurred on the receive,
@@ -1313,6 +1739,7 @@ static void CreateClientConnection
     connectionPtr->userPtr = GetUser(uid);
     connectionPtr->pid = pid;
     connectionPtr->bindingPtr = NULL;
+    connectionPtr->directChannelFd = -1;
 
     // Haven't received ID yet, so clear it out.
     memset(&connectionPtr->interface, 0, sizeof(connectionPtr->interface));
@@ -1376,6 +1803,14 @@ static void ClientConnectionDestructor
     fd_Close(connectionPtr->fd);
     connectionPtr->fd = -1;
 
+    // If a Direct Channel was requested, but never sent to a server, close it.  The client will
+    // see it hang up.
+    if (connectionPtr->directChannelFd >= 0)
+    {
+        fd_Close(connectionPtr->directChannelFd);
+        connectionPtr->directChannelFd = -1;
+    }
+
     // Release the Connection object's reference to the User object.
     le_mem_Release(connectionPtr->userPtr);
     connectionPtr->userPtr = NULL;
@@ -1512,7 +1947,10 @@ static void ServerReadHandler
     bool alreadyReceivedServiceId = (connectionPtr->interface.interfaceName[0] != '\0');
 
     // Receive the service identity from the server.
-    result = ReceiveMessage(fd, &(connectionPtr->interface), sizeof(connectionPtr->interface));
+    result = ReceiveMessage(fd,
+                            &(connectionPtr->interface),
+                            sizeof(connectionPtr->interface),
+                            NULL);
 
     // If the connection has closed or there is simply nothing left to be received
     // from the socket,
@@ -1635,30 +2073,27 @@ static void ServerConnectionDestructor
     ServerConnection_t* connectionPtr = objPtr;
 
     // Disassociate the Server Connection object from all Binding objects that refer to it...
-
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
-
-    while (userLinkPtr != NULL)
+    // NOTE: Only Bindings that refer to the service it advertised can refer to it.
+    ServiceBindings_t* serviceBindingsPtr =
+        FindServiceBindings(connectionPtr->userPtr, connectionPtr->interface.interfaceName);
+    if (serviceBindingsPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
-
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
+        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&serviceBindingsPtr->bindingList);
         while (bindingLinkPtr != NULL)
         {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, serviceLink);
 
             // If the binding is associated with the deleted server connection,
             if (connectionPtr == bindingPtr->serverConnectionPtr)
             {
                 bindingPtr->serverConnectionPtr = NULL;
+
+                // The Direct Channels created through it all go to this server.
+                RevokeDirectChannels(bindingPtr);
             }
 
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+            bindingLinkPtr = le_dls_PeekNext(&serviceBindingsPtr->bindingList, bindingLinkPtr);
         }
-
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
     }
 
     if (connectionPtr->interface.interfaceName[0] == '\0')
@@ -1683,6 +2118,7 @@ static void ServerConnectionDestructor
         if (le_dls_IsInList(&connectionPtr->userPtr->serviceList, &connectionPtr->link))
         {
             le_dls_Remove(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+            le_hashmap_Remove(ServiceMapRef, &connectionPtr->key);
         }
     }
 
@@ -1773,8 +2209,23 @@ static void BindingDestructor
 {
     Binding_t* bindingPtr = objPtr;
 
-    // Remove the Binding object from the User's Binding List.
+    // Remove the Binding object from the User's Binding List and from the Binding Map.
     le_dls_Remove(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    le_hashmap_Remove(BindingMapRef, &bindingPtr->key);
+
+    // Remove it from the list of Bindings that refer to its service, deleting that list if this
+    // was the last one.
+    ServiceBindings_t* serviceBindingsPtr = bindingPtr->serviceBindingsPtr;
+    le_dls_Remove(&serviceBindingsPtr->bindingList, &bindingPtr->serviceLink);
+    if (le_dls_IsEmpty(&serviceBindingsPtr->bindingList))
+    {
+        le_hashmap_Remove(ServiceBindingsMapRef, &serviceBindingsPtr->key);
+        le_mem_Release(serviceBindingsPtr);
+    }
+    bindingPtr->serviceBindingsPtr = NULL;
+
+    // Clients must not keep using Direct Channels that were created through this binding.
+    RevokeDirectChannels(bindingPtr);
 
     // While the list of waiting clients is not empty, pop one off and process it.
     le_dls_Link_t* linkPtr;
@@ -2429,8 +2880,49 @@ static void SdirToolUnbindAll
         le_mem_Release(userPtr);
     }
 
-    // Re-create built-in, hard-coded bindings.
+    // Re-create built-in, hard-coded bindings, and the bindings of the system's binding table.
     CreateHardCodedBindings();
+    CreateTableBindings();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles an "Unbind" request from the 'sdir' tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolUnbind
+(
+    const le_sdtp_Msg_t* msgPtr   ///< [in] Pointer to the request message payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t len = strnlen(msgPtr->clientInterfaceName, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
+    if (len == 0)
+    {
+        LE_KILL_CLIENT("Client interface name empty.");
+    }
+    else if (len == LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+    {
+        LE_KILL_CLIENT("Client interface name not null terminated!");
+    }
+    else
+    {
+        User_t* userPtr = le_hashmap_Get(UserMapRef, &msgPtr->client);
+
+        if (userPtr != NULL)
+        {
+            Binding_t* bindingPtr = FindBinding(userPtr, msgPtr->clientInterfaceName);
+
+            if (bindingPtr != NULL)
+            {
+                LE_DEBUG("Deleting binding: <%s>.%s", userPtr->name, msgPtr->clientInterfaceName);
+
+                // The destructor will remove it from the User's Binding List, etc.
+                le_mem_Release(bindingPtr);
+            }
+        }
+    }
 }
 
 
@@ -2512,6 +3004,11 @@ static void SdirToolRecv
             SdirToolBind(msgPtr);
             break;
 
+        case LE_SDTP_MSGID_UNBIND:
+
+            SdirToolUnbind(msgPtr);
+            break;
+
         default:
             LE_KILL_CLIENT("Invalid message ID %d.", msgPtr->msgType);
             break;
@@ -2559,13 +3056,34 @@ COMPONENT_INIT
     ServerConnectionPoolRef = le_mem_CreatePool("Server Connection", sizeof(ServerConnection_t));
     UserPoolRef = le_mem_CreatePool("User", sizeof(User_t));
     BindingPoolRef = le_mem_CreatePool("Binding", sizeof(Binding_t));
+    ServiceBindingsPoolRef = le_mem_CreatePool("Service Bindings", sizeof(ServiceBindings_t));
+    DirectChannelPoolRef = le_mem_CreatePool("Direct Channel", sizeof(DirectChannel_t));
 
     /// Expand the pools to their expected maximum sizes.
     /// @todo Make this configurable.
     le_mem_ExpandPool(ClientConnectionPoolRef, 100);
-    le_mem_ExpandPool(ServerConnectionPoolRef, 30);
-    le_mem_ExpandPool(UserPoolRef, 30);
-    le_mem_ExpandPool(BindingPoolRef, 30);
+    le_mem_ExpandPool(ServerConnectionPoolRef, MAX_EXPECTED_SERVICES);
+    le_mem_ExpandPool(UserPoolRef, MAX_EXPECTED_USERS);
+    le_mem_ExpandPool(BindingPoolRef, MAX_EXPECTED_BINDINGS);
+    le_mem_ExpandPool(ServiceBindingsPoolRef, MAX_EXPECTED_BINDINGS);
+
+    // Create the hash maps used to look up the objects.
+    UserMapRef = le_hashmap_CreateCompact("User",
+                                          MAX_EXPECTED_USERS,
+                                          le_hashmap_HashUInt32,
+                                          le_hashmap_EqualsUInt32);
+    ServiceMapRef = le_hashmap_CreateCompact("Service",
+                                             MAX_EXPECTED_SERVICES,
+                                             InterfaceKeyHash,
+                                             InterfaceKeyEquals);
+    BindingMapRef = le_hashmap_CreateCompact("Binding",
+                                             MAX_EXPECTED_BINDINGS,
+                                             InterfaceKeyHash,
+                                             InterfaceKeyEquals);
+    ServiceBindingsMapRef = le_hashmap_CreateCompact("ServiceBindings",
+                                                     MAX_EXPECTED_BINDINGS,
+                                                     InterfaceKeyHash,
+                                                     InterfaceKeyEquals);
 
     // Register destructor functions.
     le_mem_SetDestructor(ClientConnectionPoolRef, ClientConnectionDestructor);
@@ -2573,8 +3091,10 @@ COMPONENT_INIT
     le_mem_SetDestructor(UserPoolRef, UserDestructor);
     le_mem_SetDestructor(BindingPoolRef, BindingDestructor);
 
-    // Create built-in, hard-coded bindings.
+    // Create built-in, hard-coded bindings, and the bindings of the system's binding table, so
+    // that clients started before "sdir load" has run can already be bound.
     CreateHardCodedBindings();
+    CreateTableBindings();
 
     // Create the Legato runtime directory if it doesn't already exists.
     LE_ASSERT(le_dir_Make(STRINGIZE(LE_RUNTIME_DIR), S_IRWXU | S_IXOTH) != LE_FAULT);
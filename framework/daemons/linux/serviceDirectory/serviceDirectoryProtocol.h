@@ -5,6 +5,7 @@
  * @ref serviceDirectoryProtocol_SocketsAndCredentials <br>
  * @ref serviceDirectoryProtocol_Servers <br>
  * @ref serviceDirectoryProtocol_Clients <br>
+ * @ref serviceDirectoryProtocol_DirectChannels <br>
  * @ref serviceDirectoryProtocol_Packing
  *
  * @section serviceDirectoryProtocol_Intro Introduction
@@ -85,6 +86,30 @@
  * @note The client socket is a named socket, rather than an abstract socket because this allows
  *       file system permissions to be used to prevent DoS attacks on this socket.
  *
+ * @section serviceDirectoryProtocol_DirectChannels Direct Channels
+ *
+ * A client that expects to open the same service again can ask for a Direct Channel to the
+ * server, so that later sessions can be opened without going through the Service Directory.
+ * To do this, the client creates a connected pair of Unix domain SOCK_SEQPACKET sockets, and
+ * sends one of them to the Service Directory as a file descriptor attached to its Open Session
+ * request.
+ *
+ * When the Service Directory dispatches that client connection to the server, it first sends the
+ * Direct Channel to the server, along with a svcdir_DirectChannelMsg_t.  (Client connections are
+ * sent without any data, so the server can tell the two apart.)  The server then accepts the
+ * file descriptors of new client connection sockets from the Direct Channel too, and opens a
+ * session for each of them just as it would for client connections forwarded by the Service
+ * Directory.  The client opens later sessions by creating a connected pair of sockets, sending one
+ * of them through its end of the Direct Channel, and waiting for the server's welcome message on
+ * the other one.
+ *
+ * The Service Directory keeps its own copy of the server's end of each Direct Channel.  If the
+ * binding that the Direct Channel was created through is changed or removed, or the server
+ * withdraws its service, the Service Directory revokes the Direct Channel by shutting it down.
+ * Both ends then see a hang-up, and the client goes back to opening sessions through the Service
+ * Directory.  If the Service Directory doesn't dispatch the client connection to a server, it
+ * just closes the Direct Channel.
+ *
  * @section serviceDirectoryProtocol_Packing Byte Ordering and Packing
  *
  * This protocol only goes between processes on the same host, so there's no need to do
@@ -164,4 +189,27 @@ typedef struct
 svcdir_OpenRequest_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the magic number in a svcdir_DirectChannelMsg_t.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SVCDIR_DIRECT_CHANNEL_MAGIC 0x44434831
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Direct Channel message.
+ *
+ * Messages sent from the Service Directory to a server along with the file descriptor of a
+ * Direct Channel have this structure.  See @ref serviceDirectoryProtocol_DirectChannels.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< Always SVCDIR_DIRECT_CHANNEL_MAGIC.
+}
+svcdir_DirectChannelMsg_t;
+
+
 #endif // LEGATO_SERVICE_DIRECTORY_PROTOCOL_INCLUDE_GUARD
@@ -17,6 +17,10 @@
  * as soon as possible, without having to contend for CPU and flash bandwidth with other less
  * time-critical things.
  *
+ * Systems that are no longer needed are moved out of the way (into /legato/deleted) and deleted
+ * by a background process at idle priority once the Supervisor has been started, so that
+ * deleting them doesn't delay the framework.
+ *
  * When the system is running, the start program remains alive so it can listen for the
  * death of the Supervisor.  If the Supervisor exits, the status is checked and the start
  * program either exits or selects a system to run again.
@@ -36,6 +40,8 @@
 #include "fileSystem.h"
 #include <mntent.h>
 #include <linux/limits.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 /// Default DAC permissions for directory creation.
 #define DEFAULT_PERMS (S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH)
@@ -75,8 +81,11 @@ static const char AppsDir[] = "/legato/apps";
 static const char SystemsUnpackDir[] = "/legato/systems/unpack";
 static const char AppsUnpackDir[] = "/legato/apps/unpack";
 static const char OldFwDir[] = "/mnt/flash/opt/legato";
+static const char DeletedDir[] = "/legato/deleted";
 
 static const char LdconfigNotDoneMarkerFile[] = "/legato/systems/needs_ldconfig";
+static const char LdSoCacheFile[] = "/etc/ld.so.cache";
+static const char CurrentLdSoCacheFile[] = "/legato/systems/current/" INSTALLER_LD_SO_CACHE_FILE;
 static const char GoldenVersionFile[] = "/mnt/legato/system/version";
 static const char CurrentVersionFile[] = "/legato/systems/current/version";
 static const char BootCountFile[] = "/legato/bootCount";
@@ -169,6 +178,109 @@ static void RecursiveDelete
                path);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a directory into the deleted directory, to be deleted in the background once the
+ * Supervisor has been started (see StartDeletingInBackground()).  If it can't be moved, it is
+ * deleted right away.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteLater
+(
+    const char* path
+)
+{
+    char deletedPath[PATH_MAX];
+    int i;
+
+    if ((mkdir(DeletedDir, S_IRWXU) != 0) && (errno != EEXIST))
+    {
+        LE_WARN("Cannot create '%s' (%m).", DeletedDir);
+        RecursiveDelete(path);
+        return;
+    }
+
+    // Find a free name, as things deleted earlier may still be there.
+    for (i = 0; i < 100; i++)
+    {
+        LE_ASSERT(snprintf(deletedPath, sizeof(deletedPath), "%s/%d", DeletedDir, i)
+                  < sizeof(deletedPath));
+
+        if (rename(path, deletedPath) == 0)
+        {
+            return;
+        }
+        if ((errno != EEXIST) && (errno != ENOTEMPTY))
+        {
+            break;
+        }
+    }
+
+    if (errno != ENOENT)
+    {
+        LE_WARN("Cannot move '%s' to '%s' (%m). Deleting it now.", path, DeletedDir);
+        RecursiveDelete(path);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * If there are things to delete (see DeleteLater()), start a process that deletes them at idle
+ * CPU and I/O priority, so that it doesn't slow down the starting of the framework.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartDeletingInBackground
+(
+    void
+)
+{
+    if (!DirExists(DeletedDir) && !DirExists(OldFwDir))
+    {
+        return;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LE_WARN("Failed to fork the deletion process: %m");
+        return;
+    }
+
+    if (pid == 0)
+    {
+        // Fork again so that the deletion process isn't a child of ours that we have to reap.
+        if (fork() != 0)
+        {
+            _exit(EXIT_SUCCESS);
+        }
+
+        // Our stdin may be the pipe whose closing tells our parent the framework is up.
+        LE_FATAL_IF(freopen("/dev/null", "r", stdin) == NULL,
+                    "Failed to redirect stdin to /dev/null.  %m.");
+
+        struct sched_param param = { .sched_priority = 0 };
+        (void)sched_setscheduler(0, SCHED_IDLE, &param);
+        (void)setpriority(PRIO_PROCESS, 0, 19);
+
+        // ioprio_set(IOPRIO_WHO_PROCESS, self, IOPRIO_CLASS_IDLE)
+        (void)syscall(SYS_ioprio_set, 1, 0, 3 << 13);
+
+        // Remove any old-style firmware.
+        if (DirExists(OldFwDir))
+        {
+            RecursiveDelete(OldFwDir);
+        }
+
+        RecursiveDelete(DeletedDir);
+
+        _exit(EXIT_SUCCESS);
+    }
+
+    while ((waitpid(pid, NULL, 0) == -1) && (errno == EINTR))
+    {
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete the unpack dir and its contents.
@@ -573,11 +685,7 @@ static void DeleteAllButCurrent
     void
 )
 {
-    // Remove any old-style firmware.
-    if (DirExists(OldFwDir))
-    {
-        RecursiveDelete(OldFwDir);
-    }
+    // Any old-style firmware is removed in the background (see StartDeletingInBackground()).
 
     // Delete any non-current systems in /legato.
     DIR* d = opendir(SystemsDir);
@@ -618,7 +726,7 @@ static void DeleteAllButCurrent
             // sandboxed apps were created.
             fs_TryLazyUmount(path);
 
-            RecursiveDelete(path);
+            DeleteLater(path);
         }
     }
 
@@ -664,9 +772,52 @@ static void Rename
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Point the dynamic linker at the current system's prebuilt cache, by making /etc/ld.so.cache a
+ * symlink to it (unless it already is).
+ *
+ * @return true if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool LinkPrebuiltLdSoCache
+(
+    void
+)
+{
+    const char tmpPath[] = "/etc/ld.so.cache.legato";
+    char target[PATH_MAX];
+    ssize_t len = readlink(LdSoCacheFile, target, sizeof(target) - 1);
+
+    if (len >= 0)
+    {
+        target[len] = '\0';
+        if (strcmp(target, CurrentLdSoCacheFile) == 0)
+        {
+            return true;
+        }
+    }
+
+    // Replace the cache atomically, so there's always one the dynamic linker can use.
+    unlink(tmpPath);
+    if (   (symlink(CurrentLdSoCacheFile, tmpPath) != 0)
+        || (rename(tmpPath, LdSoCacheFile) != 0))
+    {
+        LE_WARN("Failed to link '%s' to '%s' (%m).", LdSoCacheFile, CurrentLdSoCacheFile);
+        unlink(tmpPath);
+        return false;
+    }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * create the ld.so.cache for the new install (or reversion).
+ *
+ * If the system has a prebuilt cache (built when it was installed), the dynamic linker is just
+ * pointed at the current system's cache, which follows the current system from then on.
+ * Otherwise, the cache is rebuilt with ldconfig.
  */
 //--------------------------------------------------------------------------------------------------
 static void UpdateLdSoCache
@@ -675,6 +826,13 @@ static void UpdateLdSoCache
 )
 {
     const char* text;
+
+    if (FileExists(CurrentLdSoCacheFile) && LinkPrebuiltLdSoCache())
+    {
+        unlink(LdconfigNotDoneMarkerFile);
+        return;
+    }
+
     // create marker file to say we are doing ldconfig
     text = "start_ldconfig";
     // If this fails, try to limp along anyway.
@@ -1163,6 +1321,10 @@ static int TryToRun
         LE_FATAL("Failed to run '%s': %m", supervisorPath);
     }
 
+    // Now that the Supervisor is starting, delete what is no longer needed without getting in
+    // its way.
+    StartDeletingInBackground();
+
     // Close our stdin so only the Supervisor has a copy of the write end of the pipe.
     // It will close this when the framework is up, which will trigger our parent process to exit.
     // Reopen our stdin to /dev/null so we can loop back around to this code later without
@@ -1618,6 +1780,9 @@ static int InstallGolden
     // Make the golden system the new current system.
     Rename(SystemsUnpackDir, CurrentSystemDir);
 
+    // Build its dynamic linker cache, so it's there if the system is reselected later.
+    (void)installer_BuildLdSoCache(CurrentSystemDir);
+
     // Delete old stuff we don't need anymore.
     DeleteAllButCurrent();
 
@@ -1732,13 +1897,13 @@ static void CheckAndInstallCurrentSystem
             {
                 case STATUS_BAD:
                     // System bad. Delete and roll-back (here newestIndex < currentIndex).
-                    RecursiveDelete(path);
+                    DeleteLater(path);
                     break;
 
                 case STATUS_TRYABLE:
                     // System try-able. Grab config tree from current system and delete it.
                     ImportOldConfigTrees(currentIndex, newestIndex);
-                    RecursiveDelete(path);
+                    DeleteLater(path);
                     break;
 
                 case STATUS_GOOD:
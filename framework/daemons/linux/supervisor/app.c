@@ -25,7 +25,9 @@
  * that directory is created.  The linked file will not show up in the linked directory both inside
  * the app's working area and the in the directory's original location.
  * So, instead when a directory is required or bundled, all files in the directory are individually
- * linked.
+ * linked.  For sandboxed apps, a required or bundled directory that nothing else is linked into,
+ * and that only holds regular files and directories, is bind mounted as a whole instead, because
+ * hundreds of bind mounts slow down the start of apps that import many files.
  *
  * The working area is not cleaned up by the Supervisor, rather it is left to the installer to
  * clean up.
@@ -59,6 +61,8 @@
 #include "fileDescriptor.h"
 #include "fileSystem.h"
 #include "file.h"
+#include "installer.h"
+#include "launchDesc.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -71,6 +75,18 @@
 #define CFG_NODE_SANDBOXED                              "sandboxed"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The name of the node in the config tree that specifies whether the app's processes are started
+ * with the settings of its launch descriptor (see launchDesc.h).
+ *
+ * If this entry in the config tree is missing or empty, the settings are read from the config
+ * tree.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_LAUNCH_DESC                            "launchDescriptor"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The name of the node in the config tree that contains a process's supplementary groups list.
@@ -335,12 +351,16 @@ typedef struct app_Ref
     gid_t           supplementGids[LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS];  // List of supplementary
                                                                          // group IDs.
     size_t          numSupplementGids;  // Number of supplementary groups for this app.
+    char            smackLabel[LIMIT_MAX_SMACK_LABEL_BYTES]; // SMACK label of the app's processes.
     app_State_t     state;              // Applications current state.
     le_dls_List_t   procs;              // List of processes in this application.
     le_dls_List_t   auxProcs;           // List of auxiliary processes in this application.
     le_timer_Ref_t  killTimer;          // Timeout timer for killing processes.
     le_sls_List_t   additionalLinks;    // List of additional links that are temporarily added to
                                         // the app.
+    le_sls_List_t   dirImports;         // List of directories imported into the sandbox.
+    launchDesc_Ref_t launchDescRef;     // Launch descriptor, or NULL if the processes are
+                                        // configured from the config tree.
 }
 App_t;
 
@@ -374,6 +394,29 @@ FileLinkNode_t;
 static le_mem_PoolRef_t FileLinkNodePool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A directory imported into the sandbox, either bind mounted as a whole or file by file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char src[LIMIT_MAX_PATH_BYTES];         ///< Source directory.
+    char dest[LIMIT_MAX_PATH_BYTES];        ///< Destination relative to the app's working dir.
+    bool isBound;                           ///< true if the whole directory is bind mounted.
+    le_sls_Link_t link;                     ///< Link in the app's list of imported directories.
+}
+DirImportNode_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for imported directory nodes.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirImportNodePool;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prototype for process stopped handler.
@@ -663,6 +706,7 @@ static le_result_t GetDevID
 //--------------------------------------------------------------------------------------------------
 static le_result_t SetDevicePermissions
 (
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Batch to add the SMACK rule to.
     const char* appSmackLabelPtr,   ///< [IN] SMACK label of the app.
     const char* devPathPtr,         ///< [IN] Source path.
     const char* permPtr             ///< [IN] Permissions.
@@ -695,7 +739,7 @@ static le_result_t SetDevicePermissions
     }
 
     // Set the SMACK rule to allow the app to access the device.
-    smack_SetRule(appSmackLabelPtr, permPtr, devLabel);
+    smack_AddRuleToBatch(batchPtr, appSmackLabelPtr, permPtr, devLabel);
 
     return LE_OK;
 }
@@ -712,7 +756,8 @@ static le_result_t SetDevicePermissions
 //--------------------------------------------------------------------------------------------------
 static le_result_t SetCfgDevicePermissions
 (
-    app_Ref_t appRef                ///< [IN] The application.
+    app_Ref_t appRef,               ///< [IN] The application.
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to add the SMACK rules to.
 )
 {
     // Create an iterator for the app.
@@ -742,7 +787,7 @@ static le_result_t SetCfgDevicePermissions
             char permStr[MAX_DEVICE_PERM_STR_BYTES];
             GetCfgPermissions(appCfg, permStr, sizeof(permStr));
 
-            if (SetDevicePermissions(appLabel, srcPath, permStr) != LE_OK)
+            if (SetDevicePermissions(batchPtr, appLabel, srcPath, permStr) != LE_OK)
             {
                 le_cfg_CancelTxn(appCfg);
                 return LE_FAULT;
@@ -767,7 +812,8 @@ static le_result_t SetCfgDevicePermissions
 static void SetSmackRulesForBindings
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application.
-    const char* appLabelPtr             ///< [IN] Smack label for the app.
+    const char* appLabelPtr,            ///< [IN] Smack label for the app.
+    smack_RuleBatch_t* batchPtr         ///< [IN] Batch to add the rules to.
 )
 {
     // Create a config read transaction to the bindings section for the application.
@@ -793,8 +839,8 @@ static void SetSmackRulesForBindings
             smack_GetAppLabel(serverName, serverLabel, sizeof(serverLabel));
 
             // Set the SMACK label to/from the server.
-            smack_SetRule(appLabelPtr, "rw", serverLabel);
-            smack_SetRule(serverLabel, "rw", appLabelPtr);
+            smack_AddRuleToBatch(batchPtr, appLabelPtr, "rw", serverLabel);
+            smack_AddRuleToBatch(batchPtr, serverLabel, "rw", appLabelPtr);
         }
     } while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
 
@@ -810,7 +856,8 @@ static void SetSmackRulesForBindings
 static void SetDefaultSmackRules
 (
     const char* appNamePtr,             ///< [IN] App name.
-    const char* appLabelPtr             ///< [IN] Smack label for the app.
+    const char* appLabelPtr,            ///< [IN] Smack label for the app.
+    smack_RuleBatch_t* batchPtr         ///< [IN] Batch to add the rules to.
 )
 {
 #define NUM_PERMISSONS      7
@@ -841,15 +888,15 @@ static void SetDefaultSmackRules
         char dirLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
         smack_GetAppAccessLabel(appNamePtr, mode, dirLabel, sizeof(dirLabel));
 
-        smack_SetRule(appLabelPtr, permissionStr[i], dirLabel);
+        smack_AddRuleToBatch(batchPtr, appLabelPtr, permissionStr[i], dirLabel);
     }
 
     // Set default permissions between the app and the framework.
-    smack_SetRule("framework", "w", appLabelPtr);
-    smack_SetRule(appLabelPtr, "rw", "framework");
+    smack_AddRuleToBatch(batchPtr, "framework", "w", appLabelPtr);
+    smack_AddRuleToBatch(batchPtr, appLabelPtr, "rw", "framework");
 
     // Set default permissions to allow the app to access the syslog.
-    smack_SetRule(appLabelPtr, "w", "syslog");
+    smack_AddRuleToBatch(batchPtr, appLabelPtr, "w", "syslog");
 }
 
 
@@ -893,11 +940,19 @@ static le_result_t SetSmackRules
     char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
     smack_GetAppLabel(appRef->name, appLabel, sizeof(appLabel));
 
-    SetDefaultSmackRules(appRef->name, appLabel);
+    // Collect all the app's rules so that they are loaded in as few writes as possible.
+    smack_RuleBatch_t batch;
+    smack_InitRuleBatch(&batch);
 
-    SetSmackRulesForBindings(appRef, appLabel);
+    SetDefaultSmackRules(appRef->name, appLabel, &batch);
 
-    return SetCfgDevicePermissions(appRef);
+    SetSmackRulesForBindings(appRef, appLabel, &batch);
+
+    le_result_t result = SetCfgDevicePermissions(appRef, &batch);
+
+    smack_CommitRuleBatch(&batch);
+
+    return result;
 }
 
 
@@ -1066,6 +1121,14 @@ static ProcContainer_t* FindProcContainer
     pid_t pid                       ///< [IN] The pid to search for.
 )
 {
+    // The PID index tells right away whether this is one of the app's processes.
+    proc_Ref_t procRef = proc_FindByPid(pid);
+
+    if ((procRef == NULL) || (proc_GetAppRef(procRef) != appRef))
+    {
+        return NULL;
+    }
+
     // Find the process in the app's list.
     ProcContainer_t* procContainerPtr = FindProcContainerInList(appRef->procs, pid);
 
@@ -1564,15 +1627,15 @@ static le_result_t CreateFileLink
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Recursively create links from all files under the source directory to corresponding files under
- * the destination directory.
+ * Create links from all files under the source directory to corresponding files under the
+ * destination directory.
  *
  * @return
  *      LE_OK if successful.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t RecursivelyCreateLinks
+static le_result_t CreateLinksToFiles
 (
     app_Ref_t appRef,                   ///< [IN] Application reference.
     const char* appDirLabelPtr,         ///< [IN] SMACK label to use for created directories.
@@ -1686,6 +1749,301 @@ static le_result_t RecursivelyCreateLinks
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recursively create links from all files under the source directory to corresponding files under
+ * the destination directory.
+ *
+ * For sandboxed apps, the links are only created by CreateDirImports(), once all of the other
+ * links are in the sandbox.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RecursivelyCreateLinks
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    const char* appDirLabelPtr,         ///< [IN] SMACK label to use for created directories.
+    const char* srcDirPtr,              ///< [IN] Source directory.
+    const char* destDirPtr              ///< [IN] Destination directory.
+)
+{
+    if (!appRef->sandboxed)
+    {
+        return CreateLinksToFiles(appRef, appDirLabelPtr, srcDirPtr, destDirPtr);
+    }
+
+    DirImportNode_t* importPtr = le_mem_ForceAlloc(DirImportNodePool);
+    importPtr->isBound = false;
+    importPtr->link = LE_SLS_LINK_INIT;
+    importPtr->dest[0] = '\0';
+
+    le_result_t result;
+
+    if (destDirPtr[strlen(destDirPtr)-1] == '/')
+    {
+        // Use the source directory name in the destination.
+        result = le_path_Concat("/", importPtr->dest, sizeof(importPtr->dest), destDirPtr,
+                                le_path_GetBasenamePtr(srcDirPtr, "/"), NULL);
+    }
+    else
+    {
+        result = le_utf8_Copy(importPtr->dest, destDirPtr, sizeof(importPtr->dest), NULL);
+    }
+
+    if ( (result != LE_OK) ||
+         (le_utf8_Copy(importPtr->src, srcDirPtr, sizeof(importPtr->src), NULL) != LE_OK) )
+    {
+        LE_ERROR("Path '%s' or '%s' for app %s is too long.", srcDirPtr, destDirPtr, appRef->name);
+        le_mem_Release(importPtr);
+        return LE_FAULT;
+    }
+
+    le_sls_Queue(&(appRef->dirImports), &(importPtr->link));
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a directory only holds regular files and directories of the same file system,
+ * so that bind mounting it as a whole gives the same view as bind mounting each of its files.
+ * Symlinks in particular are followed when files are linked individually, but not in a bind
+ * mounted directory.
+ *
+ * @return
+ *      true if the directory can be bind mounted as a whole.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPlainDirTree
+(
+    const char* dirPtr                  ///< [IN] Directory.
+)
+{
+    char* pathArrayPtr[] = {(char*)dirPtr, NULL};
+    FTS* ftsPtr;
+
+    do
+    {
+        ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
+    }
+    while ( (ftsPtr == NULL) && (errno == EINTR) );
+
+    if (ftsPtr == NULL)
+    {
+        return false;
+    }
+
+    FTSENT* entPtr;
+    dev_t dev = 0;
+    bool isPlain = true;
+
+    while ( isPlain && ((entPtr = fts_read(ftsPtr)) != NULL) )
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_D:
+                if (entPtr->fts_level == FTS_ROOTLEVEL)
+                {
+                    dev = entPtr->fts_statp->st_dev;
+                }
+                isPlain = (entPtr->fts_statp->st_dev == dev);
+                break;
+
+            case FTS_DP:
+                break;
+
+            case FTS_F:
+                isPlain = S_ISREG(entPtr->fts_statp->st_mode);
+                break;
+
+            default:
+                // Symlinks, unreadable directories, etc.
+                isPlain = false;
+                break;
+        }
+    }
+
+    fts_close(ftsPtr);
+
+    return isPlain;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether an imported directory can be bind mounted as a whole: its destination must not
+ * overlap with another imported directory, and nothing else must be linked into it.
+ *
+ * @return
+ *      true if the directory can be bind mounted as a whole.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CanBindDirImport
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    DirImportNode_t* importPtr          ///< [IN] Imported directory.
+)
+{
+    le_sls_Link_t* linkPtr = le_sls_Peek(&(appRef->dirImports));
+
+    while (linkPtr != NULL)
+    {
+        DirImportNode_t* otherPtr = CONTAINER_OF(linkPtr, DirImportNode_t, link);
+
+        if ( (otherPtr != importPtr) &&
+             (le_path_IsEquivalent(otherPtr->dest, importPtr->dest, "/") ||
+              le_path_IsSubpath(otherPtr->dest, importPtr->dest, "/") ||
+              le_path_IsSubpath(importPtr->dest, otherPtr->dest, "/")) )
+        {
+            return false;
+        }
+
+        linkPtr = le_sls_PeekNext(&(appRef->dirImports), linkPtr);
+    }
+
+    char destPath[LIMIT_MAX_PATH_BYTES] = "";
+
+    if (le_path_Concat("/", destPath, sizeof(destPath),
+                       appRef->workingDir, importPtr->dest, NULL) != LE_OK)
+    {
+        return false;
+    }
+
+    // The destination must not exist yet, or be left over from a previous run, either as an empty
+    // directory or still bind mounted.
+    struct stat srcStat;
+    struct stat destStat;
+
+    if (lstat(destPath, &destStat) == 0)
+    {
+        if ( (stat(importPtr->src, &srcStat) == 0) &&
+             (srcStat.st_dev == destStat.st_dev) && (srcStat.st_ino == destStat.st_ino) )
+        {
+            return true;
+        }
+
+        if (!S_ISDIR(destStat.st_mode))
+        {
+            return false;
+        }
+
+        DIR* dirPtr = opendir(destPath);
+
+        if (dirPtr == NULL)
+        {
+            return false;
+        }
+
+        struct dirent* entryPtr;
+        bool isEmpty = true;
+
+        while ( isEmpty && ((entryPtr = readdir(dirPtr)) != NULL) )
+        {
+            isEmpty = (strcmp(entryPtr->d_name, ".") == 0) || (strcmp(entryPtr->d_name, "..") == 0);
+        }
+
+        closedir(dirPtr);
+
+        if (!isEmpty)
+        {
+            return false;
+        }
+    }
+    else if (errno != ENOENT)
+    {
+        return false;
+    }
+
+    return IsPlainDirTree(importPtr->src);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the links to the directories imported into a sandbox.  Each directory is bind mounted as a
+ * whole if possible, and file by file otherwise.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateDirImports
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    const char* appDirLabelPtr          ///< [IN] SMACK label to use for created directories.
+)
+{
+    le_sls_Link_t* linkPtr = le_sls_Peek(&(appRef->dirImports));
+
+    while (linkPtr != NULL)
+    {
+        DirImportNode_t* importPtr = CONTAINER_OF(linkPtr, DirImportNode_t, link);
+
+        if (CanBindDirImport(appRef, importPtr))
+        {
+            if (CreateDirLink(appRef, appDirLabelPtr, importPtr->src, importPtr->dest) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            importPtr->isBound = true;
+        }
+        else if (CreateLinksToFiles(appRef, appDirLabelPtr,
+                                    importPtr->src, importPtr->dest) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        linkPtr = le_sls_PeekNext(&(appRef->dirImports), linkPtr);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a path of the sandbox is in a directory that is bind mounted as a whole, so that
+ * creating a link there would create a file in the source directory.
+ *
+ * @return
+ *      true if the path is in a bind mounted directory.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInBoundDir
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    const char* pathPtr                 ///< [IN] Path relative to the app's working directory.
+)
+{
+    le_sls_Link_t* linkPtr = le_sls_Peek(&(appRef->dirImports));
+
+    while (linkPtr != NULL)
+    {
+        DirImportNode_t* importPtr = CONTAINER_OF(linkPtr, DirImportNode_t, link);
+
+        if ( importPtr->isBound &&
+             (le_path_IsEquivalent(importPtr->dest, pathPtr, "/") ||
+              le_path_IsSubpath(importPtr->dest, pathPtr, "/")) )
+        {
+            return true;
+        }
+
+        linkPtr = le_sls_PeekNext(&(appRef->dirImports), linkPtr);
+    }
+
+    return false;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create links to the default temporary files that all app's will likely need.
@@ -2246,6 +2604,13 @@ static le_result_t SetupAppArea
         return LE_FAULT;
     }
 
+    // Create links to the bundled and required directories, now that all of the other links are
+    // in the sandbox.
+    if (CreateDirImports(appRef, appDirLabel) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
     return LE_OK;
 }
 
@@ -2439,9 +2804,11 @@ void app_Init
 {
     AppPool = le_mem_CreatePool("Apps", sizeof(App_t));
     FileLinkNodePool = le_mem_CreatePool("Links", sizeof(FileLinkNode_t));
+    DirImportNodePool = le_mem_CreatePool("DirImports", sizeof(DirImportNode_t));
     ProcContainerPool = le_mem_CreatePool("ProcContainers", sizeof(ProcContainer_t));
 
     proc_Init();
+    launchDesc_Init();
 
     // Create the appsWriteable area.
     if (le_dir_MakePath(APPS_WRITEABLE_DIR, S_IRUSR | S_IXUSR | S_IROTH | S_IXOTH) != LE_OK)
@@ -2587,12 +2954,17 @@ app_Ref_t app_Create
     // Store the app name.
     appPtr->name = le_path_GetBasenamePtr(appPtr->cfgPathRoot, "/");
 
+    // Compute the SMACK label of the app's processes once, rather than at every process start.
+    smack_GetAppLabel(appPtr->name, appPtr->smackLabel, sizeof(appPtr->smackLabel));
+
     // Initialize the other parameters.
     appPtr->procs = LE_DLS_LIST_INIT;
     appPtr->auxProcs = LE_DLS_LIST_INIT;
     appPtr->additionalLinks = LE_SLS_LIST_INIT;
+    appPtr->dirImports = LE_SLS_LIST_INIT;
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
+    appPtr->launchDescRef = NULL;
 
     // Get a config iterator for this app.
     le_cfg_IteratorRef_t cfgIterator = le_cfg_CreateReadTxn(appPtr->cfgPathRoot);
@@ -2624,6 +2996,19 @@ app_Ref_t app_Create
         goto failed;
     }
 
+    // Apps installed as images have to be mounted before any of their files can be reached.
+    if (installer_MountAppImage(appPtr->installDirPath, appPtr->name) == LE_FAULT)
+    {
+        LE_ERROR("Could not mount the image of app '%s'.", appPtr->name);
+        goto failed;
+    }
+
+    // Load the launch descriptor before the processes are created, as they use it.
+    if (le_cfg_GetBool(cfgIterator, CFG_NODE_LAUNCH_DESC, false))
+    {
+        appPtr->launchDescRef = launchDesc_Load(appPtr->installDirPath);
+    }
+
     // Use the app's writeable files' directory path as the its working directory.
     appPtr->workingDir[0] = '\0';
     if (LE_OK != le_path_Concat("/",
@@ -2766,12 +3151,26 @@ void app_Delete
     DeleteProcContainersList(appRef->procs);
     DeleteProcContainersList(appRef->auxProcs);
 
+    // Unload the launch descriptor, now that no process uses it.
+    if (appRef->launchDescRef != NULL)
+    {
+        launchDesc_Unload(appRef->launchDescRef);
+    }
+
     // Release the app timer.
     if (appRef->killTimer != NULL)
     {
         le_timer_Delete(appRef->killTimer);
     }
 
+    // Release the list of imported directories.
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&(appRef->dirImports))) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, DirImportNode_t, link));
+    }
+
     // Relesase app.
     le_mem_Release(appRef);
 }
@@ -3057,6 +3456,23 @@ bool app_GetIsSandboxed
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the SMACK label of an application's processes.
+ *
+ * @return
+ *      The SMACK label.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* app_GetSmackLabel
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    return appRef->smackLabel;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the directory path for an app's installation directory in the current running system.
@@ -3075,6 +3491,152 @@ const char* app_GetInstallDirPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an app's launch descriptor (see launchDesc.h).
+ *
+ * @return
+ *      The launch descriptor, or NULL if the app's processes must be configured from the config
+ *      tree.
+ */
+//--------------------------------------------------------------------------------------------------
+launchDesc_Ref_t app_GetLaunchDesc
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return appRef->launchDescRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops using an app's launch descriptor, and unloads it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropLaunchDesc
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    if (appRef->launchDescRef == NULL)
+    {
+        return;
+    }
+
+    le_dls_Link_t* procLinkPtr = le_dls_Peek(&(appRef->procs));
+
+    while (procLinkPtr != NULL)
+    {
+        ProcContainer_t* procContainerPtr = CONTAINER_OF(procLinkPtr, ProcContainer_t, link);
+
+        proc_DropLaunchDesc(procContainerPtr->procRef);
+
+        procLinkPtr = le_dls_PeekNext(&(appRef->procs), procLinkPtr);
+    }
+
+    launchDesc_Unload(appRef->launchDescRef);
+    appRef->launchDescRef = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks an app's launch descriptor after the app's configuration has changed.
+ *
+ * If the process settings in the config tree may no longer be the ones in the launch descriptor,
+ * the descriptor is disabled for good, by setting the app's "launchDescriptor" config node to
+ * false.  The processes of the app object, if there is one, are then started with the settings
+ * read from the config tree, as they are when that node is false.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_CheckLaunchDesc
+(
+    const char* cfgPathRootPtr,         ///< [IN] The path in the config tree for the app.
+    app_Ref_t appRef,                   ///< [IN] The app, or NULL if it has no app object.
+    const char* changedNodePtr          ///< [IN] Deepest node holding all the changes, relative
+                                        ///       to the app's node ("" for the app itself).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Changes to the process settings make the descriptor out of date.  Other changes can only
+    // matter if they hold the process settings too (e.g. when the app was installed), or turn the
+    // descriptor back on, and are compared.  The rest of the app's settings are not in it.
+    bool isProcsChanged;
+
+    if (   le_path_IsEquivalent(changedNodePtr, CFG_NODE_PROC_LIST, "/")
+        || le_path_IsSubpath(CFG_NODE_PROC_LIST, changedNodePtr, "/") )
+    {
+        isProcsChanged = true;
+    }
+    else if (   (changedNodePtr[0] == '\0')
+             || le_path_IsEquivalent(changedNodePtr, CFG_NODE_LAUNCH_DESC, "/") )
+    {
+        isProcsChanged = false;
+    }
+    else
+    {
+        return;
+    }
+
+    le_cfg_IteratorRef_t cfgIterator = le_cfg_CreateReadTxn(cfgPathRootPtr);
+    bool isEnabled = le_cfg_GetBool(cfgIterator, CFG_NODE_LAUNCH_DESC, false);
+    le_cfg_CancelTxn(cfgIterator);
+
+    if (!isEnabled)
+    {
+        if (appRef != NULL)
+        {
+            DropLaunchDesc(appRef);
+        }
+        return;
+    }
+
+    const char* appNamePtr = le_path_GetBasenamePtr(cfgPathRootPtr, "/");
+
+    if (!isProcsChanged)
+    {
+        // Use the app's own descriptor if it has one loaded.
+        launchDesc_Ref_t descRef = (appRef != NULL) ? appRef->launchDescRef : NULL;
+        launchDesc_Ref_t loadedDescRef = NULL;
+        char installDirPath[LIMIT_MAX_PATH_BYTES] = "";
+
+        if (   (descRef == NULL)
+            && (le_path_Concat("/", installDirPath, sizeof(installDirPath),
+                               APPS_INSTALL_DIR, appNamePtr, NULL) == LE_OK)
+            && (installer_MountAppImage(installDirPath, appNamePtr) != LE_FAULT) )
+        {
+            loadedDescRef = launchDesc_Load(installDirPath);
+            descRef = loadedDescRef;
+        }
+
+        bool isMatch = (descRef != NULL) && launchDesc_MatchesConfig(descRef, cfgPathRootPtr);
+
+        if (loadedDescRef != NULL)
+        {
+            launchDesc_Unload(loadedDescRef);
+        }
+
+        if (isMatch)
+        {
+            return;
+        }
+    }
+
+    LE_INFO("Config of app '%s' changed, its launch descriptor is no longer used.", appNamePtr);
+
+    cfgIterator = le_cfg_CreateWriteTxn(cfgPathRootPtr);
+    le_cfg_SetBool(cfgIterator, CFG_NODE_LAUNCH_DESC, false);
+    le_cfg_CommitTxn(cfgIterator);
+
+    if (appRef != NULL)
+    {
+        DropLaunchDesc(appRef);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's working directory.
@@ -3826,7 +4388,8 @@ le_result_t app_AddLink
 
     // Check that the dest path does not conflict with anything already in the app's
     // working directory.
-    if (CheckPathConflict(destPathPtr, appRef->workingDir) != LE_OK)
+    if ( IsInBoundDir(appRef, destPathPtr) ||
+         (CheckPathConflict(destPathPtr, appRef->workingDir) != LE_OK) )
     {
         return LE_DUPLICATE;
     }
@@ -3908,7 +4471,14 @@ le_result_t app_SetDevPerm
     char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
     smack_GetAppLabel(app_GetName(appRef), appLabel, sizeof(appLabel));
 
-    return SetDevicePermissions(appLabel, pathPtr, permissionPtr);
+    smack_RuleBatch_t batch;
+    smack_InitRuleBatch(&batch);
+
+    le_result_t result = SetDevicePermissions(&batch, appLabel, pathPtr, permissionPtr);
+
+    smack_CommitRuleBatch(&batch);
+
+    return result;
 }
 
 
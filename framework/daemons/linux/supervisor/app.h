@@ -9,6 +9,7 @@
 #define LEGATO_SRC_APP_INCLUDE_GUARD
 
 #include "watchdogAction.h"
+#include "launchDesc.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -288,6 +289,20 @@ bool app_GetIsSandboxed
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the SMACK label of an application's processes.
+ *
+ * @return
+ *      The SMACK label.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* app_GetSmackLabel
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the directory path for an app's installation directory in the current running system.
@@ -302,6 +317,40 @@ const char* app_GetInstallDirPath
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an app's launch descriptor (see launchDesc.h).
+ *
+ * @return
+ *      The launch descriptor, or NULL if the app's processes must be configured from the config
+ *      tree.
+ */
+//--------------------------------------------------------------------------------------------------
+launchDesc_Ref_t app_GetLaunchDesc
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks an app's launch descriptor after the app's configuration has changed.
+ *
+ * If the process settings in the config tree may no longer be the ones in the launch descriptor,
+ * the descriptor is disabled for good, by setting the app's "launchDescriptor" config node to
+ * false.  The processes of the app object, if there is one, are then started with the settings
+ * read from the config tree, as they are when that node is false.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_CheckLaunchDesc
+(
+    const char* cfgPathRootPtr,         ///< [IN] The path in the config tree for the app.
+    app_Ref_t appRef,                   ///< [IN] The app, or NULL if it has no app object.
+    const char* changedNodePtr          ///< [IN] Deepest node holding all the changes, relative
+                                        ///       to the app's node ("" for the app itself).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's working directory.
@@ -0,0 +1,582 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/appStats.c
+ *
+ * Implementation of the le_appStats API.
+ *
+ * The app-wide statistics come from the app's cgroups (which are named after the app), and the
+ * per-process ones from the /proc/<pid> directories of the processes in the app's freezer cgroup,
+ * so processes forked by the app's own processes are accounted for too.
+ *
+ * Each sample handler gets its own repeating timer.  The records are encoded as described in the
+ * le_appStats API documentation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "appStats.h"
+#include "app.h"
+#include "apps.h"
+#include "cgroups.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+
+#include <dirent.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the fixed part of a record, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_HEADER_BYTES         39
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a process entry, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROC_ENTRY_BYTES            24
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of processes of an app that are looked at.  This is more than what fits in a
+ * record, so that records can be flagged as truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PROCS                   \
+    ((LE_APPSTATS_MAX_RECORD_BYTES - RECORD_HEADER_BYTES) / PROC_ENTRY_BYTES + 1)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer used to read /proc/<pid>/stat files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROC_STAT_BYTES             512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the fields that could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNKNOWN_VALUE               UINT64_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample handler registration.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_appStats_SampleHandlerFunc_t handlerFunc;    ///< Client's handler.
+    void*                           contextPtr;     ///< Client's context pointer.
+    le_msg_SessionRef_t             sessionRef;     ///< Session of the client.
+    le_timer_Ref_t                  timerRef;       ///< Sampling timer.
+}
+Subscription_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for sample handler registrations.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SubscriptionPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference map of sample handler registrations.  The safe references are the handler
+ * references given to the clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t SubscriptionMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of the sampling of an app.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char*     appNamePtr;     ///< App to sample, or NULL for all the running apps.
+    Subscription_t* subPtr;         ///< Registration to send the records to, or NULL.
+    uint8_t*        recordPtr;      ///< Where to put the record of the app.
+    size_t          recordSize;     ///< [IN] Size of the record buffer.  [OUT] Size of the record.
+    le_result_t     result;         ///< Result of the sampling.
+}
+SampleCtx_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores an unsigned integer in little-endian byte order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutUint
+(
+    uint8_t* bufPtr,                ///< [OUT] Where to store the integer.
+    uint64_t value,                 ///< [IN] Integer.
+    size_t numBytes                 ///< [IN] Size of the integer, in bytes.
+)
+{
+    size_t i;
+
+    for (i = 0; i < numBytes; i++)
+    {
+        bufPtr[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of threads, the resident memory and the cpu time of a process.  The values that
+ * could not be read are left untouched.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadProcStat
+(
+    pid_t pid,                      ///< [IN] Process.
+    uint64_t* numThreadsPtr,        ///< [OUT] Number of threads.
+    uint64_t* rssKbPtr,             ///< [OUT] Resident memory, in kilobytes.
+    uint64_t* cpuTimeMsPtr          ///< [OUT] User + system cpu time, in milliseconds.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    char buffer[PROC_STAT_BYTES];
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        // The process may just have died.
+        return;
+    }
+
+    ssize_t numBytes;
+    do
+    {
+        numBytes = read(fd, buffer, sizeof(buffer) - 1);
+    }
+    while ((numBytes == -1) && (errno == EINTR));
+
+    fd_Close(fd);
+
+    if (numBytes <= 0)
+    {
+        return;
+    }
+    buffer[numBytes] = '\0';
+
+    // The command name (2nd field) can contain spaces and parentheses, so parse from its end.
+    char* fieldsPtr = strrchr(buffer, ')');
+    if (fieldsPtr == NULL)
+    {
+        return;
+    }
+
+    unsigned long utime;
+    unsigned long stime;
+    long numThreads;
+    long rssPages;
+
+    // Fields 3 (state) to 24 (rss), see proc(5).
+    if (sscanf(fieldsPtr + 1,
+               " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %ld %*d"
+               " %*u %*u %ld",
+               &utime, &stime, &numThreads, &rssPages) != 4)
+    {
+        return;
+    }
+
+    long ticksPerSec = sysconf(_SC_CLK_TCK);
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    *numThreadsPtr = numThreads;
+    *rssKbPtr = (uint64_t)rssPages * (pageSize / 1024);
+    if (ticksPerSec > 0)
+    {
+        *cpuTimeMsPtr = ((uint64_t)utime + stime) * 1000 / ticksPerSec;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the open file descriptors of a process.
+ *
+ * @return
+ *      The number of file descriptors, or UNKNOWN_VALUE if they could not be listed.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t CountFds
+(
+    pid_t pid                       ///< [IN] Process.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+
+    DIR* dirPtr = opendir(path);
+    if (dirPtr == NULL)
+    {
+        return UNKNOWN_VALUE;
+    }
+
+    uint64_t count = 0;
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        if (entryPtr->d_name[0] != '.')
+        {
+            count++;
+        }
+    }
+
+    closedir(dirPtr);
+
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the statistics record of an app.
+ *
+ * @return
+ *      The size of the record, or 0 if the buffer is too small to hold the record header.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t BuildRecord
+(
+    app_Ref_t appRef,               ///< [IN] The app.
+    uint8_t* recordPtr,             ///< [OUT] Buffer to build the record in.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    const char* appNamePtr = app_GetName(appRef);
+    size_t nameLen = strnlen(appNamePtr, LIMIT_MAX_APP_NAME_LEN);
+
+    if (bufSize > LE_APPSTATS_MAX_RECORD_BYTES)
+    {
+        bufSize = LE_APPSTATS_MAX_RECORD_BYTES;
+    }
+
+    if (bufSize < RECORD_HEADER_BYTES + nameLen)
+    {
+        return 0;
+    }
+
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    uint64_t cpuTimeNs;
+    if (cgrp_GetCpuTime(appNamePtr, &cpuTimeNs) != LE_OK)
+    {
+        cpuTimeNs = UNKNOWN_VALUE;
+    }
+
+    ssize_t memUsed = cgrp_GetMemUsed(appNamePtr);
+    ssize_t maxMemUsed = cgrp_GetMaxMemUsed(appNamePtr);
+
+    // Get the processes of the app.
+    pid_t pids[MAX_PROCS];
+    ssize_t numPids = cgrp_GetProcessesList(CGRP_SUBSYS_FREEZE, appNamePtr, pids, MAX_PROCS);
+    if (numPids < 0)
+    {
+        numPids = 0;
+    }
+
+    uint8_t flags = 0;
+    size_t maxEntries = (bufSize - RECORD_HEADER_BYTES - nameLen) / PROC_ENTRY_BYTES;
+    size_t numEntries = numPids;
+
+    if (numEntries > maxEntries)
+    {
+        numEntries = maxEntries;
+        flags |= LE_APPSTATS_FLAG_TRUNCATED;
+    }
+
+    size_t recordSize = RECORD_HEADER_BYTES + nameLen + numEntries * PROC_ENTRY_BYTES;
+
+    // Header.
+    PutUint(recordPtr, LE_APPSTATS_RECORD_VERSION, 1);
+    PutUint(recordPtr + 1, flags, 1);
+    PutUint(recordPtr + 2, recordSize, 2);
+    PutUint(recordPtr + 4, (uint64_t)now.sec * 1000 + now.usec / 1000, 8);
+    PutUint(recordPtr + 12, cpuTimeNs, 8);
+    PutUint(recordPtr + 20, (memUsed < 0) ? UNKNOWN_VALUE : (uint64_t)memUsed, 8);
+    PutUint(recordPtr + 28, (maxMemUsed < 0) ? UNKNOWN_VALUE : (uint64_t)maxMemUsed, 8);
+    PutUint(recordPtr + 36, numEntries, 2);
+    PutUint(recordPtr + 38, nameLen, 1);
+    memcpy(recordPtr + RECORD_HEADER_BYTES, appNamePtr, nameLen);
+
+    // Process entries.
+    uint8_t* entryPtr = recordPtr + RECORD_HEADER_BYTES + nameLen;
+    size_t i;
+
+    for (i = 0; i < numEntries; i++, entryPtr += PROC_ENTRY_BYTES)
+    {
+        uint64_t numThreads = UNKNOWN_VALUE;
+        uint64_t rssKb = UNKNOWN_VALUE;
+        uint64_t cpuTimeMs = UNKNOWN_VALUE;
+
+        ReadProcStat(pids[i], &numThreads, &rssKb, &cpuTimeMs);
+
+        PutUint(entryPtr, pids[i], 4);
+        PutUint(entryPtr + 4, numThreads, 4);
+        PutUint(entryPtr + 8, CountFds(pids[i]), 4);
+        PutUint(entryPtr + 12, rssKb, 4);
+        PutUint(entryPtr + 16, cpuTimeMs, 8);
+    }
+
+    return recordSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples an app, if it is the one being looked for.  Called by apps_ForEachRunningApp().
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleApp
+(
+    app_Ref_t appRef,               ///< [IN] The app.
+    void* contextPtr                ///< [IN] Sampling context.
+)
+{
+    SampleCtx_t* ctxPtr = contextPtr;
+
+    if ( (ctxPtr->appNamePtr != NULL) &&
+         (strncmp(app_GetName(appRef), ctxPtr->appNamePtr, LIMIT_MAX_APP_NAME_BYTES) != 0) )
+    {
+        return;
+    }
+
+    size_t recordSize = BuildRecord(appRef, ctxPtr->recordPtr, ctxPtr->recordSize);
+
+    if (ctxPtr->subPtr != NULL)
+    {
+        ctxPtr->subPtr->handlerFunc(ctxPtr->recordPtr, recordSize, ctxPtr->subPtr->contextPtr);
+    }
+    else
+    {
+        ctxPtr->result = (recordSize == 0) ? LE_OVERFLOW : LE_OK;
+        ctxPtr->recordSize = recordSize;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling timer handler.  Sends a record for each running app to the client's handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerHandler
+(
+    le_timer_Ref_t timerRef         ///< [IN] Sampling timer.
+)
+{
+    Subscription_t* subPtr = le_ref_Lookup(SubscriptionMap, le_timer_GetContextPtr(timerRef));
+
+    if (subPtr == NULL)
+    {
+        LE_ERROR("Sampling timer of a removed handler.");
+        return;
+    }
+
+    uint8_t record[LE_APPSTATS_MAX_RECORD_BYTES];
+    SampleCtx_t ctx = { .subPtr = subPtr, .recordPtr = record, .recordSize = sizeof(record) };
+
+    apps_ForEachRunningApp(SampleApp, &ctx);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a sample handler registration.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteSubscription
+(
+    void* safeRef,                  ///< [IN] Handler reference.
+    Subscription_t* subPtr          ///< [IN] Registration.
+)
+{
+    le_ref_DeleteRef(SubscriptionMap, safeRef);
+    le_timer_Delete(subPtr->timerRef);
+    le_mem_Release(subPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the sample handlers of a client that has disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteClientSubscriptions
+(
+    le_msg_SessionRef_t sessionRef,         ///< Session reference of the client.
+    void*               contextPtr          ///< Not used.
+)
+{
+    le_ref_IterRef_t iter = le_ref_GetIterator(SubscriptionMap);
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        Subscription_t* subPtr = (Subscription_t*)le_ref_GetValue(iter);
+
+        LE_ASSERT(subPtr != NULL);
+
+        if (subPtr->sessionRef == sessionRef)
+        {
+            DeleteSubscription((void*)le_ref_GetSafeRef(iter), subPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the app statistics module.  Must be called after the le_appStats service has been
+ * advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_Init
+(
+    void
+)
+{
+    SubscriptionPool = le_mem_CreatePool("appStatsHandlers", sizeof(Subscription_t));
+    SubscriptionMap = le_ref_CreateMap("AppStatsHandlers", 5);
+
+    le_msg_AddServiceCloseHandler(le_appStats_GetServiceRef(), DeleteClientSubscriptions, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_appStats_Sample'
+ *
+ * Periodic samples of the statistics of the running applications.
+ */
+//--------------------------------------------------------------------------------------------------
+le_appStats_SampleHandlerRef_t le_appStats_AddSampleHandler
+(
+    uint32_t intervalMs,
+        ///< [IN] Sampling interval, in milliseconds.
+
+    le_appStats_SampleHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL.");
+        return NULL;
+    }
+
+    if (intervalMs < LE_APPSTATS_MIN_INTERVAL_MS)
+    {
+        LE_WARN("Sampling interval of %" PRIu32 " ms rounded up to %d ms.",
+                intervalMs, LE_APPSTATS_MIN_INTERVAL_MS);
+        intervalMs = LE_APPSTATS_MIN_INTERVAL_MS;
+    }
+
+    Subscription_t* subPtr = le_mem_ForceAlloc(SubscriptionPool);
+
+    subPtr->handlerFunc = handlerPtr;
+    subPtr->contextPtr = contextPtr;
+    subPtr->sessionRef = le_appStats_GetClientSessionRef();
+
+    void* safeRef = le_ref_CreateRef(SubscriptionMap, subPtr);
+
+    subPtr->timerRef = le_timer_Create("AppStatsSample");
+    LE_ASSERT(le_timer_SetMsInterval(subPtr->timerRef, intervalMs) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(subPtr->timerRef, 0) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(subPtr->timerRef, SampleTimerHandler) == LE_OK);
+    LE_ASSERT(le_timer_SetContextPtr(subPtr->timerRef, safeRef) == LE_OK);
+    LE_ASSERT(le_timer_Start(subPtr->timerRef) == LE_OK);
+
+    return safeRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_appStats_Sample'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_appStats_RemoveSampleHandler
+(
+    le_appStats_SampleHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    Subscription_t* subPtr = le_ref_Lookup(SubscriptionMap, handlerRef);
+
+    if ( (subPtr == NULL) || (subPtr->sessionRef != le_appStats_GetClientSessionRef()) )
+    {
+        LE_ERROR("Invalid sample handler reference %p.", handlerRef);
+        return;
+    }
+
+    DeleteSubscription(handlerRef, subPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a statistics record for a running application.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the application is not running.
+ *      - LE_OVERFLOW if the record buffer is too small to hold the record header.
+ *
+ * @note If the application name pointer is null or if its string is empty or of bad format it is a
+ *       fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_appStats_GetSample
+(
+    const char* appName,
+        ///< [IN] Name of the application.
+
+    uint8_t* recordPtr,
+        ///< [OUT] Statistics record.
+
+    size_t* recordSizePtr
+        ///< [INOUT]
+)
+{
+    if ( (appName == NULL) || (appName[0] == '\0') || (strchr(appName, '/') != NULL) )
+    {
+        LE_KILL_CLIENT("Invalid app name.");
+        return LE_FAULT;
+    }
+
+    SampleCtx_t ctx = { .appNamePtr = appName,
+                        .recordPtr = recordPtr,
+                        .recordSize = *recordSizePtr,
+                        .result = LE_NOT_FOUND };
+
+    apps_ForEachRunningApp(SampleApp, &ctx);
+
+    *recordSizePtr = (ctx.result == LE_OK) ? ctx.recordSize : 0;
+
+    return ctx.result;
+}
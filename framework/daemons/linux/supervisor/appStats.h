@@ -0,0 +1,24 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/appStats.h
+ *
+ * Implementation of the le_appStats API, which reports the resources used by the running apps.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+#define LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the app statistics module.  Must be called after the le_appStats service has been
+ * advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_Init
+(
+    void
+);
+
+
+#endif  // LEGATO_SRC_APP_STATS_INCLUDE_GUARD
@@ -12,6 +12,13 @@
  * An app can be started by either an IPC call or automatically on start-up using the
  * apps_AutoStart() API.
  *
+ * Apps are auto-started in dependency order.  An app that is bound to services served by other
+ * auto-started apps is only started after those apps, so servers get a head start on advertising
+ * their services, while apps that don't depend on each other keep their configured order.  Each
+ * app is started from its own pass through the event loop, so the Supervisor keeps handling IPC
+ * requests and SIGCHLDs while the rest are still being started, and the time taken to start each
+ * app is logged.
+ *
  * When an app is started for the first time a new app container object is created which contains a
  * list link, an app stop handler reference and the app object (which is also instantiated).
  *
@@ -58,6 +65,7 @@
 #include "legato.h"
 #include "apps.h"
 #include "app.h"
+#include "proc.h"
 #include "interfaces.h"
 #include "limit.h"
 #include "wait.h"
@@ -217,6 +225,85 @@ static le_dls_List_t ActiveAppsList = LE_DLS_LIST_INIT;
 static le_dls_List_t InactiveAppsList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of all app containers (active or not), from app reference to app container.  Used with the
+ * process PID index to find the app that a SIGCHLD is about without going through all the apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t AppContainerMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App waiting to be auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;                           ///< Link in the AutoStartList.
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; ///< App name.
+    uint32_t        depth;          ///< Length of the longest chain of auto-started apps that this
+                                    ///  app is bound to services of (directly or indirectly).
+    bool            isDepthKnown;   ///< true once the depth has been computed.
+    bool            isVisiting;     ///< true while the depth is being computed (to spot cycles).
+}
+AutoStartApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for apps waiting to be auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AutoStartAppPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App whose launch descriptor has to be checked (see AppsConfigChangeHandler()).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t   link;                           ///< Link in the list of apps to check.
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; ///< App name.
+}
+LaunchDescCheck_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for apps whose launch descriptor has to be checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LaunchDescCheckPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of apps waiting to be auto-started, in the order that they will be started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t AutoStartList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of apps waiting to be auto-started, by name.  Only used while sorting the AutoStartList.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t AutoStartAppMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time at which apps_AutoStart() was called.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t AutoStartTime;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Application Process object container.
@@ -321,6 +408,8 @@ static void DeleteApp
         }
     }
 
+    le_hashmap_Remove(AppContainerMap, appContainerPtr->appRef);
+
     // Delete any app procs containers in this app.
     DeleteAppProcs(appContainerPtr->appRef, NULL);
 
@@ -510,21 +599,21 @@ static AppContainer_t* GetActiveAppWithProc
     pid_t pid
 )
 {
-    le_dls_Link_t* appLinkPtr = le_dls_Peek(&ActiveAppsList);
+    proc_Ref_t procRef = proc_FindByPid(pid);
 
-    while (appLinkPtr != NULL)
+    if (procRef == NULL)
     {
-        AppContainer_t* appContainerPtr = CONTAINER_OF(appLinkPtr, AppContainer_t, link);
+        return NULL;
+    }
 
-        if (app_HasTopLevelProc(appContainerPtr->appRef, pid))
-        {
-            return appContainerPtr;
-        }
+    AppContainer_t* appContainerPtr = le_hashmap_Get(AppContainerMap, proc_GetAppRef(procRef));
 
-        appLinkPtr = le_dls_PeekNext(&ActiveAppsList, appLinkPtr);
+    if ((appContainerPtr == NULL) || !appContainerPtr->isActive)
+    {
+        return NULL;
     }
 
-    return NULL;
+    return appContainerPtr;
 }
 
 
@@ -614,6 +703,8 @@ static AppContainer_t* CreateApp
     le_dls_Queue(&InactiveAppsList, &(appContainerPtr->link));
     appContainerPtr->isActive = false;
 
+    le_hashmap_Put(AppContainerMap, appRef, appContainerPtr);
+
     le_cfg_CancelTxn(appCfg);
 
     *resultPtr = LE_OK;
@@ -687,6 +778,221 @@ static le_result_t LaunchApp
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Converts a relative time to a number of milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TimeToMs
+(
+    le_clk_Time_t time          ///< [IN] Time to convert.
+)
+{
+    return (uint64_t)time.sec * 1000 + time.usec / 1000;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the depth of an app waiting to be auto-started, from the bindings in its
+ * configuration.  Bindings to apps that aren't being auto-started are ignored.
+ *
+ * @return The app's depth.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetAutoStartDepth
+(
+    AutoStartApp_t* appPtr      ///< [IN] App to compute the depth of.
+)
+{
+    if (appPtr->isDepthKnown)
+    {
+        return appPtr->depth;
+    }
+
+    if (appPtr->isVisiting)
+    {
+        LE_WARN("Application '%s' is part of a cycle of bindings.", appPtr->name);
+        return 0;
+    }
+
+    appPtr->isVisiting = true;
+
+    char configPath[LIMIT_MAX_PATH_BYTES] = { 0 };
+    uint32_t depth = 0;
+
+    if (le_path_Concat("/", configPath, sizeof(configPath),
+                       CFG_NODE_APPS_LIST, appPtr->name, "bindings", (char*)NULL) == LE_OK)
+    {
+        le_cfg_IteratorRef_t bindCfg = le_cfg_CreateReadTxn(configPath);
+
+        if (le_cfg_GoToFirstChild(bindCfg) == LE_OK)
+        {
+            do
+            {
+                char serverName[LIMIT_MAX_APP_NAME_BYTES];
+                AutoStartApp_t* serverPtr;
+
+                if (   (le_cfg_GetString(bindCfg, "app", serverName, sizeof(serverName), "")
+                                                                                        == LE_OK)
+                    && (strcmp(serverName, appPtr->name) != 0)
+                    && ((serverPtr = le_hashmap_Get(AutoStartAppMap, serverName)) != NULL) )
+                {
+                    uint32_t serverDepth = GetAutoStartDepth(serverPtr) + 1;
+
+                    if (serverDepth > depth)
+                    {
+                        depth = serverDepth;
+                    }
+                }
+            }
+            while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
+        }
+
+        le_cfg_CancelTxn(bindCfg);
+    }
+
+    appPtr->isVisiting = false;
+    appPtr->isDepthKnown = true;
+    appPtr->depth = depth;
+
+    return depth;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sorts the AutoStartList by depth, so that apps are started after the apps serving them.  Apps
+ * with the same depth are kept in the same order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SortAutoStartList
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    for (linkPtr = le_dls_Peek(&AutoStartList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&AutoStartList, linkPtr))
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(linkPtr, AutoStartApp_t, link);
+
+        le_hashmap_Put(AutoStartAppMap, appPtr->name, appPtr);
+    }
+
+    // Insertion sort into a new list.  There are few enough apps for this to be fine.
+    le_dls_List_t sortedList = LE_DLS_LIST_INIT;
+
+    while ((linkPtr = le_dls_Pop(&AutoStartList)) != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(linkPtr, AutoStartApp_t, link);
+        uint32_t depth = GetAutoStartDepth(appPtr);
+
+        // Find the last app that goes before this one.
+        le_dls_Link_t* prevLinkPtr = le_dls_PeekTail(&sortedList);
+
+        while (   (prevLinkPtr != NULL)
+               && (CONTAINER_OF(prevLinkPtr, AutoStartApp_t, link)->depth > depth) )
+        {
+            prevLinkPtr = le_dls_PeekPrev(&sortedList, prevLinkPtr);
+        }
+
+        if (prevLinkPtr == NULL)
+        {
+            le_dls_Stack(&sortedList, linkPtr);
+        }
+        else
+        {
+            le_dls_AddAfter(&sortedList, prevLinkPtr, linkPtr);
+        }
+    }
+
+    AutoStartList = sortedList;
+
+    le_hashmap_RemoveAll(AutoStartAppMap);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the next app waiting to be auto-started, then queues itself to start the one after that.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void AutoStartNextApp
+(
+    void* param1Ptr,            ///< [IN] Not used.
+    void* param2Ptr             ///< [IN] Not used.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Pop(&AutoStartList);
+
+    if (linkPtr == NULL)
+    {
+        return;
+    }
+
+    AutoStartApp_t* appPtr = CONTAINER_OF(linkPtr, AutoStartApp_t, link);
+
+    // The app may have been started by an IPC call since apps_AutoStart() was called.
+    if (GetActiveApp(appPtr->name) == NULL)
+    {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+        // No need to check the return code because there is nothing we can do about errors.
+        if (LaunchApp(appPtr->name) == LE_OK)
+        {
+            le_clk_Time_t endTime = le_clk_GetRelativeTime();
+
+            LE_INFO("Application '%s' started in %" PRIu64 " ms, %" PRIu64 " ms after"
+                    " auto-start began (depth %" PRIu32 ").",
+                    appPtr->name,
+                    TimeToMs(le_clk_Sub(endTime, startTime)),
+                    TimeToMs(le_clk_Sub(endTime, AutoStartTime)),
+                    appPtr->depth);
+        }
+    }
+
+    le_mem_Release(appPtr);
+
+    if (le_dls_IsEmpty(&AutoStartList))
+    {
+        LE_INFO("Auto-start complete after %" PRIu64 " ms.",
+                TimeToMs(le_clk_Sub(le_clk_GetRelativeTime(), AutoStartTime)));
+    }
+    else
+    {
+        le_event_QueueFunction(AutoStartNextApp, NULL, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discards the apps that are still waiting to be auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelAutoStart
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&AutoStartList)) != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(linkPtr, AutoStartApp_t, link);
+
+        LE_INFO("Application '%s' not auto-started because of shutdown.", appPtr->name);
+
+        le_mem_Release(appPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handle application fault.  Gets the application fault action for the process that terminated
@@ -787,6 +1093,132 @@ static void DeletesInactiveApp
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the launch descriptor of an app after its configuration has changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLaunchDesc
+(
+    const char* appNamePtr,         ///< [IN] Name of the app.
+    const char* changedNodePtr      ///< [IN] Changed node, relative to the app's node.
+)
+{
+    char configPath[LIMIT_MAX_PATH_BYTES] = { 0 };
+
+    if (le_path_Concat("/", configPath, LIMIT_MAX_PATH_BYTES,
+                       CFG_NODE_APPS_LIST, appNamePtr, (char*)NULL) == LE_OVERFLOW)
+    {
+        LE_ERROR("App name configuration path '%s/%s' too large for internal buffers!",
+                 CFG_NODE_APPS_LIST, appNamePtr);
+        return;
+    }
+
+    AppContainer_t* appContainerPtr = GetActiveApp(appNamePtr);
+
+    if (appContainerPtr == NULL)
+    {
+        appContainerPtr = GetInactiveApp(appNamePtr);
+    }
+
+    app_CheckLaunchDesc(configPath,
+                        (appContainerPtr != NULL) ? appContainerPtr->appRef : NULL,
+                        changedNodePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the apps' configuration has changed, so that launch descriptors that no longer hold
+ * the process settings in the config tree stop being used (see app_CheckLaunchDesc()).
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppsConfigChangeHandler
+(
+    const char* changedPathPtr,     ///< [IN] Deepest node holding all the changes.
+    void* contextPtr                ///< [IN] Not used.
+)
+{
+    // The changes are under "/apps/<appName>/<nodeName>", "/apps/<appName>" or "/apps".
+    const char* appNamePtr = changedPathPtr;
+
+    while (*appNamePtr == '/')
+    {
+        appNamePtr++;
+    }
+
+    size_t appsNodeLen = sizeof(CFG_NODE_APPS_LIST) - 1;
+
+    if (strncmp(appNamePtr, CFG_NODE_APPS_LIST, appsNodeLen) != 0)
+    {
+        return;
+    }
+
+    appNamePtr += appsNodeLen;
+
+    while (*appNamePtr == '/')
+    {
+        appNamePtr++;
+    }
+
+    if (*appNamePtr != '\0')
+    {
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+        const char* nodeNamePtr = strchr(appNamePtr, '/');
+        size_t appNameLen = (nodeNamePtr != NULL) ? (size_t)(nodeNamePtr - appNamePtr)
+                                                  : strlen(appNamePtr);
+
+        if (appNameLen >= sizeof(appName))
+        {
+            return;
+        }
+
+        memcpy(appName, appNamePtr, appNameLen);
+        appName[appNameLen] = '\0';
+
+        CheckLaunchDesc(appName, (nodeNamePtr != NULL) ? nodeNamePtr + 1 : "");
+        return;
+    }
+
+    // Changes to more than one app.  Get their names first, as the checks can't write to the
+    // config tree while the list is being read.
+    le_sls_List_t appList = LE_SLS_LIST_INIT;
+    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
+
+    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    {
+        do
+        {
+            LaunchDescCheck_t* checkPtr = le_mem_ForceAlloc(LaunchDescCheckPool);
+
+            checkPtr->link = LE_SLS_LINK_INIT;
+
+            if (le_cfg_GetNodeName(appCfg, "", checkPtr->name, sizeof(checkPtr->name)) == LE_OK)
+            {
+                le_sls_Queue(&appList, &checkPtr->link);
+            }
+            else
+            {
+                le_mem_Release(checkPtr);
+            }
+        }
+        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(appCfg);
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&appList)) != NULL)
+    {
+        LaunchDescCheck_t* checkPtr = CONTAINER_OF(linkPtr, LaunchDescCheck_t, link);
+
+        CheckLaunchDesc(checkPtr->name, "");
+        le_mem_Release(checkPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes all inactive app objects.
@@ -1139,10 +1571,23 @@ void apps_Init
     AppProcMap = le_ref_CreateMap("AppProcs", 5);
     AppMap = le_ref_CreateMap("App", 5);
     AppAttachHandlerMap = le_ref_CreateMap("AppAttachHandlers", 5);
+    AutoStartAppPool = le_mem_CreatePool("autoStartApps", sizeof(AutoStartApp_t));
+    LaunchDescCheckPool = le_mem_CreatePool("launchDescChecks", sizeof(LaunchDescCheck_t));
+    AutoStartAppMap = le_hashmap_Create("AutoStartApps",
+                                        31,
+                                        le_hashmap_HashString,
+                                        le_hashmap_EqualsString);
+    AppContainerMap = le_hashmap_Create("AppContainers",
+                                        31,
+                                        le_hashmap_HashVoidPointer,
+                                        le_hashmap_EqualsVoidPointer);
 
     le_instStat_AddAppUninstallEventHandler(DeletesInactiveApp, NULL);
     le_instStat_AddAppInstallEventHandler(DeletesInactiveApp, NULL);
 
+    // Stop using launch descriptors that are out of date with the config tree.
+    le_cfg_AddChangeSummaryHandler(CFG_NODE_APPS_LIST, AppsConfigChangeHandler, NULL);
+
     le_msg_AddServiceCloseHandler(le_appProc_GetServiceRef(), DeleteClientAppProcs, NULL);
 
     le_msg_AddServiceCloseHandler(le_appCtrl_GetServiceRef(), ReleaseClientAppRefs, NULL);
@@ -1171,6 +1616,9 @@ void apps_Shutdown
     void
 )
 {
+    // Don't start any more apps.
+    CancelAutoStart();
+
     // Deletes all inactive apps first.
     DeletesAllInactiveApp();
 
@@ -1230,7 +1678,8 @@ void apps_SetShutdownHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start all applications marked as 'auto' start.
+ * Start all applications marked as 'auto' start.  The apps are started asynchronously, in
+ * dependency order.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
@@ -1238,6 +1687,8 @@ void apps_AutoStart
     void
 )
 {
+    AutoStartTime = le_clk_GetRelativeTime();
+
     // Read the list of applications from the config tree.
     le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
 
@@ -1266,15 +1717,27 @@ void apps_AutoStart
             }
             else
             {
-                // Launch the application now.  No need to check the return code because there is
-                // nothing we can do about errors.
-                LaunchApp(appName);
+                // Queue the application to be launched.
+                AutoStartApp_t* appPtr = le_mem_ForceAlloc(AutoStartAppPool);
+
+                memset(appPtr, 0, sizeof(*appPtr));
+                appPtr->link = LE_DLS_LINK_INIT;
+                le_utf8_Copy(appPtr->name, appName, sizeof(appPtr->name), NULL);
+
+                le_dls_Queue(&AutoStartList, &appPtr->link);
             }
         }
     }
     while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
 
     le_cfg_CancelTxn(appCfg);
+
+    if (!le_dls_IsEmpty(&AutoStartList))
+    {
+        SortAutoStartList();
+
+        le_event_QueueFunction(AutoStartNextApp, NULL, NULL);
+    }
 }
 
 
@@ -1376,6 +1839,35 @@ void apps_VerifyAppWriteableDeviceFiles
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a function for each running application.
+ *
+ * @note The function must not start or stop applications.
+ */
+//--------------------------------------------------------------------------------------------------
+void apps_ForEachRunningApp
+(
+    apps_AppFunc_t func,                    ///< [IN] Function to call.
+    void* contextPtr                        ///< [IN] Context to pass to the function.
+)
+{
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&ActiveAppsList);
+
+    while (appLinkPtr != NULL)
+    {
+        AppContainer_t* appContainerPtr = CONTAINER_OF(appLinkPtr, AppContainer_t, link);
+
+        if (app_GetState(appContainerPtr->appRef) == APP_STATE_RUNNING)
+        {
+            func(appContainerPtr->appRef, contextPtr);
+        }
+
+        appLinkPtr = le_dls_PeekNext(&ActiveAppsList, appLinkPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a reference to an application.
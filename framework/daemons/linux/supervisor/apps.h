@@ -8,6 +8,8 @@
 #ifndef LEGATO_SRC_APPS_INCLUDE_GUARD
 #define LEGATO_SRC_APPS_INCLUDE_GUARD
 
+#include "app.h"
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -20,6 +22,18 @@ typedef void (*apps_ShutdownHandler_t)
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for functions called by apps_ForEachRunningApp().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*apps_AppFunc_t)
+(
+    app_Ref_t appRef,                       ///< [IN] The app.
+    void* contextPtr                        ///< [IN] Context passed to apps_ForEachRunningApp().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the applications system.
@@ -33,7 +47,8 @@ void apps_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start all applications marked as 'auto' start.
+ * Start all applications marked as 'auto' start.  The apps are started asynchronously, in
+ * dependency order.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
@@ -99,4 +114,18 @@ void apps_VerifyAppWriteableDeviceFiles
     void
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a function for each running application.
+ *
+ * @note The function must not start or stop applications.
+ */
+//--------------------------------------------------------------------------------------------------
+void apps_ForEachRunningApp
+(
+    apps_AppFunc_t func,                    ///< [IN] Function to call.
+    void* contextPtr                        ///< [IN] Context to pass to the function.
+);
+
 #endif  // LEGATO_SRC_APPS_INCLUDE_GUARD
@@ -3,6 +3,13 @@
  *
  * API for managing Legato-bundled kernel modules.
  *
+ * Modules are inserted by the Supervisor itself, using finit_module(2), rather than by running
+ * insmod for each of them.  The modules that each module depends on are read from the "depends"
+ * field of its .modinfo ELF section (the same information depmod uses), and a module is only
+ * inserted once all of the bundled modules it depends on have been inserted.  Modules that don't
+ * depend on each other are inserted at the same time by a few worker threads, as module
+ * initialization functions often spend most of their time waiting for hardware.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 #include "legato.h"
@@ -13,58 +20,65 @@
 #include "kernelModules.h"
 #include "le_cfg_interface.h"
 
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Memory pool size for module objects and strings
+ * Memory pool size for module objects
  */
 //--------------------------------------------------------------------------------------------------
 #define KMODULE_DEFAULT_POOL_SIZE 8
-#define STRINGS_DEFAULT_POOL_SIZE 8
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of parameters passed to a kernel module during insmod.
+ * Maximum size of a module's parameter string, in the form of "<name>=<value> <name>=<value>...",
+ * including the null terminator.
  */
 //--------------------------------------------------------------------------------------------------
-#define KMODULE_MAX_ARGC 256
+#define KMODULE_MAX_PARAMS_BYTES 2048
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum parameter string buffer size in the form of "<name>=<value>\0".
- * Use maximum name and string value size from configTree.
- * Allow extra space (2 bytes) for enclosing value in quotes, if necessary.
+ * Maximum number of bundled modules that a module can depend on.
  */
 //--------------------------------------------------------------------------------------------------
-#define STRINGS_MAX_BUFFER_SIZE (LE_CFG_NAME_LEN + LE_CFG_STR_LEN + 2 + 2)
+#define KMODULE_MAX_DEPS 16
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Root of configTree containing module parameters
+ * Maximum number of threads inserting modules at the same time.
  */
 //--------------------------------------------------------------------------------------------------
-#define KMODULE_CONFIG_TREE_ROOT "/modules"
+#define KMODULE_MAX_LOAD_THREADS 4
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Module insert command and format, arguments are module path and module params
+ * Root of configTree containing module parameters
  */
 //--------------------------------------------------------------------------------------------------
-#define INSMOD_COMMAND "/sbin/insmod"
-#define INSMOD_COMMAND_FORMAT INSMOD_COMMAND" %s %s"
+#define KMODULE_CONFIG_TREE_ROOT "/modules"
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Module remove command and format, argument is module name
+ * State of a kernel module while the modules are being inserted.
  */
 //--------------------------------------------------------------------------------------------------
-#define RMMOD_COMMAND "/sbin/rmmod"
-#define RMMOD_COMMAND_FORMAT RMMOD_COMMAND" %s"
+typedef enum
+{
+    KMODULE_STATE_WAITING,      // Waiting for the modules it depends on to be inserted
+    KMODULE_STATE_READY,        // On the ready queue
+    KMODULE_STATE_INSERTED,     // Inserted (or was already in the kernel)
+    KMODULE_STATE_FAILED        // Couldn't be inserted, or a module it depends on couldn't be
+}
+KModuleState_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -73,13 +87,17 @@
  */
 //--------------------------------------------------------------------------------------------------
 #define KMODULE_OBJECT_COOKIE 0x71a89c35
-typedef struct
+typedef struct KModuleObj
 {
     uint32_t        cookie;                     // KModuleObj_t identifier
-    char            *name;                      // Module name
+    char            name[LIMIT_MAX_PATH_BYTES]; // Module name, as the kernel knows it
     char            path[LIMIT_MAX_PATH_BYTES]; // Path to module's .ko file
-    int             argc;                       // insmod/rmmod argc
-    char            *argv[KMODULE_MAX_ARGC];    // insmod/rmmod argv
+    char            params[KMODULE_MAX_PARAMS_BYTES]; // Module parameters
+    KModuleState_t  state;                      // Insertion state
+    struct KModuleObj *deps[KMODULE_MAX_DEPS];  // Bundled modules this one depends on
+    size_t          numDeps;                    // Number of entries in deps
+    size_t          numDepsLeft;                // Number of deps not inserted yet
+    bool            isOrdered;                  // Used to find dependency cycles
     le_dls_Link_t   listLink;
 }
 KModuleObj_t;
@@ -92,28 +110,55 @@ KModuleObj_t;
 //--------------------------------------------------------------------------------------------------
 static struct {
     le_mem_PoolRef_t    modulePool;    // memory pool of KModuleObj_t objects
-    le_mem_PoolRef_t    stringPool;    // memory pool of strings (for argv)
     le_dls_List_t       moduleList;    // List of modules stored in order they were inserted
-} KModuleHandler = {NULL, NULL, LE_DLS_LIST_INIT};
+    le_dls_List_t       pendingList;   // Modules not inserted yet (while inserting)
+    le_dls_List_t       readyList;     // Modules whose dependencies are inserted (while inserting)
+    le_dls_List_t       failedList;    // Modules that failed (while inserting)
+    size_t              numLeft;       // Number of modules not finished yet (while inserting)
+    le_mutex_Ref_t      mutex;         // Protects the lists and states while inserting
+    le_sem_Ref_t        readySem;      // Posted for each module put on the ready list
+} KModuleHandler = {NULL, LE_DLS_LIST_INIT, LE_DLS_LIST_INIT, LE_DLS_LIST_INIT, LE_DLS_LIST_INIT,
+                    0, NULL, NULL};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a module name to the form the kernel uses, where '-' is replaced by '_'.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NormalizeModuleName(char *name)
+{
+    for (; *name != '\0'; name++)
+    {
+        if (*name == '-')
+        {
+            *name = '_';
+        }
+    }
+}
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Populate list of module parameters
+ * Read module parameters from the configTree into the module's parameter string.
  */
 //--------------------------------------------------------------------------------------------------
 static void ModuleGetParams(KModuleObj_t *module)
 {
-    char *p;
     char cfgTreePath[LE_CFG_STR_LEN_BYTES];
-    char tmp[LE_CFG_STR_LEN_BYTES];
+    char paramName[LE_CFG_NAME_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
     le_cfg_IteratorRef_t iter;
+    size_t len = 0;
 
     cfgTreePath[0] = '\0';
     le_path_Concat("/", cfgTreePath, LE_CFG_STR_LEN_BYTES,
-                   KMODULE_CONFIG_TREE_ROOT, module->name, "params", NULL);
+                   KMODULE_CONFIG_TREE_ROOT, le_path_GetBasenamePtr(module->path, "/"),
+                   "params", NULL);
     iter = le_cfg_CreateReadTxn(cfgTreePath);
 
+    module->params[0] = '\0';
+
     if (LE_OK != le_cfg_GoToFirstChild(iter))
     {
         LE_INFO("Module %s uses no parameters.", module->name);
@@ -121,132 +166,510 @@ static void ModuleGetParams(KModuleObj_t *module)
         return;
     }
 
-    /* Populate parameters list from configTree; careful not to overrun array */
+    /* Append each parameter as name=value, separated by spaces; careful not to overrun buffer */
     do
     {
-        /* allocate and clear string buffer */
-        p = (char*)le_mem_ForceAlloc(KModuleHandler.stringPool);
-        memset(p, 0, STRINGS_MAX_BUFFER_SIZE);
-        module->argv[module->argc] = p;
+        LE_ASSERT_OK(le_cfg_GetNodeName(iter, "", paramName, sizeof(paramName)));
+        LE_ASSERT_OK(le_cfg_GetString(iter, "", value, sizeof(value), ""));
 
-        /* first get the parameter name, append a '=' and advance to end */
-        LE_ASSERT_OK(le_cfg_GetNodeName(iter, "", p, LE_CFG_NAME_LEN_BYTES));
-        p[strlen(p)] = '=';
-        p += strlen(p);
+        /* enclose the value in quotes if it contains white space */
+        int n = snprintf(module->params + len, sizeof(module->params) - len,
+                         strpbrk(value, " \t\n") ? "%s%s=\"%s\"" : "%s%s=%s",
+                         (len == 0) ? "" : " ", paramName, value);
 
-        /* now get the parameter value, should be string */
-        LE_ASSERT_OK(le_cfg_GetString(iter, "", tmp, LE_CFG_STR_LEN_BYTES, ""));
-
-        /* enclose the parameter in quotes if it contains white space */
-        if (strpbrk(tmp, " \t\n"))
+        if ((n < 0) || ((size_t)n >= sizeof(module->params) - len))
         {
-            /* add space for quotes; likely ok to use sprintf, but anyway... */
-            snprintf(p, LE_CFG_STR_LEN_BYTES + 2, "\"%s\"", tmp);
-            p += strlen(tmp) + 2;
+            /* Drop the parameter that didn't fit */
+            module->params[len] = '\0';
+            LE_WARN("Parameters list truncated for module '%s'", module->name);
+            break;
         }
-        else
+
+        len += n;
+    }
+    while (LE_OK == le_cfg_GoToNextSibling(iter));
+
+    le_cfg_CancelTxn(iter);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the .modinfo section of a kernel module image.
+ *
+ * @return Pointer to the section, or NULL if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *FindModInfo
+(
+    const uint8_t *image,   ///< [IN] Module's ELF image.
+    size_t size,            ///< [IN] Size of the image.
+    size_t *lenPtr          ///< [OUT] Size of the section.
+)
+{
+    uint64_t shOff, shStrOff, offset, secSize, nameOff;
+    size_t shEntSize, shNum, shStrNdx, i;
+
+    if ((size < EI_NIDENT) || (memcmp(image, ELFMAG, SELFMAG) != 0))
+    {
+        return NULL;
+    }
+
+    /* Section headers are read in place, so only the fields' sizes depend on the ELF class. */
+#define ELF_FIELD(cls, type, ptr, field) ((const cls##_##type *)(ptr))->field
+#define READ_SECTIONS(cls)                                                                      \
+    if (size < sizeof(cls##_Ehdr)) return NULL;                                                 \
+    shOff = ELF_FIELD(cls, Ehdr, image, e_shoff);                                               \
+    shEntSize = ELF_FIELD(cls, Ehdr, image, e_shentsize);                                       \
+    shNum = ELF_FIELD(cls, Ehdr, image, e_shnum);                                               \
+    shStrNdx = ELF_FIELD(cls, Ehdr, image, e_shstrndx);                                         \
+    if ((shEntSize < sizeof(cls##_Shdr)) || (shStrNdx >= shNum) ||                              \
+        (shOff > size) || ((size - shOff) / shEntSize < shNum)) return NULL;                    \
+    shStrOff = ELF_FIELD(cls, Shdr, image + shOff + shStrNdx * shEntSize, sh_offset);           \
+    for (i = 0; i < shNum; i++)                                                                 \
+    {                                                                                           \
+        const uint8_t *shPtr = image + shOff + i * shEntSize;                                   \
+        nameOff = shStrOff + ELF_FIELD(cls, Shdr, shPtr, sh_name);                              \
+        offset = ELF_FIELD(cls, Shdr, shPtr, sh_offset);                                        \
+        secSize = ELF_FIELD(cls, Shdr, shPtr, sh_size);                                         \
+        if ((nameOff < size) && (strncmp((const char *)image + nameOff, ".modinfo",             \
+                                         size - nameOff) == 0) &&                               \
+            (offset <= size) && (secSize <= size - offset))                                     \
+        {                                                                                       \
+            *lenPtr = secSize;                                                                  \
+            return (const char *)image + offset;                                                \
+        }                                                                                       \
+    }
+
+    if (image[EI_CLASS] == ELFCLASS64)
+    {
+        READ_SECTIONS(Elf64)
+    }
+    else if (image[EI_CLASS] == ELFCLASS32)
+    {
+        READ_SECTIONS(Elf32)
+    }
+
+#undef READ_SECTIONS
+#undef ELF_FIELD
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the comma-separated list of the modules a kernel module depends on from its .modinfo
+ * section.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ModuleGetDepends
+(
+    const KModuleObj_t *module,     ///< [IN] Module.
+    char *buffPtr,                  ///< [OUT] Buffer for the list (empty if none).
+    size_t buffSize                 ///< [IN] Size of the buffer.
+)
+{
+    struct stat st;
+    const char *infoPtr;
+    size_t infoLen = 0;
+
+    buffPtr[0] = '\0';
+
+    int fd = open(module->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LE_CRIT("Can't open '%s'. (%m)", module->path);
+        return;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+    {
+        LE_CRIT("Can't read '%s'. (%m)", module->path);
+        fd_Close(fd);
+        return;
+    }
+
+    const uint8_t *image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    fd_Close(fd);
+    if (image == MAP_FAILED)
+    {
+        LE_CRIT("Can't map '%s'. (%m)", module->path);
+        return;
+    }
+
+    infoPtr = FindModInfo(image, st.st_size, &infoLen);
+    if (infoPtr == NULL)
+    {
+        LE_WARN("No module information in '%s'; assuming no dependencies.", module->path);
+    }
+    else
+    {
+        /* .modinfo is a list of null-terminated "key=value" strings */
+        const char *endPtr = infoPtr + infoLen;
+        while (infoPtr < endPtr)
         {
-            strcpy(p, tmp);
-            p += strlen(tmp);
+            size_t len = strnlen(infoPtr, endPtr - infoPtr);
+            if ((len > 8) && (strncmp(infoPtr, "depends=", 8) == 0))
+            {
+                if (len - 8 >= buffSize)
+                {
+                    LE_CRIT("Dependency list of '%s' is too long.", module->name);
+                }
+                else
+                {
+                    memcpy(buffPtr, infoPtr + 8, len - 8);
+                    buffPtr[len - 8] = '\0';
+                }
+                break;
+            }
+            infoPtr += len + 1;
         }
+    }
+
+    munmap((void *)image, st.st_size);
+}
+
 
-        /* increment parameter counter */
-        module->argc++;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a module that is being inserted by its name.
+ *
+ * @return The module, or NULL if it isn't bundled.
+ */
+//--------------------------------------------------------------------------------------------------
+static KModuleObj_t *FindPendingModule(const char *name)
+{
+    le_dls_Link_t *linkPtr;
+
+    for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr))
+    {
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+        if (strcmp(m->name, name) == 0)
+        {
+            return m;
+        }
     }
-    while((KMODULE_MAX_ARGC > (module->argc + 1)) &&
-          (LE_OK == le_cfg_GoToNextSibling(iter)));
 
-    le_cfg_CancelTxn(iter);
+    return NULL;
+}
+
 
-    /* Last argument to execv must be null */
-    module->argv[module->argc] = NULL;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill in the bundled modules that a module depends on.  Dependencies that aren't bundled are
+ * assumed to be built into the kernel, or loaded by the system before Legato starts.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ModuleResolveDepends(KModuleObj_t *module)
+{
+    char depends[LIMIT_MAX_PATH_BYTES * 2];
+    char *savePtr = NULL;
+    char *depName;
+
+    ModuleGetDepends(module, depends, sizeof(depends));
+
+    for (depName = strtok_r(depends, ",", &savePtr);
+         depName != NULL;
+         depName = strtok_r(NULL, ",", &savePtr))
+    {
+        NormalizeModuleName(depName);
+
+        KModuleObj_t *depPtr = FindPendingModule(depName);
+        if (depPtr == NULL)
+        {
+            LE_DEBUG("Module '%s' depends on '%s', which isn't bundled.", module->name, depName);
+        }
+        else if (module->numDeps >= KMODULE_MAX_DEPS)
+        {
+            LE_CRIT("Module '%s' depends on too many modules; ignoring '%s'.",
+                    module->name, depName);
+        }
+        else
+        {
+            module->deps[module->numDeps++] = depPtr;
+        }
+    }
 
-    if (KMODULE_MAX_ARGC <= module->argc + 1)
-        LE_WARN("Parameters list truncated for module '%s'", module->name);
+    module->numDepsLeft = module->numDeps;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Free list of module parameters
+ * Drop the dependencies that would stop modules from ever being inserted, because they go round
+ * in a cycle.
  */
 //--------------------------------------------------------------------------------------------------
-static void ModuleFreeParams(KModuleObj_t *module)
+static void BreakDependencyCycles(void)
 {
-    char **p;
+    le_dls_Link_t *linkPtr;
+    bool isProgress;
 
-    module->argv[0] = NULL; // Contained exec'ed command, not allocated
-    module->argv[1] = NULL; // Contained module path/name, not allocated
+    /* Order the modules whose dependencies are all ordered, until no more can be. */
+    do
+    {
+        isProgress = false;
 
-    /* Iterate through remaining parameters and free buffers */
-    p = module->argv + 2;
-    while (NULL != *p)
+        for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+             linkPtr != NULL;
+             linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr))
+        {
+            KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+            size_t i;
+
+            if (!m->isOrdered)
+            {
+                for (i = 0; (i < m->numDeps) && m->deps[i]->isOrdered; i++)
+                {
+                }
+                if (i == m->numDeps)
+                {
+                    m->isOrdered = true;
+                    isProgress = true;
+                }
+            }
+        }
+    }
+    while (isProgress);
+
+    /* The rest are in a cycle, or wait for one; only keep their dependencies that are ordered. */
+    for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr))
     {
-        le_mem_Release(*p);
-        *p = NULL;
-        p++;
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+        size_t i, j;
+
+        if (!m->isOrdered)
+        {
+            LE_CRIT("Module '%s' is part of a dependency cycle; ignoring its dependencies.",
+                    m->name);
+            for (i = 0, j = 0; i < m->numDeps; i++)
+            {
+                if (m->deps[i]->isOrdered)
+                {
+                    m->deps[j++] = m->deps[i];
+                }
+            }
+            m->numDeps = j;
+            m->numDepsLeft = j;
+        }
     }
+}
+
 
-    /* Reset number of parameters */
-    module->argc = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a module on the ready list, to be picked up by a worker thread.
+ *
+ * @note Must be called with the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ModuleMakeReady(KModuleObj_t *module)
+{
+    module->state = KMODULE_STATE_READY;
+    le_dls_Remove(&KModuleHandler.pendingList, &module->listLink);
+    le_dls_Queue(&KModuleHandler.readyList, &module->listLink);
+    le_sem_Post(KModuleHandler.readySem);
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Build and execute the insmod/rmmod command
+ * Record that a module has been inserted (or failed to be), and make ready the modules waiting
+ * for it.  Modules depending on a module that failed fail as well.
+ *
+ * @note Must be called with the mutex locked.
  */
 //--------------------------------------------------------------------------------------------------
-static void ExecuteCommand(char *command, char *modulePath, char *argv[])
+static void ModuleFinish(KModuleObj_t *module, bool isInserted)
 {
-    pid_t pid, p;
-    int result;
+    le_dls_Link_t *linkPtr;
 
-    argv[0] = command;  /* First argument is always the command */
-    LE_DEBUG("Execute '%s %s'", argv[0], argv[1]);
+    module->state = isInserted ? KMODULE_STATE_INSERTED : KMODULE_STATE_FAILED;
+    KModuleHandler.numLeft--;
 
-    pid = fork();
-    LE_FATAL_IF(-1 == pid, "fork() failed. (%m)");
+    if (!isInserted)
+    {
+        /* Kept until all modules are done, as the modules waiting for it check its state. */
+        le_dls_Queue(&KModuleHandler.failedList, &module->listLink);
+    }
 
-    if (0 == pid)
+    /* Count this module as done in the modules waiting for it. */
+    for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr))
     {
-        /* Child, exec command. */
-        execv(argv[0], argv);
-        /* Should never be here. */
-        LE_FATAL("Failed to run '%s %s'. (%m)", argv[0], argv[1]);
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+        size_t i;
+
+        for (i = 0; i < m->numDeps; i++)
+        {
+            if (m->deps[i] == module)
+            {
+                m->numDepsLeft--;
+            }
+        }
     }
 
-    /* Wait for command to complete; restart on EINTR. */
-    while (-1 == (p = waitpid(pid, &result, 0)) && EINTR == errno);
-    if (p != pid)
+    /* Then deal with those that have nothing left to wait for.  The list changes each time. */
+    linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+    while (linkPtr != NULL)
     {
-        if (p == -1)
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+
+        if (m->numDepsLeft != 0)
+        {
+            linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr);
+            continue;
+        }
+
+        bool isDepFailed = false;
+        size_t i;
+
+        for (i = 0; i < m->numDeps; i++)
         {
-            LE_FATAL("waitpid() failed: %m");
+            isDepFailed |= (m->deps[i]->state == KMODULE_STATE_FAILED);
+        }
+
+        if (isDepFailed)
+        {
+            LE_CRIT("Not inserting module '%s', as a module it depends on failed.", m->name);
+            le_dls_Remove(&KModuleHandler.pendingList, &m->listLink);
+            ModuleFinish(m, false);
         }
         else
         {
-            LE_FATAL("waitpid() returned unexpected result %d", p);
+            ModuleMakeReady(m);
+        }
+
+        linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+    }
+
+    /* Release the worker threads once everything is done. */
+    if (KModuleHandler.numLeft == 0)
+    {
+        int i;
+        for (i = 0; i < KMODULE_MAX_LOAD_THREADS; i++)
+        {
+            le_sem_Post(KModuleHandler.readySem);
         }
     }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Insert a module into the kernel.
+ *
+ * @return true if the module is in the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ModuleLoad(KModuleObj_t *module)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    int result;
+
+    int fd = open(module->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LE_CRIT("Can't open '%s'. (%m)", module->path);
+        return false;
+    }
+
+    result = syscall(SYS_finit_module, fd, module->params, 0);
+
+    /* Kernels older than 3.8 only take the module image */
+    if ((result != 0) && (errno == ENOSYS))
+    {
+        struct stat st;
+        void *image = MAP_FAILED;
+
+        if (fstat(fd, &st) == 0)
+        {
+            image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        if (image == MAP_FAILED)
+        {
+            LE_CRIT("Can't read '%s'. (%m)", module->path);
+            fd_Close(fd);
+            return false;
+        }
+
+        result = syscall(SYS_init_module, image, (unsigned long)st.st_size, module->params);
+        munmap(image, st.st_size);
+    }
 
-    /* Check exit status and errors */
-    if (WIFSIGNALED(result))
+    int savedErrno = errno;
+    fd_Close(fd);
+
+    if (result != 0)
     {
-        LE_CRIT("%s was killed by a signal %d.", argv[0], WTERMSIG(result));
+        if (savedErrno == EEXIST)
+        {
+            LE_INFO("Kernel module '%s' is already inserted.", module->name);
+            return true;
+        }
+
+        LE_CRIT("Failed to insert kernel module '%s'. (%s)", module->name, strerror(savedErrno));
+        return false;
     }
-    else if (WIFEXITED(result) && WEXITSTATUS(result) != EXIT_SUCCESS)
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    LE_INFO("New kernel module '%s' (initialized in %ld ms)",
+            module->name, (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread inserting ready modules until all of them are done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *LoadThreadMain(void *contextPtr)
+{
+    for (;;)
     {
-        LE_CRIT("%s exited with error code %d.", argv[0], WEXITSTATUS(result));
+        le_sem_Wait(KModuleHandler.readySem);
+
+        le_mutex_Lock(KModuleHandler.mutex);
+        le_dls_Link_t *linkPtr = le_dls_Pop(&KModuleHandler.readyList);
+        le_mutex_Unlock(KModuleHandler.mutex);
+
+        /* Only released without a module to insert once all of them are done. */
+        if (linkPtr == NULL)
+        {
+            return NULL;
+        }
+
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+        LE_ASSERT(KMODULE_OBJECT_COOKIE == m->cookie);
+
+        bool isInserted = ModuleLoad(m);
+
+        le_mutex_Lock(KModuleHandler.mutex);
+        if (isInserted)
+        {
+            /* Dependencies finish first, so this list can be removed from the tail. */
+            le_dls_Queue(&KModuleHandler.moduleList, &m->listLink);
+        }
+        ModuleFinish(m, isInserted);
+        le_mutex_Unlock(KModuleHandler.mutex);
     }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Insert a module with a given module file name
+ * Create a module object for a given module file name.
  */
 //--------------------------------------------------------------------------------------------------
-static void ModuleInsert(struct dirent *entry)
+static void ModuleCreate(struct dirent *entry)
 {
     KModuleObj_t *m;
     char *ext;
@@ -261,28 +684,19 @@ static void ModuleInsert(struct dirent *entry)
                                 entry->d_name,
                                 NULL));
     m->cookie = KMODULE_OBJECT_COOKIE;
-    m->name = le_path_GetBasenamePtr(m->path, "/");
-
-    /* Now build a parameter list that will be sent to execv */
-    m->argv[0] = NULL;      /* First: reserved for execv command */
-    m->argv[1] = m->path;   /* Second: file/module path */
-    m->argc = 2;
-    ModuleGetParams(m);       /* Read remaining parameters from configTree */
-
-    /* Run insmod commands. */
-    ExecuteCommand(INSMOD_COMMAND, m->path, m->argv);
+    m->state = KMODULE_STATE_WAITING;
 
-    /* Free parameters - they did their job */
-    ModuleFreeParams(m);
-
-    /* Trim off the extension from path/name and store module record in list */
-    ext = le_path_FindTrailing(m->path, KERNEL_MODULE_FILE_EXTENSION);
+    /* Module name is the file name without the extension */
+    LE_ASSERT_OK(le_utf8_Copy(m->name, entry->d_name, sizeof(m->name), NULL));
+    ext = le_path_FindTrailing(m->name, KERNEL_MODULE_FILE_EXTENSION);
     LE_ASSERT(ext != NULL);
     *ext = '\0';
-    m->listLink = LE_DLS_LINK_INIT;
-    le_dls_Queue(&KModuleHandler.moduleList, &m->listLink);
+    NormalizeModuleName(m->name);
 
-    LE_INFO("New kernel module '%s'", m->name);
+    ModuleGetParams(m);       /* Read parameters from configTree */
+
+    m->listLink = LE_DLS_LINK_INIT;
+    le_dls_Queue(&KModuleHandler.pendingList, &m->listLink);
 }
 
 
@@ -307,26 +721,90 @@ static int IsKernelModule
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Traverse module directory and insmod all modules in alphabetical order.
+ * Insert all modules in the module directory, each one after the bundled modules it depends on.
  */
 //--------------------------------------------------------------------------------------------------
 void kernelModules_Insert(void)
 {
     struct dirent **entryList;
+    le_thread_Ref_t threads[KMODULE_MAX_LOAD_THREADS];
+    le_dls_Link_t *linkPtr;
+    le_dls_Link_t *nextLinkPtr;
+    int numThreads;
     int i;
 
     LE_DEBUG("Inserting kernel module files (*" KERNEL_MODULE_FILE_EXTENSION
         ") from " SYSTEM_MODULE_PATH "...");
 
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
     int scanRes = scandir(SYSTEM_MODULE_PATH, &entryList, IsKernelModule, alphasort);
     LE_FATAL_IF(scanRes < 0, "Error reading modules directory: %m");
     for (i = 0; i < scanRes; i++)
     {
-        LE_DEBUG("Inserting kernel module '%s'.", entryList[i]->d_name);
-        ModuleInsert(entryList[i]);
+        ModuleCreate(entryList[i]);
         free(entryList[i]);
     }
     free(entryList);
+
+    if (scanRes == 0)
+    {
+        return;
+    }
+
+    /* Build the dependency graph once all the modules are known, and break any cycles. */
+    for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr))
+    {
+        ModuleResolveDepends(CONTAINER_OF(linkPtr, KModuleObj_t, listLink));
+    }
+    BreakDependencyCycles();
+
+    /* Start with the modules that don't depend on any other bundled module. */
+    KModuleHandler.numLeft = scanRes;
+    for (linkPtr = le_dls_Peek(&KModuleHandler.pendingList); linkPtr != NULL; linkPtr = nextLinkPtr)
+    {
+        KModuleObj_t *m = CONTAINER_OF(linkPtr, KModuleObj_t, listLink);
+
+        nextLinkPtr = le_dls_PeekNext(&KModuleHandler.pendingList, linkPtr);
+
+        if (m->numDepsLeft == 0)
+        {
+            ModuleMakeReady(m);
+        }
+    }
+
+    numThreads = (scanRes < KMODULE_MAX_LOAD_THREADS) ? scanRes : KMODULE_MAX_LOAD_THREADS;
+    for (i = 0; i < numThreads; i++)
+    {
+        char name[LIMIT_MAX_THREAD_NAME_BYTES];
+        snprintf(name, sizeof(name), "kmodLoad%d", i);
+        threads[i] = le_thread_Create(name, LoadThreadMain, NULL);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+    }
+    for (i = 0; i < numThreads; i++)
+    {
+        le_thread_Join(threads[i], NULL);
+    }
+
+    /* Drain the posts meant for the threads that weren't needed. */
+    while (le_sem_TryWait(KModuleHandler.readySem) == LE_OK)
+    {
+    }
+
+    LE_ASSERT(le_dls_IsEmpty(&KModuleHandler.pendingList));
+
+    while ((linkPtr = le_dls_Pop(&KModuleHandler.failedList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, KModuleObj_t, listLink));
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    LE_INFO("Inserted %zu of %d kernel modules in %ld ms.",
+            le_dls_NumLinks(&KModuleHandler.moduleList), scanRes,
+            (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
 }
 
 
@@ -346,18 +824,15 @@ void kernelModules_Remove(void)
         KModuleObj_t *m = CONTAINER_OF(listLink, KModuleObj_t, listLink);
         LE_ASSERT(KMODULE_OBJECT_COOKIE == m->cookie);
 
-        /* Populate argv for rmmod */
-        m->argv[0] = NULL;     /* Reserved for rmmod command */
-        m->argv[1] = m->name;  /* Second argument is module name */
-        m->argc = 2;
-
-        /* rmmod does not take paramters from configTree; just run command. */
-        ExecuteCommand(RMMOD_COMMAND, m->name, m->argv);
-
-        /* Reset exec arguments */
-        ModuleFreeParams(m);
+        if (syscall(SYS_delete_module, m->name, O_NONBLOCK) != 0)
+        {
+            LE_CRIT("Failed to remove kernel module '%s'. (%m)", m->name);
+        }
+        else
+        {
+            LE_INFO("Removed module '%s'", m->name);
+        }
 
-        LE_INFO("Removed module '%s'", m->name);
         le_mem_Release(m);
     }
 }
@@ -375,11 +850,12 @@ void kernelModules_Init(void)
                                                   sizeof(KModuleObj_t));
     le_mem_ExpandPool(KModuleHandler.modulePool, KMODULE_DEFAULT_POOL_SIZE);
 
-    // Create memory pool of strings for module parameters
-    KModuleHandler.stringPool = le_mem_CreatePool("Module Params Mem Pool",
-                                                  STRINGS_MAX_BUFFER_SIZE);
-    le_mem_ExpandPool(KModuleHandler.stringPool, STRINGS_DEFAULT_POOL_SIZE);
-
     // Create list of kernel module objects
     KModuleHandler.moduleList = LE_DLS_LIST_INIT;
+    KModuleHandler.pendingList = LE_DLS_LIST_INIT;
+    KModuleHandler.readyList = LE_DLS_LIST_INIT;
+    KModuleHandler.failedList = LE_DLS_LIST_INIT;
+
+    KModuleHandler.mutex = le_mutex_CreateNonRecursive("KernelModules");
+    KModuleHandler.readySem = le_sem_Create("KernelModulesReady", 0);
 }
@@ -0,0 +1,513 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/launchDesc.c
+ *
+ * Reading of the apps' launch descriptors (see launchDesc.h).
+ *
+ * The whole descriptor is checked when it is loaded, so that the settings can then be read from
+ * it without any more bounds checking.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "launchDesc.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include "le_cfg_interface.h"
+#include <endian.h>
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of a launch descriptor, and version of its format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LAUNCH_DESC_MAGIC       "LELD"
+#define LAUNCH_DESC_VERSION     1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config nodes the launch settings come from: the app's processes, and under each of them its
+ * priority, arguments and environment variables.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_PROCS          "procs"
+#define CFG_NODE_PRIORITY       "priority"
+#define CFG_NODE_ARGS           "args"
+#define CFG_NODE_ENV_VARS       "envVars"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer config values are compared in, large enough for any argument or value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_VALUE_BYTES         ((LIMIT_MAX_ARGS_STR_BYTES > LIMIT_MAX_PATH_BYTES) ? \
+                                 LIMIT_MAX_ARGS_STR_BYTES : LIMIT_MAX_PATH_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loaded launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct launchDesc_Ref
+{
+    void*           mapPtr;         ///< Mapping of the descriptor file.
+    size_t          size;           ///< Size of the descriptor file.
+    uint32_t        numProcs;       ///< Number of processes.
+    const uint8_t*  procsPtr;       ///< First process.
+}
+LaunchDesc_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of launch descriptors.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LaunchDescPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a 32-bit integer of a launch descriptor.
+ *
+ * @return
+ *      The integer.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReadUint32
+(
+    const uint8_t** posPtrPtr       ///< [IN/OUT] Position of the integer, moved past it.
+)
+{
+    uint32_t value;
+
+    memcpy(&value, *posPtrPtr, sizeof(value));
+    *posPtrPtr += sizeof(value);
+
+    return le32toh(value);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check and read a 32-bit integer of a launch descriptor.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the descriptor is truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckUint32
+(
+    const uint8_t** posPtrPtr,      ///< [IN/OUT] Position of the integer, moved past it.
+    const uint8_t* endPtr,          ///< [IN] End of the descriptor.
+    uint32_t* valuePtr              ///< [OUT] The integer.
+)
+{
+    if ((size_t)(endPtr - *posPtrPtr) < sizeof(uint32_t))
+    {
+        return LE_FAULT;
+    }
+
+    *valuePtr = ReadUint32(posPtrPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a string of a launch descriptor, and move past it.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the string is truncated, not null-terminated or too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckStr
+(
+    const uint8_t** posPtrPtr,      ///< [IN/OUT] Position of the string, moved past it.
+    const uint8_t* endPtr,          ///< [IN] End of the descriptor.
+    size_t maxBytes                 ///< [IN] Maximum size of the string, with its null-terminator.
+)
+{
+    uint32_t len;
+
+    if ( (CheckUint32(posPtrPtr, endPtr, &len) != LE_OK) ||
+         (len >= maxBytes) ||
+         ((size_t)(endPtr - *posPtrPtr) <= len) ||
+         ((*posPtrPtr)[len] != '\0') )
+    {
+        return LE_FAULT;
+    }
+
+    *posPtrPtr += len + 1;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a process of a launch descriptor, and move past it.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the process is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckProc
+(
+    const uint8_t** posPtrPtr,      ///< [IN/OUT] Position of the process, moved past it.
+    const uint8_t* endPtr           ///< [IN] End of the descriptor.
+)
+{
+    uint32_t count;
+    uint32_t i;
+
+    if ( (CheckStr(posPtrPtr, endPtr, LIMIT_MAX_PROCESS_NAME_BYTES) != LE_OK) ||
+         (CheckStr(posPtrPtr, endPtr, LIMIT_MAX_PRIORITY_NAME_BYTES) != LE_OK) )
+    {
+        return LE_FAULT;
+    }
+
+    // The executable comes first, and counts in the command-line arguments limit as it does when
+    // the arguments are read from the config tree.
+    if ( (CheckUint32(posPtrPtr, endPtr, &count) != LE_OK) ||
+         (count == 0) ||
+         (count > LIMIT_MAX_NUM_CMD_LINE_ARGS) )
+    {
+        return LE_FAULT;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (CheckStr(posPtrPtr, endPtr, LIMIT_MAX_ARGS_STR_BYTES) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    if ( (CheckUint32(posPtrPtr, endPtr, &count) != LE_OK) ||
+         (count > LIMIT_MAX_NUM_ENV_VARS) )
+    {
+        return LE_FAULT;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if ( (CheckStr(posPtrPtr, endPtr, LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
+             (CheckStr(posPtrPtr, endPtr, LIMIT_MAX_PATH_BYTES) != LE_OK) )
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a list in the config tree holds the same strings as a list of a process's launch
+ * settings.  The iterator is left on the process's node.
+ *
+ * @return
+ *      true if the lists match.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MatchConfigList
+(
+    le_cfg_IteratorRef_t cfgIter,   ///< [IN] Iterator on the process's node.
+    const char* listNodePtr,        ///< [IN] Name of the list's node.
+    const uint8_t* posPtr,          ///< [IN] First string of the list in the descriptor.
+    uint32_t count,                 ///< [IN] Number of items in the list in the descriptor.
+    bool isNamed                    ///< [IN] true if each item is a name followed by a value (the
+                                    ///       config node's name and value), false for values only.
+)
+{
+    char buffer[CFG_VALUE_BYTES];
+    uint32_t i = 0;
+    bool isMatch = true;
+
+    le_cfg_GoToNode(cfgIter, listNodePtr);
+
+    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    {
+        do
+        {
+            if (   (i == count)
+                || (   isNamed
+                    && (   (le_cfg_GetNodeName(cfgIter, "", buffer, sizeof(buffer)) != LE_OK)
+                        || (strcmp(buffer, launchDesc_NextStr(&posPtr)) != 0)))
+                || (le_cfg_GetString(cfgIter, "", buffer, sizeof(buffer), "") != LE_OK)
+                || (strcmp(buffer, launchDesc_NextStr(&posPtr)) != 0) )
+            {
+                isMatch = false;
+                break;
+            }
+
+            i++;
+        }
+        while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+
+        le_cfg_GoToNode(cfgIter, "..");
+    }
+
+    le_cfg_GoToNode(cfgIter, "..");
+
+    return isMatch && (i == count);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the launch descriptor module.
+ */
+//--------------------------------------------------------------------------------------------------
+void launchDesc_Init
+(
+    void
+)
+{
+    LaunchDescPool = le_mem_CreatePool("LaunchDescs", sizeof(LaunchDesc_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load and check the launch descriptor in an app's install directory.
+ *
+ * @return
+ *      Reference to the launch descriptor, or NULL if there is none or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+launchDesc_Ref_t launchDesc_Load
+(
+    const char* installDirPath      ///< [IN] App's install directory.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES] = "";
+
+    if (le_path_Concat("/", path, sizeof(path), installDirPath, LAUNCH_DESC_FILE_NAME, NULL)
+        != LE_OK)
+    {
+        LE_ERROR("Launch descriptor path '%s...' is too long.", path);
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        LE_DEBUG("No launch descriptor '%s' (%m).", path);
+        return NULL;
+    }
+
+    struct stat fileStat;
+    void* mapPtr = MAP_FAILED;
+
+    if ( (fstat(fd, &fileStat) == 0) && (fileStat.st_size > 0) )
+    {
+        mapPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    fd_Close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Could not map launch descriptor '%s' (%m).", path);
+        return NULL;
+    }
+
+    const uint8_t* posPtr = mapPtr;
+    const uint8_t* endPtr = posPtr + fileStat.st_size;
+    uint32_t version;
+    uint32_t numProcs;
+    uint32_t i;
+
+    if ( ((size_t)fileStat.st_size < sizeof(LAUNCH_DESC_MAGIC) - 1) ||
+         (memcmp(posPtr, LAUNCH_DESC_MAGIC, sizeof(LAUNCH_DESC_MAGIC) - 1) != 0) )
+    {
+        goto invalid;
+    }
+    posPtr += sizeof(LAUNCH_DESC_MAGIC) - 1;
+
+    if ( (CheckUint32(&posPtr, endPtr, &version) != LE_OK) ||
+         (version != LAUNCH_DESC_VERSION) ||
+         (CheckUint32(&posPtr, endPtr, &numProcs) != LE_OK) )
+    {
+        goto invalid;
+    }
+
+    const uint8_t* procsPtr = posPtr;
+
+    for (i = 0; i < numProcs; i++)
+    {
+        if (CheckProc(&posPtr, endPtr) != LE_OK)
+        {
+            goto invalid;
+        }
+    }
+
+    LaunchDesc_t* descPtr = le_mem_ForceAlloc(LaunchDescPool);
+
+    descPtr->mapPtr = mapPtr;
+    descPtr->size = fileStat.st_size;
+    descPtr->numProcs = numProcs;
+    descPtr->procsPtr = procsPtr;
+
+    return descPtr;
+
+invalid:
+
+    LE_ERROR("Launch descriptor '%s' is invalid.", path);
+    munmap(mapPtr, fileStat.st_size);
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unload a launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+void launchDesc_Unload
+(
+    launchDesc_Ref_t descRef        ///< [IN] Launch descriptor.
+)
+{
+    munmap(descRef->mapPtr, descRef->size);
+    le_mem_Release(descRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the launch settings of a process.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the process isn't in the launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t launchDesc_GetProc
+(
+    launchDesc_Ref_t descRef,       ///< [IN] Launch descriptor.
+    const char* procNamePtr,        ///< [IN] Name of the process.
+    launchDesc_Proc_t* procPtr      ///< [OUT] Launch settings of the process.
+)
+{
+    const uint8_t* posPtr = descRef->procsPtr;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < descRef->numProcs; i++)
+    {
+        const char* namePtr = launchDesc_NextStr(&posPtr);
+        const char* priorityPtr = launchDesc_NextStr(&posPtr);
+
+        procPtr->priorityPtr = (priorityPtr[0] != '\0') ? priorityPtr : NULL;
+
+        procPtr->numArgs = ReadUint32(&posPtr);
+        procPtr->argsPtr = posPtr;
+        for (j = 0; j < procPtr->numArgs; j++)
+        {
+            launchDesc_NextStr(&posPtr);
+        }
+
+        procPtr->numEnvVars = ReadUint32(&posPtr);
+        procPtr->envVarsPtr = posPtr;
+        for (j = 0; j < procPtr->numEnvVars * 2; j++)
+        {
+            launchDesc_NextStr(&posPtr);
+        }
+
+        if (strcmp(namePtr, procNamePtr) == 0)
+        {
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a launch descriptor holds the same launch settings as an app's config, i.e. that
+ * it can be used in place of the config.
+ *
+ * @return
+ *      true if the descriptor matches the config.
+ */
+//--------------------------------------------------------------------------------------------------
+bool launchDesc_MatchesConfig
+(
+    launchDesc_Ref_t descRef,       ///< [IN] Launch descriptor.
+    const char* appCfgPathPtr       ///< [IN] Path of the app in the config tree.
+)
+{
+    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(appCfgPathPtr);
+    char procName[LIMIT_MAX_PROCESS_NAME_BYTES];
+    char priority[LIMIT_MAX_PRIORITY_NAME_BYTES];
+    uint32_t numProcs = 0;
+    bool isMatch = true;
+
+    le_cfg_GoToNode(cfgIter, CFG_NODE_PROCS);
+
+    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    {
+        do
+        {
+            launchDesc_Proc_t proc;
+
+            if (   (le_cfg_GetNodeName(cfgIter, "", procName, sizeof(procName)) != LE_OK)
+                || (launchDesc_GetProc(descRef, procName, &proc) != LE_OK)
+                || (le_cfg_GetString(cfgIter, CFG_NODE_PRIORITY, priority, sizeof(priority), "")
+                    != LE_OK)
+                || (strcmp(priority, (proc.priorityPtr != NULL) ? proc.priorityPtr : "") != 0)
+                || !MatchConfigList(cfgIter, CFG_NODE_ARGS, proc.argsPtr, proc.numArgs, false)
+                || !MatchConfigList(cfgIter, CFG_NODE_ENV_VARS, proc.envVarsPtr, proc.numEnvVars,
+                                    true) )
+            {
+                isMatch = false;
+                break;
+            }
+
+            numProcs++;
+        }
+        while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(cfgIter);
+
+    return isMatch && (numProcs == descRef->numProcs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a string of a process's launch settings, and move on to the next one.
+ *
+ * @return
+ *      The string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* launchDesc_NextStr
+(
+    const uint8_t** posPtrPtr       ///< [IN/OUT] Position of the string, moved to the next one.
+)
+{
+    uint32_t len = ReadUint32(posPtrPtr);
+    const char* strPtr = (const char*)*posPtrPtr;
+
+    *posPtrPtr += len + 1;
+
+    return strPtr;
+}
@@ -0,0 +1,151 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/launchDesc.h
+ *
+ * API for reading an app's launch descriptor.
+ *
+ * The launch descriptor is a compact binary copy of the settings needed to start the app's
+ * processes (arguments, environment variables and priority), generated by mkapp along with the
+ * app's configuration and installed next to it.  It is memory-mapped when the app is created, so
+ * the processes are started without reading each of these settings from the config tree.
+ *
+ * The descriptor is only used if the app's "launchDescriptor" config node is true, which mkapp
+ * sets.  Setting it to false makes the Supervisor read the settings from the config tree again.
+ * The Supervisor does so itself when the settings are changed in the config tree after the app has
+ * been installed (see app_CheckLaunchDesc()), so that runtime overrides are not ignored.
+ *
+ * The format of the descriptor is (all integers are 32-bit little-endian, and each string is its
+ * length, not counting the null-terminator, followed by its bytes and a null-terminator):
+ *
+ * @verbatim
+   magic "LELD", version, number of processes
+   for each process:
+       name, priority (empty if not set),
+       number of arguments, arguments (the first one being the executable),
+       number of environment variables, name and value of each variable
+   @endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_LAUNCH_DESC_INCLUDE_GUARD
+#define LEGATO_SRC_LAUNCH_DESC_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the launch descriptor file in the app's install directory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LAUNCH_DESC_FILE_NAME       "launch.bin"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a loaded launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct launchDesc_Ref* launchDesc_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Launch settings of a process.  The strings point into the launch descriptor, and remain valid
+ * until it is unloaded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char*     priorityPtr;    ///< Priority, or NULL if not set.
+    uint32_t        numArgs;        ///< Number of arguments, including the executable.
+    const uint8_t*  argsPtr;        ///< First argument, read with launchDesc_NextStr().
+    uint32_t        numEnvVars;     ///< Number of environment variables.
+    const uint8_t*  envVarsPtr;     ///< First environment variable name, followed by its value,
+                                    ///  read with launchDesc_NextStr().
+}
+launchDesc_Proc_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the launch descriptor module.
+ */
+//--------------------------------------------------------------------------------------------------
+void launchDesc_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load and check the launch descriptor in an app's install directory.
+ *
+ * @return
+ *      Reference to the launch descriptor, or NULL if there is none or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+launchDesc_Ref_t launchDesc_Load
+(
+    const char* installDirPath      ///< [IN] App's install directory.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unload a launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+void launchDesc_Unload
+(
+    launchDesc_Ref_t descRef        ///< [IN] Launch descriptor.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the launch settings of a process.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the process isn't in the launch descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t launchDesc_GetProc
+(
+    launchDesc_Ref_t descRef,       ///< [IN] Launch descriptor.
+    const char* procNamePtr,        ///< [IN] Name of the process.
+    launchDesc_Proc_t* procPtr      ///< [OUT] Launch settings of the process.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a launch descriptor holds the same launch settings as an app's config, i.e. that
+ * it can be used in place of the config.
+ *
+ * @return
+ *      true if the descriptor matches the config.
+ */
+//--------------------------------------------------------------------------------------------------
+bool launchDesc_MatchesConfig
+(
+    launchDesc_Ref_t descRef,       ///< [IN] Launch descriptor.
+    const char* appCfgPathPtr       ///< [IN] Path of the app in the config tree.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a string of a process's launch settings, and move on to the next one.
+ *
+ * @return
+ *      The string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* launchDesc_NextStr
+(
+    const uint8_t** posPtrPtr       ///< [IN/OUT] Position of the string, moved to the next one.
+);
+
+
+#endif  // LEGATO_SRC_LAUNCH_DESC_INCLUDE_GUARD
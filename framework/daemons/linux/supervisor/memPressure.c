@@ -0,0 +1,749 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/memPressure.c
+ *
+ * Implementation of the le_memPressure API.
+ *
+ * The level is raised by PSI triggers (see the kernel's Documentation/accounting/psi.rst): writing
+ * "<some|full> <stall us> <window us>" to /proc/pressure/memory makes the file descriptor report
+ * POLLPRI each time the stall time in a window goes over the threshold.  The triggers don't report
+ * when the pressure goes away, so while the level is raised the ten second averages in the same
+ * file are polled to lower it.
+ *
+ * While the level is critical, apps whose processes all run at the idle or low priority, and that
+ * have no watchdog, are frozen through their freezer cgroup.  Apps that other running apps or
+ * non-app users are bound to are left running, as their clients would block on them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "memPressure.h"
+#include "app.h"
+#include "apps.h"
+#include "cgroups.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pressure stall information file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PSI_MEMORY_PATH             "/proc/pressure/memory"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PSI triggers raising the level to moderate and critical: stall time, in microseconds, within a
+ * one second window.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MODERATE_TRIGGER            "some 100000 1000000"
+#define CRITICAL_TRIGGER            "full 50000 1000000"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ten second stall averages, in percent, under which the level goes back down: half of the
+ * trigger thresholds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MODERATE_RELIEF_PERCENT     5.0
+#define CRITICAL_RELIEF_PERCENT     2.5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval at which the stall averages are checked while the level is raised, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RELIEF_CHECK_INTERVAL_MS    5000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration nodes looked at to decide whether an app can be frozen.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_PROC_LIST          "procs"
+#define CFG_NODE_PRIORITY           "priority"
+#define CFG_NODE_WDOG_TIMEOUT       "watchdogTimeout"
+#define CFG_NODE_BINDINGS           "bindings"
+#define CFG_NODE_BINDING_APP        "app"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration of the non-app users, which holds their bindings.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_USERS_LIST         "/users"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change handler registration.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_memPressure_ChangeHandlerFunc_t  handlerFunc;    ///< Client's handler.
+    void*                               contextPtr;     ///< Client's context pointer.
+    le_msg_SessionRef_t                 sessionRef;     ///< Session of the client.
+}
+Subscription_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App frozen because of the memory pressure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t   link;                           ///< Link in the FrozenAppList.
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; ///< Name of the app.
+}
+FrozenApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Search for a running app bound to a server app (see FindClientApp()).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* serverNamePtr;              ///< Name of the server app.
+    const char* clientNamePtr;              ///< Name of the first client app found, or NULL.
+}
+ClientSearch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools and safe reference map of the change handler registrations and frozen apps.  The
+ * safe references are the handler references given to the clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SubscriptionPool;
+static le_ref_MapRef_t SubscriptionMap;
+static le_mem_PoolRef_t FrozenAppPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apps frozen because of the memory pressure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_List_t FrozenAppList = LE_SLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Current memory pressure level.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_memPressure_Level_t Level = LE_MEMPRESSURE_LEVEL_NONE;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer checking the stall averages while the level is raised.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t ReliefTimerRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether an app can be frozen under memory pressure: all its configured processes run at
+ * the idle or low priority, and neither the app nor its processes have a watchdog (a frozen
+ * process can't kick it).
+ *
+ * @return
+ *      true if the app can be frozen.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsFreezable
+(
+    app_Ref_t appRef                        ///< [IN] App.
+)
+{
+    bool isFreezable = false;
+    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+
+    if (le_cfg_NodeExists(cfgIter, CFG_NODE_WDOG_TIMEOUT))
+    {
+        goto done;
+    }
+
+    le_cfg_GoToNode(cfgIter, CFG_NODE_PROC_LIST);
+
+    if (le_cfg_GoToFirstChild(cfgIter) != LE_OK)
+    {
+        goto done;
+    }
+
+    do
+    {
+        char priority[LIMIT_MAX_PRIORITY_NAME_BYTES];
+
+        if (   le_cfg_NodeExists(cfgIter, CFG_NODE_WDOG_TIMEOUT)
+            || (le_cfg_GetString(cfgIter, CFG_NODE_PRIORITY, priority, sizeof(priority), "medium")
+                    != LE_OK)
+            || ((strcmp(priority, "idle") != 0) && (strcmp(priority, "low") != 0)))
+        {
+            goto done;
+        }
+    }
+    while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+
+    isFreezable = true;
+
+done:
+    le_cfg_CancelTxn(cfgIter);
+    return isFreezable;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a client, app or non-app user, has a binding to a server app.
+ *
+ * @return
+ *      true if one of the client's interfaces is bound to the server app.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBoundTo
+(
+    le_cfg_IteratorRef_t cfgIter,           ///< [IN] Iterator on the client's node.  It is back on
+                                            ///       that node on return.
+    const char* serverNamePtr               ///< [IN] Name of the server app.
+)
+{
+    bool isBound = false;
+
+    le_cfg_GoToNode(cfgIter, CFG_NODE_BINDINGS);
+
+    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    {
+        do
+        {
+            char appName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if (   (le_cfg_GetString(cfgIter, CFG_NODE_BINDING_APP, appName, sizeof(appName), "")
+                        == LE_OK)
+                && (strcmp(appName, serverNamePtr) == 0) )
+            {
+                isBound = true;
+                break;
+            }
+        }
+        while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+
+        le_cfg_GoToParent(cfgIter);
+    }
+
+    le_cfg_GoToParent(cfgIter);
+
+    return isBound;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for a running app, other than the server app itself, that is bound to the server app.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FindClientApp
+(
+    app_Ref_t appRef,                       ///< [IN] Running app.
+    void* contextPtr                        ///< [IN,OUT] Search (ClientSearch_t).
+)
+{
+    ClientSearch_t* searchPtr = contextPtr;
+    const char* appNamePtr = app_GetName(appRef);
+
+    if ((searchPtr->clientNamePtr != NULL) || (strcmp(appNamePtr, searchPtr->serverNamePtr) == 0))
+    {
+        return;
+    }
+
+    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+
+    if (IsBoundTo(cfgIter, searchPtr->serverNamePtr))
+    {
+        searchPtr->clientNamePtr = appNamePtr;
+    }
+
+    le_cfg_CancelTxn(cfgIter);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a client of an app: a running app or a non-app user with a binding to the app.  A frozen
+ * app would block its clients, as it can't answer them.
+ *
+ * @return
+ *      LE_OK if a client was found.
+ *      LE_NOT_FOUND if the app has no clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetClient
+(
+    const char* appNamePtr,                 ///< [IN] Name of the app.
+    char* clientNamePtr,                    ///< [OUT] Name of the client app or user.
+    size_t clientNameSize                   ///< [IN] Size of the client name buffer.
+)
+{
+    ClientSearch_t search = { .serverNamePtr = appNamePtr, .clientNamePtr = NULL };
+
+    apps_ForEachRunningApp(FindClientApp, &search);
+
+    if (search.clientNamePtr != NULL)
+    {
+        le_utf8_Copy(clientNamePtr, search.clientNamePtr, clientNameSize, NULL);
+        return LE_OK;
+    }
+
+    // The processes of non-app users aren't tracked, so they are all taken to be running.
+    le_result_t result = LE_NOT_FOUND;
+    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(CFG_NODE_USERS_LIST);
+
+    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    {
+        do
+        {
+            if (IsBoundTo(cfgIter, appNamePtr))
+            {
+                le_cfg_GetNodeName(cfgIter, "", clientNamePtr, clientNameSize);
+                result = LE_OK;
+                break;
+            }
+        }
+        while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(cfgIter);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Freezes a running app if it can be frozen under memory pressure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreezeApp
+(
+    app_Ref_t appRef,                       ///< [IN] App.
+    void* contextPtr                        ///< [IN] Not used.
+)
+{
+    const char* appNamePtr = app_GetName(appRef);
+
+    if (!IsFreezable(appRef))
+    {
+        return;
+    }
+
+    char clientName[LIMIT_MAX_USER_NAME_BYTES];
+
+    if (GetClient(appNamePtr, clientName, sizeof(clientName)) == LE_OK)
+    {
+        LE_INFO("Not freezing app '%s' under memory pressure; it serves '%s'.",
+                appNamePtr, clientName);
+        return;
+    }
+
+    if (cgrp_frz_Freeze(appNamePtr) != LE_OK)
+    {
+        LE_ERROR("Could not freeze app '%s'.", appNamePtr);
+        return;
+    }
+
+    LE_INFO("Froze app '%s' under memory pressure.", appNamePtr);
+
+    FrozenApp_t* frozenAppPtr = le_mem_ForceAlloc(FrozenAppPool);
+
+    frozenAppPtr->link = LE_SLS_LINK_INIT;
+    LE_ASSERT(le_utf8_Copy(frozenAppPtr->name, appNamePtr, sizeof(frozenAppPtr->name), NULL)
+              == LE_OK);
+    le_sls_Stack(&FrozenAppList, &frozenAppPtr->link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thaws the apps frozen under memory pressure.  Apps stopped in the meantime are thawed when they
+ * are killed, so failures are expected for them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ThawApps
+(
+    void
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&FrozenAppList)) != NULL)
+    {
+        FrozenApp_t* frozenAppPtr = CONTAINER_OF(linkPtr, FrozenApp_t, link);
+
+        if (cgrp_frz_Thaw(frozenAppPtr->name) == LE_OK)
+        {
+            LE_INFO("Thawed app '%s'.", frozenAppPtr->name);
+        }
+        else
+        {
+            LE_DEBUG("Could not thaw app '%s'; it may have stopped.", frozenAppPtr->name);
+        }
+
+        le_mem_Release(frozenAppPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the memory pressure level, freezing or thawing apps and notifying the clients if it changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetLevel
+(
+    le_memPressure_Level_t level            ///< [IN] New level.
+)
+{
+    static const char* levelNames[] = { "none", "moderate", "critical" };
+
+    if (level == Level)
+    {
+        return;
+    }
+
+    LE_INFO("Memory pressure level %s -> %s.", levelNames[Level], levelNames[level]);
+
+    if (level == LE_MEMPRESSURE_LEVEL_CRITICAL)
+    {
+        apps_ForEachRunningApp(FreezeApp, NULL);
+    }
+    else if (level == LE_MEMPRESSURE_LEVEL_NONE)
+    {
+        ThawApps();
+    }
+
+    Level = level;
+
+    if (Level == LE_MEMPRESSURE_LEVEL_NONE)
+    {
+        le_timer_Stop(ReliefTimerRef);
+    }
+    else if (!le_timer_IsRunning(ReliefTimerRef))
+    {
+        le_timer_Start(ReliefTimerRef);
+    }
+
+    le_ref_IterRef_t iter = le_ref_GetIterator(SubscriptionMap);
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        Subscription_t* subPtr = (Subscription_t*)le_ref_GetValue(iter);
+
+        subPtr->handlerFunc(Level, subPtr->contextPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the ten second stall averages.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the file could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadStallAverages
+(
+    double* someAvgPtr,                     ///< [OUT] Average for some tasks, in percent.
+    double* fullAvgPtr                      ///< [OUT] Average for all the tasks, in percent.
+)
+{
+    static const char someKey[] = "some avg10=";
+    static const char fullKey[] = "full avg10=";
+    char buf[256];
+    ssize_t numBytes;
+
+    int fd = open(PSI_MEMORY_PATH, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        return LE_FAULT;
+    }
+
+    do
+    {
+        numBytes = read(fd, buf, sizeof(buf) - 1);
+    }
+    while ((numBytes == -1) && (errno == EINTR));
+
+    fd_Close(fd);
+
+    if (numBytes <= 0)
+    {
+        return LE_FAULT;
+    }
+
+    buf[numBytes] = '\0';
+
+    const char* somePtr = strstr(buf, someKey);
+    const char* fullPtr = strstr(buf, fullKey);
+
+    if (somePtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    *someAvgPtr = strtod(somePtr + sizeof(someKey) - 1, NULL);
+    *fullAvgPtr = (fullPtr != NULL) ? strtod(fullPtr + sizeof(fullKey) - 1, NULL) : 0;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lowers the level once the stall averages have fallen under the relief thresholds.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReliefTimerHandler
+(
+    le_timer_Ref_t timerRef                 ///< [IN] Timer.
+)
+{
+    double someAvg;
+    double fullAvg;
+    le_memPressure_Level_t level = LE_MEMPRESSURE_LEVEL_NONE;
+
+    if (ReadStallAverages(&someAvg, &fullAvg) != LE_OK)
+    {
+        LE_ERROR("Could not read '%s'.", PSI_MEMORY_PATH);
+    }
+    else if (fullAvg >= CRITICAL_RELIEF_PERCENT)
+    {
+        level = LE_MEMPRESSURE_LEVEL_CRITICAL;
+    }
+    else if (someAvg >= MODERATE_RELIEF_PERCENT)
+    {
+        level = LE_MEMPRESSURE_LEVEL_MODERATE;
+    }
+
+    // Only the triggers raise the level.
+    if (level < Level)
+    {
+        SetLevel(level);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Raises the level when a PSI trigger fires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TriggerHandler
+(
+    int fd,                                 ///< [IN] Trigger file descriptor.
+    short events                            ///< [IN] Events.
+)
+{
+    le_memPressure_Level_t level = (le_memPressure_Level_t)(intptr_t)le_fdMonitor_GetContextPtr();
+
+    if (events & POLLPRI)
+    {
+        if (level > Level)
+        {
+            SetLevel(level);
+        }
+    }
+    else if (events & (POLLERR | POLLHUP))
+    {
+        LE_ERROR("Memory pressure trigger failed; no longer watching level %d.", level);
+
+        le_fdMonitor_Delete(le_fdMonitor_GetMonitor());
+        fd_Close(fd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up a PSI trigger raising the memory pressure level.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the kernel doesn't support memory pressure triggers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddTrigger
+(
+    const char* triggerPtr,                 ///< [IN] Trigger.
+    le_memPressure_Level_t level            ///< [IN] Level raised to when the trigger fires.
+)
+{
+    int fd = open(PSI_MEMORY_PATH, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        return LE_FAULT;
+    }
+
+    // The trigger is written with its terminating null character.
+    if (write(fd, triggerPtr, strlen(triggerPtr) + 1) < 0)
+    {
+        LE_ERROR("Could not set memory pressure trigger '%s' (%m).", triggerPtr);
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    le_fdMonitor_Ref_t monitorRef = le_fdMonitor_Create("MemPressure", fd, TriggerHandler, POLLPRI);
+    le_fdMonitor_SetContextPtr(monitorRef, (void*)(intptr_t)level);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the change handlers of a client that has disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteClientSubscriptions
+(
+    le_msg_SessionRef_t sessionRef,         ///< Session reference of the client.
+    void*               contextPtr          ///< Not used.
+)
+{
+    le_ref_IterRef_t iter = le_ref_GetIterator(SubscriptionMap);
+
+    while (le_ref_NextNode(iter) == LE_OK)
+    {
+        Subscription_t* subPtr = (Subscription_t*)le_ref_GetValue(iter);
+
+        LE_ASSERT(subPtr != NULL);
+
+        if (subPtr->sessionRef == sessionRef)
+        {
+            le_ref_DeleteRef(SubscriptionMap, (void*)le_ref_GetSafeRef(iter));
+            le_mem_Release(subPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the memory pressure module and start watching the memory pressure.  Must be called
+ * after the le_memPressure service has been advertised and the apps sub system initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+void memPressure_Init
+(
+    void
+)
+{
+    SubscriptionPool = le_mem_CreatePool("memPressureHandlers", sizeof(Subscription_t));
+    SubscriptionMap = le_ref_CreateMap("MemPressureHandlers", 5);
+    FrozenAppPool = le_mem_CreatePool("memPressureFrozenApps", sizeof(FrozenApp_t));
+
+    le_msg_AddServiceCloseHandler(le_memPressure_GetServiceRef(), DeleteClientSubscriptions, NULL);
+
+    ReliefTimerRef = le_timer_Create("MemPressureRelief");
+    LE_ASSERT(le_timer_SetMsInterval(ReliefTimerRef, RELIEF_CHECK_INTERVAL_MS) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(ReliefTimerRef, 0) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(ReliefTimerRef, ReliefTimerHandler) == LE_OK);
+
+    if (   (AddTrigger(MODERATE_TRIGGER, LE_MEMPRESSURE_LEVEL_MODERATE) != LE_OK)
+        || (AddTrigger(CRITICAL_TRIGGER, LE_MEMPRESSURE_LEVEL_CRITICAL) != LE_OK))
+    {
+        LE_WARN("Memory pressure information not available; is the kernel built with CONFIG_PSI?");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_memPressure_Change'
+ *
+ * Memory pressure level changes.
+ */
+//--------------------------------------------------------------------------------------------------
+le_memPressure_ChangeHandlerRef_t le_memPressure_AddChangeHandler
+(
+    le_memPressure_ChangeHandlerFunc_t handlerPtr,
+        ///< [IN]
+
+    void* contextPtr
+        ///< [IN]
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL.");
+        return NULL;
+    }
+
+    Subscription_t* subPtr = le_mem_ForceAlloc(SubscriptionPool);
+
+    subPtr->handlerFunc = handlerPtr;
+    subPtr->contextPtr = contextPtr;
+    subPtr->sessionRef = le_memPressure_GetClientSessionRef();
+
+    return le_ref_CreateRef(SubscriptionMap, subPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_memPressure_Change'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_memPressure_RemoveChangeHandler
+(
+    le_memPressure_ChangeHandlerRef_t handlerRef
+        ///< [IN]
+)
+{
+    Subscription_t* subPtr = le_ref_Lookup(SubscriptionMap, handlerRef);
+
+    if ( (subPtr == NULL) || (subPtr->sessionRef != le_memPressure_GetClientSessionRef()) )
+    {
+        LE_ERROR("Invalid change handler reference %p.", handlerRef);
+        return;
+    }
+
+    le_ref_DeleteRef(SubscriptionMap, handlerRef);
+    le_mem_Release(subPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the current memory pressure level.
+ *
+ * @return
+ *      The memory pressure level.
+ */
+//--------------------------------------------------------------------------------------------------
+le_memPressure_Level_t le_memPressure_GetLevel
+(
+    void
+)
+{
+    return Level;
+}
@@ -0,0 +1,25 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/memPressure.h
+ *
+ * Implementation of the le_memPressure API, which watches the memory pressure of the system and
+ * freezes low priority apps while it is critical.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_SRC_MEM_PRESSURE_INCLUDE_GUARD
+#define LEGATO_SRC_MEM_PRESSURE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the memory pressure module and start watching the memory pressure.  Must be called
+ * after the le_memPressure service has been advertised and the apps sub system initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+void memPressure_Init
+(
+    void
+);
+
+
+#endif  // LEGATO_SRC_MEM_PRESSURE_INCLUDE_GUARD
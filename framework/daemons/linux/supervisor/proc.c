@@ -6,6 +6,20 @@
  * state information.  However, a processes state must be updated by calling the
  * proc_SigChildHandler() from within a SIGCHILD handler.
  *
+ * Processes are normally started without forking the Supervisor: the child is created with
+ * clone(CLONE_VM), so that it shares the Supervisor's memory until it execs instead of getting a
+ * copy-on-write copy of it.  Everything the child needs between the clone() and the exec() is
+ * prepared beforehand by the Supervisor, because the child must not allocate memory, log or call
+ * anything else that may use or modify the Supervisor's state.  If the child fails before the
+ * exec() it reports why through a close-on-exec pipe, and the Supervisor logs the error.
+ *
+ * The child also shares the thread-local storage (errno included) of the thread that cloned it.
+ * So the clone() is done with CLONE_VFORK from a short-lived spawner thread, which stays suspended
+ * until the child has exec'd, while the Supervisor's main thread sets the child's limits.
+ *
+ * Processes that must be blocked before the exec() (see proc_SetBlockCallback()) are still
+ * forked, because the block callback runs in the child.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -19,11 +33,17 @@
 #include "fileDescriptor.h"
 #include "user.h"
 #include "log.h"
+#include "logDaemon/logDaemon.h"
 #include "smack.h"
 #include "supervisor.h"
 #include "killProc.h"
 #include "interfaces.h"
 #include "sysStatus.h"
+#include "launchDesc.h"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -135,6 +155,9 @@ typedef struct proc_Ref
 {
     char*   namePtr;                ///< Name of the process.
     char*   cfgPathPtr;             ///< Path in the config tree. If NULL use default settings.
+    bool    hasLaunchDesc;          ///< true if the settings needed to start the process are read
+                                    ///  from launchDesc rather than from the config tree.
+    launchDesc_Proc_t launchDesc;   ///< Settings from the app's launch descriptor.
     app_Ref_t appRef;               ///< Reference to the app that we are part of.
     pid_t   pid;                    ///< The pid of the process.
     time_t  faultTime;              ///< The time of the last fault.
@@ -203,6 +226,23 @@ static le_mem_PoolRef_t PriorityPool;
 static le_mem_PoolRef_t ArgsPool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the running processes, from PID to process object.  Used to find the process that a
+ * SIGCHLD is about without going through all the apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t PidMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of running processes, used to size the PID index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PID_MAP_SIZE        31
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Nice level definitions for the different Legato priority levels.
@@ -235,6 +275,127 @@ EnvVar_t;
 #define WRITE_PIPE      1
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the stack of a spawned child, used from the clone() until the exec().
+ */
+//--------------------------------------------------------------------------------------------------
+#define SPAWN_STACK_BYTES   (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File a process writes to set its own SMACK label.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROC_SMACK_LABEL_FILE   "/proc/self/attr/current"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * System calls used by a spawned child to drop its privileges.  The 32-bit IDs variants are used
+ * where the original ones only take 16-bit IDs.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifdef SYS_setuid32
+#define SYS_SETGROUPS           SYS_setgroups32
+#define SYS_SETGID              SYS_setgid32
+#define SYS_SETUID              SYS_setuid32
+#else
+#define SYS_SETGROUPS           SYS_setgroups
+#define SYS_SETGID              SYS_setgid
+#define SYS_SETUID              SYS_setuid
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Steps of the start of a spawned child, used to report which one failed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SPAWN_STEP_SYNC,            ///< Waiting for the Supervisor.
+    SPAWN_STEP_STD_STREAMS,     ///< Redirecting the standard streams.
+    SPAWN_STEP_SMACK,           ///< Setting the SMACK label.
+    SPAWN_STEP_SIGNALS,         ///< Restoring the signal dispositions and mask.
+    SPAWN_STEP_WORKING_DIR,     ///< Changing the working directory.
+    SPAWN_STEP_CHROOT,          ///< Changing the root directory.
+    SPAWN_STEP_GROUPS,          ///< Setting the supplementary groups.
+    SPAWN_STEP_GID,             ///< Setting the group ID.
+    SPAWN_STEP_UID,             ///< Setting the user ID.
+    SPAWN_STEP_EXEC,            ///< Executing the program.
+    SPAWN_NUM_STEPS             ///< Number of steps.  Must be the last item in this enum.
+}
+SpawnStep_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Descriptions of the steps of the start of a spawned child, for the error messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* SpawnStepStr[SPAWN_NUM_STEPS] =
+{
+    "wait for the Supervisor",
+    "redirect the standard streams",
+    "set the SMACK label",
+    "restore the signal handling",
+    "change the working directory",
+    "chroot to the sandbox",
+    "set the supplementary groups list",
+    "set the group ID",
+    "set the user ID",
+    "exec"
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error reported by a spawned child that failed before its exec().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t step;               ///< The step that failed (a SpawnStep_t).
+    int32_t errNum;             ///< The errno of the failure.
+}
+SpawnError_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Everything a spawned child needs between the clone() and the exec().  Prepared by the
+ * Supervisor, on its stack, which stays valid until the child has exec'd.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int         syncPipeFd[2];      ///< Pipe the child waits on until the Supervisor is done.
+    int         errPipeFd[2];       ///< Close-on-exec pipe the child reports errors through.
+    int         stdInFd;            ///< Fd to redirect standard in to, or -1.
+    int         stdOutFd;           ///< Fd to redirect standard out to (fd or log pipe), or -1.
+    int         stdErrFd;           ///< Fd to redirect standard error to (fd or log pipe), or -1.
+    int         maxNumFds;          ///< Upper bound of the child's file descriptors.
+    const char* smackLabelPtr;      ///< SMACK label of the child, or NULL if SMACK is disabled.
+    bool        sandboxed;          ///< true if the child must be confined to its sandbox.
+    const char* workingDirPtr;      ///< Working directory (or sandbox root).
+    uid_t       uid;                ///< User ID of the child.
+    gid_t       gid;                ///< Primary group ID of the child.
+    gid_t       groups[LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS]; ///< Supplementary groups of the child.
+    size_t      numGroups;          ///< Number of supplementary groups.
+    const char* searchPathPtr;      ///< Value of the child's PATH, or NULL.
+    char**      argsPtr;            ///< Arguments list, as built by GetArgs().
+    char**      envPtr;             ///< Environment of the child.
+    void*       stackPtr;           ///< Stack of the child.
+    pthread_t   spawnerThread;      ///< Thread that clones the child (see SpawnChild()).
+    sem_t       startedSem;         ///< Posted once the child runs, or once the clone has failed.
+    pid_t       pid;                ///< PID of the child (set by the kernel), or -1.
+    int         cloneErrno;         ///< errno of the clone(), if it failed.
+}
+SpawnAttr_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The fault limits.
@@ -260,6 +421,35 @@ void proc_Init
     PathPool = le_mem_CreatePool("Paths", LIMIT_MAX_PATH_BYTES);
     PriorityPool = le_mem_CreatePool("Priority", LIMIT_MAX_PRIORITY_NAME_BYTES);
     ArgsPool = le_mem_CreatePool("Args", sizeof(Arg_t));
+
+    PidMap = le_hashmap_Create("ProcPids", PID_MAP_SIZE,
+                               le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the PID of a process, keeping the PID index up to date.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPid
+(
+    proc_Ref_t procRef,             ///< [IN] The process reference.
+    pid_t pid                       ///< [IN] The new PID, or -1 if the process is not running.
+)
+{
+    // The key is the process's own pid field, so it must be removed before it changes.
+    if (procRef->pid != -1)
+    {
+        le_hashmap_Remove(PidMap, &procRef->pid);
+    }
+
+    procRef->pid = pid;
+
+    if (pid != -1)
+    {
+        le_hashmap_Put(PidMap, &procRef->pid, procRef);
+    }
 }
 
 
@@ -324,6 +514,15 @@ proc_Ref_t proc_Create
         procPtr->cfgPathPtr = NULL;
     }
 
+    // Use the app's launch descriptor, if it has one, rather than reading the settings needed to
+    // start the process from the config tree.
+    launchDesc_Ref_t launchDescRef = app_GetLaunchDesc(appRef);
+
+    procPtr->hasLaunchDesc =
+        (procPtr->cfgPathPtr != NULL) &&
+        (launchDescRef != NULL) &&
+        (launchDesc_GetProc(launchDescRef, procPtr->namePtr, &procPtr->launchDesc) == LE_OK);
+
     // Initialize all other parameters.
     procPtr->appRef = appRef;
     procPtr->faultTime = 0;
@@ -361,6 +560,9 @@ void proc_Delete
     proc_Ref_t procRef              ///< [IN] The process to start.
 )
 {
+    // Drop the process from the PID index.
+    SetPid(procRef, -1);
+
     // Delete arguments override list.
     proc_ClearArgs(procRef);
 
@@ -516,6 +718,13 @@ static void SetSchedulingPriority
     {
         priorStrPtr = procRef->priorityPtr;
     }
+    else if (procRef->hasLaunchDesc)
+    {
+        if (procRef->launchDesc.priorityPtr != NULL)
+        {
+            priorStrPtr = (char*)procRef->launchDesc.priorityPtr;
+        }
+    }
     else if (procRef->cfgPathPtr != NULL)
     {
         // Read the priority setting from the config tree.
@@ -556,7 +765,25 @@ static le_result_t GetEnvironmentVariables
 {
     int numEnvVars = 0;
 
-    if (procRef->cfgPathPtr != NULL)
+    if (procRef->hasLaunchDesc)
+    {
+        // The sizes of the names and values were checked when the descriptor was loaded.
+        const uint8_t* posPtr = procRef->launchDesc.envVarsPtr;
+
+        if (procRef->launchDesc.numEnvVars > maxNumEnvVars)
+        {
+            goto errorReading;
+        }
+
+        for (numEnvVars = 0; numEnvVars < procRef->launchDesc.numEnvVars; numEnvVars++)
+        {
+            LE_ASSERT(le_utf8_Copy(envVars[numEnvVars].name, launchDesc_NextStr(&posPtr),
+                                   sizeof(envVars[numEnvVars].name), NULL) == LE_OK);
+            LE_ASSERT(le_utf8_Copy(envVars[numEnvVars].value, launchDesc_NextStr(&posPtr),
+                                   sizeof(envVars[numEnvVars].value), NULL) == LE_OK);
+        }
+    }
+    else if (procRef->cfgPathPtr != NULL)
     {
         le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
         le_cfg_GoToNode(procCfg, CFG_NODE_ENV_VARS);
@@ -726,8 +953,29 @@ static le_result_t GetArgs
         }
     }
 
-    // Set the executable and the args if necessary.
-    if (procRef->cfgPathPtr != NULL)
+    // Set the executable and the args if necessary.  The ones from the launch descriptor are used
+    // in place, as it stays mapped as long as the app exists.
+    if (procRef->hasLaunchDesc)
+    {
+        const uint8_t* posPtr = procRef->launchDesc.argsPtr;
+        const char* execPathPtr = launchDesc_NextStr(&posPtr);
+        uint32_t i;
+
+        if (procRef->execPathPtr == NULL)
+        {
+            argsPtr[INDEX_EXEC] = (char*)execPathPtr;
+        }
+
+        if (!procRef->argsListValid)
+        {
+            for (i = 1; i < procRef->launchDesc.numArgs; i++)
+            {
+                argsPtr[INDEX_ARGS + ptrIndex] = (char*)launchDesc_NextStr(&posPtr);
+                ptrIndex++;
+            }
+        }
+    }
+    else if (procRef->cfgPathPtr != NULL)
     {
         // Get a config iterator to the arguments list.
         le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
@@ -1050,6 +1298,524 @@ static void BlockOnPipe
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the environment of a spawned child, in the "name=value" form expected by execve().
+ *
+ * @return
+ *      The value of the PATH variable, or NULL if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* BuildEnvList
+(
+    EnvVar_t envVars[],     ///< [IN] The list of environment variables.
+    int numEnvVars,         ///< [IN] The number environment variables in the list.
+    char envBuffers[LIMIT_MAX_NUM_ENV_VARS][LIMIT_MAX_ENV_VAR_NAME_BYTES + LIMIT_MAX_PATH_BYTES],
+                            ///< [OUT] Buffers to store the "name=value" strings in.
+    char* envPtr[LIMIT_MAX_NUM_ENV_VARS + 1] ///< [OUT] NULL-terminated list of the strings.
+)
+{
+    const char* searchPathPtr = NULL;
+    int i;
+
+    for (i = 0; i < numEnvVars; i++)
+    {
+        LE_ASSERT(snprintf(envBuffers[i], sizeof(envBuffers[i]), "%s=%s",
+                           envVars[i].name, envVars[i].value) < sizeof(envBuffers[i]));
+        envPtr[i] = envBuffers[i];
+
+        if (strcmp(envVars[i].name, "PATH") == 0)
+        {
+            searchPathPtr = envVars[i].value;
+        }
+    }
+
+    envPtr[numEnvVars] = NULL;
+
+    return searchPathPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reports the failure of a step of a spawned child's start to the Supervisor, and exits.
+ *
+ * @note Runs in the spawned child.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SpawnFail
+(
+    const SpawnAttr_t* attrPtr, ///< [IN] Spawn attributes.
+    SpawnStep_t step,           ///< [IN] The step that failed.
+    int errNum                  ///< [IN] The errno of the failure.
+)
+{
+    SpawnError_t error = { .step = step, .errNum = errNum };
+    ssize_t numBytesWritten;
+
+    do
+    {
+        numBytesWritten = write(attrPtr->errPipeFd[WRITE_PIPE], &error, sizeof(error));
+    }
+    while ((numBytesWritten == -1) && (errno == EINTR));
+
+    _exit(EXIT_FAILURE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes all the spawned child's file descriptors other than the standard ones and the write end
+ * of the error pipe (which is closed by the exec).
+ *
+ * @note Runs in the spawned child.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SpawnCloseFds
+(
+    const SpawnAttr_t* attrPtr  ///< [IN] Spawn attributes.
+)
+{
+    int errFd = attrPtr->errPipeFd[WRITE_PIPE];
+
+#ifdef SYS_close_range
+    if (   (syscall(SYS_close_range, 3, errFd - 1, 0) == 0)
+        && (syscall(SYS_close_range, errFd + 1, ~0U, 0) == 0) )
+    {
+        return;
+    }
+#endif
+
+    int fd;
+    for (fd = 3; fd < attrPtr->maxNumFds; fd++)
+    {
+        if (fd != errFd)
+        {
+            close(fd);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Executes the spawned child's program, searching the PATH like execvp() if the program path
+ * doesn't contain a slash.
+ *
+ * @note Runs in the spawned child.  Only returns on error.
+ *
+ * @return
+ *      The errno of the failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int SpawnExec
+(
+    const SpawnAttr_t* attrPtr  ///< [IN] Spawn attributes.
+)
+{
+    const char* progPtr = attrPtr->argsPtr[0];
+    char** argvPtr = &(attrPtr->argsPtr[1]);
+
+    if ((strchr(progPtr, '/') != NULL) || (attrPtr->searchPathPtr == NULL))
+    {
+        execve(progPtr, argvPtr, attrPtr->envPtr);
+        return errno;
+    }
+
+    size_t progLen = strlen(progPtr);
+    const char* dirPtr = attrPtr->searchPathPtr;
+    int execErrno = ENOENT;
+
+    while (1)
+    {
+        const char* endPtr = strchrnul(dirPtr, ':');
+        size_t dirLen = endPtr - dirPtr;
+        char path[LIMIT_MAX_PATH_BYTES];
+
+        if (dirLen + progLen + 2 <= sizeof(path))
+        {
+            // An empty directory means the current directory.
+            if (dirLen > 0)
+            {
+                memcpy(path, dirPtr, dirLen);
+                path[dirLen++] = '/';
+            }
+            memcpy(path + dirLen, progPtr, progLen + 1);
+
+            execve(path, argvPtr, attrPtr->envPtr);
+
+            if (errno == EACCES)
+            {
+                execErrno = EACCES;
+            }
+            else if ((errno != ENOENT) && (errno != ENOTDIR))
+            {
+                return errno;
+            }
+        }
+
+        if (*endPtr == '\0')
+        {
+            return execErrno;
+        }
+
+        dirPtr = endPtr + 1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a spawned child.  Does what the forked child does in proc_Start(), using only
+ * system calls and the data prepared in the spawn attributes.
+ *
+ * @note The child shares the Supervisor's memory, so it must not allocate memory, log, or call any
+ *       function that modifies the Supervisor's state.  glibc wrappers that touch more than errno
+ *       (setuid() and friends signal all the Supervisor's threads) are bypassed too.  The errno
+ *       they set is the spawner thread's, which is suspended until the child execs.
+ *
+ * @return Never returns.
+ */
+//--------------------------------------------------------------------------------------------------
+static int SpawnedChildMain
+(
+    void* contextPtr            ///< [IN] Spawn attributes.
+)
+{
+    SpawnAttr_t* attrPtr = contextPtr;
+
+    // Let the Supervisor know we are running; our PID has been set by now.
+    sem_post(&attrPtr->startedSem);
+
+    // Wait for the Supervisor to allow us to continue by blocking on the read pipe until it
+    // is closed.
+    close(attrPtr->syncPipeFd[WRITE_PIPE]);
+    close(attrPtr->errPipeFd[READ_PIPE]);
+
+    ssize_t numBytesRead;
+    char dummyBuf;
+    do
+    {
+        numBytesRead = read(attrPtr->syncPipeFd[READ_PIPE], &dummyBuf, 1);
+    }
+    while ( ((numBytesRead == -1) && (errno == EINTR)) || (numBytesRead > 0) );
+
+    if (numBytesRead == -1)
+    {
+        SpawnFail(attrPtr, SPAWN_STEP_SYNC, errno);
+    }
+
+    // Redirect the process's standard streams.
+    if (   ((attrPtr->stdErrFd >= 0) && (dup2(attrPtr->stdErrFd, STDERR_FILENO) == -1))
+        || ((attrPtr->stdOutFd >= 0) && (dup2(attrPtr->stdOutFd, STDOUT_FILENO) == -1))
+        || ((attrPtr->stdInFd >= 0) && (dup2(attrPtr->stdInFd, STDIN_FILENO) == -1)) )
+    {
+        SpawnFail(attrPtr, SPAWN_STEP_STD_STREAMS, errno);
+    }
+
+    // Set the process's SMACK label.
+    if (attrPtr->smackLabelPtr != NULL)
+    {
+        int fd = open(PROC_SMACK_LABEL_FILE, O_WRONLY);
+        size_t labelSize = strlen(attrPtr->smackLabelPtr);
+
+        if ((fd == -1) || (write(fd, attrPtr->smackLabelPtr, labelSize) != labelSize))
+        {
+            SpawnFail(attrPtr, SPAWN_STEP_SMACK, errno);
+        }
+
+        close(fd);
+    }
+
+    // Set the umask so that files are not accidentally created with global permissions.
+    umask(S_IRWXG | S_IRWXO);
+
+    // The Supervisor's signal handlers must not run in the child, so restore the default
+    // dispositions before unblocking all signals that might have been blocked.
+    struct sigaction defaultAction = { .sa_handler = SIG_DFL };
+    sigset_t sigSet;
+    int sig;
+
+    for (sig = 1; sig < _NSIG; sig++)
+    {
+        struct sigaction action;
+
+        if (   (sigaction(sig, NULL, &action) == 0)
+            && (action.sa_handler != SIG_DFL)
+            && (action.sa_handler != SIG_IGN) )
+        {
+            (void)sigaction(sig, &defaultAction, NULL);
+        }
+    }
+
+    if ((sigfillset(&sigSet) != 0) || (sigprocmask(SIG_UNBLOCK, &sigSet, NULL) != 0))
+    {
+        SpawnFail(attrPtr, SPAWN_STEP_SIGNALS, errno);
+    }
+
+    // Setup the process environment.  See ConfineProcInSandbox() for the order of the steps.
+    if (chdir(attrPtr->workingDirPtr) != 0)
+    {
+        SpawnFail(attrPtr, SPAWN_STEP_WORKING_DIR, errno);
+    }
+
+    if (attrPtr->sandboxed)
+    {
+        if (chroot(attrPtr->workingDirPtr) != 0)
+        {
+            SpawnFail(attrPtr, SPAWN_STEP_CHROOT, errno);
+        }
+
+        if (syscall(SYS_SETGROUPS, attrPtr->numGroups, attrPtr->groups) == -1)
+        {
+            SpawnFail(attrPtr, SPAWN_STEP_GROUPS, errno);
+        }
+
+        if (syscall(SYS_SETGID, attrPtr->gid) == -1)
+        {
+            SpawnFail(attrPtr, SPAWN_STEP_GID, errno);
+        }
+
+        if (syscall(SYS_SETUID, attrPtr->uid) == -1)
+        {
+            SpawnFail(attrPtr, SPAWN_STEP_UID, errno);
+        }
+    }
+
+    // Close all non-standard file descriptors, then launch the child program.
+    SpawnCloseFds(attrPtr);
+
+    SpawnFail(attrPtr, SPAWN_STEP_EXEC, SpawnExec(attrPtr));
+
+    return EXIT_FAILURE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepares the spawn attributes of a process.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareSpawnAttr
+(
+    proc_Ref_t procRef,         ///< [IN] The process to start.
+    SpawnAttr_t* attrPtr,       ///< [OUT] Spawn attributes.
+    int syncPipeFd[2],          ///< [IN] Synchronization pipe.
+    int logStdOutPipe[2],       ///< [IN] Log standard out pipe.
+    int logStdErrPipe[2],       ///< [IN] Log standard error pipe.
+    char* argsPtr[NUM_ARGS_PTRS], ///< [IN] Arguments list.
+    char* envPtr[],             ///< [IN] Environment list.
+    const char* searchPathPtr   ///< [IN] Value of PATH in the environment list, or NULL.
+)
+{
+    if (pipe2(attrPtr->errPipeFd, O_CLOEXEC) == -1)
+    {
+        LE_ERROR("Could not create error pipe.  %m.");
+        return LE_FAULT;
+    }
+
+    attrPtr->syncPipeFd[READ_PIPE] = syncPipeFd[READ_PIPE];
+    attrPtr->syncPipeFd[WRITE_PIPE] = syncPipeFd[WRITE_PIPE];
+
+    attrPtr->stdInFd = procRef->stdInFd;
+    attrPtr->stdOutFd = (procRef->stdOutFd >= 0) ? procRef->stdOutFd : logStdOutPipe[WRITE_PIPE];
+    attrPtr->stdErrFd = (procRef->stdErrFd >= 0) ? procRef->stdErrFd : logStdErrPipe[WRITE_PIPE];
+
+    attrPtr->maxNumFds = sysconf(_SC_OPEN_MAX);
+    if (attrPtr->maxNumFds == -1)
+    {
+        attrPtr->maxNumFds = LIMIT_MAX_NUM_PROCESS_FD;
+    }
+
+    attrPtr->smackLabelPtr = smack_IsEnabled() ? app_GetSmackLabel(procRef->appRef) : NULL;
+
+    attrPtr->sandboxed = app_GetIsSandboxed(procRef->appRef);
+    attrPtr->workingDirPtr = app_GetWorkingDir(procRef->appRef);
+    attrPtr->uid = app_GetUid(procRef->appRef);
+    attrPtr->gid = app_GetGid(procRef->appRef);
+    attrPtr->numGroups = NUM_ARRAY_MEMBERS(attrPtr->groups);
+
+    LE_FATAL_IF(app_GetSupplementaryGroups(procRef->appRef, attrPtr->groups, &attrPtr->numGroups)
+                != LE_OK, "Supplementary groups list is too small.");
+
+    attrPtr->searchPathPtr = searchPathPtr;
+    attrPtr->argsPtr = argsPtr;
+    attrPtr->envPtr = envPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the spawner thread.  Clones the child, and is suspended until the child has
+ * exec'd or exited, so that the errno and other thread-local data the child shares with it can't
+ * be seen changing by anyone else.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SpawnerThreadMain
+(
+    void* contextPtr            ///< [IN] Spawn attributes.
+)
+{
+    SpawnAttr_t* attrPtr = contextPtr;
+
+    // The kernel sets the PID before the child runs, so the main thread can use it as soon as the
+    // child has posted the semaphore.
+    pid_t pid = clone(SpawnedChildMain, (char*)attrPtr->stackPtr + SPAWN_STACK_BYTES,
+                      CLONE_VM | CLONE_VFORK | CLONE_PARENT_SETTID | SIGCHLD, attrPtr,
+                      &attrPtr->pid);
+
+    if (pid == -1)
+    {
+        attrPtr->pid = -1;
+        attrPtr->cloneErrno = errno;
+        sem_post(&attrPtr->startedSem);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees what SpawnChild() allocated for a child, once the spawner thread is gone.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeSpawnResources
+(
+    SpawnAttr_t* attrPtr        ///< [IN] Spawn attributes.
+)
+{
+    LE_ASSERT(munmap(attrPtr->stackPtr, SPAWN_STACK_BYTES) == 0);
+    LE_ASSERT(sem_destroy(&attrPtr->startedSem) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Spawns a child process that will run SpawnedChildMain() on a stack of its own, sharing the
+ * Supervisor's memory until it execs.  Returns once the child is running, without waiting for it
+ * to exec (see WaitForSpawnedExec()).
+ *
+ * @return
+ *      The PID of the child if successful.
+ *      -1 if there was an error (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t SpawnChild
+(
+    SpawnAttr_t* attrPtr        ///< [IN] Spawn attributes.
+)
+{
+    int errNum;
+
+    attrPtr->stackPtr = mmap(NULL, SPAWN_STACK_BYTES, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+    if (attrPtr->stackPtr == MAP_FAILED)
+    {
+        errNum = errno;
+        fd_Close(attrPtr->errPipeFd[READ_PIPE]);
+        fd_Close(attrPtr->errPipeFd[WRITE_PIPE]);
+
+        errno = errNum;
+        return -1;
+    }
+
+    LE_ASSERT(sem_init(&attrPtr->startedSem, 0, 0) == 0);
+
+    // Block all signals, so that none of the Supervisor's signal handlers can run in the spawner
+    // thread, or in the child before it has restored the default dispositions.
+    sigset_t allSigs;
+    sigset_t oldSigs;
+    LE_ASSERT(0 == sigfillset(&allSigs));
+    LE_ASSERT(0 == pthread_sigmask(SIG_SETMASK, &allSigs, &oldSigs));
+
+    // The clone() is not done from this thread: CLONE_VFORK would suspend it until the child
+    // execs, but the child must wait for us to set its limits before it does.
+    errNum = pthread_create(&attrPtr->spawnerThread, NULL, SpawnerThreadMain, attrPtr);
+
+    LE_ASSERT(0 == pthread_sigmask(SIG_SETMASK, &oldSigs, NULL));
+
+    if (errNum == 0)
+    {
+        int result;
+
+        do
+        {
+            result = sem_wait(&attrPtr->startedSem);
+        }
+        while ((result == -1) && (errno == EINTR));
+
+        LE_ASSERT(result == 0);
+
+        if (attrPtr->pid != -1)
+        {
+            return attrPtr->pid;
+        }
+
+        LE_ASSERT(pthread_join(attrPtr->spawnerThread, NULL) == 0);
+        errNum = attrPtr->cloneErrno;
+    }
+
+    FreeSpawnResources(attrPtr);
+    fd_Close(attrPtr->errPipeFd[READ_PIPE]);
+    fd_Close(attrPtr->errPipeFd[WRITE_PIPE]);
+
+    errno = errNum;
+    return -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a spawned child to exec (or to die), logs the error it reported if any, and frees its
+ * stack.  The child uses the Supervisor's memory until then.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitForSpawnedExec
+(
+    proc_Ref_t procRef,         ///< [IN] The process started.
+    SpawnAttr_t* attrPtr        ///< [IN] Spawn attributes.
+)
+{
+    // The error pipe is closed when the child execs or exits, which is after it has left our
+    // memory for good.
+    SpawnError_t error;
+    ssize_t numBytesRead = fd_ReadSize(attrPtr->errPipeFd[READ_PIPE], &error, sizeof(error));
+
+    if (numBytesRead == sizeof(error))
+    {
+        char dummyBuf;
+        numBytesRead = fd_ReadSize(attrPtr->errPipeFd[READ_PIPE], &dummyBuf, sizeof(dummyBuf));
+
+        if ((error.step >= 0) && (error.step < SPAWN_NUM_STEPS))
+        {
+            LE_ERROR("Could not %s for process '%s' ('%s').  %s.",
+                     SpawnStepStr[error.step], procRef->namePtr, attrPtr->argsPtr[0],
+                     strerror(error.errNum));
+        }
+    }
+
+    fd_Close(attrPtr->errPipeFd[READ_PIPE]);
+
+    if (numBytesRead == LE_FAULT)
+    {
+        LE_ERROR("Could not read the error pipe of process '%s'.", procRef->namePtr);
+    }
+
+    // The spawner thread is resumed only once the child has left our memory for good.
+    LE_ASSERT(pthread_join(attrPtr->spawnerThread, NULL) == 0);
+
+    FreeSpawnResources(attrPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts a process.  If the process belongs to a sandboxed app the process will run in its sandbox,
@@ -1129,8 +1895,30 @@ le_result_t proc_Start
     CreateLogPipe(procRef, logStdOutPipe, STDOUT_FILENO);
     CreateLogPipe(procRef, logStdErrPipe, STDERR_FILENO);
 
-    // Create the child process
-    pid_t pID = fork();
+    // Create the child process.  Spawn it rather than fork the Supervisor, unless it must run the
+    // block callback before the exec.
+    bool isSpawned = (procRef->blockCallback == NULL);
+    SpawnAttr_t spawnAttr;
+    char envBuffers[LIMIT_MAX_NUM_ENV_VARS][LIMIT_MAX_ENV_VAR_NAME_BYTES + LIMIT_MAX_PATH_BYTES];
+    char* envPtr[LIMIT_MAX_NUM_ENV_VARS + 1];
+    pid_t pID;
+
+    if (isSpawned)
+    {
+        const char* searchPathPtr = BuildEnvList(envVars, numEnvVars, envBuffers, envPtr);
+
+        if (PrepareSpawnAttr(procRef, &spawnAttr, syncPipeFd, logStdOutPipe, logStdErrPipe,
+                             argsPtr, envPtr, searchPathPtr) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        pID = SpawnChild(&spawnAttr);
+    }
+    else
+    {
+        pID = fork();
+    }
 
     if (pID < 0)
     {
@@ -1150,10 +1938,7 @@ le_result_t proc_Start
         RedirectStdStreams(procRef, logStdOutPipe, logStdErrPipe);
 
         // Set the process's SMACK label.
-        char smackLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
-        smack_GetAppLabel(app_GetName(procRef->appRef), smackLabel, sizeof(smackLabel));
-
-        smack_SetMyLabel(smackLabel);
+        smack_SetMyLabel(app_GetSmackLabel(procRef->appRef));
 
         // Set the umask so that files are not accidentally created with global permissions.
         umask(S_IRWXG | S_IRWXO);
@@ -1216,11 +2001,17 @@ le_result_t proc_Start
         LE_FATAL("Could not exec '%s'.  %s.", argsPtr[0], strerror(execErrno));
     }
 
-    procRef->pid = pID;
+    SetPid(procRef, pID);
 
     // Don't need this end of the pipe.
     fd_Close(syncPipeFd[READ_PIPE]);
 
+    if (isSpawned)
+    {
+        // Only the child reports errors through this pipe.
+        fd_Close(spawnAttr.errPipeFd[WRITE_PIPE]);
+    }
+
     // Set the scheduling priority for the child process while the child process is blocked.
     SetSchedulingPriority(procRef);
 
@@ -1241,6 +2032,13 @@ le_result_t proc_Start
     // Unblock the child process.
     fd_Close(syncPipeFd[WRITE_PIPE]);
 
+    if (isSpawned)
+    {
+        // The child uses our memory, including the arguments and environment on this stack,
+        // until it execs.
+        WaitForSpawnedExec(procRef, &spawnAttr);
+    }
+
     // Check if the child process should be blocked.
     if (procRef->blockCallback != NULL)
     {
@@ -1316,6 +2114,56 @@ pid_t proc_GetPID
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the running process with the given PID.
+ *
+ * @return
+ *      The process reference if successful.
+ *      NULL if the PID is not the PID of a running process.
+ */
+//--------------------------------------------------------------------------------------------------
+proc_Ref_t proc_FindByPid
+(
+    pid_t pid                      ///< [IN] The PID to look for.
+)
+{
+    return le_hashmap_Get(PidMap, &pid);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the app that a process belongs to.
+ *
+ * @return
+ *      The app reference.
+ */
+//--------------------------------------------------------------------------------------------------
+app_Ref_t proc_GetAppRef
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+)
+{
+    return procRef->appRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops using the app's launch descriptor for a process: its launch settings are read from the
+ * config tree from then on.  Must be called before the launch descriptor is unloaded.
+ */
+//--------------------------------------------------------------------------------------------------
+void proc_DropLaunchDesc
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+)
+{
+    procRef->hasLaunchDesc = false;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's name.
@@ -1389,6 +2237,13 @@ bool proc_IsRealtime
     {
         priorStrPtr = procRef->priorityPtr;
     }
+    else if (procRef->hasLaunchDesc)
+    {
+        if (procRef->launchDesc.priorityPtr != NULL)
+        {
+            priorStrPtr = (char*)procRef->launchDesc.priorityPtr;
+        }
+    }
     else if (procRef->cfgPathPtr != NULL)
     {
         // Read the priority setting from the config tree.
@@ -1816,21 +2671,65 @@ void proc_SetRun
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the dump of a dead process's log ring, which the Log Control Daemon saves when the process
+ * disconnects from it, to LOG_RING_FAULT_DUMP_FILE for the saveLogs script to pick up.
+ *
+ * The Log Control Daemon may not have noticed that the process died yet, so this waits a little
+ * while for the dump to show up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TakeLogRingDump
+(
+    proc_Ref_t procRef,             ///< [IN] The process reference.
+    pid_t pid                       ///< [IN] The PID that the process had.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    int tries;
+
+    LE_ASSERT(snprintf(path, sizeof(path), "%s/%d", LOG_RING_DUMP_DIR, pid) < sizeof(path));
+
+    for (tries = 0; tries < 10; tries++)
+    {
+        if (rename(path, LOG_RING_FAULT_DUMP_FILE) == 0)
+        {
+            return;
+        }
+
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Could not move log ring dump '%s'.  %m.", path);
+            return;
+        }
+
+        usleep(50 * 1000);
+    }
+
+    // The process may never have connected to the Log Control Daemon.
+    LE_INFO("No log ring dump for process '%s'.", procRef->namePtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Called to capture any extra data that may help indicate what contributed to the fault that caused
  * the given process to fail.
  *
- * This function calls a shell script that will save a dump of the system log and any core files
- * that have been generated into a known location.
+ * This function calls a shell script that will save a dump of the system log, the process's last
+ * log messages and any core files that have been generated into a known location.
  */
 //--------------------------------------------------------------------------------------------------
 static void CaptureDebugData
 (
     proc_Ref_t procRef,             ///< [IN] The process reference.
+    pid_t pid,                      ///< [IN] The PID that the process had.
     bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
 )
 {
+    TakeLogRingDump(procRef, pid);
+
     char command[LIMIT_MAX_PATH_BYTES];
     int s = snprintf(command,
                      sizeof(command),
@@ -1974,7 +2873,7 @@ FaultAction_t proc_SigChildHandler
         procRef->cmdKill = false;
 
         // Remember that this process is dead.
-        procRef->pid = -1;
+        SetPid(procRef, -1);
 
         return FAULT_ACTION_NONE;
     }
@@ -2012,7 +2911,8 @@ FaultAction_t proc_SigChildHandler
     }
 
     // Record the fact that the process is dead.
-    procRef->pid = -1;
+    pid_t pid = procRef->pid;
+    SetPid(procRef, -1);
 
     // If the process has reached its fault limit, take action to stop
     // the apparently futile attempts to start this thing.
@@ -2042,7 +2942,7 @@ FaultAction_t proc_SigChildHandler
         // Check if we're rebooting.  If we are, this data needs to be saved in a more permanent
         // location.
         bool isRebooting = (faultAction == FAULT_ACTION_REBOOT);
-        CaptureDebugData(procRef, isRebooting);
+        CaptureDebugData(procRef, pid, isRebooting);
     }
 
     return faultAction;
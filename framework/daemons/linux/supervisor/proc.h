@@ -151,6 +151,47 @@ pid_t proc_GetPID
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the running process with the given PID.
+ *
+ * @return
+ *      The process reference if successful.
+ *      NULL if the PID is not the PID of a running process.
+ */
+//--------------------------------------------------------------------------------------------------
+proc_Ref_t proc_FindByPid
+(
+    pid_t pid                      ///< [IN] The PID to look for.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the app that a process belongs to.
+ *
+ * @return
+ *      The app reference.
+ */
+//--------------------------------------------------------------------------------------------------
+app_Ref_t proc_GetAppRef
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops using the app's launch descriptor for a process: its launch settings are read from the
+ * config tree from then on.  Must be called before the launch descriptor is unloaded.
+ */
+//--------------------------------------------------------------------------------------------------
+void proc_DropLaunchDesc
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's name.
@@ -210,6 +210,8 @@
 #include "sysPaths.h"
 #include "daemon.h"
 #include "apps.h"
+#include "appStats.h"
+#include "memPressure.h"
 #include "wait.h"
 #include "fileSystem.h"
 #include "sysStatus.h"
@@ -423,10 +425,14 @@ static void StartFramework
     wdog_AdvertiseService();
     le_appInfo_AdvertiseService();
     le_appProc_AdvertiseService();
+    le_appStats_AdvertiseService();
+    le_memPressure_AdvertiseService();
 
     // Initialize the apps sub system.
     apps_Init();
     apps_VerifyAppWriteableDeviceFiles();
+    appStats_Init();
+    memPressure_Init();
 
     State = STATE_NORMAL;
 
@@ -895,9 +901,12 @@ COMPONENT_INIT
     smack_Init();
 
     // Set correct smack permissions for syslog
-    smack_SetRule("_", "rw", "syslog");
-    smack_SetRule("admin", "rw", "syslog");
-    smack_SetRule("framework", "rw", "syslog");
+    smack_RuleBatch_t smackRules;
+    smack_InitRuleBatch(&smackRules);
+    smack_AddRuleToBatch(&smackRules, "_", "rw", "syslog");
+    smack_AddRuleToBatch(&smackRules, "admin", "rw", "syslog");
+    smack_AddRuleToBatch(&smackRules, "framework", "rw", "syslog");
+    smack_CommitRuleBatch(&smackRules);
 
     cgrp_Init();
 
@@ -13,6 +13,9 @@
  *       read-only/
  *       info.properties
  *       root.cfg
+ *   appFiles/
+ *     <appName>/
+ *       <contentHash>-<size>-<mode>
  *   systems/
  *     current/
  *       appsWriteable/
@@ -39,6 +42,8 @@
 #include "smack.h"
 #include "sysPaths.h"
 #include "fileSystem.h"
+#include "fileDescriptor.h"
+#include "installStats.h"
 
 
 static const char* InstallHookScriptPath = "/legato/systems/current/bin/install-hook";
@@ -53,6 +58,31 @@ static const char* PreInstallPath = "/legato/apps/%s/read-only/script/pre-instal
 static const char* PostInstallPath = "/legato/apps/%s/read-only/script/post-install";
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the file, at the top of a delta app update's payload, that lists the base app's files
+ * that aren't in the new version of the app.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* DeltaRemovalListName = ".delta-removed";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shared file store.  Holds a hard link to each distinct read-only file of each app installed,
+ * so that identical files in different versions of an app (in different systems) are stored
+ * only once.  A file's link count says how many installed apps share it, so a file in the store
+ * with only one link isn't used any more.
+ *
+ * legato/
+ *   appFiles/
+ *     <appName>/
+ *       <contentHash>-<size>-<mode>
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* SharedFilesPath = "/legato/appFiles";
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Import an applications configuration into the system config tree, allowing the supervisor to be
@@ -201,6 +231,246 @@ static void ExecPostinstallHook
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute a (64-bit FNV-1a) hash of a file's contents.
+ *
+ * @return LE_OK if successful, LE_FAULT if the file couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HashFile
+(
+    const char* pathPtr,    ///< [IN] Path to the file.
+    uint64_t* hashPtr       ///< [OUT] The hash.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = open(pathPtr, O_RDONLY);
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", pathPtr);
+        return LE_FAULT;
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    uint8_t buffer[4096];
+    ssize_t bytesRead;
+
+    while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t i = 0; i < bytesRead; i++)
+        {
+            hash = (hash ^ buffer[i]) * 1099511628211ULL;
+        }
+    }
+
+    if (bytesRead < 0)
+    {
+        LE_ERROR("Failed to read '%s' (%m).", pathPtr);
+    }
+
+    fd_Close(fd);
+
+    *hashPtr = hash;
+
+    return (bytesRead == 0) ? LE_OK : LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether two files (of the same size) have the same contents.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SameContents
+(
+    const char* path1Ptr,   ///< [IN] Path to one file.
+    const char* path2Ptr    ///< [IN] Path to the other file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd1 = open(path1Ptr, O_RDONLY);
+    int fd2 = open(path2Ptr, O_RDONLY);
+    bool isSame = ((fd1 >= 0) && (fd2 >= 0));
+
+    uint8_t buffer1[4096];
+    uint8_t buffer2[sizeof(buffer1)];
+
+    while (isSame)
+    {
+        ssize_t bytesRead1 = fd_ReadSize(fd1, buffer1, sizeof(buffer1));
+        ssize_t bytesRead2 = fd_ReadSize(fd2, buffer2, sizeof(buffer2));
+
+        if (   (bytesRead1 != bytesRead2)
+            || (bytesRead1 < 0)
+            || (memcmp(buffer1, buffer2, bytesRead1) != 0))
+        {
+            isSame = false;
+        }
+        else if (bytesRead1 == 0)
+        {
+            break;
+        }
+    }
+
+    if (fd1 >= 0)
+    {
+        fd_Close(fd1);
+    }
+    if (fd2 >= 0)
+    {
+        fd_Close(fd2);
+    }
+
+    return isSame;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Share an app file through the shared file store.  If the store already has a file with the same
+ * contents (and permissions) for this app, the app's file is replaced by a hard link to it.
+ * Otherwise, the app's file is added to the store.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ShareFile
+(
+    const char* storeDirPtr,    ///< [IN] The app's directory in the store.
+    const FTSENT* entPtr        ///< [IN] The app's file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const struct stat* statPtr = entPtr->fts_statp;
+
+    // Already shared.
+    if (statPtr->st_nlink > 1)
+    {
+        return LE_OK;
+    }
+
+    uint64_t hash;
+    if (HashFile(entPtr->fts_path, &hash) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    char storePath[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(storePath,
+                       sizeof(storePath),
+                       "%s/%016" PRIx64 "-%jx-%o",
+                       storeDirPtr,
+                       hash,
+                       (uintmax_t)statPtr->st_size,
+                       (unsigned int)(statPtr->st_mode & 07777)) < sizeof(storePath));
+
+    // If it's not in the store yet, add it.
+    if (link(entPtr->fts_path, storePath) == 0)
+    {
+        return LE_OK;
+    }
+    else if (errno != EEXIST)
+    {
+        LE_ERROR("Failed to link '%s' to '%s' (%m).", storePath, entPtr->fts_path);
+        return LE_FAULT;
+    }
+
+    // Otherwise, replace the app's copy with a link to the stored one (unless the hashes just
+    // happen to match).
+    if (!SameContents(entPtr->fts_path, storePath))
+    {
+        return LE_OK;
+    }
+
+    char tempPath[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(tempPath, sizeof(tempPath), "%s.shared", entPtr->fts_path)
+              < sizeof(tempPath));
+
+    (void)unlink(tempPath);
+
+    if (link(storePath, tempPath) != 0)
+    {
+        LE_ERROR("Failed to link '%s' to '%s' (%m).", tempPath, storePath);
+        return LE_FAULT;
+    }
+
+    if (rename(tempPath, entPtr->fts_path) != 0)
+    {
+        LE_ERROR("Failed to rename '%s' to '%s' (%m).", tempPath, entPtr->fts_path);
+        (void)unlink(tempPath);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Sharing '%s' as '%s'.", entPtr->fts_path, storePath);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hard link the files in an app's read-only directory to identical files in other installed
+ * versions of the same app, through the shared file store.
+ *
+ * Only files in the same app are shared, as the files' SMACK labels are per app.
+ *
+ * Failure to share a file isn't an error (it just takes up more space).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ShareReadOnlyFiles
+(
+    const char* appMd5Ptr,  ///< [IN] Hash ID of the application.
+    const char* appNamePtr  ///< [IN] Name of the application.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char storeDir[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(storeDir, sizeof(storeDir), "%s/%s", SharedFilesPath, appNamePtr)
+              < sizeof(storeDir));
+
+    if (le_dir_MakePath(storeDir, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Failed to create directory '%s'.", storeDir);
+        return;
+    }
+
+    char readOnlyPath[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(readOnlyPath, sizeof(readOnlyPath), "/legato/apps/%s/read-only", appMd5Ptr)
+              < sizeof(readOnlyPath));
+
+    char* pathArrayPtr[] = { readOnlyPath, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        LE_ERROR("Failed to open '%s' for traversal (%m).", readOnlyPath);
+        return;
+    }
+
+    size_t failCount = 0;
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        if ((entPtr->fts_info == FTS_F) && (ShareFile(storeDir, entPtr) != LE_OK))
+        {
+            failCount++;
+        }
+    }
+
+    fts_close(ftsPtr);
+
+    if (failCount > 0)
+    {
+        LE_WARN("%zu files in app '%s' <%s> couldn't be shared.",
+                failCount,
+                appNamePtr,
+                appMd5Ptr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Recursively sets the permissions for all files and directories in application read-only directory.
@@ -214,6 +484,15 @@ static le_result_t SetSmackPermReadOnlyDir
     const char* appNamePtr  ///< [IN] Name of the application to install.
 )
 {
+    char appPath[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(appPath, sizeof(appPath), "/legato/apps/%s", appMd5Ptr) < sizeof(appPath));
+
+    // An app installed as an image is read-only, and its files are labelled by its mount options.
+    if (fs_IsMountPoint(appPath))
+    {
+        return LE_OK;
+    }
+
     char fileLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
 
     // Get file label
@@ -301,6 +580,14 @@ static le_result_t SetSmackPermReadOnlyDir
     }
 
     fts_close(ftsPtr);
+
+    if (result == LE_OK)
+    {
+        // Now that the files are labelled, identical files in other versions of the app can be
+        // shared with them.
+        ShareReadOnlyFiles(appMd5Ptr, appNamePtr);
+    }
+
     return (result == LE_OK) ? LE_OK:LE_FAULT;
 }
 
@@ -526,6 +813,10 @@ static le_result_t PerformAppDelete
         char appPath[PATH_MAX];
         LE_ASSERT(snprintf(appPath, sizeof(appPath), "/legato/apps/%s", appMd5Ptr)
                   < sizeof(appPath));
+
+        // Unmount the app's image, if it was installed as one.
+        fs_TryLazyUmount(appPath);
+
         if (le_dir_RemoveRecursive(appPath) != LE_OK)
         {
             LE_ERROR("Was unable to remove old application path, '%s'.", appPath);
@@ -539,6 +830,8 @@ static le_result_t PerformAppDelete
 /**
  * Setup smack permission for contents in app's read-only directory.
  *
+ * @note Only uses the file system, so can be called from a worker thread.
+ *
  * @return LE_OK if successful, LE_FAULT if fails.
  *
  */
@@ -620,19 +913,283 @@ void app_PrepUnpackDir
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set up a given app's writeable files in the "unpack" system.
+ * Delete the files in the shared file store that are no longer used by any installed app (i.e.,
+ * that have no hard links other than the one in the store).
+ */
+//--------------------------------------------------------------------------------------------------
+void app_RemoveUnusedFiles
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!le_dir_IsDir(SharedFilesPath))
+    {
+        return;
+    }
+
+    char* pathArrayPtr[] = { (char*)SharedFilesPath, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        LE_ERROR("Failed to open '%s' for traversal (%m).", SharedFilesPath);
+        return;
+    }
+
+    size_t removeCount = 0;
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_F:
+                if (entPtr->fts_statp->st_nlink <= 1)
+                {
+                    if (unlink(entPtr->fts_path) != 0)
+                    {
+                        LE_ERROR("Failed to delete '%s' (%m).", entPtr->fts_path);
+                    }
+                    else
+                    {
+                        removeCount++;
+                    }
+                }
+                break;
+
+            case FTS_DP:
+                // Delete the directories of apps that have no files left (fails if not empty).
+                if (entPtr->fts_level == 1)
+                {
+                    (void)rmdir(entPtr->fts_path);
+                }
+                break;
+        }
+    }
+
+    fts_close(ftsPtr);
+
+    if (removeCount > 0)
+    {
+        LE_INFO("Removed %zu unused shared app files.", removeCount);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Populate an (empty) unpack directory with the files of an installed app, so that a delta app
+ * update can be unpacked over them.
  *
- * Files will be copied to the system unpack area based on whether an app with the same name
- * exists in the current system.
+ * Regular files are hard linked rather than copied, so files that the delta doesn't change take
+ * no extra space.  Unpacking the delta is safe, because tar replaces a file by unlinking it first,
+ * so it never writes through a link into the installed app.
  *
- * @warning Assumes the app identified by the hash is installed in /legato/apps/<hash>.
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_CloneForDelta
+(
+    const char* baseMd5Ptr,     ///< [IN] Hash ID of the installed app the delta is against.
+    const char* destPathPtr     ///< [IN] Path to the directory to populate.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char basePath[LIMIT_MAX_PATH_BYTES] = "";
+    int baseDirPathLen = snprintf(basePath, sizeof(basePath), "/legato/apps/%s", baseMd5Ptr);
+    LE_ASSERT(baseDirPathLen < sizeof(basePath));
+
+    char* pathArrayPtr[] = { basePath, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        LE_CRIT("Failed to open '%s' for traversal (%m).", basePath);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+
+    FTSENT* entPtr;
+    while ((result == LE_OK) && ((entPtr = fts_read(ftsPtr)) != NULL))
+    {
+        // The top level directory already exists.
+        if (entPtr->fts_level == 0)
+        {
+            continue;
+        }
+
+        char destPath[LIMIT_MAX_PATH_BYTES];
+        if (snprintf(destPath,
+                     sizeof(destPath),
+                     "%s%s",
+                     destPathPtr,
+                     entPtr->fts_path + baseDirPathLen) >= sizeof(destPath))
+        {
+            LE_CRIT("Path to file '%s' is too long.", entPtr->fts_path);
+            result = LE_FAULT;
+            break;
+        }
+
+        switch (entPtr->fts_info)
+        {
+            case FTS_D:
+                // Owner write permission is needed until the directory has been filled, so the
+                // directory's own permissions are set when it's visited in post-order.
+                if (mkdir(destPath, S_IRWXU) != 0)
+                {
+                    LE_CRIT("Failed to create directory '%s' (%m).", destPath);
+                    result = LE_FAULT;
+                }
+                break;
+
+            case FTS_DP:
+                if (chmod(destPath, entPtr->fts_statp->st_mode & 07777) != 0)
+                {
+                    LE_CRIT("Failed to set permissions of directory '%s' (%m).", destPath);
+                    result = LE_FAULT;
+                }
+                break;
+
+            case FTS_F:
+                if (link(entPtr->fts_path, destPath) != 0)
+                {
+                    LE_CRIT("Failed to link '%s' to '%s' (%m).", destPath, entPtr->fts_path);
+                    result = LE_FAULT;
+                }
+                break;
+
+            case FTS_SL:
+            case FTS_SLNONE:
+            {
+                char targetPath[LIMIT_MAX_PATH_BYTES];
+                ssize_t len = readlink(entPtr->fts_path, targetPath, sizeof(targetPath) - 1);
+
+                if (len < 0)
+                {
+                    LE_CRIT("Failed to read symlink '%s' (%m).", entPtr->fts_path);
+                    result = LE_FAULT;
+                }
+                else
+                {
+                    targetPath[len] = '\0';
+
+                    if (symlink(targetPath, destPath) != 0)
+                    {
+                        LE_CRIT("Failed to create symlink '%s' (%m).", destPath);
+                        result = LE_FAULT;
+                    }
+                }
+                break;
+            }
+
+            default:
+                LE_CRIT("Unexpected file type %d at '%s'.", entPtr->fts_info, entPtr->fts_path);
+                result = LE_FAULT;
+                break;
+        }
+    }
+
+    fts_close(ftsPtr);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish reconstructing an app from a delta app update, by deleting the files that the delta's
+ * removal list (if it has one) says aren't in the new version of the app.  The list holds one
+ * path per line, relative to the app's directory, and is itself deleted afterwards.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_ApplyDeltaRemovals
+(
+    const char* appPathPtr      ///< [IN] Path to the directory the delta was unpacked into.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char listPath[LIMIT_MAX_PATH_BYTES] = "";
+    LE_ASSERT(le_path_Concat("/", listPath, sizeof(listPath), appPathPtr, DeltaRemovalListName,
+                             NULL) == LE_OK);
+
+    FILE* listFilePtr = fopen(listPath, "r");
+    if (listFilePtr == NULL)
+    {
+        if (errno == ENOENT)
+        {
+            return LE_OK;
+        }
+
+        LE_CRIT("Failed to open '%s' (%m).", listPath);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    char line[LIMIT_MAX_PATH_BYTES];
+
+    while ((result == LE_OK) && (fgets(line, sizeof(line), listFilePtr) != NULL))
+    {
+        line[strcspn(line, "\n")] = '\0';
+
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+
+        // The paths have to stay inside the app.
+        size_t len = strlen(line);
+        if (   (line[0] == '/')
+            || (strcmp(line, "..") == 0)
+            || (strncmp(line, "../", 3) == 0)
+            || (strstr(line, "/../") != NULL)
+            || ((len >= 3) && (strcmp(line + len - 3, "/..") == 0)))
+        {
+            LE_CRIT("Bad path '%s' in delta removal list.", line);
+            result = LE_FAULT;
+            break;
+        }
+
+        char path[LIMIT_MAX_PATH_BYTES] = "";
+        if (le_path_Concat("/", path, sizeof(path), appPathPtr, line, NULL) != LE_OK)
+        {
+            LE_CRIT("Path '%s' in delta removal list is too long.", line);
+            result = LE_FAULT;
+        }
+        else if (le_dir_RemoveRecursive(path) != LE_OK)
+        {
+            LE_CRIT("Failed to remove '%s'.", path);
+            result = LE_FAULT;
+        }
+    }
+
+    fclose(listFilePtr);
+
+    if ((result == LE_OK) && (unlink(listPath) != 0))
+    {
+        LE_CRIT("Failed to delete '%s' (%m).", listPath);
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a given app's config tree to the "unpack" system, if an app with the same name exists in
+ * the current system.
+ *
+ * @note Uses the config tree, so must be called from the main thread.
  *
  * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t app_SetUpAppWriteables
+le_result_t app_InheritConfig
 (
-    const char* appMd5Ptr,  ///< [IN] Hash ID of the application to install.
     const char* appNamePtr  ///< [IN] Name of the application to install.
 )
 //--------------------------------------------------------------------------------------------------
@@ -647,6 +1204,31 @@ le_result_t app_SetUpAppWriteables
         }
     }
 
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up a given app's writeable files in the "unpack" system.
+ *
+ * Files will be copied to the system unpack area based on whether an app with the same name
+ * exists in the current system.
+ *
+ * @note Only uses the file system, so can be called from a worker thread.
+ *
+ * @warning Assumes the app identified by the hash is installed in /legato/apps/<hash>.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_SetUpAppWriteables
+(
+    const char* appMd5Ptr,  ///< [IN] Hash ID of the application to install.
+    const char* appNamePtr  ///< [IN] Name of the application to install.
+)
+//--------------------------------------------------------------------------------------------------
+{
     // Install appropriate writable app files.
     return installer_InstallAppWriteableFiles(appMd5Ptr, appNamePtr, "current");
 }
@@ -711,6 +1293,15 @@ le_result_t app_InstallIndividual
         }
     }
 
+    // If the app was installed as an image, its files are only reachable once it's mounted.
+    char appPath[PATH_MAX];
+    LE_ASSERT(snprintf(appPath, sizeof(appPath), "/legato/apps/%s", appMd5Ptr) < sizeof(appPath));
+
+    if (installer_MountAppImage(appPath, appNamePtr) == LE_FAULT)
+    {
+        return LE_FAULT;
+    }
+
     // If this app is already in the current system but its app hash is different,
     if (systemHasThisApp)
     {
@@ -723,7 +1314,9 @@ le_result_t app_InstallIndividual
         le_utf8_Copy(newAppName, ".new.", sizeof(newAppName), NULL);
         le_utf8_Append(newAppName, appNamePtr, sizeof(newAppName), NULL);
         system_SymlinkApp("current", appMd5Ptr, newAppName);
+        installStats_Begin(INSTALL_STATS_SYNC);
         sync();
+        installStats_End(INSTALL_STATS_SYNC);
 
         // Otherwise, stop it before we update it.
         supCtrl_StopApp(appNamePtr);
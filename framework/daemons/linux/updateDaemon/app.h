@@ -57,10 +57,52 @@ void app_PrepUnpackDir
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the files in the shared file store that are no longer used by any installed app.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_RemoveUnusedFiles
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Populate an (empty) unpack directory with hard links to the files of an installed app, so that
+ * a delta app update can be unpacked over them.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_CloneForDelta
+(
+    const char* baseMd5Ptr,     ///< [IN] Hash ID of the installed app the delta is against.
+    const char* destPathPtr     ///< [IN] Path to the directory to populate.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish reconstructing an app from a delta app update, by deleting the files listed in the
+ * delta's removal list.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_ApplyDeltaRemovals
+(
+    const char* appPathPtr      ///< [IN] Path to the directory the delta was unpacked into.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Setup smack permission for contents in app's read-only directory.
  *
+ * @note Only uses the file system, so can be called from a worker thread.
+ *
  * @return LE_OK if successful, LE_FAULT if fails.
  *
  */
@@ -72,6 +114,22 @@ le_result_t app_SetSmackPermReadOnly
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a given app's config tree to the "unpack" system, if an app with the same name exists in
+ * the current system.
+ *
+ * @note Uses the config tree, so must be called from the main thread.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_InheritConfig
+(
+    const char* appNamePtr  ///< [IN] Name of the application to install.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set up a given app's writeable files in the "unpack" system.
@@ -79,6 +137,8 @@ le_result_t app_SetSmackPermReadOnly
  * Files will be copied to the system unpack area based on whether an app with the same name
  * exists in the current system.
  *
+ * @note Only uses the file system, so can be called from a worker thread.
+ *
  * @warning Assumes the app identified by the hash is installed in /legato/apps/<hash>.
  *
  * @return LE_OK if successful.
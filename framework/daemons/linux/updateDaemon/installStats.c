@@ -0,0 +1,258 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file installStats.c
+ *
+ * Timing and byte counts of the phases of an install.  At the end of each install, a summary is
+ * logged on a single line, such as:
+ *
+ * @verbatim
+install success: total 12.345s, 3 sections, 1048576 payload bytes (84.9 KiB/s), 0 skipped;
+header 0.012s, payload 10.101s, untar 0.220s, verify 0.003s, snapshot 0.950s, apply 0.871s,
+sync 0.188s
+@endverbatim
+ *
+ * The payload time includes waiting for the update pack to arrive, so if the payload throughput
+ * is close to the speed of the link, the network is the bottleneck.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "installStats.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in an install summary.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SUMMARY_BYTES   384
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the phases, as they appear in the summary.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const PhaseNames[INSTALL_STATS_NUM_PHASES] =
+{
+    [INSTALL_STATS_HEADER]   = "header",
+    [INSTALL_STATS_PAYLOAD]  = "payload",
+    [INSTALL_STATS_UNTAR]    = "untar",
+    [INSTALL_STATS_VERIFY]   = "verify",
+    [INSTALL_STATS_SNAPSHOT] = "snapshot",
+    [INSTALL_STATS_APPLY]    = "apply",
+    [INSTALL_STATS_SYNC]     = "sync",
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the install in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct
+{
+    bool isActive;                                      ///< true between Start and Finish.
+    le_clk_Time_t startTime;                            ///< When the install started.
+    le_clk_Time_t phaseStart[INSTALL_STATS_NUM_PHASES]; ///< When each phase last began.
+    bool isPhaseActive[INSTALL_STATS_NUM_PHASES];       ///< true if a phase is being timed.
+    le_clk_Time_t phaseTotal[INSTALL_STATS_NUM_PHASES]; ///< Total time in each phase.
+    size_t numSections;                                 ///< Number of update pack sections.
+    size_t payloadBytes;                                ///< Payload bytes unpacked.
+    size_t skippedBytes;                                ///< Payload bytes skipped.
+}
+Stats;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summary of the last finished install.
+ */
+//--------------------------------------------------------------------------------------------------
+static char Summary[SUMMARY_BYTES] = "";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @return A time in seconds, as a double.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ToSeconds
+(
+    le_clk_Time_t time
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return time.sec + (time.usec / 1000000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the statistics at the start of an install.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Start
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    memset(&Stats, 0, sizeof(Stats));
+
+    Stats.isActive = true;
+    Stats.startTime = le_clk_GetRelativeTime();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start timing a phase.  Does nothing if the phase is already being timed.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Begin
+(
+    installStats_Phase_t phase  ///< [IN] The phase.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(phase < INSTALL_STATS_NUM_PHASES);
+
+    if (Stats.isActive && !Stats.isPhaseActive[phase])
+    {
+        Stats.isPhaseActive[phase] = true;
+        Stats.phaseStart[phase] = le_clk_GetRelativeTime();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop timing a phase, and add the time since installStats_Begin() to its total.  Does nothing if
+ * the phase isn't being timed.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_End
+(
+    installStats_Phase_t phase  ///< [IN] The phase.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(phase < INSTALL_STATS_NUM_PHASES);
+
+    if (Stats.isPhaseActive[phase])
+    {
+        Stats.isPhaseActive[phase] = false;
+        Stats.phaseTotal[phase] = le_clk_Add(Stats.phaseTotal[phase],
+                                             le_clk_Sub(le_clk_GetRelativeTime(),
+                                                        Stats.phaseStart[phase]));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count payload bytes that have been read from the update pack.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_AddPayloadBytes
+(
+    size_t numBytes,    ///< [IN] Number of bytes.
+    bool isSkipped      ///< [IN] true if the bytes were skipped rather than unpacked.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (isSkipped)
+    {
+        Stats.skippedBytes += numBytes;
+    }
+    else
+    {
+        Stats.payloadBytes += numBytes;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a section of the update pack.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_AddSection
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Stats.numSections++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish the install's statistics (if they haven't been already) and log them on a single line.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Finish
+(
+    const char* outcomePtr  ///< [IN] How the install ended (e.g., "success").
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!Stats.isActive)
+    {
+        return;
+    }
+
+    for (int phase = 0; phase < INSTALL_STATS_NUM_PHASES; phase++)
+    {
+        installStats_End(phase);
+    }
+
+    Stats.isActive = false;
+
+    double totalSec = ToSeconds(le_clk_Sub(le_clk_GetRelativeTime(), Stats.startTime));
+    double payloadSec = ToSeconds(Stats.phaseTotal[INSTALL_STATS_PAYLOAD]);
+
+    size_t len = snprintf(Summary,
+                          sizeof(Summary),
+                          "install %s: total %.3fs, %zu sections, %zu payload bytes (%.1f KiB/s),"
+                          " %zu skipped;",
+                          outcomePtr,
+                          totalSec,
+                          Stats.numSections,
+                          Stats.payloadBytes,
+                          (payloadSec > 0) ? (Stats.payloadBytes / 1024.0 / payloadSec) : 0.0,
+                          Stats.skippedBytes);
+
+    for (int phase = 0; (phase < INSTALL_STATS_NUM_PHASES) && (len < sizeof(Summary)); phase++)
+    {
+        len += snprintf(Summary + len,
+                        sizeof(Summary) - len,
+                        "%s %s %.3fs",
+                        (phase == 0) ? "" : ",",
+                        PhaseNames[phase],
+                        ToSeconds(Stats.phaseTotal[phase]));
+    }
+
+    LE_INFO("%s", Summary);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the summary of the last finished install, as logged by installStats_Finish().
+ *
+ * @return The summary, or an empty string if no install has finished yet.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* installStats_GetSummary
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return Summary;
+}
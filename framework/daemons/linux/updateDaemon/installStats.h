@@ -0,0 +1,116 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file installStats.h
+ *
+ * Timing and byte counts of the phases of an install, used to tell where the time goes when an
+ * update is slow (the network, parsing, unpacking, hashing or writing to flash).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_INSTALL_STATS_H_INCLUDE_GUARD
+#define LEGATO_INSTALL_STATS_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Phases of an install that are timed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    INSTALL_STATS_HEADER,   ///< Reading and parsing JSON section headers.
+    INSTALL_STATS_PAYLOAD,  ///< Reading payloads and feeding them to the unpacker.
+    INSTALL_STATS_UNTAR,    ///< Waiting for the unpacker after the last payload byte was fed to it.
+    INSTALL_STATS_VERIFY,   ///< Waiting for the hash of a payload.
+    INSTALL_STATS_SNAPSHOT, ///< Taking a snapshot of the current system.
+    INSTALL_STATS_APPLY,    ///< Installing the unpacked update (including the snapshot and sync).
+    INSTALL_STATS_SYNC,     ///< Flushing the file system to flash.
+    INSTALL_STATS_NUM_PHASES
+}
+installStats_Phase_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the statistics at the start of an install.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Start
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start timing a phase.  Does nothing if the phase is already being timed.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Begin
+(
+    installStats_Phase_t phase  ///< [IN] The phase.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop timing a phase, and add the time since installStats_Begin() to its total.  Does nothing if
+ * the phase isn't being timed.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_End
+(
+    installStats_Phase_t phase  ///< [IN] The phase.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count payload bytes that have been read from the update pack.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_AddPayloadBytes
+(
+    size_t numBytes,    ///< [IN] Number of bytes.
+    bool isSkipped      ///< [IN] true if the bytes were skipped rather than unpacked.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a section of the update pack.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_AddSection
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish the install's statistics (if they haven't been already) and log them on a single line.
+ */
+//--------------------------------------------------------------------------------------------------
+void installStats_Finish
+(
+    const char* outcomePtr  ///< [IN] How the install ended (e.g., "success").
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the summary of the last finished install, as logged by installStats_Finish().
+ *
+ * @return The summary, or an empty string if no install has finished yet.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* installStats_GetSummary
+(
+    void
+);
+
+
+#endif  // LEGATO_INSTALL_STATS_H_INCLUDE_GUARD
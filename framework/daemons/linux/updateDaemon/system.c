@@ -19,6 +19,8 @@
 #include "supCtrl.h"
 #include "file.h"
 #include "system.h"
+#include "app.h"
+#include "installStats.h"
 #include "installer.h"
 #include "sysPaths.h"
 #include "sysStatus.h"
@@ -214,6 +216,133 @@ static bool IsDir
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a top-level directory of a system is one whose files are never changed once the
+ * system has been installed (so snapshots can share them with the current system).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsImmutableSystemDir
+(
+    const char* dirNamePtr      ///< [IN] Name of the directory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The framework's programs, libraries and kernel modules are only ever replaced by installing
+    // a whole new system.
+    static const char* const immutableDirs[] = { "bin", "lib", "modules" };
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(immutableDirs); i++)
+    {
+        if (strcmp(dirNamePtr, immutableDirs[i]) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a copy of the current system in the unpack directory.  The directories that are never
+ * changed once the system is installed are hard linked rather than copied, so that a snapshot
+ * only costs the (small) size of the system's configuration and writeable files.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyCurrentSystem
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DIR* currentDir = opendir(CURRENT_SYSTEM_PATH);
+
+    if (currentDir == NULL)
+    {
+        LE_ERROR("Error opening directory %s.  %m.", CURRENT_SYSTEM_PATH);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+
+    while (result == LE_OK)
+    {
+        errno = 0;
+
+        struct dirent* dirPtr = readdir(currentDir);
+
+        if (dirPtr == NULL)
+        {
+            if (errno != 0)
+            {
+                LE_ERROR("Error reading directory %s.  %m.", CURRENT_SYSTEM_PATH);
+                result = LE_FAULT;
+            }
+
+            break;
+        }
+
+        if ((strcmp(dirPtr->d_name, ".") == 0) || (strcmp(dirPtr->d_name, "..") == 0))
+        {
+            continue;
+        }
+
+        char sourcePath[LIMIT_MAX_PATH_BYTES] = CURRENT_SYSTEM_PATH;
+        char destPath[LIMIT_MAX_PATH_BYTES] = "";
+
+        if (   (le_path_Concat("/", sourcePath, sizeof(sourcePath), dirPtr->d_name, NULL) != LE_OK)
+            || (le_path_Concat("/", destPath, sizeof(destPath), system_UnpackPath, dirPtr->d_name,
+                               NULL) != LE_OK))
+        {
+            LE_ERROR("Path to '%s' is too long.", dirPtr->d_name);
+            result = LE_FAULT;
+            break;
+        }
+
+        // Mounted files and directories aren't part of the system.
+        if (fs_IsMountPoint(sourcePath))
+        {
+            continue;
+        }
+
+        if (dirPtr->d_type == DT_LNK)
+        {
+            char linkBuffer[PATH_MAX] = "";
+            ssize_t bytesRead = readlink(sourcePath, linkBuffer, sizeof(linkBuffer) - 1);
+
+            if ((bytesRead < 0) || (symlink(linkBuffer, destPath) != 0))
+            {
+                LE_ERROR("Failed to copy symlink '%s' (%m).", sourcePath);
+                result = LE_FAULT;
+            }
+        }
+        else if (IsImmutableSystemDir(dirPtr->d_name) && le_dir_IsDir(sourcePath))
+        {
+            if (file_LinkRecursive(sourcePath, destPath) != LE_OK)
+            {
+                result = LE_FAULT;
+            }
+        }
+        else if (file_CopyRecursive(sourcePath, destPath, NULL) != LE_OK)
+        {
+            result = LE_FAULT;
+        }
+    }
+
+    if (closedir(currentDir) != 0)
+    {
+        LE_ERROR("Failed to close dir '%s'. %m", CURRENT_SYSTEM_PATH);
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the version string for the current system.
@@ -740,6 +869,13 @@ le_result_t system_FinishUpdate
         return LE_FAULT;
     }
 
+    // Build the new system's dynamic linker cache now, rather than when it is started.  If this
+    // fails, the start program will rebuild the cache before starting the system.
+    if (installer_BuildLdSoCache(system_UnpackPath) != LE_OK)
+    {
+        LE_WARN("The dynamic linker cache will be built when the new system starts.");
+    }
+
     // Set the smackfs permission of unpacked system. This has to be done before renaming unpack
     // path to some index.
     SetSystemFilesPermissions(system_UnpackPath);
@@ -755,22 +891,18 @@ le_result_t system_FinishUpdate
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Take a snapshot of the current system.
+ * Take a snapshot of the current system (see system_Snapshot()).
  *
  * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t system_Snapshot
+static le_result_t TakeSnapshot
 (
-    void
+    sysStatus_Status_t status,  ///< [IN] Status of the current system.
+    int currentIndex            ///< [IN] Index of the current system.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    sysStatus_Status_t status = sysStatus_Status();
-
-    // Copy the current system to the work dir.
-    int currentIndex = system_Index();
-
     if (status != SYS_GOOD)
     {
         LE_WARN("System has not yet passed probation, no snapshot taken.");
@@ -783,7 +915,7 @@ le_result_t system_Snapshot
 
     system_PrepUnpackDir();
 
-    if (file_CopyRecursive(CURRENT_SYSTEM_PATH, system_UnpackPath, NULL) != LE_OK)
+    if (CopyCurrentSystem() != LE_OK)
     {
         return LE_FAULT;
     }
@@ -885,6 +1017,27 @@ le_result_t system_Snapshot
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a snapshot of the current system.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t system_Snapshot
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    installStats_Begin(INSTALL_STATS_SNAPSHOT);
+    le_result_t result = TakeSnapshot(sysStatus_Status(), system_Index());
+    installStats_End(INSTALL_STATS_SNAPSHOT);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mark the system as being modified.
@@ -1036,6 +1189,9 @@ void system_RemoveUnusedApps
                 {
                     LE_INFO("Removing unused app with MD5 sum %s.", foundHashPtr);
 
+                    // The app may have been installed as an image, and mounted.
+                    fs_TryLazyUmount(entPtr->fts_path);
+
                     if (le_dir_RemoveRecursive(entPtr->fts_path) != LE_OK)
                     {
                         LE_ERROR("Unable to remove '%s'.", entPtr->fts_path);
@@ -1057,6 +1213,9 @@ void system_RemoveUnusedApps
     }
 
     fts_close(ftsPtr);
+
+    // The files that were only used by the removed apps can go too.
+    app_RemoveUnusedFiles();
 }
 
 
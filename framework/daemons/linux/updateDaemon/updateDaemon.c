@@ -41,6 +41,7 @@
 #include "user.h"
 #include "pipeline.h"
 #include "updateUnpack.h"
+#include "installStats.h"
 #include "instStat.h"
 #include "app.h"
 #include "system.h"
@@ -66,6 +67,14 @@
 #define MAX_CFGTREE_NAME_BYTES   LIMIT_MAX_USER_NAME_BYTES
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of worker threads setting up the apps of a system update in parallel.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_APP_SETUP_THREADS   4
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * State of the Update Daemon state machine.
@@ -122,6 +131,37 @@ static le_msg_SessionRef_t IpcSession = NULL;
 pipeline_Ref_t SecurityUnpackPipeline = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * App of a system update, to be set up by one of the worker threads.
+ *
+ * These are allocated from the AppSetupPool and kept in the AppSetupList.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;                         ///< Used to link into the AppSetupList.
+    char appName[LIMIT_MAX_APP_NAME_BYTES];     ///< Name of the app.
+    char appMd5[LIMIT_MD5_STR_BYTES];           ///< Hash ID of the app.
+    bool isUnpacked;                            ///< Unpacked from the update (needs SMACK labels)?
+    bool isInSystem;                            ///< In the new system (needs writeable files)?
+    le_result_t result;                         ///< Result of the set up.
+}
+AppSetup_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool and list of the apps of the system update being applied, and next one to be picked up by a
+ * worker thread (protected by AppSetupMutex).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AppSetupPool;
+static le_sls_List_t AppSetupList = LE_SLS_LIST_INIT;
+static le_sls_Link_t* NextAppSetupLinkPtr = NULL;
+static le_mutex_Ref_t AppSetupMutex;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure that can hold the details of a client's registered progress notification handler.
@@ -406,6 +446,7 @@ static void UpdateFailed
     // Should notify client only once if it is at failed state.
     if (ErrorCode == LE_UPDATE_ERR_NONE)
     {
+        installStats_Finish("failure");
         CallStatusHandlers(LE_UPDATE_STATE_FAILED, 0);
         LE_ERROR("Update failed!!");
     }
@@ -428,6 +469,8 @@ static void ReportUpdateDone
 )
 //--------------------------------------------------------------------------------------------------
 {
+    installStats_Finish("success");
+
     CallStatusHandlers(LE_UPDATE_STATE_APPLYING, 100);
     CallStatusHandlers(LE_UPDATE_STATE_SUCCESS, 100);
 }
@@ -435,7 +478,186 @@ static void ReportUpdateDone
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Install system applications from unpack directory.
+ * Get the app of the system update with a given hash, adding it to the AppSetupList if it isn't
+ * there yet.
+ *
+ * @return The app.
+ **/
+//--------------------------------------------------------------------------------------------------
+static AppSetup_t* GetAppSetup
+(
+    const char* appMd5Ptr,  ///< [IN] Hash ID of the app.
+    const char* appNamePtr  ///< [IN] Name of the app.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr;
+    AppSetup_t* appPtr;
+
+    for (linkPtr = le_sls_Peek(&AppSetupList);
+         linkPtr != NULL;
+         linkPtr = le_sls_PeekNext(&AppSetupList, linkPtr))
+    {
+        appPtr = CONTAINER_OF(linkPtr, AppSetup_t, link);
+
+        if (strcmp(appPtr->appMd5, appMd5Ptr) == 0)
+        {
+            return appPtr;
+        }
+    }
+
+    appPtr = le_mem_ForceAlloc(AppSetupPool);
+    memset(appPtr, 0, sizeof(*appPtr));
+    appPtr->link = LE_SLS_LINK_INIT;
+    LE_ASSERT(le_utf8_Copy(appPtr->appMd5, appMd5Ptr, sizeof(appPtr->appMd5), NULL) == LE_OK);
+    LE_ASSERT(le_utf8_Copy(appPtr->appName, appNamePtr, sizeof(appPtr->appName), NULL) == LE_OK);
+    appPtr->result = LE_OK;
+
+    le_sls_Queue(&AppSetupList, &appPtr->link);
+
+    return appPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the apps of the system update.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ClearAppSetups
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&AppSetupList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, AppSetup_t, link));
+    }
+
+    NextAppSetupLinkPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread setting up the apps of the system update: each takes the next app not yet picked
+ * up from the AppSetupList, until there are none left.  Only the file system is used, so the
+ * apps are independent of each other.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void* AppSetupThreadMain
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (true)
+    {
+        le_mutex_Lock(AppSetupMutex);
+
+        le_sls_Link_t* linkPtr = NextAppSetupLinkPtr;
+        if (linkPtr != NULL)
+        {
+            NextAppSetupLinkPtr = le_sls_PeekNext(&AppSetupList, linkPtr);
+        }
+
+        le_mutex_Unlock(AppSetupMutex);
+
+        if (linkPtr == NULL)
+        {
+            break;
+        }
+
+        AppSetup_t* appPtr = CONTAINER_OF(linkPtr, AppSetup_t, link);
+
+        // Now setup the smack permission.
+        if (appPtr->isUnpacked
+            && (app_SetSmackPermReadOnly(appPtr->appMd5, appPtr->appName) != LE_OK))
+        {
+            LE_CRIT("Failed to setup smack permission for app '%s<%s>'",
+                    appPtr->appName,
+                    appPtr->appMd5);
+            appPtr->result = LE_FAULT;
+            continue;
+        }
+
+        // Set up the app's writeable files in the new system (copying from install dir and/or
+        // current system).
+        if (appPtr->isInSystem
+            && (app_SetUpAppWriteables(appPtr->appMd5, appPtr->appName) != LE_OK))
+        {
+            LE_CRIT("Failed to setup writable for app '%s<%s>'",
+                    appPtr->appName,
+                    appPtr->appMd5);
+            appPtr->result = LE_FAULT;
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up the apps of the system update in parallel, in up to MAX_APP_SETUP_THREADS worker threads,
+ * and wait for all of them.
+ *
+ * @return
+ *      - LE_OK if successful
+ *      - LE_FAULT if any app failed
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetUpSystemApps
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_thread_Ref_t threads[MAX_APP_SETUP_THREADS];
+    le_sls_Link_t* linkPtr;
+    le_result_t result = LE_OK;
+    size_t numApps = le_sls_NumLinks(&AppSetupList);
+    size_t numThreads = (numApps < MAX_APP_SETUP_THREADS) ? numApps : MAX_APP_SETUP_THREADS;
+    size_t i;
+
+    LE_INFO("Setting up %zu apps in %zu threads.", numApps, numThreads);
+
+    NextAppSetupLinkPtr = le_sls_Peek(&AppSetupList);
+
+    for (i = 0; i < numThreads; i++)
+    {
+        char name[LIMIT_MAX_THREAD_NAME_BYTES];
+        snprintf(name, sizeof(name), "appSetup%zu", i);
+        threads[i] = le_thread_Create(name, AppSetupThreadMain, NULL);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+    }
+    for (i = 0; i < numThreads; i++)
+    {
+        le_thread_Join(threads[i], NULL);
+    }
+
+    for (linkPtr = le_sls_Peek(&AppSetupList);
+         linkPtr != NULL;
+         linkPtr = le_sls_PeekNext(&AppSetupList, linkPtr))
+    {
+        if (CONTAINER_OF(linkPtr, AppSetup_t, link)->result != LE_OK)
+        {
+            result = LE_FAULT;
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install system applications from unpack directory, and add them to the AppSetupList to have
+ * their SMACK permissions set up.
  *
  * @return
  *      - LE_OK if successful
@@ -533,14 +755,9 @@ static le_result_t InstallSystemApps
                         return LE_FAULT;
                     }
 
-                    // Now setup the smack permission.
-                    if (app_SetSmackPermReadOnly(appMd5Hash, appName) != LE_OK)
-                    {
-                        LE_CRIT("Failed to setup smack permission for app '%s<%s>'",
-                                appName,
-                                appMd5Hash);
-                        return LE_FAULT;
-                    }
+                    // The smack permission is set up by SetUpSystemApps().
+                    GetAppSetup(appMd5Hash, appName)->isUnpacked = true;
+
                     // We don't need to go into this directory.
                     fts_set(ftsPtr, entPtr, FTS_SKIP);
                 }
@@ -568,7 +785,8 @@ static le_result_t InstallSystemApps
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Setup writable files for all system applications.
+ * Copy the config trees of all system applications, and add them to the AppSetupList to have
+ * their writable files set up.
  *
  * @return
  *      - LE_OK if successful
@@ -616,21 +834,23 @@ static le_result_t SetupSystemAppsWritable
 
                 LE_DEBUG("Path '%s' AppName '%s', MD5 '%s'", entPtr->fts_path, appName, appMd5Buf);
 
-                // Set up the app's writeable files in the new system (copying from install dir and/or
-                // current system).
-                if (app_SetUpAppWriteables(appMd5Buf, appName) != LE_OK)
+                // The config tree is only reachable from this thread; the writeable files are set
+                // up by SetUpSystemApps().
+                if (app_InheritConfig(appName) != LE_OK)
                 {
                     if (ftsPtr)
                     {
                        fts_close(ftsPtr);
                     }
 
-                    LE_CRIT("Failed to setup writable for app '%s<%s>'",
+                    LE_CRIT("Failed to copy config of app '%s<%s>'",
                             appName,
                             appMd5Buf);
                     return LE_FAULT;
                 }
 
+                GetAppSetup(appMd5Buf, appName)->isInSystem = true;
+
                 // We don't need to go into this directory.
                 fts_set(ftsPtr, entPtr, FTS_SKIP);
             }
@@ -657,13 +877,23 @@ static void ApplySystemUpdate
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (InstallSystemApps() != LE_OK)
+    // Move the apps into place and copy their config trees first, then set up their files in
+    // parallel.  Nothing is committed until system_FinishUpdate().
+    le_result_t result = InstallSystemApps();
+
+    if (result == LE_OK)
     {
-        UpdateFailed(LE_UPDATE_ERR_INTERNAL_ERROR);
-        return;
+        result = SetupSystemAppsWritable();
+    }
+
+    if (result == LE_OK)
+    {
+        result = SetUpSystemApps();
     }
 
-    if (SetupSystemAppsWritable() != LE_OK)
+    ClearAppSetups();
+
+    if (result != LE_OK)
     {
         UpdateFailed(LE_UPDATE_ERR_INTERNAL_ERROR);
         return;
@@ -768,6 +998,7 @@ static void ApplyUpdate
 //--------------------------------------------------------------------------------------------------
 {
     State = STATE_APPLYING;
+    installStats_Begin(INSTALL_STATS_APPLY);
     CallStatusHandlers(LE_UPDATE_STATE_APPLYING, 0);
     switch (updateUnpack_GetType())
     {
@@ -1525,6 +1756,9 @@ static void UpdateUsersAndGroups
 
     // Walk the apps directory under the current system, and for each app in the directory,
     // make sure it has a user account and primary group in the new passwd and group files.
+    // The accounts are created in a single batch, so the files are only rewritten once.
+    LE_FATAL_IF(user_BeginBatch() != LE_OK, "Failed to start creating app users.");
+
     char* pathArrayPtr[] = { "/legato/systems/current/apps", NULL };
     FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
     FTSENT* entPtr;
@@ -1540,7 +1774,7 @@ static void UpdateUsersAndGroups
                 LE_ASSERT(  snprintf(userName, sizeof(userName), "app%s", appNamePtr)
                           < sizeof(userName));
 
-                le_result_t result = user_Create(userName, NULL, NULL);
+                le_result_t result = user_AddToBatch(userName, NULL, NULL);
                 if (result == LE_OK)
                 {
                     LE_INFO("User '%s' created for app '%s'.", userName, appNamePtr);
@@ -1565,6 +1799,8 @@ static void UpdateUsersAndGroups
     }
 
     fts_close(ftsPtr);
+
+    LE_FATAL_IF(user_CommitBatch() != LE_OK, "Failed to write the app users.");
 }
 
 
@@ -1804,6 +2040,7 @@ le_result_t le_update_Start
 
     // Pass the readFd to the updateUnpacker module.
     LE_DEBUG("Starting unpack");
+    installStats_Start();
     updateUnpack_Start(readFd, HandleUpdateProgress);
 
     State = STATE_UNPACKING;
@@ -1961,6 +2198,34 @@ int32_t le_update_GetPreviousSystemIndex
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a summary of the phase timings and byte counts of the last install.
+ *
+ * @return
+ *      - LE_OK if the summary was copied to the buffer.
+ *      - LE_NOT_FOUND if no install has finished since the Update Daemon started.
+ *      - LE_OVERFLOW if the supplied buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_update_GetInstallStats
+(
+    char* summary,          ///< [OUT] Buffer to hold the summary.
+    size_t summarySize      ///< [IN]  Size of the summary buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* statsPtr = installStats_GetSummary();
+
+    if (statsPtr[0] == '\0')
+    {
+        return LE_NOT_FOUND;
+    }
+
+    return le_utf8_Copy(summary, statsPtr, summarySize, NULL);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Removes a given app from the target device.
@@ -2060,6 +2325,8 @@ COMPONENT_INIT
     // Initialize pools
     ClientProgressHandlerPool = le_mem_CreatePool("ProgressHandler",
                                                   sizeof(ClientProgressHandler_t));
+    AppSetupPool = le_mem_CreatePool("AppSetup", sizeof(AppSetup_t));
+    AppSetupMutex = le_mutex_CreateNonRecursive("AppSetup");
 
     // Initialize the client progress handler reference counter to some random value.
     NextClientProgressHandlerRef = random();
@@ -15,15 +15,26 @@
 #include "interfaces.h"
 #include "limit.h"
 #include "updateUnpack.h"
+#include "installStats.h"
 #include "pipeline.h"
 #include "fileDescriptor.h"
 #include "system.h"
 #include "app.h"
+#include "installer.h"
+
+#include <sys/socket.h>
+#include <linux/if_alg.h>
 
 
 /// An MD5 hash string is 32 characters long, plus a null terminator.
 #define MD5_STRING_BYTES 33
 
+/// Maximum number of payload bytes moved by each splice() call.
+#define SPLICE_CHUNK_BYTES (64 * 1024)
+
+/// Size of the buffer payload bytes are copied through when they can't be spliced.
+#define COPY_BUFFER_BYTES (16 * 1024)
+
 /// File descriptor to read the update pack from.
 static int InputFd = -1;
 
@@ -36,6 +47,44 @@ static pipeline_Ref_t Pipeline = NULL;
 /// File descriptor connected to the input of a pipeline (-1 if not unpacking)
 static int PipelineFd = -1;
 
+/// Reference to the FD Monitor that waits for room in the pipeline's input pipe when it's full
+/// (NULL if it hasn't been needed yet).
+static le_fdMonitor_Ref_t PipelineFdMonitor = NULL;
+
+/// true if the last attempt to move payload bytes stopped because the output pipe was full, rather
+/// than because there were no more bytes to read.
+static bool IsOutputFull = false;
+
+/// File descriptor open on /dev/null, for splicing skipped payload bytes into (-1 if not open).
+static int DevNullFd = -1;
+
+/// true if the input stream can't be spliced (neither it nor the output is a pipe, or it's of a
+/// kind that doesn't support splice()), so payload bytes have to be copied through a buffer.
+static bool IsSpliceUnsupported = false;
+
+/// Pipe that the payload passes through on its way to the unpack pipeline while it's being checked
+/// against its MD5 hash, so that it can be tee()'d to the hash thread (-1 if not checking).
+static int StagePipeReadFd = -1;
+static int StagePipeWriteFd = -1;
+
+/// Number of payload bytes in the stage pipe that haven't been moved on to the pipeline yet, and
+/// how many of those (from the start of the stage pipe) have been tee()'d to the hash thread.
+static size_t StagedBytes = 0;
+static size_t TeedBytes = 0;
+
+/// Pipe that the hash thread reads the payload from (-1 if not checking).
+static int HashPipeReadFd = -1;
+static int HashPipeWriteFd = -1;
+
+/// AF_ALG socket that the hash thread hashes the payload with (-1 if not checking).
+static int HashOpFd = -1;
+
+/// Thread that hashes the payload (NULL if not checking).
+static le_thread_Ref_t HashThread = NULL;
+
+/// MD5 hash of the payload computed by the hash thread.  Only valid once it has been joined.
+static char ComputedMd5[MD5_STRING_BYTES];
+
 /// Function to be called to report progress.
 static updateUnpack_ProgressHandler_t ProgressFunc = NULL;
 
@@ -51,6 +100,23 @@ static char AppName[LIMIT_MAX_APP_NAME_BYTES];
 /// The MD5 hash obtained from a JSON header.
 static char Md5[MD5_STRING_BYTES]; ///< The system's MD5 hash.
 
+/// The MD5 hash of the payload obtained from a JSON header (empty if there isn't one).
+static char PayloadMd5[MD5_STRING_BYTES];
+
+/// The MD5 hash of the installed app that an app update is a delta against (empty if the
+/// payload is the whole app).
+static char DeltaFromMd5[MD5_STRING_BYTES];
+
+/// The format of an app update's payload, obtained from a JSON header (empty for a tarball).
+static char Format[16];
+
+/// Format of an app update payload that is a read-only file system image, to be installed as is
+/// rather than unpacked.
+#define APP_IMAGE_FORMAT "squashfs"
+
+/// Path to the directory an app is being unpacked into.
+static char AppUnpackDir[LIMIT_MAX_PATH_BYTES];
+
 /// # of bytes of payload following the JSON.
 static size_t PayloadSize;
 
@@ -121,7 +187,7 @@ static le_json_ParsingSessionRef_t ParsingSession = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Delete the FD Monitor object.
+ * Delete the FD Monitor objects.
  */
 //--------------------------------------------------------------------------------------------------
 static void DeleteFdMonitor
@@ -135,9 +201,16 @@ static void DeleteFdMonitor
         le_fdMonitor_Delete(InputFdMonitor);
         InputFdMonitor = NULL;
     }
+    if (PipelineFdMonitor != NULL)
+    {
+        le_fdMonitor_Delete(PipelineFdMonitor);
+        PipelineFdMonitor = NULL;
+    }
 }
 
 
+static le_result_t FinishVerify(void);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reset the update unpacker.
@@ -161,6 +234,9 @@ static void Reset
 
     DeleteFdMonitor();
 
+    // Stop checking the payload; the result doesn't matter any more.
+    FinishVerify();
+
     // Close the pipes.
     if (InputFd != -1)
     {
@@ -172,6 +248,11 @@ static void Reset
         fd_Close(PipelineFd);
         PipelineFd = -1;
     }
+    if (DevNullFd != -1)
+    {
+        fd_Close(DevNullFd);
+        DevNullFd = -1;
+    }
 
     // Delete the pipeline.
     if (Pipeline != NULL)
@@ -293,6 +374,8 @@ static void JsonErrorHandler
 )
 //--------------------------------------------------------------------------------------------------
 {
+    installStats_End(INSTALL_STATS_HEADER);
+
     switch (error)
     {
         case LE_JSON_SYNTAX_ERROR:
@@ -349,10 +432,14 @@ static void StartParsing
     Command[0] = '\0';
     AppName[0] = '\0';
     Md5[0] = '\0';
+    PayloadMd5[0] = '\0';
+    DeltaFromMd5[0] = '\0';
+    Format[0] = '\0';
     PayloadSize = 0;
 
     // Set the state
     State = STATE_PARSING_JSON;
+    installStats_Begin(INSTALL_STATS_HEADER);
 
     // Start the parser (and wait for callbacks).
     ParsingSession = le_json_Parse(InputFd, JsonEventHandler, JsonErrorHandler, NULL);
@@ -374,6 +461,8 @@ static void UntarDone
     pipeline_Delete(Pipeline);
     Pipeline = NULL;
 
+    installStats_End(INSTALL_STATS_UNTAR);
+
     if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
     {
         if (WIFEXITED(status))
@@ -393,6 +482,23 @@ static void UntarDone
         return;
     }
 
+    // The payload's hash has been computed alongside the unpack, so it's ready (or nearly) now.
+    if (FinishVerify() != LE_OK)
+    {
+        LE_ERROR("Malformed update pack (payload doesn't match its MD5 hash)");
+        HandleFormatError();
+        return;
+    }
+
+    // A delta app update has only been unpacked over the files of the app it's against,
+    // so the files that aren't in the new version of the app still need to be removed.
+    if ((DeltaFromMd5[0] != '\0') && (app_ApplyDeltaRemovals(AppUnpackDir) != LE_OK))
+    {
+        LE_ERROR("Failed to reconstruct app <%s> from delta against <%s>.", Md5, DeltaFromMd5);
+        HandleInternalError();
+        return;
+    }
+
     // If this update pack contains changes to individual apps,
     if (Type == TYPE_APP_UPDATE)
     {
@@ -439,6 +545,8 @@ static void SkipForwardDone
 )
 //--------------------------------------------------------------------------------------------------
 {
+    installStats_End(INSTALL_STATS_PAYLOAD);
+
     PercentDone = 100;
     ReportProgress();
 
@@ -463,101 +571,578 @@ static void SkipForwardDone
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy bytes from the input fd to the pipeline's input fd until the input fd's read buffer is
- * empty or we have copied all the payload bytes.
+ * Check whether writing to an fd would accept some data now.
+ *
+ * @return true if it would (or if writing would fail straight away), false if it would block.
  */
 //--------------------------------------------------------------------------------------------------
-static void CopyBytesToPipeline
+static bool IsWritable
 (
-    void
+    int fd              ///< File descriptor to check.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
+    struct pollfd pollFd = { .fd = fd, .events = POLLOUT };
+    int pollResult;
 
-    // Keep copying as much as we can until we've copied all the payload.
-    while (PayloadBytesCopied < PayloadSize)
+    do
+    {
+        pollResult = poll(&pollFd, 1, 0);
+    }
+    while ((pollResult == -1) && (errno == EINTR));
+
+    return (pollResult != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move up to a given number of bytes from the input fd to another fd.
+ *
+ * Where possible, the bytes are moved with splice(), so they never pass through this process's
+ * memory.  If the input stream doesn't support that, they are read into a buffer and written out.
+ *
+ * @return The number of bytes moved, 0 at the end of the input stream, or -1 on error (errno is
+ *         EWOULDBLOCK if there are currently no bytes available to be read from the input fd, or
+ *         if the output fd is a non-blocking pipe that's full, in which case IsOutputFull is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t MoveInputBytes
+(
+    int outFd,          ///< File descriptor to move the bytes to.
+    size_t maxBytes     ///< Maximum number of bytes to move.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static char buffer[COPY_BUFFER_BYTES];
+
+    IsOutputFull = false;
+
+    if (maxBytes > SPLICE_CHUNK_BYTES)
     {
-        // Compute the number of bytes to read.
-        size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
+        maxBytes = SPLICE_CHUNK_BYTES;
+    }
+
+    while (!IsSpliceUnsupported)
+    {
+        ssize_t spliceResult = splice(InputFd, NULL, outFd, NULL, maxBytes,
+                                      SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (spliceResult >= 0)
         {
-            bytesToRead = sizeof(buffer);
+            return spliceResult;
         }
 
-        // Read the bytes, retrying if interrupted by a signal.
-        ssize_t readResult;
-        do
+        if (errno == EINVAL)
         {
-            readResult = read(InputFd, buffer, bytesToRead);
+            LE_INFO("Input stream can't be spliced; copying it instead.");
+            IsSpliceUnsupported = true;
         }
-        while ((readResult == -1) && (errno == EINTR));
+        else if (errno == EWOULDBLOCK)
+        {
+            // Either there are no bytes to read, or the output pipe is full.
+            IsOutputFull = !IsWritable(outFd);
+            errno = EWOULDBLOCK;
+            return -1;
+        }
+        else if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
 
-        // Handle errors
-        if (readResult == -1)
+    if (maxBytes > sizeof(buffer))
+    {
+        maxBytes = sizeof(buffer);
+    }
+
+    // Don't take bytes out of the input stream if there's no room for any of them.
+    if (!IsWritable(outFd))
+    {
+        IsOutputFull = true;
+        errno = EWOULDBLOCK;
+        return -1;
+    }
+
+    // Read the bytes, retrying if interrupted by a signal.
+    ssize_t readResult;
+    do
+    {
+        readResult = read(InputFd, buffer, maxBytes);
+    }
+    while ((readResult == -1) && (errno == EINTR));
+
+    if (readResult <= 0)
+    {
+        return readResult;
+    }
+
+    // Write the bytes that we read.
+    ssize_t bytesWritten = 0;
+    while (bytesWritten < readResult)
+    {
+        ssize_t writeResult = write(outFd, buffer + bytesWritten, readResult - bytesWritten);
+
+        // If some bytes were written, remember how many bytes, so we don't try to write the
+        // same bytes again if we have more to write.
+        if (writeResult >= 0)
         {
-            // EWOULDBLOCK indicates that there are currently no more bytes available to be
-            // read from the fd, but more will probably become available later.
-            if (errno == EWOULDBLOCK)
+            bytesWritten += writeResult;
+        }
+        else if (errno == EWOULDBLOCK)
+        {
+            // The pipe had room for some of the bytes, but not all of them.  They can't be put
+            // back into the input stream, so wait for room for the rest.
+            struct pollfd pollFd = { .fd = outFd, .events = POLLOUT };
+            poll(&pollFd, 1, -1);
+        }
+        else if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+
+    return readResult;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the hash thread.  Hashes the payload bytes that come through the hash pipe
+ * until the write end is closed, then stores the hash in ComputedMd5.
+ *
+ * The bytes are spliced into the kernel's MD5 implementation (AF_ALG) as they arrive, so hashing
+ * runs alongside unpacking and the payload is never copied into this process's memory.
+ *
+ * @return LE_OK if the hash was computed, LE_FAULT otherwise (cast to a void pointer).
+ */
+//--------------------------------------------------------------------------------------------------
+static void* HashThreadMain
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+    unsigned char digest[16];
+    ssize_t spliceResult;
+
+    do
+    {
+        spliceResult = splice(HashPipeReadFd, NULL, HashOpFd, NULL, SPLICE_CHUNK_BYTES,
+                              SPLICE_F_MORE);
+    }
+    while ((spliceResult > 0) || ((spliceResult == -1) && (errno == EINTR)));
+
+    if (spliceResult == -1)
+    {
+        LE_ERROR("Failed to hash payload (%m).");
+        result = LE_FAULT;
+    }
+    // An empty send without MSG_MORE finishes the hash.
+    else if (   (send(HashOpFd, NULL, 0, 0) == -1)
+             || (read(HashOpFd, digest, sizeof(digest)) != sizeof(digest)))
+    {
+        LE_ERROR("Failed to get payload hash (%m).");
+        result = LE_FAULT;
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < sizeof(digest); i++)
+        {
+            snprintf(ComputedMd5 + (2 * i), 3, "%02x", digest[i]);
+        }
+    }
+
+    fd_Close(HashPipeReadFd);
+    HashPipeReadFd = -1;
+    fd_Close(HashOpFd);
+    HashOpFd = -1;
+
+    return (void*)(intptr_t)result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a socket to hash data with the kernel's MD5 implementation (AF_ALG).
+ *
+ * @return The socket's file descriptor, or -1 if the kernel doesn't provide one (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenMd5Socket
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct sockaddr_alg address =
+    {
+        .salg_family = AF_ALG,
+        .salg_type = "hash",
+        .salg_name = "md5"
+    };
+
+    int algFd = socket(AF_ALG, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (algFd == -1)
+    {
+        return -1;
+    }
+
+    int opFd = -1;
+
+    if (bind(algFd, (struct sockaddr*)&address, sizeof(address)) == 0)
+    {
+        opFd = accept4(algFd, NULL, 0, SOCK_CLOEXEC);
+    }
+
+    int savedErrno = errno;
+    fd_Close(algFd);
+    errno = savedErrno;
+
+    return opFd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start checking the payload against the MD5 hash in its JSON header, if there is one.  The
+ * payload is passed through the stage pipe, from which it is tee()'d to the hash thread as it's
+ * moved on to the unpack pipeline.
+ *
+ * Update packs made by older tools don't have a payload hash, and older kernels may not be able
+ * to compute one; their payloads are unpacked without being checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartVerify
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int stagePipe[2];
+    int hashPipe[2];
+
+    if (PayloadMd5[0] == '\0')
+    {
+        return;
+    }
+
+    HashOpFd = OpenMd5Socket();
+    if (HashOpFd == -1)
+    {
+        LE_WARN("Can't check payload hash; kernel MD5 not available (%m).");
+        return;
+    }
+
+    LE_FATAL_IF(pipe2(stagePipe, O_CLOEXEC) == -1, "Failed to create pipe (%m).");
+    LE_FATAL_IF(pipe2(hashPipe, O_CLOEXEC) == -1, "Failed to create pipe (%m).");
+
+    StagePipeReadFd = stagePipe[0];
+    StagePipeWriteFd = stagePipe[1];
+    HashPipeReadFd = hashPipe[0];
+    HashPipeWriteFd = hashPipe[1];
+
+    // Give the hash thread more slack, so tee() waits for it less often.
+    pipeline_SetPipeSize(HashPipeWriteFd, PIPELINE_PIPE_BYTES);
+
+    StagedBytes = 0;
+    TeedBytes = 0;
+    ComputedMd5[0] = '\0';
+
+    HashThread = le_thread_Create("payloadHash", HashThreadMain, NULL);
+    le_thread_SetJoinable(HashThread);
+    le_thread_Start(HashThread);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop checking the payload: wait for the hash thread to finish hashing whatever it has been
+ * given, and release the pipes.  Does nothing if the payload isn't being checked.
+ *
+ * @return
+ *      - LE_OK if the payload matches its hash, or isn't being checked.
+ *      - LE_FAULT if it doesn't match, or couldn't be hashed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FinishVerify
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+    void* threadResultPtr;
+
+    if (HashThread == NULL)
+    {
+        return LE_OK;
+    }
+
+    // Closing the write end of the hash pipe tells the hash thread it has all the bytes.
+    if (HashPipeWriteFd != -1)
+    {
+        fd_Close(HashPipeWriteFd);
+        HashPipeWriteFd = -1;
+    }
+
+    installStats_Begin(INSTALL_STATS_VERIFY);
+    le_thread_Join(HashThread, &threadResultPtr);
+    HashThread = NULL;
+    installStats_End(INSTALL_STATS_VERIFY);
+
+    fd_Close(StagePipeReadFd);
+    StagePipeReadFd = -1;
+    fd_Close(StagePipeWriteFd);
+    StagePipeWriteFd = -1;
+    StagedBytes = 0;
+    TeedBytes = 0;
+
+    if ((le_result_t)(intptr_t)threadResultPtr != LE_OK)
+    {
+        result = LE_FAULT;
+    }
+    else if (strcasecmp(ComputedMd5, PayloadMd5) != 0)
+    {
+        LE_ERROR("Payload hash mismatch (expected %s, got %s).", PayloadMd5, ComputedMd5);
+        result = LE_FAULT;
+    }
+    else
+    {
+        LE_INFO("Payload hash verified: %s", ComputedMd5);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the bytes in the stage pipe on to the pipeline's input fd, giving the hash thread a copy of
+ * them on the way.
+ *
+ * @return
+ *      - LE_OK if the stage pipe is empty.
+ *      - LE_WOULD_BLOCK if the pipeline's input pipe is full (IsOutputFull is set).
+ *      - LE_FAULT on error (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MoveStagedBytes
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // tee() always duplicates from the start of the stage pipe, so move each piece it duplicates
+    // on to the pipeline before duplicating the next.
+    while (StagedBytes > 0)
+    {
+        if (TeedBytes == 0)
+        {
+            ssize_t teeResult = tee(StagePipeReadFd, HashPipeWriteFd, StagedBytes, 0);
+            if (teeResult == -1)
             {
-                // Break out of the loop and let the FD Monitor call us back when there's
-                // more to read.
-                break;
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return LE_FAULT;
             }
 
-            LE_ERROR("Failed to read from input stream (%m).");
-            goto error;
+            TeedBytes = teeResult;
         }
 
-        // Handle end of file.
-        if (readResult == 0)
+        ssize_t spliceResult = splice(StagePipeReadFd, NULL, PipelineFd, NULL, TeedBytes,
+                                      SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (spliceResult == -1)
         {
-            LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
-                     PayloadBytesCopied,
-                     PayloadSize);
-            goto error;
+            if (errno == EWOULDBLOCK)
+            {
+                IsOutputFull = true;
+                return LE_WOULD_BLOCK;
+            }
+            if (errno != EINTR)
+            {
+                return LE_FAULT;
+            }
+            continue;
         }
 
-        // Write the bytes that we read.
-        ssize_t bytesWritten = 0;
-        ssize_t writeResult;
-        do
-        {
-            writeResult = write(PipelineFd, buffer + bytesWritten, readResult - bytesWritten);
+        StagedBytes -= spliceResult;
+        TeedBytes -= spliceResult;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move up to a given number of bytes from the input fd to the pipeline's input fd, giving the
+ * hash thread a copy of them on the way.
+ *
+ * The bytes go through the stage pipe.  If the pipeline can't take all of them, the rest are left
+ * there, and moved on before any more are taken from the input fd.
+ *
+ * @return As for MoveInputBytes().
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t MoveVerifiedInputBytes
+(
+    size_t maxBytes     ///< Maximum number of bytes to move.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t stageResult = MoveStagedBytes();
+
+    if (stageResult == LE_WOULD_BLOCK)
+    {
+        errno = EWOULDBLOCK;
+        return -1;
+    }
+    else if (stageResult != LE_OK)
+    {
+        return -1;
+    }
+
+    ssize_t result = MoveInputBytes(StagePipeWriteFd, maxBytes);
+
+    if (result <= 0)
+    {
+        return result;
+    }
+
+    // The bytes have been taken from the input stream, so they count as moved even if some of
+    // them are left in the stage pipe for now.
+    StagedBytes = result;
+
+    if (MoveStagedBytes() == LE_FAULT)
+    {
+        return -1;
+    }
+
+    return result;
+}
+
+
+static void PipelineFdEventHandler(int fd, short events);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop reading the input fd until there's room in the pipeline's input pipe again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitForPipeline
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_fdMonitor_Disable(InputFdMonitor, POLLIN);
+
+    if (PipelineFdMonitor == NULL)
+    {
+        PipelineFdMonitor = le_fdMonitor_Create("unpackOut",
+                                                PipelineFd,
+                                                PipelineFdEventHandler,
+                                                POLLOUT);
+    }
+    else
+    {
+        le_fdMonitor_Enable(PipelineFdMonitor, POLLOUT);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy bytes from the input fd to the pipeline's input fd until the input fd's read buffer is
+ * empty or we have copied all the payload bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyBytesToPipeline
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Keep copying as much as we can until we've copied all the payload.
+    while (PayloadBytesCopied < PayloadSize)
+    {
+        size_t bytesLeft = PayloadSize - PayloadBytesCopied;
+        ssize_t result = (HashThread != NULL) ? MoveVerifiedInputBytes(bytesLeft)
+                                              : MoveInputBytes(PipelineFd, bytesLeft);
 
-            // If some bytes were written, remember how many bytes, so we don't try to write the
-            // same bytes again if we have more to write.
-            if (writeResult > 0)
+        // Handle errors
+        if (result == -1)
+        {
+            // EWOULDBLOCK indicates that either there are currently no more bytes available to
+            // be read from the fd, or the pipeline can't take any more for now.
+            if (errno == EWOULDBLOCK)
             {
-                bytesWritten += writeResult;
+                // Let an FD Monitor call us back when we can carry on.
+                if (IsOutputFull)
+                {
+                    WaitForPipeline();
+                }
+                return;
             }
+
+            LE_ERROR("Failed to copy input stream to unpack pipeline (%m).");
+            goto error;
         }
-        while (   ((writeResult == -1) && (errno == EINTR)) // Retry if interrupted by a signal
-               || ((writeResult != -1) && (bytesWritten < readResult))  ); // Continue if not done
 
-        // Check for errors.
-        if (writeResult == -1)
+        // Handle end of file.
+        if (result == 0)
         {
-            LE_ERROR("Failed to write to output stream (%m)");
+            LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
+                     PayloadBytesCopied,
+                     PayloadSize);
             goto error;
         }
 
         // Update the static progress variables and report progress to the client.
-        PayloadBytesCopied += readResult;
+        PayloadBytesCopied += result;
+        installStats_AddPayloadBytes(result, false);
         PercentDone = (100 * PayloadBytesCopied) / PayloadSize;
         ReportProgress();
     }
 
     // If we have copied all the payload bytes to the pipeline's input, then we can stop
-    // monitoring the input fd now, close the pipeline input write pipe, and wait for the pipeline
-    // completion callback (UntarDone()).
+    // monitoring the input fd now, close the pipeline input write pipe (and the hash pipe, so
+    // the hash thread finishes while tar does), and wait for the pipeline completion callback
+    // (UntarDone()).
     LE_INFO("Payload copied: %zu/%zu", PayloadBytesCopied, PayloadSize);
     LE_ASSERT(PayloadBytesCopied <= PayloadSize);
     if (PayloadBytesCopied == PayloadSize)
     {
+        // The last of the payload may still be in the stage pipe, waiting for room in the
+        // pipeline's input pipe.
+        le_result_t stageResult = MoveStagedBytes();
+        if (stageResult == LE_WOULD_BLOCK)
+        {
+            WaitForPipeline();
+            return;
+        }
+        else if (stageResult != LE_OK)
+        {
+            LE_ERROR("Failed to copy input stream to unpack pipeline (%m).");
+            goto error;
+        }
+
         DeleteFdMonitor();
         fd_Close(PipelineFd);
         PipelineFd = -1;
+
+        installStats_End(INSTALL_STATS_PAYLOAD);
+        installStats_Begin(INSTALL_STATS_UNTAR);
+
+        if (HashPipeWriteFd != -1)
+        {
+            fd_Close(HashPipeWriteFd);
+            HashPipeWriteFd = -1;
+        }
     }
     return;
 
@@ -579,28 +1164,13 @@ static void DiscardPayloadBytes
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
-
     // Keep reading as much as we can until we've read all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
-        // Compute the number of bytes to read.
-        size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
-        {
-            bytesToRead = sizeof(buffer);
-        }
-
-        // Read the bytes, retrying if interrupted by a signal.
-        ssize_t readResult;
-        do
-        {
-            readResult = read(InputFd, buffer, bytesToRead);
-        }
-        while ((readResult == -1) && (errno == EINTR));
+        ssize_t result = MoveInputBytes(DevNullFd, PayloadSize - PayloadBytesCopied);
 
         // Handle errors
-        if (readResult == -1)
+        if (result == -1)
         {
             // EWOULDBLOCK indicates that there are currently no more bytes available to be
             // read from the fd, but more will probably become available later.
@@ -613,10 +1183,22 @@ static void DiscardPayloadBytes
 
             LE_ERROR("Failed to read from input stream (%m).");
             HandleInternalError();
+            return;
+        }
+
+        // Handle end of file.
+        if (result == 0)
+        {
+            LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
+                     PayloadBytesCopied,
+                     PayloadSize);
+            HandleInternalError();
+            return;
         }
 
         // Update the static progress variables and report progress to the client.
-        PayloadBytesCopied += readResult;
+        PayloadBytesCopied += result;
+        installStats_AddPayloadBytes(result, true);
         PercentDone = (100 * PayloadBytesCopied) / PayloadSize;
         ReportProgress();
     }
@@ -668,6 +1250,34 @@ static void InputFdEventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for the pipeline's input fd, called when there's room in the pipeline's input
+ * pipe again after it filled up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PipelineFdEventHandler
+(
+    int fd,
+    short events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_fdMonitor_Disable(PipelineFdMonitor, POLLOUT);
+
+    if (events & POLLOUT)
+    {
+        le_fdMonitor_Enable(InputFdMonitor, POLLIN);
+        CopyBytesToPipeline();
+    }
+    else
+    {
+        LE_ERROR("Error on unpack pipeline's input file descriptor.");
+        HandleInternalError();
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function that runs in the unpack pipeline's "tar" process.
@@ -686,13 +1296,63 @@ static int Untar
     fd_CloseAllNonStd();
 
     // Try bsdtar first.  If that fails, fallback to tar.
-    execl("/usr/bin/bsdtar", "bsdtar", "xjmop", "-f", "-", "-C", unpackDir, (char*)NULL);
+    // Files that are already there (hard links to an installed app, when unpacking a delta) are
+    // unlinked before they're replaced, rather than written through.
+    execl("/usr/bin/bsdtar", "bsdtar", "xjmopU", "-f", "-", "-C", unpackDir, (char*)NULL);
     execl("/bin/tar", "tar", "xjop", "-C", unpackDir, (char*)NULL);
 
     LE_FATAL("Failed to exec tar (%m)");
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that runs in the unpack pipeline's process when the payload is an app's file system
+ * image, which is stored as is in the unpack directory (see INSTALLER_APP_IMAGE_FILE).
+ **/
+//--------------------------------------------------------------------------------------------------
+static int WriteImage
+(
+    void* param
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* unpackDir = param;
+
+    fd_CloseAllNonStd();
+
+    char imagePath[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(imagePath, sizeof(imagePath), "%s/" INSTALLER_APP_IMAGE_FILE, unpackDir)
+              < sizeof(imagePath));
+
+    int fd = open(imagePath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    LE_FATAL_IF(fd == -1, "Failed to create '%s' (%m)", imagePath);
+
+    char buf[4096];
+    ssize_t readCount;
+
+    while ((readCount = read(STDIN_FILENO, buf, sizeof(buf))) != 0)
+    {
+        if (readCount == -1)
+        {
+            LE_FATAL_IF(errno != EINTR, "Failed to read the image (%m)");
+            continue;
+        }
+
+        LE_FATAL_IF(fd_WriteSize(fd, buf, readCount) != readCount,
+                    "Failed to write '%s' (%m)",
+                    imagePath);
+    }
+
+    // The image is mounted as soon as it's installed, so make sure it's all there first.
+    LE_FATAL_IF(fsync(fd) == -1, "Failed to sync '%s' (%m)", imagePath);
+
+    fd_Close(fd);
+
+    return EXIT_SUCCESS;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start unpacking a tarball.
@@ -707,20 +1367,44 @@ static void StartUntar
     State = STATE_UNPACKING_PAYLOAD;
 
     PayloadBytesCopied = 0;
+    installStats_Begin(INSTALL_STATS_PAYLOAD);
 
     // Create a pipeline: PipelineFd -> tar
     Pipeline = pipeline_Create();
     PipelineFd = pipeline_CreateInputPipe(Pipeline);
-    pipeline_Append(Pipeline, Untar, (void*)dirPath);
+    pipeline_Append(Pipeline,
+                    (strcmp(Format, APP_IMAGE_FORMAT) == 0) ? WriteImage : Untar,
+                    (void*)dirPath);
     pipeline_Start(Pipeline, UntarDone);
 
+    StartVerify();
+
+    // Neither end may block the event loop: when tar falls behind, the input fd stops being
+    // read until the pipeline's input pipe has room again.
     fd_SetNonBlocking(InputFd);
+    fd_SetNonBlocking(PipelineFd);
 
     // Create FD Monitor for the Input FD.
     InputFdMonitor = le_fdMonitor_Create("unpack", InputFd, InputFdEventHandler, POLLIN);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued function called when the payload has been skipped by seeking past it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SeekForwardDone
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SkipForwardDone();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start reading and throwing away payload bytes from the input stream.
@@ -735,6 +1419,38 @@ static void StartSkipForward
     State = STATE_SKIPPING_PAYLOAD;
 
     PayloadBytesCopied = 0;
+    installStats_Begin(INSTALL_STATS_PAYLOAD);
+
+    // If the update pack is being read from a file (e.g., one left by an earlier, interrupted
+    // update, whose apps have already been unpacked), just seek past the payload.
+    struct stat fileInfo;
+    off_t offset;
+
+    if (   (fstat(InputFd, &fileInfo) == 0)
+        && S_ISREG(fileInfo.st_mode)
+        && ((offset = lseek(InputFd, 0, SEEK_CUR)) != -1)
+        && ((size_t)(fileInfo.st_size - offset) >= PayloadSize)
+        && (lseek(InputFd, PayloadSize, SEEK_CUR) != -1)  )
+    {
+        LE_INFO("Payload skipped: %zu bytes", PayloadSize);
+        PayloadBytesCopied = PayloadSize;
+        installStats_AddPayloadBytes(PayloadSize, true);
+
+        // Finish from the event loop, as the JSON parser that called us isn't done yet.
+        le_event_QueueFunction(SeekForwardDone, NULL, NULL);
+        return;
+    }
+
+    if (DevNullFd == -1)
+    {
+        DevNullFd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (DevNullFd == -1)
+        {
+            LE_ERROR("Failed to open /dev/null (%m).");
+            HandleInternalError();
+            return;
+        }
+    }
 
     fd_SetNonBlocking(InputFd);
 
@@ -789,6 +1505,9 @@ static void JsonDone
 )
 //--------------------------------------------------------------------------------------------------
 {
+    installStats_End(INSTALL_STATS_HEADER);
+    installStats_AddSection();
+
     if (strcmp(Command, "updateSystem") == 0)
     {
         // System update header MUST be the first thing in a system update pack.
@@ -809,6 +1528,11 @@ static void JsonDone
             LE_ERROR("Malformed update pack (system update payload missing)");
             HandleFormatError();
         }
+        else if (Format[0] != '\0')
+        {
+            LE_ERROR("Malformed update pack (system update payload must be a tarball)");
+            HandleFormatError();
+        }
         // If everything looks good...
         else
         {
@@ -849,6 +1573,18 @@ static void JsonDone
             LE_ERROR("Malformed update pack (app update payload missing)");
             HandleFormatError();
         }
+        else if ((Format[0] != '\0') && (strcmp(Format, APP_IMAGE_FORMAT) != 0))
+        {
+            LE_ERROR("Malformed update pack (unsupported app update format '%s')", Format);
+            HandleFormatError();
+        }
+        // An image can only be installed as a whole, by itself.
+        else if ((Format[0] != '\0') &&
+                 ((Type == TYPE_SYSTEM_UPDATE) || (DeltaFromMd5[0] != '\0')))
+        {
+            LE_ERROR("Malformed update pack (app image in a system update or a delta)");
+            HandleFormatError();
+        }
         else
         {
             if (Type == TYPE_UNKNOWN)
@@ -873,26 +1609,46 @@ static void JsonDone
                     // UnpackPath = appUnpack_Path
                     // Prepare the directory to unpack into.
                     app_PrepUnpackDir();
-                    // Unpack the app tarball.
-                    // This is asynchronous and will call UntarDone() when finished.
-                    StartUntar(app_UnpackPath);
+                    le_utf8_Copy(AppUnpackDir, app_UnpackPath, sizeof(AppUnpackDir), NULL);
                 }
                 else
                 {
-                    char unpackPath[LIMIT_MAX_PATH_BYTES] = "";
                     // UnpackPath = app_unpack+Md5 hash
-                    le_path_Concat("/", unpackPath, sizeof(unpackPath), app_UnpackPath, Md5, NULL);
-                    LE_FATAL_IF(le_dir_RemoveRecursive(unpackPath) != LE_OK,
+                    le_path_Concat("/", AppUnpackDir, sizeof(AppUnpackDir), app_UnpackPath, Md5,
+                                   NULL);
+                    LE_FATAL_IF(le_dir_RemoveRecursive(AppUnpackDir) != LE_OK,
                                 "Failed to recursively delete '%s'.",
-                                unpackPath);
+                                AppUnpackDir);
                     // This is system update. Create a directory in /legato/apps/unpack/<Md5>
-                    LE_FATAL_IF(LE_OK != le_dir_MakePath(unpackPath, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH),
+                    LE_FATAL_IF(LE_OK != le_dir_MakePath(AppUnpackDir, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH),
                                 "Failed to create directory '%s'.",
-                                unpackPath);
-                    // Untar the app tarball. Will call UntarDone() when finished.
-                    StartUntar(unpackPath);
+                                AppUnpackDir);
                 }
 
+                // A delta is unpacked over the files of the installed app it's against.
+                if (DeltaFromMd5[0] != '\0')
+                {
+                    if (app_Exists(DeltaFromMd5) == false)
+                    {
+                        LE_ERROR("App update is a delta against app <%s>, which isn't installed.",
+                                 DeltaFromMd5);
+                        HandleFormatError();
+                        return;
+                    }
+
+                    LE_INFO("Reconstructing app <%s> from delta against <%s>.",
+                            Md5,
+                            DeltaFromMd5);
+
+                    if (app_CloneForDelta(DeltaFromMd5, AppUnpackDir) != LE_OK)
+                    {
+                        HandleInternalError();
+                        return;
+                    }
+                }
+
+                // Untar the app tarball. Will call UntarDone() when finished.
+                StartUntar(AppUnpackDir);
             }
             else
             {
@@ -1045,6 +1801,51 @@ static void Md5EventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * "payloadMd5" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PayloadMd5EventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, PayloadMd5, sizeof(PayloadMd5), "payload MD5 hash");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * "deltaFromMd5" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeltaFromMd5EventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, DeltaFromMd5, sizeof(DeltaFromMd5), "delta base MD5 hash");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * "format" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatEventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, Format, sizeof(Format), "payload format");
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * "version" member parsing event function.
@@ -1156,6 +1957,18 @@ static void JsonEventHandler
             {
                 le_json_SetEventHandler(Md5EventHandler);
             }
+            else if (strcmp(memberName, "payloadMd5") == 0)
+            {
+                le_json_SetEventHandler(PayloadMd5EventHandler);
+            }
+            else if (strcmp(memberName, "deltaFromMd5") == 0)
+            {
+                le_json_SetEventHandler(DeltaFromMd5EventHandler);
+            }
+            else if (strcmp(memberName, "format") == 0)
+            {
+                le_json_SetEventHandler(FormatEventHandler);
+            }
             else if (strcmp(memberName, "name") == 0)
             {
                 le_json_SetEventHandler(NameEventHandler);
@@ -1213,6 +2026,7 @@ void updateUnpack_Start
     InputFd = fd;
     ProgressFunc = progressFunc;
     PercentDone = 0;
+    IsSpliceUnsupported = false;
 
     ProgressFunc(UPDATE_UNPACK_STATUS_UNPACKING, 0);
 
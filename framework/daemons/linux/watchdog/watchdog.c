@@ -68,6 +68,17 @@
  *         The analysis assumes that the time between timeouts is significantly shorter
  *         than the time expected before pIDs are re-used.
  *
+ * Kicks are coalesced: a kick only moves the deadline of the watchdog forward.  The timer is
+ * restarted only when the new deadline is earlier than the time the timer is due, otherwise the
+ * timer finds the new deadline when it expires and is restarted for the remaining time.  So the
+ * timer is restarted at most once per timeout, however often the process kicks.
+ *
+ * A process can also kick through a counter in memory shared with the watchdog daemon, obtained
+ * with le_wdog_GetKickCounter(), which makes a kick a single atomic increment without any IPC.
+ * The counter is checked when the watchdog timer expires: if it moved since the previous check
+ * the watchdog is restarted, so a process kicking this way is found to be stuck between one and
+ * two timeouts after its last kick.
+ *
  *
  *
  * Besides le_wdog_Kick(), a command to temporarily change the timeout is provided.
@@ -108,6 +119,25 @@
 #include "user.h"
 #include "fileDescriptor.h"
 
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/// Workaround to memfd and file sealing definitions not being provided by older versions of
+/// the glibc.  Values are extracted from <linux/memfd.h> and <linux/fcntl.h>.
+#ifndef MFD_CLOEXEC
+# define MFD_CLOEXEC            0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+# define MFD_ALLOW_SEALING      0x0002U
+#endif
+#ifndef F_ADD_SEALS
+# define F_ADD_SEALS            (1024 + 9)
+# define F_SEAL_SHRINK          0x0002
+#endif
+#ifndef F_SEAL_GROW
+# define F_SEAL_GROW            0x0004
+#endif
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -205,6 +235,11 @@ typedef struct
                                         ///< beyond it's maximum period by being treated as a
                                         ///< non-mandatory watchdog.
     le_timer_Ref_t timer;               ///< The timer this watchdog uses
+    le_clk_Time_t timeoutInterval;      ///< Timeout given at the last kick
+    le_clk_Time_t deadline;             ///< Time the watchdog expires, moved by the kicks
+    le_clk_Time_t timerExpiry;          ///< Time the timer is due
+    uint32_t* kickCounterPtr;           ///< Kick counter shared with the process, or NULL
+    uint32_t lastKickCount;             ///< Value of the kick counter at the last check
 }
 WatchdogObj_t;
 
@@ -270,6 +305,63 @@ static le_hashmap_Ref_t MandatoryWatchdogRefs;  ///< The container used to track
 
 static le_mem_PoolRef_t ExternalWatchdogPool;   ///< The memory pool external for watchdog handlers
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Construct le_clk_Time_t object that will give an interval of the provided number
+ *  of milliseconds.
+ *
+ *      @return the constructed le_clk_Time_t
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t MakeTimerInterval
+(
+    uint64_t milliseconds
+)
+{
+    le_clk_Time_t interval;
+
+    interval.sec = milliseconds / 1000;
+    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
+
+    return interval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * (Re)start the timer of a watchdog so that it expires at the given time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartWatchdogTimer
+(
+    WatchdogObj_t* dogPtr,      ///< The watchdog
+    le_clk_Time_t deadline,     ///< When the timer is due
+    le_clk_Time_t now           ///< The current time
+)
+{
+    le_timer_Stop(dogPtr->timer);
+    dogPtr->deadline = deadline;
+    dogPtr->timerExpiry = deadline;
+    LE_ASSERT(LE_OK == le_timer_SetInterval(dogPtr->timer, le_clk_Sub(deadline, now)));
+    le_timer_Start(dogPtr->timer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop watching the shared kick counter of a watchdog.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseKickCounter
+(
+    WatchdogObj_t* dogPtr       ///< The watchdog
+)
+{
+    if (dogPtr->kickCounterPtr != NULL)
+    {
+        munmap(dogPtr->kickCounterPtr, sizeof(*dogPtr->kickCounterPtr));
+        dogPtr->kickCounterPtr = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Remove the watchdog from our container, free the timer it contains and then free the storage
@@ -289,11 +381,15 @@ static void DeleteWatchdog
         // Give the watchdog one more kick if it hasn't had one, then release it.
         // This allows mandatory watchdogs (which still exist in the MandatoryWatchdogRefs
         // one more kick to restart before they're considered expired.
+        ReleaseKickCounter(deadDogPtr);
         if (deadDogPtr->procId >= 0)
         {
             deadDogPtr->procId = NO_PROC;
-            le_timer_SetContextPtr(deadDogPtr->timer, (void*)((intptr_t)NO_PROC));
-            le_timer_Start(deadDogPtr->timer);
+            if (!le_timer_IsRunning(deadDogPtr->timer))
+            {
+                le_clk_Time_t now = le_clk_GetRelativeTime();
+                StartWatchdogTimer(deadDogPtr, le_clk_Add(now, deadDogPtr->timeoutInterval), now);
+            }
         }
         le_mem_Release(deadDogPtr);
     }
@@ -373,7 +469,34 @@ static void WatchdogHandleExpiry
 )
 {
     char appName[LIMIT_MAX_APP_NAME_BYTES];
-    pid_t procId = (intptr_t)le_timer_GetContextPtr(timerRef);
+    WatchdogObj_t* dogPtr = le_timer_GetContextPtr(timerRef);
+    pid_t procId = dogPtr->procId;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    // A kick through the shared counter since the last check restarts the watchdog.
+    if (dogPtr->kickCounterPtr != NULL)
+    {
+        uint32_t kickCount = __atomic_load_n(dogPtr->kickCounterPtr, __ATOMIC_RELAXED);
+
+        if (kickCount != dogPtr->lastKickCount)
+        {
+            dogPtr->lastKickCount = kickCount;
+            dogPtr->timeoutInterval = dogPtr->kickTimeoutInterval;
+            if (le_clk_Equal(dogPtr->kickTimeoutInterval,
+                             MakeTimerInterval(LE_WDOG_TIMEOUT_NEVER)))
+            {
+                return;
+            }
+            dogPtr->deadline = le_clk_Add(now, dogPtr->kickTimeoutInterval);
+        }
+    }
+
+    // The watchdog has been kicked since the timer was started: wait for the rest of the timeout.
+    if (le_clk_GreaterThan(dogPtr->deadline, now))
+    {
+        StartWatchdogTimer(dogPtr, dogPtr->deadline, now);
+        return;
+    }
 
 
     if (procId == NO_PROC)
@@ -500,27 +623,6 @@ static void ExternalWatchdogHandler
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Construct le_clk_Time_t object that will give an interval of the provided number
- *  of milliseconds.
- *
- *      @return the constructed le_clk_Time_t
- */
-//--------------------------------------------------------------------------------------------------
-static le_clk_Time_t MakeTimerInterval
-(
-    uint64_t milliseconds
-)
-{
-    le_clk_Time_t interval;
-
-    interval.sec = milliseconds / 1000;
-    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
-
-    return interval;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Given the pid, find out what the process name is. The process name, if found, is written to
@@ -715,6 +817,9 @@ static void InitNewWatchdog
     {
         newDogPtr->kickTimeoutInterval = newDogPtr->maxKickTimeoutInterval;
     }
+    newDogPtr->timeoutInterval = newDogPtr->kickTimeoutInterval;
+    newDogPtr->kickCounterPtr = NULL;
+    newDogPtr->lastKickCount = 0;
 
     if (clientPid < 0)
     {
@@ -728,8 +833,7 @@ static void InitNewWatchdog
         LE_ASSERT(0 <= snprintf(timerName, sizeof(timerName), "wdog_u%d:p%d", clientPid, appId));
     }
     newDogPtr->timer = le_timer_Create(timerName);
-    _Static_assert (sizeof(pid_t) <= sizeof(intptr_t), "pid_t is truncated by cast to void*");
-    LE_ASSERT(LE_OK == le_timer_SetContextPtr(newDogPtr->timer, (void*)((intptr_t)clientPid)));
+    LE_ASSERT(LE_OK == le_timer_SetContextPtr(newDogPtr->timer, newDogPtr));
     LE_ASSERT(LE_OK == le_timer_SetHandler(newDogPtr->timer, WatchdogHandleExpiry));
 }
 
@@ -768,8 +872,6 @@ static WatchdogObj_t* CreateNewWatchdog
         // doesn't exist.
         le_timer_Stop(newDogPtr->timer);
         // Then update the proc ID to point to this new process.
-        LE_ASSERT(LE_OK == le_timer_SetContextPtr(newDogPtr->timer,
-                                                  (void*)((intptr_t)clientPid)));
         newDogPtr->procId = clientPid;
     }
     else
@@ -798,6 +900,8 @@ static void CleanupWdog
 {
     WatchdogObj_t* deadDogPtr = objectPtr;
 
+    ReleaseKickCounter(deadDogPtr);
+
     // If this watchdog has a timer, delete it.
     if (deadDogPtr->timer)
     {
@@ -837,9 +941,9 @@ static void CreateMandatoryWatchdog
     LE_ASSERT(NULL == le_hashmap_Put(MandatoryWatchdogRefs, &(newDogPtr->key), newDogPtr));
 
     // Immediately start this watchdog.
-    LE_ASSERT(LE_OK == le_timer_SetInterval(newDogPtr->watchdog.timer,
-                                            newDogPtr->watchdog.kickTimeoutInterval));
-    le_timer_Start(newDogPtr->watchdog.timer);
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    StartWatchdogTimer(&(newDogPtr->watchdog),
+                       le_clk_Add(now, newDogPtr->watchdog.kickTimeoutInterval), now);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -922,7 +1026,6 @@ static void ResetClientWatchdog
     WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
     if (watchDogPtr != NULL)
     {
-        le_timer_Stop(watchDogPtr->timer);
         if (timeout == TIMEOUT_KICK)
         {
             timeoutValue = watchDogPtr->kickTimeoutInterval;
@@ -944,15 +1047,26 @@ static void ResetClientWatchdog
             }
         }
 
+        watchDogPtr->timeoutInterval = timeoutValue;
         if (!le_clk_Equal(timeoutValue, MakeTimerInterval(LE_WDOG_TIMEOUT_NEVER)))
         {
-            // timer should be stopped here so this should never fail
-            // testing
-            LE_ASSERT(LE_OK == le_timer_SetInterval(watchDogPtr->timer, timeoutValue));
-            le_timer_Start(watchDogPtr->timer);
+            le_clk_Time_t now = le_clk_GetRelativeTime();
+            le_clk_Time_t deadline = le_clk_Add(now, timeoutValue);
+
+            if (le_timer_IsRunning(watchDogPtr->timer)
+                && !le_clk_GreaterThan(watchDogPtr->timerExpiry, deadline))
+            {
+                // The timer is due first: it will find the new deadline when it expires.
+                watchDogPtr->deadline = deadline;
+            }
+            else
+            {
+                StartWatchdogTimer(watchDogPtr, deadline, now);
+            }
         }
         else
         {
+            le_timer_Stop(watchDogPtr->timer);
             LE_DEBUG("Timeout set to NEVER!");
         }
     }
@@ -992,6 +1106,67 @@ void le_wdog_Kick
     ResetClientWatchdog(TIMEOUT_KICK);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a kick counter shared with the watchdog daemon.  Incrementing the counter kicks the watchdog
+ * without any IPC.  Getting the counter kicks the watchdog.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT if the counter could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wdog_GetKickCounter
+(
+    int* fdPtr  ///< [OUT] Shared memory holding the kick counter.
+)
+{
+    WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
+    uint32_t* counterPtr;
+    int fd = -1;
+
+    *fdPtr = -1;
+    if (watchDogPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+#ifdef __NR_memfd_create
+    fd = syscall(__NR_memfd_create, "le_wdog", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#endif
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create kick counter: %m");
+        return LE_FAULT;
+    }
+
+    // The process must not be able to shrink the counter away from under the daemon.
+    if ((ftruncate(fd, sizeof(*counterPtr)) != 0)
+        || (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0))
+    {
+        LE_ERROR("Failed to size kick counter: %m");
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    counterPtr = mmap(NULL, sizeof(*counterPtr), PROT_READ, MAP_SHARED, fd, 0);
+    if (counterPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map kick counter: %m");
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    ReleaseKickCounter(watchDogPtr);
+    watchDogPtr->kickCounterPtr = counterPtr;
+    watchDogPtr->lastKickCount = 0;
+
+    ResetClientWatchdog(TIMEOUT_KICK);
+
+    *fdPtr = fd;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Register a function to be called to kick an external watchdog.
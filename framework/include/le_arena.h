@@ -0,0 +1,147 @@
+/**
+ * @page c_arena Arena API
+ *
+ * @ref le_arena.h "API Reference"
+ *
+ * <HR>
+ *
+ * An arena is a quick way to allocate many small, short-lived objects that all go away at the
+ * same time, such as the data built while handling a request.  Objects are carved one after the
+ * other out of large chunks of memory, so allocating one is little more than moving a pointer,
+ * and there is no need to release them one by one: deleting (or resetting) the arena gives all of
+ * its chunks back at once.
+ *
+ * @code
+ *     le_arena_Ref_t arena = le_arena_Create();
+ *
+ *     Token_t* tokenPtr = le_arena_Alloc(arena, sizeof(Token_t));
+ *     tokenPtr->textPtr = le_arena_StrDup(arena, textPtr);
+ *     ...
+ *
+ *     le_arena_Delete(arena);     // Releases the tokens and their text.
+ * @endcode
+ *
+ * The chunks come from a memory pool shared by the whole process, so they can be seen with the
+ * Inspect tool, and an arena that is reset (using le_arena_Reset()) or deleted and re-created for
+ * every request doesn't call malloc() once the pool has grown to the size needed.  Objects bigger
+ * than a quarter of a chunk get memory pool blocks of their own, which are released along with the
+ * chunks.  Objects can't be bigger than LE_ARENA_MAX_OBJ_BYTES.
+ *
+ * Objects allocated from an arena are aligned to 8 bytes and are not cleared.
+ *
+ * @section c_arenaMessages Arenas for Messages
+ *
+ * A server that builds data while handling a request message can use le_msg_GetArena() to get
+ * an arena that belongs to the message.  The arena is deleted along with the message, once the
+ * response has been sent by le_msg_Respond() (or the message is released), so the handler doesn't
+ * need to free anything it allocated from it.
+ *
+ * @section c_arenaThreading Multi-Threading
+ *
+ * An arena must not be used by more than one thread at a time.  Different threads can use
+ * different arenas at the same time.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/** @file le_arena.h
+ *
+ * Legato @ref c_arena include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_ARENA_INCLUDE_GUARD
+#define LEGATO_ARENA_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest object that can be allocated from an arena, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_ARENA_MAX_OBJ_BYTES      (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an arena.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_arena* le_arena_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty arena.
+ *
+ * @return Reference to the arena.
+ *
+ * @note On failure, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_arena_Ref_t le_arena_Create
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate an object from an arena.
+ *
+ * @return Pointer to the object, which is aligned to 8 bytes and is not cleared.
+ *
+ * @note On failure (including objects bigger than LE_ARENA_MAX_OBJ_BYTES), the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_Alloc
+(
+    le_arena_Ref_t arena,       ///< [IN] The arena.
+    size_t size                 ///< [IN] Size of the object, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a null-terminated string into an arena.
+ *
+ * @return Pointer to the copy.
+ *
+ * @note On failure (including strings longer than LE_ARENA_MAX_OBJ_BYTES), the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_arena_StrDup
+(
+    le_arena_Ref_t arena,       ///< [IN] The arena.
+    const char* strPtr          ///< [IN] String to copy.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release all of the objects allocated from an arena, leaving it empty and ready to be reused.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Reset
+(
+    le_arena_Ref_t arena        ///< [IN] The arena.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an arena, releasing all of the objects allocated from it.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Delete
+(
+    le_arena_Ref_t arena        ///< [IN] The arena.
+);
+
+
+#endif // LEGATO_ARENA_INCLUDE_GUARD
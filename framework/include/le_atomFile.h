@@ -166,6 +166,17 @@
  *
  * All the functions in this API are thread-safe and reentrant.
  *
+ * @section c_atomFile_groupCommit Group Commit
+ *
+ * By default, each le_atomFile_Close() and le_atomFile_CloseStream() flushes its own file and
+ * directory to storage.  When many files are committed at the same time, these separate flushes
+ * can be costly on flash storage.  Setting the @c LE_ATOMFILE_GROUP_COMMIT_MS environment
+ * variable of a process to a number of milliseconds (at most 1000) makes the commits of that
+ * process that start within that window of each other, on the same file system, share a single
+ * flush of the whole file system (see syncfs(2)).  Each commit still only returns once its data has
+ * reached storage, and the file is still only replaced after that, so atomicity is unchanged; only
+ * the latency of a lone commit grows by up to the window.
+ *
  * @section c_atomFile_limitations Limitations
  *
  * These APIs have inherent limitations of @ref c_flock (i.e. advisory lock, inability to detect
@@ -19,6 +19,13 @@
  * switches to use malloc/free per-block.  This way, tools like valgrind can be used on a Legato
  * executable.
  *
+ * @section bld_cfg_mem_guard_bands LE_MEM_GUARD_BANDS
+ *
+ * When @c LE_MEM_GUARD_BANDS is defined, every memory pool block gets a band of padding filled
+ * with a known pattern before and after the object, and the bands are checked every time the
+ * block is allocated or released.  Otherwise, each block only gets a single word of that pattern
+ * after the object, which is checked on a sample of the releases (see @ref mem_diagnostics).
+ *
  * @section bld_cfg_disable_SMACK LE_SMACK_DISABLE
  *
  * Legato provides the ability to disable the SMACK API. We don’t recommend disabling SMACK:
@@ -82,6 +89,12 @@
 
 
 
+// Uncomment this define to check guard bands around every memory pool block on every allocation
+// and release, instead of checking sampled blocks.
+//#define LE_MEM_GUARD_BANDS
+
+
+
 // Uncomment this define to disable the "2nd SEGV handler" protection in ShowStackSignalHandler().
 //#define LE_SEGV_HANDLER_DISABLE
 
@@ -31,6 +31,12 @@
  * is stored.  The relative time between these two events can always be calculated as B-A, and will
  * always be an accurate measure of the relative time between these two events.
  *
+ * Where a timestamp is needed often but not precisely, two cheaper sources of relative time are
+ * available:
+ *  - @ref le_clk_GetRelativeTimeCoarse() reads a coarse clock, accurate to the system tick.
+ *  - @ref le_event_GetLoopTime() returns the time at which the thread's Event Loop woke up,
+ *    reading the clock at most once for all the handlers run on that wake-up.
+ *
  * @todo
  *  - Add API for setting absolute time.
  *
@@ -128,6 +134,22 @@ typedef struct
 le_clk_Time_t le_clk_GetRelativeTime(void);
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get relative time since the same starting point as le_clk_GetRelativeTime(), cheaply but only
+ * to the resolution of the system tick (a few milliseconds).
+ *
+ * @return
+ *      Relative time in seconds/microseconds
+ *
+ * @note
+ *      Relative time includes any time that the processor is suspended.  On such systems, there
+ *      is no coarse clock to read, so this costs the same as le_clk_GetRelativeTime().
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetRelativeTimeCoarse(void);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get absolute time since the Epoch, 1970-01-01 00:00:00 +0000 (UTC).
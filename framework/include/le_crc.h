@@ -52,6 +52,33 @@
  * }
  * @endcode
  *
+ * @section Crc32Stream Streaming
+ *
+ * When the data arrives piece by piece (a download, a file read in chunks, etc.), the streaming
+ * functions keep the running CRC in a context, and accept any type of buffer:
+ *
+ *   - @c le_crc_Crc32Start() - Start a calculation
+ *   - @c le_crc_Crc32Update() - Add data to it
+ *   - @c le_crc_Crc32Finish() - Get the CRC32, the same as le_crc_Crc32() would give for all the
+ *     data at once
+ *
+ * @code
+ * le_crc_Crc32Ctx_t ctx;
+ *
+ * le_crc_Crc32Start(&ctx);
+ * while ((len = read(fd, buf, sizeof(buf))) > 0)
+ * {
+ *     le_crc_Crc32Update(&ctx, buf, len);
+ * }
+ * uint32_t crc = le_crc_Crc32Finish(&ctx);
+ * @endcode
+ *
+ * @section Crc32Speed Performance
+ *
+ * On ARMv8 CPUs that have them, the CRC32 instructions are used (detected at run time).  On
+ * other CPUs, 8 bytes are processed per iteration using a set of lookup tables (the "slice-by-8"
+ * algorithm).
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -91,9 +118,56 @@
 //--------------------------------------------------------------------------------------------------
 uint32_t le_crc_Crc32
 (
-    uint8_t* addressPtr,///< [IN] Input buffer
-    size_t   size,      ///< [IN] Number of bytes to read
-    uint32_t crc        ///< [IN] Starting CRC seed
+    const uint8_t* addressPtr,///< [IN] Input buffer
+    size_t   size,            ///< [IN] Number of bytes to read
+    uint32_t crc              ///< [IN] Starting CRC seed
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of a streamed CRC-32 calculation.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t crc;           ///< Running CRC
+}
+le_crc_Crc32Ctx_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a streamed CRC-32 calculation.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_crc_Crc32Start
+(
+    le_crc_Crc32Ctx_t* ctxPtr   ///< [OUT] Calculation context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add data to a streamed CRC-32 calculation.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_crc_Crc32Update
+(
+    le_crc_Crc32Ctx_t* ctxPtr,  ///< [IN/OUT] Calculation context
+    const void* dataPtr,        ///< [IN] Data
+    size_t size                 ///< [IN] Number of bytes of data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the result of a streamed CRC-32 calculation.
+ *
+ * @return
+ *      - 32-bit CRC, the same as chaining le_crc_Crc32() calls from LE_CRC_START_CRC32 over all
+ *        the data.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_crc_Crc32Finish
+(
+    const le_crc_Crc32Ctx_t* ctxPtr ///< [IN] Calculation context
 );
 
 #endif // LEGATO_CRC_INCLUDE_GUARD
@@ -437,6 +437,29 @@
  *
  * @endcode
  *
+ * @section c_event_reportingByRef Event Reports Without Copying the Payload
+ *
+ * le_event_Report() copies the payload into a report for every handler, which gets expensive for
+ * big payloads (such as position samples or media buffers) that go to several handlers.
+ * @c le_event_ReportByRef() sends the same kind of report, for an Event ID created using
+ * le_event_CreateId(), but the payload stays in a reference-counted memory pool object that
+ * every report points to.  Handlers, including the first-layer functions of layered handlers,
+ * get a pointer to the payload exactly as they would for le_event_Report(), so nothing changes
+ * on the handler side, except that the payload is shared and must be treated as read-only.
+ *
+ * The caller gives its reference to the Event Loop API, and each report holds a reference that
+ * is released after its handler returns (or when the report is discarded because its handler
+ * was removed or its thread died), so neither the reporter nor the handlers release anything.
+ *
+ * @code
+ *     Position_t* posPtr = le_mem_ForceAlloc(PositionPool);
+ *
+ *     // Fill in the sample.
+ *     ...
+ *
+ *     le_event_ReportByRef(PositionEventId, posPtr);
+ * @endcode
+ *
  * @section c_event_miscThreadingTopics Miscellaneous Multithreading Topics
  *
  * All functions in this API are thread safe.
@@ -487,6 +510,13 @@
  * For example, the keyword "P/T/events" controls logging for a thread named "T" running inside
  * a process named "P".
  *
+ * To find handlers that hold up a thread (for example, the main thread that also has to service
+ * IPC messages), set the @c LE_EVENT_SLOW_HANDLER_MS environment variable of a process to a number
+ * of milliseconds (at most 60000).  Each thread's Event Loop then keeps histograms of how long
+ * events wait in its queue and how long their handlers run, which can be seen using
+ * <c>inspect threads -v</c>, and logs a warning naming each handler function that runs for at
+ * least that long.  Setting it to 0 keeps the histograms without logging any warnings.
+ *
  * @todo Add a reference to the Process Inspector and its capabilities for inspecting Event Queues,
  * Event Loops, Handlers and Event Report statistics.
 
@@ -748,6 +778,26 @@ void le_event_ReportWithRefCounting
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends an Event Report whose payload is held in a reference-counted object, without copying it.
+ * The pointer must have been obtained from a memory pool using the @ref c_memory, and the object
+ * must start with the payload that would otherwise have been passed to le_event_Report().
+ *
+ * Handlers get a pointer to the payload, just like for le_event_Report(), and must neither
+ * modify nor release it.  The Event Loop releases its reference once every handler has run.
+ *
+ * Calling this function passes ownership of the caller's reference to the Event Loop API.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_ReportByRef
+(
+    le_event_Id_t   eventId,    ///< [in] Event ID created using le_event_CreateId().
+    void*           objectPtr   ///< [in] Pointer to an object allocated from a memory pool
+                                ///       (using the @ref c_memory).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the context pointer for a given event handler.
@@ -869,4 +919,23 @@ le_result_t le_event_ServiceLoop
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time (see le_clk_GetRelativeTime()) at which the calling thread's Event Loop
+ * started handling its current batch of events.
+ *
+ * The clock is read the first time this is called after the Event Loop wakes up, and the same
+ * value is returned to all the handlers it then runs, so handlers that only need a timestamp
+ * (not a measure of their own run time) don't read the clock each time.  In a thread whose Event
+ * Loop isn't being run (or serviced), this is the same as le_clk_GetRelativeTime().
+ *
+ * @return The relative time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_event_GetLoopTime
+(
+    void
+);
+
+
 #endif // LEGATO_EVENTLOOP_INCLUDE_GUARD
@@ -202,6 +202,23 @@ static void ConnectionEventHandler(int fd, int event)
  * If events occur on different fds at the same time, the order in which the handlers
  * are called is implementation-dependent.
  *
+ * @section c_fdMonitorEdgeTriggered Edge-Triggered Monitoring
+ *
+ * By default, the handler keeps getting called for as long as an enabled event's trigger
+ * condition is true (e.g., for as long as the fd has data available to be read).  Calling
+ * le_fdMonitor_SetEdgeTriggered() makes the handler only get called when the condition becomes
+ * true, so a handler that reads until the fd would block (@c EAGAIN) isn't called again for data
+ * that it has already dealt with.  This suits high-rate sockets and ttys.  An edge-triggered
+ * handler that doesn't drain the fd won't be called again until more data arrives (or the event
+ * is disabled and enabled again).
+ *
+ * @code
+ *     int fd = open("/dev/ttyS0", O_RDWR|O_NONBLOCK);
+ *     le_fdMonitor_Ref_t fdMonitor = le_fdMonitor_Create("Serial Port", fd, SerialPortHandler,
+ *                                                        POLLIN);
+ *     le_fdMonitor_SetEdgeTriggered(fdMonitor, true);
+ * @endcode
+ *
  *
  * @section c_fdMonitorHandlerContext Handler Function Context
  *
@@ -443,6 +460,24 @@ void le_fdMonitor_SetDeferrable
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets if events on a given fd are edge-triggered (the handler is only called when the fd
+ * becomes ready, so it must read or write until the fd would block) or level-triggered (the
+ * handler is called for as long as the fd is ready, which is the default).
+ *
+ * See @ref c_fdMonitorEdgeTriggered.
+ *
+ * @note This has no effect on fds that don't support epoll(7), such as regular files.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_fdMonitor_SetEdgeTriggered
+(
+    le_fdMonitor_Ref_t monitorRef,      ///< [in] Reference to the File Descriptor Monitor object.
+    bool               isEdgeTriggered  ///< [in] true (edge-triggered) or false (level-triggered).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the Context Pointer for File Descriptor Monitor's handler function.  This can be retrieved
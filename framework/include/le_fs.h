@@ -21,6 +21,26 @@
  * - recursively deletes a folder with le_fs_RemoveDirRecursive()
  * - checks whether a regular file exists le_fs_Exists()
  *
+ * @section c_fs_async Asynchronous Reads and Writes
+ *
+ * le_fs_Read() and le_fs_Write() block the calling thread until the data has been transferred,
+ * which can take a while on flash storage.  le_fs_ReadAsync() and le_fs_WriteAsync() start the
+ * transfer and return right away; a handler is then called by the calling thread's Event Loop
+ * once the transfer is done, with the result and the number of bytes transferred.  So a thread
+ * can keep serving its IPC and other events while it streams data to or from a file.
+ *
+ * The transfer is done at a given offset, or at (and moving) the current file position if
+ * @ref LE_FS_CURRENT_POSITION is given.  Transfers at the current position are done in the
+ * order they were started; transfers at given offsets can complete in any order.
+ *
+ * The buffer must not be modified or freed, and the file must not be closed, until the handler
+ * has been called.  Each thread can have up to 32 transfers in flight.  The calling thread must
+ * run its Event Loop for the handlers to be called, and must not exit while transfers are in
+ * flight.
+ *
+ * Transfers are done through io_uring where the kernel supports it, and by a worker thread
+ * otherwise.
+ *
  *
  * <HR>
  *
@@ -86,6 +106,34 @@ le_fs_Position_t;
 typedef struct le_fs_File* le_fs_FileRef_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offset to give to le_fs_ReadAsync() and le_fs_WriteAsync() to read or write at the current file
+ * position.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_FS_CURRENT_POSITION  (-1)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called when an asynchronous read or write is done.
+ *
+ * The result is:
+ *  - LE_OK             The transfer succeeded.
+ *  - LE_UNDERFLOW      The write succeeded but was not able to write all bytes.
+ *  - LE_FAULT          The transfer failed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_fs_IoHandlerFunc_t)
+(
+    le_fs_FileRef_t fileRef,   ///< [IN] File reference
+    le_result_t result,        ///< [IN] Result of the transfer
+    size_t numBytes,           ///< [IN] Number of bytes read or written
+    void* contextPtr           ///< [IN] Context pointer given when starting the transfer
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is called to create or open an existing file.
@@ -158,6 +206,48 @@ le_result_t le_fs_Write
     size_t bufSize           ///< [IN] Size of the buffer to write
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to start reading from an opened file without waiting for the data.
+ * The handler is called by the calling thread's Event Loop once the read is done.
+ *
+ * @return
+ *  - LE_OK             The read was started.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_BUSY           Too many transfers are in flight in the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_ReadAsync
+(
+    le_fs_FileRef_t fileRef,           ///< [IN] File reference
+    int64_t offset,                    ///< [IN] Offset to read at, or LE_FS_CURRENT_POSITION
+    uint8_t* bufPtr,                   ///< [OUT] Buffer to store the data read in the file
+    size_t bufSize,                    ///< [IN] Number of bytes to read
+    le_fs_IoHandlerFunc_t handlerFunc, ///< [IN] Handler called when the read is done
+    void* contextPtr                   ///< [IN] Context pointer passed to the handler
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to start writing to an opened file without waiting for the data to be
+ * written.  The handler is called by the calling thread's Event Loop once the write is done.
+ *
+ * @return
+ *  - LE_OK             The write was started.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_BUSY           Too many transfers are in flight in the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_WriteAsync
+(
+    le_fs_FileRef_t fileRef,           ///< [IN] File reference
+    int64_t offset,                    ///< [IN] Offset to write at, or LE_FS_CURRENT_POSITION
+    const uint8_t* bufPtr,             ///< [IN] Buffer to write in the file
+    size_t bufSize,                    ///< [IN] Number of bytes to write
+    le_fs_IoHandlerFunc_t handlerFunc, ///< [IN] Handler called when the write is done
+    void* contextPtr                   ///< [IN] Context pointer passed to the handler
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is called to change the file position of an opened file.
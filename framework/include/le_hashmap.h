@@ -15,10 +15,41 @@
  * type of key that you intend to store. It's unwise to mix types in a single table because
  * implementation of the table has no way to detect this behaviour.
  *
- * Choose the initial size should carefully as the index size remains fixed. The best
- * choice for the initial size is a prime number slightly larger than the
- * maximum expected capacity. If a too small size is chosen, there will be an
- * increase in collisions that degrade performance over time.
+ * Choose the initial size carefully. The best choice for the initial size is slightly larger
+ * than the maximum expected capacity. If too small a size is chosen, the map grows automatically
+ * when its load factor exceeds 0.75.  Growing doesn't happen all at once: the entries are moved
+ * to the larger table a few buckets at a time by subsequent map operations, so no single call
+ * takes much longer than usual.
+ *
+ * By default, a map never shrinks.  If a map may briefly hold many more entries than it usually
+ * does, call @c le_hashmap_EnableShrink() to allow it to shrink again (but never below its initial
+ * size) when enough entries have been removed.
+ *
+ * @subsection c_hashmap_seed Hash Seed
+ *
+ * The built-in hash functions are inlined by the map, so maps keyed by strings, integers or
+ * pointers don't pay for an indirect call to hash a key.  The string hash (le_hashmap_HashString())
+ * reads the string eight bytes at a time.
+ *
+ * If the keys of a map come from outside the process (e.g., strings received over IPC), call
+ * @c le_hashmap_SetRandomSeed() (or @c le_hashmap_SetSeed()) right after creating it.  For string
+ * keys, the seed changes which strings collide, so a client can't make the map slow by sending
+ * keys chosen to land in the same bucket.  For other keys, it only changes how they are spread
+ * over the buckets.
+ *
+ * @subsection c_hashmap_compact Compact HashMaps
+ *
+ * @c le_hashmap_CreateCompact() takes the same parameters as @c le_hashmap_Create() and returns a
+ * map that is used through exactly the same functions.  Instead of chaining separately allocated
+ * entries off an array of buckets, a compact map stores its entries directly in a single array of
+ * slots, using open addressing with Robin Hood probing.  Each slot also holds part of its key's
+ * hash, so most non-matching slots are skipped without calling the equality function.  This
+ * uses much less memory per entry and makes lookups more cache-friendly, which suits large maps
+ * with small keys (such as pointers or integers).
+ *
+ * A compact map is resized all at once (rather than a few buckets at a time) when its load factor
+ * exceeds 0.875, so chained maps remain the better choice where the worst-case latency of a
+ * single le_hashmap_Put() matters more than memory.
  *
  * All hashmaps have names for diagnostic purposes.
  *
@@ -109,6 +140,13 @@
  * @note There is only one iterator per hashtable. Calling le_hashmap_GetIterator()
  * will simply re-initialize the current iterator
  *
+ * @note A map doesn't normally grow or shrink while an iteration is in progress (i.e., from the
+ * first le_hashmap_NextNode() until le_hashmap_NextNode() or le_hashmap_PrevNode() runs off the
+ * end of the map, or le_hashmap_GetIterator() or le_hashmap_RemoveAll() is called).  If enough
+ * entries are added during an iteration that the map would become overloaded, it is resized
+ * anyway, which ends the iteration and leaves the iterator at the end of the map.  For a compact
+ * map, that is as soon as its load factor would exceed 0.875.
+ *
  * It is possible to add and remove items during this style of iteration.  When
  * adding items during an iteration it is not guaranteed that the newly added item
  * will be iterated over.  It's very possible that the newly added item is added in
@@ -256,6 +294,24 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a compact HashMap, which stores its entries in a single open-addressed array instead of
+ * in separately allocated, chained entries.  See @ref c_hashmap_compact.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateCompact
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Size of the hashmap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a key-value pair to a HashMap. If the key already exists in the map, the previous value
@@ -513,6 +569,19 @@ le_result_t le_hashmap_GetNodeAfter
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allows a HashMap to shrink when enough entries have been removed from it.  The map never shrinks
+ * below the number of buckets it was created with.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+
+void le_hashmap_EnableShrink
+(
+    le_hashmap_Ref_t mapRef     ///< [in] Reference to the map
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Counts the total number of collisions in the map. A collision occurs
@@ -528,6 +597,31 @@ size_t le_hashmap_CountCollisions
     le_hashmap_Ref_t mapRef     ///< [in] Reference to the map.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the seed of a HashMap's hash.  See @ref c_hashmap_seed.
+ *
+ * @note The map must be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_hashmap_SetSeed
+(
+    le_hashmap_Ref_t mapRef,    ///< [in] Reference to the map.
+    uint64_t seed               ///< [in] The seed.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the seed of a HashMap's hash to a random number.  See @ref c_hashmap_seed.
+ *
+ * @note The map must be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_hashmap_SetRandomSeed
+(
+    le_hashmap_Ref_t mapRef     ///< [in] Reference to the map.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * String hashing function. Can be used as a parameter to le_hashmap_Create() if the key to
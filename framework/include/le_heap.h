@@ -0,0 +1,296 @@
+/**
+ * @page c_heap Heap API
+ *
+ * @ref le_heap.h "API Reference"
+ *
+ * <HR>
+ *
+ * A heap is a priority queue: links can be added to it in any order, and the link with the lowest
+ * value (as defined by a user-supplied "less than" function) is always available at its top.
+ * Adding a link and removing the top link take O(log n) amortized time, instead of the O(n) it
+ * takes to keep a linked list sorted.
+ *
+ * This is a pairing heap, which needs no array to be allocated or resized.  Like the
+ * @ref c_doublyLinkedList "linked lists", it is intrusive: the heap only manages the links
+ * included in the user's nodes, and the user is responsible for creating and freeing the nodes
+ * (usually from a @ref c_memory "memory pool").
+ *
+ * @section heap_create Creating and Initializing Heaps
+ *
+ * To create and initialize a heap the user must create a le_heap_Heap_t typed heap and assign
+ * LE_HEAP_INIT(lessThanFunc) to it, where @c lessThanFunc compares the nodes of two links.  The
+ * heap <b>must</b> be initialized before it can be used.
+ *
+ * @code
+ * typedef struct
+ * {
+ *     uint64_t expiryTime;
+ *     ...
+ *     le_heap_Link_t link;
+ * }
+ * MyNode_t;
+ *
+ * static bool MyNodeLessThan
+ * (
+ *     const le_heap_Link_t* aPtr,
+ *     const le_heap_Link_t* bPtr
+ * )
+ * {
+ *     return CONTAINER_OF(aPtr, MyNode_t, link)->expiryTime <
+ *            CONTAINER_OF(bPtr, MyNode_t, link)->expiryTime;
+ * }
+ *
+ * static le_heap_Heap_t MyHeap = LE_HEAP_INIT(MyNodeLessThan);
+ * @endcode
+ *
+ * <b> Elements of le_heap_Heap_t MUST NOT be accessed directly by the user. </b>
+ *
+ *
+ * @section heap_use Using Heaps
+ *
+ * Each node must contain a @c le_heap_Link_t link member, initialized by assigning
+ * LE_HEAP_LINK_INIT to it.  Nodes are then handled through their links:
+ *
+ * - @c le_heap_Insert() - Adds a link to the heap.
+ * - @c le_heap_Peek() - Returns the top (lowest) link without removing it.
+ * - @c le_heap_Pop() - Removes and returns the top link.
+ * - @c le_heap_Remove() - Removes a specified link from the heap.
+ * - @c le_heap_Update() - Moves a link to its place after the value of its node has changed.
+ * - @c le_heap_IsEmpty(), @c le_heap_NumLinks() and @c le_heap_IsInHeap() - Query the heap.
+ *
+ * The order in which links of equal value come to the top is not specified.  The node's value
+ * must not be changed while its link is in the heap, unless le_heap_Update() is called right
+ * after.
+ *
+ * To obtain the node from its link, use the @c CONTAINER_OF macro defined in le_basics.h.
+ *
+ *
+ * @section heap_inspect Change Counter
+ *
+ * Every change to a heap increments its change counter, returned by le_heap_GetChangeCount().
+ * Like the change counters of the framework's other object lists, this lets a tool walking the
+ * heap from another process (e.g., inspect) notice that the heap changed under it, and retry.
+ *
+ *
+ * @section heap_synch Thread Safety and Re-Entrancy
+ *
+ * All heap function calls are re-entrant and thread safe themselves, but if a heap is shared by
+ * multiple threads, a @ref c_mutex "mutex" or some other form of thread synchronization must be
+ * used to ensure only one thread accesses it at a time.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+
+ /** @file le_heap.h
+  *
+  * Legato @ref c_heap include file.
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#ifndef LEGATO_HEAP_INCLUDE_GUARD
+#define LEGATO_HEAP_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This link object must be included in each user node.  The node's link object is used to add the
+ * node to a heap.  It must be initialized by assigning LE_HEAP_LINK_INIT to it.
+ *
+ * @warning The structure's content MUST NOT be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_heap_Link
+{
+    struct le_heap_Link* childPtr;      ///< First child link pointer.
+    struct le_heap_Link* nextPtr;       ///< Next sibling link pointer.
+    struct le_heap_Link* prevPtr;       ///< Previous sibling link pointer, or parent link pointer
+                                        ///  for the first child.
+}
+le_heap_Link_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the functions comparing the nodes of two links of a heap.
+ *
+ * @return
+ *      true if the node of aPtr must come out of the heap before the node of bPtr.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef bool (*le_heap_LessThanFunc_t)
+(
+    const le_heap_Link_t* aPtr,         ///< [IN] First link.
+    const le_heap_Link_t* bPtr          ///< [IN] Second link.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This is the heap object.  User must create this heap object and initialize it by assigning
+ * LE_HEAP_INIT(lessThanFunc) to it.
+ *
+ * @warning User MUST NOT access the contents of this structure directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_heap_Link_t* rootPtr;            ///< Top link.
+    le_heap_LessThanFunc_t lessThanFunc;///< Function comparing the nodes of two links.
+    size_t count;                       ///< Number of links in the heap.
+    size_t changeCount;                 ///< Number of changes made to the heap.
+}
+le_heap_Heap_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * When a heap is created it must be initialized by assigning this macro to the heap before the
+ * heap can be used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_HEAP_INIT(lessThanFunc) (le_heap_Heap_t){NULL, (lessThanFunc), 0, 0}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * When a link is created it must be initialized by assigning this macro to the link before it can
+ * be used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_HEAP_LINK_INIT (le_heap_Link_t){NULL, NULL, NULL}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a link to the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Insert
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] Heap to add to.
+    le_heap_Link_t* newLinkPtr          ///< [IN] New link to add.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the top (lowest) link of the heap without removing it.
+ *
+ * @return
+ *      The top link.
+ *      NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_heap_Link_t* le_heap_Peek
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes and returns the top (lowest) link of the heap.
+ *
+ * @return
+ *      The removed link.
+ *      NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_heap_Link_t* le_heap_Pop
+(
+    le_heap_Heap_t* heapPtr             ///< [IN] Heap to remove from.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the specified link from the heap.  User must ensure that the link is in the heap
+ * otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Remove
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] Heap to remove from.
+    le_heap_Link_t* linkToRemovePtr     ///< [IN] Link to remove.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a link to its place in the heap after the value of its node has changed.  User must
+ * ensure that the link is in the heap otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Update
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] The heap.
+    le_heap_Link_t* linkPtr             ///< [IN] Link of the changed node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a link is in the heap.
+ *
+ * @return
+ *      true if the link is in the heap.
+ *      false if the link is not in the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_heap_IsInHeap
+(
+    const le_heap_Heap_t* heapPtr,      ///< [IN] The heap.
+    const le_heap_Link_t* linkPtr       ///< [IN] The link, which is in this heap or in none.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of links in the heap.
+ *
+ * @return
+ *      The number of links.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_heap_NumLinks
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the change counter of the heap, incremented on every change made to it.
+ *
+ * @return
+ *      The change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_heap_GetChangeCount
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the heap is empty.
+ *
+ * @return
+ *      true if empty, false if not empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_heap_IsEmpty
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+)
+{
+    return (heapPtr->rootPtr == NULL);
+}
+
+
+#endif  // LEGATO_HEAP_INCLUDE_GUARD
@@ -36,6 +36,16 @@
  *
  * @warning Be sure to stop parsing before closing the file descriptor.
  *
+ * The parser stops reading at the end of the document, so whatever follows the document can
+ * still be read from the file descriptor afterwards.  If the file descriptor refers to a regular
+ * file, the document is read in large blocks and anything read past the end of the document is
+ * given back by seeking backwards.  Otherwise (e.g., for pipes and sockets), the document has to
+ * be read one byte at a time.
+ *
+ * A JSON document that is already in memory can be parsed using le_json_ParseBuffer() instead.
+ * This doesn't need an event loop: the handlers are called before le_json_ParseBuffer() returns,
+ * and the parsing session is cleaned up automatically.
+ *
  *  @section c_json_events Event Handling
  *
  * As parsing progresses and the parser finds things inside the JSON document, the parser calls
@@ -109,6 +119,50 @@
  * still go to <c>TopLevelHandler()</c>, because the context returns to the top level object
  * after the parser finishes parsing member "x".
  *
+ *  @section c_json_doc Document Trees
+ *
+ * For a document that is already in memory and small enough to be kept there, it is often simpler
+ * to let the parser build a read-only tree of the document and then look things up in the tree.
+ * le_json_CreateDoc() builds such a tree in a single block of memory (an "arena"), so a document
+ * costs one allocation no matter how many values it has, and le_json_DeleteDoc() frees it all.
+ *
+ * Strings and object member names are not copied into the tree.  They are null-terminated in the
+ * caller's buffer instead (by overwriting their closing quotes), so the buffer must not be freed
+ * or modified until the tree has been deleted.  As with le_json_GetString(), escape sequences are
+ * not decoded.
+ *
+ * Starting from le_json_GetDocRoot(), each value in the tree is a node:
+ * - le_json_GetNodeType() gets the type of value, as an @ref le_json_ContextType_t.
+ * - le_json_GetNodeCount() and le_json_GetNodeChild() get the members of an object or the
+ *   elements of an array by position, in constant time.
+ * - le_json_FindNodeMember() looks up an object member by name, using a hash table built into
+ *   the tree, also in constant time.
+ * - le_json_GetNodeName(), le_json_GetNodeString() and le_json_GetNodeNumber() get the member name
+ *   and value of a node.
+ *
+ * @code
+ * le_json_DocRef_t doc = le_json_CreateDoc(buffer, size);
+ * if (doc != NULL)
+ * {
+ *     le_json_NodeRef_t nameNode = le_json_FindNodeMember(le_json_GetDocRoot(doc), "name");
+ *     if ((nameNode != NULL) && (le_json_GetNodeType(nameNode) == LE_JSON_CONTEXT_STRING))
+ *     {
+ *         LE_INFO("Name is '%s'.", le_json_GetNodeString(nameNode));
+ *     }
+ *     le_json_DeleteDoc(doc);
+ * }
+ * @endcode
+ *
+ *  @section c_json_writer Writing
+ *
+ * A JSON document can be written to a file descriptor using a writer, created by
+ * le_json_CreateWriter().  The writer buffers its output and takes care of the separators between
+ * values; the caller just writes the values in document order using le_json_WriteObjectStart(),
+ * le_json_WriteMemberName(), le_json_WriteString(), le_json_WriteArrayEnd(), etc.
+ * le_json_WriteNode() writes a copy of a value from a document tree, so a document can be read,
+ * changed and written back without building a modifiable copy of it.  le_json_DeleteWriter()
+ * writes out anything still buffered and reports whether all of the output was written.
+ *
  *  @section c_json_threads Multi-Threading
  *
  * This API is not thread safe.  DO NOT attempt to SHARE parsers between threads.
@@ -222,6 +276,31 @@ le_json_ParsingSessionRef_t le_json_Parse
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory.
+ *
+ * Unlike le_json_Parse(), this parses the whole document before returning, calling the handlers
+ * as it goes, and cleans up after itself.  Anything in the buffer after the end of the document
+ * is ignored.
+ *
+ * @return
+ *      - LE_OK if the whole document was parsed.
+ *      - LE_FAULT if an error was reported to the error handler.
+ *
+ * @warning The handlers must not call le_json_Cleanup().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_ParseBuffer
+(
+    const char* bufferPtr,  ///< The JSON document (need not be null-terminated).
+    size_t bufferSize,      ///< Number of bytes in the buffer.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
@@ -404,4 +483,312 @@ le_json_ParsingSessionRef_t le_json_GetSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a read-only document tree built by le_json_CreateDoc().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_json_Doc* le_json_DocRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a value (node) in a document tree.  Valid until the tree is deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef const struct le_json_Node* le_json_NodeRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a JSON writer created by le_json_CreateWriter().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_json_Writer* le_json_WriterRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory into a read-only document tree.
+ *
+ * The tree is allocated in a single block.  Strings and object member names are not copied:
+ * they are null-terminated in place in the buffer (by overwriting their closing quotes), so the
+ * buffer is modified and must not be freed or changed until the tree has been deleted.
+ *
+ * @return Reference to the tree, or NULL if the document is not valid (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_DocRef_t le_json_CreateDoc
+(
+    char* bufferPtr,    ///< [IN] The JSON document (need not be null-terminated).  Modified.
+    size_t bufferSize   ///< [IN] Number of bytes in the buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a document tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_DeleteDoc
+(
+    le_json_DocRef_t docRef     ///< [IN] The tree.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the top-level object or array of a document tree.
+ *
+ * @return The root node.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_GetDocRoot
+(
+    le_json_DocRef_t docRef     ///< [IN] The tree.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of value held by a node.
+ *
+ * @return LE_JSON_CONTEXT_OBJECT, LE_JSON_CONTEXT_ARRAY, LE_JSON_CONTEXT_STRING,
+ *         LE_JSON_CONTEXT_NUMBER, LE_JSON_CONTEXT_TRUE, LE_JSON_CONTEXT_FALSE or
+ *         LE_JSON_CONTEXT_NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_ContextType_t le_json_GetNodeType
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the member name of a node that is an object member.
+ *
+ * @return The name, or NULL if the node is not an object member.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* le_json_GetNodeName
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of members of an object or elements of an array.
+ *
+ * @return The number of children, or 0 if the node is not an object or array.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_json_GetNodeCount
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a member of an object or element of an array by position, in document order.
+ *
+ * @return The child, or NULL if the index is out of range or the node is not an object or array.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_GetNodeChild
+(
+    le_json_NodeRef_t nodeRef,  ///< [IN] The object or array.
+    size_t index                ///< [IN] Position of the child (0 = first).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a member of an object by name.  If the object has more than one member with the name,
+ * the first one is found.
+ *
+ * @return The member, or NULL if not found or the node is not an object.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_FindNodeMember
+(
+    le_json_NodeRef_t nodeRef,  ///< [IN] The object.
+    const char* namePtr         ///< [IN] Member name.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a string node.  Escape sequences are not decoded (see le_json_GetString()).
+ *
+ * @return The string (in the document buffer), or NULL if the node is not a string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* le_json_GetNodeString
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a number node.
+ *
+ * @return The number, or 0 if the node is not a number.
+ */
+//--------------------------------------------------------------------------------------------------
+double le_json_GetNodeNumber
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a JSON writer.  The writer buffers the output, so nothing may be written to the file
+ * descriptor until le_json_DeleteWriter() is called.
+ *
+ * @return Reference to the writer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_WriterRef_t le_json_CreateWriter
+(
+    int fd          ///< [IN] File descriptor to write the JSON document to.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out anything still buffered and delete a JSON writer.  The file descriptor is not closed.
+ *
+ * @return
+ *      - LE_OK if everything was written.
+ *      - LE_FAULT if writing to the file descriptor failed (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_DeleteWriter
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing an object.  Must be followed by its members and then le_json_WriteObjectEnd().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteObjectStart
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish writing an object.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteObjectEnd
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing an array.  Must be followed by its elements and then le_json_WriteArrayEnd().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteArrayStart
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish writing an array.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteArrayEnd
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the name of an object member.  Must be followed by the member's value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteMemberName
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    const char* namePtr             ///< [IN] Member name (will be escaped).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteString
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    const char* strPtr              ///< [IN] The string (will be escaped).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a number value.  Numbers that can't be represented in JSON (infinities and NaN) are
+ * written as null.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNumber
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    double number                   ///< [IN] The number.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a true or false value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteBool
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    bool value                      ///< [IN] The value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a null value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNull
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a copy of a value from a document tree, including all of its children.  If the node is an
+ * object member, only its value is written, not its name.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNode
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    le_json_NodeRef_t nodeRef       ///< [IN] The value to copy.
+);
+
+
 #endif // LEGATO_JSON_H_INCLUDE_GUARD
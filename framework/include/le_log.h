@@ -280,6 +280,48 @@ $ export LE_LOG_LEVEL=DEBUG
  * For example,
  * @verbatim
 $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
+@endverbatim
+ *
+ * @subsubsection c_log_control_env_binary LE_LOG_BINARY
+ *
+ * Setting @c LE_LOG_BINARY to @c 1 makes debug, info and trace messages much cheaper to log,
+ * so that they can be left enabled in production.  Instead of formatting the message, the
+ * logging thread just copies the format string pointer and the raw argument values (plus copies
+ * of any strings passed for @c %s) into a ring buffer of its own, without taking any locks.  A
+ * writer thread in the same process formats and writes out the queued messages shortly after.
+ *
+ * The messages written out are exactly the same as they would have been otherwise, and each
+ * thread's messages stay in order.  Warnings and more severe messages are still written straight
+ * away (after anything the same thread had queued), and when the process exits everything
+ * still queued is written out.  However:
+ *
+ * - messages from different threads may be written out in a different order than they were
+ *   logged;
+ * - on embedded targets, syslog timestamps show when a queued message was written out, which
+ *   can be a few tens of milliseconds after it was logged;
+ * - messages that can't be deferred (e.g., with @c %n or wide character conversions in their
+ *   format strings) are written straight away.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_BINARY=1
+@endverbatim
+ *
+ * @subsubsection c_log_control_env_rateLimit LE_LOG_RATE_LIMIT
+ *
+ * @c LE_LOG_RATE_LIMIT sets the default rate limit for all components in the process, to stop a
+ * component that keeps logging the same message in a tight loop from flooding the log.  Its value
+ * is either @c off (the default) or COUNT/SECONDS, in which case each place in a component's code
+ * that logs is allowed a burst of up to COUNT messages, and after that COUNT messages every
+ * SECONDS seconds.  Messages over the limit are dropped.  Once the place that logged them has been
+ * quiet for SECONDS seconds (or is allowed to log again), a "last message repeated N times"
+ * message is logged instead.  Critical and emergency messages are never dropped.
+ *
+ * The rate limit can also be changed with the @c "log ratelimit" command.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_RATE_LIMIT=10/60
 @endverbatim
  *
  * @subsection c_log_control_functions Programmatic Log Control
@@ -294,6 +336,26 @@ $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
  *
  * Trace keywords can be enabled and disabled programmatically by calling
  * @ref le_log_EnableTrace() and @ref le_log_DisableTrace().
+ *
+ * @subsection c_log_control_static_filter Compile-Time Log Level Floor
+ *
+ * Messages can also be removed from the code altogether when it is compiled, so that code that
+ * logs a lot (e.g., debug messages in a driver's hot paths) costs nothing, not even the evaluation
+ * of the message's arguments, in a production build.  Define @c LE_LOG_LEVEL_STATIC_FILTER to the
+ * lowest level to keep (e.g., @c LE_LOG_INFO): messages of lower levels compile to nothing, and
+ * so do traces (@ref LE_TRACE) and data dumps (@ref LE_DUMP) unless it is @c LE_LOG_DEBUG, the
+ * default.  The runtime filter level still applies to the messages that are kept.
+ *
+ * The build tools' @c --log-level-floor option (e.g., <c>mksys --log-level-floor=WARNING</c>)
+ * sets it for every component built.  A component can set its own floor by defining it in its
+ * @c .cdef file's @c cflags: section, which takes precedence:
+ *
+ * @verbatim
+cflags:
+{
+    -DLE_LOG_LEVEL_STATIC_FILTER=LE_LOG_INFO
+}
+@endverbatim
  *
  *
  * @section c_log_format Log Formats
@@ -458,14 +520,30 @@ LE_SHARED le_log_Level_t* LE_LOG_LEVEL_FILTER_PTR;
 /// @endcond
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lowest level of the messages compiled into the current source file.  Messages of lower levels
+ * compile to nothing, and so do traces unless this is LE_LOG_DEBUG.
+ *
+ * See @ref c_log_control_static_filter.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LE_LOG_LEVEL_STATIC_FILTER
+#define LE_LOG_LEVEL_STATIC_FILTER  LE_LOG_DEBUG
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Internal macro to filter out messages that do not meet the current filtering level.
+ *
+ * The compile-time filter is a constant expression, so the compiler removes messages that don't
+ * meet it, along with the evaluation of their arguments.
  */
 //--------------------------------------------------------------------------------------------------
 #define _LE_LOG_MSG(level, formatString, ...) \
     do { \
-        if ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (level >= *LE_LOG_LEVEL_FILTER_PTR)) \
+        if (((level) >= LE_LOG_LEVEL_STATIC_FILTER) && \
+            ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (level >= *LE_LOG_LEVEL_FILTER_PTR))) \
             _le_log_Send(level, NULL, LE_LOG_SESSION, STRINGIZE(LE_FILENAME), __func__, __LINE__, \
                     formatString, ##__VA_ARGS__); \
     } while(0)
@@ -483,7 +561,11 @@ LE_SHARED le_log_Level_t* LE_LOG_LEVEL_FILTER_PTR;
 /** @copydoc LE_LOG_DEBUG */
 #define LE_DEBUG(formatString, ...)     _LE_LOG_MSG(LE_LOG_DEBUG, formatString, ##__VA_ARGS__)
 /** @copydoc LE_LOG_DATA */
-#define LE_DUMP(dataPtr, dataLength)    _le_LogData(dataPtr, dataLength, STRINGIZE(LE_FILENAME), __func__, __LINE__)
+#define LE_DUMP(dataPtr, dataLength) \
+        do { \
+            if (LE_LOG_DEBUG >= LE_LOG_LEVEL_STATIC_FILTER) \
+                _le_LogData(dataPtr, dataLength, STRINGIZE(LE_FILENAME), __func__, __LINE__); \
+        } while(0)
 /** @copydoc LE_LOG_INFO */
 #define LE_INFO(formatString, ...)      _LE_LOG_MSG(LE_LOG_INFO, formatString, ##__VA_ARGS__)
 /** @copydoc LE_LOG_WARN */
@@ -603,7 +685,8 @@ const char* _le_log_GetResultCodeString
  *      false otherwise.
  */
 //--------------------------------------------------------------------------------------------------
-#define LE_IS_TRACE_ENABLED(traceRef)  (le_log_IsTraceEnabled(traceRef))
+#define LE_IS_TRACE_ENABLED(traceRef) \
+        ((LE_LOG_DEBUG >= LE_LOG_LEVEL_STATIC_FILTER) && le_log_IsTraceEnabled(traceRef))
 
 
 //--------------------------------------------------------------------------------------------------
@@ -612,7 +695,7 @@ const char* _le_log_GetResultCodeString
  */
 //--------------------------------------------------------------------------------------------------
 #define LE_TRACE(traceRef, string, ...)         \
-        if (le_log_IsTraceEnabled(traceRef))    \
+        if (LE_IS_TRACE_ENABLED(traceRef))      \
         {                                       \
             _le_log_Send((le_log_Level_t)-1,    \
                     traceRef,                   \
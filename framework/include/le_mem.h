@@ -250,8 +250,8 @@
  *
  * @section mem_diagnostics Diagnostics
  *
- * The memory system also supports two different forms of diagnostics.  Both are enabled by defining
- * special preprocessor macros when building the framework.
+ * The memory system also supports three different forms of diagnostics.  They are enabled by
+ * defining special preprocessor macros when building the framework.
  *
  * The first of which is @c LE_MEM_TRACE.  When you define @c LE_MEM_TRACE every pool is given a
  * tracepoint with the name of the pool on creation.
@@ -267,6 +267,17 @@
  * pools are disabled and instead malloc and free are directly used.  Thus enabling the use of tools
  * like Valgrind.
  *
+ * The third is @c LE_MEM_GUARD_BANDS.  When @c LE_MEM_GUARD_BANDS is defined, every block is
+ * surrounded by guard bands filled with a known pattern, which are checked each time the block is
+ * allocated or released, and the process is terminated if they have been overwritten.
+ *
+ * Without @c LE_MEM_GUARD_BANDS, each block only has a single word of that pattern (a "canary")
+ * after the object.  By default, one release in every 64 (in each thread) checks the canary of the
+ * block being released, and one of those checks in every 64 also checks the canaries of all the
+ * free blocks in that block's pool.  Setting the @c LE_MEM_CHECK_INTERVAL environment variable of
+ * a process to a number of releases changes how often the canaries are checked: @c 1 checks on
+ * every release, and @c 0 never checks.
+ *
  * @section mem_threading Multi-Threading
  *
  * All functions in this API are <b> thread-safe, but not async-safe </b>.  The objects
@@ -295,6 +306,47 @@
  * the data structure, then the mutex must be held by the thread that calls le_mem_Release() to
  * ensure there's no other thread accessing the data structure when the destructor runs.
  *
+ * @subsection mem_thread_cache Thread Caches
+ *
+ * By default, every allocation and release briefly locks a mutex shared by all the pools in the
+ * process.  If a pool is heavily used by several threads at once, call
+ * @c le_mem_SetThreadCacheSize() right after creating it to give each thread its own small
+ * cache of free objects:
+ *
+ * @code
+ *     MsgPool = le_mem_CreatePool("Messages", sizeof(Msg_t));
+ *     le_mem_SetThreadCacheSize(MsgPool, 16);
+ *     le_mem_ExpandPool(MsgPool, MAX_MESSAGES);
+ * @endcode
+ *
+ * Most allocations and releases are then handled from the calling thread's cache without locking
+ * the mutex.  Objects are only moved between a thread's cache and the pool in batches, and are
+ * given back to the pool when the thread exits.  Cached objects are counted as free in the pool
+ * statistics, but note that they can only be allocated by the thread that holds them, so
+ * @c le_mem_TryAlloc() and @c le_mem_AssertAlloc() may fail (and @c le_mem_ForceAlloc() may
+ * expand the pool) while free objects still sit in other threads' caches.
+ *
+ * @subsection mem_regions Reserved Regions
+ *
+ * By default, a pool's objects are carved out of memory obtained from the heap (malloc()) each time
+ * the pool is expanded.  Large, long-lived pools end up scattered in small pieces all over a heap
+ * that they help fragment, and their pages are only faulted in one at a time as objects are first
+ * used.  Calling @c le_mem_ReserveRegion() right after creating such a pool reserves a contiguous
+ * region of memory for a given number of objects, mapped just for that pool, which the pool's
+ * expansions then take their objects from, in address order:
+ *
+ * @code
+ *     NodePool = le_mem_CreatePool("Nodes", sizeof(Node_t));
+ *     le_mem_ReserveRegion(NodePool, MAX_NODES, LE_MEM_REGION_PREFAULT);
+ *     le_mem_ExpandPool(NodePool, MAX_NODES);
+ * @endcode
+ *
+ * With @c LE_MEM_REGION_PREFAULT, all of the region's pages are faulted in right away rather than
+ * on first use.  With @c LE_MEM_REGION_HUGEPAGES, the region is aligned to, and asked to be
+ * backed by, transparent huge pages, which can save TLB misses on large pools if the kernel
+ * supports them.  Once the region is full, further expansions fall back to the heap.  The amount
+ * of the region that is actually resident in RAM is shown by the Inspect tool.
+ *
  * @section mem_pool_sizes Managing Pool Sizes
  *
  * We know it's possible to have pools automatically expand
@@ -382,6 +434,23 @@
  * @note You can't create sub-pools of sub-pools (i.e., sub-pools that get their blocks from another
  * sub-pool).
  *
+ * @section mem_size_classes Size-Class Allocators
+ *
+ * Objects whose size is only known at run time (buffers, strings, etc.) can be allocated from a
+ * size-class allocator instead of a pool per size or the heap.  le_mem_CreateSizeClassAllocator()
+ * creates one, given a name and the largest object size it will be asked for.
+ * le_mem_SizeClassAlloc() then allocates an object of a given size from the smallest size class
+ * that holds it, and the object is released using le_mem_Release() as usual.
+ *
+ * The size classes are the powers of two from 16 bytes up to LE_MEM_SIZE_CLASS_MAX_BYTES, and the
+ * sizes half way between them (16, 24, 32, 48, 64, 96, ...), so no more than a third of an
+ * object's block is ever wasted.  Each size class is a pool shared by the whole process, and each
+ * allocator takes its blocks from it through a sub-pool of its own, named after the allocator
+ * and the size of the class (e.g., "myComp.buffers.96").  A sub-pool is only created the first
+ * time its size class is used, and grows a block at a time, like le_mem_ForceAlloc() does.  As
+ * with any sub-pool, blocks released to it are kept for that allocator's later allocations, and
+ * the usage of each allocator can be seen with the Inspect tool.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -414,6 +483,23 @@
 typedef struct le_mem_Pool* le_mem_PoolRef_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Objects of this type are used to refer to a size-class allocator created using
+ * le_mem_CreateSizeClassAllocator().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mem_SizeClassAllocator* le_mem_SizeClassAllocatorRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest object size that a size-class allocator can allocate.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MEM_SIZE_CLASS_MAX_BYTES (1024 * 1024)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prototype for destructor functions.
@@ -665,6 +751,58 @@ void le_mem_SetNumObjsToForce
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables a per-thread cache of free objects for a pool.  See @ref mem_thread_cache.
+ *
+ * @return
+ *      Nothing.
+ *
+ * @note
+ *      Must be called before any objects are allocated from the pool, and can only be called once
+ *      for a given pool.  Sub-pools can't have thread caches.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetThreadCacheSize
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] Pool to enable thread caching for.
+    size_t              numObjects  ///< [IN] Maximum number of free objects to cache in each
+                                    ///       thread.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flags for le_mem_ReserveRegion().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MEM_REGION_PREFAULT      0x1     ///< Fault in the whole region right away.
+#define LE_MEM_REGION_HUGEPAGES     0x2     ///< Ask for transparent huge pages.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reserves a contiguous region of memory that a pool's expansions take their objects from.  See
+ * @ref mem_regions.
+ *
+ * @return
+ *      A reference to the memory pool object (the same value passed into it).
+ *
+ * @note
+ *      Must be called before the pool is first expanded, and can only be called once for a given
+ *      pool.  Sub-pools can't have regions (they take their objects from their super-pool).
+ *      On failure, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_PoolRef_t le_mem_ReserveRegion
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] Pool to reserve a region for.
+    size_t              numObjects, ///< [IN] Number of objects that the region must hold.
+    uint32_t            flags       ///< [IN] LE_MEM_REGION_PREFAULT and/or
+                                    ///       LE_MEM_REGION_HUGEPAGES, or 0.
+);
+
+
 #ifndef LE_MEM_TRACE
     //----------------------------------------------------------------------------------------------
     /**
@@ -945,4 +1083,66 @@ void le_mem_DeleteSubPool
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/** @cond HIDDEN_IN_USER_DOCS
+ *
+ * Internal function used to implement le_mem_CreateSizeClassAllocator() with automatic component
+ * scoping of pool names.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SizeClassAllocatorRef_t _le_mem_CreateSizeClassAllocator
+(
+    const char*     componentName,  ///< [IN] Name of the component.
+    const char*         name,       ///< [IN] Name of the allocator.
+    size_t              maxObjSize  ///< [IN] Largest object size that will be allocated.
+);
+/// @endcond
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a size-class allocator.
+ *
+ * See @ref mem_size_classes for more information.
+ *
+ * @return
+ *      Reference to the allocator.
+ *
+ * @note
+ *      On failure, the process exits, so you don't have to worry about checking the returned
+ *      reference for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_mem_SizeClassAllocatorRef_t le_mem_CreateSizeClassAllocator
+(
+    const char*         name,       ///< [IN] Name of the allocator (will be copied into it).
+    size_t              maxObjSize  ///< [IN] Largest object size that will be allocated (at most
+                                    ///       LE_MEM_SIZE_CLASS_MAX_BYTES).
+)
+{
+    return _le_mem_CreateSizeClassAllocator(STRINGIZE(LE_COMPONENT_NAME), name, maxObjSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a size-class allocator, expanding the size class if
+ * it doesn't have any free objects.  The object is released using le_mem_Release().
+ *
+ * See @ref mem_size_classes for more information.
+ *
+ * @return  A pointer to the allocated object, which is at least objSize bytes long.
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          pointer for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_SizeClassAlloc
+(
+    le_mem_SizeClassAllocatorRef_t  allocator,  ///< [IN] The allocator.
+    size_t                          objSize     ///< [IN] Size of the object, in bytes (at most
+                                                ///       the allocator's maximum object size).
+);
+
+
 #endif // LEGATO_MEM_INCLUDE_GUARD
@@ -128,6 +128,9 @@
  * it's bound to is not currently advertised by the server, then le_msg_TryOpenSessionSync()
  * will return an error code.
  *
+ * le_msg_OpenSessionsSync() opens several sessions at once, like le_msg_OpenSessionSync() does
+ * for one, but waits for all of the services in parallel.
+ *
  * @subsection c_messagingClientSending Sending a Message
  *
  * Before sending a message, the client must first allocate the message from the session's message
@@ -182,6 +185,29 @@
  *     le_msg_ReleaseMsg(responseMsgRef);
  * @endcode
  *
+ * @subsection c_messagingClientBatching Batching Requests
+ *
+ * When a client has several requests to make, doing them one at a time with
+ * le_msg_RequestSyncResponse() costs a round trip (and two context switches) per request.
+ * Instead, the client can start all of them using le_msg_RequestResponse() and handle the
+ * responses as they arrive.  To have the requests all handed to the server at once, so that the
+ * server can process them in one go, wrap them in le_msg_StartBatch() and le_msg_EndBatch():
+ *
+ * @code
+ *     le_msg_StartBatch(sessionRef);
+ *     for (i = 0; i < NUM_FIELDS; i++)
+ *     {
+ *         msgRef = le_msg_CreateMsg(sessionRef);
+ *         ...
+ *         le_msg_RequestResponse(msgRef, FieldResponseHandler, &Fields[i]);
+ *     }
+ *     le_msg_EndBatch(sessionRef);
+ * @endcode
+ *
+ * Messages sent with le_msg_Send() or le_msg_RequestResponse() during a batch are queued and only
+ * sent when the batch ends.  Batches can be nested; the messages are sent when the outermost batch
+ * ends.  A synchronous request made during a batch sends the queued messages ahead of itself.
+ *
  * @subsection c_messagingClientReceiving Receiving a Non-Response Message
  *
  * When a server sends a message to the client that is not a response to a request from the client,
@@ -365,6 +391,7 @@
  * @ref c_messagingServerCleanUp <br>
  * @ref c_messagingRemovingService <br>
  * @ref c_messagingServerMultithreading <br>
+ * @ref c_messagingServerWorkerThreads <br>
  * @ref c_messagingServerExample
  *
  * Servers that wish to offer a service do the following:
@@ -590,6 +617,33 @@
  * To work around this, you could move the service to another thread that that runs the Legato event
  * loop.
  *
+ * @subsection c_messagingServerWorkerThreads Worker Threads
+ *
+ * A server whose handlers can take a long time (e.g., because they wait for a modem to answer)
+ * holds up all its other clients while they run.  Such a server can call
+ * le_msg_SetServiceWorkerThreads() to have the service start a few worker threads of its own.
+ * Each session opened after that is handed to one of the worker threads, in turn, and everything
+ * to do with that session (its open handlers, its message handlers and its close handlers) is
+ * then done in that thread.  So the messages of one session are still handled one at a time, in
+ * the order they were sent, while different sessions are handled in parallel.
+ *
+ * This means the handlers (and whatever they share) must be thread-safe.  Messages to a client
+ * can be sent (or responses given) from any thread; they are passed on to the worker thread
+ * handling the session.  The worker threads are stopped when the service is deleted.
+ *
+ * Sessions opened in-process, through a local binding, are not dispatched; they are handled by
+ * the thread that created the service.
+ *
+ * For a server generated by @c ifgen, call le_msg_SetServiceWorkerThreads() with the reference
+ * returned by the generated @c GetServiceRef() function in the component's @c COMPONENT_INIT:
+ *
+ * @code
+ * COMPONENT_INIT
+ * {
+ *     le_msg_SetServiceWorkerThreads(le_sms_GetServiceRef(), 4);
+ * }
+ * @endcode
+ *
  * @subsection c_messagingServerExample Sample Code
  *
  * @code
@@ -696,6 +750,39 @@
  * configuration.  By default, sandboxed apps do not have any access (read or write) to the
  * "system" configuration tree.
  *
+ * @section c_messagingDirectOpen Direct Session Opening
+ *
+ * Normally, every session open request goes through the Service Directory.  A process that opens
+ * sessions with the same service over and over again can instead have the Service Directory set
+ * up a Direct Channel to the server the first time it opens a session on a client-side interface,
+ * and open later sessions on that interface by handing new connections straight to the server.
+ * This is enabled by setting the @c LE_MSG_DIRECT_OPEN environment variable to @c 1 in the client
+ * process.  It has no effect on the API.
+ *
+ * Direct Channels are kept by the client process until they are revoked, so a process that only
+ * opens one session per interface (such as a command-line tool) won't gain anything from them.
+ * If the client's binding changes or the server withdraws its service, the Service Directory
+ * revokes the Direct Channel and the next session is opened through the Service Directory again,
+ * so the binding configuration is still enforced.
+ *
+ * @section c_messagingLocalSessions Sessions Within a Process
+ *
+ * When an app binds a client-side interface to a server-side interface of a component in the same
+ * executable, the executable's generated startup code records the binding, and sessions opened on
+ * that client-side interface are opened in-process, without going through the Service Directory.
+ * Messages on such a session are still packed the same way, but are copied straight into a
+ * message on the other end of the session instead of going through a socket (file descriptors
+ * are moved across).  This makes no difference to the API, except that:
+ *  - le_msg_GetClientUserCreds() reports the process's own user ID and process ID.
+ *  - If the server-side interface is handled by the same thread as the client, the server must
+ *    respond to a synchronous request (le_msg_RequestSyncResponse()) before its receive handler
+ *    returns, or the request fails.
+ *  - Changing the binding at runtime (using the @c sdir tool) doesn't affect the executable's
+ *    own interfaces.
+ *
+ * If the server hasn't advertised its service when a session is opened, the session is opened
+ * through the Service Directory as usual.
+ *
  * @section c_messagingGetClientInfo Get Client Info
  *
  * In rare cases, a server may wish to check the user ID of the remote client.  Generally,
@@ -762,6 +849,101 @@
  * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  They can be exploited and used to break out of
  * chroot() jails.
  *
+ * @section c_messagingPayloadSize Sending Less Than the Maximum Payload
+ *
+ * By default, the whole payload buffer (the protocol's maximum message size) is sent with every
+ * message.  When messages are usually much smaller than the maximum, the sender can use
+ * le_msg_SetPayloadSize() to say how many bytes at the start of the payload are actually in
+ * use, and only those bytes will be sent.  The receiver can find out how many bytes were sent
+ * using le_msg_GetPayloadSize().  The rest of the receiver's payload buffer is filled with zeros.
+ * A server responding in the request message sends the whole payload back, unless it calls
+ * le_msg_SetPayloadSize() before le_msg_Respond().
+ *
+ * The payload of a new message is cleared to zero when it is first accessed.  Setting the
+ * payload size before that limits how much is cleared, so a sender that fills in all the bytes
+ * it sends can start with an empty payload and set the final size when it's done:
+ *
+ * @code
+ *     msgRef = le_msg_CreateMsg(sessionRef);
+ *     le_msg_SetPayloadSize(msgRef, 0);
+ *     bufPtr = le_msg_GetPayloadPtr(msgRef);
+ *     size = PackRequest(bufPtr, le_msg_GetMaxPayloadSize(msgRef));
+ *     le_msg_SetPayloadSize(msgRef, size);
+ *     le_msg_Send(msgRef);
+ * @endcode
+ *
+ * @section c_messagingSharedBuffers Sending Large Buffers
+ *
+ * Message payloads are copied through the kernel, so sending large amounts of data (e.g., image
+ * frames or audio blocks) in many maximum-size messages is expensive.  Instead, a shared memory
+ * buffer can be attached to a message.  On the sender's side, le_msg_CreateSharedBuffer() creates
+ * a buffer of the requested size and returns a pointer to it, which the sender fills in before
+ * sending the message.  On the receiver's side, le_msg_GetSharedBuffer() maps the same memory
+ * (read-only) into the receiver's address space, without copying it.
+ *
+ * @code
+ *     msgRef = le_msg_CreateMsg(sessionRef);
+ *     uint8_t* bufPtr = le_msg_CreateSharedBuffer(msgRef, frameSize);
+ *     LE_ASSERT(bufPtr != NULL);
+ *     CaptureFrame(bufPtr, frameSize);
+ *     le_msg_Send(msgRef);
+ * @endcode
+ *
+ * @code
+ *     size_t frameSize;
+ *     const uint8_t* framePtr = le_msg_GetSharedBuffer(msgRef, &frameSize);
+ *     if (framePtr != NULL)
+ *     {
+ *         DisplayFrame(framePtr, frameSize);
+ *     }
+ *     le_msg_ReleaseMsg(msgRef);
+ * @endcode
+ *
+ * When the message is sent, the sender loses access to the buffer and the buffer is sealed, so
+ * that its contents can't be changed after the receiver has received it.  The receiver's mapping
+ * is released along with the message.
+ *
+ * The shared buffer is passed using the message's file descriptor, so a message can carry either
+ * one shared buffer or one file descriptor (see @ref c_messagingSendingFileDescriptors), but not
+ * both.
+ *
+ * Interfaces defined in .api files don't need to call these functions directly: parameters of the
+ * @c buffer type are sent in shared buffers by the generated code (see @ref apiFilesSyntax).
+ *
+ * @note Shared buffers require memfd and file sealing support in the kernel (Linux 3.17 or later).
+ *       le_msg_CreateSharedBuffer() returns NULL if these are not available, in which case the
+ *       data must be sent through the payload instead.
+ *
+ * @section c_messagingArenas Per-Message Arenas
+ *
+ * A server that allocates several temporary objects while handling a request can allocate them
+ * from the request message's @ref c_arena "arena" instead of releasing each of them after
+ * responding.  le_msg_GetArena() returns the arena, creating it the first time it's called for
+ * the message, and the arena is deleted along with everything allocated from it when the message
+ * is released (i.e., once le_msg_Respond() has sent the response).
+ *
+ * @code
+ *     le_arena_Ref_t arena = le_msg_GetArena(msgRef);
+ *     Command_t* cmdPtr = ParseCommand(arena, le_msg_GetPayloadPtr(msgRef));
+ *     ...
+ *     le_msg_Respond(msgRef);     // cmdPtr and everything it points to are released later.
+ * @endcode
+ *
+ * @section c_messagingPriority High Priority Messages
+ *
+ * A message that must not wait behind a bulk transfer (for example, an emergency call trigger)
+ * can be marked using le_msg_SetHighPriority() before it's sent.  It is then sent ahead of any
+ * normal messages still waiting on the session's transmit queue (e.g., because the socket is
+ * full, or inside a batch), though never ahead of other high priority messages.  The priority is
+ * sent with the message, so it's also processed ahead of the normal messages waiting at the
+ * receiving end, and the response to it is high priority too.
+ *
+ * Functions of an interface can be made high priority in its .api file (see
+ * @ref apiFilesSyntax_functionHighPriority); the generated client code then marks their requests
+ * itself.
+ *
+ * How long messages waited on the transmit queue is shown by the Inspect tool.
+ *
  * @section c_messagingFutureEnhancements Future Enhancements
  *
  * As an optimization to reduce the number of copies in cases where the sender of a message
@@ -814,6 +996,13 @@
 #ifndef LE_MESSAGING_H_INCLUDE_GUARD
 #define LE_MESSAGING_H_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of worker threads that a service can have (see le_msg_SetServiceWorkerThreads()).
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MSG_MAX_SERVICE_WORKER_THREADS   8
+
 // =======================================
 //  DATA TYPES
 // =======================================
@@ -1154,6 +1343,24 @@ le_result_t le_msg_TryOpenSessionSync
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronously open several sessions.  Blocks until all of them are open.
+ *
+ * Same as calling le_msg_OpenSessionSync() for each session, except that the services are
+ * connected to in parallel instead of one after the other.  This is what the generated component
+ * main functions use to connect their client-side interfaces at start-up.
+ *
+ * This function logs a fatal error and terminates the calling process if unsuccessful.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_OpenSessionsSync
+(
+    le_msg_SessionRef_t*            sessionRefs,    ///< [in] Sessions (NULL entries are skipped).
+    size_t                          numSessions     ///< [in] Number of entries in sessionRefs.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Terminates a session.
@@ -1165,6 +1372,35 @@ void le_msg_CloseSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of messages on a session.  Messages sent on the session are queued until the
+ * matching call to le_msg_EndBatch().  Batches can be nested.
+ *
+ * @note Only the thread that owns the session can do this.
+ *
+ * @see @ref c_messagingClientBatching
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_StartBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [in] Reference to the session.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends a batch of messages.  When the outermost batch ends, all the queued messages are sent.
+ *
+ * @note Only the thread that owns the session can do this.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_EndBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [in] Reference to the session.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches a reference to the protocol that is being used for a given session.
@@ -1332,6 +1568,38 @@ size_t le_msg_GetMaxPayloadSize
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload that are in use.  Only these
+ * are sent.  By default, the whole payload buffer is in use.
+ *
+ * If this is called before the payload is first accessed using le_msg_GetPayloadPtr(), then only
+ * that many bytes are cleared.  Bytes added by increasing the size later are not cleared.
+ *
+ * @see @ref c_messagingPayloadSize
+ **/
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              size        ///< [in] Number of payload bytes in use.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes at the start of the message payload that are in use.  For a received
+ * message, this is the number of payload bytes the sender sent.
+ *
+ * @return The size, in bytes.
+ **/
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -1349,6 +1617,18 @@ void le_msg_SetFd
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks a message as high priority, so that it goes ahead of the normal messages waiting to be
+ * sent on the same session.  See @ref c_messagingPriority.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetHighPriority
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches a received file descriptor from the message.
@@ -1363,9 +1643,72 @@ int le_msg_GetFd
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a shared memory buffer to be sent with this message.
+ *
+ * The buffer stays writable by the sender until the message is sent.  After that, the returned
+ * pointer must not be used anymore.
+ *
+ * At most one shared buffer can be sent per message, and it can't be combined with a file
+ * descriptor set using le_msg_SetFd().
+ *
+ * @return A pointer to the buffer, or NULL if shared buffers are not supported or the buffer
+ *         could not be created.
+ *
+ * @see @ref c_messagingSharedBuffers
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_CreateSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              size        ///< [in] Size of the buffer, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the shared memory buffer received with this message.
+ *
+ * The buffer is read-only, and remains valid until the message is released.
+ *
+ * @return A pointer to the buffer, or NULL if no shared buffer was sent with this message.
+ *
+ * @see @ref c_messagingSharedBuffers
+ **/
+//--------------------------------------------------------------------------------------------------
+const void* le_msg_GetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t*             sizePtr     ///< [out] Size of the buffer, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an arena that belongs to a message, creating it the first time this is called for the
+ * message.  The arena is deleted, along with everything allocated from it, when the message is
+ * released (which, for a request message, happens once the response has been sent).
+ *
+ * @return Reference to the arena.
+ *
+ * @see @ref c_messagingArenas
+ **/
+//--------------------------------------------------------------------------------------------------
+le_arena_Ref_t le_msg_GetArena
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message.  No response expected.
+ *
+ * @note    On the client side, only the thread that created the session can send through it.  On
+ *          the server side, any thread can: if it isn't the thread handling the session (see
+ *          @ref c_messagingServerWorkerThreads), the message is passed on to that thread, which
+ *          sends it.  Messages sent from the same thread are sent in order.
  */
 //--------------------------------------------------------------------------------------------------
 void le_msg_Send
@@ -1448,12 +1791,14 @@ le_msg_MessageRef_t le_msg_RequestSyncResponse
  * Sends a response back to the client that send the request message.
  *
  * Takes a reference to the request message.  Copy the response payload (if any) into the
- * same payload buffer that held the request payload, then call le_msg_Respond().
+ * same payload buffer that held the request payload, then call le_msg_Respond().  The whole
+ * payload is sent back, unless le_msg_SetPayloadSize() is called first.
  *
  * The messaging system will delete the message automatically when it's finished sending
  * the response.
  *
- * @note    Function can only be used on the server side of a session.
+ * @note    Function can only be used on the server side of a session.  It can be called from any
+ *          thread (see le_msg_Send()).
  */
 //--------------------------------------------------------------------------------------------------
 void le_msg_Respond
@@ -1551,6 +1896,25 @@ void le_msg_SetServiceRecvHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a set of worker threads for a service.  Sessions opened by clients after this is called
+ * are dispatched to the worker threads in turn, and each session's open handlers, message
+ * handlers and close handlers are all called in the worker thread that it was dispatched to.
+ *
+ * See @ref c_messagingServerWorkerThreads.
+ *
+ * @note    Server-only function, which can only be called once per service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceWorkerThreads
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              numThreads  ///< [in] Number of worker threads
+                                    ///       (at most LE_MSG_MAX_SERVICE_WORKER_THREADS).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -0,0 +1,370 @@
+/**
+ * @page c_orderedMap Ordered Map API
+ *
+ * @ref le_orderedMap.h "API Reference"
+ *
+ * <HR>
+ *
+ * An ordered map keeps links sorted by the keys of their nodes, as defined by a user-supplied
+ * comparison function.  Adding, finding and removing a link take O(log n) time, instead of the
+ * O(n) it takes with a sorted linked list, and the links can be walked in order in either
+ * direction.
+ *
+ * The map is a red-black tree.  Like the @ref c_doublyLinkedList "linked lists", it is intrusive:
+ * the map only manages the links included in the user's nodes, and the user is responsible for
+ * creating and freeing the nodes (usually from a @ref c_memory "memory pool").  Several nodes
+ * may have the same key.
+ *
+ * @section omap_create Creating and Initializing Maps
+ *
+ * To create and initialize a map the user must create a le_omap_Map_t typed map and assign
+ * LE_OMAP_INIT(compareFunc) to it, where @c compareFunc compares a key to the key of a link's
+ * node.  The map <b>must</b> be initialized before it can be used.
+ *
+ * @code
+ * typedef struct
+ * {
+ *     int32_t signalStrength;
+ *     ...
+ *     le_omap_Link_t link;
+ * }
+ * MyNode_t;
+ *
+ * static int MyNodeCompare
+ * (
+ *     const void* keyPtr,
+ *     const le_omap_Link_t* linkPtr
+ * )
+ * {
+ *     int32_t key = *(const int32_t*)keyPtr;
+ *     int32_t nodeKey = CONTAINER_OF(linkPtr, MyNode_t, link)->signalStrength;
+ *
+ *     return (key > nodeKey) - (key < nodeKey);
+ * }
+ *
+ * static le_omap_Map_t MyMap = LE_OMAP_INIT(MyNodeCompare);
+ * @endcode
+ *
+ * <b> Elements of le_omap_Map_t MUST NOT be accessed directly by the user. </b>
+ *
+ *
+ * @section omap_use Using Maps
+ *
+ * Each node must contain a @c le_omap_Link_t link member, initialized by assigning
+ * LE_OMAP_LINK_INIT to it.  Nodes are then handled through their links:
+ *
+ * - @c le_omap_Insert() - Adds a link with the key of its node, after the links of equal keys.
+ * - @c le_omap_Remove() - Removes a specified link from the map.
+ * - @c le_omap_Pop() - Removes and returns the link of the lowest key.
+ * - @c le_omap_Find() - Returns the first link of a given key.
+ * - @c le_omap_FindGreaterOrEqual() - Returns the first link of a key greater than or equal to a
+ *   given key.
+ * - @c le_omap_Peek(), @c le_omap_PeekTail(), @c le_omap_PeekNext() and @c le_omap_PeekPrev() -
+ *   Walk the map in order.
+ * - @c le_omap_IsEmpty(), @c le_omap_NumLinks() and @c le_omap_IsInMap() - Query the map.
+ *
+ * The key of a node must not be changed while its link is in the map.  To change it, remove the
+ * link, change the key, then insert the link again.
+ *
+ * To obtain the node from its link, use the @c CONTAINER_OF macro defined in le_basics.h.
+ *
+ *
+ * @section omap_inspect Change Counter
+ *
+ * Every change to a map increments its change counter, returned by le_omap_GetChangeCount().
+ * Like the change counters of the framework's other object lists, this lets a tool walking the
+ * map from another process (e.g., inspect) notice that the map changed under it, and retry.
+ *
+ *
+ * @section omap_synch Thread Safety and Re-Entrancy
+ *
+ * All map function calls are re-entrant and thread safe themselves, but if a map is shared by
+ * multiple threads, a @ref c_mutex "mutex" or some other form of thread synchronization must be
+ * used to ensure only one thread accesses it at a time.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+
+ /** @file le_orderedMap.h
+  *
+  * Legato @ref c_orderedMap include file.
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#ifndef LEGATO_ORDERED_MAP_INCLUDE_GUARD
+#define LEGATO_ORDERED_MAP_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This link object must be included in each user node.  The node's link object is used to add the
+ * node to a map.  It must be initialized by assigning LE_OMAP_LINK_INIT to it.
+ *
+ * @warning The structure's content MUST NOT be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_omap_Link
+{
+    struct le_omap_Link* parentPtr;     ///< Parent link pointer.
+    struct le_omap_Link* leftPtr;       ///< Left (lower) child link pointer.
+    struct le_omap_Link* rightPtr;      ///< Right (higher) child link pointer.
+    bool isRed;                         ///< Colour of the link in the red-black tree.
+}
+le_omap_Link_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the functions comparing a key to the key of a link's node.
+ *
+ * @return
+ *      Less than, equal to or greater than 0 if the key is lower than, equal to or greater than
+ *      the key of the link's node.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef int (*le_omap_CompareFunc_t)
+(
+    const void* keyPtr,                 ///< [IN] The key.
+    const le_omap_Link_t* linkPtr       ///< [IN] The link.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This is the map object.  User must create this map object and initialize it by assigning
+ * LE_OMAP_INIT(compareFunc) to it.
+ *
+ * @warning User MUST NOT access the contents of this structure directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_omap_Link_t* rootPtr;            ///< Root link of the tree.
+    le_omap_CompareFunc_t compareFunc;  ///< Function comparing a key to the key of a link's node.
+    size_t count;                       ///< Number of links in the map.
+    size_t changeCount;                 ///< Number of changes made to the map.
+}
+le_omap_Map_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * When a map is created it must be initialized by assigning this macro to the map before the
+ * map can be used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_OMAP_INIT(compareFunc) (le_omap_Map_t){NULL, (compareFunc), 0, 0}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * When a link is created it must be initialized by assigning this macro to the link before it can
+ * be used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_OMAP_LINK_INIT (le_omap_Link_t){NULL, NULL, NULL, false}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a link to the map, after any links with the same key.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_omap_Insert
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] Map to add to.
+    le_omap_Link_t* newLinkPtr,         ///< [IN] New link to add.
+    const void* keyPtr                  ///< [IN] Key of the new link's node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the specified link from the map.  User must ensure that the link is in the map
+ * otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_omap_Remove
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] Map to remove from.
+    le_omap_Link_t* linkToRemovePtr     ///< [IN] Link to remove.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes and returns the link of the lowest key.
+ *
+ * @return
+ *      The removed link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Pop
+(
+    le_omap_Map_t* mapPtr               ///< [IN] Map to remove from.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first link of a key.
+ *
+ * @return
+ *      The link.
+ *      NULL if no link has this key.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Find
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const void* keyPtr                  ///< [IN] The key.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first link of a key greater than or equal to a key.
+ *
+ * @return
+ *      The link.
+ *      NULL if all the links have lower keys.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_FindGreaterOrEqual
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const void* keyPtr                  ///< [IN] The key.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link of the lowest key without removing it.
+ *
+ * @return
+ *      The link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Peek
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link of the greatest key without removing it.
+ *
+ * @return
+ *      The link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekTail
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link following currentLinkPtr in the map without removing it.  User must ensure that
+ * currentLinkPtr is in the map otherwise the behaviour of this function is undefined.
+ *
+ * @return
+ *      The next link.
+ *      NULL if currentLinkPtr is the last link.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekNext
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* currentLinkPtr///< [IN] Current link.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link preceding currentLinkPtr in the map without removing it.  User must ensure
+ * that currentLinkPtr is in the map otherwise the behaviour of this function is undefined.
+ *
+ * @return
+ *      The previous link.
+ *      NULL if currentLinkPtr is the first link.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekPrev
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* currentLinkPtr///< [IN] Current link.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a link is in the map.
+ *
+ * @return
+ *      true if the link is in the map.
+ *      false if the link is not in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_omap_IsInMap
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* linkPtr       ///< [IN] The link, which is in this map or in none.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of links in the map.
+ *
+ * @return
+ *      The number of links.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_omap_NumLinks
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the change counter of the map, incremented on every change made to it.
+ *
+ * @return
+ *      The change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_omap_GetChangeCount
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the map is empty.
+ *
+ * @return
+ *      true if empty, false if not empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_omap_IsEmpty
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+)
+{
+    return (mapPtr->rootPtr == NULL);
+}
+
+
+#endif  // LEGATO_ORDERED_MAP_INCLUDE_GUARD
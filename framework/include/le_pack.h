@@ -16,6 +16,12 @@
  *   - Packing arrays of the above types
  *   - Packing strings.
  * It also supports unpacking any of the above.
+ *
+ * Every type can be packed either at its full width, or using a compact encoding (the
+ * @c le_pack_PackVar... and @c le_pack_PackCompact... functions) in which integers are packed as
+ * variable-length integers and strings and arrays only take up the bytes actually used.  The
+ * two encodings can't be mixed: both ends of a connection must use the same one.  Interfaces
+ * generated by ifgen with the @c --compact option use the compact encoding.
  */
 
 #ifndef LE_PACK_H_INCLUDE_GUARD
@@ -947,4 +953,705 @@ static inline bool le_pack_UnpackArrayHeader
         }                                                               \
     } while (0)
 
+
+//--------------------------------------------------------------------------------------------------
+// Compact encoding
+//
+// Integers wider than a byte are packed as variable-length integers ("varints"): 7 bits per byte,
+// least significant bits first, with the top bit of each byte set if more bytes follow.  Signed
+// integers are zig-zag encoded first (0, -1, 1, -2, ... become 0, 1, 2, 3, ...) so that small
+// negative values are short too.  Strings and arrays are packed as a varint count followed by
+// only the elements actually used.  Unlike the functions above, the compact functions decrement
+// the available size by the number of bytes actually used.
+//
+// The compact encoding is not compatible with the fixed-width one: both ends of a connection
+// must use the same one.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes in a packed varint.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_VARINT_MAX_BYTES    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint64_t into a buffer as a varint, incrementing the buffer pointer and decrementing the
+ * available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarUint64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t value
+)
+{
+    size_t used = 0;
+
+    do
+    {
+        if (used >= *sizePtr)
+        {
+            return false;
+        }
+
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        (*bufferPtr)[used++] = byte | (value ? 0x80 : 0);
+    }
+    while (value);
+
+    *bufferPtr = *bufferPtr + used;
+    *sizePtr -= used;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint16_t into a buffer as a varint, incrementing the buffer pointer and decrementing the
+ * available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarUint16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint16_t value
+)
+{
+    return le_pack_PackVarUint64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint32_t into a buffer as a varint, incrementing the buffer pointer and decrementing the
+ * available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarUint32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint32_t value
+)
+{
+    return le_pack_PackVarUint64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int64_t into a buffer as a zig-zag encoded varint, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarInt64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int64_t value
+)
+{
+    uint64_t zigZag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+
+    return le_pack_PackVarUint64(bufferPtr, sizePtr, zigZag);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int16_t into a buffer as a zig-zag encoded varint, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarInt16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int16_t value
+)
+{
+    return le_pack_PackVarInt64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int32_t into a buffer as a zig-zag encoded varint, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarInt32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int32_t value
+)
+{
+    return le_pack_PackVarInt64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a size_t into a buffer as a varint, incrementing the buffer pointer and decrementing the
+ * available size by the number of bytes used.
+ *
+ * @note Packed sizes are limited to 2^32-1, regardless of platform
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarSize
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    size_t value
+)
+{
+    if (value > UINT32_MAX)
+    {
+        return false;
+    }
+
+    return le_pack_PackVarUint64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a le_result_t into a buffer as a zig-zag encoded varint, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarResult
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_result_t value
+)
+{
+    return le_pack_PackVarInt64(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a le_onoff_t into a buffer as a varint, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarOnOff
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_onoff_t value
+)
+{
+    return le_pack_PackVarUint64(bufferPtr, sizePtr, (uint32_t)value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a reference into a buffer as a varint, incrementing the buffer pointer and decrementing the
+ * available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarReference
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const void* ref
+)
+{
+    size_t refAsInt = (size_t)ref;
+
+    // Same checks as le_pack_PackReference().
+    if ((refAsInt <= UINT32_MAX) &&
+        ((refAsInt & 0x01) ||
+         !refAsInt))
+    {
+        return le_pack_PackVarUint64(bufferPtr, sizePtr, refAsInt);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a string into a buffer as a varint length followed by the characters of the string (with
+ * no null terminator), incrementing the buffer pointer and decrementing the available size by the
+ * number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactString
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const char *stringPtr,
+    uint32_t maxStringCount
+)
+{
+    if (!stringPtr)
+    {
+        return false;
+    }
+
+    size_t length = strnlen(stringPtr, (size_t)maxStringCount + 1);
+
+    // String was too long -- return false.
+    if (length > maxStringCount)
+    {
+        return false;
+    }
+
+    if (!le_pack_PackVarUint64(bufferPtr, sizePtr, length) ||
+        (*sizePtr < length))
+    {
+        return false;
+    }
+
+    memcpy(*bufferPtr, stringPtr, length);
+
+    *bufferPtr = *bufferPtr + length;
+    *sizePtr -= length;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack the element count of an array into a buffer as a varint, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.
+ *
+ * @note Users of this API should generally use LE_PACK_PACKCOMPACTARRAY macro instead which also
+ * packs the array data.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactArrayHeader
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    size_t arrayCount,
+    size_t arrayMaxCount
+)
+{
+    if (arrayCount > arrayMaxCount)
+    {
+        return false;
+    }
+
+    return le_pack_PackVarSize(bufferPtr, sizePtr, arrayCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array into a buffer as a varint element count followed by the elements actually used,
+ * incrementing the buffer pointer and decrementing the available size by the number of bytes used.
+ *
+ * The elements are packed using packFunc, which should be one of the compact pack functions for
+ * elements wider than a byte.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_PACKCOMPACTARRAY(bufferPtr,                             \
+                                 sizePtr,                               \
+                                 arrayPtr,                              \
+                                 arrayCount,                            \
+                                 arrayMaxCount,                         \
+                                 packFunc,                              \
+                                 resultPtr)                             \
+    do {                                                                \
+        *(resultPtr) = le_pack_PackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                      (arrayCount), (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            uint32_t i;                                                 \
+            for (i = 0; i < (arrayCount); ++i)                          \
+            {                                                           \
+                if (!packFunc((bufferPtr), (sizePtr), (arrayPtr)[i]))   \
+                {                                                       \
+                    *(resultPtr) = false;                               \
+                    break;                                              \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer into a uint64_t, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarUint64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t* valuePtr
+)
+{
+    uint64_t value = 0;
+    size_t used;
+
+    for (used = 0; (used < *sizePtr) && (used < LE_PACK_VARINT_MAX_BYTES); used++)
+    {
+        uint8_t byte = (*bufferPtr)[used];
+
+        // The last byte of a 64-bit value can only hold one bit.
+        if ((used == LE_PACK_VARINT_MAX_BYTES - 1) && (byte > 1))
+        {
+            return false;
+        }
+
+        value |= (uint64_t)(byte & 0x7F) << (7 * used);
+
+        if (!(byte & 0x80))
+        {
+            *valuePtr = value;
+            *bufferPtr = *bufferPtr + used + 1;
+            *sizePtr -= used + 1;
+
+            return true;
+        }
+    }
+
+    // Ran out of buffer, or too many bytes.
+    return false;
+}
+
+// Unpacking a varint into a narrower type is basically the same regardless of type.  But don't use
+// these macros directly to get better verification that we're only unpacking the types we expect
+#define LE_PACK_UNPACK_VAR_UINT(valuePtr, maxValue)                     \
+    uint64_t rawValue;                                                  \
+                                                                        \
+    if (!le_pack_UnpackVarUint64(bufferPtr, sizePtr, &rawValue) ||      \
+        (rawValue > (maxValue)))                                        \
+    {                                                                   \
+        return false;                                                   \
+    }                                                                   \
+                                                                        \
+    *(valuePtr) = rawValue;                                             \
+                                                                        \
+    return true
+
+#define LE_PACK_UNPACK_VAR_INT(valuePtr, minValue, maxValue)            \
+    uint64_t rawValue;                                                  \
+                                                                        \
+    if (!le_pack_UnpackVarUint64(bufferPtr, sizePtr, &rawValue))        \
+    {                                                                   \
+        return false;                                                   \
+    }                                                                   \
+                                                                        \
+    int64_t value = (int64_t)((rawValue >> 1) ^ -(rawValue & 1));       \
+    if ((value < (minValue)) || (value > (maxValue)))                   \
+    {                                                                   \
+        return false;                                                   \
+    }                                                                   \
+                                                                        \
+    *(valuePtr) = value;                                                \
+                                                                        \
+    return true
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer into a uint16_t, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.  Fails if the value doesn't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarUint16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint16_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_UINT(valuePtr, UINT16_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer into a uint32_t, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.  Fails if the value doesn't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarUint32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint32_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_UINT(valuePtr, UINT32_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a zig-zag encoded varint from a buffer into an int16_t, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.  Fails if the value doesn't
+ * fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarInt16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int16_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_INT(valuePtr, INT16_MIN, INT16_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a zig-zag encoded varint from a buffer into an int32_t, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.  Fails if the value doesn't
+ * fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarInt32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int32_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_INT(valuePtr, INT32_MIN, INT32_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a zig-zag encoded varint from a buffer into an int64_t, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarInt64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int64_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_INT(valuePtr, INT64_MIN, INT64_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer into a size_t, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.
+ *
+ * @note Packed sizes are limited to 2^32-1, regardless of platform
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarSize
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    size_t* valuePtr
+)
+{
+    LE_PACK_UNPACK_VAR_UINT(valuePtr, UINT32_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a zig-zag encoded varint from a buffer into a le_result_t, incrementing the buffer
+ * pointer and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarResult
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_result_t* valuePtr
+)
+{
+    int32_t value;
+
+    if (!le_pack_UnpackVarInt32(bufferPtr, sizePtr, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (le_result_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer into a le_onoff_t, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarOnOff
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_onoff_t* valuePtr
+)
+{
+    uint32_t value;
+
+    if (!le_pack_UnpackVarUint32(bufferPtr, sizePtr, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (le_onoff_t)value;
+
+    return true;
+}
+
+#undef LE_PACK_UNPACK_VAR_UINT
+#undef LE_PACK_UNPACK_VAR_INT
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a reference packed as a varint from a buffer, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarReference
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    void* refPtr                ///< Pointer to the reference.  Declared as void * to allow implicit
+                                ///< conversion from pointer to reference types.
+)
+{
+    uint32_t refAsInt;
+
+    if (!le_pack_UnpackVarUint32(bufferPtr, sizePtr, &refAsInt))
+    {
+        return false;
+    }
+
+    // Same checks as le_pack_UnpackReference().
+    if ((refAsInt & 0x01) ||
+        (!refAsInt))
+    {
+        // Double cast to avoid warnings.
+        *(void **)refPtr = (void *)(size_t)refAsInt;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a string packed by le_pack_PackCompactString() from a buffer, incrementing the buffer
+ * pointer and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactString
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    char *stringPtr,
+    uint32_t bufferSize,
+    uint32_t maxStringCount
+)
+{
+    uint32_t stringSize;
+
+    if (!le_pack_UnpackVarUint32(bufferPtr, sizePtr, &stringSize))
+    {
+        return false;
+    }
+
+    if ((stringSize > maxStringCount) ||
+        (stringSize > *sizePtr))
+    {
+        return false;
+    }
+
+    if (!stringPtr)
+    {
+        // Only allow unpacking into no output buffer if the string is zero sized.
+        // Otherwise an output buffer is required.
+        return (stringSize == 0);
+    }
+
+    // Leave room for the null terminator.
+    if (stringSize >= bufferSize)
+    {
+        return false;
+    }
+
+    memcpy(stringPtr, *bufferPtr, stringSize);
+    stringPtr[stringSize] = '\0';
+
+    *bufferPtr = *bufferPtr + stringSize;
+    *sizePtr -= stringSize;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack the element count of an array packed by le_pack_PackCompactArrayHeader() from a buffer,
+ * incrementing the buffer pointer and decrementing the available size by the number of bytes used.
+ *
+ * @note Users of this API should generally use LE_PACK_UNPACKCOMPACTARRAY macro instead which also
+ * unpacks the array data.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactArrayHeader
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    const void *arrayPtr,
+    size_t *arrayCountPtr,
+    size_t arrayMaxCount
+)
+{
+    if (!le_pack_UnpackVarSize(bufferPtr, sizePtr, arrayCountPtr))
+    {
+        return false;
+    }
+
+    if (*arrayCountPtr > arrayMaxCount)
+    {
+        return false;
+    }
+    else if (!arrayPtr)
+    {
+        // Missing array pointer must match zero sized array.
+        return (*arrayCountPtr == 0);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array packed by LE_PACK_PACKCOMPACTARRAY from a buffer, incrementing the buffer
+ * pointer and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_UNPACKCOMPACTARRAY(bufferPtr,                           \
+                                   sizePtr,                             \
+                                   arrayPtr,                            \
+                                   arrayCountPtr,                       \
+                                   arrayMaxCount,                       \
+                                   unpackFunc,                          \
+                                   resultPtr)                           \
+    do {                                                                \
+        *(resultPtr) = le_pack_UnpackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                        (arrayPtr), (arrayCountPtr), \
+                                                        (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            uint32_t i;                                                 \
+            for (i = 0; i < *(arrayCountPtr); ++i)                      \
+            {                                                           \
+                if (!unpackFunc((bufferPtr), (sizePtr), &(arrayPtr)[i])) \
+                {                                                       \
+                    *(resultPtr) = false;                               \
+                    break;                                              \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
 #endif /* LE_PACK_H_INCLUDE_GUARD */
@@ -0,0 +1,184 @@
+/**
+ * @page c_rwLock Reader-Writer Lock API
+ *
+ * @ref le_rwLock.h "API Reference"
+ *
+ * <HR>
+ *
+ * The Reader-Writer Lock API provides locks that can be held by any number of readers at the
+ * same time, or by a single writer.  They suit data that is read much more often than it is
+ * changed (lookup tables, caches, snapshots, etc.), where a mutex would make the readers wait for
+ * each other for no reason.  Like mutexes, they can be shared by threads within the same process,
+ * but can't be shared by threads in different processes.
+ *
+ * @warning  Multithreaded programming is an advanced subject with many pitfalls.
+ * A general discussion of why and how locks are used in multithreaded programming is beyond
+ * the scope of this documentation.  If you are not familiar with these concepts @e please seek
+ * out training and mentorship before attempting to work on multithreaded production code.
+ *
+ * The locks are @b writer-preferring: as soon as a thread waits for the write lock, new readers
+ * wait too, so a steady flow of readers can't keep a writer out forever.  The flip side is that
+ * a thread must never take the read lock again while it already holds it (another thread may have
+ * started waiting for the write lock in between, and then both wait for each other forever).
+ * Neither the read lock nor the write lock is recursive, and a read lock can't be upgraded to a
+ * write lock.
+ *
+ * If a thread holding the write lock tries to take the same lock again (for reading or for
+ * writing), a deadlock is detected, a fatal error is logged and the process is terminated.
+ *
+ * Taking the read lock while no writer holds or waits for the lock is a single atomic operation.
+ *
+ * @section c_rwLock_create Creating a Reader-Writer Lock
+ *
+ * In Legato, reader-writer locks are dynamically allocated objects.  le_rwlock_Create() creates
+ * one and returns a reference to it (of type le_rwlock_Ref_t).
+ *
+ * All reader-writer locks have names, required for diagnostic purposes.  See
+ * @ref c_rwLock_diagnostics below.
+ *
+ * @section c_rwLock_locking Using a Reader-Writer Lock
+ *
+ * Functions for threads that only read the protected data:
+ *  - @c le_rwlock_ReadLock()
+ *  - @c le_rwlock_TryReadLock()
+ *  - @c le_rwlock_ReadUnlock()
+ *
+ * Functions for threads that change the protected data:
+ *  - @c le_rwlock_WriteLock()
+ *  - @c le_rwlock_TryWriteLock()
+ *  - @c le_rwlock_WriteUnlock()
+ *
+ * @section c_rwLock_delete Deleting a Reader-Writer Lock
+ *
+ * When you are finished with a reader-writer lock, you must delete it by calling
+ * le_rwlock_Delete().
+ *
+ * There must not be anyone using the lock when it is deleted (i.e., no one can be holding it or
+ * waiting for it).
+ *
+ * @section c_rwLock_diagnostics Diagnostics
+ *
+ * The command-line diagnostic tool @ref toolsTarget_inspect can be used to list the reader-writer
+ * locks that currently exist inside a given process.  The state of each lock can be seen,
+ * including its number of readers, the thread that holds it for writing, and a list of any
+ * threads that might be waiting for it.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_rwLock.h
+ *
+ * Legato @ref c_rwLock include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_RWLOCK_INCLUDE_GUARD
+#define LEGATO_RWLOCK_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a Reader-Writer Lock object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_rwlock* le_rwlock_Ref_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a Reader-Writer lock.
+ *
+ * @return  Returns a reference to the lock.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_rwlock_Ref_t le_rwlock_Create
+(
+    const char* nameStr     ///< [in] Name of the lock
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_Delete
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a Reader-Writer lock for reading.  Waits while a thread holds, or waits for, the write
+ * lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_ReadLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a Reader-Writer lock for reading.
+ *
+ * @return
+ *  - LE_OK if the lock was taken for reading.
+ *  - LE_WOULD_BLOCK if a thread holds, or waits for, the write lock.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_rwlock_TryReadLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a read lock on a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_ReadUnlock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a Reader-Writer lock for writing.  Waits until no other thread holds the lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_WriteLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a Reader-Writer lock for writing.
+ *
+ * @return
+ *  - LE_OK if the lock was taken for writing.
+ *  - LE_WOULD_BLOCK if the lock is held by someone.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_rwlock_TryWriteLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the write lock on a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_WriteUnlock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+);
+
+#endif // LEGATO_RWLOCK_INCLUDE_GUARD
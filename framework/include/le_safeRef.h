@@ -56,6 +56,23 @@
  * created by calling @c le_ref_CreateMap().  It takes a single argument, the maximum number
  * of mappings expected to track of at any time.
  *
+ * @section c_safeRef_indexedMap Indexed Reference Maps
+ *
+ * Reference Maps created by @c le_ref_CreateMap() keep their mappings in a hash map.  Reference
+ * Maps created by @c le_ref_CreateIndexedMap() keep them in an array instead, and their Safe
+ * References contain the index of their mapping in the array, plus a generation counter that
+ * changes each time a mapping is deleted.  Looking up a Safe Reference in an indexed map is then
+ * a plain array access, with no hashing, and stale Safe References are still detected (even if
+ * the array entry has been reused since).  Indexed maps are recommended for objects that are
+ * looked up often, such as those referred to by IPC API calls.
+ *
+ * An indexed map can hold at most 65536 Safe References at any one time.  The generation counter
+ * of an array entry wraps around after it has been reused many times (32768 times on 32-bit
+ * systems), so a stale Safe Reference that is kept around for that long could eventually be seen
+ * as valid again.
+ *
+ * Both kinds of Reference Maps are used with the same functions.
+ *
  * @section c_safeRef_multithreading Multithreading
  *
  * This API's functions are reentrant, but not thread safe. If there's the slightest
@@ -215,6 +232,25 @@ le_ref_MapRef_t le_ref_CreateMap
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an indexed Reference Map that can hold mappings from Safe References to pointers.
+ * Indexed maps store their mappings in an array indexed by the Safe References, so lookups don't
+ * need any hashing.
+ *
+ * @return A reference to the Reference Map object.
+ *
+ * @note The map can't hold more than 65536 Safe References at any one time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_ref_MapRef_t le_ref_CreateIndexedMap
+(
+    const char* name,   ///< [in] Name of the map (for diagnostics).
+    size_t      maxRefs ///< [in] Maximum number of Safe References expected to be kept in
+                        ///       this Reference Map at any one time.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a Safe Reference, storing a mapping between that reference and a specified pointer for
@@ -21,6 +21,7 @@
  *
  * Functions to increase and decrease semaphores are:
  *  - @c le_sem_Post()
+ *  - @c le_sem_PostMany()
  *  - @c le_sem_Wait()
  *  - @c le_sem_TryWait()
  *  - @c le_sem_WaitWithTimeOut()
@@ -28,6 +29,10 @@
  * Function to get a semaphore's current value is:
  *  - @c le_sem_GetValue()
  *
+ * Waiting for a semaphore whose value is positive, and posting a semaphore no thread waits for,
+ * don't enter the kernel.  A producer handing several items at once to a pool of consumer threads
+ * should post them with le_sem_PostMany(), which wakes up as many consumers in one operation.
+ *
  * @section delete_semaphore Deleting a Semaphore
  *
  * When you are finished with a semaphore, you must delete it by calling le_sem_Delete().
@@ -161,6 +166,20 @@ void le_sem_Post
     le_sem_Ref_t    semaphorePtr      ///< [IN] Pointer to the semaphore.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post a semaphore several times at once.  This is the same as calling le_sem_Post() count times,
+ * but wakes up to count waiting threads in a single operation.
+ *
+ * @return Nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sem_PostMany
+(
+    le_sem_Ref_t    semaphorePtr,     ///< [IN] Pointer to the semaphore.
+    int32_t         count             ///< [IN] Number of times to post it (must be positive).
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the value of a semaphore.
@@ -0,0 +1,120 @@
+/**
+ * @page c_spinLock Spin Lock API
+ *
+ * @ref le_spinLock.h "API Reference"
+ *
+ * <HR>
+ *
+ * The Spin Lock API provides a lightweight lock for very short critical sections (a few loads
+ * and stores, such as updating a couple of counters or swapping a pointer).  These locks can be
+ * shared by threads within the same process, but can't be shared by threads in different
+ * processes.
+ *
+ * A thread that finds the lock taken first spins for a while, since the holder is expected to
+ * release it within a few instructions.  The number of spins adapts to how long the lock was held
+ * the previous times, and it is bounded: a thread that still doesn't get the lock goes to sleep
+ * in the kernel until the lock is released, so a holder that gets preempted doesn't make the
+ * waiters burn the CPU.
+ *
+ * Unlike @ref c_mutex "mutexes", spin locks are plain structures: they can be embedded in other
+ * objects or defined statically, and need no creating or deleting.  The price is that they have
+ * no diagnostics (they are not visible with the @ref toolsTarget_inspect tool) and no deadlock
+ * detection.  Spin locks are not recursive.  Never call anything that may block (or take a long
+ * time) while holding one; use a mutex instead.
+ *
+ * @code
+ * static le_spinlock_t StatsLock = LE_SPINLOCK_INIT;
+ *
+ * le_spinlock_Lock(&StatsLock);
+ * Stats.count++;
+ * Stats.bytes += size;
+ * le_spinlock_Unlock(&StatsLock);
+ * @endcode
+ *
+ * Spin locks that are allocated dynamically must be initialized with le_spinlock_Init() before
+ * they are used.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_spinLock.h
+ *
+ * Legato @ref c_spinLock include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_SPINLOCK_INCLUDE_GUARD
+#define LEGATO_SPINLOCK_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Spin lock.
+ *
+ * @warning The members of this structure must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t state;      ///< 0 = unlocked, 1 = locked, 2 = locked and maybe waited on.
+    int32_t spinCount;  ///< Average number of spins it took to get the lock.
+}
+le_spinlock_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Static initializer for a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_SPINLOCK_INIT { 0, 0 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Init
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Lock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a spin lock, without spinning.
+ *
+ * @return
+ *  - LE_OK if the lock was taken.
+ *  - LE_WOULD_BLOCK if the lock is held by someone.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spinlock_TryLock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlock a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Unlock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+);
+
+#endif // LEGATO_SPINLOCK_INCLUDE_GUARD
@@ -84,6 +84,23 @@
  * le_thread_Join() fetches the return/exit value of the thread that it joined with.
  *
  *
+ * @section threadReusing Reusing Threads
+ *
+ * Creating a thread and initializing its event loop and timers takes several system calls.  A
+ * component that keeps starting short-lived worker threads can avoid most of that cost by making
+ * them "reusable" with le_thread_SetReusable() before starting them.
+ *
+ * When the main function of a reusable thread returns, its destructors are called and its thread
+ * reference becomes invalid as usual, but its underlying pthread and the file descriptors of its
+ * event loop and timers are "parked" instead of being destroyed.  The next reusable thread
+ * started with the same priority and stack size is run by the parked pthread.  A few threads are
+ * kept parked per process, for up to 30 seconds.
+ *
+ * A reusable thread that calls le_thread_Exit() or is cancelled is destroyed, and not parked.
+ * Reusable threads can't be joinable.  Thread-local data created with the pthread functions is
+ * not reset between the threads run by a pthread.
+ *
+ *
  * @section threadLocalData Thread-Local Data
  *
  * Often, you want data specific to a particular thread.  A classic example
@@ -339,6 +356,22 @@ void le_thread_SetJoinable
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a thread "reusable", meaning that when its main function returns, its underlying pthread
+ * and the file descriptors of its event loop and timers are kept for a while, to run another
+ * reusable thread started later with the same priority and stack size.  By default, threads are
+ * not reusable.  See @ref threadReusing.
+ *
+ * Reusable threads can't be joinable.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_thread_SetReusable
+(
+    le_thread_Ref_t         thread  ///< [IN]
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts a new Legato execution thread.  After creating the thread, you have the opportunity
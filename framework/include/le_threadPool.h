@@ -0,0 +1,226 @@
+/**
+ * @page c_threadPool Thread Pool API
+ *
+ * @ref le_threadPool.h "API Reference"
+ *
+ * <HR>
+ *
+ * The Thread Pool API runs pieces of work ("tasks") on a fixed set of worker threads, so that
+ * components that need to spread CPU-bound work (compressing, hashing, unpacking, number
+ * crunching, etc.) over the available CPUs don't have to create, feed and join threads of their
+ * own.
+ *
+ * @section c_threadPool_create Creating a Thread Pool
+ *
+ * le_threadPool_Create() creates a pool and starts its worker threads.  By default, the pool
+ * gets one worker thread per online CPU.  Pools have names, which are used to name their worker
+ * threads ("<pool name>-<n>").
+ *
+ * The worker threads are Legato threads: tasks can use the Legato APIs that don't need an
+ * Event Loop (memory pools, mutexes, logging, etc.).  They don't run an Event Loop, though, so
+ * tasks can't create timers, FD monitors or IPC sessions.
+ *
+ * le_threadPool_SetCpuAffinity() restricts the pool's worker threads to a set of CPUs, for
+ * example to keep the pool away from a CPU reserved for latency-sensitive work.
+ *
+ * @section c_threadPool_submit Submitting Tasks
+ *
+ * le_threadPool_Submit() queues a task on the pool.  The task function is called in one of the
+ * worker threads, and is given the context pointer passed to le_threadPool_Submit().  If a
+ * completion function is given too, it is queued to the Event Loop of the thread that submitted
+ * the task once the task function has returned, and is called there with the same context
+ * pointer.  So the result of the work can be collected without any locking:
+ *
+ * @code
+ * static void Compress(void* contextPtr)           // Runs in a worker thread.
+ * {
+ *     Job_t* jobPtr = contextPtr;
+ *     jobPtr->outSize = DoCompress(jobPtr->inPtr, jobPtr->inSize, jobPtr->outPtr);
+ * }
+ *
+ * static void CompressDone(void* contextPtr)       // Runs in the submitting thread.
+ * {
+ *     Job_t* jobPtr = contextPtr;
+ *     SendChunk(jobPtr->outPtr, jobPtr->outSize);
+ *     le_mem_Release(jobPtr);
+ * }
+ *
+ * le_threadPool_Submit(PoolRef, Compress, CompressDone, jobPtr);
+ * @endcode
+ *
+ * @note The submitting thread must run its Event Loop for the completion functions to be called.
+ *
+ * Tasks are not run in any particular order.  Each worker thread keeps its own queue of tasks:
+ * tasks submitted by a task go to the queue of the worker thread running it, and an idle worker
+ * thread takes ("steals") tasks from the queues of the others.  So tasks that submit more tasks
+ * keep their data in the caches of their CPU, while the load still spreads over all the workers.
+ *
+ * @section c_threadPool_parallelFor Parallel Loops
+ *
+ * le_threadPool_ParallelFor() calls a function once for each index of a range, spreading the
+ * calls over the worker threads, and returns once all the calls are done.  The calling thread
+ * takes part in the loop, so le_threadPool_ParallelFor() can also be used from a task running in
+ * the same pool.
+ *
+ * @code
+ * static void ScaleRow(size_t row, void* contextPtr)
+ * {
+ *     Image_t* imagePtr = contextPtr;
+ *     ...
+ * }
+ *
+ * le_threadPool_ParallelFor(PoolRef, imagePtr->height, ScaleRow, imagePtr);
+ * @endcode
+ *
+ * The indexes are handed out to the threads in chunks, so the function should do enough work per
+ * index for the spreading to pay off.
+ *
+ * @section c_threadPool_delete Deleting a Thread Pool
+ *
+ * le_threadPool_Delete() waits for all the tasks that were submitted to the pool to run, then
+ * stops its worker threads.  Completion functions that were already queued are still called.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_threadPool.h
+ *
+ * Legato @ref c_threadPool include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_THREADPOOL_INCLUDE_GUARD
+#define LEGATO_THREADPOOL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a thread pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_threadPool* le_threadPool_Ref_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of task functions, called in a worker thread of the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_threadPool_TaskFunc_t)
+(
+    void* contextPtr    ///< [in] Context pointer passed to le_threadPool_Submit().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of task completion functions, called in the thread that submitted the task.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_threadPool_CompletionFunc_t)
+(
+    void* contextPtr    ///< [in] Context pointer passed to le_threadPool_Submit().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of parallel loop bodies.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_threadPool_ForFunc_t)
+(
+    size_t  index,      ///< [in] Index of the loop iteration.
+    void*   contextPtr  ///< [in] Context pointer passed to le_threadPool_ParallelFor().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a thread pool and start its worker threads.
+ *
+ * @return Reference to the thread pool.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_threadPool_Ref_t le_threadPool_Create
+(
+    const char* nameStr,    ///< [in] Name of the pool (will be copied, so can be temporary).
+    size_t      numThreads  ///< [in] Number of worker threads, or 0 for one per online CPU.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for all the tasks submitted to a thread pool, stop its worker threads and delete it.
+ *
+ * @warning Must not be called from one of the pool's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Delete
+(
+    le_threadPool_Ref_t poolRef ///< [in] Thread pool.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restrict the worker threads of a thread pool to a set of CPUs.
+ *
+ * @return
+ *  - LE_OK on success.
+ *  - LE_BAD_PARAMETER if the mask doesn't contain any online CPU.
+ *  - LE_FAULT on any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_threadPool_SetCpuAffinity
+(
+    le_threadPool_Ref_t poolRef,    ///< [in] Thread pool.
+    uint64_t            cpuMask     ///< [in] Bit n set if the workers may run on CPU n.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of worker threads of a thread pool.
+ *
+ * @return The number of worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_threadPool_GetThreadCount
+(
+    le_threadPool_Ref_t poolRef ///< [in] Thread pool.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit a task to a thread pool.
+ *
+ * The task function will be called in one of the pool's worker threads.  If a completion
+ * function is given, it will then be queued to the calling thread's Event Loop.
+ *
+ * @note Terminates the process on failure, so no need to check for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Submit
+(
+    le_threadPool_Ref_t             poolRef,        ///< [in] Thread pool.
+    le_threadPool_TaskFunc_t        taskFunc,       ///< [in] Function to call in a worker.
+    le_threadPool_CompletionFunc_t  completionFunc, ///< [in] Function to call when done, or NULL.
+    void*                           contextPtr      ///< [in] Context passed to both functions.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a function for each index from 0 to count - 1, in parallel on the worker threads of a
+ * thread pool and on the calling thread, and wait for all the calls to be done.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_ParallelFor
+(
+    le_threadPool_Ref_t     poolRef,    ///< [in] Thread pool.
+    size_t                  count,      ///< [in] Number of iterations.
+    le_threadPool_ForFunc_t forFunc,    ///< [in] Function to call for each index.
+    void*                   contextPtr  ///< [in] Context passed to the function.
+);
+
+#endif // LEGATO_THREADPOOL_INCLUDE_GUARD
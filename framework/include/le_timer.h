@@ -22,9 +22,11 @@
  *  - @ref le_timer_SetInterval
  *  - @ref le_timer_SetRepeat
  *  - @ref le_timer_SetContextPtr
+ *  - @ref le_timer_SetTolerance
  *
- * The repeat count defaults to 1, so that the timer is initially a one-shot timer. All the other
- * attributes must be explicitly set.  At a minimum, the interval must be set before the timer can be
+ * The repeat count defaults to 1, so that the timer is initially a one-shot timer, and the
+ * tolerance defaults to 0, so that the timer expires as soon as its interval has elapsed. All the
+ * other attributes must be explicitly set.  At a minimum, the interval must be set before the timer can be
  * used.  Note that these attributes can only be set if the timer is not currently running; otherwise,
  * an error will be returned.
  *
@@ -61,6 +63,20 @@
  * The number of times that a timer has expired can be retrieved by @ref le_timer_GetExpiryCount. This
  * count is independent of whether there is an expiry handler for the timer.
  *
+ * @section timer_tolerance Timer Tolerance
+ *
+ * Every timer expiry normally wakes up the thread that started the timer, and, if the system is
+ * suspended, the system as well.  Timers that do not need to expire at an exact time can be given
+ * a tolerance using @ref le_timer_SetTolerance or @ref le_timer_SetMsTolerance.  A timer may then
+ * expire at any time up to the tolerance after its interval has elapsed, but never before, so that
+ * timers expiring close together can all be handled in a single wakeup.
+ *
+ * For a repeating timer, the tolerance does not accumulate: each expiry is still scheduled one
+ * interval after the previous expiry was due.
+ *
+ * The number of wakeups and timer expiries handled by each thread can be viewed using the
+ * Inspect tool (<c>inspect threads</c>).
+ *
  * @section le_timer_thread Thread Support
  *
  * A timer should only be used by the thread that created it. It's not safe for a thread to use
@@ -89,6 +105,8 @@
  *     - @ref le_timer_SetHandler
  *     - @ref le_timer_SetInterval
  *     - @ref le_timer_SetRepeat
+ *     - @ref le_timer_SetTolerance
+ *     - @ref le_timer_SetMsTolerance
  *     - @ref le_timer_Start
  *     - @ref le_timer_Stop
  *     - @ref le_timer_Restart
@@ -236,6 +254,48 @@ le_result_t le_timer_SetMsInterval
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire.
+ *
+ * Timer will expire at some point between the end of its interval and the end of its interval plus
+ * the tolerance, so that its expiry can be handled in the same wakeup as other timers.  The
+ * default tolerance is 0.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object
+    le_clk_Time_t tolerance      ///< [IN] Timer tolerance
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, using milliseconds.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    uint32_t tolerance           ///< [IN] Timer tolerance in milliseconds.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set how many times the timer will repeat.
@@ -60,6 +60,41 @@
  * To switch between 'cannonical' and 'raw' mode, just call @c le_tty_SetCanonical() and
  * @c le_tty_SetRaw() respectively
  *
+ * @section c_tty_latency Receive latency and batching
+ *
+ * A reader woken up for every few bytes received spends most of its time in wake-ups.  Two
+ * settings trade latency against batching:
+ *
+ * - @c le_tty_SetReadBatching() changes the numChars (VMIN) and timeout (VTIME) of a port already
+ * in raw mode, without reconfiguring or flushing it, so that blocking reads return whole bursts
+ * rather than a byte at a time.
+ * - @c le_tty_SetLowLatency() toggles the serial driver's low latency mode (ASYNC_LOW_LATENCY),
+ * in which received bytes are passed up immediately rather than on the driver's next tick.  Not
+ * all drivers support it.
+ *
+ * @c le_tty_GetReadableBytes() returns the number of bytes waiting to be read, so that a reader
+ * woken up by an fd monitor can size a single read to get all of them.
+ *
+ * @section c_tty_lineReader Reading lines
+ *
+ * Line-oriented data (NMEA sentences, AT responses, ...) can be read through a line reader, which
+ * reads as much as is available at once into a caller-provided buffer and then hands out complete
+ * lines from it, without copying them:
+ *
+ * @code
+ * static char Buffer[1024];
+ * static le_tty_LineReader_t Reader;
+ *
+ * le_tty_InitLineReader(&Reader, fd, Buffer, sizeof(Buffer));
+ * ...
+ * // In the fd monitor handler of the (non-blocking) fd:
+ * char* linePtr;
+ * while (le_tty_ReadLine(&Reader, &linePtr) == LE_OK)
+ * {
+ *     ProcessLine(linePtr);
+ * }
+ * @endcode
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -261,4 +296,108 @@ le_result_t le_tty_SetRaw
                     ///<      The timeout value is given with 1 decimal places.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the number of characters (VMIN) and timeout (VTIME) of read(2) on a serial port in raw
+ * mode (see le_tty_SetRaw()), without changing any other setting or flushing the port.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the values cannot be set
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetReadBatching
+(
+    int fd,         ///< [IN] File Descriptor
+    int numChars,   ///< [IN] Number of bytes returned by read(2) when a read is performed.
+    int timeout     ///< [IN] when a read(2) is performed return after that timeout.
+                    ///<      The timeout value is given with 1 decimal places.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the low latency mode of a serial port's driver.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the device's driver doesn't support it
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetLowLatency
+(
+    int fd,         ///< [IN] File Descriptor
+    bool enable     ///< [IN] true to enable low latency mode, false to disable it.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes received on a serial port and waiting to be read.
+ *
+ * @return
+ *  - The number of bytes.
+ *  - -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_tty_GetReadableBytes
+(
+    int fd          ///< [IN] File Descriptor
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffered line reader.  Initialize it with le_tty_InitLineReader(); the members are private.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int     fd;             ///< File descriptor read from.
+    char*   bufferPtr;      ///< Buffer holding the data read and not yet returned.
+    size_t  bufferSize;     ///< Size of the buffer.
+    size_t  start;          ///< Offset in the buffer of the first byte not yet returned.
+    size_t  end;            ///< Offset in the buffer of the end of the data read.
+}
+le_tty_LineReader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a line reader.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_tty_InitLineReader
+(
+    le_tty_LineReader_t* readerPtr, ///< [IN] Line reader.
+    int fd,                         ///< [IN] File descriptor to read from.
+    char* bufferPtr,                ///< [IN] Buffer for the line reader to use.  Lines longer than
+                                    ///<      the buffer are returned in pieces.
+    size_t bufferSize               ///< [IN] Size of the buffer (at least 2 bytes).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next line from a line reader, reading from its file descriptor if it doesn't already
+ * have a complete line.  Reads don't block if the file descriptor is non-blocking.
+ *
+ * The line is returned without its line ending ("
+" or "
+"), NUL-terminated, in the line
+ * reader's buffer: it's valid until the next call.  Empty lines are returned too.
+ *
+ * @return
+ *  - LE_OK if a line was returned.
+ *  - LE_OVERFLOW if a line too long for the buffer was returned, without the rest of the line,
+ *    which will be returned by the next calls.
+ *  - LE_WOULD_BLOCK if there is no complete line yet, and nothing more to read.
+ *  - LE_CLOSED if the end of the file was reached.  The data left without a line ending is
+ *    returned as the last line first.
+ *  - LE_FAULT if a read failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_ReadLine
+(
+    le_tty_LineReader_t* readerPtr, ///< [IN] Line reader.
+    char** linePtrPtr               ///< [OUT] Line.
+);
+
 #endif // LEGATO_TTY_H_INCLUDE_GUARD
@@ -56,6 +56,14 @@
  * The @c le_uft8_CopyUpToSubStr() function is like le_utf8_Copy() except it copies only up to, but
  * not including, a specified string.
  *
+ * @c le_utf8_CopyValidated() is like le_utf8_Copy(), but also fully checks the format of the
+ * characters it copies, and reports LE_FORMAT_ERROR if they are not valid UTF-8.  It replaces a
+ * le_utf8_IsFormatCorrect() check followed by a le_utf8_Copy() with a single pass over the
+ * string, which is handy for strings received from other processes.
+ *
+ * Runs of ASCII characters are checked many bytes at a time by all these functions, so
+ * mostly-ASCII strings are processed much faster than one character at a time.
+ *
  *  @section utf8_trunc Truncation
  *
  * Because UTF-8 is a variable length encoding, the number of characters in a string is not
@@ -239,6 +247,35 @@ le_result_t le_utf8_Copy
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies the string in srcStr to the start of destStr, checking that it is correctly formatted
+ * UTF-8 as it goes.  This is le_utf8_Copy() and le_utf8_IsFormatCorrect() in a single pass over
+ * the source.
+ *
+ * Copies and truncates like le_utf8_Copy(), except that the characters that are copied are fully
+ * checked (lead and continuation bytes), and that a format error is reported as such.
+ *
+ * If destStr and srcStr overlap the behaviour of this function is undefined.
+ *
+ * @return
+ *      - LE_OK if srcStr was completely copied to the destStr.
+ *      - LE_OVERFLOW if srcStr was truncated when it was copied to destStr.
+ *      - LE_FORMAT_ERROR if srcStr is not correctly formatted UTF-8 (destStr is then set to an
+ *        empty string and the number of bytes copied to 0).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_utf8_CopyValidated
+(
+    char* destStr,          ///< [IN] Destination where the srcStr is to be copied.
+    const char* srcStr,     ///< [IN] UTF-8 source string.
+    const size_t destSize,  ///< [IN] Size of the destination buffer in bytes.
+    size_t* numBytesPtr     ///< [OUT] Number of bytes copied not including the NULL-terminator.
+                            ///        Parameter can be set to NULL if the number of bytes copied is
+                            ///        not needed.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Appends srcStr to destStr by copying characters from srcStr to the end of destStr.  The srcStr
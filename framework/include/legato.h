@@ -23,21 +23,26 @@
  * @subpage c_flock <br>
  * @subpage c_fs <br>
  * @subpage c_hashmap <br>
+ * @subpage c_heap <br>
  * @subpage c_hex <br>
  * @subpage c_json <br>
  * @subpage c_logging <br>
  * @subpage c_messaging <br>
  * @subpage c_mutex <br>
+ * @subpage c_orderedMap <br>
  * @subpage c_pack <br>
  * @subpage c_path <br>
  * @subpage c_pathIter <br>
  * @subpage c_print <br>
+ * @subpage c_rwLock <br>
  * @subpage c_safeRef <br>
  * @subpage c_semaphore <br>
  * @subpage c_signals <br>
  * @subpage c_singlyLinkedList <br>
+ * @subpage c_spinLock <br>
  * @subpage c_clock <br>
  * @subpage c_threading <br>
+ * @subpage c_threadPool <br>
  * @subpage c_timer <br>
  * @subpage c_test <br>
  * @subpage c_utf8 <br>
@@ -195,14 +200,20 @@ extern "C" {
 #include "le_basics.h"
 #include "le_doublyLinkedList.h"
 #include "le_singlyLinkedList.h"
+#include "le_heap.h"
+#include "le_orderedMap.h"
 #include "le_utf8.h"
 #include "le_log.h"
 #include "le_mem.h"
+#include "le_arena.h"
 #include "le_mutex.h"
+#include "le_rwLock.h"
+#include "le_spinLock.h"
 #include "le_clock.h"
 #include "le_semaphore.h"
 #include "le_safeRef.h"
 #include "le_thread.h"
+#include "le_threadPool.h"
 #include "le_eventLoop.h"
 #include "le_fdMonitor.h"
 #include "le_hashmap.h"
@@ -11,6 +11,7 @@
 package io.legato;
 
 import java.io.FileDescriptor;
+import java.nio.ByteBuffer;
 
 
 
@@ -86,27 +87,5 @@ class LegatoJni
     public static native FileDescriptor GetMessageFd(long messageRef);
     public static native void SetMessageFd(long messageRef, FileDescriptor fd);
 
-    public static native boolean GetMessageBool(long messageRef, int location);
-    public static native void SetMessageBool(long messageRef, int location, boolean newValue);
-
-    public static native byte GetMessageByte(long messageRef, int location);
-    public static native void SetMessageByte(long messageRef, int location, byte value);
-
-    public static native short GetMessageShort(long messageRef, int location);
-    public static native void SetMessageShort(long messageRef, int location, short value);
-
-    public static native int GetMessageInt(long messageRef, int location);
-    public static native void SetMessageInt(long messageRef, int location, int value);
-
-    public static native long GetMessageLong(long messageRef, int location);
-    public static native void SetMessageLong(long messageRef, int location, long value);
-
-    public static native double GetMessageDouble(long messageRef, int location);
-    public static native void SetMessageDouble(long messageRef, int location, double value);
-
-    public static native MessageBuffer.LocationValue GetMessageString(long messageRef, int location);
-    public static native int SetMessageString(long messageRef, int location, String value, int maxByteSize);
-
-    public static native long GetMessageLongRef(long messageRef, int location);
-    public static native void SetMessageLongRef(long messageRef, int location, long longRef);
+    public static native ByteBuffer GetMessagePayload(long messageRef);
 }
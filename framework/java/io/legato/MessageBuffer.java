@@ -12,6 +12,9 @@ package io.legato;
 
 import java.io.FileDescriptor;
 import java.math.BigInteger;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -19,6 +22,9 @@ import java.math.BigInteger;
  *
  *  The get and set methods act as a streaming operation.  The buffer maintains an internal pointer
  *  that is updated as values are read and written.
+ *
+ *  Values are read and written in place, through a direct ByteBuffer over the native message
+ *  payload, so packing and unpacking a message doesn't cross into native code for every value.
  */
 //--------------------------------------------------------------------------------------------------
 public class MessageBuffer implements AutoCloseable
@@ -29,43 +35,10 @@ public class MessageBuffer implements AutoCloseable
     private Message hostMessage;
 
     /**
-     *  The current buffer insertion location.  Reads and writes start from and update this
-     *  location.
-     */
-    private int location;
-
-    //----------------------------------------------------------------------------------------------
-    /**
-     *  Package internal class used to keep track of the amount of bytes variable length data
-     *  structures require when being written into the data buffer.
+     *  The message's payload.  Its position is the current buffer insertion location; reads and
+     *  writes start from and update this location.
      */
-    //----------------------------------------------------------------------------------------------
-    class LocationValue
-    {
-        /**
-         *  The message object that owns this buffer.
-         */
-        public final int bytesUsed;
-
-        /**
-         *  The message object that owns this buffer.
-         */
-        public final Object value;
-
-        //------------------------------------------------------------------------------------------
-        /**
-         *  Construct a new location value.
-         *
-         *  @param newBytesUsed  The number of bytes needed to store the object.
-         *  @param newValue      The object itself.
-         */
-        //------------------------------------------------------------------------------------------
-        LocationValue(int newBytesUsed, Object newValue)
-        {
-            bytesUsed = newBytesUsed;
-            value = newValue;
-        }
-    }
+    private ByteBuffer payload;
 
     //----------------------------------------------------------------------------------------------
     /**
@@ -77,7 +50,7 @@ public class MessageBuffer implements AutoCloseable
     MessageBuffer(Message message)
     {
         hostMessage = message;
-        location = 0;
+        payload = LegatoJni.GetMessagePayload(message.getRef()).order(ByteOrder.nativeOrder());
     }
 
     //----------------------------------------------------------------------------------------------
@@ -89,7 +62,7 @@ public class MessageBuffer implements AutoCloseable
     public void close()
     {
         hostMessage = null;
-        location = 0;
+        payload = null;
     }
 
     //----------------------------------------------------------------------------------------------
@@ -99,7 +72,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void resetPosition()
     {
-        location = 0;
+        payload.position(0);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -111,10 +84,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public boolean readBool()
     {
-        boolean result = LegatoJni.GetMessageBool(hostMessage.getRef(), location);
-        location += 1;
-
-        return result;
+        return payload.get() != 0;
     }
 
     //----------------------------------------------------------------------------------------------
@@ -126,8 +96,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeBool(boolean newValue)
     {
-        LegatoJni.SetMessageBool(hostMessage.getRef(), location, newValue);
-        location += 1;
+        payload.put(newValue ? (byte)1 : (byte)0);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -163,10 +132,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public byte readByte()
     {
-        byte result = LegatoJni.GetMessageByte(hostMessage.getRef(), location);
-        location += 1;
-
-        return result;
+        return payload.get();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -178,8 +144,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeByte(byte newValue)
     {
-        LegatoJni.SetMessageByte(hostMessage.getRef(), location, newValue);
-        location += 1;
+        payload.put(newValue);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -191,10 +156,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public short readShort()
     {
-        short result = LegatoJni.GetMessageShort(hostMessage.getRef(), location);
-        location += 2;
-
-        return result;
+        return payload.getShort();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -206,8 +168,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeShort(Short newValue)
     {
-        LegatoJni.SetMessageShort(hostMessage.getRef(), location, newValue);
-        location += 2;
+        payload.putShort(newValue);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -219,10 +180,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public int readInt()
     {
-        int result = LegatoJni.GetMessageInt(hostMessage.getRef(), location);
-        location += 4;
-
-        return result;
+        return payload.getInt();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -234,8 +192,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeInt(int newValue)
     {
-        LegatoJni.SetMessageInt(hostMessage.getRef(), location, newValue);
-        location += 4;
+        payload.putInt(newValue);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -247,10 +204,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public long readLong()
     {
-        long result = LegatoJni.GetMessageLong(hostMessage.getRef(), location);
-        location += 8;
-
-        return result;
+        return payload.getLong();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -262,8 +216,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeLong(long newValue)
     {
-        LegatoJni.SetMessageLong(hostMessage.getRef(), location, newValue);
-        location += 8;
+        payload.putLong(newValue);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -275,10 +228,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public double readDouble()
     {
-        double result = LegatoJni.GetMessageDouble(hostMessage.getRef(), location);
-        location += 8;
-
-        return result;
+        return payload.getDouble();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -290,23 +240,23 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeDouble(double newValue)
     {
-        LegatoJni.SetMessageDouble(hostMessage.getRef(), location, newValue);
-        location += 8;
+        payload.putDouble(newValue);
     }
 
     //----------------------------------------------------------------------------------------------
     /**
-     *  Read a NULL terminated utf-8 encoded string from the buffer at it's current location.
+     *  Read a utf-8 encoded string, preceded by its size, from the buffer at it's current location.
      *
      *  @return A string value from the current buffer location.
      */
     //----------------------------------------------------------------------------------------------
     public String readString()
     {
-        LocationValue result = LegatoJni.GetMessageString(hostMessage.getRef(), location);
+        // Strings are packed as their size in bytes, followed by the bytes themselves.
+        byte[] strBytes = new byte[payload.getInt()];
+        payload.get(strBytes);
 
-        location += result.bytesUsed;
-        return (String)result.value;
+        return new String(strBytes, StandardCharsets.UTF_8);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -318,7 +268,10 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public void writeString(String strValue, int maxSize)
     {
-        location += LegatoJni.SetMessageString(hostMessage.getRef(), location, strValue, maxSize);
+        byte[] strBytes = strValue.getBytes(StandardCharsets.UTF_8);
+
+        payload.putInt(strBytes.length);
+        payload.put(strBytes);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -330,10 +283,7 @@ public class MessageBuffer implements AutoCloseable
     //----------------------------------------------------------------------------------------------
     public long readLongRef()
     {
-        long result = (long)LegatoJni.GetMessageInt(hostMessage.getRef(), location);
-        location += 4;
-
-        return result;
+        return (long)payload.getInt();
     }
 
     //----------------------------------------------------------------------------------------------
@@ -353,8 +303,7 @@ public class MessageBuffer implements AutoCloseable
             throw new IllegalArgumentException("Illegal reference");
         }
 
-        LegatoJni.SetMessageInt(hostMessage.getRef(), location, (int)longRef);
-        location += 4;
+        payload.putInt((int)longRef);
     }
 
     /**
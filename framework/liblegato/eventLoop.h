@@ -38,6 +38,37 @@ typedef enum
 event_LoopState_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets in the Event Loop's latency histograms.  Bucket 0 counts the events that took
+ * less than 100 microseconds, and each following bucket counts those that took up to ten times as
+ * long as the one before, except the last, which counts all the rest (100 milliseconds or more).
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_LATENCY_BUCKETS   5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event Loop profiling statistics for a thread.  Only kept if profiling is enabled for the
+ * process (see event_Init()), and only ever written by the thread itself.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t    numReports;                         ///< Number of Event Reports processed
+                                                    ///< and fd events handled.
+    uint64_t    maxRunUs;                           ///< Longest handler run time (microseconds).
+    uint32_t    numSlowHandlers;                    ///< Number of handler runs that took longer
+                                                    ///< than the slow handler threshold.
+    uint32_t    queueWait[EVENT_LATENCY_BUCKETS];   ///< Histogram of the time Event Reports
+                                                    ///< spent in the queue (fd events are
+                                                    ///< handled without being queued).
+    uint32_t    handlerRun[EVENT_LATENCY_BUCKETS];  ///< Histogram of handler run times.
+}
+event_Stats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event Loop's per-thread record.
@@ -51,9 +82,19 @@ event_LoopState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_sls_List_t       eventQueue;         ///< The thread's event queue.
+    le_sls_List_t       eventQueue;         ///< Reports taken from the incoming queue, waiting
+                                            ///< to be processed.  Only the thread itself
+                                            ///< accesses this.
+    le_sls_Link_t*      incomingQueuePtr;   ///< Lock-free stack of Reports queued to the thread
+                                            ///< (by any thread), most recent first.
+    bool                isWakeupPending;    ///< true if the eventfd has been written since the
+                                            ///< thread last read it.
     le_dls_List_t       handlerList;        ///< List of handlers registered with this thread.
     le_dls_List_t       fdMonitorList;      ///< List of FD Monitors created by this thread.
+    le_dls_List_t       epollUpdateList;    ///< FD Monitors whose monitored events have changed
+                                            ///< since they were last passed on to epoll.
+    bool                isBatchingEpollUpdates; ///< true if changes to the monitored events are
+                                            ///< only passed on to epoll by the Event Loop.
     int                 epollFd;            ///< epoll(7) file descriptor.
     int                 eventQueueFd;       ///< eventfd(2) file descriptor for the Event Queue.
     void*               contextPtr;         ///< Context pointer from last Handler called.
@@ -61,6 +102,14 @@ typedef struct
     uint64_t            liveEventCount;     ///< Number of events ready for dequeing.  Ensures
                                             ///< balance between queued events and monitored fds
                                             ///< in le_event_ServiceLoop().
+    void*               handlerFuncPtr;     ///< Function handling the Event Report being
+                                            ///< processed, as reported in slow handler warnings.
+    event_Stats_t       stats;              ///< Profiling statistics.
+    bool                isCachingLoopTime;  ///< true if the Event Loop is being run or serviced,
+                                            ///< so that loopTime is invalidated on each wake-up.
+    bool                isLoopTimeValid;    ///< true if loopTime has been read since the Event
+                                            ///< Loop last woke up.
+    le_clk_Time_t       loopTime;           ///< Relative time cached for le_event_GetLoopTime().
 }
 event_PerThreadRec_t;
 
@@ -95,6 +144,21 @@ void event_InitThread
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Event Loop for a given thread, reusing the file descriptors that another thread's
+ * Event Loop handed over when it was parked (see event_ParkThread()).
+ *
+ * This is called instead of event_InitThread(), with the same restrictions.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_InitReusedThread
+(
+    int epollFd,        ///< [in] epoll(7) file descriptor, with eventQueueFd added to it.
+    int eventQueueFd    ///< [in] eventfd(2) file descriptor for the Event Queue, reset to zero.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Defer the component initializer for later execution.
@@ -127,6 +191,20 @@ void event_DestructThread
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destruct the Event Loop for a given thread like event_DestructThread(), but hand its file
+ * descriptors over instead of closing them, so that another thread's Event Loop can be
+ * initialized with them by event_InitReusedThread().  Only the eventfd is left in the epoll set.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_ParkThread
+(
+    int* epollFdPtr,        ///< [out] epoll(7) file descriptor.
+    int* eventQueueFdPtr    ///< [out] eventfd(2) file descriptor for the Event Queue.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the context pointer for the currently running thread.
@@ -140,6 +218,19 @@ void event_SetCurrentContextPtr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the function that handles the Event Report currently being processed by the calling thread,
+ * for when the function the Event Loop called passes the event on to another one (e.g., the FD
+ * Monitor's dispatcher).  This is the function named when the handler is found to be slow.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_SetCurrentHandlerFunc
+(
+    void* funcPtr       ///< [in] Handler function.
+);
+
+
 
 
 #endif // LEGATO_SRC_EVENTLOOP_H_INCLUDE_GUARD
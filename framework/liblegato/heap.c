@@ -0,0 +1,311 @@
+//--------------------------------------------------------------------------------------------------
+/** @file heap.c
+ *
+ * Intrusive pairing heap (see le_heap.h).
+ *
+ * The heap is a tree whose root is its lowest link.  Each link's children are kept in a doubly
+ * linked list of siblings, the first child pointing back to its parent.  Inserting melds the new
+ * link with the root, and removing the root melds its children in pairs, then melds the pairs
+ * together from right to left (the "two-pass" method, which gives O(log n) amortized removals).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Meld two trees of the heap, making the root of the higher one the first child of the other.
+ *
+ * @return
+ *      Root of the melded tree, which has no siblings.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_heap_Link_t* Meld
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] The heap.
+    le_heap_Link_t* aPtr,               ///< [IN] Root of the first tree.
+    le_heap_Link_t* bPtr                ///< [IN] Root of the second tree.
+)
+{
+    if (heapPtr->lessThanFunc(bPtr, aPtr))
+    {
+        le_heap_Link_t* tmpPtr = aPtr;
+
+        aPtr = bPtr;
+        bPtr = tmpPtr;
+    }
+
+    bPtr->prevPtr = aPtr;
+    bPtr->nextPtr = aPtr->childPtr;
+    if (aPtr->childPtr != NULL)
+    {
+        aPtr->childPtr->prevPtr = bPtr;
+    }
+    aPtr->childPtr = bPtr;
+
+    aPtr->nextPtr = NULL;
+    aPtr->prevPtr = NULL;
+
+    return aPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Meld a list of sibling trees into a single tree.
+ *
+ * @return
+ *      Root of the melded tree, or NULL if the list is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_heap_Link_t* MergePairs
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] The heap.
+    le_heap_Link_t* firstPtr            ///< [IN] First sibling, or NULL.
+)
+{
+    // First pass, from left to right: meld the siblings in pairs, stacking the pairs so that the
+    // last one ends up on top.
+    le_heap_Link_t* pairsPtr = NULL;
+
+    while (firstPtr != NULL)
+    {
+        le_heap_Link_t* secondPtr = firstPtr->nextPtr;
+        le_heap_Link_t* restPtr = NULL;
+
+        if (secondPtr != NULL)
+        {
+            restPtr = secondPtr->nextPtr;
+            firstPtr = Meld(heapPtr, firstPtr, secondPtr);
+        }
+
+        firstPtr->nextPtr = pairsPtr;
+        pairsPtr = firstPtr;
+        firstPtr = restPtr;
+    }
+
+    // Second pass, from right to left: meld each pair into the tree built so far.
+    le_heap_Link_t* rootPtr = NULL;
+
+    while (pairsPtr != NULL)
+    {
+        le_heap_Link_t* nextPtr = pairsPtr->nextPtr;
+
+        if (rootPtr == NULL)
+        {
+            rootPtr = pairsPtr;
+            rootPtr->nextPtr = NULL;
+            rootPtr->prevPtr = NULL;
+        }
+        else
+        {
+            rootPtr = Meld(heapPtr, rootPtr, pairsPtr);
+        }
+
+        pairsPtr = nextPtr;
+    }
+
+    return rootPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a link to the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Insert
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] Heap to add to.
+    le_heap_Link_t* newLinkPtr          ///< [IN] New link to add.
+)
+{
+    *newLinkPtr = LE_HEAP_LINK_INIT;
+
+    if (heapPtr->rootPtr == NULL)
+    {
+        heapPtr->rootPtr = newLinkPtr;
+    }
+    else
+    {
+        heapPtr->rootPtr = Meld(heapPtr, heapPtr->rootPtr, newLinkPtr);
+    }
+
+    heapPtr->count++;
+    heapPtr->changeCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the top (lowest) link of the heap without removing it.
+ *
+ * @return
+ *      The top link.
+ *      NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_heap_Link_t* le_heap_Peek
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+)
+{
+    return heapPtr->rootPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes and returns the top (lowest) link of the heap.
+ *
+ * @return
+ *      The removed link.
+ *      NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_heap_Link_t* le_heap_Pop
+(
+    le_heap_Heap_t* heapPtr             ///< [IN] Heap to remove from.
+)
+{
+    le_heap_Link_t* rootPtr = heapPtr->rootPtr;
+
+    if (rootPtr == NULL)
+    {
+        return NULL;
+    }
+
+    heapPtr->rootPtr = MergePairs(heapPtr, rootPtr->childPtr);
+    *rootPtr = LE_HEAP_LINK_INIT;
+
+    heapPtr->count--;
+    heapPtr->changeCount++;
+
+    return rootPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the specified link from the heap.  User must ensure that the link is in the heap
+ * otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Remove
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] Heap to remove from.
+    le_heap_Link_t* linkToRemovePtr     ///< [IN] Link to remove.
+)
+{
+    if (linkToRemovePtr == heapPtr->rootPtr)
+    {
+        le_heap_Pop(heapPtr);
+        return;
+    }
+
+    // Cut the link's tree out of its parent's children.  The link is the first child if its
+    // previous pointer is its parent's child pointer.
+    le_heap_Link_t* prevPtr = linkToRemovePtr->prevPtr;
+
+    if (prevPtr->childPtr == linkToRemovePtr)
+    {
+        prevPtr->childPtr = linkToRemovePtr->nextPtr;
+    }
+    else
+    {
+        prevPtr->nextPtr = linkToRemovePtr->nextPtr;
+    }
+
+    if (linkToRemovePtr->nextPtr != NULL)
+    {
+        linkToRemovePtr->nextPtr->prevPtr = prevPtr;
+    }
+
+    // Then put its children back into the heap.
+    le_heap_Link_t* subTreePtr = MergePairs(heapPtr, linkToRemovePtr->childPtr);
+
+    if (subTreePtr != NULL)
+    {
+        heapPtr->rootPtr = Meld(heapPtr, heapPtr->rootPtr, subTreePtr);
+    }
+
+    *linkToRemovePtr = LE_HEAP_LINK_INIT;
+
+    heapPtr->count--;
+    heapPtr->changeCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a link to its place in the heap after the value of its node has changed.  User must
+ * ensure that the link is in the heap otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Update
+(
+    le_heap_Heap_t* heapPtr,            ///< [IN] The heap.
+    le_heap_Link_t* linkPtr             ///< [IN] Link of the changed node.
+)
+{
+    // The value may have gone either way, so the link's children may now be lower than it.
+    le_heap_Remove(heapPtr, linkPtr);
+    le_heap_Insert(heapPtr, linkPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a link is in the heap.
+ *
+ * @return
+ *      true if the link is in the heap.
+ *      false if the link is not in the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_heap_IsInHeap
+(
+    const le_heap_Heap_t* heapPtr,      ///< [IN] The heap.
+    const le_heap_Link_t* linkPtr       ///< [IN] The link, which is in this heap or in none.
+)
+{
+    // Only the root has no previous pointer.
+    return ((linkPtr == heapPtr->rootPtr) || (linkPtr->prevPtr != NULL));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of links in the heap.
+ *
+ * @return
+ *      The number of links.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_heap_NumLinks
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+)
+{
+    return heapPtr->count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the change counter of the heap, incremented on every change made to it.
+ *
+ * @return
+ *      The change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_heap_GetChangeCount
+(
+    const le_heap_Heap_t* heapPtr       ///< [IN] The heap.
+)
+{
+    return heapPtr->changeCount;
+}
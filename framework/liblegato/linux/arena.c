@@ -0,0 +1,270 @@
+/** @file arena.c
+ *
+ * Implementation of the @ref c_arena.
+ *
+ * An arena holds a list of memory pool blocks: the chunks that small objects are carved out of,
+ * and the blocks of the objects that are too big for that.  Only the most recently added chunk
+ * is allocated from; whatever is left at the end of a chunk when an object doesn't fit is wasted,
+ * which is why objects bigger than a quarter of a chunk get blocks of their own (from a size-class
+ * allocator).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "arena.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the chunks that small objects are carved out of, including the chunk header.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_BYTES             2048
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of free chunks kept in each thread's cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_CACHE_SIZE        4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Alignment of the objects allocated from an arena.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OBJ_ALIGN               8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk, or block holding a single big object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;         ///< Link in the arena's list of chunks.
+    uint8_t data[];             ///< Objects.
+}
+Chunk_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of objects in a chunk.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_DATA_BYTES        (CHUNK_BYTES - sizeof(Chunk_t))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Arena.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_arena
+{
+    le_sls_List_t chunkList;    ///< Chunks and big object blocks.
+    uint8_t* nextPtr;           ///< Next free byte in the current chunk (NULL if none).
+    size_t freeBytes;           ///< Number of free bytes left in the current chunk.
+}
+Arena_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of arenas.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ArenaPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of chunks.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ChunkPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocator of the blocks of big objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_SizeClassAllocatorRef_t BigObjAllocator;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Arena module.
+ *
+ * Must be called exactly once at start-up before any other Arena functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void arena_Init
+(
+    void
+)
+{
+    ArenaPool = le_mem_CreatePool("Arenas", sizeof(Arena_t));
+
+    ChunkPool = le_mem_CreatePool("ArenaChunks", CHUNK_BYTES);
+    le_mem_SetThreadCacheSize(ChunkPool, CHUNK_CACHE_SIZE);
+
+    BigObjAllocator = le_mem_CreateSizeClassAllocator("ArenaObjs",
+                                                      sizeof(Chunk_t) + LE_ARENA_MAX_OBJ_BYTES);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty arena.
+ *
+ * @return Reference to the arena.
+ *
+ * @note On failure, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_arena_Ref_t le_arena_Create
+(
+    void
+)
+{
+    Arena_t* arenaPtr = le_mem_ForceAlloc(ArenaPool);
+
+    arenaPtr->chunkList = LE_SLS_LIST_INIT;
+    arenaPtr->nextPtr = NULL;
+    arenaPtr->freeBytes = 0;
+
+    return arenaPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate an object from an arena.
+ *
+ * @return Pointer to the object, which is aligned to 8 bytes and is not cleared.
+ *
+ * @note On failure (including objects bigger than LE_ARENA_MAX_OBJ_BYTES), the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_Alloc
+(
+    le_arena_Ref_t arena,       ///< [IN] The arena.
+    size_t size                 ///< [IN] Size of the object, in bytes.
+)
+{
+    LE_ASSERT(arena != NULL);
+
+    // Skip to the next aligned address in the current chunk.
+    size_t padding = (-(uintptr_t)arena->nextPtr) & (OBJ_ALIGN - 1);
+
+    if ((arena->nextPtr != NULL) && ((padding + size) <= arena->freeBytes))
+    {
+        void* objPtr = arena->nextPtr + padding;
+
+        arena->nextPtr += padding + size;
+        arena->freeBytes -= padding + size;
+
+        return objPtr;
+    }
+
+    LE_FATAL_IF(size > LE_ARENA_MAX_OBJ_BYTES,
+                "Object of %zu bytes is too big for an arena (max %d).",
+                size,
+                LE_ARENA_MAX_OBJ_BYTES);
+
+    // Blocks are only aligned to the size of a pointer, so leave room to align the object.
+    Chunk_t* chunkPtr;
+    size_t alignedSize = size + OBJ_ALIGN - sizeof(void*);
+
+    if (alignedSize > CHUNK_DATA_BYTES / 4)
+    {
+        // Big objects get a block of their own, and the current chunk stays in use.
+        chunkPtr = le_mem_SizeClassAlloc(BigObjAllocator, sizeof(Chunk_t) + alignedSize);
+        chunkPtr->link = LE_SLS_LINK_INIT;
+        le_sls_Stack(&arena->chunkList, &chunkPtr->link);
+
+        return chunkPtr->data + ((-(uintptr_t)chunkPtr->data) & (OBJ_ALIGN - 1));
+    }
+
+    // Start a new chunk.
+    chunkPtr = le_mem_ForceAlloc(ChunkPool);
+    chunkPtr->link = LE_SLS_LINK_INIT;
+    le_sls_Stack(&arena->chunkList, &chunkPtr->link);
+
+    padding = (-(uintptr_t)chunkPtr->data) & (OBJ_ALIGN - 1);
+
+    arena->nextPtr = chunkPtr->data + padding + size;
+    arena->freeBytes = CHUNK_DATA_BYTES - padding - size;
+
+    return chunkPtr->data + padding;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a null-terminated string into an arena.
+ *
+ * @return Pointer to the copy.
+ *
+ * @note On failure (including strings longer than LE_ARENA_MAX_OBJ_BYTES), the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_arena_StrDup
+(
+    le_arena_Ref_t arena,       ///< [IN] The arena.
+    const char* strPtr          ///< [IN] String to copy.
+)
+{
+    size_t size = strlen(strPtr) + 1;
+    char* copyPtr = le_arena_Alloc(arena, size);
+
+    memcpy(copyPtr, strPtr, size);
+
+    return copyPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release all of the objects allocated from an arena, leaving it empty and ready to be reused.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Reset
+(
+    le_arena_Ref_t arena        ///< [IN] The arena.
+)
+{
+    LE_ASSERT(arena != NULL);
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&arena->chunkList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, Chunk_t, link));
+    }
+
+    arena->nextPtr = NULL;
+    arena->freeBytes = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an arena, releasing all of the objects allocated from it.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Delete
+(
+    le_arena_Ref_t arena        ///< [IN] The arena.
+)
+{
+    le_arena_Reset(arena);
+    le_mem_Release(arena);
+}
@@ -0,0 +1,27 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file arena.h
+ *
+ * Interfaces exported by the Arena module to other modules inside the Legato framework
+ * implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef ARENA_H_INCLUDE_GUARD
+#define ARENA_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Arena module.
+ *
+ * Must be called exactly once at start-up before any other Arena functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void arena_Init
+(
+    void
+);
+
+#endif // ARENA_H_INCLUDE_GUARD
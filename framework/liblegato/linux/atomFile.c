@@ -57,6 +57,58 @@ static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mute
 #define UNLOCK  LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest group commit window, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_GROUP_COMMIT_MS       1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A group of commits sharing a single file system sync.  Lives on the stack of its leader, the
+ * commit that started it, which waits for all the other members to pick up the result before
+ * returning.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    dev_t dev;                            ///< File system being synced.
+    bool isDone;                          ///< true once the sync has been done.
+    le_result_t result;                   ///< Result of the sync.
+    size_t waiterCount;                   ///< Number of members waiting for the result.
+}
+SyncGroup_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Group commit window, in microseconds.  0 if group commit is disabled (the default).  Set from the
+ * LE_ATOMFILE_GROUP_COMMIT_MS environment variable.
+ */
+//--------------------------------------------------------------------------------------------------
+static useconds_t GroupCommitWindowUs;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Group that commits can currently join, or NULL if there is none.  Protected by GroupMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static SyncGroup_t* OpenGroupPtr;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex and condition variable used to coordinate the members of sync groups.  Separate from Mutex
+ * so that waiting for a group never holds up opening or closing other files.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t GroupMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t GroupCond = PTHREAD_COND_INITIALIZER;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure that can store the details of file opened for atomic access. Used to store original
@@ -721,6 +773,113 @@ static int Create
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush a file to disk as part of a sync group, sharing a single sync of the whole file system with
+ * the other commits that start within the group commit window.  The sync covers the file's
+ * directory as well.
+ *
+ * @return
+ *      LE_OK if successful
+ *      LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GroupSync
+(
+    int fd,                             ///< [IN] File to flush.
+    const char* filePath                ///< [IN] Path of the file, for error messages.
+)
+{
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) == -1)
+    {
+        LE_CRIT("Failed to stat file '%s' (%m).", filePath);
+        return LE_FAULT;
+    }
+
+    le_result_t result;
+
+    LE_ASSERT(pthread_mutex_lock(&GroupMutex) == 0);
+
+    if ((OpenGroupPtr != NULL) && (OpenGroupPtr->dev == fileStat.st_dev))
+    {
+        // Join the open group and wait for its leader to do the sync.
+        SyncGroup_t* groupPtr = OpenGroupPtr;
+
+        groupPtr->waiterCount++;
+
+        while (!groupPtr->isDone)
+        {
+            LE_ASSERT(pthread_cond_wait(&GroupCond, &GroupMutex) == 0);
+        }
+
+        result = groupPtr->result;
+
+        // The last member to leave lets the leader return.
+        if (--groupPtr->waiterCount == 0)
+        {
+            LE_ASSERT(pthread_cond_broadcast(&GroupCond) == 0);
+        }
+
+        LE_ASSERT(pthread_mutex_unlock(&GroupMutex) == 0);
+
+        return result;
+    }
+
+    if (OpenGroupPtr != NULL)
+    {
+        // A group is collecting commits for another file system.  Don't wait for it.
+        LE_ASSERT(pthread_mutex_unlock(&GroupMutex) == 0);
+
+        if (fsync(fd) == -1)
+        {
+            LE_CRIT("Failed to do fsync on file '%s' (%m).", filePath);
+            return LE_FAULT;
+        }
+
+        return LE_OK;
+    }
+
+    // Start a new group, give the other commits the window to join it, then sync for everyone.
+    SyncGroup_t group = { .dev = fileStat.st_dev, .isDone = false, .waiterCount = 0 };
+
+    OpenGroupPtr = &group;
+    LE_ASSERT(pthread_mutex_unlock(&GroupMutex) == 0);
+
+    usleep(GroupCommitWindowUs);
+
+    LE_ASSERT(pthread_mutex_lock(&GroupMutex) == 0);
+    OpenGroupPtr = NULL;
+    LE_ASSERT(pthread_mutex_unlock(&GroupMutex) == 0);
+
+    if (syncfs(fd) == -1)
+    {
+        LE_CRIT("Failed to sync file system of file '%s' (%m).", filePath);
+        result = LE_FAULT;
+    }
+    else
+    {
+        result = LE_OK;
+    }
+
+    LE_ASSERT(pthread_mutex_lock(&GroupMutex) == 0);
+
+    group.result = result;
+    group.isDone = true;
+    LE_ASSERT(pthread_cond_broadcast(&GroupCond) == 0);
+
+    while (group.waiterCount > 0)
+    {
+        LE_ASSERT(pthread_cond_wait(&GroupCond, &GroupMutex) == 0);
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&GroupMutex) == 0);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sync files to disk
@@ -736,6 +895,23 @@ static le_result_t SyncFile
     const char* tempFilePath            ///< [IN] Path to temporary file.
 )
 {
+    if (GroupCommitWindowUs > 0)
+    {
+        // Syncing the file system covers both the temporary file and its directory.
+        if (GroupSync(accessPtr->tempFd, tempFilePath) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        if (rename(tempFilePath, accessPtr->filePath))
+        {
+            LE_CRIT("Failed rename '%s' to '%s' (%m).", tempFilePath, accessPtr->filePath);
+            return LE_FAULT;
+        }
+
+        return LE_OK;
+    }
+
     // Do a fsync to ensure write to temporary file goes to storage device.
      if (fsync(accessPtr->tempFd) == -1)
      {
@@ -1710,4 +1886,22 @@ void atomFile_Init
     // Initialize pools
     FileAccessPool = le_mem_CreatePool("AtomicFileAccessPool",
                                         sizeof(FileAccess_t));
+
+    const char* envStrPtr = getenv("LE_ATOMFILE_GROUP_COMMIT_MS");
+
+    if (envStrPtr != NULL)
+    {
+        char* endPtr;
+        unsigned long windowMs = strtoul(envStrPtr, &endPtr, 10);
+
+        if ((endPtr == envStrPtr) || (*endPtr != '\0') || (windowMs > MAX_GROUP_COMMIT_MS))
+        {
+            LE_WARN("Invalid LE_ATOMFILE_GROUP_COMMIT_MS value '%s'; group commit disabled.",
+                    envStrPtr);
+        }
+        else
+        {
+            GroupCommitWindowUs = windowMs * 1000;
+        }
+    }
 }
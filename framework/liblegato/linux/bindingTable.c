@@ -0,0 +1,381 @@
+//--------------------------------------------------------------------------------------------------
+/** @file bindingTable.c
+ *
+ * Reading of a system's IPC binding table (see bindingTable.h).
+ *
+ * The whole table is checked when it is loaded, including the order of its bindings, so that
+ * they can then be read and searched without any more bounds checking.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bindingTable.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include <endian.h>
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of a binding table, and version of its format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BINDING_TABLE_MAGIC     "LEBT"
+#define BINDING_TABLE_VERSION   1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the header (magic number, version, number of bindings and size of the string area).
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_SIZE             (sizeof(BINDING_TABLE_MAGIC) - 1 + 3 * sizeof(uint32_t))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of strings of a binding, and size of a binding in the table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STRS_PER_BINDING        5
+#define BINDING_SIZE            (STRS_PER_BINDING * sizeof(uint32_t))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loaded binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct bindingTable_Ref
+{
+    void*           mapPtr;         ///< Mapping of the table file.
+    size_t          size;           ///< Size of the table file.
+    size_t          count;          ///< Number of bindings.
+    const uint8_t*  bindingsPtr;    ///< First binding.
+    const char*     stringsPtr;     ///< String area.
+}
+BindingTable_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of binding tables.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BindingTablePool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a 32-bit integer of a binding table.
+ *
+ * @return
+ *      The integer.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReadUint32
+(
+    const uint8_t* posPtr           ///< [IN] Position of the integer.
+)
+{
+    uint32_t value;
+
+    memcpy(&value, posPtr, sizeof(value));
+
+    return le32toh(value);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a string of a binding.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the string is out of the string area, empty or too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckStr
+(
+    uint32_t offset,                ///< [IN] Offset of the string in the string area.
+    const char* stringsPtr,         ///< [IN] String area.
+    uint32_t stringsSize,           ///< [IN] Size of the string area (its last byte is a null).
+    bool canBeEmpty,                ///< [IN] Whether the string can be empty.
+    size_t maxBytes                 ///< [IN] Maximum size of the string, with its null-terminator.
+)
+{
+    if (offset >= stringsSize)
+    {
+        return LE_FAULT;
+    }
+
+    size_t len = strlen(stringsPtr + offset);
+
+    if ( ((len == 0) && !canBeEmpty) || (len >= maxBytes) )
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare a binding of a binding table to a client user's interface.
+ *
+ * @return
+ *      Less than, equal to or greater than 0 if the binding sorts before, with or after the
+ *      interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareBinding
+(
+    const bindingTable_Binding_t* bindingPtr,   ///< [IN] Binding.
+    const char* clientUserPtr,                  ///< [IN] Client's user name.
+    const char* clientIfPtr                     ///< [IN] Client's interface name.
+)
+{
+    int result = strcmp(bindingPtr->clientUserPtr, clientUserPtr);
+
+    if (result == 0)
+    {
+        result = strcmp(bindingPtr->clientIfPtr, clientIfPtr);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load and check a binding table.
+ *
+ * @return
+ *      Reference to the binding table, or NULL if there is none or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+bindingTable_Ref_t bindingTable_Load
+(
+    const char* pathPtr             ///< [IN] Path of the binding table file.
+)
+{
+    int fd = open(pathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        LE_DEBUG("No binding table '%s' (%m).", pathPtr);
+        return NULL;
+    }
+
+    struct stat fileStat;
+    void* mapPtr = MAP_FAILED;
+
+    if ( (fstat(fd, &fileStat) == 0) && (fileStat.st_size > 0) )
+    {
+        mapPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    fd_Close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Could not map binding table '%s' (%m).", pathPtr);
+        return NULL;
+    }
+
+    const uint8_t* posPtr = mapPtr;
+    size_t size = fileStat.st_size;
+
+    if ( (size < HEADER_SIZE) ||
+         (memcmp(posPtr, BINDING_TABLE_MAGIC, sizeof(BINDING_TABLE_MAGIC) - 1) != 0) )
+    {
+        goto invalid;
+    }
+    posPtr += sizeof(BINDING_TABLE_MAGIC) - 1;
+
+    uint32_t version = ReadUint32(posPtr);
+    uint32_t count = ReadUint32(posPtr + sizeof(uint32_t));
+    uint32_t stringsSize = ReadUint32(posPtr + 2 * sizeof(uint32_t));
+    posPtr += 3 * sizeof(uint32_t);
+
+    // The string area follows the bindings and ends the file, with a null as its last byte so that
+    // no string can run past it.
+    if ( (version != BINDING_TABLE_VERSION) ||
+         (count > (size - HEADER_SIZE) / BINDING_SIZE) ||
+         (stringsSize == 0) ||
+         (stringsSize != size - HEADER_SIZE - (size_t)count * BINDING_SIZE) ||
+         (((const char*)mapPtr)[size - 1] != '\0') )
+    {
+        goto invalid;
+    }
+
+    if (BindingTablePool == NULL)
+    {
+        BindingTablePool = le_mem_CreatePool("BindingTables", sizeof(BindingTable_t));
+    }
+
+    BindingTable_t* tablePtr = le_mem_ForceAlloc(BindingTablePool);
+
+    tablePtr->mapPtr = mapPtr;
+    tablePtr->size = size;
+    tablePtr->count = count;
+    tablePtr->bindingsPtr = posPtr;
+    tablePtr->stringsPtr = (const char*)(posPtr + (size_t)count * BINDING_SIZE);
+
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t* bindingPosPtr = tablePtr->bindingsPtr + i * BINDING_SIZE;
+        const char* stringsPtr = tablePtr->stringsPtr;
+
+        if ( (CheckStr(ReadUint32(bindingPosPtr),
+                       stringsPtr, stringsSize, false, LIMIT_MAX_USER_NAME_BYTES) != LE_OK) ||
+             (CheckStr(ReadUint32(bindingPosPtr + sizeof(uint32_t)),
+                       stringsPtr, stringsSize, false, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+                != LE_OK) ||
+             (CheckStr(ReadUint32(bindingPosPtr + 2 * sizeof(uint32_t)),
+                       stringsPtr, stringsSize, false, LIMIT_MAX_USER_NAME_BYTES) != LE_OK) ||
+             (CheckStr(ReadUint32(bindingPosPtr + 3 * sizeof(uint32_t)),
+                       stringsPtr, stringsSize, false, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+                != LE_OK) ||
+             (CheckStr(ReadUint32(bindingPosPtr + 4 * sizeof(uint32_t)),
+                       stringsPtr, stringsSize, true, LIMIT_MAX_APP_NAME_BYTES) != LE_OK) )
+        {
+            le_mem_Release(tablePtr);
+            goto invalid;
+        }
+
+        // Bindings must be sorted for bindingTable_Find() to work.  Several unsandboxed apps can
+        // bind the same interface name, as they all run as root, so equal keys are allowed.
+        if (i > 0)
+        {
+            bindingTable_Binding_t prev;
+            bindingTable_Binding_t curr;
+
+            bindingTable_Get(tablePtr, i - 1, &prev);
+            bindingTable_Get(tablePtr, i, &curr);
+
+            if (CompareBinding(&prev, curr.clientUserPtr, curr.clientIfPtr) > 0)
+            {
+                le_mem_Release(tablePtr);
+                goto invalid;
+            }
+        }
+    }
+
+    return tablePtr;
+
+invalid:
+
+    LE_ERROR("Binding table '%s' is invalid.", pathPtr);
+    munmap(mapPtr, size);
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unload a binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+void bindingTable_Unload
+(
+    bindingTable_Ref_t tableRef     ///< [IN] Binding table.
+)
+{
+    munmap(tableRef->mapPtr, tableRef->size);
+    le_mem_Release(tableRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bindings in a binding table.
+ *
+ * @return
+ *      The number of bindings.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t bindingTable_GetCount
+(
+    bindingTable_Ref_t tableRef     ///< [IN] Binding table.
+)
+{
+    return tableRef->count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a binding of a binding table by its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void bindingTable_Get
+(
+    bindingTable_Ref_t tableRef,        ///< [IN] Binding table.
+    size_t index,                       ///< [IN] Index of the binding (< bindingTable_GetCount()).
+    bindingTable_Binding_t* bindingPtr  ///< [OUT] The binding.
+)
+{
+    LE_ASSERT(index < tableRef->count);
+
+    const uint8_t* posPtr = tableRef->bindingsPtr + index * BINDING_SIZE;
+    const char* stringsPtr = tableRef->stringsPtr;
+
+    bindingPtr->clientUserPtr = stringsPtr + ReadUint32(posPtr);
+    bindingPtr->clientIfPtr = stringsPtr + ReadUint32(posPtr + sizeof(uint32_t));
+    bindingPtr->serverUserPtr = stringsPtr + ReadUint32(posPtr + 2 * sizeof(uint32_t));
+    bindingPtr->serverIfPtr = stringsPtr + ReadUint32(posPtr + 3 * sizeof(uint32_t));
+    bindingPtr->clientAppPtr = stringsPtr + ReadUint32(posPtr + 4 * sizeof(uint32_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the binding of a client user's interface in a binding table.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the table doesn't have a binding for this interface.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bindingTable_Find
+(
+    bindingTable_Ref_t tableRef,        ///< [IN] Binding table.
+    const char* clientUserPtr,          ///< [IN] Client's user name.
+    const char* clientIfPtr,            ///< [IN] Client's interface name.
+    bindingTable_Binding_t* bindingPtr  ///< [OUT] The binding.
+)
+{
+    size_t low = 0;
+    size_t high = tableRef->count;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        bindingTable_Get(tableRef, mid, bindingPtr);
+
+        int result = CompareBinding(bindingPtr, clientUserPtr, clientIfPtr);
+
+        if (result == 0)
+        {
+            return LE_OK;
+        }
+        else if (result < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
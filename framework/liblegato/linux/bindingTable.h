@@ -0,0 +1,136 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file bindingTable.h
+ *
+ * API for reading a system's IPC binding table.
+ *
+ * The binding table is a compact binary copy of all the IPC bindings of the system's apps and
+ * non-app users, generated by mksys along with the system's configuration and installed next to
+ * it.  The Service Directory memory-maps it at start-up and creates all its bindings in one pass,
+ * instead of receiving them one by one from the "sdir load" tool.  "sdir load" then only sends
+ * the differences between the binding configuration and the table (e.g., for apps installed or
+ * removed individually since the system was installed).
+ *
+ * The bindings are sorted by client user name, then client interface name, so that a binding can
+ * be found by binary search.  The format of the table is (all integers are 32-bit little-endian):
+ *
+ * @verbatim
+   magic "LEBT", version, number of bindings, size of the string area
+   for each binding (offsets into the string area):
+       client user name, client interface name, server user name, server interface name,
+       client app name (empty string for a non-app user)
+   string area (null-terminated strings)
+   @endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_BINDING_TABLE_H_INCLUDE_GUARD
+#define LEGATO_BINDING_TABLE_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the current system's binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BINDING_TABLE_FILE_PATH     "/legato/systems/current/config/bindings.bin"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a loaded binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct bindingTable_Ref* bindingTable_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A binding of the table.  The strings point into the table, and remain valid until it is
+ * unloaded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* clientUserPtr;      ///< Client's user name.
+    const char* clientIfPtr;        ///< Client's interface name.
+    const char* serverUserPtr;      ///< Server's user name.
+    const char* serverIfPtr;        ///< Server's interface (service) name.
+    const char* clientAppPtr;       ///< Client's app name, or empty string for a non-app user.
+}
+bindingTable_Binding_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load and check a binding table.
+ *
+ * @return
+ *      Reference to the binding table, or NULL if there is none or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+bindingTable_Ref_t bindingTable_Load
+(
+    const char* pathPtr             ///< [IN] Path of the binding table file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unload a binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+void bindingTable_Unload
+(
+    bindingTable_Ref_t tableRef     ///< [IN] Binding table.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bindings in a binding table.
+ *
+ * @return
+ *      The number of bindings.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t bindingTable_GetCount
+(
+    bindingTable_Ref_t tableRef     ///< [IN] Binding table.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a binding of a binding table by its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void bindingTable_Get
+(
+    bindingTable_Ref_t tableRef,        ///< [IN] Binding table.
+    size_t index,                       ///< [IN] Index of the binding (< bindingTable_GetCount()).
+    bindingTable_Binding_t* bindingPtr  ///< [OUT] The binding.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the binding of a client user's interface in a binding table.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the table doesn't have a binding for this interface.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bindingTable_Find
+(
+    bindingTable_Ref_t tableRef,        ///< [IN] Binding table.
+    const char* clientUserPtr,          ///< [IN] Client's user name.
+    const char* clientIfPtr,            ///< [IN] Client's interface name.
+    bindingTable_Binding_t* bindingPtr  ///< [OUT] The binding.
+);
+
+
+#endif // LEGATO_BINDING_TABLE_H_INCLUDE_GUARD
@@ -3,6 +3,17 @@
  *
  * API for creating and managing cgroups.
  *
+ * Both the legacy cgroup hierarchies (one per sub-system, mounted by cgrp_Init()) and the cgroup v2
+ * unified hierarchy (if that is what is mounted at /sys/fs/cgroup) are supported.  With the unified
+ * hierarchy, the cgroups of all the sub-systems are the same directory, and the files used to
+ * control them have different names and formats.
+ *
+ * The file descriptors of the cgroup files are cached per cgroup, so that each operation is a
+ * single read or write system call instead of a path look-up, an open, a read or write and a
+ * close.  The cached file descriptors are closed when the cgroup is deleted.  If a cgroup was
+ * removed behind our back, accesses to its cached file descriptors fail with ENODEV, in which case
+ * the cache entry is dropped and the file is opened again.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -13,6 +24,8 @@
 #include "fileSystem.h"
 #include "killProc.h"
 
+#include <sys/vfs.h>
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -33,42 +46,99 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Cgroup tasks file.  The tasks file list the PIDs of all threads in a cgroup.
+ * File system magic number of the cgroup v2 unified hierarchy.
  */
 //--------------------------------------------------------------------------------------------------
-#define TASKS_FILENAME              "tasks"
+#ifndef CGROUP2_SUPER_MAGIC
+#define CGROUP2_SUPER_MAGIC         0x63677270
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Cgroup procs file.  The procs file list the PIDs of all processes in a cgroup.
+ * Cgroup files used by this module.
  */
 //--------------------------------------------------------------------------------------------------
-#define PROCS_FILENAME              "cgroup.procs"
+typedef enum
+{
+    FILE_PROCS = 0,             ///< PIDs of all processes in the cgroup.
+    FILE_TASKS,                 ///< TIDs of all threads in the cgroup.
+    FILE_CPU_SHARE,             ///< Cpu share (or weight).
+    FILE_MEM_LIMIT,             ///< Memory limit.
+    FILE_MEM_USAGE,             ///< Memory usage.
+    FILE_MEM_MAX_USAGE,         ///< Maximum memory usage.
+    FILE_FREEZE,                ///< Freezer control (and state, for legacy hierarchies).
+    FILE_EVENTS,                ///< Populated and frozen states (unified hierarchy only).
+    FILE_CPU_USAGE,             ///< Cpu time consumed (in "cpu.stat", for the unified hierarchy).
+    NUM_FILES                   ///< Number of files.  Must be the last item in this enum.
+}
+CgrpFile_t;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Cpu shares file.
+ * Names of the cgroup files in the legacy hierarchies.
  */
 //--------------------------------------------------------------------------------------------------
-#define CPU_SHARES_FILENAME         "cpu.shares"
+static const char* V1FileName[NUM_FILES] =
+{
+    "cgroup.procs",
+    "tasks",
+    "cpu.shares",
+    "memory.limit_in_bytes",
+    "memory.memsw.usage_in_bytes",
+    "memory.memsw.max_usage_in_bytes",
+    "freezer.state",
+    NULL,
+    "cpuacct.usage"
+};
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Memory limit file.
+ * Names of the cgroup files in the unified hierarchy.
  */
 //--------------------------------------------------------------------------------------------------
-#define MEM_LIMIT_FILENAME          "memory.limit_in_bytes"
+static const char* V2FileName[NUM_FILES] =
+{
+    "cgroup.procs",
+    "cgroup.threads",
+    "cpu.weight",
+    "memory.max",
+    "memory.current",
+    "memory.peak",
+    "cgroup.freeze",
+    "cgroup.events",
+    "cpu.stat"
+};
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Freeze state file.
+ * Access modes used to open the cgroup files.
  */
 //--------------------------------------------------------------------------------------------------
-#define FREEZE_STATE_FILENAME       "freezer.state"
+static const int FileAccessMode[NUM_FILES] =
+{
+    O_RDWR,
+    O_RDONLY,
+    O_WRONLY,
+    O_RDWR,
+    O_RDONLY,
+    O_RDONLY,
+    O_RDWR,
+    O_RDONLY,
+    O_RDONLY
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Controllers to enable for the children of a cgroup in the unified hierarchy.  (The freezer is
+ * built into every cgroup there.)
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* V2Controllers[] = {"+cpu", "+memory"};
 
 
 //--------------------------------------------------------------------------------------------------
@@ -87,6 +157,270 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 #define MAX_FREEZE_STATE_BYTES      20
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes in the contents of a cgroup.events file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_EVENTS_BYTES            64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes in the contents of a cgroup v2 cpu.stat file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CPU_STAT_BYTES          512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes read at a time from the procs and tasks files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ID_READ_BUFFER_BYTES        512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of cgroups per sub-system, used to size the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CGROUP_CACHE_SIZE           31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached state of a cgroup.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char        name[LIMIT_MAX_PATH_BYTES]; ///< Name of the cgroup (the cache key).
+    int         fd[NUM_FILES];              ///< Cached file descriptors (-1 if not opened yet).
+    uint32_t    subSysMask;                 ///< Sub-systems the cgroup was created for (unified
+                                            ///  hierarchy only).
+    pid_t       lastAddedPid;               ///< Last process added (unified hierarchy only).
+}
+Cgroup_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of cached cgroups, and the cache itself: one map per sub-system, from cgroup name to
+ * Cgroup_t.  (With the unified hierarchy, only the first map is used.)
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CgroupPool = NULL;
+static le_hashmap_Ref_t CgroupMap[CGRP_NUM_SUBSYSTEMS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reader of the IDs listed in a procs or tasks file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int     fd;                             ///< File being read.
+    size_t  len;                            ///< Number of bytes in the buffer.
+    size_t  pos;                            ///< Position of the next byte to parse.
+    char    buf[ID_READ_BUFFER_BYTES];      ///< Bytes read from the file.
+}
+IdReader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether the cgroup v2 unified hierarchy is mounted at the cgroup root.
+ *
+ * @return
+ *      true if the unified hierarchy is used.
+ *      false if the legacy hierarchies are used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsUnified
+(
+    void
+)
+{
+    static int isUnified = -1;
+
+    if (isUnified < 0)
+    {
+        struct statfs fsInfo;
+
+        isUnified = (   (statfs(ROOT_PATH, &fsInfo) == 0)
+                     && (fsInfo.f_type == CGROUP2_SUPER_MAGIC) );
+    }
+
+    return isUnified;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the name of a cgroup file.
+ *
+ * @return
+ *      The name of the file, or NULL if the file doesn't exist in the hierarchy used.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* FileName
+(
+    CgrpFile_t file                 ///< [IN] The file.
+)
+{
+    return IsUnified() ? V2FileName[file] : V1FileName[file];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the path to a cgroup or to one of its files.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildPath
+(
+    char* pathPtr,                  ///< [OUT] Buffer to store the path in.
+    size_t pathSize,                ///< [IN] Size of the buffer.
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    const char* fileNamePtr         ///< [IN] Name of the file, or NULL for the cgroup itself.
+)
+{
+    LE_ASSERT(le_utf8_Copy(pathPtr, ROOT_PATH, pathSize, NULL) == LE_OK);
+
+    if (!IsUnified())
+    {
+        LE_ASSERT(le_path_Concat("/", pathPtr, pathSize, SubSysName[subsystem], (char*)NULL)
+                  == LE_OK);
+    }
+
+    LE_ASSERT(le_path_Concat("/", pathPtr, pathSize, cgroupNamePtr, fileNamePtr, (char*)NULL)
+              == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the cache map of a sub-system, creating the cache on first use.
+ *
+ * @return
+ *      The map.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t GetCgroupMap
+(
+    cgrp_SubSys_t subsystem         ///< [IN] Sub-system.
+)
+{
+    if (CgroupPool == NULL)
+    {
+        CgroupPool = le_mem_CreatePool("Cgroups", sizeof(Cgroup_t));
+
+        cgrp_SubSys_t subSys = 0;
+        for (; subSys < CGRP_NUM_SUBSYSTEMS; subSys++)
+        {
+            CgroupMap[subSys] = le_hashmap_Create(SubSysName[subSys],
+                                                  CGROUP_CACHE_SIZE,
+                                                  le_hashmap_HashString,
+                                                  le_hashmap_EqualsString);
+        }
+    }
+
+    return CgroupMap[IsUnified() ? 0 : subsystem];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a cgroup in the cache.
+ *
+ * @return
+ *      The cached cgroup, or NULL if it isn't cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static Cgroup_t* FindCgroup
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
+)
+{
+    return le_hashmap_Get(GetCgroupMap(subsystem), cgroupNamePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a cgroup from the cache, adding it if it isn't cached yet.
+ *
+ * @return
+ *      The cached cgroup.
+ */
+//--------------------------------------------------------------------------------------------------
+static Cgroup_t* GetCgroup
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
+)
+{
+    Cgroup_t* cgroupPtr = FindCgroup(subsystem, cgroupNamePtr);
+
+    if (cgroupPtr == NULL)
+    {
+        cgroupPtr = le_mem_ForceAlloc(CgroupPool);
+
+        LE_FATAL_IF(le_utf8_Copy(cgroupPtr->name, cgroupNamePtr, sizeof(cgroupPtr->name), NULL)
+                    != LE_OK, "Cgroup name '%s' is too long.", cgroupNamePtr);
+
+        CgrpFile_t file = 0;
+        for (; file < NUM_FILES; file++)
+        {
+            cgroupPtr->fd[file] = -1;
+        }
+
+        cgroupPtr->subSysMask = 0;
+        cgroupPtr->lastAddedPid = -1;
+
+        le_hashmap_Put(GetCgroupMap(subsystem), cgroupPtr->name, cgroupPtr);
+    }
+
+    return cgroupPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a cgroup from the cache, closing its cached file descriptors.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropCgroup
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
+)
+{
+    Cgroup_t* cgroupPtr = le_hashmap_Remove(GetCgroupMap(subsystem), cgroupNamePtr);
+
+    if (cgroupPtr == NULL)
+    {
+        return;
+    }
+
+    CgrpFile_t file = 0;
+    for (; file < NUM_FILES; file++)
+    {
+        if (cgroupPtr->fd[file] >= 0)
+        {
+            fd_Close(cgroupPtr->fd[file]);
+        }
+    }
+
+    le_mem_Release(cgroupPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if all cgroup subsystems are mounted.
@@ -147,6 +481,58 @@ static void MountSubSys
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables the cpu and memory controllers for the children of a cgroup in the unified hierarchy.
+ *
+ * @note Failures are only logged: the cgroups still work, without the missing limits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EnableV2Controllers
+(
+    const char* cgroupNamePtr       ///< [IN] Name of the parent cgroup ("" for the root).
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
+    LE_ASSERT(le_path_Concat("/", path, sizeof(path), cgroupNamePtr, "cgroup.subtree_control",
+                             (char*)NULL) == LE_OK);
+
+    int fd;
+
+    do
+    {
+        fd = open(path, O_WRONLY | O_CLOEXEC);
+    }
+    while ((fd < 0) && (errno == EINTR));
+
+    if (fd < 0)
+    {
+        LE_WARN("Could not open file '%s'.  %m.", path);
+        return;
+    }
+
+    // Enable the controllers one at a time, so that a missing one doesn't prevent the others.
+    size_t i;
+    for (i = 0; i < NUM_ARRAY_MEMBERS(V2Controllers); i++)
+    {
+        ssize_t numBytesWritten;
+
+        do
+        {
+            numBytesWritten = write(fd, V2Controllers[i], strlen(V2Controllers[i]));
+        }
+        while ((numBytesWritten == -1) && (errno == EINTR));
+
+        if (numBytesWritten < 0)
+        {
+            LE_WARN("Could not write '%s' to '%s'.  %m.", V2Controllers[i], path);
+        }
+    }
+
+    fd_Close(fd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes cgroups for the system.  Sets up a hierarchy for each supported subsystem.
@@ -162,6 +548,14 @@ void cgrp_Init
     void
 )
 {
+    // If the system already uses the unified hierarchy, use it as it is.
+    if (IsUnified())
+    {
+        LE_INFO("Using the cgroup v2 unified hierarchy.");
+        EnableV2Controllers("");
+        return;
+    }
+
     // Setup the cgroup root directory if it does not already exist.
     if (!fs_IsMounted(ROOT_NAME, ROOT_PATH))
     {
@@ -182,227 +576,460 @@ void cgrp_Init
             LE_FATAL_IF(mount(ROOT_NAME, ROOT_PATH, "tmpfs", 0, NULL) != 0,
                             "Could not mount cgroup root file system.  %m.");
 
-            MountSubSys();
-        }
+            MountSubSys();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file descriptor of a cgroup file, opening the file if it isn't cached yet.
+ *
+ * @return
+ *      The file descriptor of the cgroup file if successful.
+ *      A negative value if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetCgrpFileFd
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    CgrpFile_t file                 ///< [IN] The file.
+)
+{
+    Cgroup_t* cgroupPtr = GetCgroup(subsystem, cgroupNamePtr);
+
+    if (cgroupPtr->fd[file] >= 0)
+    {
+        return cgroupPtr->fd[file];
+    }
+
+    // Create the path to the cgroup file.
+    char path[LIMIT_MAX_PATH_BYTES];
+    BuildPath(path, sizeof(path), subsystem, cgroupNamePtr, FileName(file));
+
+    // Open the cgroup file.  It must not be inherited by the processes we start.
+    int fd;
+
+    do
+    {
+        fd = open(path, FileAccessMode[file] | O_CLOEXEC);
+    }
+    while ((fd < 0) && (errno == EINTR));
+
+    if (fd < 0)
+    {
+        LE_ERROR("Could not open file '%s'.  %m.", path);
+
+        // Don't keep cache entries for cgroups that may not even exist.
+        if (cgroupPtr->subSysMask == 0)
+        {
+            DropCgroup(subsystem, cgroupNamePtr);
+        }
+
+        return fd;
+    }
+
+    cgroupPtr->fd[file] = fd;
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a string to a cgroup file.  Overwrites what is currently in the file.
+ *
+ * @note  Certain file types cannot accept certain types of data, and the write may fail with a
+ *        specific errno value.  If the write fails with errno ESRCH this function will return
+ *        LE_OUT_OF_RANGE.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if an attempt was made to write a value that the file cannot accept.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteToFile
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    CgrpFile_t file,                ///< [IN] File to write to.
+    const char* string              ///< [IN] String to write into the file.
+)
+{
+    // Get the length of the string.
+    size_t len = strlen(string);
+    LE_ASSERT(len > 0);
+
+    // Write the string to the file.  If the cgroup was removed and re-created since the file was
+    // opened, try again once with a freshly opened file.
+    ssize_t numBytesWritten = 0;
+    int retries = 1;
+
+    for (;;)
+    {
+        int fd = GetCgrpFileFd(subsystem, cgroupNamePtr, file);
+
+        if (fd < 0)
+        {
+            return LE_FAULT;
+        }
+
+        do
+        {
+            numBytesWritten = write(fd, string, len);
+        }
+        while ((numBytesWritten == -1) && (errno == EINTR));
+
+        if ((numBytesWritten == -1) && (errno == ENODEV) && (retries-- > 0))
+        {
+            DropCgroup(subsystem, cgroupNamePtr);
+            continue;
+        }
+
+        break;
+    }
+
+    if (numBytesWritten != len)
+    {
+        int savedErrno = errno;
+
+        LE_ERROR("Could not write '%s' to file '%s' in cgroup '%s'.  %m.",
+                 string, FileName(file), cgroupNamePtr);
+
+        if (savedErrno == ESRCH)
+        {
+            return LE_OUT_OF_RANGE;
+        }
+        else
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a value from a cgroup file.  The value is read as a string and so a NULL-terminator is
+ * always appended to the end of the read value in bufPtr.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the provided buffer is too small.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetValue
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    CgrpFile_t file,                ///< [IN] File to read from.
+    char* bufPtr,                   ///< [OUT] Buffer to store the value in.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    // Read the value from the start of the file.
+    ssize_t numBytesRead;
+    int retries = 1;
+
+    for (;;)
+    {
+        int fd = GetCgrpFileFd(subsystem, cgroupNamePtr, file);
+
+        if (fd < 0)
+        {
+            return LE_FAULT;
+        }
+
+        do
+        {
+            numBytesRead = pread(fd, bufPtr, bufSize, 0);
+        }
+        while ( (numBytesRead == -1) && (errno == EINTR) );
+
+        if ((numBytesRead == -1) && (errno == ENODEV) && (retries-- > 0))
+        {
+            DropCgroup(subsystem, cgroupNamePtr);
+            continue;
+        }
+
+        break;
+    }
+
+    // Check if the read value is valid.
+    if (numBytesRead == -1)
+    {
+        LE_ERROR("Could not read file '%s' in cgroup '%s'.  %m.", FileName(file), cgroupNamePtr);
+        return LE_FAULT;
+    }
+    else if (numBytesRead == bufSize)
+    {
+        // The value in the file is larger than the provided buffer.  Truncate the buffer.
+        bufPtr[bufSize-1] = '\0';
+        return LE_OVERFLOW;
+    }
+
+    // Null-terminate the string.
+    bufPtr[numBytesRead] = '\0';
+
+    // Remove trailing newline characters.
+    while ((numBytesRead > 0) && (bufPtr[numBytesRead - 1] == '\n'))
+    {
+        numBytesRead--;
+        bufPtr[numBytesRead] = '\0';
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an integer value from a cgroup file.
+ *
+ * @return
+ *      The value if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t GetIntValue
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    CgrpFile_t file                 ///< [IN] File to read from.
+)
+{
+    char buffer[32] = {0};
+
+    if (GetValue(subsystem, cgroupNamePtr, file, buffer, sizeof(buffer)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    errno = 0;
+    ssize_t result = strtol(buffer, NULL, 10);
+    if ((errno == ERANGE) || (errno == EINVAL))
+    {
+        return LE_FAULT;
     }
+
+    return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Opens a cgroup file.
+ * Finds the value of a "key value" line in the contents of a cgroup v2 flat keyed file
+ * (cgroup.events, cpu.stat, etc.)
  *
  * @return
- *      The file descriptor of the cgroup's tasks file if successful.
- *      A negative value if there was an error.
+ *      Pointer to the value, or NULL if the key was not found.
  */
 //--------------------------------------------------------------------------------------------------
-static int OpenCgrpFile
+static const char* FindKeyedValue
 (
-    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
-    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
-    const char* fileNamePtr,        ///< [IN] Name of the file.
-    int accessMode                  ///< [IN] Either O_RDONLY, O_WRONLY, or O_RDWR.
-
+    const char* contentsPtr,        ///< [IN] Contents of the file.
+    const char* keyPtr              ///< [IN] Key to look up.
 )
 {
-    // Create the path to the cgroup file.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             fileNamePtr, (char*)NULL) == LE_OK);
+    size_t keyLen = strlen(keyPtr);
+    const char* linePtr = contentsPtr;
 
-    // Open the cgroup file.
-    int fd;
-
-    do
+    while (linePtr != NULL)
     {
-        fd = open(path, accessMode);
-    }
-    while ((fd < 0) && (errno == EINTR));
+        if ((strncmp(linePtr, keyPtr, keyLen) == 0) && (linePtr[keyLen] == ' '))
+        {
+            return linePtr + keyLen + 1;
+        }
 
-    if (fd < 0)
-    {
-        LE_ERROR("Could not open file '%s'.  %m.", path);
+        linePtr = strchr(linePtr, '\n');
+        if (linePtr != NULL)
+        {
+            linePtr++;
+        }
     }
 
-    return fd;
+    return NULL;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes a string to a cgroup file.  Overwrites what is currently in the file.
- *
- * @note  Certain file types cannot accept certain types of data, and the write may fail with a
- *        specific errno value.  If the write fails with errno ESRCH this function will return
- *        LE_OUT_OF_RANGE.
+ * Looks up a "key value" line of a cgroup v2 cgroup.events file.
  *
  * @return
- *      LE_OK if successful.
- *      LE_OUT_OF_RANGE if an attempt was made to write a value that the file cannot accept.
- *      LE_FAULT if there was some other error.
+ *      The value if successful.
+ *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteToFile
+static int GetEventsValue
 (
-    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
     const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
-    const char* fileNamePtr,        ///< [IN] File to write to.
-    const char* string              ///< [IN] String to write into the file.
+    const char* keyPtr              ///< [IN] Key to look up ("populated" or "frozen").
 )
 {
-    // Get the length of the string.
-    size_t len = strlen(string);
-    LE_ASSERT(len > 0);
+    char events[MAX_EVENTS_BYTES];
 
-    // Open the file.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, fileNamePtr, O_WRONLY);
+    if (GetValue(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FILE_EVENTS, events, sizeof(events)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
 
-    if (fd < 0)
+    const char* valuePtr = FindKeyedValue(events, keyPtr);
+
+    if (valuePtr == NULL)
     {
+        LE_ERROR("No '%s' key in the events of cgroup '%s'.", keyPtr, cgroupNamePtr);
         return LE_FAULT;
     }
 
-    // Write the string to the file.
-    le_result_t result = LE_OK;
-    ssize_t numBytesWritten = 0;
+    return atoi(valuePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills the buffer of an ID reader.
+ *
+ * @return
+ *      LE_OK if some bytes were read.
+ *      LE_OUT_OF_RANGE if there is nothing left to read.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FillIdReader
+(
+    IdReader_t* readerPtr           ///< [IN] The reader.
+)
+{
+    ssize_t numBytesRead;
 
     do
     {
-        numBytesWritten = write(fd, string, len);
+        numBytesRead = read(readerPtr->fd, readerPtr->buf, sizeof(readerPtr->buf));
     }
-    while ((numBytesWritten == -1) && (errno == EINTR));
+    while ((numBytesRead == -1) && (errno == EINTR));
 
-    if (numBytesWritten != len)
+    if (numBytesRead < 0)
     {
-        LE_ERROR("Could not write '%s' to file '%s' in cgroup '%s'.  %m.",
-                 string, fileNamePtr, cgroupNamePtr);
-
-        if (errno == ESRCH)
-        {
-            result = LE_OUT_OF_RANGE;
-        }
-        else
-        {
-            result = LE_FAULT;
-        }
+        return LE_FAULT;
     }
 
-    fd_Close(fd);
+    readerPtr->len = numBytesRead;
+    readerPtr->pos = 0;
 
-    return result;
+    return (numBytesRead == 0) ? LE_OUT_OF_RANGE : LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets a value from a cgroup file.  The value is read as a string and so a NULL-terminator is
- * always appended to the end of the read value in bufPtr.
+ * Starts reading the IDs listed in a cgroup's procs or tasks file.  The file is read from the
+ * start, in large chunks.
  *
  * @return
  *      LE_OK if successful.
- *      LE_OVERFLOW if the provided buffer is too small.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetValue
+static le_result_t StartIdReader
 (
+    IdReader_t* readerPtr,          ///< [OUT] The reader.
     cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
     const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
-    const char* fileNamePtr,        ///< [IN] File name to read from.
-    char* bufPtr,                   ///< [OUT] Buffer to store the value in.
-    size_t bufSize                  ///< [IN] Size of the buffer.
+    CgrpFile_t file                 ///< [IN] FILE_PROCS or FILE_TASKS.
 )
 {
-    // Open the file.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, fileNamePtr, O_RDONLY);
-
-    if (fd < 0)
-    {
-        return LE_FAULT;
-    }
-
-    // Read the value from the file.
-    ssize_t numBytesRead;
+    int retries = 1;
 
-    do
+    for (;;)
     {
-        numBytesRead = read(fd, bufPtr, bufSize);
-    }
-    while ( (numBytesRead == -1) && (errno == EINTR) );
+        readerPtr->fd = GetCgrpFileFd(subsystem, cgroupNamePtr, file);
 
-    le_result_t result = LE_FAULT;
+        if (readerPtr->fd < 0)
+        {
+            return LE_FAULT;
+        }
 
-    // Check if the read value is valid.
-    if (numBytesRead == -1)
-    {
-        LE_ERROR("Could not read file '%s' in cgroup '%s'.  %m.", fileNamePtr, cgroupNamePtr);
-        result = LE_FAULT;
-    }
-    else if (numBytesRead == bufSize)
-    {
-        // The value in the file is larger than the provided buffer.  Truncate the buffer.
-        bufPtr[bufSize-1] = '\0';
-        result = LE_OVERFLOW;
-    }
-    else if ((numBytesRead >= 0) && (numBytesRead < bufSize))
-    {
-        // Null-terminate the string.
-        bufPtr[numBytesRead] = '\0';
+        // Rewinding the file makes the kernel build a fresh list.
+        if (   (lseek(readerPtr->fd, 0, SEEK_SET) == 0)
+            && (FillIdReader(readerPtr) != LE_FAULT) )
+        {
+            return LE_OK;
+        }
 
-        // Remove trailing newline characters.
-        while ((numBytesRead > 0) && (bufPtr[numBytesRead - 1] == '\n'))
+        if ((errno == ENODEV) && (retries-- > 0))
         {
-            numBytesRead--;
-            bufPtr[numBytesRead] = '\0';
+            DropCgroup(subsystem, cgroupNamePtr);
+            continue;
         }
 
-        result = LE_OK;
+        LE_ERROR("Could not read file '%s' in cgroup '%s'.  %m.", FileName(file), cgroupNamePtr);
+        return LE_FAULT;
     }
-
-    fd_Close(fd);
-
-    return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads a PID from the opened procs or tasks file specified by fd.  Updates the file offset of fd.
+ * Reads the next ID from a procs or tasks file.
  *
  * @return
- *      The current PID read from the file if successful.
+ *      The ID read from the file if successful.
  *      LE_OUT_OF_RANGE if there is nothing left to read.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
 static pid_t GetTasksId
 (
-    int fd                      ///< [IN] File descriptor to an opened procs or tasks file.
+    IdReader_t* readerPtr           ///< [IN] The reader.
 )
 {
-    // Read a pid from the file.
-    pid_t pid;
-    char pidStr[100];
-    le_result_t result = fd_ReadLine(fd, pidStr, sizeof(pidStr));
+    pid_t id = 0;
+    bool hasDigits = false;
 
-    LE_FATAL_IF(result == LE_OVERFLOW, "Buffer to read PID is too small.");
-
-    if (result == LE_OK)
+    for (;;)
     {
-        // Convert the string to a pid and store it in the caller's buffer.
-        le_result_t r = le_utf8_ParseInt(&pid, pidStr);
-
-        if (r == LE_OK)
+        if (readerPtr->pos == readerPtr->len)
         {
-            return pid;
+            le_result_t result = FillIdReader(readerPtr);
+
+            if (result == LE_OUT_OF_RANGE)
+            {
+                return hasDigits ? id : LE_OUT_OF_RANGE;
+            }
+            else if (result != LE_OK)
+            {
+                LE_ERROR("Could not read list of IDs.  %m.");
+                return LE_FAULT;
+            }
         }
 
-        LE_ERROR("Could not convert '%s' to a PID.  %s.", pidStr, LE_RESULT_TXT(r));
-        result = LE_FAULT;
-    }
+        char c = readerPtr->buf[readerPtr->pos++];
 
-    return result;
+        if ((c >= '0') && (c <= '9'))
+        {
+            id = (id * 10) + (c - '0');
+            hasDigits = true;
+        }
+        else if (c == '\n')
+        {
+            if (hasDigits)
+            {
+                return id;
+            }
+        }
+        else
+        {
+            LE_ERROR("Unexpected character 0x%02x in list of IDs.", (unsigned char)c);
+            return LE_FAULT;
+        }
+    }
 }
 
 
@@ -453,10 +1080,28 @@ le_result_t cgrp_Create
     const char* cgroupNamePtr       ///< Name of the cgroup to create.
 )
 {
+    Cgroup_t* cgroupPtr = FindCgroup(subsystem, cgroupNamePtr);
+
+    if (IsUnified() && (cgroupPtr != NULL) && (cgroupPtr->subSysMask != 0))
+    {
+        // In the unified hierarchy, the cgroups of all the sub-systems are the same directory,
+        // which we already created for another sub-system.
+        if (cgroupPtr->subSysMask & (1 << subsystem))
+        {
+            LE_WARN("Cgroup %s already exists.", cgroupNamePtr);
+            return LE_DUPLICATE;
+        }
+
+        cgroupPtr->subSysMask |= (1 << subsystem);
+        return LE_OK;
+    }
+
+    // Any cached state is from an older cgroup with that name.
+    DropCgroup(subsystem, cgroupNamePtr);
+
     // Create the path to the cgroup.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             (char*)NULL) == LE_OK);
+    char path[LIMIT_MAX_PATH_BYTES];
+    BuildPath(path, sizeof(path), subsystem, cgroupNamePtr, NULL);
 
     // Create the cgroup.
     le_result_t result = le_dir_Make(path, S_IRWXU);
@@ -472,6 +1117,26 @@ le_result_t cgrp_Create
         return LE_FAULT;
     }
 
+    if (IsUnified())
+    {
+        // Sub-groups only get the controllers that their parent enables for its children.
+        const char* lastSlashPtr = strrchr(cgroupNamePtr, '/');
+
+        if ((lastSlashPtr != NULL) && (lastSlashPtr != cgroupNamePtr))
+        {
+            char parentName[LIMIT_MAX_PATH_BYTES];
+            size_t parentLen = lastSlashPtr - cgroupNamePtr;
+
+            LE_ASSERT(parentLen < sizeof(parentName));
+            memcpy(parentName, cgroupNamePtr, parentLen);
+            parentName[parentLen] = '\0';
+
+            EnableV2Controllers(parentName);
+        }
+
+        GetCgroup(subsystem, cgroupNamePtr)->subSysMask = (1 << subsystem);
+    }
+
     return LE_OK;
 }
 
@@ -493,18 +1158,40 @@ le_result_t cgrp_AddProc
     pid_t pidToAdd                  ///< PID of the process to add.
 )
 {
+    // In the unified hierarchy, adding a process to the cgroup of one sub-system adds it to all of
+    // them, so the writes for the other sub-systems can be skipped.
+    Cgroup_t* cgroupPtr = NULL;
+
+    if (IsUnified())
+    {
+        cgroupPtr = GetCgroup(subsystem, cgroupNamePtr);
+
+        if (cgroupPtr->lastAddedPid == pidToAdd)
+        {
+            return LE_OK;
+        }
+    }
+
     // Convert the pid to a string.
     char pidStr[MAX_DIGITS];
 
     LE_ASSERT(snprintf(pidStr, sizeof(pidStr), "%d", pidToAdd) < sizeof(pidStr));
 
     // Write the pid to the file.
-    return WriteToFile(subsystem, cgroupNamePtr, PROCS_FILENAME, pidStr);
+    le_result_t result = WriteToFile(subsystem, cgroupNamePtr, FILE_PROCS, pidStr);
+
+    if ((result == LE_OK) && (cgroupPtr != NULL))
+    {
+        // The cache entry may have been replaced if the cgroup was re-created.
+        GetCgroup(subsystem, cgroupNamePtr)->lastAddedPid = pidToAdd;
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reads a list of tids/pids from an open file descriptor.  The number of pids in the file may be
+ * Reads a list of tids/pids from a procs or tasks file.  The number of pids in the file may be
  * larger than maxIds, in which case idListPtr will be filled with the first maxIds PIDs. We can
  * re-use this code for tids or pids because, in linux, all tids are pids and vice versa.
  *
@@ -515,17 +1202,26 @@ le_result_t cgrp_AddProc
 //--------------------------------------------------------------------------------------------------
 static ssize_t BuildTidList
 (
-    int fd,
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    CgrpFile_t file,                ///< [IN] FILE_PROCS or FILE_TASKS.
     pid_t* idListPtr,               ///< [OUT] Buffer that will contain the list of PIDs.
     size_t maxIds                   ///< [IN] The maximum number of pids pidListPtr can hold.
 )
 {
+    IdReader_t reader;
+
+    if (StartIdReader(&reader, subsystem, cgroupNamePtr, file) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
     // Read the pids from the file.
     size_t numTids = 0;
 
     while (1)
     {
-        pid_t tid = GetTasksId(fd);
+        pid_t tid = GetTasksId(&reader);
 
         if (tid >= 0)
         {
@@ -567,17 +1263,7 @@ ssize_t cgrp_GetThreadList
     size_t maxTids                  ///< [IN] The maximum number of tids tidListPtr can hold.
 )
 {
-    // Open the cgroup's tasks file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, TASKS_FILENAME, O_RDONLY);
-
-    if (fd < 0)
-    {
-        return LE_FAULT;
-    }
-
-    size_t numTids = BuildTidList(fd, tidListPtr, maxTids);
-
-    fd_Close(fd);
+    ssize_t numTids = BuildTidList(subsystem, cgroupNamePtr, FILE_TASKS, tidListPtr, maxTids);
 
     if (numTids == LE_FAULT)
     {
@@ -605,23 +1291,13 @@ ssize_t cgrp_GetProcessesList
     size_t maxPids                  ///< [IN] The maximum number of pids pidListPtr can hold.
 )
 {
-    // Open the cgroup's processes file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, PROCS_FILENAME, O_RDONLY);
-
-    if (fd < 0)
-    {
-        return LE_FAULT;
-    }
-
-    size_t numPids = BuildTidList(fd, pidListPtr, maxPids);
+    ssize_t numPids = BuildTidList(subsystem, cgroupNamePtr, FILE_PROCS, pidListPtr, maxPids);
 
     if (numPids == LE_FAULT)
     {
         LE_ERROR("Error reading the '%s' cgroup's tasks.", cgroupNamePtr);
     }
 
-    fd_Close(fd);
-
     return numPids;
 }
 
@@ -641,10 +1317,9 @@ ssize_t cgrp_SendSig
     int sig                         ///< [IN] The signal to send.
 )
 {
-    // Open the cgroup's procs file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, PROCS_FILENAME, O_RDONLY);
+    IdReader_t reader;
 
-    if (fd < 0)
+    if (StartIdReader(&reader, subsystem, cgroupNamePtr, FILE_PROCS) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -654,7 +1329,7 @@ ssize_t cgrp_SendSig
 
     while (1)
     {
-        pid_t pid = GetTasksId(fd);
+        pid_t pid = GetTasksId(&reader);
 
         if (pid >= 0)
         {
@@ -670,12 +1345,10 @@ ssize_t cgrp_SendSig
         else
         {
             LE_ERROR("Error reading the '%s' cgroup's tasks.", cgroupNamePtr);
-            fd_Close(fd);
             return LE_FAULT;
         }
     }
 
-    fd_Close(fd);
     return numPids;
 }
 
@@ -695,17 +1368,21 @@ bool cgrp_IsEmpty
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    // Open the cgroup's tasks file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, TASKS_FILENAME, O_RDONLY);
+    // The unified hierarchy keeps track of whether a cgroup is populated.
+    if (IsUnified())
+    {
+        return (GetEventsValue(cgroupNamePtr, "populated") == 0);
+    }
 
-    if (fd < 0)
+    // Read a tid from the cgroup's tasks file.
+    IdReader_t reader;
+
+    if (StartIdReader(&reader, subsystem, cgroupNamePtr, FILE_TASKS) != LE_OK)
     {
         return false;
     }
 
-    // Read a tid from the file.
-    pid_t tid = GetTasksId(fd);
-    fd_Close(fd);
+    pid_t tid = GetTasksId(&reader);
 
     if (tid >= 0)
     {
@@ -743,10 +1420,24 @@ le_result_t cgrp_Delete
     const char* cgroupNamePtr       ///< Name of the cgroup to delete.
 )
 {
+    if (IsUnified())
+    {
+        // Only remove the directory once the cgroups of all the sub-systems are deleted.
+        Cgroup_t* cgroupPtr = FindCgroup(subsystem, cgroupNamePtr);
+
+        if ((cgroupPtr != NULL) && ((cgroupPtr->subSysMask & ~(1 << subsystem)) != 0))
+        {
+            cgroupPtr->subSysMask &= ~(1 << subsystem);
+            return LE_OK;
+        }
+    }
+
+    // The cgroup's files must not be kept open.
+    DropCgroup(subsystem, cgroupNamePtr);
+
     // Create the path to the cgroup.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             (char*)NULL) == LE_OK);
+    char path[LIMIT_MAX_PATH_BYTES];
+    BuildPath(path, sizeof(path), subsystem, cgroupNamePtr, NULL);
 
     // Attempt to remove the cgroup directory.
     if (rmdir(path) != 0)
@@ -822,6 +1513,9 @@ const char* cgrp_SubSysName
  * The process in cgroupC will get 2048/4608 = 44% of the cpu.
  * The system process will get 1024/4608 = 22% of the cpu.
  *
+ * In the unified hierarchy, the share is converted to the equivalent cpu weight (1 to 10000,
+ * 100 by default).
+ *
  * @return
  *      LE_OK if successful.
  *      LE_FAULT if there was an error.
@@ -834,12 +1528,27 @@ le_result_t cgrp_cpu_SetShare
                                     ///  details.
 )
 {
+    if (IsUnified())
+    {
+        // Map the share range [2, 262144] onto the weight range [1, 10000].
+        if (share < 2)
+        {
+            share = 2;
+        }
+        else if (share > 262144)
+        {
+            share = 262144;
+        }
+
+        share = 1 + ((share - 2) * 9999) / 262142;
+    }
+
     // Convert the value to a string.
     char shareStr[MAX_DIGITS];
     LE_ASSERT(snprintf(shareStr, sizeof(shareStr), "%zd", share) < sizeof(shareStr));
 
     // Write the share value to the file.
-    if (WriteToFile(CGRP_SUBSYS_CPU, cgroupNamePtr, CPU_SHARES_FILENAME, shareStr) != LE_OK)
+    if (WriteToFile(CGRP_SUBSYS_CPU, cgroupNamePtr, FILE_CPU_SHARE, shareStr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -871,7 +1580,7 @@ le_result_t cgrp_mem_SetLimit
     LE_ASSERT(snprintf(limitStr, sizeof(limitStr), "%zd", limit * 1024) < sizeof(limitStr));
 
     // Write the limit to the file.
-    if (WriteToFile(CGRP_SUBSYS_MEM, cgroupNamePtr, MEM_LIMIT_FILENAME, limitStr) != LE_OK)
+    if (WriteToFile(CGRP_SUBSYS_MEM, cgroupNamePtr, FILE_MEM_LIMIT, limitStr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -881,7 +1590,7 @@ le_result_t cgrp_mem_SetLimit
 
     if (GetValue(CGRP_SUBSYS_MEM,
                  cgroupNamePtr,
-                 MEM_LIMIT_FILENAME,
+                 FILE_MEM_LIMIT,
                  readLimitStr,
                  sizeof(readLimitStr)) != LE_OK)
     {
@@ -915,7 +1624,8 @@ le_result_t cgrp_frz_Freeze
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME, "FROZEN") != LE_OK)
+    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FILE_FREEZE,
+                    IsUnified() ? "1" : "FROZEN") != LE_OK)
     {
         return LE_FAULT;
     }
@@ -941,7 +1651,8 @@ le_result_t cgrp_frz_Thaw
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME, "THAWED") != LE_OK)
+    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FILE_FREEZE,
+                    IsUnified() ? "0" : "THAWED") != LE_OK)
     {
         return LE_FAULT;
     }
@@ -964,11 +1675,25 @@ cgrp_FreezeState_t cgrp_frz_GetState
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
+    if (IsUnified())
+    {
+        // A cgroup that is still freezing is reported as not frozen, like with the legacy
+        // hierarchy.
+        int frozen = GetEventsValue(cgroupNamePtr, "frozen");
+
+        if (frozen == LE_FAULT)
+        {
+            return LE_FAULT;
+        }
+
+        return (frozen == 1) ? CGRP_FROZEN : CGRP_THAWED;
+    }
+
     char stateStr[MAX_FREEZE_STATE_BYTES] = {0};
 
     le_result_t result = GetValue(CGRP_SUBSYS_FREEZE,
                                   cgroupNamePtr,
-                                  FREEZE_STATE_FILENAME,
+                                  FILE_FREEZE,
                                   stateStr,
                                   sizeof(stateStr));
 
@@ -1008,24 +1733,7 @@ ssize_t cgrp_GetMemUsed
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    char buffer[32] = {0};
-    ssize_t result;
-
-    if (GetValue(CGRP_SUBSYS_MEM,
-                 cgroupNamePtr,
-                 "memory.memsw.usage_in_bytes",
-                 buffer,
-                 sizeof(buffer)) == LE_OK)
-    {
-        result = strtol(buffer, NULL, 10);
-        if ((errno == ERANGE) || (errno == EINVAL))
-        {
-            result = LE_FAULT;
-        }
-    }else{
-        result = LE_FAULT;
-    }
-    return result;
+    return GetIntValue(CGRP_SUBSYS_MEM, cgroupNamePtr, FILE_MEM_USAGE);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1041,24 +1749,57 @@ ssize_t cgrp_GetMaxMemUsed
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    char buffer[32] = {0};
-    ssize_t result;
+    return GetIntValue(CGRP_SUBSYS_MEM, cgroupNamePtr, FILE_MEM_MAX_USAGE);
+}
 
-    if (GetValue(CGRP_SUBSYS_MEM,
-                 cgroupNamePtr,
-                 "memory.memsw.max_usage_in_bytes",
-                 buffer,
-                 sizeof(buffer)) == LE_OK)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total cpu time consumed by all the tasks in a cgroup.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_GetCpuTime
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* cpuTimeNsPtr          ///< [OUT] Cpu time, in nanoseconds.
+)
+{
+    char buffer[MAX_CPU_STAT_BYTES];
+
+    if (GetValue(CGRP_SUBSYS_CPU, cgroupNamePtr, FILE_CPU_USAGE, buffer, sizeof(buffer)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // The legacy cpuacct controller counts nanoseconds, cpu.stat counts microseconds.
+    const char* valuePtr = buffer;
+    uint64_t scale = 1;
+
+    if (IsUnified())
     {
-        result = strtol(buffer, NULL, 10);
-        if ((errno == ERANGE) || (errno == EINVAL))
+        valuePtr = FindKeyedValue(buffer, "usage_usec");
+        scale = 1000;
+
+        if (valuePtr == NULL)
         {
-            result = LE_FAULT;
+            LE_ERROR("No cpu usage in the cpu.stat of cgroup '%s'.", cgroupNamePtr);
+            return LE_FAULT;
         }
-    }else{
-        result = LE_FAULT;
     }
-    return result;
-}
 
+    char* endPtr;
+    errno = 0;
+    unsigned long long value = strtoull(valuePtr, &endPtr, 10);
+    if ((errno != 0) || (endPtr == valuePtr))
+    {
+        LE_ERROR("Bad cpu usage value in cgroup '%s'.", cgroupNamePtr);
+        return LE_FAULT;
+    }
+
+    *cpuTimeNsPtr = (uint64_t)value * scale;
 
+    return LE_OK;
+}
@@ -43,6 +43,11 @@
  * words there is a one-to-one mapping of hierarchy and sub-systems so the terms hierarchy and
  * sub-system will be used interchangeably henceforth.
  *
+ * If the system already mounted the cgroup v2 unified hierarchy at /sys/fs/cgroup, that single
+ * hierarchy is used for all the sub-systems instead: the cgroups of all the sub-systems with the
+ * same name are then the same cgroup.  This API hides the difference; a cgroup is only removed
+ * once it has been deleted for all the sub-systems it was created for.
+ *
  *
  * @section c_cgrp_init Initialization
  *
@@ -435,4 +440,19 @@ ssize_t cgrp_GetMaxMemUsed
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total cpu time consumed by all the tasks in a cgroup, since the cgroup was created.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_GetCpuTime
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* cpuTimeNsPtr          ///< [OUT] Cpu time, in nanoseconds.
+);
+
 #endif // LEGATO_SRC_CGROUPS_INCLUDE_GUARD
@@ -49,6 +49,44 @@ le_clk_Time_t le_clk_GetRelativeTime(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get relative time since the same starting point as le_clk_GetRelativeTime(), cheaply but only
+ * to the resolution of the system tick.
+ *
+ * @return
+ *      The relative time in seconds/microseconds
+ *
+ * @note
+ *      - There is no coarse version of CLOCK_BOOTTIME, so where the relative time includes the
+ *        time that the processor is suspended, this reads the same clock as
+ *        le_clk_GetRelativeTime().
+ *      - It is a fatal error if the relative time cannot be returned
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetRelativeTimeCoarse(void)
+{
+    struct timespec systemTime;
+    le_clk_Time_t relativeTime;
+    clockid_t clockId = timer_GetClockType();
+
+    if (CLOCK_MONOTONIC == clockId)
+    {
+        clockId = CLOCK_MONOTONIC_COARSE;
+    }
+
+    if (0 > clock_gettime(clockId, &systemTime))
+    {
+        LE_FATAL("clock_gettime() failed. errno = %d (%m)", errno);
+    }
+
+    relativeTime.sec = systemTime.tv_sec;
+    relativeTime.usec = systemTime.tv_nsec/1000;
+
+    return relativeTime;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get absolute time since the Epoch, 1970-01-01 00:00:00 +0000 (UTC).
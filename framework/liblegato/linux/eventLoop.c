@@ -65,20 +65,27 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
- * will return immediately, reporting that there is something to read from that fd.
+ * Event Reports are queued to a thread by pushing them onto that thread's incoming queue, a
+ * lock-free stack that any thread can push onto without holding the Mutex.  The first Report
+ * pushed after the thread last read its eventfd also writes the number 1 to the eventfd; later
+ * Reports skip the write, because the thread is already going to wake up.  As long as the
+ * eventfd's value is greater than 0, epoll_wait() will return immediately, reporting that there
+ * is something to read from that fd.
  *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
- * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
- * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
- * FD Event Reports are created and pushed onto Event Queues according to what handlers are
- * registered for those events.  All pending Event Reports are processed until the Event Queue is
- * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
- * overhead in times of heavy load.  Unfortunately, it also means that if event handlers always add
- * new events to the queue, then epoll_wait() will never be called and therefore fd events will
- * never be detected.)
+ * that epoll_wait() reports.  If epoll_wait() reports an event on any fd other than the eventfd,
+ * the FD Monitor's handler for that fd is called straight away.  If the eventfd is readable, it is
+ * read, and the whole incoming queue is taken in one go and moved (oldest first) onto the end of
+ * the thread's Event Queue.  Then at most MAX_REPORTS_PER_ITERATION Event Reports are processed
+ * before returning to epoll_wait(), which doesn't block if any are left.  So fd events are checked
+ * for (and handled ahead of the backlog) at least every MAX_REPORTS_PER_ITERATION Event Reports,
+ * however many are queued, and handlers that keep adding new events to the queue can't prevent
+ * fd events from being detected.
+ *
+ * Changes that handlers make to the events being monitored on their fds are only passed on to
+ * epoll when the Event Loop is about to call epoll_wait() again (see fdMon_ApplyEpollUpdates()),
+ * so an fd that is enabled and disabled many times while handling a batch of events costs a single
+ * epoll_ctl() call.
  *
  * ----
  *
@@ -86,7 +93,8 @@
  *
  * Everything can be shared between multiple threads, and therefore must be protected from
  * multithreaded race conditions.  A Mutex is provided for that purpose, and it can be locked
- * and unlocked using the functions Lock() and Unlock().
+ * and unlocked using the functions Lock() and Unlock().  The exception is the incoming queue
+ * of each thread and its wakeup flag, which are only accessed using atomic operations.
  *
  * ----
  *
@@ -99,9 +107,11 @@
 #include "fdMonitor.h"
 #include "limit.h"
 #include "fileDescriptor.h"
+#include "startupTrace.h"
 
 #include <pthread.h>
 #include <sys/eventfd.h>
+#include <dlfcn.h>
 
 // ==============================================
 //  PRIVATE DATA
@@ -110,6 +120,10 @@
 /// Maximum number of events that can be received from epoll_wait() at one time.
 #define MAX_EPOLL_EVENTS 32
 
+/// Maximum number of Event Reports processed by le_event_RunLoop() between two checks for fd
+/// events.
+#define MAX_REPORTS_PER_ITERATION 32
+
 /// The default number of objects in the process-wide Queued Function Report Pool, from which
 /// Queued Function reports are allocated.
 /// @todo Make this configurable.
@@ -129,6 +143,9 @@
 /// @todo Make this configurable.
 #define DEFAULT_EVENT_POOL_SIZE 5
 
+/// Largest slow handler threshold that can be set using LE_EVENT_SLOW_HANDLER_MS, in milliseconds.
+#define MAX_SLOW_HANDLER_MS 60000
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -235,6 +252,10 @@ typedef enum
     LE_EVENT_REPORT_COUNTED_REF,    ///< Publish-Subscribe Event Report containing poiner to
                                     ///  reference-counted object allocated from a memory pool.
 
+    LE_EVENT_REPORT_SHARED_REF,     ///< Publish-Subscribe Event Report containing pointer to a
+                                    ///  reference-counted object holding the payload, which is
+                                    ///  released by the Event Loop once the handler returns.
+
     LE_EVENT_REPORT_QUEUED_FUNC,    ///< Queued Function.
 }
 EventReportType_t;
@@ -260,6 +281,8 @@ typedef struct
 {
     le_sls_Link_t           link;       ///< Used to link onto an Event Queue.
     EventReportType_t       type;       ///< Indicates what type of event report this is.
+    uint64_t                queuedUs;   ///< Time at which the report was queued (microseconds,
+                                        ///< relative clock).  Only set if profiling.
 }
 Report_t;
 
@@ -387,11 +410,37 @@ static void Unlock
 //--------------------------------------------------------------------------------------------------
 static le_log_TraceRef_t TraceRef;
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if the Event Loop profiling statistics are kept (see event_Init()).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsProfiling = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler run time (in microseconds) above which a warning naming the handler is logged, or 0 if
+ * slow handlers are not logged.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t SlowHandlerUs = 0;
+
 /// Macro used to generate trace output in this module.
 /// Takes the same parameters as LE_DEBUG() et. al.
 #define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of component initializers that have been queued but not yet run.  Only used by the
+ * main thread, at start-up.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PendingComponentInitCount = 0;
+
+
 // ==============================================
 //  PRIVATE FUNCTIONS
 // ==============================================
@@ -442,8 +491,11 @@ static Event_t* CreateEvent
     {
         LE_WARN("Event report pool name truncated for '%s' events.", name);
     }
+    // Leave room for an object pointer, for reports sent using le_event_ReportByRef().
+    size_t reportPayloadSize = (payloadSize < sizeof(void*)) ? sizeof(void*) : payloadSize;
     eventPtr->reportPoolRef = le_mem_CreatePool(poolNameStr,
-                                              offsetof(PubSubEventReport_t, payload) + payloadSize);
+                                                offsetof(PubSubEventReport_t, payload)
+                                                + reportPayloadSize);
     le_mem_ExpandPool(eventPtr->reportPoolRef, DEFAULT_REPORT_POOL_SIZE);
 
     // Up until now, we have not accessed anything that is available to anyone else; except for
@@ -486,9 +538,48 @@ static void DeleteHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write to a thread's Event File Descriptor.  This increments it by one.
+ * Guards against thread cancellation, without locking the mutex.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * @return Old state of cancelability.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int DisableCancel
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldState;
+
+    int err = pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+
+    return oldState;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the thread cancellation guard created by DisableCancel().
+ **/
+//--------------------------------------------------------------------------------------------------
+static void RestoreCancel
+(
+    int restoreTo   ///< Old state of cancellability to be restored.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int junk;
+
+    int err = pthread_setcancelstate(restoreTo, &junk);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write to a thread's Event File Descriptor.  This increments it by one.
  */
 //--------------------------------------------------------------------------------------------------
 static void WriteEventFd
@@ -562,6 +653,202 @@ static uint64_t ReadEventFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative clock time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeUs
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return (uint64_t)now.sec * 1000000 + now.usec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a time in a latency histogram (see EVENT_LATENCY_BUCKETS).
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountLatency
+(
+    uint32_t* histogramPtr,     ///< [in] Histogram of EVENT_LATENCY_BUCKETS buckets.
+    uint64_t usec               ///< [in] Time to count, in microseconds.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t limit = 100;
+    size_t i;
+
+    for (i = 0; (i < EVENT_LATENCY_BUCKETS - 1) && (usec >= limit); i++)
+    {
+        limit *= 10;
+    }
+
+    histogramPtr[i]++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the run time of the handler of an Event Report in the calling thread's statistics, and
+ * log a warning naming the handler function if it was slow.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountHandlerRun
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the calling thread's per-thread record.
+    uint64_t startUs                        ///< [in] Time at which the handler was called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t runUs = GetTimeUs() - startUs;
+    event_Stats_t* statsPtr = &perThreadRecPtr->stats;
+
+    CountLatency(statsPtr->handlerRun, runUs);
+
+    if (runUs > statsPtr->maxRunUs)
+    {
+        statsPtr->maxRunUs = runUs;
+    }
+
+    if ((SlowHandlerUs != 0) && (runUs >= SlowHandlerUs))
+    {
+        Dl_info info;
+        void* funcPtr = perThreadRecPtr->handlerFuncPtr;
+
+        statsPtr->numSlowHandlers++;
+
+        if ((funcPtr != NULL) && (dladdr(funcPtr, &info) != 0) && (info.dli_sname != NULL))
+        {
+            LE_WARN("Event handler %s() in %s ran for %" PRIu64 " us.",
+                    info.dli_sname, info.dli_fname, runUs);
+        }
+        else
+        {
+            LE_WARN("Event handler %p ran for %" PRIu64 " us.", funcPtr, runUs);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue an Event Report to a thread (which could be the calling thread or some other thread).
+ *
+ * The eventfd is only written if the thread has read it since it was last written, as the
+ * thread is otherwise already due to wake up and take everything on its incoming queue.
+ *
+ * @warning Assumes the thread is protected from cancellation, as a cancellation between queuing
+ *          the report and writing the eventfd would leave the other thread asleep for good.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReport
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the thread's per-thread record.
+    Report_t* reportPtr                     ///< [in] The report to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (IsProfiling)
+    {
+        reportPtr->queuedUs = GetTimeUs();
+    }
+
+    le_sls_Link_t* headPtr = __atomic_load_n(&perThreadRecPtr->incomingQueuePtr, __ATOMIC_RELAXED);
+
+    // Push the report onto the incoming queue.  Only the thread itself takes reports off it, and
+    // it takes them all at once, so there is no ABA problem.
+    do
+    {
+        reportPtr->link.nextPtr = headPtr;
+    }
+    while (!__atomic_compare_exchange_n(&perThreadRecPtr->incomingQueuePtr,
+                                        &headPtr,
+                                        &reportPtr->link,
+                                        true,
+                                        __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+
+    // Wake up the thread, unless someone else already has.
+    if (!__atomic_exchange_n(&perThreadRecPtr->isWakeupPending, true, __ATOMIC_ACQ_REL))
+    {
+        WriteEventFd(perThreadRecPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move everything on the calling thread's incoming queue onto the end of its Event Queue, in the
+ * order it was queued.
+ *
+ * @return The number of Event Reports moved to the Event Queue.
+ **/
+//--------------------------------------------------------------------------------------------------
+static uint64_t TakeIncomingReports
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t numReports = 0;
+    le_sls_Link_t* linkPtr = __atomic_exchange_n(&perThreadRecPtr->incomingQueuePtr,
+                                                 NULL,
+                                                 __ATOMIC_ACQUIRE);
+
+    // The incoming queue is most recent first, so reverse it.
+    le_sls_Link_t* oldestPtr = NULL;
+    while (linkPtr != NULL)
+    {
+        le_sls_Link_t* nextPtr = linkPtr->nextPtr;
+        linkPtr->nextPtr = oldestPtr;
+        oldestPtr = linkPtr;
+        linkPtr = nextPtr;
+    }
+
+    while (oldestPtr != NULL)
+    {
+        linkPtr = oldestPtr;
+        oldestPtr = oldestPtr->nextPtr;
+
+        le_sls_Queue(&perThreadRecPtr->eventQueue, linkPtr);
+        numReports++;
+    }
+
+    return numReports;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the calling thread's eventfd, and fetch the batch of Event Reports queued to the thread
+ * since it was last read.
+ *
+ * @return The number of Event Reports added to the Event Queue.
+ **/
+//--------------------------------------------------------------------------------------------------
+static uint64_t FetchEventReports
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Reset the eventfd to zero so epoll stops telling us about it, then clear the wakeup flag so
+    // that the next report queued writes to it again.  Clearing the flag synchronizes with any
+    // thread that saw it set and skipped the write, so its report will be taken below.
+    (void)ReadEventFd(perThreadRecPtr);
+    (void)__atomic_exchange_n(&perThreadRecPtr->isWakeupPending, false, __ATOMIC_ACQ_REL);
+
+    return TakeIncomingReports(perThreadRecPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process one event report from the calling thread's Event Queue.
@@ -576,14 +863,14 @@ static void ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    uint64_t startUs = 0;
 
-    int oldState = Lock();
+    int oldState;
 
-    // Pop an Event Report off the head of the Event Queue (inside a critical section).
+    // Pop an Event Report off the head of the Event Queue.  Only this thread uses its Event Queue,
+    // so there is no need to lock the mutex.
     linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
 
-    Unlock(oldState);
-
     if (linkPtr == NULL)
     {
         return;
@@ -592,6 +879,14 @@ static void ProcessOneEventReport
     // Convert the link pointer into a pointer to the Report base class.
     reportObjPtr = CONTAINER_OF(linkPtr, Report_t, link);
 
+    if (IsProfiling)
+    {
+        startUs = GetTimeUs();
+        perThreadRecPtr->stats.numReports++;
+        CountLatency(perThreadRecPtr->stats.queueWait, startUs - reportObjPtr->queuedUs);
+        perThreadRecPtr->handlerFuncPtr = NULL;
+    }
+
     // If it's a queued function report,
     if (reportObjPtr->type == LE_EVENT_REPORT_QUEUED_FUNC)
     {
@@ -600,6 +895,7 @@ static void ProcessOneEventReport
         queuedFuncReportPtr = CONTAINER_OF(reportObjPtr, QueuedFunctionReport_t, baseClass);
 
         // Call the function.
+        perThreadRecPtr->handlerFuncPtr = queuedFuncReportPtr->function;
         queuedFuncReportPtr->function(queuedFuncReportPtr->param1Ptr,
                                       queuedFuncReportPtr->param2Ptr);
 
@@ -623,7 +919,8 @@ static void ProcessOneEventReport
 
             // If its payload is a pointer to a reference-counted memory pool object,
             // then that has to be released.
-            if (reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            if ((reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+                || (reportObjPtr->type == LE_EVENT_REPORT_SHARED_REF))
             {
                 le_mem_Release(pubSubReportPtr->payload[0]);
             }
@@ -640,7 +937,8 @@ static void ProcessOneEventReport
             // If it's a reference-counted report, then the payload is a pointer to the
             // report.  Otherwise, the report itself is in the payload.
             void* reportPtr;
-            if (reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            if ((reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+                || (reportObjPtr->type == LE_EVENT_REPORT_SHARED_REF))
             {
                 reportPtr = pubSubReportPtr->payload[0];
             }
@@ -652,12 +950,25 @@ static void ProcessOneEventReport
             Unlock(oldState);  // Unlock the mutex before calling the handler function.
                                // Don't access the Handler object anymore after this.
 
+            // The second layer is the function the handler was registered with.
+            perThreadRecPtr->handlerFuncPtr = secondLayerFunc;
             firstLayerFunc(reportPtr, secondLayerFunc);
+
+            // Shared reports hold a reference that is ours to release, not the handler's.
+            if (reportObjPtr->type == LE_EVENT_REPORT_SHARED_REF)
+            {
+                le_mem_Release(reportPtr);
+            }
         }
     }
 
     // NOTE: The Mutex should be unlocked by this point.
 
+    if (IsProfiling)
+    {
+        CountHandlerRun(perThreadRecPtr, startUs);
+    }
+
     // We are done with this report.
     le_mem_Release(reportObjPtr);
 }
@@ -665,7 +976,8 @@ static void ProcessOneEventReport
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Process Event Reports from the calling thread's Event Queue until the queue is empty.
+ * Process Event Reports from the calling thread's Event Queue, until the queue is empty or
+ * MAX_REPORTS_PER_ITERATION of them have been processed.
  */
 //--------------------------------------------------------------------------------------------------
 static void ProcessEventReports
@@ -674,21 +986,54 @@ static void ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = ReadEventFd(perThreadRecPtr);
-
-    // Process only those event reports that are already on the queue.  Anything reported by the
-    // event handlers will have to wait until next time ProcessEventReports() is called.
-    // This approach ensures that event handlers that re-queue events to the event
-    // queue don't cause fd events to be starved.
-    for (; numReports > 0; numReports--)
+    // Anything reported by the event handlers goes onto the incoming queue, so it will wait
+    // until the Event Loop has checked for fd events again.  This approach ensures that event
+    // handlers that re-queue events to the event queue don't cause fd events to be starved.
+    int i;
+
+    for (i = 0; i < MAX_REPORTS_PER_ITERATION; i++)
     {
+        if (le_sls_IsEmpty(&perThreadRecPtr->eventQueue))
+        {
+            break;
+        }
+
         ProcessOneEventReport(perThreadRecPtr);
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call the FD Monitor handler for events reported by epoll_wait() on a monitored fd.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DispatchFdEvent
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the calling thread's per-thread record.
+    void* safeRef,                          ///< [in] Safe Reference for the FD Monitor.
+    uint32_t eventFlags                     ///< [in] Event flags from epoll_wait().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t startUs = 0;
+
+    if (IsProfiling)
+    {
+        startUs = GetTimeUs();
+        perThreadRecPtr->stats.numReports++;
+        perThreadRecPtr->handlerFuncPtr = NULL;
+    }
+
+    fdMon_Dispatch(safeRef, eventFlags);
+
+    if (IsProfiling)
+    {
+        CountHandlerRun(perThreadRecPtr, startUs);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * First-layer handler function that is used to implement the single-layer API using the two-layer
@@ -718,7 +1063,7 @@ static void PubSubHandlerFunc
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
  * could belong to some other thread).
  *
- * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ * @warning Assumes the thread is protected from cancellation.
  */
 //--------------------------------------------------------------------------------------------------
 static void QueueFunction
@@ -740,11 +1085,8 @@ static void QueueFunction
     reportPtr->param1Ptr = param1Ptr;
     reportPtr->param2Ptr = param2Ptr;
 
-    // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
-
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
-    WriteEventFd(perThreadRecPtr);
+    // Queue it to the thread, notifying the Event Loop that there is something on the queue.
+    QueueReport(perThreadRecPtr, &reportPtr->baseClass);
 }
 
 
@@ -764,6 +1106,11 @@ void CallComponentInitializer
     void (*componentInitFunc)(void) = param1Ptr;
 
     componentInitFunc();
+
+    if (--PendingComponentInitCount == 0)
+    {
+        startupTrace_Mark(STARTUP_TRACE_EVENT_INIT, NULL);
+    }
 }
 
 
@@ -808,6 +1155,26 @@ void event_Init
     // Get a reference to the trace keyword that is used to control tracing in this module.
     TraceRef = le_log_GetTraceRef("eventLoop");
 
+    // Profiling is enabled by setting the slow handler threshold (which can be 0).
+    const char* envStrPtr = getenv("LE_EVENT_SLOW_HANDLER_MS");
+
+    if (envStrPtr != NULL)
+    {
+        char* endPtr;
+        unsigned long thresholdMs = strtoul(envStrPtr, &endPtr, 10);
+
+        if ((endPtr == envStrPtr) || (*endPtr != '\0') || (thresholdMs > MAX_SLOW_HANDLER_MS))
+        {
+            LE_WARN("Invalid LE_EVENT_SLOW_HANDLER_MS value '%s'; profiling disabled.",
+                    envStrPtr);
+        }
+        else
+        {
+            IsProfiling = true;
+            SlowHandlerUs = (uint64_t)thresholdMs * 1000;
+        }
+    }
+
     // Initialize the FD Monitor module.
     fdMon_Init();
 }
@@ -829,28 +1196,15 @@ void event_InitThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // NOTE: This function doesn't touch any data structures that are shared with other threads yet,
-    //       so it doesn't need to lock the mutex.  While it's true that the structures initialized
-    //       here will eventually be shared with other threads, they will not be shared until this
-    //       thread registers a handler function, which it can't do until after it has been
-    //       initialized.
-
-    event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
-
-    // Initialize the various thread-specific lists and queues.
-    recPtr->eventQueue = LE_SLS_LIST_INIT;
-    recPtr->handlerList = LE_DLS_LIST_INIT;
-    recPtr->fdMonitorList = LE_DLS_LIST_INIT;
-
     // Create the epoll file descriptor for this thread.  This will be used to monitor for
     // events on various file descriptors.
-    recPtr->epollFd = epoll_create1(0);
-    LE_FATAL_IF(recPtr->epollFd < 0, "epoll_create1(0) failed with errno %d (%m).", errno);
+    int epollFd = epoll_create1(0);
+    LE_FATAL_IF(epollFd < 0, "epoll_create1(0) failed with errno %d (%m).", errno);
 
     // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
     // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
-    LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
+    int eventQueueFd = eventfd(0, 0);
+    LE_FATAL_IF(eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
 
     // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
     struct epoll_event ev;
@@ -859,16 +1213,56 @@ void event_InitThread
     ev.data.ptr = NULL;     // This being set to NULL is what tells the main event loop that this
                             // is the Event Queue FD, rather than another FD that is being
                             // monitored.
-    if (epoll_ctl(recPtr->epollFd, EPOLL_CTL_ADD, recPtr->eventQueueFd, &ev) == -1)
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventQueueFd, &ev) == -1)
     {
         LE_FATAL(   "epoll_ctl(ADD) failed for fd %d. errno = %d (%m)",
-                    recPtr->eventQueueFd,
+                    eventQueueFd,
                     errno);
     }
 
+    event_InitReusedThread(epollFd, eventQueueFd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Event Loop for a given thread, reusing the file descriptors that another thread's
+ * Event Loop handed over when it was parked (see event_ParkThread()).
+ *
+ * This is called instead of event_InitThread(), with the same restrictions.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_InitReusedThread
+(
+    int epollFd,        ///< [in] epoll(7) file descriptor, with eventQueueFd added to it.
+    int eventQueueFd    ///< [in] eventfd(2) file descriptor for the Event Queue, reset to zero.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // NOTE: This function doesn't touch any data structures that are shared with other threads yet,
+    //       so it doesn't need to lock the mutex.  While it's true that the structures initialized
+    //       here will eventually be shared with other threads, they will not be shared until this
+    //       thread registers a handler function, which it can't do until after it has been
+    //       initialized.
+
+    event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
+
+    // Initialize the various thread-specific lists and queues.
+    recPtr->eventQueue = LE_SLS_LIST_INIT;
+    recPtr->incomingQueuePtr = NULL;
+    recPtr->isWakeupPending = false;
+    recPtr->handlerList = LE_DLS_LIST_INIT;
+    recPtr->fdMonitorList = LE_DLS_LIST_INIT;
+
+    recPtr->epollFd = epollFd;
+    recPtr->eventQueueFd = eventQueueFd;
+
     // Set the context pointer to NULL for safety's sake.
     recPtr->contextPtr = NULL;
 
+    recPtr->isCachingLoopTime = false;
+    recPtr->isLoopTimeValid = false;
+
     // Initialize the FD Monitor module's thread-specific stuff.
     fdMon_InitThread(recPtr);
 
@@ -895,26 +1289,23 @@ void event_QueueComponentInit
 )
 //--------------------------------------------------------------------------------------------------
 {
+    PendingComponentInitCount++;
+
     le_event_QueueFunction(CallComponentInitializer, func, NULL);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Destruct the Event Loop for a given thread.
- *
- * This function must be called exactly once at thread shutdown, after any other Event module
- * or Event Loop API functions are called by that thread, and before the Thread object is
- * deleted.
+ * Delete everything the calling thread's Event Loop holds, except its file descriptors.
  */
 //--------------------------------------------------------------------------------------------------
-void event_DestructThread
+static void ClearThread
 (
-    void
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
     le_dls_Link_t* doubleLinkPtr;
     le_sls_Link_t* singleLinkPtr;
 
@@ -945,14 +1336,16 @@ void event_DestructThread
     // Delete all the FD Monitors for this thread.
     fdMon_DestructThread(perThreadRecPtr);
 
-    // Discard everything on the Event Queue.
+    // Discard everything on the Event Queue, including anything still on the incoming queue.
+    (void)TakeIncomingReports(perThreadRecPtr);
     while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
 
         // If it is carrying a pointer to a reference-counted object from a memory pool,
         // release that thing first.
-        if (reportPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+        if ((reportPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            || (reportPtr->type == LE_EVENT_REPORT_SHARED_REF))
         {
             PubSubEventReport_t* pubSubReportPtr = CONTAINER_OF(reportPtr,
                                                                 PubSubEventReport_t,
@@ -962,6 +1355,27 @@ void event_DestructThread
 
         le_mem_Release(reportPtr);
     }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destruct the Event Loop for a given thread.
+ *
+ * This function must be called exactly once at thread shutdown, after any other Event module
+ * or Event Loop API functions are called by that thread, and before the Thread object is
+ * deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_DestructThread
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
+
+    ClearThread(perThreadRecPtr);
 
     // Close the epoll file descriptor.
     fd_Close(perThreadRecPtr->epollFd);
@@ -971,6 +1385,36 @@ void event_DestructThread
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destruct the Event Loop for a given thread like event_DestructThread(), but hand its file
+ * descriptors over instead of closing them, so that another thread's Event Loop can be
+ * initialized with them by event_InitReusedThread().  Only the eventfd is left in the epoll set.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_ParkThread
+(
+    int* epollFdPtr,        ///< [out] epoll(7) file descriptor.
+    int* eventQueueFdPtr    ///< [out] eventfd(2) file descriptor for the Event Queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
+
+    ClearThread(perThreadRecPtr);
+
+    // Reset the eventfd to zero if anything was queued since it was last read, so that the next
+    // Event Loop doesn't wake up for nothing.
+    if (__atomic_exchange_n(&perThreadRecPtr->isWakeupPending, false, __ATOMIC_ACQ_REL))
+    {
+        (void)ReadEventFd(perThreadRecPtr);
+    }
+
+    *epollFdPtr = perThreadRecPtr->epollFd;
+    *eventQueueFdPtr = perThreadRecPtr->eventQueueFd;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the context pointer for the currently running thread.
@@ -991,6 +1435,23 @@ void event_SetCurrentContextPtr
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the function that handles the Event Report currently being processed by the calling thread,
+ * for when the function the Event Loop called passes the event on to another one (e.g., the FD
+ * Monitor's dispatcher).  This is the function named when the handler is found to be slow.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_SetCurrentHandlerFunc
+(
+    void* funcPtr       ///< [in] Handler function.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    thread_GetEventRecPtr()->handlerFuncPtr = funcPtr;
+}
+
+
 // ==============================================
 //  PUBLIC API FUNCTIONS
 // ==============================================
@@ -1221,11 +1682,10 @@ void le_event_Report
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
         memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
+        // Queue it to the handler's thread.
         // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        QueueReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1282,11 +1742,10 @@ void le_event_ReportWithRefCounting
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
+        // Queue it to the handler's thread.
         // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        QueueReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1301,6 +1760,74 @@ void le_event_ReportWithRefCounting
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends an Event Report whose payload is held in a reference-counted object, without copying it.
+ * The pointer must have been obtained from a memory pool using the @ref c_memory, and the object
+ * must start with the payload that would otherwise have been passed to le_event_Report().
+ *
+ * Unlike le_event_ReportWithRefCounting(), this works with Event IDs created using
+ * le_event_CreateId(), and handlers (including first-layer handlers) get a pointer to the payload
+ * just like they do for le_event_Report().  Each report holds one reference to the object, which
+ * the Event Loop releases after the handler returns, so handlers must not release it.  Handlers
+ * must not modify the payload either, because it is shared with every other handler.
+ *
+ * Calling this function passes ownership of the caller's reference to the Event Loop API.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_ReportByRef
+(
+    le_event_Id_t   eventId,    ///< [in] The event ID.
+    void*           objectPtr   ///< [in] Pointer to an object allocated from a memory pool
+                                ///       (using the @ref c_memory).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldState = Lock();
+
+    Event_t* eventPtr = le_ref_Lookup(EventRefMap, eventId);
+
+    LE_FATAL_IF(eventPtr == NULL, "No such event %p.", eventId);
+
+    LE_FATAL_IF(eventPtr->isRefCounted,
+                "Attempt to use Event ID (%s) created using le_event_CreateIdWithRefCounting().",
+                eventPtr->name);
+
+    TRACE("Reporting event '%s' by reference...", eventPtr->name);
+
+    // For each Handler registered for this Event,
+    le_dls_Link_t* linkPtr = le_dls_Peek(&eventPtr->handlerList);
+    while (linkPtr != NULL)
+    {
+        Handler_t* handlerPtr = CONTAINER_OF(linkPtr, Handler_t, eventLink);
+
+        event_PerThreadRec_t* perThreadRecPtr = handlerPtr->threadRecPtr;
+
+        TRACE("  ...to handler '%s'.", handlerPtr->name);
+
+        // Queue a report to the handler's thread's Event Queue.
+        PubSubEventReport_t* reportObjPtr = le_mem_ForceAlloc(eventPtr->reportPoolRef);
+        reportObjPtr->baseClass.link = LE_SLS_LINK_INIT;
+        reportObjPtr->baseClass.type = LE_EVENT_REPORT_SHARED_REF;
+        reportObjPtr->handlerRef = handlerPtr->safeRef;
+        reportObjPtr->payload[0] = objectPtr;
+        le_mem_AddRef(objectPtr);
+
+        // Queue it to the handler's thread.
+        // This will wake up the thread and tell it that it has something on its Event Queue.
+        QueueReport(perThreadRecPtr, &reportObjPtr->baseClass);
+
+        linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
+    }
+
+    Unlock(oldState);
+
+    // Release the caller's reference outside the critical section, in case the object's
+    // destructor uses the Event Loop API.
+    le_mem_Release(objectPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the context pointer for a given event handler.
@@ -1366,11 +1893,11 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
+    int oldState = DisableCancel();
 
     QueueFunction(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
 
-    Unlock(oldState);
+    RestoreCancel(oldState);
 }
 
 
@@ -1389,11 +1916,11 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
+    int oldState = DisableCancel();
 
     QueueFunction(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
 
-    Unlock(oldState);
+    RestoreCancel(oldState);
 }
 
 
@@ -1426,24 +1953,43 @@ void le_event_RunLoop
     // Update the state of the Event Loop.
     perThreadRecPtr->state = LE_EVENT_LOOP_RUNNING;
 
+    startupTrace_Mark(STARTUP_TRACE_EVENT_LOOP, NULL);
+
+    // From now on, the thread only runs handlers called by the Event Loop, so changes to the
+    // events monitored on fds can wait until the loop gets back to epoll_wait().
+    perThreadRecPtr->isBatchingEpollUpdates = true;
+
+    // And the handlers it runs on each wake-up can share one reading of the clock.
+    perThreadRecPtr->isCachingLoopTime = true;
+
     // Enter the infinite loop itself.
     for (;;)
     {
+        // Pass on the changes the handlers made to the events monitored on their fds.
+        fdMon_ApplyEpollUpdates(perThreadRecPtr);
+
         // Wait for something to happen on one of the file descriptors that we are monitoring
-        // using our epoll fd.
-        int result = epoll_wait(epollFd, epollEventList, NUM_ARRAY_MEMBERS(epollEventList), -1);
+        // using our epoll fd, unless there are Event Reports left over from last time.
+        int timeout = le_sls_IsEmpty(&perThreadRecPtr->eventQueue) ? -1 : 0;
+        int result = epoll_wait(epollFd,
+                                epollEventList,
+                                NUM_ARRAY_MEMBERS(epollEventList),
+                                timeout);
+
+        perThreadRecPtr->isLoopTimeValid = false;
 
         // If something happened on one or more of the monitored file descriptors,
         if (result > 0)
         {
             int i;
+            bool isEventQueueReady = false;
 
             // Check if someone has cancelled the thread and terminate the thread now, if so.
             pthread_testcancel();
 
             // For each fd event reported by epoll_wait(), if it is any file descriptor other
             // than the eventfd (which is used to indicate that there is something on the
-            // Event Queue), queue an Event Report to the Event Queue for that fd.
+            // incoming queue), call the handler for that fd.
             for (i = 0; i < result; i++)
             {
                 // Get the pointer that we registered with epoll_ctl(2) along with this fd.
@@ -1454,12 +2000,19 @@ void le_event_RunLoop
 
                 if (safeRef != NULL)
                 {
-                    fdMon_Report(safeRef, epollEventList[i].events);
+                    DispatchFdEvent(perThreadRecPtr, safeRef, epollEventList[i].events);
+                }
+                else
+                {
+                    isEventQueueReady = true;
                 }
             }
 
-            // Process all the Event Reports on the Event Queue.
-            ProcessEventReports(perThreadRecPtr);
+            // Move the Reports queued to this thread onto the end of the Event Queue.
+            if (isEventQueueReady)
+            {
+                (void)FetchEventReports(perThreadRecPtr);
+            }
         }
         // Otherwise, if an epoll_wait() reported an error, hopefully it's just an interruption
         // by a signal (EINTR).  Anything else is a fatal error.
@@ -1474,12 +2027,15 @@ void le_event_RunLoop
             // check if someone has cancelled the thread and terminate the thread now, if so.
             pthread_testcancel();
         }
-        // Otherwise, if epoll_wait() returned zero, something has gone horribly wrong, because
-        // it should never return zero.
-        else
+        // Otherwise, if epoll_wait() returned zero, something has gone horribly wrong, unless
+        // it wasn't allowed to block.
+        else if (timeout != 0)
         {
             LE_FATAL("epoll_wait() returned zero!");
         }
+
+        // Process the next lot of Event Reports on the Event Queue.
+        ProcessEventReports(perThreadRecPtr);
     }
 }
 
@@ -1508,26 +2064,19 @@ int le_event_GetFd
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Services the calling thread's Event Loop.
- *
- * @warning This function is only intended for use when integrating with legacy POSIX-based software
- * that cannot be easily refactored to use the Legato Event Loop.  The preferred approach is
- * to call le_event_RunLoop().
- *
- * See also: le_event_GetFd().
+ * Services the calling thread's Event Loop (see le_event_ServiceLoop()).
  *
  * @return
  *  - LE_OK if there is more to be done.
  *  - LE_WOULD_BLOCK if there were no events to process.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_event_ServiceLoop
+static le_result_t ServiceLoop
 (
-    void
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
     int epollFd = perThreadRecPtr->epollFd;
     struct epoll_event epollEventList[MAX_EPOLL_EVENTS];
 
@@ -1541,6 +2090,9 @@ le_result_t le_event_ServiceLoop
 
     int result;
 
+    // Pass on the changes made to the events monitored on fds before asking epoll about them.
+    fdMon_ApplyEpollUpdates(perThreadRecPtr);
+
     do
     {
         // If no events on the queue, try to refill the event queue.
@@ -1600,8 +2152,8 @@ le_result_t le_event_ServiceLoop
     }
 
     // Read the eventfd to reset it to zero so epoll stops telling us about it until more
-    // are added.
-    perThreadRecPtr->liveEventCount = ReadEventFd(perThreadRecPtr);
+    // are added, and fetch the batch of Reports that have been queued.
+    perThreadRecPtr->liveEventCount = FetchEventReports(perThreadRecPtr);
 
     // If events were read, process the top event
     if (perThreadRecPtr->liveEventCount--)
@@ -1617,3 +2169,86 @@ le_result_t le_event_ServiceLoop
 }
 
 
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Services the calling thread's Event Loop.
+ *
+ * @warning This function is only intended for use when integrating with legacy POSIX-based software
+ * that cannot be easily refactored to use the Legato Event Loop.  The preferred approach is
+ * to call le_event_RunLoop().
+ *
+ * See also: le_event_GetFd().
+ *
+ * @return
+ *  - LE_OK if there is more to be done.
+ *  - LE_WOULD_BLOCK if there were no events to process.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_event_ServiceLoop
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
+
+    // Each servicing step is a wake-up of the Event Loop.
+    bool wasCachingLoopTime = perThreadRecPtr->isCachingLoopTime;
+    perThreadRecPtr->isCachingLoopTime = true;
+    perThreadRecPtr->isLoopTimeValid = false;
+
+    // Batch the changes made by the handler to the events monitored on fds, and pass them on
+    // before returning to the caller (unless this is nested inside another handler), as the
+    // caller may be about to wait for the epoll fd to become readable.
+    bool wasBatching = perThreadRecPtr->isBatchingEpollUpdates;
+    perThreadRecPtr->isBatchingEpollUpdates = true;
+
+    le_result_t result = ServiceLoop(perThreadRecPtr);
+
+    perThreadRecPtr->isCachingLoopTime = wasCachingLoopTime;
+    perThreadRecPtr->isBatchingEpollUpdates = wasBatching;
+    if (!wasBatching)
+    {
+        fdMon_ApplyEpollUpdates(perThreadRecPtr);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time (see le_clk_GetRelativeTime()) at which the calling thread's Event Loop
+ * started handling its current batch of events.
+ *
+ * The clock is read the first time this is called after the Event Loop wakes up, and the same
+ * value is returned to all the handlers it then runs, so busy Event Loops don't read the clock
+ * for every handler.  In a thread whose Event Loop isn't being run (or serviced), this is the
+ * same as le_clk_GetRelativeTime().
+ *
+ * @return The relative time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_event_GetLoopTime
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
+
+    if (!perThreadRecPtr->isCachingLoopTime)
+    {
+        return le_clk_GetRelativeTime();
+    }
+
+    if (!perThreadRecPtr->isLoopTimeValid)
+    {
+        perThreadRecPtr->loopTime = le_clk_GetRelativeTime();
+        perThreadRecPtr->isLoopTimeValid = true;
+    }
+
+    return perThreadRecPtr->loopTime;
+}
@@ -10,12 +10,18 @@
  *
  * @section fdMonitor_Algorithm     Algorithm
  *
- * When a file descriptor event is detected by the Event Loop, fdMon_Report() is called with
+ * When a file descriptor event is detected by le_event_RunLoop(), fdMon_Dispatch() is called with
  * the FD Monitor Reference (a safe reference) and a bit map containing the events that were
- * detected.  fdMon_Report() queues a function call (DispatchToHandler()) to the calling thread.
- * When that function gets called, it does a look-up of the safe reference.  If it finds an
- * FD Monitor object matching that reference (it could have been deleted in the meantime), then
- * it calls its registered handler function for that event.
+ * detected, and calls DispatchToHandler() straight away.  le_event_ServiceLoop(), which handles
+ * one event per call, calls fdMon_Report() instead, which queues a function call
+ * (DispatchToHandler()) to the calling thread.  DispatchToHandler() does a look-up of the safe
+ * reference.  If it finds an FD Monitor object matching that reference (it could have been
+ * deleted in the meantime), then it calls its registered handler function for that event.
+ *
+ * Changes to the events monitored on an fd (le_fdMonitor_Enable(), le_fdMonitor_Disable(), etc.)
+ * made while the Event Loop is running handlers are not passed on to epoll straight away.  The
+ * FD Monitor is put on the thread's epoll update list instead, and fdMon_ApplyEpollUpdates() is
+ * called by the Event Loop before it next checks for fd events.
  *
  * The reason it was decided not to use Publish-Subscribe Events for this feature is that Event IDs
  * can't be deleted, and yet FD Monitors can.
@@ -91,6 +97,9 @@ typedef struct FdMonitor
     le_fdMonitor_HandlerFunc_t  handlerFunc;    ///< Handler function.
     void*                       contextPtr;     ///< The context pointer for this handler.
 
+    le_dls_Link_t           updateLink;         ///< Link in the thread's epoll update list.
+    bool                    isUpdatePending;    ///< true if on the thread's epoll update list.
+
     char        name[MAX_FD_MONITOR_NAME_BYTES];            ///< UTF-8 name of this object.
 }
 FdMonitor_t;
@@ -362,9 +371,15 @@ static void DeleteFdMonitor
 
     LE_ASSERT(perThreadRecPtr == fdMonitorPtr->threadRecPtr);
 
-    // Remove the FD Monitor from the thread's FD Monitor List.
+    // Remove the FD Monitor from the thread's FD Monitor List, and from its epoll update list.
     le_dls_Remove(&perThreadRecPtr->fdMonitorList, &fdMonitorPtr->link);
 
+    if (fdMonitorPtr->isUpdatePending)
+    {
+        le_dls_Remove(&perThreadRecPtr->epollUpdateList, &fdMonitorPtr->updateLink);
+        fdMonitorPtr->isUpdatePending = false;
+    }
+
     LOCK
 
     // Delete the Safe References used for the FD Monitor and any of its Handler objects.
@@ -445,8 +460,9 @@ static void DispatchToHandler
     // and le_fdMonitor_GetContextPtr() can find it.
     LE_ASSERT(pthread_setspecific(FDMonitorPtrKey, fdMonitorPtr) == 0);
 
-    // Set the thread's event loop Context Pointer.
+    // Set the thread's event loop Context Pointer, and name the real handler in its profile.
     event_SetCurrentContextPtr(fdMonitorPtr->contextPtr);
+    event_SetCurrentHandlerFunc(fdMonitorPtr->handlerFunc);
 
     // Call the handler function.
     fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, pollEvents);
@@ -470,20 +486,15 @@ static void DispatchToHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Update the epoll(7) FD for a given FD Monitor object.
+ * Pass the events monitored by a given FD Monitor object on to the epoll(7) FD.
  **/
 //--------------------------------------------------------------------------------------------------
-static void UpdateEpollFd
+static void ApplyEpollUpdate
 (
     FdMonitor_t*    monitorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (monitorPtr->isAlwaysReady)
-    {
-        return;
-    }
-
     struct epoll_event ev;
     memset(&ev, 0, sizeof(ev));
     ev.events = monitorPtr->epollEvents;
@@ -512,6 +523,41 @@ static void UpdateEpollFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the epoll(7) FD for a given FD Monitor object.
+ *
+ * While the thread's Event Loop is running handlers, the update is left on the thread's epoll
+ * update list for the Event Loop to apply before it next checks for fd events, so that an FD
+ * Monitor that is changed several times costs a single epoll_ctl() call.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateEpollFd
+(
+    FdMonitor_t*    monitorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (monitorPtr->isAlwaysReady)
+    {
+        return;
+    }
+
+    if (monitorPtr->threadRecPtr->isBatchingEpollUpdates)
+    {
+        if (!monitorPtr->isUpdatePending)
+        {
+            monitorPtr->isUpdatePending = true;
+            le_dls_Queue(&monitorPtr->threadRecPtr->epollUpdateList, &monitorPtr->updateLink);
+        }
+    }
+    else
+    {
+        ApplyEpollUpdate(monitorPtr);
+    }
+}
+
+
 
 // ==============================================
 //  INTER-MODULE FUNCTIONS
@@ -563,6 +609,8 @@ void fdMon_InitThread
 //--------------------------------------------------------------------------------------------------
 {
     perThreadRecPtr->fdMonitorList = LE_DLS_LIST_INIT;
+    perThreadRecPtr->epollUpdateList = LE_DLS_LIST_INIT;
+    perThreadRecPtr->isBatchingEpollUpdates = false;
 }
 
 
@@ -585,6 +633,51 @@ void fdMon_Report
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call the handler of an FD Monitor for events detected on its fd.
+ *
+ * This is called by the Event Loop when it detects events on a file descriptor that is being
+ * monitored, to handle them straight away rather than queueing them.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_Dispatch
+(
+    void*       safeRef,        ///< [in] Safe Reference for the FD Monitor object for the fd.
+    uint32_t    eventFlags      ///< [in] OR'd together event flags from epoll_wait().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DispatchToHandler(safeRef, (void*)(ssize_t)eventFlags);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass on to epoll the changes made to the events monitored by the calling thread's FD Monitors
+ * since this was last called.
+ *
+ * This is called by the Event Loop before it checks for fd events.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_ApplyEpollUpdates
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&perThreadRecPtr->epollUpdateList)) != NULL)
+    {
+        FdMonitor_t* monitorPtr = CONTAINER_OF(linkPtr, FdMonitor_t, updateLink);
+
+        monitorPtr->isUpdatePending = false;
+        ApplyEpollUpdate(monitorPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete all FD Monitor objects for the calling thread.
@@ -665,6 +758,8 @@ le_fdMonitor_Ref_t le_fdMonitor_Create
     fdMonitorPtr->threadRecPtr = perThreadRecPtr;
     fdMonitorPtr->handlerFunc = handlerFunc;
     fdMonitorPtr->contextPtr = NULL;
+    fdMonitorPtr->updateLink = LE_DLS_LINK_INIT;
+    fdMonitorPtr->isUpdatePending = false;
 
     // Copy the name into it.
     if (le_utf8_Copy(fdMonitorPtr->name, name, sizeof(fdMonitorPtr->name), NULL) == LE_OVERFLOW)
@@ -886,6 +981,53 @@ void le_fdMonitor_SetDeferrable
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets if events on a given fd are edge-triggered (the handler is only called when the fd
+ * becomes ready, so it must read or write until the fd would block) or level-triggered (the
+ * handler is called for as long as the fd is ready, which is the default).
+ *
+ * @note Edge-triggered monitoring saves the Event Loop from calling the handler again for data
+ *       that is already being dealt with, so it suits busy sockets and ttys whose handlers drain
+ *       the fd anyway.  It has no effect on fds that don't support epoll(7), such as regular files.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_fdMonitor_SetEdgeTriggered
+(
+    le_fdMonitor_Ref_t monitorRef,      ///< [in] Reference to the File Descriptor Monitor object.
+    bool               isEdgeTriggered  ///< [in] true (edge-triggered) or false (level-triggered).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Look up the File Descriptor Monitor object using the safe reference provided.
+    // Note that the safe reference map is shared by all threads in the process, so it
+    // must be protected using the mutex.  The File Descriptor Monitor objects, on the other
+    // hand, are only allowed to be accessed by the one thread that created them, so it is
+    // safe to unlock the mutex after doing the safe reference lookup.
+    LOCK
+    FdMonitor_t* monitorPtr = le_ref_Lookup(FdMonitorRefMap, monitorRef);
+    UNLOCK
+
+    LE_FATAL_IF(monitorPtr == NULL, "File Descriptor Monitor %p doesn't exist!", monitorRef);
+    LE_FATAL_IF(thread_GetEventRecPtr() != monitorPtr->threadRecPtr,
+                "FD Monitor '%s' (fd %d) is owned by another thread.",
+                monitorPtr->name,
+                monitorPtr->fd);
+
+    // Set/clear the EPOLLET flag in the FD Monitor's epoll(7) flags set.
+    if (isEdgeTriggered)
+    {
+        monitorPtr->epollEvents |= EPOLLET;
+    }
+    else
+    {
+        monitorPtr->epollEvents &= ~EPOLLET;
+    }
+
+    UpdateEpollFd(monitorPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the Context Pointer for File Descriptor Monitor's handler function.  This can be retrieved
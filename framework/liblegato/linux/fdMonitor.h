@@ -68,6 +68,35 @@ void fdMon_Report
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call the handler of an FD Monitor for events detected on its fd.
+ *
+ * This is called by the Event Loop when it detects events on a file descriptor that is being
+ * monitored, to handle them straight away rather than queueing them.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_Dispatch
+(
+    void*       safeRef,        ///< [in] Safe Reference for the FD Monitor object for the fd.
+    uint32_t    eventFlags      ///< [in] OR'd together event flags from epoll_wait().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass on to epoll the changes made to the events monitored by the calling thread's FD Monitors
+ * since this was last called.
+ *
+ * This is called by the Event Loop before it checks for fd events.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_ApplyEpollUpdates
+(
+    event_PerThreadRec_t* perThreadRecPtr
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete all FD Monitor objects for the calling thread.
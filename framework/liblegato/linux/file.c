@@ -10,6 +10,8 @@
 //--------------------------------------------------------------------------------------------------
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
 #include "legato.h"
 #include "smack.h"
 #include "fileDescriptor.h"
@@ -531,6 +533,100 @@ static le_result_t CreateDir
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ioctl that makes a file share the data blocks of another (a "reflink"), on file systems that
+ * support it.  Defined here because the kernel header that defines it clashes with sys/mount.h.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef FICLONE
+#define FICLONE     _IOW(0x94, 9, int)
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the data of one open file into another, newly created one, in the cheapest way available:
+ *
+ *  - by sharing the source's data blocks (a reflink), on file systems that support it, which costs
+ *    no I/O at all until one of the files is modified;
+ *  - with copy_file_range(), which lets the file system copy the data without going through the
+ *    page cache twice (and may also share blocks);
+ *  - with sendfile(), which copies the data in the kernel.
+ *
+ * Both files' offsets must be at the start of the files.
+ *
+ * @return - LE_OK if the copy was successful.
+ *         - LE_IO_ERROR if an IO error occurs during the copy operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyData
+(
+    int readFd,                 ///< [IN] File to copy from.
+    int writeFd,                ///< [IN] File to copy to.
+    off_t size                  ///< [IN] Number of bytes to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((size > 0) && (ioctl(writeFd, FICLONE, readFd) == 0))
+    {
+        return LE_OK;
+    }
+
+    bool useCopyFileRange = true;
+    off_t sizeWritten = 0;
+
+    // Get the kernel to copy the data over.  It may or may not happen in one go, so keep trying
+    // until the whole file has been written or we error out.
+    while (sizeWritten < size)
+    {
+        ssize_t nextWritten = -1;
+
+#ifdef SYS_copy_file_range
+        if (useCopyFileRange)
+        {
+            nextWritten = syscall(SYS_copy_file_range, readFd, NULL, writeFd, NULL,
+                                  (size_t)(size - sizeWritten), 0);
+
+            // Not supported by the kernel or between these files; sendfile() always is.
+            if (   (nextWritten == -1)
+                && (   (errno == ENOSYS) || (errno == EXDEV)
+                    || (errno == EINVAL) || (errno == EOPNOTSUPP)) )
+            {
+                useCopyFileRange = false;
+                continue;
+            }
+        }
+        else
+#endif
+        {
+            useCopyFileRange = false;
+            nextWritten = sendfile(writeFd, readFd, NULL, size - sizeWritten);
+        }
+
+        if (nextWritten == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return LE_IO_ERROR;
+        }
+
+        if (nextWritten == 0)
+        {
+            // The source file got shorter while we were copying it.
+            break;
+        }
+
+        sizeWritten += nextWritten;
+    }
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Copy a file.  This function copies the source file's owner, permissions and extended attributes
@@ -618,27 +714,12 @@ le_result_t file_Copy
         return result;
     }
 
-    // Get the kernel to copy the data over.  It may or may not happen in one go, so keep trying
-    // until the whole file has been written or we error out.
-    ssize_t sizeWritten = 0;
-    result = LE_OK;
-    off_t fileOffset = 0;
+    // Copy the data, sharing the source's data blocks if the file system supports it.
+    result = CopyData(readFd, writeFd, sourceStatus.st_size);
 
-    while (sizeWritten < sourceStatus.st_size)
+    if (result != LE_OK)
     {
-        ssize_t nextWritten = sendfile(writeFd,
-                                       readFd,
-                                       &fileOffset,
-                                       sourceStatus.st_size - sizeWritten);
-
-        if (nextWritten == -1)
-        {
-            LE_CRIT("Error when copying file '%s' to '%s'. (%m)", sourcePathPtr, destPathPtr);
-            result = LE_IO_ERROR;
-            break;
-        }
-
-        sizeWritten += nextWritten;
+        LE_CRIT("Error when copying file '%s' to '%s'. (%m)", sourcePathPtr, destPathPtr);
     }
 
     fd_Close(readFd);
@@ -650,24 +731,16 @@ le_result_t file_Copy
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy a batch of files recursively from one directory into another.  This function copies the
- * source files' owner, permissions and extended attributes to the destination files as well.
- *
- * @note Does not copy mounted files or any files under mounted directories.  Does not copy anything
- *       if the source path directory is empty.
- *
- * @return - LE_OK if the copy was successful.
- *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
- *           be opened.
- *         - LE_IO_ERROR if an IO error occurs during the copy operation.
- *         - LE_NOT_FOUND if source file or the destination directory does not exist.
+ * Recreate a directory tree somewhere else, either copying the files in it or hard linking them.
+ * See file_CopyRecursive() and file_LinkRecursive().
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t file_CopyRecursive
+static le_result_t CopyTree
 (
     const char* sourcePathPtr,  ///< [IN] Copy recursively from this path...
     const char* destPathPtr,    ///< [IN] To this path.
-    const char* smackLabelPtr   ///< [IN] If not NULL, the file will have this smack label set.
+    const char* smackLabelPtr,  ///< [IN] If not NULL, the file will have this smack label set.
+    bool linkFiles              ///< [IN] true to hard link regular files instead of copying them.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -682,10 +755,20 @@ le_result_t file_CopyRecursive
         return result;
     }
 
-    // If the source is a file, then just copy it.
+    // If the source is a file, then just copy (or link) it.
     if (S_ISREG(sourceStatus.st_mode))
     {
-        return file_Copy(sourcePathPtr, destPathPtr, smackLabelPtr);
+        if (!linkFiles)
+        {
+            return file_Copy(sourcePathPtr, destPathPtr, smackLabelPtr);
+        }
+        else if (link(sourcePathPtr, destPathPtr) != 0)
+        {
+            LE_CRIT("Failed to link '%s' to '%s'.  (%m)", destPathPtr, sourcePathPtr);
+            return LE_IO_ERROR;
+        }
+
+        return LE_OK;
     }
 
     // Now check the destination.
@@ -778,7 +861,16 @@ le_result_t file_CopyRecursive
             case FTS_F:
                 if (!fs_IsMountPoint(entPtr->fts_path))
                 {
-                    result = file_Copy(entPtr->fts_path, newPath, smackLabelPtr);
+                    if (!linkFiles)
+                    {
+                        result = file_Copy(entPtr->fts_path, newPath, smackLabelPtr);
+                    }
+                    else if (link(entPtr->fts_path, newPath) != 0)
+                    {
+                        LE_CRIT("Failed to link '%s' to '%s'.  (%m)", newPath, entPtr->fts_path);
+                        result = LE_IO_ERROR;
+                    }
+
                     if (result != LE_OK)
                     {
                         goto cleanup;
@@ -863,6 +955,60 @@ le_result_t file_CopyRecursive
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a batch of files recursively from one directory into another.  This function copies the
+ * source files' owner, permissions and extended attributes to the destination files as well.
+ *
+ * @note Does not copy mounted files or any files under mounted directories.  Does not copy anything
+ *       if the source path directory is empty.
+ *
+ * @return - LE_OK if the copy was successful.
+ *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
+ *           be opened.
+ *         - LE_IO_ERROR if an IO error occurs during the copy operation.
+ *         - LE_NOT_FOUND if source file or the destination directory does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_CopyRecursive
+(
+    const char* sourcePathPtr,  ///< [IN] Copy recursively from this path...
+    const char* destPathPtr,    ///< [IN] To this path.
+    const char* smackLabelPtr   ///< [IN] If not NULL, the file will have this smack label set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CopyTree(sourcePathPtr, destPathPtr, smackLabelPtr, false);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recreate a directory tree in another directory (on the same file system), hard linking the
+ * files in it instead of copying them.  Directories are created with the source directories'
+ * owner, permissions and extended attributes.
+ *
+ * @warning The files are shared, so they must not be modified in place afterwards.
+ *
+ * @note Does not link mounted files or any files under mounted directories.
+ *
+ * @return - LE_OK if successful.
+ *         - LE_NOT_PERMITTED if the destination path is not a directory.
+ *         - LE_IO_ERROR if an IO error occurs.
+ *         - LE_NOT_FOUND if source directory does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_LinkRecursive
+(
+    const char* sourcePathPtr,  ///< [IN] Link recursively from this path...
+    const char* destPathPtr     ///< [IN] To this path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CopyTree(sourcePathPtr, destPathPtr, NULL, true);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rename a file or directory.
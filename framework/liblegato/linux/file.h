@@ -135,6 +135,29 @@ le_result_t file_CopyRecursive
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recreate a directory tree in another directory (on the same file system), hard linking the
+ * files in it instead of copying them.  Directories are created with the source directories'
+ * owner, permissions and extended attributes.
+ *
+ * @warning The files are shared, so they must not be modified in place afterwards.
+ *
+ * @note Does not link mounted files or any files under mounted directories.
+ *
+ * @return - LE_OK if successful.
+ *         - LE_NOT_PERMITTED if the destination path is not a directory.
+ *         - LE_IO_ERROR if an IO error occurs.
+ *         - LE_NOT_FOUND if source directory does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_LinkRecursive
+(
+    const char* sourcePathPtr,  ///< [IN] Link recursively from this path...
+    const char* destPathPtr     ///< [IN] To this path.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rename a file or directory.
@@ -8,6 +8,16 @@
 #include "legato.h"
 #include "limit.h"
 #include "fileSystem.h"
+#include "fileDescriptor.h"
+#include <linux/loop.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times a free loop device is looked for, in case another process grabs it first.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_LOOP_DEV_ATTEMPTS       5
 
 
 //--------------------------------------------------------------------------------------------------
@@ -97,3 +107,158 @@ void fs_TryLazyUmount
         LE_CRIT("Could not lazy unmount '%s'.  %m.", pathPtr);
     }
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attach an image file to a free loop device, read-only.  The loop device is detached automatically
+ * when the last reference to it (i.e., the mount) goes away.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AttachLoopDev
+(
+    int imageFd,                    ///< [IN] Image file.
+    const char* imagePathPtr,       ///< [IN] Path of the image file.
+    char* loopPathPtr,              ///< [OUT] Path of the loop device.
+    size_t loopPathSize             ///< [IN] Size of the loop device path buffer.
+)
+{
+    int ctlFd = open("/dev/loop-control", O_RDWR | O_CLOEXEC);
+
+    if (ctlFd == -1)
+    {
+        LE_CRIT("Could not open '/dev/loop-control'.  %m.");
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_FAULT;
+    int attempt;
+
+    for (attempt = 0; attempt < MAX_LOOP_DEV_ATTEMPTS; attempt++)
+    {
+        int devNum = ioctl(ctlFd, LOOP_CTL_GET_FREE);
+
+        if (devNum < 0)
+        {
+            LE_CRIT("Could not get a free loop device.  %m.");
+            break;
+        }
+
+        LE_ASSERT(snprintf(loopPathPtr, loopPathSize, "/dev/loop%d", devNum) < loopPathSize);
+
+        int loopFd = open(loopPathPtr, O_RDONLY | O_CLOEXEC);
+
+        if (loopFd == -1)
+        {
+            LE_CRIT("Could not open '%s'.  %m.", loopPathPtr);
+            break;
+        }
+
+        if (ioctl(loopFd, LOOP_SET_FD, imageFd) == -1)
+        {
+            fd_Close(loopFd);
+
+            // Someone else took the device in the meantime, look for another one.
+            if (errno == EBUSY)
+            {
+                continue;
+            }
+
+            LE_CRIT("Could not attach '%s' to '%s'.  %m.", imagePathPtr, loopPathPtr);
+            break;
+        }
+
+        struct loop_info64 info;
+        memset(&info, 0, sizeof(info));
+        info.lo_flags = LO_FLAGS_READ_ONLY | LO_FLAGS_AUTOCLEAR;
+        LE_ASSERT(le_utf8_Copy((char*)info.lo_file_name, imagePathPtr,
+                               sizeof(info.lo_file_name), NULL) != LE_BAD_PARAMETER);
+
+        if (ioctl(loopFd, LOOP_SET_STATUS64, &info) == -1)
+        {
+            LE_CRIT("Could not set the status of '%s'.  %m.", loopPathPtr);
+            ioctl(loopFd, LOOP_CLR_FD, 0);
+        }
+        else
+        {
+            result = LE_OK;
+        }
+
+        fd_Close(loopFd);
+        break;
+    }
+
+    if (attempt == MAX_LOOP_DEV_ATTEMPTS)
+    {
+        LE_CRIT("No loop device could be attached to '%s'.", imagePathPtr);
+    }
+
+    fd_Close(ctlFd);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mount a file system image read-only, through a loop device that is released when the file system
+ * is unmounted.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fs_MountImage
+(
+    const char* imagePathPtr,       ///< [IN] Path of the image file.
+    const char* mountPathPtr,       ///< [IN] Mount point.
+    const char* fsTypePtr,          ///< [IN] Type of the file system in the image.
+    const char* optionsPtr          ///< [IN] File system specific mount options (can be NULL).
+)
+{
+    int imageFd = open(imagePathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (imageFd == -1)
+    {
+        LE_CRIT("Could not open '%s'.  %m.", imagePathPtr);
+        return LE_FAULT;
+    }
+
+    char loopPath[LIMIT_MAX_PATH_BYTES];
+    le_result_t result = AttachLoopDev(imageFd, imagePathPtr, loopPath, sizeof(loopPath));
+
+    // The loop device holds its own reference to the image file.
+    fd_Close(imageFd);
+
+    if (result != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    unsigned long flags = MS_RDONLY | MS_NODEV | MS_NOSUID;
+
+    if (mount(loopPath, mountPathPtr, fsTypePtr, flags, optionsPtr) == -1)
+    {
+        LE_CRIT("Could not mount '%s' (%s) at '%s'.  %m.", imagePathPtr, loopPath, mountPathPtr);
+
+        // Nothing else references the loop device, so it must be detached explicitly.
+        int loopFd = open(loopPath, O_RDONLY | O_CLOEXEC);
+
+        if (loopFd != -1)
+        {
+            ioctl(loopFd, LOOP_CLR_FD, 0);
+            fd_Close(loopFd);
+        }
+
+        return LE_FAULT;
+    }
+
+    LE_INFO("Mounted '%s' at '%s'.", imagePathPtr, mountPathPtr);
+
+    return LE_OK;
+}
@@ -43,4 +43,23 @@ void fs_TryLazyUmount
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mount a file system image read-only, through a loop device that is released when the file system
+ * is unmounted.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fs_MountImage
+(
+    const char* imagePathPtr,       ///< [IN] Path of the image file.
+    const char* mountPathPtr,       ///< [IN] Mount point.
+    const char* fsTypePtr,          ///< [IN] Type of the file system in the image.
+    const char* optionsPtr          ///< [IN] File system specific mount options (can be NULL).
+);
+
+
 #endif // LE_FILE_SYSTEM_H_INCLUDE_GUARD
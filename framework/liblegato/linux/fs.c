@@ -11,6 +11,7 @@
 #include "legato.h"
 #include "file.h"
 #include "dir.h"
+#include "fsAsync.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -423,6 +424,104 @@ le_result_t le_fs_Write
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Validate the parameters of an asynchronous read or write and start it.
+ *
+ * @return
+ *  - LE_OK             The transfer was started.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_BUSY           Too many transfers are in flight in the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartAsync
+(
+    bool isWrite,                       ///< [IN] true to write, false to read
+    le_fs_FileRef_t fileRef,            ///< [IN] File reference
+    int64_t offset,                     ///< [IN] Offset, or LE_FS_CURRENT_POSITION
+    void* bufPtr,                       ///< [IN] Buffer
+    size_t bufSize,                     ///< [IN] Number of bytes to transfer
+    le_fs_IoHandlerFunc_t handlerFunc,  ///< [IN] Completion handler
+    void* contextPtr                    ///< [IN] Context pointer passed to the handler
+)
+{
+    File_t* filePtr;
+
+    // Check if the pointers are set
+    if (NULL == bufPtr)
+    {
+        LE_ERROR("NULL buffer pointer!");
+        return LE_BAD_PARAMETER;
+    }
+    if (NULL == handlerFunc)
+    {
+        LE_ERROR("NULL handler pointer!");
+        return LE_BAD_PARAMETER;
+    }
+    if (offset < LE_FS_CURRENT_POSITION)
+    {
+        LE_ERROR("Wrong offset %" PRId64 "!", offset);
+        return LE_BAD_PARAMETER;
+    }
+
+    filePtr = le_ref_Lookup(FsFileRefMap, fileRef);
+    if (NULL == filePtr)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return fsAsync_Submit(isWrite, filePtr->fd, fileRef, offset, bufPtr, bufSize,
+                          handlerFunc, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to start reading from an opened file without waiting for the data.
+ * The handler is called by the calling thread's Event Loop once the read is done.
+ *
+ * @return
+ *  - LE_OK             The read was started.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_BUSY           Too many transfers are in flight in the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_ReadAsync
+(
+    le_fs_FileRef_t fileRef,           ///< [IN]  File reference
+    int64_t offset,                    ///< [IN]  Offset to read at, or LE_FS_CURRENT_POSITION
+    uint8_t* bufPtr,                   ///< [OUT] Buffer to store the data read in the file
+    size_t bufSize,                    ///< [IN]  Number of bytes to read
+    le_fs_IoHandlerFunc_t handlerFunc, ///< [IN]  Handler called when the read is done
+    void* contextPtr                   ///< [IN]  Context pointer passed to the handler
+)
+{
+    return StartAsync(false, fileRef, offset, bufPtr, bufSize, handlerFunc, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to start writing to an opened file without waiting for the data to be
+ * written.  The handler is called by the calling thread's Event Loop once the write is done.
+ *
+ * @return
+ *  - LE_OK             The write was started.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_BUSY           Too many transfers are in flight in the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_WriteAsync
+(
+    le_fs_FileRef_t fileRef,           ///< [IN] File reference
+    int64_t offset,                    ///< [IN] Offset to write at, or LE_FS_CURRENT_POSITION
+    const uint8_t* bufPtr,             ///< [IN] Buffer to write in the file
+    size_t bufSize,                    ///< [IN] Number of bytes to write
+    le_fs_IoHandlerFunc_t handlerFunc, ///< [IN] Handler called when the write is done
+    void* contextPtr                   ///< [IN] Context pointer passed to the handler
+)
+{
+    return StartAsync(true, fileRef, offset, (void*)bufPtr, bufSize, handlerFunc, contextPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is called to change the file position of an opened file.
@@ -844,4 +943,6 @@ end:
 
     // Create the Safe Reference Map to use for data profile object Safe References.
     FsFileRefMap = le_ref_CreateMap("FsFileRefMap", FS_MAX_FILE_REF);
+
+    fsAsync_Init();
 }
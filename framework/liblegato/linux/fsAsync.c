@@ -0,0 +1,675 @@
+/** @file fsAsync.c
+ *
+ * Asynchronous reads and writes for the File System service.  See fsAsync.h for the design.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "fsAsync.h"
+#include "fileDescriptor.h"
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#if defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HAVE_IO_URING
+#endif
+#endif
+
+#ifdef HAVE_IO_URING
+// Kernels that don't have this feature can't read or write at the current file position through
+// io_uring, so those operations go to the worker thread instead.
+#ifndef IORING_FEAT_RW_CUR_POS
+#define IORING_FEAT_RW_CUR_POS      0
+#endif
+#endif
+
+
+// ==============================
+//  PRIVATE DATA
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-thread state.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t inFlightCount;               ///< Number of operations in flight.
+#ifdef HAVE_IO_URING
+    int ringFd;                         ///< io_uring instance, or -1 if the thread has none.
+    uint32_t features;                  ///< io_uring features supported by the kernel.
+    int eventFd;                        ///< eventfd signalled by the kernel on completions.
+    le_fdMonitor_Ref_t monitorRef;      ///< Monitor of eventFd.
+    void* sqRingPtr;                    ///< Submission queue ring mapping.
+    size_t sqRingSize;                  ///< Size of sqRingPtr's mapping.
+    void* cqRingPtr;                    ///< Completion queue ring mapping.
+    size_t cqRingSize;                  ///< Size of cqRingPtr's mapping.
+    struct io_uring_sqe* sqesPtr;       ///< Submission queue entries mapping.
+    size_t sqesSize;                    ///< Size of sqesPtr's mapping.
+    unsigned* sqTailPtr;                ///< Submission queue tail, in sqRingPtr.
+    unsigned* sqMaskPtr;                ///< Submission queue index mask, in sqRingPtr.
+    unsigned* sqArrayPtr;               ///< Submission queue array, in sqRingPtr.
+    unsigned* cqHeadPtr;                ///< Completion queue head, in cqRingPtr.
+    unsigned* cqTailPtr;                ///< Completion queue tail, in cqRingPtr.
+    unsigned* cqMaskPtr;                ///< Completion queue index mask, in cqRingPtr.
+    struct io_uring_cqe* cqesPtr;       ///< Completion queue entries, in cqRingPtr.
+#endif
+}
+ThreadState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An asynchronous operation.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isWrite;                       ///< true for a write, false for a read.
+    int fd;                             ///< File descriptor.
+    int64_t offset;                     ///< Offset, or LE_FS_CURRENT_POSITION.
+    struct iovec iov;                   ///< Buffer.
+    le_fs_FileRef_t fileRef;            ///< File reference, passed to the handler.
+    le_fs_IoHandlerFunc_t handlerFunc;  ///< Completion handler.
+    void* contextPtr;                   ///< Context pointer passed to the handler.
+    ThreadState_t* statePtr;            ///< State of the submitting thread.
+    le_thread_Ref_t threadRef;          ///< Submitting thread.
+    ssize_t result;                     ///< Number of bytes transferred, or -errno.
+}
+Request_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of per-thread states.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ThreadStatePool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of operations.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RequestPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the thread-local pointer to the thread's state.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t ThreadStateKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread, started the first time an operation can't go through io_uring.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t WorkerThreadRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the start of the worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t WorkerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+#ifdef HAVE_IO_URING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set once io_uring turned out to be unavailable, so that other threads don't try again.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsIoUringUnavailable;
+#endif
+
+
+// ==============================
+//  PRIVATE FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish an operation in the submitting thread: release it and call its handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteRequest
+(
+    Request_t* reqPtr                   ///< [IN] Operation.
+)
+{
+    le_fs_FileRef_t fileRef = reqPtr->fileRef;
+    le_fs_IoHandlerFunc_t handlerFunc = reqPtr->handlerFunc;
+    void* contextPtr = reqPtr->contextPtr;
+    le_result_t result = LE_OK;
+    size_t numBytes = 0;
+
+    if (reqPtr->result < 0)
+    {
+        errno = -reqPtr->result;
+        LE_DEBUG("Asynchronous %s failed (%m).", reqPtr->isWrite ? "write" : "read");
+        result = LE_FAULT;
+    }
+    else
+    {
+        numBytes = reqPtr->result;
+
+        if (reqPtr->isWrite && (numBytes != reqPtr->iov.iov_len))
+        {
+            result = LE_UNDERFLOW;
+        }
+    }
+
+    reqPtr->statePtr->inFlightCount--;
+    le_mem_Release(reqPtr);
+
+    handlerFunc(fileRef, result, numBytes, contextPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the submitting thread once the worker thread has done an operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WorkerDone
+(
+    void* reqPtr,                       ///< [IN] Operation.
+    void* unusedPtr                     ///< [IN] Unused.
+)
+{
+    CompleteRequest(reqPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do an operation in the worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DoIo
+(
+    void* param1Ptr,                    ///< [IN] Operation.
+    void* unusedPtr                     ///< [IN] Unused.
+)
+{
+    Request_t* reqPtr = param1Ptr;
+    ssize_t rc;
+
+    do
+    {
+        if (reqPtr->offset == LE_FS_CURRENT_POSITION)
+        {
+            rc = reqPtr->isWrite ? write(reqPtr->fd, reqPtr->iov.iov_base, reqPtr->iov.iov_len)
+                                 : read(reqPtr->fd, reqPtr->iov.iov_base, reqPtr->iov.iov_len);
+        }
+        else
+        {
+            rc = reqPtr->isWrite ? pwrite(reqPtr->fd, reqPtr->iov.iov_base, reqPtr->iov.iov_len,
+                                          reqPtr->offset)
+                                 : pread(reqPtr->fd, reqPtr->iov.iov_base, reqPtr->iov.iov_len,
+                                         reqPtr->offset);
+        }
+    }
+    while ((rc == -1) && (errno == EINTR));
+
+    reqPtr->result = (rc == -1) ? -errno : rc;
+
+    le_event_QueueFunctionToThread(reqPtr->threadRef, WorkerDone, reqPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* semRef                        ///< [IN] Semaphore to post once the thread is running.
+)
+{
+    le_sem_Post(semRef);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the worker thread, starting it if needed.
+ *
+ * @return The worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t GetWorkerThread
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&WorkerMutex) == 0);
+
+    if (WorkerThreadRef == NULL)
+    {
+        // Functions can only be queued to the thread once its Event Loop is initialized.
+        le_sem_Ref_t semRef = le_sem_Create("FsAsyncStart", 0);
+
+        WorkerThreadRef = le_thread_Create("FsAsync", WorkerMain, semRef);
+        le_thread_Start(WorkerThreadRef);
+
+        le_sem_Wait(semRef);
+        le_sem_Delete(semRef);
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&WorkerMutex) == 0);
+
+    return WorkerThreadRef;
+}
+
+
+#ifdef HAVE_IO_URING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the io_uring instance of a thread, if it has one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DestroyRing
+(
+    ThreadState_t* statePtr             ///< [IN] Thread state.
+)
+{
+    if (statePtr->monitorRef != NULL)
+    {
+        le_fdMonitor_Delete(statePtr->monitorRef);
+        statePtr->monitorRef = NULL;
+    }
+
+    if (statePtr->eventFd != -1)
+    {
+        fd_Close(statePtr->eventFd);
+        statePtr->eventFd = -1;
+    }
+
+    if (statePtr->sqesPtr != NULL)
+    {
+        munmap(statePtr->sqesPtr, statePtr->sqesSize);
+        statePtr->sqesPtr = NULL;
+    }
+
+    if (statePtr->cqRingPtr != NULL)
+    {
+        munmap(statePtr->cqRingPtr, statePtr->cqRingSize);
+        statePtr->cqRingPtr = NULL;
+    }
+
+    if (statePtr->sqRingPtr != NULL)
+    {
+        munmap(statePtr->sqRingPtr, statePtr->sqRingSize);
+        statePtr->sqRingPtr = NULL;
+    }
+
+    if (statePtr->ringFd != -1)
+    {
+        fd_Close(statePtr->ringFd);
+        statePtr->ringFd = -1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map one of the regions of an io_uring instance.
+ *
+ * @return The mapping, or NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* MapRing
+(
+    int ringFd,                         ///< [IN] io_uring instance.
+    size_t size,                        ///< [IN] Size of the region.
+    off_t offset                        ///< [IN] Region (IORING_OFF_xxx).
+)
+{
+    void* addrPtr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                         offset);
+
+    return (addrPtr == MAP_FAILED) ? NULL : addrPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the completion eventfd of a thread's io_uring instance.  Calls the handlers of all
+ * the completed operations.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingHandler
+(
+    int fd,                             ///< [IN] The eventfd.
+    short events                        ///< [IN] Events.
+)
+{
+    ThreadState_t* statePtr = le_fdMonitor_GetContextPtr();
+    uint64_t count;
+
+    if (read(fd, &count, sizeof(count)) == -1)
+    {
+        // Nothing to reap if the count was already reset.
+        return;
+    }
+
+    // Only this thread moves the head, so it can be kept locally.  The handlers may start new
+    // operations, which is fine as the submission queue is separate.
+    unsigned head = *statePtr->cqHeadPtr;
+
+    while (head != __atomic_load_n(statePtr->cqTailPtr, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_cqe* cqePtr = &statePtr->cqesPtr[head & *statePtr->cqMaskPtr];
+        Request_t* reqPtr = (Request_t*)(uintptr_t)cqePtr->user_data;
+
+        reqPtr->result = cqePtr->res;
+
+        head++;
+        __atomic_store_n(statePtr->cqHeadPtr, head, __ATOMIC_RELEASE);
+
+        CompleteRequest(reqPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the io_uring instance of the calling thread.
+ *
+ * @return true if successful, false if io_uring can't be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CreateRing
+(
+    ThreadState_t* statePtr             ///< [IN] Thread state.
+)
+{
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+
+    statePtr->ringFd = syscall(__NR_io_uring_setup, FS_ASYNC_MAX_IN_FLIGHT, &params);
+
+    if (statePtr->ringFd == -1)
+    {
+        LE_INFO("io_uring is not available (%m); asynchronous file I/O will use a worker thread.");
+        IsIoUringUnavailable = true;
+        return false;
+    }
+
+    statePtr->features = params.features;
+    statePtr->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    statePtr->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    statePtr->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    statePtr->sqRingPtr = MapRing(statePtr->ringFd, statePtr->sqRingSize, IORING_OFF_SQ_RING);
+    statePtr->cqRingPtr = MapRing(statePtr->ringFd, statePtr->cqRingSize, IORING_OFF_CQ_RING);
+    statePtr->sqesPtr = MapRing(statePtr->ringFd, statePtr->sqesSize, IORING_OFF_SQES);
+
+    if (   (statePtr->sqRingPtr == NULL)
+        || (statePtr->cqRingPtr == NULL)
+        || (statePtr->sqesPtr == NULL) )
+    {
+        LE_WARN("Failed to map io_uring queues (%m).");
+        DestroyRing(statePtr);
+        return false;
+    }
+
+    uint8_t* sqPtr = statePtr->sqRingPtr;
+    uint8_t* cqPtr = statePtr->cqRingPtr;
+
+    statePtr->sqTailPtr = (unsigned*)(sqPtr + params.sq_off.tail);
+    statePtr->sqMaskPtr = (unsigned*)(sqPtr + params.sq_off.ring_mask);
+    statePtr->sqArrayPtr = (unsigned*)(sqPtr + params.sq_off.array);
+    statePtr->cqHeadPtr = (unsigned*)(cqPtr + params.cq_off.head);
+    statePtr->cqTailPtr = (unsigned*)(cqPtr + params.cq_off.tail);
+    statePtr->cqMaskPtr = (unsigned*)(cqPtr + params.cq_off.ring_mask);
+    statePtr->cqesPtr = (struct io_uring_cqe*)(cqPtr + params.cq_off.cqes);
+
+    statePtr->eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (   (statePtr->eventFd == -1)
+        || (syscall(__NR_io_uring_register, statePtr->ringFd, IORING_REGISTER_EVENTFD,
+                    &statePtr->eventFd, 1) == -1) )
+    {
+        LE_WARN("Failed to set up io_uring completion notifications (%m).");
+        DestroyRing(statePtr);
+        return false;
+    }
+
+    statePtr->monitorRef = le_fdMonitor_Create("FsAsync", statePtr->eventFd, RingHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(statePtr->monitorRef, statePtr);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an operation through the calling thread's io_uring instance.
+ *
+ * @return true if the operation was started, false if it must go to the worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SubmitToRing
+(
+    ThreadState_t* statePtr,            ///< [IN] Thread state.
+    Request_t* reqPtr                   ///< [IN] Operation.
+)
+{
+    if (statePtr->ringFd == -1)
+    {
+        return false;
+    }
+
+    bool isAtCurrentPos = (reqPtr->offset == LE_FS_CURRENT_POSITION);
+
+    if (isAtCurrentPos && ((statePtr->features & IORING_FEAT_RW_CUR_POS) == 0))
+    {
+        return false;
+    }
+
+    // There are never more operations in flight than submission queue entries, and the kernel
+    // consumes the entries as soon as they are submitted, so there is always a free entry.
+    unsigned tail = *statePtr->sqTailPtr;
+    unsigned index = tail & *statePtr->sqMaskPtr;
+    struct io_uring_sqe* sqePtr = &statePtr->sqesPtr[index];
+
+    memset(sqePtr, 0, sizeof(*sqePtr));
+    sqePtr->opcode = reqPtr->isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqePtr->fd = reqPtr->fd;
+    sqePtr->addr = (uintptr_t)&reqPtr->iov;
+    sqePtr->len = 1;
+    sqePtr->off = (uint64_t)reqPtr->offset;
+    sqePtr->user_data = (uintptr_t)reqPtr;
+
+    // Operations at the current position must be done in order, as they move the position.
+    if (isAtCurrentPos)
+    {
+        sqePtr->flags = IOSQE_IO_DRAIN;
+    }
+
+    statePtr->sqArrayPtr[index] = index;
+    __atomic_store_n(statePtr->sqTailPtr, tail + 1, __ATOMIC_RELEASE);
+
+    int rc;
+
+    do
+    {
+        rc = syscall(__NR_io_uring_enter, statePtr->ringFd, 1, 0, 0, NULL, 0);
+    }
+    while ((rc == -1) && (errno == EINTR));
+
+    if (rc != 1)
+    {
+        // The entry wasn't consumed, so take it back.
+        LE_WARN("Failed to submit to io_uring (%m).");
+        __atomic_store_n(statePtr->sqTailPtr, tail, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the state of a thread that is exiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DestructThreadState
+(
+    void* contextPtr                    ///< [IN] Thread state.
+)
+{
+    ThreadState_t* statePtr = contextPtr;
+
+    if (statePtr->inFlightCount > 0)
+    {
+        LE_WARN("Thread exiting with %zu asynchronous file operations in flight.",
+                statePtr->inFlightCount);
+    }
+
+#ifdef HAVE_IO_URING
+    DestroyRing(statePtr);
+#endif
+
+    LE_ASSERT(pthread_setspecific(ThreadStateKey, NULL) == 0);
+    le_mem_Release(statePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the calling thread's state, creating it if needed.
+ *
+ * @return The thread state.
+ */
+//--------------------------------------------------------------------------------------------------
+static ThreadState_t* GetThreadState
+(
+    void
+)
+{
+    ThreadState_t* statePtr = pthread_getspecific(ThreadStateKey);
+
+    if (statePtr != NULL)
+    {
+        return statePtr;
+    }
+
+    statePtr = le_mem_ForceAlloc(ThreadStatePool);
+    memset(statePtr, 0, sizeof(*statePtr));
+
+#ifdef HAVE_IO_URING
+    statePtr->ringFd = -1;
+    statePtr->eventFd = -1;
+
+    if (!IsIoUringUnavailable)
+    {
+        CreateRing(statePtr);
+    }
+#endif
+
+    le_thread_AddDestructor(DestructThreadState, statePtr);
+    LE_ASSERT(pthread_setspecific(ThreadStateKey, statePtr) == 0);
+
+    return statePtr;
+}
+
+
+// ==============================
+//  INTERNAL FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the asynchronous operations module.
+ *
+ * Called by fs_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void fsAsync_Init
+(
+    void
+)
+{
+    ThreadStatePool = le_mem_CreatePool("FsAsyncThread", sizeof(ThreadState_t));
+    RequestPool = le_mem_CreatePool("FsAsyncRequest", sizeof(Request_t));
+
+    LE_ASSERT(pthread_key_create(&ThreadStateKey, NULL) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an asynchronous read or write.
+ *
+ * @return
+ *  - LE_OK     The operation was started; the handler will be called once it's done.
+ *  - LE_BUSY   The calling thread already has FS_ASYNC_MAX_IN_FLIGHT operations in flight.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fsAsync_Submit
+(
+    bool isWrite,                           ///< [IN] true to write, false to read.
+    int fd,                                 ///< [IN] File descriptor.
+    le_fs_FileRef_t fileRef,                ///< [IN] File reference, passed to the handler.
+    int64_t offset,                         ///< [IN] Offset, or LE_FS_CURRENT_POSITION.
+    void* bufPtr,                           ///< [IN] Buffer to read into or write from.
+    size_t bufSize,                         ///< [IN] Number of bytes to read or write.
+    le_fs_IoHandlerFunc_t handlerFunc,      ///< [IN] Completion handler.
+    void* contextPtr                        ///< [IN] Context pointer passed to the handler.
+)
+{
+    ThreadState_t* statePtr = GetThreadState();
+
+    if (statePtr->inFlightCount >= FS_ASYNC_MAX_IN_FLIGHT)
+    {
+        return LE_BUSY;
+    }
+
+    Request_t* reqPtr = le_mem_ForceAlloc(RequestPool);
+
+    reqPtr->isWrite = isWrite;
+    reqPtr->fd = fd;
+    reqPtr->offset = offset;
+    reqPtr->iov.iov_base = bufPtr;
+    reqPtr->iov.iov_len = bufSize;
+    reqPtr->fileRef = fileRef;
+    reqPtr->handlerFunc = handlerFunc;
+    reqPtr->contextPtr = contextPtr;
+    reqPtr->statePtr = statePtr;
+    reqPtr->threadRef = le_thread_GetCurrent();
+    reqPtr->result = 0;
+
+    statePtr->inFlightCount++;
+
+#ifdef HAVE_IO_URING
+    if (SubmitToRing(statePtr, reqPtr))
+    {
+        return LE_OK;
+    }
+#endif
+
+    le_event_QueueFunctionToThread(GetWorkerThread(), DoIo, reqPtr, NULL);
+
+    return LE_OK;
+}
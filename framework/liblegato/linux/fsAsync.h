@@ -0,0 +1,61 @@
+/** @file fsAsync.h
+ *
+ * Asynchronous reads and writes for the File System service.
+ *
+ * Each thread that starts asynchronous operations gets its own io_uring instance, whose
+ * completions are signalled through an eventfd monitored by the thread's Event Loop, so the
+ * completion handlers are called in that thread without any locking.  Where io_uring is not
+ * available (old kernel, or disabled by the system), the operations are run by a worker thread
+ * shared by the whole process, which queues the handlers back to the submitting thread.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef FS_ASYNC_INCLUDE_GUARD
+#define FS_ASYNC_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of asynchronous operations in flight per thread.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FS_ASYNC_MAX_IN_FLIGHT      32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the asynchronous operations module.
+ *
+ * Called by fs_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void fsAsync_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an asynchronous read or write.
+ *
+ * @return
+ *  - LE_OK     The operation was started; the handler will be called once it's done.
+ *  - LE_BUSY   The calling thread already has FS_ASYNC_MAX_IN_FLIGHT operations in flight.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fsAsync_Submit
+(
+    bool isWrite,                           ///< [IN] true to write, false to read.
+    int fd,                                 ///< [IN] File descriptor.
+    le_fs_FileRef_t fileRef,                ///< [IN] File reference, passed to the handler.
+    int64_t offset,                         ///< [IN] Offset, or LE_FS_CURRENT_POSITION.
+    void* bufPtr,                           ///< [IN] Buffer to read into or write from.
+    size_t bufSize,                         ///< [IN] Number of bytes to read or write.
+    le_fs_IoHandlerFunc_t handlerFunc,      ///< [IN] Completion handler.
+    void* contextPtr                        ///< [IN] Context pointer passed to the handler.
+);
+
+
+#endif  // FS_ASYNC_INCLUDE_GUARD
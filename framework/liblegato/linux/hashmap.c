@@ -1,4 +1,13 @@
 /** @file hashmap.c
+ *
+ * Maps grow (and, if le_hashmap_EnableShrink() has been called, shrink) automatically.  To keep
+ * the cost of a resize from landing on a single operation, the entries are migrated from the old
+ * bucket table to the new one a few buckets at a time: every Put and Remove migrates
+ * MIGRATE_BUCKETS_PER_OP of the old buckets.  Lookups don't modify the map: while a migration is
+ * in progress, a key is looked up in the old table if its old bucket hasn't been migrated yet, and
+ * in the new table otherwise.  Operations that walk the whole map (iteration, ForEach, etc.)
+ * finish any migration first, and a resize is put off while a step-by-step iteration is in
+ * progress (unless the map has become badly overloaded), so the iterator semantics are unchanged.
  *
  * Copyright (C) Sierra Wireless Inc.
  *
@@ -18,7 +27,6 @@
  */
 
 #include "legato.h"
-#include "hsieh_hash.h"
 #include "limit.h"
 #include "hashmap.h"
 
@@ -37,8 +45,82 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Calculate a hash. First this calls the user-supplied hash function.
- * Then it does some defensive coding to avoid bad hashes from outside hash functions
+ * Number of old buckets migrated to the new bucket table by each Put or Remove while a resize is
+ * in progress.  Since a map doubles in size when its load factor exceeds 0.75, this guarantees
+ * that a migration completes well before the next one is needed.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MIGRATE_BUCKETS_PER_OP  4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Multiplier of the string hash (from MurmurHash64A, by Austin Appleby, in the public domain).
+ **/
+//--------------------------------------------------------------------------------------------------
+#define HASH_MULTIPLIER     0xc6a4a7935bd1e995ULL
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash a string, eight bytes at a time.  The seed is mixed in first, so strings that collide
+ * with one seed don't collide with another.
+ *
+ * This only uses 64-bit multiplies (no 128-bit products), so it is also cheap on 32-bit targets.
+ *
+ * @return  Returns the hash of the string.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t HashString
+(
+    const char* strPtr,         ///< [in] The string.
+    uint64_t seed               ///< [in] The seed.
+)
+{
+    size_t len = strlen(strPtr);
+    const uint8_t* posPtr = (const uint8_t*)strPtr;
+    const uint8_t* endPtr = posPtr + (len & ~(size_t)7);
+    uint64_t h = seed ^ (len * HASH_MULTIPLIER);
+
+    for (; posPtr != endPtr; posPtr += sizeof(uint64_t))
+    {
+        uint64_t k;
+
+        memcpy(&k, posPtr, sizeof(k));
+        k *= HASH_MULTIPLIER;
+        k ^= k >> 47;
+        k *= HASH_MULTIPLIER;
+        h ^= k;
+        h *= HASH_MULTIPLIER;
+    }
+
+    switch (len & 7)
+    {
+        case 7: h ^= (uint64_t)posPtr[6] << 48;     // fall through
+        case 6: h ^= (uint64_t)posPtr[5] << 40;     // fall through
+        case 5: h ^= (uint64_t)posPtr[4] << 32;     // fall through
+        case 4: h ^= (uint64_t)posPtr[3] << 24;     // fall through
+        case 3: h ^= (uint64_t)posPtr[2] << 16;     // fall through
+        case 2: h ^= (uint64_t)posPtr[1] << 8;      // fall through
+        case 1: h ^= (uint64_t)posPtr[0];
+                h *= HASH_MULTIPLIER;
+    }
+
+    h ^= h >> 47;
+    h *= HASH_MULTIPLIER;
+    h ^= h >> 47;
+
+    // Fold the upper half in, so it isn't lost where size_t is 32 bits.
+    return (size_t)(h ^ (h >> 32));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculate a hash.  The built-in hash functions are inlined, to avoid the indirect call for the
+ * most common key types; otherwise this calls the user-supplied hash function.  Then, except for
+ * the string hash, which is already well mixed, it does some defensive coding to avoid bad hashes
+ * from outside hash functions.
  *
  * @param map A pointer to the hashmap instance
  * @param key A pointer to the key to hash
@@ -47,10 +129,34 @@
  */
 //--------------------------------------------------------------------------------------------------
 static inline size_t HashKey(Hashmap_t* map, const void* key) {
-    size_t h = map->hashFuncPtr(key);
+    le_hashmap_HashFunc_t hashFuncPtr = map->hashFuncPtr;
+    size_t h;
+
+    if (hashFuncPtr == le_hashmap_HashString)
+    {
+        return HashString(key, map->seed);
+    }
+    else if (hashFuncPtr == le_hashmap_HashUInt32)
+    {
+        h = *((const uint32_t*)key);
+    }
+    else if (hashFuncPtr == le_hashmap_HashUInt64)
+    {
+        uint64_t k = *((const uint64_t*)key);
+        h = (size_t)(k ^ (k >> 32));
+    }
+    else if (hashFuncPtr == le_hashmap_HashVoidPointer)
+    {
+        h = (size_t)key;
+    }
+    else
+    {
+        h = hashFuncPtr(key);
+    }
 
-    // If the Hseih hash has been used then we can just return h
-    if (map->hashFuncPtr == &le_hashmap_HashString) return h;
+    // The seed only varies how other keys spread over the buckets: keys whose hashes collide
+    // still collide whatever the seed.
+    h ^= (size_t)map->seed;
 
     // We apply this secondary hashing discovered by Doug Lea to defend
     // against bad hashes. This is important for user-supplied hash fns
@@ -59,84 +165,1025 @@ static inline size_t HashKey(Hashmap_t* map, const void* key) {
     h += (h << 4);
     h ^= (((unsigned int) h) >> 10);
 
-    return h;
+    return h;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new entry to put in the map. Allocates the entry from the pool which was created
+ * during construction of the map.
+ *
+ * @param newKeyPtr A pointer to the key
+ * @param newHash The calculated hash
+ * @param newValuePtr A pointer to the value
+ * @param poolRef A memory pool reference to use for allocating memory. This pool must have been
+ * created as a pool of Entry_t.
+ * @return  Returns a pointer to the newly allocated and filled-in Entry_t
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* CreateEntry
+(
+    const void* newKeyPtr,
+    int newHash,
+    const void* newValuePtr,
+    le_mem_PoolRef_t poolRef
+)
+{
+    Entry_t* entryPtr = le_mem_ForceAlloc(poolRef);
+    LE_ASSERT(entryPtr);
+
+    entryPtr->keyPtr = newKeyPtr;
+    entryPtr->hash = newHash;
+    entryPtr->valuePtr = newValuePtr;
+    entryPtr->entryListLink = LE_DLS_LINK_INIT;
+    return entryPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Given a hash and a map size, calculate the index at which to store the entry
+ *
+ * @param bucketCount The number of buckets in the map
+ * @param hash The hash to use
+ * @return  Returns the index to use in the bucket array
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t CalculateIndex(size_t bucketCount, size_t hash) {
+    return (hash) & (bucketCount - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if 2 keys are equal (or are actually the same key)
+ *
+ * @param keyAPtr Pointer to the first key
+ * @param hashA The hash of the first key
+ * @param keyBPtr Pointer to the second key
+ * @param hashB The hash of the second key
+ * @param equalsFuncPtr The equality function in use by the map
+ * @return  Returns true if the keys are identical, false otherwise
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool EqualKeys
+(
+    const void* keyAPtr,
+    int hashA,
+    const void* keyBPtr,
+    int hashB,
+    le_hashmap_EqualsFunc_t equalsFuncPtr
+)
+{
+    if (keyAPtr == keyBPtr) {
+        return true;
+    }
+    if (hashA != hashB) {
+        return false;
+    }
+    return equalsFuncPtr(keyAPtr, keyBPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates and initializes a table of empty buckets along with its array of chain lengths.
+ *
+ * @note Terminates the process on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateBuckets
+(
+    size_t bucketCount,                 ///< [in] Number of buckets (must be a power of 2).
+    le_dls_List_t** bucketsPtrPtr,      ///< [out] The bucket array.
+    size_t** chainLengthPtrPtr          ///< [out] The chain length array.
+)
+{
+    le_dls_List_t* bucketsPtr = malloc(bucketCount * sizeof(le_dls_List_t));
+    LE_ASSERT(bucketsPtr);
+    size_t* chainLengthPtr = malloc(bucketCount * sizeof(size_t));
+    LE_ASSERT(chainLengthPtr);
+
+    size_t i;
+    for (i = 0; i < bucketCount; i++)
+    {
+        bucketsPtr[i] = LE_DLS_LIST_INIT;
+        chainLengthPtr[i] = 0;
+    }
+
+    *bucketsPtrPtr = bucketsPtr;
+    *chainLengthPtrPtr = chainLengthPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the bucket that an entry with a given hash is (or would be) stored in.  While a resize is
+ * in progress, this is the bucket in the old table if that bucket hasn't been migrated yet.
+ *
+ * @return Pointer to the bucket's list head.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t* GetBucket
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    size_t hash,                        ///< [in] The hash of the key.
+    size_t** chainLengthPtrPtr          ///< [out] Pointer to the bucket's chain length.
+)
+{
+    if (mapRef->oldBucketsPtr != NULL)
+    {
+        size_t oldIndex = CalculateIndex(mapRef->oldBucketCount, hash);
+
+        if (oldIndex >= mapRef->migrateIndex)
+        {
+            *chainLengthPtrPtr = &(mapRef->oldChainLengthPtr[oldIndex]);
+            return &(mapRef->oldBucketsPtr[oldIndex]);
+        }
+    }
+
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    *chainLengthPtrPtr = &(mapRef->chainLengthPtr[index]);
+    return &(mapRef->bucketsPtr[index]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves all the entries in the next old bucket to the new bucket table, and frees the old table
+ * once it is empty.  Must only be called while a resize is in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MigrateBucket
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    le_dls_List_t* oldListPtr = &(mapRef->oldBucketsPtr[mapRef->migrateIndex]);
+    le_dls_Link_t* linkPtr;
+
+    // Queue the entries onto their new buckets in their original order.
+    while ((linkPtr = le_dls_Pop(oldListPtr)) != NULL)
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, entryListLink);
+        size_t index = CalculateIndex(mapRef->bucketCount, entryPtr->hash);
+
+        le_dls_Queue(&(mapRef->bucketsPtr[index]), linkPtr);
+        mapRef->chainLengthPtr[index]++;
+    }
+
+    mapRef->oldChainLengthPtr[mapRef->migrateIndex] = 0;
+    mapRef->migrateIndex++;
+
+    if (mapRef->migrateIndex >= mapRef->oldBucketCount)
+    {
+        free(mapRef->oldBucketsPtr);
+        free(mapRef->oldChainLengthPtr);
+        mapRef->oldBucketsPtr = NULL;
+        mapRef->oldChainLengthPtr = NULL;
+        mapRef->oldBucketCount = 0;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Resize to %zu buckets complete",
+            mapRef->nameStr,
+            mapRef->bucketCount
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs one increment of an in-progress resize, if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void MigrateStep
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    int i;
+    for (i = 0; (i < MIGRATE_BUCKETS_PER_OP) && (mapRef->oldBucketsPtr != NULL); i++)
+    {
+        MigrateBucket(mapRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completes an in-progress resize, if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishMigration
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    while (mapRef->oldBucketsPtr != NULL)
+    {
+        MigrateBucket(mapRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts resizing the map to a new number of buckets.  The entries are migrated to the new
+ * buckets incrementally by subsequent map operations.
+ *
+ * The resize is skipped if a step-by-step iteration is in progress (it will be retried by a later
+ * Put or Remove), unless the map has grown to more than twice as many entries as buckets.  That
+ * ends the iteration, but stops an abandoned iterator from leaving the map overloaded for good.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartResize
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    size_t newBucketCount               ///< [in] The new number of buckets (a power of 2).
+)
+{
+    if (   mapRef->iteratorPtr->isActive
+        && (mapRef->size <= (mapRef->bucketCount * 2)) )
+    {
+        return;
+    }
+
+    // A previous resize must be complete before starting another.  This doesn't normally happen,
+    // because each operation migrates enough buckets for it to be finished long before.
+    FinishMigration(mapRef);
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Resizing from %zu to %zu buckets (size %zu)",
+        mapRef->nameStr,
+        mapRef->bucketCount,
+        newBucketCount,
+        mapRef->size
+    );
+
+    mapRef->oldBucketsPtr = mapRef->bucketsPtr;
+    mapRef->oldChainLengthPtr = mapRef->chainLengthPtr;
+    mapRef->oldBucketCount = mapRef->bucketCount;
+    mapRef->migrateIndex = 0;
+
+    CreateBuckets(newBucketCount, &(mapRef->bucketsPtr), &(mapRef->chainLengthPtr));
+    mapRef->bucketCount = newBucketCount;
+
+    // The iterator's position refers to the old table, so leave it parked at the end of the map.
+    mapRef->iteratorPtr->currentIndex = newBucketCount;
+    mapRef->iteratorPtr->currentListPtr = NULL;
+    mapRef->iteratorPtr->currentLinkPtr = NULL;
+    mapRef->iteratorPtr->isValueValid = false;
+    mapRef->iteratorPtr->isActive = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts growing the map if it has become too full.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CheckGrow
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    // Keep the same 0.75 maximum load factor that the map is created with.
+    if ((mapRef->size * 4) > (mapRef->bucketCount * 3))
+    {
+        size_t newBucketCount = mapRef->bucketCount * 2;
+
+        StartResize(mapRef, newBucketCount);
+
+        if (mapRef->bucketCount == newBucketCount)
+        {
+            le_mem_SetNumObjsToForce(mapRef->entryPoolRef, newBucketCount / 8);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts shrinking the map if shrinking is enabled and the map has become sparse.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CheckShrink
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    // Shrink when the load factor falls below 1/8, so that the map ends up at around 0.25, well
+    // clear of the growth threshold.
+    if (   mapRef->isShrinkable
+        && (mapRef->bucketCount > mapRef->minBucketCount)
+        && ((mapRef->size * 8) < mapRef->bucketCount) )
+    {
+        StartResize(mapRef, mapRef->bucketCount / 2);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Compact (open addressing) maps.
+//
+// The entries of a compact map are stored directly in an array of bucketCount slots.  An entry is
+// placed in the first free slot at or after its "home" slot (given by its hash), and Robin Hood
+// ordering is kept on insertion: an entry being inserted takes the place of any entry that is
+// closer to its own home slot, and that entry is then re-inserted further along.  This makes it
+// possible to stop a search for a key as soon as a slot is found whose entry is closer to its
+// home than the key would be.  Entries are removed by shifting the following entries back.
+//
+// To keep the iterator usable while entries are added and removed, entries are never moved while
+// an iteration is in progress: removed entries leave their slot marked as removed, and new entries
+// are put in the first free slot without keeping the Robin Hood order.  Searches don't stop early
+// while the order is broken, and the slot array is rebuilt by the first Put or Remove after the
+// iteration has finished, or by a Put that needs the map to grow (which ends the iteration).
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot tags of compact maps.  A slot in use has its key's hash, with the top bit set, as its tag.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define SLOT_EMPTY      0
+#define SLOT_REMOVED    1
+#define SLOT_USED_BIT   0x80000000u
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the tag of a slot holding a key with a given hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t MakeSlotTag
+(
+    size_t hash                         ///< [in] The hash of the key.
+)
+{
+    return ((uint32_t)hash) | SLOT_USED_BIT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a slot holds an entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsSlotUsed
+(
+    uint32_t tag                        ///< [in] The slot's tag.
+)
+{
+    return ((tag & SLOT_USED_BIT) != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes how far an entry is from its home slot.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t ProbeDistance
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    uint32_t tag,                       ///< [in] The entry's tag.
+    size_t index                        ///< [in] Index of the slot the entry is in.
+)
+{
+    // The bucket count is never larger than the tag's hash bits, so the top bit doesn't matter.
+    return (index - tag) & (mapRef->bucketCount - 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for a key in a compact map.
+ *
+ * @return The index of the key's slot, or -1 if the key isn't in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t FindSlot
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    const void* keyPtr,                 ///< [in] The key.
+    uint32_t tag                        ///< [in] The key's tag.
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t index = tag & mask;
+    size_t distance;
+
+    for (distance = 0; distance < mapRef->bucketCount; distance++)
+    {
+        CompactSlot_t* slotPtr = &(mapRef->slotsPtr[index]);
+
+        if (slotPtr->tag == SLOT_EMPTY)
+        {
+            break;
+        }
+
+        if (IsSlotUsed(slotPtr->tag))
+        {
+            if (   (slotPtr->tag == tag)
+                && ((slotPtr->keyPtr == keyPtr) || mapRef->equalsFuncPtr(slotPtr->keyPtr, keyPtr)) )
+            {
+                return index;
+            }
+
+            // If the key were here, it would have displaced this entry.
+            if ((!mapRef->isUnordered) && (ProbeDistance(mapRef, slotPtr->tag, index) < distance))
+            {
+                break;
+            }
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inserts an entry into a compact map, keeping the Robin Hood order.  The key must not already be
+ * in the map, and the map must not contain any removed slots or be unordered.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InsertSlot
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    CompactSlot_t newSlot               ///< [in] The entry to insert.
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t index = newSlot.tag & mask;
+    size_t distance = 0;
+
+    while (mapRef->slotsPtr[index].tag != SLOT_EMPTY)
+    {
+        CompactSlot_t* slotPtr = &(mapRef->slotsPtr[index]);
+        size_t slotDistance = ProbeDistance(mapRef, slotPtr->tag, index);
+
+        // Take the place of entries that are closer to home, and carry on inserting them instead.
+        if (slotDistance < distance)
+        {
+            CompactSlot_t displacedSlot = *slotPtr;
+            *slotPtr = newSlot;
+            newSlot = displacedSlot;
+            distance = slotDistance;
+        }
+
+        index = (index + 1) & mask;
+        distance++;
+    }
+
+    mapRef->slotsPtr[index] = newSlot;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inserts an entry into a compact map without moving any other entries, for use while an
+ * iteration is in progress.  The key must not already be in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendSlot
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    CompactSlot_t newSlot               ///< [in] The entry to insert.
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t index = newSlot.tag & mask;
+
+    while (IsSlotUsed(mapRef->slotsPtr[index].tag))
+    {
+        index = (index + 1) & mask;
+    }
+
+    if (mapRef->slotsPtr[index].tag == SLOT_REMOVED)
+    {
+        mapRef->removedCount--;
+    }
+
+    mapRef->slotsPtr[index] = newSlot;
+    mapRef->isUnordered = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties a slot of a compact map, shifting back the entries following it that aren't in their
+ * home slots.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ShiftSlotsBack
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    size_t index                        ///< [in] Index of the slot to empty.
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t nextIndex = (index + 1) & mask;
+
+    while (   IsSlotUsed(mapRef->slotsPtr[nextIndex].tag)
+           && (ProbeDistance(mapRef, mapRef->slotsPtr[nextIndex].tag, nextIndex) != 0) )
+    {
+        mapRef->slotsPtr[index] = mapRef->slotsPtr[nextIndex];
+        index = nextIndex;
+        nextIndex = (index + 1) & mask;
+    }
+
+    memset(&(mapRef->slotsPtr[index]), 0, sizeof(CompactSlot_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rebuilds the slot array of a compact map, dropping removed slots and restoring the Robin Hood
+ * order.  If the iterator has been started, it is left at the end of the map.
+ *
+ * @note Terminates the process on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Rehash
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    size_t newSlotCount                 ///< [in] The new number of slots (a power of 2).
+)
+{
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Rehashing from %zu to %zu slots (size %zu, %zu removed)",
+        mapRef->nameStr,
+        mapRef->bucketCount,
+        newSlotCount,
+        mapRef->size,
+        mapRef->removedCount
+    );
+
+    CompactSlot_t* oldSlotsPtr = mapRef->slotsPtr;
+    size_t oldSlotCount = mapRef->bucketCount;
+
+    mapRef->slotsPtr = calloc(newSlotCount, sizeof(CompactSlot_t));
+    LE_ASSERT(mapRef->slotsPtr);
+    mapRef->bucketCount = newSlotCount;
+    mapRef->removedCount = 0;
+    mapRef->isUnordered = false;
+
+    size_t i;
+    for (i = 0; i < oldSlotCount; i++)
+    {
+        if (IsSlotUsed(oldSlotsPtr[i].tag))
+        {
+            InsertSlot(mapRef, oldSlotsPtr[i]);
+        }
+    }
+
+    free(oldSlotsPtr);
+
+    // The iterator's position refers to the old array.
+    if (mapRef->iteratorPtr->currentIndex != -1)
+    {
+        mapRef->iteratorPtr->currentIndex = newSlotCount;
+        mapRef->iteratorPtr->isValueValid = false;
+        mapRef->iteratorPtr->isActive = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rebuilds the slot array of a compact map if an iteration that has finished left it with
+ * removed slots or out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void TidySlots
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    if (   (!mapRef->iteratorPtr->isActive)
+        && ((mapRef->removedCount != 0) || mapRef->isUnordered) )
+    {
+        Rehash(mapRef, mapRef->bucketCount);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first slot in use of a compact map at or after a given index.
+ *
+ * @return The index of the slot, or the slot count if there are none.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t NextUsedSlot
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    size_t index                        ///< [in] Index to start looking at.
+)
+{
+    while ((index < mapRef->bucketCount) && !IsSlotUsed(mapRef->slotsPtr[index].tag))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_Put().
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompactPut
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    const void* keyPtr,                 ///< [in] The key.
+    const void* valuePtr                ///< [in] The value.
+)
+{
+    TidySlots(mapRef);
+
+    uint32_t tag = MakeSlotTag(HashKey(mapRef, keyPtr));
+    ssize_t index = FindSlot(mapRef, keyPtr, tag);
+
+    if (index >= 0)
+    {
+        const void* oldValue = mapRef->slotsPtr[index].valuePtr;
+        mapRef->slotsPtr[index].valuePtr = valuePtr;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Replaced entry in slot %zd. Total map size now %zu",
+            mapRef->nameStr,
+            index,
+            mapRef->size
+        );
+
+        return (void*)oldValue;
+    }
+
+    // Grow when the load factor would exceed 0.875, even while an iteration is in progress (which
+    // ends it), so that probe sequences stay short however many entries are added.
+    size_t usedCount = mapRef->size + mapRef->removedCount + 1;
+
+    if ((usedCount * 8) > (mapRef->bucketCount * 7))
+    {
+        Rehash(mapRef, mapRef->bucketCount * 2);
+    }
+
+    CompactSlot_t newSlot = { .keyPtr = keyPtr, .valuePtr = valuePtr, .tag = tag };
+
+    if (mapRef->iteratorPtr->isActive)
+    {
+        AppendSlot(mapRef, newSlot);
+    }
+    else
+    {
+        InsertSlot(mapRef, newSlot);
+    }
+
+    mapRef->size++;
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Added entry. Total map size now %zu",
+        mapRef->nameStr,
+        mapRef->size
+    );
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_Remove().
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompactRemove
+(
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    const void* keyPtr                  ///< [in] The key.
+)
+{
+    TidySlots(mapRef);
+
+    ssize_t index = FindSlot(mapRef, keyPtr, MakeSlotTag(HashKey(mapRef, keyPtr)));
+
+    if (index < 0)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+        return NULL;
+    }
+
+    void* value = (void*)(mapRef->slotsPtr[index].valuePtr);
+    mapRef->size--;
+
+    if (mapRef->iteratorPtr->isActive)
+    {
+        // Leave the other entries where they are, so the iterator doesn't miss or repeat any.
+        memset(&(mapRef->slotsPtr[index]), 0, sizeof(CompactSlot_t));
+        mapRef->slotsPtr[index].tag = SLOT_REMOVED;
+        mapRef->removedCount++;
+
+        if (mapRef->iteratorPtr->currentIndex == index)
+        {
+            mapRef->iteratorPtr->isValueValid = false;
+        }
+    }
+    else
+    {
+        ShiftSlotsBack(mapRef, index);
+
+        if (   mapRef->isShrinkable
+            && (mapRef->bucketCount > mapRef->minBucketCount)
+            && ((mapRef->size * 8) < mapRef->bucketCount) )
+        {
+            Rehash(mapRef, mapRef->bucketCount / 2);
+        }
+    }
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Removing key from map",
+        mapRef->nameStr
+    );
+
+    return value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_RemoveAll().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactRemoveAll
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    if (mapRef->isShrinkable && (mapRef->bucketCount > mapRef->minBucketCount))
+    {
+        free(mapRef->slotsPtr);
+        mapRef->slotsPtr = calloc(mapRef->minBucketCount, sizeof(CompactSlot_t));
+        LE_ASSERT(mapRef->slotsPtr);
+        mapRef->bucketCount = mapRef->minBucketCount;
+    }
+    else
+    {
+        memset(mapRef->slotsPtr, 0, mapRef->bucketCount * sizeof(CompactSlot_t));
+    }
+
+    mapRef->removedCount = 0;
+    mapRef->isUnordered = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_ForEach().
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CompactForEach
+(
+    Hashmap_t* mapRef,                      ///< [in] The map.
+    le_hashmap_ForEachHandler_t forEachFn,  ///< [in] Callback function.
+    void* context                           ///< [in] Context to pass to the callback.
+)
+{
+    size_t i;
+    for (i = NextUsedSlot(mapRef, 0); i < mapRef->bucketCount; i = NextUsedSlot(mapRef, i + 1))
+    {
+        CompactSlot_t* slotPtr = &(mapRef->slotsPtr[i]);
+
+        if (!forEachFn(slotPtr->keyPtr, slotPtr->valuePtr, context))
+        {
+            // Despite stopping early, all elements may have been examined.
+            return (NextUsedSlot(mapRef, i + 1) >= mapRef->bucketCount);
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_NextNode().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompactNextNode
+(
+    HashmapIt_t* iteratorRef            ///< [in] The iterator.
+)
+{
+    Hashmap_t* mapRef = iteratorRef->theMapPtr;
+
+    // currentIndex is -1 if the iterator is new.
+    size_t index = NextUsedSlot(mapRef, iteratorRef->currentIndex + 1);
+
+    if (index < mapRef->bucketCount)
+    {
+        iteratorRef->currentIndex = index;
+        iteratorRef->isActive = true;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Found slot match, index is %d",
+            iteratorRef->currentIndex
+        );
+        return LE_OK;
+    }
+
+    // Park the iterator at the end of the map, so that le_hashmap_PrevNode() starts again from
+    // the last entry.
+    iteratorRef->currentIndex = mapRef->bucketCount;
+    iteratorRef->isValueValid = false;
+    iteratorRef->isActive = false;
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact map version of le_hashmap_PrevNode().  The iterator must not be at the start of the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompactPrevNode
+(
+    HashmapIt_t* iteratorRef            ///< [in] The iterator.
+)
+{
+    Hashmap_t* mapRef = iteratorRef->theMapPtr;
+    int32_t index = iteratorRef->currentIndex;
+
+    if (index > (int32_t)mapRef->bucketCount)
+    {
+        index = mapRef->bucketCount;
+    }
+
+    for (index--; index >= 0; index--)
+    {
+        if (IsSlotUsed(mapRef->slotsPtr[index].tag))
+        {
+            iteratorRef->currentIndex = index;
+            iteratorRef->isActive = true;
+
+            HASHMAP_TRACE(
+                mapRef,
+                "Found slot match, index is %d",
+                iteratorRef->currentIndex
+            );
+            return LE_OK;
+        }
+    }
+
+    iteratorRef->currentIndex = -1;
+    iteratorRef->isValueValid = false;
+    iteratorRef->isActive = false;
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the slot the iterator of a compact map is on.
+ *
+ * @return Pointer to the slot, or NULL if the iterator isn't on an entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline CompactSlot_t* GetIteratorSlot
+(
+    HashmapIt_t* iteratorRef            ///< [in] The iterator.
+)
+{
+    if (iteratorRef->currentIndex >= (int32_t)iteratorRef->theMapPtr->bucketCount)
+    {
+        return NULL;
+    }
+
+    return &(iteratorRef->theMapPtr->slotsPtr[iteratorRef->currentIndex]);
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a new entry to put in the map. Allocates the entry from the pool which was created
- * during construction of the map.
- *
- * @param newKeyPtr A pointer to the key
- * @param newHash The calculated hash
- * @param newValuePtr A pointer to the value
- * @param poolRef A memory pool reference to use for allocating memory. This pool must have been
- * created as a pool of Entry_t.
- * @return  Returns a pointer to the newly allocated and filled-in Entry_t
- *
+ * Compact map version of le_hashmap_GetNodeAfter().
  */
 //--------------------------------------------------------------------------------------------------
-static Entry_t* CreateEntry
+static le_result_t CompactGetNodeAfter
 (
-    const void* newKeyPtr,
-    int newHash,
-    const void* newValuePtr,
-    le_mem_PoolRef_t poolRef
+    Hashmap_t* mapRef,                  ///< [in] The map.
+    const void* keyPtr,                 ///< [in] The key to look for.
+    void** nextKeyPtr,                  ///< [out] The next key.
+    void** nextValuePtr                 ///< [out] The next value (can be NULL).
 )
 {
-    Entry_t* entryPtr = le_mem_ForceAlloc(poolRef);
-    LE_ASSERT(entryPtr);
+    ssize_t index = FindSlot(mapRef, keyPtr, MakeSlotTag(HashKey(mapRef, keyPtr)));
 
-    entryPtr->keyPtr = newKeyPtr;
-    entryPtr->hash = newHash;
-    entryPtr->valuePtr = newValuePtr;
-    entryPtr->entryListLink = LE_DLS_LINK_INIT;
-    return entryPtr;
+    if (index < 0)
+    {
+        // The original key was never found
+        return LE_BAD_PARAMETER;
+    }
+
+    size_t nextIndex = NextUsedSlot(mapRef, index + 1);
+
+    if (nextIndex >= mapRef->bucketCount)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    *nextKeyPtr = (void*)mapRef->slotsPtr[nextIndex].keyPtr;
+    if (NULL != nextValuePtr)
+    {
+        *nextValuePtr = (void*)mapRef->slotsPtr[nextIndex].valuePtr;
+    }
+
+    return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Given a hash and a map size, calculate the index at which to store the entry
- *
- * @param bucketCount The number of buckets in the map
- * @param hash The hash to use
- * @return  Returns the index to use in the bucket array
- *
+ * Compact map version of le_hashmap_CountCollisions().  An entry counts as a collision if it
+ * isn't in its home slot.
  */
 //--------------------------------------------------------------------------------------------------
-static inline size_t CalculateIndex(size_t bucketCount, size_t hash) {
-    return (hash) & (bucketCount - 1);
+static size_t CompactCountCollisions
+(
+    Hashmap_t* mapRef                   ///< [in] The map.
+)
+{
+    size_t i, collCount = 0;
+
+    for (i = 0; i < mapRef->bucketCount; i++)
+    {
+        uint32_t tag = mapRef->slotsPtr[i].tag;
+
+        if (IsSlotUsed(tag) && (ProbeDistance(mapRef, tag, i) != 0))
+        {
+            collCount++;
+        }
+    }
+
+    return collCount;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks if 2 keys are equal (or are actually the same key)
+ * Allocates a map object and its iterator, and initializes the members common to both kinds of
+ * map.  The bucket (or slot) table is left for the caller to set up.
  *
- * @param keyAPtr Pointer to the first key
- * @param hashA The hash of the first key
- * @param keyBPtr Pointer to the second key
- * @param hashB The hash of the second key
- * @param equalsFuncPtr The equality function in use by the map
- * @return  Returns true if the keys are identical, false otherwise
+ * @return  Returns a reference to the map.
  *
+ * @note Terminates the process on failure.
  */
 //--------------------------------------------------------------------------------------------------
-static inline bool EqualKeys
+static le_hashmap_Ref_t CreateMap
 (
-    const void* keyAPtr,
-    int hashA,
-    const void* keyBPtr,
-    int hashB,
-    le_hashmap_EqualsFunc_t equalsFuncPtr
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
 )
 {
-    if (keyAPtr == keyBPtr) {
-        return true;
-    }
-    if (hashA != hashB) {
-        return false;
-    }
-    return equalsFuncPtr(keyAPtr, keyBPtr);
+    LE_ASSERT(hashFunc);
+    LE_ASSERT(equalsFunc);
+
+    // It is ok to use malloc here as we will not be destroying the map
+    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
+    LE_ASSERT(mapRef);
+    memset(mapRef, 0, sizeof(Hashmap_t));
+
+    mapRef->traceRef = NULL;
+    mapRef->hashFuncPtr = hashFunc;
+    mapRef->equalsFuncPtr = equalsFunc;
+    mapRef->nameStr = nameStr;
+
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
+
+    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
+    mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->isValueValid = true;
+
+    return mapRef;
 }
 
 
@@ -157,14 +1204,7 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
 )
 {
-    LE_ASSERT(hashFunc);
-    LE_ASSERT(equalsFunc);
-
-    // It is ok to use malloc here as we will not be destroying the map
-    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
-    LE_ASSERT(mapRef);
-
-    mapRef->traceRef = NULL;
+    le_hashmap_Ref_t mapRef = CreateMap(nameStr, hashFunc, equalsFunc);
 
     /**
      * 0.75 load factor. We have more buckets than expected keys as we want
@@ -193,29 +1233,47 @@ le_hashmap_Ref_t le_hashmap_Create
                                                                mapRef->bucketCount / 2);
     le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
 
-    mapRef->bucketsPtr = malloc(mapRef->bucketCount * sizeof(le_dls_List_t));
-    LE_ASSERT(mapRef->bucketsPtr);
-    mapRef->chainLengthPtr = malloc(mapRef->bucketCount * sizeof(size_t));
-    LE_ASSERT(mapRef->chainLengthPtr);
-    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
-    LE_ASSERT(mapRef->iteratorPtr);
+    CreateBuckets(mapRef->bucketCount, &(mapRef->bucketsPtr), &(mapRef->chainLengthPtr));
 
-    uint32_t i = 0;
-    for (i=0; i<mapRef->bucketCount; i++)
-    {
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
-    }
+    mapRef->minBucketCount = mapRef->bucketCount;
 
-    mapRef->size = 0;
+    return mapRef;
+}
 
-    mapRef->hashFuncPtr = hashFunc;
-    mapRef->equalsFuncPtr = equalsFunc;
-    mapRef->nameStr = nameStr;
 
-    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
-    mapRef->iteratorPtr->theMapPtr = mapRef;
-    mapRef->iteratorPtr->isValueValid = true;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a compact HashMap, which stores its entries in an open-addressed slot array.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateCompact
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    le_hashmap_Ref_t mapRef = CreateMap(nameStr, hashFunc, equalsFunc);
+
+    // 0.875 load factor, which Robin Hood probing copes with well.  The slot count must be a
+    // power of 2.
+    capacity = (capacity < 3)? 3 : capacity;
+    size_t minimumSlotCount = capacity * 8 / 7;
+    mapRef->bucketCount = 4;
+    while (mapRef->bucketCount <= minimumSlotCount) {
+        mapRef->bucketCount <<= 1;
+    }
+
+    mapRef->isCompact = true;
+    mapRef->slotsPtr = calloc(mapRef->bucketCount, sizeof(CompactSlot_t));
+    LE_ASSERT(mapRef->slotsPtr);
+
+    mapRef->minBucketCount = mapRef->bucketCount;
 
     return mapRef;
 }
@@ -237,6 +1295,13 @@ void* le_hashmap_Put
     const void* valuePtr       ///< [in] Pointer to the value to be stored
 )
 {
+    if (mapRef->isCompact)
+    {
+        return CompactPut(mapRef, keyPtr, valuePtr);
+    }
+
+    MigrateStep(mapRef);
+
     size_t hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
 
@@ -248,7 +1313,8 @@ void* le_hashmap_Put
         (int)hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr;
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, hash, &chainLengthPtr);
 
     if (le_dls_NumLinks(listHeadPtr) == 0)
     {
@@ -265,7 +1331,9 @@ void* le_hashmap_Put
             mapRef->size
         );
 
-        mapRef->chainLengthPtr[index]++;
+        (*chainLengthPtr)++;
+
+        CheckGrow(mapRef);
 
         return NULL;
     }
@@ -312,16 +1380,18 @@ void* le_hashmap_Put
                     mapRef->size
                 );
 
-                mapRef->chainLengthPtr[index]++;
+                (*chainLengthPtr)++;
 
                 HASHMAP_TRACE(
                     mapRef,
                     "Hashmap %s: Bucket now contains %zu entries (%zu)",
                     mapRef->nameStr,
                     le_dls_NumLinks(listHeadPtr),
-                    mapRef->chainLengthPtr[index]
+                    *chainLengthPtr
                 );
 
+                CheckGrow(mapRef);
+
                 return NULL;
             }
 
@@ -346,6 +1416,12 @@ void* le_hashmap_Get
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved
 )
 {
+    if (mapRef->isCompact)
+    {
+        ssize_t index = FindSlot(mapRef, keyPtr, MakeSlotTag(HashKey(mapRef, keyPtr)));
+        return (index < 0)? NULL : (void*)(mapRef->slotsPtr[index].valuePtr);
+    }
+
     size_t hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
     HASHMAP_TRACE(
@@ -356,7 +1432,8 @@ void* le_hashmap_Get
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr;
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, hash, &chainLengthPtr);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Looked up list contains %zu links",
@@ -408,6 +1485,12 @@ void* le_hashmap_GetStoredKey
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved.
 )
 {
+    if (mapRef->isCompact)
+    {
+        ssize_t index = FindSlot(mapRef, keyPtr, MakeSlotTag(HashKey(mapRef, keyPtr)));
+        return (index < 0)? NULL : (void*)(mapRef->slotsPtr[index].keyPtr);
+    }
+
     size_t hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
     HASHMAP_TRACE(
@@ -418,7 +1501,8 @@ void* le_hashmap_GetStoredKey
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr;
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, hash, &chainLengthPtr);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Looked up list contains %zu links",
@@ -473,6 +1557,13 @@ void* le_hashmap_Remove
    const void* keyPtr       ///< [in] Pointer to the key to be removed
 )
 {
+    if (mapRef->isCompact)
+    {
+        return CompactRemove(mapRef, keyPtr);
+    }
+
+    MigrateStep(mapRef);
+
     int hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
 
@@ -484,7 +1575,8 @@ void* le_hashmap_Remove
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr;
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, hash, &chainLengthPtr);
     le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
     while (theLinkPtr != NULL) {
@@ -498,15 +1590,18 @@ void* le_hashmap_Remove
         {
             if (mapRef->iteratorPtr->currentLinkPtr == theLinkPtr)
             {
+                // Stepping back off the start of the map doesn't end the iteration.
+                bool isActive = mapRef->iteratorPtr->isActive;
                 le_hashmap_PrevNode(mapRef->iteratorPtr);
                 mapRef->iteratorPtr->isValueValid = false;
+                mapRef->iteratorPtr->isActive = isActive;
             }
 
             void* value = (void*)(currentEntryPtr->valuePtr);
             le_dls_Remove(listHeadPtr, theLinkPtr);
             le_mem_Release( currentEntryPtr );
             mapRef->size--;
-            mapRef->chainLengthPtr[index]--;
+            (*chainLengthPtr)--;
 
             HASHMAP_TRACE(
                 mapRef,
@@ -514,6 +1609,8 @@ void* le_hashmap_Remove
                 mapRef->nameStr
             );
 
+            CheckShrink(mapRef);
+
             return value;
         }
         theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
@@ -577,6 +1674,11 @@ bool le_hashmap_ContainsKey
     const void* keyPtr        ///< [in] Pointer to the key to be searched for
 )
 {
+    if (mapRef->isCompact)
+    {
+        return (FindSlot(mapRef, keyPtr, MakeSlotTag(HashKey(mapRef, keyPtr))) >= 0);
+    }
+
     int hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
 
@@ -588,7 +1690,8 @@ bool le_hashmap_ContainsKey
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr;
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, hash, &chainLengthPtr);
     le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
     while (theLinkPtr != NULL) {
@@ -634,13 +1737,23 @@ void le_hashmap_RemoveAll
     le_hashmap_Ref_t mapRef    ///< [in] Reference to the map
 )
 {
+    FinishMigration(mapRef);
+
     // Reset the iterator
     mapRef->iteratorPtr->isValueValid = false;
+    mapRef->iteratorPtr->isActive = false;
     mapRef->iteratorPtr->currentIndex = -1;
     mapRef->iteratorPtr->currentListPtr = NULL;
     mapRef->iteratorPtr->currentLinkPtr = NULL;
     mapRef->iteratorPtr->currentEntryPtr = NULL;
 
+    if (mapRef->isCompact)
+    {
+        CompactRemoveAll(mapRef);
+        mapRef->size = 0;
+        return;
+    }
+
     uint32_t i;
     for (i = 0; i < mapRef->bucketCount; i++) {
         le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
@@ -663,6 +1776,8 @@ void le_hashmap_RemoveAll
        "Hashmap %s: All entries deleted from map",
        mapRef->nameStr
     );
+
+    CheckShrink(mapRef);
 }
 
 
@@ -682,6 +1797,13 @@ bool le_hashmap_ForEach
     void* context                            ///< [in] Pointer to a context to be supplied to the callback
 )
 {
+    if (mapRef->isCompact)
+    {
+        return CompactForEach(mapRef, forEachFn, context);
+    }
+
+    FinishMigration(mapRef);
+
     uint32_t i;
     for (i = 0; i < mapRef->bucketCount; i++) {
         le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
@@ -724,10 +1846,16 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
     le_hashmap_Ref_t mapRef                 ///< [in] Reference to the map
 )
 {
+    // The iterator walks the bucket table directly, so make sure there's only one table.
+    FinishMigration(mapRef);
+
     // Set the counter to -1 so that we know the iterator is at the start
     mapRef->iteratorPtr->currentIndex = -1;
     // Mark the iterator as valid
     mapRef->iteratorPtr->isValueValid = true;
+    // Any previous iteration is over, even if it was abandoned part way through.  Resizing is
+    // deferred again once le_hashmap_NextNode() starts the new one.
+    mapRef->iteratorPtr->isActive = false;
 
     return mapRef->iteratorPtr;
 }
@@ -753,13 +1881,24 @@ le_result_t le_hashmap_NextNode
     if (le_hashmap_isEmpty(iteratorRef->theMapPtr))
     {
         iteratorRef->isValueValid = false;
+        iteratorRef->isActive = false;
         return LE_NOT_FOUND;
     }
 
+    if (iteratorRef->theMapPtr->isCompact)
+    {
+        return CompactNextNode(iteratorRef);
+    }
+
+    // A resize may have been started (and the iterator parked at the end of the map) since the
+    // last iteration finished, so make sure the bucket table is the only one.
+    FinishMigration(iteratorRef->theMapPtr);
+    iteratorRef->isActive = true;
+
     le_dls_Link_t* theLinkPtr = NULL;
 
-    // -1 indicates the iterator is new
-    if (iteratorRef->currentIndex != -1) {
+    // -1 indicates the iterator is new, and a NULL link means it was parked by a resize.
+    if ((iteratorRef->currentIndex != -1) && (iteratorRef->currentLinkPtr != NULL)) {
         // Check if the current entry is at the end of a list
         theLinkPtr = le_dls_PeekNext(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
     }
@@ -809,6 +1948,7 @@ le_result_t le_hashmap_NextNode
 
     // At the end without finding another entry, need to invalidate the iterator
     iteratorRef->isValueValid = false;
+    iteratorRef->isActive = false;
     return LE_NOT_FOUND;
 }
 
@@ -837,11 +1977,25 @@ le_result_t le_hashmap_PrevNode
        )
     {
         iteratorRef->isValueValid = false;
+        iteratorRef->isActive = false;
         return LE_NOT_FOUND;
     }
 
-    le_dls_Link_t* theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr,
-                                                iteratorRef->currentLinkPtr);
+    if (iteratorRef->theMapPtr->isCompact)
+    {
+        return CompactPrevNode(iteratorRef);
+    }
+
+    FinishMigration(iteratorRef->theMapPtr);
+    iteratorRef->isActive = true;
+
+    le_dls_Link_t* theLinkPtr = NULL;
+
+    // A NULL link means the iterator was parked at the end of the map by a resize.
+    if (iteratorRef->currentLinkPtr != NULL)
+    {
+        theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
+    }
 
     if (NULL == theLinkPtr)
     {
@@ -888,6 +2042,7 @@ le_result_t le_hashmap_PrevNode
 
     // At the beginning, without finding another entry, need to invalidate the iterator.
     iteratorRef->isValueValid = false;
+    iteratorRef->isActive = false;
     return LE_NOT_FOUND;
 }
 
@@ -907,6 +2062,12 @@ const void* le_hashmap_GetKey
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (iteratorRef->theMapPtr->isCompact)
+    {
+        CompactSlot_t* slotPtr = GetIteratorSlot(iteratorRef);
+        return (slotPtr == NULL)? NULL : slotPtr->keyPtr;
+    }
+
     return iteratorRef->currentEntryPtr->keyPtr;
 }
 
@@ -925,6 +2086,12 @@ void* le_hashmap_GetValue
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (iteratorRef->theMapPtr->isCompact)
+    {
+        CompactSlot_t* slotPtr = GetIteratorSlot(iteratorRef);
+        return (slotPtr == NULL)? NULL : (void*)slotPtr->valuePtr;
+    }
+
     // Need to cast away the const
     return (void*)iteratorRef->currentEntryPtr->valuePtr;
 }
@@ -962,6 +2129,19 @@ le_result_t le_hashmap_GetFirstNode
         return LE_BAD_PARAMETER;
     }
 
+    if (mapRef->isCompact)
+    {
+        CompactSlot_t* slotPtr = &(mapRef->slotsPtr[NextUsedSlot(mapRef, 0)]);
+        *firstKeyPtr = (void *)slotPtr->keyPtr;
+        if (firstValuePtr != NULL)
+        {
+            *firstValuePtr = (void *)slotPtr->valuePtr;
+        }
+        return LE_OK;
+    }
+
+    FinishMigration(mapRef);
+
     // Find the first list head
     size_t index = 0;
     for (
@@ -1015,6 +2195,13 @@ le_result_t le_hashmap_GetNodeAfter
         return LE_BAD_PARAMETER;
     }
 
+    if (mapRef->isCompact)
+    {
+        return CompactGetNodeAfter(mapRef, keyPtr, nextKeyPtr, nextValuePtr);
+    }
+
+    FinishMigration(mapRef);
+
     // Find the node pointed to by the key
     size_t hash = HashKey(mapRef, keyPtr);
     size_t index = CalculateIndex(mapRef->bucketCount, hash);
@@ -1111,6 +2298,13 @@ size_t le_hashmap_CountCollisions
     le_hashmap_Ref_t mapRef     ///< [in] Reference to the map
 )
 {
+    if (mapRef->isCompact)
+    {
+        return CompactCountCollisions(mapRef);
+    }
+
+    FinishMigration(mapRef);
+
     size_t i, collCount = 0;
     for (i = 0; i < mapRef->bucketCount; i++) {
         if (mapRef->chainLengthPtr[i] > 1) {
@@ -1121,6 +2315,60 @@ size_t le_hashmap_CountCollisions
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allows a HashMap to shrink when enough entries have been removed from it.  The map never shrinks
+ * below the number of buckets it was created with.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+
+void le_hashmap_EnableShrink
+(
+    le_hashmap_Ref_t mapRef     ///< [in] Reference to the map
+)
+{
+    mapRef->isShrinkable = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the seed of a HashMap's hash.  The map must be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+
+void le_hashmap_SetSeed
+(
+    le_hashmap_Ref_t mapRef,    ///< [in] Reference to the map
+    uint64_t seed               ///< [in] The seed
+)
+{
+    // The entries' stored hashes would no longer match their keys.
+    LE_FATAL_IF(mapRef->size != 0, "Setting the seed of non-empty hashmap '%s'.", mapRef->nameStr);
+
+    mapRef->seed = seed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the seed of a HashMap's hash to a random number.  The map must be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+
+void le_hashmap_SetRandomSeed
+(
+    le_hashmap_Ref_t mapRef     ///< [in] Reference to the map
+)
+{
+    uint64_t seed;
+
+    le_rand_GetBuffer((uint8_t*)&seed, sizeof(seed));
+    le_hashmap_SetSeed(mapRef, seed);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * String hashing function. This can be used as a parameter to le_hashmap_Create if the key to
@@ -1136,8 +2384,7 @@ size_t le_hashmap_HashString
     const void* stringToHashPtr    ///< [in] Pointer to the string to be hashed
 )
 {
-    int len = le_utf8_NumBytes(stringToHashPtr);
-    return SuperFastHash(stringToHashPtr, len);
+    return HashString(stringToHashPtr, 0);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1217,7 +2464,9 @@ size_t le_hashmap_HashUInt64
 )
 {
     uint64_t ui = *((uint64_t *)intToHashPtr);
-    return (size_t)ui;
+
+    // Fold the upper half in, so it isn't lost where size_t is 32 bits.
+    return (size_t)(ui ^ (ui >> 32));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1236,8 +2485,8 @@ bool le_hashmap_EqualsUInt64
     const void* secondIntPtr    ///< [in] Pointer to the second long integer for comparing.
 )
 {
-    int a = *((uint64_t*) firstIntPtr);
-    int b = *((uint64_t*) secondIntPtr);
+    uint64_t a = *((uint64_t*) firstIntPtr);
+    uint64_t b = *((uint64_t*) secondIntPtr);
     return a == b;
 }
 
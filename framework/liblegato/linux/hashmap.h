@@ -20,6 +20,17 @@ struct Entry {
     le_dls_Link_t entryListLink;
 };
 
+/**
+ * A slot in the array of a compact (open addressing) map.
+ */
+typedef struct
+{
+    const void* keyPtr;
+    const void* valuePtr;
+    uint32_t tag;           ///< 0 = empty, 1 = removed, otherwise the key's hash with the top bit set.
+}
+CompactSlot_t;
+
 /**
  * A hashmap iterator
  */
@@ -30,6 +41,8 @@ typedef struct le_hashmap_It {
     le_dls_Link_t* currentLinkPtr;
     Entry_t* currentEntryPtr;
     bool isValueValid;
+    bool isActive;                  ///< true while an iteration is in progress (resizing of the
+                                    ///  map is deferred until it has finished).
 }
 HashmapIt_t;
 
@@ -47,6 +60,19 @@ typedef struct le_hashmap {
     const char* nameStr;
     HashmapIt_t* iteratorPtr;
     le_log_TraceRef_t traceRef;
+    size_t minBucketCount;          ///< Bucket count the map was created with.  Never shrinks below.
+    bool isShrinkable;              ///< true if the map may shrink when entries are removed.
+    size_t oldBucketCount;          ///< Number of buckets in the table being migrated from.
+    le_dls_List_t* oldBucketsPtr;   ///< Table being migrated from, or NULL if not resizing.
+    size_t* oldChainLengthPtr;      ///< Chain lengths of the table being migrated from.
+    size_t migrateIndex;            ///< Index of the next old bucket to be migrated.
+    bool isCompact;                 ///< true if created by le_hashmap_CreateCompact().  A compact
+                                    ///  map has bucketCount slots and no buckets or entry pool.
+    CompactSlot_t* slotsPtr;        ///< Slot array of a compact map.
+    size_t removedCount;            ///< Number of slots of a compact map marked as removed.
+    bool isUnordered;               ///< true if entries have been added to a compact map without
+                                    ///  keeping the Robin Hood order (during an iteration).
+    uint64_t seed;                  ///< Hash seed set by le_hashmap_SetSeed(), or 0.
 }
 Hashmap_t;
 
@@ -13,25 +13,49 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Convert a numeric value into a uppercase character representing the hexidecimal value of the
- * input.
- *
- * @return Hexidecimal character in the range [0-9A-F] or 0 if the input value was too large
+ * Uppercase hexadecimal representation of every byte value, two characters per byte (not
+ * null-terminated).  Encoding a byte is a single 16-bit copy out of this table.
  */
 //--------------------------------------------------------------------------------------------------
-static char DecToHex(uint8_t hex)
+static const char HexPairs[512] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of every character as a hexadecimal digit, or INVALID_DIGIT if it isn't one.  One row per
+ * 16 character codes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INVALID_DIGIT   0xFF
+
+static const uint8_t HexDigitValues[256] =
 {
-    if (hex < 10) {
-        return (char)('0'+hex);  // for number
-    }
-    else if (hex < 16) {
-        return (char)('A'+hex-10);  // for A,B,C,D,E,F
-    }
-    else {
-        LE_DEBUG("value %u cannot be converted in HEX string", hex);
-        return 0;
-    }
-}
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -56,9 +80,8 @@ int32_t le_hex_StringToBinary
 {
     uint32_t idxString;
     uint32_t idxBinary;
-    char*    refStrPtr = "0123456789ABCDEF";
 
-    if (stringLength > strlen(stringPtr))
+    if (stringLength > strnlen(stringPtr, stringLength))
     {
         LE_DEBUG("The stringLength (%u) is more than size of stringPtr (%s)",
                  stringLength, stringPtr);
@@ -82,20 +105,17 @@ int32_t le_hex_StringToBinary
 
     for (idxString=0,idxBinary=0 ; idxString<stringLength ; idxString+=2,idxBinary++)
     {
-        char* ch1Ptr;
-        char* ch2Ptr;
+        uint8_t highNibble = HexDigitValues[(uint8_t)stringPtr[idxString]];
+        uint8_t lowNibble = HexDigitValues[(uint8_t)stringPtr[idxString+1]];
 
-        if ( ((ch1Ptr = strchr(refStrPtr, toupper(stringPtr[idxString]))) && *ch1Ptr) &&
-             ((ch2Ptr = strchr(refStrPtr, toupper(stringPtr[idxString+1]))) && *ch2Ptr) )
-        {
-            binaryPtr[idxBinary] = ((ch2Ptr - refStrPtr) & 0x0F) |
-                                   (((ch1Ptr - refStrPtr)<<4) & 0xF0);
-        }
-        else
+        // An invalid digit has its high bits set.
+        if ((highNibble | lowNibble) & 0xF0)
         {
             LE_DEBUG("Invalid string to convert (%s)", stringPtr);
             return -1;
         }
+
+        binaryPtr[idxBinary] = (highNibble << 4) | lowNibble;
     }
 
     return idxBinary;
@@ -119,7 +139,7 @@ int32_t le_hex_BinaryToString
     uint32_t       stringSize  ///< [IN] size of string array.  Must be >= (2 * binarySize) + 1
 )
 {
-    int32_t idxString,idxBinary;
+    uint32_t idxString,idxBinary;
 
     if (stringSize < (2 * binarySize) + 1)
     {
@@ -130,16 +150,39 @@ int32_t le_hex_BinaryToString
         return -1;
     }
 
-    for(idxBinary=0,idxString=0;
-        idxBinary<binarySize;
-        idxBinary++,idxString=idxString+2)
+    idxBinary = 0;
+    idxString = 0;
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    // Convert 4 bytes at a time with 64-bit arithmetic: spread the 8 nibbles into the 8 bytes of a
+    // word (in output order), then turn each of them into its digit in parallel, adding 7 more to
+    // the ones above 9 to skip from '9' to 'A'.
+    for (; idxBinary + 4 <= binarySize; idxBinary += 4, idxString += 8)
+    {
+        uint32_t in;
+        memcpy(&in, binaryPtr + idxBinary, sizeof(in));
+
+        uint64_t spread = ((uint64_t)(in & 0x000000FF))
+                        | ((uint64_t)(in & 0x0000FF00) << 8)
+                        | ((uint64_t)(in & 0x00FF0000) << 16)
+                        | ((uint64_t)(in & 0xFF000000) << 24);
+        uint64_t nibbles = ((spread >> 4) & UINT64_C(0x000F000F000F000F))
+                         | ((spread & UINT64_C(0x000F000F000F000F)) << 8);
+        uint64_t letters = ((nibbles + UINT64_C(0x0606060606060606)) >> 4)
+                         & UINT64_C(0x0101010101010101);
+        uint64_t out = nibbles + UINT64_C(0x3030303030303030) + (letters * 7);
+
+        memcpy(stringPtr + idxString, &out, sizeof(out));
+    }
+#endif
+
+    for (; idxBinary < binarySize; idxBinary++, idxString += 2)
     {
-        stringPtr[idxString]   = DecToHex( (binaryPtr[idxBinary]>>4) & 0x0F);
-        stringPtr[idxString+1] = DecToHex(  binaryPtr[idxBinary]     & 0x0F);
+        memcpy(stringPtr + idxString, &HexPairs[binaryPtr[idxBinary] * 2], 2);
     }
     stringPtr[idxString] = '\0';
 
-    return idxString;
+    return (int32_t)idxString;
 }
 
 //--------------------------------------------------------------------------------------------------
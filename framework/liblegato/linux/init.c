@@ -13,6 +13,7 @@
 #include "messaging.h"
 #include "log.h"
 #include "thread.h"
+#include "threadPool.h"
 #include "signals.h"
 #include "eventLoop.h"
 #include "timer.h"
@@ -20,9 +21,12 @@
 #include "killProc.h"
 #include "properties.h"
 #include "json.h"
+#include "arena.h"
 #include "pipeline.h"
 #include "atomFile.h"
 #include "fs.h"
+#include "startupTrace.h"
+#include "procStats.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -50,20 +54,25 @@ __attribute__((constructor)) void _legato_InitFramework
     // hasn't been called yet.  Keep it that way.  Also, be careful when using logging inside
     // the memory pool module, because there is the risk of creating infinite recursion.
 
-    mem_Init();
+    startupTrace_Init();    // Uses nothing else, and should be as close to exec() as possible.
+    procStats_Init();  // Uses nothing else.
+    mem_Init();        // Uses the stats page.
     log_Init();        // Uses memory pools.
     sig_Init();        // Uses memory pools.
     safeRef_Init();    // Uses memory pools and hash maps.
     pathIter_Init();   // Uses memory pools and safe references.
     mutex_Init();      // Uses memory pools.
     sem_Init();        // Uses memory pools.
+    rwlock_Init();     // Uses memory pools.
     thread_Init();     // Uses memory pools and safe references.
+    threadPool_Init(); // Uses memory pools.
     event_Init();      // Uses thread API.
     timer_Init();      // Uses event loop.
     msg_Init();        // Uses event loop.
     kill_Init();       // Uses memory pools and timers.
     properties_Init(); // Uses memory pools and safe references.
     json_Init();       // Uses memory pools.
+    arena_Init();      // Uses memory pools.
     pipeline_Init();   // Uses memory pools and FD Monitors.
     atomFile_Init();   // Uses memory pools.
     fs_Init();         // Uses memory pools and safe references.
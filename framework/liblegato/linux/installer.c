@@ -16,6 +16,11 @@
 #include "smack.h"
 #include "dir.h"
 #include "user.h"
+#include "sysPaths.h"
+#include "fileDescriptor.h"
+#include "fileSystem.h"
+#include <sched.h>
+#include <sys/mount.h>
 
 
 
@@ -640,3 +645,157 @@ le_result_t installer_RemoveAppWriteableDeviceFiles
 
     return result;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a system's dynamic linker cache (see INSTALLER_LD_SO_CACHE_FILE), so that it doesn't have
+ * to be rebuilt when the system is made current.
+ *
+ * ldconfig records the full paths of the libraries, which must be under the current system's
+ * directory.  So unless the system already is the current system, ldconfig is run in a mount
+ * namespace of its own, where the system's directory is bind mounted over the current system's.
+ *
+ * @return LE_OK if successful.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t installer_BuildLdSoCache
+(
+    const char* systemPath  ///< Path to the system's directory (e.g., "/legato/systems/unpack").
+)
+{
+    char cachePath[PATH_MAX];
+    char confPath[PATH_MAX];
+    const char confText[] = CURRENT_SYSTEM_PATH "/lib\n";
+
+    LE_ASSERT(snprintf(cachePath, sizeof(cachePath), "%s/" INSTALLER_LD_SO_CACHE_FILE, systemPath)
+              < sizeof(cachePath));
+    LE_ASSERT(snprintf(confPath, sizeof(confPath), "%s/ld.so.conf", systemPath)
+              < sizeof(confPath));
+
+    int fd = open(confPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP
+                  | S_IROTH);
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create '%s'. (%m)", confPath);
+        return LE_FAULT;
+    }
+    ssize_t written = write(fd, confText, sizeof(confText) - 1);
+    fd_Close(fd);
+    if (written != sizeof(confText) - 1)
+    {
+        LE_ERROR("Failed to write '%s'. (%m)", confPath);
+        return LE_FAULT;
+    }
+
+    bool isCurrent = (strcmp(systemPath, CURRENT_SYSTEM_PATH) == 0);
+
+    pid_t pid = fork();
+    LE_FATAL_IF(pid < 0, "Failed to fork. (%m)");
+
+    if (pid == 0)
+    {
+        // Only this process sees the bind mount.
+        if (   (!isCurrent)
+            && (   (unshare(CLONE_NEWNS) != 0)
+                || (mount(NULL, "/", NULL, MS_REC | MS_PRIVATE, NULL) != 0)
+                || (mount(systemPath, CURRENT_SYSTEM_PATH, NULL, MS_BIND, NULL) != 0)))
+        {
+            LE_ERROR("Failed to mount '%s' as the current system. (%m)", systemPath);
+            _exit(EXIT_FAILURE);
+        }
+
+        // Paths are under the current system's directory, where the system now is.
+        char currentCachePath[PATH_MAX];
+        char currentConfPath[PATH_MAX];
+        LE_ASSERT(snprintf(currentCachePath, sizeof(currentCachePath), "%s/%s",
+                           CURRENT_SYSTEM_PATH, INSTALLER_LD_SO_CACHE_FILE)
+                  < sizeof(currentCachePath));
+        LE_ASSERT(snprintf(currentConfPath, sizeof(currentConfPath), "%s/ld.so.conf",
+                           CURRENT_SYSTEM_PATH) < sizeof(currentConfPath));
+
+        int nullFd = open("/dev/null", O_WRONLY);
+        if (nullFd >= 0)
+        {
+            dup2(nullFd, STDOUT_FILENO);
+            fd_Close(nullFd);
+        }
+
+        execlp("ldconfig", "ldconfig", "-C", currentCachePath, "-f", currentConfPath, NULL);
+        LE_ERROR("Failed to run ldconfig. (%m)");
+        _exit(EXIT_FAILURE);
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) == -1)
+    {
+        LE_FATAL_IF(errno != EINTR, "waitpid() failed. (%m)");
+    }
+
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+    {
+        LE_ERROR("Failed to build the dynamic linker cache of '%s'.", systemPath);
+        unlink(cachePath);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mount an app's file system image (see INSTALLER_APP_IMAGE_FILE) over its install directory, if
+ * the app was installed as an image.  The files in the image are given the app's SMACK label.
+ *
+ * @return
+ *      - LE_OK if the image is mounted (or already was).
+ *      - LE_NOT_FOUND if the app wasn't installed as an image.
+ *      - LE_FAULT if the image couldn't be mounted.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t installer_MountAppImage
+(
+    const char* appDirPath, ///< App's install directory (e.g., "/legato/apps/<hash>").
+    const char* appNamePtr  ///< Name of the app.
+)
+{
+    // The install directory is usually reached through the system's symlink to it.
+    char dirPath[PATH_MAX];
+
+    if (realpath(appDirPath, dirPath) == NULL)
+    {
+        LE_CRIT("Could not resolve '%s' (%m).", appDirPath);
+        return LE_FAULT;
+    }
+
+    // Once mounted, the image file is hidden under the mount.
+    if (fs_IsMountPoint(dirPath))
+    {
+        return LE_OK;
+    }
+
+    char imagePath[PATH_MAX];
+    LE_ASSERT(snprintf(imagePath, sizeof(imagePath), "%s/" INSTALLER_APP_IMAGE_FILE, dirPath)
+              < sizeof(imagePath));
+
+    if (!file_Exists(imagePath))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    // The files can't be labelled one by one in a read-only file system, so they all get the
+    // app's label through the mount options.
+    char options[2 * LIMIT_MAX_SMACK_LABEL_BYTES + 32] = "";
+
+    if (smack_IsEnabled())
+    {
+        char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
+        smack_GetAppLabel(appNamePtr, appLabel, sizeof(appLabel));
+
+        LE_ASSERT(snprintf(options, sizeof(options), "smackfsdef=%s,smackfsroot=%s",
+                           appLabel, appLabel) < sizeof(options));
+    }
+
+    return fs_MountImage(imagePath, dirPath, "squashfs", (options[0] == '\0') ? NULL : options);
+}
@@ -78,4 +78,54 @@ le_result_t installer_RemoveAppWriteableDeviceFiles
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the dynamic linker cache file that is prebuilt in each system's directory, for its
+ * libraries as they will be found once the system is the current system.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INSTALLER_LD_SO_CACHE_FILE "ld.so.cache"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the read-only file system image that an app is installed as, in the app's install
+ * directory, when its update pack was built as an image rather than as a tarball.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INSTALLER_APP_IMAGE_FILE "app.img"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mount an app's file system image (see INSTALLER_APP_IMAGE_FILE) over its install directory, if
+ * the app was installed as an image.  The files in the image are given the app's SMACK label.
+ *
+ * @return
+ *      - LE_OK if the image is mounted (or already was).
+ *      - LE_NOT_FOUND if the app wasn't installed as an image.
+ *      - LE_FAULT if the image couldn't be mounted.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t installer_MountAppImage
+(
+    const char* appDirPath, ///< App's install directory (e.g., "/legato/apps/<hash>").
+    const char* appNamePtr  ///< Name of the app.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a system's dynamic linker cache (see INSTALLER_LD_SO_CACHE_FILE), so that it doesn't have
+ * to be rebuilt when the system is made current.
+ *
+ * @return LE_OK if successful.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t installer_BuildLdSoCache
+(
+    const char* systemPath  ///< Path to the system's directory (e.g., "/legato/systems/unpack").
+);
+
+
 #endif // LEGATO_INSTALLER_H_INCLUDE_GUARD
@@ -7,12 +7,16 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "legato.h"
+#include "json.h"
 
 
 /// Maximum number of bytes allowed in a string value, object member name, or number's text
 /// including the null terminator.
 #define MAX_STRING_BYTES 1024
 
+/// Number of bytes read from the file descriptor at a time, when the fd is a regular file.
+#define READ_CHUNK_BYTES 1024
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -54,9 +58,13 @@ typedef struct le_json_ParsingSession
     size_t numBytes;                ///< # of bytes of content in the buffer.
     double number;                  ///< Value of last number parsed.
 
-    int fd;                         ///< File descriptor to read the JSON document from.
+    int fd;                         ///< File descriptor to read the JSON document from (-1 if
+                                    ///  parsing from a buffer).
     le_fdMonitor_Ref_t fdMonitor;   ///< File Descriptor Monitor used to monitor the fd.
+    bool isSeekable;                ///< true if the fd can be read ahead of the parser.
+    size_t unprocessedBytes;        ///< # of bytes read ahead that haven't been processed yet.
     size_t bytesRead;               ///< # of bytes read from the file descriptor.
+    bool hasError;                  ///< true if an error has been reported.
     size_t line;                    ///< Line number of the JSON document (starts at 1).
 
     le_json_ErrorHandler_t errorHandler; ///< Function to call when errors happen.
@@ -130,8 +138,27 @@ static void StopParsing
     if (NotStopped(parserPtr))
     {
         parserPtr->next = EXPECT_NOTHING;
-        le_fdMonitor_Delete(parserPtr->fdMonitor);
-        parserPtr->fdMonitor = NULL;
+
+        if (parserPtr->fdMonitor != NULL)
+        {
+            le_fdMonitor_Delete(parserPtr->fdMonitor);
+            parserPtr->fdMonitor = NULL;
+        }
+
+        // Give back anything that was read past the point where parsing stopped, so whatever
+        // follows the JSON document can still be read from the file descriptor.  This is done
+        // here rather than in ReadData() because a handler may close the fd right after stopping.
+        if (parserPtr->isSeekable && (parserPtr->unprocessedBytes > 0))
+        {
+            if (lseek(parserPtr->fd, -(off_t)parserPtr->unprocessedBytes, SEEK_CUR) == -1)
+            {
+                LE_ERROR("Failed to seek back %zu bytes in JSON document fd %d (%m).",
+                         parserPtr->unprocessedBytes,
+                         parserPtr->fd);
+            }
+
+            parserPtr->unprocessedBytes = 0;
+        }
     }
 }
 
@@ -183,6 +210,8 @@ void json_Init
 
     // Initialize the thread-local data key.
     pthread_key_create(&HandlerKey, NULL);
+
+    jsonDoc_Init();
 }
 
 
@@ -264,6 +293,7 @@ static void Error
     snprintf(errorMessage, sizeof(errorMessage), "%s (at line %zu)", msg, parserPtr->line);
 
     StopParsing(parserPtr);
+    parserPtr->hasError = true;
 
     // Set the thread-local pointer to the parser object for the handler to use.
     pthread_setspecific(HandlerKey, parserPtr);
@@ -612,8 +642,20 @@ static void ParseString
     // See if this is a string terminating '"' character.
     if (c == '"')
     {
-        // It's not string terminating if it is escaped.
-        if ((parserPtr->bytesRead == 0) || (parserPtr->buffer[parserPtr->bytesRead - 1] != '\\'))
+        // It's not string terminating if it is escaped, i.e., if it follows an odd number of
+        // backslashes.
+        size_t numBackslashes = 0;
+        while (   (numBackslashes < parserPtr->numBytes)
+               && (parserPtr->buffer[parserPtr->numBytes - numBackslashes - 1] == '\\'))
+        {
+            numBackslashes++;
+        }
+
+        if ((numBackslashes % 2) != 0)
+        {
+            AddToBuffer(parserPtr, c);
+        }
+        else
         {
             // Make we have a valid UTF-8 string.
             if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
@@ -802,7 +844,9 @@ static void ProcessChar
 
         case EXPECT_NUMBER:
 
-            if ((c == '.') || isdigit(c))
+            // Anything that can be part of a number, including an exponent.  ProcessNumber()
+            // checks that it all makes sense.
+            if (isdigit(c) || (strchr(".eE+-", c) != NULL))
             {
                 AddToBuffer(parserPtr, c);
             }
@@ -851,6 +895,40 @@ static void ProcessChar
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process a block of the JSON document, stopping early if parsing stops.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessData
+(
+    Parser_t* parserPtr,
+    const char* dataPtr,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; (i < numBytes) && NotStopped(parserPtr); i++)
+    {
+        char c = dataPtr[i];
+
+        // Keep track of what hasn't been processed, in case parsing stops at this character.
+        parserPtr->unprocessedBytes = numBytes - i - 1;
+
+        parserPtr->bytesRead++;
+        if (c == '\n')
+        {
+            parserPtr->line++;
+        }
+        ProcessChar(parserPtr, c);
+    }
+
+    parserPtr->unprocessedBytes = 0;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read data from the JSON document file descriptor and process it.
@@ -863,13 +941,18 @@ static void ReadData
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Reading ahead of the parser is only done if the bytes that follow the end of the document
+    // can be given back (see StopParsing()).  Otherwise, the data has to be read one byte at a
+    // time, so nothing that follows the document is lost.
+    size_t readSize = (parserPtr->isSeekable ? READ_CHUNK_BYTES : 1);
+
     while (NotStopped(parserPtr))
     {
-        char c;
+        char data[READ_CHUNK_BYTES];
         ssize_t bytesRead;
         do
         {
-            bytesRead = read(fd, &c, 1);
+            bytesRead = read(fd, data, readSize);
         }
         while ((bytesRead == -1) && (errno == EINTR));
 
@@ -914,12 +997,7 @@ static void ReadData
         }
         else
         {
-            parserPtr->bytesRead++;
-            if (c == '\n')
-            {
-                parserPtr->line++;
-            }
-            ProcessChar(parserPtr, c);
+            ProcessData(parserPtr, data, bytesRead);
         }
     }
 }
@@ -975,30 +1053,31 @@ static void FdEventHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Parse a JSON document received via a file descriptor.
+ * Create a Parser object, ready to start parsing a document.
  *
- * @return Reference to the JSON parsing session started by this function call.
+ * @return Pointer to the Parser.
  */
 //--------------------------------------------------------------------------------------------------
-le_json_ParsingSessionRef_t le_json_Parse
+static Parser_t* CreateParser
 (
-    int fd, ///< File descriptor to read the JSON document from.
+    int fd,                                 ///< File descriptor, or -1 if parsing a buffer.
     le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
     le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
     void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Create a Parser.
     Parser_t* parserPtr = le_mem_ForceAlloc(ParserPool);
 
     parserPtr->next = EXPECT_OBJECT_OR_ARRAY;
     parserPtr->numBytes = 0;
 
     parserPtr->fd = fd;
-    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
-    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+    parserPtr->fdMonitor = NULL;
+    parserPtr->isSeekable = false;
+    parserPtr->unprocessedBytes = 0;
     parserPtr->bytesRead = 0;
+    parserPtr->hasError = false;
     parserPtr->line = 1;
 
     parserPtr->errorHandler = errorHandler;
@@ -1016,6 +1095,79 @@ le_json_ParsingSessionRef_t le_json_Parse
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document received via a file descriptor.
+ *
+ * @return Reference to the JSON parsing session started by this function call.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_ParsingSessionRef_t le_json_Parse
+(
+    int fd, ///< File descriptor to read the JSON document from.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(fd, eventHandler, errorHandler, opaquePtr);
+
+    // Only regular files can be read ahead of the parser, because anything read past the end of
+    // the document has to be given back by seeking.
+    struct stat fileInfo;
+    parserPtr->isSeekable = ((fstat(fd, &fileInfo) == 0) && S_ISREG(fileInfo.st_mode));
+
+    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+
+    return parserPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory.
+ *
+ * Unlike le_json_Parse(), this parses the whole document before returning, calling the handlers
+ * as it goes, and cleans up after itself.  Anything in the buffer after the end of the document
+ * is ignored.
+ *
+ * @return
+ *      - LE_OK if the whole document was parsed.
+ *      - LE_FAULT if an error was reported to the error handler.
+ *
+ * @warning The handlers must not call le_json_Cleanup().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_ParseBuffer
+(
+    const char* bufferPtr,  ///< The JSON document (need not be null-terminated).
+    size_t bufferSize,      ///< Number of bytes in the buffer.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(-1, eventHandler, errorHandler, opaquePtr);
+
+    ProcessData(parserPtr, bufferPtr, bufferSize);
+
+    if (NotStopped(parserPtr))
+    {
+        // The document has been truncated.
+        Error(parserPtr, LE_JSON_READ_ERROR, "Unexpected end of buffer.");
+    }
+
+    le_result_t result = (parserPtr->hasError ? LE_FAULT : LE_OK);
+
+    le_mem_Release(parserPtr);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
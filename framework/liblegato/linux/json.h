@@ -24,4 +24,16 @@ void json_Init
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the JSON document tree and writer module.
+ *
+ * Called by json_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void jsonDoc_Init
+(
+    void
+);
+
 #endif // JSON_H_INCLUDE_GUARD
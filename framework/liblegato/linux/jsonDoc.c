@@ -0,0 +1,1120 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file jsonDoc.c JSON Document Tree and JSON Writer implementation.
+ *
+ * A document tree is built from the JSON parser's events in two passes over the document.  The
+ * first pass counts the values in the document and the number of children each object or array
+ * has.  That's enough to allocate the whole tree in one block (the "arena") and to lay it out so
+ * that the children of each object or array are next to each other in the arena, in document order.
+ * The second pass fills in the tree.
+ *
+ * Each object also gets an open addressing hash table of its members (in the arena, after the
+ * nodes), so members can be looked up by name without searching.
+ *
+ * Strings and object member names are not copied.  They are terminated in place, in the caller's
+ * buffer, by writing a null character over the closing quote.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "json.h"
+
+
+/// Number of bytes of output buffered by a writer before it is written to the file descriptor.
+#define WRITER_BUFFER_BYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A value in a document tree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_json_Node
+{
+    le_json_ContextType_t type;         ///< Type of value.
+    const char* namePtr;                ///< Member name, or NULL if not an object member.
+    struct le_json_Node* parentPtr;     ///< Object or array containing this (NULL for the root).
+    union
+    {
+        const char* strPtr;             ///< String value.
+        double number;                  ///< Number value.
+        struct
+        {
+            struct le_json_Node* childrenPtr;   ///< Array of children.
+            size_t numChildren;                 ///< # of children filled in so far.
+            uint32_t* slotsPtr;                 ///< Member hash table (objects only): child
+                                                ///  index + 1, or 0 if the slot is empty.
+            size_t numSlots;                    ///< # of slots in the hash table (power of 2).
+        }
+        container;
+    }
+    value;
+}
+Node_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A document tree.  Allocated in one block, followed by the nodes (the root first) and then the
+ * hash table slots.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_json_Doc
+{
+    size_t numNodes;        ///< # of nodes in the tree.
+    Node_t nodes[];         ///< The nodes.
+}
+Doc_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Information collected about an object or array in the first pass.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t numChildren;     ///< # of children.
+    size_t parentIndex;     ///< Index of the containing object or array's Container_t.
+    bool isObject;          ///< true if an object, false if an array.
+}
+Container_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a document tree being built.  Passed to the event handlers as the opaque pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char* bufferPtr;                ///< The document.
+
+    // First pass
+    size_t numNodes;                ///< # of values found.
+    Container_t* containersPtr;     ///< Objects and arrays found, in document order.
+    size_t numContainers;           ///< # of entries used in the containers array.
+    size_t maxContainers;           ///< # of entries allocated in the containers array.
+    size_t currentIndex;            ///< Index of the container being counted (SIZE_MAX if none).
+
+    // Second pass
+    Doc_t* docPtr;                  ///< The tree.
+    size_t nextNode;                ///< Index of the next unused node.
+    uint32_t* nextSlotPtr;          ///< Next unused hash table slot.
+    size_t nextContainer;           ///< Index of the next object or array's Container_t.
+    Node_t* currentPtr;             ///< Object or array being filled in (NULL if none).
+    const char* namePtr;            ///< Member name of the next value.
+}
+Builder_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A JSON writer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_json_Writer
+{
+    int fd;                                 ///< File descriptor to write to.
+    bool needsComma;                        ///< true if a value has been written in the current
+                                            ///  object or array.
+    bool hasError;                          ///< true if an error has happened.
+    size_t numBytes;                        ///< # of bytes of output in the buffer.
+    char buffer[WRITER_BUFFER_BYTES];       ///< Output not written yet.
+}
+Writer_t;
+
+
+// Memory pool reference for the pool that writers are allocated from.
+static le_mem_PoolRef_t WriterPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the JSON document tree and writer module.
+ *
+ * Called by json_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void jsonDoc_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    WriterPool = le_mem_CreatePool("JSON Writer", sizeof(Writer_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler used for both passes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ERROR("Failed to parse JSON document: %s", msg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for the first pass.  Counts the values in the document.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountEventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Builder_t* builderPtr = le_json_GetOpaquePtr();
+
+    switch (event)
+    {
+        case LE_JSON_OBJECT_MEMBER:
+        case LE_JSON_DOC_END:
+            return;
+
+        case LE_JSON_OBJECT_END:
+        case LE_JSON_ARRAY_END:
+        {
+            Container_t* containerPtr = &builderPtr->containersPtr[builderPtr->currentIndex];
+
+            builderPtr->currentIndex = containerPtr->parentIndex;
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    builderPtr->numNodes++;
+
+    if (builderPtr->currentIndex != SIZE_MAX)
+    {
+        builderPtr->containersPtr[builderPtr->currentIndex].numChildren++;
+    }
+
+    if ((event == LE_JSON_OBJECT_START) || (event == LE_JSON_ARRAY_START))
+    {
+        if (builderPtr->numContainers == builderPtr->maxContainers)
+        {
+            builderPtr->maxContainers = (builderPtr->maxContainers * 2) + 16;
+            builderPtr->containersPtr = realloc(builderPtr->containersPtr,
+                                                builderPtr->maxContainers * sizeof(Container_t));
+            LE_ASSERT(builderPtr->containersPtr != NULL);
+        }
+
+        Container_t* containerPtr = &builderPtr->containersPtr[builderPtr->numContainers];
+
+        containerPtr->numChildren = 0;
+        containerPtr->parentIndex = builderPtr->currentIndex;
+        containerPtr->isObject = (event == LE_JSON_OBJECT_START);
+
+        builderPtr->currentIndex = builderPtr->numContainers;
+        builderPtr->numContainers++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of the hash table to use for an object with a given number of members.
+ *
+ * @return The number of slots (zero or a power of two at least twice the number of members).
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetNumSlots
+(
+    size_t numMembers
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t numSlots = 0;
+
+    if (numMembers > 0)
+    {
+        numSlots = 2;
+        while (numSlots < numMembers * 2)
+        {
+            numSlots *= 2;
+        }
+    }
+
+    return numSlots;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate the string or member name that was just parsed, in place.
+ *
+ * @return Pointer to the string, in the document buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* TerminateString
+(
+    Builder_t* builderPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The parser has just read the closing quote.
+    char* endPtr = builderPtr->bufferPtr + le_json_GetBytesRead(le_json_GetSession()) - 1;
+    size_t len = strlen(le_json_GetString());
+
+    LE_ASSERT(*endPtr == '"');
+    *endPtr = '\0';
+
+    return endPtr - len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new node to the tree, as the next child of the object or array being filled in.
+ *
+ * @return Pointer to the node.
+ */
+//--------------------------------------------------------------------------------------------------
+static Node_t* AddNode
+(
+    Builder_t* builderPtr,
+    le_json_ContextType_t type
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Node_t* parentPtr = builderPtr->currentPtr;
+    Node_t* nodePtr;
+
+    if (parentPtr == NULL)
+    {
+        nodePtr = &builderPtr->docPtr->nodes[0];
+    }
+    else
+    {
+        size_t index = parentPtr->value.container.numChildren++;
+
+        nodePtr = &parentPtr->value.container.childrenPtr[index];
+
+        if (parentPtr->type == LE_JSON_CONTEXT_OBJECT)
+        {
+            size_t mask = parentPtr->value.container.numSlots - 1;
+            size_t slot = le_hashmap_HashString(builderPtr->namePtr) & mask;
+
+            while (parentPtr->value.container.slotsPtr[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+            parentPtr->value.container.slotsPtr[slot] = index + 1;
+        }
+    }
+
+    nodePtr->type = type;
+    nodePtr->namePtr = builderPtr->namePtr;
+    nodePtr->parentPtr = parentPtr;
+    builderPtr->namePtr = NULL;
+
+    return nodePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for the second pass.  Fills in the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildEventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Builder_t* builderPtr = le_json_GetOpaquePtr();
+    Node_t* nodePtr;
+
+    switch (event)
+    {
+        case LE_JSON_OBJECT_START:
+        case LE_JSON_ARRAY_START:
+        {
+            Container_t* containerPtr = &builderPtr->containersPtr[builderPtr->nextContainer++];
+
+            nodePtr = AddNode(builderPtr, (event == LE_JSON_OBJECT_START ? LE_JSON_CONTEXT_OBJECT
+                                                                         : LE_JSON_CONTEXT_ARRAY));
+
+            // Reserve room for the children and the member hash table.
+            nodePtr->value.container.childrenPtr = &builderPtr->docPtr->nodes[builderPtr->nextNode];
+            nodePtr->value.container.numChildren = 0;
+            builderPtr->nextNode += containerPtr->numChildren;
+
+            nodePtr->value.container.slotsPtr = builderPtr->nextSlotPtr;
+            nodePtr->value.container.numSlots = 0;
+            if (containerPtr->isObject)
+            {
+                nodePtr->value.container.numSlots = GetNumSlots(containerPtr->numChildren);
+                builderPtr->nextSlotPtr += nodePtr->value.container.numSlots;
+            }
+
+            builderPtr->currentPtr = nodePtr;
+            break;
+        }
+
+        case LE_JSON_OBJECT_END:
+        case LE_JSON_ARRAY_END:
+
+            builderPtr->currentPtr = builderPtr->currentPtr->parentPtr;
+            break;
+
+        case LE_JSON_OBJECT_MEMBER:
+
+            builderPtr->namePtr = TerminateString(builderPtr);
+            break;
+
+        case LE_JSON_STRING:
+
+            nodePtr = AddNode(builderPtr, LE_JSON_CONTEXT_STRING);
+            nodePtr->value.strPtr = TerminateString(builderPtr);
+            break;
+
+        case LE_JSON_NUMBER:
+
+            nodePtr = AddNode(builderPtr, LE_JSON_CONTEXT_NUMBER);
+            nodePtr->value.number = le_json_GetNumber();
+            break;
+
+        case LE_JSON_TRUE:
+
+            AddNode(builderPtr, LE_JSON_CONTEXT_TRUE);
+            break;
+
+        case LE_JSON_FALSE:
+
+            AddNode(builderPtr, LE_JSON_CONTEXT_FALSE);
+            break;
+
+        case LE_JSON_NULL:
+
+            AddNode(builderPtr, LE_JSON_CONTEXT_NULL);
+            break;
+
+        case LE_JSON_DOC_END:
+
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory into a read-only document tree.
+ *
+ * The tree is allocated in a single block.  Strings and object member names are not copied:
+ * they are null-terminated in place in the buffer (by overwriting their closing quotes), so the
+ * buffer is modified and must not be freed or changed until the tree has been deleted.
+ *
+ * @return Reference to the tree, or NULL if the document is not valid (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_DocRef_t le_json_CreateDoc
+(
+    char* bufferPtr,    ///< [IN] The JSON document (need not be null-terminated).  Modified.
+    size_t bufferSize   ///< [IN] Number of bytes in the buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Builder_t builder;
+
+    memset(&builder, 0, sizeof(builder));
+    builder.bufferPtr = bufferPtr;
+    builder.currentIndex = SIZE_MAX;
+
+    // First pass: count the values.
+    if (le_json_ParseBuffer(bufferPtr, bufferSize, CountEventHandler, ErrorHandler, &builder)
+        != LE_OK)
+    {
+        free(builder.containersPtr);
+        return NULL;
+    }
+
+    size_t numSlots = 0;
+    size_t i;
+
+    for (i = 0; i < builder.numContainers; i++)
+    {
+        if (builder.containersPtr[i].isObject)
+        {
+            numSlots += GetNumSlots(builder.containersPtr[i].numChildren);
+        }
+    }
+
+    // Allocate the arena and lay it out.
+    size_t nodesSize = sizeof(Doc_t) + (builder.numNodes * sizeof(Node_t));
+    size_t slotsSize = numSlots * sizeof(uint32_t);
+
+    builder.docPtr = malloc(nodesSize + slotsSize);
+    LE_ASSERT(builder.docPtr != NULL);
+
+    builder.docPtr->numNodes = builder.numNodes;
+    builder.nextNode = 1;
+    builder.nextSlotPtr = (uint32_t*)((char*)builder.docPtr + nodesSize);
+    memset(builder.nextSlotPtr, 0, slotsSize);
+
+    // Second pass: fill in the tree.  This can only fail if the document changed.
+    LE_ASSERT(le_json_ParseBuffer(bufferPtr, bufferSize, BuildEventHandler, ErrorHandler, &builder)
+              == LE_OK);
+    LE_ASSERT(builder.nextNode == builder.numNodes);
+
+    free(builder.containersPtr);
+
+    return builder.docPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a document tree.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_DeleteDoc
+(
+    le_json_DocRef_t docRef     ///< [IN] The tree.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(docRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the top-level object or array of a document tree.
+ *
+ * @return The root node.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_GetDocRoot
+(
+    le_json_DocRef_t docRef     ///< [IN] The tree.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return &docRef->nodes[0];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of value held by a node.
+ *
+ * @return LE_JSON_CONTEXT_OBJECT, LE_JSON_CONTEXT_ARRAY, LE_JSON_CONTEXT_STRING,
+ *         LE_JSON_CONTEXT_NUMBER, LE_JSON_CONTEXT_TRUE, LE_JSON_CONTEXT_FALSE or
+ *         LE_JSON_CONTEXT_NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_ContextType_t le_json_GetNodeType
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return nodeRef->type;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the member name of a node that is an object member.
+ *
+ * @return The name, or NULL if the node is not an object member.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* le_json_GetNodeName
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return nodeRef->namePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of members of an object or elements of an array.
+ *
+ * @return The number of children, or 0 if the node is not an object or array.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_json_GetNodeCount
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((nodeRef->type != LE_JSON_CONTEXT_OBJECT) && (nodeRef->type != LE_JSON_CONTEXT_ARRAY))
+    {
+        return 0;
+    }
+
+    return nodeRef->value.container.numChildren;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a member of an object or element of an array by position, in document order.
+ *
+ * @return The child, or NULL if the index is out of range or the node is not an object or array.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_GetNodeChild
+(
+    le_json_NodeRef_t nodeRef,  ///< [IN] The object or array.
+    size_t index                ///< [IN] Position of the child (0 = first).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (index >= le_json_GetNodeCount(nodeRef))
+    {
+        return NULL;
+    }
+
+    return &nodeRef->value.container.childrenPtr[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a member of an object by name.  If the object has more than one member with the name,
+ * the first one is found.
+ *
+ * @return The member, or NULL if not found or the node is not an object.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_NodeRef_t le_json_FindNodeMember
+(
+    le_json_NodeRef_t nodeRef,  ///< [IN] The object.
+    const char* namePtr         ///< [IN] Member name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((nodeRef->type != LE_JSON_CONTEXT_OBJECT) || (nodeRef->value.container.numSlots == 0))
+    {
+        return NULL;
+    }
+
+    size_t mask = nodeRef->value.container.numSlots - 1;
+    size_t slot = le_hashmap_HashString(namePtr) & mask;
+    uint32_t entry;
+
+    while ((entry = nodeRef->value.container.slotsPtr[slot]) != 0)
+    {
+        Node_t* childPtr = &nodeRef->value.container.childrenPtr[entry - 1];
+
+        if (strcmp(childPtr->namePtr, namePtr) == 0)
+        {
+            return childPtr;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a string node.  Escape sequences are not decoded (see le_json_GetString()).
+ *
+ * @return The string (in the document buffer), or NULL if the node is not a string.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* le_json_GetNodeString
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (nodeRef->type != LE_JSON_CONTEXT_STRING)
+    {
+        return NULL;
+    }
+
+    return nodeRef->value.strPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of a number node.
+ *
+ * @return The number, or 0 if the node is not a number.
+ */
+//--------------------------------------------------------------------------------------------------
+double le_json_GetNodeNumber
+(
+    le_json_NodeRef_t nodeRef   ///< [IN] The node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (nodeRef->type != LE_JSON_CONTEXT_NUMBER)
+    {
+        return 0;
+    }
+
+    return nodeRef->value.number;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out the contents of a writer's buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Flush
+(
+    Writer_t* writerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+
+    while ((offset < writerPtr->numBytes) && !writerPtr->hasError)
+    {
+        ssize_t result = write(writerPtr->fd,
+                               writerPtr->buffer + offset,
+                               writerPtr->numBytes - offset);
+        if (result >= 0)
+        {
+            offset += result;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Failed to write JSON to fd %d (%m).", writerPtr->fd);
+            writerPtr->hasError = true;
+        }
+    }
+
+    writerPtr->numBytes = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add bytes to a writer's output.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Output
+(
+    Writer_t* writerPtr,
+    const char* dataPtr,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (numBytes > 0)
+    {
+        if (writerPtr->numBytes == sizeof(writerPtr->buffer))
+        {
+            Flush(writerPtr);
+        }
+
+        size_t chunkBytes = sizeof(writerPtr->buffer) - writerPtr->numBytes;
+        if (chunkBytes > numBytes)
+        {
+            chunkBytes = numBytes;
+        }
+
+        memcpy(writerPtr->buffer + writerPtr->numBytes, dataPtr, chunkBytes);
+        writerPtr->numBytes += chunkBytes;
+        dataPtr += chunkBytes;
+        numBytes -= chunkBytes;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string to a writer's output, in quotes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OutputString
+(
+    Writer_t* writerPtr,
+    const char* strPtr,
+    bool isEscaped          ///< true if the string is already escaped (e.g., from a document tree).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Output(writerPtr, "\"", 1);
+
+    if (isEscaped)
+    {
+        Output(writerPtr, strPtr, strlen(strPtr));
+    }
+    else
+    {
+        const char* startPtr = strPtr;
+
+        for (; *strPtr != '\0'; strPtr++)
+        {
+            unsigned char c = *strPtr;
+
+            if ((c == '"') || (c == '\\') || (c < 0x20))
+            {
+                char escape[8];
+
+                Output(writerPtr, startPtr, strPtr - startPtr);
+                startPtr = strPtr + 1;
+
+                switch (c)
+                {
+                    case '"':  Output(writerPtr, "\\\"", 2); break;
+                    case '\\': Output(writerPtr, "\\\\", 2); break;
+                    case '\n': Output(writerPtr, "\\n", 2);  break;
+                    case '\r': Output(writerPtr, "\\r", 2);  break;
+                    case '\t': Output(writerPtr, "\\t", 2);  break;
+                    default:
+                        snprintf(escape, sizeof(escape), "\\u%04x", c);
+                        Output(writerPtr, escape, 6);
+                        break;
+                }
+            }
+        }
+
+        Output(writerPtr, startPtr, strPtr - startPtr);
+    }
+
+    Output(writerPtr, "\"", 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new value, writing the comma that separates it from the one before it if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartValue
+(
+    Writer_t* writerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (writerPtr->needsComma)
+    {
+        Output(writerPtr, ",", 1);
+    }
+
+    writerPtr->needsComma = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a JSON writer.  The writer buffers the output, so nothing may be written to the file
+ * descriptor until le_json_DeleteWriter() is called.
+ *
+ * @return Reference to the writer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_WriterRef_t le_json_CreateWriter
+(
+    int fd          ///< [IN] File descriptor to write the JSON document to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Writer_t* writerPtr = le_mem_ForceAlloc(WriterPool);
+
+    writerPtr->fd = fd;
+    writerPtr->needsComma = false;
+    writerPtr->hasError = false;
+    writerPtr->numBytes = 0;
+
+    return writerPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out anything still buffered and delete a JSON writer.  The file descriptor is not closed.
+ *
+ * @return
+ *      - LE_OK if everything was written.
+ *      - LE_FAULT if writing to the file descriptor failed (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_DeleteWriter
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Flush(writerRef);
+
+    le_result_t result = (writerRef->hasError ? LE_FAULT : LE_OK);
+
+    le_mem_Release(writerRef);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing an object.  Must be followed by its members and then le_json_WriteObjectEnd().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteObjectStart
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+    Output(writerRef, "{", 1);
+    writerRef->needsComma = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish writing an object.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteObjectEnd
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Output(writerRef, "}", 1);
+    writerRef->needsComma = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start writing an array.  Must be followed by its elements and then le_json_WriteArrayEnd().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteArrayStart
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+    Output(writerRef, "[", 1);
+    writerRef->needsComma = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish writing an array.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteArrayEnd
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Output(writerRef, "]", 1);
+    writerRef->needsComma = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the name of an object member.  Must be followed by the member's value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteMemberName
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    const char* namePtr             ///< [IN] Member name (will be escaped).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+    OutputString(writerRef, namePtr, false);
+    Output(writerRef, ":", 1);
+    writerRef->needsComma = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteString
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    const char* strPtr              ///< [IN] The string (will be escaped).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+    OutputString(writerRef, strPtr, false);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a number value.  Numbers that can't be represented in JSON (infinities and NaN) are
+ * written as null.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNumber
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    double number                   ///< [IN] The number.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char text[32];
+    int len;
+
+    if (isfinite(number))
+    {
+        // Use the shortest of the two precisions that gives back the same number when read.
+        len = snprintf(text, sizeof(text), "%.15g", number);
+        if (strtod(text, NULL) != number)
+        {
+            len = snprintf(text, sizeof(text), "%.17g", number);
+        }
+    }
+    else
+    {
+        len = snprintf(text, sizeof(text), "null");
+    }
+
+    StartValue(writerRef);
+    Output(writerRef, text, len);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a true or false value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteBool
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    bool value                      ///< [IN] The value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+
+    if (value)
+    {
+        Output(writerRef, "true", 4);
+    }
+    else
+    {
+        Output(writerRef, "false", 5);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a null value.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNull
+(
+    le_json_WriterRef_t writerRef   ///< [IN] The writer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StartValue(writerRef);
+    Output(writerRef, "null", 4);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a copy of a value from a document tree, including all of its children.  If the node is an
+ * object member, only its value is written, not its name.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_WriteNode
+(
+    le_json_WriterRef_t writerRef,  ///< [IN] The writer.
+    le_json_NodeRef_t nodeRef       ///< [IN] The value to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    switch (nodeRef->type)
+    {
+        case LE_JSON_CONTEXT_OBJECT:
+
+            le_json_WriteObjectStart(writerRef);
+            for (i = 0; i < nodeRef->value.container.numChildren; i++)
+            {
+                Node_t* childPtr = &nodeRef->value.container.childrenPtr[i];
+
+                // Names from a tree are still escaped, as they were in the original document.
+                StartValue(writerRef);
+                OutputString(writerRef, childPtr->namePtr, true);
+                Output(writerRef, ":", 1);
+                writerRef->needsComma = false;
+
+                le_json_WriteNode(writerRef, childPtr);
+            }
+            le_json_WriteObjectEnd(writerRef);
+            break;
+
+        case LE_JSON_CONTEXT_ARRAY:
+
+            le_json_WriteArrayStart(writerRef);
+            for (i = 0; i < nodeRef->value.container.numChildren; i++)
+            {
+                le_json_WriteNode(writerRef, &nodeRef->value.container.childrenPtr[i]);
+            }
+            le_json_WriteArrayEnd(writerRef);
+            break;
+
+        case LE_JSON_CONTEXT_STRING:
+
+            StartValue(writerRef);
+            OutputString(writerRef, nodeRef->value.strPtr, true);
+            break;
+
+        case LE_JSON_CONTEXT_NUMBER:
+
+            le_json_WriteNumber(writerRef, nodeRef->value.number);
+            break;
+
+        case LE_JSON_CONTEXT_TRUE:
+        case LE_JSON_CONTEXT_FALSE:
+
+            le_json_WriteBool(writerRef, (nodeRef->type == LE_JSON_CONTEXT_TRUE));
+            break;
+
+        case LE_JSON_CONTEXT_NULL:
+
+            le_json_WriteNull(writerRef);
+            break;
+
+        default:
+
+            LE_FATAL("Invalid JSON node type %d.", nodeRef->type);
+    }
+}
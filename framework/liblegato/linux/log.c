@@ -12,13 +12,17 @@
 #include "logDaemon/logDaemon.h"
 #include "limit.h"
 #include "messagingSession.h"
+#include "logBinary.h"
+#include "logRing.h"
+#include "logRateLimit.h"
+#include "fileDescriptor.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum length of log messages.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_MSG_SIZE            256
+#define MAX_MSG_SIZE            LOG_MAX_MSG_SIZE
 
 
 //--------------------------------------------------------------------------------------------------
@@ -62,6 +66,7 @@ typedef struct le_log_Session
     const char* componentNamePtr;       ///< A pointer to the component's name.
     le_log_Level_t level;               ///< The component's severity level filter.
                                         ///  Log messages with severity less than this are ignored.
+    log_RateLimit_t rateLimit;          ///< The rate limit applied to each of its call sites.
     le_sls_List_t keywordList;          ///< The list of keywords for this component.
     le_sls_Link_t link;                 ///< The link used for linking with the SessionList.
 }
@@ -93,6 +98,7 @@ static le_mem_PoolRef_t SessionMemPool;
 static LogSession_t DefaultLogSession =    {
                                             .componentNamePtr="<invalid>",
                                             .level=LOG_DEFAULT_LOG_FILTER,
+                                            .rateLimit={ .count=0, .period=0 },
                                             .keywordList=LE_SLS_LIST_INIT,
                                             .link=LE_SLS_LINK_INIT
                                         };
@@ -129,6 +135,24 @@ static le_mem_PoolRef_t KeywordMemPool;
 static le_msg_SessionRef_t IpcSessionRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log ring received from the Log Control Daemon.  If not NULL, log messages are written into this
+ * instead of being sent to syslog (see logRing.h).  Set once, by the main thread, and read by
+ * every thread that logs.
+ **/
+//--------------------------------------------------------------------------------------------------
+static logRing_Ref_t RingRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process ID of this process, so that writing into the log ring doesn't need a system call.
+ **/
+//--------------------------------------------------------------------------------------------------
+static pid_t ProcessId;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Trace reference used for controlling tracing in this module.
@@ -291,91 +315,74 @@ static LogSession_t* GetSession
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Enable a trace keyword.
+ * Enable a trace keyword in a log session.
+ *
+ * @warning Assumes that the mutex is held by the caller.
  */
 //--------------------------------------------------------------------------------------------------
-static void EnableTrace
+static void EnableSessionTrace
 (
-    const char* componentNamePtr,   // The component that contains the keyword to disable.
-    const char* keywordPtr          // The trace keyword to disable.
+    LogSession_t* sessionPtr,       // The session that contains the keyword to enable.
+    const char* keywordPtr          // The trace keyword to enable.
 )
 {
-    Lock();
-
-    // Find the session for this component.
-    LogSession_t* sessionPtr = GetSession(componentNamePtr);
+    // Search for the keyword.
+    KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
 
-    if (sessionPtr)
+    if (keywordObjPtr == NULL)
     {
-        // Search for the keyword.
-        KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
-
-        if (keywordObjPtr == NULL)
-        {
-            // The keyword does not exist so we should create it from the memory pool.
-            keywordObjPtr = CreateKeyword(sessionPtr, keywordPtr);
-        }
-
-        // Enable the keyword.
-        keywordObjPtr->isEnabled = true;
+        // The keyword does not exist so we should create it from the memory pool.
+        keywordObjPtr = CreateKeyword(sessionPtr, keywordPtr);
     }
 
-    Unlock();
+    // Enable the keyword.
+    keywordObjPtr->isEnabled = true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Disable a trace keyword.
+ * Disable a trace keyword in a log session.
+ *
+ * @warning Assumes that the mutex is held by the caller.
  */
 //--------------------------------------------------------------------------------------------------
-static void DisableTrace
+static void DisableSessionTrace
 (
-    const char* componentNamePtr,   // The component that contains the keyword to disable.
+    LogSession_t* sessionPtr,       // The session that contains the keyword to disable.
     const char* keywordPtr          // The trace keyword to disable.
 )
 {
-    Lock();
-
-    // Find the session for this component.
-    LogSession_t* sessionPtr = GetSession(componentNamePtr);
+    // Search the keyword list for the keyword.
+    KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
 
-    if (sessionPtr)
+    if (keywordObjPtr)
     {
-        // Search the keyword list for the keyword.
-        KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
-
-        if (keywordObjPtr)
-        {
-            // Disable the keyword.
-            keywordObjPtr->isEnabled = false;
-        }
+        // Disable the keyword.
+        keywordObjPtr->isEnabled = false;
     }
-
-    Unlock();
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the log level filter for a specific component.
+ * Enable a trace keyword.
  */
 //--------------------------------------------------------------------------------------------------
-static void SetLogLevelFilter
+static void EnableTrace
 (
-    const char* componentNamePtr,   // The name of the component.
-    int levelFilter                 // The filter level.
+    const char* componentNamePtr,   // The component that contains the keyword to enable.
+    const char* keywordPtr          // The trace keyword to enable.
 )
 {
     Lock();
 
-    // Find the session to apply the filter to.
+    // Find the session for this component.
     LogSession_t* sessionPtr = GetSession(componentNamePtr);
 
     if (sessionPtr)
     {
-        // Set this component's level.
-        sessionPtr->level = levelFilter;
+        EnableSessionTrace(sessionPtr, keywordPtr);
     }
 
     Unlock();
@@ -400,6 +407,7 @@ static LogSession_t* CreateSession
     // Initialize the log session.
     logSessionPtr->componentNamePtr = componentNamePtr;
     logSessionPtr->level = DefaultLogSession.level;
+    logSessionPtr->rateLimit = DefaultLogSession.rateLimit;
     logSessionPtr->keywordList = LE_SLS_LIST_INIT;
     logSessionPtr->link = LE_SLS_LINK_INIT;
 
@@ -443,6 +451,29 @@ static void ReadLevelFromEnv
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the default rate limit from the environment, if present.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ReadRateLimitFromEnv
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv("LE_LOG_RATE_LIMIT");
+
+    if (envStrPtr != NULL)
+    {
+        if (log_StrToRateLimit(envStrPtr, &DefaultLogSession.rateLimit) != LE_OK)
+        {
+            LE_ERROR("LE_LOG_RATE_LIMIT environment variable has invalid value '%s'.", envStrPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Loads the default list of enabled trace keywords from the environment, if present.
@@ -620,55 +651,154 @@ static bool ParseCmdPacket
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Processes a remote logging command.  This function should be called by the event loop when there
- * is a received log command.
+ * Applies a logging command received from the Log Control Daemon to a log session.
+ *
+ * @return
+ *      true if success.
+ *      false if the command code is not valid.
+ *
+ * @warning Assumes that the mutex is held by the caller.
  */
 //--------------------------------------------------------------------------------------------------
-static void ProcessLogCmd
+static bool ApplyLogCmd
 (
-    le_msg_MessageRef_t msgRef,
-    void*               contextPtr  // not used.
+    LogSession_t* sessionPtr,       ///< [IN] The session to apply the command to.
+    char command,                   ///< [IN] The command code.
+    const char* commandDataPtr      ///< [IN] The CommandData part of the command.
 )
 {
-    char* cmdPacketPtr = le_msg_GetPayloadPtr(msgRef);
+    switch (command)
+    {
+        case LOG_CMD_SET_LEVEL:
+        {
+            int level = log_StrToSeverityLevel(commandDataPtr);
 
+            if (level != -1)
+            {
+                sessionPtr->level = level;
+            }
+            return true;
+        }
+
+        case LOG_CMD_ENABLE_TRACE:
+            EnableSessionTrace(sessionPtr, commandDataPtr);
+            return true;
+
+        case LOG_CMD_DISABLE_TRACE:
+            DisableSessionTrace(sessionPtr, commandDataPtr);
+            return true;
+
+        case LOG_CMD_SET_RATE_LIMIT:
+        {
+            log_RateLimit_t rateLimit;
+
+            if (log_StrToRateLimit(commandDataPtr, &rateLimit) == LE_OK)
+            {
+                sessionPtr->rateLimit = rateLimit;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processes one remote logging command.  The component name "*" applies it to every component
+ * in the process.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessOneLogCmd
+(
+    const char* cmdPacketPtr        ///< [IN] The command packet.
+)
+{
     char command;
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
     const char* commandDataPtr;
 
     // Parse the packet.
-    if (ParseCmdPacket(cmdPacketPtr, &command, componentName, &commandDataPtr))
+    if (!ParseCmdPacket(cmdPacketPtr, &command, componentName, &commandDataPtr))
     {
-        // Process the data
-        switch (command)
-        {
-            case LOG_CMD_SET_LEVEL:
-            {
-                int level = log_StrToSeverityLevel(commandDataPtr);
+        LE_ERROR("Malformed command packet '%s'.", cmdPacketPtr);
+        return;
+    }
 
-                if (level != -1)
-                {
-                    SetLogLevelFilter(componentName, level);
-                }
-                break;
-            }
+    bool isValid = true;
 
-            case LOG_CMD_ENABLE_TRACE:
-                EnableTrace(componentName, commandDataPtr);
-                break;
+    Lock();
 
-            case LOG_CMD_DISABLE_TRACE:
-                DisableTrace(componentName, commandDataPtr);
-                break;
+    if (strcmp(componentName, "*") == 0)
+    {
+        le_sls_Link_t* sessionLinkPtr = le_sls_Peek(&SessionList);
 
-            default:
-                LE_ERROR("Invalid command character '%c'.", command);
-                break;
+        while ((sessionLinkPtr != NULL) && isValid)
+        {
+            LogSession_t* sessionPtr = CONTAINER_OF(sessionLinkPtr, LogSession_t, link);
+
+            isValid = ApplyLogCmd(sessionPtr, command, commandDataPtr);
+
+            sessionLinkPtr = le_sls_PeekNext(&SessionList, sessionLinkPtr);
         }
     }
     else
     {
-        LE_ERROR("Malformed command packet '%s'.", cmdPacketPtr);
+        LogSession_t* sessionPtr = GetSession(componentName);
+
+        if (sessionPtr)
+        {
+            isValid = ApplyLogCmd(sessionPtr, command, commandDataPtr);
+        }
+    }
+
+    Unlock();
+
+    if (!isValid)
+    {
+        LE_ERROR("Invalid command character '%c'.", command);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processes a message of remote logging commands.  This function should be called by the event
+ * loop when there is a received log command message.
+ *
+ * The Log Control Daemon batches the commands for a process into as few messages as it can, so
+ * the message may hold several commands, separated by LOG_CMD_SEPARATOR characters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessLogCmd
+(
+    le_msg_MessageRef_t msgRef,
+    void*               contextPtr  // not used.
+)
+{
+    char* cmdPacketPtr = le_msg_GetPayloadPtr(msgRef);
+
+    // Make sure the last command is terminated, even if the message was filled to the brim.
+    cmdPacketPtr[le_msg_GetMaxPayloadSize(msgRef) - 1] = '\0';
+
+    while (*cmdPacketPtr != '\0')
+    {
+        char* nextPtr = strchr(cmdPacketPtr, LOG_CMD_SEPARATOR);
+
+        if (nextPtr != NULL)
+        {
+            *nextPtr = '\0';
+            nextPtr++;
+        }
+        else
+        {
+            nextPtr = cmdPacketPtr + strlen(cmdPacketPtr);
+        }
+
+        ProcessOneLogCmd(cmdPacketPtr);
+
+        cmdPacketPtr = nextPtr;
     }
 
     le_msg_ReleaseMsg(msgRef);
@@ -724,19 +854,51 @@ static void RegisterWithLogControlDaemon
         // log settings get applied before the component initialization functions run.
         msgRef = le_msg_RequestSyncResponse(msgRef);
 
-        // The response has no payload.
+        // The response has no payload, but the response to the first registration may carry the
+        // log ring that the Log Control Daemon created for this process.
         if (msgRef == NULL)
         {
             LE_ERROR("Log session registration failed!");
         }
         else
         {
+            int fd = le_msg_GetFd(msgRef);
+
+            if (fd >= 0)
+            {
+                if (RingRef == NULL)
+                {
+                    __atomic_store_n(&RingRef, logRing_Map(fd), __ATOMIC_RELEASE);
+                }
+                else
+                {
+                    fd_Close(fd);
+                }
+            }
+
             le_msg_ReleaseMsg(msgRef);
         }
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the child process after a fork().  The log ring belongs to the parent, so the child
+ * must not write into it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ForgetRingInChild
+(
+    void
+)
+{
+    // The mapping is left alone, as the parent's ring must not be touched.
+    RingRef = NULL;
+    ProcessId = getpid();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.
@@ -749,8 +911,17 @@ void log_Init
 {
     // NOTE: This is called when there is only one thread running, so no need to lock the mutex.
 
+    ProcessId = getpid();
+    logRing_Init();
+    LE_ASSERT(pthread_atfork(NULL, NULL, ForgetRingInChild) == 0);
+
     // Load the default log level filter and output destination settings from the environment.
     ReadLevelFromEnv();
+    ReadRateLimitFromEnv();
+    logRateLimit_Init();
+
+    // Switch to binary logging if the environment asks for it.
+    logBinary_Init();
 
     // Create the keyword memory pool.
     KeywordMemPool = le_mem_CreatePool("TraceKeys", sizeof(KeywordObj_t));
@@ -978,6 +1149,85 @@ const char* log_SeverityLevelToStr
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a rate limit string to a rate limit.  The string must be "off", for no limit, or
+ * "COUNT/SECONDS", where COUNT messages are allowed every SECONDS seconds.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the string is an invalid rate limit.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t log_StrToRateLimit
+(
+    const char* rateLimitStr,           ///< [IN] The rate limit string.
+    log_RateLimit_t* rateLimitPtr       ///< [OUT] The rate limit.
+)
+{
+    if (strcmp(rateLimitStr, LOG_RATE_LIMIT_OFF_STR) == 0)
+    {
+        rateLimitPtr->count = 0;
+        rateLimitPtr->period = 0;
+        return LE_OK;
+    }
+
+    // strtoul() would accept leading white space and signs, so check for a digit first.
+    if (!isdigit((unsigned char)rateLimitStr[0]))
+    {
+        return LE_FAULT;
+    }
+
+    char* endPtr;
+    errno = 0;
+    unsigned long count = strtoul(rateLimitStr, &endPtr, 10);
+
+    if ((errno != 0) || (*endPtr != '/') || (!isdigit((unsigned char)endPtr[1])))
+    {
+        return LE_FAULT;
+    }
+
+    unsigned long period = strtoul(endPtr + 1, &endPtr, 10);
+
+    if (   (errno != 0) || (*endPtr != '\0')
+        || (count == 0) || (count > UINT32_MAX)
+        || (period == 0) || (period > UINT32_MAX) )
+    {
+        return LE_FAULT;
+    }
+
+    rateLimitPtr->count = count;
+    rateLimitPtr->period = period;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a rate limit to a rate limit string.  The buffer must be at least
+ * LOG_RATE_LIMIT_STR_BYTES long.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_RateLimitToStr
+(
+    const log_RateLimit_t* rateLimitPtr,    ///< [IN] The rate limit.
+    char* bufferPtr,                        ///< [OUT] Buffer to write the string into.
+    size_t bufferSize                       ///< [IN] Size of the buffer.
+)
+{
+    if (rateLimitPtr->count == 0)
+    {
+        LE_ASSERT(le_utf8_Copy(bufferPtr, LOG_RATE_LIMIT_OFF_STR, bufferSize, NULL) == LE_OK);
+    }
+    else
+    {
+        LE_ASSERT(snprintf(bufferPtr, bufferSize, "%" PRIu32 "/%" PRIu32,
+                           rateLimitPtr->count, rateLimitPtr->period) < (int)bufferSize);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Converts the legato log levels to the syslog priority levels.
@@ -1017,9 +1267,89 @@ static int ConvertToSyslogLevel
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a fully formatted log message out to the logging system.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_WriteMsg
+(
+    le_log_Level_t level,           ///< [IN] Severity level (-1 for a trace).
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* threadNamePtr,      ///< [IN] Name of the thread that logged the message.
+    const char* filenamePtr,        ///< [IN] Source file that logged the message.
+    const char* functionNamePtr,    ///< [IN] Function that logged the message.
+    unsigned int lineNumber,        ///< [IN] Line number in the source file.
+    time_t timestamp,               ///< [IN] Time at which the message was logged.
+    const char* msgPtr              ///< [IN] Formatted user message.
+)
+{
+    // Get the file name.
+    char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
+
+    // Get the process name.
+    const char* procNamePtr = le_arg_GetProgramName();
+    if (procNamePtr == NULL)
+    {
+        procNamePtr = "n/a";
+    }
+
+    // If the Log Control Daemon gave us a log ring, write the message into that.
+    logRing_Ref_t ringRef = __atomic_load_n(&RingRef, __ATOMIC_ACQUIRE);
+
+    if (ringRef != NULL)
+    {
+        char line[LOG_MAX_LINE_SIZE];
+
+        snprintf(line, sizeof(line), "%s | %s[%d]/%s T=%s | %s %s() %d | %s",
+                 levelPtr, procNamePtr, ProcessId, compNamePtr, threadNamePtr, baseFileNamePtr,
+                 functionNamePtr, lineNumber, msgPtr);
+
+        logRing_Write(ringRef, level, line);
+    }
+
+    // If running on an embedded target, write the message out to the log, unless it went into
+    // the log ring, in which case the Log Control Daemon will do that.
+    // NOTE: syslog adds its own timestamp.
+#ifdef LEGATO_EMBEDDED
+
+    if (ringRef == NULL)
+    {
+        syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+               levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
+               functionNamePtr, lineNumber, msgPtr);
+    }
+
+    // If running on a PC, write the message to standard error with a timestamp added.  The log
+    // ring, if there is one, only keeps a copy for after a crash.
+#else
+
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if ( (timestamp != ((time_t)-1)) && (ctime_r(&timestamp, timeStamp) != NULL) )
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
+            baseFileNamePtr, functionNamePtr, lineNumber, msgPtr);
+
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Builds the log message and sends it to the logging system.
+ *
+ * In binary logging mode (see logBinary.h), debug, info and trace messages are instead queued
+ * with their raw arguments and formatted later by the binary log writer.
  */
 //--------------------------------------------------------------------------------------------------
 void _le_log_Send
@@ -1074,23 +1404,46 @@ void _le_log_Send
     // NOTE: The component name won't change, so it's safe to read this without locking the mutex.
     const char* compNamePtr = logSession->componentNamePtr;
 
-    // Get the file name.
-    char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
+    // Report the messages dropped by call sites that have since gone quiet, then drop this one if
+    // its own call site is over the component's rate limit.  Critical and emergency messages are
+    // never dropped.
+    logRateLimit_Flush(false);
 
-    // Get the thread name.
-    const char* threadNamePtr = le_thread_GetMyName();
+    if (   ((traceRef != NULL) || (level < LE_LOG_CRIT))
+        && (!logRateLimit_Check(&logSession->rateLimit, level, levelPtr, compNamePtr, filenamePtr,
+                                functionNamePtr, lineNumber)) )
+    {
+        return;
+    }
 
-    // Get the process name.
-    const char* procNamePtr = le_arg_GetProgramName();
-    if (procNamePtr == NULL)
+    va_list varParams;
+
+    if (logBinary_IsEnabled())
     {
-        procNamePtr = "n/a";
+        if ((level == LE_LOG_DEBUG) || (level == LE_LOG_INFO) || (traceRef != NULL))
+        {
+            va_start(varParams, formatPtr);
+
+            bool isQueued = logBinary_Queue(level, levelPtr, compNamePtr, filenamePtr,
+                                            functionNamePtr, lineNumber, savedErrno,
+                                            formatPtr, varParams);
+            va_end(varParams);
+
+            if (isQueued)
+            {
+                return;
+            }
+        }
+
+        // This message will be written straight away, so write out everything this thread queued
+        // before it first (or everything queued by any thread, if the process may be about to
+        // die).
+        logBinary_Flush(level >= LE_LOG_CRIT);
     }
 
     // Get the user message.
     char msg[MAX_MSG_SIZE] = "";
 
-    va_list varParams;
     va_start(varParams, formatPtr);
 
     // Reset the errno to ensure that we report the proper errno value.
@@ -1102,33 +1455,8 @@ void _le_log_Send
 
     va_end(varParams);
 
-    // If running on an embedded target, write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
-           functionNamePtr, lineNumber, msg);
-
-    // If running on a PC, write the message to standard error with a timestamp added.
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
-
-    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
-            baseFileNamePtr, functionNamePtr, lineNumber, msg);
-
-#endif
+    log_WriteMsg(level, levelPtr, compNamePtr, le_thread_GetMyName(), filenamePtr,
+                 functionNamePtr, lineNumber, time(NULL), msg);
 }
 
 
@@ -1338,6 +1666,42 @@ void log_TestFrameworkMsgs
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a complete log line, as formatted by log_WriteMsg() in the process that logged it, out
+ * to the logging system.  Used by the Log Control Daemon to pass on messages from log rings.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_WriteLine
+(
+    le_log_Level_t level,       ///< [IN] Severity level (-1 for a trace).
+    const char* linePtr         ///< [IN] Log line.
+)
+{
+#ifdef LEGATO_EMBEDDED
+
+    syslog(ConvertToSyslogLevel(level), "%s\n", linePtr);
+
+#else
+
+    time_t now;
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    fprintf(stderr, "%s : %s\n", timeStampPtr, linePtr);
+
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Logs a generic message with the given information.
@@ -0,0 +1,1234 @@
+/** @file logBinary.c
+ *
+ * Binary (deferred-format) logging.  See logBinary.h for an overview.
+ *
+ * Each thread that logs gets its own ring buffer of log records.  A record contains the pointers
+ * to the format string and to the other strings that make up the log message (all of which are
+ * string literals or live for the life of the process), a copy of the thread name, and the raw
+ * values of the arguments, in the order that they are consumed by the format string.  Strings
+ * passed for %s are copied, since they usually don't outlive the call.
+ *
+ * Only the owning thread ever adds records to a ring (advancing its head), and records are only
+ * ever removed (advancing the tail) with the DrainMutex held, so adding a record needs no lock.
+ * If the ring is full, the owning thread writes out its own records to make room.
+ *
+ * The writer thread sleeps until a thread queues a record while no wake-up is pending, then
+ * waits WRITER_DELAY_MS so that more records can collect before it writes them all out.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+#include "logBinary.h"
+#include "limit.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of each thread's ring buffer, in bytes.  Must be a power of two.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_SIZE           (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest record that can be queued.  Messages that need more are logged the normal way.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_SIZE     1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest conversion specification (e.g., "%-08.3lld") supported, including the terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SPEC_BYTES      32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time that the writer thread waits after being woken up before it writes out queued records.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WRITER_DELAY_MS     20
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the length of a null string pointer passed for %s.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NULL_STRING_LEN     UINT16_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round a record size up to keep records 8-byte aligned in the ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALIGN_RECORD_SIZE(size)     (((size) + 7) & ~(size_t)7)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of queued records.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    RECORD_MSG,         ///< A log message.
+    RECORD_PADDING      ///< Unused space at the end of the ring buffer.  Skip to the start.
+}
+RecordType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log record header.  Followed by the null-terminated thread name, then the argument values.
+ *
+ * Padding records only have valid size and type fields.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t size;                  ///< Size of the record, including this header (aligned).
+    uint32_t type;                  ///< Record type (see RecordType_t).
+    le_log_Level_t level;           ///< Severity level (-1 for a trace).
+    unsigned int lineNumber;        ///< Line number.
+    int savedErrno;                 ///< Value of errno when the message was logged (for %m).
+    time_t timestamp;               ///< When the message was logged.
+    const char* levelPtr;           ///< Severity string or trace keyword.
+    const char* compNamePtr;        ///< Component name.
+    const char* filenamePtr;        ///< Source file name.
+    const char* functionNamePtr;    ///< Function name.
+    const char* formatPtr;          ///< Format string.
+}
+Record_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-thread ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;             ///< Link in the RingList.
+    size_t head;                    ///< Total bytes ever added.  Only changed by the owner.
+    bool isOrphaned;                ///< true once the owning thread has terminated.
+    uint8_t buffer[RING_SIZE] __attribute__((aligned(8)));  ///< The records.
+    size_t tail;                    ///< Total bytes ever removed.  Only changed with the
+                                    ///  DrainMutex held.
+}
+Ring_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of argument consumed by a conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ARG_PERCENT,        ///< "%%": no argument.
+    ARG_ERRNO,          ///< "%m": no argument, uses the saved errno.
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_SIZE,
+    ARG_INTMAX,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+    ARG_UNSUPPORTED     ///< Can't be deferred (e.g., %n, wide characters, bad specification).
+}
+ArgType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parsed conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    ArgType_t type;         ///< Type of the (last) argument consumed.
+    size_t len;             ///< Number of characters in the specification, including the '%'.
+    int numStars;           ///< Number of '*' width/precision arguments consumed before it.
+    bool isPrecisionStar;   ///< true if the precision is given by the last '*' argument.
+    int precision;          ///< Precision given in the specification (-1 if none).
+}
+Spec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if binary logging is enabled.  Only set during initialization.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsEnabled = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to find the calling thread's ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t RingKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of every thread's ring buffer.  Protected by the DrainMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t RingList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Held while removing records from ring buffers (and while writing them out, so that records
+ * from one thread are always written in order) and while changing the RingList.
+ *
+ * This is an error-checking mutex so that a thread that logs while it already holds it (e.g.,
+ * from a signal handler after crashing while writing a message) gets an error instead of
+ * deadlocking.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t DrainMutex = PTHREAD_ERRORCHECK_MUTEX_INITIALIZER_NP;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * eventfd used to wake up the writer thread (-1 until the writer thread has been started).
+ */
+//--------------------------------------------------------------------------------------------------
+static int WakeFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if the writer thread has been asked to wake up and hasn't yet started writing.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsWakePending = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseSpec
+(
+    const char* specPtr,    ///< [IN] Points to the '%' that starts the specification.
+    Spec_t* parsedPtr       ///< [OUT] Parsed specification.
+)
+{
+    const char* charPtr = specPtr + 1;
+    enum { LEN_NONE, LEN_L, LEN_LL, LEN_BIG_L, LEN_Z, LEN_J, LEN_T } lenModifier = LEN_NONE;
+
+    parsedPtr->numStars = 0;
+    parsedPtr->isPrecisionStar = false;
+    parsedPtr->precision = -1;
+
+    // Flags.
+    while ((*charPtr != '\0') && (strchr("-+ #0'", *charPtr) != NULL))
+    {
+        charPtr++;
+    }
+
+    // Field width.
+    if (*charPtr == '*')
+    {
+        parsedPtr->numStars++;
+        charPtr++;
+    }
+    while (isdigit((unsigned char)*charPtr))
+    {
+        charPtr++;
+    }
+
+    // Precision.
+    if (*charPtr == '.')
+    {
+        charPtr++;
+
+        if (*charPtr == '*')
+        {
+            parsedPtr->numStars++;
+            parsedPtr->isPrecisionStar = true;
+            charPtr++;
+        }
+        else
+        {
+            parsedPtr->precision = 0;
+
+            while (isdigit((unsigned char)*charPtr))
+            {
+                parsedPtr->precision = (parsedPtr->precision * 10) + (*charPtr - '0');
+                charPtr++;
+            }
+        }
+    }
+
+    // Length modifier.  (hh and h arguments are promoted to int.)
+    switch (*charPtr)
+    {
+        case 'h':
+            charPtr += (charPtr[1] == 'h') ? 2 : 1;
+            break;
+
+        case 'l':
+            if (charPtr[1] == 'l')
+            {
+                lenModifier = LEN_LL;
+                charPtr += 2;
+            }
+            else
+            {
+                lenModifier = LEN_L;
+                charPtr++;
+            }
+            break;
+
+        case 'q':
+            lenModifier = LEN_LL;
+            charPtr++;
+            break;
+
+        case 'L':
+            lenModifier = LEN_BIG_L;
+            charPtr++;
+            break;
+
+        case 'z':
+        case 'Z':
+            lenModifier = LEN_Z;
+            charPtr++;
+            break;
+
+        case 'j':
+            lenModifier = LEN_J;
+            charPtr++;
+            break;
+
+        case 't':
+            lenModifier = LEN_T;
+            charPtr++;
+            break;
+    }
+
+    // Conversion.
+    switch (*charPtr)
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (lenModifier)
+            {
+                case LEN_L:     parsedPtr->type = ARG_LONG;     break;
+                case LEN_LL:
+                case LEN_BIG_L: parsedPtr->type = ARG_LLONG;    break;
+                case LEN_Z:     parsedPtr->type = ARG_SIZE;     break;
+                case LEN_J:     parsedPtr->type = ARG_INTMAX;   break;
+                case LEN_T:     parsedPtr->type = ARG_PTRDIFF;  break;
+                default:        parsedPtr->type = ARG_INT;      break;
+            }
+            break;
+
+        case 'c':
+            parsedPtr->type = (lenModifier == LEN_NONE) ? ARG_INT : ARG_UNSUPPORTED;
+            break;
+
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            parsedPtr->type = (lenModifier == LEN_BIG_L) ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+
+        case 's':
+            parsedPtr->type = (lenModifier == LEN_NONE) ? ARG_STR : ARG_UNSUPPORTED;
+            break;
+
+        case 'p':
+            parsedPtr->type = ARG_PTR;
+            break;
+
+        case 'm':
+            parsedPtr->type = ARG_ERRNO;
+            break;
+
+        case '%':
+            parsedPtr->type = ARG_PERCENT;
+            break;
+
+        default:
+            // Includes %n and the end of the string.
+            parsedPtr->type = ARG_UNSUPPORTED;
+            charPtr--;
+            break;
+    }
+
+    parsedPtr->len = (charPtr + 1) - specPtr;
+
+    if (parsedPtr->len >= MAX_SPEC_BYTES)
+    {
+        parsedPtr->type = ARG_UNSUPPORTED;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the arguments consumed by a format string into a buffer.
+ *
+ * @return
+ *      Number of bytes used, or
+ *      SIZE_MAX if the arguments can't be deferred or don't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t EncodeArgs
+(
+    const char* formatPtr,  ///< [IN] Format string.
+    va_list* argsPtr,       ///< [IN] Arguments.
+    uint8_t* bufPtr,        ///< [OUT] Buffer to store them in.
+    size_t bufSize          ///< [IN] Size of the buffer.
+)
+{
+    size_t used = 0;
+    const char* charPtr = formatPtr;
+
+#define PUT_ARG(type, promotedType) \
+    do { \
+        type value = (type)va_arg(*argsPtr, promotedType); \
+        if (used + sizeof(value) > bufSize) { return SIZE_MAX; } \
+        memcpy(bufPtr + used, &value, sizeof(value)); \
+        used += sizeof(value); \
+    } while (0)
+
+    while ((charPtr = strchr(charPtr, '%')) != NULL)
+    {
+        Spec_t spec;
+        int stars[2] = { 0, 0 };
+        int i;
+
+        ParseSpec(charPtr, &spec);
+        charPtr += spec.len;
+
+        if (spec.type == ARG_UNSUPPORTED)
+        {
+            return SIZE_MAX;
+        }
+
+        for (i = 0; i < spec.numStars; i++)
+        {
+            stars[i] = va_arg(*argsPtr, int);
+
+            if (used + sizeof(int) > bufSize)
+            {
+                return SIZE_MAX;
+            }
+            memcpy(bufPtr + used, &stars[i], sizeof(int));
+            used += sizeof(int);
+        }
+
+        switch (spec.type)
+        {
+            case ARG_INT:       PUT_ARG(int, int);                  break;
+            case ARG_LONG:      PUT_ARG(long, long);                break;
+            case ARG_LLONG:     PUT_ARG(long long, long long);      break;
+            case ARG_SIZE:      PUT_ARG(size_t, size_t);            break;
+            case ARG_INTMAX:    PUT_ARG(intmax_t, intmax_t);        break;
+            case ARG_PTRDIFF:   PUT_ARG(ptrdiff_t, ptrdiff_t);      break;
+            case ARG_DOUBLE:    PUT_ARG(double, double);            break;
+            case ARG_LDOUBLE:   PUT_ARG(long double, long double);  break;
+            case ARG_PTR:       PUT_ARG(void*, void*);              break;
+
+            case ARG_STR:
+            {
+                const char* strPtr = va_arg(*argsPtr, const char*);
+                uint16_t len = NULL_STRING_LEN;
+
+                if (strPtr != NULL)
+                {
+                    // Nothing beyond the maximum message size can ever be printed.
+                    int precision = spec.isPrecisionStar ? stars[spec.numStars - 1]
+                                                         : spec.precision;
+                    size_t maxLen = LOG_MAX_MSG_SIZE - 1;
+
+                    if ((precision >= 0) && ((size_t)precision < maxLen))
+                    {
+                        maxLen = precision;
+                    }
+
+                    len = strnlen(strPtr, maxLen);
+                }
+
+                if (used + sizeof(len) + ((strPtr != NULL) ? len + 1 : 0) > bufSize)
+                {
+                    return SIZE_MAX;
+                }
+
+                memcpy(bufPtr + used, &len, sizeof(len));
+                used += sizeof(len);
+
+                if (strPtr != NULL)
+                {
+                    memcpy(bufPtr + used, strPtr, len);
+                    bufPtr[used + len] = '\0';
+                    used += len + 1;
+                }
+                break;
+            }
+
+            default:
+                // No argument.
+                break;
+        }
+    }
+
+#undef PUT_ARG
+
+    return used;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a message from a format string and the arguments copied by EncodeArgs().
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatMsg
+(
+    const char* formatPtr,  ///< [IN] Format string.
+    const uint8_t* argPtr,  ///< [IN] Arguments.
+    const uint8_t* endPtr,  ///< [IN] End of the arguments buffer.
+    int savedErrno,         ///< [IN] errno value to use for %m.
+    char* msgPtr,           ///< [OUT] Formatted message.
+    size_t msgSize          ///< [IN] Size of the message buffer.
+)
+{
+    const char* charPtr = formatPtr;
+    size_t len = 0;
+
+    msgPtr[0] = '\0';
+
+#define GET_ARG(var) \
+    do { \
+        if (argPtr + sizeof(var) > endPtr) { return; } \
+        memcpy(&(var), argPtr, sizeof(var)); \
+        argPtr += sizeof(var); \
+    } while (0)
+
+#define FORMAT_ARG(type) \
+    do { \
+        type value; \
+        GET_ARG(value); \
+        switch (spec.numStars) \
+        { \
+            case 0:  n = snprintf(outPtr, outSize, specStr, value);                      break; \
+            case 1:  n = snprintf(outPtr, outSize, specStr, stars[0], value);            break; \
+            default: n = snprintf(outPtr, outSize, specStr, stars[0], stars[1], value);  break; \
+        } \
+    } while (0)
+
+    while ((*charPtr != '\0') && (len < msgSize - 1))
+    {
+        // Copy the literal text up to the next conversion.
+        const char* specPtr = strchr(charPtr, '%');
+        size_t literalLen = (specPtr != NULL) ? (size_t)(specPtr - charPtr) : strlen(charPtr);
+
+        if (literalLen > msgSize - 1 - len)
+        {
+            literalLen = msgSize - 1 - len;
+        }
+        memcpy(msgPtr + len, charPtr, literalLen);
+        len += literalLen;
+        msgPtr[len] = '\0';
+
+        if ((specPtr == NULL) || (len >= msgSize - 1))
+        {
+            return;
+        }
+
+        Spec_t spec;
+        char specStr[MAX_SPEC_BYTES];
+        int stars[2] = { 0, 0 };
+        int i;
+        int n = 0;
+        char* outPtr = msgPtr + len;
+        size_t outSize = msgSize - len;
+
+        ParseSpec(specPtr, &spec);
+        charPtr = specPtr + spec.len;
+
+        if (spec.type == ARG_UNSUPPORTED)
+        {
+            // Can't happen, because EncodeArgs() would have refused the message.
+            return;
+        }
+
+        memcpy(specStr, specPtr, spec.len);
+        specStr[spec.len] = '\0';
+
+        for (i = 0; i < spec.numStars; i++)
+        {
+            GET_ARG(stars[i]);
+        }
+
+        switch (spec.type)
+        {
+            case ARG_PERCENT:
+                n = snprintf(outPtr, outSize, "%%");
+                break;
+
+            case ARG_ERRNO:
+            {
+                // Print the error string with the same flags, width and precision.
+                const char* errStrPtr = strerror(savedErrno);
+
+                specStr[spec.len - 1] = 's';
+                switch (spec.numStars)
+                {
+                    case 0:  n = snprintf(outPtr, outSize, specStr, errStrPtr);            break;
+                    case 1:  n = snprintf(outPtr, outSize, specStr, stars[0], errStrPtr);  break;
+                    default: n = snprintf(outPtr, outSize, specStr, stars[0], stars[1],
+                                          errStrPtr);
+                             break;
+                }
+                break;
+            }
+
+            case ARG_INT:       FORMAT_ARG(int);            break;
+            case ARG_LONG:      FORMAT_ARG(long);           break;
+            case ARG_LLONG:     FORMAT_ARG(long long);      break;
+            case ARG_SIZE:      FORMAT_ARG(size_t);         break;
+            case ARG_INTMAX:    FORMAT_ARG(intmax_t);       break;
+            case ARG_PTRDIFF:   FORMAT_ARG(ptrdiff_t);      break;
+            case ARG_DOUBLE:    FORMAT_ARG(double);         break;
+            case ARG_LDOUBLE:   FORMAT_ARG(long double);    break;
+            case ARG_PTR:       FORMAT_ARG(void*);          break;
+
+            case ARG_STR:
+            {
+                uint16_t strLen;
+                const char* value = NULL;
+
+                GET_ARG(strLen);
+                if (strLen != NULL_STRING_LEN)
+                {
+                    if (argPtr + strLen + 1 > endPtr)
+                    {
+                        return;
+                    }
+                    value = (const char*)argPtr;
+                    argPtr += strLen + 1;
+                }
+
+                switch (spec.numStars)
+                {
+                    case 0:  n = snprintf(outPtr, outSize, specStr, value);                   break;
+                    case 1:  n = snprintf(outPtr, outSize, specStr, stars[0], value);         break;
+                    default: n = snprintf(outPtr, outSize, specStr, stars[0], stars[1], value);
+                             break;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (n > 0)
+        {
+            len = ((size_t)n >= outSize) ? (msgSize - 1) : (len + n);
+        }
+    }
+
+#undef FORMAT_ARG
+#undef GET_ARG
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a log record and write it out.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteRecord
+(
+    const Record_t* recPtr
+)
+{
+    const char* threadNamePtr = (const char*)(recPtr + 1);
+    const uint8_t* argsPtr = (const uint8_t*)threadNamePtr + strlen(threadNamePtr) + 1;
+    char msg[LOG_MAX_MSG_SIZE];
+
+    FormatMsg(recPtr->formatPtr,
+              argsPtr,
+              (const uint8_t*)recPtr + recPtr->size,
+              recPtr->savedErrno,
+              msg,
+              sizeof(msg));
+
+    log_WriteMsg(recPtr->level,
+                 recPtr->levelPtr,
+                 recPtr->compNamePtr,
+                 threadNamePtr,
+                 recPtr->filenamePtr,
+                 recPtr->functionNamePtr,
+                 recPtr->lineNumber,
+                 recPtr->timestamp,
+                 msg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out and remove all the records in a ring buffer.
+ *
+ * @note The DrainMutex must be held.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DrainRing
+(
+    Ring_t* ringPtr
+)
+{
+    size_t head = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE);
+    size_t tail = ringPtr->tail;
+
+    while (tail != head)
+    {
+        const Record_t* recPtr = (const Record_t*)(ringPtr->buffer + (tail & (RING_SIZE - 1)));
+
+        if (recPtr->type == RECORD_MSG)
+        {
+            WriteRecord(recPtr);
+        }
+
+        tail += recPtr->size;
+
+        // Free up the space as soon as possible.
+        __atomic_store_n(&ringPtr->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out the records in every ring buffer, and free those owned by terminated threads.
+ *
+ * @note The DrainMutex must be held.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DrainAllRings
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&RingList);
+
+    while (linkPtr != NULL)
+    {
+        Ring_t* ringPtr = CONTAINER_OF(linkPtr, Ring_t, link);
+
+        linkPtr = le_dls_PeekNext(&RingList, linkPtr);
+
+        // Check this before draining, so that we can't miss a record added just before the owner
+        // terminated.
+        bool isOrphaned = __atomic_load_n(&ringPtr->isOrphaned, __ATOMIC_ACQUIRE);
+
+        DrainRing(ringPtr);
+
+        if (isOrphaned)
+        {
+            le_dls_Remove(&RingList, &ringPtr->link);
+            free(ringPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writer thread.  Writes out queued records a short time after being woken up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr
+)
+{
+    for (;;)
+    {
+        struct pollfd pollFd = { .fd = WakeFd, .events = POLLIN };
+        uint64_t count;
+
+        if ((poll(&pollFd, 1, -1) <= 0) || (read(WakeFd, &count, sizeof(count)) < 0))
+        {
+            continue;
+        }
+
+        // Let more records collect.
+        usleep(WRITER_DELAY_MS * 1000);
+
+        // Clear the flag before draining, so that any records added after this point will wake
+        // us up again.  The exchange synchronizes with the one in WakeWriter().
+        (void)__atomic_exchange_n(&IsWakePending, false, __ATOMIC_ACQ_REL);
+
+        if (pthread_mutex_lock(&DrainMutex) == 0)
+        {
+            DrainAllRings();
+            pthread_mutex_unlock(&DrainMutex);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the writer thread, if it isn't running yet.
+ *
+ * @note The DrainMutex must be held.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartWriter
+(
+    void
+)
+{
+    if (WakeFd >= 0)
+    {
+        return;
+    }
+
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (fd < 0)
+    {
+        return;
+    }
+
+    // Create the writer with all signals blocked, so it never handles signals meant for the
+    // Legato threads.
+    sigset_t allSignals;
+    sigset_t oldSignals;
+    pthread_t thread;
+
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignals);
+
+    __atomic_store_n(&WakeFd, fd, __ATOMIC_RELEASE);
+
+    if (pthread_create(&thread, NULL, WriterThread, NULL) == 0)
+    {
+        pthread_detach(thread);
+    }
+    else
+    {
+        __atomic_store_n(&WakeFd, -1, __ATOMIC_RELEASE);
+        close(fd);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldSignals, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wake up the writer thread, if it hasn't already been asked to wake up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WakeWriter
+(
+    void
+)
+{
+    if (!__atomic_exchange_n(&IsWakePending, true, __ATOMIC_ACQ_REL))
+    {
+        int fd = __atomic_load_n(&WakeFd, __ATOMIC_ACQUIRE);
+
+        if ((fd < 0) && (pthread_mutex_lock(&DrainMutex) == 0))
+        {
+            StartWriter();
+            fd = WakeFd;
+            pthread_mutex_unlock(&DrainMutex);
+        }
+
+        if (fd >= 0)
+        {
+            uint64_t count = 1;
+            (void)write(fd, &count, sizeof(count));
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a thread that has a ring buffer terminates.  The writer frees the ring once it has
+ * written out its last records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingDestructor
+(
+    void* ringPtr
+)
+{
+    __atomic_store_n(&((Ring_t*)ringPtr)->isOrphaned, true, __ATOMIC_RELEASE);
+
+    WakeWriter();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the calling thread's ring buffer, creating it if necessary.
+ *
+ * @return The ring buffer, or NULL if it couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static Ring_t* GetRing
+(
+    void
+)
+{
+    Ring_t* ringPtr = pthread_getspecific(RingKey);
+
+    if (ringPtr == NULL)
+    {
+        // NOTE: Can't use a memory pool, because the memory pool module may log.
+        ringPtr = calloc(1, sizeof(Ring_t));
+
+        if (ringPtr != NULL)
+        {
+            ringPtr->link = LE_DLS_LINK_INIT;
+
+            if (pthread_mutex_lock(&DrainMutex) != 0)
+            {
+                free(ringPtr);
+                return NULL;
+            }
+            le_dls_Stack(&RingList, &ringPtr->link);
+            pthread_mutex_unlock(&DrainMutex);
+
+            pthread_setspecific(RingKey, ringPtr);
+        }
+    }
+
+    return ringPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a record to the calling thread's ring buffer.
+ *
+ * @return
+ *      true if the record was added.
+ *      false if there is no room and the thread can't write out its records to make some.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutRecord
+(
+    Ring_t* ringPtr,        ///< [IN] The calling thread's ring buffer.
+    const void* recPtr,     ///< [IN] The record.
+    size_t size             ///< [IN] Size of the record (aligned).
+)
+{
+    size_t head = ringPtr->head;
+    size_t offset = head & (RING_SIZE - 1);
+    size_t paddingSize = (RING_SIZE - offset < size) ? (RING_SIZE - offset) : 0;
+
+    // If there isn't room, write out this thread's records to make some.
+    while (RING_SIZE - (head - __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE))
+           < paddingSize + size)
+    {
+        if (pthread_mutex_lock(&DrainMutex) != 0)
+        {
+            return false;
+        }
+        DrainRing(ringPtr);
+        pthread_mutex_unlock(&DrainMutex);
+    }
+
+    // Records don't wrap around the end of the buffer.
+    if (paddingSize > 0)
+    {
+        Record_t* paddingPtr = (Record_t*)(ringPtr->buffer + offset);
+
+        paddingPtr->size = paddingSize;
+        paddingPtr->type = RECORD_PADDING;
+
+        head += paddingSize;
+        offset = 0;
+    }
+
+    memcpy(ringPtr->buffer + offset, recPtr, size);
+
+    __atomic_store_n(&ringPtr->head, head + size, __ATOMIC_RELEASE);
+
+    WakeWriter();
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out everything that has been queued when the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushAtExit
+(
+    void
+)
+{
+    logBinary_Flush(true);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the parent process just before a fork().  Makes sure that no ring buffer is being
+ * drained as the process is copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrepareFork
+(
+    void
+)
+{
+    pthread_mutex_lock(&DrainMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the parent process just after a fork().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParentAfterFork
+(
+    void
+)
+{
+    pthread_mutex_unlock(&DrainMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the child process just after a fork().  The queued records belong to the parent,
+ * which will write them out, and the writer thread and other threads don't exist in the child.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChildAfterFork
+(
+    void
+)
+{
+    Ring_t* myRingPtr = pthread_getspecific(RingKey);
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&RingList)) != NULL)
+    {
+        Ring_t* ringPtr = CONTAINER_OF(linkPtr, Ring_t, link);
+
+        if (ringPtr != myRingPtr)
+        {
+            free(ringPtr);
+        }
+    }
+
+    if (myRingPtr != NULL)
+    {
+        myRingPtr->tail = myRingPtr->head;
+        le_dls_Stack(&RingList, &myRingPtr->link);
+    }
+
+    if (WakeFd >= 0)
+    {
+        close(WakeFd);
+        WakeFd = -1;
+    }
+    IsWakePending = false;
+
+    // The mutex is owned by the parent's thread ID, so it can't be unlocked here.
+    pthread_mutex_t unlockedMutex = PTHREAD_ERRORCHECK_MUTEX_INITIALIZER_NP;
+    DrainMutex = unlockedMutex;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize binary logging.  Reads the @c LE_LOG_BINARY environment variable.
+ *
+ * Called by log_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void logBinary_Init
+(
+    void
+)
+{
+    const char* envStrPtr = getenv("LE_LOG_BINARY");
+
+    if ((envStrPtr == NULL) || (strcmp(envStrPtr, "1") != 0))
+    {
+        return;
+    }
+
+    if (   (pthread_key_create(&RingKey, RingDestructor) != 0)
+        || (pthread_atfork(PrepareFork, ParentAfterFork, ChildAfterFork) != 0)
+        || (atexit(FlushAtExit) != 0) )
+    {
+        LE_ERROR("Failed to set up binary logging.");
+        return;
+    }
+
+    IsEnabled = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if binary logging is enabled in this process.
+ *
+ * @return true if enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBinary_IsEnabled
+(
+    void
+)
+{
+    return IsEnabled;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a log message in the calling thread's ring buffer, to be formatted later.
+ *
+ * @return
+ *      true if the message was queued.
+ *      false if it can't be deferred, in which case the caller must log it the normal way.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBinary_Queue
+(
+    le_log_Level_t level,           ///< [IN] Severity level (-1 for a trace).
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.  Must stay valid.
+    const char* compNamePtr,        ///< [IN] Component name.  Must stay valid.
+    const char* filenamePtr,        ///< [IN] Source file name.  Must stay valid.
+    const char* functionNamePtr,    ///< [IN] Function name.  Must stay valid.
+    unsigned int lineNumber,        ///< [IN] Line number.
+    int savedErrno,                 ///< [IN] Value of errno to use for %m.
+    const char* formatPtr,          ///< [IN] Format string.  Must stay valid.
+    va_list args                    ///< [IN] Arguments.
+)
+{
+    uint8_t buffer[MAX_RECORD_SIZE] __attribute__((aligned(8)));
+    Record_t* recPtr = (Record_t*)buffer;
+    size_t used = sizeof(Record_t);
+
+    Ring_t* ringPtr = GetRing();
+
+    if (ringPtr == NULL)
+    {
+        return false;
+    }
+
+    recPtr->type = RECORD_MSG;
+    recPtr->level = level;
+    recPtr->lineNumber = lineNumber;
+    recPtr->savedErrno = savedErrno;
+    recPtr->timestamp = time(NULL);
+    recPtr->levelPtr = levelPtr;
+    recPtr->compNamePtr = compNamePtr;
+    recPtr->filenamePtr = filenamePtr;
+    recPtr->functionNamePtr = functionNamePtr;
+    recPtr->formatPtr = formatPtr;
+
+    // Copy the thread name, because the thread may be gone by the time the record is written.
+    const char* threadNamePtr = le_thread_GetMyName();
+    size_t nameLen = strnlen(threadNamePtr, LIMIT_MAX_THREAD_NAME_LEN);
+
+    memcpy(buffer + used, threadNamePtr, nameLen);
+    buffer[used + nameLen] = '\0';
+    used += nameLen + 1;
+
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    size_t argsSize = EncodeArgs(formatPtr, &argsCopy, buffer + used, sizeof(buffer) - used);
+    va_end(argsCopy);
+
+    if (argsSize == SIZE_MAX)
+    {
+        return false;
+    }
+
+    used = ALIGN_RECORD_SIZE(used + argsSize);
+    recPtr->size = used;
+
+    return PutRecord(ringPtr, buffer, used);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format and write out queued log messages now.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBinary_Flush
+(
+    bool allThreads     ///< [IN] true = every thread's messages, false = only the calling thread's.
+)
+{
+    if (!IsEnabled)
+    {
+        return;
+    }
+
+    if (pthread_mutex_lock(&DrainMutex) != 0)
+    {
+        return;
+    }
+
+    if (allThreads)
+    {
+        DrainAllRings();
+    }
+    else
+    {
+        Ring_t* ringPtr = pthread_getspecific(RingKey);
+
+        if (ringPtr != NULL)
+        {
+            DrainRing(ringPtr);
+        }
+    }
+
+    pthread_mutex_unlock(&DrainMutex);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file logBinary.h
+ *
+ * Binary (deferred-format) logging.  This is an internal part of the log module (log.c).
+ *
+ * When the @c LE_LOG_BINARY environment variable is set to 1, debug, info and trace messages are
+ * not formatted by the thread that logs them.  Instead, the thread copies the format string
+ * pointer and the raw argument values into its own ring buffer, which it never needs to lock,
+ * and a writer thread in the same process formats and writes the messages out later (at most
+ * a few tens of milliseconds later).
+ *
+ * Warnings and more severe messages are still formatted and written straight away, after
+ * everything that the same thread queued before them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_LOG_BINARY_INCLUDE_GUARD
+#define LEGATO_SRC_LOG_BINARY_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize binary logging.  Reads the @c LE_LOG_BINARY environment variable.
+ *
+ * Called by log_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void logBinary_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if binary logging is enabled in this process.
+ *
+ * @return true if enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBinary_IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a log message in the calling thread's ring buffer, to be formatted later.
+ *
+ * @return
+ *      true if the message was queued.
+ *      false if it can't be deferred (e.g., because its format string uses %n), in which case
+ *      the caller must log it the normal way.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBinary_Queue
+(
+    le_log_Level_t level,           ///< [IN] Severity level (-1 for a trace).
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.  Must stay valid.
+    const char* compNamePtr,        ///< [IN] Component name.  Must stay valid.
+    const char* filenamePtr,        ///< [IN] Source file name.  Must stay valid.
+    const char* functionNamePtr,    ///< [IN] Function name.  Must stay valid.
+    unsigned int lineNumber,        ///< [IN] Line number.
+    int savedErrno,                 ///< [IN] Value of errno to use for %m.
+    const char* formatPtr,          ///< [IN] Format string.  Must stay valid.
+    va_list args                    ///< [IN] Arguments.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format and write out queued log messages now.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBinary_Flush
+(
+    bool allThreads     ///< [IN] true = every thread's messages, false = only the calling thread's.
+);
+
+
+#endif // LEGATO_SRC_LOG_BINARY_INCLUDE_GUARD
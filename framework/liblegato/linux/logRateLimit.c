@@ -0,0 +1,384 @@
+/** @file logRateLimit.c
+ *
+ * Per-call-site log rate limiting.  See logRateLimit.h for an overview.
+ *
+ * The state of each call site that logs under a rate limit is kept in a small, fixed-size, open
+ * addressing hash table keyed by the address of the file name string and the line number.  The
+ * rate limit is applied using the Generic Cell Rate Algorithm (a token bucket that only needs to
+ * keep one time stamp): each message that gets through moves the call site's "next" time forward
+ * by SECONDS / COUNT, and a message is dropped if that would move it more than SECONDS ahead of
+ * the current time.
+ *
+ * If the table is full of call sites that are still busy, the messages of any other call site
+ * are let through unlimited, so no message is ever dropped for lack of room.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+#include "logRateLimit.h"
+#include "logBinary.h"
+#include "limit.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of call sites that can be tracked at the same time.  Must be a power of two.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CALL_SITES          128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of neighbouring table entries that are looked at to find a call site.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PROBES              8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time between looks for call sites that have gone quiet, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLUSH_INTERVAL_NS       1000000000ULL
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Nanoseconds per second.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NS_PER_SEC              1000000000ULL
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a call site.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char*     filenamePtr;        ///< Source file name, or NULL if the entry is free.
+    unsigned int    lineNumber;         ///< Line number.
+    le_log_Level_t  level;              ///< Severity level (-1 for a trace).
+    const char*     levelPtr;           ///< Severity string or trace keyword.
+    const char*     compNamePtr;        ///< Component name.
+    const char*     functionNamePtr;    ///< Function name.
+    uint64_t        nextNs;             ///< Time at which the bucket will be full again.
+    uint64_t        lastDropNs;         ///< Time at which the last message was dropped.
+    uint64_t        quietNs;            ///< How long to be quiet for before the drops are reported.
+    uint32_t        dropCount;          ///< Number of messages dropped since the last report.
+    char threadName[LIMIT_MAX_THREAD_NAME_BYTES];   ///< Thread that logged the first dropped one.
+}
+CallSite_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Table of call sites.
+ */
+//--------------------------------------------------------------------------------------------------
+static CallSite_t CallSites[MAX_CALL_SITES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of call sites that have dropped messages that haven't been reported yet.  Only changed
+ * with the Mutex held, but read without it.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PendingCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time before which logRateLimit_Flush() doesn't look for call sites that have gone quiet.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NextFlushNs;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex used to protect the call site table.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time from the monotonic clock.
+ *
+ * @return Time in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetNowNs
+(
+    void
+)
+{
+    struct timespec now;
+
+    LE_ASSERT(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+
+    return (uint64_t)now.tv_sec * NS_PER_SEC + now.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a call site in the table, adding it if it isn't there.  A free entry, or one whose call
+ * site has nothing to report and would let its next message through anyway, is used for it.
+ *
+ * @return Pointer to the call site, or NULL if there was no room for it.
+ *
+ * @warning Assumes that the Mutex is held by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static CallSite_t* GetCallSite
+(
+    const char* filenamePtr,
+    unsigned int lineNumber,
+    uint64_t nowNs
+)
+{
+    size_t hash = (((uintptr_t)filenamePtr >> 3) ^ (lineNumber * 2654435761U));
+    CallSite_t* freePtr = NULL;
+    size_t i;
+
+    for (i = 0; i < MAX_PROBES; i++)
+    {
+        CallSite_t* sitePtr = &CallSites[(hash + i) & (MAX_CALL_SITES - 1)];
+
+        if ((sitePtr->filenamePtr == filenamePtr) && (sitePtr->lineNumber == lineNumber))
+        {
+            return sitePtr;
+        }
+
+        if (   (freePtr == NULL)
+            && (   (sitePtr->filenamePtr == NULL)
+                || ((sitePtr->dropCount == 0) && (sitePtr->nextNs <= nowNs)) ) )
+        {
+            freePtr = sitePtr;
+        }
+    }
+
+    if (freePtr != NULL)
+    {
+        memset(freePtr, 0, sizeof(*freePtr));
+        freePtr->filenamePtr = filenamePtr;
+        freePtr->lineNumber = lineNumber;
+        freePtr->nextNs = nowNs;
+    }
+
+    return freePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out the "last message repeated N times" message for a call site.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteReport
+(
+    const CallSite_t* sitePtr   ///< [IN] Copy of the call site's state before it was reset.
+)
+{
+    char msg[64];
+
+    snprintf(msg, sizeof(msg), "last message repeated %" PRIu32 " times", sitePtr->dropCount);
+
+    // Messages still queued by binary logging were logged before the ones that were dropped.
+    if (logBinary_IsEnabled())
+    {
+        logBinary_Flush(true);
+    }
+
+    log_WriteMsg(sitePtr->level, sitePtr->levelPtr, sitePtr->compNamePtr, sitePtr->threadName,
+                 sitePtr->filenamePtr, sitePtr->functionNamePtr, sitePtr->lineNumber, time(NULL),
+                 msg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a copy of a call site's dropped messages report and reset its drop count.
+ *
+ * @warning Assumes that the Mutex is held by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TakeReport
+(
+    CallSite_t* sitePtr,        ///< [IN] Call site that has dropped messages.
+    CallSite_t* reportPtr       ///< [OUT] Copy of its state.
+)
+{
+    *reportPtr = *sitePtr;
+    sitePtr->dropCount = 0;
+
+    __atomic_sub_fetch(&PendingCount, 1, __ATOMIC_RELAXED);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report everything that is still pending when the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushAtExit
+(
+    void
+)
+{
+    logRateLimit_Flush(true);
+}
+
+
+void logRateLimit_Init
+(
+    void
+)
+{
+    LE_ASSERT(atexit(FlushAtExit) == 0);
+}
+
+
+bool logRateLimit_Check
+(
+    const log_RateLimit_t* rateLimitPtr,
+    le_log_Level_t level,
+    const char* levelPtr,
+    const char* compNamePtr,
+    const char* filenamePtr,
+    const char* functionNamePtr,
+    unsigned int lineNumber
+)
+{
+    // The limit is read without the log module's lock held, so take a copy before checking it.
+    log_RateLimit_t rateLimit = *rateLimitPtr;
+
+    if ((rateLimit.count == 0) || (rateLimit.period == 0))
+    {
+        return true;
+    }
+
+    uint64_t nowNs = GetNowNs();
+    uint64_t periodNs = rateLimit.period * NS_PER_SEC;
+    uint64_t intervalNs = periodNs / rateLimit.count;
+    bool isAllowed = true;
+    bool hasReport = false;
+    CallSite_t report;
+
+    LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+
+    CallSite_t* sitePtr = GetCallSite(filenamePtr, lineNumber, nowNs);
+
+    if (sitePtr != NULL)
+    {
+        if (sitePtr->nextNs < nowNs)
+        {
+            sitePtr->nextNs = nowNs;
+        }
+
+        if (sitePtr->nextNs - nowNs > periodNs - intervalNs)
+        {
+            isAllowed = false;
+
+            if (sitePtr->dropCount == 0)
+            {
+                sitePtr->level = level;
+                sitePtr->levelPtr = levelPtr;
+                sitePtr->compNamePtr = compNamePtr;
+                sitePtr->functionNamePtr = functionNamePtr;
+                le_utf8_Copy(sitePtr->threadName,
+                             le_thread_GetMyName(),
+                             sizeof(sitePtr->threadName),
+                             NULL);
+
+                __atomic_add_fetch(&PendingCount, 1, __ATOMIC_RELAXED);
+            }
+
+            sitePtr->dropCount++;
+            sitePtr->lastDropNs = nowNs;
+            sitePtr->quietNs = periodNs;
+        }
+        else
+        {
+            sitePtr->nextNs += intervalNs;
+
+            if (sitePtr->dropCount != 0)
+            {
+                TakeReport(sitePtr, &report);
+                hasReport = true;
+            }
+        }
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+
+    if (hasReport)
+    {
+        WriteReport(&report);
+    }
+
+    return isAllowed;
+}
+
+
+void logRateLimit_Flush
+(
+    bool force
+)
+{
+    if (__atomic_load_n(&PendingCount, __ATOMIC_RELAXED) == 0)
+    {
+        return;
+    }
+
+    uint64_t nowNs = GetNowNs();
+
+    if ((!force) && (nowNs < __atomic_load_n(&NextFlushNs, __ATOMIC_RELAXED)))
+    {
+        return;
+    }
+
+    size_t i = 0;
+
+    for (;;)
+    {
+        bool hasReport = false;
+        CallSite_t report;
+
+        LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+
+        __atomic_store_n(&NextFlushNs, nowNs + FLUSH_INTERVAL_NS, __ATOMIC_RELAXED);
+
+        for (; i < MAX_CALL_SITES; i++)
+        {
+            CallSite_t* sitePtr = &CallSites[i];
+
+            if (   (sitePtr->dropCount != 0)
+                && (force || (nowNs - sitePtr->lastDropNs >= sitePtr->quietNs)) )
+            {
+                TakeReport(sitePtr, &report);
+                hasReport = true;
+                break;
+            }
+        }
+
+        LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+
+        // The report is written without the Mutex held, as it may log more messages.
+        if (!hasReport)
+        {
+            break;
+        }
+
+        WriteReport(&report);
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file logRateLimit.h
+ *
+ * Per-call-site log rate limiting.  This is an internal part of the log module (log.c).
+ *
+ * A component can be given a rate limit of the form "COUNT/SECONDS" (through the @c
+ * LE_LOG_RATE_LIMIT environment variable or the "log ratelimit" command).  Each place in the
+ * component's code that logs (each call site, identified by its file and line number) is then
+ * allowed a burst of up to COUNT messages, and after that COUNT messages every SECONDS seconds.
+ * Anything more is dropped, and once the call site has been quiet for SECONDS seconds (or as soon
+ * as it is allowed to log again) a "last message repeated N times" message is logged in place of
+ * the dropped messages.  Critical and emergency messages are never dropped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_LOG_RATE_LIMIT_INCLUDE_GUARD
+#define LEGATO_SRC_LOG_RATE_LIMIT_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the log rate limiting module.
+ *
+ * Called by log_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void logRateLimit_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a call site is allowed to log another message under a given rate limit.
+ *
+ * If the call site had messages dropped and is now allowed to log again, the "last message
+ * repeated N times" message is written out before this returns.
+ *
+ * @return
+ *      true if the message should be logged.
+ *      false if it should be dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logRateLimit_Check
+(
+    const log_RateLimit_t* rateLimitPtr,    ///< [IN] The component's rate limit.
+    le_log_Level_t level,           ///< [IN] Severity level (-1 for a trace).
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.  Must stay valid.
+    const char* compNamePtr,        ///< [IN] Component name.  Must stay valid.
+    const char* filenamePtr,        ///< [IN] Source file name.  Must stay valid.
+    const char* functionNamePtr,    ///< [IN] Function name.  Must stay valid.
+    unsigned int lineNumber         ///< [IN] Line number.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write out the "last message repeated N times" messages of the call sites that have gone quiet.
+ *
+ * This is cheap to call often; it only looks at the call sites about once a second.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRateLimit_Flush
+(
+    bool force      ///< [IN] true = write out every pending message now, even if its call site
+                    ///        hasn't gone quiet yet (e.g., because the process is exiting).
+);
+
+
+#endif // LEGATO_SRC_LOG_RATE_LIMIT_INCLUDE_GUARD
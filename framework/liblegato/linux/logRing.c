@@ -0,0 +1,466 @@
+/** @file logRing.c
+ *
+ * Shared-memory log rings.  See logRing.h for an overview.
+ *
+ * The shared memory starts with a header, followed by the message data.  Positions in the ring
+ * are counted in bytes written since the ring was created, and never wrap; the offset in the data
+ * area is the position modulo the size of the data area.
+ *
+ * The writer publishes two positions:
+ *  - @c reserve, the position that the data will have been written up to once the message that is
+ *    being written is complete.  This is updated before the message bytes are copied in.
+ *  - @c head, the position up to which complete messages have been written.  This is updated
+ *    after the message bytes are copied in.
+ *
+ * A reader copies out everything from its position up to @c head, then checks @c reserve to find
+ * out how much of what it copied may have been overwritten while it was copying, and throws that
+ * part away.  This is the same technique as a sequence lock, so the writer never waits for the
+ * reader, and a reader in another process can't corrupt the ring or make the writer block.
+ *
+ * Nothing that is read out of the shared memory is trusted by the reader, since the writer could
+ * be misbehaving.  The reader uses its own copy of the ring size, and only ever uses positions
+ * read from the shared memory modulo that size.  The memfd is sealed so that the writer can't
+ * shrink it either (which would make the reader crash with a bus error).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+#include "logRing.h"
+#include "fileDescriptor.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/// Workaround to memfd and file sealing definitions not being provided by older versions of
+/// the glibc.  Values are extracted from <linux/memfd.h> and <linux/fcntl.h>.
+#ifndef MFD_CLOEXEC
+# define MFD_CLOEXEC            0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+# define MFD_ALLOW_SEALING      0x0002U
+#endif
+#ifndef F_ADD_SEALS
+# define F_ADD_SEALS            (1024 + 9)
+# define F_SEAL_SEAL            0x0001
+# define F_SEAL_SHRINK          0x0002
+# define F_SEAL_GROW            0x0004
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the magic number at the start of every log ring ("LeLR").
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_MAGIC          0x524C654CU
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Space reserved for the header at the start of the shared memory.  The data area starts right
+ * after it.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_SPACE        64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of the shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< RING_MAGIC.
+    uint32_t size;          ///< Size of the data area, in bytes (a power of two).
+    int32_t  pid;           ///< PID of the process that the ring was created for.
+    uint32_t reserved;      ///< Not used.
+    uint64_t reserve;       ///< Position that the message being written will end at.
+    uint64_t head;          ///< Position that complete messages have been written up to.
+}
+Header_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log ring objects.  Each process that has a ring mapped has its own one of these.
+ */
+//--------------------------------------------------------------------------------------------------
+struct logRing_Ring
+{
+    Header_t*       hdrPtr;     ///< Start of the shared memory.
+    char*           dataPtr;    ///< Start of the data area.
+    size_t          size;       ///< Size of the data area.
+    uint64_t        writePos;   ///< Position to write the next message at (writer only).
+    char*           readBufPtr; ///< Buffer the reader copies messages out into (reader only).
+    pthread_mutex_t mutex;      ///< Serializes writes from different threads (writer only).
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which log ring objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RingPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a ring object for a mapping of the shared memory.
+ *
+ * @return Reference to the ring object.
+ */
+//--------------------------------------------------------------------------------------------------
+static logRing_Ref_t CreateRingObj
+(
+    Header_t* hdrPtr,       ///< [IN] Start of the shared memory.
+    size_t size             ///< [IN] Size of the data area.
+)
+{
+    logRing_Ref_t ringRef = le_mem_ForceAlloc(RingPool);
+
+    ringRef->hdrPtr = hdrPtr;
+    ringRef->dataPtr = (char*)hdrPtr + HEADER_SPACE;
+    ringRef->size = size;
+    ringRef->writePos = 0;
+    ringRef->readBufPtr = NULL;
+    pthread_mutex_init(&ringRef->mutex, NULL);
+
+    return ringRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy bytes into the data area, wrapping around the end if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyIn
+(
+    logRing_Ref_t ringRef,  ///< [IN] Ring to copy into.
+    uint64_t pos,           ///< [IN] Position to copy to.
+    const void* srcPtr,     ///< [IN] Bytes to copy.
+    size_t len              ///< [IN] Number of bytes to copy.  Not more than the ring size.
+)
+{
+    size_t offset = pos & (ringRef->size - 1);
+    size_t firstLen = ringRef->size - offset;
+
+    if (firstLen >= len)
+    {
+        memcpy(ringRef->dataPtr + offset, srcPtr, len);
+    }
+    else
+    {
+        memcpy(ringRef->dataPtr + offset, srcPtr, firstLen);
+        memcpy(ringRef->dataPtr, (const char*)srcPtr + firstLen, len - firstLen);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy bytes out of the data area, wrapping around the end if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyOut
+(
+    logRing_Ref_t ringRef,  ///< [IN] Ring to copy out of.
+    uint64_t pos,           ///< [IN] Position to copy from.
+    void* destPtr,          ///< [OUT] Where to copy the bytes to.
+    size_t len              ///< [IN] Number of bytes to copy.  Not more than the ring size.
+)
+{
+    size_t offset = pos & (ringRef->size - 1);
+    size_t firstLen = ringRef->size - offset;
+
+    if (firstLen >= len)
+    {
+        memcpy(destPtr, ringRef->dataPtr + offset, len);
+    }
+    else
+    {
+        memcpy(destPtr, ringRef->dataPtr + offset, firstLen);
+        memcpy((char*)destPtr + firstLen, ringRef->dataPtr, len - firstLen);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the log ring module.
+ *
+ * Called by log_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Init
+(
+    void
+)
+{
+    RingPool = le_mem_CreatePool("LogRing", sizeof(struct logRing_Ring));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new, empty log ring, for reading.
+ *
+ * @return
+ *      Reference to the ring, or NULL if it could not be created (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+logRing_Ref_t logRing_Create
+(
+    size_t size,        ///< [IN] Number of bytes of messages to keep.  Must be a power of two.
+    pid_t pid,          ///< [IN] PID of the process that will write into the ring.
+    int* fdPtr          ///< [OUT] File descriptor to send to the writer.  Owned by the caller.
+)
+{
+    LE_ASSERT((size > LOG_MAX_LINE_SIZE) && ((size & (size - 1)) == 0));
+
+#ifdef __NR_memfd_create
+    int fd = syscall(__NR_memfd_create, "le_logRing", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    int fd = -1;
+    errno = ENOSYS;
+#endif
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create log ring (%m).");
+        return NULL;
+    }
+
+    // Don't let the writer resize the ring once it has it.
+    if (   (ftruncate(fd, HEADER_SPACE + size) != 0)
+        || (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) )
+    {
+        LE_ERROR("Failed to set up log ring of %zu bytes (%m).", size);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    Header_t* hdrPtr = mmap(NULL, HEADER_SPACE + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdrPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map log ring of %zu bytes (%m).", size);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    // The memfd starts out zeroed, so only the identification needs to be filled in.
+    hdrPtr->size = size;
+    hdrPtr->pid = pid;
+    __atomic_store_n(&hdrPtr->magic, RING_MAGIC, __ATOMIC_RELEASE);
+
+    logRing_Ref_t ringRef = CreateRingObj(hdrPtr, size);
+
+    ringRef->readBufPtr = malloc(size);
+    LE_ASSERT(ringRef->readBufPtr != NULL);
+
+    *fdPtr = fd;
+
+    return ringRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a log ring received from the Log Control Daemon, for writing.  The file descriptor is
+ * closed.
+ *
+ * @return
+ *      Reference to the ring, or NULL if the fd is not a valid log ring (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+logRing_Ref_t logRing_Map
+(
+    int fd              ///< [IN] File descriptor received from logRing_Create()'s caller.
+)
+{
+    struct stat fdStat;
+
+    if ((fstat(fd, &fdStat) != 0) || (fdStat.st_size <= HEADER_SPACE))
+    {
+        LE_ERROR("Invalid log ring fd.");
+        fd_Close(fd);
+        return NULL;
+    }
+
+    Header_t* hdrPtr = mmap(NULL, fdStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // The mapping holds on to the ring, so the fd isn't needed anymore.
+    fd_Close(fd);
+
+    if (hdrPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map log ring of %zu bytes (%m).", (size_t)fdStat.st_size);
+        return NULL;
+    }
+
+    size_t size = hdrPtr->size;
+
+    if (   (__atomic_load_n(&hdrPtr->magic, __ATOMIC_ACQUIRE) != RING_MAGIC)
+        || (size + HEADER_SPACE != fdStat.st_size)
+        || ((size & (size - 1)) != 0) )
+    {
+        LE_ERROR("Received an invalid log ring.");
+        munmap(hdrPtr, fdStat.st_size);
+        return NULL;
+    }
+
+    logRing_Ref_t ringRef = CreateRingObj(hdrPtr, size);
+
+    // Carry on from where the last writer stopped, in case the ring has been used before.
+    ringRef->writePos = __atomic_load_n(&hdrPtr->head, __ATOMIC_RELAXED);
+
+    return ringRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a log ring and free its reference.  The ring is destroyed once nobody has it mapped.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Delete
+(
+    logRing_Ref_t ringRef   ///< [IN] Ring to delete.
+)
+{
+    munmap(ringRef->hdrPtr, HEADER_SPACE + ringRef->size);
+    free(ringRef->readBufPtr);
+    pthread_mutex_destroy(&ringRef->mutex);
+    le_mem_Release(ringRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a message to a log ring, overwriting the oldest messages if there isn't enough room.
+ *
+ * Messages longer than LOG_MAX_LINE_SIZE bytes are truncated.  Safe to call from several threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Write
+(
+    logRing_Ref_t ringRef,  ///< [IN] Ring to write to.
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr      ///< [IN] Formatted message.
+)
+{
+    // Store the level as an ASCII digit (traces are '0') so that it is never a null character.
+    char levelChar = '1' + level;
+    size_t len = strnlen(msgPtr, LOG_MAX_LINE_SIZE - 1);
+    size_t recordLen = len + 2;
+
+    LE_ASSERT(pthread_mutex_lock(&ringRef->mutex) == 0);
+
+    uint64_t pos = ringRef->writePos;
+    Header_t* hdrPtr = ringRef->hdrPtr;
+
+    // Let readers know which bytes are about to be overwritten before overwriting them.
+    __atomic_store_n(&hdrPtr->reserve, pos + recordLen, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    CopyIn(ringRef, pos, &levelChar, 1);
+    CopyIn(ringRef, pos + 1, msgPtr, len);
+    CopyIn(ringRef, pos + 1 + len, "", 1);
+
+    ringRef->writePos = pos + recordLen;
+    __atomic_store_n(&hdrPtr->head, pos + recordLen, __ATOMIC_RELEASE);
+
+    LE_ASSERT(pthread_mutex_unlock(&ringRef->mutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the messages that were written to a log ring since the last read.
+ *
+ * Messages that were overwritten before they could be read are skipped.
+ *
+ * @return
+ *      The number of bytes of messages that were skipped.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t logRing_Read
+(
+    logRing_Ref_t ringRef,          ///< [IN] Ring to read from.
+    uint64_t* posPtr,               ///< [IN/OUT] Position to read from (0 = oldest message).
+                                    ///           Updated to the position to read from next time.
+    logRing_MsgHandler_t handler,   ///< [IN] Function to call for each message.
+    void* contextPtr                ///< [IN] Context pointer to pass to the handler.
+)
+{
+    Header_t* hdrPtr = ringRef->hdrPtr;
+    char* bufPtr = ringRef->readBufPtr;
+    uint64_t pos = *posPtr;
+    uint64_t head = __atomic_load_n(&hdrPtr->head, __ATOMIC_ACQUIRE);
+    size_t lost = 0;
+
+    // The head can only go backwards if the writer is misbehaving.  Start again from there.
+    if (head < pos)
+    {
+        pos = head;
+    }
+
+    // Skip anything that has already been overwritten.
+    if (head - pos > ringRef->size)
+    {
+        lost = head - ringRef->size - pos;
+        pos = head - ringRef->size;
+    }
+
+    size_t len = head - pos;
+    CopyOut(ringRef, pos, bufPtr, len);
+
+    // Throw away anything that the writer may have overwritten while it was being copied.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t reserve = __atomic_load_n(&hdrPtr->reserve, __ATOMIC_RELAXED);
+    size_t start = 0;
+
+    if (reserve > pos + ringRef->size)
+    {
+        start = (reserve - ringRef->size - pos < len) ? (reserve - ringRef->size - pos) : len;
+        lost += start;
+    }
+
+    // If anything was lost, this is probably in the middle of a message; skip to the next one.
+    if (lost > 0)
+    {
+        char* nulPtr = memchr(bufPtr + start, '\0', len - start);
+        size_t skip = (nulPtr == NULL) ? (len - start) : (nulPtr + 1 - (bufPtr + start));
+
+        start += skip;
+        lost += skip;
+    }
+
+    while (start < len)
+    {
+        char* nulPtr = memchr(bufPtr + start + 1, '\0', len - start - 1);
+        if (nulPtr == NULL)
+        {
+            // Only a misbehaving writer can leave a message unterminated.
+            lost += len - start;
+            break;
+        }
+
+        int level = bufPtr[start] - '1';
+        if ((level < -1) || (level > LE_LOG_EMERG))
+        {
+            // Again, only a misbehaving writer can do this.
+            level = LE_LOG_INFO;
+        }
+
+        handler((le_log_Level_t)level, bufPtr + start + 1, contextPtr);
+
+        start = nulPtr + 1 - bufPtr;
+    }
+
+    *posPtr = head;
+
+    return lost;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file logRing.h
+ *
+ * Shared-memory log rings.  This is an internal part of the log module (log.c), also used by the
+ * Log Control Daemon and the Supervisor.
+ *
+ * A log ring is a fixed-size circular buffer of fully formatted log messages, kept in a sealed
+ * memfd that is created by the Log Control Daemon and shared with one client process.  The client
+ * appends messages to it without making any system calls, overwriting the oldest messages when it
+ * is full.  The Log Control Daemon is the only reader.  It writes the messages out to the system
+ * log, and because it keeps the ring mapped after the client dies, the client's last messages are
+ * still available after a crash.
+ *
+ * Each message is stored as one byte holding the severity level, followed by the message text and
+ * a null terminator.  The level byte is never zero, so a reader that lost its place because the
+ * writer overwrote what it was about to read can find the start of the next message by skipping
+ * past the next null character.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_LOG_RING_INCLUDE_GUARD
+#define LEGATO_SRC_LOG_RING_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a log ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct logRing_Ring* logRing_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the functions that are called for each message read out of a log ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logRing_MsgHandler_t)
+(
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr,     ///< [IN] Formatted message.
+    void* contextPtr        ///< [IN] Context pointer passed to logRing_Read().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the log ring module.
+ *
+ * Called by log_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new, empty log ring, for reading.
+ *
+ * @return
+ *      Reference to the ring, or NULL if it could not be created (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+logRing_Ref_t logRing_Create
+(
+    size_t size,        ///< [IN] Number of bytes of messages to keep.  Must be a power of two.
+    pid_t pid,          ///< [IN] PID of the process that will write into the ring.
+    int* fdPtr          ///< [OUT] File descriptor to send to the writer.  Owned by the caller.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a log ring received from the Log Control Daemon, for writing.  The file descriptor is
+ * closed.
+ *
+ * @return
+ *      Reference to the ring, or NULL if the fd is not a valid log ring (check the logs).
+ */
+//--------------------------------------------------------------------------------------------------
+logRing_Ref_t logRing_Map
+(
+    int fd              ///< [IN] File descriptor received from logRing_Create()'s caller.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a log ring and free its reference.  The ring is destroyed once nobody has it mapped.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Delete
+(
+    logRing_Ref_t ringRef   ///< [IN] Ring to delete.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a message to a log ring, overwriting the oldest messages if there isn't enough room.
+ *
+ * Messages longer than LOG_MAX_LINE_SIZE bytes are truncated.  Safe to call from several threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Write
+(
+    logRing_Ref_t ringRef,  ///< [IN] Ring to write to.
+    le_log_Level_t level,   ///< [IN] Severity level (-1 for a trace).
+    const char* msgPtr      ///< [IN] Formatted message.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the messages that were written to a log ring since the last read.
+ *
+ * Messages that were overwritten before they could be read are skipped.
+ *
+ * @return
+ *      The number of bytes of messages that were skipped.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t logRing_Read
+(
+    logRing_Ref_t ringRef,          ///< [IN] Ring to read from.
+    uint64_t* posPtr,               ///< [IN/OUT] Position to read from (0 = oldest message).
+                                    ///           Updated to the position to read from next time.
+    logRing_MsgHandler_t handler,   ///< [IN] Function to call for each message.
+    void* contextPtr                ///< [IN] Context pointer to pass to the handler.
+);
+
+
+#endif // LEGATO_SRC_LOG_RING_INCLUDE_GUARD
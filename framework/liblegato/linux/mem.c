@@ -30,29 +30,106 @@
  * delete a sub-pool while there are still blocks allocated from it.  The sub-pool itself is then
  * removed from the list of pools and released back into the pool of sub-pools.
  *
+ * THREAD CACHES
+ * =============
+ *
+ * A pool can optionally be given a per-thread cache of free blocks using
+ * le_mem_SetThreadCacheSize().  Each thread that allocates from or releases to such a pool gets
+ * its own small stack of free blocks (stored in thread-local storage).  Allocations are satisfied
+ * from the calling thread's cache without taking the module's mutex, and releases are pushed
+ * onto it.  Only when a cache runs empty (or full) is the mutex taken, and then half a cache's
+ * worth of blocks is moved between the cache and the pool's free list in one go.  When a thread
+ * exits, the blocks in its caches are returned to their pools' free lists.
+ *
+ * Because the statistics and reference counts can be updated without holding the mutex, they
+ * are always manipulated using atomic operations.  Blocks sitting in a thread cache are counted
+ * as free.
+ *
+ * RESERVED REGIONS
+ * ================
+ *
+ * A pool that has a region reserved using le_mem_ReserveRegion() gets an anonymous mapping of its
+ * own, and AddBlocks() carves new blocks out of it, one after the other, until it's full.  The
+ * blocks are stacked on the free list in reverse order, so that they are allocated in address
+ * order.  The region is never unmapped, as pools are never deleted.
+ *
+ * SIZE CLASSES
+ * ============
+ *
+ * A size-class allocator is an array of sub-pools, one per size class, each taking its blocks from
+ * a super-pool that holds the objects of that size class for the whole process.  The size
+ * classes are the powers of two (starting at SIZE_CLASS_MIN_BYTES) and the sizes half way between
+ * them, so the size class of an object can be found from the position of the two most significant
+ * bits of its size, in constant time.  The super-pools and sub-pools are created the first time
+ * their size class is used.
+ *
  * GUARD BANDS
  * ===========
  *
- * A debugging feature can be enabled at compile-time by defining the macro "USE_GUARD_BAND".
+ * A debugging feature can be enabled at compile-time by defining the macro "LE_MEM_GUARD_BANDS"
+ * (see le_build_config.h), which defines "USE_GUARD_BAND".
  * This inserts chunks of memory into each memory block both before and after the user object
  * part.  These chunks of memory, called "guard bands", are filled with a special pattern that
  * is unlikely to occur in normal data.  Whenever a block is allocated or released, the
  * guard bands are checked for corruption and any corruption is reported.
  *
+ * SAMPLED CANARIES
+ * ================
+ *
+ * When guard bands are not enabled, "USE_CANARY" is defined instead.  Each block then only gets
+ * a single word of the same pattern (the "canary") right after the user object, written once when
+ * the block is created.  Rather than checking it on every allocation and release, only one
+ * release in every CheckInterval (per thread) checks the released block's canary, and one of
+ * those checks in every CHECKS_PER_SCAN also scans the canaries of all the free blocks of the
+ * block's pool, which catches objects that were written to after being released.  This keeps
+ * most of the protection against buffer overruns in production builds at a fraction of the
+ * memory and CPU cost.  CheckInterval can be set using the LE_MEM_CHECK_INTERVAL environment
+ * variable (see le_mem.h).
+ *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 #include "legato.h"
 #include "mem.h"
 #include "limit.h"
+#include "procStats.h"
+
+#include <sys/mman.h>
 
+#ifdef LE_MEM_GUARD_BANDS
 #define USE_GUARD_BAND
+#else
+#define USE_CANARY
+#endif
 #define FILL_DELETED_AND_CHECK_ALLOCATED
 
 #define NUM_GUARD_BAND_WORDS 8
 #define GUARD_WORD ((uint32_t)0xDEADBEEF)
 #define GUARD_BAND_SIZE (sizeof(GUARD_WORD) * NUM_GUARD_BAND_WORDS)
 
+/// Default number of releases per canary check.
+#define DEFAULT_CHECK_INTERVAL          64
+
+/// Number of canary checks per scan of a pool's free blocks.
+#define CHECKS_PER_SCAN                 64
+
+/// Alignment of regions that are asked to be backed by huge pages (the usual huge page size).
+#define HUGE_PAGE_BYTES                 (2 * 1024 * 1024)
+
+/// log2 of the smallest size class, in bytes.
+#define SIZE_CLASS_MIN_SHIFT            4
+#define SIZE_CLASS_MIN_BYTES            (1 << SIZE_CLASS_MIN_SHIFT)
+
+/// log2 of LE_MEM_SIZE_CLASS_MAX_BYTES.
+#define SIZE_CLASS_MAX_SHIFT            20
+
+/// Number of size classes: two per power of two above the smallest, plus the smallest.
+#define NUM_SIZE_CLASSES                (2 * (SIZE_CLASS_MAX_SHIFT - SIZE_CLASS_MIN_SHIFT) + 1)
+
+#if (1 << SIZE_CLASS_MAX_SHIFT) != LE_MEM_SIZE_CLASS_MAX_BYTES
+#error "SIZE_CLASS_MAX_SHIFT doesn't match LE_MEM_SIZE_CLASS_MAX_BYTES."
+#endif
+
 
 /// The maximum total pool name size, including the component prefix, which is a component
 /// name plus a '.' separator ("myComp.myPool") and the null terminator.
@@ -109,6 +186,38 @@ typedef struct
 MemBlock_t;
 
 
+#ifndef LE_MEM_VALGRIND
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-thread cache of free blocks for a pool that has thread caching enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MemPool_t* poolPtr;         ///< The pool that the cached blocks belong to.
+    le_sls_List_t blockList;    ///< Stack of cached free blocks.
+    size_t numBlocks;           ///< Number of blocks currently on blockList.
+}
+ThreadCache_t;
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size-class allocator.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mem_SizeClassAllocator
+{
+    const char* componentName;                  ///< Name of the component that created it.
+    char name[LIMIT_MAX_MEM_POOL_NAME_BYTES];   ///< Name of the allocator.
+    size_t maxObjSize;                          ///< Largest object size it can allocate.
+    le_mem_PoolRef_t subPools[NUM_SIZE_CLASSES];///< Sub-pool of each size class, or NULL if the
+                                                ///  size class hasn't been used yet.
+}
+SizeClassAllocator_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Local list of all memory pools created with le_mem_CreatePool and le_mem_CreateSubPool
@@ -143,6 +252,42 @@ static le_mem_PoolRef_t SubPoolsPool;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Super-pool of each size class, or NULL if no allocator has used the size class yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SizeClassPools[NUM_SIZE_CLASSES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the creation of size-class pools.  Separate from Mutex because the pool
+ * creation functions lock that one.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t SizeClassMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+#ifdef USE_CANARY
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of releases per canary check.  0 if canaries are never checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static unsigned int CheckInterval = DEFAULT_CHECK_INTERVAL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of releases done by the calling thread, and number of canary checks done by it.
+ */
+//--------------------------------------------------------------------------------------------------
+static __thread unsigned int ReleaseCount;
+static __thread unsigned int CheckCount;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exposing the memory pool list; mainly for the Inspect tool.
@@ -199,6 +344,52 @@ static inline void Unlock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds to a pool's count of blocks in use, updating the "high water mark" if necessary.
+ *
+ * @note Safe to call with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddBlocksInUse
+(
+    MemPool_t*  poolPtr,        ///< [IN] The pool.
+    size_t      numBlocks       ///< [IN] Number of blocks that have been put into use.
+)
+{
+    size_t numInUse = __atomic_add_fetch(&poolPtr->numBlocksInUse, numBlocks, __ATOMIC_RELAXED);
+    size_t maxUsed = __atomic_load_n(&poolPtr->maxNumBlocksUsed, __ATOMIC_RELAXED);
+
+    while ((numInUse > maxUsed) &&
+           !__atomic_compare_exchange_n(&poolPtr->maxNumBlocksUsed,
+                                        &maxUsed,
+                                        numInUse,
+                                        true,
+                                        __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED))
+    {
+        // maxUsed has been refreshed by the failed compare-exchange, so just try again.
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subtracts from a pool's count of blocks in use.
+ *
+ * @note Safe to call with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void RemoveBlocksInUse
+(
+    MemPool_t*  poolPtr,        ///< [IN] The pool.
+    size_t      numBlocks       ///< [IN] Number of blocks that are no longer in use.
+)
+{
+    __atomic_sub_fetch(&poolPtr->numBlocksInUse, numBlocks, __ATOMIC_RELAXED);
+}
+
+
 #ifdef USE_GUARD_BAND
 
     //----------------------------------------------------------------------------------------------
@@ -280,6 +471,113 @@ static inline void Unlock
 #endif
 
 
+#ifdef USE_CANARY
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets a pointer to the canary that follows the user object in a memory block.
+     *
+     * The canary isn't necessarily aligned, so it must be accessed using memcpy().
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline uint8_t* GetCanaryPtr
+    (
+        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+    )
+    {
+        return blockHeaderPtr->data + blockHeaderPtr->poolPtr->userDataSize;
+    }
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Initializes the canary in a memory block's data payload section.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void InitCanary
+    (
+        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+    )
+    {
+        uint32_t canary = GUARD_WORD;
+
+        memcpy(GetCanaryPtr(blockHeaderPtr), &canary, sizeof(canary));
+    }
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Checks the integrity of the canary in a memory block's data payload section.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void CheckCanary
+    (
+        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+    )
+    {
+        uint8_t* canaryPtr = GetCanaryPtr(blockHeaderPtr);
+        uint32_t canary;
+
+        memcpy(&canary, canaryPtr, sizeof(canary));
+
+        if (canary != GUARD_WORD)
+        {
+            LE_EMERG("Memory corruption detected at address %p at end of object allocated"
+                                                                            " from pool '%s'.",
+                     canaryPtr,
+                     blockHeaderPtr->poolPtr->name);
+            LE_FATAL("Canary value should have been %d, but was found to be %d.",
+                     GUARD_WORD,
+                     canary);
+        }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Checks the canary of a block being released, if it's this thread's turn to check one.
+     * Every CHECKS_PER_SCAN checks, also checks the canaries of all of the free blocks of the
+     * block's pool.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void SampleCanaries
+    (
+        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+    )
+    {
+        if ((CheckInterval == 0) || (++ReleaseCount < CheckInterval))
+        {
+            return;
+        }
+
+        ReleaseCount = 0;
+
+        CheckCanary(blockHeaderPtr);
+
+        #ifndef LE_MEM_VALGRIND
+            if (++CheckCount >= CHECKS_PER_SCAN)
+            {
+                CheckCount = 0;
+
+                // Blocks sitting in thread caches are skipped, as they belong to other threads.
+                MemPool_t* poolPtr = blockHeaderPtr->poolPtr;
+
+                Lock();
+
+                le_sls_Link_t* blockLinkPtr = le_sls_Peek(&(poolPtr->freeList));
+
+                while (blockLinkPtr != NULL)
+                {
+                    CheckCanary(CONTAINER_OF(blockLinkPtr, MemBlock_t, link));
+
+                    blockLinkPtr = le_sls_PeekNext(&(poolPtr->freeList), blockLinkPtr);
+                }
+
+                Unlock();
+            }
+        #endif
+    }
+
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes a memory pool.
@@ -311,6 +609,11 @@ static void InitPool
         // Add guard bands around the user data in every block.
         blockSize += (GUARD_BAND_SIZE * 2);
     }
+    #elif defined(USE_CANARY)
+    {
+        // Add a canary after the user data in every block.
+        blockSize += sizeof(GUARD_WORD);
+    }
     #endif
 
     // Round up the block size to the nearest multiple of the processor word size.
@@ -324,6 +627,10 @@ static void InitPool
 
     #ifndef LE_MEM_VALGRIND
         pool->freeList = LE_SLS_LIST_INIT;
+        pool->threadCacheSize = 0;
+        pool->regionPtr = NULL;
+        pool->regionSize = 0;
+        pool->regionUsed = 0;
     #endif
 
     pool->userDataSize = objSize;
@@ -423,6 +730,8 @@ static void InitBlock
 
     #ifdef USE_GUARD_BAND
         InitGuardBands(newBlockPtr);
+    #elif defined(USE_CANARY)
+        InitCanary(newBlockPtr);
     #endif
 }
 
@@ -447,22 +756,211 @@ static void InitBlock
     {
         size_t i;
         size_t blockSize = pool->blockSize;
-        size_t mallocSize = numBlocks * blockSize;
+        size_t numRegionBlocks = 0;
 
-        // Allocate the chunk.
-        MemBlock_t* newBlockPtr = malloc(mallocSize);
+        // Take as many blocks as possible from the pool's region, if it has one.  Initialize them
+        // from the last one to the first, so that they come off the free list in address order.
+        if (pool->regionPtr != NULL)
+        {
+            numRegionBlocks = (pool->regionSize - pool->regionUsed) / blockSize;
+            if (numRegionBlocks > numBlocks)
+            {
+                numRegionBlocks = numBlocks;
+            }
 
-        LE_ASSERT(newBlockPtr);
+            uint8_t* regionBlockPtr = pool->regionPtr + pool->regionUsed;
+            pool->regionUsed += numRegionBlocks * blockSize;
 
-        for (i = 0; i < numBlocks; i++)
+            for (i = numRegionBlocks; i > 0; i--)
+            {
+                InitBlock(pool, (MemBlock_t*)(regionBlockPtr + (i - 1) * blockSize));
+            }
+        }
+
+        if (numRegionBlocks < numBlocks)
         {
-            InitBlock(pool, newBlockPtr);
-            newBlockPtr = (MemBlock_t*)(((uint8_t*)newBlockPtr) + blockSize);
+            size_t mallocSize = (numBlocks - numRegionBlocks) * blockSize;
+
+            // Allocate the chunk.
+            MemBlock_t* newBlockPtr = malloc(mallocSize);
+
+            LE_ASSERT(newBlockPtr);
+
+            for (i = numRegionBlocks; i < numBlocks; i++)
+            {
+                InitBlock(pool, newBlockPtr);
+                newBlockPtr = (MemBlock_t*)(((uint8_t*)newBlockPtr) + blockSize);
+            }
         }
 
         // Update the pool.
         pool->totalBlocks += numBlocks;
     }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves up to a given number of blocks from a thread cache back onto its pool's free list.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FlushThreadCache
+    (
+        ThreadCache_t*  cachePtr,   ///< [IN] The thread cache.
+        size_t          numBlocks   ///< [IN] The maximum number of blocks to move.
+    )
+    {
+        while ((numBlocks > 0) && (cachePtr->numBlocks > 0))
+        {
+            le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(cachePtr->blockList));
+
+            le_sls_Stack(&(cachePtr->poolPtr->freeList), blockLinkPtr);
+
+            cachePtr->numBlocks--;
+            numBlocks--;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Thread-local storage destructor for thread caches.  Called when a thread that has a
+     * thread cache exits.  Gives all of the cached blocks back to the pool.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void DestructThreadCache
+    (
+        void* objPtr    ///< [IN] Pointer to the exiting thread's ThreadCache_t.
+    )
+    {
+        ThreadCache_t* cachePtr = objPtr;
+
+        Lock();
+        FlushThreadCache(cachePtr, cachePtr->numBlocks);
+        Unlock();
+
+        free(cachePtr);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the calling thread's cache for a given pool, creating it if necessary.
+     *
+     * @return Pointer to the thread cache.
+     */
+    //----------------------------------------------------------------------------------------------
+    static ThreadCache_t* GetThreadCache
+    (
+        MemPool_t*  poolPtr     ///< [IN] The pool, which must have thread caching enabled.
+    )
+    {
+        ThreadCache_t* cachePtr = pthread_getspecific(poolPtr->threadCacheKey);
+
+        if (cachePtr == NULL)
+        {
+            cachePtr = malloc(sizeof(ThreadCache_t));
+            LE_ASSERT(cachePtr);
+
+            cachePtr->poolPtr = poolPtr;
+            cachePtr->blockList = LE_SLS_LIST_INIT;
+            cachePtr->numBlocks = 0;
+
+            LE_ASSERT(pthread_setspecific(poolPtr->threadCacheKey, cachePtr) == 0);
+        }
+
+        return cachePtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the number of blocks moved between a thread cache and its pool's free list at a time.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline size_t ThreadCacheBatchSize
+    (
+        MemPool_t*  poolPtr     ///< [IN] The pool, which must have thread caching enabled.
+    )
+    {
+        return (poolPtr->threadCacheSize + 1) / 2;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pops a free block from the calling thread's cache for a pool, refilling the cache from the
+     * pool's free list if the cache is empty.
+     *
+     * @return Pointer to the block, or NULL if there are no free blocks left in the pool.
+     */
+    //----------------------------------------------------------------------------------------------
+    static MemBlock_t* PopCachedBlock
+    (
+        MemPool_t*  poolPtr     ///< [IN] The pool, which must have thread caching enabled.
+    )
+    {
+        ThreadCache_t* cachePtr = GetThreadCache(poolPtr);
+
+        if (cachePtr->numBlocks == 0)
+        {
+            size_t batchSize = ThreadCacheBatchSize(poolPtr);
+
+            Lock();
+
+            while (cachePtr->numBlocks < batchSize)
+            {
+                le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(poolPtr->freeList));
+
+                if (blockLinkPtr == NULL)
+                {
+                    break;
+                }
+
+                le_sls_Stack(&(cachePtr->blockList), blockLinkPtr);
+                cachePtr->numBlocks++;
+            }
+
+            Unlock();
+
+            if (cachePtr->numBlocks == 0)
+            {
+                return NULL;
+            }
+        }
+
+        cachePtr->numBlocks--;
+
+        return CONTAINER_OF(le_sls_Pop(&(cachePtr->blockList)), MemBlock_t, link);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pushes a free block onto the calling thread's cache for its pool, giving half of the cached
+     * blocks back to the pool's free list if the cache is full.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void PushCachedBlock
+    (
+        MemPool_t*  poolPtr,    ///< [IN] The pool, which must have thread caching enabled.
+        MemBlock_t* blockPtr    ///< [IN] The free block.
+    )
+    {
+        ThreadCache_t* cachePtr = GetThreadCache(poolPtr);
+
+        if (cachePtr->numBlocks >= poolPtr->threadCacheSize)
+        {
+            Lock();
+            FlushThreadCache(cachePtr, ThreadCacheBatchSize(poolPtr));
+            Unlock();
+        }
+
+        le_sls_Stack(&(cachePtr->blockList), &(blockPtr->link));
+        cachePtr->numBlocks++;
+    }
 #endif
 
 
@@ -513,6 +1011,24 @@ void mem_Init
     // NOTE: No need to lock the mutex because this function should be called when there is still
     //       only one thread running.
 
+    #ifdef USE_CANARY
+    {
+        // NOTE: The logging system isn't initialized yet, so invalid values are silently ignored.
+        const char* envStrPtr = getenv("LE_MEM_CHECK_INTERVAL");
+
+        if (envStrPtr != NULL)
+        {
+            char* endPtr;
+            unsigned long interval = strtoul(envStrPtr, &endPtr, 10);
+
+            if ((endPtr != envStrPtr) && (*endPtr == '\0') && (interval <= UINT_MAX))
+            {
+                CheckInterval = interval;
+            }
+        }
+    }
+    #endif
+
     // Create a memory for all sub-pools.
     SubPoolsPool = le_mem_CreatePool("SubPools", sizeof(MemPool_t));
     le_mem_ExpandPool(SubPoolsPool, DEFAULT_SUB_POOLS_POOL_SIZE);
@@ -630,13 +1146,20 @@ le_mem_PoolRef_t _le_mem_CreatePool
                         /// (in bytes).  E.g., sizeof(MyObject_t).
 )
 {
-    le_mem_PoolRef_t newPool = malloc(sizeof(MemPool_t));
+    // Put the pool in the process's stats page if there is room, so Inspect can see it cheaply.
+    le_mem_PoolRef_t newPool = procStats_AllocPool();
 
-    // Crash if we can't create the memory pool.
-    LE_ASSERT(newPool);
+    if (newPool == NULL)
+    {
+        newPool = malloc(sizeof(MemPool_t));
+
+        // Crash if we can't create the memory pool.
+        LE_ASSERT(newPool);
+    }
 
     // Initialize the memory pool.
     InitPool(newPool, componentName, name, objSize);
+    procStats_PublishPool(newPool);
 
     Lock();
 
@@ -693,12 +1216,7 @@ le_mem_PoolRef_t le_mem_ExpandPool
             pool->totalBlocks = pool->totalBlocks + numObjects;
 
             // Update the super-pool's block use counts.
-            pool->superPoolPtr->numBlocksInUse += numObjects;
-
-            if (pool->superPoolPtr->numBlocksInUse > pool->superPoolPtr->maxNumBlocksUsed)
-            {
-                pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
-            }
+            AddBlocksInUse(pool->superPoolPtr, numObjects);
         }
         else
         {
@@ -732,16 +1250,26 @@ void* le_mem_TryAlloc
     MemBlock_t* blockPtr = NULL;
     void* userPtr = NULL;
 
-    Lock();
-
     #ifndef LE_MEM_VALGRIND
-        // Pop a link off the pool.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
-
-        if (blockLinkPtr != NULL)
+        if (pool->threadCacheSize > 0)
+        {
+            // Get a block from this thread's cache without locking the mutex if possible.
+            blockPtr = PopCachedBlock(pool);
+        }
+        else
         {
-            // Get the block from the block link.
-            blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+            Lock();
+
+            // Pop a link off the pool.
+            le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
+
+            Unlock();
+
+            if (blockLinkPtr != NULL)
+            {
+                // Get the block from the block link.
+                blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+            }
         }
     #else
         blockPtr = malloc(pool->blockSize);
@@ -754,16 +1282,12 @@ void* le_mem_TryAlloc
 
     if (blockPtr != NULL)
     {
-        // Update the pool and the block.
-        pool->numAllocations++;
-        pool->numBlocksInUse++;
+        // Update the pool and the block.  Note that the block is now owned by this thread, so
+        // its reference count can be set without worrying about other threads.
+        __atomic_add_fetch(&pool->numAllocations, 1, __ATOMIC_RELAXED);
+        AddBlocksInUse(pool, 1);
 
-        if (pool->numBlocksInUse > pool->maxNumBlocksUsed)
-        {
-            pool->maxNumBlocksUsed = pool->numBlocksInUse;
-        }
-
-        blockPtr->refCount = 1;
+        __atomic_store_n(&blockPtr->refCount, 1, __ATOMIC_RELAXED);
 
         // Return the user object in the block.
         #ifdef USE_GUARD_BAND
@@ -774,8 +1298,6 @@ void* le_mem_TryAlloc
         #endif
     }
 
-    Unlock();
-
     return userPtr;
 }
 
@@ -876,6 +1398,135 @@ void le_mem_SetNumObjsToForce
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables a per-thread cache of free objects for a pool.
+ *
+ * @return
+ *      Nothing.
+ *
+ * @note
+ *      Must be called before any objects are allocated from the pool, and can only be called once
+ *      for a given pool.  Sub-pools can't have thread caches.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetThreadCacheSize
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] The pool to enable thread caching for.
+    size_t              numObjects  ///< [IN] The maximum number of free objects to cache in each
+                                    ///       thread.
+)
+{
+    LE_ASSERT(pool != NULL);
+
+    #ifndef LE_MEM_VALGRIND
+        LE_FATAL_IF(numObjects == 0, "Thread cache for pool '%s' must hold at least one object.",
+                    pool->name);
+
+        Lock();
+
+        LE_FATAL_IF(pool->superPoolPtr != NULL,
+                    "Sub-pool '%s' can't have a thread cache.", pool->name);
+        LE_FATAL_IF(pool->threadCacheSize != 0,
+                    "Pool '%s' already has a thread cache.", pool->name);
+        LE_FATAL_IF(pool->numAllocations != 0,
+                    "Thread cache enabled for pool '%s' after objects were allocated.", pool->name);
+
+        LE_ASSERT(pthread_key_create(&pool->threadCacheKey, DestructThreadCache) == 0);
+        pool->threadCacheSize = numObjects;
+
+        Unlock();
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reserves a contiguous region of memory that a pool's expansions take their objects from.
+ *
+ * @return
+ *      A reference to the memory pool object (the same value passed into it).
+ *
+ * @note
+ *      Must be called before the pool is first expanded, and can only be called once for a given
+ *      pool.  Sub-pools can't have regions.  On failure, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_PoolRef_t le_mem_ReserveRegion
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] The pool to reserve a region for.
+    size_t              numObjects, ///< [IN] The number of objects that the region must hold.
+    uint32_t            flags       ///< [IN] LE_MEM_REGION_PREFAULT and/or
+                                    ///       LE_MEM_REGION_HUGEPAGES, or 0.
+)
+{
+    LE_ASSERT(pool != NULL);
+
+    #ifndef LE_MEM_VALGRIND
+        LE_FATAL_IF(pool->superPoolPtr != NULL, "Sub-pool '%s' can't have a region.", pool->name);
+        LE_FATAL_IF(pool->regionPtr != NULL, "Pool '%s' already has a region.", pool->name);
+        LE_FATAL_IF(pool->totalBlocks != 0,
+                    "Region reserved for pool '%s' after it was expanded.", pool->name);
+        LE_FATAL_IF((numObjects == 0) || (numObjects > SIZE_MAX / pool->blockSize),
+                    "Can't reserve a region of %zu objects for pool '%s'.", numObjects, pool->name);
+
+        size_t alignment = (flags & LE_MEM_REGION_HUGEPAGES) ? HUGE_PAGE_BYTES
+                                                             : (size_t)sysconf(_SC_PAGESIZE);
+        size_t regionSize = numObjects * pool->blockSize;
+        regionSize = (regionSize + alignment - 1) & ~(alignment - 1);
+
+        // Map an extra alignment's worth, and trim the ends, so the region starts on an alignment
+        // boundary.  Only needed for huge pages, as mappings are always page-aligned.
+        size_t mapSize = (flags & LE_MEM_REGION_HUGEPAGES) ? (regionSize + alignment) : regionSize;
+        uint8_t* mapPtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        LE_FATAL_IF(mapPtr == MAP_FAILED,
+                    "Failed to map a region of %zu bytes for pool '%s' (%m).",
+                    regionSize,
+                    pool->name);
+
+        uint8_t* regionPtr = (uint8_t*)(((uintptr_t)mapPtr + alignment - 1) & ~(alignment - 1));
+
+        if (regionPtr > mapPtr)
+        {
+            munmap(mapPtr, regionPtr - mapPtr);
+        }
+        if (mapPtr + mapSize > regionPtr + regionSize)
+        {
+            munmap(regionPtr + regionSize, (mapPtr + mapSize) - (regionPtr + regionSize));
+        }
+
+        #ifdef MADV_HUGEPAGE
+            if (   (flags & LE_MEM_REGION_HUGEPAGES)
+                && (madvise(regionPtr, regionSize, MADV_HUGEPAGE) != 0) )
+            {
+                LE_DEBUG("No transparent huge pages for pool '%s' (%m).", pool->name);
+            }
+        #endif
+
+        if (flags & LE_MEM_REGION_PREFAULT)
+        {
+            size_t pageSize = sysconf(_SC_PAGESIZE);
+            size_t offset;
+
+            for (offset = 0; offset < regionSize; offset += pageSize)
+            {
+                regionPtr[offset] = 0;
+            }
+        }
+
+        Lock();
+        pool->regionPtr = regionPtr;
+        pool->regionSize = regionSize;
+        pool->regionUsed = 0;
+        Unlock();
+    #endif
+
+    return pool;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Releases an object.  If the object's reference count has reached zero, it will be destructed
@@ -909,47 +1560,53 @@ void le_mem_Release
 
     #ifdef USE_GUARD_BAND
         CheckGuardBands(blockPtr);
+    #elif defined(USE_CANARY)
+        SampleCanaries(blockPtr);
     #endif
 
-    Lock();
-
-    switch (blockPtr->refCount)
+    // Decrement the reference count atomically, so that the mutex doesn't need to be locked
+    // unless the block has to go back onto the pool's free list.
+    switch (__atomic_fetch_sub(&blockPtr->refCount, 1, __ATOMIC_ACQ_REL))
     {
         case 1:
         {
+            // The reference count has reached zero, so nobody else can be touching this block.
             MemPool_t* poolPtr = blockPtr->poolPtr;
 
-            // The reference count has reached zero.
-            blockPtr->refCount = 0;
-
             // Call the destructor, if there is one.
-            if (poolPtr->destructor)
+            // Note that the destructor is called with the mutex unlocked, because it is not a
+            // recursive mutex and therefore would deadlock if the destructor uses this API.
+            le_mem_Destructor_t destructor = __atomic_load_n(&poolPtr->destructor,
+                                                             __ATOMIC_ACQUIRE);
+            if (destructor)
             {
-                // Make sure that the destructor is not called with the mutex locked, because
-                // it is not a recursive mutex and therefore will deadlock if locked again by
-                // the same thread.  Also, fetch the destructor function address before unlocking
-                // the mutex so that we don't touch the pool object while the mutex is unlocked.
-                le_mem_Destructor_t destructor = poolPtr->destructor;
-                Unlock();
                 destructor(objPtr);
-
-                // Re-lock the mutex now so that it is safe to access the pool object again.
-                Lock();
             }
 
+            // Update the stats before the block is made available for reallocation, so that
+            // the number of blocks in use never appears to exceed the total number of blocks.
+            RemoveBlocksInUse(poolPtr, 1);
+
             #ifndef LE_MEM_VALGRIND
                 // Release the memory back into the pool.
                 // Note that we don't do this before calling the destructor because the destructor
                 // still needs to access it, but after it goes back on the free list, it could get
                 // reallocated by another thread (or even the destructor itself) and have its
                 // contents clobbered.
-                le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+                if (poolPtr->threadCacheSize > 0)
+                {
+                    PushCachedBlock(poolPtr, blockPtr);
+                }
+                else
+                {
+                    Lock();
+                    le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+                    Unlock();
+                }
             #else
                 free(blockPtr);
             #endif
 
-            poolPtr->numBlocksInUse--;
-
             break;
         }
 
@@ -960,10 +1617,8 @@ void le_mem_Release
                      blockPtr->poolPtr->name);
 
         default:
-            blockPtr->refCount--;
+            break;
     }
-
-    Unlock();
 }
 
 
@@ -991,13 +1646,8 @@ void le_mem_AddRef
         CheckGuardBands(memBlockPtr);
     #endif
 
-    Lock();
-
-    LE_ASSERT(memBlockPtr->refCount != 0);
-
-    memBlockPtr->refCount++;
-
-    Unlock();
+    // The caller holds a reference, so the count can't concurrently drop to zero.
+    LE_ASSERT(__atomic_fetch_add(&memBlockPtr->refCount, 1, __ATOMIC_RELAXED) != 0);
 }
 
 
@@ -1019,9 +1669,7 @@ void le_mem_SetDestructor
 {
     LE_ASSERT(pool != NULL);
 
-    Lock();
-    pool->destructor = destructor;
-    Unlock();
+    __atomic_store_n(&pool->destructor, destructor, __ATOMIC_RELEASE);
 }
 
 
@@ -1043,11 +1691,15 @@ void le_mem_GetStats
 
     Lock();
 
-    statsPtr->numAllocs = pool->numAllocations;
+    // Blocks can be allocated and released without the mutex locked, so read the counters that
+    // can change without the mutex atomically.  Blocks held in thread caches are counted as free.
+    size_t numBlocksInUse = __atomic_load_n(&pool->numBlocksInUse, __ATOMIC_RELAXED);
+
+    statsPtr->numAllocs = __atomic_load_n(&pool->numAllocations, __ATOMIC_RELAXED);
     statsPtr->numOverflows = pool->numOverflows;
-    statsPtr->numFree = pool->totalBlocks - pool->numBlocksInUse;
-    statsPtr->numBlocksInUse = pool->numBlocksInUse;
-    statsPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+    statsPtr->numFree = pool->totalBlocks - numBlocksInUse;
+    statsPtr->numBlocksInUse = numBlocksInUse;
+    statsPtr->maxNumBlocksUsed = __atomic_load_n(&pool->maxNumBlocksUsed, __ATOMIC_RELAXED);
 
     Unlock();
 }
@@ -1069,7 +1721,7 @@ void le_mem_ResetStats
     LE_ASSERT(pool != NULL);
 
     Lock();
-    pool->numAllocations = 0;
+    __atomic_store_n(&pool->numAllocations, 0, __ATOMIC_RELAXED);
     pool->numOverflows = 0;
     Unlock();
 }
@@ -1281,12 +1933,18 @@ le_mem_PoolRef_t _le_mem_CreateSubPool
     // Make sure the parent pool is not itself a sub-pool.
     LE_ASSERT(superPool->superPoolPtr == NULL);
 
-    // Get a sub-pool from the pool of sub-pools.
-    le_mem_PoolRef_t subPool = le_mem_ForceAlloc(SubPoolsPool);
+    // Get a sub-pool from the stats page, or from the pool of sub-pools if the page is full.
+    le_mem_PoolRef_t subPool = procStats_AllocPool();
+
+    if (subPool == NULL)
+    {
+        subPool = le_mem_ForceAlloc(SubPoolsPool);
+    }
 
     // Initialize the pool.
     InitPool(subPool, componentName, name, superPool->userDataSize);
     subPool->superPoolPtr = superPool;
+    procStats_PublishPool(subPool);
 
     Lock();
 
@@ -1333,7 +1991,7 @@ void le_mem_DeleteSubPool
     // Make sure all sub-pool objects are free.
     le_mem_PoolRef_t superPool = subPool->superPoolPtr;
 
-    LE_FATAL_IF(subPool->numBlocksInUse != 0,
+    LE_FATAL_IF(__atomic_load_n(&subPool->numBlocksInUse, __ATOMIC_RELAXED) != 0,
                 "Subpool '%s' deleted while %zu blocks remain allocated.",
                 subPool->name,
                 subPool->numBlocksInUse);
@@ -1344,7 +2002,7 @@ void le_mem_DeleteSubPool
     MoveBlocks(superPool, subPool, numBlocks);
 
     // Update the superPool's block use count.
-    superPool->numBlocksInUse -= numBlocks;
+    RemoveBlocksInUse(superPool, numBlocks);
 
     // Remove the sub-pool from the list of sub-pools.
     PoolListChangeCount++;
@@ -1353,7 +2011,186 @@ void le_mem_DeleteSubPool
     Unlock();
 
     // Release the sub-pool.
-    le_mem_Release(subPool);
+    if (!procStats_ReleasePool(subPool))
+    {
+        le_mem_Release(subPool);
+    }
 }
 
 
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size class of an object size.
+ *
+ * @return Index of the smallest size class that holds objects of that size.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t GetSizeClass
+(
+    size_t objSize  ///< [IN] Size of the object, in bytes.
+)
+{
+    if (objSize <= SIZE_CLASS_MIN_BYTES)
+    {
+        return 0;
+    }
+
+    // Sizes from 2^n + 1 to 2^n + 2^(n-1) go in the first size class above 2^n, and sizes up to
+    // 2^(n+1) in the second one, so it only takes the two most significant bits of (size - 1).
+    size_t lastByte = objSize - 1;
+    size_t msb = (sizeof(unsigned long) * 8 - 1) - __builtin_clzl(lastByte);
+
+    return 2 * (msb - SIZE_CLASS_MIN_SHIFT) + 1 + ((lastByte >> (msb - 1)) & 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the object size of a size class.
+ *
+ * @return Size of the objects in that size class, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t GetSizeClassBytes
+(
+    size_t sizeClass    ///< [IN] Index of the size class.
+)
+{
+    if (sizeClass % 2 == 0)
+    {
+        return (size_t)SIZE_CLASS_MIN_BYTES << (sizeClass / 2);
+    }
+
+    return (size_t)(SIZE_CLASS_MIN_BYTES + SIZE_CLASS_MIN_BYTES / 2) << (sizeClass / 2);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an allocator's sub-pool for a size class, creating it (and the size class's super-pool)
+ * if it doesn't exist yet.
+ *
+ * @return Reference to the sub-pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t GetSizeClassPool
+(
+    SizeClassAllocator_t*   allocatorPtr,   ///< [IN] The allocator.
+    size_t                  sizeClass       ///< [IN] Index of the size class.
+)
+{
+    le_mem_PoolRef_t subPool = __atomic_load_n(&allocatorPtr->subPools[sizeClass],
+                                               __ATOMIC_ACQUIRE);
+
+    if (subPool == NULL)
+    {
+        char name[LIMIT_MAX_MEM_POOL_NAME_BYTES];
+        size_t objSize = GetSizeClassBytes(sizeClass);
+
+        LE_ASSERT(pthread_mutex_lock(&SizeClassMutex) == 0);
+
+        subPool = allocatorPtr->subPools[sizeClass];
+
+        if (subPool == NULL)
+        {
+            if (SizeClassPools[sizeClass] == NULL)
+            {
+                snprintf(name, sizeof(name), "SizeClass%zu", objSize);
+                SizeClassPools[sizeClass] = le_mem_CreatePool(name, objSize);
+            }
+
+            if (snprintf(name, sizeof(name), "%s.%zu", allocatorPtr->name, objSize)
+                >= (int)sizeof(name))
+            {
+                LE_DEBUG("Size-class pool name '%s.%zu' is truncated to '%s'",
+                         allocatorPtr->name,
+                         objSize,
+                         name);
+            }
+            subPool = _le_mem_CreateSubPool(SizeClassPools[sizeClass],
+                                            allocatorPtr->componentName,
+                                            name,
+                                            0);
+
+            __atomic_store_n(&allocatorPtr->subPools[sizeClass], subPool, __ATOMIC_RELEASE);
+        }
+
+        LE_ASSERT(pthread_mutex_unlock(&SizeClassMutex) == 0);
+    }
+
+    return subPool;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a size-class allocator.
+ *
+ * See @ref mem_size_classes for more information.
+ *
+ * @return
+ *      A reference to the allocator.
+ *
+ * @note
+ *      On failure, the process exits, so you don't have to worry about checking the returned
+ *      reference for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SizeClassAllocatorRef_t _le_mem_CreateSizeClassAllocator
+(
+    const char*     componentName,  ///< [IN] Name of the component.
+    const char*         name,       ///< [IN] Name of the allocator.
+    size_t              maxObjSize  ///< [IN] Largest object size that will be allocated.
+)
+{
+    LE_FATAL_IF(maxObjSize > LE_MEM_SIZE_CLASS_MAX_BYTES,
+                "Size-class allocator '%s' can't allocate objects of %zu bytes (max %d).",
+                name,
+                maxObjSize,
+                LE_MEM_SIZE_CLASS_MAX_BYTES);
+
+    SizeClassAllocator_t* allocatorPtr = calloc(1, sizeof(SizeClassAllocator_t));
+
+    // Crash if we can't create the allocator.
+    LE_ASSERT(allocatorPtr);
+
+    allocatorPtr->componentName = componentName;
+    if (le_utf8_Copy(allocatorPtr->name, name, sizeof(allocatorPtr->name), NULL) == LE_OVERFLOW)
+    {
+        LE_DEBUG("Size-class allocator name '%s' is truncated to '%s'", name, allocatorPtr->name);
+    }
+    allocatorPtr->maxObjSize = maxObjSize;
+
+    return allocatorPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a size-class allocator, expanding the size class if
+ * it doesn't have any free objects.  The object is released using le_mem_Release().
+ *
+ * @return  A pointer to the allocated object, which is at least objSize bytes long.
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          pointer for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_SizeClassAlloc
+(
+    le_mem_SizeClassAllocatorRef_t  allocator,  ///< [IN] The allocator.
+    size_t                          objSize     ///< [IN] Size of the object, in bytes.
+)
+{
+    LE_ASSERT(allocator != NULL);
+
+    LE_FATAL_IF(objSize > allocator->maxObjSize,
+                "Object of %zu bytes is too big for size-class allocator '%s' (max %zu).",
+                objSize,
+                allocator->name,
+                allocator->maxObjSize);
+
+    return le_mem_ForceAlloc(GetSizeClassPool(allocator, GetSizeClass(objSize)));
+}
@@ -27,6 +27,13 @@ typedef struct le_mem_Pool
                                         ///  if we are not a sub-pool.
     #ifndef LE_MEM_VALGRIND
         le_sls_List_t freeList;         ///< List of free memory blocks.
+        size_t threadCacheSize;         ///< Max. number of free blocks cached per thread.
+                                        ///  0 if per-thread caching is disabled.
+        pthread_key_t threadCacheKey;   ///< Key for this pool's thread-local block cache.
+        uint8_t* regionPtr;             ///< Region reserved by le_mem_ReserveRegion() (NULL if
+                                        ///  the blocks come from the heap).
+        size_t regionSize;              ///< Size of the reserved region, in bytes.
+        size_t regionUsed;              ///< Number of bytes of the region holding blocks.
     #endif
 
     size_t userDataSize;                ///< Size of the object requested by the client in bytes.
@@ -120,3 +120,24 @@ void msg_Init
     msgInterface_Init();
     msgSession_Init();
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that a client-side interface is bound to a server-side interface in the same process,
+ * so that sessions opened on the client-side interface are opened in-process, without going
+ * through the Service Directory.
+ *
+ * Called by the generated main() of executables built by the mk tools, before any components are
+ * initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+void msg_AddLocalBinding
+(
+    const char* clientIfName,   ///< [IN] Client-side interface name.
+    const char* serverIfName    ///< [IN] Server-side interface name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_AddLocalBinding(clientIfName, serverIfName);
+}
@@ -15,6 +15,8 @@
 #include "messagingInterface.h"
 #include "messagingSession.h"
 #include "fileDescriptor.h"
+#include "startupTrace.h"
+#include "procStats.h"
 
 
 // =======================================
@@ -31,6 +33,36 @@
 /// Highest number of Client Interfaces that are expected to be referred to in a single process.
 #define MAX_EXPECTED_CLIENT_INTERFACES    32
 
+/// Highest number of local bindings that are expected in a single process.
+#define MAX_EXPECTED_LOCAL_BINDINGS     16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local binding.  Binds a client interface to a service offered in the same process, so that
+ * sessions can be opened without going through the Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char clientIfName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];  ///< Client interface name (the key).
+    char serverIfName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];  ///< Name of the service it's bound to.
+}
+LocalBinding_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Local Binding objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LocalBindingPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hashmap in which Local Binding objects are kept, keyed by client interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t LocalBindingMapRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hashmap in which Service objects are kept.
@@ -89,6 +121,29 @@ static le_mem_PoolRef_t ClientInterfacePoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  HandlerEventPoolRef;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server-side Direct Channel object.  Keeps track of a Direct Channel that the Service Directory
+ * has given a Service, through which a client sends the fds of new connections to the Service.
+ * See @ref serviceDirectoryProtocol_DirectChannels.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t           link;           ///< Used to link into the Service's list of channels.
+    msgInterface_Service_t* servicePtr;     ///< The Service that the channel opens sessions with.
+    int                     fd;             ///< Fd of the server's end of the channel.
+    le_fdMonitor_Ref_t      fdMonitorRef;   ///< File descriptor monitor for the channel.
+}
+DirectChannel_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Direct Channel objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirectChannelPoolRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect data structures in this module from multi-threaded race conditions.
@@ -239,8 +294,14 @@ static msgInterface_Service_t* CreateService
     // Initialize the open handlers dls
     servicePtr->openListPtr = LE_DLS_LIST_INIT;
 
+    servicePtr->directChannelList = LE_DLS_LIST_INIT;
+
+    servicePtr->numWorkerThreads = 0;
+    servicePtr->nextWorkerIndex = 0;
+
     ServiceObjMapChangeCount++;
     le_hashmap_Put(ServiceMapRef, &servicePtr->interface.id, servicePtr);
+    procStats_Add(PROCSTATS_SERVICES, 1);
 
     return servicePtr;
 }
@@ -271,6 +332,7 @@ static msgInterface_ClientInterface_t* CreateClientInterface
 
     ClientInterfaceMapChangeCount++;
     le_hashmap_Put(ClientInterfaceMapRef, &clientPtr->interface.id, clientPtr);
+    procStats_Add(PROCSTATS_CLIENT_INTERFACES, 1);
 
     return clientPtr;
 }
@@ -381,6 +443,7 @@ static void ServiceDestructor
 
     ServiceObjMapChangeCount++;
     le_hashmap_Remove(ServiceMapRef, &servicePtr->interface.id);
+    procStats_Add(PROCSTATS_SERVICES, -1);
 
     // Release the close handlers
     le_dls_Link_t* linkPtr;
@@ -424,6 +487,7 @@ static void ClientInterfaceDestructor
 
     ClientInterfaceMapChangeCount++;
     le_hashmap_Remove(ClientInterfaceMapRef, &clientPtr->interface.id);
+    procStats_Add(PROCSTATS_CLIENT_INTERFACES, -1);
 }
 
 
@@ -502,6 +566,8 @@ static void DirectorySocketWriteable
 
             servicePtr->state = LE_MSG_INTERFACE_SERVICE_ADVERTISED;
 
+            startupTrace_Mark(STARTUP_TRACE_EVENT_ADVERTISE, servicePtr->interface.id.name);
+
             // Wait for the Service Directory to respond by either dropping the connection
             // (meaning that we have been denied permission to offer this service) or by
             // forwarding us file descriptors for authenticated client connections.
@@ -521,12 +587,219 @@ static void DirectorySocketWriteable
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a server-side session for a client connection socket in the current thread, and calls
+ * the Service's "open" handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenSessionInThread
+(
+    msgInterface_Service_t* servicePtr,
+    int clientSocketFd
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Create a server-side Session object for that connection to this Service.
+    le_msg_SessionRef_t sessionRef = msgSession_CreateServerSideSession(servicePtr,
+                                                                        clientSocketFd);
+
+    // If successful, call the registered "open" handler, if there is one.
+    if (sessionRef != NULL)
+    {
+        CallOpenHandler(servicePtr, sessionRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a server-side session in the worker thread that it was dispatched to.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenSessionInWorker
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Service object (holds a reference).
+    void* param2Ptr     ///< [IN] Client connection socket file descriptor.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_Service_t* servicePtr = param1Ptr;
+
+    OpenSessionInThread(servicePtr, (int)(intptr_t)param2Ptr);
+
+    msgInterface_Release((le_msg_InterfaceRef_t)servicePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a server-side session for a client connection socket, and calls the Service's "open"
+ * handlers.  If the Service has worker threads, this is done in the next one in turn, which then
+ * handles everything to do with the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenServerSideSession
+(
+    msgInterface_Service_t* servicePtr,
+    int clientSocketFd
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (servicePtr->numWorkerThreads == 0)
+    {
+        OpenSessionInThread(servicePtr, clientSocketFd);
+    }
+    else
+    {
+        le_thread_Ref_t threadRef = servicePtr->workerThreads[servicePtr->nextWorkerIndex];
+
+        servicePtr->nextWorkerIndex = (servicePtr->nextWorkerIndex + 1)
+                                      % servicePtr->numWorkerThreads;
+
+        le_mem_AddRef(servicePtr);
+        le_event_QueueFunctionToThread(threadRef,
+                                       OpenSessionInWorker,
+                                       servicePtr,
+                                       (void*)(intptr_t)clientSocketFd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a Service's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerThreadMain
+(
+    void* contextPtr    ///< [IN] Semaphore to post once the thread's Event Loop is ready.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sem_Post(contextPtr);
+
+    le_event_RunLoop();
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a Direct Channel and deletes its object.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteDirectChannel
+(
+    DirectChannel_t* channelPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&channelPtr->servicePtr->directChannelList, &channelPtr->link);
+
+    le_fdMonitor_Delete(channelPtr->fdMonitorRef);
+    fd_Close(channelPtr->fd);
+
+    le_mem_Release(channelPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles events detected on the file descriptor of a Direct Channel.
+ *
+ * If the channel has hung up (because the client closed it or the Service Directory revoked it),
+ * it is deleted, and any connections still waiting in it are dropped.  The clients will retry
+ * through the Service Directory.  Otherwise, the client has sent us the fd of a new connection.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DirectChannelEventHandler
+(
+    int     fd,
+    short   events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DirectChannel_t* channelPtr = le_fdMonitor_GetContextPtr();
+
+    if (events & (POLLHUP | POLLRDHUP | POLLERR))
+    {
+        DeleteDirectChannel(channelPtr);
+        return;
+    }
+
+    int clientSocketFd;
+    le_result_t result = unixSocket_ReceiveMsg(fd,
+                                               NULL,   // dataBuffPtr
+                                               0,      // dataBuffSize
+                                               &clientSocketFd,
+                                               NULL);  // credPtr
+
+    if (result == LE_WOULD_BLOCK)
+    {
+        return;
+    }
+    else if (result != LE_OK)
+    {
+        LE_ERROR("Failed to receive client fd from Direct Channel for (%s:%s) (%s).",
+                 channelPtr->servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(channelPtr->servicePtr->interface.id.protocolRef),
+                 LE_RESULT_TXT(result));
+        DeleteDirectChannel(channelPtr);
+    }
+    else if (clientSocketFd < 0)
+    {
+        LE_ERROR("Received something other than a file descriptor from Direct Channel for (%s:%s).",
+                 channelPtr->servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(channelPtr->servicePtr->interface.id.protocolRef));
+    }
+    else
+    {
+        OpenServerSideSession(channelPtr->servicePtr, clientSocketFd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a Direct Channel object for a Direct Channel received from the Service Directory, and
+ * starts accepting client connections from it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateDirectChannel
+(
+    msgInterface_Service_t* servicePtr,
+    int fd                              ///< [in] Fd of the server's end of the channel.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DirectChannel_t* channelPtr = le_mem_ForceAlloc(DirectChannelPoolRef);
+
+    channelPtr->link = LE_DLS_LINK_INIT;
+    channelPtr->servicePtr = servicePtr;
+    channelPtr->fd = fd;
+
+    fd_SetNonBlocking(fd);
+
+    channelPtr->fdMonitorRef = le_fdMonitor_Create(servicePtr->interface.id.name,
+                                                   fd,
+                                                   DirectChannelEventHandler,
+                                                   POLLIN);
+    le_fdMonitor_SetContextPtr(channelPtr->fdMonitorRef, channelPtr);
+
+    le_dls_Queue(&servicePtr->directChannelList, &channelPtr->link);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event handler function called when a Service's directorySocketFd becomes readable.
  *
  * This means that the Service Directory has sent us the file descriptor of an authenticated
- * client connection socket.
+ * client connection socket, or of a Direct Channel.
  */
 //--------------------------------------------------------------------------------------------------
 static void DirectorySocketReadable
@@ -538,11 +811,14 @@ static void DirectorySocketReadable
     le_result_t result;
 
     int clientSocketFd;
+    svcdir_DirectChannelMsg_t msg;
+    size_t msgSize = sizeof(msg);
 
-    // Receive the Client connection file descriptor from the Service Directory.
+    // Receive the Client connection (or Direct Channel) file descriptor from the
+    // Service Directory.
     result = unixSocket_ReceiveMsg(servicePtr->directorySocketFd,
-                                   NULL,   // dataBuffPtr
-                                   0,      // dataBuffSize
+                                   &msg,
+                                   &msgSize,
                                    &clientSocketFd,
                                    NULL);  // credPtr
     if (result == LE_CLOSED)
@@ -568,17 +844,21 @@ static void DirectorySocketReadable
                  servicePtr->interface.id.name,
                  le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
     }
+    // Client connections come without any data.
+    else if (msgSize == 0)
+    {
+        OpenServerSideSession(servicePtr, clientSocketFd);
+    }
+    else if ((msgSize == sizeof(msg)) && (msg.magic == SVCDIR_DIRECT_CHANNEL_MAGIC))
+    {
+        CreateDirectChannel(servicePtr, clientSocketFd);
+    }
     else
     {
-        // Create a server-side Session object for that connection to this Service.
-        le_msg_SessionRef_t sessionRef = msgSession_CreateServerSideSession(servicePtr,
-                                                                            clientSocketFd);
-
-        // If successful, call the registered "open" handler, if there is one.
-        if (sessionRef != NULL)
-        {
-            CallOpenHandler(servicePtr, sessionRef);
-        }
+        LE_ERROR("Received unexpected message from Service Directory for (%s:%s).",
+                 servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+        fd_Close(clientSocketFd);
     }
 }
 
@@ -700,32 +980,121 @@ static void StartMonitoringDirectorySocket
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Close all sessions on a given Service object's list of open sessions.
+ * Gets one of a Service's sessions that is handled by the current thread.
+ *
+ * @return  The session, or NULL if there are none.
  */
 //--------------------------------------------------------------------------------------------------
-static void CloseAllSessions
+static le_msg_SessionRef_t GetSessionOfCurrentThread
 (
     msgInterface_Service_t* servicePtr
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_thread_Ref_t threadRef = le_thread_GetCurrent();
+    le_msg_SessionRef_t sessionRef = NULL;
+
     LOCK
 
-    for (;;)
+    le_dls_Link_t* linkPtr = le_dls_Peek(&servicePtr->interface.sessionList);
+
+    while (linkPtr != NULL)
     {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&servicePtr->interface.sessionList);
+        le_msg_SessionRef_t candidateRef = msgSession_GetSessionContainingLink(linkPtr);
 
-        if (linkPtr != NULL)
-        {
-            le_msg_DeleteSession(msgSession_GetSessionContainingLink(linkPtr));
-        }
-        else
+        if (msgSession_GetThreadRef(candidateRef) == threadRef)
         {
+            sessionRef = candidateRef;
             break;
         }
+
+        linkPtr = le_dls_PeekNext(&servicePtr->interface.sessionList, linkPtr);
     }
 
     UNLOCK
+
+    return sessionRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close all the sessions on a given Service object's list of open sessions that are handled by
+ * the current thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseAllSessions
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_SessionRef_t sessionRef;
+
+    // NOTE: The Mutex can't be held while deleting a session, because deleting it takes the Mutex
+    //       to remove it from the list (and calls the close handlers).
+    while ((sessionRef = GetSessionOfCurrentThread(servicePtr)) != NULL)
+    {
+        le_msg_DeleteSession(sessionRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close all the sessions of a Service that are handled by a worker thread, in that thread.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseWorkerSessions
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Service object.
+    void* param2Ptr     ///< [IN] Semaphore to post when done.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CloseAllSessions(param1Ptr);
+
+    le_sem_Post(param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the sessions handled by a Service's worker threads, and stop the threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopWorkerThreads
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (servicePtr->numWorkerThreads == 0)
+    {
+        return;
+    }
+
+    le_sem_Ref_t doneSemRef = le_sem_Create("MsgWorkerDone", 0);
+    size_t i;
+
+    for (i = 0; i < servicePtr->numWorkerThreads; i++)
+    {
+        le_event_QueueFunctionToThread(servicePtr->workerThreads[i],
+                                       CloseWorkerSessions,
+                                       servicePtr,
+                                       doneSemRef);
+        le_sem_Wait(doneSemRef);
+
+        le_thread_Cancel(servicePtr->workerThreads[i]);
+        servicePtr->workerThreads[i] = NULL;
+    }
+
+    le_sem_Delete(doneSemRef);
+
+    servicePtr->numWorkerThreads = 0;
+    servicePtr->nextWorkerIndex = 0;
 }
 
 
@@ -816,6 +1185,9 @@ void msgInterface_Init
     HandlerEventPoolRef = le_mem_CreatePool("HandlerEventPool", sizeof(SessionEventHandler_t));
     le_mem_ExpandPool(HandlerEventPoolRef, MAX_EXPECTED_SERVICES*6);
 
+    // Create the pool of Direct Channel objects.
+    DirectChannelPoolRef = le_mem_CreatePool("MessagingDirectChannels", sizeof(DirectChannel_t));
+
     // Create safe reference map for add references.
     HandlersRefMap = le_ref_CreateMap("HandlersRef", MAX_EXPECTED_SERVICES*6);
 
@@ -831,6 +1203,13 @@ void msgInterface_Init
                                               ComputeInterfaceIdHash,
                                               AreInterfaceIdsTheSame);
 
+    // Create the pool and map of Local Bindings.
+    LocalBindingPoolRef = le_mem_CreatePool("MessagingLocalBindings", sizeof(LocalBinding_t));
+    LocalBindingMapRef = le_hashmap_Create("MessagingLocalBindings",
+                                           MAX_EXPECTED_LOCAL_BINDINGS,
+                                           le_hashmap_HashString,
+                                           le_hashmap_EqualsString);
+
     // Create the key to be used to identify thread-local data records containing the Message
     // Reference when running a Service's message receive handler.
     int result = pthread_key_create(&ThreadLocalRxMsgKey, NULL);
@@ -866,6 +1245,123 @@ le_msg_ClientInterfaceRef_t msgInterface_GetClient
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binds a client interface to a service offered by the same process.  Sessions opened on that
+ * client interface while the service is advertised are opened locally, without going through the
+ * Service Directory or a socket.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_AddLocalBinding
+(
+    const char* clientIfName,   ///< [IN] Client interface name.
+    const char* serverIfName    ///< [IN] Name of the service, in this process, it is bound to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(   (strlen(clientIfName) >= LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+                || (strlen(serverIfName) >= LIMIT_MAX_IPC_INTERFACE_NAME_BYTES),
+                "Interface name too long in local binding '%s' -> '%s'.",
+                clientIfName,
+                serverIfName);
+
+    LOCK
+
+    // A client interface can only be bound once; a later binding replaces the earlier one.
+    LocalBinding_t* bindingPtr = le_hashmap_Get(LocalBindingMapRef, clientIfName);
+
+    if (bindingPtr == NULL)
+    {
+        bindingPtr = le_mem_ForceAlloc(LocalBindingPoolRef);
+        le_utf8_Copy(bindingPtr->clientIfName,
+                     clientIfName,
+                     sizeof(bindingPtr->clientIfName),
+                     NULL);
+        le_hashmap_Put(LocalBindingMapRef, bindingPtr->clientIfName, bindingPtr);
+    }
+
+    le_utf8_Copy(bindingPtr->serverIfName, serverIfName, sizeof(bindingPtr->serverIfName), NULL);
+
+    UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the service that a client interface is bound to locally, if that service is offered by a
+ * server thread in this process and is advertised.  Must be released using msgInterface_Release()
+ * when you are done with it.
+ *
+ * @return  Reference to the Service object, or NULL if the session must be opened through the
+ *          Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t msgInterface_GetLocalService
+(
+    le_msg_InterfaceRef_t   clientRef,      ///< [IN] Client interface.
+    le_thread_Ref_t*        serverThreadPtr ///< [OUT] Server thread of the service.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_Service_t* servicePtr = NULL;
+
+    LOCK
+
+    LocalBinding_t* bindingPtr = le_hashmap_Get(LocalBindingMapRef, clientRef->id.name);
+
+    if (bindingPtr != NULL)
+    {
+        // The service must have the same protocol as the client.
+        msgInterface_Id_t id;
+
+        id.protocolRef = clientRef->id.protocolRef;
+        le_utf8_Copy(id.name, bindingPtr->serverIfName, sizeof(id.name), NULL);
+
+        servicePtr = le_hashmap_Get(ServiceMapRef, &id);
+
+        if (   (servicePtr != NULL)
+            && (servicePtr->serverThread != NULL)
+            && (servicePtr->state != LE_MSG_INTERFACE_SERVICE_HIDDEN) )
+        {
+            le_mem_AddRef(servicePtr);
+            *serverThreadPtr = servicePtr->serverThread;
+        }
+        else
+        {
+            servicePtr = NULL;
+        }
+    }
+
+    UNLOCK
+
+    return servicePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a Service is still advertised by the calling thread.
+ *
+ * @return  true if it is, false if it has been hidden or deleted, or is served by another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_IsAdvertisedByCurrentThread
+(
+    le_msg_ServiceRef_t serviceRef  ///< [IN] Reference to the Service object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isAdvertised;
+
+    LOCK
+    isAdvertised = (   (serviceRef->serverThread == le_thread_GetCurrent())
+                    && (serviceRef->state != LE_MSG_INTERFACE_SERVICE_HIDDEN) );
+    UNLOCK
+
+    return isAdvertised;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the interface details for a given interface object.
@@ -960,6 +1456,24 @@ void msgInterface_RemoveSession
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a Service's registered session open handler functions, if there are any registered.
+ *
+ * @note    This only gets called by the server thread for the service.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_CallOpenHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CallOpenHandler(serviceRef, sessionRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Call a Service's registered session close handler function, if there is one registered.
@@ -1091,6 +1605,7 @@ void le_msg_DeleteService
     le_msg_HideService(serviceRef);
 
     // Close any remaining open sessions.
+    StopWorkerThreads(serviceRef);
     CloseAllSessions(serviceRef);
 
     // NOTE: Lock the mutex here to prevent a race between this thread dropping ownership
@@ -1253,6 +1768,61 @@ void le_msg_SetServiceRecvHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a set of worker threads for a service.  Sessions opened by clients after this is called
+ * are dispatched to the worker threads in turn, and each session's open handlers, message
+ * handlers and close handlers are all called in the worker thread that it was dispatched to.
+ *
+ * @note    This is a server-only function, which can only be called once per service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceWorkerThreads
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              numThreads  ///< [in] Number of worker threads
+                                    ///       (at most LE_MSG_MAX_SERVICE_WORKER_THREADS).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
+                "Service (%s:%s) not owned by calling thread.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF(serviceRef->numWorkerThreads != 0,
+                "Service (%s:%s) already has worker threads.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF((numThreads == 0) || (numThreads > LE_MSG_MAX_SERVICE_WORKER_THREADS),
+                "Invalid number of worker threads (%zu) for service (%s:%s).",
+                numThreads,
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    // Wait for each thread's Event Loop to be ready before anything is queued to it.
+    le_sem_Ref_t readySemRef = le_sem_Create("MsgWorkerReady", 0);
+    size_t i;
+
+    for (i = 0; i < numThreads; i++)
+    {
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+
+        snprintf(threadName, sizeof(threadName), "%.40s-%zu", serviceRef->interface.id.name, i);
+
+        serviceRef->workerThreads[i] = le_thread_Create(threadName, WorkerThreadMain, readySemRef);
+        le_thread_Start(serviceRef->workerThreads[i]);
+        le_sem_Wait(readySemRef);
+    }
+
+    le_sem_Delete(readySemRef);
+
+    serviceRef->nextWorkerIndex = 0;
+    serviceRef->numWorkerThreads = numThreads;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -1386,6 +1956,13 @@ void le_msg_HideService
     fd_Close(serviceRef->directorySocketFd);
     serviceRef->directorySocketFd = -1;
 
+    // Stop accepting connections from Direct Channels too.
+    le_dls_Link_t* linkPtr;
+    while (NULL != (linkPtr = le_dls_Peek(&serviceRef->directChannelList)))
+    {
+        DeleteDirectChannel(CONTAINER_OF(linkPtr, DirectChannel_t, link));
+    }
+
     serviceRef->state = LE_MSG_INTERFACE_SERVICE_HIDDEN;
 }
 
@@ -94,6 +94,15 @@ typedef struct le_msg_Service
 
     le_dls_List_t                   closeListPtr; ///< open List: list of close session handlers
                                                   ///  called when a session is opened
+
+    le_dls_List_t                   directChannelList; ///< List of Direct Channels that clients
+                                                       ///  open sessions through.
+
+    le_thread_Ref_t workerThreads[LE_MSG_MAX_SERVICE_WORKER_THREADS]; ///< Threads that
+                                        ///  sessions are dispatched to.
+    size_t          numWorkerThreads;   ///< Number of worker threads (0 = sessions are handled by
+                                        ///  the server thread).
+    size_t          nextWorkerIndex;    ///< Index of the worker thread that gets the next session.
 }
 msgInterface_Service_t;
 
@@ -183,6 +192,50 @@ le_msg_ClientInterfaceRef_t msgInterface_GetClient
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binds a client interface to a service offered by the same process.  Sessions opened on that
+ * client interface while the service is advertised are opened locally, without going through the
+ * Service Directory or a socket.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_AddLocalBinding
+(
+    const char* clientIfName,   ///< [IN] Client interface name.
+    const char* serverIfName    ///< [IN] Name of the service, in this process, it is bound to.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the service that a client interface is bound to locally, if that service is offered by a
+ * server thread in this process and is advertised.  Must be released using msgInterface_Release()
+ * when you are done with it.
+ *
+ * @return  Reference to the Service object, or NULL if the session must be opened through the
+ *          Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t msgInterface_GetLocalService
+(
+    le_msg_InterfaceRef_t   clientRef,      ///< [IN] Client interface.
+    le_thread_Ref_t*        serverThreadPtr ///< [OUT] Server thread of the service.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a Service is still advertised by the calling thread.
+ *
+ * @return  true if it is, false if it has been hidden or deleted, or is served by another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_IsAdvertisedByCurrentThread
+(
+    le_msg_ServiceRef_t serviceRef  ///< [IN] Reference to the Service object.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the interface details for a given interface object.
@@ -246,6 +299,20 @@ void msgInterface_RemoveSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a Service's registered session open handler functions, if there are any registered.
+ *
+ * @note    This only gets called by the server thread for the service.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_CallOpenHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Call a Service's registered session close handler function, if there is one registered.
@@ -15,10 +15,134 @@
 #include "fileDescriptor.h"
 #include "unixSocket.h"
 
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/// Workaround to memfd and file sealing definitions not being provided by older versions of
+/// the glibc.  Values are extracted from <linux/memfd.h> and <linux/fcntl.h>.
+#ifndef MFD_CLOEXEC
+# define MFD_CLOEXEC            0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+# define MFD_ALLOW_SEALING      0x0002U
+#endif
+#ifndef F_ADD_SEALS
+# define F_ADD_SEALS            (1024 + 9)
+# define F_GET_SEALS            (1024 + 10)
+# define F_SEAL_SEAL            0x0001
+# define F_SEAL_SHRINK          0x0002
+# define F_SEAL_GROW            0x0004
+# define F_SEAL_WRITE           0x0008
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seals that must be set on a shared buffer before it is sent, so that the receiver can be sure
+ * the contents won't change after it has checked them.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SHARED_BUFFER_SEALS (F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes sent ahead of the payload: the message flags and the transaction ID.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_SIZE (offsetof(Message_t, payload) - offsetof(Message_t, flags))
+
 // =======================================
 //  PRIVATE FUNCTIONS
 // =======================================
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a message ready to be sent: move the response fd into place, seal the shared buffer and
+ * clear the payload if nobody has looked at it.
+ *
+ * @return The file descriptor to send with the message (-1 if none).
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrepareToSend
+(
+    Message_t*  msgPtr      ///< The Message to be sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If this is a response message, and this isn't a retry,
+    if (le_msg_NeedsResponse(msgPtr) && !msgPtr->isSendPrepared)
+    {
+        // If there was an fd that was received from the client but not fetched from the message
+        // generate a warning and close that fd.
+        if (msgPtr->fd >= 0)
+        {
+            LE_WARN("File descriptor not retrieved from message received from client.");
+            fd_Close(msgPtr->fd);
+        }
+
+        // Move the responseFd to the normal fd position in the message object.
+        msgPtr->fd = msgPtr->clientServer.server.responseFd;
+        msgPtr->clientServer.server.responseFd = -1;
+    }
+
+    // If there is a shared buffer to send, then the sender can't write to it anymore.  Unmap it
+    // and seal it (this can be a retry, in which case that has already been done).  The memfd
+    // is sent in place of the message's fd, and is closed when the message is released.
+    int fd = msgPtr->fd;
+
+    if (msgPtr->sendBufFd >= 0)
+    {
+        if (msgPtr->sendBufPtr != NULL)
+        {
+            munmap(msgPtr->sendBufPtr, msgPtr->sendBufSize);
+            msgPtr->sendBufPtr = NULL;
+
+            if (fcntl(msgPtr->sendBufFd, F_ADD_SEALS, SHARED_BUFFER_SEALS) != 0)
+            {
+                LE_FATAL("Failed to seal shared buffer (%m).");
+            }
+        }
+
+        fd = msgPtr->sendBufFd;
+    }
+
+    // If nobody has looked at the payload, it hasn't been cleared yet.  Do that now, so that
+    // stale data left over in the pool block is never sent.
+    if (msgPtr->needsClearing)
+    {
+        memset(msgPtr->payload, 0, msgPtr->payloadSize);
+        msgPtr->needsClearing = false;
+    }
+
+    msgPtr->isSendPrepared = true;
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the part of a received message's payload that is past what was sent, so that a receiver
+ * that reads past the end of what was sent never sees stale data from the pool block.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetReceivedPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] Message object that was received.
+    size_t              payloadSize ///< [IN] Number of payload bytes that were sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxPayloadSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    memset((uint8_t*)msgRef->payload + payloadSize, 0, maxPayloadSize - payloadSize);
+
+    msgRef->payloadSize = payloadSize;
+    msgRef->needsClearing = false;
+    msgRef->isSendPrepared = false;
+    msgRef->isPayloadSizeSet = false;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor function for Message objects.
@@ -62,6 +186,26 @@ static void MessageDestructor
         fd_Close(msgPtr->fd);
     }
 
+    // Release any shared buffers.
+    if (msgPtr->sendBufPtr != NULL)
+    {
+        munmap(msgPtr->sendBufPtr, msgPtr->sendBufSize);
+    }
+    if (msgPtr->sendBufFd >= 0)
+    {
+        fd_Close(msgPtr->sendBufFd);
+    }
+    if (msgPtr->recvBufPtr != NULL)
+    {
+        munmap((void*)msgPtr->recvBufPtr, msgPtr->recvBufSize);
+    }
+
+    // Release the objects allocated from the message's arena.
+    if (msgPtr->arenaRef != NULL)
+    {
+        le_arena_Delete(msgPtr->arenaRef);
+    }
+
     // Release the Message object's hold on the Session object.
     le_mem_Release(msgPtr->sessionRef);
 }
@@ -142,32 +286,58 @@ le_result_t msgMessage_Send
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If this is a response message,
-    if (le_msg_NeedsResponse(msgPtr))
-    {
-        // If there was an fd that was received from the client but not fetched from the message
-        // generate a warning and close that fd.
-        if (msgPtr->fd >= 0)
-        {
-            LE_WARN("File descriptor not retrieved from message received from client.");
-            fd_Close(msgPtr->fd);
-        }
+    int fd = PrepareToSend(msgPtr);
 
-        // Move the responseFd to the normal fd position in the message object.
-        msgPtr->fd = msgPtr->clientServer.server.responseFd;
-        msgPtr->clientServer.server.responseFd = -1;
-    }
-
-    // The first bytes come from our transaction ID and the rest (if any)
-    // from our Message object's payload section, which comes right after the transaction ID.
+    // The first bytes come from our header (flags and transaction ID) and the rest (if any)
+    // from our Message object's payload section, which comes right after the header.
+    // Only the part of the payload that is in use is sent.
     return unixSocket_SendMsg(  socketFd,
-                                &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
-                                msgPtr->fd,
+                                &msgPtr->flags,
+                                HEADER_SIZE + msgPtr->payloadSize,
+                                fd,
                                 false   ); // Don't send process credentials.
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send several messages over a connected socket, using a single system call.
+ *
+ * If only some of the messages are sent, LE_OK is returned; sending the rest gives the reason.
+ *
+ * @return
+ * - LE_OK if successful (check numSentPtr).
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space for the first message.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int         socketFd,   ///< [IN] Connected socket's file descriptor.
+    Message_t** msgPtrs,    ///< [IN] Messages to be sent (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t      numMsgs,    ///< [IN] Number of messages.
+    size_t*     numSentPtr  ///< [OUT] Number of messages sent (the first ones).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_Msg_t msgs[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    // Same as msgMessage_Send(), for each message.
+    for (i = 0; i < numMsgs; i++)
+    {
+        msgs[i].fd = PrepareToSend(msgPtrs[i]);
+        msgs[i].dataPtr = &msgPtrs[i]->flags;
+        msgs[i].dataSize = HEADER_SIZE + msgPtrs[i]->payloadSize;
+    }
+
+    return unixSocket_SendMsgs(socketFd, msgs, numMsgs, numSentPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive a single message from a connected socket.
@@ -186,11 +356,11 @@ le_result_t msgMessage_Receive
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Receive the first bytes into our transaction ID and the rest (if any)
+    // Receive the first bytes into our header (flags and transaction ID) and the rest (if any)
     // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
+    size_t byteCount = HEADER_SIZE + le_msg_GetMaxPayloadSize(msgRef);
     le_result_t result = unixSocket_ReceiveMsg( socketFd,
-                                                &msgRef->txnId,
+                                                &msgRef->flags,
                                                 &byteCount,
                                                 &msgRef->fd,
                                                 NULL    );  // Don't receive credentials.
@@ -199,10 +369,145 @@ le_result_t msgMessage_Receive
         msgRef->clientServer.server.responseFd = -1;
     }
 
+    if (result == LE_OK)
+    {
+        // The sender may have sent only part of the payload.
+        size_t payloadSize = 0;
+
+        if (byteCount > HEADER_SIZE)
+        {
+            payloadSize = byteCount - HEADER_SIZE;
+        }
+
+        SetReceivedPayloadSize(msgRef, payloadSize);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive, without blocking, as many messages as are waiting on a connected socket, up to the
+ * number of Message objects given.
+ *
+ * The Message objects that received a message are moved to the start of the array, in the order
+ * received.  The others, including those that received a message too big for them, should be
+ * released.
+ *
+ * @return
+ * - LE_OK if successful (check numReceivedPtr, which can be zero).
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                  socketFd,  ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t* msgRefs,   ///< [IN+OUT] Message objects to store the messages in
+                                    ///  (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t               numMsgs,   ///< [IN] Number of Message objects.
+    size_t*              numReceivedPtr ///< [OUT] Number of messages received.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_Msg_t msgs[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t numMsgsReceived = 0;
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    // Same as msgMessage_Receive(), for each message.
+    for (i = 0; i < numMsgs; i++)
+    {
+        msgs[i].dataPtr = &msgRefs[i]->flags;
+        msgs[i].dataSize = HEADER_SIZE + le_msg_GetMaxPayloadSize(msgRefs[i]);
+
+        if (msgSession_GetInterfaceType(msgRefs[i]->sessionRef) == LE_MSG_INTERFACE_SERVER)
+        {
+            msgRefs[i]->clientServer.server.responseFd = -1;
+        }
+    }
+
+    *numReceivedPtr = 0;
+
+    le_result_t result = unixSocket_ReceiveMsgs(socketFd, msgs, numMsgs, &numMsgsReceived);
+
+    for (i = 0; i < numMsgsReceived; i++)
+    {
+        le_msg_MessageRef_t msgRef = msgRefs[i];
+
+        // The fd is closed when the message is released, if it's dropped.
+        msgRef->fd = msgs[i].fd;
+
+        if (msgs[i].isTruncated)
+        {
+            LE_WARN("Discarding message too big for protocol '%s'.",
+                    le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(msgRef->sessionRef)));
+            continue;
+        }
+
+        // The sender may have sent only part of the payload.
+        size_t payloadSize = 0;
+
+        if (msgs[i].dataSize > HEADER_SIZE)
+        {
+            payloadSize = msgs[i].dataSize - HEADER_SIZE;
+        }
+
+        SetReceivedPayloadSize(msgRef, payloadSize);
+
+        // Move it down over the dropped ones, if any.
+        msgRefs[i] = msgRefs[*numReceivedPtr];
+        msgRefs[*numReceivedPtr] = msgRef;
+        (*numReceivedPtr)++;
+    }
+
     return result;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transfer a single message to a message created for the other end of a local session (one whose
+ * client and server are in the same process).  This does what sending the message and receiving
+ * it at the other end would do, without the socket.  The file descriptor or shared buffer, if any,
+ * is moved to the other message.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_Transfer
+(
+    Message_t*          msgPtr,     ///< [IN] The Message to be sent.
+    le_msg_MessageRef_t destMsgRef  ///< [IN] Message object to store the transferred message in.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = PrepareToSend(msgPtr);
+
+    // Sending an fd gives the receiver its own copy, and the sender's is closed when its message
+    // is released.  In the same process, the fd can just change hands.
+    if (fd >= 0)
+    {
+        if (fd == msgPtr->sendBufFd)
+        {
+            msgPtr->sendBufFd = -1;
+        }
+        else
+        {
+            msgPtr->fd = -1;
+        }
+    }
+    destMsgRef->fd = fd;
+
+    destMsgRef->txnId = msgPtr->txnId;
+    destMsgRef->flags = msgPtr->flags;
+    memcpy(destMsgRef->payload, msgPtr->payload, msgPtr->payloadSize);
+
+    SetReceivedPayloadSize(destMsgRef, msgPtr->payloadSize);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Call the completion callback function for a given message, if it has one.
@@ -272,8 +577,21 @@ le_msg_MessageRef_t le_msg_CreateMsg
     }
 
     msgPtr->fd = -1;
+    msgPtr->sendBufFd = -1;
+    msgPtr->sendBufPtr = NULL;
+    msgPtr->sendBufSize = 0;
+    msgPtr->recvBufPtr = NULL;
+    msgPtr->recvBufSize = 0;
+    msgPtr->flags = 0;
     msgPtr->txnId = 0;
-    memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
+    msgPtr->arenaRef = NULL;
+
+    // The payload is cleared lazily, when it is first accessed (or sent), and then only as much
+    // of it as is in use.  See le_msg_SetPayloadSize().
+    msgPtr->payloadSize = le_msg_GetProtocolMaxMsgSize(protocolRef);
+    msgPtr->needsClearing = true;
+    msgPtr->isSendPrepared = false;
+    msgPtr->isPayloadSizeSet = false;
 
     return msgPtr;
 }
@@ -351,6 +669,12 @@ void* le_msg_GetPayloadPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (msgRef->needsClearing)
+    {
+        memset(msgRef->payload, 0, msgRef->payloadSize);
+        msgRef->needsClearing = false;
+    }
+
     return msgRef->payload;
 }
 
@@ -372,6 +696,66 @@ size_t le_msg_GetMaxPayloadSize
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload that are in use.  Only these are
+ * sent.  New messages start out with the whole payload in use.
+ *
+ * If this is called before the payload is first accessed using le_msg_GetPayloadPtr(), then only
+ * the given number of bytes will be cleared.  Bytes added to the payload by increasing its size
+ * after that are not cleared, so the caller must fill them in.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              size        ///< [in] Number of payload bytes in use.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    LE_FATAL_IF(size > maxSize, "Payload size %zu is larger than maximum (%zu).", size, maxSize);
+
+    msgRef->payloadSize = size;
+    msgRef->isPayloadSizeSet = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes at the start of the message payload that are in use.  For a received
+ * message, this is the number of payload bytes that were sent.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return msgRef->payloadSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks a message as high priority, so that it goes ahead of the normal messages waiting to be
+ * sent on the same session.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetHighPriority
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgRef->flags |= MSG_FLAG_HIGH_PRIORITY;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -391,6 +775,11 @@ void le_msg_SetFd
 {
     // If this is a message that is to be responded to, then store the fd in the "response fd"
     // field so that the fd field is still available to be read.
+    if (msgRef->sendBufFd >= 0)
+    {
+        LE_FATAL("Attempt to set a file descriptor on a message with a shared buffer.");
+    }
+
     if (le_msg_NeedsResponse(msgRef))
     {
         if (msgRef->clientServer.server.responseFd >= 0)
@@ -433,6 +822,155 @@ int le_msg_GetFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a shared memory buffer to be sent with this message, instead of copying a large amount
+ * of data through the message payload.
+ *
+ * The buffer is mapped into the caller's address space until the message is sent, at which point
+ * it is sealed against any further changes and passed to the receiver, which maps it read-only
+ * using le_msg_GetSharedBuffer().
+ *
+ * At most one shared buffer can be sent per message, and a message that has a shared buffer can't
+ * also have a file descriptor set using le_msg_SetFd().
+ *
+ * @return A pointer to the buffer, or NULL if shared buffers are not supported by the kernel or
+ *         the buffer could not be created (check your logs).
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_CreateSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              size        ///< [in] Size of the buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgRef->sendBufFd >= 0)
+    {
+        LE_FATAL("Attempt to create more than one shared buffer on the same message.");
+    }
+    // Note that on a request received by a server, the fd is the one received from the client.
+    int fdToSend = (le_msg_NeedsResponse(msgRef) ? msgRef->clientServer.server.responseFd
+                                                 : msgRef->fd);
+    if (fdToSend >= 0)
+    {
+        LE_FATAL("Attempt to create a shared buffer on a message with a file descriptor.");
+    }
+    LE_FATAL_IF(size == 0, "Shared buffer size can't be zero.");
+
+#ifdef __NR_memfd_create
+    int fd = syscall(__NR_memfd_create, "le_msg", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    int fd = -1;
+    errno = ENOSYS;
+#endif
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create shared buffer (%m).");
+        return NULL;
+    }
+
+    if (ftruncate(fd, size) != 0)
+    {
+        LE_ERROR("Failed to set shared buffer size to %zu (%m).", size);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    void* bufPtr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (bufPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map shared buffer of %zu bytes (%m).", size);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    msgRef->sendBufFd = fd;
+    msgRef->sendBufPtr = bufPtr;
+    msgRef->sendBufSize = size;
+
+    return bufPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the shared memory buffer received with this message.
+ *
+ * The buffer is mapped read-only, and remains mapped until the message is released.
+ *
+ * @return A pointer to the buffer, or NULL if no shared buffer was sent with this message (if an
+ *         ordinary file descriptor was sent instead, it can still be fetched using le_msg_GetFd()).
+ **/
+//--------------------------------------------------------------------------------------------------
+const void* le_msg_GetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t*             sizePtr     ///< [out] Size of the buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgRef->recvBufPtr == NULL)
+    {
+        int fd = msgRef->fd;
+        struct stat fdStat;
+
+        // Only accept memfds that have been sealed against changes, so that the sender can't
+        // modify the buffer while the receiver is using it.
+        if (   (fd < 0)
+            || ((fcntl(fd, F_GET_SEALS) & SHARED_BUFFER_SEALS) != SHARED_BUFFER_SEALS)
+            || (fstat(fd, &fdStat) != 0)
+            || (fdStat.st_size == 0) )
+        {
+            return NULL;
+        }
+
+        void* bufPtr = mmap(NULL, fdStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (bufPtr == MAP_FAILED)
+        {
+            LE_ERROR("Failed to map received shared buffer of %zu bytes (%m).",
+                     (size_t)fdStat.st_size);
+            return NULL;
+        }
+
+        // The mapping holds on to the buffer, so the fd isn't needed anymore.
+        fd_Close(fd);
+        msgRef->fd = -1;
+
+        msgRef->recvBufPtr = bufPtr;
+        msgRef->recvBufSize = fdStat.st_size;
+    }
+
+    *sizePtr = msgRef->recvBufSize;
+
+    return msgRef->recvBufPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an arena that belongs to a message, creating it the first time this is called for the
+ * message.  The arena is deleted, along with everything allocated from it, when the message is
+ * released (which, for a request message, happens once the response has been sent).
+ *
+ * @return Reference to the arena.
+ */
+//--------------------------------------------------------------------------------------------------
+le_arena_Ref_t le_msg_GetArena
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgRef->arenaRef == NULL)
+    {
+        msgRef->arenaRef = le_arena_Create();
+    }
+
+    return msgRef->arenaRef;
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -547,6 +1085,9 @@ le_msg_MessageRef_t le_msg_RequestSyncResponse
  * Takes a reference to the request message.  Copy the response payload (if any) into the
  * same payload buffer that held the request payload, then call le_msg_Respond().
  *
+ * Unless le_msg_SetPayloadSize() was called on the message since it was received, the whole
+ * payload is sent back, not just as much as the request used.
+ *
  * The messaging system will delete the message automatically when it has finished sending
  * the response.
  *
@@ -562,6 +1103,13 @@ void le_msg_Respond
     LE_FATAL_IF(!le_msg_NeedsResponse(msgRef),
                 "Attempt to respond to a message that doesn't need a response.");
 
+    // The request's size says nothing about the response written over it.  The part past what
+    // was received has been cleared, so sending it doesn't leak anything.
+    if (!msgRef->isPayloadSizeSet)
+    {
+        msgRef->payloadSize = le_msg_GetMaxPayloadSize(msgRef);
+    }
+
     // Send the response message.
     msgSession_SendMessage(msgRef->sessionRef, msgRef);
 }
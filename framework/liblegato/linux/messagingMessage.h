@@ -8,6 +8,14 @@
 #ifndef LEGATO_MESSAGING_MESSAGE_H_INCLUDE_GUARD
 #define LEGATO_MESSAGING_MESSAGE_H_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message header flags, sent along with the transaction ID.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_FLAG_HIGH_PRIORITY  0x1     ///< Goes ahead of normal messages (le_msg_SetHighPriority).
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a message.
@@ -41,6 +49,23 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    int                         sendBufFd;  ///< memfd of the shared buffer to send (-1 = none)
+    void*                       sendBufPtr; ///< Sender's mapping of the shared buffer to send
+                                            ///  (NULL = none, or sealed ready for sending).
+    size_t                      sendBufSize;///< Size of the shared buffer to send, in bytes.
+    const void*                 recvBufPtr; ///< Mapping of the shared buffer received (NULL = none)
+    size_t                      recvBufSize;///< Size of the shared buffer received, in bytes.
+    size_t                      payloadSize;///< Number of payload bytes in use (sent or received).
+    bool                        needsClearing;///< true = payload not cleared yet (new message).
+    bool                        isSendPrepared;///< true = got ready to send (send being retried).
+    bool                        isPayloadSizeSet;///< true = le_msg_SetPayloadSize() was called
+                                            ///  since the message was received.
+    le_clk_Time_t               queuedTime; ///< When it was put on the Transmit Queue.
+    le_arena_Ref_t              arenaRef;   ///< Arena returned by le_msg_GetArena() (NULL = none)
+
+    // NOTE: The header (flags and transaction ID) and the payload are sent and received as one
+    //       block, so nothing can go between them.
+    uintptr_t                   flags;      ///< MSG_FLAG_xxx flags.
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
@@ -90,6 +115,42 @@ le_result_t msgMessage_Send
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send several messages over a connected socket, using a single system call.
+ *
+ * If only some of the messages are sent, LE_OK is returned; sending the rest gives the reason.
+ *
+ * @return
+ * - LE_OK if successful (check numSentPtr).
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space for the first message.
+ * - LE_COMM_ERROR if the socket reported an error on the send operation.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int         socketFd,   ///< [IN] Connected socket's file descriptor.
+    Message_t** msgPtrs,    ///< [IN] Messages to be sent (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t      numMsgs,    ///< [IN] Number of messages.
+    size_t*     numSentPtr  ///< [OUT] Number of messages sent (the first ones).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transfer a single message to a message created for the other end of a local session (one whose
+ * client and server are in the same process).  This does what sending the message and receiving
+ * it at the other end would do, without the socket.  The file descriptor or shared buffer, if any,
+ * is moved to the other message.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_Transfer
+(
+    Message_t*          msgPtr,     ///< [IN] The Message to be sent.
+    le_msg_MessageRef_t destMsgRef  ///< [IN] Message object to store the transferred message in.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive a single message from a connected socket.
@@ -108,6 +169,32 @@ le_result_t msgMessage_Receive
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive, without blocking, as many messages as are waiting on a connected socket, up to the
+ * number of Message objects given.
+ *
+ * The Message objects that received a message are moved to the start of the array, in the order
+ * received.  The others, including those that received a message too big for them, should be
+ * released.
+ *
+ * @return
+ * - LE_OK if successful (check numReceivedPtr, which can be zero).
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                  socketFd,  ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t* msgRefs,   ///< [IN+OUT] Message objects to store the messages in
+                                    ///  (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t               numMsgs,   ///< [IN] Number of Message objects.
+    size_t*              numReceivedPtr ///< [OUT] Number of messages received.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the queue link inside a Message object.
@@ -158,6 +245,56 @@ static inline void msgMessage_SetTxnId
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a message is high priority (see le_msg_SetHighPriority()).
+ *
+ * @return true if high priority.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool msgMessage_IsHighPriority
+(
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ((msgRef->flags & MSG_FLAG_HIGH_PRIORITY) != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the time a message was put on a Transmit Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void msgMessage_SetQueuedTime
+(
+    le_msg_MessageRef_t msgRef,
+    le_clk_Time_t time
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgRef->queuedTime = time;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time a message was put on a Transmit Queue.
+ *
+ * @return The time recorded by msgMessage_SetQueuedTime().
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_clk_Time_t msgMessage_GetQueuedTime
+(
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return msgRef->queuedTime;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a Message object's transaction ID.
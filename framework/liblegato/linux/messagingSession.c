@@ -17,6 +17,7 @@
 #include "messagingProtocol.h"
 #include "messagingMessage.h"
 #include "fileDescriptor.h"
+#include "procStats.h"
 
 
 // =======================================
@@ -49,6 +50,57 @@ static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
 //--------------------------------------------------------------------------------------------------
 static le_log_TraceRef_t TraceRef;
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if client sessions should be opened through Direct Channels when possible (see
+ * @ref serviceDirectoryProtocol_DirectChannels).  Set from the LE_MSG_DIRECT_OPEN environment
+ * variable.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDirectOpenEnabled = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of client interfaces that we expect to keep Direct Channels for in the same process.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_EXPECTED_DIRECT_CHANNELS 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client-side Direct Channel object.  Keeps the client's end of a Direct Channel to the service
+ * that a client interface is bound to.  These are kept for as long as the channel stays
+ * usable, even after the client interface has no sessions left, so that reopening is cheap.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    msgInterface_Id_t   id;     ///< The client interface that the channel was set up for.
+    int                 fd;     ///< Client's end of the channel.
+}
+DirectChannel_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Direct Channel objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirectChannelPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of Direct Channel objects, keyed by client interface ID.
+ *
+ * @note    Because this is shared by multiple threads, it must be protected using the Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t DirectChannelMapRef;
+
 /// Macro used to generate trace output in this module.
 /// Takes the same parameters as LE_DEBUG() et. al.
 #define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
@@ -73,6 +125,40 @@ static le_mem_PoolRef_t SessionPoolRef;
 static le_ref_MapRef_t TxnMapRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Condition signalled, with the Mutex locked, when the response to a synchronous request on a
+ * local session arrives (or the session is closed by the server).
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_cond_t SyncResponseCond = PTHREAD_COND_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attempt to open a local session (one whose client and server are in the same process).  Passed
+ * from the client thread to the server thread, which creates the server-side Session object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    msgSession_Session_t*   clientPtr;  ///< Client-side Session object (holds a reference).
+    le_msg_ServiceRef_t     serviceRef; ///< Service that it's bound to (holds a reference).
+    le_sem_Ref_t            semRef;     ///< Posted when done if the client thread is waiting.
+    bool                    isAsync;    ///< true = the client thread isn't waiting; let it know
+                                        ///  by queueing a function to it.
+}
+LocalOpen_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Local Open objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LocalOpenPoolRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * A counter that increments every time a change is made to a session list in ANY interface obj.
@@ -87,6 +173,44 @@ static size_t* SessionObjListChangeCountRef = &SessionObjListChangeCount;
 // =======================================
 
 static void AttemptOpen(msgSession_Session_t* sessionPtr);
+static void PeerHangUp(void* param1Ptr, void* param2Ptr);
+static void TriggerDeferredProcessing(msgSession_Session_t* sessionPtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Transmit Queue a message goes on: high priority messages have their own, which is
+ * always sent first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_dls_List_t* GetTransmitQueue
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return msgMessage_IsHighPriority(msgRef) ? &sessionPtr->highTransmitQueue
+                                             : &sessionPtr->transmitQueue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether there's nothing waiting on either of the Transmit Queues.
+ *
+ * @return true if there's nothing to send.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsTransmitQueueEmpty
+(
+    msgSession_Session_t*   sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return le_dls_IsEmpty(&sessionPtr->highTransmitQueue)
+           && le_dls_IsEmpty(&sessionPtr->transmitQueue);
+}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -105,15 +229,23 @@ static void PushTransmitQueue
 {
     le_dls_Link_t* linkPtr = msgMessage_GetQueueLinkPtr(msgRef);
 
+    msgMessage_SetQueuedTime(msgRef, le_clk_GetRelativeTime());
+
     LOCK
-    le_dls_Queue(&sessionPtr->transmitQueue, linkPtr);
+    le_dls_Queue(GetTransmitQueue(sessionPtr, msgRef), linkPtr);
+    sessionPtr->stats.txQueueDepth++;
+    if (sessionPtr->stats.txQueueDepth > sessionPtr->stats.maxTxQueueDepth)
+    {
+        sessionPtr->stats.maxTxQueueDepth = sessionPtr->stats.txQueueDepth;
+    }
     UNLOCK
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pops a message off of the Transmit Queue.
+ * Pops a message off of the Transmit Queue, high priority messages first, and keeps track of how
+ * long messages wait there.
  *
  * @return A reference to the Message object that was popped from the queue, or NULL if the queue
  *         is empty.
@@ -129,16 +261,37 @@ static le_msg_MessageRef_t PopTransmitQueue
 {
     le_dls_Link_t* linkPtr;
 
+    uint32_t* maxWaitPtr = &sessionPtr->stats.maxHighTxWaitUs;
+
     LOCK
-    linkPtr = le_dls_Pop(&sessionPtr->transmitQueue);
+    linkPtr = le_dls_Pop(&sessionPtr->highTransmitQueue);
+    if (linkPtr == NULL)
+    {
+        linkPtr = le_dls_Pop(&sessionPtr->transmitQueue);
+        maxWaitPtr = &sessionPtr->stats.maxTxWaitUs;
+    }
+    if (linkPtr != NULL)
+    {
+        sessionPtr->stats.txQueueDepth--;
+    }
     UNLOCK
 
-    if (linkPtr != NULL)
+    if (linkPtr == NULL)
     {
-        return msgMessage_GetMessageContainingLink(linkPtr);
+        return NULL;
     }
 
-    return NULL;
+    le_msg_MessageRef_t msgRef = msgMessage_GetMessageContainingLink(linkPtr);
+
+    le_clk_Time_t wait = le_clk_Sub(le_clk_GetRelativeTime(), msgMessage_GetQueuedTime(msgRef));
+    uint64_t waitUs = (uint64_t)wait.sec * 1000000 + wait.usec;
+
+    if (waitUs > *maxWaitPtr)
+    {
+        *maxWaitPtr = (waitUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)waitUs;
+    }
+
+    return msgRef;
 }
 
 
@@ -159,14 +312,76 @@ static void UnPopTransmitQueue
     le_dls_Link_t* linkPtr = msgMessage_GetQueueLinkPtr(msgRef);
 
     LOCK
-    le_dls_Stack(&sessionPtr->transmitQueue, linkPtr);
+    le_dls_Stack(GetTransmitQueue(sessionPtr, msgRef), linkPtr);
+    sessionPtr->stats.txQueueDepth++;
     UNLOCK
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pushes a message onto the tail of the Receive Queue.
+ * Counts a message sent through a session in the session's statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CountSentMessage
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sessionPtr->stats.msgsSent++;
+    sessionPtr->stats.bytesSent += le_msg_GetPayloadSize(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a message received through a session in the session's statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CountReceivedMessage
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sessionPtr->stats.msgsReceived++;
+    sessionPtr->stats.bytesReceived += le_msg_GetPayloadSize(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a synchronous request-response transaction in the session's latency histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountSyncLatency
+(
+    msgSession_Session_t*   sessionPtr,
+    le_clk_Time_t           startTime   ///< [IN] Relative time at which the request was made.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    uint64_t usec = (uint64_t)elapsed.sec * 1000000 + elapsed.usec;
+    uint64_t limit = 100;
+    size_t i;
+
+    for (i = 0; (i < MSG_SESSION_LATENCY_BUCKETS - 1) && (usec >= limit); i++)
+    {
+        limit *= 10;
+    }
+
+    sessionPtr->stats.syncLatency[i]++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pushes a message onto the tail of the Receive Queue, or, if it's high priority, after the other
+ * high priority messages at the head of the queue.
  */
 //--------------------------------------------------------------------------------------------------
 static inline void PushReceiveQueue
@@ -176,7 +391,26 @@ static inline void PushReceiveQueue
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Queue(&sessionPtr->receiveQueue, msgMessage_GetQueueLinkPtr(msgRef));
+    le_dls_Link_t* linkPtr = msgMessage_GetQueueLinkPtr(msgRef);
+
+    if (msgMessage_IsHighPriority(msgRef))
+    {
+        le_dls_Link_t* nextLinkPtr = le_dls_Peek(&sessionPtr->receiveQueue);
+
+        while ((nextLinkPtr != NULL)
+               && msgMessage_IsHighPriority(msgMessage_GetMessageContainingLink(nextLinkPtr)))
+        {
+            nextLinkPtr = le_dls_PeekNext(&sessionPtr->receiveQueue, nextLinkPtr);
+        }
+
+        if (nextLinkPtr != NULL)
+        {
+            le_dls_AddBefore(&sessionPtr->receiveQueue, nextLinkPtr, linkPtr);
+            return;
+        }
+    }
+
+    le_dls_Queue(&sessionPtr->receiveQueue, linkPtr);
 }
 
 
@@ -438,6 +672,8 @@ static msgSession_Session_t* CreateSession
 
     sessionPtr->txnList = LE_DLS_LIST_INIT;
     sessionPtr->transmitQueue = LE_DLS_LIST_INIT;
+    sessionPtr->highTransmitQueue = LE_DLS_LIST_INIT;
+    sessionPtr->batchCount = 0;
     sessionPtr->receiveQueue = LE_DLS_LIST_INIT;
 
     sessionPtr->contextPtr = NULL;
@@ -448,15 +684,64 @@ static msgSession_Session_t* CreateSession
     sessionPtr->closeHandler = NULL;
     sessionPtr->closeContextPtr = NULL;
 
+    sessionPtr->isLocal = false;
+    sessionPtr->peerPtr = NULL;
+    sessionPtr->localOpenPtr = NULL;
+    sessionPtr->syncTxnId = NULL;
+    sessionPtr->syncResponseRef = NULL;
+
+    memset(&sessionPtr->stats, 0, sizeof(sessionPtr->stats));
+
     sessionPtr->interfaceRef = interfaceRef;
 
     SessionObjListChangeCount++;
     msgInterface_AddSession(interfaceRef, sessionPtr);
+    procStats_Add(PROCSTATS_SESSIONS, 1);
 
     return sessionPtr;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disconnects a local session from its other end, if it is connected, and tells the other end
+ * that the session has closed.  Also abandons any local open attempt in progress.
+ *
+ * @note    This is used on both the client side and the server side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DisconnectPeer
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    msgSession_Session_t* peerPtr = sessionPtr->peerPtr;
+
+    sessionPtr->peerPtr = NULL;
+    sessionPtr->localOpenPtr = NULL;
+
+    // If the client thread is blocked waiting for a response, it will never come.
+    if ((peerPtr != NULL) && (peerPtr->syncTxnId != NULL))
+    {
+        peerPtr->syncTxnId = NULL;
+        LE_ASSERT(pthread_cond_broadcast(&SyncResponseCond) == 0);
+    }
+
+    UNLOCK
+
+    // The hang-up is queued behind any messages already transferred to the other end.
+    // NOTE: The reference held by the peerPtr is passed on to the queued function.
+    if (peerPtr != NULL)
+    {
+        le_mem_AddRef(sessionPtr);
+        le_event_QueueFunctionToThread(peerPtr->threadRef, PeerHangUp, peerPtr, sessionPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Closes a session.
@@ -472,6 +757,8 @@ static void CloseSession
 {
     sessionPtr->state = LE_MSG_SESSION_STATE_CLOSED;
 
+    DisconnectPeer(sessionPtr);
+
     // Always notify the server on close.
     if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
     {
@@ -486,8 +773,12 @@ static void CloseSession
         le_fdMonitor_Delete(sessionPtr->fdMonitorRef);
         sessionPtr->fdMonitorRef = NULL;
     }
-    fd_Close(sessionPtr->socketFd);
-    sessionPtr->socketFd = -1;
+    if (sessionPtr->socketFd >= 0)
+    {
+        fd_Close(sessionPtr->socketFd);
+        sessionPtr->socketFd = -1;
+    }
+    sessionPtr->isLocal = false;
 
     // If there are any messages stranded on the transmit queue, the pending transaction list,
     // or the receive queue, clean them all up.
@@ -522,6 +813,7 @@ static void DeleteSession
     // Remove the Session from the Interface's Session List.
     SessionObjListChangeCount++;
     msgInterface_RemoveSession(sessionPtr->interfaceRef, sessionPtr);
+    procStats_Add(PROCSTATS_SESSIONS, -1);
 
     // Release the Session object itself.
     le_mem_Release(sessionPtr);
@@ -799,6 +1091,8 @@ static void ProcessReceivedMessages
     {
         le_msg_MessageRef_t msgRef = msgMessage_GetMessageContainingLink(linkPtr);
 
+        CountReceivedMessage(sessionPtr, msgRef);
+
         if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_CLIENT)
         {
             ProcessMessageFromServer(sessionPtr, msgRef);
@@ -911,25 +1205,53 @@ static void ReceiveMessages
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_msg_MessageRef_t msgRefs[UNIX_SOCKET_MAX_BATCH_MSGS];
+
+    // Start with a single message, and receive bigger batches while they keep coming back full,
+    // so that a burst is received with few system calls without creating many Message objects
+    // for every lone message.
+    size_t batchSize = 1;
+
     for (;;)
     {
-        // Create a Message object.
-        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
+        size_t numReceived;
+        size_t i;
+
+        // Create the Message objects.
+        for (i = 0; i < batchSize; i++)
+        {
+            msgRefs[i] = le_msg_CreateMsg(sessionPtr);
+        }
 
-        // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+        // Receive from the socket into the Message objects.
+        le_result_t result = msgMessage_ReceiveBatch(sessionPtr->socketFd,
+                                                     msgRefs,
+                                                     batchSize,
+                                                     &numReceived);
 
-        if (result == LE_OK)
+        // Push what was received onto the Receive Queue for later processing.
+        for (i = 0; i < batchSize; i++)
         {
-            // Received something.  Push it onto the Receive Queue for later processing.
-            PushReceiveQueue(sessionPtr, msgRef);
+            if ((result == LE_OK) && (i < numReceived))
+            {
+                PushReceiveQueue(sessionPtr, msgRefs[i]);
+            }
+            else
+            {
+                le_msg_ReleaseMsg(msgRefs[i]);
+            }
         }
-        else
+
+        if (result != LE_OK)
         {
             // Nothing left to receive from the socket.  We are done.
-            le_msg_ReleaseMsg(msgRef);
             break;
         }
+
+        if ((numReceived == batchSize) && (batchSize < UNIX_SOCKET_MAX_BATCH_MSGS))
+        {
+            batchSize *= 2;
+        }
     }
 }
 
@@ -982,108 +1304,374 @@ static void ServerSocketError
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Send messages from a session's Transmit Queue until either the socket becomes full or there
- * are no more messages waiting on the queue.
+ * Handles the other end of a local session closing the session, as if it had closed the socket.
+ *
+ * @warning The Session may have already been closed, reopened, or even deleted since the function
+ *          call was queued to the Event Queue.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
  */
 //--------------------------------------------------------------------------------------------------
-static void SendFromTransmitQueue
+static void PeerHangUp
 (
-    msgSession_Session_t* sessionPtr
+    void* param1Ptr,    ///< [IN] Pointer to the Session object (holds a reference).
+    void* param2Ptr     ///< [IN] Pointer to the other end's Session object (holds a reference).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    for (;;)
+    msgSession_Session_t* sessionPtr = param1Ptr;
+    msgSession_Session_t* closerPtr = param2Ptr;
+
+    LOCK
+    bool isConnected = (sessionPtr->peerPtr == closerPtr);
+    if (isConnected)
+    {
+        sessionPtr->peerPtr = NULL;
+    }
+    UNLOCK
+
+    if (isConnected)
     {
-        le_msg_MessageRef_t msgRef = PopTransmitQueue(sessionPtr);
+        le_mem_Release(closerPtr);
 
-        if (msgRef == NULL)
+        if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_CLIENT)
         {
-            // Since the Transmit Queue is empty, tell the FD Monitor that we don't need to be
-            // notified about writeability anymore.
-            DisableWriteabilityNotification(sessionPtr);
-            break;
+            ClientSocketHangUp(sessionPtr);
         }
-
-        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef);
-
-        switch (result)
+        else
         {
-            case LE_OK:
-                switch (sessionPtr->interfaceRef->interfaceType)
-                {
-                    // If this is the client side of the session,
-                    case LE_MSG_INTERFACE_CLIENT:
-                        // If a response is expected from the other side later, then put this
-                        // message on the Transaction List.
-                        if (msgMessage_GetTxnId(msgRef) != 0)
-                        {
-                            AddToTxnList(sessionPtr, msgRef);
-                        }
-                        // Otherwise, release it.
-                        else
-                        {
-                            le_msg_ReleaseMsg(msgRef);
-                        }
-
-                        break;
-
-                    // If this is the server side of the session,
-                    case LE_MSG_INTERFACE_SERVER:
-                        // Release the message, but first clear out the transaction ID so that
-                        // the message knows that it is not being deleted without a reponse message
-                        // being sent if one was expected.
-                        msgMessage_SetTxnId(msgRef, 0);
-                        le_msg_ReleaseMsg(msgRef);
-
-                        break;
-
-                    default:
-                        LE_FATAL("Unhandled interface type (%d)",
-                                 sessionPtr->interfaceRef->interfaceType);
-                }
-
-                break;  // Continue to loop around and send another.
-
-            case LE_NO_MEMORY:
-                // Have to wait for the socket to become writeable.  Put the message back on
-                // the head of the queue and ask the FD Monitor to tell us when the socket becomes
-                // writeable again.
-                UnPopTransmitQueue(sessionPtr, msgRef);
-                EnableWriteabilityNotification(sessionPtr);
-
-                return;
-
-            case LE_COMM_ERROR:
-                // In this case, we expect a handler function to be called by the FD Monitor,
-                // so we don't need to handle this case here.  However, we must stop
-                // trying to transmit now.  Stick the current message back on the Transmit Queue
-                // so it gets cleaned up with the others when the session closes.
-                UnPopTransmitQueue(sessionPtr, msgRef);
-
-                return;
-
-            default:
-                LE_FATAL("Unexpected return code %d.", result);
+            ServerSocketHangUp(sessionPtr);
         }
     }
+
+    le_mem_Release(closerPtr);
+    le_mem_Release(sessionPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Client-side handler for when a Session's socket becomes ready for reading (i.e., handle
- * an incoming message).
+ * Gets the other end of a local session.
+ *
+ * @return  The other end's Session object, with a reference that must be released, or NULL if the
+ *          session has been closed.
  */
 //--------------------------------------------------------------------------------------------------
-static void ClientSocketReadable
+static msgSession_Session_t* GetPeer
 (
     msgSession_Session_t* sessionPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    switch (sessionPtr->state)
-    {
-        case LE_MSG_SESSION_STATE_CLOSED:
+    LOCK
+
+    msgSession_Session_t* peerPtr = sessionPtr->peerPtr;
+
+    if (peerPtr != NULL)
+    {
+        le_mem_AddRef(peerPtr);
+    }
+
+    UNLOCK
+
+    return peerPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives a message transferred by the other end of a local session, as if it had arrived on
+ * the socket.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReceiveLocalMessage
+(
+    void* param1Ptr,    ///< [IN] The Message object.
+    void* param2Ptr     ///< [IN] Pointer to the sender's Session object (holds a reference).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t msgRef = param1Ptr;
+    msgSession_Session_t* senderPtr = param2Ptr;
+    msgSession_Session_t* sessionPtr = le_msg_GetSession(msgRef);
+
+    // Drop messages from an end that has since been disconnected.
+    LOCK
+    bool isConnected = (sessionPtr->peerPtr == senderPtr);
+    UNLOCK
+
+    if (isConnected && (sessionPtr->state == LE_MSG_SESSION_STATE_OPEN))
+    {
+        PushReceiveQueue(sessionPtr, msgRef);
+        ProcessReceivedMessages(sessionPtr);
+    }
+    else
+    {
+        le_msg_ReleaseMsg(msgRef);
+    }
+
+    le_mem_Release(senderPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transfers a message to the other end of a local session.
+ *
+ * If the other end is handled by another thread, the message is queued to it.  If it is handled
+ * by this thread, the message goes straight onto its Receive Queue, and is processed later, or
+ * right away if processNow is true.  A response that the client thread is blocked waiting for is
+ * handed to it directly.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_CLOSED if the other end has closed the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t TransferMessage
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef,
+    bool                    processNow
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* peerPtr = GetPeer(sessionPtr);
+
+    if (peerPtr == NULL)
+    {
+        return LE_CLOSED;
+    }
+
+    le_msg_MessageRef_t peerMsgRef = le_msg_CreateMsg(peerPtr);
+    msgMessage_Transfer(msgRef, peerMsgRef);
+
+    void* txnId = msgMessage_GetTxnId(peerMsgRef);
+    bool isSyncResponse = false;
+
+    LOCK
+    if ((txnId != NULL) && (peerPtr->syncTxnId == txnId))
+    {
+        peerPtr->syncResponseRef = peerMsgRef;
+        peerPtr->syncTxnId = NULL;
+        isSyncResponse = true;
+
+        LE_ASSERT(pthread_cond_broadcast(&SyncResponseCond) == 0);
+    }
+    UNLOCK
+
+    if (isSyncResponse)
+    {
+        // Handed over.
+    }
+    else if (peerPtr->threadRef == le_thread_GetCurrent())
+    {
+        if (processNow)
+        {
+            PushReceiveQueue(peerPtr, peerMsgRef);
+            ProcessReceivedMessages(peerPtr);
+        }
+        else
+        {
+            if (le_dls_IsEmpty(&peerPtr->receiveQueue))
+            {
+                TriggerDeferredProcessing(peerPtr);
+            }
+            PushReceiveQueue(peerPtr, peerMsgRef);
+        }
+    }
+    else
+    {
+        le_mem_AddRef(sessionPtr);
+        le_event_QueueFunctionToThread(peerPtr->threadRef,
+                                       ReceiveLocalMessage,
+                                       peerMsgRef,
+                                       sessionPtr);
+    }
+
+    le_mem_Release(peerPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes up with a message that has been sent (or transferred to the other end of a local
+ * session).
+ */
+//--------------------------------------------------------------------------------------------------
+static void MessageSent
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CountSentMessage(sessionPtr, msgRef);
+
+    switch (sessionPtr->interfaceRef->interfaceType)
+    {
+        // If this is the client side of the session,
+        case LE_MSG_INTERFACE_CLIENT:
+            // If a response is expected from the other side later, then put this
+            // message on the Transaction List.
+            if (msgMessage_GetTxnId(msgRef) != 0)
+            {
+                AddToTxnList(sessionPtr, msgRef);
+            }
+            // Otherwise, release it.
+            else
+            {
+                le_msg_ReleaseMsg(msgRef);
+            }
+
+            break;
+
+        // If this is the server side of the session,
+        case LE_MSG_INTERFACE_SERVER:
+            // Release the message, but first clear out the transaction ID so that
+            // the message knows that it is not being deleted without a reponse message
+            // being sent if one was expected.
+            msgMessage_SetTxnId(msgRef, 0);
+            le_msg_ReleaseMsg(msgRef);
+
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d)",
+                     sessionPtr->interfaceRef->interfaceType);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transfers all the messages on a local session's Transmit Queue to the other end.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TransferFromTransmitQueue
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t msgRef;
+
+    while (NULL != (msgRef = PopTransmitQueue(sessionPtr)))
+    {
+        if (TransferMessage(sessionPtr, msgRef, false) != LE_OK)
+        {
+            // The other end has closed the session.  Stick the message back on the Transmit
+            // Queue so it gets cleaned up with the others when the hang-up is handled.
+            UnPopTransmitQueue(sessionPtr, msgRef);
+
+            return;
+        }
+
+        MessageSent(sessionPtr, msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send messages from a session's Transmit Queue until either the socket becomes full or there
+ * are no more messages waiting on the queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendFromTransmitQueue
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (sessionPtr->isLocal)
+    {
+        TransferFromTransmitQueue(sessionPtr);
+        return;
+    }
+
+    for (;;)
+    {
+        le_msg_MessageRef_t msgRefs[UNIX_SOCKET_MAX_BATCH_MSGS];
+        le_msg_MessageRef_t msgRef;
+        size_t numMsgs = 0;
+        size_t numSent = 0;
+
+        // Pop as many messages as can be sent with one system call.
+        while ((numMsgs < NUM_ARRAY_MEMBERS(msgRefs))
+               && (NULL != (msgRef = PopTransmitQueue(sessionPtr))))
+        {
+            msgRefs[numMsgs++] = msgRef;
+        }
+
+        if (numMsgs == 0)
+        {
+            // Since the Transmit Queue is empty, tell the FD Monitor that we don't need to be
+            // notified about writeability anymore.
+            DisableWriteabilityNotification(sessionPtr);
+            break;
+        }
+
+        le_result_t result = msgMessage_SendBatch(sessionPtr->socketFd, msgRefs, numMsgs, &numSent);
+
+        size_t i;
+        for (i = 0; i < numSent; i++)
+        {
+            MessageSent(sessionPtr, msgRefs[i]);
+        }
+
+        // Put the messages that weren't sent back on the head of the queue, in order.
+        for (i = numMsgs; i > numSent; i--)
+        {
+            UnPopTransmitQueue(sessionPtr, msgRefs[i - 1]);
+        }
+
+        switch (result)
+        {
+            case LE_OK:
+                break;  // Continue to loop around and send the rest.
+
+            case LE_NO_MEMORY:
+                // Have to wait for the socket to become writeable.  Ask the FD Monitor to tell
+                // us when the socket becomes writeable again.
+                EnableWriteabilityNotification(sessionPtr);
+                sessionPtr->stats.writeStalls++;
+
+                return;
+
+            case LE_COMM_ERROR:
+                // In this case, we expect a handler function to be called by the FD Monitor,
+                // so we don't need to handle this case here.  However, we must stop
+                // trying to transmit now.  The messages left on the Transmit Queue get cleaned
+                // up with the others when the session closes.
+                return;
+
+            default:
+                LE_FATAL("Unexpected return code %d.", result);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client-side handler for when a Session's socket becomes ready for reading (i.e., handle
+ * an incoming message).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClientSocketReadable
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (sessionPtr->state)
+    {
+        case LE_MSG_SESSION_STATE_CLOSED:
             // This should never happen!
             LE_FATAL("Unexpected notification for a closed session!");
             break;
@@ -1288,10 +1876,190 @@ static void StartSocketMonitoring
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key hash function for the Direct Channel map.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashDirectChannelKey
+(
+    const void* keyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const msgInterface_Id_t* idPtr = keyPtr;
+
+    return le_hashmap_HashString(idPtr->name) ^ ((uintptr_t)idPtr->protocolRef >> 3);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key equality comparison function for the Direct Channel map.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AreDirectChannelKeysEqual
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const msgInterface_Id_t* firstIdPtr = firstKeyPtr;
+    const msgInterface_Id_t* secondIdPtr = secondKeyPtr;
+
+    return (   (firstIdPtr->protocolRef == secondIdPtr->protocolRef)
+            && le_hashmap_EqualsString(firstIdPtr->name, secondIdPtr->name) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a Direct Channel and deletes its object.
+ *
+ * @warning Assumes that the Mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropDirectChannel
+(
+    DirectChannel_t* channelPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TRACE("Dropping Direct Channel for interface (%s:%s).",
+          channelPtr->id.name,
+          le_msg_GetProtocolIdStr(channelPtr->id.protocolRef));
+
+    le_hashmap_Remove(DirectChannelMapRef, &channelPtr->id);
+
+    fd_Close(channelPtr->fd);
+    le_mem_Release(channelPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a Direct Channel for a client interface that doesn't have one yet, to be sent to the
+ * Service Directory with a session open request.  The client's end of the channel is kept in
+ * the Direct Channel map.
+ *
+ * @return  The fd of the server's end of the channel (to be closed by the caller after sending
+ *          it), or -1 if the interface already has a channel or the channel couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateDirectChannel
+(
+    le_msg_InterfaceRef_t interfaceRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int clientFd;
+    int serverFd = -1;
+
+    LOCK
+
+    if (   (le_hashmap_Get(DirectChannelMapRef, &interfaceRef->id) == NULL)
+        && (unixSocket_CreateSeqPacketPair(&clientFd, &serverFd) == LE_OK) )
+    {
+        DirectChannel_t* channelPtr = le_mem_ForceAlloc(DirectChannelPoolRef);
+
+        channelPtr->id = interfaceRef->id;
+
+        // Never block on the channel; sessions can always be opened through the Service
+        // Directory instead.
+        fd_SetNonBlocking(clientFd);
+        channelPtr->fd = clientFd;
+
+        le_hashmap_Put(DirectChannelMapRef, &channelPtr->id, channelPtr);
+    }
+
+    UNLOCK
+
+    return serverFd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an attempt to open a session by sending the server a new connection socket through the
+ * client interface's Direct Channel.
+ *
+ * If successful, leaves the other end of the new connection open and stores its file descriptor in
+ * the Session object.  The server will send its LE_OK "hello" message over it, or it will be
+ * closed if the server has gone away.  If the channel has been closed or revoked, it is dropped.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_UNAVAILABLE if the session must be opened through the Service Directory instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartDirectOpenAttempt
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_UNAVAILABLE;
+
+    LOCK
+
+    DirectChannel_t* channelPtr = le_hashmap_Get(DirectChannelMapRef,
+                                                 &sessionPtr->interfaceRef->id);
+    if (channelPtr != NULL)
+    {
+        struct pollfd pollFd = { .fd = channelPtr->fd, .events = 0 };
+
+        // A hang-up means the server has gone away or the Service Directory revoked the channel.
+        if ((poll(&pollFd, 1, 0) < 0) || (pollFd.revents & (POLLHUP | POLLERR)))
+        {
+            DropDirectChannel(channelPtr);
+        }
+        else
+        {
+            int localFd;
+            int remoteFd;
+
+            if (unixSocket_CreateSeqPacketPair(&localFd, &remoteFd) == LE_OK)
+            {
+                result = unixSocket_SendMsg(channelPtr->fd,
+                                            NULL,   // dataPtr
+                                            0,      // dataSize
+                                            remoteFd,
+                                            false); // sendCredentials
+                fd_Close(remoteFd);
+
+                if (result == LE_OK)
+                {
+                    sessionPtr->socketFd = localFd;
+                }
+                else
+                {
+                    fd_Close(localFd);
+
+                    // If the channel is just full, keep it for next time.
+                    if (result != LE_NO_MEMORY)
+                    {
+                        DropDirectChannel(channelPtr);
+                    }
+
+                    result = LE_UNAVAILABLE;
+                }
+            }
+        }
+    }
+
+    UNLOCK
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start an attempt to open a session by connecting to the Service Directory and sending it
- * a request to open a session.
+ * a request to open a session.  If Direct Channels are enabled, the session is opened through the
+ * client interface's Direct Channel instead, if it has one, or a Direct Channel is requested
+ * along with the session.
  *
  * If successful, puts the Session object in the OPENING state, leaves the connection socket open
  * and stores its file descriptor in the Session object.
@@ -1318,6 +2086,11 @@ static le_result_t StartSessionOpenAttempt
 {
     sessionPtr->state = LE_MSG_SESSION_STATE_OPENING;
 
+    if (IsDirectOpenEnabled && (StartDirectOpenAttempt(sessionPtr) == LE_OK))
+    {
+        return LE_OK;
+    }
+
     // Create a socket for the session.
     sessionPtr->socketFd = CreateSocket();
 
@@ -1330,8 +2103,23 @@ static le_result_t StartSessionOpenAttempt
         msgInterface_GetInterfaceDetails(sessionPtr->interfaceRef, &(msg.interface));
         msg.shouldWait = shouldWait;
 
-        // Send the request to the Service Directory.
-        result = unixSocket_SendDataMsg(sessionPtr->socketFd, &msg, sizeof(msg));
+        int channelFd = -1;
+        if (IsDirectOpenEnabled)
+        {
+            channelFd = CreateDirectChannel(sessionPtr->interfaceRef);
+        }
+
+        // Send the request to the Service Directory, along with the Direct Channel, if any.
+        result = unixSocket_SendMsg(sessionPtr->socketFd,
+                                    &msg,
+                                    sizeof(msg),
+                                    channelFd,
+                                    false); // sendCredentials
+        if (channelFd >= 0)
+        {
+            fd_Close(channelFd);
+        }
+
         if (result != LE_OK)
         {
             // NOTE: This is only done when the socket is newly opened, so this shouldn't ever
@@ -1341,27 +2129,270 @@ static le_result_t StartSessionOpenAttempt
                     result,
                     LE_RESULT_TXT(result));
 
-            result = LE_COMM_ERROR;
-        }
+            result = LE_COMM_ERROR;
+        }
+    }
+
+    // On failure, clean up.
+    if (result != LE_OK)
+    {
+        fd_Close(sessionPtr->socketFd);
+        sessionPtr->socketFd = -1;
+
+        sessionPtr->state = LE_MSG_SESSION_STATE_CLOSED;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attempts to open a connection to a service (via the Service Directory's client connection
+ * socket).
+ */
+//--------------------------------------------------------------------------------------------------
+static void AttemptServiceDirectoryOpen
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Start the session "Open" attempt.
+    if (StartSessionOpenAttempt(sessionPtr, true /* wait for binding or advertisement */ ) == LE_OK)
+    {
+        // Set the socket non-blocking.
+        fd_SetNonBlocking(sessionPtr->socketFd);
+
+        // Start monitoring for events on this socket.
+        StartSocketMonitoring(sessionPtr, ClientSocketEventHandler);
+
+        // NOTE: The next step will be for the server to send us an LE_OK "hello" message, or the
+        // connection will be closed if something goes wrong.
+    }
+    else
+    {
+        LE_FATAL("Unable to connect to the Service Directory.");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes an asynchronous attempt to open a local session, in the client thread.
+ *
+ * If the server side couldn't be created, the session is opened through the Service Directory
+ * instead.  Nothing is done if the client has closed the session in the meantime.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishLocalOpen
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Local Open object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LocalOpen_t* openPtr = param1Ptr;
+    msgSession_Session_t* sessionPtr = openPtr->clientPtr;
+
+    LOCK
+    bool isCurrent = (sessionPtr->localOpenPtr == openPtr);
+    if (isCurrent)
+    {
+        sessionPtr->localOpenPtr = NULL;
+    }
+    bool isConnected = (sessionPtr->peerPtr != NULL);
+    UNLOCK
+
+    if (isCurrent)
+    {
+        if (isConnected)
+        {
+            sessionPtr->isLocal = true;
+            sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
+
+            TRACE("Local session opened with service (%s:%s).",
+                  le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+                  le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(sessionPtr->interfaceRef)));
+
+            if (sessionPtr->openHandler != NULL)
+            {
+                sessionPtr->openHandler(sessionPtr, sessionPtr->openContextPtr);
+            }
+        }
+        else
+        {
+            AttemptServiceDirectoryOpen(sessionPtr);
+        }
+    }
+
+    msgInterface_Release((le_msg_InterfaceRef_t)openPtr->serviceRef);
+    le_mem_Release(sessionPtr);
+    le_mem_Release(openPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the server side of a local session, in the server thread, and connects it to the client
+ * side.
+ *
+ * The client side is left unconnected if the service is no longer advertised or the client has
+ * given up on the attempt in the meantime.
+ *
+ * @note    This function is called directly, or by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenLocalServerSession
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Local Open object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LocalOpen_t* openPtr = param1Ptr;
+    msgSession_Session_t* clientPtr = openPtr->clientPtr;
+    msgSession_Session_t* serverPtr = NULL;
+    bool isConnected = false;
+
+    if (msgInterface_IsAdvertisedByCurrentThread(openPtr->serviceRef))
+    {
+        serverPtr = CreateSession((le_msg_InterfaceRef_t)openPtr->serviceRef);
+        serverPtr->isLocal = true;
+
+        LOCK
+        if (clientPtr->localOpenPtr == openPtr)
+        {
+            // Each end holds a reference to the other until the session is closed.
+            le_mem_AddRef(clientPtr);
+            le_mem_AddRef(serverPtr);
+            serverPtr->peerPtr = clientPtr;
+            clientPtr->peerPtr = serverPtr;
+            serverPtr->state = LE_MSG_SESSION_STATE_OPEN;
+            isConnected = true;
+        }
+        UNLOCK
+
+        if (!isConnected)
+        {
+            // It was never opened, so no close handlers are called.
+            DeleteSession(serverPtr);
+        }
+    }
+
+    // Let the client side know before calling the server's open handler, so that anything the
+    // handler sends reaches the client after it has finished opening.
+    // NOTE: The Local Open object can't be used after this.
+    if (openPtr->isAsync)
+    {
+        le_event_QueueFunctionToThread(clientPtr->threadRef, FinishLocalOpen, openPtr, NULL);
+    }
+    else if (openPtr->semRef != NULL)
+    {
+        le_sem_Post(openPtr->semRef);
+    }
+
+    if (isConnected)
+    {
+        msgInterface_CallOpenHandler((le_msg_ServiceRef_t)serverPtr->interfaceRef, serverPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attempts to open a local session, with a server in this process that the client interface is
+ * bound to (see msg_AddLocalBinding()).
+ *
+ * If isAsync is true, this returns as soon as the attempt has been started, and the rest is done
+ * by FinishLocalOpen().  Otherwise, this blocks until the server thread has accepted or rejected
+ * the session, and updates the session state to either OPEN or CLOSED.
+ *
+ * @return
+ * - LE_OK if the session was opened (or the asynchronous attempt was started).
+ * - LE_UNAVAILABLE if there's no local server for the client interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenLocalSession
+(
+    msgSession_Session_t*   sessionPtr,
+    bool                    isAsync
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_thread_Ref_t serverThreadRef;
+    le_msg_ServiceRef_t serviceRef = msgInterface_GetLocalService(sessionPtr->interfaceRef,
+                                                                  &serverThreadRef);
+    if (serviceRef == NULL)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    sessionPtr->state = LE_MSG_SESSION_STATE_OPENING;
+
+    LocalOpen_t* openPtr = le_mem_ForceAlloc(LocalOpenPoolRef);
+    le_mem_AddRef(sessionPtr);
+    openPtr->clientPtr = sessionPtr;
+    openPtr->serviceRef = serviceRef;
+    openPtr->semRef = NULL;
+    openPtr->isAsync = isAsync;
+
+    LOCK
+    sessionPtr->localOpenPtr = openPtr;
+    UNLOCK
+
+    if (isAsync)
+    {
+        le_event_QueueFunctionToThread(serverThreadRef, OpenLocalServerSession, openPtr, NULL);
+
+        return LE_OK;
     }
 
-    // On failure, clean up.
-    if (result != LE_OK)
+    if (serverThreadRef == le_thread_GetCurrent())
     {
-        fd_Close(sessionPtr->socketFd);
-        sessionPtr->socketFd = -1;
+        OpenLocalServerSession(openPtr, NULL);
+    }
+    else
+    {
+        openPtr->semRef = le_sem_Create("MsgLocalOpen", 0);
+        le_event_QueueFunctionToThread(serverThreadRef, OpenLocalServerSession, openPtr, NULL);
+        le_sem_Wait(openPtr->semRef);
+        le_sem_Delete(openPtr->semRef);
+    }
+
+    LOCK
+    sessionPtr->localOpenPtr = NULL;
+    bool isConnected = (sessionPtr->peerPtr != NULL);
+    UNLOCK
+
+    msgInterface_Release((le_msg_InterfaceRef_t)serviceRef);
+    le_mem_Release(sessionPtr);
+    le_mem_Release(openPtr);
 
+    if (!isConnected)
+    {
         sessionPtr->state = LE_MSG_SESSION_STATE_CLOSED;
+
+        return LE_UNAVAILABLE;
     }
 
-    return result;
+    sessionPtr->isLocal = true;
+    sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
+
+    TRACE("Local session opened with service (%s:%s).",
+          le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+          le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(sessionPtr->interfaceRef)));
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Attempts to open a connection to a service (via the Service Directory's client connection
- * socket).
+ * Attempts to open a session, locally if the server is in this process, or else via the Service
+ * Directory.
  */
 //--------------------------------------------------------------------------------------------------
 static void AttemptOpen
@@ -1370,22 +2401,52 @@ static void AttemptOpen
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Start the session "Open" attempt.
-    if (StartSessionOpenAttempt(sessionPtr, true /* wait for binding or advertisement */ ) == LE_OK)
+    if (OpenLocalSession(sessionPtr, true) != LE_OK)
     {
-        // Set the socket non-blocking.
+        AttemptServiceDirectoryOpen(sessionPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completes a session "Open" attempt started by StartSessionOpenAttempt(), blocking until the
+ * response is received.
+ *
+ * Updates the session state to either OPEN or CLOSED, depending on the result.
+ *
+ * @return
+ * - LE_OK if the session was successfully opened.
+ * - LE_CLOSED if the attempt should be retried.
+ * - Anything else is an error returned by ReceiveSessionOpenResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FinishSessionOpenAttempt
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Block until a response is received.
+    le_result_t result = ReceiveSessionOpenResponse(sessionPtr);
+
+    // If a server accepted us,
+    if (result == LE_OK)
+    {
+        // Set the socket non-blocking for future operation.
         fd_SetNonBlocking(sessionPtr->socketFd);
 
         // Start monitoring for events on this socket.
         StartSocketMonitoring(sessionPtr, ClientSocketEventHandler);
 
-        // NOTE: The next step will be for the server to send us an LE_OK "hello" message, or the
-        // connection will be closed if something goes wrong.
+        sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
     }
     else
     {
-        LE_FATAL("Unable to connect to the Service Directory.");
+        CloseSession(sessionPtr);
     }
+
+    return result;
 }
 
 
@@ -1415,6 +2476,11 @@ static le_result_t AttemptOpenSync
 {
     le_result_t result;
 
+    if (OpenLocalSession(sessionPtr, false) == LE_OK)
+    {
+        return LE_OK;
+    }
+
     do
     {
         // Start the session "Open" attempt.
@@ -1422,24 +2488,7 @@ static le_result_t AttemptOpenSync
 
         if (result == LE_OK)
         {
-            // Block until a response is received.
-            result = ReceiveSessionOpenResponse(sessionPtr);
-
-            // If a server accepted us,
-            if (result == LE_OK)
-            {
-                // Set the socket non-blocking for future operation.
-                fd_SetNonBlocking(sessionPtr->socketFd);
-
-                // Start monitoring for events on this socket.
-                StartSocketMonitoring(sessionPtr, ClientSocketEventHandler);
-
-                sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
-            }
-            else
-            {
-                CloseSession(sessionPtr);
-            }
+            result = FinishSessionOpenAttempt(sessionPtr);
         }
 
     } while (result == LE_CLOSED);
@@ -1538,6 +2587,17 @@ void msgSession_Init
 
     // Get a reference to the trace keyword that is used to control tracing in this module.
     TraceRef = le_log_GetTraceRef("messaging");
+
+    const char* envStrPtr = getenv("LE_MSG_DIRECT_OPEN");
+    IsDirectOpenEnabled = ((envStrPtr != NULL) && (strcmp(envStrPtr, "1") == 0));
+
+    DirectChannelPoolRef = le_mem_CreatePool("DirectChannel", sizeof(DirectChannel_t));
+    DirectChannelMapRef = le_hashmap_CreateCompact("MsgDirectChannels",
+                                                   MAX_EXPECTED_DIRECT_CHANNELS,
+                                                   HashDirectChannelKey,
+                                                   AreDirectChannelKeysEqual);
+
+    LocalOpenPoolRef = le_mem_CreatePool("MsgLocalOpen", sizeof(LocalOpen_t));
 }
 
 
@@ -1575,9 +2635,33 @@ bool msgSession_IsOpen
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a message that another thread passed to the thread that handles the message's session.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendQueuedMessage
+(
+    void* param1Ptr,    ///< [IN] The Message object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t msgRef = param1Ptr;
+
+    msgSession_SendMessage(le_msg_GetSession(msgRef), msgRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a given Message object through a given Session.
+ *
+ * On the server side, a message sent by a thread other than the one handling the session (such as
+ * the service's server thread, for a session handled by a worker thread) is passed to the thread
+ * handling the session, which sends it.
  */
 //--------------------------------------------------------------------------------------------------
 void msgSession_SendMessage
@@ -1587,12 +2671,19 @@ void msgSession_SendMessage
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Only the thread that is handling events on this socket is allowed to send messages through
-    // this socket.  This prevents multi-threaded races.
-    /// @todo Allow other threads to send?
-    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
-                "Attempt to send by thread that doesn't own session '%s'.",
-                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+    if (le_thread_GetCurrent() != sessionRef->threadRef)
+    {
+        // Only the thread that is handling events on this socket is allowed to send messages
+        // through this socket.  This prevents multi-threaded races.
+        LE_FATAL_IF(sessionRef->interfaceRef->interfaceType != LE_MSG_INTERFACE_SERVER,
+                    "Attempt to send by thread that doesn't own session '%s'.",
+                    le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+        // NOTE: The message holds a reference to the session.
+        le_event_QueueFunctionToThread(sessionRef->threadRef, SendQueuedMessage, messageRef, NULL);
+
+        return;
+    }
 
     if (sessionRef->state != LE_MSG_SESSION_STATE_OPEN)
     {
@@ -1605,8 +2696,11 @@ void msgSession_SendMessage
         // Put the message on the Transmit Queue.
         PushTransmitQueue(sessionRef, messageRef);
 
-        // Try to send something from the Transmit Queue.
-        SendFromTransmitQueue(sessionRef);
+        // Try to send something from the Transmit Queue, unless messages are being batched.
+        if (sessionRef->batchCount == 0)
+        {
+            SendFromTransmitQueue(sessionRef);
+        }
     }
 }
 
@@ -1639,8 +2733,80 @@ void msgSession_RequestResponse
     // Put the message on the Transmit Queue.
     PushTransmitQueue(sessionRef, msgRef);
 
-    // Try to send something from the Transmit Queue.
-    SendFromTransmitQueue(sessionRef);
+    // Try to send something from the Transmit Queue, unless messages are being batched.
+    if (sessionRef->batchCount == 0)
+    {
+        SendFromTransmitQueue(sessionRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a synchronous request-response transaction on a local session.
+ *
+ * If the server is handled by this thread, the request is handled right away, and the server must
+ * respond to it before its handler returns.  Otherwise, this blocks until the server thread
+ * responds or the session closes.
+ *
+ * @return  The response message, or NULL if the session closed (or the server didn't respond).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t DoLocalSyncRequestResponse
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Anything still waiting on the Transmit Queue must go first.
+    if (!IsTransmitQueueEmpty(sessionPtr))
+    {
+        TransferFromTransmitQueue(sessionPtr);
+    }
+
+    LOCK
+    bool isSameThread = ((sessionPtr->peerPtr != NULL)
+                         && (sessionPtr->peerPtr->threadRef == sessionPtr->threadRef));
+    sessionPtr->syncTxnId = msgMessage_GetTxnId(msgRef);
+    sessionPtr->syncResponseRef = NULL;
+    UNLOCK
+
+    bool isAbandoned = false;
+
+    if (TransferMessage(sessionPtr, msgRef, isSameThread) == LE_OK)
+    {
+        CountSentMessage(sessionPtr, msgRef);
+
+        LOCK
+        if (isSameThread)
+        {
+            isAbandoned = (sessionPtr->syncTxnId != NULL);
+        }
+        else
+        {
+            while (sessionPtr->syncTxnId != NULL)
+            {
+                LE_ASSERT(pthread_cond_wait(&SyncResponseCond, &Mutex) == 0);
+            }
+        }
+        UNLOCK
+    }
+
+    LOCK
+    le_msg_MessageRef_t rxMsgRef = sessionPtr->syncResponseRef;
+    sessionPtr->syncResponseRef = NULL;
+    sessionPtr->syncTxnId = NULL;
+    UNLOCK
+
+    if (isAbandoned)
+    {
+        LE_ERROR("Server in the same thread didn't respond right away (%s:%s).",
+                 le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+                 le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(sessionPtr->interfaceRef)));
+    }
+
+    return rxMsgRef;
 }
 
 
@@ -1667,11 +2833,39 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // Create an ID for this transaction.
     CreateTxnId(msgRef);
 
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    if (sessionRef->isLocal)
+    {
+        rxMsgRef = DoLocalSyncRequestResponse(sessionRef, msgRef);
+
+        if (rxMsgRef != NULL)
+        {
+            CountReceivedMessage(sessionRef, rxMsgRef);
+            CountSyncLatency(sessionRef, startTime);
+        }
+
+        DeleteTxnId(msgRef);
+        le_msg_ReleaseMsg(msgRef);
+
+        return rxMsgRef;
+    }
+
     // Put the socket into blocking mode.
     fd_SetBlocking(sessionRef->socketFd);
 
+    // Anything still waiting on the Transmit Queue (e.g., because it is part of a batch) must go
+    // out first, so that the server sees the requests in the order they were made.
+    if (!IsTransmitQueueEmpty(sessionRef))
+    {
+        SendFromTransmitQueue(sessionRef);
+    }
+
     // Send the Request Message.
-    msgMessage_Send(sessionRef->socketFd, msgRef);
+    if (msgMessage_Send(sessionRef->socketFd, msgRef) == LE_OK)
+    {
+        CountSentMessage(sessionRef, msgRef);
+    }
 
     // While we have not yet received the response we are waiting for, keep
     // receiving messages.  Any that we receive that don't match the transaction ID
@@ -1695,6 +2889,8 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
         if (msgMessage_GetTxnId(rxMsgRef) == msgMessage_GetTxnId(msgRef))
         {
             // Got the synchronous response we were waiting for.
+            CountReceivedMessage(sessionRef, rxMsgRef);
+            CountSyncLatency(sessionRef, startTime);
             break;
         }
 
@@ -1742,6 +2938,23 @@ le_msg_InterfaceRef_t msgSession_GetInterfaceRef
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches a reference to the thread that handles a given Session object.
+ *
+ * @return  The thread reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_thread_Ref_t msgSession_GetThreadRef
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sessionRef->threadRef;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the list link inside of a Session object.  This is used to link the
@@ -2079,6 +3292,57 @@ le_result_t le_msg_TryOpenSessionSync
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronously open several sessions.  Blocks until all of them are open.
+ *
+ * Same as calling le_msg_OpenSessionSync() for each session, except that the "Open" requests are
+ * all sent before waiting for any of the responses, so the services are connected to in parallel
+ * instead of one after the other.
+ *
+ * This function logs a fatal error and terminates the calling process if unsuccessful.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_OpenSessionsSync
+(
+    le_msg_SessionRef_t*            sessionRefs,    ///< [in] Sessions (NULL entries are skipped).
+    size_t                          numSessions     ///< [in] Number of entries in sessionRefs.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    // Start all the "Open" attempts.  Failed ones are left CLOSED.
+    for (i = 0; i < numSessions; i++)
+    {
+        if ((sessionRefs[i] != NULL) && (OpenLocalSession(sessionRefs[i], false) != LE_OK))
+        {
+            StartSessionOpenAttempt(sessionRefs[i], true /* wait if necessary */ );
+        }
+    }
+
+    // Collect the responses, and fall back to opening the sessions that didn't make it one by one,
+    // which retries or reports the error.
+    for (i = 0; i < numSessions; i++)
+    {
+        if (sessionRefs[i] == NULL)
+        {
+            continue;
+        }
+
+        if (sessionRefs[i]->state == LE_MSG_SESSION_STATE_OPENING)
+        {
+            FinishSessionOpenAttempt(sessionRefs[i]);
+        }
+
+        if (sessionRefs[i]->state != LE_MSG_SESSION_STATE_OPEN)
+        {
+            le_msg_OpenSessionSync(sessionRefs[i]);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Terminates a session.
@@ -2102,6 +3366,62 @@ void le_msg_CloseSession
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of messages on a session.  Until the matching call to le_msg_EndBatch(), messages
+ * sent or requests started on the session using le_msg_Send() or le_msg_RequestResponse() are
+ * queued instead of being sent right away.
+ *
+ * Batches can be nested.  The queued messages are sent when the outermost batch ends.
+ *
+ * @note Only the thread that owns the session can do this.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_StartBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [in] Reference to the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
+                "Calling thread doesn't own the session '%s'.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    sessionRef->batchCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends a batch of messages started using le_msg_StartBatch().  If this ends the outermost batch,
+ * all the messages queued on the session are sent.
+ *
+ * @note Only the thread that owns the session can do this.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_EndBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [in] Reference to the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
+                "Calling thread doesn't own the session '%s'.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    LE_FATAL_IF(sessionRef->batchCount == 0,
+                "Batch ended on session '%s' without being started.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    sessionRef->batchCount--;
+
+    if ((sessionRef->batchCount == 0) && (sessionRef->state == LE_MSG_SESSION_STATE_OPEN))
+    {
+        SendFromTransmitQueue(sessionRef);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches a reference to the protocol that is being used for a given session.
@@ -2199,6 +3519,22 @@ le_result_t le_msg_GetClientUserCreds
         LE_FATAL("Server-side function called by client.");
     }
 
+    // The client of a local session is this process.
+    if (sessionRef->isLocal)
+    {
+        if (userIdPtr)
+        {
+            *userIdPtr = geteuid();
+        }
+
+        if (processIdPtr)
+        {
+            *processIdPtr = getpid();
+        }
+
+        return LE_OK;
+    }
+
     int result = getsockopt(sessionRef->socketFd, SOL_SOCKET, SO_PEERCRED, &credentials, &credSize);
 
     if (result == -1)
@@ -30,6 +30,44 @@ typedef enum
 msgSession_SessionState_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets in a session's synchronous request-response latency histogram.  Bucket 0
+ * counts transactions that took less than 100 microseconds, and each following bucket counts
+ * those that took up to ten times as long as the one before, except the last, which counts all
+ * the rest (100 milliseconds or more).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_SESSION_LATENCY_BUCKETS     5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics kept for a session, mainly for the Inspect tool.
+ *
+ * The counters are only changed by the thread that handles the session (the transmit queue ones
+ * with the Session module's mutex locked), so reading them from elsewhere can give a slightly
+ * stale but never a torn value.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t    msgsSent;           ///< Number of messages sent.
+    uint64_t    bytesSent;          ///< Number of payload bytes sent.
+    uint64_t    msgsReceived;       ///< Number of messages received.
+    uint64_t    bytesReceived;      ///< Number of payload bytes received.
+    uint32_t    txQueueDepth;       ///< Number of messages on the transmit queue.
+    uint32_t    maxTxQueueDepth;    ///< Highest number of messages ever on the transmit queue.
+    uint32_t    writeStalls;        ///< Number of times sending had to wait for the socket to
+                                    ///  become writeable.
+    uint32_t    maxTxWaitUs;        ///< Longest time a message waited on the transmit queue (us).
+    uint32_t    maxHighTxWaitUs;    ///< Same, for high priority messages.
+    uint32_t    syncLatency[MSG_SESSION_LATENCY_BUCKETS]; ///< Synchronous request-response
+                                    ///  latency histogram (see MSG_SESSION_LATENCY_BUCKETS).
+}
+msgSession_Stats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a client-server session.
@@ -50,6 +88,10 @@ typedef struct le_msg_Session
                                                     ///  sent and are waiting for their response.
 
     le_dls_List_t                   transmitQueue;  ///< Queue of messages waiting to be sent.
+    le_dls_List_t                   highTransmitQueue; ///< Queue of high priority messages
+                                                    ///  waiting to be sent (sent first).
+    size_t                          batchCount;     ///< Number of le_msg_StartBatch() calls not
+                                                    ///  yet matched by le_msg_EndBatch().
 
     le_dls_List_t                   receiveQueue;   ///< Queue of received messages waiting to be
                                                     /// processed.
@@ -61,6 +103,20 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+
+    // Local sessions (client and server in the same process) don't use the socket.  Messages are
+    // transferred straight to the other end's Session object.  The fields below that are shared
+    // with the other end's thread are protected by the Session module's mutex.
+
+    bool                            isLocal;        ///< true = local session.
+    struct le_msg_Session*          peerPtr;        ///< Other end of a local session, or NULL if
+                                                    ///  not connected (holds a reference).
+    void*                           localOpenPtr;   ///< Local open attempt in progress, or NULL.
+    void*                           syncTxnId;      ///< Txn ID of the synchronous request that the
+                                                    ///  client thread is waiting on, or NULL.
+    le_msg_MessageRef_t             syncResponseRef;///< Response to that synchronous request.
+
+    msgSession_Stats_t              stats;          ///< Statistics.
 }
 msgSession_Session_t;
 
@@ -163,6 +219,19 @@ le_msg_InterfaceRef_t msgSession_GetInterfaceRef
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches a reference to the thread that handles a given Session object.
+ *
+ * @return  The thread reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_thread_Ref_t msgSession_GetThreadRef
+(
+    le_msg_SessionRef_t sessionRef
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the list link inside of a Session object.  This is used to link the
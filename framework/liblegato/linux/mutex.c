@@ -27,6 +27,14 @@
  *    - Each Mutex object keeps track of its lock count.
  *  -# What type of mutex is a given mutex? (recursive?)
  *    - Stored in each Mutex object as a boolean flag.
+ *  -# How contended is a given mutex?
+ *    - Each Mutex object counts the times a thread had to wait for it, and for how long.
+ *
+ * The lock itself is a futex word in the Mutex object.  Taking a free mutex is a single atomic
+ * compare-and-swap, and releasing a mutex nobody waits for is a single atomic exchange: the kernel
+ * is only entered when a thread has to wait.  The waiting list (and its own pthreads mutex) is
+ * therefore only updated when the lock is contended, or for every lock when the "mutex" trace
+ * keyword is enabled.  A thread only ever appears on a waiting list while it is blocked anyway.
  *
  * Copyright (C) Sierra Wireless Inc.
  */
@@ -36,6 +44,9 @@
 #include "mutex.h"
 #include "thread.h"
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
 
 // ==============================
 //  PRIVATE DATA
@@ -84,6 +95,25 @@ static le_dls_List_t MutexList = LE_DLS_LIST_INIT;
 //--------------------------------------------------------------------------------------------------
 static pthread_mutex_t MutexListMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace reference used for controlling tracing in this module.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_log_TraceRef_t TraceRef;
+
+/// Macro used to generate trace output in this module.
+/// Takes the same parameters as LE_DEBUG() et. al.
+#define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
+
+/// Macro used to query current trace state in this module
+#define IS_TRACE_ENABLED LE_IS_TRACE_ENABLED(TraceRef)
+
+/// Values of a mutex's futex word.
+#define STATE_UNLOCKED  0   ///< Nobody holds the lock.
+#define STATE_LOCKED    1   ///< The lock is held, and nobody waits for it.
+#define STATE_CONTENDED 2   ///< The lock is held, and other threads may be waiting for it.
+
 
 // ==============================
 //  PRIVATE FUNCTIONS
@@ -105,6 +135,64 @@ static pthread_mutex_t MutexListMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
             LE_ASSERT(pthread_mutex_unlock(&(mutexPtr)->waitingListMutex) == 0)
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait on, or wake up threads waiting on, a mutex's futex word.
+ *
+ * @return The futex system call's result.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline long Futex
+(
+    int32_t*    statePtr,   ///< [in] Futex word.
+    int         op,         ///< [in] FUTEX_WAIT_PRIVATE or FUTEX_WAKE_PRIVATE.
+    int32_t     val         ///< [in] Expected value (wait) or number of threads to wake up.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return syscall(SYS_futex, statePtr, op, val, NULL, NULL, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a mutex's lock if it is free.
+ *
+ * @return true if the lock was taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool TryAcquire
+(
+    Mutex_t* mutexPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int32_t expected = STATE_UNLOCKED;
+
+    return __atomic_compare_exchange_n(&mutexPtr->state, &expected, STATE_LOCKED, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the calling thread holds a mutex's lock.
+ *
+ * Other threads only ever store themselves or NULL in the Mutex object, so this is reliable even
+ * though the lock isn't held while checking.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsHeldByCurrentThread
+(
+    Mutex_t*        mutexPtr,
+    le_thread_Ref_t currentThread
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (__atomic_load_n(&mutexPtr->lockingThreadRef, __ATOMIC_RELAXED) == currentThread);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a mutex.
@@ -130,31 +218,15 @@ le_mutex_Ref_t CreateMutex
     pthread_mutex_init(&mutexPtr->waitingListMutex, NULL);  // Default attributes = Fast mutex.
     mutexPtr->isRecursive = isRecursive;
     mutexPtr->lockCount = 0;
+    mutexPtr->state = STATE_UNLOCKED;
+    mutexPtr->contentionCount = 0;
+    mutexPtr->waitTimeUs = 0;
+    mutexPtr->maxWaitUs = 0;
     if (le_utf8_Copy(mutexPtr->name, nameStr, sizeof(mutexPtr->name), NULL) == LE_OVERFLOW)
     {
         LE_WARN("Mutex name '%s' truncated to '%s'.", nameStr, mutexPtr->name);
     }
 
-    // Initialize the underlying POSIX mutex according to whether the mutex is recursive or not.
-    pthread_mutexattr_t mutexAttrs;
-    pthread_mutexattr_init(&mutexAttrs);
-    int mutexType;
-    if (isRecursive)
-    {
-        mutexType = PTHREAD_MUTEX_RECURSIVE_NP;
-    }
-    else
-    {
-        mutexType = PTHREAD_MUTEX_ERRORCHECK_NP;
-    }
-    int result = pthread_mutexattr_settype(&mutexAttrs, mutexType);
-    if (result != 0)
-    {
-        LE_FATAL("Failed to set the mutex type to %d.  errno = %d (%m).", mutexType, errno);
-    }
-    pthread_mutex_init(&mutexPtr->mutex, &mutexAttrs);
-    pthread_mutexattr_destroy(&mutexAttrs);
-
     // Add the mutex to the process's Mutex List.
     LOCK_MUTEX_LIST();
     le_dls_Queue(&MutexList, &mutexPtr->mutexListLink);
@@ -233,7 +305,7 @@ static void MarkLocked
     le_dls_Stack(&perThreadRecPtr->lockedMutexList, &mutexPtr->lockedByThreadLink);
 
     // Record the current thread in the Mutex object as the thread that currently holds the lock.
-    mutexPtr->lockingThreadRef = le_thread_GetCurrent();
+    __atomic_store_n(&mutexPtr->lockingThreadRef, le_thread_GetCurrent(), __ATOMIC_RELAXED);
 }
 
 
@@ -262,7 +334,66 @@ static void MarkUnlocked
     le_dls_Remove(&perThreadRecPtr->lockedMutexList, &mutexPtr->lockedByThreadLink);
 
     // Record in the Mutex object that no thread currently holds the lock.
-    mutexPtr->lockingThreadRef = NULL;
+    __atomic_store_n(&mutexPtr->lockingThreadRef, NULL, __ATOMIC_RELAXED);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a mutex's lock the slow way: the thread is put on the mutex's waiting list and sleeps in
+ * the kernel until the lock is released.  The time spent waiting is added to the mutex's
+ * contention statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LockContended
+(
+    mutex_ThreadRec_t*  perThreadRecPtr,    ///< [in] Pointer to the thread's mutex info record.
+    Mutex_t*            mutexPtr            ///< [in] Pointer to the Mutex object to lock.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct timespec startTime;
+    struct timespec endTime;
+
+    AddToWaitingList(mutexPtr, perThreadRecPtr);
+
+    if (TryAcquire(mutexPtr))
+    {
+        // Only got here because tracing is enabled; the lock was free after all.
+        RemoveFromWaitingList(mutexPtr, perThreadRecPtr);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+    // Mark the lock contended, so that whoever releases it wakes a waiter up.  The futex wait
+    // returns at once if the word is no longer "contended", and may also return spuriously, so
+    // just try again until the word was found "unlocked".
+    while (__atomic_exchange_n(&mutexPtr->state, STATE_CONTENDED, __ATOMIC_ACQUIRE)
+           != STATE_UNLOCKED)
+    {
+        (void)Futex(&mutexPtr->state, FUTEX_WAIT_PRIVATE, STATE_CONTENDED);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+
+    RemoveFromWaitingList(mutexPtr, perThreadRecPtr);
+
+    // NOTE: the statistics are protected by the mutex itself.
+    uint64_t waitUs = (uint64_t)(endTime.tv_sec - startTime.tv_sec) * 1000000
+                      + (endTime.tv_nsec - startTime.tv_nsec) / 1000;
+    mutexPtr->contentionCount++;
+    mutexPtr->waitTimeUs += waitUs;
+    if (waitUs > mutexPtr->maxWaitUs)
+    {
+        mutexPtr->maxWaitUs = (waitUs > UINT32_MAX ? UINT32_MAX : waitUs);
+    }
+
+    TRACE("Thread '%s' waited %" PRIu64 " us for mutex '%s' (contended %" PRIu32 " times).",
+          le_thread_GetMyName(),
+          waitUs,
+          mutexPtr->name,
+          mutexPtr->contentionCount);
 }
 
 
@@ -334,6 +465,8 @@ void mutex_Init
 {
     MutexPoolRef = le_mem_CreatePool("mutex", sizeof(Mutex_t));
     le_mem_ExpandPool(MutexPoolRef, DEFAULT_POOL_SIZE);
+
+    TraceRef = le_log_GetTraceRef("mutex");
 }
 
 
@@ -420,10 +553,7 @@ void le_mutex_Delete
     le_dls_Remove(&MutexList, &mutexRef->mutexListLink);
     UNLOCK_MUTEX_LIST();
 
-    if (mutexRef->lockingThreadRef != NULL)
-
-    // Destroy the pthreads mutex.
-    if (pthread_mutex_destroy(&mutexRef->mutex) != 0)
+    if (__atomic_load_n(&mutexRef->state, __ATOMIC_RELAXED) != STATE_UNLOCKED)
     {
         char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
         le_thread_GetName(mutexRef->lockingThreadRef, threadName, sizeof(threadName));
@@ -448,49 +578,34 @@ void le_mutex_Lock
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int result;
-
-    mutex_ThreadRec_t* perThreadRecPtr = thread_GetMutexRecPtr();
-
-    AddToWaitingList(mutexRef, perThreadRecPtr);
-
-    result = pthread_mutex_lock(&mutexRef->mutex);
-
-    RemoveFromWaitingList(mutexRef, perThreadRecPtr);
+    le_thread_Ref_t currentThread = le_thread_GetCurrent();
 
-    if (result == 0)
+    if (IsHeldByCurrentThread(mutexRef, currentThread))
     {
-        // Got the lock!
-
-        // NOTE: the lock count is protected by the mutex itself.  That is, it can never be
-        //       updated by anyone who doesn't hold the lock on the mutex.
-
-        // If the mutex wasn't already locked by this thread before, we need to update
-        // the data structures to indicate that it now holds the lock.
-        if (mutexRef->lockCount == 0)
+        if (!mutexRef->isRecursive)
         {
-            MarkLocked(perThreadRecPtr, mutexRef);
+            LE_FATAL("DEADLOCK DETECTED! Thread '%s' attempting to re-lock mutex '%s'.",
+                     le_thread_GetMyName(),
+                     mutexRef->name);
         }
 
-        // Update the lock count.
+        // NOTE: the lock count is protected by the mutex itself.  That is, it can never be
+        //       updated by anyone who doesn't hold the lock on the mutex.
         mutexRef->lockCount++;
+        return;
     }
-    else
+
+    mutex_ThreadRec_t* perThreadRecPtr = thread_GetMutexRecPtr();
+
+    // Fast path: the lock is free, so no other thread needs to know this one wanted it.
+    if (IS_TRACE_ENABLED || !TryAcquire(mutexRef))
     {
-        if (result == EDEADLK)
-        {
-            LE_FATAL("DEADLOCK DETECTED! Thread '%s' attempting to re-lock mutex '%s'.",
-                     le_thread_GetMyName(),
-                     mutexRef->name);
-        }
-        else
-        {
-            LE_FATAL("Thread '%s' failed to lock mutex '%s'. Error code %d (%m).",
-                     le_thread_GetMyName(),
-                     mutexRef->name,
-                     result );
-        }
+        LockContended(perThreadRecPtr, mutexRef);
     }
+
+    // Got the lock!  Update the data structures to indicate that this thread now holds it.
+    MarkLocked(perThreadRecPtr, mutexRef);
+    mutexRef->lockCount = 1;
 }
 
 
@@ -511,37 +626,28 @@ le_result_t le_mutex_TryLock
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int result = pthread_mutex_trylock(&mutexRef->mutex);
-
-    if (result == 0)
+    if (IsHeldByCurrentThread(mutexRef, le_thread_GetCurrent()))
     {
-        // Got the lock!
-
-        // NOTE: the lock count is protected by the mutex itself.  That is, it can never be
-        //       updated by anyone who doesn't hold the lock on the mutex.
-
-        // If the mutex wasn't already locked by this thread before, we need to update
-        // the data structures to indicate that it now holds the lock.
-        if (mutexRef->lockCount == 0)
+        if (!mutexRef->isRecursive)
         {
-            MarkLocked(thread_GetMutexRecPtr(), mutexRef);
+            return LE_WOULD_BLOCK;
         }
 
-        // Update the lock count.
+        // NOTE: the lock count is protected by the mutex itself.  That is, it can never be
+        //       updated by anyone who doesn't hold the lock on the mutex.
         mutexRef->lockCount++;
+        return LE_OK;
     }
-    else if (result == EBUSY)
+
+    if (!TryAcquire(mutexRef))
     {
         // The mutex is already held by someone else.
         return LE_WOULD_BLOCK;
     }
-    else
-    {
-        LE_FATAL("Thread '%s' failed to trylock mutex '%s'. Error code %d (%m).",
-                 le_thread_GetMyName(),
-                 mutexRef->name,
-                 result );
-    }
+
+    // Got the lock!  Update the data structures to indicate that this thread now holds it.
+    MarkLocked(thread_GetMutexRecPtr(), mutexRef);
+    mutexRef->lockCount = 1;
 
     return LE_OK;
 }
@@ -558,8 +664,6 @@ void le_mutex_Unlock
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int result;
-
     le_thread_Ref_t lockingThread = mutexRef->lockingThreadRef;
     le_thread_Ref_t currentThread = le_thread_GetCurrent();
 
@@ -589,15 +693,13 @@ void le_mutex_Unlock
     if (mutexRef->lockCount == 0)
     {
         MarkUnlocked(mutexRef);
-    }
 
-    // Warning!  If the lock count is now zero, then as soon as we call this function another
-    // thread may grab the lock.
-    result = pthread_mutex_unlock(&mutexRef->mutex);
-    if (result != 0)
-    {
-        LE_FATAL("Failed to unlock mutex '%s'. Errno = %d (%m).",
-                 mutexRef->name,
-                 result );
+        // Warning!  As soon as the futex word is cleared, another thread may grab the lock.
+        // The kernel only needs to be entered if some thread may be waiting for it.
+        if (__atomic_exchange_n(&mutexRef->state, STATE_UNLOCKED, __ATOMIC_RELEASE)
+            == STATE_CONTENDED)
+        {
+            (void)Futex(&mutexRef->state, FUTEX_WAKE_PRIVATE, 1);
+        }
     }
 }
@@ -26,7 +26,11 @@ typedef struct le_mutex
     pthread_mutex_t     waitingListMutex;   ///< Pthreads mutex used to protect the waiting list.
     bool                isRecursive;        ///< true if recursive, false otherwise.
     int                 lockCount;      ///< Number of lock calls not yet matched by unlock calls.
-    pthread_mutex_t     mutex;          ///< Pthreads mutex that does the real work. :)
+    int32_t             state;          ///< Futex word: 0 = unlocked, 1 = locked,
+                                        ///  2 = locked and maybe waited on.
+    uint32_t            contentionCount;    ///< Number of times a thread had to wait for the lock.
+    uint64_t            waitTimeUs;         ///< Total time spent waiting for the lock (us).
+    uint32_t            maxWaitUs;          ///< Longest time spent waiting for the lock (us).
     char                name[MAX_NAME_BYTES]; ///< The name of the mutex (UTF8 string).
 }
 Mutex_t;
@@ -404,11 +404,60 @@ void pipeline_CreatePipe
 
     LE_FATAL_IF((pipe(fds) == -1), "Can't create pipe. errno: %d (%m)", errno);
 
+    // A bigger pipe lets the processes on either end of it (or the event loop feeding or draining
+    // it) move more data each time they're woken up.  It's only an optimization, so keep the
+    // default size if the system doesn't allow it.
+    pipeline_SetPipeSize(fds[1], PIPELINE_PIPE_BYTES);
+
     *readFdPtr = fds[0];
     *writeFdPtr = fds[1];
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the capacity of a pipe.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NOT_PERMITTED if the size is more than the system allows (see /proc/sys/fs/pipe-max-size).
+ * - LE_BUSY if the pipe holds more data than the new size.
+ * - LE_NOT_IMPLEMENTED if the kernel doesn't support changing pipe sizes.
+ * - LE_FAULT if fd isn't a pipe, or the capacity couldn't be changed for some other reason.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pipeline_SetPipeSize
+(
+    int fd,             ///< [in] Either end of the pipe.
+    size_t size         ///< [in] Capacity, in bytes.  Rounded up to a power-of-two number of pages.
+)
+//--------------------------------------------------------------------------------------------------
+{
+#ifdef F_SETPIPE_SZ
+    if (fcntl(fd, F_SETPIPE_SZ, (int)size) != -1)
+    {
+        return LE_OK;
+    }
+
+    LE_DEBUG("Can't set size of pipe %d to %zu bytes (%m).", fd, size);
+
+    switch (errno)
+    {
+        case EPERM:
+            return LE_NOT_PERMITTED;
+
+        case EBUSY:
+            return LE_BUSY;
+
+        default:
+            return LE_FAULT;
+    }
+#else
+    return LE_NOT_IMPLEMENTED;
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Move a file descriptor to a specific fd number.  Does nothing if src and dest are the same.
@@ -90,7 +90,10 @@
  * - pipeline_CreateOutputPipe() creates a pipe to be connected to the output of the last process
  *   in the pipeline.  Returns the read end for the caller to use to read data from the pipe.
  *
- * - pipeline_CreatePipe() can be used to create a pipe.  It's a simple wrapper around pipe().
+ * - pipeline_CreatePipe() can be used to create a pipe.  It's a simple wrapper around pipe() that
+ *   also grows the pipe to PIPELINE_PIPE_BYTES, like all the other pipes this API creates.
+ *
+ * - pipeline_SetPipeSize() changes the capacity of a pipe.
  *
  * - pipeline_Start() executes the processes in the pipeline.  A completion callback function is
  *   provided, which will be called when the pipeline terminates.
@@ -249,6 +252,16 @@ int pipeline_CreateOutputPipe
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capacity that the pipes created by this API are given, where the system allows it.  Bigger than
+ * the kernel's default of 64 KiB, so that the processes (and event handlers) at either end of a
+ * pipe wake up less often when large amounts of data go through it.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PIPELINE_PIPE_BYTES (256 * 1024)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a pipe.
@@ -261,6 +274,25 @@ void pipeline_CreatePipe
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the capacity of a pipe.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NOT_PERMITTED if the size is more than the system allows (see /proc/sys/fs/pipe-max-size).
+ * - LE_BUSY if the pipe holds more data than the new size.
+ * - LE_NOT_IMPLEMENTED if the kernel doesn't support changing pipe sizes.
+ * - LE_FAULT if fd isn't a pipe, or the capacity couldn't be changed for some other reason.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pipeline_SetPipeSize
+(
+    int fd,             ///< [in] Either end of the pipe.
+    size_t size         ///< [in] Capacity, in bytes.  Rounded up to a power-of-two number of pages.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pipeline termination handler functions must look like this.
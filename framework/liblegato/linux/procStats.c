@@ -0,0 +1,240 @@
+/** @file procStats.c
+ *
+ * Process statistics page.  See procStats.h for the design.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "procStats.h"
+
+
+// ==============================
+//  PRIVATE DATA
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The stats page.
+ */
+//--------------------------------------------------------------------------------------------------
+static procStats_Page_t Page;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit set for each pool slot that is taken, published or not.  Not part of the page.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t TakenBitmap[PROCSTATS_MAX_POOLS / 32];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock protecting TakenBitmap and the writer side of the page's sequence lock.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_spinlock_t Lock = LE_SPINLOCK_INIT;
+
+
+// ==============================
+//  PRIVATE FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the slot index of a pool object.
+ *
+ * @return The index, or -1 if the pool is not in the page.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetSlotIndex
+(
+    MemPool_t* poolPtr              ///< [IN] Pool object.
+)
+{
+    if ((poolPtr < &Page.pools[0]) || (poolPtr >= &Page.pools[PROCSTATS_MAX_POOLS]))
+    {
+        return -1;
+    }
+
+    return poolPtr - &Page.pools[0];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set or clear a slot's bit in the page's pool bitmap, under the sequence lock.
+ *
+ * @warning Must be called with the lock held.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPublished
+(
+    int index,                      ///< [IN] Slot index.
+    bool isPublished                ///< [IN] true to publish the slot, false to unpublish it.
+)
+{
+    uint32_t seq = Page.seq;
+    uint32_t bit = (uint32_t)1 << (index % 32);
+
+    __atomic_store_n(&Page.seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (isPublished)
+    {
+        Page.poolBitmap[index / 32] |= bit;
+    }
+    else
+    {
+        Page.poolBitmap[index / 32] &= ~bit;
+    }
+
+    __atomic_store_n(&Page.seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+
+// ==============================
+//  INTERNAL FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the stats page.
+ *
+ * Called by the framework library's constructor.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_Init
+(
+    void
+)
+{
+    Page.version = PROCSTATS_VERSION;
+    __atomic_store_n(&Page.magic, PROCSTATS_MAGIC, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stats page; mainly for the Inspect tool, which uses its address to find the page in
+ * other processes.
+ */
+//--------------------------------------------------------------------------------------------------
+procStats_Page_t* procStats_GetPage
+(
+    void
+)
+{
+    return &Page;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add to (or, with a negative delta, subtract from) one of the counters.  Safe to call from any
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_Add
+(
+    procStats_Counter_t counter,    ///< [IN] Counter to change.
+    int32_t delta                   ///< [IN] Amount to add.
+)
+{
+    __atomic_add_fetch(&Page.counters[counter], (uint32_t)delta, __ATOMIC_RELAXED);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a memory pool slot.  The slot is not visible in the page until procStats_PublishPool() is
+ * called on it.
+ *
+ * @return
+ *      The pool object, or NULL if all the slots are taken (the pool is then counted in the
+ *      PROCSTATS_UNLISTED_POOLS counter).
+ */
+//--------------------------------------------------------------------------------------------------
+MemPool_t* procStats_AllocPool
+(
+    void
+)
+{
+    int index;
+
+    le_spinlock_Lock(&Lock);
+
+    for (index = 0; index < PROCSTATS_MAX_POOLS; index++)
+    {
+        uint32_t bit = (uint32_t)1 << (index % 32);
+
+        if ((TakenBitmap[index / 32] & bit) == 0)
+        {
+            TakenBitmap[index / 32] |= bit;
+            break;
+        }
+    }
+
+    le_spinlock_Unlock(&Lock);
+
+    if (index == PROCSTATS_MAX_POOLS)
+    {
+        procStats_Add(PROCSTATS_UNLISTED_POOLS, 1);
+        return NULL;
+    }
+
+    return &Page.pools[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make an initialized pool visible in the page.  Does nothing if the pool is not in the page.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_PublishPool
+(
+    MemPool_t* poolPtr              ///< [IN] Pool object.
+)
+{
+    int index = GetSlotIndex(poolPtr);
+
+    if (index >= 0)
+    {
+        le_spinlock_Lock(&Lock);
+        SetPublished(index, true);
+        le_spinlock_Unlock(&Lock);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give back the slot of a pool that is being deleted.
+ *
+ * @return
+ *      true if the pool was in the page, false if it was allocated elsewhere (in which case it is
+ *      taken out of the PROCSTATS_UNLISTED_POOLS counter, and the caller must free it).
+ */
+//--------------------------------------------------------------------------------------------------
+bool procStats_ReleasePool
+(
+    MemPool_t* poolPtr              ///< [IN] Pool object.
+)
+{
+    int index = GetSlotIndex(poolPtr);
+
+    if (index < 0)
+    {
+        procStats_Add(PROCSTATS_UNLISTED_POOLS, -1);
+        return false;
+    }
+
+    le_spinlock_Lock(&Lock);
+    SetPublished(index, false);
+    TakenBitmap[index / 32] &= ~((uint32_t)1 << (index % 32));
+    le_spinlock_Unlock(&Lock);
+
+    return true;
+}
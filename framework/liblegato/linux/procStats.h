@@ -0,0 +1,175 @@
+/**
+ * @file procStats.h
+ *
+ * Process statistics page.
+ *
+ * Every process that uses the framework library keeps its statistics in a single structure, the
+ * "stats page", so that the Inspect tool can take a snapshot of them with a single read of
+ * /proc/<pid>/mem, instead of walking the framework's lists one remote pointer at a time.
+ *
+ * The page holds:
+ *  - The memory pool objects themselves (as long as there are free slots), so the pool counters
+ *    in the page are always current without adding any work to the allocation paths.  A pool
+ *    slot is published in the page's pool bitmap once its pool is initialized, and unpublished
+ *    before it's reused.
+ *  - Counters of threads, running timers, IPC sessions, etc., updated with atomic operations
+ *    where those objects are created and deleted.
+ *
+ * Publishing and unpublishing pool slots is done under a sequence lock: the page's sequence number
+ * is odd while the pool bitmap is being changed, and is incremented again once it's done.  So a
+ * reader that sees the same even sequence number before and after reading the page has a
+ * consistent view of the pool table.  The individual counters are not covered by the sequence
+ * lock (each one is always consistent on its own), so changing them never makes readers retry.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_PROC_STATS_INCLUDE_GUARD
+#define LEGATO_SRC_PROC_STATS_INCLUDE_GUARD
+
+#include "mem.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number found at the start of an initialized stats page.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROCSTATS_MAGIC             0x4c535450  // "PTSL"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the stats page layout.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROCSTATS_VERSION           1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of memory pool slots in the stats page.  Pools created once all the slots are taken are
+ * allocated elsewhere, and are only counted.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROCSTATS_MAX_POOLS         128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counters kept in the stats page.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PROCSTATS_THREADS,              ///< Legato threads.
+    PROCSTATS_RUNNING_TIMERS,       ///< Timers that are running.
+    PROCSTATS_RWLOCKS,              ///< Reader-writer locks.
+    PROCSTATS_SERVICES,             ///< IPC services (server-side interfaces).
+    PROCSTATS_CLIENT_INTERFACES,    ///< IPC client-side interfaces.
+    PROCSTATS_SESSIONS,             ///< IPC sessions.
+    PROCSTATS_UNLISTED_POOLS,       ///< Memory pools that didn't get a slot in the page.
+
+    PROCSTATS_COUNTER_COUNT         ///< Number of counters.  Not a counter.
+}
+procStats_Counter_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The stats page.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                                 ///< PROCSTATS_MAGIC once initialized.
+    uint32_t version;                               ///< PROCSTATS_VERSION.
+    uint32_t seq;                                   ///< Sequence number.  Odd during changes.
+    uint32_t counters[PROCSTATS_COUNTER_COUNT];     ///< Counters.
+    uint32_t poolBitmap[PROCSTATS_MAX_POOLS / 32];  ///< Bit set for each published pool slot.
+    MemPool_t pools[PROCSTATS_MAX_POOLS];           ///< Pool slots.
+}
+procStats_Page_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the stats page.
+ *
+ * Called by the framework library's constructor.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stats page; mainly for the Inspect tool, which uses its address to find the page in
+ * other processes.
+ */
+//--------------------------------------------------------------------------------------------------
+procStats_Page_t* procStats_GetPage
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add to (or, with a negative delta, subtract from) one of the counters.  Safe to call from any
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_Add
+(
+    procStats_Counter_t counter,    ///< [IN] Counter to change.
+    int32_t delta                   ///< [IN] Amount to add.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a memory pool slot.  The slot is not visible in the page until procStats_PublishPool() is
+ * called on it.
+ *
+ * @return
+ *      The pool object, or NULL if all the slots are taken (the pool is then counted in the
+ *      PROCSTATS_UNLISTED_POOLS counter).
+ */
+//--------------------------------------------------------------------------------------------------
+MemPool_t* procStats_AllocPool
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make an initialized pool visible in the page.  Does nothing if the pool is not in the page.
+ */
+//--------------------------------------------------------------------------------------------------
+void procStats_PublishPool
+(
+    MemPool_t* poolPtr              ///< [IN] Pool object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give back the slot of a pool that is being deleted.
+ *
+ * @return
+ *      true if the pool was in the page, false if it was allocated elsewhere (in which case it is
+ *      taken out of the PROCSTATS_UNLISTED_POOLS counter, and the caller must free it).
+ */
+//--------------------------------------------------------------------------------------------------
+bool procStats_ReleasePool
+(
+    MemPool_t* poolPtr              ///< [IN] Pool object.
+);
+
+
+#endif // LEGATO_SRC_PROC_STATS_INCLUDE_GUARD
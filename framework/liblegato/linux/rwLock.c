@@ -0,0 +1,665 @@
+/** @file rwLock.c
+ *
+ * Legato @ref c_rwLock implementation.
+ *
+ * Each reader-writer lock is represented by a <b> RwLock object </b>.  They are dynamically
+ * allocated from the <b> RwLock Pool </b> and are stored on the <b> RwLock List </b> until they are
+ * destroyed, so that the Inspect tool can find them.
+ *
+ * The lock itself is the @c state word of the RwLock object: its low bits count the readers that
+ * hold the lock, and two flags tell whether a writer holds the lock ("write-locked") and whether
+ * writers are waiting for it ("write-wanted").  A reader gets the lock by incrementing the
+ * number of readers, which it may only do while neither flag is set, with a single
+ * compare-and-swap.  A reader releases the lock with a single atomic decrement.
+ *
+ * Everything else happens under the object's Wait Mutex: writers taking and releasing the lock,
+ * and readers that have to wait.  Writers are expected to be rare, so this keeps the algorithm
+ * simple: a writer that has to wait raises the "write-wanted" flag (which stops new readers),
+ * and sleeps on the writers' condition variable until the readers are gone.  The last reader to
+ * leave while the flag is set wakes it up, and a writer releasing the lock hands it to the next
+ * waiting writer, or else wakes up all the waiting readers.
+ *
+ * Like for mutexes, each thread has a <b> Per-Thread RwLock Record </b>, kept in the Thread object
+ * inside the thread module and fetched through a call to thread_GetRwLockRecPtr().  It holds the
+ * lock that the thread is waiting on (if any) and the list of locks the thread holds for writing.
+ * Threads waiting for a lock are also kept on that lock's waiting list.  None of this is updated
+ * when a read lock is taken without waiting.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "rwLock.h"
+#include "procStats.h"
+#include "thread.h"
+
+
+// ==============================
+//  PRIVATE DATA
+// ==============================
+
+/// Number of objects in the RwLock Pool to start with.
+#define DEFAULT_POOL_SIZE 4
+
+/// Bits of the state word counting the readers that hold the lock.
+#define STATE_READERS_MASK  0x3FFFFFFFu
+
+/// Flag of the state word set while a writer holds the lock.
+#define STATE_WRITE_LOCKED  0x40000000u
+
+/// Flag of the state word set while writers wait for the lock.  New readers wait when it is set.
+#define STATE_WRITE_WANTED  0x80000000u
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A counter that increments every time a change is made to the RwLock list.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t RwLockListChangeCount = 0;
+static size_t* RwLockListChangeCountRef = &RwLockListChangeCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RwLock Pool.
+ *
+ * Memory pool from which RwLock objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RwLockPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RwLock List.
+ *
+ * List on which all RwLock objects in the process are kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t RwLockList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RwLock List Mutex.
+ *
+ * Basic pthreads mutex used to protect the RwLock List from multi-threaded race conditions.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t RwLockListMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ==============================
+//  PRIVATE FUNCTIONS
+// ==============================
+
+/// Lock the RwLock List Mutex.
+#define LOCK_RWLOCK_LIST()   LE_ASSERT(pthread_mutex_lock(&RwLockListMutex) == 0)
+
+/// Unlock the RwLock List Mutex.
+#define UNLOCK_RWLOCK_LIST() LE_ASSERT(pthread_mutex_unlock(&RwLockListMutex) == 0)
+
+
+/// Lock a RwLock's Wait Mutex.
+#define LOCK_WAIT_MUTEX(rwLockPtr) \
+            LE_ASSERT(pthread_mutex_lock(&(rwLockPtr)->waitMutex) == 0)
+
+/// Unlock a RwLock's Wait Mutex.
+#define UNLOCK_WAIT_MUTEX(rwLockPtr) \
+            LE_ASSERT(pthread_mutex_unlock(&(rwLockPtr)->waitMutex) == 0)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the read lock if neither a writer holds the lock nor writers wait for it.
+ *
+ * @return true if the read lock was taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool TryAcquireRead
+(
+    RwLock_t* rwLockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t state = __atomic_load_n(&rwLockPtr->state, __ATOMIC_RELAXED);
+
+    while ((state & (STATE_WRITE_LOCKED | STATE_WRITE_WANTED)) == 0)
+    {
+        LE_FATAL_IF((state & STATE_READERS_MASK) == STATE_READERS_MASK,
+                    "Too many readers on lock '%s'.",
+                    rwLockPtr->name);
+
+        if (__atomic_compare_exchange_n(&rwLockPtr->state, &state, state + 1, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the write lock if nobody holds the lock.  The "write-wanted" flag is left as it is.
+ *
+ * @return true if the write lock was taken.
+ *
+ * @warning Assumes that the calling thread holds the lock's Wait Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TryAcquireWrite
+(
+    RwLock_t* rwLockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t state = __atomic_load_n(&rwLockPtr->state, __ATOMIC_RELAXED);
+
+    // Readers may still come and go while the "write-wanted" flag is clear.
+    while ((state & (STATE_READERS_MASK | STATE_WRITE_LOCKED)) == 0)
+    {
+        if (__atomic_compare_exchange_n(&rwLockPtr->state, &state, state | STATE_WRITE_LOCKED,
+                                        true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a thread's RwLock Record to a RwLock object's waiting list.
+ *
+ * @warning Assumes that the calling thread holds the lock's Wait Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToWaitingList
+(
+    RwLock_t*           rwLockPtr,
+    rwlock_ThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    perThreadRecPtr->waitingOnRwLock = rwLockPtr;
+    le_dls_Queue(&rwLockPtr->waitingList, &perThreadRecPtr->waitingListLink);
+    rwLockPtr->contentionCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a thread's RwLock Record from a RwLock object's waiting list.
+ *
+ * @warning Assumes that the calling thread holds the lock's Wait Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFromWaitingList
+(
+    RwLock_t*           rwLockPtr,
+    rwlock_ThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&rwLockPtr->waitingList, &perThreadRecPtr->waitingListLink);
+    perThreadRecPtr->waitingOnRwLock = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kill the process if the calling thread holds the write lock of a lock it is about to wait for.
+ *
+ * @warning Assumes that the calling thread holds the lock's Wait Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDeadlock
+(
+    RwLock_t* rwLockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (rwLockPtr->writingThreadRef == le_thread_GetCurrent())
+    {
+        LE_FATAL("DEADLOCK DETECTED! Thread '%s' attempting to re-lock lock '%s'.",
+                 le_thread_GetMyName(),
+                 rwLockPtr->name);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a lock "write-locked" by the calling thread.
+ *
+ * @warning Assumes that the calling thread holds the lock's Wait Mutex and the write lock.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MarkWriteLocked
+(
+    RwLock_t* rwLockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    rwlock_ThreadRec_t* perThreadRecPtr = thread_GetRwLockRecPtr();
+
+    le_dls_Stack(&perThreadRecPtr->lockedRwLockList, &rwLockPtr->lockedByThreadLink);
+    rwLockPtr->writingThreadRef = le_thread_GetCurrent();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The thread is dying.  Make sure no locks are write-locked by it.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ThreadDeathCleanUp
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    rwlock_ThreadRec_t* perThreadRecPtr = contextPtr;
+
+    if (le_dls_IsEmpty(&perThreadRecPtr->lockedRwLockList) == false)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&perThreadRecPtr->lockedRwLockList);
+        while (linkPtr != NULL)
+        {
+            RwLock_t* rwLockPtr = CONTAINER_OF(linkPtr, RwLock_t, lockedByThreadLink);
+
+            LE_EMERG("Thread died while holding write lock '%s'.", rwLockPtr->name);
+
+            linkPtr = le_dls_PeekNext(&perThreadRecPtr->lockedRwLockList, linkPtr);
+        }
+        LE_FATAL("Killing process to prevent future deadlock.");
+    }
+}
+
+
+// ==============================
+//  INTRA-FRAMEWORK FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the reader-writer lock list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* rwlock_GetRwLockList
+(
+    void
+)
+{
+    return (&RwLockList);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the reader-writer lock list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** rwlock_GetRwLockListChgCntRef
+(
+    void
+)
+{
+    return (&RwLockListChangeCountRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Reader-Writer Lock module.
+ *
+ * This function must be called exactly once at process start-up before any other rwLock module
+ * functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void rwlock_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RwLockPoolRef = le_mem_CreatePool("rwLock", sizeof(RwLock_t));
+    le_mem_ExpandPool(RwLockPoolRef, DEFAULT_POOL_SIZE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread-specific parts of the Reader-Writer Lock module.
+ *
+ * This function must be called once by each thread when it starts, before any other rwLock module
+ * functions are called by that thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void rwlock_ThreadInit
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    rwlock_ThreadRec_t* perThreadRecPtr = thread_GetRwLockRecPtr();
+
+    perThreadRecPtr->waitingOnRwLock = NULL;
+    perThreadRecPtr->lockedRwLockList = LE_DLS_LIST_INIT;
+    perThreadRecPtr->waitingListLink = LE_DLS_LINK_INIT;
+
+    // Register a thread destructor function to check that everything has been cleaned up properly.
+    (void)le_thread_AddDestructor(ThreadDeathCleanUp, perThreadRecPtr);
+}
+
+
+// ==============================
+//  PUBLIC API FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a Reader-Writer lock.
+ *
+ * @return  Returns a reference to the lock.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_rwlock_Ref_t le_rwlock_Create
+(
+    const char* nameStr     ///< [in] Name of the lock
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RwLock_t* rwLockPtr = le_mem_ForceAlloc(RwLockPoolRef);
+
+    rwLockPtr->rwLockListLink = LE_DLS_LINK_INIT;
+    rwLockPtr->writingThreadRef = NULL;
+    rwLockPtr->lockedByThreadLink = LE_DLS_LINK_INIT;
+    rwLockPtr->state = 0;
+    pthread_mutex_init(&rwLockPtr->waitMutex, NULL);  // Default attributes = Fast mutex.
+    pthread_cond_init(&rwLockPtr->readersCond, NULL);
+    pthread_cond_init(&rwLockPtr->writersCond, NULL);
+    rwLockPtr->waitingReaders = 0;
+    rwLockPtr->waitingWriters = 0;
+    rwLockPtr->waitingList = LE_DLS_LIST_INIT;
+    rwLockPtr->contentionCount = 0;
+    if (le_utf8_Copy(rwLockPtr->name, nameStr, sizeof(rwLockPtr->name), NULL) == LE_OVERFLOW)
+    {
+        LE_WARN("Lock name '%s' truncated to '%s'.", nameStr, rwLockPtr->name);
+    }
+
+    // Add the lock to the process's RwLock List.
+    LOCK_RWLOCK_LIST();
+    le_dls_Queue(&RwLockList, &rwLockPtr->rwLockListLink);
+    RwLockListChangeCount++;
+    procStats_Add(PROCSTATS_RWLOCKS, 1);
+    UNLOCK_RWLOCK_LIST();
+
+    return rwLockPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_Delete
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t state = __atomic_load_n(&lockRef->state, __ATOMIC_RELAXED);
+
+    if (state & STATE_WRITE_LOCKED)
+    {
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+        le_thread_GetName(lockRef->writingThreadRef, threadName, sizeof(threadName));
+        LE_FATAL("Lock '%s' deleted while still write-locked by thread '%s'!",
+                 lockRef->name,
+                 threadName);
+    }
+    LE_FATAL_IF(state != 0,
+                "Lock '%s' deleted while still read-locked by %" PRIu32 " threads!",
+                lockRef->name,
+                state & STATE_READERS_MASK);
+
+    // Remove the RwLock object from the RwLock List.
+    LOCK_RWLOCK_LIST();
+    le_dls_Remove(&RwLockList, &lockRef->rwLockListLink);
+    RwLockListChangeCount++;
+    procStats_Add(PROCSTATS_RWLOCKS, -1);
+    UNLOCK_RWLOCK_LIST();
+
+    pthread_cond_destroy(&lockRef->writersCond);
+    pthread_cond_destroy(&lockRef->readersCond);
+    pthread_mutex_destroy(&lockRef->waitMutex);
+
+    // Release the RwLock object back to the RwLock Pool.
+    le_mem_Release(lockRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a Reader-Writer lock for reading.  Waits while a thread holds, or waits for, the write
+ * lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_ReadLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Fast path: no writer around, nobody needs to know about this reader.
+    if (TryAcquireRead(lockRef))
+    {
+        return;
+    }
+
+    rwlock_ThreadRec_t* perThreadRecPtr = thread_GetRwLockRecPtr();
+
+    LOCK_WAIT_MUTEX(lockRef);
+
+    if (!TryAcquireRead(lockRef))
+    {
+        CheckDeadlock(lockRef);
+
+        lockRef->waitingReaders++;
+        AddToWaitingList(lockRef, perThreadRecPtr);
+
+        // The flags can only be set (and cleared) by writers holding the Wait Mutex, so the
+        // readers can't miss the broadcast that tells them the flags are clear.
+        do
+        {
+            LE_ASSERT(pthread_cond_wait(&lockRef->readersCond, &lockRef->waitMutex) == 0);
+        }
+        while (!TryAcquireRead(lockRef));
+
+        RemoveFromWaitingList(lockRef, perThreadRecPtr);
+        lockRef->waitingReaders--;
+    }
+
+    UNLOCK_WAIT_MUTEX(lockRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a Reader-Writer lock for reading.
+ *
+ * @return
+ *  - LE_OK if the lock was taken for reading.
+ *  - LE_WOULD_BLOCK if a thread holds, or waits for, the write lock.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_rwlock_TryReadLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (TryAcquireRead(lockRef) ? LE_OK : LE_WOULD_BLOCK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a read lock on a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_ReadUnlock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t state = __atomic_fetch_sub(&lockRef->state, 1, __ATOMIC_RELEASE);
+
+    LE_FATAL_IF((state & STATE_READERS_MASK) == 0,
+                "Lock '%s' read-unlocked too many times!",
+                lockRef->name);
+
+    // If this was the last reader a writer is waiting for, wake the writer up.  The writer raised
+    // the flag before checking the number of readers, while holding the Wait Mutex, so it is
+    // either about to see that there are no readers left, or already waiting for the signal.
+    if (((state & STATE_READERS_MASK) == 1) && (state & STATE_WRITE_WANTED))
+    {
+        LOCK_WAIT_MUTEX(lockRef);
+        LE_ASSERT(pthread_cond_signal(&lockRef->writersCond) == 0);
+        UNLOCK_WAIT_MUTEX(lockRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a Reader-Writer lock for writing.  Waits until no other thread holds the lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_WriteLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK_WAIT_MUTEX(lockRef);
+
+    CheckDeadlock(lockRef);
+
+    if (!TryAcquireWrite(lockRef))
+    {
+        rwlock_ThreadRec_t* perThreadRecPtr = thread_GetRwLockRecPtr();
+
+        // Stop new readers before checking for readers again, so that the last one leaving can't
+        // be missed.
+        lockRef->waitingWriters++;
+        __atomic_fetch_or(&lockRef->state, STATE_WRITE_WANTED, __ATOMIC_RELAXED);
+        AddToWaitingList(lockRef, perThreadRecPtr);
+
+        while (!TryAcquireWrite(lockRef))
+        {
+            LE_ASSERT(pthread_cond_wait(&lockRef->writersCond, &lockRef->waitMutex) == 0);
+        }
+
+        RemoveFromWaitingList(lockRef, perThreadRecPtr);
+
+        // Let the readers in again once the last waiting writer is done.
+        lockRef->waitingWriters--;
+        if (lockRef->waitingWriters == 0)
+        {
+            __atomic_fetch_and(&lockRef->state, ~STATE_WRITE_WANTED, __ATOMIC_RELAXED);
+        }
+    }
+
+    MarkWriteLocked(lockRef);
+
+    UNLOCK_WAIT_MUTEX(lockRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a Reader-Writer lock for writing.
+ *
+ * @return
+ *  - LE_OK if the lock was taken for writing.
+ *  - LE_WOULD_BLOCK if the lock is held by someone.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_rwlock_TryWriteLock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_WOULD_BLOCK;
+
+    LOCK_WAIT_MUTEX(lockRef);
+
+    if (TryAcquireWrite(lockRef))
+    {
+        MarkWriteLocked(lockRef);
+        result = LE_OK;
+    }
+
+    UNLOCK_WAIT_MUTEX(lockRef);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the write lock on a Reader-Writer lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rwlock_WriteUnlock
+(
+    le_rwlock_Ref_t    lockRef   ///< [in] Lock reference
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK_WAIT_MUTEX(lockRef);
+
+    // Make sure that the current thread is the one holding the write lock.
+    if (lockRef->writingThreadRef != le_thread_GetCurrent())
+    {
+        if (lockRef->writingThreadRef == NULL)
+        {
+            LE_FATAL("Lock '%s' write-unlocked while not write-locked!", lockRef->name);
+        }
+
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+        le_thread_GetName(lockRef->writingThreadRef, threadName, sizeof(threadName));
+        LE_FATAL("Attempt to write-unlock lock '%s' held by other thread '%s'.",
+                 lockRef->name,
+                 threadName);
+    }
+
+    le_dls_Remove(&thread_GetRwLockRecPtr()->lockedRwLockList, &lockRef->lockedByThreadLink);
+    lockRef->writingThreadRef = NULL;
+
+    __atomic_fetch_and(&lockRef->state, ~STATE_WRITE_LOCKED, __ATOMIC_RELEASE);
+
+    // Writers first: the readers only get the lock when no writer wants it.
+    if (lockRef->waitingWriters > 0)
+    {
+        LE_ASSERT(pthread_cond_signal(&lockRef->writersCond) == 0);
+    }
+    else if (lockRef->waitingReaders > 0)
+    {
+        LE_ASSERT(pthread_cond_broadcast(&lockRef->readersCond) == 0);
+    }
+
+    UNLOCK_WAIT_MUTEX(lockRef);
+}
@@ -0,0 +1,109 @@
+/** @file rwLock.h
+ *
+ * Reader-Writer Lock module's intra-framework header file.  This file exposes type definitions
+ * and function interfaces to other modules inside the framework implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_RWLOCK_H_INCLUDE_GUARD
+#define LEGATO_SRC_RWLOCK_H_INCLUDE_GUARD
+
+/// Maximum number of bytes in a reader-writer lock name (including null terminator).
+#define RWLOCK_MAX_NAME_BYTES 24
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reader-Writer Lock object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_rwlock
+{
+    le_dls_Link_t       rwLockListLink;     ///< Used to link onto the process's RwLock List.
+    le_thread_Ref_t     writingThreadRef;   ///< Reference to the thread that holds the write lock.
+    le_dls_Link_t       lockedByThreadLink; ///< Used to link onto the writer's locked list.
+    uint32_t            state;              ///< Number of readers, plus the write flags.
+    pthread_mutex_t     waitMutex;          ///< Protects the writers and the waiting threads.
+    pthread_cond_t      readersCond;        ///< Signalled when readers may get the lock.
+    pthread_cond_t      writersCond;        ///< Signalled when a writer may get the lock.
+    uint32_t            waitingReaders;     ///< Number of readers waiting for the lock.
+    uint32_t            waitingWriters;     ///< Number of writers waiting for the lock.
+    le_dls_List_t       waitingList;        ///< List of threads waiting for this lock.
+    uint32_t            contentionCount;    ///< Number of times a thread had to wait for the lock.
+    char                name[RWLOCK_MAX_NAME_BYTES]; ///< The name of the lock (UTF8 string).
+}
+RwLock_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reader-Writer Lock Thread Record.
+ *
+ * This structure is to be stored as a member in each Thread object.  The function
+ * thread_GetRwLockRecPtr() is used by the rwLock module to fetch a pointer to one of these
+ * records for a given thread.
+ *
+ * @warning No code outside of the rwLock module (rwLock.c) should ever access the members of this
+ *          structure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_rwlock_Ref_t waitingOnRwLock;    ///< Reference to the lock that is being waited on.
+    le_dls_List_t   lockedRwLockList;   ///< List of locks currently write-locked by this thread.
+    le_dls_Link_t   waitingListLink;    ///< Used to link into RwLock object's waiting list.
+}
+rwlock_ThreadRec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the reader-writer lock list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* rwlock_GetRwLockList
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the reader-writer lock list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** rwlock_GetRwLockListChgCntRef
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Reader-Writer Lock module.
+ *
+ * This function must be called exactly once at process start-up before any other rwLock module
+ * functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void rwlock_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread-specific parts of the Reader-Writer Lock module.
+ *
+ * This function must be called once by each thread when it starts, before any other rwLock module
+ * functions are called by that thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void rwlock_ThreadInit
+(
+    void
+);
+
+
+#endif /* LEGATO_SRC_RWLOCK_H_INCLUDE_GUARD */
@@ -9,6 +9,16 @@
  *       processor architectures.  Also, if they try to use a memory address as a Safe Ref,
  *       the memory address is guaranteed to be detected as an invalid Safe Reference.
  *
+ * Maps created with le_ref_CreateMap() keep their mappings in a hashmap, keyed by the Safe
+ * Reference itself.
+ *
+ * Maps created with le_ref_CreateIndexedMap() keep their mappings in an array of slots instead.
+ * Above the odd bit, a Safe Reference holds the index of its slot (INDEX_BITS bits), then the
+ * slot's generation counter.  The generation counter is incremented each time the slot's Safe
+ * Reference is deleted, so a stale Safe Reference doesn't match the slot's generation anymore,
+ * even once the slot is reused.  Free slots are reused oldest first, so that a slot goes through
+ * its generations as slowly as possible.  Lookups are then an array access and a compare.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -29,17 +39,69 @@
 /// Name used for diagnostics.
 static const char ModuleName[] = "ref";
 
+/// Number of bits of an indexed map's Safe References that hold the slot index, which is also the
+/// maximum number of Safe References an indexed map can hold at the same time.
+#define INDEX_BITS 16
+#define MAX_SLOTS (1U << INDEX_BITS)
+#define INDEX_MASK (MAX_SLOTS - 1)
+
+/// Position and mask of the generation counter in an indexed map's Safe References.
+#define GENERATION_SHIFT (INDEX_BITS + 1)
+#define GENERATION_MASK (UINTPTR_MAX >> GENERATION_SHIFT)
+
+/// Slot index used to mark the end of the free slot list, and an iterator that isn't on a slot.
+#define NO_SLOT UINT32_MAX
+
+/// Minimum number of slots of an indexed map.
+#define MIN_SLOTS 4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot of an indexed Reference Map.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*       ptr;        ///< Pointer to which the slot's Safe Reference is mapped.
+    uintptr_t   generation; ///< Generation of the slot's current (or next) Safe Reference.
+    uint32_t    nextFree;   ///< Index of the next free slot if this one is free, or NO_SLOT.
+    bool        inUse;      ///< true if the slot holds a valid Safe Reference.
+}
+Slot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference Map iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_ref_Iter
+{
+    struct le_ref_Map*  mapPtr;         ///< Map being iterated.
+    le_hashmap_It_Ref_t hashmapIterRef; ///< Hashmap iterator (only for hashmap-based maps).
+    uint32_t            currentIndex;   ///< Slot the iterator is on, or NO_SLOT.
+    uint32_t            nextIndex;      ///< Next slot to look at.
+}
+Iter_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference Map object, which stores mappings from Safe References to pointers.
- * The actual mapping is held in a hashmap.
+ * The actual mapping is held in a hashmap, or in an array of slots for indexed maps.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct le_ref_Map
 {
     uint32_t             nextRefNum;     ///< The next Safe Reference value to be assigned.
 
-    le_hashmap_Ref_t    referenceMap;    ///< HashMap of Mapping objects.
+    le_hashmap_Ref_t    referenceMap;    ///< HashMap of Mapping objects (NULL for indexed maps).
+
+    Slot_t*             slotsPtr;        ///< Array of slots (indexed maps only).
+    uint32_t            slotCount;       ///< Number of slots in the array.
+    uint32_t            freeHead;        ///< Index of the first free slot, or NO_SLOT.
+    uint32_t            freeTail;        ///< Index of the last free slot, or NO_SLOT.
+
+    Iter_t              iterator;        ///< The map's iterator.
 
     char          name[MAX_NAME_BYTES]; ///< The name of the map (for diagnostics).
 }
@@ -59,40 +121,155 @@ static le_mem_PoolRef_t MapPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef hashing function.
- *
- * @return  Returns the SafeRef itself as it can used as a hash
+ * Allocate a Map object and name it.
  *
+ * @return Pointer to the Map object.
  */
 //--------------------------------------------------------------------------------------------------
-
-size_t hashSafeRef
+static Map_t* CreateMap
 (
-    const void* safeRefPtr    ///< [in] Safe Ref to be hashed
+    const char* name    ///< [in] The name of the map (for diagnostics).
 )
 {
-    // Return the key value itself.
-    return (size_t) safeRefPtr;
+    Map_t* mapPtr = le_mem_ForceAlloc(MapPool);
+
+    memset(mapPtr, 0, sizeof(*mapPtr));
+
+    size_t strLen;
+
+    LE_ASSERT(le_utf8_Copy(mapPtr->name, ModuleName, sizeof(mapPtr->name), &strLen) == LE_OK);
+
+    if (   le_utf8_Copy(mapPtr->name + strLen, name, sizeof(mapPtr->name) - strLen, NULL)
+        == LE_OVERFLOW)
+    {
+        LE_WARN("Map name '%s%s' truncated to '%s'.", ModuleName, name, mapPtr->name);
+    }
+
+    mapPtr->freeHead = NO_SLOT;
+    mapPtr->freeTail = NO_SLOT;
+    mapPtr->iterator.mapPtr = mapPtr;
+    mapPtr->iterator.currentIndex = NO_SLOT;
+
+    return mapPtr;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef equality function.
+ * Build the Safe Reference of a slot of an indexed map.
  *
- * @return  Returns true if the integers are equal, false otherwise
+ * @return The Safe Reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void* MakeIndexedRef
+(
+    uint32_t    index,      ///< [in] Index of the slot.
+    uintptr_t   generation  ///< [in] Generation of the slot.
+)
+{
+    return (void*)((generation << GENERATION_SHIFT) | ((uintptr_t)index << 1) | 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the slot of an indexed map that a Safe Reference refers to.
  *
+ * @return Pointer to the slot, or NULL if the Safe Reference is invalid or stale.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Slot_t* GetSlot
+(
+    Map_t*  mapPtr,     ///< [in] The indexed map.
+    void*   safeRef     ///< [in] The Safe Reference.
+)
+{
+    uintptr_t refNum = (uintptr_t)safeRef;
+    uint32_t index = (refNum >> 1) & INDEX_MASK;
+
+    if (((refNum & 1) == 0) || (index >= mapPtr->slotCount))
+    {
+        return NULL;
+    }
+
+    Slot_t* slotPtr = &mapPtr->slotsPtr[index];
+
+    if ((!slotPtr->inUse) || (slotPtr->generation != (refNum >> GENERATION_SHIFT)))
+    {
+        return NULL;
+    }
+
+    return slotPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a slot to the free slot list of an indexed map.
  */
 //--------------------------------------------------------------------------------------------------
+static void FreeSlot
+(
+    Map_t*      mapPtr, ///< [in] The indexed map.
+    uint32_t    index   ///< [in] Index of the slot.
+)
+{
+    mapPtr->slotsPtr[index].nextFree = NO_SLOT;
 
-bool equalsSafeRef
+    if (mapPtr->freeTail == NO_SLOT)
+    {
+        mapPtr->freeHead = index;
+    }
+    else
+    {
+        mapPtr->slotsPtr[mapPtr->freeTail].nextFree = index;
+    }
+
+    mapPtr->freeTail = index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grow the slot array of an indexed map, adding the new slots to the free slot list.
+ *
+ * @note Terminates the process if the map already has the maximum number of slots.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowSlots
 (
-    const void* firstSafeRef,    ///< [in] First SafeRef for comparing.
-    const void* secondSafeRef    ///< [in] Second SafeRef for comparing.
+    Map_t*      mapPtr, ///< [in] The indexed map.
+    uint32_t    count   ///< [in] Number of slots wanted.
 )
 {
-    return firstSafeRef == secondSafeRef;
+    LE_FATAL_IF(mapPtr->slotCount >= MAX_SLOTS,
+                "Reference Map '%s' is full (%u references).", mapPtr->name, MAX_SLOTS);
+
+    if (count < MIN_SLOTS)
+    {
+        count = MIN_SLOTS;
+    }
+    if (count > MAX_SLOTS)
+    {
+        count = MAX_SLOTS;
+    }
+
+    mapPtr->slotsPtr = realloc(mapPtr->slotsPtr, count * sizeof(Slot_t));
+    LE_ASSERT(mapPtr->slotsPtr);
+
+    uint32_t index;
+    for (index = mapPtr->slotCount; index < count; index++)
+    {
+        mapPtr->slotsPtr[index].ptr = NULL;
+        mapPtr->slotsPtr[index].generation = 1;
+        mapPtr->slotsPtr[index].inUse = false;
+        FreeSlot(mapPtr, index);
+    }
+
+    mapPtr->slotCount = count;
 }
 
+
 // =============================================
 //  PROTECTED (Intra-Module) FUNCTIONS
 // =============================================
@@ -137,32 +314,49 @@ le_ref_MapRef_t le_ref_CreateMap
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Map_t* mapPtr = le_mem_ForceAlloc(MapPool);
-
-    size_t strLen;
-
-    LE_ASSERT(le_utf8_Copy(mapPtr->name, ModuleName, sizeof(mapPtr->name), &strLen) == LE_OK);
-
-    if (   le_utf8_Copy(mapPtr->name + strLen, name, sizeof(mapPtr->name) - strLen, NULL)
-        == LE_OVERFLOW)
-    {
-        LE_WARN("Map name '%s%s' truncated to '%s'.", ModuleName, name, mapPtr->name);
-    }
+    Map_t* mapPtr = CreateMap(name);
 
     /// @todo Make this a random number so that using a reference from another Map is unlikely to
     ///       get by undetected.
     mapPtr->nextRefNum = 0x10000001; // Use only odd numbers.
 
+    // A Safe Reference is its own hash, so the pointer hash (which the hashmap inlines) is used.
     mapPtr->referenceMap = le_hashmap_Create(mapPtr->name,
                                              maxRefs,
-                                             hashSafeRef,
-                                             equalsSafeRef
+                                             le_hashmap_HashVoidPointer,
+                                             le_hashmap_EqualsVoidPointer
                                             );
 
     return mapPtr;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an indexed Reference Map.  An indexed map stores its mappings in an array, and encodes
+ * the array index in the Safe References, so lookups are done in constant time without any
+ * hashing.
+ *
+ * @return A reference to the Reference Map object.
+ */
+//--------------------------------------------------------------------------------------------------
+le_ref_MapRef_t le_ref_CreateIndexedMap
+(
+    const char* name,   ///< [in] The name of the map (for diagnostics).
+
+    size_t      maxRefs ///< [in] The maximum number of Safe References expected to be kept in
+                        ///       this Reference Map at any one time.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Map_t* mapPtr = CreateMap(name);
+
+    GrowSlots(mapPtr, (maxRefs < MAX_SLOTS) ? maxRefs : MAX_SLOTS);
+
+    return mapPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a Safe Reference, storing a mapping between that reference and a given pointer for
@@ -178,6 +372,28 @@ void* le_ref_CreateRef
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (mapRef->referenceMap == NULL)
+    {
+        if (mapRef->freeHead == NO_SLOT)
+        {
+            GrowSlots(mapRef, mapRef->slotCount * 2);
+        }
+
+        uint32_t index = mapRef->freeHead;
+        Slot_t* slotPtr = &mapRef->slotsPtr[index];
+
+        mapRef->freeHead = slotPtr->nextFree;
+        if (mapRef->freeHead == NO_SLOT)
+        {
+            mapRef->freeTail = NO_SLOT;
+        }
+
+        slotPtr->ptr = ptr;
+        slotPtr->inUse = true;
+
+        return MakeIndexedRef(index, slotPtr->generation);
+    }
+
     ssize_t thisRef = mapRef->nextRefNum;
 
     le_hashmap_Put(mapRef->referenceMap, (const void*)(thisRef), ptr);
@@ -204,6 +420,13 @@ void* le_ref_Lookup
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (mapRef->referenceMap == NULL)
+    {
+        Slot_t* slotPtr = GetSlot(mapRef, safeRef);
+
+        return (slotPtr == NULL) ? NULL : slotPtr->ptr;
+    }
+
     return le_hashmap_Get(mapRef->referenceMap, safeRef);
 }
 
@@ -220,7 +443,23 @@ void le_ref_DeleteRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (le_hashmap_Remove(mapRef->referenceMap, safeRef) == NULL)
+    if (mapRef->referenceMap == NULL)
+    {
+        Slot_t* slotPtr = GetSlot(mapRef, safeRef);
+
+        if (slotPtr == NULL)
+        {
+            LE_ERROR("Deleting non-existent Safe Reference %p from Map '%s'.",
+                     safeRef, mapRef->name);
+            return;
+        }
+
+        slotPtr->ptr = NULL;
+        slotPtr->inUse = false;
+        slotPtr->generation = (slotPtr->generation + 1) & GENERATION_MASK;
+        FreeSlot(mapRef, slotPtr - mapRef->slotsPtr);
+    }
+    else if (le_hashmap_Remove(mapRef->referenceMap, safeRef) == NULL)
     {
         LE_ERROR("Deleting non-existent Safe Reference %p from Map '%s'.", safeRef, mapRef->name);
     }
@@ -243,7 +482,17 @@ le_ref_IterRef_t le_ref_GetIterator
     le_ref_MapRef_t mapRef ///< [in] Reference to the map.
 )
 {
-    return (le_ref_IterRef_t)le_hashmap_GetIterator(mapRef->referenceMap);
+    Iter_t* iterPtr = &mapRef->iterator;
+
+    if (mapRef->referenceMap != NULL)
+    {
+        iterPtr->hashmapIterRef = le_hashmap_GetIterator(mapRef->referenceMap);
+    }
+
+    iterPtr->currentIndex = NO_SLOT;
+    iterPtr->nextIndex = 0;
+
+    return iterPtr;
 }
 
 
@@ -261,7 +510,28 @@ le_result_t le_ref_NextNode
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_NextNode((le_hashmap_It_Ref_t)iteratorRef);
+    Map_t* mapPtr = iteratorRef->mapPtr;
+
+    if (mapPtr->referenceMap != NULL)
+    {
+        return le_hashmap_NextNode(iteratorRef->hashmapIterRef);
+    }
+
+    uint32_t index;
+    for (index = iteratorRef->nextIndex; index < mapPtr->slotCount; index++)
+    {
+        if (mapPtr->slotsPtr[index].inUse)
+        {
+            iteratorRef->currentIndex = index;
+            iteratorRef->nextIndex = index + 1;
+            return LE_OK;
+        }
+    }
+
+    iteratorRef->currentIndex = NO_SLOT;
+    iteratorRef->nextIndex = mapPtr->slotCount;
+
+    return LE_NOT_FOUND;
 }
 
 
@@ -280,7 +550,22 @@ const void* le_ref_GetSafeRef
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetKey((le_hashmap_It_Ref_t)iteratorRef);
+    Map_t* mapPtr = iteratorRef->mapPtr;
+
+    if (mapPtr->referenceMap != NULL)
+    {
+        return le_hashmap_GetKey(iteratorRef->hashmapIterRef);
+    }
+
+    // The slot may have been deleted since the iterator moved onto it.
+    if ((iteratorRef->currentIndex == NO_SLOT) ||
+        (!mapPtr->slotsPtr[iteratorRef->currentIndex].inUse))
+    {
+        return NULL;
+    }
+
+    return MakeIndexedRef(iteratorRef->currentIndex,
+                          mapPtr->slotsPtr[iteratorRef->currentIndex].generation);
 }
 
 
@@ -299,5 +584,18 @@ void* le_ref_GetValue
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetValue((le_hashmap_It_Ref_t)iteratorRef);
+    Map_t* mapPtr = iteratorRef->mapPtr;
+
+    if (mapPtr->referenceMap != NULL)
+    {
+        return le_hashmap_GetValue(iteratorRef->hashmapIterRef);
+    }
+
+    if ((iteratorRef->currentIndex == NO_SLOT) ||
+        (!mapPtr->slotsPtr[iteratorRef->currentIndex].inUse))
+    {
+        return NULL;
+    }
+
+    return mapPtr->slotsPtr[iteratorRef->currentIndex].ptr;
 }
@@ -22,6 +22,11 @@
  *  -# What threads, if any, are currently waiting on a given semaphore?
  *    - Each Semaphore object has a list of Per-Thread Semaphore Records for this.
  *
+ * The semaphore's value is a futex word in the Semaphore object.  Taking from a positive value is a
+ * single atomic compare-and-swap, and posting to a semaphore nobody waits for is a single atomic
+ * add: the kernel is only entered when a thread has to wait, or has to be woken up.  The waiting
+ * list (and its own pthreads mutex) is therefore only updated when a thread actually has to wait.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -29,6 +34,9 @@
 #include "semaphores.h"
 #include "thread.h"
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
 // ==============================
 //  PRIVATE DATA
 // ==============================
@@ -136,6 +144,185 @@ static void RemoveFromWaitingList
     UNLOCK_WAITING_LIST(semaphorePtr);
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take one from a semaphore's value if it is positive.
+ *
+ * @return true if the value was decremented, false if it was 0.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool TryDecrement
+(
+    Semaphore_t*        semaphorePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int32_t value = __atomic_load_n(&semaphorePtr->value, __ATOMIC_SEQ_CST);
+
+    // On failure, the compare-and-swap reloads the value, so just try again while it's positive.
+    while (value > 0)
+    {
+        if (__atomic_compare_exchange_n(&semaphorePtr->value, &value, value - 1, true,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sleep in the kernel until a semaphore's value is no longer 0, or a deadline is reached.
+ *
+ * Like sem_wait(), this is a cancellation point.
+ *
+ * @return The futex system call's result (errno is set on failure).
+ */
+//--------------------------------------------------------------------------------------------------
+static long FutexWait
+(
+    Semaphore_t*            semaphorePtr,
+    const struct timespec*  deadlinePtr     ///< [in] CLOCK_MONOTONIC deadline, or NULL for none.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldType;
+
+    // The thread may only be cancelled while it sleeps, which is what sem_wait() does too.
+    LE_ASSERT(pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &oldType) == 0);
+
+    long result = syscall(SYS_futex, &semaphorePtr->value, FUTEX_WAIT_BITSET_PRIVATE, 0,
+                          deadlinePtr, NULL, FUTEX_BITSET_MATCH_ANY);
+    int savedErrno = errno;
+
+    LE_ASSERT(pthread_setcanceltype(oldType, NULL) == 0);
+
+    errno = savedErrno;
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clean up after a thread has stopped waiting for a semaphore, because it took from its value,
+ * timed out or was cancelled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitCleanUp
+(
+    void* contextPtr    ///< [in] Pointer to the thread's semaphore info record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sem_ThreadRec_t* perThreadRecPtr = contextPtr;
+    Semaphore_t* semaphorePtr = perThreadRecPtr->waitingOnSemaphore;
+
+    int32_t numWaiters = __atomic_sub_fetch(&semaphorePtr->numWaiters, 1, __ATOMIC_SEQ_CST);
+
+    // If this thread was woken up by a post but then timed out or was cancelled, the wake-up must
+    // be passed on to another waiter, or it could sleep although the value is positive.
+    if ( (numWaiters > 0) && (__atomic_load_n(&semaphorePtr->value, __ATOMIC_SEQ_CST) > 0) )
+    {
+        (void)syscall(SYS_futex, &semaphorePtr->value, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+
+    RemoveFromWaitingList(semaphorePtr, perThreadRecPtr);
+    SemaphoreListChangeCount++;
+    perThreadRecPtr->waitingOnSemaphore = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a semaphore the slow way: the thread is put on the semaphore's waiting list and sleeps
+ * in the kernel until the semaphore is posted.
+ *
+ * @return
+ *      - LE_OK         The semaphore was decremented.
+ *      - LE_TIMEOUT    The deadline was reached.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitContended
+(
+    Semaphore_t*            semaphorePtr,
+    const struct timespec*  deadlinePtr     ///< [in] CLOCK_MONOTONIC deadline, or NULL for none.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    sem_ThreadRec_t* perThreadRecPtr = thread_GetSemaphoreRecPtr();
+    volatile le_result_t result = LE_OK;
+
+    SemaphoreListChangeCount++;
+    perThreadRecPtr->waitingOnSemaphore = semaphorePtr;
+    AddToWaitingList(semaphorePtr, perThreadRecPtr);
+
+    // Posters only enter the kernel if they see a waiter, so the waiter count must be raised
+    // before the value is checked again.
+    __atomic_add_fetch(&semaphorePtr->numWaiters, 1, __ATOMIC_SEQ_CST);
+
+    pthread_cleanup_push(WaitCleanUp, perThreadRecPtr);
+
+    // The futex wait returns at once if the value is no longer 0, and may also return spuriously,
+    // so just try again until the value could be decremented.
+    while (!TryDecrement(semaphorePtr))
+    {
+        if (FutexWait(semaphorePtr, deadlinePtr) != 0)
+        {
+            if (errno == ETIMEDOUT)
+            {
+                result = LE_TIMEOUT;
+                break;
+            }
+
+            LE_FATAL_IF((errno != EAGAIN) && (errno != EINTR),
+                        "Thread '%s' failed to wait on semaphore '%s' (%m).",
+                        le_thread_GetMyName(),
+                        semaphorePtr->nameStr);
+        }
+    }
+
+    pthread_cleanup_pop(1);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add to a semaphore's value, and wake up as many waiting threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Post
+(
+    Semaphore_t*        semaphorePtr,
+    int32_t             count           ///< [in] Number to add to the value (> 0).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int32_t value = __atomic_load_n(&semaphorePtr->value, __ATOMIC_RELAXED);
+
+    do
+    {
+        LE_FATAL_IF(value > SEM_VALUE_MAX - count,
+                    "Failed to post %" PRId32 " times on semaphore '%s' of value %" PRId32 ".",
+                    count,
+                    semaphorePtr->nameStr,
+                    value);
+    }
+    while (!__atomic_compare_exchange_n(&semaphorePtr->value, &value, value + count, true,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    // The kernel only needs to be entered if some thread may be waiting.
+    if (__atomic_load_n(&semaphorePtr->numWaiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        (void)syscall(SYS_futex, &semaphorePtr->value, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+}
+
 // ==============================
 //  INTRA-FRAMEWORK FUNCTIONS
 // ==============================
@@ -224,12 +411,12 @@ le_sem_Ref_t le_sem_Create
         LE_WARN("Semaphore name '%s' truncated to '%s'.", name, semaphorePtr->nameStr);
     }
 
-    // Initialize the underlying POSIX semaphore shared between thread.
-    int result = sem_init(&semaphorePtr->semaphore,0, initialCount);
-    if (result != 0)
-    {
-        LE_FATAL("Failed to set the semaphore . errno = %d (%m).", errno);
-    }
+    LE_FATAL_IF((initialCount < 0) || (initialCount > SEM_VALUE_MAX),
+                "Invalid initial count %" PRId32 " for semaphore '%s'.",
+                initialCount,
+                semaphorePtr->nameStr);
+    semaphorePtr->value = initialCount;
+    semaphorePtr->numWaiters = 0;
 
     // Add the semaphore to the process's Semaphore List.
     LOCK_SEMAPHORE_LIST();
@@ -257,19 +444,14 @@ void le_sem_Delete
     UNLOCK_SEMAPHORE_LIST();
 
     LOCK_WAITING_LIST(semaphorePtr);
-    if ( le_dls_Peek(&semaphorePtr->waitingList)==NULL ) {
+    if ( (le_dls_Peek(&semaphorePtr->waitingList)==NULL) &&
+         (__atomic_load_n(&semaphorePtr->numWaiters, __ATOMIC_SEQ_CST) == 0) ) {
         UNLOCK_WAITING_LIST(semaphorePtr);
         if (pthread_mutex_destroy(&semaphorePtr->waitingListMutex) != 0)
         {
             LE_FATAL(   "Semaphore '%s' could not destroy internal mutex!",
                         semaphorePtr->nameStr);
         }
-            // Destroy the semaphore.
-        if (sem_destroy(&semaphorePtr->semaphore) != 0)
-        {
-            LE_FATAL(   "Semaphore '%s' is not a valid semaphore!",
-                        semaphorePtr->nameStr);
-        }
     } else {
         UNLOCK_WAITING_LIST(semaphorePtr);
         // TODO print more information
@@ -311,24 +493,10 @@ void le_sem_Wait
     le_sem_Ref_t    semaphorePtr   ///< [IN] Pointer to the semaphore
 )
 {
-    int result;
-
-    sem_ThreadRec_t* perThreadRecPtr = thread_GetSemaphoreRecPtr();
-
-    SemaphoreListChangeCount++;
-    perThreadRecPtr->waitingOnSemaphore = semaphorePtr;
-    AddToWaitingList(semaphorePtr, perThreadRecPtr);
-
-    result = sem_wait(&semaphorePtr->semaphore);
-
-    RemoveFromWaitingList(semaphorePtr, perThreadRecPtr);
-    SemaphoreListChangeCount++;
-    perThreadRecPtr->waitingOnSemaphore = NULL;
-
-    LE_FATAL_IF( (result!=0), "Thread '%s' failed to wait on semaphore '%s'. Error code %d (%m).",
-                le_thread_GetMyName(),
-                semaphorePtr->nameStr,
-                result);
+    if (!TryDecrement(semaphorePtr))
+    {
+        (void)WaitContended(semaphorePtr, NULL);
+    }
 }
 
 
@@ -348,20 +516,9 @@ le_result_t le_sem_TryWait
     le_sem_Ref_t    semaphorePtr   ///< [IN] Pointer to the semaphore
 )
 {
-    int result;
-
-    result = sem_trywait(&semaphorePtr->semaphore);
-
-    if (result != 0)
+    if (!TryDecrement(semaphorePtr))
     {
-        if ( errno == EAGAIN ) {
-            return LE_WOULD_BLOCK;
-        } else {
-            LE_FATAL("Thread '%s' failed to trywait on semaphore '%s'. Error code %d (%m).",
-                    le_thread_GetMyName(),
-                    semaphorePtr->nameStr,
-                    result);
-        }
+        return LE_WOULD_BLOCK;
     }
 
     return LE_OK;
@@ -384,42 +541,23 @@ le_result_t le_sem_WaitWithTimeOut
     le_clk_Time_t   timeToWait      ///< [IN] Time to wait
 )
 {
-    struct timespec timeOut;
-    int result;
-
-    // Prepare the timer
-    le_clk_Time_t currentUtcTime = le_clk_GetAbsoluteTime();
-    le_clk_Time_t wakeUpTime = le_clk_Add(currentUtcTime,timeToWait);
-    timeOut.tv_sec = wakeUpTime.sec;
-    timeOut.tv_nsec = wakeUpTime.usec * 1000;
-
-    // Retrieve reference thread
-    sem_ThreadRec_t* perThreadRecPtr = thread_GetSemaphoreRecPtr();
-    // Save into waiting list
-    SemaphoreListChangeCount++;
-    perThreadRecPtr->waitingOnSemaphore = semaphorePtr;
-    AddToWaitingList(semaphorePtr, perThreadRecPtr);
-
-    result = sem_timedwait(&semaphorePtr->semaphore,&timeOut);
-
-    // Remove from waiting list
-    RemoveFromWaitingList(semaphorePtr, perThreadRecPtr);
-    SemaphoreListChangeCount++;
-    perThreadRecPtr->waitingOnSemaphore = NULL;
-
-    if (result != 0)
+    if (TryDecrement(semaphorePtr))
     {
-        if ( errno == ETIMEDOUT ) {
-            return LE_TIMEOUT;
-        } else {
-            LE_FATAL("Thread '%s' failed to wait on semaphore '%s'. Error code %d (%m).",
-                    le_thread_GetMyName(),
-                    semaphorePtr->nameStr,
-                    result);
-        }
+        return LE_OK;
     }
 
-    return LE_OK;
+    // Prepare the deadline.  The monotonic clock is used so that changes to the time of day don't
+    // affect the wait.
+    struct timespec now;
+    LE_ASSERT(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+
+    le_clk_Time_t currentTime = { .sec = now.tv_sec, .usec = now.tv_nsec / 1000 };
+    le_clk_Time_t wakeUpTime = le_clk_Add(currentTime, timeToWait);
+    struct timespec deadline;
+    deadline.tv_sec = wakeUpTime.sec;
+    deadline.tv_nsec = wakeUpTime.usec * 1000;
+
+    return WaitContended(semaphorePtr, &deadline);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -434,13 +572,29 @@ void le_sem_Post
     le_sem_Ref_t    semaphorePtr      ///< [IN] Pointer to the semaphore
 )
 {
-    int result;
+    Post(semaphorePtr, 1);
+}
 
-    result = sem_post (&semaphorePtr->semaphore);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post a semaphore several times at once, waking up to that many waiting threads with a single
+ * system call.
+ *
+ * @return Nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sem_PostMany
+(
+    le_sem_Ref_t    semaphorePtr,     ///< [IN] Pointer to the semaphore
+    int32_t         count             ///< [IN] Number of times to post it
+)
+{
+    LE_FATAL_IF(count <= 0,
+                "Invalid count %" PRId32 " to post on semaphore '%s'.",
+                count,
+                semaphorePtr->nameStr);
 
-    LE_FATAL_IF((result!=0),"Failed to post on semaphore '%s'. Errno = %d (%m).",
-                semaphorePtr->nameStr,
-                result);
+    Post(semaphorePtr, count);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -455,12 +609,5 @@ int le_sem_GetValue
     le_sem_Ref_t    semaphorePtr   ///< [IN] Pointer to the semaphore
 )
 {
-    int value;
-
-    if ( sem_getvalue(&(semaphorePtr->semaphore),&value) != 0)
-    {
-        LE_FATAL("Cannot get %s semaphore value",semaphorePtr->nameStr);
-    }
-
-    return value;
+    return __atomic_load_n(&semaphorePtr->value, __ATOMIC_RELAXED);
 }
@@ -22,7 +22,9 @@ typedef struct le_sem_t
     le_dls_Link_t       semaphoreListLink;   ///< Used to link onto the process's Semaphore List.
     le_dls_List_t       waitingList;         ///< List of threads waiting for this semaphore.
     pthread_mutex_t     waitingListMutex;    ///< Pthreads mutex used to protect the waiting list.
-    sem_t               semaphore;           ///< Pthreads semaphore that does the real work. :)
+    int32_t             value;               ///< Value of the semaphore, used as a futex word.
+    int32_t             numWaiters;          ///< Number of threads waiting (or about to wait) for
+                                             ///  the value to become positive.
     char                nameStr[LIMIT_MAX_SEMAPHORE_NAME_BYTES]; ///< The name of the semaphore (UTF8 string).
 }
 Semaphore_t;
@@ -316,6 +316,46 @@ static void MakeRuleStr
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes one or more rules to the SMACK load file, in a single write.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadRules
+(
+    const char* rulesPtr,           ///< [IN] Rules, separated by newlines.
+    size_t rulesLength              ///< [IN] Length of the rules string.
+)
+{
+    // Open the SMACK load file.
+    int fd;
+
+    do
+    {
+        fd = open(SMACK_LOAD_FILE, O_WRONLY);
+    }
+    while ( (fd == -1) && (errno == EINTR) );
+
+    LE_FATAL_IF(fd == -1, "Could not open %s.  %m.\n", SMACK_LOAD_FILE);
+
+    // Write the rules to the SMACK load file.
+    int numBytes = 0;
+
+    do
+    {
+        numBytes = write(fd, rulesPtr, rulesLength);
+    }
+    while ( (numBytes == -1) && (errno == EINTR) );
+
+    LE_FATAL_IF(numBytes != rulesLength, "Could not write SMACK rules '%.*s'.  %m.",
+                (int)rulesLength, rulesPtr);
+
+    fd_Close(fd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Shows whether SMACK is enabled or disabled in the Legato Framework.
@@ -524,32 +564,84 @@ void smack_SetRule
     char rule[SMACK_RULE_STR_BYTES];
     MakeRuleStr(subjectLabelPtr, accessModePtr, objectLabelPtr, rule, sizeof(rule));
 
-    // Open the SMACK load file.
-    int fd;
+    LoadRules(rule, strlen(rule));
 
-    do
-    {
-        fd = open(SMACK_LOAD_FILE, O_WRONLY);
-    }
-    while ( (fd == -1) && (errno == EINTR) );
+    LE_DEBUG("Set SMACK rule '%s'.", rule);
+}
 
-    LE_FATAL_IF(fd == -1, "Could not open %s.  %m.\n", SMACK_LOAD_FILE);
 
-    // Write the rule to the SMACK load file.
-    int numBytes = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty rule batch.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_InitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to initialize.
+)
+{
+    batchPtr->len = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a batch.  The access mode is the same as for smack_SetRule().
+ *
+ * The rule is not in effect until the batch is committed, unless the batch was full, in which case
+ * the rules already in the batch are loaded first to make room.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRuleToBatch
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Batch to add the rule to.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+)
+{
+    CheckLabel(subjectLabelPtr);
+    CheckLabel(objectLabelPtr);
+
+    // Create the SMACK rule.
+    char rule[SMACK_RULE_STR_BYTES];
+    MakeRuleStr(subjectLabelPtr, accessModePtr, objectLabelPtr, rule, sizeof(rule));
+
+    // Make room for the rule and its newline, if needed.
     size_t ruleLength = strlen(rule);
 
-    do
+    if (batchPtr->len + ruleLength + 1 > sizeof(batchPtr->buf))
     {
-        numBytes = write(fd, rule, ruleLength);
+        smack_CommitRuleBatch(batchPtr);
     }
-    while ( (numBytes == -1) && (errno == EINTR) );
 
-    LE_FATAL_IF(numBytes != ruleLength, "Could not write SMACK rule '%s'.  %m.", rule);
+    memcpy(batchPtr->buf + batchPtr->len, rule, ruleLength);
+    batchPtr->len += ruleLength;
+    batchPtr->buf[batchPtr->len++] = '\n';
 
-    fd_Close(fd);
+    LE_DEBUG("Batched SMACK rule '%s'.", rule);
+}
 
-    LE_DEBUG("Set SMACK rule '%s'.", rule);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads all the rules in a batch, and empties the batch so that it can be reused.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to commit.
+)
+{
+    if (batchPtr->len > 0)
+    {
+        LoadRules(batchPtr->buf, batchPtr->len);
+        batchPtr->len = 0;
+    }
 }
 
 
@@ -899,6 +991,50 @@ void smack_SetRule
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty rule batch.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_InitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to initialize.
+)
+{
+    batchPtr->len = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a batch.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRuleToBatch
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Batch to add the rule to.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads all the rules in a batch, and empties the batch so that it can be reused.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to commit.
+)
+{
+    batchPtr->len = 0;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks whether a subject has the specified access mode for an object.
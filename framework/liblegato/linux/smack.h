@@ -63,6 +63,11 @@
  * Use smack_SetRule() to set an explicit SMACK rule that gives a specified subject access to a
  * specified object.
  *
+ * Setting many rules at once (when an app is started, for example) is cheaper with a rule batch:
+ * smack_InitRuleBatch(), then smack_AddRuleToBatch() for each rule, then smack_CommitRuleBatch().
+ * The rules are then loaded with as few writes to smackfs as possible, instead of one open, write
+ * and close for each rule.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -80,6 +85,29 @@
 #define SMACK_APP_PREFIX          "app."
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a rule batch's buffer.  smackfs only takes one page of rules per write, so this is kept
+ * below the smallest page size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMACK_RULE_BATCH_BYTES    2048
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch of SMACK rules waiting to be loaded.  Usually allocated on the stack.  Must be initialized
+ * with smack_InitRuleBatch().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t len;                                 ///< Number of bytes used in the buffer.
+    char buf[SMACK_RULE_BATCH_BYTES];           ///< Newline-separated rules.
+}
+smack_RuleBatch_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Shows whether SMACK is enabled or disabled in the Legato Framework.
@@ -187,6 +215,49 @@ void smack_SetRule
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty rule batch.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_InitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to initialize.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a batch.  The access mode is the same as for smack_SetRule().
+ *
+ * The rule is not in effect until the batch is committed, unless the batch was full, in which case
+ * the rules already in the batch are loaded first to make room.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRuleToBatch
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Batch to add the rule to.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads all the rules in a batch, and empties the batch so that it can be reused.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRuleBatch
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Batch to commit.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks whether a subject has the specified access mode for an object.
@@ -0,0 +1,187 @@
+/** @file spinLock.c
+ *
+ * Legato @ref c_spinLock implementation.
+ *
+ * The state word of a spin lock is used as a futex: 0 when unlocked, 1 when locked, and 2 when
+ * locked and maybe waited on by threads sleeping in the kernel.
+ *
+ * A thread that finds the lock taken spins, reading the state word until it looks free, for at
+ * most twice the lock's average number of spins (plus a few).  The average moves towards the
+ * number of spins it took each time, and is capped by MAX_SPINS.  So a lock that is usually
+ * released within a few spins gets a short spin budget, and one whose holder is often preempted
+ * quickly stops spinning at all.  A thread that runs out of spins marks the lock "contended" and
+ * sleeps on the futex until the lock is released.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+
+// ==============================
+//  PRIVATE DATA
+// ==============================
+
+/// Maximum number of times a thread spins before going to sleep.
+#define MAX_SPINS 100
+
+/// Values of a spin lock's state word.
+#define STATE_UNLOCKED  0   ///< Nobody holds the lock.
+#define STATE_LOCKED    1   ///< The lock is held, and nobody sleeps waiting for it.
+#define STATE_CONTENDED 2   ///< The lock is held, and threads may be sleeping waiting for it.
+
+
+// ==============================
+//  PRIVATE FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell the CPU that the thread is busy-waiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CpuRelax
+(
+    void
+)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && (__ARM_ARCH >= 7))
+    __asm__ __volatile__ ("yield" ::: "memory");
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a spin lock if it is free.
+ *
+ * @return true if the lock was taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool TryAcquire
+(
+    le_spinlock_t*  lockPtr
+)
+{
+    int32_t expected = STATE_UNLOCKED;
+
+    return __atomic_compare_exchange_n(&lockPtr->state, &expected, STATE_LOCKED, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+
+// ==============================
+//  PUBLIC API FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Init
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+)
+{
+    lockPtr->state = STATE_UNLOCKED;
+    lockPtr->spinCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Lock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+)
+{
+    if (TryAcquire(lockPtr))
+    {
+        return;
+    }
+
+    // NOTE: the spin count is only a hint, so it is updated without any synchronization.
+    int32_t spinCount = __atomic_load_n(&lockPtr->spinCount, __ATOMIC_RELAXED);
+    int32_t maxSpins = spinCount * 2 + 10;
+    if (maxSpins > MAX_SPINS)
+    {
+        maxSpins = MAX_SPINS;
+    }
+
+    int32_t spins;
+    for (spins = 0; spins < maxSpins; spins++)
+    {
+        CpuRelax();
+
+        // Only try to take the lock when it looks free, so as not to bounce its cache line around.
+        if ((__atomic_load_n(&lockPtr->state, __ATOMIC_RELAXED) == STATE_UNLOCKED) &&
+            TryAcquire(lockPtr))
+        {
+            __atomic_store_n(&lockPtr->spinCount, spinCount + (spins - spinCount) / 8,
+                             __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    __atomic_store_n(&lockPtr->spinCount, spinCount + (maxSpins - spinCount) / 8,
+                     __ATOMIC_RELAXED);
+
+    // Out of spins: mark the lock contended, so that whoever releases it wakes a sleeper up, and
+    // sleep until the lock was found unlocked.
+    while (__atomic_exchange_n(&lockPtr->state, STATE_CONTENDED, __ATOMIC_ACQUIRE)
+           != STATE_UNLOCKED)
+    {
+        (void)syscall(SYS_futex, &lockPtr->state, FUTEX_WAIT_PRIVATE, STATE_CONTENDED,
+                      NULL, NULL, 0);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to lock a spin lock, without spinning.
+ *
+ * @return
+ *  - LE_OK if the lock was taken.
+ *  - LE_WOULD_BLOCK if the lock is held by someone.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spinlock_TryLock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+)
+{
+    return (TryAcquire(lockPtr) ? LE_OK : LE_WOULD_BLOCK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlock a spin lock.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_spinlock_Unlock
+(
+    le_spinlock_t*  lockPtr     ///< [in] Spin lock
+)
+{
+    int32_t state = __atomic_exchange_n(&lockPtr->state, STATE_UNLOCKED, __ATOMIC_RELEASE);
+
+    LE_FATAL_IF(state == STATE_UNLOCKED, "Spin lock %p unlocked while not locked!", lockPtr);
+
+    if (state == STATE_CONTENDED)
+    {
+        (void)syscall(SYS_futex, &lockPtr->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
@@ -0,0 +1,203 @@
+/** @file startupTrace.c
+ *
+ * Start-up timeline tracing.  See startupTrace.h for an overview.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "startupTrace.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest trace entry that will be written, including the newline.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_ENTRY_BYTES     160
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Microseconds per second.
+ */
+//--------------------------------------------------------------------------------------------------
+#define US_PER_SEC          1000000ULL
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the events, as written in the trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* EventNames[STARTUP_TRACE_EVENT_COUNT] =
+{
+    [STARTUP_TRACE_EVENT_LOOP] = "loop",
+    [STARTUP_TRACE_EVENT_INIT] = "init",
+    [STARTUP_TRACE_EVENT_ADVERTISE] = "advertise",
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Which events have been recorded in this process.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsMarked[STARTUP_TRACE_EVENT_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an entry to the trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteEntry
+(
+    uint64_t timeUs,            ///< [IN] Time of the event, in microseconds since boot.
+    const char* eventPtr,       ///< [IN] Event name.
+    const char* detailPtr       ///< [IN] Extra detail, or NULL.
+)
+{
+    char entry[MAX_ENTRY_BYTES];
+    int len = snprintf(entry, sizeof(entry), "%" PRIu64 " %d %s %s %s\n",
+                       timeUs,
+                       (int)getpid(),
+                       program_invocation_short_name,
+                       eventPtr,
+                       (detailPtr != NULL) ? detailPtr : "-");
+
+    if ((len < 0) || (len >= (int)sizeof(entry)))
+    {
+        return;
+    }
+
+    // Failing to open the file is normal for processes without access to the runtime directory.
+    int fd = open(STARTUP_TRACE_FILE, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat fileStat;
+
+    if ((fstat(fd, &fileStat) == 0) && (fileStat.st_size < STARTUP_TRACE_MAX_FILE_BYTES))
+    {
+        ssize_t result;
+
+        // Nothing can be done if this fails.
+        do
+        {
+            result = write(fd, entry, len);
+        }
+        while ((result == -1) && (errno == EINTR));
+    }
+
+    close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time since boot.
+ *
+ * @return Time in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetNowUs
+(
+    void
+)
+{
+    struct timespec now;
+
+    if (clock_gettime(CLOCK_BOOTTIME, &now) != 0)
+    {
+        return 0;
+    }
+
+    return (uint64_t)now.tv_sec * US_PER_SEC + now.tv_nsec / 1000;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time at which this process was forked, from the starttime field of /proc/self/stat.
+ *
+ * @return Time in microseconds since boot, or 0 if it isn't known.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetForkTimeUs
+(
+    void
+)
+{
+    char stat[512];
+    int fd = open("/proc/self/stat", O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    ssize_t len = read(fd, stat, sizeof(stat) - 1);
+    close(fd);
+
+    if (len <= 0)
+    {
+        return 0;
+    }
+
+    stat[len] = '\0';
+
+    // The process name (field 2) can contain spaces and parentheses, so start after the last ')'.
+    // The start time is then the 20th field (field 22 of the whole line).
+    char* fieldPtr = strrchr(stat, ')');
+    unsigned long long startTicks;
+    long ticksPerSec = sysconf(_SC_CLK_TCK);
+
+    if (   (fieldPtr == NULL)
+        || (ticksPerSec <= 0)
+        || (sscanf(fieldPtr + 1,
+                   " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d"
+                   " %llu", &startTicks) != 1) )
+    {
+        return 0;
+    }
+
+    return startTicks * US_PER_SEC / ticksPerSec;
+}
+
+
+void startupTrace_Init
+(
+    void
+)
+{
+    uint64_t execTimeUs = GetNowUs();
+    uint64_t forkTimeUs = GetForkTimeUs();
+
+    if (forkTimeUs != 0)
+    {
+        WriteEntry(forkTimeUs, "fork", NULL);
+    }
+
+    WriteEntry(execTimeUs, "exec", NULL);
+}
+
+
+void startupTrace_Mark
+(
+    startupTrace_Event_t event,
+    const char* detailPtr
+)
+{
+    LE_ASSERT(event < STARTUP_TRACE_EVENT_COUNT);
+
+    if (__atomic_exchange_n(&IsMarked[event], true, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    WriteEntry(GetNowUs(), EventNames[event], detailPtr);
+}
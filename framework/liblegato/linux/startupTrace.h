@@ -0,0 +1,83 @@
+/**
+ * @file startupTrace.h
+ *
+ * Start-up timeline tracing.
+ *
+ * Every process that uses the framework library appends a few time-stamped entries to a shared
+ * trace file in the runtime directory as it starts: when it was forked, when it was exec'd,
+ * when it first entered its event loop, when its component initializers finished, and when it
+ * first advertised an IPC service.  The file can be viewed with "inspect startup".
+ *
+ * Each entry is one line of the form "<usec since boot> <pid> <process name> <event> <detail>",
+ * written with a single append, so entries from different processes never interleave.  Times are
+ * taken from CLOCK_BOOTTIME.  Processes that can't open the file (e.g., sandboxed apps) just don't
+ * record anything, and nothing more is recorded once the file reaches
+ * STARTUP_TRACE_MAX_FILE_BYTES.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_STARTUP_TRACE_INCLUDE_GUARD
+#define LEGATO_SRC_STARTUP_TRACE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the start-up trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STARTUP_TRACE_FILE          STRINGIZE(LE_RUNTIME_DIR) "startupTrace"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size beyond which the start-up trace file stops growing.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STARTUP_TRACE_MAX_FILE_BYTES    (256 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events that are recorded in the start-up trace.  Only the first of each is recorded in each
+ * process.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    STARTUP_TRACE_EVENT_LOOP,       ///< Entered the event loop for the first time.
+    STARTUP_TRACE_EVENT_INIT,       ///< All the component initializers have returned.
+    STARTUP_TRACE_EVENT_ADVERTISE,  ///< Advertised an IPC service (detail = service name).
+
+    STARTUP_TRACE_EVENT_COUNT       ///< Number of events.  Not an event.
+}
+startupTrace_Event_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the start-up trace module, and record when the process was forked and exec'd.
+ *
+ * Called by the framework library's constructor.
+ */
+//--------------------------------------------------------------------------------------------------
+void startupTrace_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record an event in the start-up trace, unless it has already been recorded in this process.
+ * Safe to call from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void startupTrace_Mark
+(
+    startupTrace_Event_t event,     ///< [IN] Event that happened.
+    const char* detailPtr           ///< [IN] Extra detail (no spaces), or NULL if none.
+);
+
+
+#endif // LEGATO_SRC_STARTUP_TRACE_INCLUDE_GUARD
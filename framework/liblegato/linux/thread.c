@@ -28,11 +28,19 @@
  * thread-specific data, so le_thread_CleanupLegatoThreadData() doesn't need to be called in that
  * case.
  *
+ * When the main function of a reusable thread (see le_thread_SetReusable()) returns, its pthread
+ * doesn't die.  It runs the thread's destructors and deletes its thread object as usual, but keeps
+ * the file descriptors of its event loop and timers, and waits on the Parked Thread List for
+ * another reusable thread with the same attributes to be started.  That thread's thread object is
+ * then run by the parked pthread, without creating a new pthread or new file descriptors.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
 #include "legato.h"
 #include "thread.h"
+#include "procStats.h"
+#include "fileDescriptor.h"
 
 
 /// Expected number of threads in the process.
@@ -40,6 +48,23 @@
 #define THREAD_POOL_SIZE    4
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of parked threads (see le_thread_SetReusable()).  A reusable thread that finishes
+ * when there are already that many dies instead.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PARKED_THREADS              4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of seconds a parked thread waits to be reused, before it dies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARKED_THREAD_TIMEOUT_SEC       30
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Nice level definitions for the different Legato priority levels.
@@ -124,6 +149,43 @@ static le_mem_PoolRef_t DestructorPool;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // Pthreads FAST mutex.
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A parked thread: a pthread whose reusable thread has finished, and which keeps that thread's
+ * resources while it waits for another reusable thread to run.  These live on the parked
+ * pthread's stack.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t           link;           ///< Link in the Parked Thread List.
+    pthread_t               threadHandle;   ///< The pthreads thread handle.
+    le_thread_Priority_t    priority;       ///< Priority the pthread runs at.
+    size_t                  stackSize;      ///< Stack size of the pthread.
+    int                     epollFd;        ///< The event loop's epoll fd.
+    int                     eventQueueFd;   ///< The event loop's eventfd.
+    int                     timerFd;        ///< The timerFD (-1 if none).
+    thread_Obj_t*           threadPtr;      ///< Thread to run next (NULL while parked).
+}
+ParkedThread_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of parked threads, most recently parked first.  Protected by the module's Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t ParkedThreadList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Condition signalled, with the module's Mutex, when parked threads are given a thread to run.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_cond_t ParkedThreadCond;
+
+
 
 // ===================================
 //  PRIVATE FUNCTIONS
@@ -208,18 +270,36 @@ static void DeleteThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Clean-up function that gets run by a thread just before it dies.
- */
+ * Invalidate a thread object's safe reference, remove it from the thread object list, and free
+ * it.
+ **/
 //--------------------------------------------------------------------------------------------------
-static void CleanupThread
+static void ReleaseThread
 (
-    void* objPtr    ///< Pointer to the Thread object.
+    thread_Obj_t* threadPtr
 )
 {
-    thread_Obj_t* threadObjPtr = objPtr;
+    Lock();
+    le_ref_DeleteRef(ThreadRefMap, threadPtr->safeRef);
+    ThreadObjListChangeCount++;
+    le_dls_Remove(&ThreadObjList, &(threadPtr->link));
+    procStats_Add(PROCSTATS_THREADS, -1);
+    Unlock();
+
+    DeleteThread(threadPtr);
+}
 
-    threadObjPtr->state = THREAD_STATE_DYING;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call all the destructors of a thread that is finishing.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunDestructors
+(
+    thread_Obj_t* threadObjPtr      ///< Pointer to the Thread object.
+)
+{
     // Call all destructors in the list.
     le_dls_Link_t* destructorLinkPtr;
     while ((destructorLinkPtr = le_dls_Pop(&threadObjPtr->destructorList)) != NULL)
@@ -237,6 +317,24 @@ static void CleanupThread
         // Free the destructor object.
         le_mem_Release(destructorObjPtr);
     }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clean-up function that gets run by a thread just before it dies.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CleanupThread
+(
+    void* objPtr    ///< Pointer to the Thread object.
+)
+{
+    thread_Obj_t* threadObjPtr = objPtr;
+
+    threadObjPtr->state = THREAD_STATE_DYING;
+
+    RunDestructors(threadObjPtr);
 
     // Destruct the event loop.
     event_DestructThread();
@@ -250,14 +348,140 @@ static void CleanupThread
     // joins with it.
     if (! threadObjPtr->isJoinable)
     {
-        Lock();
-        le_ref_DeleteRef(ThreadRefMap, threadObjPtr->safeRef);
-        ThreadObjListChangeCount++;
-        le_dls_Remove(&ThreadObjList, &(threadObjPtr->link));
-        Unlock();
+        ReleaseThread(threadObjPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parks the calling thread when its reusable thread's main function has returned: cleans up the
+ * thread like CleanupThread() does, but keeps its event loop and timer file descriptors, and waits
+ * for another reusable thread to be started with the same attributes (see StartParkedThread()).
+ *
+ * @return
+ *      true if there is another thread to run (in parkedPtr->threadPtr).
+ *      false if the calling pthread must die (its file descriptors have been closed).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParkThread
+(
+    thread_Obj_t* threadPtr,        ///< [in] Thread whose main function has returned.
+    ParkedThread_t* parkedPtr       ///< [out] Where to keep the thread's resources.
+)
+{
+    int oldCancelState;
+
+    // There is no thread object to clean up if the pthread gets cancelled while it's parked.
+    LE_ASSERT(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldCancelState) == 0);
+
+    threadPtr->state = THREAD_STATE_DYING;
+
+    RunDestructors(threadPtr);
+
+    // Hand over the file descriptors; the FD Monitor of the timerFD is deleted with the event
+    // loop's, so the timer module is done after it.
+    event_ParkThread(&parkedPtr->epollFd, &parkedPtr->eventQueueFd);
+    parkedPtr->timerFd = timer_ParkThread();
+
+    parkedPtr->link = LE_DLS_LINK_INIT;
+    parkedPtr->threadHandle = pthread_self();
+    parkedPtr->priority = threadPtr->priority;
+    LE_ASSERT(pthread_attr_getstacksize(&(threadPtr->attr), &parkedPtr->stackSize) == 0);
+    parkedPtr->threadPtr = NULL;
+
+    // Reusable threads are never joinable.
+    ReleaseThread(threadPtr);
+    LE_ASSERT(pthread_setspecific(ThreadLocalDataKey, NULL) == 0);
+
+    struct timespec deadline;
+    LE_ASSERT(clock_gettime(CLOCK_MONOTONIC, &deadline) == 0);
+    deadline.tv_sec += PARKED_THREAD_TIMEOUT_SEC;
+
+    Lock();
+
+    if (le_dls_NumLinks(&ParkedThreadList) < MAX_PARKED_THREADS)
+    {
+        le_dls_Stack(&ParkedThreadList, &parkedPtr->link);
+
+        while (parkedPtr->threadPtr == NULL)
+        {
+            if ( (pthread_cond_timedwait(&ParkedThreadCond, &Mutex, &deadline) == ETIMEDOUT)
+                && (parkedPtr->threadPtr == NULL) )
+            {
+                le_dls_Remove(&ParkedThreadList, &parkedPtr->link);
+                break;
+            }
+        }
+    }
+
+    Unlock();
+
+    LE_ASSERT(pthread_setcancelstate(oldCancelState, NULL) == 0);
+
+    if (parkedPtr->threadPtr == NULL)
+    {
+        fd_Close(parkedPtr->epollFd);
+        fd_Close(parkedPtr->eventQueueFd);
+        if (parkedPtr->timerFd != -1)
+        {
+            fd_Close(parkedPtr->timerFd);
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hands a reusable thread that is being started over to a parked thread with the same attributes,
+ * if there is one.
+ *
+ * @return
+ *      true if a parked thread will run the thread.
+ *      false if there is no such parked thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StartParkedThread
+(
+    thread_Obj_t* threadPtr         ///< [in] Thread being started.
+)
+{
+    size_t stackSize;
+    bool isStarted = false;
+
+    LE_ASSERT(pthread_attr_getstacksize(&(threadPtr->attr), &stackSize) == 0);
+
+    Lock();
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&ParkedThreadList);
+
+    while (linkPtr != NULL)
+    {
+        ParkedThread_t* parkedPtr = CONTAINER_OF(linkPtr, ParkedThread_t, link);
 
-        DeleteThread(threadObjPtr);
+        if ((parkedPtr->priority == threadPtr->priority) && (parkedPtr->stackSize == stackSize))
+        {
+            le_dls_Remove(&ParkedThreadList, linkPtr);
+
+            threadPtr->state = THREAD_STATE_RUNNING;
+            threadPtr->threadHandle = parkedPtr->threadHandle;
+            parkedPtr->threadPtr = threadPtr;
+            LE_ASSERT(pthread_cond_broadcast(&ParkedThreadCond) == 0);
+
+            isStarted = true;
+            break;
+        }
+
+        linkPtr = le_dls_PeekNext(&ParkedThreadList, linkPtr);
     }
+
+    Unlock();
+
+    return isStarted;
 }
 
 
@@ -277,6 +501,9 @@ void thread_InitThread
     // Init the thread's mutex.
     sem_ThreadInit();
 
+    // Init the thread's reader-writer lock tracking structures.
+    rwlock_ThreadInit();
+
     // Init the event loop.
     event_InitThread();
 
@@ -287,37 +514,34 @@ void thread_InitThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This is a pthread start routine function wrapper.  We pass this function to the created pthread
- * and we pass the thread object as a parameter to this function.  This function then calls the
- * user's main function.
- * We do this because the user's main function has a different format then the start routine that
- * pthread expects.
+ * Perform thread specific initialization for the current thread, reusing the file descriptors
+ * kept by the parked thread that runs it.
  */
 //--------------------------------------------------------------------------------------------------
-static void* PThreadStartRoutine
+static void InitReusedThread
 (
-    void* threadObjPtr
+    const ParkedThread_t* parkedPtr
 )
 {
-    void* returnValue;
-    thread_Obj_t* threadPtr = threadObjPtr;
-
-    // WARNING: This code must be very carefully crafted to avoid the possibility of hitting
-    //          a cancellation point before pthread_cleanup_push() is called.  Otherwise, it's
-    //          possible that any destructor function set before the thread was started will
-    //          not get executed, which could create intermittent resource leaks.
-
-    // Store the Thread Object pointer in thread-local storage so GetCurrentThreadPtr() can
-    // find it later.
-    // NOTE: pthread_setspecific() is not a cancellation point.
-    if (pthread_setspecific(ThreadLocalDataKey, threadPtr) != 0)
-    {
-        LE_FATAL("pthread_setspecific() failed!");
-    }
+    mutex_ThreadInit();
+    sem_ThreadInit();
+    rwlock_ThreadInit();
+    event_InitReusedThread(parkedPtr->epollFd, parkedPtr->eventQueueFd);
+    timer_InitReusedThread(parkedPtr->timerFd);
+}
 
-    // Push the default destructor onto the thread's cleanup stack.
-    pthread_cleanup_push(CleanupThread, threadPtr);
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies the priority of the calling thread, for the priorities that can only be set once the
+ * thread is running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyPriority
+(
+    thread_Obj_t* threadPtr
+)
+{
     // If the thread is supposed to run in the background (at IDLE priority), then
     // switch to that scheduling policy now.
     if (threadPtr->priority == LE_THREAD_PRIORITY_IDLE)
@@ -362,17 +586,74 @@ static void* PThreadStartRoutine
             LE_DEBUG("Set nice level to %d.", niceLevel);
         }
     }
+}
 
-    // Perform thread specific init
-    thread_InitThread();
 
-    // Call the user's main function.
-    returnValue = threadPtr->mainFunc(threadPtr->context);
+//--------------------------------------------------------------------------------------------------
+/**
+ * This is a pthread start routine function wrapper.  We pass this function to the created pthread
+ * and we pass the thread object as a parameter to this function.  This function then calls the
+ * user's main function.
+ * We do this because the user's main function has a different format then the start routine that
+ * pthread expects.
+ *
+ * If the thread is reusable, the pthread is parked when the main function returns, and this
+ * function then calls the main function of the next reusable thread it is given, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PThreadStartRoutine
+(
+    void* threadObjPtr
+)
+{
+    void* returnValue;
+    thread_Obj_t* threadPtr = threadObjPtr;
+    ParkedThread_t parked;
+    bool isReused = false;
+
+    for (;;)
+    {
+        // WARNING: This code must be very carefully crafted to avoid the possibility of hitting
+        //          a cancellation point before pthread_cleanup_push() is called.  Otherwise, it's
+        //          possible that any destructor function set before the thread was started will
+        //          not get executed, which could create intermittent resource leaks.
+
+        // Store the Thread Object pointer in thread-local storage so GetCurrentThreadPtr() can
+        // find it later.
+        // NOTE: pthread_setspecific() is not a cancellation point.
+        if (pthread_setspecific(ThreadLocalDataKey, threadPtr) != 0)
+        {
+            LE_FATAL("pthread_setspecific() failed!");
+        }
+
+        // Push the default destructor onto the thread's cleanup stack.
+        pthread_cleanup_push(CleanupThread, threadPtr);
+
+        // Perform thread specific init.  A reused pthread already runs at the thread's priority.
+        if (isReused)
+        {
+            InitReusedThread(&parked);
+        }
+        else
+        {
+            ApplyPriority(threadPtr);
+            thread_InitThread();
+        }
+
+        // Call the user's main function.
+        returnValue = threadPtr->mainFunc(threadPtr->context);
 
-    // Pop the default destructor and call it.
-    pthread_cleanup_pop(1);
+        // Pop the default destructor and call it, unless the thread is to be parked instead.
+        pthread_cleanup_pop(!threadPtr->isReusable);
 
-    return returnValue;
+        if ((!threadPtr->isReusable) || (!ParkThread(threadPtr, &parked)))
+        {
+            return returnValue;
+        }
+
+        threadPtr = parked.threadPtr;
+        isReused = true;
+    }
 }
 
 
@@ -421,6 +702,7 @@ static thread_Obj_t* CreateThread
 
     threadPtr->priority = LE_THREAD_PRIORITY_MEDIUM;
     threadPtr->isJoinable = false;
+    threadPtr->isReusable = false;
     threadPtr->state = THREAD_STATE_NEW;
     threadPtr->mainFunc = mainFunc;
     threadPtr->context = context;
@@ -429,6 +711,7 @@ static thread_Obj_t* CreateThread
 
     memset(&threadPtr->mutexRec, 0, sizeof(threadPtr->mutexRec));
     memset(&threadPtr->semaphoreRec, 0, sizeof(threadPtr->semaphoreRec));
+    memset(&threadPtr->rwLockRec, 0, sizeof(threadPtr->rwLockRec));
     memset(&threadPtr->eventRec, 0, sizeof(threadPtr->eventRec));
     memset(&threadPtr->timerRec, 0, sizeof(threadPtr->timerRec));
 
@@ -438,6 +721,7 @@ static thread_Obj_t* CreateThread
     threadPtr->safeRef = le_ref_CreateRef(ThreadRefMap, threadPtr);
     ThreadObjListChangeCount++;
     le_dls_Queue(&ThreadObjList, &(threadPtr->link));
+    procStats_Add(PROCSTATS_THREADS, 1);
     Unlock();
 
     return threadPtr;
@@ -557,6 +841,13 @@ void thread_Init
     // Create the destructor object pool.
     DestructorPool = le_mem_CreatePool("DestructorObjs", sizeof(Destructor_t));
 
+    // Parked threads wait on a monotonic clock, which isn't the default.
+    pthread_condattr_t condAttr;
+    LE_ASSERT(pthread_condattr_init(&condAttr) == 0);
+    LE_ASSERT(pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC) == 0);
+    LE_ASSERT(pthread_cond_init(&ParkedThreadCond, &condAttr) == 0);
+    pthread_condattr_destroy(&condAttr);
+
     // Create the thread-local data key to be used to store a pointer to each thread object.
     LE_ASSERT(pthread_key_create(&ThreadLocalDataKey, NULL) == 0);
 
@@ -597,6 +888,19 @@ sem_ThreadRec_t* thread_GetSemaphoreRecPtr
     return &((GetCurrentThreadPtr())->semaphoreRec);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the calling thread's reader-writer lock record.
+ */
+//--------------------------------------------------------------------------------------------------
+rwlock_ThreadRec_t* thread_GetRwLockRecPtr
+(
+    void
+)
+{
+    return &((GetCurrentThreadPtr())->rwLockRec);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -812,11 +1116,50 @@ void le_thread_SetJoinable
                 "Attempt to make running thread '%s' joinable.",
                 threadPtr->name);
 
+    LE_FATAL_IF(threadPtr->isReusable,
+                "Attempt to make reusable thread '%s' joinable.",
+                threadPtr->name);
+
     threadPtr->isJoinable = true;
     LE_ASSERT(pthread_attr_setdetachstate(&(threadPtr->attr), PTHREAD_CREATE_JOINABLE) == 0);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a thread "reusable", meaning that when its main function returns, its underlying pthread
+ * and the file descriptors of its event loop and timers are kept for a while, to run another
+ * reusable thread started later with the same priority and stack size.  This saves the cost of
+ * creating a thread for components that start many short-lived threads.
+ *
+ * Reusable threads can't be joinable.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_thread_SetReusable
+(
+    le_thread_Ref_t         thread  ///< [in]
+)
+{
+    Lock();
+
+    thread_Obj_t* threadPtr = le_ref_Lookup(ThreadRefMap, thread);
+
+    Unlock();
+
+    LE_FATAL_IF(threadPtr == NULL, "Invalid thread reference %p.", thread);
+
+    LE_FATAL_IF(threadPtr->state != THREAD_STATE_NEW,
+                "Attempt to make running thread '%s' reusable.",
+                threadPtr->name);
+
+    LE_FATAL_IF(threadPtr->isJoinable,
+                "Attempt to make joinable thread '%s' reusable.",
+                threadPtr->name);
+
+    threadPtr->isReusable = true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts a new Legato thread of execution.  After creating the thread, you have the opportunity
@@ -840,6 +1183,12 @@ void le_thread_Start
                 "Attempt to start an already started thread (%s).",
                 threadPtr->name);
 
+    // A reusable thread is run by a parked pthread, if there is a suitable one.
+    if (threadPtr->isReusable && StartParkedThread(threadPtr))
+    {
+        return;
+    }
+
     // Start the thread with the default function PThreadStartRoutine, passing the
     // PThreadStartRoutine the thread object.  PThreadStartRoutine will then start the user's main
     // function.
@@ -937,6 +1286,7 @@ le_result_t le_thread_Join
                     le_ref_DeleteRef(ThreadRefMap, threadPtr->safeRef);
                     ThreadObjListChangeCount++;
                     le_dls_Remove(&ThreadObjList, &(threadPtr->link));
+                    procStats_Add(PROCSTATS_THREADS, -1);
                     Unlock();
                     DeleteThread(threadPtr);
 
@@ -12,6 +12,7 @@
 
 #include "eventLoop.h"
 #include "mutex.h"
+#include "rwLock.h"
 #include "semaphores.h"
 #include "timer.h"
 
@@ -40,6 +41,7 @@ typedef struct
     pthread_attr_t          attr;           ///< The thread's attributes.
     le_thread_Priority_t    priority;       ///< The thread's priority.
     bool                    isJoinable;     ///< true = the thread is joinable, false = detached.
+    bool                    isReusable;     ///< true = the thread is parked when it finishes.
 
     /// Thread state.
     enum
@@ -55,6 +57,7 @@ typedef struct
     le_dls_List_t           destructorList; ///< The destructor list for this thread.
     mutex_ThreadRec_t       mutexRec;       ///< The thread's mutex record.
     sem_ThreadRec_t         semaphoreRec;   ///< the thread's semaphore record.
+    rwlock_ThreadRec_t      rwLockRec;      ///< The thread's reader-writer lock record.
     event_PerThreadRec_t    eventRec;       ///< The thread's event record.
     pthread_t               threadHandle;   ///< The pthreads thread handle.
     le_thread_Ref_t         safeRef;        ///< Safe reference for this object.
@@ -133,6 +136,17 @@ sem_ThreadRec_t* thread_GetSemaphoreRecPtr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the calling thread's reader-writer lock record.
+ */
+//--------------------------------------------------------------------------------------------------
+rwlock_ThreadRec_t* thread_GetRwLockRecPtr
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the calling thread's event record.
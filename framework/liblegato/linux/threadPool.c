@@ -0,0 +1,709 @@
+/** @file threadPool.c
+ *
+ * Legato @ref c_threadPool implementation.
+ *
+ * Each worker thread has its own queue of tasks, protected by a spin lock.  A worker takes tasks
+ * from the tail of its own queue (most recently queued first, as their data is the most likely to
+ * still be in the caches), and when its queue is empty, steals tasks from the head of the other
+ * workers' queues (oldest first).  Tasks submitted from a worker thread go to that worker's queue;
+ * tasks submitted from other threads are spread over the workers' queues in turn.
+ *
+ * The pool counts the tasks that are queued but not started yet.  A worker that finds no task
+ * anywhere sleeps on the pool's condition variable until that count goes up.  Submitters only
+ * take the pool's mutex to wake a worker up if some worker is idle, so that a busy pool is fed
+ * without any thread ever going through that mutex.  (Both counts are updated and read with
+ * sequentially consistent atomics: either the submitter sees the idle worker, or the worker sees
+ * the new task before going to sleep.)
+ *
+ * The worker threads are created with pthread_create(), and made Legato threads with
+ * le_thread_InitLegatoThreadData().
+ *
+ * Parallel loops are spread over the workers by submitting "helper" tasks that, like the calling
+ * thread, take chunks of indexes from a shared counter until there are none left.  The caller
+ * never waits for a helper task to start: a helper that starts after all the chunks are taken
+ * finds nothing to do.  So the loop data is reference counted, as helpers may still use it after
+ * the caller has returned.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "threadPool.h"
+#include "thread.h"
+
+
+// ==============================
+//  PRIVATE DATA
+// ==============================
+
+/// Maximum number of bytes in a thread pool name (including null terminator).
+#define POOL_MAX_NAME_BYTES 16
+
+/// Number of chunks a parallel loop is split into per participating thread, to balance the load
+/// when some iterations take longer than others.
+#define CHUNKS_PER_THREAD 4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Task object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t                   link;           ///< Used to link onto a worker's queue.
+    le_threadPool_TaskFunc_t        taskFunc;       ///< Function to call in a worker thread.
+    le_threadPool_CompletionFunc_t  completionFunc; ///< Function to call when done (or NULL).
+    void*                           contextPtr;     ///< Context passed to both functions.
+    le_thread_Ref_t                 submitterRef;   ///< Thread to call the completion function in.
+}
+Task_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    struct le_threadPool*   poolPtr;    ///< Pool the worker belongs to.
+    size_t                  index;      ///< Index of the worker in its pool.
+    pthread_t               threadId;   ///< The worker's thread.
+    le_spinlock_t           queueLock;  ///< Protects the queue.
+    le_dls_List_t           queue;      ///< Tasks waiting to be run.
+}
+Worker_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread pool object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_threadPool
+{
+    size_t          numWorkers;     ///< Number of worker threads.
+    Worker_t*       workersPtr;     ///< Array of worker records.
+    size_t          nextWorker;     ///< Worker to queue the next task from another thread to.
+    uint32_t        pendingCount;   ///< Number of tasks queued but not started yet.
+    uint32_t        idleCount;      ///< Number of workers sleeping (or about to sleep).
+    bool            isStopping;     ///< true when the pool is being deleted.
+    pthread_mutex_t idleMutex;      ///< Protects the sleeping and the waking up of workers.
+    pthread_cond_t  idleCond;       ///< Signalled when a task is queued or the pool is stopping.
+    char            name[POOL_MAX_NAME_BYTES];  ///< Name of the pool.
+}
+ThreadPool_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parallel loop object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_threadPool_ForFunc_t forFunc;    ///< Function to call for each index.
+    void*                   contextPtr; ///< Context passed to the function.
+    size_t                  count;      ///< Number of iterations.
+    size_t                  chunkSize;  ///< Number of iterations taken at a time.
+    size_t                  nextIndex;  ///< First index of the next chunk to run.
+    size_t                  doneCount;  ///< Number of iterations done.
+    int32_t                 refCount;   ///< Number of threads (and tasks) using this object.
+    sem_t                   doneSem;    ///< Posted when all the iterations are done.
+}
+Loop_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools from which the thread pool, task and parallel loop objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ThreadPoolPoolRef;
+static le_mem_PoolRef_t TaskPoolRef;
+static le_mem_PoolRef_t LoopPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the thread-specific data pointing to the calling thread's worker record (NULL if the
+ * thread isn't a worker thread).
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t WorkerKey;
+
+
+// ==============================
+//  PRIVATE FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the calling thread's worker record if it is a worker of a given pool.
+ *
+ * @return Pointer to the worker record, or NULL if the calling thread isn't a worker of the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static Worker_t* GetCurrentWorker
+(
+    ThreadPool_t*   poolPtr
+)
+{
+    Worker_t* workerPtr = pthread_getspecific(WorkerKey);
+
+    if ((workerPtr != NULL) && (workerPtr->poolPtr == poolPtr))
+    {
+        return workerPtr;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a task to a worker and wake up an idle worker if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueTask
+(
+    ThreadPool_t*   poolPtr,
+    Worker_t*       workerPtr,
+    Task_t*         taskPtr
+)
+{
+    le_spinlock_Lock(&workerPtr->queueLock);
+    le_dls_Queue(&workerPtr->queue, &taskPtr->link);
+    le_spinlock_Unlock(&workerPtr->queueLock);
+
+    __atomic_add_fetch(&poolPtr->pendingCount, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&poolPtr->idleCount, __ATOMIC_SEQ_CST) > 0)
+    {
+        pthread_mutex_lock(&poolPtr->idleMutex);
+        pthread_cond_signal(&poolPtr->idleCond);
+        pthread_mutex_unlock(&poolPtr->idleMutex);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the next task to run for a worker: the last one queued to its own queue, or else the
+ * first one queued to another worker's queue.
+ *
+ * @return Pointer to the task, or NULL if all the queues are empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static Task_t* TakeTask
+(
+    ThreadPool_t*   poolPtr,
+    Worker_t*       workerPtr
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    le_spinlock_Lock(&workerPtr->queueLock);
+    linkPtr = le_dls_PopTail(&workerPtr->queue);
+    le_spinlock_Unlock(&workerPtr->queueLock);
+
+    size_t i;
+    for (i = 1; (linkPtr == NULL) && (i < poolPtr->numWorkers); i++)
+    {
+        Worker_t* victimPtr = &poolPtr->workersPtr[(workerPtr->index + i) % poolPtr->numWorkers];
+
+        // Don't bother taking the lock of a queue that looks empty.
+        if (le_dls_IsEmpty(&victimPtr->queue))
+        {
+            continue;
+        }
+
+        le_spinlock_Lock(&victimPtr->queueLock);
+        linkPtr = le_dls_Pop(&victimPtr->queue);
+        le_spinlock_Unlock(&victimPtr->queueLock);
+    }
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    __atomic_sub_fetch(&poolPtr->pendingCount, 1, __ATOMIC_SEQ_CST);
+
+    return CONTAINER_OF(linkPtr, Task_t, link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a worker to sleep until a task is queued or the pool is stopping.
+ *
+ * @return false if the worker must exit (the pool is stopping and there are no tasks left).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WaitForTask
+(
+    ThreadPool_t*   poolPtr
+)
+{
+    bool keepRunning = true;
+
+    pthread_mutex_lock(&poolPtr->idleMutex);
+
+    __atomic_add_fetch(&poolPtr->idleCount, 1, __ATOMIC_SEQ_CST);
+
+    while (__atomic_load_n(&poolPtr->pendingCount, __ATOMIC_SEQ_CST) == 0)
+    {
+        if (poolPtr->isStopping)
+        {
+            keepRunning = false;
+            break;
+        }
+
+        pthread_cond_wait(&poolPtr->idleCond, &poolPtr->idleMutex);
+    }
+
+    __atomic_sub_fetch(&poolPtr->idleCount, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&poolPtr->idleMutex);
+
+    return keepRunning;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a task's completion function.  Runs in the thread that submitted the task.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallCompletionFunc
+(
+    void* taskPtr,
+    void* unusedPtr
+)
+{
+    Task_t* tPtr = taskPtr;
+
+    tPtr->completionFunc(tPtr->contextPtr);
+
+    le_mem_Release(tPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a task, then hand it over to the submitting thread to call its completion function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunTask
+(
+    Task_t* taskPtr
+)
+{
+    taskPtr->taskFunc(taskPtr->contextPtr);
+
+    if (taskPtr->completionFunc != NULL)
+    {
+        le_event_QueueFunctionToThread(taskPtr->submitterRef, CallCompletionFunc, taskPtr, NULL);
+    }
+    else
+    {
+        le_mem_Release(taskPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* workerPtr
+)
+{
+    Worker_t* wPtr = workerPtr;
+    ThreadPool_t* poolPtr = wPtr->poolPtr;
+    char name[MAX_THREAD_NAME_SIZE];
+
+    snprintf(name, sizeof(name), "%s-%zu", poolPtr->name, wPtr->index);
+    le_thread_InitLegatoThreadData(name);
+
+    LE_ASSERT(pthread_setspecific(WorkerKey, wPtr) == 0);
+
+    do
+    {
+        Task_t* taskPtr;
+
+        while ((taskPtr = TakeTask(poolPtr, wPtr)) != NULL)
+        {
+            RunTask(taskPtr);
+        }
+    }
+    while (WaitForTask(poolPtr));
+
+    le_thread_CleanupLegatoThreadData();
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run chunks of a parallel loop until there are none left.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunLoopChunks
+(
+    Loop_t* loopPtr
+)
+{
+    for (;;)
+    {
+        size_t index = __atomic_fetch_add(&loopPtr->nextIndex, loopPtr->chunkSize,
+                                          __ATOMIC_RELAXED);
+        if (index >= loopPtr->count)
+        {
+            break;
+        }
+
+        size_t endIndex = index + loopPtr->chunkSize;
+        if (endIndex > loopPtr->count)
+        {
+            endIndex = loopPtr->count;
+        }
+
+        size_t chunkSize = endIndex - index;
+        for (; index < endIndex; index++)
+        {
+            loopPtr->forFunc(index, loopPtr->contextPtr);
+        }
+
+        if (__atomic_add_fetch(&loopPtr->doneCount, chunkSize, __ATOMIC_ACQ_REL) == loopPtr->count)
+        {
+            sem_post(&loopPtr->doneSem);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a reference to a parallel loop object, and free it when the last one is gone.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseLoop
+(
+    Loop_t* loopPtr
+)
+{
+    if (__atomic_sub_fetch(&loopPtr->refCount, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        sem_destroy(&loopPtr->doneSem);
+        le_mem_Release(loopPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Task function of the parallel loop helpers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoopHelper
+(
+    void* loopPtr
+)
+{
+    RunLoopChunks(loopPtr);
+    ReleaseLoop(loopPtr);
+}
+
+
+// ==============================
+//  INTRA-FRAMEWORK FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Thread Pool module.
+ *
+ * This function must be called exactly once at process start-up before any other threadPool
+ * module functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void threadPool_Init
+(
+    void
+)
+{
+    ThreadPoolPoolRef = le_mem_CreatePool("ThreadPool", sizeof(ThreadPool_t));
+    TaskPoolRef = le_mem_CreatePool("ThreadPoolTask", sizeof(Task_t));
+    LoopPoolRef = le_mem_CreatePool("ThreadPoolLoop", sizeof(Loop_t));
+
+    LE_ASSERT(pthread_key_create(&WorkerKey, NULL) == 0);
+}
+
+
+// ==============================
+//  PUBLIC API FUNCTIONS
+// ==============================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a thread pool and start its worker threads.
+ *
+ * @return Reference to the thread pool.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_threadPool_Ref_t le_threadPool_Create
+(
+    const char* nameStr,    ///< [in] Name of the pool (will be copied, so can be temporary).
+    size_t      numThreads  ///< [in] Number of worker threads, or 0 for one per online CPU.
+)
+{
+    if (numThreads == 0)
+    {
+        long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = (numCpus > 0) ? (size_t)numCpus : 1;
+    }
+
+    ThreadPool_t* poolPtr = le_mem_ForceAlloc(ThreadPoolPoolRef);
+    memset(poolPtr, 0, sizeof(*poolPtr));
+
+    if (le_utf8_Copy(poolPtr->name, nameStr, sizeof(poolPtr->name), NULL) == LE_OVERFLOW)
+    {
+        LE_WARN("Thread pool name '%s' truncated to '%s'.", nameStr, poolPtr->name);
+    }
+
+    poolPtr->numWorkers = numThreads;
+    poolPtr->workersPtr = calloc(numThreads, sizeof(Worker_t));
+    LE_ASSERT(poolPtr->workersPtr);
+
+    LE_ASSERT(pthread_mutex_init(&poolPtr->idleMutex, NULL) == 0);
+    LE_ASSERT(pthread_cond_init(&poolPtr->idleCond, NULL) == 0);
+
+    size_t i;
+    for (i = 0; i < numThreads; i++)
+    {
+        Worker_t* workerPtr = &poolPtr->workersPtr[i];
+
+        workerPtr->poolPtr = poolPtr;
+        workerPtr->index = i;
+        le_spinlock_Init(&workerPtr->queueLock);
+        workerPtr->queue = LE_DLS_LIST_INIT;
+    }
+
+    for (i = 0; i < numThreads; i++)
+    {
+        int result = pthread_create(&poolPtr->workersPtr[i].threadId, NULL, WorkerMain,
+                                    &poolPtr->workersPtr[i]);
+        LE_FATAL_IF(result != 0, "Failed to start worker %zu of thread pool '%s' (%s).",
+                    i, poolPtr->name, strerror(result));
+    }
+
+    return poolPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for all the tasks submitted to a thread pool, stop its worker threads and delete it.
+ *
+ * @warning Must not be called from one of the pool's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Delete
+(
+    le_threadPool_Ref_t poolRef ///< [in] Thread pool.
+)
+{
+    LE_FATAL_IF(GetCurrentWorker(poolRef) != NULL,
+                "Thread pool '%s' deleted by one of its own workers.", poolRef->name);
+
+    pthread_mutex_lock(&poolRef->idleMutex);
+    poolRef->isStopping = true;
+    pthread_cond_broadcast(&poolRef->idleCond);
+    pthread_mutex_unlock(&poolRef->idleMutex);
+
+    size_t i;
+    for (i = 0; i < poolRef->numWorkers; i++)
+    {
+        LE_ASSERT(pthread_join(poolRef->workersPtr[i].threadId, NULL) == 0);
+    }
+
+    pthread_cond_destroy(&poolRef->idleCond);
+    pthread_mutex_destroy(&poolRef->idleMutex);
+    free(poolRef->workersPtr);
+    le_mem_Release(poolRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restrict the worker threads of a thread pool to a set of CPUs.
+ *
+ * @return
+ *  - LE_OK on success.
+ *  - LE_BAD_PARAMETER if the mask doesn't contain any online CPU.
+ *  - LE_FAULT on any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_threadPool_SetCpuAffinity
+(
+    le_threadPool_Ref_t poolRef,    ///< [in] Thread pool.
+    uint64_t            cpuMask     ///< [in] Bit n set if the workers may run on CPU n.
+)
+{
+    cpu_set_t cpuSet;
+    int cpu;
+
+    CPU_ZERO(&cpuSet);
+    for (cpu = 0; cpu < 64; cpu++)
+    {
+        if (cpuMask & ((uint64_t)1 << cpu))
+        {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+
+    size_t i;
+    for (i = 0; i < poolRef->numWorkers; i++)
+    {
+        int result = pthread_setaffinity_np(poolRef->workersPtr[i].threadId, sizeof(cpuSet),
+                                            &cpuSet);
+        if (result == EINVAL)
+        {
+            LE_ERROR("No online CPU in mask 0x%" PRIx64 " for thread pool '%s'.",
+                     cpuMask, poolRef->name);
+            return LE_BAD_PARAMETER;
+        }
+        else if (result != 0)
+        {
+            LE_ERROR("Failed to set CPU affinity of thread pool '%s' (%s).",
+                     poolRef->name, strerror(result));
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of worker threads of a thread pool.
+ *
+ * @return The number of worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_threadPool_GetThreadCount
+(
+    le_threadPool_Ref_t poolRef ///< [in] Thread pool.
+)
+{
+    return poolRef->numWorkers;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit a task to a thread pool.
+ *
+ * The task function will be called in one of the pool's worker threads.  If a completion
+ * function is given, it will then be queued to the calling thread's Event Loop.
+ *
+ * @note Terminates the process on failure, so no need to check for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Submit
+(
+    le_threadPool_Ref_t             poolRef,        ///< [in] Thread pool.
+    le_threadPool_TaskFunc_t        taskFunc,       ///< [in] Function to call in a worker.
+    le_threadPool_CompletionFunc_t  completionFunc, ///< [in] Function to call when done, or NULL.
+    void*                           contextPtr      ///< [in] Context passed to both functions.
+)
+{
+    LE_ASSERT(taskFunc != NULL);
+
+    Task_t* taskPtr = le_mem_ForceAlloc(TaskPoolRef);
+
+    taskPtr->link = LE_DLS_LINK_INIT;
+    taskPtr->taskFunc = taskFunc;
+    taskPtr->completionFunc = completionFunc;
+    taskPtr->contextPtr = contextPtr;
+    taskPtr->submitterRef = (completionFunc != NULL) ? le_thread_GetCurrent() : NULL;
+
+    Worker_t* workerPtr = GetCurrentWorker(poolRef);
+    if (workerPtr == NULL)
+    {
+        size_t index = __atomic_fetch_add(&poolRef->nextWorker, 1, __ATOMIC_RELAXED);
+        workerPtr = &poolRef->workersPtr[index % poolRef->numWorkers];
+    }
+
+    QueueTask(poolRef, workerPtr, taskPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a function for each index from 0 to count - 1, in parallel on the worker threads of a
+ * thread pool and on the calling thread, and wait for all the calls to be done.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_ParallelFor
+(
+    le_threadPool_Ref_t     poolRef,    ///< [in] Thread pool.
+    size_t                  count,      ///< [in] Number of iterations.
+    le_threadPool_ForFunc_t forFunc,    ///< [in] Function to call for each index.
+    void*                   contextPtr  ///< [in] Context passed to the function.
+)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    size_t chunkSize = count / ((poolRef->numWorkers + 1) * CHUNKS_PER_THREAD);
+    if (chunkSize == 0)
+    {
+        chunkSize = 1;
+    }
+
+    // One helper per worker, but no more than there are chunks for the helpers to take.
+    size_t numHelpers = (count + chunkSize - 1) / chunkSize - 1;
+    if (numHelpers > poolRef->numWorkers)
+    {
+        numHelpers = poolRef->numWorkers;
+    }
+
+    Loop_t* loopPtr = le_mem_ForceAlloc(LoopPoolRef);
+
+    loopPtr->forFunc = forFunc;
+    loopPtr->contextPtr = contextPtr;
+    loopPtr->count = count;
+    loopPtr->chunkSize = chunkSize;
+    loopPtr->nextIndex = 0;
+    loopPtr->doneCount = 0;
+    loopPtr->refCount = numHelpers + 1;
+    LE_ASSERT(sem_init(&loopPtr->doneSem, 0, 0) == 0);
+
+    size_t i;
+    for (i = 0; i < numHelpers; i++)
+    {
+        le_threadPool_Submit(poolRef, LoopHelper, NULL, loopPtr);
+    }
+
+    RunLoopChunks(loopPtr);
+
+    while (sem_wait(&loopPtr->doneSem) != 0)
+    {
+        LE_ASSERT(errno == EINTR);
+    }
+
+    ReleaseLoop(loopPtr);
+}
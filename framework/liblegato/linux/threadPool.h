@@ -0,0 +1,26 @@
+/** @file threadPool.h
+ *
+ * Thread Pool module's intra-framework header file.  This file exposes function interfaces to
+ * other modules inside the framework implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_THREADPOOL_H_INCLUDE_GUARD
+#define LEGATO_SRC_THREADPOOL_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Thread Pool module.
+ *
+ * This function must be called exactly once at process start-up before any other threadPool
+ * module functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void threadPool_Init
+(
+    void
+);
+
+
+#endif /* LEGATO_SRC_THREADPOOL_H_INCLUDE_GUARD */
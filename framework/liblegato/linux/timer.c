@@ -9,6 +9,7 @@
 #include "legato.h"
 #include "timer.h"
 #include "thread.h"
+#include "procStats.h"
 #include "fileDescriptor.h"
 #include <sys/timerfd.h>
 #include "fileDescriptor.h"
@@ -110,6 +111,7 @@ static Timer_t* CreateTimer
     timerPtr->interval = (le_clk_Time_t){0, 0};
     timerPtr->repeatCount = 1;
     timerPtr->contextPtr = NULL;
+    timerPtr->tolerance = (le_clk_Time_t){0, 0};
     timerPtr->link = LE_DLS_LINK_INIT;
     timerPtr->isActive = false;
     timerPtr->expiryTime = (le_clk_Time_t){0, 0};
@@ -121,6 +123,358 @@ static Timer_t* CreateTimer
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a timer has been given a non-zero tolerance.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool HasTolerance
+(
+    Timer_t* timerPtr                   ///< [IN] The timer to check.
+)
+{
+    return ((timerPtr->tolerance.sec != 0) || (timerPtr->tolerance.usec != 0));
+}
+
+
+#ifdef LE_TIMER_HEAP
+
+//--------------------------------------------------------------------------------------------------
+// Pairing heap implementation of the per-thread timer queue.
+//
+// The running timers of each thread are kept in a pairing heap ordered by expiry time, so that
+// starting a timer takes constant time and stopping or expiring one takes O(log n) amortized time,
+// however many timers are running.  Each heap node points to its first child, its next sibling,
+// and to either its parent (if it is a first child) or its previous sibling.
+//
+// The active timer list is still maintained, unsorted, so the Inspect tool can list the timers.
+//--------------------------------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether one timer is due to expire before another.  Timers with the same expiry time are
+ * ordered by when they were started, as they are on a sorted timer list.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsEarlier
+(
+    Timer_t* aPtr,                      ///< [IN] First timer.
+    Timer_t* bPtr                       ///< [IN] Second timer.
+)
+{
+    if (le_clk_Equal(aPtr->expiryTime, bPtr->expiryTime))
+    {
+        return ((int32_t)(aPtr->heapSeqNum - bPtr->heapSeqNum) < 0);
+    }
+
+    return le_clk_GreaterThan(bPtr->expiryTime, aPtr->expiryTime);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Merge two heaps, whose roots must have no siblings.
+ *
+ * @return  The root of the merged heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* MeldHeaps
+(
+    Timer_t* aPtr,                      ///< [IN] Root of the first heap (can be NULL).
+    Timer_t* bPtr                       ///< [IN] Root of the second heap (can be NULL).
+)
+{
+    if (aPtr == NULL)
+    {
+        return bPtr;
+    }
+    if (bPtr == NULL)
+    {
+        return aPtr;
+    }
+
+    if (IsEarlier(bPtr, aPtr))
+    {
+        Timer_t* tempPtr = aPtr;
+        aPtr = bPtr;
+        bPtr = tempPtr;
+    }
+
+    // Make the later root the first child of the earlier one.
+    bPtr->heapSiblingPtr = aPtr->heapChildPtr;
+    if (bPtr->heapSiblingPtr != NULL)
+    {
+        bPtr->heapSiblingPtr->heapPrevPtr = bPtr;
+    }
+    bPtr->heapPrevPtr = aPtr;
+    aPtr->heapChildPtr = bPtr;
+
+    return aPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Merge a list of sibling heaps into a single heap, using the standard two-pass pairing.
+ *
+ * @return  The root of the merged heap, or NULL if the list was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* MergePairs
+(
+    Timer_t* firstPtr                   ///< [IN] First heap in the sibling list (can be NULL).
+)
+{
+    Timer_t* pairListPtr = NULL;
+
+    // First pass: meld the heaps in pairs from left to right, stacking up the results.
+    while (firstPtr != NULL)
+    {
+        Timer_t* aPtr = firstPtr;
+        Timer_t* bPtr = aPtr->heapSiblingPtr;
+
+        firstPtr = (bPtr != NULL) ? bPtr->heapSiblingPtr : NULL;
+
+        aPtr->heapSiblingPtr = NULL;
+        aPtr->heapPrevPtr = NULL;
+        if (bPtr != NULL)
+        {
+            bPtr->heapSiblingPtr = NULL;
+            bPtr->heapPrevPtr = NULL;
+            aPtr = MeldHeaps(aPtr, bPtr);
+        }
+
+        aPtr->heapSiblingPtr = pairListPtr;
+        pairListPtr = aPtr;
+    }
+
+    // Second pass: meld the pairs together from right to left.
+    Timer_t* rootPtr = NULL;
+
+    while (pairListPtr != NULL)
+    {
+        Timer_t* nextPtr = pairListPtr->heapSiblingPtr;
+
+        pairListPtr->heapSiblingPtr = NULL;
+        rootPtr = MeldHeaps(rootPtr, pairListPtr);
+        pairListPtr = nextPtr;
+    }
+
+    return rootPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the timer record to the thread's timer queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToTimerList
+(
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread's timer record.
+    Timer_t* newTimerPtr                  ///< [IN] The timer to add
+)
+{
+    if ( newTimerPtr->isActive )
+    {
+        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
+        return;
+    }
+
+    TimerListChangeCount++;
+    le_dls_Queue(&threadRecPtr->activeTimerList, &newTimerPtr->link);
+    procStats_Add(PROCSTATS_RUNNING_TIMERS, 1);
+
+    newTimerPtr->heapChildPtr = NULL;
+    newTimerPtr->heapSiblingPtr = NULL;
+    newTimerPtr->heapPrevPtr = NULL;
+    newTimerPtr->heapSeqNum = threadRecPtr->heapSeqNum++;
+    threadRecPtr->heapRootPtr = MeldHeaps(threadRecPtr->heapRootPtr, newTimerPtr);
+
+    if (HasTolerance(newTimerPtr))
+    {
+        threadRecPtr->heapTolerantCount++;
+    }
+
+    // The new timer is now on the active list
+    newTimerPtr->isActive = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Peek at the first timer from the thread's timer queue
+ *
+ * @return:
+ *      - pointer to the first timer on the list
+ *      - NULL if the list is empty
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PeekFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
+)
+{
+    return threadRecPtr->heapRootPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the timer from the thread's timer queue
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the timer was not in the list
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RemoveFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    Timer_t* timerPtr                   ///< [IN] The timer to remove
+)
+{
+    if ( ! timerPtr->isActive )
+    {
+        return LE_FAULT;
+    }
+
+    // Remove the timer from the active list
+    timerPtr->isActive = false;
+    TimerListChangeCount++;
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+    procStats_Add(PROCSTATS_RUNNING_TIMERS, -1);
+
+    if (timerPtr == threadRecPtr->heapRootPtr)
+    {
+        threadRecPtr->heapRootPtr = MergePairs(timerPtr->heapChildPtr);
+    }
+    else
+    {
+        // Unlink the timer's sub-heap from its parent or previous sibling, then merge the
+        // timer's children back into the heap.
+        Timer_t* prevPtr = timerPtr->heapPrevPtr;
+
+        if (prevPtr->heapChildPtr == timerPtr)
+        {
+            prevPtr->heapChildPtr = timerPtr->heapSiblingPtr;
+        }
+        else
+        {
+            prevPtr->heapSiblingPtr = timerPtr->heapSiblingPtr;
+        }
+        if (timerPtr->heapSiblingPtr != NULL)
+        {
+            timerPtr->heapSiblingPtr->heapPrevPtr = prevPtr;
+        }
+
+        threadRecPtr->heapRootPtr = MeldHeaps(threadRecPtr->heapRootPtr,
+                                              MergePairs(timerPtr->heapChildPtr));
+    }
+
+    timerPtr->heapChildPtr = NULL;
+    timerPtr->heapSiblingPtr = NULL;
+    timerPtr->heapPrevPtr = NULL;
+
+    if (HasTolerance(timerPtr))
+    {
+        threadRecPtr->heapTolerantCount--;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop the first timer from the thread's timer queue
+ *
+ * @return:
+ *      - pointer to the first timer on the list
+ *      - NULL if the list is empty
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PopFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
+)
+{
+    Timer_t* timerPtr = threadRecPtr->heapRootPtr;
+
+    if (timerPtr != NULL)
+    {
+        RemoveFromTimerList(threadRecPtr, timerPtr);
+    }
+
+    return timerPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out when the timerFD must expire so that the first timer in the queue, and every other
+ * timer that can be handled along with it, expire inside their tolerance windows.
+ *
+ * Only timers that expire before the wakeup time found so far need to be looked at, and since the
+ * heap is ordered by expiry time, the sub-heaps of those that don't can be skipped.
+ *
+ * @return  The wakeup time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t GetWakeupTime
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    Timer_t* firstTimerPtr              ///< [IN] The first timer in the queue.
+)
+{
+    le_clk_Time_t wakeupTime = le_clk_Add(firstTimerPtr->expiryTime, firstTimerPtr->tolerance);
+
+    // Without any tolerant timers, the wakeup time is always the first timer's expiry time.
+    if (threadRecPtr->heapTolerantCount == 0)
+    {
+        return wakeupTime;
+    }
+
+    Timer_t* nodePtr = firstTimerPtr->heapChildPtr;
+
+    while (nodePtr != NULL)
+    {
+        if (le_clk_GreaterThan(wakeupTime, nodePtr->expiryTime))
+        {
+            le_clk_Time_t deadline = le_clk_Add(nodePtr->expiryTime, nodePtr->tolerance);
+
+            if (le_clk_GreaterThan(wakeupTime, deadline))
+            {
+                wakeupTime = deadline;
+            }
+
+            if (nodePtr->heapChildPtr != NULL)
+            {
+                nodePtr = nodePtr->heapChildPtr;
+                continue;
+            }
+        }
+
+        // Move on to the next sibling, climbing back up to the parent whenever the end of a
+        // sibling list is reached.
+        while ((nodePtr != firstTimerPtr) && (nodePtr->heapSiblingPtr == NULL))
+        {
+            while (nodePtr->heapPrevPtr->heapChildPtr != nodePtr)
+            {
+                nodePtr = nodePtr->heapPrevPtr;
+            }
+            nodePtr = nodePtr->heapPrevPtr;
+        }
+
+        nodePtr = (nodePtr == firstTimerPtr) ? NULL : nodePtr->heapSiblingPtr;
+    }
+
+    return wakeupTime;
+}
+
+#else /* LE_TIMER_HEAP */
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add the timer record to the given list, sorted according to the timer value
@@ -128,10 +482,11 @@ static Timer_t* CreateTimer
 //--------------------------------------------------------------------------------------------------
 static void AddToTimerList
 (
-    le_dls_List_t* listPtr,               ///< [IN] The list to add to.
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread's timer record.
     Timer_t* newTimerPtr                  ///< [IN] The timer to add
 )
 {
+    le_dls_List_t* listPtr = &threadRecPtr->activeTimerList;
     Timer_t* timerPtr;
     le_dls_Link_t* linkPtr;
 
@@ -156,6 +511,7 @@ static void AddToTimerList
     }
 
     TimerListChangeCount++;
+    procStats_Add(PROCSTATS_RUNNING_TIMERS, 1);
     if (linkPtr == NULL)
     {
         // The list is either empty, or the new timer has the largest expiry time.
@@ -184,12 +540,12 @@ static void AddToTimerList
 //--------------------------------------------------------------------------------------------------
 static Timer_t* PeekFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
 )
 {
     le_dls_Link_t* linkPtr;
 
-    linkPtr = le_dls_Peek(listPtr);
+    linkPtr = le_dls_Peek(&threadRecPtr->activeTimerList);
     if (linkPtr != NULL)
     {
         return ( CONTAINER_OF(linkPtr, Timer_t, link) );
@@ -209,16 +565,17 @@ static Timer_t* PeekFromTimerList
 //--------------------------------------------------------------------------------------------------
 static Timer_t* PopFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
 )
 {
     le_dls_Link_t* linkPtr;
     Timer_t* timerPtr;
 
-    linkPtr = le_dls_Pop(listPtr);
+    linkPtr = le_dls_Pop(&threadRecPtr->activeTimerList);
     if (linkPtr != NULL)
     {
         TimerListChangeCount++;
+        procStats_Add(PROCSTATS_RUNNING_TIMERS, -1);
         timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
 
         // The timer is no longer on the active list
@@ -241,7 +598,7 @@ static Timer_t* PopFromTimerList
 //--------------------------------------------------------------------------------------------------
 static le_result_t RemoveFromTimerList
 (
-    le_dls_List_t* listPtr,             ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
     Timer_t* timerPtr                   ///< [IN] The timer to remove
 )
 {
@@ -253,12 +610,56 @@ static le_result_t RemoveFromTimerList
     // Remove the timer from the active list
     timerPtr->isActive = false;
     TimerListChangeCount++;
-    le_dls_Remove(listPtr, &timerPtr->link);
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+    procStats_Add(PROCSTATS_RUNNING_TIMERS, -1);
 
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out when the timerFD must expire so that the first timer on the list, and every other
+ * timer that can be handled along with it, expire inside their tolerance windows.
+ *
+ * @return  The wakeup time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t GetWakeupTime
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    Timer_t* firstTimerPtr              ///< [IN] The first timer on the list.
+)
+{
+    le_dls_List_t* listPtr = &threadRecPtr->activeTimerList;
+    le_clk_Time_t wakeupTime = le_clk_Add(firstTimerPtr->expiryTime, firstTimerPtr->tolerance);
+    le_dls_Link_t* linkPtr = le_dls_PeekNext(listPtr, &firstTimerPtr->link);
+
+    // The list is sorted, so stop at the first timer that doesn't expire before the wakeup time.
+    while (linkPtr != NULL)
+    {
+        Timer_t* timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+
+        if ( !le_clk_GreaterThan(wakeupTime, timerPtr->expiryTime) )
+        {
+            break;
+        }
+
+        le_clk_Time_t deadline = le_clk_Add(timerPtr->expiryTime, timerPtr->tolerance);
+        if (le_clk_GreaterThan(wakeupTime, deadline))
+        {
+            wakeupTime = deadline;
+        }
+
+        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+    }
+
+    return wakeupTime;
+}
+
+#endif /* LE_TIMER_HEAP */
+
+
 #if 0
 //--------------------------------------------------------------------------------------------------
 /**
@@ -313,12 +714,14 @@ static void RestartTimerFD
 {
     timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
     struct itimerspec timerInterval;
+    le_clk_Time_t wakeupTime = GetWakeupTime(threadRecPtr, timerPtr);
 
-    // Set the timer to expire at the expiry time of the given timer
+    // Set the timer to expire at the expiry time of the given timer, or later if the timer and the
+    // ones expiring shortly after it can tolerate it, so that they are all handled in one wakeup.
     // There is a small possibility that the time set now will be slightly in the past
     // at this point but it will just cause the timerfd to expire immediately.
-    timerInterval.it_value.tv_sec = timerPtr->expiryTime.sec;
-    timerInterval.it_value.tv_nsec = timerPtr->expiryTime.usec * 1000;
+    timerInterval.it_value.tv_sec = wakeupTime.sec;
+    timerInterval.it_value.tv_nsec = wakeupTime.usec * 1000;
 
     // The timerFD does not repeat
     timerInterval.it_interval.tv_sec = 0;
@@ -335,6 +738,7 @@ static void RestartTimerFD
 
     // Store the timer for future reference
     threadRecPtr->firstTimerPtr = timerPtr;
+    threadRecPtr->wakeupTime = wakeupTime;
 }
 
 
@@ -387,6 +791,7 @@ static void ProcessExpiredTimer
 
     // Keep track of the number of times the timer has expired, regardless of whether it repeats.
     expiredTimer->expiryCount++;
+    threadRecPtr->expiryCount++;
 
     // Handle repeating timers by adding it back to the list; do this before calling the expiry
     // handler to reduce jitter.
@@ -404,7 +809,7 @@ static void ProcessExpiredTimer
         expiredTimer->expiryTime = le_clk_Add(expiredTimer->expiryTime, expiredTimer->interval);
 
         // Add the timer back to the timer list
-        AddToTimerList(&threadRecPtr->activeTimerList, expiredTimer);
+        AddToTimerList(threadRecPtr, expiredTimer);
         //PrintTimerList(&threadRecPtr->activeTimerList);
     }
 
@@ -456,8 +861,10 @@ static void TimerFdHandler
     LE_ERROR_IF(numBytes != 8, "On TimerFD read, unexpected numBytes=%zd", numBytes);
     LE_ERROR_IF(expiry != 1,  "On TimerFD read, unexpected expiry=%u", (unsigned int)expiry);
 
+    threadRecPtr->wakeupCount++;
+
     // Pop off the first timer from the active list, and make sure it is the expected timer.
-    firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PopFromTimerList(threadRecPtr);
     LE_ASSERT( NULL != firstTimerPtr);
 
     LE_ASSERT( threadRecPtr->firstTimerPtr == firstTimerPtr );
@@ -471,17 +878,19 @@ static void TimerFdHandler
     ProcessExpiredTimer(firstTimerPtr);
 
     // Check if there are any other timers that have since expired, pop them off the
-    // list and process them.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    // list and process them.  The clock is only read once for all of them; any timer that expires
+    // while they are being processed will be picked up when the timerFD is restarted below.
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     while ( firstTimerPtr != NULL &&
-            le_clk_GreaterThan(le_clk_GetRelativeTime(), firstTimerPtr->expiryTime) )
+            le_clk_GreaterThan(now, firstTimerPtr->expiryTime) )
     {
         // Pop off the timer and process it
-        firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PopFromTimerList(threadRecPtr);
         ProcessExpiredTimer(firstTimerPtr);
 
         // Try the next timer on the list
-        firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PeekFromTimerList(threadRecPtr);
     }
 
     // While processing expired timers in the above loop, it is possible that a timer was started,
@@ -496,8 +905,11 @@ static void TimerFdHandler
     // running a timer that is no longer at the beginning of the active list, then (re)start the
     // timerFD.  The timerFD could be running here, if the expiry handler started a new timer,
     // although it might no longer be at the beginning of the list, if we had multiple timers
-    // expire, and one of them is a repetitive timer.
-    if ( (firstTimerPtr != NULL) && ( threadRecPtr->firstTimerPtr != firstTimerPtr ) )
+    // expire, and one of them is a repetitive timer.  For the same reason, the timerFD may be set
+    // to a wakeup time that is too late for a repetitive timer that was added back to the list.
+    if ( (firstTimerPtr != NULL) &&
+         ( (threadRecPtr->firstTimerPtr != firstTimerPtr) ||
+           !le_clk_Equal(threadRecPtr->wakeupTime, GetWakeupTime(threadRecPtr, firstTimerPtr)) ) )
     {
         RestartTimerFD(firstTimerPtr);
     }
@@ -596,8 +1008,37 @@ void timer_InitThread
     timer_ThreadRec_t* recPtr = thread_GetTimerRecPtr();
 
     recPtr->timerFD = -1;
+    recPtr->spareTimerFD = -1;
     recPtr->activeTimerList = LE_DLS_LIST_INIT;
     recPtr->firstTimerPtr = NULL;
+    recPtr->wakeupTime = (le_clk_Time_t){0, 0};
+    recPtr->wakeupCount = 0;
+    recPtr->expiryCount = 0;
+#ifdef LE_TIMER_HEAP
+    recPtr->heapRootPtr = NULL;
+    recPtr->heapSeqNum = 0;
+    recPtr->heapTolerantCount = 0;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread-specific parts of the timer module, reusing the timerFD that another
+ * thread handed over when it was parked (see timer_ParkThread()).
+ *
+ * This is called instead of timer_InitThread(), with the same restrictions.
+ */
+//--------------------------------------------------------------------------------------------------
+void timer_InitReusedThread
+(
+    int timerFd     ///< [IN] Disarmed timerFD, or -1 if none.
+)
+{
+    timer_InitThread();
+
+    // It gets its FD Monitor when the first timer is started, like a new timerFD.
+    thread_GetTimerRecPtr()->spareTimerFD = timerFd;
 }
 
 
@@ -626,13 +1067,47 @@ void timer_DestructThread
     void
 )
 {
-    timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
+    int timerFd = timer_ParkThread();
 
     // Close the file descriptor
+    if (timerFd != -1)
+    {
+        fd_Close(timerFd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destruct timer resources for a given thread like timer_DestructThread(), but hand its timerFD
+ * over, disarmed, instead of closing it, so that another thread can be initialized with it by
+ * timer_InitReusedThread().
+ *
+ * This must be called after event_ParkThread(), which deletes the timerFD's FD Monitor.
+ *
+ * @return The timerFD, or -1 if the thread didn't have any.
+ */
+//--------------------------------------------------------------------------------------------------
+int timer_ParkThread
+(
+    void
+)
+{
+    timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
+    int timerFd = threadRecPtr->spareTimerFD;
+
     if (threadRecPtr->timerFD != -1)
     {
-        fd_Close(threadRecPtr->timerFD);
+        uint64_t expiry;
+
+        // Disarm it, and clear any expiry that hasn't been read yet (it is non-blocking).
+        StopTimerFD();
+        (void)read(threadRecPtr->timerFD, &expiry, sizeof(expiry));
+
+        timerFd = threadRecPtr->timerFD;
+        threadRecPtr->timerFD = -1;
     }
+    threadRecPtr->spareTimerFD = -1;
 
     le_dls_Link_t* linkPtr;
 
@@ -647,9 +1122,17 @@ void timer_DestructThread
         linkPtr = le_dls_PeekNext(&threadRecPtr->activeTimerList, linkPtr);
 
         le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+        procStats_Add(PROCSTATS_RUNNING_TIMERS, -1);
 
         le_mem_Release(timerPtr);
     }
+
+#ifdef LE_TIMER_HEAP
+    threadRecPtr->heapRootPtr = NULL;
+    threadRecPtr->heapTolerantCount = 0;
+#endif
+
+    return timerFd;
 }
 
 // =============================================
@@ -807,6 +1290,75 @@ le_result_t le_timer_SetMsInterval
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire.
+ *
+ * Timer will expire at some point between the end of its interval and the end of its interval plus
+ * the tolerance, so that its expiry can be handled in the same wakeup as other timers.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object
+    le_clk_Time_t tolerance      ///< [IN] Timer tolerance
+)
+{
+    Timer_t* timerPtr = le_ref_Lookup(SafeRefMap, timerRef);
+    LE_FATAL_IF(NULL == timerPtr, "Invalid timer reference %p.", timerRef);
+
+    if ( timerPtr->isActive )
+    {
+        return LE_BUSY;
+    }
+
+    timerPtr->tolerance = tolerance;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, using milliseconds.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    uint32_t tolerance           ///< [IN] Timer tolerance in milliseconds.
+)
+{
+    Timer_t* timerPtr = le_ref_Lookup(SafeRefMap, timerRef);
+    LE_FATAL_IF(NULL == timerPtr, "Invalid timer reference %p.", timerRef);
+
+    if ( timerPtr->isActive )
+    {
+        return LE_BUSY;
+    }
+
+    time_t seconds = tolerance / 1000;
+    timerPtr->tolerance.sec = seconds;
+    timerPtr->tolerance.usec = (tolerance - (seconds * 1000)) * 1000;
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set how many times the timer will repeat
@@ -976,7 +1528,16 @@ le_result_t le_timer_Start
         // stopped after it expired but before the handler was called.
         // We also want the FD to close on exec (TFD_CLOEXEC) so that the FD is not inherited by
         // any child processes.
-        threadRecPtr->timerFD = timerfd_create(TimerClockType, TFD_NONBLOCK | TFD_CLOEXEC);
+        // A parked thread may have handed one over already, though.
+        if (threadRecPtr->spareTimerFD != -1)
+        {
+            threadRecPtr->timerFD = threadRecPtr->spareTimerFD;
+            threadRecPtr->spareTimerFD = -1;
+        }
+        else
+        {
+            threadRecPtr->timerFD = timerfd_create(TimerClockType, TFD_NONBLOCK | TFD_CLOEXEC);
+        }
         if (0 > threadRecPtr->timerFD)
             // Should have succeeded if checks in timer_Init() passed.
             LE_FATAL("timerfd_create() failed with errno = %d (%m)", errno);
@@ -992,16 +1553,19 @@ le_result_t le_timer_Start
     // Add the timer to the timer list. This is the only place we reset the expiry count.
     timerPtr->expiryCount = 0;
     timerPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), timerPtr->interval);
-    AddToTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    AddToTimerList(threadRecPtr, timerPtr);
     //PrintTimerList(&threadRecPtr->activeTimerList);
 
     // Get the first timer from the active list. This is needed to determine whether the timerFD
     // needs to be restarted, in case the new timer was put at the beginning of the list.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     LE_FATAL_IF(NULL == firstTimerPtr, "Invalid firstTimerPtr reference %p.", firstTimerPtr);
     // If the timerFD is not running, or it is running a timer that is no longer at the beginning
-    // of the active list, then (re)start the timerFD.
-    if ( threadRecPtr->firstTimerPtr != firstTimerPtr )
+    // of the active list, or the new timer can't wait until the timerFD expires, then (re)start
+    // the timerFD.
+    if ( (threadRecPtr->firstTimerPtr != firstTimerPtr) ||
+         le_clk_GreaterThan(threadRecPtr->wakeupTime,
+                            le_clk_Add(timerPtr->expiryTime, timerPtr->tolerance)) )
     {
         RestartTimerFD(firstTimerPtr);
     }
@@ -1043,7 +1607,7 @@ le_result_t le_timer_Stop
 
     timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
 
-    result = RemoveFromTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    result = RemoveFromTimerList(threadRecPtr, timerPtr);
     if (result == LE_OK)
     {
         // If the timer was at the start of the active list, then restart the timerFD using the next
@@ -1053,7 +1617,7 @@ le_result_t le_timer_Stop
             TRACE("Stopping the first active timer");
             threadRecPtr->firstTimerPtr = NULL;
 
-            firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+            firstTimerPtr = PeekFromTimerList(threadRecPtr);
             if (firstTimerPtr != NULL)
             {
                 RestartTimerFD(firstTimerPtr);
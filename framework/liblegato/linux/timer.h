@@ -17,7 +17,7 @@
  * Timer object.  Created by le_timer_Create().
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Timer
 {
     // Settable attributes
     char name[LIMIT_MAX_TIMER_NAME_BYTES];   ///< The timer name
@@ -25,6 +25,8 @@ typedef struct
     le_clk_Time_t interval;                  ///< Interval
     uint32_t repeatCount;                    ///< Number of times the timer will repeat
     void* contextPtr;                        ///< Context for timer expiry
+    le_clk_Time_t tolerance;                 ///< How late the timer may expire, so that its
+                                             ///  expiry can be combined with other timers'
 
     // Internal State
     le_dls_Link_t link;                      ///< For adding to the timer list
@@ -32,6 +34,15 @@ typedef struct
     le_clk_Time_t expiryTime;                ///< Time at which the timer should expire
     uint32_t expiryCount;                    ///< Number of times the counter has expired
     le_timer_Ref_t safeRef;                  ///< For the API user to refer to this timer by
+
+#ifdef LE_TIMER_HEAP
+    // Pairing heap links.  These are kept last, so the Inspect tool can read the members above
+    // regardless of how it was built.
+    struct Timer* heapChildPtr;              ///< First (leftmost) child in the heap
+    struct Timer* heapSiblingPtr;            ///< Next sibling to the right in the heap
+    struct Timer* heapPrevPtr;               ///< Parent if first child, else sibling to the left
+    uint32_t heapSeqNum;                     ///< Order of insertion, for timers with equal expiry
+#endif
 }
 Timer_t;
 
@@ -50,12 +61,25 @@ Timer_t;
 typedef struct
 {
     int timerFD;                        ///< System timer used by the thread.
+    int spareTimerFD;                   ///< Disarmed system timer handed over by a parked thread,
+                                        ///  to use instead of creating one (or -1).
     le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread
+                                        ///  (sorted by expiry time, unless LE_TIMER_HEAP).
     Timer_t* firstTimerPtr;             ///< Pointer to the timer on the active list that is
                                         ///  associated with the currently running timerFD,
                                         ///  or NULL if there are no timers on the active list.
                                         ///  This is normally the first timer on the list.
-
+    le_clk_Time_t wakeupTime;           ///< Time the timerFD is set to expire at, if running.
+                                        ///  This can be later than the first timer's expiry
+                                        ///  time if it has a tolerance.
+    uint64_t wakeupCount;               ///< Number of times the timerFD has expired.
+    uint64_t expiryCount;               ///< Number of timer expiries handled on those wakeups.
+#ifdef LE_TIMER_HEAP
+    Timer_t* heapRootPtr;               ///< Root of the pairing heap of running timers (the one
+                                        ///  that expires first), or NULL if none are running.
+    uint32_t heapSeqNum;                ///< Sequence number to give the next timer added.
+    size_t heapTolerantCount;           ///< Number of running timers with a non-zero tolerance.
+#endif
 }
 timer_ThreadRec_t;
 
@@ -99,6 +123,20 @@ void timer_InitThread
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread-specific parts of the timer module, reusing the timerFD that another
+ * thread handed over when it was parked (see timer_ParkThread()).
+ *
+ * This is called instead of timer_InitThread(), with the same restrictions.
+ */
+//--------------------------------------------------------------------------------------------------
+void timer_InitReusedThread
+(
+    int timerFd     ///< [IN] Disarmed timerFD, or -1 if none.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Accessor for clock type negotiated between clock and timerfd routines.
@@ -124,4 +162,21 @@ void timer_DestructThread
     void
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destruct timer resources for a given thread like timer_DestructThread(), but hand its timerFD
+ * over, disarmed, instead of closing it, so that another thread can be initialized with it by
+ * timer_InitReusedThread().
+ *
+ * This must be called after event_ParkThread(), which deletes the timerFD's FD Monitor.
+ *
+ * @return The timerFD, or -1 if the thread didn't have any.
+ */
+//--------------------------------------------------------------------------------------------------
+int timer_ParkThread
+(
+    void
+);
+
 #endif /* LEGATO_SRC_TIMER_H_INCLUDE_GUARD */
@@ -14,6 +14,8 @@
 #include "fileDescriptor.h"
 #include "le_tty.h"
 #include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
 
 // ==============================================
 //  PRIVATE DATA
@@ -638,3 +640,253 @@ le_result_t le_tty_SetRaw
 
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the number of characters (VMIN) and timeout (VTIME) of read(2) on a serial port in raw
+ * mode (see le_tty_SetRaw()), without changing any other setting or flushing the port.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the values cannot be set
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetReadBatching
+(
+    int fd,         ///< [IN] File Descriptor
+    int numChars,   ///< [IN] Number of bytes returned by read(2) when a read is performed.
+    int timeout     ///< [IN] when a read(2) is performed return after that timeout.
+                    ///<      The timeout value is given with 1 decimal places.
+)
+{
+    struct termios portSettings, portSettingsSetted;
+
+    if (-1 == tcgetattr(fd, &portSettings)) {
+        LE_ERROR("Cannot retrieve port settings");
+        return LE_FAULT;
+    }
+
+    portSettings.c_cc[VMIN] = numChars;
+    portSettings.c_cc[VTIME] = timeout;
+
+    if (-1 == tcsetattr(fd, TCSANOW, &portSettings)) {
+        LE_ERROR("Cannot set port settings");
+        return LE_FAULT;
+    }
+
+    // Test if value is supported
+    if (-1 == tcgetattr(fd, &portSettingsSetted)) {
+        LE_ERROR("Cannot retrieve port settings");
+        return LE_FAULT;
+    }
+
+    if ( (portSettings.c_cc[VMIN] != portSettingsSetted.c_cc[VMIN])
+        ||
+         (portSettings.c_cc[VTIME] != portSettingsSetted.c_cc[VTIME])
+       ) {
+        LE_ERROR("Could not set read batching, values not supported");
+        return LE_UNSUPPORTED;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the low latency mode of a serial port's driver.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the device's driver doesn't support it
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetLowLatency
+(
+    int fd,         ///< [IN] File Descriptor
+    bool enable     ///< [IN] true to enable low latency mode, false to disable it.
+)
+{
+    struct serial_struct serialInfo;
+
+    if (-1 == ioctl(fd, TIOCGSERIAL, &serialInfo)) {
+        if ((ENOTTY == errno) || (EINVAL == errno)) {
+            LE_DEBUG("Low latency mode not supported on fd %d", fd);
+            return LE_UNSUPPORTED;
+        }
+        LE_ERROR("Cannot retrieve serial settings (%m)");
+        return LE_FAULT;
+    }
+
+    if (enable) {
+        serialInfo.flags |= ASYNC_LOW_LATENCY;
+    }
+    else {
+        serialInfo.flags &= ~ASYNC_LOW_LATENCY;
+    }
+
+    if (-1 == ioctl(fd, TIOCSSERIAL, &serialInfo)) {
+        if ((ENOTTY == errno) || (EINVAL == errno)) {
+            LE_DEBUG("Low latency mode not supported on fd %d", fd);
+            return LE_UNSUPPORTED;
+        }
+        LE_ERROR("Cannot set serial settings (%m)");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes received on a serial port and waiting to be read.
+ *
+ * @return
+ *  - The number of bytes.
+ *  - -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_tty_GetReadableBytes
+(
+    int fd          ///< [IN] File Descriptor
+)
+{
+    int available;
+
+    if (-1 == ioctl(fd, FIONREAD, &available)) {
+        LE_ERROR("Cannot get the number of readable bytes (%m)");
+        return -1;
+    }
+
+    return available;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a line reader.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_tty_InitLineReader
+(
+    le_tty_LineReader_t* readerPtr, ///< [IN] Line reader.
+    int fd,                         ///< [IN] File descriptor to read from.
+    char* bufferPtr,                ///< [IN] Buffer for the line reader to use.  Lines longer than
+                                    ///<      the buffer are returned in pieces.
+    size_t bufferSize               ///< [IN] Size of the buffer (at least 2 bytes).
+)
+{
+    LE_ASSERT(readerPtr != NULL);
+    LE_ASSERT(bufferPtr != NULL);
+    LE_ASSERT(bufferSize >= 2);
+
+    readerPtr->fd = fd;
+    readerPtr->bufferPtr = bufferPtr;
+    readerPtr->bufferSize = bufferSize;
+    readerPtr->start = 0;
+    readerPtr->end = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the data left in a line reader's buffer as a line, and empty the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static char* TakeBufferedData
+(
+    le_tty_LineReader_t* readerPtr  ///< [IN] Line reader.
+)
+{
+    // The data has been moved to the start of the buffer, and one byte is always kept free for
+    // the NUL.
+    readerPtr->bufferPtr[readerPtr->end] = '\0';
+    readerPtr->start = 0;
+    readerPtr->end = 0;
+
+    return readerPtr->bufferPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next line from a line reader, reading from its file descriptor if it doesn't already
+ * have a complete line.  Reads don't block if the file descriptor is non-blocking.
+ *
+ * The line is returned without its line ending ("\n" or "\r\n"), NUL-terminated, in the line
+ * reader's buffer: it's valid until the next call.  Empty lines are returned too.
+ *
+ * @return
+ *  - LE_OK if a line was returned.
+ *  - LE_OVERFLOW if a line too long for the buffer was returned, without the rest of the line,
+ *    which will be returned by the next calls.
+ *  - LE_WOULD_BLOCK if there is no complete line yet, and nothing more to read.
+ *  - LE_CLOSED if the end of the file was reached.  The data left without a line ending is
+ *    returned as the last line first.
+ *  - LE_FAULT if a read failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_ReadLine
+(
+    le_tty_LineReader_t* readerPtr, ///< [IN] Line reader.
+    char** linePtrPtr               ///< [OUT] Line.
+)
+{
+    LE_ASSERT(readerPtr != NULL);
+    LE_ASSERT(linePtrPtr != NULL);
+
+    for (;;)
+    {
+        char* dataPtr = readerPtr->bufferPtr + readerPtr->start;
+        size_t dataSize = readerPtr->end - readerPtr->start;
+
+        // Return the next line from the buffer, if it holds a complete one.
+        char* eolPtr = memchr(dataPtr, '\n', dataSize);
+        if (eolPtr != NULL) {
+            *eolPtr = '\0';
+            if ((eolPtr > dataPtr) && (eolPtr[-1] == '\r')) {
+                eolPtr[-1] = '\0';
+            }
+            readerPtr->start += (eolPtr - dataPtr) + 1;
+
+            *linePtrPtr = dataPtr;
+            return LE_OK;
+        }
+
+        // Move the start of the line to the start of the buffer, to make room for the rest.
+        if (readerPtr->start > 0) {
+            memmove(readerPtr->bufferPtr, dataPtr, dataSize);
+            readerPtr->start = 0;
+            readerPtr->end = dataSize;
+        }
+
+        if (readerPtr->end >= readerPtr->bufferSize - 1) {
+            *linePtrPtr = TakeBufferedData(readerPtr);
+            return LE_OVERFLOW;
+        }
+
+        // Read as much as is available, in one go.
+        ssize_t count;
+        do {
+            count = read(readerPtr->fd,
+                         readerPtr->bufferPtr + readerPtr->end,
+                         readerPtr->bufferSize - 1 - readerPtr->end);
+        } while ((-1 == count) && (EINTR == errno));
+
+        if (-1 == count) {
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+                return LE_WOULD_BLOCK;
+            }
+            LE_ERROR("Cannot read from fd %d (%m)", readerPtr->fd);
+            return LE_FAULT;
+        }
+
+        if (0 == count) {
+            if (readerPtr->end > 0) {
+                *linePtrPtr = TakeBufferedData(readerPtr);
+                return LE_OK;
+            }
+            return LE_CLOSED;
+        }
+
+        readerPtr->end += count;
+    }
+}
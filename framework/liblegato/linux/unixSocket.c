@@ -15,6 +15,16 @@
 #define CMSG_BUFF_SIZE (CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct ucred)))
 
 
+/// Ancillary (control) message buffer of one of the messages sent or received in a batch, aligned
+/// for the cmsghdr structures.
+typedef union
+{
+    char buff[CMSG_BUFF_SIZE];
+    struct cmsghdr align;
+}
+BatchCmsgBuffer_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Extract a file descriptor from an SCM_RIGHTS ancillary data message.
@@ -508,6 +518,119 @@ le_result_t unixSocket_SendMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends several messages, each of which can contain data and a file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket, using a single system call.
+ *
+ * If some of the messages are sent but not all (for example because the socket's buffer is full),
+ * LE_OK is returned; sending the rest gives the reason.
+ *
+ * @return
+ * - LE_OK if successful (check numSentPtr).
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send the first message right now.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_Msg_t* msgs,     ///< [IN] Messages to send.
+    size_t numMsgs,             ///< [IN] Number of messages (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t* numSentPtr          ///< [OUT] Number of messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIX_SOCKET_MAX_BATCH_MSGS];
+    struct iovec ioVectors[UNIX_SOCKET_MAX_BATCH_MSGS];
+    BatchCmsgBuffer_t cmsgBuffers[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    *numSentPtr = 0;
+
+    memset(msgHeaders, 0, sizeof(msgHeaders));
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        if ((msgs[i].dataPtr != NULL) && (msgs[i].dataSize > 0))
+        {
+            ioVectors[i].iov_base = msgs[i].dataPtr;
+            ioVectors[i].iov_len = msgs[i].dataSize;
+            msgHeaderPtr->msg_iov = &ioVectors[i];
+            msgHeaderPtr->msg_iovlen = 1;
+        }
+
+        // Same as unixSocket_SendMsg(), the fd is sent in an SCM_RIGHTS control message.
+        if (msgs[i].fd >= 0)
+        {
+            msgHeaderPtr->msg_control = cmsgBuffers[i].buff;
+            msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i].buff);
+
+            struct cmsghdr* cmsgHeaderPtr = CMSG_FIRSTHDR(msgHeaderPtr);
+            cmsgHeaderPtr->cmsg_level = SOL_SOCKET;
+            cmsgHeaderPtr->cmsg_type = SCM_RIGHTS;
+            cmsgHeaderPtr->cmsg_len = CMSG_LEN(sizeof(int));
+            memcpy(CMSG_DATA(cmsgHeaderPtr), &msgs[i].fd, sizeof(int));
+
+            msgHeaderPtr->msg_controllen = cmsgHeaderPtr->cmsg_len;
+
+            LE_DEBUG("Sending fd %d.", msgs[i].fd);
+        }
+    }
+
+    // Send the messages (retry if interrupted by a signal).
+    int numSent;
+    do
+    {
+        numSent = sendmmsg(localSocketFd, msgHeaders, numMsgs, 0);
+    }
+    while ((numSent < 0) && (errno == EINTR));
+
+    if (numSent < 0)
+    {
+        switch (errno)
+        {
+            case EAGAIN:  // Same as EWOULDBLOCK
+                return LE_NO_MEMORY;
+
+            case ENOTCONN:
+            case ECONNRESET:
+            case EPIPE:
+                LE_WARN("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_COMM_ERROR;
+
+            default:
+                LE_ERROR("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < (size_t)numSent; i++)
+    {
+        if (msgHeaders[i].msg_len < msgs[i].dataSize)
+        {
+            LE_ERROR("The last %zu data bytes (of %zu total) were discarded by sendmmsg()!",
+                     msgs[i].dataSize - msgHeaders[i].msg_len,
+                     msgs[i].dataSize);
+            *numSentPtr = i;
+            return LE_FAULT;
+        }
+    }
+
+    *numSentPtr = numSent;
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message containing only data through a connected Unix domain datagram or
@@ -686,6 +809,112 @@ le_result_t unixSocket_ReceiveMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives, without blocking, up to a given number of messages from a connected Unix domain
+ * datagram or sequenced-packet socket, using a single system call.  Credentials are not received.
+ *
+ * @return
+ * - LE_OK if at least one message was received (check numReceivedPtr).
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to receive.
+    unixSocket_Msg_t* msgs,     ///< [IN+OUT] Buffers to receive the messages in.
+    size_t numMsgs,             ///< [IN] Number of buffers (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t* numReceivedPtr      ///< [OUT] Number of messages received.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIX_SOCKET_MAX_BATCH_MSGS];
+    struct iovec ioVectors[UNIX_SOCKET_MAX_BATCH_MSGS];
+    BatchCmsgBuffer_t cmsgBuffers[UNIX_SOCKET_MAX_BATCH_MSGS];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH_MSGS);
+
+    *numReceivedPtr = 0;
+
+    memset(msgHeaders, 0, sizeof(msgHeaders));
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        msgHeaderPtr->msg_control = cmsgBuffers[i].buff;
+        msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i].buff);
+
+        if ((msgs[i].dataPtr != NULL) && (msgs[i].dataSize > 0))
+        {
+            ioVectors[i].iov_base = msgs[i].dataPtr;
+            ioVectors[i].iov_len = msgs[i].dataSize;
+            msgHeaderPtr->msg_iov = &ioVectors[i];
+            msgHeaderPtr->msg_iovlen = 1;
+        }
+
+        msgs[i].dataSize = 0;
+        msgs[i].fd = -1;
+        msgs[i].isTruncated = false;
+    }
+
+    // Receive what is there (retry if interrupted by a signal).
+    int numReceived;
+    do
+    {
+        numReceived = recvmmsg(localSocketFd, msgHeaders, numMsgs, MSG_DONTWAIT, NULL);
+    }
+    while ((numReceived < 0) && (errno == EINTR));
+
+    if (numReceived < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return LE_WOULD_BLOCK;
+        }
+        else if (errno == ECONNRESET)
+        {
+            return LE_CLOSED;
+        }
+        else
+        {
+            LE_ERROR("recvmmsg() failed with errno %d (%m).", errno);
+            return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < (size_t)numReceived; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        if (msgHeaderPtr->msg_controllen > 0)
+        {
+            ExtractAncillaryData(msgHeaderPtr, &msgs[i].fd, NULL);
+        }
+        // An empty message without ancillary data means the socket has closed.
+        else if (msgHeaders[i].msg_len == 0)
+        {
+            break;
+        }
+
+        if ((msgHeaderPtr->msg_flags & MSG_CTRUNC) != 0)
+        {
+            LE_WARN("Ancillary data was discarded because it couldn't fit in our buffer.");
+        }
+
+        msgs[i].dataSize = msgHeaders[i].msg_len;
+        msgs[i].isTruncated = ((msgHeaderPtr->msg_flags & MSG_TRUNC) != 0);
+    }
+
+    *numReceivedPtr = i;
+
+    return (i > 0) ? LE_OK : LE_CLOSED;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receives a message containing only data payload through a connected Unix domain datagram or
@@ -424,6 +424,79 @@ le_result_t unixSocket_SendMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of messages sent by unixSocket_SendMsgs() or received by unixSocket_ReceiveMsgs()
+ * in one call.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNIX_SOCKET_MAX_BATCH_MSGS  16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message sent by unixSocket_SendMsgs() or received by unixSocket_ReceiveMsgs().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*   dataPtr;        ///< Data payload.
+    size_t  dataSize;       ///< Number of bytes of data payload to send, or that fit in the buffer
+                            ///  when receiving (updated to the number of bytes received).
+    int     fd;             ///< File descriptor sent or received (-1 if none).
+    bool    isTruncated;    ///< [OUT] Received data didn't fit in the buffer (the rest is lost).
+}
+unixSocket_Msg_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends several messages, each of which can contain data and a file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket, using a single system call.
+ *
+ * If some of the messages are sent but not all (for example because the socket's buffer is full),
+ * LE_OK is returned; sending the rest gives the reason.
+ *
+ * @return
+ * - LE_OK if successful (check numSentPtr).
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send the first message right now.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_Msg_t* msgs,     ///< [IN] Messages to send.
+    size_t numMsgs,             ///< [IN] Number of messages (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t* numSentPtr          ///< [OUT] Number of messages sent.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives, without blocking, up to a given number of messages from a connected Unix domain
+ * datagram or sequenced-packet socket, using a single system call.  Credentials are not received.
+ *
+ * @return
+ * - LE_OK if at least one message was received (check numReceivedPtr).
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to receive.
+    unixSocket_Msg_t* msgs,     ///< [IN+OUT] Buffers to receive the messages in.
+    size_t numMsgs,             ///< [IN] Number of buffers (at most UNIX_SOCKET_MAX_BATCH_MSGS).
+    size_t* numReceivedPtr      ///< [OUT] Number of messages received.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message containing only data through a connected Unix domain datagram or
@@ -15,6 +15,14 @@
  * Groups are created and deleted by modifying the /etc/group file.  File update and locking is
  * handled in the same way as the passwd file.
  *
+ * Lookups are served from an in-process cache of the passwd and group entries, which is reloaded
+ * whenever the file's inode, size or modification time changes, so a lookup costs a stat() instead
+ * of a scan of the file.  If the cache can't answer (an entry's name is too long to be cached, for
+ * example) the lookup falls back to the C library.
+ *
+ * Several users can be created with a single update of the passwd and group files using a batch:
+ * user_BeginBatch(), then user_AddToBatch() for each user, then user_CommitBatch().
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -82,6 +90,80 @@ static size_t MaxGroupEntrySize = LIMIT_MAX_PATH_BYTES;
 #define LOGIN_DEF_FILE          "/etc/login.defs"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached passwd or group entry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_USER_NAME_BYTES];   ///< User or group name.
+    uint32_t id;                            ///< User ID, or group ID for a group entry.
+    uint32_t gid;                           ///< Primary group ID (same as id for a group entry).
+    le_dls_Link_t link;                     ///< Link in the cache's list of entries.
+}
+CacheEntry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache of the entries of the passwd file or of the group file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* filePath;                   ///< File the entries are read from.
+    bool isGroupFile;                       ///< true for the group file, false for passwd.
+    bool isValid;                           ///< true if the entries match the file's stat below.
+    bool isComplete;                        ///< false if some entries could not be cached.
+    dev_t dev;                              ///< Device of the file when it was cached.
+    ino_t ino;                              ///< Inode of the file when it was cached.
+    off_t size;                             ///< Size of the file when it was cached.
+    struct timespec mtime;                  ///< Modification time of the file when it was cached.
+    le_dls_List_t entryList;                ///< All the cached entries.
+    le_hashmap_Ref_t byName;                ///< Entries by name (the first one of each name).
+    le_hashmap_Ref_t byId;                  ///< Entries by ID (the first one of each ID).
+}
+Cache_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The passwd and group file caches.
+ */
+//--------------------------------------------------------------------------------------------------
+static Cache_t PasswdCache = {.filePath = PASSWORD_FILE, .isGroupFile = false,
+                              .entryList = LE_DLS_LIST_INIT};
+static Cache_t GroupCache = {.filePath = GROUP_FILE, .isGroupFile = true,
+                             .entryList = LE_DLS_LIST_INIT};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of cache entries.  Created on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CacheEntryPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the caches.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t CacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The passwd and group files opened by the batch in progress, or NULL if there is no batch in
+ * progress.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE* BatchPasswdFilePtr = NULL;
+static FILE* BatchGroupFilePtr = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Updates the user or group ID range value from a string.  If the string contains the value to
@@ -433,6 +515,315 @@ void user_Init
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties a cache.
+ *
+ * @warning Must be called with the cache mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearCache
+(
+    Cache_t* cachePtr               ///< [IN] Cache to empty.
+)
+{
+    cachePtr->isValid = false;
+
+    if (cachePtr->byName != NULL)
+    {
+        le_hashmap_RemoveAll(cachePtr->byName);
+        le_hashmap_RemoveAll(cachePtr->byId);
+    }
+
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&cachePtr->entryList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, CacheEntry_t, link));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an entry to a cache.  If there already is an entry with the same name or ID, lookups by that
+ * name or ID keep returning the first one, as the C library does.
+ *
+ * @warning Must be called with the cache mutex locked.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the name is too long to be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddCacheEntry
+(
+    Cache_t* cachePtr,              ///< [IN] Cache to add the entry to.
+    const char* namePtr,            ///< [IN] User or group name.
+    uint32_t id,                    ///< [IN] User or group ID.
+    uint32_t gid                    ///< [IN] Primary group ID.
+)
+{
+    if (CacheEntryPool == NULL)
+    {
+        CacheEntryPool = le_mem_CreatePool("UserCacheEntry", sizeof(CacheEntry_t));
+    }
+
+    if (cachePtr->byName == NULL)
+    {
+        cachePtr->byName = le_hashmap_Create(cachePtr->isGroupFile ? "GroupsByName" : "UsersByName",
+                                             31, le_hashmap_HashString, le_hashmap_EqualsString);
+        cachePtr->byId = le_hashmap_Create(cachePtr->isGroupFile ? "GroupsById" : "UsersById",
+                                           31, le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    }
+
+    CacheEntry_t* entryPtr = le_mem_ForceAlloc(CacheEntryPool);
+
+    if (le_utf8_Copy(entryPtr->name, namePtr, sizeof(entryPtr->name), NULL) != LE_OK)
+    {
+        le_mem_Release(entryPtr);
+        return LE_OVERFLOW;
+    }
+
+    entryPtr->id = id;
+    entryPtr->gid = gid;
+    entryPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&cachePtr->entryList, &entryPtr->link);
+
+    if (le_hashmap_Get(cachePtr->byName, entryPtr->name) == NULL)
+    {
+        le_hashmap_Put(cachePtr->byName, entryPtr->name, entryPtr);
+    }
+
+    if (le_hashmap_Get(cachePtr->byId, &entryPtr->id) == NULL)
+    {
+        le_hashmap_Put(cachePtr->byId, &entryPtr->id, entryPtr);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads all the entries of a cache's file into the cache.
+ *
+ * @warning Must be called with the cache mutex locked.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the file could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadCache
+(
+    Cache_t* cachePtr               ///< [IN] Cache to load.
+)
+{
+    ClearCache(cachePtr);
+    cachePtr->isComplete = true;
+
+    FILE* filePtr = fopen(cachePtr->filePath, "r");
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Could not open file %s.  %m.", cachePtr->filePath);
+        return LE_FAULT;
+    }
+
+    int err;
+
+    if (cachePtr->isGroupFile)
+    {
+        char buf[MaxGroupEntrySize];
+        struct group grp;
+        struct group* grpPtr;
+
+        while ((err = fgetgrent_r(filePtr, &grp, buf, sizeof(buf), &grpPtr)) == 0)
+        {
+            if (AddCacheEntry(cachePtr, grp.gr_name, grp.gr_gid, grp.gr_gid) != LE_OK)
+            {
+                cachePtr->isComplete = false;
+            }
+        }
+    }
+    else
+    {
+        char buf[MaxPasswdEntrySize];
+        struct passwd pwd;
+        struct passwd* pwdPtr;
+
+        while ((err = fgetpwent_r(filePtr, &pwd, buf, sizeof(buf), &pwdPtr)) == 0)
+        {
+            if (AddCacheEntry(cachePtr, pwd.pw_name, pwd.pw_uid, pwd.pw_gid) != LE_OK)
+            {
+                cachePtr->isComplete = false;
+            }
+        }
+    }
+
+    fclose(filePtr);
+
+    if (err != ENOENT)
+    {
+        errno = err;
+        LE_ERROR("Could not read file %s.  %m.", cachePtr->filePath);
+        ClearCache(cachePtr);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure that a cache matches its file, reloading it if the file has changed since it was
+ * cached.
+ *
+ * @warning Must be called with the cache mutex locked.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the file could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RefreshCache
+(
+    Cache_t* cachePtr               ///< [IN] Cache to refresh.
+)
+{
+    struct stat fileStat;
+
+    if (stat(cachePtr->filePath, &fileStat) != 0)
+    {
+        LE_ERROR("Could not stat file %s.  %m.", cachePtr->filePath);
+        return LE_FAULT;
+    }
+
+    if ( cachePtr->isValid &&
+         (cachePtr->dev == fileStat.st_dev) &&
+         (cachePtr->ino == fileStat.st_ino) &&
+         (cachePtr->size == fileStat.st_size) &&
+         (cachePtr->mtime.tv_sec == fileStat.st_mtim.tv_sec) &&
+         (cachePtr->mtime.tv_nsec == fileStat.st_mtim.tv_nsec) )
+    {
+        return LE_OK;
+    }
+
+    if (LoadCache(cachePtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    cachePtr->dev = fileStat.st_dev;
+    cachePtr->ino = fileStat.st_ino;
+    cachePtr->size = fileStat.st_size;
+    cachePtr->mtime = fileStat.st_mtim;
+    cachePtr->isValid = true;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up an entry in a cache, by name or by ID.
+ *
+ * @return
+ *      LE_OK if the entry was found.
+ *      LE_NOT_FOUND if the file has no such entry.
+ *      LE_UNAVAILABLE if the cache can't tell; the caller must then ask the C library.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LookUpCacheEntry
+(
+    Cache_t* cachePtr,              ///< [IN] Cache to look in.
+    const char* namePtr,            ///< [IN] Name to look for, or NULL to look for the ID.
+    uint32_t id,                    ///< [IN] ID to look for, if namePtr is NULL.
+    CacheEntry_t* entryPtr          ///< [OUT] Copy of the entry found.
+)
+{
+    le_result_t result = LE_UNAVAILABLE;
+
+    LE_ASSERT(pthread_mutex_lock(&CacheMutex) == 0);
+
+    if (RefreshCache(cachePtr) == LE_OK)
+    {
+        CacheEntry_t* foundPtr = (namePtr != NULL) ? le_hashmap_Get(cachePtr->byName, namePtr) :
+                                                     le_hashmap_Get(cachePtr->byId, &id);
+
+        if (foundPtr != NULL)
+        {
+            *entryPtr = *foundPtr;
+            result = LE_OK;
+        }
+        else if (cachePtr->isComplete)
+        {
+            result = LE_NOT_FOUND;
+        }
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&CacheMutex) == 0);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an entry that has been written to a batch's copy of a file, but not committed yet, to that
+ * file's cache, so that it's taken into account by the next lookups (in particular by the search
+ * for available IDs).
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the entry could not be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddPendingCacheEntry
+(
+    Cache_t* cachePtr,              ///< [IN] Cache to add the entry to.
+    const char* namePtr,            ///< [IN] User or group name.
+    uint32_t id,                    ///< [IN] User or group ID.
+    uint32_t gid                    ///< [IN] Primary group ID.
+)
+{
+    le_result_t result;
+
+    LE_ASSERT(pthread_mutex_lock(&CacheMutex) == 0);
+
+    result = RefreshCache(cachePtr);
+
+    if ((result == LE_OK) && (AddCacheEntry(cachePtr, namePtr, id, gid) != LE_OK))
+    {
+        LE_ERROR("Name '%s' is too long.", namePtr);
+        result = LE_FAULT;
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&CacheMutex) == 0);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops the entries of a cache, such as pending entries of a cancelled batch.  The cache is
+ * reloaded from its file on the next lookup.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateCache
+(
+    Cache_t* cachePtr               ///< [IN] Cache to invalidate.
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&CacheMutex) == 0);
+    ClearCache(cachePtr);
+    LE_ASSERT(pthread_mutex_unlock(&CacheMutex) == 0);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a user name from a user ID.
@@ -453,6 +844,19 @@ static le_result_t GetName
     size_t nameBufSize          ///< [IN] The size of the buffer that the user name will be stored in.
 )
 {
+    // Try the cache first.
+    CacheEntry_t entry;
+    le_result_t result = LookUpCacheEntry(&PasswdCache, NULL, uid, &entry);
+
+    if (result == LE_OK)
+    {
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        return LE_NOT_FOUND;
+    }
+
     // Get the entry in the passwd file.
     char buf[MaxPasswdEntrySize];
     struct passwd pwd;
@@ -506,6 +910,19 @@ static le_result_t GetGroupName
     size_t nameBufSize          ///< [IN] The size of the buffer that the group name will be stored in.
 )
 {
+    // Try the cache first.
+    CacheEntry_t entry;
+    le_result_t result = LookUpCacheEntry(&GroupCache, NULL, gid, &entry);
+
+    if (result == LE_OK)
+    {
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        return LE_NOT_FOUND;
+    }
+
     // Get the entry in the group file.
     char buf[MaxGroupEntrySize];
     struct group grp;
@@ -561,6 +978,29 @@ static le_result_t GetIDs
                                 ///        This can be NULL if the gid is not needed.
 )
 {
+    // Try the cache first.
+    CacheEntry_t entry;
+    le_result_t result = LookUpCacheEntry(&PasswdCache, usernamePtr, 0, &entry);
+
+    if (result == LE_OK)
+    {
+        if (uidPtr != NULL)
+        {
+            *uidPtr = entry.id;
+        }
+
+        if (gidPtr != NULL)
+        {
+            *gidPtr = entry.gid;
+        }
+
+        return LE_OK;
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        return LE_NOT_FOUND;
+    }
+
     // Get the entry in the passwd file.
     char buf[MaxPasswdEntrySize];
     struct passwd pwd;
@@ -645,6 +1085,20 @@ static le_result_t GetGid
     gid_t* gidPtr                   ///< [OUT] Pointer to store the gid of the group.
 )
 {
+    // Try the cache first.
+    CacheEntry_t entry;
+    le_result_t result = LookUpCacheEntry(&GroupCache, groupNamePtr, 0, &entry);
+
+    if (result == LE_OK)
+    {
+        *gidPtr = entry.id;
+        return LE_OK;
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        return LE_NOT_FOUND;
+    }
+
     // Get the entry in the group file.
     char buf[MaxGroupEntrySize];
     struct group grp;
@@ -842,31 +1296,23 @@ static le_result_t CreateUser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates a user account with the specified name.  A group with the same name as the username will
- * also be created and the group will be set as the user's primary group.  If the user and group are
- * successfully created the user ID and group ID are stored at the location pointed to by uidPtr and
- * gidPtr respectively.  If the user/group accounts already exist then LE_DUPLICATE will be
- * returned and the user account's user ID and group ID are stored at the location pointed to by
- * uidPtr and gidPtr respectively.  If there is an error then LE_FAULT will be returned and the
- * values at uidPtr and gidPtr are undefined.
+ * Starts a batch of user creations.  The passwd and group files are locked until the batch is
+ * committed or cancelled, and are only updated (once) when the batch is committed.
+ *
+ * @warning Only one batch can be in progress at a time in a process, and no other function of this
+ *          API that modifies the passwd or group files may be called while it is in progress.
  *
  * @return
  *      LE_OK if successful.
- *      LE_DUPLICATE if the user or group already exists.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t user_Create
+le_result_t user_BeginBatch
 (
-    const char* usernamePtr,    ///< [IN] Pointer to the name of the user and group to create.
-    uid_t* uidPtr,              ///< [OUT] Pinter to a location to store the uid for the created
-                                ///        user.  This can be NULL if the uid is not needed.
-    gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for the created
-                                ///        user.  This can be NULL if the gid is not needed.
+    void
 )
 {
-    // Consider this a duplicate if either group or user do not exist
-    bool isDuplicate = true;
+    LE_FATAL_IF(BatchPasswdFilePtr != NULL, "A user batch is already in progress.");
 
     // Create a backup file for the group file.
     if (MakeBackup(GROUP_FILE, BACKUP_GROUP_FILE) != LE_OK)
@@ -879,6 +1325,7 @@ le_result_t user_Create
     if (passwdFilePtr == NULL)
     {
         LE_ERROR("Could not open file %s.  %m.", PASSWORD_FILE);
+        DeleteFile(BACKUP_GROUP_FILE);
         return LE_FAULT;
     }
 
@@ -888,9 +1335,43 @@ le_result_t user_Create
     {
         LE_ERROR("Could not open file %s.  %m.", GROUP_FILE);
         le_atomFile_CancelStream(passwdFilePtr);
+        DeleteFile(BACKUP_GROUP_FILE);
         return LE_FAULT;
     }
 
+    BatchPasswdFilePtr = passwdFilePtr;
+    BatchGroupFilePtr = groupFilePtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a user account to the batch in progress.  Same as user_Create(), except that the account is
+ * only written to the passwd and group files when the batch is committed.  Lookups done in the
+ * meantime by this process already see it.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_DUPLICATE if the user or group already exists.
+ *      LE_FAULT if there was an error.  The batch should then be cancelled.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_AddToBatch
+(
+    const char* usernamePtr,    ///< [IN] Pointer to the name of the user and group to create.
+    uid_t* uidPtr,              ///< [OUT] Pointer to a location to store the uid for the created
+                                ///        user.  This can be NULL if the uid is not needed.
+    gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for the created
+                                ///        user.  This can be NULL if the gid is not needed.
+)
+{
+    LE_FATAL_IF(BatchPasswdFilePtr == NULL, "No user batch in progress.");
+
+    // Consider this a duplicate if either group or user do not exist
+    bool isDuplicate = true;
+
     // Create group first, as we need the gid to create a user.
     // First check if the group exists.
     uid_t uid;
@@ -906,13 +1387,18 @@ le_result_t user_Create
             result = GetAvailGid(&gid);
             if (result != LE_OK)
             {
-                goto cleanup;
+                return LE_FAULT;
             }
 
-            result = CreateGroup(usernamePtr, gid, groupFilePtr);
+            result = CreateGroup(usernamePtr, gid, BatchGroupFilePtr);
             if (LE_OK != result)
             {
-                goto cleanup;
+                return LE_FAULT;
+            }
+
+            if (AddPendingCacheEntry(&GroupCache, usernamePtr, gid, gid) != LE_OK)
+            {
+                return LE_FAULT;
             }
 
             isDuplicate = false;
@@ -920,7 +1406,7 @@ le_result_t user_Create
             break;
         default:
             LE_CRIT("Error %d checking if group '%s' exists", result, usernamePtr);
-            goto cleanup;
+            return LE_FAULT;
     }
 
     // Now check if the user already exists
@@ -935,13 +1421,18 @@ le_result_t user_Create
             result = GetAvailUid(&uid);
             if (LE_OK != result)
             {
-                goto cleanup;
+                return LE_FAULT;
             }
 
-            result = CreateUser(usernamePtr, uid, gid, passwdFilePtr);
+            result = CreateUser(usernamePtr, uid, gid, BatchPasswdFilePtr);
             if (LE_OK != result)
             {
-                goto cleanup;
+                return LE_FAULT;
+            }
+
+            if (AddPendingCacheEntry(&PasswdCache, usernamePtr, uid, gid) != LE_OK)
+            {
+                return LE_FAULT;
             }
 
             isDuplicate = false;
@@ -951,55 +1442,174 @@ le_result_t user_Create
         default:
             // Error checking if user exists
             LE_CRIT("Error %d checking if user '%s' exists", result, usernamePtr);
-            goto cleanup;
+            return LE_FAULT;
     }
 
-    result = le_atomFile_CloseStream(groupFilePtr);
+    LE_DEBUG("Added user '%s' with uid %d and gid %d to batch.", usernamePtr, uid, gid);
 
-    if (result != LE_OK)
+    if (uidPtr != NULL)
     {
-        DeleteFile(BACKUP_GROUP_FILE);
-        le_atomFile_CancelStream(passwdFilePtr);
-        return result;
+        *uidPtr = uid;
     }
 
-    result = le_atomFile_CloseStream(passwdFilePtr);
+    if (gidPtr != NULL)
+    {
+        *gidPtr = gid;
+    }
+
+    return (isDuplicate ? LE_DUPLICATE : LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancels the batch in progress.  None of the users added to it are created.
+ */
+//--------------------------------------------------------------------------------------------------
+void user_CancelBatch
+(
+    void
+)
+{
+    LE_FATAL_IF(BatchPasswdFilePtr == NULL, "No user batch in progress.");
+
+    DeleteFile(BACKUP_GROUP_FILE);
+    le_atomFile_CancelStream(BatchPasswdFilePtr);
+    le_atomFile_CancelStream(BatchGroupFilePtr);
+
+    BatchPasswdFilePtr = NULL;
+    BatchGroupFilePtr = NULL;
+
+    // Drop the entries of the users that were added.
+    InvalidateCache(&PasswdCache);
+    InvalidateCache(&GroupCache);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits the batch in progress: writes the passwd and group files, and unlocks them.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  None of the users in the batch are created then.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_CommitBatch
+(
+    void
+)
+{
+    LE_FATAL_IF(BatchPasswdFilePtr == NULL, "No user batch in progress.");
+
+    FILE* passwdFilePtr = BatchPasswdFilePtr;
+    FILE* groupFilePtr = BatchGroupFilePtr;
+
+    BatchPasswdFilePtr = NULL;
+    BatchGroupFilePtr = NULL;
+
+    le_result_t result = le_atomFile_CloseStream(groupFilePtr);
 
     if (result != LE_OK)
     {
-        // Restore group file. If restoration succeed, it will automatically delete the backup file.
-        LE_FATAL_IF(RestoreBackup(GROUP_FILE, BACKUP_GROUP_FILE) != LE_OK,
-                    "Can't restore group file from backup.");
-
-        return result;
+        DeleteFile(BACKUP_GROUP_FILE);
+        le_atomFile_CancelStream(passwdFilePtr);
     }
     else
     {
-        DeleteFile(BACKUP_GROUP_FILE);
-        LE_INFO("Created user '%s' with uid %d and gid %d.", usernamePtr, uid, gid);
+        result = le_atomFile_CloseStream(passwdFilePtr);
 
-        if (uidPtr != NULL)
+        if (result != LE_OK)
         {
-            *uidPtr = uid;
+            // Restore group file. If restoration succeed, it will automatically delete the backup
+            // file.
+            LE_FATAL_IF(RestoreBackup(GROUP_FILE, BACKUP_GROUP_FILE) != LE_OK,
+                        "Can't restore group file from backup.");
         }
-
-        if (gidPtr != NULL)
+        else
         {
-            *gidPtr = gid;
+            DeleteFile(BACKUP_GROUP_FILE);
         }
+    }
 
-        result = (isDuplicate ? LE_DUPLICATE : LE_OK);
-        return result;
+    // On success the files have changed, so the caches will be reloaded anyway.  On failure, the
+    // pending entries must be dropped.
+    if (result != LE_OK)
+    {
+        InvalidateCache(&PasswdCache);
+        InvalidateCache(&GroupCache);
     }
 
-cleanup:
-    DeleteFile(BACKUP_GROUP_FILE);
-    le_atomFile_CancelStream(passwdFilePtr);
-    le_atomFile_CancelStream(groupFilePtr);
     return result;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a user account with the specified name.  A group with the same name as the username will
+ * also be created and the group will be set as the user's primary group.  If the user and group are
+ * successfully created the user ID and group ID are stored at the location pointed to by uidPtr and
+ * gidPtr respectively.  If the user/group accounts already exist then LE_DUPLICATE will be
+ * returned and the user account's user ID and group ID are stored at the location pointed to by
+ * uidPtr and gidPtr respectively.  If there is an error then LE_FAULT will be returned and the
+ * values at uidPtr and gidPtr are undefined.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_DUPLICATE if the user or group already exists.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_Create
+(
+    const char* usernamePtr,    ///< [IN] Pointer to the name of the user and group to create.
+    uid_t* uidPtr,              ///< [OUT] Pinter to a location to store the uid for the created
+                                ///        user.  This can be NULL if the uid is not needed.
+    gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for the created
+                                ///        user.  This can be NULL if the gid is not needed.
+)
+{
+    uid_t uid;
+    gid_t gid;
+
+    le_result_t result = user_BeginBatch();
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    le_result_t addResult = user_AddToBatch(usernamePtr, &uid, &gid);
+
+    if ((addResult != LE_OK) && (addResult != LE_DUPLICATE))
+    {
+        user_CancelBatch();
+        return addResult;
+    }
+
+    result = user_CommitBatch();
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    LE_INFO("Created user '%s' with uid %d and gid %d.", usernamePtr, uid, gid);
+
+    if (uidPtr != NULL)
+    {
+        *uidPtr = uid;
+    }
+
+    if (gidPtr != NULL)
+    {
+        *gidPtr = gid;
+    }
+
+    return addResult;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a group with the specified name.
@@ -50,6 +50,73 @@ le_result_t user_Create
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch of user creations.  The passwd and group files are locked until the batch is
+ * committed or cancelled, and are only updated (once) when the batch is committed.
+ *
+ * @warning Only one batch can be in progress at a time in a process, and no other function of this
+ *          API that modifies the passwd or group files may be called while it is in progress.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_BeginBatch
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a user account to the batch in progress.  Same as user_Create(), except that the account is
+ * only written to the passwd and group files when the batch is committed.  Lookups done in the
+ * meantime by this process already see it.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_DUPLICATE if the user or group already exists.
+ *      LE_FAULT if there was an error.  The batch should then be cancelled.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_AddToBatch
+(
+    const char* usernamePtr,    ///< [IN] Pointer to the name of the user and group to create.
+    uid_t* uidPtr,              ///< [OUT] Pointer to a location to store the uid for the created
+                                ///        user.  This can be NULL if the uid is not needed.
+    gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for the created
+                                ///        user.  This can be NULL if the gid is not needed.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancels the batch in progress.  None of the users added to it are created.
+ */
+//--------------------------------------------------------------------------------------------------
+void user_CancelBatch
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits the batch in progress: writes the passwd and group files, and unlocks them.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  None of the users in the batch are created then.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_CommitBatch
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a group with the specified name.
@@ -44,6 +44,47 @@
 #define LOG_DEFAULT_LOG_FILTER      LE_LOG_INFO
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a formatted user message, including the null terminator.  Longer messages are
+ * truncated.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define LOG_MAX_MSG_SIZE            256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a complete log line (the user message with the severity, process, component,
+ * thread and source location in front of it), including the null terminator.  Longer lines are
+ * truncated.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define LOG_MAX_LINE_SIZE           512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a buffer big enough for any rate limit string (see log_StrToRateLimit()), including the
+ * null terminator.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define LOG_RATE_LIMIT_STR_BYTES    24
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rate limit applied to each call site in a component (see logRateLimit.h).
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;     ///< Number of messages allowed per period (0 = no limit).
+    uint32_t period;    ///< Length of the period, in seconds.
+}
+log_RateLimit_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.  This must be called VERY early in the process initialization.
@@ -140,6 +181,37 @@ const char* log_SeverityLevelToStr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a rate limit string to a rate limit.  The string must be "off", for no limit, or
+ * "COUNT/SECONDS", where COUNT messages are allowed every SECONDS seconds.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the string is an invalid rate limit.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t log_StrToRateLimit
+(
+    const char* rateLimitStr,           ///< [IN] The rate limit string.
+    log_RateLimit_t* rateLimitPtr       ///< [OUT] The rate limit.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a rate limit to a rate limit string.  The buffer must be at least
+ * LOG_RATE_LIMIT_STR_BYTES long.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_RateLimitToStr
+(
+    const log_RateLimit_t* rateLimitPtr,    ///< [IN] The rate limit.
+    char* bufferPtr,                        ///< [OUT] Buffer to write the string into.
+    size_t bufferSize                       ///< [IN] Size of the buffer.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log messages from the framework.  Used for testing only.
@@ -151,6 +223,39 @@ void log_TestFrameworkMsgs
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a fully formatted log message out to the logging system (syslog on embedded targets,
+ * stderr otherwise).
+ */
+//--------------------------------------------------------------------------------------------------
+void log_WriteMsg
+(
+    le_log_Level_t level,           ///< [IN] Severity level (-1 for a trace).
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* threadNamePtr,      ///< [IN] Name of the thread that logged the message.
+    const char* filenamePtr,        ///< [IN] Source file that logged the message.
+    const char* functionNamePtr,    ///< [IN] Function that logged the message.
+    unsigned int lineNumber,        ///< [IN] Line number in the source file.
+    time_t timestamp,               ///< [IN] Time at which the message was logged.
+    const char* msgPtr              ///< [IN] Formatted user message.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a complete log line, as formatted by log_WriteMsg() in the process that logged it, out
+ * to the logging system.  Used by the Log Control Daemon to pass on messages from log rings.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_WriteLine
+(
+    le_log_Level_t level,       ///< [IN] Severity level (-1 for a trace).
+    const char* linePtr         ///< [IN] Log line.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Logs a generic message with the given information.
@@ -0,0 +1,698 @@
+//--------------------------------------------------------------------------------------------------
+/** @file orderedMap.c
+ *
+ * Intrusive ordered map (see le_orderedMap.h), implemented as a red-black tree with parent
+ * pointers, so that links can be removed and walked without searching the tree.  Leaves are NULL
+ * pointers, which count as black.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a link is red (NULL leaves are black).
+ *
+ * @return
+ *      true if the link is red.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsRed
+(
+    const le_omap_Link_t* linkPtr       ///< [IN] The link, or NULL.
+)
+{
+    return ((linkPtr != NULL) && linkPtr->isRed);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the lowest link of a sub-tree.
+ *
+ * @return
+ *      The link.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_omap_Link_t* Lowest
+(
+    le_omap_Link_t* linkPtr             ///< [IN] Root of the sub-tree.
+)
+{
+    while (linkPtr->leftPtr != NULL)
+    {
+        linkPtr = linkPtr->leftPtr;
+    }
+
+    return linkPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the greatest link of a sub-tree.
+ *
+ * @return
+ *      The link.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_omap_Link_t* Greatest
+(
+    le_omap_Link_t* linkPtr             ///< [IN] Root of the sub-tree.
+)
+{
+    while (linkPtr->rightPtr != NULL)
+    {
+        linkPtr = linkPtr->rightPtr;
+    }
+
+    return linkPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replaces a child of a link (or the root of the tree) with another sub-tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplaceChild
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] The map.
+    le_omap_Link_t* parentPtr,          ///< [IN] Parent link, or NULL to replace the root.
+    le_omap_Link_t* oldChildPtr,        ///< [IN] Child to replace.
+    le_omap_Link_t* newChildPtr         ///< [IN] New child, or NULL.
+)
+{
+    if (parentPtr == NULL)
+    {
+        mapPtr->rootPtr = newChildPtr;
+    }
+    else if (parentPtr->leftPtr == oldChildPtr)
+    {
+        parentPtr->leftPtr = newChildPtr;
+    }
+    else
+    {
+        parentPtr->rightPtr = newChildPtr;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rotates a link left, making its right child its parent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RotateLeft
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] The map.
+    le_omap_Link_t* linkPtr             ///< [IN] Link to rotate.
+)
+{
+    le_omap_Link_t* childPtr = linkPtr->rightPtr;
+
+    linkPtr->rightPtr = childPtr->leftPtr;
+    if (childPtr->leftPtr != NULL)
+    {
+        childPtr->leftPtr->parentPtr = linkPtr;
+    }
+
+    childPtr->parentPtr = linkPtr->parentPtr;
+    ReplaceChild(mapPtr, linkPtr->parentPtr, linkPtr, childPtr);
+
+    childPtr->leftPtr = linkPtr;
+    linkPtr->parentPtr = childPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rotates a link right, making its left child its parent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RotateRight
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] The map.
+    le_omap_Link_t* linkPtr             ///< [IN] Link to rotate.
+)
+{
+    le_omap_Link_t* childPtr = linkPtr->leftPtr;
+
+    linkPtr->leftPtr = childPtr->rightPtr;
+    if (childPtr->rightPtr != NULL)
+    {
+        childPtr->rightPtr->parentPtr = linkPtr;
+    }
+
+    childPtr->parentPtr = linkPtr->parentPtr;
+    ReplaceChild(mapPtr, linkPtr->parentPtr, linkPtr, childPtr);
+
+    childPtr->rightPtr = linkPtr;
+    linkPtr->parentPtr = childPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restores the red-black properties after a red link has been added.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FixAfterInsert
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] The map.
+    le_omap_Link_t* linkPtr             ///< [IN] The added link.
+)
+{
+    le_omap_Link_t* parentPtr;
+
+    // A red parent can't be the root, so there always is a grandparent.
+    while (((parentPtr = linkPtr->parentPtr) != NULL) && parentPtr->isRed)
+    {
+        le_omap_Link_t* grandParentPtr = parentPtr->parentPtr;
+
+        if (parentPtr == grandParentPtr->leftPtr)
+        {
+            le_omap_Link_t* unclePtr = grandParentPtr->rightPtr;
+
+            if (IsRed(unclePtr))
+            {
+                parentPtr->isRed = false;
+                unclePtr->isRed = false;
+                grandParentPtr->isRed = true;
+                linkPtr = grandParentPtr;
+            }
+            else
+            {
+                if (linkPtr == parentPtr->rightPtr)
+                {
+                    RotateLeft(mapPtr, parentPtr);
+                    parentPtr = linkPtr;
+                }
+
+                parentPtr->isRed = false;
+                grandParentPtr->isRed = true;
+                RotateRight(mapPtr, grandParentPtr);
+                break;
+            }
+        }
+        else
+        {
+            le_omap_Link_t* unclePtr = grandParentPtr->leftPtr;
+
+            if (IsRed(unclePtr))
+            {
+                parentPtr->isRed = false;
+                unclePtr->isRed = false;
+                grandParentPtr->isRed = true;
+                linkPtr = grandParentPtr;
+            }
+            else
+            {
+                if (linkPtr == parentPtr->leftPtr)
+                {
+                    RotateRight(mapPtr, parentPtr);
+                    parentPtr = linkPtr;
+                }
+
+                parentPtr->isRed = false;
+                grandParentPtr->isRed = true;
+                RotateLeft(mapPtr, grandParentPtr);
+                break;
+            }
+        }
+    }
+
+    mapPtr->rootPtr->isRed = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restores the red-black properties after a black link has been removed, leaving a sub-tree one
+ * black link short.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FixAfterRemove
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] The map.
+    le_omap_Link_t* linkPtr,            ///< [IN] Root of the short sub-tree, or NULL.
+    le_omap_Link_t* parentPtr           ///< [IN] Parent of the short sub-tree.
+)
+{
+    // The sibling of the short sub-tree has at least one black link, so it is never NULL.
+    while ((linkPtr != mapPtr->rootPtr) && !IsRed(linkPtr))
+    {
+        if (linkPtr == parentPtr->leftPtr)
+        {
+            le_omap_Link_t* siblingPtr = parentPtr->rightPtr;
+
+            if (siblingPtr->isRed)
+            {
+                siblingPtr->isRed = false;
+                parentPtr->isRed = true;
+                RotateLeft(mapPtr, parentPtr);
+                siblingPtr = parentPtr->rightPtr;
+            }
+
+            if (!IsRed(siblingPtr->leftPtr) && !IsRed(siblingPtr->rightPtr))
+            {
+                siblingPtr->isRed = true;
+                linkPtr = parentPtr;
+                parentPtr = linkPtr->parentPtr;
+            }
+            else
+            {
+                if (!IsRed(siblingPtr->rightPtr))
+                {
+                    siblingPtr->leftPtr->isRed = false;
+                    siblingPtr->isRed = true;
+                    RotateRight(mapPtr, siblingPtr);
+                    siblingPtr = parentPtr->rightPtr;
+                }
+
+                siblingPtr->isRed = parentPtr->isRed;
+                parentPtr->isRed = false;
+                siblingPtr->rightPtr->isRed = false;
+                RotateLeft(mapPtr, parentPtr);
+                linkPtr = mapPtr->rootPtr;
+            }
+        }
+        else
+        {
+            le_omap_Link_t* siblingPtr = parentPtr->leftPtr;
+
+            if (siblingPtr->isRed)
+            {
+                siblingPtr->isRed = false;
+                parentPtr->isRed = true;
+                RotateRight(mapPtr, parentPtr);
+                siblingPtr = parentPtr->leftPtr;
+            }
+
+            if (!IsRed(siblingPtr->leftPtr) && !IsRed(siblingPtr->rightPtr))
+            {
+                siblingPtr->isRed = true;
+                linkPtr = parentPtr;
+                parentPtr = linkPtr->parentPtr;
+            }
+            else
+            {
+                if (!IsRed(siblingPtr->leftPtr))
+                {
+                    siblingPtr->rightPtr->isRed = false;
+                    siblingPtr->isRed = true;
+                    RotateLeft(mapPtr, siblingPtr);
+                    siblingPtr = parentPtr->leftPtr;
+                }
+
+                siblingPtr->isRed = parentPtr->isRed;
+                parentPtr->isRed = false;
+                siblingPtr->leftPtr->isRed = false;
+                RotateRight(mapPtr, parentPtr);
+                linkPtr = mapPtr->rootPtr;
+            }
+        }
+    }
+
+    if (linkPtr != NULL)
+    {
+        linkPtr->isRed = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a link to the map, after any links with the same key.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_omap_Insert
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] Map to add to.
+    le_omap_Link_t* newLinkPtr,         ///< [IN] New link to add.
+    const void* keyPtr                  ///< [IN] Key of the new link's node.
+)
+{
+    le_omap_Link_t* parentPtr = NULL;
+    le_omap_Link_t* currentPtr = mapPtr->rootPtr;
+    bool isLeft = false;
+
+    while (currentPtr != NULL)
+    {
+        parentPtr = currentPtr;
+        isLeft = (mapPtr->compareFunc(keyPtr, currentPtr) < 0);
+        currentPtr = isLeft ? currentPtr->leftPtr : currentPtr->rightPtr;
+    }
+
+    *newLinkPtr = LE_OMAP_LINK_INIT;
+    newLinkPtr->parentPtr = parentPtr;
+    newLinkPtr->isRed = true;
+
+    if (parentPtr == NULL)
+    {
+        mapPtr->rootPtr = newLinkPtr;
+    }
+    else if (isLeft)
+    {
+        parentPtr->leftPtr = newLinkPtr;
+    }
+    else
+    {
+        parentPtr->rightPtr = newLinkPtr;
+    }
+
+    FixAfterInsert(mapPtr, newLinkPtr);
+
+    mapPtr->count++;
+    mapPtr->changeCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the specified link from the map.  User must ensure that the link is in the map
+ * otherwise the behaviour of this function is undefined.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_omap_Remove
+(
+    le_omap_Map_t* mapPtr,              ///< [IN] Map to remove from.
+    le_omap_Link_t* linkToRemovePtr     ///< [IN] Link to remove.
+)
+{
+    le_omap_Link_t* childPtr;
+    le_omap_Link_t* parentPtr;
+    bool wasRed = linkToRemovePtr->isRed;
+
+    if ((linkToRemovePtr->leftPtr == NULL) || (linkToRemovePtr->rightPtr == NULL))
+    {
+        // At most one child, which takes the removed link's place.
+        childPtr = (linkToRemovePtr->leftPtr != NULL) ? linkToRemovePtr->leftPtr
+                                                      : linkToRemovePtr->rightPtr;
+        parentPtr = linkToRemovePtr->parentPtr;
+        ReplaceChild(mapPtr, parentPtr, linkToRemovePtr, childPtr);
+        if (childPtr != NULL)
+        {
+            childPtr->parentPtr = parentPtr;
+        }
+    }
+    else
+    {
+        // Two children: the next link, which has no left child, takes the removed link's place
+        // and colour, and the tree is short of a black link where the next link was.
+        le_omap_Link_t* nextPtr = Lowest(linkToRemovePtr->rightPtr);
+
+        wasRed = nextPtr->isRed;
+        childPtr = nextPtr->rightPtr;
+
+        if (nextPtr->parentPtr == linkToRemovePtr)
+        {
+            parentPtr = nextPtr;
+        }
+        else
+        {
+            parentPtr = nextPtr->parentPtr;
+            ReplaceChild(mapPtr, parentPtr, nextPtr, childPtr);
+            if (childPtr != NULL)
+            {
+                childPtr->parentPtr = parentPtr;
+            }
+
+            nextPtr->rightPtr = linkToRemovePtr->rightPtr;
+            nextPtr->rightPtr->parentPtr = nextPtr;
+        }
+
+        ReplaceChild(mapPtr, linkToRemovePtr->parentPtr, linkToRemovePtr, nextPtr);
+        nextPtr->parentPtr = linkToRemovePtr->parentPtr;
+        nextPtr->leftPtr = linkToRemovePtr->leftPtr;
+        nextPtr->leftPtr->parentPtr = nextPtr;
+        nextPtr->isRed = linkToRemovePtr->isRed;
+    }
+
+    if (!wasRed)
+    {
+        FixAfterRemove(mapPtr, childPtr, parentPtr);
+    }
+
+    *linkToRemovePtr = LE_OMAP_LINK_INIT;
+
+    mapPtr->count--;
+    mapPtr->changeCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes and returns the link of the lowest key.
+ *
+ * @return
+ *      The removed link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Pop
+(
+    le_omap_Map_t* mapPtr               ///< [IN] Map to remove from.
+)
+{
+    le_omap_Link_t* linkPtr = le_omap_Peek(mapPtr);
+
+    if (linkPtr != NULL)
+    {
+        le_omap_Remove(mapPtr, linkPtr);
+    }
+
+    return linkPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first link of a key.
+ *
+ * @return
+ *      The link.
+ *      NULL if no link has this key.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Find
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const void* keyPtr                  ///< [IN] The key.
+)
+{
+    le_omap_Link_t* linkPtr = le_omap_FindGreaterOrEqual(mapPtr, keyPtr);
+
+    if ((linkPtr != NULL) && (mapPtr->compareFunc(keyPtr, linkPtr) == 0))
+    {
+        return linkPtr;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first link of a key greater than or equal to a key.
+ *
+ * @return
+ *      The link.
+ *      NULL if all the links have lower keys.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_FindGreaterOrEqual
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const void* keyPtr                  ///< [IN] The key.
+)
+{
+    le_omap_Link_t* currentPtr = mapPtr->rootPtr;
+    le_omap_Link_t* foundPtr = NULL;
+
+    while (currentPtr != NULL)
+    {
+        if (mapPtr->compareFunc(keyPtr, currentPtr) <= 0)
+        {
+            foundPtr = currentPtr;
+            currentPtr = currentPtr->leftPtr;
+        }
+        else
+        {
+            currentPtr = currentPtr->rightPtr;
+        }
+    }
+
+    return foundPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link of the lowest key without removing it.
+ *
+ * @return
+ *      The link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_Peek
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+)
+{
+    if (mapPtr->rootPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return Lowest(mapPtr->rootPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link of the greatest key without removing it.
+ *
+ * @return
+ *      The link.
+ *      NULL if the map is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekTail
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+)
+{
+    if (mapPtr->rootPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return Greatest(mapPtr->rootPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link following currentLinkPtr in the map without removing it.  User must ensure that
+ * currentLinkPtr is in the map otherwise the behaviour of this function is undefined.
+ *
+ * @return
+ *      The next link.
+ *      NULL if currentLinkPtr is the last link.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekNext
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* currentLinkPtr///< [IN] Current link.
+)
+{
+    if (currentLinkPtr->rightPtr != NULL)
+    {
+        return Lowest(currentLinkPtr->rightPtr);
+    }
+
+    // Go up until coming from a left child.
+    le_omap_Link_t* parentPtr = currentLinkPtr->parentPtr;
+
+    while ((parentPtr != NULL) && (currentLinkPtr == parentPtr->rightPtr))
+    {
+        currentLinkPtr = parentPtr;
+        parentPtr = parentPtr->parentPtr;
+    }
+
+    return parentPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the link preceding currentLinkPtr in the map without removing it.  User must ensure
+ * that currentLinkPtr is in the map otherwise the behaviour of this function is undefined.
+ *
+ * @return
+ *      The previous link.
+ *      NULL if currentLinkPtr is the first link.
+ */
+//--------------------------------------------------------------------------------------------------
+le_omap_Link_t* le_omap_PeekPrev
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* currentLinkPtr///< [IN] Current link.
+)
+{
+    if (currentLinkPtr->leftPtr != NULL)
+    {
+        return Greatest(currentLinkPtr->leftPtr);
+    }
+
+    // Go up until coming from a right child.
+    le_omap_Link_t* parentPtr = currentLinkPtr->parentPtr;
+
+    while ((parentPtr != NULL) && (currentLinkPtr == parentPtr->leftPtr))
+    {
+        currentLinkPtr = parentPtr;
+        parentPtr = parentPtr->parentPtr;
+    }
+
+    return parentPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a link is in the map.
+ *
+ * @return
+ *      true if the link is in the map.
+ *      false if the link is not in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_omap_IsInMap
+(
+    const le_omap_Map_t* mapPtr,        ///< [IN] The map.
+    const le_omap_Link_t* linkPtr       ///< [IN] The link, which is in this map or in none.
+)
+{
+    // Only the root has no parent.
+    return ((linkPtr == mapPtr->rootPtr) || (linkPtr->parentPtr != NULL));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of links in the map.
+ *
+ * @return
+ *      The number of links.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_omap_NumLinks
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+)
+{
+    return mapPtr->count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the change counter of the map, incremented on every change made to it.
+ *
+ * @return
+ *      The change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_omap_GetChangeCount
+(
+    const le_omap_Map_t* mapPtr         ///< [IN] The map.
+)
+{
+    return mapPtr->changeCount;
+}
@@ -16,58 +16,133 @@
 #define IS_THREE_BYTE_CHAR(leadByte)            ( (leadByte & 0xF0) == 0xE0 )
 #define IS_FOUR_BYTE_CHAR(leadByte)             ( (leadByte & 0xF8) == 0xF0 )
 
+// Bit set in every byte of a word that holds a non-ASCII byte.
+#define NON_ASCII_MASK                          UINT64_C(0x8080808080808080)
+
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function returns the number of characters in string.
- *
- * UTF-8 encoded characters may be larger than 1 byte so the number of characters is not necessarily
- * equal to the the number of bytes in the string.
+ * Get the length of the run of ASCII characters at the start of a buffer.  Checks 16 bytes at a
+ * time, which is what makes the ASCII parts of strings fast to scan.
  *
  * @return
- *      - Number of characters in string if successful.
- *      - LE_FORMAT_ERROR if the string is not UTF-8.
+ *      Number of leading bytes that are ASCII characters.
  */
 //--------------------------------------------------------------------------------------------------
-ssize_t le_utf8_NumChars
+static size_t AsciiPrefixLen
 (
-    const char* string      ///< [IN] Pointer to the string.
+    const char* bufPtr,     ///< [IN] Buffer.
+    size_t len              ///< [IN] Number of bytes in the buffer.
 )
 {
-    size_t i;
-    size_t numBytes;
-    size_t strIndex = 0;
-    size_t numChars = 0;
+    size_t i = 0;
 
-    // Check parameters.
-    if (string == NULL)
+    for (; i + 2 * sizeof(uint64_t) <= len; i += 2 * sizeof(uint64_t))
     {
-        return 0;
+        uint64_t words[2];
+
+        memcpy(words, bufPtr + i, sizeof(words));
+
+        if (((words[0] | words[1]) & NON_ASCII_MASK) != 0)
+        {
+            break;
+        }
+    }
+
+    while ((i < len) && IS_SINGLE_BYTE_CHAR(bufPtr[i]))
+    {
+        i++;
     }
 
-    while (string[strIndex] != '\0')
+    return i;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the UTF-8 format of a buffer, and count its characters.
+ *
+ * @return
+ *      true if the buffer only holds complete, correctly formatted characters.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckFormat
+(
+    const char* bufPtr,     ///< [IN] Buffer.
+    size_t len,             ///< [IN] Number of bytes in the buffer.
+    size_t* numCharsPtr     ///< [OUT] Number of characters in the buffer (if format is correct).
+)
+{
+    size_t i = 0;
+    size_t numChars = 0;
+
+    while (i < len)
     {
-        numBytes = le_utf8_NumBytesInChar(string[strIndex]);
+        size_t runLen = AsciiPrefixLen(bufPtr + i, len - i);
+
+        i += runLen;
+        numChars += runLen;
 
-        if (numBytes == 0)
+        if (i == len)
         {
-            return LE_FORMAT_ERROR;
+            break;
+        }
+
+        size_t numBytes = le_utf8_NumBytesInChar(bufPtr[i]);
+
+        if ((numBytes == 0) || (numBytes > len - i))
+        {
+            return false;
         }
 
         // Go through the bytes in this character to make sure all bytes are formatted correctly.
-        for (i = 1; i < numBytes; i++)
+        size_t j;
+        for (j = 1; j < numBytes; j++)
         {
-            if ( !le_utf8_IsContinuationByte(string[++strIndex]) )
+            if ( !le_utf8_IsContinuationByte(bufPtr[i + j]) )
             {
-                return LE_FORMAT_ERROR;
+                return false;
             }
         }
 
-        // This character is correct.
+        i += numBytes;
         numChars++;
+    }
+
+    *numCharsPtr = numChars;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function returns the number of characters in string.
+ *
+ * UTF-8 encoded characters may be larger than 1 byte so the number of characters is not necessarily
+ * equal to the the number of bytes in the string.
+ *
+ * @return
+ *      - Number of characters in string if successful.
+ *      - LE_FORMAT_ERROR if the string is not UTF-8.
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_utf8_NumChars
+(
+    const char* string      ///< [IN] Pointer to the string.
+)
+{
+    size_t numChars;
 
-        // Move on.
-        strIndex++;
+    // Check parameters.
+    if (string == NULL)
+    {
+        return 0;
+    }
+
+    if (!CheckFormat(string, strlen(string), &numChars))
+    {
+        return LE_FORMAT_ERROR;
     }
 
     return numChars;
@@ -173,8 +248,36 @@ le_result_t le_utf8_Copy
     // Check parameters.
     LE_ASSERT( (destStr != NULL) && (srcStr != NULL) && (destSize > 0) );
 
-    // Go through the string copying one character at a time.
-    size_t i = 0;
+    // Copy the leading ASCII characters in one go.  The source is only read up to its
+    // null-terminator or the size of the destination, whichever comes first.
+    size_t srcLen = strnlen(srcStr, destSize);
+    size_t i = AsciiPrefixLen(srcStr, srcLen);
+
+    if (i == srcLen)
+    {
+        le_result_t result = LE_OK;
+
+        if (i == destSize)
+        {
+            // No room for the null-terminator.
+            i--;
+            result = LE_OVERFLOW;
+        }
+
+        memcpy(destStr, srcStr, i);
+        destStr[i] = '\0';
+
+        if (numBytesPtr)
+        {
+            *numBytesPtr = i;
+        }
+
+        return result;
+    }
+
+    memcpy(destStr, srcStr, i);
+
+    // Go through the rest of the string copying one character at a time.
     while (1)
     {
         if (srcStr[i] == '\0')
@@ -231,6 +334,109 @@ le_result_t le_utf8_Copy
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies the string in srcStr to the start of destStr, checking that it is correctly formatted
+ * UTF-8 as it goes.  This is le_utf8_Copy() and le_utf8_IsFormatCorrect() in a single pass over
+ * the source, for strings that come from untrusted sources (IPC messages, files, modems, etc.)
+ *
+ * Copies and truncates like le_utf8_Copy(), except that the characters that are copied are fully
+ * checked (lead and continuation bytes), and that a format error is reported as such.
+ *
+ * If destStr and srcStr overlap the behaviour of this function is undefined.
+ *
+ * @return
+ *      - LE_OK if srcStr was completely copied to the destStr.
+ *      - LE_OVERFLOW if srcStr was truncated when it was copied to destStr.
+ *      - LE_FORMAT_ERROR if srcStr is not correctly formatted UTF-8 (destStr is then set to an
+ *        empty string and the number of bytes copied to 0).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_utf8_CopyValidated
+(
+    char* destStr,          ///< [IN] The destination where the srcStr is to be copied.
+    const char* srcStr,     ///< [IN] The UTF-8 source string.
+    const size_t destSize,  ///< [IN] Size of the destination buffer in bytes.
+    size_t* numBytesPtr     ///< [OUT] The number of bytes copied not including the NULL-terminator.
+                            ///        This parameter can be set to NULL if the number of bytes
+                            ///        copied is not needed.
+)
+{
+    // Check parameters.
+    LE_ASSERT( (destStr != NULL) && (srcStr != NULL) && (destSize > 0) );
+
+    // The source is only read up to its null-terminator or the size of the destination, whichever
+    // comes first.
+    size_t srcLen = strnlen(srcStr, destSize);
+    le_result_t result = LE_OK;
+    size_t i = 0;
+
+    while (i < srcLen)
+    {
+        i += AsciiPrefixLen(srcStr + i, srcLen - i);
+
+        if (i == srcLen)
+        {
+            break;
+        }
+
+        size_t charLength = le_utf8_NumBytesInChar(srcStr[i]);
+        size_t j;
+
+        if (charLength == 0)
+        {
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        // Check the continuation bytes that are within reach.  Any beyond the end of the source
+        // (the null-terminator) make the character incomplete; any beyond the end of the
+        // destination buffer make it not fit.
+        for (j = 1; (j < charLength) && (i + j < srcLen); j++)
+        {
+            if ( !le_utf8_IsContinuationByte(srcStr[i + j]) )
+            {
+                break;
+            }
+        }
+
+        if (j < charLength)
+        {
+            result = ((i + j < srcLen) || (srcLen < destSize)) ? LE_FORMAT_ERROR : LE_OVERFLOW;
+            break;
+        }
+
+        i += charLength;
+    }
+
+    if (result == LE_FORMAT_ERROR)
+    {
+        i = 0;
+    }
+    else if (i == destSize)
+    {
+        // No room for the null-terminator, so drop the last character.
+        do
+        {
+            i--;
+        }
+        while ((i > 0) && le_utf8_IsContinuationByte(srcStr[i]));
+
+        result = LE_OVERFLOW;
+    }
+
+    memcpy(destStr, srcStr, i);
+    destStr[i] = '\0';
+
+    if (numBytesPtr)
+    {
+        *numBytesPtr = i;
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Appends srcStr to destStr by copying characters from srcStr to the end of destStr.  The srcStr
@@ -402,9 +608,7 @@ bool le_utf8_IsFormatCorrect
     const char* string      ///< [IN] The string.
 )
 {
-    size_t i;
-    size_t numBytes = 0;
-    size_t strIndex = 0;
+    size_t numChars;
 
     // Check parameters.
     if (string == NULL)
@@ -412,29 +616,7 @@ bool le_utf8_IsFormatCorrect
         return false;
     }
 
-    while (string[strIndex] != '\0')
-    {
-        numBytes = le_utf8_NumBytesInChar(string[strIndex]);
-
-        if (numBytes == 0)
-        {
-            return false;
-        }
-
-        // Go through the bytes in this character to make sure all bytes are formatted correctly.
-        for (i = 1; i < numBytes; i++)
-        {
-            if ( !le_utf8_IsContinuationByte(string[++strIndex]) )
-            {
-                return false;
-            }
-        }
-
-        // Move on.
-        strIndex++;
-    }
-
-    return true;
+    return CheckFormat(string, strlen(string), &numChars);
 }
 
 
@@ -48,6 +48,9 @@ def IsStringParameter(paramObj):
 def IsArrayParameter(paramObj):
     return isinstance(paramObj, interfaceIR.ArrayParameter)
 
+def IsBufferParameter(paramObj):
+    return isinstance(paramObj, interfaceIR.BufferParameter)
+
 ### Function tests
 def HasCallbackFunction(typeObj):
     """Does this function have a callback?"""
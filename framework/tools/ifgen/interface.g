@@ -418,15 +418,23 @@ formalParameterList returns [parameters]
     ;
 
 functionDecl returns [function]
-    : FUNCTION typeIdentifier? IDENTIFIER '(' formalParameterList? ')' ';'
+    : FUNCTION typeIdentifier? name=IDENTIFIER '(' formalParameterList? ')'
+          attribute=IDENTIFIER? ';'
         {
             if $formalParameterList.parameters == None:
                 parameterList = []
             else:
                 parameterList = $formalParameterList.parameters
             $function = interfaceIR.Function($typeIdentifier.typeObj,
-                                              $IDENTIFIER.text,
+                                              $name.text,
                                               parameterList)
+            if $attribute:
+                if $attribute.text == 'HIGH_PRIORITY':
+                    $function.isHighPriority = True
+                else:
+                    self.compileErrors += 1
+                    self.emitErrorMessage(self.getErrorHeaderForToken($attribute) +
+                                          " Unknown function attribute {}".format($attribute.text))
         }
     ;
 
@@ -162,6 +162,9 @@ class HandlerType(Type):
         if any([isinstance(parameter.apiType, HandlerType) for parameter in self.parameters]):
             raise Exception("Handlers cannot have handler parameters")
 
+        if any([isinstance(parameter, BufferParameter) for parameter in self.parameters]):
+            raise Exception("Handlers cannot have buffer parameters")
+
     def __str__(self):
         return "Handler %s(%s)" \
             % (self.name,
@@ -195,6 +198,7 @@ DOUBLE_TYPE = BasicType('double', 8)
 SIZE_TYPE   = BasicType('size', 4)
 STRING_TYPE = BasicType('string', 1)
 FILE_TYPE   = BasicType('file', 0)
+BUFFER_TYPE = BasicType('buffer', 1)
 RESULT_TYPE = BasicType('le_result_t', 4)
 ONOFF_TYPE  = BasicType('le_onoff_t', 4)
 # Indicates an error occurred parsing a type -- e.g. reference to type that doesn't exist
@@ -202,6 +206,18 @@ ERROR_TYPE  = BasicType('**ERROR**', 0)
 # Magic old-handler type
 OLD_HANDLER_TYPE = OldHandlerType()
 
+def GetPackedSize(apiType, compact=False):
+    """
+    Get the maximum number of bytes a value of a type takes up once packed.
+
+    In the compact encoding, every value wider than a byte (other than a double) is packed as a
+    variable-length integer, holding 7 bits per byte.
+    """
+    if compact and apiType.size > 1 and apiType != DOUBLE_TYPE:
+        return (apiType.size * 8 + 6) // 7
+
+    return apiType.size
+
 #---------------------------------------------------------------------------------------------------
 # Formal parameters
 #---------------------------------------------------------------------------------------------------
@@ -212,8 +228,8 @@ class Parameter(object):
         self.direction = direction
         self.comments = []
 
-    def GetMaxSize(self):
-        return self.apiType.size
+    def GetMaxSize(self, compact=False):
+        return GetPackedSize(self.apiType, compact)
 
     def __str__(self):
         result = "%s %s " % (self.apiType.name, self.name)
@@ -232,8 +248,9 @@ class ArrayParameter(Parameter):
         super(ArrayParameter, self).__init__(apiType, name, direction)
         self.maxCount = maxCount
 
-    def GetMaxSize(self):
-        return UINT32_TYPE.size + self.apiType.size * self.maxCount
+    def GetMaxSize(self, compact=False):
+        return (GetPackedSize(UINT32_TYPE, compact) +
+                GetPackedSize(self.apiType, compact) * self.maxCount)
 
     def __str__(self):
         result = "%s %s[%d] " % (self.apiType.name, self.name, self.maxCount)
@@ -251,9 +268,9 @@ class StringParameter(Parameter):
         super(StringParameter, self).__init__(STRING_TYPE, name, direction)
         self.maxCount = maxCount
 
-    def GetMaxSize(self):
+    def GetMaxSize(self, compact=False):
         # Size of a string element is always 1.
-        return UINT32_TYPE.size + self.maxCount
+        return GetPackedSize(UINT32_TYPE, compact) + self.maxCount
 
     def __str__(self):
         result = "%s %s[%d] " % (self.apiType.name, self.name, self.maxCount)
@@ -266,6 +283,20 @@ class StringParameter(Parameter):
     def __repr__(self):
         return "<StringParameter {}>".format(str(self))
 
+class BufferParameter(ArrayParameter):
+    """
+    Array of bytes sent in a shared memory buffer, instead of being copied into the message.  Only
+    the number of bytes is packed, so the maximum size doesn't count towards the message size.
+    """
+    def __init__(self, name, maxCount, direction=DIR_IN):
+        super(BufferParameter, self).__init__(BUFFER_TYPE, name, maxCount, direction)
+
+    def GetMaxSize(self, compact=False):
+        return GetPackedSize(UINT32_TYPE, compact)
+
+    def __repr__(self):
+        return "<BufferParameter {}>".format(str(self))
+
 def MakeParameter(interface, typeObj, name, arraySize, direction=DIR_IN):
     """Helper to make a parameter object"""
     if direction == None:
@@ -281,6 +312,10 @@ def MakeParameter(interface, typeObj, name, arraySize, direction=DIR_IN):
         if arraySize == None:
             raise Exception("String needs a size limit")
         return StringParameter(name, arraySize, direction)
+    elif typeObj == BUFFER_TYPE:
+        if arraySize == None:
+            raise Exception("Buffer needs a size limit")
+        return BufferParameter(name, arraySize, direction)
     elif arraySize != None:
         if isinstance(typeObj, HandlerType):
             raise Exception("Cannot have arrays of handlers")
@@ -320,6 +355,21 @@ class Function(object):
         if len(handlers) > 1:
             raise Exception('A function can only have one handler parameter')
 
+        # Buffers are sent in place of the message's file descriptor, so a message can carry
+        # either one buffer or one file.
+        for direction in (DIR_IN, DIR_OUT):
+            buffers = [ parameter for parameter in parameters
+                        if isinstance(parameter, BufferParameter)
+                           and parameter.direction == direction ]
+            files = [ parameter for parameter in parameters
+                      if parameter.apiType == FILE_TYPE and parameter.direction == direction ]
+            if len(buffers) > 0 and len(buffers) + len(files) > 1:
+                raise Exception('A function can only have one buffer or file parameter '
+                                'in each direction')
+
+        # Set by the HIGH_PRIORITY attribute.  Not part of the protocol, so not in __repr__.
+        self.isHighPriority = False
+
         self.comment = ""
 
     def __str__(self):
@@ -388,6 +438,7 @@ class Interface(object):
                     'size':   SIZE_TYPE,
                     'string': STRING_TYPE,
                     'file':   FILE_TYPE,
+                    'buffer': BUFFER_TYPE,
                     'le_result_t': RESULT_TYPE,
                     'le_onoff_t': ONOFF_TYPE }
 
@@ -520,19 +571,21 @@ class Interface(object):
         else:
             raise Exception("Unknown declaration object type")
 
-    def getMessageSize(self):
+    def getMessageSize(self, compact=False):
         """
         Get size of largest possible message to a function or handler.
 
         A message is 4-bytes for message ID, optional 4
         bytes for required output parameters, and a variable number of bytes to pack
         the return value (if the function has one), and all input and output parameters.
+        If compact is set, the sizes are those of the compact encoding.
         """
         return 8 + max([1] +
-                       [sum([function.returnType.size if function.returnType else 0] +
-                            [parameter.GetMaxSize() for parameter in function.parameters])
+                       [sum([GetPackedSize(function.returnType, compact)
+                             if function.returnType else 0] +
+                            [parameter.GetMaxSize(compact) for parameter in function.parameters])
                         for function in self.functions.values()] +
-                       [sum([parameter.GetMaxSize() for parameter in handler.parameters])
+                       [sum([parameter.GetMaxSize(compact) for parameter in handler.parameters])
                         for handler in self.types.values() if isinstance(handler, HandlerType)])
 
     def __str__(self):
@@ -1705,19 +1705,20 @@ class interfaceParser(Parser):
 
 
     # $ANTLR start "functionDecl"
-    # interface.g:420:1: functionDecl returns [function] : FUNCTION ( typeIdentifier )? IDENTIFIER '(' ( formalParameterList )? ')' ';' ;
+    # interface.g:420:1: functionDecl returns [function] : FUNCTION ( typeIdentifier )? name= IDENTIFIER '(' ( formalParameterList )? ')' (attribute= IDENTIFIER )? ';' ;
     def functionDecl(self, ):
         function = None
 
 
-        IDENTIFIER44 = None
+        name = None
+        attribute = None
         formalParameterList42 = None
         typeIdentifier43 = None
 
         try:
             try:
-                # interface.g:421:5: ( FUNCTION ( typeIdentifier )? IDENTIFIER '(' ( formalParameterList )? ')' ';' )
-                # interface.g:421:7: FUNCTION ( typeIdentifier )? IDENTIFIER '(' ( formalParameterList )? ')' ';'
+                # interface.g:421:5: ( FUNCTION ( typeIdentifier )? name= IDENTIFIER '(' ( formalParameterList )? ')' (attribute= IDENTIFIER )? ';' )
+                # interface.g:421:7: FUNCTION ( typeIdentifier )? name= IDENTIFIER '(' ( formalParameterList )? ')' (attribute= IDENTIFIER )? ';'
                 pass 
                 self.match(self.input, FUNCTION, self.FOLLOW_FUNCTION_in_functionDecl1648)
 
@@ -1743,7 +1744,7 @@ class interfaceParser(Parser):
 
 
 
-                IDENTIFIER44 = self.match(self.input, IDENTIFIER, self.FOLLOW_IDENTIFIER_in_functionDecl1653)
+                name = self.match(self.input, IDENTIFIER, self.FOLLOW_IDENTIFIER_in_functionDecl1653)
 
                 self.match(self.input, 29, self.FOLLOW_29_in_functionDecl1655)
 
@@ -1766,7 +1767,21 @@ class interfaceParser(Parser):
 
                 self.match(self.input, 30, self.FOLLOW_30_in_functionDecl1660)
 
-                self.match(self.input, SEMICOLON, self.FOLLOW_SEMICOLON_in_functionDecl1662)
+                # interface.g:422:20: (attribute= IDENTIFIER )?
+                alt28 = 2
+                LA28_0 = self.input.LA(1)
+
+                if (LA28_0 == IDENTIFIER) :
+                    alt28 = 1
+                if alt28 == 1:
+                    # interface.g:422:20: attribute= IDENTIFIER
+                    pass 
+                    attribute = self.match(self.input, IDENTIFIER, self.FOLLOW_IDENTIFIER_in_functionDecl1667)
+
+
+
+
+                self.match(self.input, SEMICOLON, self.FOLLOW_SEMICOLON_in_functionDecl1670)
 
                 #action start
                         
@@ -1775,8 +1790,15 @@ class interfaceParser(Parser):
                 else:
                     parameterList = formalParameterList42
                 function = interfaceIR.Function(typeIdentifier43,
-                                                  IDENTIFIER44.text,
+                                                  name.text,
                                                   parameterList)
+                if attribute:
+                    if attribute.text == 'HIGH_PRIORITY':
+                        function.isHighPriority = True
+                    else:
+                        self.compileErrors += 1
+                        self.emitErrorMessage(self.getErrorHeaderForToken(attribute) +
+                                              " Unknown function attribute {}".format(attribute.text))
                         
                 #action end
 
@@ -2640,8 +2662,9 @@ class interfaceParser(Parser):
     FOLLOW_IDENTIFIER_in_functionDecl1653 = frozenset([29])
     FOLLOW_29_in_functionDecl1655 = frozenset([19, 25, 30])
     FOLLOW_formalParameterList_in_functionDecl1657 = frozenset([30])
-    FOLLOW_30_in_functionDecl1660 = frozenset([26])
-    FOLLOW_SEMICOLON_in_functionDecl1662 = frozenset([1])
+    FOLLOW_30_in_functionDecl1660 = frozenset([19, 26])
+    FOLLOW_IDENTIFIER_in_functionDecl1667 = frozenset([26])
+    FOLLOW_SEMICOLON_in_functionDecl1670 = frozenset([1])
     FOLLOW_HANDLER_in_handlerDecl1693 = frozenset([19])
     FOLLOW_IDENTIFIER_in_handlerDecl1695 = frozenset([29])
     FOLLOW_29_in_handlerDecl1697 = frozenset([19, 25, 30])
@@ -12,6 +12,11 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='generate asynchronous-style server functions')
+    parser.add_argument('--async-client',
+                        dest="asyncClient",
+                        action='store_true',
+                        default=False,
+                        help='also generate asynchronous (batchable) client functions')
 
 # Custom filters needed for C templates
 Filters = { 'FormatHeaderComment': codeGenHelpers.FormatHeaderComment,
@@ -27,10 +32,14 @@ Filters = { 'FormatHeaderComment': codeGenHelpers.FormatHeaderComment,
             'CAPIParameters':      codeGenHelpers.IterCAPIParameters }
 
 
-Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter }
+Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter,
+          'ByValueParameter':      codeGenHelpers.IsByValueParameter }
 
 Globals = { 'Labeler':             codeGenHelpers.Labeler }
 
+# Supports the --compact option (see le_pack.h).
+CompactEncoding = True
+
 GeneratedFiles = { 'interface' : '%s_interface.h',
                    'local' : '%s_messages.h',
                    'client' : '%s_client.c',
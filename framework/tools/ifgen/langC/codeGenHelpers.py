@@ -10,6 +10,7 @@
 # Copyright (C) Sierra Wirless Inc.
 #
 
+import jinja2
 import interfaceIR
 
 #---------------------------------------------------------------------------------------------------
@@ -67,6 +68,7 @@ def FormatType(apiType):
         interfaceIR.SIZE_TYPE:   "size_t",
         interfaceIR.STRING_TYPE: "char*",
         interfaceIR.FILE_TYPE:   "int",
+        interfaceIR.BUFFER_TYPE: "uint8_t",
         interfaceIR.RESULT_TYPE: "le_result_t",
         interfaceIR.ONOFF_TYPE:  "le_onoff_t",
         _CONTEXT_TYPE: "void*"
@@ -163,33 +165,46 @@ _PackFunctionMapping = {
     interfaceIR.ONOFF_TYPE:  "le_pack_%sOnOff",
 }
 
-def GetPackFunction(apiType):
-    if isinstance(apiType, interfaceIR.ReferenceType):
-        return "le_pack_PackReference"
-    elif isinstance(apiType, interfaceIR.BitmaskType) or \
-         isinstance(apiType, interfaceIR.EnumType):
-        if (apiType.size == 4):
-            return "le_pack_PackUint32"
-        elif (apiType.size == 8):
-            return "le_pack_PackUint64"
-        else:
-            raise KeyError(apiType.name)
-    else:
-        return _PackFunctionMapping[apiType] % ("Pack", )
+# Functions used for the types that have a compact encoding (see le_pack.h).  Types not listed here
+# are packed the same way in both encodings.
+_CompactPackFunctionMapping = {
+    interfaceIR.UINT16_TYPE: "le_pack_%sVarUint16",
+    interfaceIR.UINT32_TYPE: "le_pack_%sVarUint32",
+    interfaceIR.UINT64_TYPE: "le_pack_%sVarUint64",
+    interfaceIR.INT16_TYPE:  "le_pack_%sVarInt16",
+    interfaceIR.INT32_TYPE:  "le_pack_%sVarInt32",
+    interfaceIR.INT64_TYPE:  "le_pack_%sVarInt64",
+    interfaceIR.SIZE_TYPE:   "le_pack_%sVarSize",
+    interfaceIR.STRING_TYPE: "le_pack_%sCompactString",
+    interfaceIR.RESULT_TYPE: "le_pack_%sVarResult",
+    interfaceIR.ONOFF_TYPE:  "le_pack_%sVarOnOff",
+}
 
-def GetUnpackFunction(apiType):
+def _GetPackUnpackFunction(apiType, direction, compact):
+    varPrefix = "Var" if compact else ""
     if isinstance(apiType, interfaceIR.ReferenceType):
-        return "le_pack_UnpackReference"
+        return "le_pack_%s%sReference" % (direction, varPrefix)
     elif isinstance(apiType, interfaceIR.BitmaskType) or \
          isinstance(apiType, interfaceIR.EnumType):
         if (apiType.size == 4):
-            return "le_pack_UnpackUint32"
+            return "le_pack_%s%sUint32" % (direction, varPrefix)
         elif (apiType.size == 8):
-            return "le_pack_UnpackUint64"
+            return "le_pack_%s%sUint64" % (direction, varPrefix)
         else:
             raise KeyError(apiType.name)
+    elif compact and apiType in _CompactPackFunctionMapping:
+        return _CompactPackFunctionMapping[apiType] % (direction, )
     else:
-        return _PackFunctionMapping[apiType] % ("Unpack", )
+        return _PackFunctionMapping[apiType] % (direction, )
+
+# The pack functions depend on whether the template is generating code for the compact encoding.
+@jinja2.contextfilter
+def GetPackFunction(context, apiType):
+    return _GetPackUnpackFunction(apiType, "Pack", context.get('compact', False))
+
+@jinja2.contextfilter
+def GetUnpackFunction(context, apiType):
+    return _GetPackUnpackFunction(apiType, "Unpack", context.get('compact', False))
 
 #---------------------------------------------------------------------------------------------------
 # Test functions
@@ -197,6 +212,16 @@ def GetUnpackFunction(apiType):
 def IsSizeParameter(parameter):
     return isinstance(parameter, SizeParameter)
 
+def IsByValueParameter(parameter):
+    """Is this parameter packed from its value alone (not a string, an array or a file)?"""
+    if isinstance(parameter, (interfaceIR.StringParameter, interfaceIR.ArrayParameter)):
+        return False
+    if isinstance(parameter.apiType, interfaceIR.BasicType):
+        return parameter.apiType.name != 'file'
+    return isinstance(parameter.apiType, (interfaceIR.EnumType,
+                                          interfaceIR.BitmaskType,
+                                          interfaceIR.ReferenceType))
+
 #---------------------------------------------------------------------------------------------------
 # Global functions
 #---------------------------------------------------------------------------------------------------
@@ -7,7 +7,7 @@
  #
  #  Copyright (C) Sierra Wireless Inc.
  #}
-{%- import 'pack.templ' as pack -%}
+{%- import 'pack.templ' as pack with context -%}
 /*
  * ====================== WARNING ======================
  *
@@ -50,6 +50,32 @@ _ClientData_t;
  */
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t _ClientDataPool;
+{%- if args.asyncClient %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Async Request Objects
+ *
+ * This object holds on to the response handler for a request made using one of the Async
+ * functions, until the response arrives.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void (*respFuncPtr)(void);  ///< Response handler (cast back to its real type to call it)
+    void*  contextPtr;          ///< ContextPtr passed to the Async function
+}
+_AsyncRequest_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for async request objects
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t _AsyncRequestPool;
+{%- endif %}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -150,6 +176,52 @@ static void ClientIndicationRecvHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a session to the service for the current thread, without opening it.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t CreateClientSession
+(
+    void
+)
+{
+    le_msg_ProtocolRef_t protocolRef;
+    le_msg_SessionRef_t sessionRef;
+
+    protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(_Message_t));
+    sessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetSessionRecvHandler(sessionRef, ClientIndicationRecvHandler, NULL);
+
+    return sessionRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize thread specific data for an open session to the service.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitClientThreadData
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    // Store the client sessionRef in thread-local storage, since each thread requires
+    // its own sessionRef.
+    _ClientThreadData_t* clientThreadPtr = le_mem_ForceAlloc(_ClientThreadDataPool);
+    memset(clientThreadPtr, 0, sizeof(_ClientThreadData_t));
+    clientThreadPtr->sessionRef = sessionRef;
+    if (pthread_setspecific(_ThreadDataKey, clientThreadPtr) != 0)
+    {
+        LE_FATAL("pthread_setspecific() failed!");
+    }
+
+    // This is the first client for the current thread
+    clientThreadPtr->clientCount = 1;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize thread specific data, and connect to the service for the current thread.
@@ -168,12 +240,7 @@ static le_result_t InitClientForThread
 )
 {
     // Open a session.
-    le_msg_ProtocolRef_t protocolRef;
-    le_msg_SessionRef_t sessionRef;
-
-    protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(_Message_t));
-    sessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
-    le_msg_SetSessionRecvHandler(sessionRef, ClientIndicationRecvHandler, NULL);
+    le_msg_SessionRef_t sessionRef = CreateClientSession();
 
     if ( isBlocking )
     {
@@ -215,18 +282,7 @@ static le_result_t InitClientForThread
         }
     }
 
-    // Store the client sessionRef in thread-local storage, since each thread requires
-    // its own sessionRef.
-    _ClientThreadData_t* clientThreadPtr = le_mem_ForceAlloc(_ClientThreadDataPool);
-    memset(clientThreadPtr, 0, sizeof(_ClientThreadData_t));
-    clientThreadPtr->sessionRef = sessionRef;
-    if (pthread_setspecific(_ThreadDataKey, clientThreadPtr) != 0)
-    {
-        LE_FATAL("pthread_setspecific() failed!");
-    }
-
-    // This is the first client for the current thread
-    clientThreadPtr->clientCount = 1;
+    InitClientThreadData(sessionRef);
 
     return LE_OK;
 }
@@ -279,6 +335,11 @@ static void InitCommonData(void)
 {
     // Allocate the client data pool
     _ClientDataPool = le_mem_CreatePool("{{apiName}}_ClientData", sizeof(_ClientData_t));
+    {%- if args.asyncClient %}
+
+    // Allocate the async request pool
+    _AsyncRequestPool = le_mem_CreatePool("{{apiName}}_AsyncRequest", sizeof(_AsyncRequest_t));
+    {%- endif %}
 
     // Allocate the client thread pool
     _ClientThreadDataPool = le_mem_CreatePool("{{apiName}}_ClientThreadData",
@@ -295,6 +356,23 @@ static void InitCommonData(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init the common data, if this is the first time the service is connected to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitCommonDataOnce(void)
+{
+    LOCK_INIT
+    if ( ! CommonDataInitialized )
+    {
+        InitCommonData();
+        CommonDataInitialized = true;
+    }
+    UNLOCK_INIT
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Connect to the service, using either blocking or non-blocking calls.
@@ -315,13 +393,7 @@ static le_result_t DoConnectService
 )
 {
     // If this is the first time the function is called, init the client common data.
-    LOCK_INIT
-    if ( ! CommonDataInitialized )
-    {
-        InitCommonData();
-        CommonDataInitialized = true;
-    }
-    UNLOCK_INIT
+    InitCommonDataOnce();
 
     _ClientThreadData_t* clientThreadPtr = GetClientThreadDataPtr();
 
@@ -403,6 +475,56 @@ le_result_t {{apiName}}_TryConnectService
     return DoConnectService(false);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * First half of {{apiName}}_ConnectService(), used by the generated component main to open the
+ * sessions of all of its client-side interfaces at once, using le_msg_OpenSessionsSync().
+ *
+ * @return The session to open, or NULL if the current thread is already connected to the service.
+ *
+ * This function is created automatically, and is not part of the API.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t {{apiName}}_PrepareConnectService
+(
+    void
+)
+{
+    InitCommonDataOnce();
+
+    if (GetClientThreadDataPtr() != NULL)
+    {
+        return NULL;
+    }
+
+    return CreateClientSession();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Second half of {{apiName}}_ConnectService(), called once the session returned by
+ * {{apiName}}_PrepareConnectService() has been opened.
+ *
+ * This function is created automatically, and is not part of the API.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_FinishConnectService
+(
+    le_msg_SessionRef_t sessionRef      ///< [IN] Opened session, or NULL if already connected.
+)
+{
+    if (sessionRef == NULL)
+    {
+        // Count another client on the connection the thread already has.
+        DoConnectService(true);
+        return;
+    }
+
+    InitClientThreadData(sessionRef);
+
+    LE_DEBUG("======= Starting client for '%s' service ========", SERVICE_INSTANCE_NAME);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Session close handler.
 //
@@ -523,6 +645,42 @@ void {{apiName}}_DisconnectService
         }
     }
 }
+{%- if args.asyncClient %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of requests on the current client thread's connection to the service.  Requests
+ * made using the Async functions are queued until the matching call to {{apiName}}_EndBatch(),
+ * and then all sent to the server together.  Batches can be nested.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_StartBatch
+(
+    void
+)
+{
+    le_msg_StartBatch(GetCurrentSessionRef());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a batch of requests started using {{apiName}}_StartBatch().
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_EndBatch
+(
+    void
+)
+{
+    le_msg_EndBatch(GetCurrentSessionRef());
+}
+{%- endif %}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -660,8 +818,13 @@ error_unpack:
     {%- endfor %}
 
 
-    // Create a new message object and get the message buffer
+    // Create a new message object and get the message buffer.  Only the packed bytes are sent,
+    // so start with an empty payload instead of clearing the whole buffer.
     _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    le_msg_SetPayloadSize(_msgRef, 0);
+    {%- if function.isHighPriority %}
+    le_msg_SetHighPriority(_msgRef);
+    {%- endif %}
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
     _msgBufPtr = _msgPtr->buffer;
@@ -697,6 +860,7 @@ error_unpack:
     {%- endif %}
 
     // Send a request to the server and get the response.
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     LE_DEBUG("Sending message to server and waiting for response : %ti bytes sent",
              _msgBufPtr-_msgPtr->buffer);
     _responseMsgRef = le_msg_RequestSyncResponse(_msgRef);
@@ -738,7 +902,7 @@ error_unpack:
     {%- endif %}
 
     // Unpack any "out" parameters
-    {%- call pack.UnpackOutputs(function.parameters) %}
+    {%- call pack.UnpackOutputs(function.parameters, msgRef='_responseMsgRef') %}
         goto {{error_unpack_label}};
     {%- endcall %}
 
@@ -759,6 +923,184 @@ error_unpack:
     {%- endif %}
     {%- endwith %}
 }
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+
+// This function parses the response to a request made using {{apiName}}_{{function.name}}Async(),
+// and then passes the results to the response handler given by the caller.
+static void _Handle_{{apiName}}_{{function.name}}Response
+(
+    le_msg_MessageRef_t _msgRef,
+    void* _requestPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    _AsyncRequest_t* _asyncRequestPtr = _requestPtr;
+    {{apiName}}_{{function.name}}RespFunc_t _respFuncPtr =
+        ({{apiName}}_{{function.name}}RespFunc_t)_asyncRequestPtr->respFuncPtr;
+    void* _contextPtr = _asyncRequestPtr->contextPtr;
+    le_mem_Release(_asyncRequestPtr);
+
+    // If the session closed before the response arrived, there are no results to pass on.  The
+    // session close handler takes care of the disconnection.
+    if (_msgRef == NULL)
+    {
+        LE_ERROR("No response received to {{apiName}}_{{function.name}}Async()");
+        return;
+    }
+
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    {%- if function.returnType %}
+
+    // Unpack the result first
+    {{function.returnType|FormatType}} _result;
+    if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+    {
+        goto {{error_unpack_label}};
+    }
+    {%- endif %}
+
+    // Define storage for output parameters
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    char {{parameter.name}}Buffer[{{parameter.maxCount + 1}}] = "";
+    char* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = sizeof({{parameter.name}}Buffer);
+    {%- elif parameter is BufferParameter %}
+    const uint8_t* {{parameter.name}}Buffer = NULL;
+    size_t {{parameter.name}}Size = 0;
+    {%- elif parameter is ArrayParameter %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}Buffer[{{parameter.maxCount}}];
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = {{parameter.maxCount}};
+    size_t* {{parameter.name}}SizePtr = &{{parameter.name}}Size;
+    {%- else %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}Buffer;
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = &{{parameter.name}}Buffer;
+    {%- endif %}
+    {%- endfor %}
+
+    // Unpack any "out" parameters
+    {%- call pack.UnpackOutputs(function.parameters, mapBuffers=True) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
+    {%- set hasOutputBuffers = any(function.parameters|select('OutParameter'), 'BufferParameter') %}
+    {%- if not hasOutputBuffers %}
+
+    // Release the message object, now that all results/output has been copied.
+    le_msg_ReleaseMsg(_msgRef);
+    {%- endif %}
+
+    _respFuncPtr(
+        {%- if function.returnType %}_result, {% endif %}
+        {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+        {%- if parameter is SizeParameter %}{{parameter.name}}
+        {%- else %}{{parameter.name}}Buffer{% endif %}, {% endfor -%}
+        _contextPtr);
+    {%- if hasOutputBuffers %}
+
+    // The output buffers are passed straight from the message, so only release it now.
+    le_msg_ReleaseMsg(_msgRef);
+    {%- endif %}
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous version of {{apiName}}_{{function.name}}().  Sends the request (or queues it, if a
+ * batch has been started) and returns without waiting for the response.  All outputs are
+ * requested, and are passed to respFuncPtr, which is called by the calling thread's event loop
+ * when the response arrives.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters if parameter is InParameter and
+        not (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {{apiName}}_{{function.name}}RespFunc_t respFuncPtr,
+        ///< [IN] Function to be called when the response arrives.
+    void* contextPtr
+        ///< [IN] Value to be passed to respFuncPtr.
+)
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to the server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+
+    // Range check values, if appropriate
+    {%- for parameter in function.parameters if parameter is InParameter %}
+    {%- if parameter is StringParameter %}
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- elif parameter is ArrayParameter %}
+    if ( (NULL == {{parameter|FormatParameterName}}) &&
+         (0 != {{parameter|GetParameterCount}}) )
+    {
+        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
+                 "{{parameter|GetParameterCount}} must be zero");
+    }
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- endif %}
+    {%- endfor %}
+    LE_FATAL_IF(respFuncPtr == NULL, "respFuncPtr is NULL");
+
+    // Create a new message object and get the message buffer.  Only the packed bytes are sent,
+    // so start with an empty payload instead of clearing the whole buffer.
+    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    le_msg_SetPayloadSize(_msgRef, 0);
+    {%- if function.isHighPriority %}
+    le_msg_SetHighPriority(_msgRef);
+    {%- endif %}
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _MAX_MSG_SIZE;
+
+    // All outputs are requested, since they are all passed to the response handler.
+    {%- if any(function.parameters, "OutParameter") %}
+    uint32_t _requiredOutputs = 0;
+    {%- for output in function.parameters if output is OutParameter %}
+    _requiredOutputs |= (1u << {{loop.index0}});
+    {%- endfor %}
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
+    {%- endif %}
+
+    // Pack the input parameters
+    {{- pack.PackInputs(function.parameters, maxOutputSizes=True) }}
+
+    // Keep the response handler until the response arrives.
+    _AsyncRequest_t* _asyncRequestPtr = le_mem_ForceAlloc(_AsyncRequestPool);
+    _asyncRequestPtr->respFuncPtr = (void (*)(void))respFuncPtr;
+    _asyncRequestPtr->contextPtr = contextPtr;
+
+    // Send the request to the server.
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+    LE_DEBUG("Sending async request to server : %ti bytes sent", _msgBufPtr-_msgPtr->buffer);
+    le_msg_RequestResponse(_msgRef, _Handle_{{apiName}}_{{function.name}}Response,
+                           _asyncRequestPtr);
+}
+{%- endif %}
 {%- endfor %}
 
 
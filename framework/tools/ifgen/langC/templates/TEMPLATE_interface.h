@@ -98,4 +98,73 @@ void {{apiName}}_DisconnectService
 (
     void
 );
+{%- if args.asyncClient %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of requests on the current client thread's connection to the service.  Requests
+ * made using the Async functions are queued until the matching call to {{apiName}}_EndBatch(),
+ * and then all sent to the server together.  Batches can be nested.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_StartBatch
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a batch of requests started using {{apiName}}_StartBatch().
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_EndBatch
+(
+    void
+);
+{%- endif %}
+{%- endblock %}
+{% block FunctionDeclaration %}
+{{- super() }}
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response handler for {{apiName}}_{{function.name}}Async().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*{{apiName}}_{{function.name}}RespFunc_t)
+(
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}} _result,
+    {%- endif %}
+    {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+    {{parameter|FormatParameter(forceInput=True)}},
+    {%- endfor %}
+    void* contextPtr
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous version of {{apiName}}_{{function.name}}().  Sends the request (or queues it, if a
+ * batch has been started) and returns without waiting for the response.  All outputs are
+ * requested, and are passed to respFuncPtr, which is called by the calling thread's event loop
+ * when the response arrives.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters if parameter is InParameter and
+        not (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+    {{parameter|FormatParameter}},
+    {%- endfor %}
+    {{apiName}}_{{function.name}}RespFunc_t respFuncPtr,
+    void* contextPtr
+);
+{%- endif %}
 {%- endblock %}
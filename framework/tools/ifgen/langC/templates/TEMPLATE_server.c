@@ -7,7 +7,7 @@
  #
  #  Copyright (C) Sierra Wireless Inc.
  #}
-{% import 'pack.templ' as pack -%}
+{% import 'pack.templ' as pack with context -%}
 /*
  * ====================== WARNING ======================
  *
@@ -129,22 +129,14 @@ static void ServerMsgRecvHandler
 static le_msg_ServiceRef_t _ServerServiceRef;
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Server Thread Reference
- *
- * Reference to the thread that is registered to provide this service.
- */
-//--------------------------------------------------------------------------------------------------
-static le_thread_Ref_t _ServerThreadRef;
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Client Session Reference for the current message received from a client
+ *
+ * Thread-local, because the service's sessions may be handled by worker threads.
  */
 //--------------------------------------------------------------------------------------------------
-static le_msg_SessionRef_t _ClientSessionRef;
+static __thread le_msg_SessionRef_t _ClientSessionRef;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -210,27 +202,12 @@ static void CleanupClientData
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Send the message to the client (queued version)
- *
- * This is a wrapper around le_msg_Send() with an extra parameter so that it can be used
- * with le_event_QueueFunctionToThread().
- */
-//--------------------------------------------------------------------------------------------------
-__attribute__((unused)) static void SendMsgToClientQueued
-(
-    void*  msgRef,  ///< [in] Reference to the message.
-    void*  unused   ///< [in] Not used
-)
-{
-    le_msg_Send(msgRef);
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Send the message to the client.
+ *
+ * This can be called from any thread: if it isn't the thread handling the client's session (the
+ * server thread, or one of the service's worker threads), the message is passed on to that thread.
  */
 //--------------------------------------------------------------------------------------------------
 __attribute__((unused)) static void SendMsgToClient
@@ -238,22 +215,7 @@ __attribute__((unused)) static void SendMsgToClient
     le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
 )
 {
-    /*
-     * If called from a thread other than the server thread, queue the message onto the server
-     * thread.  This is necessary to allow async response/handler functions to be called from any
-     * thread, whereas messages to the client can only be sent from the server thread.
-     */
-    if ( le_thread_GetCurrent() != _ServerThreadRef )
-    {
-        le_event_QueueFunctionToThread(_ServerThreadRef,
-                                       SendMsgToClientQueued,
-                                       msgRef,
-                                       NULL);
-    }
-    else
-    {
-        le_msg_Send(msgRef);
-    }
+    le_msg_Send(msgRef);
 }
 
 
@@ -274,6 +236,9 @@ le_msg_ServiceRef_t {{apiName}}_GetServiceRef
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the client session reference for the current message
+ *
+ * This is the session of the message being handled by the calling thread, so it is NULL in any
+ * other thread (such as one that a handler has passed some work on to).
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_SessionRef_t {{apiName}}_GetClientSessionRef
@@ -320,9 +285,6 @@ void {{apiName}}_AdvertiseService
 
     // Register for client sessions being closed
     le_msg_AddServiceCloseHandler(_ServerServiceRef, CleanupClientData, NULL);
-
-    // Need to keep track of the thread that is registered to provide this service.
-    _ServerThreadRef = le_thread_GetCurrent();
 }
 
 
@@ -332,6 +294,32 @@ void {{apiName}}_AdvertiseService
 {%- for function in functions %}
 {#- Write out handler first; there should only be one per function #}
 {%- for handler in function.parameters if handler.apiType is HandlerType %}
+{%- set isEventCached = function is AddHandlerFunction
+        and handler.apiType.parameters|length > 0
+        and handler.apiType.parameters|reject('ByValueParameter')|list|length == 0 %}
+{%- if isEventCached %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last event passed to the {{apiName}}_{{function.name}}() handlers by this thread, and its packed
+ * parameters.
+ *
+ * A server reports an event to the handlers of all of its clients one after the other, so the
+ * parameters are only packed for the first one.
+ */
+//--------------------------------------------------------------------------------------------------
+static __thread struct
+{
+    bool isValid;
+    {%- for parameter in handler.apiType.parameters %}
+    {{parameter.apiType|FormatType}} {{parameter.name}};
+    {%- endfor %}
+    size_t size;
+    uint8_t bytes[{{handler.apiType.parameters|length}} * LE_PACK_VARINT_MAX_BYTES];
+}
+_Last{{function.name}}Event;
+{%- endif %}
 
 
 static void AsyncResponse_{{apiName}}_{{function.name}}
@@ -359,8 +347,10 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
     __attribute__((unused)) uint8_t* _msgBufPtr;
     __attribute__((unused)) size_t _msgBufSize;
 
-    // Create a new message object and get the message buffer
+    // Create a new message object and get the message buffer.  Only the packed bytes are sent,
+    // so start with an empty payload instead of clearing the whole buffer.
     _msgRef = le_msg_CreateMsg(serverDataPtr->clientSessionRef);
+    le_msg_SetPayloadSize(_msgRef, 0);
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
     _msgBufPtr = _msgPtr->buffer;
@@ -368,11 +358,44 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
 
     // Always pack the client context pointer first
     LE_ASSERT(le_pack_PackReference( &_msgBufPtr, &_msgBufSize, serverDataPtr->contextPtr ))
+    {%- if isEventCached %}
+
+    // Copy the input parameters if they were already packed for another client, else pack them.
+    if (_Last{{function.name}}Event.isValid
+        {%- for parameter in handler.apiType.parameters %}
+        && (memcmp(&_Last{{function.name}}Event.{{parameter.name}},
+        {#- #} &{{parameter|FormatParameterName}}, sizeof({{parameter|FormatParameterName}})) == 0)
+        {%- endfor %}
+        && (_Last{{function.name}}Event.size <= _msgBufSize))
+    {
+        memcpy(_msgBufPtr, _Last{{function.name}}Event.bytes, _Last{{function.name}}Event.size);
+        _msgBufPtr += _Last{{function.name}}Event.size;
+        _msgBufSize -= _Last{{function.name}}Event.size;
+    }
+    else
+    {
+        uint8_t* _paramsPtr = _msgBufPtr;
+        {{ pack.PackInputs(handler.apiType.parameters)|indent(4) }}
+
+        _Last{{function.name}}Event.size = _msgBufPtr - _paramsPtr;
+        _Last{{function.name}}Event.isValid =
+            (_Last{{function.name}}Event.size <= sizeof(_Last{{function.name}}Event.bytes));
+        if (_Last{{function.name}}Event.isValid)
+        {
+            memcpy(_Last{{function.name}}Event.bytes, _paramsPtr, _Last{{function.name}}Event.size);
+            {%- for parameter in handler.apiType.parameters %}
+            _Last{{function.name}}Event.{{parameter.name}} = {{parameter|FormatParameterName}};
+            {%- endfor %}
+        }
+    }
+    {%- else %}
 
     // Pack the input parameters
     {{ pack.PackInputs(handler.apiType.parameters) }}
+    {%- endif %}
 
     // Send the async response to the client
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     LE_DEBUG("Sending message to client session %p : %ti bytes sent",
              serverDataPtr->clientSessionRef,
              _msgBufPtr-_msgPtr->buffer);
@@ -440,12 +463,25 @@ void {{apiName}}_{{function.name}}Respond
     {
         {{parameter|FormatParameterName}} = NULL;
     }
+    {%- if parameter is BufferParameter %}
+    else if ({{parameter.name}}Size > 0)
+    {
+        // Copy the output into a shared buffer, which is sent instead.
+        LE_ASSERT({{parameter.name}}Size <= {{parameter.maxCount}});
+        uint8_t* {{parameter.name}}BufPtr =
+            le_msg_CreateSharedBuffer(_msgRef, {{parameter.name}}Size);
+        LE_ASSERT({{parameter.name}}BufPtr != NULL);
+        memcpy({{parameter.name}}BufPtr, {{parameter|FormatParameterName}},
+               {{parameter.name}}Size);
+    }
+    {%- endif %}
     {%- endfor %}
 
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
 
     // Return the response
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     LE_DEBUG("Sending response to client session %p", le_msg_GetSession(_msgRef));
     le_msg_Respond(_msgRef);
 
@@ -579,6 +615,17 @@ static void Handle_{{apiName}}_{{function.name}}
     char {{parameter.name}}Buffer[{{parameter.maxCount + 1}}];
     char *{{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
     {{parameter|FormatParameterName}}[0] = 0;
+    {%- elif parameter is BufferParameter %}
+    uint8_t {{parameter.name}}Empty[1];
+    uint8_t *{{parameter|FormatParameterName}} = {{parameter.name}}Empty;
+    size_t *{{parameter.name}}SizePtr = &{{parameter.name}}Size;
+    if ((_requiredOutputs & (1u << {{loop.index0}})) && ({{parameter.name}}Size > 0))
+    {
+        // The output is written straight into the shared buffer sent back to the client.
+        {{parameter|FormatParameterName}} =
+            le_msg_CreateSharedBuffer(_msgRef, {{parameter.name}}Size);
+        LE_ASSERT({{parameter|FormatParameterName}} != NULL);
+    }
     {%- elif parameter is ArrayParameter %}
     {{parameter.apiType|FormatType}} {{parameter.name}}Buffer
         {#- #}[{{parameter.maxCount}}];
@@ -650,6 +697,7 @@ static void Handle_{{apiName}}_{{function.name}}
     {{- pack.PackOutputs(function.parameters) }}
 
     // Return the response
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef));
     LE_DEBUG("Sending response to client session %p : %ti bytes sent",
              le_msg_GetSession(_msgRef),
              _msgBufPtr-_msgBufStartPtr);
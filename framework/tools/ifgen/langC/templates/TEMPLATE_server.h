@@ -37,6 +37,9 @@ le_msg_ServiceRef_t {{apiName}}_GetServiceRef
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the client session reference for the current message
+ *
+ * This is the session of the message being handled by the calling thread, so it is NULL in any
+ * other thread (such as one that a handler has passed some work on to).
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_SessionRef_t {{apiName}}_GetClientSessionRef
@@ -0,0 +1,52 @@
+#
+# Init file for the C++ language package
+#
+# The C++ interface is a header-only layer over the C client interface, and the C++ server class
+# is called by the C server interface, so both reuse the C language package's helpers for
+# everything that maps straight onto the C API.
+#
+# Copyright (C) Sierra Wireless Inc.
+#
+
+import langC.codeGenHelpers as cHelpers
+import codeGenHelpers
+
+def AddLangArgumentGroup(parser):
+    parser.add_argument('--async-server',
+                        dest="async",
+                        action='store_true',
+                        default=False,
+                        help='generate an asynchronous-style server class (the C server interface'
+                             ' must be generated with --async-server too)')
+    parser.add_argument('--async-client',
+                        dest="asyncClient",
+                        action='store_true',
+                        default=False,
+                        help='also generate asynchronous client functions (the C interface must'
+                             ' be generated with --async-client too)')
+
+# Custom filters needed for C++ templates
+Filters = { 'FormatHeaderComment':   cHelpers.FormatHeaderComment,
+            'FormatType':            cHelpers.FormatType,
+            'FormatParameter':       cHelpers.FormatParameter,
+            'FormatParameterName':   cHelpers.FormatParameterName,
+            'CAPIParameters':        cHelpers.IterCAPIParameters,
+            'FormatCppParameter':    codeGenHelpers.FormatCppParameter,
+            'FormatCArguments':      codeGenHelpers.FormatCArguments,
+            'FormatServerParameter': codeGenHelpers.FormatServerParameter,
+            'FormatServerArguments': codeGenHelpers.FormatServerArguments,
+            'FormatViewType':        codeGenHelpers.FormatViewType,
+            'FormatViewArgument':    codeGenHelpers.FormatViewArgument,
+            'GetHandlerParameter':   codeGenHelpers.GetHandlerParameter }
+
+Tests = { 'SizeParameter':           cHelpers.IsSizeParameter,
+          'CppSupported':            codeGenHelpers.IsCppSupported }
+
+Globals = { }
+
+# The C++ wrappers and server classes don't pack anything themselves, so they work with either
+# encoding of the C code they are layered over (see le_pack.h).
+CompactEncoding = True
+
+GeneratedFiles = { 'interface' : '%s_interface.hpp',
+                   'server-interface' : '%s_server.hpp' }
@@ -0,0 +1,134 @@
+#
+# Functions for easing writing C++ templates.
+#
+# The C++ interface wraps the C client interface: strings and arrays are passed as views of the
+# caller's buffers (le_cpp::StrView, le_cpp::ArrayView and le_cpp::Span, defined in the generated
+# header), which the C client code packs straight into the IPC message.  The C++ server class is
+# called by the C server interface in the same way, with views of the received message and of the
+# buffers the response is packed from (le_cpp::StrBuf for output strings).  These helpers map each
+# .api parameter onto its C++ form, and onto the arguments it is passed on as.
+#
+# Copyright (C) Sierra Wireless Inc.
+#
+
+import interfaceIR
+import langC.codeGenHelpers as cHelpers
+
+#---------------------------------------------------------------------------------------------------
+# Filters
+#---------------------------------------------------------------------------------------------------
+
+def FormatCppParameter(parameter):
+    """Declare a parameter of a C++ wrapper function"""
+    cType = cHelpers.FormatType(parameter.apiType)
+    isOut = (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT
+    if isinstance(parameter, interfaceIR.StringParameter):
+        if isOut:
+            return u"std::string& " + parameter.name
+        return u"le_cpp::StrView " + parameter.name
+    elif isinstance(parameter, interfaceIR.ArrayParameter):
+        if isOut:
+            return u"le_cpp::Span<%s>& %s" % (cType, parameter.name)
+        return u"le_cpp::ArrayView<%s> %s" % (cType, parameter.name)
+    elif isOut:
+        return u"%s& %s" % (cType, parameter.name)
+    else:
+        return u"%s %s" % (cType, parameter.name)
+
+def FormatServerParameter(parameter):
+    """Declare a parameter of a C++ server function"""
+    isOut = (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT
+    if isinstance(parameter, interfaceIR.StringParameter) and isOut:
+        return u"le_cpp::StrBuf " + parameter.name
+    return FormatCppParameter(parameter)
+
+def FormatCArguments(parameter, forceInput=False):
+    """
+    Pass a parameter of a C++ wrapper function on to the C function.  Output arrays go through a
+    local size variable (<name>Size), declared by the template before the call.  With forceInput,
+    an output parameter is passed as a value, as to a server's respond function.
+    """
+    isOut = (not forceInput
+             and (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT)
+    if isinstance(parameter, interfaceIR.StringParameter):
+        if isOut:
+            return u"&%s[0], %s.size()" % (parameter.name, parameter.name)
+        return u"%s.c_str()" % (parameter.name,)
+    elif isinstance(parameter, interfaceIR.ArrayParameter):
+        if isOut:
+            return u"%s.data(), &%sSize" % (parameter.name, parameter.name)
+        return u"%s.data(), %s.size()" % (parameter.name, parameter.name)
+    elif isOut:
+        return u"&" + parameter.name
+    else:
+        return parameter.name
+
+def FormatServerArguments(parameter):
+    """
+    Pass a parameter of a C server function on to the C++ server function.  Output arrays go
+    through a local le_cpp::Span named after the parameter, declared by the template before the
+    call.
+    """
+    isOut = (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT
+    if isinstance(parameter, interfaceIR.StringParameter):
+        if isOut:
+            return u"le_cpp::StrBuf(%s, %sSize)" % (parameter.name, parameter.name)
+        return parameter.name
+    elif isinstance(parameter, interfaceIR.ArrayParameter):
+        if isOut:
+            return parameter.name
+        return u"le_cpp::ArrayView<%s>(%sPtr, %sSize)" % (cHelpers.FormatType(parameter.apiType),
+                                                          parameter.name,
+                                                          parameter.name)
+    elif isOut:
+        return u"*%sPtr" % (parameter.name,)
+    else:
+        return parameter.name
+
+def FormatViewType(parameter):
+    """Type of a value passed to a C++ handler or response function"""
+    cType = cHelpers.FormatType(parameter.apiType)
+    if isinstance(parameter, interfaceIR.StringParameter):
+        return u"le_cpp::StrView"
+    elif isinstance(parameter, interfaceIR.ArrayParameter):
+        return u"le_cpp::ArrayView<%s>" % (cType,)
+    else:
+        return cType
+
+def FormatViewArgument(parameter):
+    """
+    Convert a parameter of a C handler or response function into the value passed to the C++
+    handler or response function.  The views alias the received message.
+    """
+    if isinstance(parameter, interfaceIR.StringParameter):
+        return u"le_cpp::StrView(%s)" % (parameter.name,)
+    elif isinstance(parameter, interfaceIR.ArrayParameter):
+        return u"le_cpp::ArrayView<%s>(%sPtr, %sSize)" % (cHelpers.FormatType(parameter.apiType),
+                                                          parameter.name,
+                                                          parameter.name)
+    else:
+        return parameter.name
+
+def GetHandlerParameter(function):
+    """Get the handler parameter of an add handler function"""
+    for parameter in function.parameters:
+        if isinstance(parameter.apiType, interfaceIR.HandlerType):
+            return parameter
+    return None
+
+#---------------------------------------------------------------------------------------------------
+# Test functions
+#---------------------------------------------------------------------------------------------------
+
+def IsCppSupported(function):
+    """
+    Can this function be wrapped as a plain C++ function?  Add/remove handler functions are
+    wrapped as handler classes instead, and functions taking a callback are left to the C API.
+    Server classes declare those with their C parameters, as the C server interface does.
+    """
+    if isinstance(function, interfaceIR.EventFunction):
+        return False
+    for parameter in function.parameters:
+        if isinstance(parameter.apiType, interfaceIR.HandlerType):
+            return False
+    return True
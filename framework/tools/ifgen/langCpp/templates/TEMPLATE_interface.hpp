@@ -0,0 +1,274 @@
+{#-
+ #  Jinja2 template for generating C++ client wrappers for Legato APIs.
+ #
+ #  The wrappers are inline functions over the C client interface, so the C client code still does
+ #  all the messaging; strings and arrays are passed through as views of the caller's buffers, and
+ #  packed by the C client code straight into the message.
+ #
+ #  Copyright (C) Sierra Wireless Inc.
+ #}
+/*
+ * ====================== WARNING ======================
+ *
+ * THIS FILE IS AUTO-GENERATED BY IFGEN. DO NOT EDIT.
+ *
+ * =====================================================
+ */
+
+#ifndef {{apiName|upper}}_INTERFACE_HPP_INCLUDE_GUARD
+#define {{apiName|upper}}_INTERFACE_HPP_INCLUDE_GUARD
+
+extern "C"
+{
+#include "{{apiName}}_interface.h"
+}
+
+{% include 'cppSupport.templ' %}
+
+{% for comment in fileComments -%}
+{{comment|FormatHeaderComment}}
+{% endfor %}
+namespace {{apiName}}
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect the current client thread to the service providing this API.  See
+ * {{apiName}}_ConnectService().
+ */
+//--------------------------------------------------------------------------------------------------
+inline void ConnectService()
+{
+    {{apiName}}_ConnectService();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Try to connect the current client thread to the service providing this API.  See
+ * {{apiName}}_TryConnectService().
+ */
+//--------------------------------------------------------------------------------------------------
+inline le_result_t TryConnectService()
+{
+    return {{apiName}}_TryConnectService();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disconnect the current client thread from the service providing this API.  See
+ * {{apiName}}_DisconnectService().
+ */
+//--------------------------------------------------------------------------------------------------
+inline void DisconnectService()
+{
+    {{apiName}}_DisconnectService();
+}
+{%- for function in functions if function is AddHandlerFunction %}
+{%- set handlerParameter = function|GetHandlerParameter %}
+{%- set handler = handlerParameter.apiType %}
+{%- set className = function.event.name + "Handler" %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registration of a handler for the {{function.event.name}} event.  The handler is added by the
+ * constructor and removed when the object is destroyed (or Remove() is called).  Strings and
+ * arrays are passed to the handler as views of the received message, which are only valid while
+ * the handler runs.
+ *
+ * See {{apiName}}_{{function.name}}().
+ */
+//--------------------------------------------------------------------------------------------------
+class {{className}}
+{
+public:
+    typedef std::function<void(
+        {%- for parameter in handler.parameters %}
+        {{- parameter|FormatViewType }}{% if not loop.last %}, {% endif %}
+        {%- endfor %})> Func_t;
+
+    {{className}}() : ref(NULL) {}
+
+    {{className}}
+    (
+        {%- for parameter in function.parameters if parameter.apiType is not HandlerType %}
+        {{parameter|FormatCppParameter}},
+        {%- endfor %}
+        Func_t func
+    )
+    :   funcPtr(new Func_t(std::move(func)))
+    {
+        ref = {{apiName}}_{{function.name}}(
+            {%- for parameter in function.parameters if parameter.apiType is not HandlerType %}
+            {{- parameter|FormatCArguments }}, {% endfor -%}
+            Dispatch, funcPtr.get());
+    }
+
+    {{className}}({{className}}&& other) : ref(other.ref), funcPtr(std::move(other.funcPtr))
+    {
+        other.ref = NULL;
+    }
+
+    {{className}}& operator=({{className}}&& other)
+    {
+        if (this != &other)
+        {
+            Remove();
+            ref = other.ref;
+            funcPtr = std::move(other.funcPtr);
+            other.ref = NULL;
+        }
+        return *this;
+    }
+
+    {{className}}(const {{className}}&) = delete;
+    {{className}}& operator=(const {{className}}&) = delete;
+
+    ~{{className}}()
+    {
+        Remove();
+    }
+
+    /// Remove the handler, if it is still registered.
+    void Remove()
+    {
+        if (ref != NULL)
+        {
+            {{apiName}}_Remove{{className}}(ref);
+            ref = NULL;
+        }
+        funcPtr.reset();
+    }
+
+    /// Is the handler registered?
+    bool IsAdded() const
+    {
+        return (ref != NULL);
+    }
+
+private:
+    static void Dispatch
+    (
+        {%- for parameter in handler|CAPIParameters %}
+        {{parameter|FormatParameter}}{% if not loop.last %},{% endif %}
+        {%- endfor %}
+    )
+    {
+        (*static_cast<Func_t*>(contextPtr))(
+            {%- for parameter in handler.parameters %}
+            {{- parameter|FormatViewArgument }}{% if not loop.last %}, {% endif %}
+            {%- endfor %});
+    }
+
+    {{function.returnType|FormatType}} ref;
+    std::unique_ptr<Func_t> funcPtr;
+};
+{%- endfor %}
+{%- for function in functions if function is CppSupported %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * See {{apiName}}_{{function.name}}().
+ {%- for parameter in function.parameters if parameter is OutParameter %}
+ {%- if parameter is StringParameter %}
+ *
+ * @c {{parameter.name}} is resized to hold the returned string.
+ {%- elif parameter is ArrayParameter %}
+ *
+ * @c {{parameter.name}} is filled in place, and shrunk to the number of elements returned.
+ {%- endif %}
+ {%- endfor %}
+ */
+//--------------------------------------------------------------------------------------------------
+inline {{function.returnType|FormatType}} {{function.name}}
+(
+    {%- for parameter in function.parameters %}
+    {{parameter|FormatCppParameter}}{% if not loop.last %},{% endif %}
+    {%- else %}
+    void
+    {%- endfor %}
+)
+{
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    {{parameter.name}}.resize({{parameter.maxCount + 1}});
+    {%- elif parameter is ArrayParameter %}
+    size_t {{parameter.name}}Size = {{parameter.name}}.size();
+    {%- endif %}
+    {%- endfor %}
+    {% if function.returnType %}{{function.returnType|FormatType}} _result = {% endif -%}
+    {{apiName}}_{{function.name}}(
+        {%- for parameter in function.parameters %}
+        {{- parameter|FormatCArguments }}{% if not loop.last %}, {% endif %}
+        {%- endfor %});
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    {{parameter.name}}.resize(strlen({{parameter.name}}.c_str()));
+    {%- elif parameter is ArrayParameter %}
+    {{parameter.name}}.shrink({{parameter.name}}Size);
+    {%- endif %}
+    {%- endfor %}
+    {%- if function.returnType %}
+    return _result;
+    {%- endif %}
+}
+{%- if args.asyncClient %}
+{%- set outParameters = function.parameters|select("OutParameter")|list %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous version of {{function.name}}().  See {{apiName}}_{{function.name}}Async().
+ *
+ * respFunc is called by the calling thread's event loop when the response arrives.  Strings and
+ * arrays are passed to it as views of the response message, which are only valid while it runs.
+ */
+//--------------------------------------------------------------------------------------------------
+inline void {{function.name}}Async
+(
+    {%- for parameter in function.parameters if parameter is not OutParameter %}
+    {{parameter|FormatCppParameter}},
+    {%- endfor %}
+    std::function<void(
+        {%- if function.returnType %}
+        {{- function.returnType|FormatType }}{% if outParameters %}, {% endif %}
+        {%- endif %}
+        {%- for parameter in outParameters %}
+        {{- parameter|FormatViewType }}{% if not loop.last %}, {% endif %}
+        {%- endfor %})> respFunc
+)
+{
+    typedef decltype(respFunc) RespFunc_t;
+
+    struct Response
+    {
+        static void Dispatch
+        (
+            {%- if function.returnType %}
+            {{function.returnType|FormatType}} _result,
+            {%- endif %}
+            {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+            {{parameter|FormatParameter(forceInput=True)}},
+            {%- endfor %}
+            void* contextPtr
+        )
+        {
+            std::unique_ptr<RespFunc_t> funcPtr(static_cast<RespFunc_t*>(contextPtr));
+            (*funcPtr)(
+                {%- if function.returnType %}_result{% if outParameters %}, {% endif %}
+                {%- endif %}
+                {%- for parameter in outParameters %}
+                {{- parameter|FormatViewArgument }}{% if not loop.last %}, {% endif %}
+                {%- endfor %});
+        }
+    };
+
+    {{apiName}}_{{function.name}}Async(
+        {%- for parameter in function.parameters if parameter is not OutParameter %}
+        {{- parameter|FormatCArguments }}, {% endfor -%}
+        Response::Dispatch, new RespFunc_t(std::move(respFunc)));
+}
+{%- endif %}
+{%- endfor %}
+
+} // namespace {{apiName}}
+
+#endif // {{apiName|upper}}_INTERFACE_HPP_INCLUDE_GUARD
@@ -0,0 +1,266 @@
+{#-
+ #  Jinja2 template for generating C++ server classes for Legato APIs.
+ #
+ #  The server class is called by the C server interface, so the C server code still does all the
+ #  messaging; the C server functions pass each request on to the object given to SetServer(),
+ #  with strings and arrays as views of the received message and of the response buffers.
+ #
+ #  Copyright (C) Sierra Wireless Inc.
+ #}
+/*
+ * ====================== WARNING ======================
+ *
+ * THIS FILE IS AUTO-GENERATED BY IFGEN. DO NOT EDIT.
+ *
+ * =====================================================
+ */
+
+#ifndef {{apiName|upper}}_SERVER_HPP_INCLUDE_GUARD
+#define {{apiName|upper}}_SERVER_HPP_INCLUDE_GUARD
+
+extern "C"
+{
+#include "{{apiName}}_server.h"
+}
+
+{% include 'cppSupport.templ' %}
+
+{% for comment in fileComments -%}
+{{comment|FormatHeaderComment}}
+{% endfor %}
+namespace {{apiName}}
+{
+{%- if functions %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference.  See {{apiName}}_GetServiceRef().
+ */
+//--------------------------------------------------------------------------------------------------
+inline le_msg_ServiceRef_t GetServiceRef()
+{
+    return {{apiName}}_GetServiceRef();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message.  See
+ * {{apiName}}_GetClientSessionRef().
+ */
+//--------------------------------------------------------------------------------------------------
+inline le_msg_SessionRef_t GetClientSessionRef()
+{
+    return {{apiName}}_GetClientSessionRef();
+}
+{%- endif %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server of the {{apiName}} API.  Derive a class implementing its functions, and pass an object of
+ * that class to SetServer() before the first request is handled (e.g. in COMPONENT_INIT).
+ *
+ * Strings and arrays are passed to the functions as views of the received message, which are only
+ * valid while the function runs.  Functions taking a handler are declared with the same parameters
+ * as the C server functions.
+ *
+{%- if args.async %}
+ * Each function gets the command reference of the request, which must be passed to the matching
+ * Respond function, and the maximum sizes of its output strings and arrays.
+{%- else %}
+ * Output strings and arrays are written straight into the buffers that the response is packed
+ * from.
+{%- endif %}
+ *
+ * The C server functions that call the server object are defined in the source file that defines
+ * {{apiName|upper}}_CPP_SERVER_IMPLEMENTATION before including this header.  Exactly one source
+ * file of the component must do so.
+ */
+//--------------------------------------------------------------------------------------------------
+class Server
+{
+public:
+    virtual ~Server() {}
+{%- for function in functions %}
+
+    /// See {{apiName}}_{{function.name}}().
+    {%- if function is not CppSupported %}
+    virtual {{function.returnType|FormatType}} {{function.name}}
+    (
+        {%- for parameter in function|CAPIParameters %}
+        {{parameter|FormatParameter}}{% if not loop.last %},{% endif %}
+        {%- else %}
+        void
+        {%- endfor %}
+    ) = 0;
+    {%- elif args.async %}
+    virtual void {{function.name}}
+    (
+        {{apiName}}_ServerCmdRef_t cmdRef
+        {%- for parameter in function.parameters %}
+        {%- if parameter is InParameter %},
+        {{parameter|FormatServerParameter}}
+        {%- elif parameter is StringParameter or parameter is ArrayParameter %},
+        size_t {{parameter.name}}Size
+        {%- endif %}
+        {%- endfor %}
+    ) = 0;
+    {%- else %}
+    virtual {{function.returnType|FormatType}} {{function.name}}
+    (
+        {%- for parameter in function.parameters %}
+        {{parameter|FormatServerParameter}}{% if not loop.last %},{% endif %}
+        {%- else %}
+        void
+        {%- endfor %}
+    ) = 0;
+    {%- endif %}
+{%- endfor %}
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the object serving the requests of this API.  It must outlive the service.
+ */
+//--------------------------------------------------------------------------------------------------
+void SetServer
+(
+    Server& server
+);
+{%- if args.async %}
+{%- for function in functions if function is CppSupported %}
+{%- set outParameters = function.parameters|select("OutParameter")|list %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the response to the {{function.name}}() request of cmdRef.  See
+ * {{apiName}}_{{function.name}}Respond().
+ */
+//--------------------------------------------------------------------------------------------------
+inline void {{function.name}}Respond
+(
+    {{apiName}}_ServerCmdRef_t cmdRef
+    {%- if function.returnType %},
+    {{function.returnType|FormatType}} _result
+    {%- endif %}
+    {%- for parameter in outParameters %},
+    {{parameter|FormatViewType}} {{parameter.name}}
+    {%- endfor %}
+)
+{
+    {{apiName}}_{{function.name}}Respond(cmdRef
+        {%- if function.returnType %}, _result{% endif %}
+        {%- for parameter in outParameters %}, {{ parameter|FormatCArguments(forceInput=True) }}
+        {%- endfor %});
+}
+{%- endfor %}
+{%- endif %}
+
+} // namespace {{apiName}}
+
+#ifdef {{apiName|upper}}_CPP_SERVER_IMPLEMENTATION
+
+namespace {{apiName}}
+{
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Object serving the requests, set by SetServer().
+ */
+//--------------------------------------------------------------------------------------------------
+static Server* ServerPtr = NULL;
+
+void SetServer
+(
+    Server& server
+)
+{
+    ServerPtr = &server;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the object serving the requests.  It is a fatal error if none has been set.
+ */
+//--------------------------------------------------------------------------------------------------
+static Server& GetServer()
+{
+    LE_FATAL_IF(ServerPtr == NULL, "No server object set for '%s'", "{{apiName}}");
+    return *ServerPtr;
+}
+
+} // namespace {{apiName}}
+
+extern "C"
+{
+{%- for function in functions %}
+
+{% if function is CppSupported and args.async -%}
+void {{apiName}}_{{function.name}}
+(
+    {{apiName}}_ServerCmdRef_t _cmdRef
+    {%- for parameter in function|CAPIParameters if parameter is InParameter %},
+    {{parameter|FormatParameter(forceInput=True)}}
+    {%- endfor %}
+)
+{
+    {{apiName}}::GetServer().{{function.name}}(_cmdRef
+        {%- for parameter in function.parameters %}
+        {%- if parameter is InParameter %}, {{ parameter|FormatServerArguments }}
+        {%- elif parameter is StringParameter or parameter is ArrayParameter -%}
+        , {{ parameter.name }}Size
+        {%- endif %}
+        {%- endfor %});
+}
+{%- elif function is CppSupported -%}
+{{function.returnType|FormatType}} {{apiName}}_{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last %},{% endif %}
+    {%- else %}
+    void
+    {%- endfor %}
+)
+{
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is ArrayParameter %}
+    le_cpp::Span<{{parameter.apiType|FormatType}}> {{parameter.name}}({{parameter.name}}Ptr,
+                                        {{- ' ' }}*{{parameter.name}}SizePtr);
+    {%- endif %}
+    {%- endfor %}
+    {% if function.returnType %}{{function.returnType|FormatType}} _result = {% endif -%}
+    {{apiName}}::GetServer().{{function.name}}(
+        {%- for parameter in function.parameters %}
+        {{- parameter|FormatServerArguments }}{% if not loop.last %}, {% endif %}
+        {%- endfor %});
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is ArrayParameter %}
+    *{{parameter.name}}SizePtr = {{parameter.name}}.size();
+    {%- endif %}
+    {%- endfor %}
+    {%- if function.returnType %}
+    return _result;
+    {%- endif %}
+}
+{%- else -%}
+{{function.returnType|FormatType}} {{apiName}}_{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last %},{% endif %}
+    {%- else %}
+    void
+    {%- endfor %}
+)
+{
+    return {{apiName}}::GetServer().{{function.name}}(
+        {%- for parameter in function|CAPIParameters %}
+        {{- parameter|FormatParameterName }}{% if not loop.last %}, {% endif %}
+        {%- endfor %});
+}
+{%- endif %}
+{%- endfor %}
+
+} // extern "C"
+
+#endif // {{apiName|upper}}_CPP_SERVER_IMPLEMENTATION
+
+#endif // {{apiName|upper}}_SERVER_HPP_INCLUDE_GUARD
@@ -70,6 +70,8 @@ def FormatType(context, apiType, qualifiedTypes=None):
 
     if apiType == None:
         return "void"
+    elif apiType == interfaceIR.BUFFER_TYPE:
+        raise Exception("Buffer parameters are not supported in Java")
     elif isinstance(apiType, interfaceIR.BasicType):
         return _BasicTypeMapping[apiType]
     elif isinstance(apiType, interfaceIR.HandlerReferenceType):
@@ -924,6 +924,8 @@ void GenerateExportedAdef
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("adefGenerator", appPtr->name);
+
     std::string dirPath = path::Combine(buildParams.workingDir, appPtr->name);
     std::string filePath = path::Combine(dirPath, appPtr->name + ".adef");
 
@@ -26,6 +26,8 @@ BuildParams_t::BuildParams_t
     target("localhost"),
     codeGenOnly(false),
     isStandAloneComp(false),
+    appImage(false),
+    unityBuild(false),
     argc(0),
     argv(NULL)
 //--------------------------------------------------------------------------------------------------
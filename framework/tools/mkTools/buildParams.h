@@ -35,6 +35,18 @@ struct BuildParams_t
     bool                    codeGenOnly;        ///< true = only generate code, don't compile, etc.
     bool                    isStandAloneComp;   ///< true = generate stand-alone component
     bool                    binPack;            ///< true = generate a binary package for redist.
+    bool                    appImage;           ///< true = pack the app as a squashfs image.
+    bool                    unityBuild;         ///< true = compile each component's C sources
+                                                ///<        in batches, with a precompiled header.
+    std::string             buildProfile;       ///< Name of the optimization profile ("" = none).
+    std::string             pgoDir;             ///< Dir for profile-guided optimization data.
+    std::string             objCacheDir;        ///< Dir of the shared object file cache
+                                                ///<  ("" = LEGATO_OBJ_CACHE, if set).
+    std::string             profileCFlags;      ///< Compiler flags for the build profile.
+    std::string             profileLdFlags;     ///< Linker flags for the build profile.
+    std::string             logLevelFloor;      ///< Lowest log level compiled in ("" = all),
+                                                ///<  as a level name, then as an le_log_Level_t
+                                                ///<  constant once checked.
 
     int                     argc;               ///< Number of arguments (argc to main)
     const char**            argv;               ///< Argument list (argv to main)
@@ -66,15 +66,10 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         // Delete the old info.properties file, if there is one.
         "  command = rm -f $out && $\n"
         // Compute the MD5 checksum of the staging area.
-        // Don't follow symlinks (-P), and include the directory structure and the contents of
-        // symlinks as part of the MD5 hash.
-        "            md5=$$( ( cd $workingDir/staging && $\n"
-        "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-        "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-        "                      find -P -type l -print0 |LC_ALL=C sort -z"
-                             " |xargs -0 -r -n 1 readlink $\n"
-        "                    ) | md5sum) && $\n"
-        "            md5=$${md5%% *} && $\n"
+        // Symlinks aren't followed, and the directory structure and the contents of symlinks are
+        // included in the MD5 hash.  The hashes of the files are kept in a manifest outside the
+        // staging area, so only files that have changed since the last time get read again.
+        "            md5=$$(mkmd5 --manifest=$workingDir/staging.md5 $workingDir/staging) && $\n"
         // Generate the app's info.properties file.
         "            ( echo \"app.name=$name\" && $\n"
         "              echo \"app.md5=$$md5\" && $\n"
@@ -92,6 +87,8 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
                         " -cjf - --mtime=$adefPath) > $workingDir/$name.$target && $\n"
         // Get the size of the tarball.
         "            tarballSize=`stat -c '%s' $workingDir/$name.$target` && $\n"
+        // Get the MD5 hash of the tarball, so the target can check it as it unpacks it.
+        "            tarballMd5=`md5sum $workingDir/$name.$target | cut -d ' ' -f 1` && $\n"
         // Get the app's MD5 hash from its info.properties file.
         "            md5=`grep '^app.md5=' $in | sed 's/^app.md5=//'` && $\n"
         // Generate a JSON header and concatenate the tarball to it to create the update pack.
@@ -100,12 +97,36 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         "              printf '\"name\":\"$name\",\\n' && $\n"
         "              printf '\"version\":\"$version\",\\n' && $\n"
         "              printf '\"md5\":\"%s\",\\n' \"$$md5\" && $\n"
+        "              printf '\"payloadMd5\":\"%s\",\\n' \"$$tarballMd5\" && $\n"
         "              printf '\"size\":%s\\n' \"$$tarballSize\" && $\n"
         "              printf '}' && $\n"
         "              cat $workingDir/$name.$target $\n"
         "            ) > $out\n"
         "\n"
 
+        // Create an update pack file for an app, with the staging area packed into a read-only
+        // file system image that the target mounts instead of unpacking.
+        "rule PackAppImage\n"
+        "  description = Packaging app image\n"
+        "  command = rm -f $workingDir/$name.$target.img && $\n"
+        "            mksquashfs $workingDir/staging $workingDir/$name.$target.img"
+                     " -noappend -all-root -no-xattrs -no-progress > /dev/null && $\n"
+        "            imageSize=`stat -c '%s' $workingDir/$name.$target.img` && $\n"
+        "            imageMd5=`md5sum $workingDir/$name.$target.img | cut -d ' ' -f 1` && $\n"
+        "            md5=`grep '^app.md5=' $in | sed 's/^app.md5=//'` && $\n"
+        "            ( printf '{\\n' && $\n"
+        "              printf '\"command\":\"updateApp\",\\n' && $\n"
+        "              printf '\"name\":\"$name\",\\n' && $\n"
+        "              printf '\"version\":\"$version\",\\n' && $\n"
+        "              printf '\"md5\":\"%s\",\\n' \"$$md5\" && $\n"
+        "              printf '\"format\":\"squashfs\",\\n' && $\n"
+        "              printf '\"payloadMd5\":\"%s\",\\n' \"$$imageMd5\" && $\n"
+        "              printf '\"size\":%s\\n' \"$$imageSize\" && $\n"
+        "              printf '}' && $\n"
+        "              cat $workingDir/$name.$target.img $\n"
+        "            ) > $out\n"
+        "\n"
+
         "rule BinPackApp\n"
         "  description = Packaging app for distribution.\n"
         "  command = cp -r $stagingDir/* $workingDir/ && $\n"
@@ -544,8 +565,9 @@ void AppBuildScriptGenerator_t::GenerateAppBundleBuildStatement
                << "/staging/read-only/bin/" << mapItem.second->name;
     }
 
-    // It also depends on the generated config file.
+    // It also depends on the generated config file and launch descriptor.
     script << " $builddir/" << appPtr->ConfigFilePath();
+    script << " $builddir/" << appPtr->LaunchDescriptorFilePath();
 
     // End of dependency list.
     script << "\n";
@@ -560,7 +582,8 @@ void AppBuildScriptGenerator_t::GenerateAppBundleBuildStatement
     // This depends on the info.properties file, which is the last thing to be added to the
     // app's staging area.
     auto outputFile = path::Combine(outputDir, appPtr->name) + ".$target.update";
-    script << "build " << outputFile << ": PackApp " << infoPropertiesPath << "\n";
+    script << "build " << outputFile << ": " << (buildParams.appImage ? "PackAppImage" : "PackApp")
+           << " " << infoPropertiesPath << "\n";
 
     // Tell the build rule what the app's name and version are and where its working directory
     // is.
@@ -735,6 +758,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("buildScriptGenerator", appPtr->name);
+
     std::string filePath = path::Minimize(buildParams.workingDir + "/build.ninja");
 
     AppBuildScriptGenerator_t appGenerator(filePath, buildParams);
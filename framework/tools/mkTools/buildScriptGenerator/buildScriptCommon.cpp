@@ -122,6 +122,8 @@ BuildScriptGenerator_t::~BuildScriptGenerator_t
 )
 {
     CloseFile(script);
+
+    profile::CountNinjaEdges(scriptPath);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -179,35 +181,78 @@ void BuildScriptGenerator_t::GenerateBuildRules
         }
     }
 
+    // Flags used for all C compiles.  (They must be the same for the precompiled headers used
+    // by unity builds as for the sources that use them.)
+    std::string cCompileFlags = " -Wall" // Enable all warnings.
+                                " -fPIC" // Compile to position-independent code for linking into
+                                         // a shared library.
+                                " -Werror" // Treat all warnings as errors.
+                                " -fvisibility=hidden" // Prevent exporting of symbols by default.
+                                " -DMK_TOOLS_BUILD"; // Indicate build is being done by mk tools.
+    if (target != "localhost")
+    {
+        cCompileFlags += "  -DLEGATO_EMBEDDED"; // Indicate target is an embedded device.
+    }
+    if (!buildParams.debugDir.empty())
+    {
+        cCompileFlags += " -g";
+    }
+    cCompileFlags += buildParams.profileCFlags; // Optimizations for the build profile, if any.
+    cCompileFlags += " $cFlags"; // Include user-provided CFLAGS last so other settings can be
+                                 // overridden.
+
+    // With an object file cache, single source files are compiled through the objcache script,
+    // which only runs the compiler if an identical compile isn't in the cache.  It's given the
+    // input, output and dependency file itself.
+    std::string objCacheDir = buildParams.objCacheDir;
+    if (objCacheDir.empty())
+    {
+        objCacheDir = envVars::Get("LEGATO_OBJ_CACHE");
+    }
+
+    std::string compilePrefix;
+    std::string compileArgs = " -MMD -MF $out.d -c $in -o $out";
+    if (!objCacheDir.empty())
+    {
+        compilePrefix = "objcache " + path::MakeAbsolute(objCacheDir) + " $in $out $out.d ";
+        compileArgs.clear();
+    }
+
     // Generate rule for compiling a C source code file.
     script << "rule CompileC\n"
               "  description = Compiling C source\n"
               "  depfile = $out.d\n" // Tell ninja where gcc will put the dependencies.
-              "  command = " << cCompilerPath << " " << sysrootOption <<
-              " -MMD -MF $out.d -c $in -o $out"
+              "  command = " << compilePrefix << cCompilerPath << " " << sysrootOption <<
+              compileArgs <<
               " -DLE_FILENAME=`basename $in`" // Define the file name for the log macros.
-              " -Wall" // Enable all warnings.
-              " -fPIC" // Compile to position-independent code for linking into a shared library.
-              " -Werror" // Treat all warnings as errors.
-              " -fvisibility=hidden" // Prevent exporting of symbols by default.
-              " -DMK_TOOLS_BUILD"; // Indicate build is being done by the mk tools.
-    if (target != "localhost")
-    {
-        script << "  -DLEGATO_EMBEDDED";    // Indicate target is an embedded device (not a PC).
-    }
-    if (!buildParams.debugDir.empty())
+           << cCompileFlags << "\n\n";
+
+    if (buildParams.unityBuild)
     {
-        script << " -g";
+        // Generate rule for precompiling a component's common headers.
+        script << "rule CompileCHeader\n"
+                  "  description = Precompiling C header\n"
+                  "  depfile = $out.d\n"
+                  "  command = " << cCompilerPath << " " << sysrootOption <<
+                  " -MMD -MF $out.d -x c-header -c $in -o $out"
+               << cCompileFlags << "\n\n";
+
+        // Generate rule for compiling a batch of C source files as one translation unit.  The
+        // generated source defines LE_FILENAME itself, before including each file.
+        script << "rule CompileCUnity\n"
+                  "  description = Compiling C sources as a unity build\n"
+                  "  depfile = $out.d\n"
+                  "  command = " << cCompilerPath << " " << sysrootOption <<
+                  " -MMD -MF $out.d -c $in -o $out"
+               << cCompileFlags << "\n\n";
     }
-    script << " $cFlags" // Include user-provided CFLAGS last so other settings can be overridden.
-              "\n\n";
 
     // Generate rule for compiling a C++ source code file.
     script << "rule CompileCxx\n"
               "  description = Compiling C++ source\n"
               "  depfile = $out.d\n" // Tell ninja where gcc will put the dependencies.
-              "  command = " << cxxCompilerPath << " " << sysrootOption <<
-              " -MMD -MF $out.d -c $in -o $out"
+              "  command = " << compilePrefix << cxxCompilerPath << " " << sysrootOption <<
+              compileArgs <<
               " -DLE_FILENAME=`basename $in`" // Define the file name for the log macros.
               " -Wall" // Enable all warnings.
               " -fPIC" // Compile to position-independent code for linking into a shared library.
@@ -222,6 +267,7 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -g";
     }
+    script << buildParams.profileCFlags; // Optimizations for the build profile, if any.
     script << " $cxxFlags" // Include user-provided CXXFLAGS last so
                            // other settings can be overridden
               "\n\n";
@@ -234,7 +280,7 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -Wl,--build-id -g";
     }
-    script << " -shared -o $out $in $ldFlags";
+    script << " -shared -o $out $in" << buildParams.profileLdFlags << " $ldFlags";
     if (!buildParams.debugDir.empty())
     {
         script << " $\n"
@@ -250,7 +296,7 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -Wl,--build-id -g";
     }
-    script << " -shared -o $out $in $ldFlags";
+    script << " -shared -o $out $in" << buildParams.profileLdFlags << " $ldFlags";
     if (!buildParams.debugDir.empty())
     {
         script << " $\n"
@@ -266,7 +312,7 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -Wl,--build-id -g";
     }
-    script << " -o $out $in $ldFlags";
+    script << " -o $out $in" << buildParams.profileLdFlags << " $ldFlags";
     if (!buildParams.debugDir.empty())
     {
         script << " -g $\n"
@@ -282,7 +328,7 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -Wl,--build-id -g";
     }
-    script << " -o $out $in $ldFlags";
+    script << " -o $out $in" << buildParams.profileLdFlags << " $ldFlags";
     if (!buildParams.debugDir.empty())
     {
         script << " -g $\n"
@@ -323,10 +369,12 @@ void BuildScriptGenerator_t::GenerateBuildRules
     }
     script << "            sh -c \'$externalCommand\'\n";
 
-    // Generate a rule for running ifgen.
+    // Generate a rule for running ifgen.  This goes through ifgen-client, which hands the job to
+    // a long-running ifgen server instead of starting a new Python interpreter for every
+    // interface.
     script << "rule GenInterfaceCode\n"
               "  description = Generating IPC interface code\n"
-              "  command = ifgen --output-dir $outputDir $ifgenFlags $in\n"
+              "  command = ifgen-client --output-dir $outputDir $ifgenFlags $in\n"
               "\n";
 
     // Generate a rule for copying a file.
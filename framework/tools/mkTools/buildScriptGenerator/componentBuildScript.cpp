@@ -107,6 +107,24 @@ void ComponentBuildScriptGenerator_t::GenerateCommonCAndCxxFlags
     script << " -DLE_LOG_SESSION=" << componentPtr->name << "_LogSession ";
     script << " -DLE_LOG_LEVEL_FILTER_PTR=" << componentPtr->name << "_LogLevelFilterPtr ";
 
+    // Define the compile-time log level floor, unless the component defines its own.
+    if (!buildParams.logLevelFloor.empty())
+    {
+        auto definesFloor = [](const std::list<std::string>& flags)
+            {
+                return std::any_of(flags.begin(), flags.end(),
+                                   [](const std::string& flag)
+                                   {
+                                       return flag.find("-DLE_LOG_LEVEL_STATIC_FILTER") == 0;
+                                   });
+            };
+
+        if (!definesFloor(componentPtr->cFlags) && !definesFloor(componentPtr->cxxFlags))
+        {
+            script << " -DLE_LOG_LEVEL_STATIC_FILTER=" << buildParams.logLevelFloor;
+        }
+    }
+
     // Define the COMPONENT_INIT.
     script << " \"-DCOMPONENT_INIT=LE_CI_LINKAGE LE_SHARED void "
            << componentPtr->getTargetInfo<target::LinuxComponentInfo_t>()->initFuncName << "()\"";
@@ -323,7 +341,9 @@ void ComponentBuildScriptGenerator_t::GenerateLdFlagsDef
 //--------------------------------------------------------------------------------------------------
 /**
  * Populate a string with a space-separated list of absolute paths to all .h files that need
- * to be generated by ifgen before the component's C/C++ source files can be built.
+ * to be generated by ifgen before the component's C/C++ source files can be built.  For a
+ * component with C++ code, this includes the .hpp files with the C++ wrappers of its client-side
+ * interfaces and the C++ server classes of its server-side interfaces.
  **/
 //--------------------------------------------------------------------------------------------------
 void ComponentBuildScriptGenerator_t::GetCInterfaceHeaders
@@ -349,6 +369,11 @@ void ComponentBuildScriptGenerator_t::GetCInterfaceHeaders
 
         result.push_back("$builddir/" + cFiles.interfaceFile);
         result.push_back("$builddir/" + cFiles.internalHFile);
+
+        if (componentPtr->HasCppCode())
+        {
+            result.push_back("$builddir/" + cFiles.cppInterfaceFile);
+        }
     }
 
     for (auto ifPtr : componentPtr->clientApis)
@@ -358,6 +383,11 @@ void ComponentBuildScriptGenerator_t::GetCInterfaceHeaders
 
         result.push_back("$builddir/" + cFiles.interfaceFile);
         result.push_back("$builddir/" + cFiles.internalHFile);
+
+        if (componentPtr->HasCppCode())
+        {
+            result.push_back("$builddir/" + cFiles.cppInterfaceFile);
+        }
     }
 
     for (auto apiFilePtr : componentPtr->clientUsetypesApis)
@@ -457,10 +487,18 @@ void ComponentBuildScriptGenerator_t::GenerateComponentLinkStatement
     script << "build " << componentPtr->getTargetInfo<target::LinuxComponentInfo_t>()->lib
            << ": " << rule;
 
-    // Includes object files compiled from the component's C/C++ source files.
-    for (auto objFilePtr : componentPtr->cObjectFiles)
+    // Includes object files compiled from the component's C/C++ source files (or from the
+    // batches of C source files, for a unity build).
+    if (componentPtr->cUnityFiles.empty())
     {
-        script << " $builddir/" << objFilePtr->path;
+        for (auto objFilePtr : componentPtr->cObjectFiles)
+        {
+            script << " $builddir/" << objFilePtr->path;
+        }
+    }
+    for (auto unityFilePtr : componentPtr->cUnityFiles)
+    {
+        script << " $builddir/" << unityFilePtr->path;
     }
     for (auto objFilePtr : componentPtr->cxxObjectFiles)
     {
@@ -596,6 +634,72 @@ void ComponentBuildScriptGenerator_t::GenerateCxxSourceBuildStatement
     script << "\n\n";
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print to a given build script the statements for building a component's C sources as a unity
+ * build: one to precompile the component's _componentPch.h, and one for each generated source file
+ * that includes a batch of the component's C source files.
+ *
+ * The precompiled header is built with the same cFlags as the batches, or gcc won't use it.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ComponentBuildScriptGenerator_t::GenerateCUnityBuildStatements
+(
+    model::Component_t* componentPtr,
+    const std::list<std::string>& apiHeaders ///< IPC API .h files needed by component.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto pchPath = "$builddir/" + componentPtr->workingDir + "/src/_componentPch.h";
+
+    // Finish off a build statement, given its implicit dependencies (beginning with " |").
+    auto finishStatement = [this, componentPtr, &apiHeaders](const std::string& implicitDeps)
+        {
+            script << implicitDeps;
+
+            if (HasExternalDependencies(componentPtr))
+            {
+                if (implicitDeps.empty())
+                {
+                    script << " |";
+                }
+                GetExternalDependencies(componentPtr);
+            }
+
+            // Add order-only dependencies for all the generated .h files that will be needed.
+            if (!apiHeaders.empty())
+            {
+                script << " || ";
+                std::copy(apiHeaders.begin(), apiHeaders.end(),
+                          std::ostream_iterator<std::string>(script, " "));
+            }
+
+            script << "\n";
+
+            // Define the cFlags variable.
+            script << "  cFlags = $cFlags";
+            GenerateCommonCAndCxxFlags(componentPtr);
+            for (auto& arg : componentPtr->cFlags)
+            {
+                script << " " << arg;
+            }
+            script << "\n\n";
+        };
+
+    script << "build " << pchPath << ".gch: CompileCHeader " << pchPath;
+    finishStatement("");
+
+    // The batches can't be compiled until the precompiled header is ready.  (ninja learns which
+    // of the component's sources each batch depends on from the compiler.)
+    for (auto unityFilePtr : componentPtr->cUnityFiles)
+    {
+        script << "build $builddir/" << unityFilePtr->path << ":"
+                  " CompileCUnity " << unityFilePtr->sourceFilePath;
+        finishStatement(" | " + pchPath + ".gch");
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate the build commands necessary to compile java code and create a Jar file to contain the
@@ -690,9 +794,16 @@ void ComponentBuildScriptGenerator_t::GenerateBuildStatements
     }
 
     // Add build statements for all the component's object files.
-    for (auto objFilePtr : componentPtr->cObjectFiles)
+    if (componentPtr->cUnityFiles.empty())
     {
-        GenerateCSourceBuildStatement(componentPtr, objFilePtr, interfaceHeaders);
+        for (auto objFilePtr : componentPtr->cObjectFiles)
+        {
+            GenerateCSourceBuildStatement(componentPtr, objFilePtr, interfaceHeaders);
+        }
+    }
+    else
+    {
+        GenerateCUnityBuildStatements(componentPtr, interfaceHeaders);
     }
     for (auto objFilePtr : componentPtr->cxxObjectFiles)
     {
@@ -1033,6 +1144,10 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
     }
     if (!generatedFiles.empty())
     {
+        if (ifPtr->async)
+        {
+            ifgenFlags += " --async-client";
+        }
         ifgenFlags += " --name-prefix " + ifPtr->internalName;
         script << "build" << generatedFiles <<
                   ": GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
@@ -1041,6 +1156,23 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
                   "  ifgenFlags =" << ifgenFlags << " $ifgenFlags\n"
                   "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n\n";
     }
+
+    // C++ wrappers of the C interface, for components with C++ code.
+    if (   (ifPtr->componentPtr != NULL)
+        && ifPtr->componentPtr->HasCppCode()
+        && (generatedIPC.find(cFiles.cppInterfaceFile) == generatedIPC.end())  )
+    {
+        generatedIPC.insert(cFiles.cppInterfaceFile);
+        script << "build $builddir/" << cFiles.cppInterfaceFile << ":"
+                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
+        GetIncludedApis(ifPtr->apiFilePtr);
+        script << "\n"
+                  "  ifgenFlags = --lang Cpp --gen-interface"
+               << (ifPtr->async ? " --async-client" : "")
+               << " --name-prefix " << ifPtr->internalName << " $ifgenFlags\n"
+                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.cppInterfaceFile) <<
+                  "\n\n";
+    }
 }
 
 
@@ -1210,6 +1342,23 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
                   "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n"
                   "\n";
     }
+
+    // C++ server class of the C server interface, for components with C++ code.
+    if (   (ifPtr->componentPtr != NULL)
+        && ifPtr->componentPtr->HasCppCode()
+        && (generatedIPC.find(cFiles.cppInterfaceFile) == generatedIPC.end())  )
+    {
+        generatedIPC.insert(cFiles.cppInterfaceFile);
+        script << "build $builddir/" << cFiles.cppInterfaceFile << ":"
+                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
+        GetIncludedApis(ifPtr->apiFilePtr);
+        script << "\n"
+                  "  ifgenFlags = --lang Cpp --gen-server-interface"
+               << (ifPtr->async ? " --async-server" : "")
+               << " --name-prefix " << ifPtr->internalName << " $ifgenFlags\n"
+                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.cppInterfaceFile) <<
+                  "\n\n";
+    }
 }
 
 
@@ -1482,6 +1631,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("buildScriptGenerator", componentPtr->name);
+
     std::string filePath = path::Combine(buildParams.workingDir, "build.ninja");
 
     ComponentBuildScriptGenerator_t componentGenerator(filePath, buildParams);
@@ -70,6 +70,8 @@ class ComponentBuildScriptGenerator_t : protected RequireBaseGenerator_t
         virtual void GenerateCxxSourceBuildStatement(model::Component_t* componentPtr,
                                                      const model::ObjectFile_t* objFilePtr,
                                                      const std::list<std::string>& apiHeaders);
+        virtual void GenerateCUnityBuildStatements(model::Component_t* componentPtr,
+                                                   const std::list<std::string>& apiHeaders);
         virtual void GenerateJavaBuildCommand(const std::string& outputJar,
                                               const std::string& classDestPath,
                                               const std::list<std::string>& sources,
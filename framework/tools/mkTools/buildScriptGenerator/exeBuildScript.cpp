@@ -472,6 +472,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("buildScriptGenerator", exePtr->name);
+
     std::string filePath = path::Minimize(buildParams.workingDir + "/build.ninja");
 
     ExeBuildScriptGenerator_t scriptGenerator(filePath, buildParams);
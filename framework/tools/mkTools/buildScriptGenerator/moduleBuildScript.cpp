@@ -204,6 +204,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("buildScriptGenerator", modulePtr->name);
+
     std::string filePath = path::Minimize(buildParams.workingDir + "/build.ninja");
 
     ModuleBuildScriptGenerator_t scriptGenerator(filePath, buildParams);
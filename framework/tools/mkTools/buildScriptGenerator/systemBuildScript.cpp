@@ -125,14 +125,10 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     "            rm -f $stagingDir/info.properties && $\n"
 
     // Compute the MD5 checksum of the staging area.
-    // Don't follow symlinks (-P), and include the directory structure and the contents of symlinks
-    // as part of the MD5 hash.
-    "            md5=$$( ( cd $stagingDir && $\n"
-    "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-    "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-    "                      find -P -type l -print0 |LC_ALL=C sort -z |xargs -0 -r -n 1 readlink $\n"
-    "                    ) | md5sum) && $\n"
-    "            md5=$${md5%% *} && $\n"
+    // Symlinks aren't followed, and the directory structure and the contents of symlinks are
+    // included in the MD5 hash.  The hashes of the files are kept in a manifest outside the
+    // staging area, so only files that have changed since the last time get read again.
+    "            md5=$$(mkmd5 --manifest=$stagingDir.md5 $stagingDir) && $\n"
 
     // Get the Legato framework version and append the MD5 sum to it to get the system version.
     "           frameworkVersion=$$( cat $$LEGATO_ROOT/version ) && $\n"
@@ -153,6 +149,10 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     // Get the size of the tarball.
     "            tarballSize=`stat -c '%s' $builddir/" << systemPtr->name << ".$target` && $\n"
 
+    // Get the MD5 hash of the tarball, so the target can check it as it unpacks it.
+    "            tarballMd5=`md5sum $builddir/" << systemPtr->name << ".$target | "
+                                                                    "cut -d ' ' -f 1` && $\n"
+
     // Get the app's MD5 hash from its info.properties file.
     "            md5=`grep '^system.md5=' $stagingDir/info.properties | "
                                                                     "sed 's/^system.md5=//'` && $\n"
@@ -161,6 +161,7 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     "            ( printf '{\\n' && $\n"
     "              printf '\"command\":\"updateSystem\",\\n' && $\n"
     "              printf '\"md5\":\"%s\",\\n' \"$$md5\" && $\n"
+    "              printf '\"payloadMd5\":\"%s\",\\n' \"$$tarballMd5\" && $\n"
     "              printf '\"size\":%s\\n' \"$$tarballSize\" && $\n"
     "              printf '}' && $\n"
     "              cat $builddir/" << systemPtr->name << ".$target && $\n"
@@ -201,8 +202,8 @@ void SystemBuildScriptGenerator_t::GenerateSystemPackBuildStatement
         }
     }
 
-    // This also must be run if the users.cfg has changed.
-    script << " | $builddir/staging/config/users.cfg";
+    // This also must be run if the users.cfg or the binding table has changed.
+    script << " | $builddir/staging/config/users.cfg $builddir/staging/config/bindings.bin";
 
     // It must also be run again if any preloaded apps have changed.
     for (auto& mapEntry : systemPtr->apps)
@@ -393,6 +394,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("buildScriptGenerator", systemPtr->name);
+
     std::string filePath = path::Minimize(buildParams.workingDir + "/build.ninja");
 
     SystemBuildScriptGenerator_t systemGenerator(filePath, buildParams);
@@ -27,6 +27,13 @@ void GenerateCLangComponentMainFile
 );
 
 
+void GenerateCLangUnityFiles
+(
+    const model::Component_t* componentPtr,
+    const mk::BuildParams_t& buildParams
+);
+
+
 void GenerateCLangExeMain
 (
     const model::Exe_t* exePtr,
@@ -63,6 +70,8 @@ void GenerateInterfacesHeader
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("codeGenerator", componentPtr->name + "/interfaces.h");
+
     if (componentPtr->HasCOrCppCode())
     {
         GenerateCLangInterfacesHeader(componentPtr, buildParams);
@@ -85,6 +94,8 @@ void GenerateComponentMainFile
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("codeGenerator", componentPtr->name + "/_componentMain");
+
     // This generator is for Linux & generates necessary code to create a Linux shared library.
     // Add the component-specific info now (if not already present)
     componentPtr->setTargetInfo(new target::LinuxComponentInfo_t(componentPtr, buildParams));
@@ -100,6 +111,28 @@ void GenerateComponentMainFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the precompiled header and batched source files for a given component, if it is to be
+ * built as a unity build.
+ **/
+//--------------------------------------------------------------------------------------------------
+void GenerateUnityFiles
+(
+    model::Component_t* componentPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!componentPtr->cUnityFiles.empty())
+    {
+        profile::Scope_t profileScope("codeGenerator", componentPtr->name + "/_unity");
+
+        GenerateCLangUnityFiles(componentPtr, buildParams);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate an _main.c file for a given executable.
@@ -112,6 +145,8 @@ void GenerateExeMain
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("codeGenerator", exePtr->name + "/_main");
+
     if (exePtr->hasCOrCppCode)
     {
         GenerateCLangExeMain(exePtr, buildParams);
@@ -40,6 +40,19 @@ void GenerateComponentMainFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the precompiled header and batched source files for a given component, if it is to be
+ * built as a unity build.
+ **/
+//--------------------------------------------------------------------------------------------------
+void GenerateUnityFiles
+(
+    model::Component_t* componentPtr,
+    const mk::BuildParams_t& buildParams
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate an _main.c file for a given executable.
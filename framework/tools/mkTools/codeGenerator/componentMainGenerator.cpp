@@ -15,7 +15,7 @@
 //--------------------------------------------------------------------------------------------------
 static void DefineServiceNameVars
 (
-    std::ofstream& fileStream,      ///< File stream to write to.
+    std::ostream& fileStream,       ///< Stream to write to.
     const model::ApiRef_t* interfacePtr,  ///< Ptr to client or server interface.
     bool isStandAlone   ///< true = fully resolve all interface name variables.
 )
@@ -87,15 +87,8 @@ void GenerateCLangComponentMainFile
                   << std::endl;
     }
 
-    // Open the .c file for writing.
-    file::MakeDir(outputDir);
-    std::ofstream fileStream(filePath, std::ofstream::trunc);
-    if (!fileStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    // Generate the .c file in memory, so it's only written if it changed.
+    std::ostringstream fileStream;
 
     // Generate file header and #include directives.
     fileStream << "/*\n"
@@ -119,8 +112,12 @@ void GenerateCLangComponentMainFile
     {
         DefineServiceNameVars(fileStream, interfacePtr, buildParams.isStandAloneComp);
 
-        // Declare the client-side interface initialization function.
-        fileStream << "void " << interfacePtr->internalName << "_ConnectService(void);\n";
+        // Declare the client-side interface initialization functions.
+        fileStream << "void " << interfacePtr->internalName << "_ConnectService(void);\n"
+                      "le_msg_SessionRef_t " << interfacePtr->internalName <<
+                      "_PrepareConnectService(void);\n"
+                      "void " << interfacePtr->internalName <<
+                      "_FinishConnectService(le_msg_SessionRef_t sessionRef);\n";
     }
 
     // For each of the component's server-side interfaces,
@@ -174,24 +171,62 @@ void GenerateCLangComponentMainFile
         fileStream << "\n";
     }
 
-    // Call each of the component's client-side interfaces' initialization functions,
-    // except those that are marked [manual-start].
+    // Connect each of the component's client-side interfaces, except those that are marked
+    // [manual-start].
+    std::list<model::ApiClientInterface_t*> autoStartClientApis;
+
+    for (auto ifPtr : componentPtr->clientApis)
+    {
+        if (!(ifPtr->manualStart))
+        {
+            autoStartClientApis.push_back(ifPtr);
+        }
+    }
+
     if (!componentPtr->clientApis.empty())
     {
         fileStream << "    // Connect client-side IPC interfaces.\n";
 
         for (auto ifPtr : componentPtr->clientApis)
         {
-            // If not marked for manual start,
-            if (!(ifPtr->manualStart))
+            if (ifPtr->manualStart)
             {
-                // Call the interface initialization function.
-                fileStream << "    " << ifPtr->internalName << "_ConnectService();\n";
+                fileStream << "    // '" << ifPtr->internalName << "' is [manual-start].\n";
             }
-            else
+        }
+
+        if (autoStartClientApis.size() == 1)
+        {
+            // Call the interface initialization function.
+            fileStream << "    " << autoStartClientApis.front()->internalName <<
+                          "_ConnectService();\n";
+        }
+        else if (autoStartClientApis.size() > 1)
+        {
+            // Open all the sessions at once, so the component waits for its slowest service
+            // instead of for all of them, one after the other.
+            fileStream << "    {\n"
+                          "        le_msg_SessionRef_t sessionRefs[] =\n"
+                          "        {\n";
+
+            for (auto ifPtr : autoStartClientApis)
             {
-                fileStream << "    // '" << ifPtr->internalName << "' is [manual-start].\n";
+                fileStream << "            " << ifPtr->internalName <<
+                              "_PrepareConnectService(),\n";
             }
+
+            fileStream << "        };\n"
+                          "        le_msg_OpenSessionsSync(sessionRefs,"
+                          " NUM_ARRAY_MEMBERS(sessionRefs));\n";
+
+            size_t i = 0;
+            for (auto ifPtr : autoStartClientApis)
+            {
+                fileStream << "        " << ifPtr->internalName <<
+                              "_FinishConnectService(sessionRefs[" << i++ << "]);\n";
+            }
+
+            fileStream << "    }\n";
         }
 
         fileStream << "\n";
@@ -214,6 +249,9 @@ void GenerateCLangComponentMainFile
                   "#ifdef __cplusplus\n"
                   "}\n"
                   "#endif\n";
+
+    file::MakeDir(outputDir);
+    file::WriteIfChanged(filePath, fileStream.str());
 }
 
 
@@ -43,15 +43,8 @@ void GenerateCLangExeMain
                   << std::endl;
     }
 
-    // Open the file as an output stream.
-    file::MakeDir(path::GetContainingDir(sourceFile));
-    std::ofstream outputFile(sourceFile);
-    if (outputFile.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), sourceFile)
-        );
-    }
+    // Generate the file in memory, so it's only written if it changed.
+    std::ostringstream outputFile;
 
     // Generate the file header comment and #include directives.
     outputFile << "\n"
@@ -61,6 +54,7 @@ void GenerateCLangExeMain
                   "#include \"legato.h\"\n"
                   "#include \"../liblegato/eventLoop.h\"\n"
                   "#include \"../liblegato/log.h\"\n"
+                  "#include \"../liblegato/linux/messaging.h\"\n"
                   "#include <dlfcn.h>\n"
                   "\n"
                   "\n";
@@ -157,6 +151,45 @@ void GenerateCLangExeMain
                   "    #endif\n"
                   "\n";
 
+    // Collect the names of the server-side interfaces that are instantiated in this executable.
+    std::set<std::string> serverIfNames;
+    for (auto componentInstancePtr : exePtr->componentInstances)
+    {
+        for (auto ifInstancePtr : componentInstancePtr->serverApis)
+        {
+            serverIfNames.insert(ifInstancePtr->name);
+        }
+    }
+
+    // Any client-side interface that is bound to one of those gets its sessions opened in-process.
+    bool hasLocalBindings = false;
+    for (auto componentInstancePtr : exePtr->componentInstances)
+    {
+        for (auto ifInstancePtr : componentInstancePtr->clientApis)
+        {
+            auto bindingPtr = ifInstancePtr->bindingPtr;
+
+            if (   (bindingPtr != NULL)
+                && (bindingPtr->serverType == model::Binding_t::INTERNAL)
+                && (serverIfNames.count(bindingPtr->serverIfName) != 0))
+            {
+                if (!hasLocalBindings)
+                {
+                    outputFile << "    // Open sessions between this executable's own interfaces"
+                                  " in-process.\n";
+                    hasLocalBindings = true;
+                }
+
+                outputFile << "    msg_AddLocalBinding(\"" << ifInstancePtr->name << "\", \""
+                           << bindingPtr->serverIfName << "\");\n";
+            }
+        }
+    }
+    if (hasLocalBindings)
+    {
+        outputFile << "\n";
+    }
+
     // Iterate over the list of Component Instances, loading their dynamic libraries.
     outputFile << "    // Load dynamic libraries.\n";
     for (auto componentInstancePtr : exePtr->componentInstances)
@@ -205,7 +238,8 @@ void GenerateCLangExeMain
                   "    LE_FATAL(\"== SHOULDN'T GET HERE! ==\");\n"
                   "}\n";
 
-    outputFile.close();
+    file::MakeDir(path::GetContainingDir(sourceFile));
+    file::WriteIfChanged(sourceFile, outputFile.str());
 }
 
 
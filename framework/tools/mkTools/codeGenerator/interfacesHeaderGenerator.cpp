@@ -37,17 +37,9 @@ void GenerateCLangInterfacesHeader
                   << std::endl;
     }
 
-    // Make sure the working file output directory exists.
-    file::MakeDir(outputDir);
-
-    // Open the interfaces.h file for writing.
-    std::ofstream fileStream(filePath, std::ofstream::trunc);
-    if (!fileStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    // Generate interfaces.h in memory, so it's only written if it changed.  Otherwise, every
+    // source file in the component would be recompiled every time.
+    std::ostringstream fileStream;
 
     std::string includeGuardName = "__" + componentPtr->name
                                         + "_COMPONENT_INTERFACE_H_INCLUDE_GUARD";
@@ -102,6 +94,11 @@ void GenerateCLangInterfacesHeader
                   "#endif\n"
                   "\n"
                   "#endif // " << includeGuardName << "\n";
+
+    // Make sure the working file output directory exists.
+    file::MakeDir(outputDir);
+
+    file::WriteIfChanged(filePath, fileStream.str());
 }
 
 
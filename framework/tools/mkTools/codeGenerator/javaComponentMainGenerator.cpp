@@ -41,15 +41,8 @@ void GenerateJavaComponentMainFile
                   << std::endl;
     }
 
-    // Open the .java file for writing.
-    file::MakeDir(outputDir);
-    std::ofstream outputFile(filePath, std::ofstream::trunc);
-    if (!outputFile.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    // Generate the .java file in memory, so it's only written if it changed.
+    std::ostringstream outputFile;
 
     std::string apiImports;
     std::string serverVars;
@@ -158,6 +151,9 @@ void GenerateJavaComponentMainFile
                   "        return component;\n"
                   "    }\n"
                   "}\n";
+
+    file::MakeDir(outputDir);
+    file::WriteIfChanged(filePath, outputFile.str());
 }
 
 
@@ -28,15 +28,8 @@ void GenerateJavaExeMain
     // Compute the path to the file to be generated.
     auto sourceFile = exePtr->MainObjectFile().sourceFilePath;
 
-    // Open the file as an output stream.
-    file::MakeDir(path::GetContainingDir(sourceFile));
-    std::ofstream outputFile(sourceFile);
-    if (outputFile.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), sourceFile)
-        );
-    }
+    // Generate the file in memory, so it's only written if it changed.
+    std::ostringstream outputFile;
 
     auto& exeName = exePtr->name;
     auto& appName = exePtr->appPtr->name;
@@ -117,6 +110,9 @@ void GenerateJavaExeMain
                   "        }\n"
                   "    }\n"
                   "}\n";
+
+    file::MakeDir(path::GetContainingDir(sourceFile));
+    file::WriteIfChanged(sourceFile, outputFile.str());
 }
 
 
@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file unityFileGenerator.cpp
+ *
+ * Generation of the sources for unity builds (see mk --unity-build).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+
+namespace code
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the _componentPch.h precompiled header and the _unity<N>.c files for a given component.
+ *
+ * Each _unity<N>.c file includes the precompiled header, then each of the C source files in its
+ * batch, redefining LE_FILENAME before each one so that log messages still name the right file.
+ * (LE_FILENAME is left off the command line for these, as it would stop gcc using the .gch.)
+ **/
+//--------------------------------------------------------------------------------------------------
+void GenerateCLangUnityFiles
+(
+    const model::Component_t* componentPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto& compName = componentPtr->name;
+
+    std::string outputDir = path::Minimize(buildParams.workingDir
+                                        + '/'
+                                        + componentPtr->workingDir
+                                        + "/src");
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Generating %zu unity build source files for"
+                                        " component '%s' in '%s'."),
+                                componentPtr->cUnityFiles.size(), compName, outputDir)
+                  << std::endl;
+    }
+
+    file::MakeDir(outputDir);
+
+    // The headers included by (almost) every source file in the component.
+    std::ostringstream pchStream;
+
+    pchStream << "/*\n"
+                 " * AUTO-GENERATED _componentPch.h for the " << compName << " component.\n"
+                 " *\n"
+                 " * Precompiled once, then included first by each of the component's unity build\n"
+                 " * source files.\n"
+                 "\n"
+                 " * Don't bother hand-editing this file.\n"
+                 " */\n"
+                 "\n"
+                 "#include \"legato.h\"\n"
+                 "#include \"interfaces.h\"\n";
+
+    file::WriteIfChanged(path::Combine(outputDir, "_componentPch.h"), pchStream.str());
+
+    for (auto unityFilePtr : componentPtr->cUnityFiles)
+    {
+        std::ostringstream fileStream;
+
+        fileStream << "/*\n"
+                      " * AUTO-GENERATED " << path::GetLastNode(unityFilePtr->sourceFilePath)
+                   << " for the " << compName << " component.\n"
+                      "\n"
+                      " * Don't bother hand-editing this file.\n"
+                      " */\n"
+                      "\n"
+                      "#include \"_componentPch.h\"\n";
+
+        for (auto objFilePtr : unityFilePtr->members)
+        {
+            fileStream << "\n"
+                          "#undef LE_FILENAME\n"
+                          "#define LE_FILENAME "
+                       << path::GetLastNode(objFilePtr->sourceFilePath) << "\n"
+                          "#include \"" << objFilePtr->sourceFilePath << "\"\n";
+        }
+
+        file::WriteIfChanged(unityFilePtr->sourceFilePath, fileStream.str());
+    }
+}
+
+
+} // namespace code
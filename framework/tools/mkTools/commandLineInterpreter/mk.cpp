@@ -15,6 +15,67 @@
 #include "commandLineInterpreter.h"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for the --profile option, which all the tools accept, and enable profiling if it's there.
+ * It's removed from the argument list, so that it isn't saved with the build's arguments and
+ * doesn't make any difference to the build itself.
+ *
+ *  --profile           Write a trace of the tool's work to "<tool name>.profile.json".
+ *  --profile=FILE      Write it to FILE instead.
+ *
+ * The trace can be loaded into chrome://tracing or https://ui.perfetto.dev.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleProfileOption
+(
+    const std::string& toolName,
+    std::vector<const char*>& args  ///< [in,out] The command-line arguments.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (auto i = args.begin(); i != args.end(); )
+    {
+        if (strcmp(*i, "--profile") == 0)
+        {
+            profile::Enable(toolName + ".profile.json");
+            i = args.erase(i);
+        }
+        else if (strncmp(*i, "--profile=", 10) == 0)
+        {
+            profile::Enable(*i + 10);
+            i = args.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the profile, if there is one, without throwing.  Used when exiting with an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveProfile
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    try
+    {
+        profile::Save();
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Program entry point.
@@ -26,6 +87,13 @@ int main(int argc, const char** argv)
     {
         std::string fileName = path::GetLastNode(argv[0]);
 
+        // Take the --profile option out of the arguments before the tool sees them.
+        std::vector<const char*> args(argv, argv + argc);
+        HandleProfileOption(fileName, args);
+        argc = args.size();
+        args.push_back(NULL);
+        argv = args.data();
+
         if (fileName == "mkexe")
         {
             cli::MakeExecutable(argc, argv);
@@ -42,23 +110,31 @@ int main(int argc, const char** argv)
         {
             cli::MakeSystem(argc, argv);
         }
+        else if (fileName == "mkmd5")
+        {
+            cli::MakeMd5(argc, argv);
+        }
         else
         {
             std::cerr << mk::format(LE_I18N("** ERROR: unknown command name '%s'."), fileName)
                       << std::endl;
             return EXIT_FAILURE;
         }
+
+        profile::Save();
     }
     catch (mk::Exception_t &e)
     {
         std::cerr << LE_I18N("** ERROR:") << std::endl
                   << e.what() << std::endl;
+        SaveProfile();
         return EXIT_FAILURE;
     }
     catch (std::exception& e)
     {
         std::cerr << LE_I18N("** ERROR:") << std::endl
                   << mk::format(LE_I18N("Internal error: %s"), e.what()) << std::endl;
+        SaveProfile();
         return EXIT_FAILURE;
     }
 
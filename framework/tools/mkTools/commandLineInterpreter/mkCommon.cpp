@@ -10,6 +10,9 @@
 #include "mkCommon.h"
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <thread>
 
 
 namespace
@@ -98,113 +101,256 @@ std::string GetToolPath
 
 //----------------------------------------------------------------------------------------------
 /**
- * Get the sysroot path to use when linking for a given compiler.
+ * Ask gcc what sysroot it uses by default.
  *
- * @return  The path to the sysroot base directory, or an empty string if not specified.
+ * @return  The path to the sysroot base directory, or an empty string if gcc doesn't have one.
  *
  * @throws  mk::Exception_t on error.
  */
 //----------------------------------------------------------------------------------------------
-std::string GetSysRootPath
+std::string AskGccForSysRootPath
 (
-    const std::string& target,          ///< The target device type (e.g., wp85)
     const std::string& cCompilerPath    ///< Path to the C compiler
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If LEGATO_SYSROOT is set, use that.
-    auto sysRoot = envVars::Get("LEGATO_SYSROOT");
-    if (! sysRoot.empty())
+    std::string commandLine = cCompilerPath + " --print-sysroot";
+
+    FILE* output = popen(commandLine.c_str(), "r");
+
+    if (output == NULL)
     {
-        return sysRoot;
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Could not exec '%s' to get sysroot path."), commandLine)
+        );
     }
 
-    // Else, if the target-specific XXXX_SYSROOT is set, then use that.
-    std::string targetPrefix = target + "_";
-    std::transform(targetPrefix.begin(), targetPrefix.end(), targetPrefix.begin(), ::toupper);
-    sysRoot = envVars::Get(targetPrefix + "SYSROOT");
-    if (! sysRoot.empty())
+    char buffer[1024] = { 0 };
+    static const size_t bufferSize = sizeof(buffer);
+
+    if (fgets(buffer, bufferSize, output) != buffer)
     {
-        return sysRoot;
+        std::cerr <<
+            mk::format(LE_I18N("** WARNING: Failed to receive sysroot path from compiler "
+                               "'%s' (errno: %s)."), commandLine, strerror(errno))
+                  << std::endl;
+        buffer[0] = '\0';
+    }
+    else
+    {
+        // Remove any trailing newline character.
+        size_t len = strlen(buffer);
+        if (buffer[len - 1] == '\n')
+        {
+            buffer[len - 1] = '\0';
+        }
     }
 
-    // Else, if the compiler is gcc, ask gcc what sysroot it uses by default.
-    if (path::HasSuffix(cCompilerPath, "gcc"))
+    // Yocto >= 1.8 returns '/not/exist' as a sysroot path
+    if (buffer == std::string("/not/exist"))
     {
-        std::string commandLine = cCompilerPath + " --print-sysroot";
+        std::cerr << mk::format(LE_I18N("** WARNING: Invalid sysroot returned from compiler"
+                                        " '%s' (returned '%s')."), commandLine, buffer)
+                  << std::endl;
+        buffer[0] = '\0';
+    }
 
-        FILE* output = popen(commandLine.c_str(), "r");
+    // Close the connection and collect the exit code from the compiler.
+    int result;
+    do
+    {
+        result = pclose(output);
 
-        if (output == NULL)
-        {
-            throw mk::Exception_t(
-                mk::format(LE_I18N("Could not exec '%s' to get sysroot path."), commandLine)
-            );
-        }
+    } while ((result == -1) && (errno == EINTR));
 
-        char buffer[1024] = { 0 };
-        static const size_t bufferSize = sizeof(buffer);
+    if (result == -1)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
+                               "pclose() errno = %s"), commandLine, strerror(errno))
+        );
+    }
+    else if (!WIFEXITED(result))
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
+                               "Compiler was interrupted by something."),
+                       commandLine)
+        );
+    }
+    else if (WEXITSTATUS(result) != EXIT_SUCCESS)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
+                               "Compiler exited with code %d"),
+                       commandLine, WEXITSTATUS(result))
+        );
+    }
 
-        if (fgets(buffer, bufferSize, output) != buffer)
-        {
-            std::cerr <<
-                mk::format(LE_I18N("** WARNING: Failed to receive sysroot path from compiler "
-                                   "'%s' (errno: %s)."), commandLine, strerror(errno))
-                      << std::endl;
-            buffer[0] = '\0';
-        }
-        else
-        {
-            // Remove any trailing newline character.
-            size_t len = strlen(buffer);
-            if (buffer[len - 1] == '\n')
-            {
-                buffer[len - 1] = '\0';
-            }
-        }
+    return buffer;
+}
 
-        // Yocto >= 1.8 returns '/not/exist' as a sysroot path
-        if (buffer == std::string("/not/exist"))
-        {
-            std::cerr << mk::format(LE_I18N("** WARNING: Invalid sysroot returned from compiler"
-                                            " '%s' (returned '%s')."), commandLine, buffer)
-                      << std::endl;
-            buffer[0] = '\0';
-        }
 
-        // Close the connection and collect the exit code from the compiler.
-        int result;
-        do
-        {
-            result = pclose(output);
+//----------------------------------------------------------------------------------------------
+/**
+ * Get a string that changes whenever a given executable is replaced or modified, by finding it
+ * (searching the PATH if necessary) and looking at its size and modification time.
+ *
+ * @return  The string, or an empty string if the executable can't be found.
+ */
+//----------------------------------------------------------------------------------------------
+std::string GetExecutableStamp
+(
+    const std::string& exePath          ///< Path to the executable, or just its name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::list<std::string> candidates;
 
-        } while ((result == -1) && (errno == EINTR));
+    if (exePath.find('/') != std::string::npos)
+    {
+        candidates.push_back(exePath);
+    }
+    else
+    {
+        std::stringstream searchPath(envVars::Get("PATH"));
+        std::string dir;
 
-        if (result == -1)
+        while (std::getline(searchPath, dir, ':'))
         {
-            throw mk::Exception_t(
-                mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
-                                   "pclose() errno = %s"), commandLine, strerror(errno))
-            );
+            candidates.push_back(path::Combine(dir.empty() ? "." : dir, exePath));
         }
-        else if (!WIFEXITED(result))
+    }
+
+    for (auto& candidate : candidates)
+    {
+        struct stat statBuffer;
+
+        if ((stat(candidate.c_str(), &statBuffer) == 0) && S_ISREG(statBuffer.st_mode))
         {
-            throw mk::Exception_t(
-                mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
-                                   "Compiler was interrupted by something."),
-                           commandLine)
-            );
+            return mk::format("%lld.%09ld %lld %s",
+                              (long long)statBuffer.st_mtim.tv_sec,
+                              (long)statBuffer.st_mtim.tv_nsec,
+                              (long long)statBuffer.st_size,
+                              path::MakeAbsolute(candidate));
         }
-        else if (WEXITSTATUS(result) != EXIT_SUCCESS)
+    }
+
+    return "";
+}
+
+
+//----------------------------------------------------------------------------------------------
+/**
+ * Get the sysroot path that gcc uses by default, from the cache in the working directory if
+ * the same compiler has been asked before, or else by asking gcc (and caching the answer).
+ *
+ * The cache holds a record for each compiler path that has been asked, and each record is only
+ * used if the compiler executable has not been modified since.
+ *
+ * @return  The path to the sysroot base directory, or an empty string if gcc doesn't have one.
+ *
+ * @throws  mk::Exception_t on error.
+ */
+//----------------------------------------------------------------------------------------------
+std::string GetGccSysRootPath
+(
+    const std::string& cCompilerPath,   ///< Path to the C compiler
+    const std::string& workingDir       ///< Working dir in which to cache the answer (or empty)
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto stamp = GetExecutableStamp(cCompilerPath);
+
+    if (workingDir.empty() || stamp.empty() || (cCompilerPath.find('\t') != std::string::npos))
+    {
+        return AskGccForSysRootPath(cCompilerPath);
+    }
+
+    auto cachePath = path::Combine(workingDir, "mktool_sysroots");
+
+    // Each line in the cache is <compiler path> TAB <executable stamp> TAB <sysroot path>.
+    std::map<std::string, std::pair<std::string, std::string>> cache;
+    std::ifstream cacheFile(cachePath);
+    std::string line;
+
+    while (std::getline(cacheFile, line))
+    {
+        auto firstTab = line.find('\t');
+        auto secondTab = (firstTab == std::string::npos) ? firstTab : line.find('\t', firstTab + 1);
+
+        if (secondTab != std::string::npos)
         {
-            throw mk::Exception_t(
-                mk::format(LE_I18N("Failed to receive the sysroot path from the compiler '%s'. "
-                                   "Compiler exited with code %d"),
-                           commandLine, WEXITSTATUS(result))
-            );
+            cache[line.substr(0, firstTab)] =
+                std::make_pair(line.substr(firstTab + 1, secondTab - firstTab - 1),
+                               line.substr(secondTab + 1));
         }
+    }
+
+    cacheFile.close();
+
+    auto i = cache.find(cCompilerPath);
+    if ((i != cache.end()) && (i->second.first == stamp))
+    {
+        return i->second.second;
+    }
+
+    auto sysRoot = AskGccForSysRootPath(cCompilerPath);
+
+    cache[cCompilerPath] = std::make_pair(stamp, sysRoot);
 
-        return buffer;
+    // Failing to save the cache just means gcc will be asked again next time.
+    file::MakeDir(workingDir);
+    std::ofstream newCacheFile(cachePath);
+
+    for (auto& entry : cache)
+    {
+        newCacheFile << entry.first << '\t'
+                     << entry.second.first << '\t'
+                     << entry.second.second << '\n';
+    }
+
+    return sysRoot;
+}
+
+
+//----------------------------------------------------------------------------------------------
+/**
+ * Get the sysroot path to use when linking for a given compiler.
+ *
+ * @return  The path to the sysroot base directory, or an empty string if not specified.
+ *
+ * @throws  mk::Exception_t on error.
+ */
+//----------------------------------------------------------------------------------------------
+std::string GetSysRootPath
+(
+    const std::string& target,          ///< The target device type (e.g., wp85)
+    const std::string& cCompilerPath,   ///< Path to the C compiler
+    const std::string& workingDir       ///< Working dir in which to cache the answer (or empty)
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If LEGATO_SYSROOT is set, use that.
+    auto sysRoot = envVars::Get("LEGATO_SYSROOT");
+    if (! sysRoot.empty())
+    {
+        return sysRoot;
+    }
+
+    // Else, if the target-specific XXXX_SYSROOT is set, then use that.
+    std::string targetPrefix = target + "_";
+    std::transform(targetPrefix.begin(), targetPrefix.end(), targetPrefix.begin(), ::toupper);
+    sysRoot = envVars::Get(targetPrefix + "SYSROOT");
+    if (! sysRoot.empty())
+    {
+        return sysRoot;
+    }
+
+    // Else, if the compiler is gcc, ask gcc what sysroot it uses by default.
+    if (path::HasSuffix(cCompilerPath, "gcc"))
+    {
+        return GetGccSysRootPath(cCompilerPath, workingDir);
     }
 
     return sysRoot;
@@ -236,7 +382,9 @@ void FindToolChain
 {
     buildParams.cCompilerPath = GetToolPath(buildParams.target, "CC");
     buildParams.cxxCompilerPath = GetToolPath(buildParams.target, "CXX");
-    buildParams.sysrootPath = GetSysRootPath(buildParams.target, buildParams.cCompilerPath);
+    buildParams.sysrootPath = GetSysRootPath(buildParams.target,
+                                              buildParams.cCompilerPath,
+                                              buildParams.workingDir);
     buildParams.linkerPath = GetToolPath(buildParams.target, "LD");
     buildParams.archiverPath = GetToolPath(buildParams.target, "AR");
     buildParams.assemblerPath = GetToolPath(buildParams.target, "AS");
@@ -259,6 +407,137 @@ void FindToolChain
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out the compiler and linker flags for the build profile named in @c buildParams (if any)
+ * and store them in @c buildParams.
+ *
+ * The profiles are cumulative:
+ *  - size: put every function and data item in its own section, and have the linker drop the
+ *          ones that aren't used.
+ *  - lto: as for size, plus link-time optimization.
+ *  - pgo-generate: as for lto, plus instrumentation that records a profile in the PGO data
+ *          directory (a directory on the target) when the programs run.
+ *  - pgo-use: as for lto, plus optimization using profiles found in the PGO data directory (on
+ *          the build host), for those object files that have one.
+ *
+ * @throw mk::Exception_t if the profile is unknown, or needs a PGO data directory and none is given.
+ */
+//--------------------------------------------------------------------------------------------------
+void ApplyBuildProfile
+(
+    mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const auto& profile = buildParams.buildProfile;
+
+    buildParams.profileCFlags.clear();
+    buildParams.profileLdFlags.clear();
+
+    if (profile.empty() || (profile == "default"))
+    {
+        return;
+    }
+
+    bool isPgo = ((profile == "pgo-generate") || (profile == "pgo-use"));
+
+    if ((profile != "size") && (profile != "lto") && !isPgo)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Unknown build profile '%s'.  Must be one of 'default', 'size',"
+                               " 'lto', 'pgo-generate' or 'pgo-use'."),
+                       profile)
+        );
+    }
+
+    if (isPgo && buildParams.pgoDir.empty())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("The '%s' build profile needs a profile data directory"
+                               " (--pgo-dir)."),
+                       profile)
+        );
+    }
+
+    buildParams.profileCFlags = " -ffunction-sections -fdata-sections";
+    buildParams.profileLdFlags = " -Wl,--gc-sections";
+
+    if (profile != "size")
+    {
+        buildParams.profileCFlags += " -flto";
+        buildParams.profileLdFlags += " -flto";
+    }
+
+    if (profile == "pgo-generate")
+    {
+        // The directory is on the target, so it's used as is.
+        buildParams.profileCFlags += " -fprofile-generate=" + buildParams.pgoDir;
+        buildParams.profileLdFlags += " -fprofile-generate=" + buildParams.pgoDir;
+    }
+    else if (profile == "pgo-use")
+    {
+        auto pgoDir = path::MakeAbsolute(buildParams.pgoDir);
+
+        // Counters from multi-threaded programs may be slightly inconsistent, and object files
+        // that weren't run, or that have changed since, are just optimized as usual.
+        buildParams.profileCFlags += " -fprofile-use=" + pgoDir +
+                                     " -fprofile-correction"
+                                     " -Wno-missing-profile"
+                                     " -Wno-error=coverage-mismatch";
+        buildParams.profileLdFlags += " -fprofile-use=" + pgoDir;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the log level floor named in @c buildParams (if any), and replace it with the name of the
+ * matching le_log_Level_t constant, which the components' log macros are compiled with.
+ *
+ * The level names are the same as the log tool's and the LE_LOG_LEVEL environment variable's.
+ *
+ * @throw mk::Exception_t if the log level is unknown.
+ */
+//--------------------------------------------------------------------------------------------------
+void ApplyLogLevelFloor
+(
+    mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const std::map<std::string, std::string> levels =
+    {
+        { "DEBUG",      "LE_LOG_DEBUG" },
+        { "INFO",       "LE_LOG_INFO" },
+        { "WARNING",    "LE_LOG_WARN" },
+        { "ERROR",      "LE_LOG_ERR" },
+        { "CRITICAL",   "LE_LOG_CRIT" },
+        { "EMERGENCY",  "LE_LOG_EMERG" },
+    };
+
+    auto& floor = buildParams.logLevelFloor;
+
+    if (floor.empty())
+    {
+        return;
+    }
+
+    auto i = levels.find(floor);
+
+    if (i == levels.end())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Unknown log level '%s'.  Must be one of 'DEBUG', 'INFO',"
+                               " 'WARNING', 'ERROR', 'CRITICAL' or 'EMERGENCY'."),
+                       floor)
+        );
+    }
+
+    floor = i->second;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Run the Ninja build tool.  Executes the build.ninja script in the root of the working directory
@@ -280,6 +559,9 @@ void RunNinja
 
     if (file::FileExists(ninjaFilePath))
     {
+        // Ninja replaces this process, so the profile has to be saved now.
+        profile::Save();
+
         if (buildParams.beVerbose)
         {
             std::cout << LE_I18N("Executing ninja build system...") << std::endl;
@@ -313,6 +595,77 @@ void RunNinja
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a list of independent code generation jobs on a pool of threads, one per core.  The calling
+ * thread works too, and this returns once every job has finished.
+ *
+ * If any jobs throw, the exception thrown by the first of them (in list order) is rethrown once
+ * all the jobs are finished, so errors are reported the same way no matter how the work was
+ * scheduled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunInParallel
+(
+    const std::vector<std::function<void()>>& jobs
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::vector<std::exception_ptr> errors(jobs.size());
+    std::atomic<size_t> nextJob(0);
+
+    auto worker = [&jobs, &errors, &nextJob]()
+        {
+            size_t i;
+
+            while ((i = nextJob++) < jobs.size())
+            {
+                try
+                {
+                    jobs[i]();
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = std::min(threadCount, jobs.size());
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (std::system_error&)
+        {
+            // Make do with the threads we've got.
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate code for a given component.
@@ -333,6 +686,9 @@ void GenerateCode
 
     // Generate a custom "_componentMain.c" file for this component.
     code::GenerateComponentMainFile(componentPtr, buildParams);
+
+    // Generate the sources for building it as a unity build, if that was asked for.
+    code::GenerateUnityFiles(componentPtr, buildParams);
 }
 
 
@@ -348,10 +704,14 @@ void GenerateCode
 )
 //--------------------------------------------------------------------------------------------------
 {
+    std::vector<std::function<void()>> jobs;
+
     for (auto componentPtr : components)
     {
-        GenerateCode(componentPtr, buildParams);
+        jobs.push_back([componentPtr, &buildParams]() { GenerateCode(componentPtr, buildParams); });
     }
+
+    RunInParallel(jobs);
 }
 
 
@@ -367,10 +727,16 @@ void GenerateCode
 )
 //--------------------------------------------------------------------------------------------------
 {
+    std::vector<std::function<void()>> jobs;
+
     for (auto& mapEntry : components)
     {
-        GenerateCode(mapEntry.second, buildParams);
+        auto componentPtr = mapEntry.second;
+
+        jobs.push_back([componentPtr, &buildParams]() { GenerateCode(componentPtr, buildParams); });
     }
+
+    RunInParallel(jobs);
 }
 
 
@@ -392,12 +758,18 @@ void GenerateCode
     // Generate the configuration data file.
     config::Generate(appPtr, buildParams);
 
-    // For each executable in the application,
-    for (auto exePtr : appPtr->executables)
+    // Generate _main.c for each executable in the application.  This relies on the code for the
+    // executables' components having been generated already.
+    std::vector<std::function<void()>> jobs;
+
+    for (auto& mapEntry : appPtr->executables)
     {
-        // Generate _main.c.
-        code::GenerateExeMain(exePtr.second, buildParams);
+        auto exePtr = mapEntry.second;
+
+        jobs.push_back([exePtr, &buildParams]() { code::GenerateExeMain(exePtr, buildParams); });
     }
+
+    RunInParallel(jobs);
 }
 
 
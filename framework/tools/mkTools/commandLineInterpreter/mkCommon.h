@@ -28,6 +28,34 @@ void FindToolChain
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out the compiler and linker flags for the build profile named in @c buildParams (if any)
+ * and store them in @c buildParams.
+ *
+ * @throw mk::Exception_t if the profile is unknown, or needs a PGO data directory and none is given.
+ */
+//--------------------------------------------------------------------------------------------------
+void ApplyBuildProfile
+(
+    mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the log level floor named in @c buildParams (if any), and replace it with the name of the
+ * matching le_log_Level_t constant, which the components' log macros are compiled with.
+ *
+ * @throw mk::Exception_t if the log level is unknown.
+ */
+//--------------------------------------------------------------------------------------------------
+void ApplyLogLevelFloor
+(
+    mk::BuildParams_t& buildParams
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Run the Ninja build tool.  Executes the build.ninja script in the root of the working directory
@@ -45,7 +45,10 @@ static bool DontRunNinja = false;
 /// Steps to run to generate a Linux app
 static const generator::AppGenerator_t LinuxSteps[] =
 {
-    generator::ForAllComponents<GenerateCode>,
+    [](model::App_t* appPtr, const mk::BuildParams_t& buildParams)
+    {
+        GenerateCode(appPtr->components, buildParams);
+    },
     GenerateCode,
     ninja::Generate,
     [](model::App_t* appPtr, const mk::BuildParams_t& buildParams)
@@ -211,7 +214,10 @@ static void GetCommandLineArgs
                                   " including a new copy of the build.ninja, then exit without"
                                   " running ninja.  This is used by the build.ninja to to"
                                   " regenerate itself and any other files that need to be"
-                                  " regenerated when the build.ninja finds itself out of date."));
+                                  " regenerated when the build.ninja finds itself out of date."
+                                  "  If the contents of the inputs and the environment are the"
+                                  " same as when the build.ninja was generated, it is just"
+                                  " marked as up to date instead."));
 
     args::AddOptionalFlag(&BuildParams.codeGenOnly,
                           'g',
@@ -223,6 +229,59 @@ static void GetCommandLineArgs
                                   " This is useful for supporting context-sensitive auto-complete"
                                   " and related features in source code editors, for example."));
 
+    args::AddOptionalFlag(&BuildParams.unityBuild,
+                          'U',
+                          "unity-build",
+                          LE_I18N("Compile each component's C source files in batches, each batch"
+                                  " as a single translation unit, with the headers that they all"
+                                  " include (legato.h and interfaces.h) precompiled.  This makes"
+                                  " components with many source files build faster, but source"
+                                  " files that define static variables or functions with the same"
+                                  " names will conflict with each other."));
+
+    args::AddOptionalString(&BuildParams.buildProfile,
+                            "",
+                            'O',
+                            "build-profile",
+                            LE_I18N("Build everything with a set of optimizations for size and"
+                                    " speed: 'size' (unused code and data removed at link time),"
+                                    " 'lto' (size, plus link-time optimization), 'pgo-generate'"
+                                    " (lto, plus instrumentation that records a profile of each"
+                                    " program as it runs) or 'pgo-use' (lto, plus optimization"
+                                    " using the recorded profiles).  The default is 'default'"
+                                    " (none of these)."));
+
+    args::AddOptionalString(&BuildParams.pgoDir,
+                            "",
+                            'P',
+                            "pgo-dir",
+                            LE_I18N("Directory for profile-guided optimization data.  With"
+                                    " 'pgo-generate', the directory on the target that the"
+                                    " profiles will be written to.  With 'pgo-use', the directory"
+                                    " on the build host that they have been copied to."));
+
+    args::AddOptionalString(&BuildParams.objCacheDir,
+                            "",
+                            'K',
+                            "obj-cache",
+                            LE_I18N("Directory of a cache of compiled object files, which can be"
+                                    " shared by any number of builds.  Source files are only"
+                                    " compiled if the cache doesn't already have the result of an"
+                                    " identical compile (same preprocessed source, flags and"
+                                    " compiler).  Defaults to the LEGATO_OBJ_CACHE environment"
+                                    " variable, if set."));
+
+    args::AddOptionalString(&BuildParams.logLevelFloor,
+                            "",
+                            'F',
+                            "log-level-floor",
+                            LE_I18N("Compile out log messages below this level: 'DEBUG', 'INFO',"
+                                    " 'WARNING', 'ERROR', 'CRITICAL' or 'EMERGENCY'.  Traces are"
+                                    " compiled out too, unless it is 'DEBUG'.  The level can still"
+                                    " be raised at runtime.  A component can override it by"
+                                    " defining LE_LOG_LEVEL_STATIC_FILTER in its cflags.  The"
+                                    " default is to compile all messages in."));
+
     args::AddOptionalFlag(&BuildParams.binPack,
                           'b',
                           "bin-pack",
@@ -232,6 +291,14 @@ static void GetCommandLineArgs
                                   " is intended to be included in a system definition (.sdef) "
                                   " file's 'apps:' section in place of a .adef file."));
 
+    args::AddOptionalFlag(&BuildParams.appImage,
+                          'S',
+                          "squashfs",
+                          LE_I18N("Pack the app into its .update file as a read-only squashfs"
+                                  " image instead of a tarball.  The target mounts the image"
+                                  " instead of unpacking it, which makes installing the app"
+                                  " faster and keeps its files from being modified."));
+
     // Any remaining parameters on the command-line are treated as the .adef file path.
     // Note: there should only be one parameter not prefixed by an argument identifier.
     args::SetLooseArgHandler(adefFileNameSet);
@@ -296,13 +363,31 @@ void MakeApp
     // (Must be done after command-line args parsing and before setting target-specific env vars.)
     FindToolChain(BuildParams);
 
+    // Work out the compiler and linker flags for the build profile.
+    ApplyBuildProfile(BuildParams);
+    ApplyLogLevelFloor(BuildParams);
+
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
-    // If we have been asked not to run Ninja, then delete the staging area because it probably
-    // will contain some of the wrong files now that .Xdef file have changed.
+    // Take note of the arguments and environment variables before parsing changes them.
+    inputs::RecordSettings(BuildParams);
+
+    // If we have been asked not to run Ninja, ninja wants its build.ninja regenerated because a
+    // file it depends on looks newer.  If none of the input files' contents have actually changed,
+    // the existing build.ninja is still right, so just mark it as up to date.  Otherwise, delete
+    // the staging area because it probably will contain some of the wrong files now that .Xdef
+    // file have changed.
     if (DontRunNinja)
     {
+        auto ninjaFilePath = path::Combine(BuildParams.workingDir, "build.ninja");
+
+        if (file::FileExists(ninjaFilePath) && inputs::MatchesSaved(BuildParams))
+        {
+            file::Touch(ninjaFilePath);
+            return;
+        }
+
         file::DeleteDir(path::Combine(BuildParams.workingDir, "staging"));
     }
     // If we have not been asked to ignore any already existing build.ninja, and the command-line
@@ -359,6 +444,9 @@ void MakeApp
     // Now delete the appPtr
     delete appPtr;
 
+    // Remember what the build.ninja was generated from.
+    inputs::Save(BuildParams);
+
     // If we haven't been asked not to, run ninja.
     if (!DontRunNinja)
     {
@@ -38,6 +38,7 @@ static generator::ComponentGenerator_t LinuxSteps[] =
 {
     code::GenerateInterfacesHeader,
     code::GenerateComponentMainFile,
+    code::GenerateUnityFiles,
     ninja::Generate,
     NULL
 };
@@ -212,6 +213,59 @@ static void GetCommandLineArgs
                                   " This is useful for supporting context-sensitive auto-complete"
                                   " and related features in source code editors, for example."));
 
+    args::AddOptionalFlag(&BuildParams.unityBuild,
+                          'U',
+                          "unity-build",
+                          LE_I18N("Compile each component's C source files in batches, each batch"
+                                  " as a single translation unit, with the headers that they all"
+                                  " include (legato.h and interfaces.h) precompiled.  This makes"
+                                  " components with many source files build faster, but source"
+                                  " files that define static variables or functions with the same"
+                                  " names will conflict with each other."));
+
+    args::AddOptionalString(&BuildParams.buildProfile,
+                            "",
+                            'O',
+                            "build-profile",
+                            LE_I18N("Build everything with a set of optimizations for size and"
+                                    " speed: 'size' (unused code and data removed at link time),"
+                                    " 'lto' (size, plus link-time optimization), 'pgo-generate'"
+                                    " (lto, plus instrumentation that records a profile of each"
+                                    " program as it runs) or 'pgo-use' (lto, plus optimization"
+                                    " using the recorded profiles).  The default is 'default'"
+                                    " (none of these)."));
+
+    args::AddOptionalString(&BuildParams.pgoDir,
+                            "",
+                            'P',
+                            "pgo-dir",
+                            LE_I18N("Directory for profile-guided optimization data.  With"
+                                    " 'pgo-generate', the directory on the target that the"
+                                    " profiles will be written to.  With 'pgo-use', the directory"
+                                    " on the build host that they have been copied to."));
+
+    args::AddOptionalString(&BuildParams.objCacheDir,
+                            "",
+                            'K',
+                            "obj-cache",
+                            LE_I18N("Directory of a cache of compiled object files, which can be"
+                                    " shared by any number of builds.  Source files are only"
+                                    " compiled if the cache doesn't already have the result of an"
+                                    " identical compile (same preprocessed source, flags and"
+                                    " compiler).  Defaults to the LEGATO_OBJ_CACHE environment"
+                                    " variable, if set."));
+
+    args::AddOptionalString(&BuildParams.logLevelFloor,
+                            "",
+                            'F',
+                            "log-level-floor",
+                            LE_I18N("Compile out log messages below this level: 'DEBUG', 'INFO',"
+                                    " 'WARNING', 'ERROR', 'CRITICAL' or 'EMERGENCY'.  Traces are"
+                                    " compiled out too, unless it is 'DEBUG'.  The level can still"
+                                    " be raised at runtime.  A component can override it by"
+                                    " defining LE_LOG_LEVEL_STATIC_FILTER in its cflags.  The"
+                                    " default is to compile all messages in."));
+
     // Any remaining parameters on the command-line are treated as a component path.
     // Note: there should only be one.
     args::SetLooseArgHandler(componentPathSet);
@@ -256,6 +310,10 @@ void MakeComponent
     // (Must be done after command-line args parsing and before setting target-specific env vars.)
     FindToolChain(BuildParams);
 
+    // Work out the compiler and linker flags for the build profile.
+    ApplyBuildProfile(BuildParams);
+    ApplyLogLevelFloor(BuildParams);
+
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
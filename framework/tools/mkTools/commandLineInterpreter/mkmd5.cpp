@@ -0,0 +1,440 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Implements the "mkmd5" functionality of the "mk" tool.
+ *
+ *  Computes the MD5 hash that identifies the contents of a staging directory (for an app's or a
+ *  system's info.properties).  The hash is exactly the same as the one that comes out of the
+ *  shell pipeline the build scripts used to run:
+ *
+ *  @verbatim
+    ( cd DIR && find -P -print0 |LC_ALL=C sort -z &&
+                find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum &&
+                find -P -type l -print0 |LC_ALL=C sort -z |xargs -0 -r -n 1 readlink ) | md5sum
+    @endverbatim
+ *
+ *  but it is computed without starting a process per file, and, if a manifest file is given, the
+ *  hash of each file's contents is remembered there and only recomputed if the file has changed
+ *  (according to its inode number, size and status change time) since the last run.
+ *
+ *  Run 'mkmd5 --help' for command-line options and usage help.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include <fts.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string.h>
+#include <iostream>
+#include <algorithm>
+
+#include "mkTools.h"
+#include "commandLineInterpreter.h"
+
+
+namespace cli
+{
+
+
+/// Path to the directory to be hashed.
+static std::string DirPath;
+
+/// Path to the manifest file in which file hashes are cached, or empty if none.
+static std::string ManifestPath;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * What is remembered about a regular file, to tell whether its hash needs to be recomputed.
+ */
+//--------------------------------------------------------------------------------------------------
+struct FileInfo_t
+{
+    std::string md5;            ///< Hash of the file's contents.
+    unsigned long long inode;   ///< Inode number.
+    long long size;             ///< Size in bytes.
+    long long ctimeSec;         ///< Status change time (seconds).
+    long ctimeNsec;             ///< Status change time (nanoseconds).
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the command-line arguments and update the static operating parameters variables.
+ *
+ * Throws a std::runtime_error exception on failure.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void GetCommandLineArgs
+(
+    int argc,
+    const char** argv
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Lambda function that gets called once for each parameter not prefixed by an argument
+    // identifier.  There must be exactly one: the directory to hash.
+    auto dirPathSet = [&](const char* param)
+            {
+                if (DirPath != "")
+                {
+                    throw mk::Exception_t(LE_I18N("Only one directory allowed."));
+                }
+                DirPath = param;
+            };
+
+    args::AddOptionalString(&ManifestPath,
+                            "",
+                            'm',
+                            "manifest",
+                            LE_I18N("Specify a file in which to remember the hash of each file in"
+                                    " the directory, so that only files that have changed since"
+                                    " the last run need to be read again."));
+
+    args::SetLooseArgHandler(dirPathSet);
+
+    args::Scan(argc, argv);
+
+    if (DirPath == "")
+    {
+        throw mk::Exception_t(LE_I18N("A directory must be supplied."));
+    }
+
+    // Strip trailing slashes, so that fts reports paths relative to the directory in the same
+    // form as find does.
+    while ((DirPath.size() > 1) && (DirPath.back() == '/'))
+    {
+        DirPath.erase(--DirPath.end());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the file hashes saved in the manifest by a previous run, if there are any.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void LoadManifest
+(
+    std::map<std::string, FileInfo_t>& manifest ///< [out] File info, keyed by path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream manifestFile(ManifestPath);
+    if (!manifestFile.is_open())
+    {
+        return;
+    }
+
+    std::string line;
+
+    while (std::getline(manifestFile, line))
+    {
+        // <md5> <inode> <size> <ctime sec>.<ctime nsec> <path>
+        FileInfo_t info;
+        char md5[33];
+        int pathOffset = -1;
+
+        if (   (sscanf(line.c_str(),
+                       "%32s %llu %lld %lld.%ld %n",
+                       md5,
+                       &info.inode,
+                       &info.size,
+                       &info.ctimeSec,
+                       &info.ctimeNsec,
+                       &pathOffset) == 5)
+            && (pathOffset > 0))
+        {
+            info.md5 = md5;
+            manifest[line.substr(pathOffset)] = info;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the file hashes to the manifest for the next run.  The new manifest is written to a
+ * temporary file and renamed over the old one, so that an interrupted run can't leave a
+ * half-written manifest behind.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SaveManifest
+(
+    const std::map<std::string, FileInfo_t>& manifest  ///< File info, keyed by path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto tempPath = ManifestPath + ".tmp";
+
+    std::ofstream manifestFile(tempPath);
+    if (!manifestFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), tempPath)
+        );
+    }
+
+    for (auto& entry : manifest)
+    {
+        // Paths containing newlines can't be stored in a line-based file, so they always get
+        // rehashed.
+        if (entry.first.find('\n') != std::string::npos)
+        {
+            continue;
+        }
+
+        auto& info = entry.second;
+
+        manifestFile << info.md5 << ' '
+                     << info.inode << ' '
+                     << info.size << ' '
+                     << info.ctimeSec << '.' << info.ctimeNsec << ' '
+                     << entry.first << '\n';
+    }
+
+    manifestFile.close();
+    if (manifestFile.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to file '%s'."), tempPath)
+        );
+    }
+
+    if (rename(tempPath.c_str(), ManifestPath.c_str()) != 0)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to rename file '%s' to '%s' (%s)."),
+                       tempPath,
+                       ManifestPath,
+                       strerror(errno))
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the line that md5sum would print for a file.
+ *
+ * @return The line, including the trailing newline.
+ **/
+//--------------------------------------------------------------------------------------------------
+static std::string Md5sumLine
+(
+    const std::string& md5,
+    const std::string& filePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // md5sum escapes file names containing backslashes or line breaks, and flags the line with a
+    // leading backslash.
+    if (filePath.find_first_of("\\\n\r") == std::string::npos)
+    {
+        return md5 + "  " + filePath + '\n';
+    }
+
+    std::string escapedPath;
+
+    for (auto c : filePath)
+    {
+        switch (c)
+        {
+            case '\\':  escapedPath += "\\\\";  break;
+            case '\n':  escapedPath += "\\n";   break;
+            case '\r':  escapedPath += "\\r";   break;
+            default:    escapedPath += c;       break;
+        }
+    }
+
+    return '\\' + md5 + "  " + escapedPath + '\n';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the hash of the directory's contents.
+ *
+ * @return The hash, as a string of hex digits.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+static std::string HashDir
+(
+    const std::map<std::string, FileInfo_t>& oldManifest,  ///< File info from the last run.
+    std::map<std::string, FileInfo_t>& newManifest         ///< [out] File info for this run.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Paths relative to the directory, in "./x/y" form (as find prints them).
+    std::vector<std::string> allPaths;
+    std::vector<std::string> filePaths;
+    std::vector<std::string> linkPaths;
+
+    char* const rootPaths[] = { const_cast<char*>(DirPath.c_str()), NULL };
+
+    FTS* ftsPtr = fts_open(rootPaths, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+    if (ftsPtr == NULL)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open directory '%s' (%s)."), DirPath, strerror(errno))
+        );
+    }
+
+    FTSENT* entPtr;
+
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_DP:
+                // Directories are listed on the way down, not on the way back up.
+                continue;
+
+            case FTS_DNR:
+            case FTS_ERR:
+            case FTS_NS:
+            {
+                std::string errorPath(entPtr->fts_path);
+                int error = entPtr->fts_errno;
+                fts_close(ftsPtr);
+                throw mk::Exception_t(
+                    mk::format(LE_I18N("Failed to read '%s' (%s)."), errorPath, strerror(error))
+                );
+            }
+        }
+
+        std::string relPath = "." + std::string(entPtr->fts_path + DirPath.size());
+
+        allPaths.push_back(relPath);
+
+        if (entPtr->fts_info == FTS_F)
+        {
+            filePaths.push_back(relPath);
+        }
+        else if ((entPtr->fts_info == FTS_SL) || (entPtr->fts_info == FTS_SLNONE))
+        {
+            linkPaths.push_back(relPath);
+        }
+    }
+
+    int error = errno;
+    fts_close(ftsPtr);
+
+    if (error != 0)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to read directory '%s' (%s)."), DirPath, strerror(error))
+        );
+    }
+
+    // std::string compares bytewise, which is the same order as "LC_ALL=C sort".
+    std::sort(allPaths.begin(), allPaths.end());
+    std::sort(filePaths.begin(), filePaths.end());
+    std::sort(linkPaths.begin(), linkPaths.end());
+
+    MD5 hash;
+
+    for (auto& relPath : allPaths)
+    {
+        hash.update(relPath.c_str(), relPath.size() + 1);
+    }
+
+    for (auto& relPath : filePaths)
+    {
+        auto fullPath = DirPath + relPath.substr(1);
+
+        struct stat statBuf;
+        if (lstat(fullPath.c_str(), &statBuf) != 0)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to stat '%s' (%s)."), fullPath, strerror(errno))
+            );
+        }
+
+        FileInfo_t info;
+        info.inode = statBuf.st_ino;
+        info.size = statBuf.st_size;
+        info.ctimeSec = statBuf.st_ctim.tv_sec;
+        info.ctimeNsec = statBuf.st_ctim.tv_nsec;
+
+        auto i = oldManifest.find(relPath);
+
+        if (   (i != oldManifest.end())
+            && (i->second.inode == info.inode)
+            && (i->second.size == info.size)
+            && (i->second.ctimeSec == info.ctimeSec)
+            && (i->second.ctimeNsec == info.ctimeNsec))
+        {
+            info.md5 = i->second.md5;
+        }
+        else
+        {
+            info.md5 = file::GetMd5Hash(fullPath);
+        }
+
+        newManifest[relPath] = info;
+
+        auto line = Md5sumLine(info.md5, relPath);
+        hash.update(line.c_str(), line.size());
+    }
+
+    for (auto& relPath : linkPaths)
+    {
+        auto fullPath = DirPath + relPath.substr(1);
+
+        char target[PATH_MAX];
+        ssize_t length = readlink(fullPath.c_str(), target, sizeof(target));
+        if (length < 0)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to read symlink '%s' (%s)."), fullPath, strerror(errno))
+            );
+        }
+
+        hash.update(target, length);
+        hash.update("\n", 1);
+    }
+
+    return hash.finalize().hexdigest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the mkmd5 functionality.
+ */
+//--------------------------------------------------------------------------------------------------
+void MakeMd5
+(
+    int argc,           ///< Count of the number of command line parameters.
+    const char** argv   ///< Pointer to an array of pointers to command line argument strings.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    GetCommandLineArgs(argc, argv);
+
+    std::map<std::string, FileInfo_t> oldManifest;
+    std::map<std::string, FileInfo_t> newManifest;
+
+    if (!ManifestPath.empty())
+    {
+        LoadManifest(oldManifest);
+    }
+
+    auto md5 = HashDir(oldManifest, newManifest);
+
+    if (!ManifestPath.empty())
+    {
+        SaveManifest(newManifest);
+    }
+
+    std::cout << md5 << std::endl;
+}
+
+
+} // namespace cli
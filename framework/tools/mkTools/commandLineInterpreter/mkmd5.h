@@ -0,0 +1,22 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef MKMD5_H_INCLUDE_GUARD
+#define MKMD5_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the mkmd5 functionality.
+ */
+//--------------------------------------------------------------------------------------------------
+void MakeMd5
+(
+    int argc,           ///< Count of the number of command line parameters.
+    const char** argv   ///< Pointer to an array of pointers to command line argument strings.
+);
+
+
+#endif // MKMD5_H_INCLUDE_GUARD
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <iostream>
 #include <string.h>
@@ -39,6 +40,9 @@ static std::string SystemName;
 /// a new build.ninja.
 static bool DontRunNinja = false;
 
+/// Targets to build the system for, when more than one is given (e.g., "-t wp85,wp76").
+static std::vector<std::string> Targets;
+
 /// Steps to run to generate a Linux system
 static const generator::SystemGenerator_t LinuxSteps[] =
 {
@@ -153,7 +157,10 @@ static void GetCommandLineArgs
                             "localhost",
                             't',
                             "target",
-                            LE_I18N("Set the compile target (e.g., localhost or ar7)."));
+                            LE_I18N("Set the compile target (e.g., localhost or ar7).  Several"
+                                    " targets can be given, separated by commas (e.g.,"
+                                    " wp85,wp76), to build the system for all of them in a single"
+                                    " run of ninja."));
 
     args::AddOptionalFlag(&BuildParams.beVerbose,
                           'v',
@@ -184,7 +191,10 @@ static void GetCommandLineArgs
                                   " including a new copy of the build.ninja, then exit without"
                                   " running ninja.  This is used by the build.ninja to to"
                                   " regenerate itself and any other files that need to be"
-                                  " regenerated when the build.ninja finds itself out of date."));
+                                  " regenerated when the build.ninja finds itself out of date."
+                                  "  If the contents of the inputs and the environment are the"
+                                  " same as when the build.ninja was generated, it is just"
+                                  " marked as up to date instead."));
 
     args::AddOptionalFlag(&BuildParams.codeGenOnly,
                           'g',
@@ -196,6 +206,59 @@ static void GetCommandLineArgs
                                   " context-sensitive auto-complete and related features in"
                                   " source code editors, for example."));
 
+    args::AddOptionalFlag(&BuildParams.unityBuild,
+                          'U',
+                          "unity-build",
+                          LE_I18N("Compile each component's C source files in batches, each batch"
+                                  " as a single translation unit, with the headers that they all"
+                                  " include (legato.h and interfaces.h) precompiled.  This makes"
+                                  " components with many source files build faster, but source"
+                                  " files that define static variables or functions with the same"
+                                  " names will conflict with each other."));
+
+    args::AddOptionalString(&BuildParams.buildProfile,
+                            "",
+                            'O',
+                            "build-profile",
+                            LE_I18N("Build everything with a set of optimizations for size and"
+                                    " speed: 'size' (unused code and data removed at link time),"
+                                    " 'lto' (size, plus link-time optimization), 'pgo-generate'"
+                                    " (lto, plus instrumentation that records a profile of each"
+                                    " program as it runs) or 'pgo-use' (lto, plus optimization"
+                                    " using the recorded profiles).  The default is 'default'"
+                                    " (none of these)."));
+
+    args::AddOptionalString(&BuildParams.pgoDir,
+                            "",
+                            'P',
+                            "pgo-dir",
+                            LE_I18N("Directory for profile-guided optimization data.  With"
+                                    " 'pgo-generate', the directory on the target that the"
+                                    " profiles will be written to.  With 'pgo-use', the directory"
+                                    " on the build host that they have been copied to."));
+
+    args::AddOptionalString(&BuildParams.objCacheDir,
+                            "",
+                            'K',
+                            "obj-cache",
+                            LE_I18N("Directory of a cache of compiled object files, which can be"
+                                    " shared by any number of builds.  Source files are only"
+                                    " compiled if the cache doesn't already have the result of an"
+                                    " identical compile (same preprocessed source, flags and"
+                                    " compiler).  Defaults to the LEGATO_OBJ_CACHE environment"
+                                    " variable, if set."));
+
+    args::AddOptionalString(&BuildParams.logLevelFloor,
+                            "",
+                            'F',
+                            "log-level-floor",
+                            LE_I18N("Compile out log messages below this level: 'DEBUG', 'INFO',"
+                                    " 'WARNING', 'ERROR', 'CRITICAL' or 'EMERGENCY'.  Traces are"
+                                    " compiled out too, unless it is 'DEBUG'.  The level can still"
+                                    " be raised at runtime.  A component can override it by"
+                                    " defining LE_LOG_LEVEL_STATIC_FILTER in its cflags.  The"
+                                    " default is to compile all messages in."));
+
     // Any remaining parameters on the command-line are treated as the .sdef file path.
     // Note: there should only be one parameter not prefixed by an argument identifier.
     args::SetLooseArgHandler(sdefFileNameSet);
@@ -211,12 +274,40 @@ static void GetCommandLineArgs
     // Compute the system name from the .sdef file path.
     SystemName = path::RemoveSuffix(path::GetLastNode(SdefFilePath), ".sdef");
 
+    // Split up a list of targets.
+    if (BuildParams.target.find(',') != std::string::npos)
+    {
+        std::stringstream targetList(BuildParams.target);
+        std::string target;
+
+        while (std::getline(targetList, target, ','))
+        {
+            if (target.empty())
+            {
+                throw mk::Exception_t(
+                    mk::format(LE_I18N("Empty target name in target list '%s'."),
+                               BuildParams.target)
+                );
+            }
+            if (std::find(Targets.begin(), Targets.end(), target) == Targets.end())
+            {
+                Targets.push_back(target);
+            }
+        }
+    }
+
     // If we were not given a working directory (intermediate build output directory) path,
     // use a subdirectory of the current directory, and use a different working dir for
-    // different systems and for the same system built for different targets.
+    // different systems and for the same system built for different targets.  When building for
+    // several targets, the working dir holds a subdirectory for each target.
     if (BuildParams.workingDir == "")
     {
-        BuildParams.workingDir = "./_build_" + SystemName + "/" + BuildParams.target;
+        BuildParams.workingDir = "./_build_" + SystemName;
+
+        if (Targets.empty())
+        {
+            BuildParams.workingDir += "/" + BuildParams.target;
+        }
     }
     else if (BuildParams.workingDir.back() == '/')
     {
@@ -233,6 +324,210 @@ static void GetCommandLineArgs
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the command line for generating the build script of one of several targets: the same
+ * arguments, but for that target alone, with that target's own working directory, and without
+ * running ninja.
+ *
+ * @return The arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::vector<std::string> GetTargetArgs
+(
+    int argc,
+    const char** argv,
+    const std::string& target
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::vector<std::string> targetArgs = { argv[0] };
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if ((arg == "-t") || (arg == "-w"))
+        {
+            i++;
+        }
+        else if (   (arg.compare(0, 9, "--target=") != 0)
+                 && (arg.compare(0, 13, "--object-dir=") != 0)
+                 && (arg != "--dont-run-ninja"))
+        {
+            targetArgs.push_back(arg);
+        }
+    }
+
+    targetArgs.push_back("--target=" + target);
+    targetArgs.push_back("--object-dir=" + path::Combine(BuildParams.workingDir, target));
+    targetArgs.push_back("--dont-run-ninja");
+
+    return targetArgs;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the system for several targets.
+ *
+ * The system is modelled, and its build script generated, for each target separately (because
+ * the .sdef and the files it includes can differ from one target to another), by running mksys
+ * for all the targets at once.  Each target keeps its own working directory and build script,
+ * exactly as if it had been built alone.  Those build scripts are then combined into one, so a
+ * single run of ninja builds all of the targets in parallel, and brings each target's build script
+ * up to date itself.
+ *
+ * @throw mk::Exception_t if the build script of any of the targets couldn't be generated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MakeMultiTargetSystem
+(
+    int argc,           ///< Count of the number of command line parameters.
+    const char** argv   ///< Pointer to an array of pointers to command line argument strings.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::map<pid_t, std::string> children;
+
+    for (const auto& target : Targets)
+    {
+        auto targetArgs = GetTargetArgs(argc, argv, target);
+
+        std::vector<char*> childArgv;
+        for (auto& arg : targetArgs)
+        {
+            childArgv.push_back(&arg[0]);
+        }
+        childArgv.push_back(NULL);
+
+        if (BuildParams.beVerbose)
+        {
+            std::cout << mk::format(LE_I18N("Generating build script for target '%s'."), target)
+                      << std::endl;
+        }
+
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            execvp(childArgv[0], childArgv.data());
+            _exit(127);
+        }
+        else if (pid < 0)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to run mksys for target '%s' (%s)."),
+                           target,
+                           strerror(errno))
+            );
+        }
+
+        children[pid] = target;
+    }
+
+    std::string failedTarget;
+
+    while (!children.empty())
+    {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+
+        if (pid == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to wait for mksys (%s)."), strerror(errno))
+            );
+        }
+
+        auto childIter = children.find(pid);
+        if (childIter == children.end())
+        {
+            continue;
+        }
+
+        if ((!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) && failedTarget.empty())
+        {
+            failedTarget = childIter->second;
+        }
+
+        children.erase(childIter);
+    }
+
+    if (!failedTarget.empty())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to generate the build script for target '%s'."),
+                       failedTarget)
+        );
+    }
+
+    // Generate the combined build script.  It regenerates itself (after the targets' scripts
+    // have regenerated themselves, if needed) by running this again.
+    auto ninjaFilePath = path::Combine(BuildParams.workingDir, "build.ninja");
+
+    file::MakeDir(BuildParams.workingDir);
+
+    std::ofstream script(ninjaFilePath);
+    if (!script.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), ninjaFilePath)
+        );
+    }
+
+    script << "# Build script for system '" << SystemName << "' for several targets\n"
+              "\n"
+              "# == Auto-generated file.  Do not edit. ==\n"
+              "\n"
+              "rule RegenMultiTargetScript\n"
+              "  description = Regenerating multi-target build script\n"
+              "  generator = 1\n"
+              "  command = " << argv[0] << " --dont-run-ninja";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--dont-run-ninja") != 0)
+        {
+            script << " \"" << argv[i] << '"';
+        }
+    }
+    script << "\n"
+              "\n";
+
+    for (const auto& target : Targets)
+    {
+        script << "subninja " << path::Combine(path::Combine(BuildParams.workingDir, target),
+                                               "build.ninja") << "\n";
+    }
+
+    script << "\nbuild " << ninjaFilePath << ": RegenMultiTargetScript |";
+    for (const auto& target : Targets)
+    {
+        script << " " << path::Combine(path::Combine(BuildParams.workingDir, target),
+                                       "build.ninja");
+    }
+    script << "\n";
+
+    script.close();
+    if (script.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to file '%s'."), ninjaFilePath)
+        );
+    }
+
+    // If we haven't been asked not to, run ninja.
+    if (!DontRunNinja)
+    {
+        RunNinja(BuildParams);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Implements the mksys functionality.
@@ -247,6 +542,12 @@ void MakeSystem
 {
     GetCommandLineArgs(argc, argv);
 
+    if (!Targets.empty())
+    {
+        MakeMultiTargetSystem(argc, argv);
+        return;
+    }
+
     BuildParams.argc = argc;
     BuildParams.argv = argv;
 
@@ -254,16 +555,34 @@ void MakeSystem
     // (Must be done after command-line args parsing and before setting target-specific env vars.)
     FindToolChain(BuildParams);
 
+    // Work out the compiler and linker flags for the build profile.
+    ApplyBuildProfile(BuildParams);
+    ApplyLogLevelFloor(BuildParams);
+
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
     // Compute the staging directory path.
     auto stagingDir = path::Combine(BuildParams.workingDir, "staging");
 
-    // If we have been asked not to run Ninja, then delete the staging area because it probably
-    // will contain some of the wrong files now that .Xdef file have changed.
+    // Take note of the arguments and environment variables before parsing changes them.
+    inputs::RecordSettings(BuildParams);
+
+    // If we have been asked not to run Ninja, ninja wants its build.ninja regenerated because a
+    // file it depends on looks newer.  If none of the input files' contents have actually changed,
+    // the existing build.ninja is still right, so just mark it as up to date.  Otherwise, delete
+    // the staging area because it probably will contain some of the wrong files now that .Xdef
+    // file have changed.
     if (DontRunNinja)
     {
+        auto ninjaFilePath = path::Combine(BuildParams.workingDir, "build.ninja");
+
+        if (file::FileExists(ninjaFilePath) && inputs::MatchesSaved(BuildParams))
+        {
+            file::Touch(ninjaFilePath);
+            return;
+        }
+
         file::DeleteDir(stagingDir);
     }
     // If we have not been asked to ignore any already existing build.ninja, and the command-line
@@ -308,6 +627,9 @@ void MakeSystem
     // Now delete the appPtr
     delete systemPtr;
 
+    // Remember what the build.ninja was generated from.
+    inputs::Save(BuildParams);
+
     // If we haven't been asked not to, run ninja.
     if (!DontRunNinja)
     {
@@ -320,7 +320,8 @@ ApiClientInterface_t::ApiClientInterface_t
 //--------------------------------------------------------------------------------------------------
 :   ApiRef_t(aPtr, cPtr, iName),
     manualStart(false),
-    optional(false)
+    optional(false),
+    async(false)
 //--------------------------------------------------------------------------------------------------
 {
 }
@@ -338,12 +339,22 @@ void ApiClientInterface_t::GetInterfaceFiles
 const
 //--------------------------------------------------------------------------------------------------
 {
-    std::string codeGenDir = path::Combine(apiFilePtr->codeGenDir, "client/");
+    std::string codeGenDir;
+
+    if (async)
+    {
+        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "async_client/");
+    }
+    else
+    {
+        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "client/");
+    }
 
     cFiles.interfaceFile = codeGenDir + internalName + "_interface.h";
     cFiles.internalHFile = codeGenDir + internalName + "_messages.h";
     cFiles.sourceFile = codeGenDir + internalName + "_client.c";
     cFiles.objectFile = codeGenDir + internalName + "_client.c.o";
+    cFiles.cppInterfaceFile = codeGenDir + internalName + "_interface.hpp";
 }
 
 
@@ -414,6 +425,7 @@ const
     cFiles.internalHFile = codeGenDir + internalName + "_messages.h";
     cFiles.sourceFile = codeGenDir + internalName + "_server.c";
     cFiles.objectFile = codeGenDir + internalName + "_server.o";
+    cFiles.cppInterfaceFile = codeGenDir + internalName + "_server.hpp";
 }
 
 
@@ -79,6 +79,7 @@ struct InterfaceCFiles_t
     std::string internalHFile;  ///< local.h file that gets included by generated .c code.
     std::string sourceFile;     ///< Generated .c file.
     std::string objectFile;     ///< Path to the .o file for this interface.
+    std::string cppInterfaceFile;   ///< .hpp file with the C++ wrappers or server class.
 };
 
 
@@ -141,6 +142,7 @@ struct ApiClientInterface_t : public ApiRef_t
 {
     bool manualStart;   ///< true = generated main() should not call the ConnectService() function.
     bool optional;      ///< true = okay to not be bound.
+    bool async;         ///< true = asynchronous (batchable) functions should also be generated.
 
     ApiClientInterface_t(ApiFile_t* aPtr, Component_t* cPtr, const std::string& iName);
 
@@ -320,4 +320,22 @@ const
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path to the app's launch descriptor file (see config::Generate()) relative to the
+ * build's working directory.
+ *
+ * @return the file path.
+ */
+//--------------------------------------------------------------------------------------------------
+std::string App_t::LaunchDescriptorFilePath
+(
+)
+const
+//--------------------------------------------------------------------------------------------------
+{
+    return workingDir + "/staging/launch.bin";
+}
+
+
 } // namespace modeller
@@ -109,6 +109,9 @@ struct App_t : public HasTargetInfo_t
 
     // Get the path to the app's root.cfg file relative to the build's working directory.
     std::string ConfigFilePath() const;
+
+    // Get the path to the app's launch descriptor file relative to the build's working directory.
+    std::string LaunchDescriptorFilePath() const;
 };
 
 
@@ -26,6 +26,8 @@ struct Component_t : public HasTargetInfo_t
 
     std::list<ObjectFile_t*> cObjectFiles;  ///< List of .o files to build from C source files.
     std::list<ObjectFile_t*> cxxObjectFiles;///< List of .o files to build from C++ source files.
+    std::list<UnityFile_t*> cUnityFiles;    ///< Unity build sources replacing cObjectFiles (only
+                                            ///< if building with --unity-build).
     std::list<JavaPackage_t*> javaPackages; ///< List of packages of Java code.
     std::list<std::string> externalBuildCommands; ///< List of external build commands.
 
@@ -20,4 +20,19 @@ struct ObjectFile_t
 };
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A generated C source file that #includes a batch of other C source files, so that they are all
+ * compiled as one translation unit (a "unity" or "jumbo" build).
+ */
+//--------------------------------------------------------------------------------------------------
+struct UnityFile_t : public ObjectFile_t
+{
+    std::list<const ObjectFile_t*> members; ///< Object files whose source files it includes.
+
+    UnityFile_t(const std::string& p, const std::string& s)
+        : ObjectFile_t(p, s) {}
+};
+
+
 #endif // LEGATO_MKTOOLS_MODEL_OBJECT_FILE_H_INCLUDE_GUARD
@@ -442,6 +442,48 @@ static std::string GenerateClassPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the command-line argument list of a process, the first argument being the executable to run.
+ *
+ * @return The argument list.
+ **/
+//--------------------------------------------------------------------------------------------------
+static std::vector<std::string> GetProcessArgs
+(
+    const model::App_t* appPtr,
+    const model::Process_t* procPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::vector<std::string> args;
+
+    // Look try to find a matching executable definition in the model.  If it is found then
+    // check to see if it's a Java executable.  If it is a Java executable, then modify the
+    // run parameters to properly invoke the JVM.  Note that it is possible to run an
+    // executable that is not defined in the model, like for instance you might want to
+    // bind in a web server to serve web pages from your app.
+    auto exePtr = FindExecutable(appPtr, procPtr->exePath);
+
+    if (   (exePtr != nullptr)
+        && (exePtr->hasJavaCode))
+    {
+        args.push_back("java");
+        args.push_back("-cp");
+        args.push_back(GenerateClassPath(exePtr));
+        args.push_back("io.legato.generated.exe." + procPtr->exePath + ".Main");
+    }
+    else
+    {
+        args.push_back(procPtr->exePath);
+    }
+
+    args.insert(args.end(), procPtr->commandLineArgs.begin(), procPtr->commandLineArgs.end());
+
+    return args;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate the configuration for all the processes that the Supervisor should start when the
@@ -471,33 +513,8 @@ static void GenerateProcessConfig
             cfgStream << "      \"args\"" << std::endl;
             cfgStream << "      {" << std::endl;
 
-
-            // Look try to find a matching executable definition in the model.  If it is found then
-            // check to see if it's a Java executable.  If it is a Java executable, then modify the
-            // run parameters to properly invoke the JVM.  Note that it is possible to run an
-            // executable that is not defined in the model, like for instance you might want to
-            // bind in a web server to serve web pages from your app.
-            int argIndex;
-            auto exePtr = FindExecutable(appPtr, procPtr->exePath);
-
-            if (   (exePtr != nullptr)
-                && (exePtr->hasJavaCode))
-            {
-                cfgStream << "        \"0\" \"java\"" << std::endl
-                          << "        \"1\" \"-cp\"" << std::endl
-                          << "        \"2\" \"" << GenerateClassPath(exePtr) << "\"" << std::endl
-                          << "        \"3\" \"io.legato.generated.exe."
-                          << procPtr->exePath << ".Main" << "\"" << std::endl;
-                argIndex = 4;
-            }
-            else
-            {
-                cfgStream << "        \"0\" \"" << path::EscapeQuotes(procPtr->exePath) << "\""
-                          << std::endl;
-                argIndex = 1;
-            }
-
-            for (const auto& arg : procPtr->commandLineArgs)
+            int argIndex = 0;
+            for (const auto& arg : GetProcessArgs(appPtr, procPtr))
             {
                 cfgStream << "        \"" << argIndex << "\" \"" << path::EscapeQuotes(arg) << "\""
                           << std::endl;
@@ -771,6 +788,115 @@ static void GenerateAppWatchdogConfig
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a 32-bit integer to a binary file (launch descriptor or binding table), in little-endian
+ * byte order.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void WriteUint32
+(
+    std::ofstream& binStream,
+    uint32_t value
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (int i = 0; i < 4; i++)
+    {
+        binStream.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string to a launch descriptor: its length, followed by its bytes and a null-terminator.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void WriteLaunchDescString
+(
+    std::ofstream& descStream,
+    const std::string& str
+)
+//--------------------------------------------------------------------------------------------------
+{
+    WriteUint32(descStream, str.size());
+    descStream.write(str.c_str(), str.size() + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the launch descriptor of an app: a compact binary copy of the settings the Supervisor
+ * needs to start the app's processes, so that it doesn't have to read them one by one from the
+ * config tree.  It will be output to a file called "launch.bin" in the app's staging directory.
+ *
+ * The format is described in the Supervisor's launchDesc.h.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void GenerateLaunchDescriptor
+(
+    const model::App_t* appPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string filePath = path::Combine(buildParams.workingDir,
+                                         appPtr->LaunchDescriptorFilePath());
+
+    std::ofstream descStream(filePath, std::ofstream::trunc | std::ofstream::binary);
+
+    if (descStream.is_open() == false)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
+        );
+    }
+
+    uint32_t numProcs = 0;
+    for (auto procEnvPtr : appPtr->processEnvs)
+    {
+        numProcs += procEnvPtr->processes.size();
+    }
+
+    descStream.write("LELD", 4);
+    WriteUint32(descStream, 1);
+    WriteUint32(descStream, numProcs);
+
+    for (auto procEnvPtr : appPtr->processEnvs)
+    {
+        auto& startPriority = procEnvPtr->GetStartPriority();
+
+        for (auto procPtr : procEnvPtr->processes)
+        {
+            WriteLaunchDescString(descStream, procPtr->GetName());
+            WriteLaunchDescString(descStream, startPriority.IsSet() ? startPriority.Get() : "");
+
+            auto args = GetProcessArgs(appPtr, procPtr);
+            WriteUint32(descStream, args.size());
+            for (const auto& arg : args)
+            {
+                WriteLaunchDescString(descStream, arg);
+            }
+
+            WriteUint32(descStream, procEnvPtr->envVars.size());
+            for (const auto& pair : procEnvPtr->envVars)
+            {
+                WriteLaunchDescString(descStream, pair.first);
+                WriteLaunchDescString(descStream, pair.second);
+            }
+        }
+    }
+
+    if (!descStream.good())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to '%s'."), filePath)
+        );
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate the configuration that the framework needs for a given app.  This is the configuration
@@ -786,6 +912,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("configGenerator", appPtr->name);
+
     std::string filePath = path::Combine(buildParams.workingDir, appPtr->ConfigFilePath());
 
     file::MakeDir(path::GetContainingDir(filePath));
@@ -824,7 +952,12 @@ void Generate
 
     GenerateAppWatchdogConfig(cfgStream, appPtr);
 
+    // Tell the Supervisor to start the processes with the settings of the launch descriptor.
+    cfgStream << "  \"launchDescriptor\" !t" << std::endl;
+
     cfgStream << "}" << std::endl;
+
+    GenerateLaunchDescriptor(appPtr, buildParams);
 }
 
 
@@ -1027,12 +1160,233 @@ static void GenerateAppsConfig
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC binding of the system's binding table, with the client and server user names resolved.
+ */
+//--------------------------------------------------------------------------------------------------
+struct TableBinding_t
+{
+    std::string clientUser;     ///< Client's user name.
+    std::string clientIf;       ///< Client's interface name.
+    std::string serverUser;     ///< Server's user name.
+    std::string serverIf;       ///< Server's interface (service) name.
+    std::string clientApp;      ///< Client's app name, or empty for a non-app user.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of the user an app of the system runs as.  Unsandboxed apps run as root.  Apps
+ * that are not in the system are assumed to be sandboxed, as the Service Directory does.
+ *
+ * @return The user name.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string GetAppUserName
+(
+    const model::System_t* systemPtr,
+    const std::string& appName
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto i = systemPtr->apps.find(appName);
+
+    if ((i != systemPtr->apps.end()) && !i->second->isSandboxed)
+    {
+        return "root";
+    }
+
+    return "app" + appName;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a binding to the system's binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddTableBinding
+(
+    std::vector<TableBinding_t>& bindings,  ///< The binding table being built.
+    const model::System_t* systemPtr,
+    const std::string& clientUser,
+    const std::string& clientApp,           ///< Client's app name, or empty for a non-app user.
+    const model::Binding_t* bindingPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TableBinding_t binding;
+
+    binding.clientUser = clientUser;
+    binding.clientIf = bindingPtr->clientIfName;
+    binding.serverIf = bindingPtr->serverIfName;
+    binding.clientApp = clientApp;
+
+    switch (bindingPtr->serverType)
+    {
+        case model::Binding_t::INTERNAL:        // Binding to another exe inside the same app.
+        case model::Binding_t::EXTERNAL_APP:    // Binding to an executable inside another app.
+
+            binding.serverUser = GetAppUserName(systemPtr, bindingPtr->serverAgentName);
+            break;
+
+        case model::Binding_t::EXTERNAL_USER:  // Binding to an executable running outside all apps.
+
+            binding.serverUser = bindingPtr->serverAgentName;
+            break;
+    }
+
+    bindings.push_back(binding);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the system's binding table: a compact binary copy of the IPC bindings of all the
+ * system's apps and non-app users, sorted by client user and interface name, that the Service
+ * Directory loads in one pass at start-up instead of receiving the bindings one by one.  It will
+ * be output to a file called "bindings.bin" in the "config" directory under the system's
+ * staging directory.
+ *
+ * The bindings are the same as in "apps.cfg" and "users.cfg".  The format is described in
+ * liblegato's bindingTable.h.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void GenerateBindingTable
+(
+    model::System_t* systemPtr,     ///< The system to generate the binding table for.
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string filePath = path::Combine(buildParams.workingDir, "staging/config/bindings.bin");
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Generating IPC binding table in file '%s'."), filePath)
+                  << std::endl;
+    }
+
+    std::vector<TableBinding_t> bindings;
+
+    for (auto& mapEntry : systemPtr->users)
+    {
+        auto userPtr = mapEntry.second;
+
+        for (auto& bindingEntry : userPtr->bindings)
+        {
+            AddTableBinding(bindings, systemPtr, userPtr->name, "", bindingEntry.second);
+        }
+    }
+
+    for (auto& mapEntry : systemPtr->apps)
+    {
+        auto appPtr = mapEntry.second;
+        auto clientUser = GetAppUserName(systemPtr, appPtr->name);
+
+        // Same bindings as generated by GenerateBindingsConfig().
+        if (buildParams.target != "localhost")
+        {
+            TableBinding_t binding = { clientUser, "LogClient", "root", "LogClient", appPtr->name };
+            bindings.push_back(binding);
+        }
+
+        for (const auto& exeEntry : appPtr->executables)
+        {
+            for (const auto& componentInstancePtr : exeEntry.second->componentInstances)
+            {
+                for (const auto& interfacePtr : componentInstancePtr->clientApis)
+                {
+                    if (interfacePtr->bindingPtr != NULL)
+                    {
+                        AddTableBinding(bindings, systemPtr, clientUser, appPtr->name,
+                                        interfacePtr->bindingPtr);
+                    }
+                }
+            }
+        }
+        for (const auto& ifEntry : appPtr->preBuiltClientInterfaces)
+        {
+            if (ifEntry.second->bindingPtr != NULL)
+            {
+                AddTableBinding(bindings, systemPtr, clientUser, appPtr->name,
+                                ifEntry.second->bindingPtr);
+            }
+        }
+    }
+
+    std::stable_sort(bindings.begin(), bindings.end(),
+                     [](const TableBinding_t& a, const TableBinding_t& b)
+                     {
+                         return (a.clientUser < b.clientUser) ||
+                                ((a.clientUser == b.clientUser) && (a.clientIf < b.clientIf));
+                     });
+
+    // Build the string area, storing each distinct string only once.
+    std::string strings;
+    std::map<std::string, uint32_t> stringOffsets;
+    auto addString = [&strings, &stringOffsets](const std::string& str)
+    {
+        auto result = stringOffsets.insert(std::make_pair(str, strings.size()));
+        if (result.second)
+        {
+            strings.append(str);
+            strings.push_back('\0');
+        }
+        return result.first->second;
+    };
+
+    // The string area always ends with a null, even if there are no bindings.
+    addString("");
+
+    std::vector<uint32_t> offsets;
+    for (const auto& binding : bindings)
+    {
+        offsets.push_back(addString(binding.clientUser));
+        offsets.push_back(addString(binding.clientIf));
+        offsets.push_back(addString(binding.serverUser));
+        offsets.push_back(addString(binding.serverIf));
+        offsets.push_back(addString(binding.clientApp));
+    }
+
+    std::ofstream tableStream(filePath, std::ofstream::trunc | std::ofstream::binary);
+
+    if (tableStream.is_open() == false)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
+        );
+    }
+
+    tableStream.write("LEBT", 4);
+    WriteUint32(tableStream, 1);
+    WriteUint32(tableStream, bindings.size());
+    WriteUint32(tableStream, strings.size());
+
+    for (auto offset : offsets)
+    {
+        WriteUint32(tableStream, offset);
+    }
+
+    tableStream.write(strings.data(), strings.size());
+
+    if (!tableStream.good())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to '%s'."), filePath)
+        );
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate the configuration that the framework needs for a given system.  This is the
  * configuration that will be installed in the system configuration tree by the installer when
  * the system starts for the first time on the target.  It will be output to two files called
- * "apps.cfg" and "users.cfg" in the "config" directory under the system's staging directory.
+ * "apps.cfg" and "users.cfg" in the "config" directory under the system's staging directory,
+ * along with the system's IPC binding table "bindings.bin".
  *
  * @note This assumes that the "root.cfg" config files for all the apps have already been
  *       generated in the apps' staging directories.
@@ -1045,6 +1399,8 @@ void Generate
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("configGenerator", systemPtr->name);
+
     file::MakeDir(path::Combine(buildParams.workingDir, "staging/config"));
 
     GenerateModulesConfig(systemPtr, buildParams);
@@ -1052,6 +1408,8 @@ void Generate
     GenerateUsersConfig(systemPtr, buildParams);
 
     GenerateAppsConfig(systemPtr, buildParams);
+
+    GenerateBindingTable(systemPtr, buildParams);
 }
 
 
@@ -33,7 +33,8 @@ void Generate
  * Generate the configuration that the framework needs for a given system.  This is the
  * configuration that will be installed in the system configuration tree by the installer when
  * the system starts for the first time on the target.  It will be output to two files called
- * "apps.cfg" and "users.cfg" in the "config" directory under the system's staging directory.
+ * "apps.cfg" and "users.cfg" in the "config" directory under the system's staging directory,
+ * along with the system's IPC binding table "bindings.bin".
  *
  * @note This assumes that the "root.cfg" config files for all the apps have already been
  *       generated in the apps' staging directories.
@@ -19,6 +19,38 @@ namespace envVars
 {
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment variables overridden for the current thread only.  See SetForThread().
+ */
+//--------------------------------------------------------------------------------------------------
+static thread_local std::map<std::string, std::string> ThreadVars;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up an environment variable, preferring the current thread's override of it.
+ *
+ * @return  Pointer to the value, or nullptr if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* Lookup
+(
+    const std::string& name  ///< The name of the environment variable.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto i = ThreadVars.find(name);
+
+    if (i != ThreadVars.end())
+    {
+        return i->second.c_str();
+    }
+
+    return getenv(name.c_str());
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetch the value of a given optional environment variable.
@@ -32,7 +64,7 @@ std::string Get
 )
 //--------------------------------------------------------------------------------------------------
 {
-    const char* value = getenv(name.c_str());
+    const char* value = Lookup(name);
 
     if (value == nullptr)
     {
@@ -58,7 +90,7 @@ std::string GetRequired
 )
 //--------------------------------------------------------------------------------------------------
 {
-    const char* value = getenv(name.c_str());
+    const char* value = Lookup(name);
 
     if (value == nullptr)
     {
@@ -93,6 +125,38 @@ void Set
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Override the value of a given environment variable for the calling thread only.  The process's
+ * environment is left untouched.
+ */
+//--------------------------------------------------------------------------------------------------
+void SetForThread
+(
+    const std::string& name,  ///< The name of the environment variable.
+    const std::string& value  ///< The value the calling thread should see.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ThreadVars[name] = value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop all the environment variable overrides made by the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ClearForThread
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ThreadVars.clear();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set compiler, linker, etc. environment variables according to the target device type, if they're
@@ -362,7 +426,7 @@ std::string DoSubstitution
             // The end of the string terminates the environment variable name.
             // Look up the environment variable, and if found, add its value to the result.
             {
-                const char* envVarPtr = getenv(envVarName.c_str());
+                const char* envVarPtr = Lookup(envVarName);
                 if (envVarPtr != NULL)
                 {
                     result += envVarPtr;
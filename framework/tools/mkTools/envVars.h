@@ -56,6 +56,32 @@ void Set
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Override the value of a given environment variable for the calling thread only.  Get() and
+ * DoSubstitution() called on this thread will see the override instead of the process's
+ * environment, which lets the definition file parsers run on several threads at once, each with
+ * its own CURDIR.  The process's environment is left untouched.
+ */
+//--------------------------------------------------------------------------------------------------
+void SetForThread
+(
+    const std::string& name,  ///< The name of the environment variable.
+    const std::string& value  ///< The value the calling thread should see.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop all the environment variable overrides made by the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ClearForThread
+(
+    void
+);
+
+
 //----------------------------------------------------------------------------------------------
 /**
  * Adds target-specific environment variables (e.g., LEGATO_TARGET) to the process's environment.
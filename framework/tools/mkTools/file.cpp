@@ -13,6 +13,7 @@
 #include <limits.h>
 #include <fts.h>
 #include <stdlib.h>
+#include <utime.h>
 
 #include "mkTools.h"
 
@@ -307,11 +308,11 @@ void MakeDir
         }
 
         int status = mkdir(path.c_str(), mode);
+        int err = errno;
 
-        if (status != 0)
+        // Another thread may have created it in the meantime.
+        if ((status != 0) && !((err == EEXIST) && DirectoryExists(path)))
         {
-            int err = errno;
-
             throw mk::Exception_t(
                 mk::format(LE_I18N("Failed to create directory '%s' (%s)"), path, strerror(err))
             );
@@ -320,6 +321,73 @@ void MakeDir
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a directory and everything in it, without following symlinks.  (Equivalent to
+ * 'rm -rf', but without starting a shell.)
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DeleteTree
+(
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char* const rootPaths[] = { const_cast<char*>(path.c_str()), NULL };
+
+    FTS* ftsPtr = fts_open(rootPaths, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+    if (ftsPtr == NULL)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to delete directory at '%s' (%s)."), path, strerror(errno))
+        );
+    }
+
+    FTSENT* entPtr;
+
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        int result = 0;
+
+        switch (entPtr->fts_info)
+        {
+            case FTS_D:
+                // Directories are deleted on the way back up, once they are empty.
+                continue;
+
+            case FTS_DP:
+                result = rmdir(entPtr->fts_accpath);
+                break;
+
+            case FTS_DNR:
+            case FTS_ERR:
+            case FTS_NS:
+                errno = entPtr->fts_errno;
+                result = -1;
+                break;
+
+            default:
+                result = unlink(entPtr->fts_accpath);
+                break;
+        }
+
+        if ((result != 0) && (errno != ENOENT))
+        {
+            std::string errorPath(entPtr->fts_path);
+            int error = errno;
+            fts_close(ftsPtr);
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to delete '%s' (%s)."), errorPath, strerror(error))
+            );
+        }
+    }
+
+    fts_close(ftsPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Recursively delete a directory.  That is, delete everything in the directory,
@@ -338,6 +406,8 @@ void DeleteDir
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("io", "Delete " + path);
+
     struct stat statBuffer;
 
     if (path == "")
@@ -351,15 +421,7 @@ void DeleteDir
         // If it's a directory, delete it.
         if (S_ISDIR(statBuffer.st_mode))
         {
-            std::string commandLine = "rm -rf " + path;
-            int result = system(commandLine.c_str());
-            if (result != EXIT_SUCCESS)
-            {
-                throw mk::Exception_t(
-                    mk::format(LE_I18N("Failed to execute command '%s' result: %d"),
-                               commandLine, result)
-                );
-            }
+            DeleteTree(path);
         }
         else
         {
@@ -408,13 +470,11 @@ void DeleteFile
         // If it's a regular file, delete it.
         if (S_ISREG(statBuffer.st_mode))
         {
-            std::string commandLine = "rm -f " + path;
-            int result = system(commandLine.c_str());
-            if (result != EXIT_SUCCESS)
+            if ((unlink(path.c_str()) != 0) && (errno != ENOENT))
             {
                 throw mk::Exception_t(
-                    mk::format(LE_I18N("Failed to execute command '%s' result: %d"),
-                               commandLine, result)
+                    mk::format(LE_I18N("Failed to delete file at '%s' (%s)."),
+                               path, strerror(errno))
                 );
             }
         }
@@ -434,4 +494,127 @@ void DeleteFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's contents.
+ *
+ * @return The hash, as a string of 32 hex digits.
+ *
+ * @throw mk::Exception_t if the file can't be read.
+ **/
+//--------------------------------------------------------------------------------------------------
+std::string GetMd5Hash
+(
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    profile::Scope_t profileScope("io", "Hash " + path);
+
+    std::ifstream inputFile(path, std::ios::binary);
+    if (!inputFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for reading."), path)
+        );
+    }
+
+    MD5 hash;
+    char buffer[16 * 1024];
+
+    while (inputFile.read(buffer, sizeof(buffer)) || (inputFile.gcount() > 0))
+    {
+        hash.update(buffer, inputFile.gcount());
+    }
+
+    if (inputFile.bad())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to read from file '%s'."), path)
+        );
+    }
+
+    return hash.finalize().hexdigest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the modification time of a file to now, so that ninja sees it as up to date.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+void Touch
+(
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (utime(path.c_str(), NULL) != 0)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to update the modification time of '%s' (%s)."),
+                       path, strerror(errno))
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a file's contents, unless the file already has exactly those contents, in which case it
+ * is left alone so that its modification time doesn't make ninja rebuild what depends on it.
+ *
+ * @return true if the file was written, false if it was already up to date.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool WriteIfChanged
+(
+    const std::string& path,
+    const std::string& contents
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat fileInfo;
+
+    // Only bother reading the old contents if they're the right size.
+    if (   (stat(path.c_str(), &fileInfo) == 0)
+        && S_ISREG(fileInfo.st_mode)
+        && ((size_t)fileInfo.st_size == contents.size()))
+    {
+        std::ifstream oldFile(path, std::ios::binary);
+        std::string oldContents(contents.size(), '\0');
+
+        if (   oldFile.read(&oldContents[0], oldContents.size())
+            && (oldContents == contents))
+        {
+            return false;
+        }
+    }
+
+    std::ofstream newFile(path, std::ios::binary | std::ios::trunc);
+    if (!newFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), path)
+        );
+    }
+
+    newFile << contents;
+
+    newFile.close();
+    if (newFile.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to file '%s'."), path)
+        );
+    }
+
+    return true;
+}
+
+
 } // namespace file
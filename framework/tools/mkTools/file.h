@@ -173,6 +173,51 @@ void DeleteFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's contents.
+ *
+ * @return The hash, as a string of 32 hex digits.
+ *
+ * @throw mk::Exception_t if the file can't be read.
+ **/
+//--------------------------------------------------------------------------------------------------
+std::string GetMd5Hash
+(
+    const std::string& path
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the modification time of a file to now, so that ninja sees it as up to date.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+void Touch
+(
+    const std::string& path
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a file's contents, unless the file already has exactly those contents, in which case it
+ * is left alone so that its modification time doesn't make ninja rebuild what depends on it.
+ *
+ * @return true if the file was written, false if it was already up to date.
+ *
+ * @throw mk::Exception_t if something goes wrong.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool WriteIfChanged
+(
+    const std::string& path,
+    const std::string& contents
+);
+
+
 } // namespace file
 
 #endif // LEGATO_MKTOOLS_FILE_H_INCLUDE_GUARD
@@ -0,0 +1,291 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file inputs.cpp
+ *
+ * Tracking of the input files read while building the model.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+#include <string.h>
+#include <mutex>
+
+/// The standard C environment variable list.
+extern char**environ;
+
+
+namespace inputs
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash of the command-line arguments and environment variables the build started with.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string SettingsMd5;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths of all the input files read so far, and the mutex that protects them (the parsers can
+ * run on several threads at once).
+ */
+//--------------------------------------------------------------------------------------------------
+static std::set<std::string> InputFiles;
+static std::mutex InputFilesMutex;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file system path to the file in which the input hashes are saved.
+ **/
+//--------------------------------------------------------------------------------------------------
+static std::string GetSaveFilePath
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return path::Combine(buildParams.workingDir, "mktool_inputs");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's contents.
+ *
+ * @return The hash, or an empty string if the file can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string GetFileMd5
+(
+    const std::string& filePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    try
+    {
+        return file::GetMd5Hash(filePath);
+    }
+    catch (mk::Exception_t&)
+    {
+        return "";
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take note of the command-line arguments and environment variables that the build starts with.
+ * Must be called before any definition files are parsed, as parsing changes the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+void RecordSettings
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    MD5 hash;
+
+    // The arguments, leaving out the one that ninja adds when it asks for build.ninja to be
+    // regenerated.
+    for (int i = 0; i < buildParams.argc; i++)
+    {
+        if (   (strcmp(buildParams.argv[i], "--dont-run-ninja") != 0)
+            && (strcmp(buildParams.argv[i], "-n") != 0))
+        {
+            hash.update(buildParams.argv[i], strlen(buildParams.argv[i]) + 1);
+        }
+    }
+
+    // The environment variables, leaving out CURDIR, which is always set by the modellers before
+    // it's used.
+    for (int i = 0; environ[i] != NULL; i++)
+    {
+        if (strncmp(environ[i], "CURDIR=", 7) != 0)
+        {
+            hash.update(environ[i], strlen(environ[i]) + 1);
+        }
+    }
+
+    SettingsMd5 = hash.finalize().hexdigest();
+
+    // A different version of the mk tools may build a different model from the same files.
+    auto toolPath = path::Combine(envVars::Get("LEGATO_ROOT"), "build/tools/mk");
+    if (file::FileExists(toolPath))
+    {
+        Add(toolPath);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that a file has been read as an input to the model.  May be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void Add
+(
+    const std::string& filePath ///< Path to the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(InputFilesMutex);
+
+    InputFiles.insert(path::MakeAbsolute(filePath));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the hashes of the settings and of every input file recorded so far (in a file in the
+ * build's working directory) for later use by MatchesSaved().
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    profile::Scope_t profileScope("io", "Save input hashes");
+
+    auto filePath = GetSaveFilePath(buildParams);
+
+    // Make sure the containing directory exists.
+    file::MakeDir(buildParams.workingDir);
+
+    // Open the file
+    std::ofstream saveFile(filePath);
+    if (!saveFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
+        );
+    }
+
+    // The first line is the hash of the settings, followed by a line for each input file,
+    // giving the hash of its contents and its path.
+    saveFile << SettingsMd5 << '\n';
+
+    std::lock_guard<std::mutex> lock(InputFilesMutex);
+
+    for (auto& inputPath : InputFiles)
+    {
+        auto inputMd5 = GetFileMd5(inputPath);
+
+        saveFile << (inputMd5.empty() ? "-" : inputMd5) << ' ' << inputPath << '\n';
+
+        if (saveFile.fail())
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Error writing to file '%s'."), filePath)
+            );
+        }
+    }
+
+    // Close the file.
+    saveFile.close();
+    if (saveFile.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error closing file '%s'."), filePath)
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares the settings and the contents of the input files with those saved in the build's
+ * working directory.
+ *
+ * @return true if nothing has changed, false if anything has (or nothing was saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool MatchesSaved
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    profile::Scope_t profileScope("io", "Check input hashes");
+
+    auto filePath = GetSaveFilePath(buildParams);
+
+    if (!file::FileExists(filePath))
+    {
+        if (buildParams.beVerbose)
+        {
+            std::cout << LE_I18N("Input file hashes from previous run not found.") << std::endl;
+        }
+        return false;
+    }
+
+    // Open the file
+    std::ifstream saveFile(filePath);
+    if (!saveFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
+        );
+    }
+
+    std::string line;
+
+    if (!std::getline(saveFile, line) || (line != SettingsMd5))
+    {
+        if (buildParams.beVerbose)
+        {
+            std::cout << LE_I18N("Arguments or environment variables are different this time.")
+                      << std::endl;
+        }
+        return false;
+    }
+
+    while (std::getline(saveFile, line))
+    {
+        auto separator = line.find(' ');
+        if (separator == std::string::npos)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Error reading from file '%s'."), filePath)
+            );
+        }
+
+        auto savedMd5 = line.substr(0, separator);
+        auto inputPath = line.substr(separator + 1);
+        auto inputMd5 = GetFileMd5(inputPath);
+
+        if ((inputMd5.empty() ? "-" : inputMd5) != savedMd5)
+        {
+            if (buildParams.beVerbose)
+            {
+                std::cout << mk::format(LE_I18N("Input file '%s' has changed."), inputPath)
+                          << std::endl;
+            }
+            return false;
+        }
+    }
+
+    if (saveFile.bad())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error reading from file '%s'."), filePath)
+        );
+    }
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << LE_I18N("None of the input files have changed.") << std::endl;
+    }
+
+    return true;
+}
+
+
+} // namespace inputs
@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file inputs.h
+ *
+ * Tracking of the input files read while building the model, so that a build.ninja regeneration
+ * can be skipped when none of them have actually changed.
+ *
+ * Ninja asks for build.ninja to be regenerated whenever a definition file it depends on has a
+ * newer modification time than build.ninja, even if its contents are exactly the same as before
+ * (e.g., after a "git checkout" or a "touch").  Every file the lexers and the .api dependency
+ * scanner read is recorded, and once the build scripts have been generated, the MD5 hash of each
+ * one's contents is saved in the working directory, along with a hash of the command-line
+ * arguments and environment variables the tool was started with.  If all of those still match
+ * the next time, the model would come out the same, so the old build.ninja can be kept.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_INPUTS_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_INPUTS_H_INCLUDE_GUARD
+
+namespace inputs
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take note of the command-line arguments and environment variables that the build starts with.
+ * Must be called before any definition files are parsed, as parsing changes the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+void RecordSettings
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that a file has been read as an input to the model.  May be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void Add
+(
+    const std::string& filePath ///< Path to the file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the hashes of the settings and of every input file recorded so far (in a file in the
+ * build's working directory) for later use by MatchesSaved().
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares the settings and the contents of the input files with those saved in the build's
+ * working directory.
+ *
+ * @return true if nothing has changed, false if anything has (or nothing was saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool MatchesSaved
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+} // namespace inputs
+
+#endif // LEGATO_MKTOOLS_INPUTS_H_INCLUDE_GUARD
@@ -16,6 +16,7 @@
 
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -40,6 +41,8 @@
 #include "exception.h"
 #include "buildParams.h"
 #include "envVars.h"
+#include "inputs.h"
+#include "profile.h"
 #include "path.h"
 #include "file.h"
 #include "format.h"
@@ -9,6 +9,7 @@
 #include "mkTools.h"
 #include "modellerCommon.h"
 #include "componentModeller.h"
+#include "parseAhead.h"
 #include "envVars.h"
 
 
@@ -1678,12 +1679,14 @@ model::App_t* GetApp
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("model", adefPath);
+
     // Save the old CURDIR environment variable value and set it to the dir containing this file.
     auto oldDir = envVars::Get("CURDIR");
     envVars::Set("CURDIR", path::MakeAbsolute(path::GetContainingDir(adefPath)));
 
     // Parse the .adef file.
-    const auto adefFilePtr = parser::adef::Parse(adefPath, buildParams.beVerbose);
+    const auto adefFilePtr = ParseAdef(adefPath, buildParams.beVerbose);
 
     // Create a new App_t object for this app.
     auto appPtr = new model::App_t(adefFilePtr);
@@ -9,6 +9,7 @@
 #include "mkTools.h"
 #include "modellerCommon.h"
 #include "componentModeller.h"
+#include "parseAhead.h"
 
 namespace modeller
 {
@@ -525,6 +526,7 @@ static void GetRequiredApi
     bool typesOnly = false;
     bool manualStart = false;
     bool optional = false;
+    bool async = false;
     for (auto contentPtr : contentList)
     {
         if (contentPtr->type == parseTree::Token_t::CLIENT_IPC_OPTION)
@@ -533,6 +535,10 @@ static void GetRequiredApi
             {
                 typesOnly = true;
             }
+            else if (contentPtr->text == "[async]")
+            {
+                async = true;
+            }
             else if (contentPtr->text == "[manual-start]")
             {
                 manualStart = true;
@@ -549,6 +555,11 @@ static void GetRequiredApi
         itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [manual-start] or [optional]"
                                   " for the same interface."));
     }
+    if (typesOnly && async)
+    {
+        itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [async]"
+                                  " for the same interface."));
+    }
 
     // Get a pointer to the .api file object.
     auto apiFilePtr = GetApiFilePtr(apiFilePath, buildParams.interfaceDirs, contentList[0]);
@@ -572,6 +583,7 @@ static void GetRequiredApi
 
         ifPtr->manualStart = manualStart;
         ifPtr->optional = optional;
+        ifPtr->async = async;
 
         componentPtr->clientApis.push_back(ifPtr);
     }
@@ -734,6 +746,67 @@ static void AddRequiredItems
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The most C source files that will be compiled together as one translation unit in a unity build.
+ * Larger batches save more header parsing, but leave fewer jobs for ninja to run in parallel.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const size_t MaxUnityBatchSize = 8;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * For unity builds, split a component's C source files into evenly sized batches, each of which
+ * will be compiled as a single translation unit by way of a generated source file that #includes
+ * all the files in the batch.
+ *
+ * Components with fewer than two C source files aren't worth it.  C++ sources are always compiled
+ * individually.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AddUnityFiles
+(
+    model::Component_t* componentPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto sourceCount = componentPtr->cObjectFiles.size();
+
+    if ((!buildParams.unityBuild) || (sourceCount < 2))
+    {
+        return;
+    }
+
+    auto batchCount = (sourceCount + MaxUnityBatchSize - 1) / MaxUnityBatchSize;
+
+    auto srcDir = path::Combine(path::MakeAbsolute(buildParams.workingDir),
+                                path::Combine(componentPtr->workingDir, "src"));
+    auto objDir = path::Combine(componentPtr->workingDir, "obj");
+
+    std::vector<model::UnityFile_t*> batches;
+
+    for (size_t i = 0; i < batchCount; i++)
+    {
+        auto fileName = mk::format("_unity%zu.c", i);
+
+        batches.push_back(new model::UnityFile_t(path::Combine(objDir, fileName + ".o"),
+                                                 path::Combine(srcDir, fileName)));
+    }
+
+    // Deal the files out in order, so each batch gets a run of adjacent files.
+    size_t i = 0;
+
+    for (auto objFilePtr : componentPtr->cObjectFiles)
+    {
+        batches[(i++ * batchCount) / sourceCount]->members.push_back(objFilePtr);
+    }
+
+    componentPtr->cUnityFiles.assign(batches.begin(), batches.end());
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print a summary of a component model.
@@ -759,6 +832,13 @@ static void PrintSummary
         }
     }
 
+    for (auto unityFilePtr : componentPtr->cUnityFiles)
+    {
+        std::cout << mk::format(LE_I18N("  Unity build source '%s' includes %zu C sources."),
+                                unityFilePtr->sourceFilePath, unityFilePtr->members.size())
+                  << std::endl;
+    }
+
     if (!componentPtr->cxxObjectFiles.empty())
     {
         std::cout << LE_I18N("  C++ sources:") << std::endl;
@@ -920,13 +1000,15 @@ model::Component_t* GetComponent
         return componentPtr;
     }
 
+    profile::Scope_t profileScope("model", componentDir);
+
     // Save the old CURDIR environment variable value and set it to the dir containing this file.
     auto oldDir = envVars::Get("CURDIR");
     envVars::Set("CURDIR", path::MakeAbsolute(componentDir));
 
     // Parse the .cdef file.
     auto cdefFilePath = path::Combine(componentDir, "Component.cdef");
-    auto cdefFilePtr = parser::cdef::Parse(cdefFilePath, buildParams.beVerbose);
+    auto cdefFilePtr = ParseCdef(cdefFilePath, buildParams.beVerbose);
 
     // Create a new object for this component.
     // By default, it will be built in a sub-directory called "component/<compName>" under the
@@ -1013,6 +1095,8 @@ model::Component_t* GetComponent
         componentPtr->implicitDependencies.insert(liblegatoJniPath);
     }
 
+    AddUnityFiles(componentPtr, buildParams);
+
     if (buildParams.beVerbose)
     {
         PrintSummary(componentPtr);
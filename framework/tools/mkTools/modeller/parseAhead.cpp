@@ -0,0 +1,409 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseAhead.cpp
+ *
+ * Parsing of .adef and .cdef files ahead of the modellers, on a pool of worker threads.
+ *
+ * Each wave of files is parsed in parallel, then the parse trees are searched (on the main
+ * thread) for the components they use, whose .cdef files make up the next wave.
+ *
+ * The parsers look up environment variables, and CURDIR must be the directory of the file being
+ * parsed, so each worker thread gets its own CURDIR using envVars::SetForThread().  Nothing sets
+ * the process's environment while the workers are running.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+#include "parseAhead.h"
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+namespace modeller
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A definition file that has been parsed ahead: either its parse tree, or the exception thrown
+ * while parsing it.
+ */
+//--------------------------------------------------------------------------------------------------
+struct ParsedFile_t
+{
+    parseTree::DefFile_t* filePtr;  ///< The parse tree, or NULL if the parse failed.
+    std::exception_ptr error;       ///< What the parser threw, if anything.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A definition file to be parsed by the worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+struct Job_t
+{
+    std::string path;                   ///< Path to the file.
+    parseTree::DefFile_t::Type_t type;  ///< Type of file (ADEF or CDEF).
+    ParsedFile_t result;                ///< Filled in by the worker thread.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The files that have been parsed ahead and not taken yet, keyed by file path.  Only ever touched
+ * by the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::map<std::string, ParsedFile_t> ParsedFiles;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse one file, on whichever thread calls this.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Parse
+(
+    Job_t& job
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The file is parsed with CURDIR set to the dir containing it, as the modellers would do.
+    envVars::SetForThread("CURDIR", path::MakeAbsolute(path::GetContainingDir(job.path)));
+
+    job.result.filePtr = NULL;
+
+    try
+    {
+        if (job.type == parseTree::DefFile_t::ADEF)
+        {
+            job.result.filePtr = parser::adef::Parse(job.path, false);
+        }
+        else
+        {
+            job.result.filePtr = parser::cdef::Parse(job.path, false);
+        }
+    }
+    catch (...)
+    {
+        job.result.error = std::current_exception();
+    }
+
+    envVars::ClearForThread();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a wave of files on a pool of threads, one per core.  The calling thread works too, and
+ * this returns once every file has been parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseAll
+(
+    std::vector<Job_t>& jobs,
+    bool beVerbose
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::atomic<size_t> nextJob(0);
+
+    auto worker = [&jobs, &nextJob]()
+        {
+            size_t i;
+
+            while ((i = nextJob++) < jobs.size())
+            {
+                Parse(jobs[i]);
+            }
+        };
+
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = std::min(threadCount, jobs.size());
+
+    if (beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Parsing %zu definition files on %zu threads."),
+                                jobs.size(), threadCount)
+                  << std::endl;
+    }
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (std::system_error&)
+        {
+            // Make do with the threads we've got.
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the .cdef file of the component named by a token in a parsed file, unless that component
+ * has already been parsed, queued or modelled.  Components that can't be found are skipped.
+ *
+ * Must be called with CURDIR set to the dir of the file containing the token.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueComponent
+(
+    const parseTree::Token_t* tokenPtr, ///< Token naming the component.
+    const std::string& fileDir,         ///< Dir of the file containing the token.
+    const mk::BuildParams_t& buildParams,
+    std::set<std::string>& queuedPaths, ///< [in,out] Every file path queued so far.
+    std::vector<Job_t>& jobs            ///< [in,out] The next wave of files to parse.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Resolve the path the same way as the component modeller does.
+    std::string componentPath;
+
+    try
+    {
+        componentPath = path::Unquote(envVars::DoSubstitution(tokenPtr->text));
+    }
+    catch (mk::Exception_t&)
+    {
+        return;
+    }
+
+    if (componentPath.empty())
+    {
+        return;
+    }
+
+    auto resolvedPath = file::FindComponent(componentPath, { fileDir });
+    if (resolvedPath.empty())
+    {
+        resolvedPath = file::FindComponent(componentPath, buildParams.sourceDirs);
+    }
+    if (resolvedPath.empty())
+    {
+        return;
+    }
+
+    auto componentDir = path::MakeAbsolute(resolvedPath);
+
+    if (model::Component_t::GetComponent(componentDir) != NULL)
+    {
+        return;
+    }
+
+    auto cdefFilePath = path::Combine(componentDir, "Component.cdef");
+
+    if (queuedPaths.insert(cdefFilePath).second)
+    {
+        jobs.push_back({ cdefFilePath, parseTree::DefFile_t::CDEF, { NULL, nullptr } });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the .cdef files of all the components used by a parsed .adef or .cdef file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueComponents
+(
+    const parseTree::DefFile_t* filePtr,
+    const mk::BuildParams_t& buildParams,
+    std::set<std::string>& queuedPaths, ///< [in,out] Every file path queued so far.
+    std::vector<Job_t>& jobs            ///< [in,out] The next wave of files to parse.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto fileDir = path::MakeAbsolute(path::GetContainingDir(filePtr->path));
+
+    envVars::SetForThread("CURDIR", fileDir);
+
+    auto queue = [&](const parseTree::TokenList_t* listPtr)
+        {
+            for (auto tokenPtr : listPtr->Contents())
+            {
+                QueueComponent(tokenPtr, fileDir, buildParams, queuedPaths, jobs);
+            }
+        };
+
+    for (auto sectionPtr : filePtr->sections)
+    {
+        auto& sectionName = sectionPtr->firstTokenPtr->text;
+
+        if (filePtr->type == parseTree::DefFile_t::ADEF)
+        {
+            if (sectionName == "components")
+            {
+                queue(parseTree::ToTokenListSectionPtr(sectionPtr));
+            }
+            else if (sectionName == "executables")
+            {
+                for (auto itemPtr : parseTree::ToCompoundItemListPtr(sectionPtr)->Contents())
+                {
+                    queue(parseTree::ToTokenListPtr(itemPtr));
+                }
+            }
+        }
+        else if (sectionName == "requires")
+        {
+            for (auto memberPtr : parseTree::ToComplexSectionPtr(sectionPtr)->Contents())
+            {
+                if (memberPtr->firstTokenPtr->text == "component")
+                {
+                    queue(parseTree::ToTokenListPtr(memberPtr));
+                }
+            }
+        }
+    }
+
+    envVars::ClearForThread();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a list of .adef files, and the .cdef files of all the components they use (and the
+ * components those use, etc.), in parallel.  The results are held until they are taken by
+ * ParseAdef() and ParseCdef().
+ */
+//--------------------------------------------------------------------------------------------------
+void ParseAhead
+(
+    const std::list<std::string>& adefPaths,    ///< Paths to the .adef files.
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::set<std::string> queuedPaths;
+    std::vector<Job_t> jobs;
+
+    for (auto& adefPath : adefPaths)
+    {
+        if (queuedPaths.insert(adefPath).second)
+        {
+            jobs.push_back({ adefPath, parseTree::DefFile_t::ADEF, { NULL, nullptr } });
+        }
+    }
+
+    while (!jobs.empty())
+    {
+        ParseAll(jobs, buildParams.beVerbose);
+
+        std::vector<Job_t> nextJobs;
+
+        for (auto& job : jobs)
+        {
+            ParsedFiles[job.path] = job.result;
+
+            if (job.result.filePtr != NULL)
+            {
+                QueueComponents(job.result.filePtr, buildParams, queuedPaths, nextJobs);
+            }
+        }
+
+        jobs.swap(nextJobs);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a file out of the files parsed ahead, or parse it now if it isn't there.
+ *
+ * @return Pointer to the parse tree.
+ *
+ * @throw mk::Exception_t if an error was encountered when the file was parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+template <class FileType_t>
+static FileType_t* Take
+(
+    const std::string& filePath,
+    bool beVerbose,
+    FileType_t* (*parseFunc)(const std::string&, bool)
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto i = ParsedFiles.find(filePath);
+
+    if (i == ParsedFiles.end())
+    {
+        return parseFunc(filePath, beVerbose);
+    }
+
+    auto parsedFile = i->second;
+    ParsedFiles.erase(i);
+
+    // Keep the progress messages in the same order as if the file had been parsed just now.
+    if (beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Parsing file: '%s'."), filePath) << std::endl;
+    }
+
+    if (parsedFile.error)
+    {
+        std::rethrow_exception(parsedFile.error);
+    }
+
+    return static_cast<FileType_t*>(parsedFile.filePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parse tree of a .adef file, either from the files parsed ahead, or by parsing it now.
+ *
+ * @return Pointer to a fully populated AdefFile_t object.
+ *
+ * @throw mk::Exception_t if an error is encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::AdefFile_t* ParseAdef
+(
+    const std::string& adefPath,    ///< Path to the .adef file.
+    bool beVerbose                  ///< true if progress messages should be printed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return Take(adefPath, beVerbose, parser::adef::Parse);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parse tree of a .cdef file, either from the files parsed ahead, or by parsing it now.
+ *
+ * @return Pointer to a fully populated CdefFile_t object.
+ *
+ * @throw mk::Exception_t if an error is encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::CdefFile_t* ParseCdef
+(
+    const std::string& cdefPath,    ///< Path to the .cdef file.
+    bool beVerbose                  ///< true if progress messages should be printed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return Take(cdefPath, beVerbose, parser::cdef::Parse);
+}
+
+
+} // namespace modeller
@@ -0,0 +1,79 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseAhead.h
+ *
+ * Parsing of .adef and .cdef files ahead of the modellers, on a pool of worker threads.
+ *
+ * The modellers walk the apps and components one at a time, and parse each definition file as
+ * they come to it.  ParseAhead() lets a system's worth of definition files be parsed all at once,
+ * on as many threads as there are cores, before the modelling starts.  The modellers then take the
+ * parsed files with ParseAdef() and ParseCdef(), in the same order as always, so the model (and
+ * any error reported while building it) comes out exactly as if the files had been parsed one
+ * after the other.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_PARSE_AHEAD_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_PARSE_AHEAD_H_INCLUDE_GUARD
+
+namespace modeller
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a list of .adef files, and the .cdef files of all the components they use (and the
+ * components those use, etc.), in parallel.  The results are held until they are taken by
+ * ParseAdef() and ParseCdef().
+ *
+ * Errors are not reported here.  A file that fails to parse is held along with its error, which
+ * is thrown when the file is taken, and a component that can't be found is just skipped, for the
+ * modeller to complain about when it gets there.
+ *
+ * Must be called with all the build variables already set in the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+void ParseAhead
+(
+    const std::list<std::string>& adefPaths,    ///< Paths to the .adef files.
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parse tree of a .adef file, either from the files parsed ahead, or by parsing it now.
+ *
+ * @return Pointer to a fully populated AdefFile_t object.
+ *
+ * @throw mk::Exception_t if an error is encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::AdefFile_t* ParseAdef
+(
+    const std::string& adefPath,    ///< Path to the .adef file.
+    bool beVerbose                  ///< true if progress messages should be printed.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parse tree of a .cdef file, either from the files parsed ahead, or by parsing it now.
+ *
+ * @return Pointer to a fully populated CdefFile_t object.
+ *
+ * @throw mk::Exception_t if an error is encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::CdefFile_t* ParseCdef
+(
+    const std::string& cdefPath,    ///< Path to the .cdef file.
+    bool beVerbose                  ///< true if progress messages should be printed.
+);
+
+
+} // namespace modeller
+
+#endif // LEGATO_MKTOOLS_PARSE_AHEAD_H_INCLUDE_GUARD
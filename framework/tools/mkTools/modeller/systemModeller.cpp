@@ -8,6 +8,10 @@
 
 #include "mkTools.h"
 #include "modellerCommon.h"
+#include "parseAhead.h"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 
 namespace modeller
@@ -156,6 +160,9 @@ static void ModelAppOverrides
 //--------------------------------------------------------------------------------------------------
 /**
  * Run the tar command to decompress a given app file into the build directory.
+ *
+ * The MD5 hash of the app file is saved beside the extraction directory, and if the same app file
+ * has already been extracted there, it isn't extracted again.
  */
 //--------------------------------------------------------------------------------------------------
 static void UntarBinApp
@@ -167,11 +174,67 @@ static void UntarBinApp
 )
 //--------------------------------------------------------------------------------------------------
 {
-    std::string flags = isVerbose ? "xvf" : "xf";
-    std::string cmdLine = "tar " + flags + " \"" + appPath + "\" -C " + destPath;
+    const std::string stampPath = destPath + ".md5";
+    std::string appMd5;
+
+    try
+    {
+        appMd5 = file::GetMd5Hash(appPath);
+    }
+    catch (mk::Exception_t& e)
+    {
+        sectionPtr->ThrowException(e.what());
+    }
+
+    if (file::DirectoryExists(destPath))
+    {
+        std::ifstream stampFile(stampPath);
+        std::string extractedMd5;
+
+        if (std::getline(stampFile, extractedMd5) && (extractedMd5 == appMd5))
+        {
+            if (isVerbose)
+            {
+                std::cout << mk::format(LE_I18N("Binary app '%s' is already extracted."), appPath)
+                          << std::endl;
+            }
+            return;
+        }
 
+        // Don't leave behind files from a different version of the app.
+        file::DeleteDir(destPath);
+    }
+
+    file::DeleteFile(stampPath);
     file::MakeDir(destPath);
-    int retVal = system(cmdLine.c_str());
+
+    // Run tar directly, rather than through a shell.
+    const char* flags = isVerbose ? "xvf" : "xf";
+    int retVal = -1;
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        execlp("tar", "tar", flags, appPath.c_str(), "-C", destPath.c_str(), (char*)NULL);
+        _exit(127);
+    }
+    else if (pid > 0)
+    {
+        int status;
+        pid_t result;
+
+        do
+        {
+            result = waitpid(pid, &status, 0);
+
+        } while ((result == -1) && (errno == EINTR));
+
+        if ((result == pid) && WIFEXITED(status))
+        {
+            retVal = WEXITSTATUS(status);
+        }
+    }
 
     if (retVal != 0)
     {
@@ -179,6 +242,9 @@ static void UntarBinApp
         msg << "Binary app '" << appPath << "' could not be extracted.";
         sectionPtr->ThrowException(msg.str());
     }
+
+    std::ofstream stampFile(stampPath);
+    stampFile << appMd5 << '\n';
 }
 
 
@@ -311,6 +377,8 @@ static void ModelApp
                       << "to '" << dirPath << "'." << std::endl;
         }
 
+        inputs::Add(filePath);
+
         UntarBinApp(filePath, dirPath, sectionPtr, buildParams.beVerbose);
         filePath = FindBinAppAdef(sectionPtr, path::MakeAbsolute(dirPath) + "/");
         //filePath = newAdefPath;
@@ -694,6 +762,65 @@ static void ModelBindingsSection
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the .adef files of all the apps in all the "apps:" sections, the same way as ModelApp()
+ * does.  Binary apps, and apps that can't be found, are left out.
+ *
+ * @return The paths to the .adef files.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::list<std::string> FindAdefFiles
+(
+    const std::list<const parseTree::CompoundItem_t*>& appsSections,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::list<std::string> adefPaths;
+
+    const std::string appSuffix = "." + buildParams.target + ".app";
+
+    for (auto sectionPtr : appsSections)
+    {
+        auto appsSectionPtr = dynamic_cast<const parseTree::CompoundItemList_t*>(sectionPtr);
+
+        for (auto itemPtr : appsSectionPtr->Contents())
+        {
+            std::string appSpec;
+
+            try
+            {
+                appSpec = path::Unquote(envVars::DoSubstitution(itemPtr->firstTokenPtr->text));
+            }
+            catch (mk::Exception_t&)
+            {
+                // ModelApp() will report this.
+                continue;
+            }
+
+            std::string filePath;
+
+            if (path::HasSuffix(appSpec, ".adef"))
+            {
+                filePath = file::FindFile(appSpec, buildParams.sourceDirs);
+            }
+            else if (!appSpec.empty() && !path::HasSuffix(appSpec, appSuffix))
+            {
+                filePath = file::FindFile(appSpec + ".adef", buildParams.sourceDirs);
+            }
+
+            if (!filePath.empty())
+            {
+                adefPaths.push_back(filePath);
+            }
+        }
+    }
+
+    return adefPaths;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Model all the apps from all the "apps:" sections and add them to a system.
@@ -707,6 +834,10 @@ static void ModelApps
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Parse all the apps' .adef files, and their components' .cdef files, in parallel first.
+    // They are then modelled one at a time, in order, exactly as if they were parsed on the way.
+    ParseAhead(FindAdefFiles(appsSections, buildParams), buildParams);
+
     for (auto sectionPtr : appsSections)
     {
         ModelAppsSection(systemPtr, sectionPtr, buildParams);
@@ -889,6 +1020,8 @@ model::System_t* GetSystem
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("model", sdefPath);
+
     // Save the old CURDIR environment variable value and set it to the dir containing this file.
     auto oldDir = envVars::Get("CURDIR");
     envVars::Set("CURDIR", path::MakeAbsolute(path::GetContainingDir(sdefPath)));
@@ -81,6 +81,8 @@ void GetDependencies
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("parse", filePath);
+
     // Make sure the file exists.
     if (!file::FileExists(filePath))
     {
@@ -99,6 +101,8 @@ void GetDependencies
         );
     }
 
+    inputs::Add(filePath);
+
     // Keep looking for USETYPES statements, skipping comments.
     for (int c = inputStream.get(); c != EOF; c = inputStream.get())
     {
@@ -58,16 +58,28 @@ class Lexer_t
         {
             parseTree::DefFileFragment_t* filePtr;  ///< Pointer to the File object for the file being parsed.
 
-            std::ifstream inputStream;      ///< File input stream from which tokens will be matched.
-            std::deque<int> nextChars;      ///< File buffer for characters read from the input
-                                            ///< stream but not yet consumed.
+            std::string buffer;             ///< The whole contents of the file.
+            size_t pos;                     ///< Offset in the buffer of the next character to be
+                                            ///< consumed.
             size_t line;                    ///< File line number.
             size_t column;                  ///< Char index on line (treat tab & return same as space).
             size_t ifNestDepth;             ///< Current number of nested #if directives.
 
             LexerContext_t(parseTree::DefFileFragment_t *filePtr);
 
-            void Buffer(size_t n);
+            /// Look at a character not yet consumed, without consuming it.
+            /// @return The character, or EOF if it's past the end of the file.
+            int Peek(size_t offset) const
+            {
+                return (pos + offset < buffer.size()) ? (unsigned char)buffer[pos + offset] : EOF;
+            }
+
+            /// Check whether the characters not yet consumed start with a given string literal.
+            template <size_t N>
+            bool LookingAt(const char (&string)[N]) const
+            {
+                return (buffer.compare(pos, N - 1, string, N - 1) == 0);
+            }
         };
 
         std::stack<LexerContext_t> context;
@@ -316,6 +316,8 @@ void ParseFile
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("parse", defFilePtr->path);
+
     if (beVerbose)
     {
         std::cout << mk::format(LE_I18N("Parsing file: '%s'."), defFilePtr->path)
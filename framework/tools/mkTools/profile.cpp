@@ -0,0 +1,359 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file profile.cpp
+ *
+ * Timing of the mk tools' own work, for the --profile option.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+#include <thread>
+
+
+namespace profile
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A piece of work that has been timed.
+ */
+//--------------------------------------------------------------------------------------------------
+struct Event_t
+{
+    const char* category;   ///< Kind of work.
+    std::string name;       ///< What was being worked on.
+    size_t threadId;        ///< Small number identifying the thread it was done on.
+    long long startUs;      ///< Start time, in microseconds since profiling was enabled.
+    long long durationUs;   ///< How long it took, in microseconds.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of build statements per rule in a ninja script.
+ */
+//--------------------------------------------------------------------------------------------------
+struct EdgeCount_t
+{
+    std::string filePath;               ///< Path to the ninja script.
+    long long timeUs;                   ///< When it was counted, as for Event_t::startUs.
+    std::map<std::string, size_t> counts;   ///< Number of build statements, keyed by rule name.
+};
+
+
+/// true if profiling is enabled.  Only changed while no other threads are running.
+static bool Enabled = false;
+
+/// Path to the file the trace is to be saved in.
+static std::string TraceFilePath;
+
+/// When profiling was enabled.
+static std::chrono::steady_clock::time_point StartTime;
+
+/// Everything recorded so far, and the mutex that protects it (the parsers run on several threads).
+static std::list<Event_t> Events;
+static std::list<EdgeCount_t> EdgeCounts;
+static std::map<std::thread::id, size_t> ThreadIds;
+static std::mutex Mutex;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @return The number of microseconds between when profiling was enabled and a given time.
+ */
+//--------------------------------------------------------------------------------------------------
+static long long ToUs
+(
+    std::chrono::steady_clock::time_point time
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - StartTime).count();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @return A string quoted and escaped for use in a JSON file.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string Quote
+(
+    const std::string& text
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string result = "\"";
+
+    for (auto c : text)
+    {
+        switch (c)
+        {
+            case '"':   result += "\\\"";   break;
+            case '\\':  result += "\\\\";   break;
+            case '\n':  result += "\\n";    break;
+            case '\t':  result += "\\t";    break;
+
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    result += mk::format("\\u%04x", (unsigned int)(unsigned char)c);
+                }
+                else
+                {
+                    result += c;
+                }
+                break;
+        }
+    }
+
+    return result + '"';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start profiling.  The trace will be written to a given file when Save() is called.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const std::string& filePath ///< Path to the trace file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TraceFilePath = path::MakeAbsolute(filePath);
+    StartTime = std::chrono::steady_clock::now();
+    Enabled = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @return true if profiling has been enabled (and not yet saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsEnabled
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return Enabled;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Constructor.  Starts timing.
+ */
+//--------------------------------------------------------------------------------------------------
+Scope_t::Scope_t
+(
+    const char* category,   ///< Kind of work (e.g., "parse").
+    const std::string& name ///< What is being worked on (e.g., a file path).
+)
+//--------------------------------------------------------------------------------------------------
+:   isActive(Enabled),
+    category(category)
+{
+    if (isActive)
+    {
+        this->name = name;
+        startTime = std::chrono::steady_clock::now();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor.  Records the event.
+ */
+//--------------------------------------------------------------------------------------------------
+Scope_t::~Scope_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (isActive)
+    {
+        auto endTime = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(Mutex);
+
+        auto threadId = ThreadIds.insert(std::make_pair(std::this_thread::get_id(),
+                                                        ThreadIds.size() + 1)).first->second;
+
+        Events.push_back({ category,
+                           name,
+                           threadId,
+                           ToUs(startTime),
+                           ToUs(endTime) - ToUs(startTime) });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the build statements in a ninja script, by rule, and add the counts to the trace.
+ * Errors reading the file are ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void CountNinjaEdges
+(
+    const std::string& filePath ///< Path to the ninja script.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!Enabled)
+    {
+        return;
+    }
+
+    EdgeCount_t edgeCount;
+    edgeCount.filePath = filePath;
+    edgeCount.timeUs = ToUs(std::chrono::steady_clock::now());
+
+    std::ifstream script(filePath);
+    std::string line;
+
+    while (std::getline(script, line))
+    {
+        if (line.compare(0, 6, "build ") != 0)
+        {
+            continue;
+        }
+
+        // The rule name follows the first ':' that isn't escaped with a '$'.
+        size_t i = 6;
+        while ((i < line.size()) && (line[i] != ':'))
+        {
+            i += (line[i] == '$') ? 2 : 1;
+        }
+
+        auto ruleStart = line.find_first_not_of(' ', i + 1);
+        if ((i >= line.size()) || (ruleStart == std::string::npos))
+        {
+            continue;
+        }
+
+        auto ruleEnd = line.find_first_of(" |$", ruleStart);
+
+        edgeCount.counts[line.substr(ruleStart, ruleEnd - ruleStart)]++;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    EdgeCounts.push_back(edgeCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the trace to the file given to Enable(), and stop profiling.  Does nothing if profiling
+ * isn't enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!Enabled)
+    {
+        return;
+    }
+
+    Enabled = false;
+
+    std::ofstream traceFile(TraceFilePath);
+    if (!traceFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), TraceFilePath)
+        );
+    }
+
+    const int pid = getpid();
+    const char* separator = "\n";
+
+    traceFile << "{\"traceEvents\":[";
+
+    for (auto& event : Events)
+    {
+        traceFile << separator
+                  << "{\"name\":" << Quote(event.name)
+                  << ",\"cat\":\"" << event.category
+                  << "\",\"ph\":\"X\",\"ts\":" << event.startUs
+                  << ",\"dur\":" << event.durationUs
+                  << ",\"pid\":" << pid
+                  << ",\"tid\":" << event.threadId << "}";
+        separator = ",\n";
+    }
+
+    // The edge counts are shown as counters, one track per ninja script.
+    size_t totalEdges = 0;
+
+    for (auto& edgeCount : EdgeCounts)
+    {
+        traceFile << separator
+                  << "{\"name\":" << Quote("ninja edges: " + edgeCount.filePath)
+                  << ",\"cat\":\"ninja\",\"ph\":\"C\",\"ts\":" << edgeCount.timeUs
+                  << ",\"pid\":" << pid
+                  << ",\"args\":{";
+
+        const char* argSeparator = "";
+
+        for (auto& count : edgeCount.counts)
+        {
+            traceFile << argSeparator << Quote(count.first) << ":" << count.second;
+            argSeparator = ",";
+            totalEdges += count.second;
+        }
+
+        traceFile << "}}";
+        separator = ",\n";
+    }
+
+    traceFile << "\n],\n"
+                 "\"displayTimeUnit\":\"ms\",\n"
+                 "\"otherData\":{\"ninjaEdges\":\"" << totalEdges << "\"}}\n";
+
+    traceFile.close();
+    if (traceFile.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Error writing to file '%s'."), TraceFilePath)
+        );
+    }
+
+    std::cout << mk::format(LE_I18N("Profile written to '%s'."), TraceFilePath) << std::endl;
+
+    for (auto& edgeCount : EdgeCounts)
+    {
+        size_t edges = 0;
+        for (auto& count : edgeCount.counts)
+        {
+            edges += count.second;
+        }
+
+        std::cout << mk::format(LE_I18N("  %zu build statements in '%s':"),
+                                edges, edgeCount.filePath)
+                  << std::endl;
+
+        for (auto& count : edgeCount.counts)
+        {
+            std::cout << mk::format("    %-24s %zu", count.first, count.second) << std::endl;
+        }
+    }
+}
+
+
+} // namespace profile
@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file profile.h
+ *
+ * Timing of the mk tools' own work, for the --profile option.
+ *
+ * When profiling is enabled, each Scope_t object records how long it lived (and on which thread)
+ * as an event in the Chrome trace event format, and the number of build statements in each
+ * build.ninja written is counted, per rule.  Save() writes it all to a JSON file that can be
+ * loaded into chrome://tracing or https://ui.perfetto.dev.
+ *
+ * When profiling isn't enabled, a Scope_t costs one test of a flag.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
+
+namespace profile
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start profiling.  The trace will be written to a given file when Save() is called.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const std::string& filePath ///< Path to the trace file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @return true if profiling has been enabled (and not yet saved).
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Times the work done during its lifetime, and records it as a trace event.
+ */
+//--------------------------------------------------------------------------------------------------
+class Scope_t
+{
+    public:
+
+        Scope_t(const char* category, const std::string& name);
+        ~Scope_t();
+
+    private:
+
+        bool isActive;          ///< true if profiling was enabled when this was created.
+        const char* category;   ///< Kind of work (e.g., "parse").
+        std::string name;       ///< What is being worked on (e.g., a file path).
+        std::chrono::steady_clock::time_point startTime;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the build statements in a ninja script, by rule, and add the counts to the trace.
+ * Errors reading the file are ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void CountNinjaEdges
+(
+    const std::string& filePath ///< Path to the ninja script.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the trace to the file given to Enable(), and stop profiling.  Does nothing if profiling
+ * isn't enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+void Save
+(
+    void
+);
+
+
+} // namespace profile
+
+#endif // LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
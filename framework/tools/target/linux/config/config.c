@@ -83,11 +83,21 @@ static bool UseJson = false;
 
 
 
+/// Format the config tree streams imported and exported data in.
+static le_cfgAdmin_TreeFormat_t TreeFormat = LE_CFGADMIN_FORMAT_TEXT;
+
+
+
 /// If true, delete the original node after a copy, false leave the original alone.
 static bool DeleteAfterCopy = false;
 
 
 
+/// If true, reset the config tree's performance counters after reporting them.
+static bool ResetStats = false;
+
+
+
 /// Function to be used to handle the command.
 static int (*CommandHandler)(void);
 
@@ -118,13 +128,15 @@ static void PrintHelpAndExit
            "To clear or create a new, empty node:\n"
            "\t%s clear <tree path>\n\n"
            "To import config data:\n"
-           "\t%s import <tree path> <file path> [--format=json]\n\n"
+           "\t%s import <tree path> <file path> [--format=json|snapshot]\n\n"
            "To export config data:\n"
-           "\t%s export <tree path> <file path> [--format=json]\n\n"
+           "\t%s export <tree path> <file path> [--format=json|snapshot]\n\n"
            "To list all config trees:\n"
            "\t%s list\n\n"
            "To delete a tree:\n"
            "\t%s rmtree <tree name>\n\n"
+           "To report the config tree's performance counters:\n"
+           "\t%s stats [--reset] [--format=json]\n\n"
            "Where:\n"
            "\t<tree path>: Is a path to the tree and node to operate on.\n"
            "\t<tree name>: Is the name of a tree in the system, but without a path.\n"
@@ -136,7 +148,13 @@ static void PrintHelpAndExit
            "\n"
            "\tIf --format=json is specified, for imports, then properly formatted JSON will be\n"
            "\texpected.  If it is specified for exports, then the data will be generated as well.\n"
-           "\tIt is also possible to specify JSON for the get sub-command.\n"
+           "\tIt is also possible to specify JSON for the get and stats sub-commands.\n"
+           "\n"
+           "\tIf --format=snapshot is specified for imports or exports, the data is in the\n"
+           "\tbinary format the config tree saves its trees in.\n"
+           "\n"
+           "\tIf --reset is given to the stats sub-command, the counters are set back\n"
+           "\tto zero once they have been reported.\n"
            "\n"
            "\tA tree path is specified similarly to a *nix path.  With the beginning slash\n"
            "\tbeing optional.\n"
@@ -166,6 +184,7 @@ static void PrintHelpAndExit
            ProgramName,
            ProgramName,
            ProgramName,
+           ProgramName,
            ProgramName);
 
     exit(EXIT_SUCCESS);
@@ -728,145 +747,6 @@ static int HandleGetJSON
 
 
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Function that handles the actual import of JSON data into the configTree.
- *
- *  @return LE_OK if the import is successful, LE_FAULT otherwise.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t HandleImportJSONIteration
-(
-    le_cfg_IteratorRef_t iterRef,  ///< Dump the JSON data into this iterator.
-    json_t* nodePtr                ///< From this JSON object.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Get value
-    json_t* value = json_object_get(nodePtr, JSON_FIELD_VALUE);
-
-    // Check type
-    const char* typeStr = json_string_value(json_object_get(nodePtr, JSON_FIELD_TYPE));
-    le_cfg_nodeType_t type = GetNodeTypeFromString(typeStr);
-
-    switch (type)
-    {
-        case LE_CFG_TYPE_BOOL:
-            le_cfg_SetBool(iterRef, "", json_is_true(value));
-            break;
-
-        case LE_CFG_TYPE_STRING:
-            le_cfg_SetString(iterRef, "", json_string_value(value));
-            break;
-
-        case LE_CFG_TYPE_INT:
-            le_cfg_SetInt(iterRef, "", json_integer_value(value));
-            break;
-
-        case LE_CFG_TYPE_FLOAT:
-            le_cfg_SetFloat(iterRef, "", json_real_value(value));
-            break;
-
-        case LE_CFG_TYPE_STEM:
-            {
-                // Iterate on children
-                json_t* childrenPtr = json_object_get(nodePtr, JSON_FIELD_CHILDREN);
-                json_t* childPtr;
-                int i;
-
-                json_array_foreach(childrenPtr, i, childPtr)
-                {
-                    // Get name
-                    const char* name = json_string_value(json_object_get(childPtr,
-                                                                         JSON_FIELD_NAME));
-
-                    // Is node exist with this name?
-                    le_cfg_nodeType_t existingType = le_cfg_GetNodeType(iterRef, name);
-                    switch (existingType)
-                    {
-                        case LE_CFG_TYPE_DOESNT_EXIST:
-                        case LE_CFG_TYPE_STEM:
-                        case LE_CFG_TYPE_EMPTY:
-                            // Not existing, already a stem or empty node, nothing to do
-                        break;
-
-                        default:
-                            // Issue with node creation
-                            fprintf(stderr, "Node conflict when importing, at node %s", name);
-                            return LE_NOT_POSSIBLE;
-                        break;
-                    }
-
-                    // Iterate to this child
-                    le_cfg_GoToNode(iterRef, name);
-
-                    // Iterate
-                    le_result_t subResult = HandleImportJSONIteration(iterRef, childPtr);
-                    if (subResult != LE_OK)
-                    {
-                        // Something went wrong
-                        return subResult;
-                    }
-
-                    // Go back to parent
-                    le_cfg_GoToParent(iterRef);
-                }
-            }
-            break;
-
-        default:
-            return LE_FAULT;
-    }
-
-    return LE_OK;
-}
-
-
-
-
-// -------------------------------------------------------------------------------------------------
-/**
- *  Load a JSON representation of some config data and import it into the configTree at the
- *  iterator's starting location.
- *
- *  @return LE_OK if the import is successful.  LE_FAULT otherwise.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t HandleImportJSON
-(
-    le_cfg_IteratorRef_t iterRef,  ///< The iterator being written to.
-    const char* filePathPtr        ///< Load the JSON from a file at this path.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Attempt to load JSON file.  If it fails to validate, then bail out.
-    json_error_t error;
-    json_t* decodedRootPtr = json_load_file(filePathPtr, 0, &error);
-
-    if (decodedRootPtr == NULL)
-    {
-        fprintf(stderr,
-                "JSON import error: line: %d, column: %d, position: %d, source: '%s', error: %s",
-                error.line,
-                error.column,
-                error.position,
-                error.source,
-                error.text);
-
-        return LE_FAULT;
-    }
-
-    // OK, looks like the JSON loaded, so iterate through it and dump it's contents into the
-    // configTree.
-    le_result_t result = HandleImportJSONIteration(iterRef, decodedRootPtr);
-    json_decref(decodedRootPtr);
-
-    return result;
-}
-
-
-
-
 // -------------------------------------------------------------------------------------------------
 /**
  *  This function will attempt read a value from the tree, and write it to standard out.  If the
@@ -1168,19 +1048,20 @@ static int HandleImport
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(NodePath);
-    le_result_t result;
+    // The whole file is handed to the config tree, which parses it in one go.
+    int fd = open(FilePath, O_RDONLY);
 
-    // Check requested format format.
-    if (UseJson)
-    {
-        result = HandleImportJSON(iterRef, FilePath);
-    }
-    else
+    if (fd == -1)
     {
-        result = le_cfgAdmin_ImportTree(iterRef, FilePath, "");
+        fprintf(stderr, "Could not open '%s': %s\n", FilePath, strerror(errno));
+        return EXIT_FAILURE;
     }
 
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(NodePath);
+
+    // The descriptor is closed once it has been sent.
+    le_result_t result = le_cfgAdmin_ImportTreeStream(iterRef, fd, "", TreeFormat);
+
     if (result != LE_OK)
     {
         ReportImportExportFail(result, "Import", NodePath, FilePath);
@@ -1211,15 +1092,25 @@ static int HandleExport
 {
     le_result_t result;
 
-    // Check required format.
-    if (UseJson)
+    // Dumping all of the trees at once is left to the client, otherwise the config tree writes the
+    // whole sub-tree to the file in one go.
+    if ((UseJson) && (strcmp(NodePath, "*") == 0))
     {
-        result = HandleGetJSON(NodePath, FilePath);
+        result = (HandleGetJSON(NodePath, FilePath) == EXIT_SUCCESS) ? LE_OK : LE_FAULT;
     }
     else
     {
+        int fd = open(FilePath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+
+        if (fd == -1)
+        {
+            fprintf(stderr, "Could not open '%s': %s\n", FilePath, strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        // The descriptor is closed once it has been sent.
         le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
-        result = le_cfgAdmin_ExportTree(iterRef, FilePath, "");
+        result = le_cfgAdmin_ExportTreeStream(iterRef, fd, "", TreeFormat);
         le_cfg_CancelTxn(iterRef);
     }
 
@@ -1332,6 +1223,40 @@ static int HandleDeleteTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Handle the stats command.  The config tree writes its report straight to our standard out.
+ *
+ *  @return EXIT_SUCCESS if the command completes properly.  EXIT_FAILURE otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static int HandleStats
+(
+    void
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Make sure anything we've printed ourselves goes out ahead of the report.
+    fflush(stdout);
+
+    le_result_t result = le_cfgAdmin_DumpStats(STDOUT_FILENO, UseJson);
+
+    if (result != LE_OK)
+    {
+        fprintf(stderr, "Could not report the config tree stats: %s.\n", LE_RESULT_TXT(result));
+        return EXIT_FAILURE;
+    }
+
+    if (ResetStats)
+    {
+        le_cfgAdmin_ResetStats();
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Function called when a data type is found on the command line.
@@ -1364,6 +1289,11 @@ static void FormatArgHandler
     if (strcmp(format, "json") == 0)
     {
         UseJson = true;
+        TreeFormat = LE_CFGADMIN_FORMAT_JSON;
+    }
+    else if (strcmp(format, "snapshot") == 0)
+    {
+        TreeFormat = LE_CFGADMIN_FORMAT_SNAPSHOT;
     }
     else
     {
@@ -1561,6 +1491,14 @@ static void CommandArgHandler
         // The only parameter is the tree name.
         le_arg_AddPositionalCallback(TreeNameArgHandler);
     }
+    else if (strcmp(command, "stats") == 0)
+    {
+        CommandHandler = HandleStats;
+
+        // No positional parameters, only the options.
+        le_arg_SetFlagVar(&ResetStats, NULL, "reset");
+        le_arg_SetStringCallback(FormatArgHandler, NULL, "format");
+    }
     else if (strcmp(command, "help") == 0)
     {
         PrintHelpAndExit();
@@ -2,7 +2,8 @@
 /** @file inspect.c
  *
  * Legato inspection tool used to inspect Legato structures such as memory pools, timers, threads,
- * mutexes, etc. in running processes.
+ * mutexes, etc. in running processes.  It also prints the framework's start-up trace, and the
+ * config tree's performance counters.
  *
  * Must be run as root.
  *
@@ -21,13 +22,16 @@
 #include "limit.h"
 #include "addr.h"
 #include "fileDescriptor.h"
+#include "startupTrace.h"
+#include "procStats.h"
+#include "interfaces.h"
 
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Objects of these types are used to refer to lists of memory pools, thread objects, timers,
- * mutexes, semaphores, and service objects. They can be used to iterate over those lists in a
- * remote process.
+ * mutexes, semaphores, reader-writer locks, and service objects. They can be used to iterate over
+ * those lists in a remote process.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct MemPoolIter*         MemPoolIter_Ref_t;
@@ -35,6 +39,7 @@ typedef struct ThreadObjIter*       ThreadObjIter_Ref_t;
 typedef struct TimerIter*           TimerIter_Ref_t;
 typedef struct MutexIter*           MutexIter_Ref_t;
 typedef struct SemaphoreIter*       SemaphoreIter_Ref_t;
+typedef struct RwLockIter*          RwLockIter_Ref_t;
 typedef struct ThreadMemberObjIter* ThreadMemberObjIter_Ref_t;
 typedef struct ServiceObjIter*      ServiceObjIter_Ref_t;
 typedef struct ClientObjIter*       ClientObjIter_Ref_t;
@@ -54,10 +59,12 @@ typedef enum
     INSPECT_INSP_TYPE_TIMER,
     INSPECT_INSP_TYPE_MUTEX,
     INSPECT_INSP_TYPE_SEMAPHORE,
+    INSPECT_INSP_TYPE_RWLOCK,
     INSPECT_INSP_TYPE_IPC_SERVERS,
     INSPECT_INSP_TYPE_IPC_CLIENTS,
     INSPECT_INSP_TYPE_IPC_SERVERS_SESSIONS,
-    INSPECT_INSP_TYPE_IPC_CLIENTS_SESSIONS
+    INSPECT_INSP_TYPE_IPC_CLIENTS_SESSIONS,
+    INSPECT_INSP_TYPE_STATS
 }
 InspType_t;
 
@@ -137,6 +144,13 @@ typedef struct SemaphoreIter
 }
 SemaphoreIter_t;
 
+typedef struct RwLockIter
+{
+    RemoteListAccess_t rwLockList;  ///< Reader-writer lock list in the remote process.
+    RwLock_t currRwLock;            ///< Current reader-writer lock from the list.
+}
+RwLockIter_t;
+
 // Type describing the commonalities of the thread memeber objects - namely timer, mutex, and
 // semaphore.
 typedef struct ThreadMemberObjIter
@@ -231,6 +245,28 @@ static le_mem_PoolRef_t IteratorPool;
 #define DEFAULT_RETRY_INTERVAL              500000
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times the stats page is read before giving up on getting a consistent snapshot, and
+ * the delay between two attempts, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATS_READ_MAX_ATTEMPTS             10
+#define STATS_READ_RETRY_DELAY              1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the strings showing latency histograms (of sessions and event loops): a 32-bit count
+ * for each bucket, separated by slashes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LATENCY_STR_BYTES                   (11 * ((MSG_SESSION_LATENCY_BUCKETS >               \
+                                                    EVENT_LATENCY_BUCKETS) ?                    \
+                                                   MSG_SESSION_LATENCY_BUCKETS :                \
+                                                   EVENT_LATENCY_BUCKETS))
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Variable storing the configurable refresh interval in seconds.
@@ -263,6 +299,14 @@ static pid_t PidToInspect = -1;
 static int FdProcMem = -1;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Snapshot of the stats page of the process under inspection.
+ */
+//--------------------------------------------------------------------------------------------------
+static procStats_Page_t StatsPage;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Indicating if the Inspect results are output as the JSON format or not. Currently false implies
@@ -297,6 +341,47 @@ static bool IsFollowing = false;
 static bool IsVerbose = false;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * true = print the start-up trace rather than inspect a process.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsStartupTrace = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true = print the config tree's performance counters rather than inspect a process.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsConfigStats = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of entries that can be read from the start-up trace.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MAX_STARTUP_TRACE_ENTRIES   (STARTUP_TRACE_MAX_FILE_BYTES / 16)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start-up trace entry.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t    timeUs;     ///< Time of the event, in microseconds since boot.
+    const char* pidPtr;     ///< PID.
+    const char* namePtr;    ///< Process name.
+    const char* eventPtr;   ///< Event name.
+    const char* detailPtr;  ///< Extra detail.
+    size_t      index;      ///< Position in the file, to keep the sort stable.
+}
+StartupTraceEntry_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Flags indicating how an inspection ended.
@@ -638,6 +723,49 @@ static SemaphoreIter_Ref_t CreateSemaphoreIter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over the list of reader-writer locks for a
+ * specific process. See the comment block for CreateMemPoolIter for additional detail.
+ *
+ * @return
+ *      An iterator to the list of reader-writer locks for the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static RwLockIter_Ref_t CreateRwLockIter
+(
+    void
+)
+{
+    // Get the address offset of the lock list for the process to inspect.
+    off_t listAddrOffset = GetRemoteAddress(PidToInspect, rwlock_GetRwLockList());
+
+    // Get the address offset of the lock list change counter for the process to inspect.
+    off_t listChgCntAddrOffset = GetRemoteAddress(PidToInspect, rwlock_GetRwLockListChgCntRef());
+
+    // Create the iterator.
+    RwLockIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    InitRemoteListAccessObj(&iteratorPtr->rwLockList);
+
+    // Get the List for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listAddrOffset, &(iteratorPtr->rwLockList.List),
+                             sizeof(iteratorPtr->rwLockList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("rwlock list"));
+    }
+
+    // Get the ListChgCntRef for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
+                          &(iteratorPtr->rwLockList.ListChgCntRef),
+                          sizeof(iteratorPtr->rwLockList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("rwlock list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an iterator that can be used to iterate over the map of interface objects. See the
@@ -837,6 +965,30 @@ static size_t GetMemPoolListChgCnt
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the reader-writer lock list change counter from the specified iterator.
+ *
+ * @return
+ *      List change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetRwLockListChgCnt
+(
+    RwLockIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t rwLockListChgCnt;
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->rwLockList.ListChgCntRef),
+                          &rwLockListChgCnt, sizeof(rwLockListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("rwlock list change counter"));
+    }
+
+    return rwLockListChgCnt;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the thread object list change counter from the specified iterator.
@@ -1339,6 +1491,42 @@ static Semaphore_t* GetNextSemaphore
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next reader-writer lock from the specified iterator. For other detail see
+ * GetNextMemPool.
+ *
+ * @return
+ *      A reader-writer lock from the iterator's list of locks.
+ */
+//--------------------------------------------------------------------------------------------------
+static RwLock_t* GetNextRwLock
+(
+    RwLockIter_Ref_t rwLockIterRef ///< [IN] The iterator to get the next lock from.
+)
+{
+    le_dls_Link_t* linkPtr = GetNextLink(&(rwLockIterRef->rwLockList),
+                                         &(rwLockIterRef->currRwLock.rwLockListLink));
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Get the address of the lock.
+    RwLock_t* rwLockPtr = CONTAINER_OF(linkPtr, RwLock_t, rwLockListLink);
+
+    // Read the lock into our own memory.
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)rwLockPtr, &(rwLockIterRef->currRwLock),
+                          sizeof(rwLockIterRef->currRwLock)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("rwlock object"));
+    }
+
+    return &(rwLockIterRef->currRwLock);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the pointer to the next interface instance object. For other detail see GetNextMemPool.
@@ -1555,20 +1743,56 @@ static void PrintHelp
         "              Legato process.\n"
         "\n"
         "SYNOPSIS:\n"
-        "    inspect <pools|threads|timers|mutexes|semaphores> [OPTIONS] PID\n"
+        "    inspect <pools|threads|timers|mutexes|semaphores|rwlocks> [OPTIONS] PID\n"
         "    inspect ipc <servers|clients [sessions]> [OPTIONS] PID\n"
+        "    inspect stats [OPTIONS] PID\n"
+        "    inspect startup [--format=json]\n"
+        "    inspect config [--format=json]\n"
         "\n"
         "DESCRIPTION:\n"
         "    inspect pools              Prints the memory pools usage for the specified process.\n"
         "    inspect threads            Prints the info of threads for the specified process.\n"
+        "                               If the process runs with LE_EVENT_SLOW_HANDLER_MS set,"
+                                        " verbose mode also\n"
+        "                               shows how many events each thread's event loop has"
+                                        " handled, histograms\n"
+        "                               of how long they waited in the queue and how long their"
+                                        " handlers ran\n"
+        "                               (under 100us/1ms/10ms/100ms, and 100ms or more), the"
+                                        " longest handler run,\n"
+        "                               and how many runs reached the slow handler"
+                                        " threshold.\n"
         "    inspect timers             Prints the info of timers in all threads for the"
                                         " specified process.\n"
         "    inspect mutexes            Prints the info of mutexes in all threads for the"
                                         " specified process.\n"
         "    inspect semaphores         Prints the info of semaphores in all threads for the"
                                         " specified process.\n"
-        "    inspect ipc                Prints the info of ipc in all threads for the"
+        "    inspect rwlocks            Prints the info of reader-writer locks for the"
                                         " specified process.\n"
+        "    inspect ipc                Prints the info of ipc in all threads for the"
+                                        " specified process.  In verbose\n"
+        "                               mode, sessions also show the messages and bytes"
+                                        " sent and received,\n"
+        "                               the transmit queue depth, how often sending had to"
+                                        " wait for the\n"
+        "                               socket, and a histogram of synchronous request"
+                                        " latencies\n"
+        "                               (under 100us/1ms/10ms/100ms, and 100ms or more).\n"
+        "    inspect stats              Prints the object counters and memory pools of the"
+                                        " specified process,\n"
+        "                               read in a single consistent snapshot.\n"
+        "    inspect startup            Prints the start-up timeline of the framework's"
+                                        " processes: when each\n"
+        "                               one was forked and exec'd, first entered its event"
+                                        " loop, finished\n"
+        "                               its component initialization and first advertised"
+                                        " a service.\n"
+        "    inspect config             Prints the config tree's performance counters, per"
+                                        " tree and per client:\n"
+        "                               quick gets and sets, transactions, commit times,"
+                                        " bytes written and\n"
+        "                               requests that had to wait for a transaction.\n"
         "\n"
         "OPTIONS:\n"
         "    -f\n"
@@ -1658,6 +1882,7 @@ static ColumnInfo_t MemPoolTableInfo[] =
     {"ALLOCS",      "%*s",  NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, true},
     {"BLK BYTES",   "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"USED BYTES",  "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
+    {"REGION RSS",  "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"MEMORY POOL", "%-*s", NULL, "%-*s",       LIMIT_MAX_MEM_POOL_NAME_LEN, true,  0, true},
     {"SUB-POOL",    "%*s",  NULL, "%*s",        0,                           true,  0, true}
 };
@@ -1675,7 +1900,14 @@ static ColumnInfo_t ThreadObjTableInfo[] =
     {"CONTENTION SCOPE", "%*s", NULL, "%*s",  0,                    true,  0, true},
     {"GUARD SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true},
     {"STACK ADDR",       "%*s", NULL, "%*X",  sizeof(uint64_t),     false, 0, true},
-    {"STACK SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true}
+    {"STACK SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true},
+    {"TIMER WAKEUPS",    "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, true},
+    {"TIMER EXPIRIES",   "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, true},
+    {"EVENTS",           "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false},
+    {"QUEUE WAIT",       "%*s", NULL, "%*s",  LATENCY_STR_BYTES - 1,  true,  0, false},
+    {"HANDLER RUN",      "%*s", NULL, "%*s",  LATENCY_STR_BYTES - 1,  true,  0, false},
+    {"MAX RUN US",       "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false},
+    {"SLOW HANDLERS",    "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t), false, 0, false}
 };
 static size_t ThreadObjTableInfoSize = NUM_ARRAY_MEMBERS(ThreadObjTableInfo);
 
@@ -1686,7 +1918,8 @@ static ColumnInfo_t TimerTableInfo[] =
     {"REPEAT COUNT", "%*s", NULL, "%*u",  sizeof(uint32_t),           false, 0, true},
     {"ISACTIVE",     "%*s", NULL, "%*u",  sizeof(bool),               false, 0, true},
     {"EXPIRY TIME",  "%*s", NULL, "%*f",  sizeof(double),             false, 0, true},
-    {"EXPIRY COUNT", "%*s", NULL, "%*u",  sizeof(uint32_t),           false, 0, true}
+    {"EXPIRY COUNT", "%*s", NULL, "%*u",  sizeof(uint32_t),           false, 0, true},
+    {"TOLERANCE",    "%*s", NULL, "%*f",  sizeof(double),             false, 0, true}
 };
 static size_t TimerTableInfoSize = NUM_ARRAY_MEMBERS(TimerTableInfo);
 
@@ -1695,7 +1928,10 @@ static ColumnInfo_t MutexTableInfo[] =
     {"NAME",         "%*s", NULL, "%*s", MAX_NAME_BYTES,       true,  0, true},
     {"LOCK COUNT",   "%*s", NULL, "%*d", sizeof(int),          false, 0, true},
     {"RECURSIVE",    "%*s", NULL, "%*u", sizeof(bool),         false, 0, true},
-    {"WAITING LIST", "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE, true,  0, true}
+    {"WAITING LIST", "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE, true,  0, true},
+    {"CONTENDED",    "%*s", NULL, "%*u", sizeof(uint32_t),     false, 0, false},
+    {"WAIT US",      "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false},
+    {"MAX WAIT US",  "%*s", NULL, "%*u", sizeof(uint32_t),     false, 0, false}
 };
 static size_t MutexTableInfoSize = NUM_ARRAY_MEMBERS(MutexTableInfo);
 
@@ -1706,6 +1942,16 @@ static ColumnInfo_t SemaphoreTableInfo[] =
 };
 static size_t SemaphoreTableInfoSize = NUM_ARRAY_MEMBERS(SemaphoreTableInfo);
 
+static ColumnInfo_t RwLockTableInfo[] =
+{
+    {"NAME",         "%*s", NULL, "%*s", RWLOCK_MAX_NAME_BYTES, true,  0, true},
+    {"READERS",      "%*s", NULL, "%*u", sizeof(uint32_t),      false, 0, true},
+    {"WRITER",       "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,  true,  0, true},
+    {"WAITING LIST", "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,  true,  0, true},
+    {"CONTENDED",    "%*s", NULL, "%*u", sizeof(uint32_t),      false, 0, false}
+};
+static size_t RwLockTableInfoSize = NUM_ARRAY_MEMBERS(RwLockTableInfo);
+
 static ColumnInfo_t ServiceObjTableInfo[] =
 {
     {"INTERFACE NAME", "%*s", NULL, "%*s",  LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
@@ -1730,7 +1976,17 @@ static ColumnInfo_t SessionObjTableInfo[] =
     {"INTERFACE NAME", "%*s", NULL, "%*s", LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
     {"STATE",          "%*s", NULL, "%*s", 0,                                  true,  0, true},
     {"THREAD NAME",    "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,               true,  0, true},
-    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false}
+    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false},
+    {"MSGS TX",        "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, false},
+    {"BYTES TX",       "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, false},
+    {"MSGS RX",        "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, false},
+    {"BYTES RX",       "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, false},
+    {"TXQ",            "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t),            false, 0, false},
+    {"TXQ MAX",        "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t),            false, 0, false},
+    {"STALLS",         "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t),            false, 0, false},
+    {"TXQ WAIT US",    "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t),            false, 0, false},
+    {"HI TXQ WAIT US", "%*s", NULL, "%*"PRIu32"", sizeof(uint32_t),            false, 0, false},
+    {"SYNC LATENCY",   "%*s", NULL, "%*s", LATENCY_STR_BYTES - 1,              true,  0, false}
 };
 static size_t SessionObjTableInfoSize = NUM_ARRAY_MEMBERS(SessionObjTableInfo);
 
@@ -2034,6 +2290,7 @@ static void InitDisplay
     switch (inspectType)
     {
         case INSPECT_INSP_TYPE_MEM_POOL:
+        case INSPECT_INSP_TYPE_STATS:
             // Initialize the display tables with the optimal column widths.
             InitDisplayTable(MemPoolTableInfo, MemPoolTableInfoSize);
             break;
@@ -2054,6 +2311,10 @@ static void InitDisplay
             InitDisplayTable(SemaphoreTableInfo, SemaphoreTableInfoSize);
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            InitDisplayTable(RwLockTableInfo, RwLockTableInfoSize);
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             InitDisplayTable(ServiceObjTableInfo, ServiceObjTableInfoSize);
             break;
@@ -2249,6 +2510,12 @@ static int PrintInspectHeader
             tableSize = SemaphoreTableInfoSize;
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            strncpy(inspectTypeString, "Reader-Writer Locks", inspectTypeStringSize);
+            table = RwLockTableInfo;
+            tableSize = RwLockTableInfoSize;
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             strncpy(inspectTypeString, "IPC Server Interface", inspectTypeStringSize);
             table = ServiceObjTableInfo;
@@ -2273,6 +2540,12 @@ static int PrintInspectHeader
             tableSize = SessionObjTableInfoSize;
             break;
 
+        case INSPECT_INSP_TYPE_STATS:
+            strncpy(inspectTypeString, "Process Statistics", inspectTypeStringSize);
+            table = MemPoolTableInfo;
+            tableSize = MemPoolTableInfoSize;
+            break;
+
         default:
             INTERNAL_ERR("unexpected inspect type %d.", InspectType);
     }
@@ -2288,6 +2561,20 @@ static int PrintInspectHeader
         printf("Inspecting process %d\n", PidToInspect);
         lineCount++;
 
+        if (InspectType == INSPECT_INSP_TYPE_STATS)
+        {
+            const uint32_t* counters = StatsPage.counters;
+
+            printf("Threads: %" PRIu32 "  Running timers: %" PRIu32 "  RW locks: %" PRIu32
+                   "  Services: %" PRIu32 "  Client interfaces: %" PRIu32
+                   "  Sessions: %" PRIu32 "  Unlisted pools: %" PRIu32 "\n",
+                   counters[PROCSTATS_THREADS], counters[PROCSTATS_RUNNING_TIMERS],
+                   counters[PROCSTATS_RWLOCKS], counters[PROCSTATS_SERVICES],
+                   counters[PROCSTATS_CLIENT_INTERFACES], counters[PROCSTATS_SESSIONS],
+                   counters[PROCSTATS_UNLISTED_POOLS]);
+            lineCount++;
+        }
+
         // Print column headers.
         PrintHeader(table, tableSize);
         lineCount++;
@@ -2320,6 +2607,20 @@ static int PrintInspectHeader
 
         printf("],");
 
+        if (InspectType == INSPECT_INSP_TYPE_STATS)
+        {
+            const uint32_t* counters = StatsPage.counters;
+
+            printf("\"Counters\":{\"Threads\":%" PRIu32 ",\"RunningTimers\":%" PRIu32
+                   ",\"RwLocks\":%" PRIu32 ",\"Services\":%" PRIu32
+                   ",\"ClientInterfaces\":%" PRIu32 ",\"Sessions\":%" PRIu32
+                   ",\"UnlistedPools\":%" PRIu32 "},",
+                   counters[PROCSTATS_THREADS], counters[PROCSTATS_RUNNING_TIMERS],
+                   counters[PROCSTATS_RWLOCKS], counters[PROCSTATS_SERVICES],
+                   counters[PROCSTATS_CLIENT_INTERFACES], counters[PROCSTATS_SESSIONS],
+                   counters[PROCSTATS_UNLISTED_POOLS]);
+        }
+
         // Print the data of "InspectType", "PID", and the beginning of "Data".
         printf("\"InspectType\":\"%s\",\"PID\":\"%d\",\"Data\":[", inspectTypeString, PidToInspect);
     }
@@ -2712,6 +3013,77 @@ static void FillBoolColField
 static bool IsPrintedNodeFirst = true;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes of a memory pool's reserved region (see le_mem_ReserveRegion()) that
+ * are resident in RAM, by looking up the region's pages in the inspected process's page map.
+ *
+ * @return
+ *      The number of resident bytes, or 0 if the pool has no region or the page map can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetRegionRss
+(
+    le_mem_PoolRef_t memPool    ///< [IN] Local copy of the pool.
+)
+{
+    size_t numResidentPages = 0;
+
+#ifndef LE_MEM_VALGRIND
+    if (memPool->regionPtr == NULL)
+    {
+        return 0;
+    }
+
+    char pagemapPath[LIMIT_MAX_PATH_BYTES];
+    snprintf(pagemapPath, sizeof(pagemapPath), "/proc/%d/pagemap", PidToInspect);
+
+    int fd = open(pagemapPath, O_RDONLY);
+    if (fd == -1)
+    {
+        return 0;
+    }
+
+    // Each page has a 64-bit entry in the page map, whose top bit is set if it's in RAM.
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t numPages = memPool->regionSize / pageSize;
+    off_t offset = ((uintptr_t)memPool->regionPtr / pageSize) * sizeof(uint64_t);
+    uint64_t entries[512];
+
+    while (numPages > 0)
+    {
+        size_t numEntries = (numPages < NUM_ARRAY_MEMBERS(entries)) ? numPages
+                                                                    : NUM_ARRAY_MEMBERS(entries);
+        ssize_t readSize = pread(fd, entries, numEntries * sizeof(uint64_t), offset);
+        if (readSize <= 0)
+        {
+            break;
+        }
+
+        numEntries = readSize / sizeof(uint64_t);
+
+        size_t i;
+        for (i = 0; i < numEntries; i++)
+        {
+            if (entries[i] & (1ULL << 63))
+            {
+                numResidentPages++;
+            }
+        }
+
+        numPages -= numEntries;
+        offset += readSize;
+    }
+
+    fd_Close(fd);
+
+    return numResidentPages * pageSize;
+#else
+    return numResidentPages;
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print memory pool information to stdout.
@@ -2760,6 +3132,8 @@ static int PrintMemPoolInfo
                                                                  MemPoolTableInfoSize, &index);
         FillSizeTColField (blockSize*(poolStats.numBlocksInUse), MemPoolTableInfo,
                                                                  MemPoolTableInfoSize, &index);
+        FillSizeTColField (GetRegionRss(memPool),                MemPoolTableInfo,
+                                                                 MemPoolTableInfoSize, &index);
         FillStrColField   (name,                                 MemPoolTableInfo,
                                                                  MemPoolTableInfoSize, &index);
         FillStrColField   (subPoolStr,                           MemPoolTableInfo,
@@ -2798,6 +3172,8 @@ static int PrintMemPoolInfo
                                                             MemPoolTableInfoSize, &index, &printed);
         ExportSizeTToJson (blockSize*(poolStats.numBlocksInUse), MemPoolTableInfo,
                                                             MemPoolTableInfoSize, &index, &printed);
+        ExportSizeTToJson (GetRegionRss(memPool),           MemPoolTableInfo,
+                                                            MemPoolTableInfoSize, &index, &printed);
         ExportStrToJson   (name,                            MemPoolTableInfo,
                                                             MemPoolTableInfoSize, &index, &printed);
         ExportStrToJson   (subPoolStr,                      MemPoolTableInfo,
@@ -2810,6 +3186,31 @@ static int PrintMemPoolInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a latency histogram as its bucket counts separated by slashes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatLatencyHistogram
+(
+    char* bufPtr,                   ///< [OUT] Buffer of LATENCY_STR_BYTES bytes.
+    const uint32_t* histogramPtr,   ///< [IN] Bucket counts.
+    size_t numBuckets               ///< [IN] Number of buckets.
+)
+{
+    size_t len = 0;
+    size_t i;
+
+    bufPtr[0] = '\0';
+
+    for (i = 0; (i < numBuckets) && (len < LATENCY_STR_BYTES); i++)
+    {
+        len += snprintf(bufPtr + len, LATENCY_STR_BYTES - len,
+                        (i == 0) ? "%" PRIu32 : "/%" PRIu32, histogramPtr[i]);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print thread obj information to stdout.
@@ -2865,6 +3266,13 @@ static int PrintThreadObjInfo
         INTERNAL_ERR("pthread_attr_getguardsize failed.");
     }
 
+    // Event loop profile (all zeroes unless the process runs with LE_EVENT_SLOW_HANDLER_MS set).
+    const event_Stats_t* eventStatsPtr = &threadObjRef->eventRec.stats;
+    char queueWaitStr[LATENCY_STR_BYTES];
+    char handlerRunStr[LATENCY_STR_BYTES];
+    FormatLatencyHistogram(queueWaitStr, eventStatsPtr->queueWait, EVENT_LATENCY_BUCKETS);
+    FormatLatencyHistogram(handlerRunStr, eventStatsPtr->handlerRun, EVENT_LATENCY_BUCKETS);
+
     uint32_t stackAddr[1]; // Need to handle both 32 and 64-bit platforms
     size_t stackSize;
     if (pthread_attr_getstack(&threadObjRef->attr, (void**)&stackAddr, &stackSize) != 0)
@@ -2899,6 +3307,20 @@ static int PrintThreadObjInfo
                                                                     ThreadObjTableInfoSize, &index);
         FillSizeTColField (stackSize,                               ThreadObjTableInfo,
                                                                     ThreadObjTableInfoSize, &index);
+        FillUint64ColField(threadObjRef->timerRec.wakeupCount,      ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(threadObjRef->timerRec.expiryCount,      ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(eventStatsPtr->numReports,               ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillStrColField   (queueWaitStr,                            ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillStrColField   (handlerRunStr,                           ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(eventStatsPtr->maxRunUs,                 ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint32ColField(eventStatsPtr->numSlowHandlers,          ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
 
         PrintInfo(ThreadObjTableInfo, ThreadObjTableInfoSize);
         lineCount++;
@@ -2941,6 +3363,20 @@ static int PrintThreadObjInfo
                                                           ThreadObjTableInfoSize, &index, &printed);
         ExportSizeTToJson (stackSize,                     ThreadObjTableInfo,
                                                           ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadObjRef->timerRec.wakeupCount, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadObjRef->timerRec.expiryCount, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(eventStatsPtr->numReports,     ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportStrToJson   (queueWaitStr,                  ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportStrToJson   (handlerRunStr,                 ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(eventStatsPtr->maxRunUs,       ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(eventStatsPtr->numSlowHandlers, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -2963,6 +3399,8 @@ static int PrintTimerInfo
     double interval = (double)timerRef->interval.sec + ((double)timerRef->interval.usec / 1000000);
     double expiryTime = (double)timerRef->expiryTime.sec +
                         ((double)timerRef->expiryTime.usec / 1000000);
+    double tolerance = (double)timerRef->tolerance.sec +
+                       ((double)timerRef->tolerance.usec / 1000000);
 
     // Output timer info
     int index = 0;
@@ -2975,6 +3413,7 @@ static int PrintTimerInfo
         FillBoolColField  (timerRef->isActive,    TimerTableInfo, TimerTableInfoSize, &index);
         FillDoubleColField(expiryTime,            TimerTableInfo, TimerTableInfoSize, &index);
         FillUint32ColField(timerRef->expiryCount, TimerTableInfo, TimerTableInfoSize, &index);
+        FillDoubleColField(tolerance,             TimerTableInfo, TimerTableInfoSize, &index);
 
         PrintInfo(TimerTableInfo, TimerTableInfoSize);
         lineCount++;
@@ -3007,6 +3446,8 @@ static int PrintTimerInfo
                                                   TimerTableInfoSize, &index, &printed);
         ExportUint32ToJson(timerRef->expiryCount, TimerTableInfo,
                                                   TimerTableInfoSize, &index, &printed);
+        ExportDoubleToJson(tolerance,             TimerTableInfo,
+                                                  TimerTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3056,7 +3497,25 @@ static thread_Obj_t* GetThreadPtrFromSemLink
     return CONTAINER_OF(currNodePtr, thread_Obj_t, semaphoreRec);
 }
 
-// Retrieve the waiting list link from a mutex or semaphore thread record.
+// Given a waiting list link ptr, get a ptr to the thread record
+static void* GetRwLockThreadRecPtr
+(
+    le_dls_Link_t* currNodeLinkPtr  ///< [IN] waiting list link ptr.
+)
+{
+    return CONTAINER_OF(currNodeLinkPtr, rwlock_ThreadRec_t, waitingListLink);
+}
+
+// Given a thread rec ptr, get a ptr to the thread obj
+static thread_Obj_t* GetThreadPtrFromRwLockLink
+(
+    void* currNodePtr    ///< [IN] thread record ptr.
+)
+{
+    return CONTAINER_OF(currNodePtr, thread_Obj_t, rwLockRec);
+}
+
+// Retrieve the waiting list link from a mutex, semaphore or reader-writer lock thread record.
 static le_dls_Link_t GetWaitingListLink
 (
     InspType_t inspectType, ///< [IN] What to inspect.
@@ -3073,6 +3532,10 @@ static le_dls_Link_t GetWaitingListLink
             return ((sem_ThreadRec_t*)threadRecPtr)->waitingListLink;
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            return ((rwlock_ThreadRec_t*)threadRecPtr)->waitingListLink;
+            break;
+
         default:
             INTERNAL_ERR("Failed to get the waiting list link - unexpected inspect type %d.",
                          inspectType);
@@ -3103,6 +3566,7 @@ static void GetWaitingListThreadNames
     {
         mutex_ThreadRec_t m;
         sem_ThreadRec_t s;
+        rwlock_ThreadRec_t r;
     }
     ThreadRec_t;
 
@@ -3122,6 +3586,12 @@ static void GetWaitingListThreadNames
             threadRecSize = sizeof(sem_ThreadRec_t);
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            getThreadRecPtrFunc      = GetRwLockThreadRecPtr;
+            getThreadPtrFromLinkFunc = GetThreadPtrFromRwLockLink;
+            threadRecSize = sizeof(rwlock_ThreadRec_t);
+            break;
+
         default:
             INTERNAL_ERR("Failed to get the waiting list link - unexpected inspect type %d.",
                          inspectType);
@@ -3275,6 +3745,9 @@ static int PrintMutexInfo
         FillIntColField (mutexRef->lockCount,   MutexTableInfo, MutexTableInfoSize, &index);
         FillBoolColField(mutexRef->isRecursive, MutexTableInfo, MutexTableInfoSize, &index);
         FillStrColField (waitingThreadNames[0], MutexTableInfo, MutexTableInfoSize, &index);
+        FillUint32ColField(mutexRef->contentionCount, MutexTableInfo, MutexTableInfoSize, &index);
+        FillUint64ColField(mutexRef->waitTimeUs,      MutexTableInfo, MutexTableInfoSize, &index);
+        FillUint32ColField(mutexRef->maxWaitUs,       MutexTableInfo, MutexTableInfoSize, &index);
 
         PrintInfo(MutexTableInfo, MutexTableInfoSize);
         lineCount++;
@@ -3316,6 +3789,12 @@ static int PrintMutexInfo
                                                   MutexTableInfoSize, &index, &printed);
         ExportArrayToJson(waitingThreadJsonArray, MutexTableInfo,
                                                   MutexTableInfoSize, &index, &printed);
+        ExportUint32ToJson(mutexRef->contentionCount, MutexTableInfo,
+                                                  MutexTableInfoSize, &index, &printed);
+        ExportUint64ToJson(mutexRef->waitTimeUs,  MutexTableInfo,
+                                                  MutexTableInfoSize, &index, &printed);
+        ExportUint32ToJson(mutexRef->maxWaitUs,   MutexTableInfo,
+                                                  MutexTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3433,6 +3912,95 @@ static void LookupThreadName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print reader-writer lock information to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintRwLockInfo
+(
+    RwLock_t* rwLockRef   ///< [IN] ref to reader-writer lock to be printed.
+)
+{
+    int lineCount = 0;
+
+    #define MAX_THREADS 400 // should be plenty; with an AR7 only 379 threads can be created.
+    char* waitingThreadNames[MAX_THREADS] = {0};
+    int i = 0;
+    GetWaitingListThreadNames(INSPECT_INSP_TYPE_RWLOCK, rwLockRef->waitingList,
+                              waitingThreadNames, MAX_THREADS, &i);
+
+    // The state word counts the readers in its low bits.
+    uint32_t readers = rwLockRef->state & 0x3FFFFFFF;
+
+    char writerName[MAX_THREAD_NAME_SIZE] = "";
+    if (rwLockRef->writingThreadRef != NULL)
+    {
+        LookupThreadName((size_t)rwLockRef->writingThreadRef, writerName, sizeof(writerName));
+    }
+
+    // Output reader-writer lock info
+    int index = 0;
+
+    if (!IsOutputJson)
+    {
+        FillStrColField   (rwLockRef->name,          RwLockTableInfo, RwLockTableInfoSize, &index);
+        FillUint32ColField(readers,                  RwLockTableInfo, RwLockTableInfoSize, &index);
+        FillStrColField   (writerName,               RwLockTableInfo, RwLockTableInfoSize, &index);
+        FillStrColField   (waitingThreadNames[0],    RwLockTableInfo, RwLockTableInfoSize, &index);
+        FillUint32ColField(rwLockRef->contentionCount,
+                                                     RwLockTableInfo, RwLockTableInfoSize, &index);
+
+        PrintInfo(RwLockTableInfo, RwLockTableInfoSize);
+        lineCount++;
+
+        int j;
+        for (j = 1; j < i; j++)
+        {
+            PrintUnderColumn("WAITING LIST", RwLockTableInfo, RwLockTableInfoSize,
+                             waitingThreadNames[j]);
+            lineCount++;
+        }
+    }
+    else
+    {
+        int waitingThreadJsonArraySize = EstimateJsonArraySizeFromStrings(waitingThreadNames, i);
+        char waitingThreadJsonArray[waitingThreadJsonArraySize];
+        ConstructJsonArrayFromStrings(waitingThreadNames, i, waitingThreadJsonArray,
+                                      waitingThreadJsonArraySize);
+
+        // If it's not the first time, print a comma.
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+
+        printf("[");
+
+        ExportStrToJson   (rwLockRef->name,           RwLockTableInfo,
+                                                      RwLockTableInfoSize, &index, &printed);
+        ExportUint32ToJson(readers,                   RwLockTableInfo,
+                                                      RwLockTableInfoSize, &index, &printed);
+        ExportStrToJson   (writerName,                RwLockTableInfo,
+                                                      RwLockTableInfoSize, &index, &printed);
+        ExportArrayToJson (waitingThreadJsonArray,    RwLockTableInfo,
+                                                      RwLockTableInfoSize, &index, &printed);
+        ExportUint32ToJson(rwLockRef->contentionCount, RwLockTableInfo,
+                                                      RwLockTableInfoSize, &index, &printed);
+
+        printf("]");
+    }
+
+    return lineCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print service object information to stdout.
@@ -3595,6 +4163,10 @@ static int PrintSessionObjInfo
 )
 {
     int lineCount = 0;
+    const msgSession_Stats_t* statsPtr = &sessionObjRef->stats;
+
+    char latencyStr[LATENCY_STR_BYTES];
+    FormatLatencyHistogram(latencyStr, statsPtr->syncLatency, MSG_SESSION_LATENCY_BUCKETS);
 
     // Convert the session state to a meaningful string.
     char* sessionStateStr = DefnToStr(sessionObjRef->state, SessionStateTbl, SessionStateTblSize);
@@ -3624,6 +4196,26 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index);
         FillIntColField(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index);
+        FillUint64ColField(statsPtr->msgsSent,   SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint64ColField(statsPtr->bytesSent,  SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint64ColField(statsPtr->msgsReceived, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint64ColField(statsPtr->bytesReceived, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint32ColField(statsPtr->txQueueDepth, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint32ColField(statsPtr->maxTxQueueDepth, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint32ColField(statsPtr->writeStalls, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint32ColField(statsPtr->maxTxWaitUs, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillUint32ColField(statsPtr->maxHighTxWaitUs, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillStrColField(latencyStr,              SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
 
         PrintInfo(SessionObjTableInfo, SessionObjTableInfoSize);
         lineCount++;
@@ -3652,6 +4244,26 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index, &printed);
         ExportIntToJson(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->msgsSent,   SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->bytesSent,  SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->msgsReceived, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->bytesReceived, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(statsPtr->txQueueDepth, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(statsPtr->maxTxQueueDepth, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(statsPtr->writeStalls, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(statsPtr->maxTxWaitUs, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportUint32ToJson(statsPtr->maxHighTxWaitUs, SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportStrToJson(latencyStr,              SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3757,6 +4369,112 @@ static int InspectEndHandling
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a consistent snapshot of the stats page of the process under inspection into StatsPage.
+ *
+ * @return
+ *      true if successful, false if the page kept changing while it was being read.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadStatsPage
+(
+    void
+)
+{
+    off_t pageAddrOffset = GetRemoteAddress(PidToInspect, procStats_GetPage());
+    off_t seqAddrOffset = pageAddrOffset + offsetof(procStats_Page_t, seq);
+    int attempt;
+
+    for (attempt = 0; attempt < STATS_READ_MAX_ATTEMPTS; attempt++)
+    {
+        uint32_t seq;
+
+        if (attempt > 0)
+        {
+            usleep(STATS_READ_RETRY_DELAY);
+        }
+
+        if (fd_ReadFromOffset(FdProcMem, seqAddrOffset, &seq, sizeof(seq)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("stats page sequence number"));
+        }
+
+        // An odd sequence number means the pool table is being changed.
+        if (seq & 1)
+        {
+            continue;
+        }
+
+        if (fd_ReadFromOffset(FdProcMem, pageAddrOffset, &StatsPage, sizeof(StatsPage)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("stats page"));
+        }
+
+        if ((StatsPage.magic != PROCSTATS_MAGIC) || (StatsPage.version != PROCSTATS_VERSION))
+        {
+            fprintf(stderr, "Process %d has no compatible statistics page.\n", PidToInspect);
+            exit(EXIT_FAILURE);
+        }
+
+        if (StatsPage.seq == seq)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the counters and memory pools of the stats page of the process under inspection.
+ *
+ * Unlike the other inspections, which walk the remote lists one object at a time, the whole page is
+ * read at once, so the snapshot is consistent and only takes a few system calls.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InspectStats
+(
+    void
+)
+{
+    static int lineCount = 0;
+
+    bool isConsistent = ReadStatsPage();
+
+    // Print header information.
+    if (!IsOutputJson)
+    {
+        printf("%c[1G", ESCAPE_CHAR);             // Move cursor to the column 1.
+        printf("%c[%dA", ESCAPE_CHAR, lineCount); // Move cursor up to the top of the table.
+        printf("%c[0J", ESCAPE_CHAR);             // Clear Screen.
+    }
+
+    lineCount = PrintInspectHeader();
+
+    if (isConsistent)
+    {
+        int i;
+
+        for (i = 0; i < PROCSTATS_MAX_POOLS; i++)
+        {
+            if (StatsPage.poolBitmap[i / 32] & ((uint32_t)1 << (i % 32)))
+            {
+                lineCount += PrintMemPoolInfo(&StatsPage.pools[i]);
+            }
+        }
+
+        lineCount += InspectEndHandling(INSPECT_SUCCESS);
+    }
+    else
+    {
+        lineCount += InspectEndHandling(INSPECT_INTERRUPTED);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Performs the specified inspection for the specified process. Prints the results to stdout.
@@ -3781,6 +4499,12 @@ static void InspectFunc
     GetNextNodeFunc_t getNextNodeFunc;
     PrintNodeInfoFunc_t printNodeInfoFunc;
 
+    if (inspectType == INSPECT_INSP_TYPE_STATS)
+    {
+        InspectStats();
+        return;
+    }
+
     // assigns the appropriate set of functions according to the inspection type.
     switch (inspectType)
     {
@@ -3819,6 +4543,13 @@ static void InspectFunc
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintSemaphoreInfo;
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            createIterFunc    = (CreateIterFunc_t)    CreateRwLockIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetRwLockListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextRwLock;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintRwLockInfo;
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             createIterFunc    = (CreateIterFunc_t)    CreateServiceObjIter;
             getListChgCntFunc = (GetListChgCntFunc_t) GetInterfaceObjMapChgCnt;
@@ -4038,17 +4769,33 @@ static void CommandArgHandler
     {
         InspectType = INSPECT_INSP_TYPE_SEMAPHORE;
     }
+    else if (strcmp(command, "rwlocks") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_RWLOCK;
+    }
+    else if (strcmp(command, "stats") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_STATS;
+    }
     else if (strcmp(command, "ipc") == 0)
     {
         le_arg_AddPositionalCallback(IpcInterfaceTypeHandler);
     }
+    else if (strcmp(command, "startup") == 0)
+    {
+        IsStartupTrace = true;
+    }
+    else if (strcmp(command, "config") == 0)
+    {
+        IsConfigStats = true;
+    }
     else
     {
         fprintf(stderr, "Invalid command '%s'.\n", command);
         exit(EXIT_FAILURE);
     }
 
-    if (strcmp(command, "ipc") != 0)
+    if ((strcmp(command, "ipc") != 0) && !IsStartupTrace && !IsConfigStats)
     {
         le_arg_AddPositionalCallback(PidArgHandler);
     }
@@ -4103,6 +4850,184 @@ static void FormatOptionCallback
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares two start-up trace entries by time, for qsort().
+ **/
+//--------------------------------------------------------------------------------------------------
+static int CompareStartupTraceEntries
+(
+    const void* firstPtr,
+    const void* secondPtr
+)
+{
+    const StartupTraceEntry_t* firstEntryPtr = firstPtr;
+    const StartupTraceEntry_t* secondEntryPtr = secondPtr;
+
+    if (firstEntryPtr->timeUs != secondEntryPtr->timeUs)
+    {
+        return (firstEntryPtr->timeUs < secondEntryPtr->timeUs) ? -1 : 1;
+    }
+
+    return (firstEntryPtr->index < secondEntryPtr->index) ? -1 : 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the start-up trace, sorted by time.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintStartupTrace
+(
+    void
+)
+{
+    // The file can go over its maximum size by up to one entry.
+    static char buffer[STARTUP_TRACE_MAX_FILE_BYTES + 1024];
+    static StartupTraceEntry_t entries[MAX_STARTUP_TRACE_ENTRIES];
+
+    int fd = open(STARTUP_TRACE_FILE, O_RDONLY);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "Can't open the start-up trace '%s' (%m).\n", STARTUP_TRACE_FILE);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t size = 0;
+    ssize_t result;
+
+    do
+    {
+        result = read(fd, buffer + size, sizeof(buffer) - 1 - size);
+
+        if (result > 0)
+        {
+            size += result;
+        }
+    }
+    while (((result > 0) && (size < sizeof(buffer) - 1)) || ((result == -1) && (errno == EINTR)));
+
+    fd_Close(fd);
+    buffer[size] = '\0';
+
+    // Split the file into entries.  Incomplete or malformed lines are skipped.
+    size_t numEntries = 0;
+    char* savePtr = NULL;
+    char* linePtr;
+
+    for (linePtr = strtok_r(buffer, "\n", &savePtr);
+         (linePtr != NULL) && (numEntries < MAX_STARTUP_TRACE_ENTRIES);
+         linePtr = strtok_r(NULL, "\n", &savePtr))
+    {
+        StartupTraceEntry_t* entryPtr = &entries[numEntries];
+        char* fieldSavePtr = NULL;
+        char* timePtr = strtok_r(linePtr, " ", &fieldSavePtr);
+        char* endPtr;
+
+        entryPtr->pidPtr = strtok_r(NULL, " ", &fieldSavePtr);
+        entryPtr->namePtr = strtok_r(NULL, " ", &fieldSavePtr);
+        entryPtr->eventPtr = strtok_r(NULL, " ", &fieldSavePtr);
+        entryPtr->detailPtr = strtok_r(NULL, " ", &fieldSavePtr);
+
+        if ((timePtr == NULL) || (entryPtr->detailPtr == NULL))
+        {
+            continue;
+        }
+
+        entryPtr->timeUs = strtoull(timePtr, &endPtr, 10);
+
+        if (*endPtr != '\0')
+        {
+            continue;
+        }
+
+        entryPtr->index = numEntries;
+        numEntries++;
+    }
+
+    qsort(entries, numEntries, sizeof(entries[0]), CompareStartupTraceEntries);
+
+    size_t i;
+
+    if (IsOutputJson)
+    {
+        printf("[");
+
+        for (i = 0; i < numEntries; i++)
+        {
+            printf("%s{\"time\":%" PRIu64 ",\"pid\":%s,\"process\":\"%s\",\"event\":\"%s\"",
+                   (i == 0) ? "" : ",",
+                   entries[i].timeUs,
+                   entries[i].pidPtr,
+                   entries[i].namePtr,
+                   entries[i].eventPtr);
+
+            if (strcmp(entries[i].detailPtr, "-") != 0)
+            {
+                printf(",\"detail\":\"%s\"", entries[i].detailPtr);
+            }
+
+            printf("}");
+        }
+
+        printf("]\n");
+        return;
+    }
+
+    printf("%12s %10s %7s  %-24s %-10s %s\n",
+           "TIME(s)", "DELTA(ms)", "PID", "PROCESS", "EVENT", "DETAIL");
+
+    for (i = 0; i < numEntries; i++)
+    {
+        uint64_t deltaUs = (i == 0) ? 0 : entries[i].timeUs - entries[i - 1].timeUs;
+
+        printf("%5" PRIu64 ".%06" PRIu64 " %6" PRIu64 ".%03" PRIu64 " %7s  %-24s %-10s %s\n",
+               entries[i].timeUs / 1000000,
+               entries[i].timeUs % 1000000,
+               deltaUs / 1000,
+               deltaUs % 1000,
+               entries[i].pidPtr,
+               entries[i].namePtr,
+               entries[i].eventPtr,
+               (strcmp(entries[i].detailPtr, "-") != 0) ? entries[i].detailPtr : "");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the config tree's performance counters.  The config tree writes them straight to our
+ * standard out.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintConfigStats
+(
+    void
+)
+{
+    le_result_t result = le_cfgAdmin_TryConnectService();
+
+    if (result != LE_OK)
+    {
+        fprintf(stderr, "The config tree admin service is not available (%s).\n",
+                LE_RESULT_TXT(result));
+        exit(EXIT_FAILURE);
+    }
+
+    fflush(stdout);
+
+    result = le_cfgAdmin_DumpStats(STDOUT_FILENO, IsOutputJson);
+
+    if (result != LE_OK)
+    {
+        fprintf(stderr, "Could not read the config tree stats (%s).\n", LE_RESULT_TXT(result));
+        exit(EXIT_FAILURE);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a memory pool for the iterators depending on the inspect type.
@@ -4121,6 +5046,10 @@ static void InitIteratorPool
             size = sizeof(MemPoolIter_t);
             break;
 
+        case INSPECT_INSP_TYPE_STATS:
+            // The stats page is read in one go; no iterators are needed.
+            return;
+
         case INSPECT_INSP_TYPE_THREAD_OBJ:
             size = sizeof(ThreadObjIter_t);
             break;
@@ -4137,6 +5066,10 @@ static void InitIteratorPool
             size = sizeof(SemaphoreIter_t);
             break;
 
+        case INSPECT_INSP_TYPE_RWLOCK:
+            size = sizeof(RwLockIter_t);
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             // Make the block size big enough to accomodate either one.
             // Technically a little wasteful.
@@ -4185,6 +5118,18 @@ COMPONENT_INIT
 
     le_arg_Scan();
 
+    if (IsStartupTrace)
+    {
+        PrintStartupTrace();
+        exit(EXIT_SUCCESS);
+    }
+
+    if (IsConfigStats)
+    {
+        PrintConfigStats();
+        exit(EXIT_SUCCESS);
+    }
+
     // Create a memory pool for iterators.
     InitIteratorPool(InspectType);
 
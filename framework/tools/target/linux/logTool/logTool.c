@@ -26,6 +26,11 @@ $ log trace keyword processName/componentName
  * To disable a trace:
  * @verbatim
 $ log stoptrace keyword processName/componentName
+@endverbatim
+ *
+ * To stream the WARNING (or more severe) messages of a component that contain a piece of text:
+ * @verbatim
+$ log stream --level=WARNING --match=text processName/componentName
 @endverbatim
  *
  *
@@ -52,6 +57,7 @@ $ log stoptrace keyword processName/componentName
 #include "legato.h"
 #include "log.h"
 #include "logDaemon.h"
+#include "logStore.h"
 #include "limit.h"
 #include <ctype.h>
 
@@ -66,6 +72,15 @@ $ log stoptrace keyword processName/componentName
 #define DEFAULT_SESSION_ID    "*/*"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command character for the "show" command.  This command is carried out by the tool itself, so
+ * it's never sent to the Log Control Daemon.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SHOW_COMMAND          's'
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Command character byte.
@@ -99,6 +114,29 @@ static const char* SessionIdPtr = DEFAULT_SESSION_ID;
 static bool ErrorOccurred = false;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Options of the "show" command: how many seconds ago the messages to show start and end
+ * (-1 if not given), and the least severe level to show (NULL if not given).
+ **/
+//--------------------------------------------------------------------------------------------------
+static int SinceSeconds = -1;
+static int UntilSeconds = -1;
+static const char* MinLevelStr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Options of the "stream" command: the text and the regular expression that the messages
+ * streamed must contain and match (NULL if not given), and the most messages streamed per second.
+ * The --level option is shared with the "show" command.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* MatchStr = NULL;
+static const char* RegexStr = NULL;
+static int StreamRate = LOG_STREAM_DEFAULT_RATE;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints help to stdout.
@@ -118,7 +156,11 @@ static void PrintHelpAndExit
         "    log level FILTER_STR [DESTINATION]\n"
         "    log trace KEYWORD_STR [DESTINATION]\n"
         "    log stoptrace KEYWORD_STR [DESTINATION]\n"
+        "    log ratelimit LIMIT_STR [DESTINATION]\n"
         "    log forget PROCESS_NAME\n"
+        "    log show [--since=SECONDS] [--until=SECONDS] [--level=FILTER_STR]\n"
+        "    log stream [--level=FILTER_STR] [--match=TEXT] [--regex=REGEX]\n"
+        "               [--rate=COUNT] [DESTINATION]\n"
         "\n"
         "DESCRIPTION:\n"
         "    log list            Lists all processes/components registered with the\n"
@@ -142,10 +184,41 @@ static void PrintHelpAndExit
         "                        keyword is not logged.  The KEYWORD_STR is a trace\n"
         "                        keyword.\n"
         "\n"
+        "    log ratelimit       Limits how often each place in the code of a component\n"
+        "                        can log.  The LIMIT_STR is either COUNT/SECONDS, to\n"
+        "                        allow bursts of up to COUNT messages and then COUNT\n"
+        "                        messages every SECONDS seconds, or 'off'.  Messages\n"
+        "                        over the limit are dropped and replaced with a\n"
+        "                        'last message repeated N times' message.  Critical\n"
+        "                        and emergency messages are never dropped.\n"
+        "\n"
         "    log forget          Forgets all settings for processes with a given name.\n"
         "                        Future processes with that name will have default\n"
         "                        settings.\n"
         "\n"
+        "    log show            Shows the messages kept in the on-target log store\n"
+        "                        (" LOG_STORE_DIR "), oldest first.  The log\n"
+        "                        store is only kept if that directory exists when\n"
+        "                        the log daemon starts.  --since and --until limit\n"
+        "                        the messages to those logged between the given\n"
+        "                        numbers of seconds ago, and --level to those at\n"
+        "                        least as severe as the given FILTER_STR (traces\n"
+        "                        are not shown then).  The last few seconds of\n"
+        "                        messages may not be in the store yet.\n"
+        "\n"
+        "    log stream          Prints the messages logged from now on, until\n"
+        "                        interrupted.  Only the messages from the\n"
+        "                        [DESTINATION] are printed, and --level, --match and\n"
+        "                        --regex further limit them to those at least as\n"
+        "                        severe as FILTER_STR, containing TEXT and matching\n"
+        "                        the POSIX extended REGEX.  The filtering is done by\n"
+        "                        the log daemon, so only the messages printed are\n"
+        "                        sent to the tool.  At most COUNT messages are sent\n"
+        "                        each second (default "
+                                 STRINGIZE(LOG_STREAM_DEFAULT_RATE) ", 0 for no\n"
+        "                        limit); the number of messages dropped over that is\n"
+        "                        printed instead.  Only available on targets.\n"
+        "\n"
         "The [DESTINATION] is optional and specifies the process and component to\n"
         "send the command to.  The [DESTINATION] must be in this format:\n"
         "\n"
@@ -464,6 +537,35 @@ static void TraceKeywordArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called by le_arg_Scan() when a rate limit argument is seen on the command
+ * line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void RateLimitArgHandler
+(
+    const char* rateLimitStr
+)
+{
+    static char normalizedStr[LOG_RATE_LIMIT_STR_BYTES];
+    log_RateLimit_t rateLimit;
+
+    // Check that the string is a valid rate limit.
+    if (log_StrToRateLimit(rateLimitStr, &rateLimit) != LE_OK)
+    {
+        ExitWithErrorMsg("Invalid rate limit.");
+    }
+
+    log_RateLimitToStr(&rateLimit, normalizedStr, sizeof(normalizedStr));
+    CommandParamPtr = normalizedStr;
+
+    // Wait for an optional log session identifier next.
+    le_arg_AddPositionalCallback(SessionIdArgHandler);
+    le_arg_AllowLessPositionalArgsThanCallbacks();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function that gets called by le_arg_Scan() when the process identifier argument (either a process
@@ -516,6 +618,13 @@ static void CommandArgHandler
         // Expect a trace keyword next.
         le_arg_AddPositionalCallback(TraceKeywordArgHandler);
     }
+    else if (strcmp(command, "ratelimit") == 0)
+    {
+        Command = LOG_CMD_SET_RATE_LIMIT;
+
+        // Expect a rate limit next.
+        le_arg_AddPositionalCallback(RateLimitArgHandler);
+    }
     else if (strcmp(command, "list") == 0)
     {
         Command = LOG_CMD_LIST_COMPONENTS;
@@ -529,6 +638,20 @@ static void CommandArgHandler
         // This command has only a process name (or pid) as a parameter.
         le_arg_AddPositionalCallback(ProcessIdArgHandler);
     }
+    else if (strcmp(command, "show") == 0)
+    {
+        Command = SHOW_COMMAND;
+
+        // This command only has options.
+    }
+    else if (strcmp(command, "stream") == 0)
+    {
+        Command = LOG_CMD_STREAM;
+
+        // Wait for an optional log session identifier.
+        le_arg_AddPositionalCallback(SessionIdArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
     else
     {
         char errorMsg[100];
@@ -538,6 +661,153 @@ static void CommandArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints a message read out of the log store.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintStoredMsg
+(
+    uint64_t timeMs,        ///< [IN] Time at which the message was stored (ms since the Epoch).
+    le_log_Level_t level,   ///< [IN] Severity level (not used; it's in the message).
+    const char* msgPtr,     ///< [IN] Formatted message.
+    void* contextPtr        ///< [IN] Not used.
+)
+{
+    time_t seconds = timeMs / 1000;
+    struct tm brokenDownTime;
+    char timeStamp[32] = "";
+
+    if (localtime_r(&seconds, &brokenDownTime) != NULL)
+    {
+        strftime(timeStamp, sizeof(timeStamp), "%b %e %H:%M:%S", &brokenDownTime);
+    }
+
+    printf("%s.%03u %s\n", timeStamp, (unsigned int)(timeMs % 1000), msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Carries out the "show" command: prints the messages in the log store that match the options.
+ **/
+//--------------------------------------------------------------------------------------------------
+__attribute__ ((__noreturn__))
+static void ShowStoredLogs
+(
+    void
+)
+{
+    uint64_t startMs = 0;
+    uint64_t endMs = UINT64_MAX;
+    uint32_t levelMask = UINT32_MAX;
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t nowMs = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+
+    if (SinceSeconds >= 0)
+    {
+        startMs = nowMs - (uint64_t)SinceSeconds * 1000;
+    }
+    if (UntilSeconds >= 0)
+    {
+        endMs = nowMs - (uint64_t)UntilSeconds * 1000;
+    }
+
+    if (MinLevelStr != NULL)
+    {
+        le_log_Level_t minLevel = ParseSeverityLevel(MinLevelStr);
+        if (minLevel == (le_log_Level_t)(-1))
+        {
+            ExitWithErrorMsg("Invalid log level.");
+        }
+
+        // All the levels at least as severe as the minimum.
+        levelMask = ~(LOG_STORE_LEVEL_BIT(minLevel) - 1);
+    }
+
+    if (logStore_Read(LOG_STORE_DIR, startMs, endMs, levelMask, PrintStoredMsg, NULL) != LE_OK)
+    {
+        ExitWithErrorMsg("No log store found in " LOG_STORE_DIR ".");
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends one "KEY=VALUE" setting of the stream filter to the "stream" command message.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AppendStreamSetting
+(
+    le_msg_MessageRef_t msgRef, ///< Command message.
+    const char* keyPtr,         ///< Key of the setting.
+    const char* valuePtr        ///< Value of the setting.
+)
+{
+    // The settings are separated by LOG_CMD_SEPARATOR characters, so values can't contain any.
+    if (strchr(valuePtr, LOG_CMD_SEPARATOR) != NULL)
+    {
+        ExitWithErrorMsg("Stream filters can't contain line breaks.");
+    }
+
+    const char separatorStr[] = { LOG_CMD_SEPARATOR, '\0' };
+
+    AppendToCommand(msgRef, separatorStr);
+    AppendToCommand(msgRef, keyPtr);
+    AppendToCommand(msgRef, "=");
+    AppendToCommand(msgRef, valuePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends the filter given by the options of the "stream" command to its command message.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AppendStreamFilter
+(
+    le_msg_MessageRef_t msgRef  ///< Command message.
+)
+{
+    char rateStr[16];
+
+    if (StreamRate < 0)
+    {
+        ExitWithErrorMsg("Invalid stream rate.");
+    }
+
+    // The rate always comes first, so the filter is never empty.
+    snprintf(rateStr, sizeof(rateStr), "%d", StreamRate);
+    AppendToCommand(msgRef, LOG_STREAM_RATE_KEY "=");
+    AppendToCommand(msgRef, rateStr);
+
+    if (MinLevelStr != NULL)
+    {
+        le_log_Level_t minLevel = ParseSeverityLevel(MinLevelStr);
+        if (minLevel == (le_log_Level_t)(-1))
+        {
+            ExitWithErrorMsg("Invalid log level.");
+        }
+
+        AppendStreamSetting(msgRef, LOG_STREAM_LEVEL_KEY, log_SeverityLevelToStr(minLevel));
+    }
+
+    if (MatchStr != NULL)
+    {
+        AppendStreamSetting(msgRef, LOG_STREAM_MATCH_KEY, MatchStr);
+    }
+
+    if (RegexStr != NULL)
+    {
+        AppendStreamSetting(msgRef, LOG_STREAM_REGEX_KEY, RegexStr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
@@ -545,6 +815,16 @@ COMPONENT_INIT
     // The first positional argument must always be a command.
     le_arg_AddPositionalCallback(CommandArgHandler);
 
+    // Options of the "show" command.
+    le_arg_SetIntVar(&SinceSeconds, NULL, "since");
+    le_arg_SetIntVar(&UntilSeconds, NULL, "until");
+    le_arg_SetStringVar(&MinLevelStr, NULL, "level");
+
+    // Options of the "stream" command.
+    le_arg_SetStringVar(&MatchStr, NULL, "match");
+    le_arg_SetStringVar(&RegexStr, NULL, "regex");
+    le_arg_SetIntVar(&StreamRate, NULL, "rate");
+
     // Remaining arguments will depend on the command.  CommandArgHandler() will add more
     // positional callbacks if necessary.
 
@@ -553,6 +833,11 @@ COMPONENT_INIT
 
     le_arg_Scan();
 
+    if (Command == SHOW_COMMAND)
+    {
+        ShowStoredLogs();
+    }
+
     // Connect to the Log Control Daemon and allocate a message buffer to hold the command.
     le_msg_SessionRef_t sessionRef = ConnectToLogControlDaemon();
     le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
@@ -566,6 +851,7 @@ COMPONENT_INIT
         case LOG_CMD_SET_LEVEL:
         case LOG_CMD_ENABLE_TRACE:
         case LOG_CMD_DISABLE_TRACE:
+        case LOG_CMD_SET_RATE_LIMIT:
 
             AppendToCommand(msgRef, SessionIdPtr);
             AppendToCommand(msgRef, "/");
@@ -583,11 +869,22 @@ COMPONENT_INIT
 
             AppendToCommand(msgRef, CommandParamPtr);
 
+            break;
+
+        case LOG_CMD_STREAM:
+
+            AppendToCommand(msgRef, SessionIdPtr);
+            AppendToCommand(msgRef, "/");
+            AppendStreamFilter(msgRef);
+
+            // Print each message as soon as it arrives, even into a pipe.
+            setvbuf(stdout, NULL, _IOLBF, 0);
+
             break;
     }
 
     // Send the command and wait for messages from the Log Control Daemon.  When the Log Control
     // Daemon has finished executing the command, it will close the IPC session, resulting in a
-    // call to SessionCloseHandler().
+    // call to SessionCloseHandler().  For the "stream" command, that only happens on an error.
     le_msg_Send(msgRef);
 }
@@ -12,6 +12,7 @@
 #include "sdirToolProtocol.h"
 #include "limit.h"
 #include "user.h"
+#include "bindingTable.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -67,6 +68,7 @@ static void PrintHelpAndExit
         "    sdir load\n"
         "            Updates the Service Directory's bindings with the current state.\n"
         "            of the binding configuration settings in the configuration tree.\n"
+        "            Only the differences from the system's binding table are sent.\n"
         "\n"
         "            The tool will not exit until it gets confirmation from\n"
         "            the Service Directory that the changes have been applied.\n"
@@ -240,22 +242,56 @@ static void SendUnbindAllRequest
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the user ID for a given app name.
+ * Send an "Unbind" request to the Service Directory for one client interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendUnbindRequest
+(
+    uid_t uid,                      ///< [in] Unix user ID of the client.
+    const char* interfaceName       ///< [in] Client's interface name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+    le_sdtp_Msg_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->msgType = LE_SDTP_MSGID_UNBIND;
+    msgPtr->client = uid;
+    le_utf8_Copy(msgPtr->clientInterfaceName,
+                 interfaceName,
+                 sizeof(msgPtr->clientInterfaceName),
+                 NULL);
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+
+    if (msgRef == NULL)
+    {
+        ExitWithErrorMsg("Communication with Service Directory failed.");
+    }
+
+    le_msg_ReleaseMsg(msgRef);
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user name of the server of the binding that a configuration tree iterator is
+ * positioned at.
  *
  * @return LE_OK if successful.
  **/
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetServerUid
+static le_result_t GetServerUserName
 (
     le_cfg_IteratorRef_t    i,  ///< [in] Config tree iterator positioned at binding config.
-    uid_t*  uidPtr              ///< [out] The application's user ID.
+    char* userName,             ///< [out] The server's user name.
+    size_t userNameSize         ///< [in] Size of the user name buffer.
 )
 //--------------------------------------------------------------------------------------------------
 {
     le_result_t result;
 
-    char userName[LIMIT_MAX_USER_NAME_BYTES];
-
     // If an app name is present in the binding config,
     if (le_cfg_NodeExists(i, "app"))
     {
@@ -295,13 +331,11 @@ static le_result_t GetServerUid
         }
         if (!le_cfg_GetBool(i, path, true))
         {
-            *uidPtr = 0;
-
-            return LE_OK;
+            return le_utf8_Copy(userName, "root", userNameSize, NULL);
         }
 
-        // It is not sandboxed.  Convert the app name into a user name.
-        result = user_AppNameToUserName(appName, userName, sizeof(userName));
+        // It is sandboxed.  Convert the app name into a user name.
+        result = user_AppNameToUserName(appName, userName, userNameSize);
         if (result != LE_OK)
         {
             LE_CRIT("Failed to convert app name '%s' into a user name.", appName);
@@ -313,7 +347,7 @@ static le_result_t GetServerUid
     else
     {
         // Get the server user name instead.
-        result = le_cfg_GetString(i, "user", userName, sizeof(userName), "");
+        result = le_cfg_GetString(i, "user", userName, userNameSize, "");
         if (result != LE_OK)
         {
             char path[LIMIT_MAX_PATH_BYTES];
@@ -334,6 +368,33 @@ static le_result_t GetServerUid
         }
     }
 
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user ID of the server of the binding that a configuration tree iterator is
+ * positioned at.
+ *
+ * @return LE_OK if successful.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetServerUid
+(
+    le_cfg_IteratorRef_t    i,  ///< [in] Config tree iterator positioned at binding config.
+    uid_t*  uidPtr              ///< [out] The application's user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char userName[LIMIT_MAX_USER_NAME_BYTES];
+
+    le_result_t result = GetServerUserName(i, userName, sizeof(userName));
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
     // Convert the server's user name into a user ID.
     result = user_GetUid(userName, uidPtr);
     if (result != LE_OK)
@@ -363,6 +424,58 @@ static le_result_t GetServerUid
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the binding that a configuration tree iterator is positioned at is the same as a
+ * binding of the system's binding table.
+ *
+ * @return true if the server user and interface are the same.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsSameBinding
+(
+    le_cfg_IteratorRef_t i,                     ///< [in] Iterator positioned at binding config.
+    const bindingTable_Binding_t* bindingPtr    ///< [in] Binding of the binding table.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char userName[LIMIT_MAX_USER_NAME_BYTES];
+    char interfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];
+
+    return (   (GetServerUserName(i, userName, sizeof(userName)) == LE_OK)
+            && (strcmp(userName, bindingPtr->serverUserPtr) == 0)
+            && (le_cfg_GetString(i, "interface", interfaceName, sizeof(interfaceName), "")
+                    == LE_OK)
+            && (strcmp(interfaceName, bindingPtr->serverIfPtr) == 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the binding that a configuration tree iterator is positioned at is already in
+ * the system's binding table, and so has already been created by the Service Directory.
+ *
+ * @return true if it is.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsInBindingTable
+(
+    bindingTable_Ref_t tableRef,    ///< [in] Binding table, or NULL if there is none.
+    const char* clientUserName,     ///< [in] User name of the client.
+    le_cfg_IteratorRef_t i          ///< [in] Iterator positioned at binding config.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char interfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];
+    bindingTable_Binding_t binding;
+
+    return (   (tableRef != NULL)
+            && (le_cfg_GetNodeName(i, "", interfaceName, sizeof(interfaceName)) == LE_OK)
+            && (bindingTable_Find(tableRef, clientUserName, interfaceName, &binding) == LE_OK)
+            && IsSameBinding(i, &binding) );
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send a binding from a configuration tree iterator's current node to the Service Directory.
@@ -437,36 +550,46 @@ static void SendBindRequest
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the Unix user ID for the user configuration node that a given configuration iterator
+ * Gets the Unix user name for the app configuration node that a given configuration iterator
  * is currently positioned at.
  *
  * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetUserUid
+static le_result_t GetAppUserName
 (
-    le_cfg_IteratorRef_t i, ///< [in] Configuration tree iterator.
-    uid_t*          uidPtr  ///< [out] Pointer to where the user ID will be put if successful.
+    le_cfg_IteratorRef_t i, ///< [IN] Configuration tree iterator.
+    char* userName,         ///< [OUT] The app's user name.
+    size_t userNameSize     ///< [IN] Size of the user name buffer.
 )
 //--------------------------------------------------------------------------------------------------
 {
     le_result_t result;
 
-    char userName[LIMIT_MAX_USER_NAME_BYTES];
-    result = le_cfg_GetNodeName(i, "", userName, sizeof(userName));
-
+    char appName[LIMIT_MAX_APP_NAME_BYTES];
+    result = le_cfg_GetNodeName(i, "", appName, sizeof(appName));
     if (result != LE_OK)
     {
-        LE_CRIT("Configuration node name too long under 'system/users/'.");
+        LE_CRIT("Configuration node name too long under 'system/apps/'.");
         return LE_OVERFLOW;
     }
 
-    // Convert the user name into a user ID.
-    result = user_GetUid(userName, uidPtr);
+    // If this is an "unsandboxed" app, use the root user.
+    if (le_cfg_GetBool(i, "sandboxed", true) == false)
+    {
+        char path[256];
+        le_cfg_GetPath(i, "", path, sizeof(path));
+        LE_DEBUG("'%s' = <root>", path);
+
+        return le_utf8_Copy(userName, "root", userNameSize, NULL);
+    }
+
+    // Convert the app name into a user name by prefixing it with "app".
+    result = user_AppNameToUserName(appName, userName, userNameSize);
     if (result != LE_OK)
     {
-        LE_CRIT("Failed to get user ID for user '%s'. (%s)", userName, LE_RESULT_TXT(result));
-        return LE_NOT_FOUND;
+        LE_CRIT("Failed to convert app name into user name.");
+        return LE_OVERFLOW;
     }
 
     return LE_OK;
@@ -475,64 +598,132 @@ static le_result_t GetUserUid
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the Unix user ID for the app configuration node that a given configuration iterator
- * is currently positioned at.
+ * Gets the Unix user ID for a user name.
  *
  * @return LE_OK if successful.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetAppUid
+static le_result_t GetUidFromName
 (
-    le_cfg_IteratorRef_t i, ///< [in] Configuration tree iterator.
-    uid_t*          uidPtr  ///< [out] Pointer to where the user ID will be put if successful.
+    const char* userName,   ///< [IN] User name.
+    uid_t*          uidPtr  ///< [OUT] Pointer to where the user ID will be put if successful.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_result_t result;
-
-    char appName[LIMIT_MAX_APP_NAME_BYTES];
-    result = le_cfg_GetNodeName(i, "", appName, sizeof(appName));
+    le_result_t result = user_GetUid(userName, uidPtr);
     if (result != LE_OK)
     {
-        LE_CRIT("Configuration node name too long under 'system/apps/'.");
-        return LE_OVERFLOW;
+        LE_CRIT("Failed to get user ID for user '%s'. (%s)", userName, LE_RESULT_TXT(result));
+        return LE_NOT_FOUND;
     }
 
-    // If this is an "unsandboxed" app, use the root user ID.
-    if (le_cfg_GetBool(i, "sandboxed", true) == false)
-    {
-        char path[256];
-        le_cfg_GetPath(i, "", path, sizeof(path));
-        LE_DEBUG("'%s' = <root>", path);
+    return LE_OK;
+}
 
-        *uidPtr = 0;
-        return LE_OK;
-    }
 
-    // Convert the app name into a user name by prefixing it with "app".
-    char userName[LIMIT_MAX_USER_NAME_BYTES] = "app";
-    result = le_utf8_Append(userName, appName, sizeof(userName), NULL);
-    if (result != LE_OK)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the bindings of the system's binding table that are no longer in the binding
+ * configuration, or have changed in it (e.g., because their app has been updated or removed
+ * individually).
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnbindStaleTableBindings
+(
+    bindingTable_Ref_t tableRef     ///< [IN] Binding table.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:");
+    size_t count = bindingTable_GetCount(tableRef);
+    size_t index;
+
+    for (index = 0; index < count; index++)
     {
-        LE_CRIT("Failed to convert app name into user name.");
-        return LE_OVERFLOW;
+        bindingTable_Binding_t binding;
+        char path[LIMIT_MAX_PATH_BYTES];
+        bool isStale = true;
+
+        bindingTable_Get(tableRef, index, &binding);
+
+        // Go to the client's app or user node.
+        if (binding.clientAppPtr[0] != '\0')
+        {
+            snprintf(path, sizeof(path), "/apps/%s", binding.clientAppPtr);
+        }
+        else
+        {
+            snprintf(path, sizeof(path), "/users/%s", binding.clientUserPtr);
+        }
+        le_cfg_GoToNode(i, path);
+
+        // An app's user also changes if it is no longer sandboxed, or the other way around.
+        char userName[LIMIT_MAX_USER_NAME_BYTES];
+        if (   le_cfg_NodeExists(i, "bindings")
+            && (   (binding.clientAppPtr[0] == '\0')
+                || (   (GetAppUserName(i, userName, sizeof(userName)) == LE_OK)
+                    && (strcmp(userName, binding.clientUserPtr) == 0) ) ) )
+        {
+            le_cfg_GoToNode(i, "bindings");
+
+            if (le_cfg_NodeExists(i, binding.clientIfPtr))
+            {
+                le_cfg_GoToNode(i, binding.clientIfPtr);
+                isStale = !IsSameBinding(i, &binding);
+            }
+        }
+
+        uid_t uid;
+        if (isStale && (user_GetUid(binding.clientUserPtr, &uid) == LE_OK))
+        {
+            SendUnbindRequest(uid, binding.clientIfPtr);
+        }
     }
 
-    // Convert the app user name into a user ID.
-    result = user_GetUid(userName, uidPtr);
-    if (result != LE_OK)
+    le_cfg_CancelTxn(i);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the bindings of the client user or app that a configuration tree iterator is positioned
+ * at, except those that are already in the system's binding table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendBindRequests
+(
+    bindingTable_Ref_t tableRef,    ///< [IN] Binding table, or NULL if there is none.
+    const char* userName,           ///< [IN] Client's user name.
+    uid_t uid,                      ///< [IN] Client's user ID.
+    le_cfg_IteratorRef_t i          ///< [IN] Iterator positioned at the user or app node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Iterate over the bindings collection, sending the bindings to the Service Directory.
+    le_cfg_GoToNode(i, "bindings");
+    le_result_t result = le_cfg_GoToFirstChild(i);
+    while (result == LE_OK)
     {
-        LE_CRIT("Failed to get user ID for user '%s'. (%s)", userName, LE_RESULT_TXT(result));
-        return LE_NOT_FOUND;
+        if (!IsInBindingTable(tableRef, userName, i))
+        {
+            SendBindRequest(uid, i);
+        }
+
+        result = le_cfg_GoToNextSibling(i);
     }
 
-    return LE_OK;
+    // Go back up to the user or app node.
+    le_cfg_GoToNode(i, "../..");
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Execute a 'load' command.
+ *
+ * The Service Directory resets its bindings to the built-in ones and those of the system's
+ * binding table, so only the differences between the binding configuration and the table are
+ * sent to it.
  */
 //--------------------------------------------------------------------------------------------------
 static void Load
@@ -549,33 +740,35 @@ static void Load
     // Initialize the "User API".
     user_Init();
 
+    bindingTable_Ref_t tableRef = bindingTable_Load(BINDING_TABLE_FILE_PATH);
+
     // Start a read transaction on the root of the "system" configuration tree.
     le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:");
 
-    // Tell the Service Directory to delete all existing bindings.
+    // Tell the Service Directory to delete all existing bindings, except the built-in ones and
+    // those of the binding table.
     SendUnbindAllRequest();
 
+    if (tableRef != NULL)
+    {
+        UnbindStaleTableBindings(tableRef);
+    }
+
     // Iterate over the users collection.
     le_cfg_GoToNode(i, "/users");
     result = le_cfg_GoToFirstChild(i);
     while (result == LE_OK)
     {
+        char userName[LIMIT_MAX_USER_NAME_BYTES];
         uid_t uid;
-        if (GetUserUid(i, &uid) == LE_OK)
-        {
-            // For each user, iterate over the bindings collection, sending the binding to
-            // the Service Directory.
-            le_cfg_GoToNode(i, "bindings");
-            result = le_cfg_GoToFirstChild(i);
-            while (result == LE_OK)
-            {
-                SendBindRequest(uid, i);
 
-                result = le_cfg_GoToNextSibling(i);
-            }
-
-            // Go back up to the user name node.
-            le_cfg_GoToNode(i, "../..");
+        if (le_cfg_GetNodeName(i, "", userName, sizeof(userName)) != LE_OK)
+        {
+            LE_CRIT("Configuration node name too long under 'system/users/'.");
+        }
+        else if (GetUidFromName(userName, &uid) == LE_OK)
+        {
+            SendBindRequests(tableRef, userName, uid, i);
         }
 
         // Move on to the next user.
@@ -587,30 +780,19 @@ static void Load
     result = le_cfg_GoToFirstChild(i);
     while (result == LE_OK)
     {
+        char userName[LIMIT_MAX_USER_NAME_BYTES];
         uid_t uid;
 
-        if (GetAppUid(i, &uid) == LE_OK)
+        if (   (GetAppUserName(i, userName, sizeof(userName)) == LE_OK)
+            && (GetUidFromName(userName, &uid) == LE_OK) )
         {
-            // For each app, iterate over the bindings collection, sending the binding to
-            // the Service Directory.
-            le_cfg_GoToNode(i, "bindings");
-            result = le_cfg_GoToFirstChild(i);
-            while (result == LE_OK)
-            {
-                SendBindRequest(uid, i);
-
-                result = le_cfg_GoToNextSibling(i);
-            }
-
-            // Go back up to the app's node.
-            le_cfg_GoToNode(i, "../..");
+            SendBindRequests(tableRef, userName, uid, i);
         }
 
         // Move on to the next app.
         result = le_cfg_GoToNextSibling(i);
     }
 
-
     exit(EXIT_SUCCESS);
 }
 
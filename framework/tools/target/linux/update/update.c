@@ -38,6 +38,39 @@ static bool DoRemove = false;
 static bool Done = false;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size (in KiB) of the synthetic app to install, if --benchmark was specified on the command-line.
+ * 0 = not benchmarking.
+ */
+//--------------------------------------------------------------------------------------------------
+static int BenchmarkKb = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the synthetic app installed by --benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_APP_NAME "updateBenchmark"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of each of the files in the synthetic app installed by --benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_FILE_BYTES (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Temporary directory that the synthetic update pack is built in.
+ */
+//--------------------------------------------------------------------------------------------------
+static char BenchmarkDir[] = "/tmp/updateBenchmarkXXXXXX";
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Positional command-line argument.
@@ -67,6 +100,8 @@ static void PrintHelp
         "    update --mark-good\n"
         "    update --mark-bad\n"
         "    update --defer\n"
+        "    update --stats\n"
+        "    update --benchmark=SIZE_KB\n"
         "\n"
         "DESCRIPTION:\n"
         "    update --help\n"
@@ -98,6 +133,16 @@ static void PrintHelp
         "        To release the deferral use Ctrl-C or kill to exit this command.\n"
         "        More than one deferral can be in effect at any time. All of them must be cleared\n"
         "        before an update can take place.\n"
+        "\n"
+        "    update --stats\n"
+        "    update -s\n"
+        "        Prints the time spent in each phase of the last install and the number of\n"
+        "        payload bytes unpacked and skipped.\n"
+        "\n"
+        "    update --benchmark=SIZE_KB\n"
+        "        Builds an update pack for a synthetic app with SIZE_KB KiB of random files,\n"
+        "        installs it, prints the install statistics (as for --stats) and then removes\n"
+        "        the app again.\n"
     );
 
     exit(EXIT_SUCCESS);
@@ -232,6 +277,231 @@ static void StartDeferral
 
 
 //--------------------------------------------------------------------------------------------------
+/**
+ * Prints the statistics of the last install to stdout.
+ *
+ * @return LE_OK if there were statistics to print.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrintInstallStats
+(
+    void
+)
+{
+    char summary[LE_UPDATE_MAX_INSTALL_STATS_LEN + 1];
+
+    le_result_t result = le_update_GetInstallStats(summary, sizeof(summary));
+    if (result == LE_OK)
+    {
+        printf("%s\n", summary);
+    }
+    else if (result == LE_NOT_FOUND)
+    {
+        fprintf(stderr, "No install has finished since the Update Daemon started.\n");
+    }
+    else
+    {
+        fprintf(stderr, "**ERROR: Failed to get install statistics (%s).\n", LE_RESULT_TXT(result));
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called when --stats or -s appear on the command-line.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintStats
+(
+    void
+)
+{
+    le_update_ConnectService();
+
+    exit(PrintInstallStats() == LE_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called when --benchmark appears on the command-line.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetBenchmark
+(
+    int sizeKb
+)
+{
+    if (sizeKb <= 0)
+    {
+        fprintf(stderr, "Benchmark app size must be at least 1 KiB.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    BenchmarkKb = sizeKb;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a file, exiting on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteBenchmarkFile
+(
+    const char* pathPtr,    ///< [IN] Path to the file.
+    const void* dataPtr,    ///< [IN] Contents of the file.
+    size_t dataSize,        ///< [IN] Number of bytes to write.
+    const char* modePtr     ///< [IN] fopen() mode.
+)
+{
+    FILE* filePtr = fopen(pathPtr, modePtr);
+
+    if (   (filePtr == NULL)
+        || (fwrite(dataPtr, 1, dataSize, filePtr) != dataSize)
+        || (fclose(filePtr) != 0))
+    {
+        fprintf(stderr, "**ERROR: Failed to write '%s' (%m).\n", pathPtr);
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds an update pack that installs a synthetic app of BenchmarkKb KiB of random files.
+ * The app gets a random MD5 hash, so that it is always installed afresh.
+ *
+ * @return Path to the update pack.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* MakeBenchmarkPack
+(
+    void
+)
+{
+    static char packPath[PATH_MAX];
+    char path[PATH_MAX];
+    char md5[LIMIT_MD5_STR_BYTES];
+    uint8_t md5Bytes[(LIMIT_MD5_STR_BYTES - 1) / 2];
+    static uint8_t data[BENCHMARK_FILE_BYTES];
+    size_t i;
+
+    if (mkdtemp(BenchmarkDir) == NULL)
+    {
+        fprintf(stderr, "**ERROR: Failed to create a temporary directory (%m).\n");
+        exit(EXIT_FAILURE);
+    }
+
+    le_rand_GetBuffer(md5Bytes, sizeof(md5Bytes));
+    for (i = 0; i < sizeof(md5Bytes); i++)
+    {
+        snprintf(md5 + (i * 2), sizeof(md5) - (i * 2), "%02x", md5Bytes[i]);
+    }
+
+    // Lay the app out the way mkapp does: info.properties, root.cfg and the app's files.
+    snprintf(path, sizeof(path), "%s/staging/read-only/bench", BenchmarkDir);
+    if (le_dir_MakePath(path, S_IRWXU) != LE_OK)
+    {
+        fprintf(stderr, "**ERROR: Failed to create '%s'.\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t remaining = (size_t)BenchmarkKb * 1024;
+    for (i = 0; remaining > 0; i++)
+    {
+        size_t fileSize = (remaining < sizeof(data)) ? remaining : sizeof(data);
+
+        le_rand_GetBuffer(data, fileSize);
+        snprintf(path, sizeof(path), "%s/staging/read-only/bench/data%zu", BenchmarkDir, i);
+        WriteBenchmarkFile(path, data, fileSize, "w");
+
+        remaining -= fileSize;
+    }
+
+    char text[256];
+    int len = snprintf(text, sizeof(text),
+                       "app.name=" BENCHMARK_APP_NAME "\n"
+                       "app.md5=%s\n"
+                       "app.version=benchmark\n",
+                       md5);
+    snprintf(path, sizeof(path), "%s/staging/info.properties", BenchmarkDir);
+    WriteBenchmarkFile(path, text, len, "w");
+
+    // Don't start the app after it is installed.
+    len = snprintf(text, sizeof(text), "{\n  \"startManual\" !t\n}\n");
+    snprintf(path, sizeof(path), "%s/staging/root.cfg", BenchmarkDir);
+    WriteBenchmarkFile(path, text, len, "w");
+
+    // Compress the app the same way update-util does.
+    char command[PATH_MAX * 2 + 32];
+    snprintf(command, sizeof(command), "tar cjf %s/app.tar.bz2 -C %s/staging .",
+             BenchmarkDir, BenchmarkDir);
+    if (system(command) != 0)
+    {
+        fprintf(stderr, "**ERROR: Failed to run '%s'.\n", command);
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat tarStat;
+    snprintf(path, sizeof(path), "%s/app.tar.bz2", BenchmarkDir);
+    if (stat(path, &tarStat) != 0)
+    {
+        fprintf(stderr, "**ERROR: Failed to stat '%s' (%m).\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    // The update pack is the app update section's JSON header followed by the tarball.
+    snprintf(packPath, sizeof(packPath), "%s/app.update", BenchmarkDir);
+    len = snprintf(text, sizeof(text),
+                   "{\"command\":\"updateApp\",\"name\":\"" BENCHMARK_APP_NAME "\","
+                   "\"version\":\"benchmark\",\"md5\":\"%s\",\"size\":%lld}",
+                   md5,
+                   (long long)tarStat.st_size);
+    WriteBenchmarkFile(packPath, text, len, "w");
+
+    snprintf(command, sizeof(command), "cat %s >> %s", path, packPath);
+    if (system(command) != 0)
+    {
+        fprintf(stderr, "**ERROR: Failed to run '%s'.\n", command);
+        exit(EXIT_FAILURE);
+    }
+
+    return packPath;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes a benchmark run: prints the install statistics, then removes the synthetic app and the
+ * temporary directory the update pack was built in.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndBenchmark
+(
+    bool isSuccess  ///< [IN] true if the synthetic app was installed.
+)
+{
+    PrintInstallStats();
+
+    if (isSuccess)
+    {
+        le_appRemove_ConnectService();
+
+        le_result_t result = le_appRemove_Remove(BENCHMARK_APP_NAME);
+        if (result != LE_OK)
+        {
+            fprintf(stderr, "Failed to remove app '" BENCHMARK_APP_NAME "' (%s)\n",
+                    LE_RESULT_TXT(result));
+        }
+    }
+
+    le_dir_RemoveRecursive(BenchmarkDir);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the file descriptor for the input stream.  Input file either might be given via STDIN or
@@ -408,12 +678,20 @@ static void UpdateProgressHandler
         case LE_UPDATE_STATE_SUCCESS:
             //Successful completion.
             printf("\nSUCCESS\n");
+            if (BenchmarkKb > 0)
+            {
+                EndBenchmark(true);
+            }
             exit(EXIT_SUCCESS);
 
         case LE_UPDATE_STATE_FAILED:
             // Failure in update, exit with failure code.
             PrintErrorMsg();
             printf("\nFAILED\n");
+            if (BenchmarkKb > 0)
+            {
+                EndBenchmark(false);
+            }
             exit(EXIT_FAILURE);
     }
 }
@@ -522,6 +800,12 @@ COMPONENT_INIT
     // update --defer
     le_arg_SetFlagCallback(StartDeferral, "d", "defer");
 
+    // update --stats
+    le_arg_SetFlagCallback(PrintStats, "s", "stats");
+
+    // update --benchmark=SIZE_KB
+    le_arg_SetIntCallback(SetBenchmark, NULL, "benchmark");
+
     // update [FILE_NAME]
     le_arg_AddPositionalCallback(HandlePositionalArg);
     le_arg_AllowLessPositionalArgsThanCallbacks();
@@ -541,6 +825,11 @@ COMPONENT_INIT
 
             RemoveApp(ArgPtr);
         }
+        // If --benchmark was specified, then install a synthetic app.
+        else if (BenchmarkKb > 0)
+        {
+            Update(MakeBenchmarkPack());
+        }
         // If --remove (or -r) was NOT specified, then process an update pack.
         else
         {